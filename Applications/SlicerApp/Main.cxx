@@ -50,6 +50,7 @@
 #include "qSlicerCommandOptions.h"
 #include "qSlicerModuleFactoryManager.h"
 #include "qSlicerModuleManager.h"
+#include "qSlicerStartupTracer.h"
 #include "qSlicerStyle.h"
 
 // ITK includes
@@ -173,14 +174,18 @@ int SlicerAppMain(int argc, char* argv[])
 
   // Register and instantiate modules
   splashMessage(splashScreen, "Registering modules...");
+  qSlicerStartupTracer::beginSpan("Register modules");
   moduleFactoryManager->registerModules();
+  qSlicerStartupTracer::endSpan();
   if (app.commandOptions()->verbose())
     {
     qDebug() << "Number of registered modules:"
              << moduleFactoryManager->registeredModuleNames().count();
     }
   splashMessage(splashScreen, "Instantiating modules...");
+  qSlicerStartupTracer::beginSpan("Instantiate modules");
   moduleFactoryManager->instantiateModules();
+  qSlicerStartupTracer::endSpan();
   if (app.commandOptions()->verbose())
     {
     qDebug() << "Number of instantiated modules:"
@@ -191,7 +196,9 @@ int SlicerAppMain(int argc, char* argv[])
   QScopedPointer<qSlicerAppMainWindow> window;
   if (enableMainWindow)
     {
+    qSlicerStartupTracer::beginSpan("Create main window");
     window.reset(new qSlicerAppMainWindow);
+    qSlicerStartupTracer::endSpan();
     window->setWindowTitle(window->windowTitle()+ " " + Slicer_VERSION_FULL);
     }
   else if (app.commandOptions()->showPythonInteractor()
@@ -209,12 +216,18 @@ int SlicerAppMain(int argc, char* argv[])
     }
 
   // Load all available modules
+  qSlicerStartupTracer::beginSpan("Load modules");
   foreach(const QString& name, moduleFactoryManager->instantiatedModuleNames())
     {
     Q_ASSERT(!name.isNull());
     splashMessage(splashScreen, "Loading module \"" + name + "\"...");
     moduleFactoryManager->loadModule(name);
     }
+  qSlicerStartupTracer::endSpan();
+  if (app.commandOptions()->verboseModuleDiscovery())
+    {
+    moduleFactoryManager->printModuleStartupTimes();
+    }
   if (app.commandOptions()->verbose())
     {
     qDebug() << "Number of loaded modules:" << moduleManager->modulesNames().count();
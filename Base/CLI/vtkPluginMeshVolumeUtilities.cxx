@@ -0,0 +1,533 @@
+#include "vtkPluginMeshVolumeUtilities.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCharArray.h>
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkMultiThreader.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTriangleFilter.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+// The rays are slightly offset from the voxel centers so that they never
+// go exactly through a vertex or an edge of the surface, where crossings
+// would be counted twice or not at all.
+const double RayOffsetJ = 1.2345678e-5;
+const double RayOffsetK = 2.3456789e-5;
+
+//----------------------------------------------------------------------------
+int GetNumberOfThreads(int numberOfThreads)
+{
+  if (numberOfThreads <= 0)
+    {
+    numberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    }
+  return std::min(numberOfThreads, VTK_MAX_THREADS);
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+T CastValue(double value)
+{
+  if (std::numeric_limits<T>::is_integer)
+    {
+    value = floor(value + 0.5);
+    value = std::max(value, static_cast<double>(std::numeric_limits<T>::min()));
+    value = std::min(value, static_cast<double>(std::numeric_limits<T>::max()));
+    }
+  return static_cast<T>(value);
+}
+
+//----------------------------------------------------------------------------
+// Range of the voxels whose center is in [minimum - 0.5, maximum + 0.5],
+// clamped to [first, last]. Return false if the range is empty.
+bool GetVoxelRange(double minimum, double maximum, int first, int last, int range[2])
+{
+  double rangeMin = std::max(static_cast<double>(first), ceil(minimum - 0.5));
+  double rangeMax = std::min(static_cast<double>(last), floor(maximum + 0.5));
+  if (rangeMin > rangeMax)
+    {
+    return false;
+    }
+  range[0] = static_cast<int>(rangeMin);
+  range[1] = static_cast<int>(rangeMax);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+struct RasterizeData
+{
+  int Extent[6];
+  // Voxels in the bounding box of the surface
+  int Bounds[6];
+  // Surface points in IJK
+  std::vector<double> Points;
+  // Point ids of the triangles
+  std::vector<vtkIdType> Triangles;
+  // Triangles touching slice k are SliceTriangles[SliceStart[k - Bounds[4]]]
+  // to SliceTriangles[SliceStart[k - Bounds[4] + 1] - 1]
+  std::vector<vtkIdType> SliceStart;
+  std::vector<vtkIdType> SliceTriangles;
+  void* Scalars;
+  double Label;
+  double BoundarySampleDistance;
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+VTK_THREAD_RETURN_TYPE RasterizeThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  RasterizeData* data = static_cast<RasterizeData*>(info->UserData);
+  const int* extent = data->Extent;
+  const int* bounds = data->Bounds;
+  const vtkIdType incJ = extent[1] - extent[0] + 1;
+  const vtkIdType incK = incJ * (extent[3] - extent[2] + 1);
+  const double* points = &data->Points[0];
+  const vtkIdType* triangles = &data->Triangles[0];
+  const T label = CastValue<T>(data->Label);
+  T* scalars = static_cast<T*>(data->Scalars);
+
+  const int numberOfRows = bounds[3] - bounds[2] + 1;
+  std::vector<vtkIdType> rowStart(numberOfRows + 1);
+  std::vector<vtkIdType> rowTriangles;
+  std::vector<int> triangleRows;
+  std::vector<double> crossings;
+
+  for (int k = bounds[4] + info->ThreadID; k <= bounds[5]; k += info->NumberOfThreads)
+    {
+    const vtkIdType sliceBegin = data->SliceStart[k - bounds[4]];
+    const vtkIdType sliceEnd = data->SliceStart[k - bounds[4] + 1];
+    if (sliceBegin == sliceEnd)
+      {
+      continue;
+      }
+    T* slice = scalars + (k - extent[4]) * incK;
+
+    // Sort the triangles of the slice by row
+    std::fill(rowStart.begin(), rowStart.end(), 0);
+    triangleRows.resize(2 * (sliceEnd - sliceBegin));
+    for (vtkIdType t = sliceBegin; t < sliceEnd; ++t)
+      {
+      const vtkIdType* ids = triangles + 3 * data->SliceTriangles[t];
+      double minimum = std::min(points[3 * ids[0] + 1],
+        std::min(points[3 * ids[1] + 1], points[3 * ids[2] + 1]));
+      double maximum = std::max(points[3 * ids[0] + 1],
+        std::max(points[3 * ids[1] + 1], points[3 * ids[2] + 1]));
+      int* range = &triangleRows[2 * (t - sliceBegin)];
+      if (!GetVoxelRange(minimum, maximum, bounds[2], bounds[3], range))
+        {
+        range[0] = 1;
+        range[1] = 0;
+        continue;
+        }
+      for (int j = range[0]; j <= range[1]; ++j)
+        {
+        ++rowStart[j - bounds[2] + 1];
+        }
+      }
+    for (int j = 0; j < numberOfRows; ++j)
+      {
+      rowStart[j + 1] += rowStart[j];
+      }
+    rowTriangles.resize(rowStart[numberOfRows]);
+    std::vector<vtkIdType> rowEnd(rowStart.begin(), rowStart.end() - 1);
+    for (vtkIdType t = sliceBegin; t < sliceEnd; ++t)
+      {
+      const int* range = &triangleRows[2 * (t - sliceBegin)];
+      for (int j = range[0]; j <= range[1]; ++j)
+        {
+        rowTriangles[rowEnd[j - bounds[2]]++] = data->SliceTriangles[t];
+        }
+      }
+
+    // Fill the voxels between pairs of crossings of each row
+    const double z = k + RayOffsetK;
+    for (int j = bounds[2]; j <= bounds[3]; ++j)
+      {
+      const double y = j + RayOffsetJ;
+      crossings.clear();
+      for (vtkIdType r = rowStart[j - bounds[2]]; r < rowStart[j - bounds[2] + 1]; ++r)
+        {
+        const vtkIdType* ids = triangles + 3 * rowTriangles[r];
+        const double* a = points + 3 * ids[0];
+        const double* b = points + 3 * ids[1];
+        const double* c = points + 3 * ids[2];
+        // Edge functions of the triangle projected on the slice. An edge
+        // shared by two triangles gets opposite values in both, so the ray
+        // crosses exactly one of them.
+        double wa = (b[1] - y) * (c[2] - z) - (b[2] - z) * (c[1] - y);
+        double wb = (c[1] - y) * (a[2] - z) - (c[2] - z) * (a[1] - y);
+        double wc = (a[1] - y) * (b[2] - z) - (a[2] - z) * (b[1] - y);
+        if (!((wa > 0 && wb > 0 && wc > 0) || (wa < 0 && wb < 0 && wc < 0)))
+          {
+          continue;
+          }
+        crossings.push_back((wa * a[0] + wb * b[0] + wc * c[0]) / (wa + wb + wc));
+        }
+      if (crossings.size() < 2)
+        {
+        continue;
+        }
+      std::sort(crossings.begin(), crossings.end());
+      T* row = slice + (j - extent[2]) * incJ - extent[0];
+      for (size_t c = 0; c + 1 < crossings.size(); c += 2)
+        {
+        int range[2];
+        if (!GetVoxelRange(crossings[c] + 0.5, crossings[c + 1] - 0.5, bounds[0], bounds[1], range))
+          {
+          continue;
+          }
+        std::fill(row + range[0], row + range[1] + 1, label);
+        }
+      }
+
+    // Set the voxels crossed by the surface
+    if (data->BoundarySampleDistance <= 0)
+      {
+      continue;
+      }
+    for (vtkIdType t = sliceBegin; t < sliceEnd; ++t)
+      {
+      const vtkIdType* ids = triangles + 3 * data->SliceTriangles[t];
+      const double* a = points + 3 * ids[0];
+      double ab[3], ac[3], bc[3];
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        ab[axis] = points[3 * ids[1] + axis] - a[axis];
+        ac[axis] = points[3 * ids[2] + axis] - a[axis];
+        bc[axis] = ac[axis] - ab[axis];
+        }
+      double edgeLength = sqrt(std::max(ab[0] * ab[0] + ab[1] * ab[1] + ab[2] * ab[2],
+        std::max(ac[0] * ac[0] + ac[1] * ac[1] + ac[2] * ac[2],
+          bc[0] * bc[0] + bc[1] * bc[1] + bc[2] * bc[2])));
+      int numberOfSteps = std::max(1, static_cast<int>(ceil(edgeLength / data->BoundarySampleDistance)));
+      for (int u = 0; u <= numberOfSteps; ++u)
+        {
+        for (int v = 0; v <= numberOfSteps - u; ++v)
+          {
+          double fu = static_cast<double>(u) / numberOfSteps;
+          double fv = static_cast<double>(v) / numberOfSteps;
+          if (static_cast<int>(floor(a[2] + fu * ab[2] + fv * ac[2] + 0.5)) != k)
+            {
+            continue;
+            }
+          int i = static_cast<int>(floor(a[0] + fu * ab[0] + fv * ac[0] + 0.5));
+          int jj = static_cast<int>(floor(a[1] + fu * ab[1] + fv * ac[1] + 0.5));
+          if (i >= bounds[0] && i <= bounds[1] && jj >= bounds[2] && jj <= bounds[3])
+            {
+            slice[(jj - extent[2]) * incJ + i - extent[0]] = label;
+            }
+          }
+        }
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Voxel of the extent with the lower corner of the trilinear interpolation
+// cell of ijk and the position of ijk in that cell. Return false if ijk is
+// outside of the extent.
+bool GetInterpolationCell(const double ijk[3], const int extent[6], int base[3], double fraction[3])
+{
+  const double tolerance = 1e-6;
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    double first = extent[2 * axis];
+    double last = extent[2 * axis + 1];
+    if (!(ijk[axis] >= first - tolerance && ijk[axis] <= last + tolerance))
+      {
+      return false;
+      }
+    double position = std::min(std::max(ijk[axis], first), last);
+    base[axis] = std::min(static_cast<int>(floor(position)), std::max(extent[2 * axis], extent[2 * axis + 1] - 1));
+    fraction[axis] = position - base[axis];
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+struct ProbeData
+{
+  int Extent[6];
+  // Model points in IJK
+  std::vector<double> Points;
+  void* Source;
+  void* Output;
+  int NumberOfComponents;
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+VTK_THREAD_RETURN_TYPE ProbeThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  ProbeData* data = static_cast<ProbeData*>(info->UserData);
+  const int* extent = data->Extent;
+  const int numberOfComponents = data->NumberOfComponents;
+  const vtkIdType incJ = numberOfComponents * static_cast<vtkIdType>(extent[1] - extent[0] + 1);
+  const vtkIdType incK = incJ * (extent[3] - extent[2] + 1);
+  // Offsets of the neighbors of the lower corner, 0 along flat axes
+  const vtkIdType offsetI = extent[1] > extent[0] ? numberOfComponents : 0;
+  const vtkIdType offsetJ = extent[3] > extent[2] ? incJ : 0;
+  const vtkIdType offsetK = extent[5] > extent[4] ? incK : 0;
+  const T* source = static_cast<const T*>(data->Source);
+  T* output = static_cast<T*>(data->Output);
+
+  const vtkIdType numberOfPoints = static_cast<vtkIdType>(data->Points.size() / 3);
+  const vtkIdType begin = numberOfPoints * info->ThreadID / info->NumberOfThreads;
+  const vtkIdType end = numberOfPoints * (info->ThreadID + 1) / info->NumberOfThreads;
+  for (vtkIdType p = begin; p < end; ++p)
+    {
+    T* value = output + p * numberOfComponents;
+    int base[3];
+    double f[3];
+    if (!GetInterpolationCell(&data->Points[3 * p], extent, base, f))
+      {
+      std::fill(value, value + numberOfComponents, static_cast<T>(0));
+      continue;
+      }
+    const T* v000 = source + (base[2] - extent[4]) * incK + (base[1] - extent[2]) * incJ
+      + (base[0] - extent[0]) * numberOfComponents;
+    const T* v100 = v000 + offsetI;
+    const T* v010 = v000 + offsetJ;
+    const T* v110 = v010 + offsetI;
+    const T* v001 = v000 + offsetK;
+    const T* v101 = v001 + offsetI;
+    const T* v011 = v001 + offsetJ;
+    const T* v111 = v011 + offsetI;
+    for (int c = 0; c < numberOfComponents; ++c)
+      {
+      double v00 = v000[c] + f[0] * (v100[c] - static_cast<double>(v000[c]));
+      double v10 = v010[c] + f[0] * (v110[c] - static_cast<double>(v010[c]));
+      double v01 = v001[c] + f[0] * (v101[c] - static_cast<double>(v001[c]));
+      double v11 = v011[c] + f[0] * (v111[c] - static_cast<double>(v011[c]));
+      double v0 = v00 + f[1] * (v10 - v00);
+      double v1 = v01 + f[1] * (v11 - v01);
+      value[c] = CastValue<T>(v0 + f[2] * (v1 - v0));
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void TransformPoints(vtkPoints* points, vtkMatrix4x4* worldToIJK, std::vector<double>& ijkPoints)
+{
+  vtkIdType numberOfPoints = points ? points->GetNumberOfPoints() : 0;
+  ijkPoints.resize(3 * numberOfPoints);
+  for (vtkIdType p = 0; p < numberOfPoints; ++p)
+    {
+    double world[4] = {0.0, 0.0, 0.0, 1.0};
+    points->GetPoint(p, world);
+    double ijk[4];
+    worldToIJK->MultiplyPoint(world, ijk);
+    ijkPoints[3 * p] = ijk[0];
+    ijkPoints[3 * p + 1] = ijk[1];
+    ijkPoints[3 * p + 2] = ijk[2];
+    }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+void vtkPluginMeshVolumeUtilities::RasterizeSurface(vtkPolyData* surface,
+  vtkMatrix4x4* worldToIJK, vtkImageData* labelMap, double label,
+  double boundarySampleDistance, int numberOfThreads)
+{
+  if (!surface || !worldToIJK || !labelMap
+    || !labelMap->GetPointData()->GetScalars()
+    || labelMap->GetNumberOfScalarComponents() != 1)
+    {
+    return;
+    }
+
+  vtkNew<vtkTriangleFilter> triangulator;
+  triangulator->SetInputData(surface);
+  triangulator->PassVertsOff();
+  triangulator->PassLinesOff();
+  triangulator->Update();
+  vtkPolyData* triangulated = triangulator->GetOutput();
+  if (triangulated->GetNumberOfPolys() == 0)
+    {
+    return;
+    }
+
+  RasterizeData data;
+  labelMap->GetExtent(data.Extent);
+  data.Scalars = labelMap->GetScalarPointer();
+  data.Label = label;
+  data.BoundarySampleDistance = boundarySampleDistance;
+  TransformPoints(triangulated->GetPoints(), worldToIJK, data.Points);
+
+  // Only visit the voxels in the bounding box of the surface
+  double bounds[6] = {VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN,
+    VTK_DOUBLE_MAX, VTK_DOUBLE_MIN};
+  for (size_t p = 0; p < data.Points.size(); p += 3)
+    {
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      bounds[2 * axis] = std::min(bounds[2 * axis], data.Points[p + axis]);
+      bounds[2 * axis + 1] = std::max(bounds[2 * axis + 1], data.Points[p + axis]);
+      }
+    }
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    if (!GetVoxelRange(bounds[2 * axis], bounds[2 * axis + 1],
+      data.Extent[2 * axis], data.Extent[2 * axis + 1], data.Bounds + 2 * axis))
+      {
+      return;
+      }
+    }
+
+  // Sort the triangles by slice
+  vtkCellArray* polys = triangulated->GetPolys();
+  data.Triangles.reserve(3 * polys->GetNumberOfCells());
+  const int numberOfSlices = data.Bounds[5] - data.Bounds[4] + 1;
+  data.SliceStart.resize(numberOfSlices + 1, 0);
+  std::vector<int> triangleSlices;
+  triangleSlices.reserve(2 * polys->GetNumberOfCells());
+  vtkIdType npts = 0;
+  vtkIdType* pts = 0;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+    {
+    if (npts != 3)
+      {
+      continue;
+      }
+    double minimum = std::min(data.Points[3 * pts[0] + 2],
+      std::min(data.Points[3 * pts[1] + 2], data.Points[3 * pts[2] + 2]));
+    double maximum = std::max(data.Points[3 * pts[0] + 2],
+      std::max(data.Points[3 * pts[1] + 2], data.Points[3 * pts[2] + 2]));
+    int range[2];
+    if (!GetVoxelRange(minimum, maximum, data.Bounds[4], data.Bounds[5], range))
+      {
+      continue;
+      }
+    data.Triangles.insert(data.Triangles.end(), pts, pts + 3);
+    triangleSlices.push_back(range[0]);
+    triangleSlices.push_back(range[1]);
+    for (int k = range[0]; k <= range[1]; ++k)
+      {
+      ++data.SliceStart[k - data.Bounds[4] + 1];
+      }
+    }
+  if (data.Triangles.empty())
+    {
+    return;
+    }
+  for (int k = 0; k < numberOfSlices; ++k)
+    {
+    data.SliceStart[k + 1] += data.SliceStart[k];
+    }
+  data.SliceTriangles.resize(data.SliceStart[numberOfSlices]);
+  std::vector<vtkIdType> sliceEnd(data.SliceStart.begin(), data.SliceStart.end() - 1);
+  for (size_t t = 0; t < triangleSlices.size() / 2; ++t)
+    {
+    for (int k = triangleSlices[2 * t]; k <= triangleSlices[2 * t + 1]; ++k)
+      {
+      data.SliceTriangles[sliceEnd[k - data.Bounds[4]]++] = static_cast<vtkIdType>(t);
+      }
+    }
+
+  vtkNew<vtkMultiThreader> threader;
+  threader->SetNumberOfThreads(std::min(GetNumberOfThreads(numberOfThreads), numberOfSlices));
+  switch (labelMap->GetScalarType())
+    {
+    vtkTemplateMacro(threader->SetSingleMethod(RasterizeThreadFunction<VTK_TT>, &data));
+    default:
+      return;
+    }
+  threader->SingleMethodExecute();
+  labelMap->GetPointData()->GetScalars()->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkPluginMeshVolumeUtilities::ProbeImage(vtkImageData* image,
+  vtkMatrix4x4* worldToIJK, vtkPolyData* model, int numberOfThreads)
+{
+  if (!image || !worldToIJK || !model)
+    {
+    return;
+    }
+
+  ProbeData data;
+  image->GetExtent(data.Extent);
+  TransformPoints(model->GetPoints(), worldToIJK, data.Points);
+  const vtkIdType numberOfPoints = static_cast<vtkIdType>(data.Points.size() / 3);
+
+  vtkNew<vtkCharArray> mask;
+  mask->SetName("vtkValidPointMask");
+  mask->SetNumberOfTuples(numberOfPoints);
+  for (vtkIdType p = 0; p < numberOfPoints; ++p)
+    {
+    int base[3];
+    double fraction[3];
+    mask->SetValue(p, GetInterpolationCell(&data.Points[3 * p], data.Extent, base, fraction) ? 1 : 0);
+    }
+
+  vtkPointData* imagePointData = image->GetPointData();
+  vtkPointData* modelPointData = model->GetPointData();
+  vtkNew<vtkMultiThreader> threader;
+  threader->SetNumberOfThreads(GetNumberOfThreads(numberOfThreads));
+  for (int i = 0; i < imagePointData->GetNumberOfArrays(); ++i)
+    {
+    vtkDataArray* source = imagePointData->GetArray(i);
+    if (!source || source->GetNumberOfTuples() != image->GetNumberOfPoints())
+      {
+      continue;
+      }
+    vtkSmartPointer<vtkDataArray> output =
+      vtkSmartPointer<vtkDataArray>::Take(source->NewInstance());
+    output->SetName(source->GetName());
+    output->SetNumberOfComponents(source->GetNumberOfComponents());
+    output->SetNumberOfTuples(numberOfPoints);
+    data.Source = source->GetVoidPointer(0);
+    data.Output = output->GetVoidPointer(0);
+    data.NumberOfComponents = source->GetNumberOfComponents();
+    bool supportedType = true;
+    switch (source->GetDataType())
+      {
+      vtkTemplateMacro(threader->SetSingleMethod(ProbeThreadFunction<VTK_TT>, &data));
+      default:
+        supportedType = false;
+      }
+    if (!supportedType)
+      {
+      continue;
+      }
+    if (numberOfPoints > 0)
+      {
+      threader->SingleMethodExecute();
+      }
+
+    if (source->GetName())
+      {
+      modelPointData->RemoveArray(source->GetName());
+      }
+    int attribute = imagePointData->IsArrayAnAttribute(i);
+    if (attribute >= 0)
+      {
+      modelPointData->SetAttribute(output, attribute);
+      }
+    else
+      {
+      modelPointData->AddArray(output);
+      }
+    }
+  modelPointData->RemoveArray(mask->GetName());
+  modelPointData->AddArray(mask.GetPointer());
+}
@@ -0,0 +1,57 @@
+#ifndef __vtkPluginMeshVolumeUtilities_h
+#define __vtkPluginMeshVolumeUtilities_h
+
+#include "vtkSlicerBaseCLIWin32Header.h"
+
+class vtkImageData;
+class vtkMatrix4x4;
+class vtkPolyData;
+
+/** \class vtkPluginMeshVolumeUtilities
+ * \brief Multithreaded operations between models and volumes shared by the
+ * CLI modules.
+ *
+ * The points of the models are mapped to the voxels with a world to IJK
+ * matrix, the image origin and spacing are ignored. Only the voxels in the
+ * bounding box of a model are visited, so the cost depends on the size of
+ * the model rather than on the size of the volume. Work is split between
+ * threads with vtkMultiThreader. A number of threads of 0 uses
+ * vtkMultiThreader::GetGlobalDefaultNumberOfThreads().
+ *
+ * Example of use:
+ *
+ * vtkNew<vtkMatrix4x4> rasToIJK;
+ * for (size_t i = 0; i < models.size(); ++i)
+ *   {
+ *   vtkPluginMeshVolumeUtilities::RasterizeSurface(
+ *     models[i], rasToIJK.GetPointer(), labelMap, labels[i]);
+ *   }
+ */
+class VTK_SLICER_BASE_CLI_EXPORT vtkPluginMeshVolumeUtilities
+{
+public:
+  /** Set the voxels of \a labelMap inside the closed \a surface to
+   * \a label. A voxel is inside when its center is inside: rays along the
+   * rows of each slice are intersected with the triangles and the voxels
+   * between pairs of crossings are set, so models with several pieces or
+   * with cavities are supported.
+   * When \a boundarySampleDistance is positive, the voxels crossed by the
+   * surface are set as well: the triangles are sampled with points at most
+   * \a boundarySampleDistance apart (in voxels).
+   * Slices are distributed between the threads, every voxel is written by
+   * one thread only. \a labelMap must have one scalar component. */
+  static void RasterizeSurface(vtkPolyData* surface, vtkMatrix4x4* worldToIJK,
+    vtkImageData* labelMap, double label, double boundarySampleDistance = 0.5,
+    int numberOfThreads = 0);
+
+  /** Add to the point data of \a model the trilinear interpolation of each
+   * point data array of \a image at the model points.
+   * The interpolated arrays have the name, type and number of components of
+   * the image arrays and replace the model arrays with the same name.
+   * Points outside of the image get 0 and are flagged 0 in a
+   * "vtkValidPointMask" array, as with vtkProbeFilter. */
+  static void ProbeImage(vtkImageData* image, vtkMatrix4x4* worldToIJK,
+    vtkPolyData* model, int numberOfThreads = 0);
+};
+
+#endif
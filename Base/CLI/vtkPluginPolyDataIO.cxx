@@ -0,0 +1,156 @@
+#include "vtkPluginPolyDataIO.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataReader.h>
+#include <vtkPolyDataWriter.h>
+#include <vtkXMLPolyDataReader.h>
+#include <vtkXMLPolyDataWriter.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+const char* MemoryReferencePrefix = "slicer:polydata:";
+}
+
+//----------------------------------------------------------------------------
+bool vtkPluginPolyDataIO::IsMemoryReference(const std::string& fileName)
+{
+  return fileName.compare(0, strlen(MemoryReferencePrefix), MemoryReferencePrefix) == 0;
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData* vtkPluginPolyDataIO::GetMemoryReference(const std::string& fileName)
+{
+  if (!vtkPluginPolyDataIO::IsMemoryReference(fileName))
+    {
+    return NULL;
+    }
+  void* address = NULL;
+  if (sscanf(fileName.c_str() + strlen(MemoryReferencePrefix), "%p", &address) != 1)
+    {
+    return NULL;
+    }
+  return static_cast<vtkPolyData*>(address);
+}
+
+//----------------------------------------------------------------------------
+std::string vtkPluginPolyDataIO::CreateMemoryReference(vtkPolyData* polyData)
+{
+  char address[64];
+  sprintf(address, "%p", static_cast<void*>(polyData));
+  return std::string(MemoryReferencePrefix) + address;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPluginPolyDataIO::ReadPolyData(const std::string& fileName, vtkPolyData* polyData)
+{
+  if (!polyData)
+    {
+    return false;
+    }
+  if (vtkPluginPolyDataIO::IsMemoryReference(fileName))
+    {
+    vtkPolyData* source = vtkPluginPolyDataIO::GetMemoryReference(fileName);
+    if (!source)
+      {
+      std::cerr << "Invalid model reference " << fileName << std::endl;
+      return false;
+      }
+    // The source belongs to the scene, only share its arrays
+    polyData->ShallowCopy(source);
+    return true;
+    }
+
+  std::string extension = vtksys::SystemTools::LowerCase(
+    vtksys::SystemTools::GetFilenameLastExtension(fileName) );
+  if (extension == std::string(".vtk"))
+    {
+    vtkNew<vtkPolyDataReader> reader;
+    reader->SetFileName(fileName.c_str());
+    reader->Update();
+    if (reader->GetErrorCode() != 0)
+      {
+      std::cerr << "Failed to read model " << fileName << std::endl;
+      return false;
+      }
+    polyData->ShallowCopy(reader->GetOutput());
+    }
+  else if (extension == std::string(".vtp"))
+    {
+    vtkNew<vtkXMLPolyDataReader> reader;
+    reader->SetFileName(fileName.c_str());
+    reader->Update();
+    if (reader->GetErrorCode() != 0)
+      {
+      std::cerr << "Failed to read model " << fileName << std::endl;
+      return false;
+      }
+    polyData->ShallowCopy(reader->GetOutput());
+    }
+  else
+    {
+    std::cerr << "Unsupported model file format " << fileName << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPluginPolyDataIO::WritePolyData(const std::string& fileName, vtkPolyData* polyData)
+{
+  if (!polyData)
+    {
+    return false;
+    }
+  if (vtkPluginPolyDataIO::IsMemoryReference(fileName))
+    {
+    vtkPolyData* target = vtkPluginPolyDataIO::GetMemoryReference(fileName);
+    if (!target)
+      {
+      std::cerr << "Invalid model reference " << fileName << std::endl;
+      return false;
+      }
+    // The target outlives the module, it can't share the module arrays
+    target->DeepCopy(polyData);
+    return true;
+    }
+
+  std::string extension = vtksys::SystemTools::LowerCase(
+    vtksys::SystemTools::GetFilenameLastExtension(fileName) );
+  if (extension == std::string(".vtk"))
+    {
+    vtkNew<vtkPolyDataWriter> writer;
+    writer->SetFileName(fileName.c_str());
+    writer->SetInputData(polyData);
+    if (!writer->Write())
+      {
+      std::cerr << "Failed to write model " << fileName << std::endl;
+      return false;
+      }
+    }
+  else if (extension == std::string(".vtp"))
+    {
+    vtkNew<vtkXMLPolyDataWriter> writer;
+    writer->SetIdTypeToInt32();
+    writer->SetFileName(fileName.c_str());
+    writer->SetInputData(polyData);
+    if (!writer->Write())
+      {
+      std::cerr << "Failed to write model " << fileName << std::endl;
+      return false;
+      }
+    }
+  else
+    {
+    std::cerr << "Unsupported model file format " << fileName << std::endl;
+    return false;
+    }
+  return true;
+}
@@ -0,0 +1,55 @@
+#ifndef __vtkPluginPolyDataIO_h
+#define __vtkPluginPolyDataIO_h
+
+#include "vtkSlicerBaseCLIWin32Header.h"
+
+// STD includes
+#include <string>
+
+class vtkPolyData;
+
+/** \class vtkPluginPolyDataIO
+ * \brief Read and write model parameters of a CLI module.
+ *
+ * When a CLI module is run as a shared object module, Slicer can
+ * communicate models directly in memory instead of through temporary
+ * files. The parameter is then a reference of the form
+ * "slicer:polydata:<address>" where the address is the one of a
+ * vtkPolyData living in the Slicer process. Otherwise the parameter is a
+ * regular filename and the model is read or written with the VTK reader or
+ * writer matching its extension (.vtk or .vtp).
+ *
+ * Example of use:
+ *
+ * vtkNew<vtkPolyData> model;
+ * if (!vtkPluginPolyDataIO::ReadPolyData(InputModel, model.GetPointer()))
+ *   {
+ *   return EXIT_FAILURE;
+ *   }
+ *
+ * \sa vtkSlicerCLIModuleLogic::SetInMemoryModelTransfer()
+ */
+class VTK_SLICER_BASE_CLI_EXPORT vtkPluginPolyDataIO
+{
+public:
+  /** Return true if \a fileName references a vtkPolyData in memory. */
+  static bool IsMemoryReference(const std::string& fileName);
+
+  /** Return the vtkPolyData referenced by \a fileName or NULL if
+   * \a fileName is not a memory reference. */
+  static vtkPolyData* GetMemoryReference(const std::string& fileName);
+
+  /** Build a reference to \a polyData that can be passed as parameter
+   * to a shared object module. */
+  static std::string CreateMemoryReference(vtkPolyData* polyData);
+
+  /** Read the model referenced by \a fileName into \a polyData.
+   * Return false and print an error to std::cerr on failure. */
+  static bool ReadPolyData(const std::string& fileName, vtkPolyData* polyData);
+
+  /** Write \a polyData to the file or memory referenced by \a fileName.
+   * Return false and print an error to std::cerr on failure. */
+  static bool WritePolyData(const std::string& fileName, vtkPolyData* polyData);
+};
+
+#endif
@@ -166,6 +166,56 @@ int vtkArchiveTest1(int argc, char * argv[] )
     std::cerr << "failed to extract archive : " << "extractedArchiveTest" << std::endl;
     return EXIT_FAILURE;
     }
+  vtksys::SystemTools::ChangeDirectory("..");
+
+  //
+  // Create a zip file without compression and extract it
+  //
+  std::cout << "creating archiveTestStored.zip" << std::endl;
+  std::string storedZipFilePath = vtksys::SystemTools::GetCurrentWorkingDirectory() +
+                                                    std::string("/archiveTestStored.zip");
+  res = zip(storedZipFilePath.c_str(), zipDirPath.c_str(), 0);
+  if (!res)
+    {
+    std::cerr << "failed to create new archive without compression" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( vtksys::SystemTools::FileExists("extractedArchiveTestStored") )
+    {
+    vtksys::SystemTools::RemoveADirectory("extractedArchiveTestStored");
+    }
+  vtksys::SystemTools::MakeDirectory("extractedArchiveTestStored");
+  std::vector<std::string> extractedFiles;
+  res = unzip(storedZipFilePath.c_str(), "extractedArchiveTestStored", &extractedFiles);
+  if (!res)
+    {
+    std::cerr << "failed to extract new archive without compression" << std::endl;
+    return EXIT_FAILURE;
+    }
+  // the two scene files (directory entries have an empty file name)
+  validFiles = 0;
+  for (size_t i = 0; i < extractedFiles.size(); i++)
+    {
+    if ( validFile(vtksys::SystemTools::GetFilenameName(extractedFiles[i]).c_str()) ) validFiles++;
+    }
+  if (validFiles != 2)
+    {
+    std::cerr << "unzip did not list the extracted files: " << validFiles << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtksys::SystemTools::ChangeDirectory("extractedArchiveTestStored");
+  cwd.Load("archiveTest");
+  numberOfFiles = cwd.GetNumberOfFiles();
+  validFiles = 0;
+  for (unsigned int i = 0; i < numberOfFiles; i++)
+    {
+    if ( validFile(cwd.GetFile(i)) ) validFiles++;
+    }
+  if (validFiles != 4)
+    {
+    std::cerr << "failed to extract archive : " << "extractedArchiveTestStored" << std::endl;
+    return EXIT_FAILURE;
+    }
 
   return EXIT_SUCCESS;
 }
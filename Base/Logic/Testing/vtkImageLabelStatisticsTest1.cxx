@@ -0,0 +1,130 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Slicer includes
+#include "vtkImageLabelStatistics.h"
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <cmath>
+
+namespace
+{
+//----------------------------------------------------------------------------
+bool CheckValue(const char* name, double actual, double expected)
+{
+  if (fabs(actual - expected) > 1e-6)
+    {
+    std::cerr << name << ": expected " << expected
+              << ", got " << actual << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLabelStatisticsTest1(int vtkNotUsed(argc), char * vtkNotUsed(argv)[])
+{
+  vtkNew<vtkImageLabelStatistics> statistics;
+  EXERCISE_BASIC_OBJECT_METHODS(statistics.GetPointer());
+
+  // Labelmap: label 3 in slice 0 (16 voxels), label 7 in the first row of slice 1 (4 voxels),
+  // background in the rest of slice 1 (12 voxels).
+  // Scalars: voxel value is its index in the image.
+  vtkNew<vtkImageData> labels;
+  labels->SetExtent(0, 3, 0, 3, 0, 1);
+  labels->AllocateScalars(VTK_SHORT, 1);
+  vtkNew<vtkImageData> scalars;
+  scalars->SetExtent(0, 3, 0, 3, 0, 1);
+  scalars->AllocateScalars(VTK_INT, 1);
+  short* labelPtr = static_cast<short*>(labels->GetScalarPointer());
+  int* scalarPtr = static_cast<int*>(scalars->GetScalarPointer());
+  for (int k = 0; k < 2; ++k)
+    {
+    for (int j = 0; j < 4; ++j)
+      {
+      for (int i = 0; i < 4; ++i)
+        {
+        *(labelPtr++) = (k == 0 ? 3 : (j == 0 ? 7 : 0));
+        *(scalarPtr++) = (k * 4 + j) * 4 + i;
+        }
+      }
+    }
+
+  statistics->SetLabelImageData(labels.GetPointer());
+  statistics->SetScalarImageData(scalars.GetPointer());
+  statistics->ComputeHistogramsOn();
+  statistics->SetNumberOfThreads(2);
+  if (!statistics->Update())
+    {
+    std::cerr << "Line " << __LINE__ << " - Update failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (statistics->GetNumberOfLabels() != 3
+    || statistics->GetLabelValue(0) != 0 || statistics->GetLabelValue(1) != 3 || statistics->GetLabelValue(2) != 7
+    || statistics->GetLabelIndex(7) != 2 || statistics->GetLabelIndex(5) != -1)
+    {
+    std::cerr << "Line " << __LINE__ << " - Unexpected labels" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  int label3 = statistics->GetLabelIndex(3);
+  if (statistics->GetVoxelCount(label3) != 16
+    || !CheckValue("label 3 minimum", statistics->GetMinimum(label3), 0.0)
+    || !CheckValue("label 3 maximum", statistics->GetMaximum(label3), 15.0)
+    || !CheckValue("label 3 mean", statistics->GetMean(label3), 7.5)
+    || !CheckValue("label 3 standard deviation", statistics->GetStandardDeviation(label3), sqrt(340.0 / 15.0))
+    || !CheckValue("label 3 median", statistics->GetMedian(label3), 7.0)
+    || !CheckValue("label 3 25th percentile", statistics->GetPercentile(label3, 25.0), 3.0)
+    || !CheckValue("label 3 100th percentile", statistics->GetPercentile(label3, 100.0), 15.0))
+    {
+    std::cerr << "Line " << __LINE__ << " - Unexpected statistics of label 3" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  int label7 = statistics->GetLabelIndex(7);
+  if (statistics->GetVoxelCount(label7) != 4
+    || !CheckValue("label 7 mean", statistics->GetMean(label7), 17.5)
+    || !CheckValue("label 7 median", statistics->GetMedian(label7), 17.0))
+    {
+    std::cerr << "Line " << __LINE__ << " - Unexpected statistics of label 7" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Interpolated percentiles
+  statistics->SetNumberOfHistogramBins(4);
+  if (!statistics->Update()
+    || !CheckValue("label 3 interpolated median", statistics->GetMedian(label3), 7.75))
+    {
+    std::cerr << "Line " << __LINE__ << " - Unexpected interpolated percentile" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Voxel counts only
+  statistics->SetScalarImageData(NULL);
+  if (!statistics->Update() || statistics->GetNumberOfLabels() != 3 || statistics->GetVoxelCount(0) != 12)
+    {
+    std::cerr << "Line " << __LINE__ << " - Unexpected voxel counts" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
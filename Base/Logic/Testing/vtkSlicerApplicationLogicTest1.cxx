@@ -22,13 +22,191 @@
 #include "vtkSlicerApplicationLogic.h"
 #include "vtkMRMLCoreTestingMacros.h"
 #include "vtkSlicerConfigure.h"
+#include "vtkSlicerTask.h"
 
 // Slicer MRML includes
 #include "vtkMRMLScene.h"
+#include "vtkMRMLLinearTransformNode.h"
 #include "vtkMRMLModelHierarchyNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
 
 // VTK includes
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkMultiThreader.h>
 #include <vtkNew.h>
+#include <vtkObjectFactory.h>
+
+// ITK includes
+#include <itkMutexLock.h>
+#include <itksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+// Logic counting how many of its tasks run at the same time
+class vtkConcurrentTaskLogic : public vtkMRMLAbstractLogic
+{
+public:
+  static vtkConcurrentTaskLogic *New();
+  vtkTypeMacro(vtkConcurrentTaskLogic, vtkMRMLAbstractLogic);
+
+  void RunTask(void*)
+  {
+    this->Lock->Lock();
+    ++this->NumberOfRunningTasks;
+    this->MaximumNumberOfRunningTasks =
+      std::max(this->MaximumNumberOfRunningTasks, this->NumberOfRunningTasks);
+    this->Lock->Unlock();
+
+    itksys::SystemTools::Delay(500);
+
+    this->Lock->Lock();
+    --this->NumberOfRunningTasks;
+    ++this->NumberOfCompletedTasks;
+    this->Lock->Unlock();
+  }
+
+  int GetNumberOfCompletedTasks()
+  {
+    this->Lock->Lock();
+    int completed = this->NumberOfCompletedTasks;
+    this->Lock->Unlock();
+    return completed;
+  }
+
+  itk::MutexLock::Pointer Lock;
+  int NumberOfRunningTasks;
+  int MaximumNumberOfRunningTasks;
+  int NumberOfCompletedTasks;
+
+protected:
+  vtkConcurrentTaskLogic()
+  {
+    this->Lock = itk::MutexLock::New();
+    this->NumberOfRunningTasks = 0;
+    this->MaximumNumberOfRunningTasks = 0;
+    this->NumberOfCompletedTasks = 0;
+  }
+};
+vtkStandardNewMacro(vtkConcurrentTaskLogic);
+
+//-----------------------------------------------------------------------------
+bool RunConcurrentTasks(int numberOfTasks, int threadsPerTask, int& maximumNumberOfRunningTasks)
+{
+  vtkNew<vtkSlicerApplicationLogic> appLogic;
+  appLogic->SetNumberOfProcessingThreads(3);
+  appLogic->SetProcessingThreadsBudget(4);
+  appLogic->CreateProcessingThread();
+
+  vtkNew<vtkConcurrentTaskLogic> taskLogic;
+  for (int i = 0; i < numberOfTasks; ++i)
+    {
+    vtkNew<vtkSlicerTask> task;
+    task->SetTypeToProcessing();
+    task->SetNumberOfThreads(threadsPerTask);
+    task->SetTaskFunction(taskLogic.GetPointer(), (vtkSlicerTask::TaskFunctionPointer)
+                          &vtkConcurrentTaskLogic::RunTask, 0);
+    if (!appLogic->ScheduleTask(task.GetPointer()))
+      {
+      std::cerr << "Line " << __LINE__ << " - Failed to schedule task" << std::endl;
+      return false;
+      }
+    }
+  // wait at most 20s for the tasks to complete
+  for (int i = 0; i < 200 && taskLogic->GetNumberOfCompletedTasks() < numberOfTasks; ++i)
+    {
+    itksys::SystemTools::Delay(100);
+    }
+  appLogic->TerminateProcessingThread();
+  if (taskLogic->GetNumberOfCompletedTasks() != numberOfTasks)
+    {
+    std::cerr << "Line " << __LINE__ << " - Only " << taskLogic->GetNumberOfCompletedTasks()
+              << " tasks completed out of " << numberOfTasks << std::endl;
+    return false;
+    }
+  maximumNumberOfRunningTasks = taskLogic->MaximumNumberOfRunningTasks;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+// Producer thread streaming images and poses to the nodes
+struct StreamingThreadData
+{
+  vtkSlicerApplicationLogic* AppLogic;
+  std::string VolumeNodeID;
+  std::string TransformNodeID;
+  int NumberOfFrames;
+};
+
+//-----------------------------------------------------------------------------
+ITK_THREAD_RETURN_TYPE StreamingThreadCallback(void* arg)
+{
+  itk::MultiThreader::ThreadInfoStruct* info =
+    static_cast<itk::MultiThreader::ThreadInfoStruct*>(arg);
+  StreamingThreadData* data = static_cast<StreamingThreadData*>(info->UserData);
+  for (int frame = 1; frame <= data->NumberOfFrames; ++frame)
+    {
+    vtkNew<vtkImageData> image;
+    image->SetDimensions(frame, 1, 1);
+    image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+    data->AppLogic->RequestSetImageData(data->VolumeNodeID.c_str(), image.GetPointer());
+    vtkNew<vtkMatrix4x4> matrix;
+    matrix->SetElement(0, 3, frame);
+    data->AppLogic->RequestSetMatrixTransformToParent(data->TransformNodeID.c_str(), matrix.GetPointer());
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+bool TestStreamedData()
+{
+  vtkNew<vtkSlicerApplicationLogic> appLogic;
+  vtkNew<vtkMRMLScene> scene;
+  appLogic->SetMRMLScene(scene.GetPointer());
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  scene->AddNode(volumeNode.GetPointer());
+  vtkNew<vtkMRMLLinearTransformNode> transformNode;
+  scene->AddNode(transformNode.GetPointer());
+
+  StreamingThreadData data;
+  data.AppLogic = appLogic.GetPointer();
+  data.VolumeNodeID = volumeNode->GetID();
+  data.TransformNodeID = transformNode->GetID();
+  data.NumberOfFrames = 50;
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  int threadID = threader->SpawnThread(StreamingThreadCallback, &data);
+  threader->TerminateThread(threadID);
+
+  // only the newest frame is set
+  if (appLogic->ProcessStreamedData() != 2)
+    {
+    std::cerr << "Line " << __LINE__ << " - Expected 2 updated nodes" << std::endl;
+    return false;
+    }
+  int dimensions[3] = {0, 0, 0};
+  if (volumeNode->GetImageData())
+    {
+    volumeNode->GetImageData()->GetDimensions(dimensions);
+    }
+  vtkNew<vtkMatrix4x4> matrix;
+  transformNode->GetMatrixTransformToParent(matrix.GetPointer());
+  if (dimensions[0] != data.NumberOfFrames ||
+      matrix->GetElement(0, 3) != data.NumberOfFrames)
+    {
+    std::cerr << "Line " << __LINE__ << " - Newest streamed data not set: image dimension "
+              << dimensions[0] << ", translation " << matrix->GetElement(0, 3) << std::endl;
+    return false;
+    }
+  // nothing left to process
+  if (appLogic->ProcessStreamedData() != 0)
+    {
+    std::cerr << "Line " << __LINE__ << " - Expected no updated node" << std::endl;
+    return false;
+    }
+  return true;
+}
 
 //-----------------------------------------------------------------------------
 int vtkSlicerApplicationLogicTest1(int , char * [])
@@ -327,6 +505,70 @@ int vtkSlicerApplicationLogicTest1(int , char * [])
     }
   }
 
+  //-----------------------------------------------------------------------------
+  // Test concurrent processing tasks limited by the threads budget
+  //-----------------------------------------------------------------------------
+  {
+  int maximumNumberOfRunningTasks = 0;
+  // 3 processing threads, 4 threads budget: 3 single threaded tasks run together
+  if (!RunConcurrentTasks(3, 1, maximumNumberOfRunningTasks))
+    {
+    return EXIT_FAILURE;
+    }
+  if (maximumNumberOfRunningTasks != 3)
+    {
+    std::cerr << "Line " << __LINE__ << " - Expected 3 concurrent tasks, got "
+              << maximumNumberOfRunningTasks << std::endl;
+    return EXIT_FAILURE;
+    }
+  // only 2 tasks of 2 threads fit in the budget
+  if (!RunConcurrentTasks(3, 2, maximumNumberOfRunningTasks))
+    {
+    return EXIT_FAILURE;
+    }
+  if (maximumNumberOfRunningTasks != 2)
+    {
+    std::cerr << "Line " << __LINE__ << " - Expected 2 concurrent tasks, got "
+              << maximumNumberOfRunningTasks << std::endl;
+    return EXIT_FAILURE;
+    }
+  // a task larger than the budget still runs, alone
+  if (!RunConcurrentTasks(2, 8, maximumNumberOfRunningTasks))
+    {
+    return EXIT_FAILURE;
+    }
+  if (maximumNumberOfRunningTasks != 1)
+    {
+    std::cerr << "Line " << __LINE__ << " - Expected 1 concurrent task, got "
+              << maximumNumberOfRunningTasks << std::endl;
+    return EXIT_FAILURE;
+    }
+  }
+
+  //-----------------------------------------------------------------------------
+  // Test RequestSetImageData, RequestSetMatrixTransformToParent and ProcessStreamedData
+  //-----------------------------------------------------------------------------
+  if (!TestStreamedData())
+    {
+    return EXIT_FAILURE;
+    }
+
+  //-----------------------------------------------------------------------------
+  // Test SetMaximumNumberOfThreads
+  //-----------------------------------------------------------------------------
+  {
+  vtkNew<vtkSlicerApplicationLogic> appLogic;
+  appLogic->SetMaximumNumberOfThreads(2);
+  CHECK_INT(appLogic->GetMaximumNumberOfThreads(), 2);
+  CHECK_INT(static_cast<int>(itk::MultiThreader::GetGlobalDefaultNumberOfThreads()), 2);
+  CHECK_INT(vtkMultiThreader::GetGlobalDefaultNumberOfThreads(), 2);
+  CHECK_INT(appLogic->GetProcessingThreadsBudget(), 2);
+  appLogic->SetMaximumNumberOfThreads(0);
+  CHECK_INT(appLogic->GetMaximumNumberOfThreads(), 0);
+  CHECK_INT(static_cast<int>(itk::MultiThreader::GetGlobalDefaultNumberOfThreads()),
+    static_cast<int>(itk::MultiThreader::GetGlobalDefaultNumberOfThreadsByPlatform()));
+  }
+
   return EXIT_SUCCESS;
 }
 
@@ -4,6 +4,8 @@
 
 // MRML includes
 #include "vtkCacheManager.h"
+#include "vtkMRMLDisplayableNode.h"
+#include "vtkMRMLDisplayNode.h"
 #include "vtkMRMLStorageNode.h"
 #include "vtkMRMLStorableNode.h"
 #include "vtkPermissionPrompter.h"
@@ -14,6 +16,7 @@
 #include <vtkCallbackCommand.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkTimerLog.h>
 
 // VTKsys includes
 #include <vtksys/SystemTools.hxx>
@@ -204,6 +207,25 @@ void vtkDataIOManagerLogic::CancelDataTransfer ( vtkDataTransfer *dt )
 
 
 
+//----------------------------------------------------------------------------
+int vtkDataIOManagerLogic::GetReadPriority ( vtkMRMLNode *node )
+{
+  vtkMRMLDisplayableNode *displayableNode = vtkMRMLDisplayableNode::SafeDownCast ( node );
+  if ( displayableNode == NULL )
+    {
+    return 0;
+    }
+  for (int i = 0; i < displayableNode->GetNumberOfDisplayNodes(); ++i)
+    {
+    vtkMRMLDisplayNode *displayNode = displayableNode->GetNthDisplayNode(i);
+    if ( displayNode != NULL && displayNode->GetVisibility() )
+      {
+      return 1;
+      }
+    }
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 int vtkDataIOManagerLogic::QueueRead ( vtkMRMLNode *node )
 {
@@ -310,6 +332,10 @@ int vtkDataIOManagerLogic::QueueRead ( vtkMRMLNode *node )
         }
       }
     }
+  //--- make room for the download by removing the least
+  //--- recently used files if the cache is full.
+  cm->EvictLeastRecentlyUsedFiles();
+
   //---
   //--- WJPtest:
   //--- Again, test for space to download the file.
@@ -354,6 +380,7 @@ int vtkDataIOManagerLogic::QueueRead ( vtkMRMLNode *node )
        ( !(cm->GetEnableForceRedownload())) )
     {
     dnode->GetNthStorageNode(storageNodeIndex)->SetReadStateTransferDone();
+    cm->MarkCacheHit ( dest );
     vtkDebugMacro("QueueRead: the destination file is there and we're not forceing redownload");
     return 1;
     }
@@ -402,6 +429,8 @@ int vtkDataIOManagerLogic::QueueRead ( vtkMRMLNode *node )
   this->GetDataIOManager()->InvokeEvent ( vtkDataIOManager::RefreshDisplayEvent );
 
   vtkDebugMacro("QueueRead: asynchronous enabled = " << this->GetDataIOManager()->GetEnableAsynchronousIO());
+  // visible nodes are downloaded first
+  int readPriority = vtkDataIOManagerLogic::GetReadPriority ( node );
 
   if ( this->GetDataIOManager()->GetEnableAsynchronousIO() )
     {
@@ -411,6 +440,7 @@ int vtkDataIOManagerLogic::QueueRead ( vtkMRMLNode *node )
     //---
     vtkNew<vtkSlicerTask> task;
     task->SetTypeToNetworking();
+    task->SetPriority ( readPriority );
     transfer0->SetTransferStatus ( vtkDataTransfer::Pending );
     task->SetTaskFunction(this, (vtkSlicerTask::TaskFunctionPointer)
                           &vtkDataIOManagerLogic::ApplyTransfer, transfer0.GetPointer());
@@ -465,6 +495,7 @@ int vtkDataIOManagerLogic::QueueRead ( vtkMRMLNode *node )
       vtkDebugMacro("QueueRead: Schedule an ASYNCHRONOUS data transfer, n = " << n);
       vtkNew<vtkSlicerTask> task;
       task->SetTypeToNetworking();
+      task->SetPriority ( readPriority );
       transfer1->SetTransferStatus ( vtkDataTransfer::Pending );
       task->SetTaskFunction(this, (vtkSlicerTask::TaskFunctionPointer)
                             &vtkDataIOManagerLogic::ApplyTransfer, transfer1.GetPointer());
@@ -716,7 +747,9 @@ void vtkDataIOManagerLogic::ApplyTransfer( void *clientdata )
         {
         dt->SetTransferStatusNoModify ( vtkDataTransfer::Running );
         this->GetApplicationLogic()->RequestModified( dt );
+        double startTime = vtkTimerLog::GetUniversalTime();
         handler->StageFileRead( source, dest);
+        this->UpdateTransferStatistics(dt, dest, startTime);
         dt->SetTransferStatusNoModify ( vtkDataTransfer::Completed );
         this->GetApplicationLogic()->RequestModified( dt );
 
@@ -748,17 +781,35 @@ void vtkDataIOManagerLogic::ApplyTransfer( void *clientdata )
           vtkErrorMacro( "ApplyTransfer: no storage node for scheduled data transfer" );
           return;
           }
+        std::string cachedFile = dest;
+        vtkCacheManager *cm = iom->GetCacheManager();
+        if ( cm != NULL )
+          {
+          // the files of a multi-file storage node refer to each other by
+          // name, only single files can be shared between URIs.
+          cachedFile = cm->AddCachedFile( source, dest, storageNode->GetNumberOfURIs() == 0 );
+          }
         storageNode->SetDisableModifiedEvent( 1 );
+        if ( cachedFile != dest )
+          {
+          storageNode->SetFileName( cachedFile.c_str() );
+          }
         // let the storage node know that the remote transfer is done
         vtkDebugMacro("ApplyTransfer: setting storage node read state to transfer done for uri " << storageNode->GetURI());
         storageNode->SetReadStateTransferDone();
         storageNode->SetDisableModifiedEvent( 0 );
-        this->GetApplicationLogic()->RequestReadData( node->GetID(), dest, 0, 0 );
+        this->GetApplicationLogic()->RequestReadData( node->GetID(), cachedFile.c_str(), 0, 0 );
         }
       else
         {
         vtkDebugMacro("ApplyTransfer: stage file read on the handler..., source = " << source << ", dest = " << dest);
+        double startTime = vtkTimerLog::GetUniversalTime();
         handler->StageFileRead( source, dest);
+        this->UpdateTransferStatistics(dt, dest, startTime);
+        if ( iom != NULL && iom->GetCacheManager() != NULL )
+          {
+          iom->GetCacheManager()->AddCachedFile( source, dest );
+          }
         }
       }
     }
@@ -774,7 +825,9 @@ void vtkDataIOManagerLogic::ApplyTransfer( void *clientdata )
         {
         dt->SetTransferStatusNoModify ( vtkDataTransfer::Running );
         this->GetApplicationLogic()->RequestModified( dt );
+        double startTime = vtkTimerLog::GetUniversalTime();
         handler->StageFileWrite( source, dest);
+        this->UpdateTransferStatistics(dt, source, startTime);
         dt->SetTransferStatusNoModify ( vtkDataTransfer::Completed );
         this->GetApplicationLogic()->RequestModified( dt );
 
@@ -810,7 +863,9 @@ void vtkDataIOManagerLogic::ApplyTransfer( void *clientdata )
       else
         {
         vtkDebugMacro("ApplyTransfer: Upload: stage file write on the handler, source = " << source << ", dest = " << dest);
+        double startTime = vtkTimerLog::GetUniversalTime();
         handler->StageFileWrite( source, dest);
+        this->UpdateTransferStatistics(dt, source, startTime);
         }
       }
     else
@@ -826,6 +881,27 @@ void vtkDataIOManagerLogic::ApplyTransfer( void *clientdata )
 
 
 
+//----------------------------------------------------------------------------
+void vtkDataIOManagerLogic::UpdateTransferStatistics(vtkDataTransfer* transfer,
+                                                     const char* localFile,
+                                                     double startTime)
+{
+  double duration = vtkTimerLog::GetUniversalTime() - startTime;
+  vtkTypeInt64 bytes = 0;
+  if (localFile && vtksys::SystemTools::FileExists(localFile, true))
+    {
+    bytes = static_cast<vtkTypeInt64>(vtksys::SystemTools::FileLength(localFile));
+    }
+  transfer->SetTransferredBytes(bytes);
+  transfer->SetTransferDuration(duration);
+  if (this->GetDataIOManager())
+    {
+    this->GetDataIOManager()->AddTransferStatistics(bytes, duration);
+    }
+  vtkDebugMacro("UpdateTransferStatistics: transferred " << bytes << " bytes in "
+                << duration << "s for " << (localFile ? localFile : "(none)"));
+}
+
 //----------------------------------------------------------------------------
 void vtkDataIOManagerLogic::ProgressCallback ( void * vtkNotUsed(who) )
 {
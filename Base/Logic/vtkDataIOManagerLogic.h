@@ -41,6 +41,14 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkDataIOManagerLogic : public vtkSlicerModul
   /// Method that queues the write
   virtual int QueueWrite ( vtkMRMLNode *node );
 
+  ///
+  /// Priority of the download tasks queued by QueueRead() for \a node.
+  /// The data of nodes that have a visible display node is downloaded
+  /// before the data of hidden nodes, so that the views fill up first and
+  /// the rest of the scene is fetched in the background.
+  /// \sa vtkSlicerTask::SetPriority()
+  static int GetReadPriority ( vtkMRMLNode *node );
+
   ///
   /// The method that executes the data transfer in another thread
   virtual void ApplyTransfer(void *clientdata);
@@ -70,6 +78,11 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkDataIOManagerLogic : public vtkSlicerModul
   vtkObserverManager* DataIOObserverManager;
   static void DataIOManagerCallback(vtkObject *caller, unsigned long eid, void *clientData, void *callData);
   virtual void ProcessDataIOManagerEvents( vtkObject *caller, unsigned long event, void *calldata );
+
+  /// Set the size of \a localFile and the time elapsed since \a startTime
+  /// on the transfer and account for them in the data IO manager.
+  /// \sa vtkDataIOManager::AddTransferStatistics()
+  void UpdateTransferStatistics(vtkDataTransfer* transfer, const char* localFile, double startTime);
 };
 
 #endif
@@ -0,0 +1,516 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkImageLabelStatistics.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMultiThreader.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+/// Accumulators of the per-thread tables are not allowed to use more memory than this (in bytes)
+const size_t MAXIMUM_ACCUMULATOR_MEMORY = 64 * 1024 * 1024;
+
+//----------------------------------------------------------------------------
+struct LabelAccumulator
+{
+  LabelAccumulator()
+    : VoxelCount(0)
+    , Sum(0.0)
+    , SumOfSquares(0.0)
+    , Min(VTK_DOUBLE_MAX)
+    , Max(-VTK_DOUBLE_MAX)
+    {
+    }
+  void Merge(const LabelAccumulator& other)
+    {
+    this->VoxelCount += other.VoxelCount;
+    this->Sum += other.Sum;
+    this->SumOfSquares += other.SumOfSquares;
+    this->Min = std::min(this->Min, other.Min);
+    this->Max = std::max(this->Max, other.Max);
+    }
+  vtkIdType VoxelCount;
+  double Sum;
+  double SumOfSquares;
+  double Min;
+  double Max;
+};
+
+//----------------------------------------------------------------------------
+/// Data shared by the threads. Each thread processes a range of slices of Extent
+/// and only writes its own element of ThreadAccumulators or ThreadHistograms.
+struct LabelStatisticsThreadData
+{
+  vtkImageData* Labels;
+  vtkImageData* Scalars;
+  int Extent[6];
+  int NumberOfThreads;
+
+  /// Accumulate statistics (first scan) or histograms (second scan)
+  bool AccumulateHistograms;
+
+  /// Accumulators for each label value from LabelMin, used in the first scan
+  int LabelMin;
+  std::vector< std::vector<LabelAccumulator> > ThreadAccumulators;
+
+  /// Histogram bins of each label that occurs in the image, used in the second scan
+  std::vector<int> LabelIndexOfValueOffset;
+  int NumberOfLabels;
+  int NumberOfBins;
+  double HistogramMin;
+  double BinWidth;
+  std::vector< std::vector<vtkIdType> > ThreadHistograms;
+};
+
+//----------------------------------------------------------------------------
+template <class TLabel, class TScalar>
+void LabelStatisticsScanSlices(LabelStatisticsThreadData* data, int threadId,
+  int firstSlice, int lastSlice, TLabel*, TScalar*)
+{
+  const int* extent = data->Extent;
+  const int numberOfScalarComponents = data->Scalars ? data->Scalars->GetNumberOfScalarComponents() : 0;
+  LabelAccumulator* accumulators = data->AccumulateHistograms ? NULL : &data->ThreadAccumulators[threadId][0];
+  vtkIdType* histograms = data->AccumulateHistograms ? &data->ThreadHistograms[threadId][0] : NULL;
+  for (int k = firstSlice; k <= lastSlice; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      const TLabel* labelPtr = static_cast<TLabel*>(data->Labels->GetScalarPointer(extent[0], j, k));
+      const TScalar* scalarPtr = data->Scalars ? static_cast<TScalar*>(data->Scalars->GetScalarPointer(extent[0], j, k)) : NULL;
+      for (int i = extent[0]; i <= extent[1]; ++i, ++labelPtr, scalarPtr += numberOfScalarComponents)
+        {
+        const int labelValueOffset = static_cast<int>(*labelPtr) - data->LabelMin;
+        if (!data->AccumulateHistograms)
+          {
+          LabelAccumulator& accumulator = accumulators[labelValueOffset];
+          ++accumulator.VoxelCount;
+          if (scalarPtr)
+            {
+            const double value = static_cast<double>(*scalarPtr);
+            accumulator.Sum += value;
+            accumulator.SumOfSquares += value * value;
+            if (value < accumulator.Min)
+              {
+              accumulator.Min = value;
+              }
+            if (value > accumulator.Max)
+              {
+              accumulator.Max = value;
+              }
+            }
+          }
+        else
+          {
+          const int labelIndex = data->LabelIndexOfValueOffset[labelValueOffset];
+          int bin = static_cast<int>(floor((static_cast<double>(*scalarPtr) - data->HistogramMin) / data->BinWidth));
+          bin = std::max(0, std::min(bin, data->NumberOfBins - 1));
+          ++histograms[static_cast<size_t>(labelIndex) * data->NumberOfBins + bin];
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class TLabel>
+void LabelStatisticsScanSlices(LabelStatisticsThreadData* data, int threadId,
+  int firstSlice, int lastSlice, TLabel* labelType)
+{
+  if (!data->Scalars)
+    {
+    LabelStatisticsScanSlices(data, threadId, firstSlice, lastSlice, labelType, static_cast<char*>(NULL));
+    return;
+    }
+  switch (data->Scalars->GetScalarType())
+    {
+    vtkTemplateMacro(LabelStatisticsScanSlices(data, threadId, firstSlice, lastSlice,
+      labelType, static_cast<VTK_TT*>(NULL)));
+    default:
+      break;
+    }
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE LabelStatisticsThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  LabelStatisticsThreadData* data = static_cast<LabelStatisticsThreadData*>(threadInfo->UserData);
+  const int threadId = threadInfo->ThreadID;
+  const int numberOfThreads = std::min(threadInfo->NumberOfThreads, data->NumberOfThreads);
+  if (threadId >= numberOfThreads)
+    {
+    return VTK_THREAD_RETURN_VALUE;
+    }
+  const int numberOfSlices = data->Extent[5] - data->Extent[4] + 1;
+  const int firstSlice = data->Extent[4] + (numberOfSlices * threadId) / numberOfThreads;
+  const int lastSlice = data->Extent[4] + (numberOfSlices * (threadId + 1)) / numberOfThreads - 1;
+  switch (data->Labels->GetScalarType())
+    {
+    vtkTemplateMacro(LabelStatisticsScanSlices(data, threadId, firstSlice, lastSlice, static_cast<VTK_TT*>(NULL)));
+    default:
+      break;
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void LabelStatisticsExecute(LabelStatisticsThreadData& data, int numberOfThreads)
+{
+  vtkNew<vtkMultiThreader> threader;
+  threader->SetNumberOfThreads(numberOfThreads);
+  threader->SetSingleMethod(LabelStatisticsThreadFunction, &data);
+  threader->SingleMethodExecute();
+}
+}
+
+//----------------------------------------------------------------------------
+class vtkImageLabelStatistics::vtkInternal
+{
+public:
+  vtkInternal()
+    : NumberOfBins(0)
+    , HistogramMin(0.0)
+    , BinWidth(1.0)
+    , ExactHistogram(false)
+    {
+    }
+  void Reset()
+    {
+    this->LabelValues.clear();
+    this->Statistics.clear();
+    this->Histograms.clear();
+    this->NumberOfBins = 0;
+    }
+
+  std::vector<int> LabelValues;
+  std::vector<LabelAccumulator> Statistics;
+  std::vector<vtkIdType> Histograms;
+  int NumberOfBins;
+  double HistogramMin;
+  double BinWidth;
+  bool ExactHistogram;
+};
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkImageLabelStatistics);
+vtkCxxSetObjectMacro(vtkImageLabelStatistics, LabelImageData, vtkImageData);
+vtkCxxSetObjectMacro(vtkImageLabelStatistics, ScalarImageData, vtkImageData);
+
+//----------------------------------------------------------------------------
+vtkImageLabelStatistics::vtkImageLabelStatistics()
+{
+  this->LabelImageData = NULL;
+  this->ScalarImageData = NULL;
+  this->ComputeHistograms = false;
+  this->NumberOfHistogramBins = 1000;
+  this->NumberOfThreads = 0;
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkImageLabelStatistics::~vtkImageLabelStatistics()
+{
+  this->SetLabelImageData(NULL);
+  this->SetScalarImageData(NULL);
+  delete this->Internal;
+  this->Internal = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageLabelStatistics::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "LabelImageData: " << this->LabelImageData << "\n";
+  os << indent << "ScalarImageData: " << this->ScalarImageData << "\n";
+  os << indent << "ComputeHistograms: " << (this->ComputeHistograms ? "true" : "false") << "\n";
+  os << indent << "NumberOfHistogramBins: " << this->NumberOfHistogramBins << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "NumberOfLabels: " << this->Internal->LabelValues.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkImageLabelStatistics::Update()
+{
+  this->Internal->Reset();
+  if (!this->LabelImageData || !this->LabelImageData->GetPointData()->GetScalars())
+    {
+    vtkErrorMacro("Update: Invalid label image");
+    return false;
+    }
+  int labelScalarType = this->LabelImageData->GetScalarType();
+  if (labelScalarType == VTK_FLOAT || labelScalarType == VTK_DOUBLE)
+    {
+    vtkErrorMacro("Update: Label image must have integer scalar type");
+    return false;
+    }
+  if (this->ScalarImageData && !this->ScalarImageData->GetPointData()->GetScalars())
+    {
+    vtkErrorMacro("Update: Invalid scalar image");
+    return false;
+    }
+
+  LabelStatisticsThreadData data;
+  data.Labels = this->LabelImageData;
+  data.Scalars = this->ScalarImageData;
+  data.AccumulateHistograms = false;
+  this->LabelImageData->GetExtent(data.Extent);
+  if (this->ScalarImageData)
+    {
+    int scalarExtent[6] = {0,-1,0,-1,0,-1};
+    this->ScalarImageData->GetExtent(scalarExtent);
+    for (int i = 0; i < 3; ++i)
+      {
+      data.Extent[i * 2] = std::max(data.Extent[i * 2], scalarExtent[i * 2]);
+      data.Extent[i * 2 + 1] = std::min(data.Extent[i * 2 + 1], scalarExtent[i * 2 + 1]);
+      }
+    }
+  if (data.Extent[0] > data.Extent[1] || data.Extent[2] > data.Extent[3] || data.Extent[4] > data.Extent[5])
+    {
+    // empty, no labels
+    return true;
+    }
+
+  double labelRange[2] = {0.0, 0.0};
+  this->LabelImageData->GetScalarRange(labelRange);
+  if (labelRange[0] < VTK_INT_MIN || labelRange[1] > VTK_INT_MAX
+    || (labelRange[1] - labelRange[0] + 1) * sizeof(LabelAccumulator) > MAXIMUM_ACCUMULATOR_MEMORY)
+    {
+    vtkErrorMacro("Update: Range of label values is too large (" << labelRange[0] << " to " << labelRange[1] << ")");
+    return false;
+    }
+  data.LabelMin = static_cast<int>(labelRange[0]);
+  const size_t numberOfLabelValues = static_cast<size_t>(static_cast<int>(labelRange[1]) - data.LabelMin) + 1;
+  const size_t accumulatorsMemory = numberOfLabelValues * sizeof(LabelAccumulator);
+
+  // Limit the number of threads to keep total memory usage of the tables below the limit
+  int numberOfThreads = this->NumberOfThreads;
+  if (numberOfThreads <= 0)
+    {
+    numberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    }
+  numberOfThreads = std::min(numberOfThreads, data.Extent[5] - data.Extent[4] + 1);
+  numberOfThreads = std::min(numberOfThreads, static_cast<int>(MAXIMUM_ACCUMULATOR_MEMORY / accumulatorsMemory));
+  numberOfThreads = std::max(1, std::min(numberOfThreads, VTK_MAX_THREADS));
+  data.NumberOfThreads = numberOfThreads;
+
+  // First scan: voxel count and intensity statistics of all label values
+  data.ThreadAccumulators.resize(numberOfThreads, std::vector<LabelAccumulator>(numberOfLabelValues));
+  LabelStatisticsExecute(data, numberOfThreads);
+  std::vector<LabelAccumulator>& accumulators = data.ThreadAccumulators[0];
+  for (int threadId = 1; threadId < numberOfThreads; ++threadId)
+    {
+    for (size_t labelValueOffset = 0; labelValueOffset < numberOfLabelValues; ++labelValueOffset)
+      {
+      accumulators[labelValueOffset].Merge(data.ThreadAccumulators[threadId][labelValueOffset]);
+      }
+    }
+
+  // Compact table of the labels that occur in the image
+  data.LabelIndexOfValueOffset.resize(numberOfLabelValues, -1);
+  double scalarMin = VTK_DOUBLE_MAX;
+  double scalarMax = -VTK_DOUBLE_MAX;
+  for (size_t labelValueOffset = 0; labelValueOffset < numberOfLabelValues; ++labelValueOffset)
+    {
+    const LabelAccumulator& accumulator = accumulators[labelValueOffset];
+    if (accumulator.VoxelCount == 0)
+      {
+      continue;
+      }
+    data.LabelIndexOfValueOffset[labelValueOffset] = static_cast<int>(this->Internal->LabelValues.size());
+    this->Internal->LabelValues.push_back(data.LabelMin + static_cast<int>(labelValueOffset));
+    this->Internal->Statistics.push_back(accumulator);
+    scalarMin = std::min(scalarMin, accumulator.Min);
+    scalarMax = std::max(scalarMax, accumulator.Max);
+    }
+  data.ThreadAccumulators.clear();
+
+  if (!this->ComputeHistograms || !this->ScalarImageData || this->Internal->LabelValues.empty())
+    {
+    return true;
+    }
+
+  // Second scan: histogram of each label, over the range of scalars in all labels
+  int scalarType = this->ScalarImageData->GetScalarType();
+  bool integerScalars = (scalarType != VTK_FLOAT && scalarType != VTK_DOUBLE);
+  data.NumberOfLabels = static_cast<int>(this->Internal->LabelValues.size());
+  data.HistogramMin = scalarMin;
+  if (integerScalars && scalarMax - scalarMin + 1 <= this->NumberOfHistogramBins)
+    {
+    // one bin for each value
+    this->Internal->ExactHistogram = true;
+    data.NumberOfBins = static_cast<int>(scalarMax - scalarMin) + 1;
+    data.BinWidth = 1.0;
+    }
+  else
+    {
+    this->Internal->ExactHistogram = false;
+    data.NumberOfBins = this->NumberOfHistogramBins;
+    data.BinWidth = (scalarMax > scalarMin ? (scalarMax - scalarMin) / data.NumberOfBins : 1.0);
+    }
+  const size_t histogramsSize = static_cast<size_t>(data.NumberOfLabels) * data.NumberOfBins;
+  numberOfThreads = std::min(numberOfThreads,
+    std::max(1, static_cast<int>(MAXIMUM_ACCUMULATOR_MEMORY / (histogramsSize * sizeof(vtkIdType)))));
+  data.NumberOfThreads = numberOfThreads;
+  data.AccumulateHistograms = true;
+  data.ThreadHistograms.resize(numberOfThreads, std::vector<vtkIdType>(histogramsSize, 0));
+  LabelStatisticsExecute(data, numberOfThreads);
+  this->Internal->Histograms.swap(data.ThreadHistograms[0]);
+  for (int threadId = 1; threadId < numberOfThreads; ++threadId)
+    {
+    for (size_t binIndex = 0; binIndex < histogramsSize; ++binIndex)
+      {
+      this->Internal->Histograms[binIndex] += data.ThreadHistograms[threadId][binIndex];
+      }
+    }
+  this->Internal->NumberOfBins = data.NumberOfBins;
+  this->Internal->HistogramMin = data.HistogramMin;
+  this->Internal->BinWidth = data.BinWidth;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLabelStatistics::GetNumberOfLabels()
+{
+  return static_cast<int>(this->Internal->LabelValues.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLabelStatistics::GetLabelValue(int labelIndex)
+{
+  if (labelIndex < 0 || labelIndex >= this->GetNumberOfLabels())
+    {
+    vtkErrorMacro("GetLabelValue: Invalid label index " << labelIndex);
+    return 0;
+    }
+  return this->Internal->LabelValues[labelIndex];
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLabelStatistics::GetLabelIndex(int labelValue)
+{
+  std::vector<int>::iterator labelIt = std::lower_bound(
+    this->Internal->LabelValues.begin(), this->Internal->LabelValues.end(), labelValue);
+  if (labelIt == this->Internal->LabelValues.end() || *labelIt != labelValue)
+    {
+    return -1;
+    }
+  return static_cast<int>(labelIt - this->Internal->LabelValues.begin());
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkImageLabelStatistics::GetVoxelCount(int labelIndex)
+{
+  if (labelIndex < 0 || labelIndex >= this->GetNumberOfLabels())
+    {
+    vtkErrorMacro("GetVoxelCount: Invalid label index " << labelIndex);
+    return 0;
+    }
+  return this->Internal->Statistics[labelIndex].VoxelCount;
+}
+
+//----------------------------------------------------------------------------
+double vtkImageLabelStatistics::GetMinimum(int labelIndex)
+{
+  if (labelIndex < 0 || labelIndex >= this->GetNumberOfLabels() || !this->ScalarImageData)
+    {
+    vtkErrorMacro("GetMinimum: Invalid label index " << labelIndex << " or no scalar image");
+    return vtkMath::Nan();
+    }
+  return this->Internal->Statistics[labelIndex].Min;
+}
+
+//----------------------------------------------------------------------------
+double vtkImageLabelStatistics::GetMaximum(int labelIndex)
+{
+  if (labelIndex < 0 || labelIndex >= this->GetNumberOfLabels() || !this->ScalarImageData)
+    {
+    vtkErrorMacro("GetMaximum: Invalid label index " << labelIndex << " or no scalar image");
+    return vtkMath::Nan();
+    }
+  return this->Internal->Statistics[labelIndex].Max;
+}
+
+//----------------------------------------------------------------------------
+double vtkImageLabelStatistics::GetMean(int labelIndex)
+{
+  if (labelIndex < 0 || labelIndex >= this->GetNumberOfLabels() || !this->ScalarImageData)
+    {
+    vtkErrorMacro("GetMean: Invalid label index " << labelIndex << " or no scalar image");
+    return vtkMath::Nan();
+    }
+  const LabelAccumulator& statistics = this->Internal->Statistics[labelIndex];
+  return statistics.Sum / statistics.VoxelCount;
+}
+
+//----------------------------------------------------------------------------
+double vtkImageLabelStatistics::GetStandardDeviation(int labelIndex)
+{
+  if (labelIndex < 0 || labelIndex >= this->GetNumberOfLabels() || !this->ScalarImageData)
+    {
+    vtkErrorMacro("GetStandardDeviation: Invalid label index " << labelIndex << " or no scalar image");
+    return vtkMath::Nan();
+    }
+  const LabelAccumulator& statistics = this->Internal->Statistics[labelIndex];
+  if (statistics.VoxelCount < 2)
+    {
+    return 0.0;
+    }
+  const double mean = statistics.Sum / statistics.VoxelCount;
+  const double variance = (statistics.SumOfSquares - mean * statistics.Sum) / (statistics.VoxelCount - 1);
+  return sqrt(std::max(variance, 0.0));
+}
+
+//----------------------------------------------------------------------------
+double vtkImageLabelStatistics::GetPercentile(int labelIndex, double percent)
+{
+  if (labelIndex < 0 || labelIndex >= this->GetNumberOfLabels() || this->Internal->Histograms.empty())
+    {
+    vtkErrorMacro("GetPercentile: Invalid label index " << labelIndex << " or histograms are not computed");
+    return vtkMath::Nan();
+    }
+  const LabelAccumulator& statistics = this->Internal->Statistics[labelIndex];
+  const double targetCount = std::max(0.0, std::min(percent, 100.0)) / 100.0 * statistics.VoxelCount;
+  const vtkIdType* histogram = &this->Internal->Histograms[static_cast<size_t>(labelIndex) * this->Internal->NumberOfBins];
+  vtkIdType cumulativeCount = 0;
+  for (int bin = 0; bin < this->Internal->NumberOfBins; ++bin)
+    {
+    if (histogram[bin] == 0 || cumulativeCount + histogram[bin] < targetCount)
+      {
+      cumulativeCount += histogram[bin];
+      continue;
+      }
+    if (this->Internal->ExactHistogram)
+      {
+      return this->Internal->HistogramMin + bin;
+      }
+    // interpolate within the bin
+    double fraction = (targetCount - cumulativeCount) / histogram[bin];
+    double value = this->Internal->HistogramMin + this->Internal->BinWidth * (bin + fraction);
+    return std::max(statistics.Min, std::min(value, statistics.Max));
+    }
+  return statistics.Max;
+}
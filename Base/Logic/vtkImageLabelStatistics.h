@@ -0,0 +1,112 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkImageLabelStatistics_h
+#define __vtkImageLabelStatistics_h
+
+#include "vtkSlicerBaseLogic.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+class vtkImageData;
+
+/// \brief Compute statistics of a scalar image for all labels of a labelmap.
+///
+/// All labels are accumulated in one multi-threaded scan of the images: slices are
+/// distributed between the threads, each thread accumulates voxel count, sum, sum of
+/// squares, minimum and maximum of each label value into its own table, and the tables
+/// are merged at the end. Only labels that occur in the labelmap are reported,
+/// in ascending order of label value.
+///
+/// If ComputeHistograms is enabled then a histogram is computed for each label in a second
+/// scan, which allows getting median and percentiles. For integer scalars with a range that is
+/// not larger than NumberOfHistogramBins the bin width is 1 and percentiles are exact, otherwise
+/// they are linearly interpolated within the histogram bin.
+///
+/// The label image must have integer scalar type. Only the voxels in the intersection of the
+/// extents of the two images are used. Only the first component of the scalar image is used.
+class VTK_SLICER_BASE_LOGIC_EXPORT vtkImageLabelStatistics : public vtkObject
+{
+public:
+  static vtkImageLabelStatistics *New();
+  vtkTypeMacro(vtkImageLabelStatistics,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  /// Labelmap that defines the regions
+  virtual void SetLabelImageData(vtkImageData* image);
+  vtkGetObjectMacro(LabelImageData, vtkImageData);
+
+  /// Image for intensity statistics. If not set then only voxels are counted.
+  virtual void SetScalarImageData(vtkImageData* image);
+  vtkGetObjectMacro(ScalarImageData, vtkImageData);
+
+  /// Compute per-label histograms for median and percentiles. Off by default.
+  vtkSetMacro(ComputeHistograms, bool);
+  vtkGetMacro(ComputeHistograms, bool);
+  vtkBooleanMacro(ComputeHistograms, bool);
+
+  /// Maximum number of bins of the histogram of each label. Default is 1000.
+  vtkSetClampMacro(NumberOfHistogramBins, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfHistogramBins, int);
+
+  /// Number of threads used. Default number of threads of vtkMultiThreader is used if 0 (default).
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  /// Compute statistics of all the labels
+  /// \return Success flag
+  bool Update();
+
+  /// Number of labels that occur in the label image
+  int GetNumberOfLabels();
+  /// Label value of the label at the specified index
+  int GetLabelValue(int labelIndex);
+  /// Index of the specified label value, -1 if the label does not occur in the label image
+  int GetLabelIndex(int labelValue);
+
+  /// Number of voxels of the label
+  vtkIdType GetVoxelCount(int labelIndex);
+  /// Intensity statistics of the label. Only available if scalar image is set.
+  double GetMinimum(int labelIndex);
+  double GetMaximum(int labelIndex);
+  double GetMean(int labelIndex);
+  /// Sample standard deviation (same as vtkImageAccumulate)
+  double GetStandardDeviation(int labelIndex);
+
+  /// Intensity value below which the specified percent of the voxels of the label are.
+  /// Only available if ComputeHistograms is enabled.
+  double GetPercentile(int labelIndex, double percent);
+  double GetMedian(int labelIndex) { return this->GetPercentile(labelIndex, 50.0); };
+
+protected:
+  vtkImageLabelStatistics();
+  ~vtkImageLabelStatistics();
+
+  vtkImageData* LabelImageData;
+  vtkImageData* ScalarImageData;
+  bool ComputeHistograms;
+  int NumberOfHistogramBins;
+  int NumberOfThreads;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkImageLabelStatistics(const vtkImageLabelStatistics&);  // Not implemented.
+  void operator=(const vtkImageLabelStatistics&);  // Not implemented.
+};
+
+#endif
@@ -27,13 +27,19 @@
 #include <vtkMRMLScene.h>
 #include <vtkMRMLSelectionNode.h>
 #include <vtkMRMLTableNode.h>
+#include <vtkMRMLTransformNode.h>
 #include <vtkMRMLRemoteIOLogic.h>
+#include <vtkMRMLVolumeNode.h>
 
 // VTK includes
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkMultiThreader.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
+#include <vtkSMPTools.h>
 
 // ITKSYS includes
 #include <itksys/SystemTools.hxx>
@@ -47,12 +53,24 @@
 # include <sys/resource.h>
 #endif
 
+#include <deque>
+#include <map>
 #include <queue>
 
 //----------------------------------------------------------------------------
-class ProcessingTaskQueue : public std::queue<vtkSmartPointer<vtkSlicerTask> > {};
+class ProcessingTaskQueue : public std::deque<vtkSmartPointer<vtkSlicerTask> > {};
 class ModifiedQueue : public std::queue<vtkSmartPointer<vtkObject> > {};
 
+//----------------------------------------------------------------------------
+// Newest data streamed for a node
+class StreamedDataRequest
+{
+public:
+  vtkSmartPointer<vtkImageData> ImageData;
+  vtkSmartPointer<vtkMatrix4x4> MatrixTransformToParent;
+};
+class StreamedDataQueue : public std::map<std::string, StreamedDataRequest> {};
+
 //----------------------------------------------------------------------------
 class DataRequest
 {
@@ -200,8 +218,16 @@ vtkStandardNewMacro(vtkSlicerApplicationLogic);
 vtkSlicerApplicationLogic::vtkSlicerApplicationLogic()
 {
   this->ProcessingThreader = itk::MultiThreader::New();
-  this->ProcessingThreadId = -1;
   this->ProcessingThreadActive = false;
+  this->NumberOfProcessingThreads = 1;
+  this->NumberOfNetworkingThreads = 1;
+  this->ProcessingThreadsBudget =
+    itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  this->ProcessingMemoryBudget = 0;
+  this->MaximumNumberOfThreads = 0;
+  this->NumberOfRunningProcessingTasks = 0;
+  this->RunningProcessingThreads = 0;
+  this->RunningProcessingMemory = 0;
   this->ProcessingThreadActiveLock = itk::MutexLock::New();
   this->ProcessingTaskQueueLock = itk::MutexLock::New();
 
@@ -217,11 +243,15 @@ vtkSlicerApplicationLogic::vtkSlicerApplicationLogic()
   this->WriteDataQueueActiveLock = itk::MutexLock::New();
   this->WriteDataQueueLock = itk::MutexLock::New();
 
+  this->StreamedDataQueueLock = itk::MutexLock::New();
+  this->StreamedDataProcessingRequested = false;
+
   this->InternalTaskQueue = new ProcessingTaskQueue;
   this->InternalModifiedQueue = new ModifiedQueue;
 
   this->InternalReadDataQueue = new ReadDataQueue;
   this->InternalWriteDataQueue = new WriteDataQueue;
+  this->InternalStreamedDataQueue = new StreamedDataQueue;
 }
 
 //----------------------------------------------------------------------------
@@ -230,17 +260,21 @@ vtkSlicerApplicationLogic::~vtkSlicerApplicationLogic()
   // Note that TerminateThread does not kill a thread, it only waits
   // for the thread to finish.  We need to signal the thread that we
   // want to terminate
-  if (this->ProcessingThreadId != -1 && this->ProcessingThreader)
+  if (!this->ProcessingThreadIDs.empty() && this->ProcessingThreader)
     {
     // Signal the processingThread that we are terminating.
     this->ProcessingThreadActiveLock->Lock();
     this->ProcessingThreadActive = false;
     this->ProcessingThreadActiveLock->Unlock();
 
-    // Wait for the thread to finish and clean up the state of the threader
-    this->ProcessingThreader->TerminateThread( this->ProcessingThreadId );
-
-    this->ProcessingThreadId = -1;
+    // Wait for the threads to finish and clean up the state of the threader
+    std::vector<int>::const_iterator idIterator;
+    for (idIterator = this->ProcessingThreadIDs.begin();
+         idIterator != this->ProcessingThreadIDs.end(); ++idIterator)
+      {
+      this->ProcessingThreader->TerminateThread( *idIterator );
+      }
+    this->ProcessingThreadIDs.clear();
     }
 
   delete this->InternalTaskQueue;
@@ -256,6 +290,7 @@ vtkSlicerApplicationLogic::~vtkSlicerApplicationLogic()
   delete this->InternalModifiedQueue;
   delete this->InternalReadDataQueue;
   delete this->InternalWriteDataQueue;
+  delete this->InternalStreamedDataQueue;
 }
 
 //----------------------------------------------------------------------------
@@ -322,36 +357,27 @@ void vtkSlicerApplicationLogic::PrintSelf(ostream& os, vtkIndent indent)
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::CreateProcessingThread()
 {
-  if (this->ProcessingThreadId == -1)
+  if (this->ProcessingThreadIDs.empty())
     {
     this->ProcessingThreadActiveLock->Lock();
     this->ProcessingThreadActive = true;
     this->ProcessingThreadActiveLock->Unlock();
 
-    this->ProcessingThreadId
-      = this->ProcessingThreader
-      ->SpawnThread(vtkSlicerApplicationLogic::ProcessingThreaderCallback,
-                    this);
-
-    // Start four network threads (TODO: make the number of threads a setting)
-    this->NetworkingThreadIDs.push_back ( this->ProcessingThreader
-          ->SpawnThread(vtkSlicerApplicationLogic::NetworkingThreaderCallback,
-                    this) );
-    /*
-     * TODO: it looks like curl is not thread safe by default
-     * - maybe there's a setting that cmcurl can have
-     *   similar to the --enable-threading of the standard curl build
-     *
-    this->NetworkingThreadIDs.push_back ( this->ProcessingThreader
-          ->SpawnThread(vtkSlicerApplicationLogic::NetworkingThreaderCallback,
-                    this) );
-    this->NetworkingThreadIDs.push_back ( this->ProcessingThreader
-          ->SpawnThread(vtkSlicerApplicationLogic::NetworkingThreaderCallback,
-                    this) );
-    this->NetworkingThreadIDs.push_back ( this->ProcessingThreader
-          ->SpawnThread(vtkSlicerApplicationLogic::NetworkingThreaderCallback,
-                    this) );
-    */
+    for (int i = 0; i < this->NumberOfProcessingThreads; ++i)
+      {
+      this->ProcessingThreadIDs.push_back( this->ProcessingThreader
+        ->SpawnThread(vtkSlicerApplicationLogic::ProcessingThreaderCallback,
+                      this) );
+      }
+
+    // Start the network threads, vtkHTTPHandler uses a curl handle per
+    // transfer so that transfers can run concurrently.
+    for (int i = 0; i < this->NumberOfNetworkingThreads; ++i)
+      {
+      this->NetworkingThreadIDs.push_back ( this->ProcessingThreader
+            ->SpawnThread(vtkSlicerApplicationLogic::NetworkingThreaderCallback,
+                      this) );
+      }
 
     // Setup the communication channel back to the main thread
     this->ModifiedQueueActiveLock->Lock();
@@ -374,7 +400,7 @@ void vtkSlicerApplicationLogic::CreateProcessingThread()
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::TerminateProcessingThread()
 {
-  if (this->ProcessingThreadId != -1)
+  if (!this->ProcessingThreadIDs.empty())
     {
     this->ModifiedQueueActiveLock->Lock();
     this->ModifiedQueueActive = false;
@@ -392,10 +418,15 @@ void vtkSlicerApplicationLogic::TerminateProcessingThread()
     this->ProcessingThreadActive = false;
     this->ProcessingThreadActiveLock->Unlock();
 
-    this->ProcessingThreader->TerminateThread( this->ProcessingThreadId );
-    this->ProcessingThreadId = -1;
-
     std::vector<int>::const_iterator idIterator;
+    idIterator = this->ProcessingThreadIDs.begin();
+    while (idIterator != this->ProcessingThreadIDs.end())
+      {
+      this->ProcessingThreader->TerminateThread( *idIterator );
+      ++idIterator;
+      }
+    this->ProcessingThreadIDs.clear();
+
     idIterator = this->NetworkingThreadIDs.begin();
     while (idIterator != this->NetworkingThreadIDs.end())
       {
@@ -458,29 +489,52 @@ void vtkSlicerApplicationLogic::ProcessProcessingTasks()
 
     if (active)
       {
-      // pull a task off the queue
+      // pull the processing task of highest priority off the queue if
+      // there are enough resources to run it
       this->ProcessingTaskQueueLock->Lock();
-      if ((*this->InternalTaskQueue).size() > 0)
+      ProcessingTaskQueue::iterator taskIt = this->InternalTaskQueue->end();
+      for (ProcessingTaskQueue::iterator it = this->InternalTaskQueue->begin();
+           it != this->InternalTaskQueue->end(); ++it)
         {
-        // std::cout << "Number of queued tasks: " << (*this->InternalTaskQueue).size() << std::endl;
-
-        // only handle processing tasks in this thread
-        task = (*this->InternalTaskQueue).front();
-        if ( task->GetType() == vtkSlicerTask::Processing )
+        if ((*it)->GetType() == vtkSlicerTask::Processing
+            && (taskIt == this->InternalTaskQueue->end()
+                || (*it)->GetPriority() > (*taskIt)->GetPriority()))
           {
-          (*this->InternalTaskQueue).pop();
+          taskIt = it;
           }
-        else
+        }
+      if (taskIt != this->InternalTaskQueue->end())
+        {
+        // Lower priority tasks are not started in place of a task waiting
+        // for resources, to prevent it from starving.
+        bool enoughThreads = (this->RunningProcessingThreads
+          + (*taskIt)->GetNumberOfThreads() <= this->ProcessingThreadsBudget);
+        bool enoughMemory = (this->ProcessingMemoryBudget == 0
+          || this->RunningProcessingMemory + (*taskIt)->GetMemorySize()
+             <= this->ProcessingMemoryBudget);
+        if (this->NumberOfRunningProcessingTasks == 0
+            || (enoughThreads && enoughMemory))
           {
-          task = NULL;
+          task = *taskIt;
+          this->InternalTaskQueue->erase(taskIt);
+          ++this->NumberOfRunningProcessingTasks;
+          this->RunningProcessingThreads += task->GetNumberOfThreads();
+          this->RunningProcessingMemory += task->GetMemorySize();
           }
         }
       this->ProcessingTaskQueueLock->Unlock();
 
-      // process the task (should this be in a separate thread?)
+      // process the task
       if (task)
         {
         task->Execute();
+
+        this->ProcessingTaskQueueLock->Lock();
+        --this->NumberOfRunningProcessingTasks;
+        this->RunningProcessingThreads -= task->GetNumberOfThreads();
+        this->RunningProcessingMemory -= task->GetMemorySize();
+        this->ProcessingTaskQueueLock->Unlock();
+
         task = 0;
         }
       }
@@ -540,21 +594,24 @@ void vtkSlicerApplicationLogic::ProcessNetworkingTasks()
 
     if (active)
       {
-      // pull a task off the queue
+      // pull the networking task of highest priority off the queue
       this->ProcessingTaskQueueLock->Lock();
-      if ((*this->InternalTaskQueue).size() > 0)
+      ProcessingTaskQueue::iterator taskIt = this->InternalTaskQueue->end();
+      for (ProcessingTaskQueue::iterator it = this->InternalTaskQueue->begin();
+           it != this->InternalTaskQueue->end(); ++it)
         {
-        // std::cout << "Number of queued tasks: " << (*this->InternalTaskQueue).size() << std::endl;
-        task = (*this->InternalTaskQueue).front();
-        if ( task->GetType() == vtkSlicerTask::Networking )
+        if ((*it)->GetType() == vtkSlicerTask::Networking
+            && (taskIt == this->InternalTaskQueue->end()
+                || (*it)->GetPriority() > (*taskIt)->GetPriority()))
           {
-          (*this->InternalTaskQueue).pop();
-          }
-        else
-          {
-          task = NULL;
+          taskIt = it;
           }
         }
+      if (taskIt != this->InternalTaskQueue->end())
+        {
+        task = *taskIt;
+        this->InternalTaskQueue->erase(taskIt);
+        }
       this->ProcessingTaskQueueLock->Unlock();
 
       // process the task (should this be in a separate thread?)
@@ -562,6 +619,8 @@ void vtkSlicerApplicationLogic::ProcessNetworkingTasks()
         {
         task->Execute();
         task = 0;
+        // don't wait before looking for the next queued transfer
+        continue;
         }
       }
 
@@ -585,7 +644,7 @@ int vtkSlicerApplicationLogic::ScheduleTask( vtkSlicerTask *task )
   if (active)
     {
     this->ProcessingTaskQueueLock->Lock();
-    (*this->InternalTaskQueue).push( task );
+    (*this->InternalTaskQueue).push_back( task );
     //std::cout << (*this->InternalTaskQueue).size() << std::endl;
     this->ProcessingTaskQueueLock->Unlock();
 
@@ -596,6 +655,95 @@ int vtkSlicerApplicationLogic::ScheduleTask( vtkSlicerTask *task )
   return false;
 }
 
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::SetNumberOfProcessingThreads(int numberOfThreads)
+{
+  if (!this->ProcessingThreadIDs.empty())
+    {
+    vtkWarningMacro("SetNumberOfProcessingThreads: processing threads are "
+                    "already created, the change is ignored until they are "
+                    "terminated.");
+    }
+  this->NumberOfProcessingThreads = std::max(numberOfThreads, 1);
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::GetNumberOfProcessingThreads()
+{
+  return this->NumberOfProcessingThreads;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::SetNumberOfNetworkingThreads(int numberOfThreads)
+{
+  if (!this->NetworkingThreadIDs.empty())
+    {
+    vtkWarningMacro("SetNumberOfNetworkingThreads: networking threads are "
+                    "already created, the change is ignored until they are "
+                    "terminated.");
+    }
+  this->NumberOfNetworkingThreads = std::max(numberOfThreads, 1);
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::GetNumberOfNetworkingThreads()
+{
+  return this->NumberOfNetworkingThreads;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::SetProcessingThreadsBudget(int numberOfThreads)
+{
+  this->ProcessingTaskQueueLock->Lock();
+  this->ProcessingThreadsBudget = std::max(numberOfThreads, 1);
+  this->ProcessingTaskQueueLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::GetProcessingThreadsBudget()
+{
+  return this->ProcessingThreadsBudget;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::SetProcessingMemoryBudget(unsigned int megabytes)
+{
+  this->ProcessingTaskQueueLock->Lock();
+  this->ProcessingMemoryBudget = megabytes;
+  this->ProcessingTaskQueueLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkSlicerApplicationLogic::GetProcessingMemoryBudget()
+{
+  return this->ProcessingMemoryBudget;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::SetMaximumNumberOfThreads(int numberOfThreads)
+{
+  this->MaximumNumberOfThreads = std::max(numberOfThreads, 0);
+  int threads = this->MaximumNumberOfThreads;
+  if (threads == 0)
+    {
+    threads = static_cast<int>(itk::MultiThreader::GetGlobalDefaultNumberOfThreadsByPlatform());
+    }
+  threads = std::max(1, threads);
+
+  itk::MultiThreader::SetGlobalMaximumNumberOfThreads(threads);
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(threads);
+  vtkMultiThreader::SetGlobalMaximumNumberOfThreads(std::min(threads, VTK_MAX_THREADS));
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(std::min(threads, VTK_MAX_THREADS));
+  vtkSMPTools::Initialize(threads);
+  this->SetProcessingThreadsBudget(threads);
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::GetMaximumNumberOfThreads()
+{
+  return this->MaximumNumberOfThreads;
+}
+
 //----------------------------------------------------------------------------
 int vtkSlicerApplicationLogic::RequestModified( vtkObject *obj )
 {
@@ -625,6 +773,57 @@ int vtkSlicerApplicationLogic::RequestModified( vtkObject *obj )
   return 0;
 }
 
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::RequestSetImageData(const char* nodeID, vtkImageData* imageData)
+{
+  if (!nodeID || !imageData)
+    {
+    return 0;
+    }
+  this->StreamedDataQueueLock->Lock();
+  this->RequestTimeStamp.Modified();
+  int uid = static_cast<int>(this->RequestTimeStamp.GetMTime());
+  // replaces (and releases) any image that has not been processed yet
+  (*this->InternalStreamedDataQueue)[nodeID].ImageData = imageData;
+  bool requestProcessing = !this->StreamedDataProcessingRequested;
+  this->StreamedDataProcessingRequested = true;
+  this->StreamedDataQueueLock->Unlock();
+
+  // the data of all the nodes streamed until the main thread gets to it
+  // is processed at once
+  if (requestProcessing)
+    {
+    this->InvokeEventWithDelay(0, this, vtkSlicerApplicationLogic::RequestStreamedDataEvent);
+    }
+  return uid;
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::RequestSetMatrixTransformToParent(const char* nodeID, vtkMatrix4x4* matrix)
+{
+  if (!nodeID || !matrix)
+    {
+    return 0;
+    }
+  // copy outside of the lock, the caller may reuse its matrix
+  vtkSmartPointer<vtkMatrix4x4> matrixCopy = vtkSmartPointer<vtkMatrix4x4>::New();
+  matrixCopy->DeepCopy(matrix);
+
+  this->StreamedDataQueueLock->Lock();
+  this->RequestTimeStamp.Modified();
+  int uid = static_cast<int>(this->RequestTimeStamp.GetMTime());
+  (*this->InternalStreamedDataQueue)[nodeID].MatrixTransformToParent = matrixCopy;
+  bool requestProcessing = !this->StreamedDataProcessingRequested;
+  this->StreamedDataProcessingRequested = true;
+  this->StreamedDataQueueLock->Unlock();
+
+  if (requestProcessing)
+    {
+    this->InvokeEventWithDelay(0, this, vtkSlicerApplicationLogic::RequestStreamedDataEvent);
+    }
+  return uid;
+}
+
 //----------------------------------------------------------------------------
 int vtkSlicerApplicationLogic::RequestReadData( const char *refNode, const char *filename, int displayData, int deleteFile )
 {
@@ -762,6 +961,59 @@ void vtkSlicerApplicationLogic::ProcessModified()
   this->InvokeEvent(vtkSlicerApplicationLogic::RequestModifiedEvent, &delay);
 }
 
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::ProcessStreamedData()
+{
+  // Take all the pending data at once: the producers are only blocked for
+  // the time of a swap, not while the nodes are updated.
+  StreamedDataQueue requests;
+  this->StreamedDataQueueLock->Lock();
+  requests.swap(*this->InternalStreamedDataQueue);
+  this->StreamedDataProcessingRequested = false;
+  this->StreamedDataQueueLock->Unlock();
+
+  vtkMRMLScene* scene = this->GetMRMLScene();
+  if (!scene)
+    {
+    return 0;
+    }
+  int numberOfUpdatedNodes = 0;
+  for (StreamedDataQueue::iterator it = requests.begin(); it != requests.end(); ++it)
+    {
+    vtkMRMLNode* node = scene->GetNodeByID(it->first);
+    if (!node)
+      {
+      vtkWarningMacro("ProcessStreamedData: node " << it->first << " not found");
+      continue;
+      }
+    int wasModifying = node->StartModify();
+    bool updated = false;
+    vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(node);
+    if (it->second.ImageData.GetPointer() && volumeNode)
+      {
+      // frames are swapped without rebuilding the display pipelines
+      volumeNode->ReplaceImageData(it->second.ImageData);
+      updated = true;
+      }
+    vtkMRMLTransformNode* transformNode = vtkMRMLTransformNode::SafeDownCast(node);
+    if (it->second.MatrixTransformToParent.GetPointer() && transformNode)
+      {
+      transformNode->SetMatrixTransformToParent(it->second.MatrixTransformToParent);
+      updated = true;
+      }
+    node->EndModify(wasModifying);
+    if (updated)
+      {
+      ++numberOfUpdatedNodes;
+      }
+    else
+      {
+      vtkWarningMacro("ProcessStreamedData: streamed data cannot be set on node " << it->first);
+      }
+    }
+  return numberOfUpdatedNodes;
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::ProcessReadData()
 {
@@ -36,10 +36,13 @@ class vtkMRMLInteractionNode;
 class vtkMRMLRemoteIOLogic;
 class vtkDataIOManagerLogic;
 class vtkSlicerTask;
+class vtkImageData;
+class vtkMatrix4x4;
 class ModifiedQueue;
 class ProcessingTaskQueue;
 class ReadDataQueue;
 class ReadDataRequest;
+class StreamedDataQueue;
 class WriteDataQueue;
 class WriteDataRequest;
 
@@ -69,7 +72,8 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
   /// (display it in the Fiducials GUI)
   void PropagateFiducialListSelection();
 
-  /// Create a thread for processing
+  /// Create the threads for processing
+  /// \sa SetNumberOfProcessingThreads()
   void CreateProcessingThread();
 
   /// Shutdown the processing thread
@@ -84,14 +88,59 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
       /// has been processed.
       /// The uid of the request is passed as callData.
       /// \todo Add support for "modified" request.
-      RequestProcessedEvent
+      RequestProcessedEvent,
+      /// Event fired in the main thread when streamed data is waiting to be
+      /// set on nodes.
+      /// \sa RequestSetImageData(), ProcessStreamedData()
+      RequestStreamedDataEvent
     };
 
   /// Schedule a task to run in the processing thread. Returns true if
   /// task was successfully scheduled. ScheduleTask() is called from the
   /// main thread to run something in the processing thread.
+  /// Processing tasks are started by order of priority, as long as their
+  /// cost fits in the processing budget.
+  /// Networking tasks are started by order of priority too.
+  /// \sa vtkSlicerTask::SetPriority(), vtkSlicerTask::SetNumberOfThreads(),
+  /// vtkSlicerTask::SetMemorySize()
   int ScheduleTask( vtkSlicerTask* );
 
+  /// Number of threads processing tasks concurrently. It must be set before
+  /// the processing threads are created. 1 by default, tasks are then run
+  /// one after the other.
+  /// \sa CreateProcessingThread()
+  void SetNumberOfProcessingThreads(int numberOfThreads);
+  int GetNumberOfProcessingThreads();
+
+  /// Number of threads running networking tasks (e.g. remote data
+  /// transfers) concurrently. It must be set before the processing threads
+  /// are created. 1 by default.
+  /// \sa CreateProcessingThread()
+  void SetNumberOfNetworkingThreads(int numberOfThreads);
+  int GetNumberOfNetworkingThreads();
+
+  /// Total number of threads the running processing tasks may use.
+  /// A task that requires more than the budget is only started when no other
+  /// task is running. The number of cores of the machine by default.
+  /// \sa vtkSlicerTask::SetNumberOfThreads()
+  void SetProcessingThreadsBudget(int numberOfThreads);
+  int GetProcessingThreadsBudget();
+
+  /// Total memory in megabytes the running processing tasks may use.
+  /// 0 (unlimited) by default.
+  /// \sa vtkSlicerTask::SetMemorySize()
+  void SetProcessingMemoryBudget(unsigned int megabytes);
+  unsigned int GetProcessingMemoryBudget();
+
+  /// Application-wide limit on the number of threads: it is the default
+  /// and maximum number of threads of the ITK and VTK multi-threaders, the
+  /// number of threads of the VTK SMP backend (only the first call has an
+  /// effect on the TBB backend), and the processing threads budget.
+  /// 0 (by default) means the number of cores of the machine.
+  /// \sa SetProcessingThreadsBudget()
+  void SetMaximumNumberOfThreads(int numberOfThreads);
+  int GetMaximumNumberOfThreads();
+
   /// Request a Modified call on an object.  This method allows a
   /// processing thread to request a Modified call on an object to be
   /// performed in the main thread.  This allows the call to Modified
@@ -146,6 +195,29 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
                        int displayData = false,
                        int deleteFile = false);
 
+  /// Request that an image be set on a volume node (SetAndObserveImageData).
+  /// This method allows a thread receiving data from a device (e.g. live
+  /// ultrasound) to hand a fully built image over to the main thread. The
+  /// image must not be modified by the caller anymore.
+  /// Only the newest streamed data of a node is kept: if the main thread
+  /// falls behind, older images are dropped instead of being queued, so the
+  /// latency does not grow.
+  /// Can be called from any thread. Return the request UID (monotonically
+  /// increasing) of the request or 0 if the request failed to be registered.
+  /// \sa RequestSetMatrixTransformToParent(), ProcessStreamedData()
+  int RequestSetImageData(const char* nodeID, vtkImageData* imageData);
+
+  /// Request that a matrix be set on a transform node
+  /// (SetMatrixTransformToParent). The matrix is copied.
+  /// \sa RequestSetImageData(), ProcessStreamedData()
+  int RequestSetMatrixTransformToParent(const char* nodeID, vtkMatrix4x4* matrix);
+
+  /// Set the newest streamed data on the nodes. This method is called in
+  /// the main thread of the application (on RequestStreamedDataEvent)
+  /// because setting data on nodes can cause an update of the GUI.
+  /// Returns the number of nodes that have been updated.
+  int ProcessStreamedData();
+
   /// Process a request on the Modified queue.  This method is called
   /// in the main thread of the application because calls to Modified()
   /// can cause an update to the GUI. (Method needs to be public to fit
@@ -237,9 +309,20 @@ private:
   itk::MutexLock::Pointer ReadDataQueueLock;
   itk::MutexLock::Pointer WriteDataQueueActiveLock;
   itk::MutexLock::Pointer WriteDataQueueLock;
+  itk::MutexLock::Pointer StreamedDataQueueLock;
   vtkTimeStamp RequestTimeStamp;
-  int ProcessingThreadId;
+  std::vector<int> ProcessingThreadIDs;
   std::vector<int> NetworkingThreadIDs;
+  int NumberOfProcessingThreads;
+  int NumberOfNetworkingThreads;
+  int ProcessingThreadsBudget;
+  unsigned int ProcessingMemoryBudget;
+  int MaximumNumberOfThreads;
+  /// Resources used by the running processing tasks, protected by
+  /// ProcessingTaskQueueLock.
+  int NumberOfRunningProcessingTasks;
+  int RunningProcessingThreads;
+  unsigned int RunningProcessingMemory;
   int ProcessingThreadActive;
   int ModifiedQueueActive;
   int ReadDataQueueActive;
@@ -249,6 +332,10 @@ private:
   ModifiedQueue*       InternalModifiedQueue;
   ReadDataQueue*       InternalReadDataQueue;
   WriteDataQueue*      InternalWriteDataQueue;
+  StreamedDataQueue*   InternalStreamedDataQueue;
+  /// True when a RequestStreamedDataEvent has been requested and not
+  /// processed yet, protected by StreamedDataQueueLock.
+  bool StreamedDataProcessingRequested;
 
   /// For use with external tracing tool (such as AQTime)
   int Tracing;
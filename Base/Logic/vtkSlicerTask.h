@@ -38,6 +38,27 @@ public:
   void SetTypeToProcessing() {this->SetType(vtkSlicerTask::Processing);};
   void SetTypeToNetworking() {this->SetType(vtkSlicerTask::Networking);};
 
+  ///
+  /// Tasks with a higher priority are run first. Tasks of the same priority
+  /// are run in the order they were scheduled. 0 by default.
+  vtkSetMacro (Priority, int);
+  vtkGetMacro (Priority, int);
+
+  ///
+  /// Number of threads the task is expected to use while running. The
+  /// application logic doesn't start a task if it would exceed the number of
+  /// threads available for processing. 1 by default.
+  /// \sa vtkSlicerApplicationLogic::SetProcessingThreadsBudget()
+  vtkSetClampMacro (NumberOfThreads, int, 1, VTK_INT_MAX);
+  vtkGetMacro (NumberOfThreads, int);
+
+  ///
+  /// Memory in megabytes the task is expected to use while running.
+  /// 0 (unknown) by default.
+  /// \sa vtkSlicerApplicationLogic::SetProcessingMemoryBudget()
+  vtkSetMacro (MemorySize, unsigned int);
+  vtkGetMacro (MemorySize, unsigned int);
+
   const char* GetTypeAsString( ) {
     switch (this->Type)
       {
@@ -60,6 +81,9 @@ private:
   void *TaskClientData;
 
   int Type;
+  int Priority;
+  int NumberOfThreads;
+  unsigned int MemorySize;
 
 };
 #endif
@@ -88,5 +88,247 @@ def run(module, node = None, parameters = None, wait_for_completion = False, del
   #widget.apply()
   return node
 
+def runAsync(module, node=None, parameters=None, delete_temporary_files=True, update_display=True):
+  """Run a CLI without blocking and return a :py:class:`CLIFuture`
+  completed when the CLI is done.
+  """
+  node = run(module, node=node, parameters=parameters, wait_for_completion=False,
+    delete_temporary_files=delete_temporary_files, update_display=update_display)
+  if not node:
+    return None
+  return CLIFuture(node)
+
 def cancel(node):
   print "Not yet implemented"
+
+class CLIFuture(object):
+  """Completion of a CLI run, based on the status of its
+  vtkMRMLCommandLineModuleNode.
+
+  Done callbacks are invoked on the main thread with the future as
+  argument, once the CLI is completed, completed with errors or cancelled.
+  """
+  def __init__(self, node=None):
+    self._node = None
+    self._observerTag = None
+    self._doneCallbacks = []
+    self._done = False
+    self._succeeded = False
+    if node:
+      self._setNode(node)
+
+  def node(self):
+    """Return the vtkMRMLCommandLineModuleNode of the CLI run, None if the
+    run has not been started yet."""
+    return self._node
+
+  def isDone(self):
+    return self._done
+
+  def succeeded(self):
+    """Return True if the CLI is completed without errors."""
+    return self._done and self._succeeded
+
+  def addDoneCallback(self, callback):
+    if self._done:
+      callback(self)
+    else:
+      self._doneCallbacks.append(callback)
+
+  def wait(self):
+    """Process events until the CLI is done. Return succeeded()."""
+    import qt, slicer, time
+    while not self._done:
+      slicer.app.processEvents(qt.QEventLoop.ExcludeUserInputEvents)
+      time.sleep(0.01)
+    return self._succeeded
+
+  def _setNode(self, node):
+    import slicer
+    self._node = node
+    self._observerTag = node.AddObserver(
+      slicer.vtkMRMLCommandLineModuleNode.StatusModifiedEvent, self._onStatusModified)
+    self._onStatusModified(node, None)
+
+  def _onStatusModified(self, caller, event):
+    import slicer
+    status = self._node.GetStatus()
+    if status == slicer.vtkMRMLCommandLineModuleNode.CompletedWithErrors or \
+       status == slicer.vtkMRMLCommandLineModuleNode.Cancelled:
+      self._complete(False)
+    elif status == slicer.vtkMRMLCommandLineModuleNode.Completed:
+      self._complete(True)
+
+  def _complete(self, succeeded):
+    if self._done:
+      return
+    if self._observerTag is not None:
+      self._node.RemoveObserver(self._observerTag)
+      self._observerTag = None
+    self._done = True
+    self._succeeded = succeeded
+    callbacks = self._doneCallbacks
+    self._doneCallbacks = []
+    for callback in callbacks:
+      callback(self)
+
+class PipelineStep(CLIFuture):
+  """CLI run of a :py:class:`Pipeline`. Returned by :py:meth:`Pipeline.addStep`."""
+  def __init__(self, pipeline, module, parameters):
+    CLIFuture.__init__(self)
+    self.pipeline = pipeline
+    self.module = module
+    self.parameters = parameters
+    self.dependencies = []
+
+  def output(self, parameterName):
+    """Return the node set as the \a parameterName output parameter of the
+    step. Passing this node as an input parameter of another step makes
+    that step depend on this one."""
+    node = self.parameters.get(parameterName)
+    if node is None:
+      raise ValueError("Output parameter %s of %s is not set" % (parameterName, self.module.name))
+    self.pipeline._outputSteps[node.GetID()] = self
+    return node
+
+class Pipeline(object):
+  """Run a directed acyclic graph of CLIs.
+
+  A step depends on the other steps whose outputs (see
+  :py:meth:`PipelineStep.output`) are among its parameters. A step is
+  started as soon as all the steps it depends on are completed, therefore
+  independent steps run concurrently, within the processing thread and
+  memory budgets of the application logic (see
+  vtkSlicerApplicationLogic::SetNumberOfProcessingThreads()).
+
+  Data is exchanged between steps through MRML nodes, which the shared
+  object CLIs read and write in memory. Intermediate nodes created with
+  :py:meth:`createNode` are removed from the scene once the pipeline is
+  done, unless ``removeIntermediateNodes`` is False.
+
+  .. code-block:: python
+
+    pipeline = slicer.cli.Pipeline()
+    for channel in channels:
+      corrected = pipeline.createNode('vtkMRMLScalarVolumeNode')
+      n4 = pipeline.addStep(slicer.modules.n4itkbiasfieldcorrection,
+        {'inputImageName': channel, 'outputImageName': corrected})
+      pipeline.addStep(slicer.modules.resamplescalarvectordwivolume,
+        {'inputVolume': n4.output('outputImageName'), 'outputVolume': outputs[channel], ...})
+    pipeline.run()
+    pipeline.wait()
+  """
+  def __init__(self, removeIntermediateNodes=True):
+    self.steps = []
+    self.removeIntermediateNodes = removeIntermediateNodes
+    self._outputSteps = {}
+    self._intermediateNodes = []
+    self._doneCallbacks = []
+    self._running = False
+
+  def createNode(self, className, name=None):
+    """Create a node in the scene to hold intermediate data."""
+    import slicer
+    scene = slicer.mrmlScene
+    node = scene.CreateNodeByClass(className)
+    node.UnRegister(scene)
+    node.SetName(name if name else scene.GenerateUniqueName("PipelineData"))
+    node.SetHideFromEditors(True)
+    scene.AddNode(node)
+    self._intermediateNodes.append(node)
+    return node
+
+  def addStep(self, module, parameters):
+    """Add a CLI run and return its :py:class:`PipelineStep`.
+
+    Dependencies are found from the nodes among \a parameters that have
+    been returned by the :py:meth:`PipelineStep.output` method of
+    previously added steps."""
+    step = PipelineStep(self, module, dict(parameters))
+    self.steps.append(step)
+    return step
+
+  def addDoneCallback(self, callback):
+    """Invoke ``callback(pipeline)`` on the main thread once all the steps
+    are done."""
+    if self.isDone():
+      callback(self)
+    else:
+      self._doneCallbacks.append(callback)
+
+  def isDone(self):
+    return all(step.isDone() for step in self.steps)
+
+  def succeeded(self):
+    return all(step.succeeded() for step in self.steps)
+
+  def run(self):
+    """Start the steps that do not depend on other steps. Return the list
+    of steps, whose futures complete as the pipeline progresses."""
+    import slicer
+    for step in self.steps:
+      step.dependencies = []
+      for value in step.parameters.values():
+        if isinstance(value, slicer.vtkMRMLNode) and value.GetID() in self._outputSteps:
+          dependency = self._outputSteps[value.GetID()]
+          if dependency is not step and dependency not in step.dependencies:
+            step.dependencies.append(dependency)
+    self._checkAcyclic()
+    self._running = True
+    for step in self.steps:
+      step.addDoneCallback(self._onStepDone)
+    self._startReadySteps()
+    return self.steps
+
+  def wait(self):
+    """Process events until all the steps are done. Return succeeded()."""
+    for step in self.steps:
+      step.wait()
+    return self.succeeded()
+
+  def _checkAcyclic(self):
+    visited = {}
+    def visit(step):
+      state = visited.get(step)
+      if state == 1:
+        raise ValueError("Pipeline steps have circular dependencies (%s)" % step.module.name)
+      if state == 2:
+        return
+      visited[step] = 1
+      for dependency in step.dependencies:
+        visit(dependency)
+      visited[step] = 2
+    for step in self.steps:
+      visit(step)
+
+  def _startReadySteps(self):
+    for step in self.steps:
+      if step.node() is not None or step.isDone():
+        continue
+      if any(dependency.isDone() and not dependency.succeeded() for dependency in step.dependencies):
+        # Do not run steps whose inputs could not be computed
+        step._complete(False)
+        continue
+      if all(dependency.succeeded() for dependency in step.dependencies):
+        node = run(step.module, parameters=step.parameters, wait_for_completion=False, update_display=False)
+        if node is None:
+          step._complete(False)
+        else:
+          step._setNode(node)
+
+  def _onStepDone(self, step):
+    if not self._running:
+      return
+    self._startReadySteps()
+    if not self.isDone():
+      return
+    self._running = False
+    if self.removeIntermediateNodes:
+      import slicer
+      for node in self._intermediateNodes:
+        slicer.mrmlScene.RemoveNode(node)
+      self._intermediateNodes = []
+    callbacks = self._doneCallbacks
+    self._doneCallbacks = []
+    for callback in callbacks:
+      callback(self)
@@ -0,0 +1,49 @@
+import unittest
+import slicer
+import slicer.util
+import vtk
+
+class SlicerUtilArraysTest(unittest.TestCase):
+
+    def setUp(self):
+        slicer.mrmlScene.Clear(0)
+
+    def test_arrayFromVolume(self):
+        imageData = vtk.vtkImageData()
+        imageData.SetDimensions(4, 3, 2)
+        imageData.AllocateScalars(vtk.VTK_SHORT, 1)
+        imageData.GetPointData().GetScalars().FillComponent(0, 0)
+        volumeNode = slicer.vtkMRMLScalarVolumeNode()
+        volumeNode.SetAndObserveImageData(imageData)
+        slicer.mrmlScene.AddNode(volumeNode)
+
+        narray = slicer.util.arrayFromVolume(volumeNode)
+        self.assertEqual(narray.shape, (2, 3, 4))
+
+        # The array shares memory with the image data
+        modifiedTime = imageData.GetMTime()
+        narray[1, 2, 3] = 12
+        self.assertEqual(imageData.GetScalarComponentAsDouble(3, 2, 1, 0), 12)
+        slicer.util.arrayFromVolumeModified(volumeNode)
+        self.assertGreater(imageData.GetMTime(), modifiedTime)
+        self.assertEqual(imageData.GetScalarRange()[1], 12)
+
+        # Update with a copy of a different shape
+        slicer.util.updateVolumeFromArray(volumeNode, narray[:, :2, :].copy())
+        self.assertEqual(volumeNode.GetImageData().GetDimensions(), (4, 2, 2))
+
+    def test_arrayFromModelPoints(self):
+        sphere = vtk.vtkSphereSource()
+        sphere.Update()
+        modelNode = slicer.vtkMRMLModelNode()
+        modelNode.SetAndObservePolyData(sphere.GetOutput())
+        slicer.mrmlScene.AddNode(modelNode)
+
+        narray = slicer.util.arrayFromModelPoints(modelNode)
+        self.assertEqual(narray.shape, (modelNode.GetPolyData().GetNumberOfPoints(), 3))
+        narray[0] = [10., 20., 30.]
+        slicer.util.arrayFromModelPointsModified(modelNode)
+        self.assertEqual(modelNode.GetPolyData().GetPoint(0), (10., 20., 30.))
+
+        polyIds = slicer.util.arrayFromModelPolyIds(modelNode)
+        self.assertEqual(polyIds.reshape(-1, 4)[0, 0], 3)
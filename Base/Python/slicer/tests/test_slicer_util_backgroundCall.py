@@ -0,0 +1,40 @@
+import unittest
+import slicer
+import slicer.util
+import vtk
+
+class SlicerUtilBackgroundCallTest(unittest.TestCase):
+
+    @staticmethod
+    def _smooth(imageData):
+        smoothing = vtk.vtkImageGaussianSmooth()
+        smoothing.SetInputData(imageData)
+        smoothing.Update()
+        return smoothing.GetOutput()
+
+    def _createImage(self):
+        source = vtk.vtkImageNoiseSource()
+        source.SetWholeExtent(0, 63, 0, 63, 0, 63)
+        source.Update()
+        return source.GetOutput()
+
+    def test_result(self):
+        handle = slicer.util.startBackgroundCall(self._smooth, self._createImage())
+        output = handle.result()
+        self.assertTrue(handle.isDone())
+        self.assertEqual(output.GetDimensions(), (64, 64, 64))
+
+    def test_doneCallback(self):
+        handles = [slicer.util.startBackgroundCall(self._smooth, self._createImage()) for i in range(3)]
+        completed = []
+        for handle in handles:
+            handle.addDoneCallback(completed.append)
+        for handle in handles:
+            handle.wait()
+        self.assertEqual(len(completed), 3)
+
+    def test_exception(self):
+        def fail():
+            raise ValueError("expected")
+        handle = slicer.util.startBackgroundCall(fail)
+        self.assertRaises(ValueError, handle.result)
@@ -647,41 +647,329 @@ def array(pattern = "", index = 0):
   """Return the array you are "most likely to want" from the indexth
   MRML node that matches the pattern.  Meant to be used in the python
   console for quick debugging/testing.  More specific API should be
-  used in scripts to be sure you get exactly what you want.
+  used in scripts to be sure you get exactly what you want, such as
+  :py:meth:`arrayFromVolume` or :py:meth:`arrayFromModelPoints`.
+
+  The returned array shares memory with the node data.
   """
-  scalarTypes = ('vtkMRMLScalarVolumeNode', 'vtkMRMLLabelMapVolumeNode')
-  vectorTypes = ('vtkMRMLVectorVolumeNode', 'vtkMRMLMultiVolumeNode')
-  tensorTypes = ('vtkMRMLDiffusionTensorVolumeNode',)
+  volumeTypes = ('vtkMRMLScalarVolumeNode', 'vtkMRMLLabelMapVolumeNode',
+    'vtkMRMLVectorVolumeNode', 'vtkMRMLMultiVolumeNode', 'vtkMRMLDiffusionTensorVolumeNode')
   pointTypes = ('vtkMRMLModelNode',)
-  import vtk.util.numpy_support
   n = getNode(pattern=pattern, index=index)
-  if n.GetClassName() in scalarTypes:
-    i = n.GetImageData()
-    shape = list(n.GetImageData().GetDimensions())
-    shape.reverse()
-    a = vtk.util.numpy_support.vtk_to_numpy(i.GetPointData().GetScalars()).reshape(shape)
-    return a
-  elif n.GetClassName() in vectorTypes:
-    i = n.GetImageData()
-    shape = list(n.GetImageData().GetDimensions())
-    shape.reverse()
-    components = i.GetNumberOfScalarComponents()
-    if components > 1:
-      shape.append(components)
-    a = vtk.util.numpy_support.vtk_to_numpy(i.GetPointData().GetScalars()).reshape(shape)
-    return a
-  elif n.GetClassName() in tensorTypes:
-    i = n.GetImageData()
-    shape = list(n.GetImageData().GetDimensions())
-    shape.reverse()
-    a = vtk.util.numpy_support.vtk_to_numpy(i.GetPointData().GetTensors()).reshape(shape+[3,3])
-    return a
+  if n.GetClassName() in volumeTypes:
+    return arrayFromVolume(n)
   elif n.GetClassName() in pointTypes:
-    p = n.GetPolyData().GetPoints().GetData()
-    a = vtk.util.numpy_support.vtk_to_numpy(p)
-    return a
-  # TODO: accessors for other node types: polydata (verts, polys...), colors
+    return arrayFromModelPoints(n)
+  # TODO: accessors for other node types: colors
+
+def arrayFromVolume(volumeNode):
+  """Return voxel array from volume node as numpy array.
 
+  Voxels values are not copied: the array shares memory with the image
+  data of the volume, modifying the array modifies the volume. Call
+  :py:meth:`arrayFromVolumeModified` after the voxels have been modified
+  to update the views.
+
+  The array is indexed as [k, j, i] for scalar volumes, with an additional
+  component index for vector volumes ([k, j, i, component]) and two
+  additional indices for tensor volumes ([k, j, i, row, column]).
+
+  .. warning:: The array becomes invalid if the image data of the volume
+    is replaced or reallocated (e.g., its dimensions are changed).
+  """
+  import vtk.util.numpy_support
+  imageData = volumeNode.GetImageData()
+  shape = list(imageData.GetDimensions())
+  shape.reverse()
+  if volumeNode.IsA('vtkMRMLDiffusionTensorVolumeNode'):
+    tensors = imageData.GetPointData().GetTensors()
+    return vtk.util.numpy_support.vtk_to_numpy(tensors).reshape(shape+[3,3])
+  scalars = imageData.GetPointData().GetScalars()
+  components = imageData.GetNumberOfScalarComponents()
+  if components > 1:
+    shape.append(components)
+  return vtk.util.numpy_support.vtk_to_numpy(scalars).reshape(shape)
+
+def arrayFromVolumeModified(volumeNode):
+  """Indicate that the voxels of a volume have been modified in place
+  (e.g., through the array returned by :py:meth:`arrayFromVolume`).
+
+  A single modified event is invoked on the image data, which updates the
+  views and the scalar range of the volume.
+  """
+  imageData = volumeNode.GetImageData()
+  pointData = imageData.GetPointData() if imageData else None
+  if pointData:
+    if pointData.GetScalars():
+      pointData.GetScalars().Modified()
+    if pointData.GetTensors():
+      pointData.GetTensors().Modified()
+  if imageData:
+    imageData.Modified()
+
+def updateVolumeFromArray(volumeNode, narray):
+  """Set the voxels of a volume from a numpy array indexed as [k, j, i]
+  (and [k, j, i, component] for vector volumes).
+
+  Voxels are copied once into a new image data, which is the only option
+  when the dimensions or the scalar type change. The origin, spacing and
+  directions of the volume are preserved. Prefer modifying the array
+  returned by :py:meth:`arrayFromVolume` in place when the dimensions and
+  scalar type do not change.
+  """
+  import vtk
+  import vtk.util.numpy_support
+  if narray.ndim not in (3, 4):
+    raise ValueError("Array must be 3 or 4 dimensional, indexed as [k, j, i] or [k, j, i, component]")
+  components = narray.shape[3] if narray.ndim == 4 else 1
+  imageData = vtk.vtkImageData()
+  imageData.SetDimensions(narray.shape[2], narray.shape[1], narray.shape[0])
+  vtype = vtk.util.numpy_support.get_vtk_array_type(narray.dtype)
+  imageData.AllocateScalars(vtype, components)
+  scalars = vtk.util.numpy_support.vtk_to_numpy(imageData.GetPointData().GetScalars())
+  scalars[:] = narray.reshape(scalars.shape)
+  volumeNode.SetAndObserveImageData(imageData)
+
+def arrayFromModelPoints(modelNode):
+  """Return point positions of a model node as numpy array.
+
+  Point coordinates are not copied: the array shares memory with the
+  points of the model, modifying the array moves the points. Call
+  :py:meth:`arrayFromModelPointsModified` after the points have been
+  modified to update the views.
+
+  The array is indexed as [point index, coordinate].
+  """
+  import vtk.util.numpy_support
+  pointData = modelNode.GetPolyData().GetPoints().GetData()
+  return vtk.util.numpy_support.vtk_to_numpy(pointData)
+
+def arrayFromModelPointsModified(modelNode):
+  """Indicate that the point positions of a model have been modified in
+  place (e.g., through the array returned by :py:meth:`arrayFromModelPoints`).
+
+  A single modified event is invoked on the mesh of the model.
+  """
+  polyData = modelNode.GetPolyData()
+  if polyData.GetPoints():
+    polyData.GetPoints().GetData().Modified()
+    polyData.GetPoints().Modified()
+  polyData.Modified()
+
+def arrayFromModelPolyIds(modelNode):
+  """Return the point indices of the polygons of a model node as numpy array.
+
+  The array is not copied: it shares memory with the cells of the model.
+  It is a flat list of cells, each cell being stored as the number of its
+  points followed by the point indices: [n0, p0_0, ..., p0_n0-1, n1, p1_0, ...].
+  For models made of triangles only, ``arrayFromModelPolyIds(modelNode).reshape(-1, 4)[:,1:]``
+  gives one triangle per row.
+  Call :py:meth:`arrayFromModelPointsModified` after the array has been
+  modified in place.
+  """
+  import vtk.util.numpy_support
+  cellData = modelNode.GetPolyData().GetPolys().GetData()
+  return vtk.util.numpy_support.vtk_to_numpy(cellData)
+
+def arrayFromModelPointData(modelNode, arrayName):
+  """Return a point data array of a model node as numpy array.
+
+  Values are not copied: the array shares memory with the point data of
+  the model. Call :py:meth:`arrayFromModelPointsModified` after the values
+  have been modified in place.
+  """
+  import vtk.util.numpy_support
+  pointData = modelNode.GetPolyData().GetPointData().GetArray(arrayName)
+  if pointData is None:
+    raise ValueError("Model %s has no point data array named %s" % (modelNode.GetName(), arrayName))
+  return vtk.util.numpy_support.vtk_to_numpy(pointData)
+
+def arrayFromMarkupsControlPoints(markupsNode):
+  """Return the positions of all the points of all the markups of a
+  markups node as numpy array, indexed as [point index, coordinate].
+
+  Markups do not store their points in a contiguous buffer, therefore the
+  positions are copied. Use :py:meth:`updateMarkupsControlPointsFromArray`
+  to set the modified positions.
+  """
+  import vtk
+  import vtk.util.numpy_support
+  points = vtk.vtkPoints()
+  markupsNode.GetAllMarkupPoints(points)
+  return vtk.util.numpy_support.vtk_to_numpy(points.GetData())
+
+def updateMarkupsControlPointsFromArray(markupsNode, narray):
+  """Set the positions of all the points of all the markups of a markups
+  node from a numpy array indexed as [point index, coordinate].
+
+  The number of points must not change. A single modified event is invoked.
+  """
+  import vtk
+  import vtk.util.numpy_support
+  if narray.ndim != 2 or narray.shape[1] != 3:
+    raise ValueError("Array must be indexed as [point index, coordinate]")
+  points = vtk.vtkPoints()
+  points.SetData(vtk.util.numpy_support.numpy_to_vtk(narray.astype('float64'), deep=True))
+  if not markupsNode.SetAllMarkupPoints(points):
+    raise ValueError("Array has %d points, markups node %s has a different number of points"
+      % (narray.shape[0], markupsNode.GetName()))
+
+def arrayFromSegment(segmentationNode, segmentId):
+  """Return the binary labelmap of a segment as numpy array, indexed as [k, j, i].
+
+  Voxels are not copied: the array shares memory with the master
+  representation of the segment, which must be the binary labelmap.
+  Call :py:meth:`arrayFromSegmentModified` after the voxels have been
+  modified.
+
+  .. note:: The labelmap of a segment may only cover the region of its
+    non-zero voxels: element [0, 0, 0] of the array is the voxel at the
+    first corner of ``GetExtent()`` of the labelmap, not the first voxel
+    of the reference volume.
+  """
+  import vtk.util.numpy_support
+  segmentation = segmentationNode.GetSegmentation()
+  segment = segmentation.GetSegment(segmentId)
+  if segment is None:
+    raise ValueError("Segment %s not found in %s" % (segmentId, segmentationNode.GetName()))
+  labelmap = segment.GetRepresentation(segmentation.GetMasterRepresentationName())
+  if labelmap is None or not labelmap.IsA('vtkImageData'):
+    raise ValueError("Master representation of %s is not a binary labelmap" % segmentationNode.GetName())
+  shape = list(labelmap.GetDimensions())
+  shape.reverse()
+  return vtk.util.numpy_support.vtk_to_numpy(labelmap.GetPointData().GetScalars()).reshape(shape)
+
+def arrayFromSegmentModified(segmentationNode, segmentId, extent=None):
+  """Indicate that the binary labelmap of a segment has been modified in
+  place (e.g., through the array returned by :py:meth:`arrayFromSegment`).
+
+  The other representations of the segment are updated and a single
+  master representation modified event is invoked.
+
+  :param extent: optional region that has been modified, given as
+    [imin, imax, jmin, jmax, kmin, kmax] in the IJK coordinates of the
+    labelmap (see ``GetExtent()``), allowing views to only update that
+    region. The whole segment is considered modified if not specified.
+  """
+  segmentation = segmentationNode.GetSegmentation()
+  segment = segmentation.GetSegment(segmentId)
+  if segment is None:
+    raise ValueError("Segment %s not found in %s" % (segmentId, segmentationNode.GetName()))
+  labelmap = segment.GetRepresentation(segmentation.GetMasterRepresentationName())
+  if labelmap and labelmap.GetPointData().GetScalars():
+    labelmap.GetPointData().GetScalars().Modified()
+  if extent is None:
+    segmentation.UpdateSegmentFromMasterRepresentation(segmentId)
+  else:
+    segmentation.UpdateSegmentFromMasterRepresentation(segmentId, [int(v) for v in extent])
+
+#
+# Threads
+#
+
+class BackgroundCall(object):
+  """Handle of a function running in a background thread, returned by
+  :py:meth:`startBackgroundCall`.
+
+  Done callbacks are invoked on the main thread, once the function has
+  returned, with the handle as argument.
+  """
+  pollingIntervalMsec = 20
+
+  def __init__(self, function, args, kwargs):
+    import threading
+    self._result = None
+    self._exception = None
+    self._done = False
+    self._doneCallbacks = []
+    self._timer = None
+    def run():
+      try:
+        self._result = function(*args, **kwargs)
+      except Exception as e:
+        self._exception = e
+    self._thread = threading.Thread(target=run)
+    self._thread.daemon = True
+    self._thread.start()
+
+  def isDone(self):
+    """Return True if the function has returned and the done callbacks have
+    been invoked."""
+    return self._done
+
+  def addDoneCallback(self, callback):
+    """Invoke ``callback(handle)`` on the main thread when the function has
+    returned. Must be called from the main thread."""
+    if self._done:
+      callback(self)
+      return
+    self._doneCallbacks.append(callback)
+    if self._timer is None:
+      import qt
+      self._timer = qt.QTimer()
+      self._timer.setInterval(self.pollingIntervalMsec)
+      self._timer.connect('timeout()', self._poll)
+      self._timer.start()
+
+  def wait(self, processEvents=True):
+    """Block the main thread until the function returns, processing the
+    Qt events meanwhile if ``processEvents`` is True. The GIL is released
+    while waiting."""
+    import qt, slicer
+    while self._thread.is_alive():
+      self._thread.join(self.pollingIntervalMsec / 1000.)
+      if processEvents:
+        slicer.app.processEvents(qt.QEventLoop.ExcludeUserInputEvents)
+    self._complete()
+
+  def result(self):
+    """Wait for the function to return and return its result. The
+    exception raised by the function, if any, is raised again."""
+    self.wait(processEvents=False)
+    if self._exception is not None:
+      raise self._exception
+    return self._result
+
+  def _poll(self):
+    # Yield the GIL briefly to the background thread
+    self._thread.join(0.001)
+    if not self._thread.is_alive():
+      self._complete()
+
+  def _complete(self):
+    if self._done:
+      return
+    self._done = True
+    if self._timer is not None:
+      self._timer.stop()
+      self._timer = None
+    callbacks = self._doneCallbacks
+    self._doneCallbacks = []
+    for callback in callbacks:
+      callback(self)
+
+def startBackgroundCall(function, *args, **kwargs):
+  """Call ``function(*args, **kwargs)`` in a background thread and return
+  a :py:class:`BackgroundCall` handle.
+
+  Wrapped VTK and Slicer C++ methods release the GIL while they run, so
+  several long running computations (e.g. image filters, segmentation
+  conversions, resampling) can use several cores at once. The function
+  must not modify the MRML scene or the GUI: apply its result from a done
+  callback, which runs on the main thread.
+
+  .. code-block:: python
+
+    def resample(inputImage, referenceImage):
+      resampled = slicer.vtkOrientedImageData()
+      slicer.vtkOrientedImageDataResample.ResampleOrientedImageToReferenceOrientedImage(
+        inputImage, referenceImage, resampled)
+      return resampled
+
+    handle = slicer.util.startBackgroundCall(resample, inputImage, referenceImage)
+    handle.addDoneCallback(lambda h: outputVolumeNode.SetAndObserveImageData(h.result()))
+  """
+  return BackgroundCall(function, args, kwargs)
 
 #
 # VTK
@@ -128,6 +128,9 @@ void qSlicerApplicationHelper::setupModuleFactoryManager(qSlicerModuleFactoryMan
 
     qSlicerCLIExecutableModuleFactory* cliExecutableFactory = new qSlicerCLIExecutableModuleFactory();
     cliExecutableFactory->setTempDirectory(tempDirectory);
+    // Avoid running every executable with "--xml" at each startup
+    cliExecutableFactory->setXmlDescriptionCacheDirectory(
+      tempDirectory + "/CLIXmlDescriptionCache");
     moduleFactoryManager->registerFactory(cliExecutableFactory, preferExecutableCLIs ? 1 : 0);
 
     if (!options->disableBuiltInModules() &&
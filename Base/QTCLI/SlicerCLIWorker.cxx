@@ -0,0 +1,142 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Resident process running the shared library of a CLI module on request.
+// It is started by vtkSlicerCLIModuleLogic, which sends it the command lines
+// of the executions so that the libraries (ITK, IO factories...) are loaded
+// only once instead of each time the module executable is run.
+//
+// Usage: SlicerCLIWorker <module library>
+//
+// Each job read from the standard input is the number of arguments followed
+// by the arguments, every value being preceded by its length in bytes:
+//   <length>\n<argc><length>\n<argv[0]>...<length>\n<argv[argc-1]>
+// The standard output of the module is forwarded (progress reporting is
+// unchanged) and its standard error collected. When the module returns, the
+// worker writes on the standard output:
+//   \n<cli-worker-done>returnValue errorLength</cli-worker-done>\n<error>
+// and waits for the next job. It exits when its standard input is closed.
+
+// ITKSYS includes
+#include <itksys/DynamicLoader.hxx>
+
+// STD includes
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+typedef int (*ModuleEntryPoint)(int argc, char* argv[]);
+
+//----------------------------------------------------------------------------
+static bool ReadValue(std::istream& input, std::string& value)
+{
+  std::string line;
+  if (!std::getline(input, line))
+    {
+    return false;
+    }
+  std::string::size_type length =
+    static_cast<std::string::size_type>(atol(line.c_str()));
+  value.resize(length);
+  return length == 0 || !input.read(&value[0], length).fail();
+}
+
+//----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " <module library>" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+#ifdef _WIN32
+  _setmode(_fileno(stdin), _O_BINARY);
+  _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+  itksys::DynamicLoader::LibraryHandle library =
+    itksys::DynamicLoader::OpenLibrary(argv[1]);
+  if (!library)
+    {
+    std::cerr << "Failed to load " << argv[1] << ": "
+              << itksys::DynamicLoader::LastError() << std::endl;
+    return EXIT_FAILURE;
+    }
+  ModuleEntryPoint entryPoint = reinterpret_cast<ModuleEntryPoint>(
+    itksys::DynamicLoader::GetSymbolAddress(library, "ModuleEntryPoint"));
+  if (!entryPoint)
+    {
+    std::cerr << argv[1] << " has no ModuleEntryPoint" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::string value;
+  while (ReadValue(std::cin, value))
+    {
+    int numberOfArguments = atoi(value.c_str());
+    std::vector<std::string> arguments(numberOfArguments);
+    bool complete = true;
+    for (int i = 0; complete && i < numberOfArguments; ++i)
+      {
+      complete = ReadValue(std::cin, arguments[i]);
+      }
+    if (!complete)
+      {
+      break;
+      }
+    std::vector<char*> commandLine(numberOfArguments + 1, static_cast<char*>(0));
+    for (int i = 0; i < numberOfArguments; ++i)
+      {
+      commandLine[i] = const_cast<char*>(arguments[i].c_str());
+      }
+
+    std::ostringstream errorStream;
+    std::streambuf* originalErrorBuffer = std::cerr.rdbuf(errorStream.rdbuf());
+    int returnValue = EXIT_FAILURE;
+    try
+      {
+      returnValue = (*entryPoint)(numberOfArguments, &commandLine[0]);
+      }
+    catch (std::exception& e)
+      {
+      std::cerr << "Terminated with an exception: " << e.what() << std::endl;
+      }
+    catch (...)
+      {
+      std::cerr << "Terminated with an unknown exception." << std::endl;
+      }
+    std::cerr.rdbuf(originalErrorBuffer);
+
+    std::string errorText = errorStream.str();
+    std::cout.flush();
+    fflush(stdout);
+    std::cout << "\n<cli-worker-done>" << returnValue << " " << errorText.size()
+              << "</cli-worker-done>\n" << errorText;
+    std::cout.flush();
+    }
+
+  itksys::DynamicLoader::CloseLibrary(library);
+  return EXIT_SUCCESS;
+}
@@ -19,7 +19,10 @@
 ==============================================================================*/
 
 // Qt includes
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QProcess>
+#include <QThread>
 
 // SlicerQt includes
 #include "qSlicerCLIExecutableModuleFactory.h"
@@ -30,7 +33,12 @@
 
 //-----------------------------------------------------------------------------
 qSlicerCLIExecutableModuleFactoryItem::qSlicerCLIExecutableModuleFactoryItem(
-  const QString& newTempDirectory) : TempDirectory(newTempDirectory)
+  const QString& newTempDirectory, const QString& newXmlDescriptionCacheDirectory,
+  qSlicerCLIExecutableModuleFactory* factory)
+  : TempDirectory(newTempDirectory)
+  , XmlDescriptionCacheDirectory(newXmlDescriptionCacheDirectory)
+  , Factory(factory)
+  , CLIModule(0)
 {
 }
 
@@ -78,7 +86,22 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
     }
   else
     {
-    xmlDescription = this->runCLIWithXmlArgument();
+    if (this->Factory && this->ProbedXmlDescription.isEmpty())
+      {
+      // no-op if the executables have already been probed
+      this->Factory->probeXmlDescriptions();
+      }
+    xmlDescription = this->ProbedXmlDescription;
+    if (xmlDescription.isEmpty())
+      {
+      xmlDescription = this->readCachedXmlDescription();
+      }
+    if (xmlDescription.isEmpty())
+      {
+      // Run it again on its own to report errors
+      xmlDescription = this->runCLIWithXmlArgument();
+      this->writeCachedXmlDescription(xmlDescription);
+      }
     }
   if (xmlDescription.isEmpty())
     {
@@ -96,6 +119,41 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
   return module.take();
 }
 
+//-----------------------------------------------------------------------------
+bool qSlicerCLIExecutableModuleFactoryItem::needsXmlDescriptionProbing()
+{
+  return this->CLIModule == 0
+    && this->ProbedXmlDescription.isEmpty()
+    && !QFile::exists(this->xmlModuleDescriptionFilePath())
+    && this->readCachedXmlDescription().isEmpty();
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactoryItem::setProbedXmlDescription(const QString& xmlDescription)
+{
+  this->ProbedXmlDescription = xmlDescription;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactoryItem::configureXmlArgumentProcess(QProcess& process)
+{
+  process.setWorkingDirectory(QFileInfo(this->path()).path());
+  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+  env.insert("ITK_AUTOLOAD_PATH", "");
+  process.setProcessEnvironment(env);
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactoryItem::extractXmlDescription(const QString& output)
+{
+  int xmlStart = output.indexOf("<?xml");
+  if (xmlStart < 0)
+    {
+    return QString();
+    }
+  return output.mid(xmlStart);
+}
+
 //-----------------------------------------------------------------------------
 QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
 {
@@ -103,9 +161,7 @@ QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
 
   int cliProcessTimeoutInMs = 5000;
   QProcess cli;
-  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-  env.insert("ITK_AUTOLOAD_PATH", "");
-  cli.setProcessEnvironment(env);
+  this->configureXmlArgumentProcess(cli);
   cli.start(this->path(), QStringList(QString("--xml")));
   bool res = cli.waitForFinished(cliProcessTimeoutInMs);
   if (!res)
@@ -175,6 +231,71 @@ QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
   return xmlDescription;
 }
 
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactoryItem::cachedXmlDescriptionFilePath()
+{
+  if (this->XmlDescriptionCacheDirectory.isEmpty())
+    {
+    return QString();
+    }
+  QFileInfo info(this->path());
+  QString pathHash = QCryptographicHash::hash(
+    info.absoluteFilePath().toUtf8(), QCryptographicHash::Md5).toHex();
+  return QDir(this->XmlDescriptionCacheDirectory).filePath(
+    QString("%1_%2_%3.xml").arg(pathHash).arg(info.size())
+                           .arg(info.lastModified().toTime_t()));
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactoryItem::readCachedXmlDescription()
+{
+  QString cacheFilePath = this->cachedXmlDescriptionFilePath();
+  if (cacheFilePath.isEmpty() || !QFile::exists(cacheFilePath))
+    {
+    return QString();
+    }
+  QFile cacheFile(cacheFilePath);
+  if (!cacheFile.open(QIODevice::ReadOnly))
+    {
+    return QString();
+    }
+  QString xmlDescription = QTextStream(&cacheFile).readAll();
+  if (!xmlDescription.startsWith("<?xml"))
+    {
+    // Truncated or corrupted cache entry, probe the executable again
+    return QString();
+    }
+  return xmlDescription;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactoryItem::writeCachedXmlDescription(const QString& xmlDescription)
+{
+  QString cacheFilePath = this->cachedXmlDescriptionFilePath();
+  if (cacheFilePath.isEmpty() || xmlDescription.isEmpty())
+    {
+    return;
+    }
+  QDir cacheDir(this->XmlDescriptionCacheDirectory);
+  if (!cacheDir.exists() && !QDir().mkpath(cacheDir.absolutePath()))
+    {
+    return;
+    }
+  // Remove the descriptions cached for previous versions of the executable
+  QString pathHash = QFileInfo(cacheFilePath).fileName().section('_', 0, 0);
+  foreach(const QString& outdatedFile,
+          cacheDir.entryList(QStringList() << pathHash + "_*.xml", QDir::Files))
+    {
+    cacheDir.remove(outdatedFile);
+    }
+  QFile cacheFile(cacheFilePath);
+  if (!cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+    return;
+    }
+  QTextStream(&cacheFile) << xmlDescription;
+}
+
 //-----------------------------------------------------------------------------
 void qSlicerCLIExecutableModuleFactoryItem::uninstantiate()
 {
@@ -197,6 +318,8 @@ public:
 
 private:
   QString TempDirectory;
+  QString XmlDescriptionCacheDirectory;
+  bool XmlDescriptionsProbed;
 };
 
 //-----------------------------------------------------------------------------
@@ -204,6 +327,7 @@ qSlicerCLIExecutableModuleFactoryPrivate::qSlicerCLIExecutableModuleFactoryPriva
 :q_ptr(&object)
 {
   this->TempDirectory = QDir::tempPath();
+  this->XmlDescriptionsProbed = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -246,7 +370,8 @@ ctkAbstractFactoryItem<qSlicerAbstractCoreModule>* qSlicerCLIExecutableModuleFac
 ::createFactoryFileBasedItem()
 {
   Q_D(qSlicerCLIExecutableModuleFactory);
-  return new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory);
+  return new qSlicerCLIExecutableModuleFactoryItem(
+    d->TempDirectory, d->XmlDescriptionCacheDirectory, this);
 }
 
 //-----------------------------------------------------------------------------
@@ -261,3 +386,78 @@ void qSlicerCLIExecutableModuleFactory::setTempDirectory(const QString& newTempD
   Q_D(qSlicerCLIExecutableModuleFactory);
   d->TempDirectory = newTempDirectory;
 }
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactory::setXmlDescriptionCacheDirectory(const QString& cacheDirectory)
+{
+  Q_D(qSlicerCLIExecutableModuleFactory);
+  d->XmlDescriptionCacheDirectory = cacheDirectory;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactory::xmlDescriptionCacheDirectory()const
+{
+  Q_D(const qSlicerCLIExecutableModuleFactory);
+  return d->XmlDescriptionCacheDirectory;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactory::probeXmlDescriptions()
+{
+  Q_D(qSlicerCLIExecutableModuleFactory);
+  if (d->XmlDescriptionsProbed)
+    {
+    return;
+    }
+  d->XmlDescriptionsProbed = true;
+
+  QList<qSlicerCLIExecutableModuleFactoryItem*> items;
+  foreach(const QString& key, this->itemKeys())
+    {
+    qSlicerCLIExecutableModuleFactoryItem* item =
+      dynamic_cast<qSlicerCLIExecutableModuleFactoryItem*>(this->item(key));
+    if (item && item->needsXmlDescriptionProbing())
+      {
+      items << item;
+      }
+    }
+
+  const int cliProcessTimeoutInMs = 5000;
+  const int maximumNumberOfProcesses = qMax(QThread::idealThreadCount(), 1);
+  while (!items.isEmpty())
+    {
+    // Start a batch of executables and collect their descriptions.
+    // Failures are reported when the module is instantiated.
+    QList<qSlicerCLIExecutableModuleFactoryItem*> batch =
+      items.mid(0, maximumNumberOfProcesses);
+    items = items.mid(batch.count());
+    QList<QProcess*> processes;
+    foreach(qSlicerCLIExecutableModuleFactoryItem* item, batch)
+      {
+      QProcess* process = new QProcess;
+      item->configureXmlArgumentProcess(*process);
+      process->start(item->path(), QStringList(QString("--xml")));
+      processes << process;
+      }
+    for (int i = 0; i < batch.count(); ++i)
+      {
+      QProcess* process = processes[i];
+      if (process->waitForFinished(cliProcessTimeoutInMs)
+          && process->exitStatus() == QProcess::NormalExit
+          && process->readAllStandardError().isEmpty())
+        {
+        QString xmlDescription =
+          qSlicerCLIExecutableModuleFactoryItem::extractXmlDescription(
+            process->readAllStandardOutput());
+        batch[i]->setProbedXmlDescription(xmlDescription);
+        batch[i]->writeCachedXmlDescription(xmlDescription);
+        }
+      else
+        {
+        process->kill();
+        process->waitForFinished();
+        }
+      delete process;
+      }
+    }
+}
@@ -25,6 +25,10 @@
 #include "qSlicerAbstractCoreModule.h"
 #include "qSlicerBaseQTCLIExport.h"
 class qSlicerCLIModule;
+class qSlicerCLIExecutableModuleFactory;
+
+// Qt includes
+class QProcess;
 
 // CTK includes
 #include <ctkPimpl.h>
@@ -35,17 +39,51 @@ class qSlicerCLIExecutableModuleFactoryItem
   : public ctkAbstractFactoryFileBasedItem<qSlicerAbstractCoreModule>
 {
 public:
-  qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory);
+  qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory,
+                                        const QString& newXmlDescriptionCacheDirectory = QString(),
+                                        qSlicerCLIExecutableModuleFactory* factory = 0);
   virtual bool load();
   virtual void uninstantiate();
+
+  /// Return true if the XML description can only be retrieved by running
+  /// the executable with "--xml" (no XML file, no valid cached description).
+  bool needsXmlDescriptionProbing();
+  /// Set the description retrieved by running the executable ahead of
+  /// instantiation.
+  /// \sa qSlicerCLIExecutableModuleFactory::probeXmlDescriptions()
+  void setProbedXmlDescription(const QString& xmlDescription);
+
+  /// Set the working directory and environment of a \a process running the
+  /// executable to retrieve its XML description.
+  void configureXmlArgumentProcess(QProcess& process);
+  /// Remove any output printed by the executable before its XML description.
+  /// Return an empty string if \a output contains no description.
+  static QString extractXmlDescription(const QString& output);
 protected:
   /// Return path of the expected XML file.
   QString xmlModuleDescriptionFilePath();
 
   virtual qSlicerAbstractCoreModule* instanciator();
   QString runCLIWithXmlArgument();
+
+  /// Return the path of the cached XML description of the executable.
+  /// The file name depends on the executable path, size and last
+  /// modification time so that a modified executable is probed again.
+  /// Return an empty string if there is no cache directory.
+  QString cachedXmlDescriptionFilePath();
+  /// Return the cached XML description or an empty string if the
+  /// executable has no valid cached description.
+  QString readCachedXmlDescription();
+  /// Save \a xmlDescription in the cache and remove the outdated
+  /// descriptions of the executable.
+  void writeCachedXmlDescription(const QString& xmlDescription);
+
+  friend class qSlicerCLIExecutableModuleFactory;
 private:
   QString TempDirectory;
+  QString XmlDescriptionCacheDirectory;
+  QString ProbedXmlDescription;
+  qSlicerCLIExecutableModuleFactory* Factory;
   qSlicerCLIModule* CLIModule;
 };
 
@@ -71,6 +109,18 @@ public:
 
   void setTempDirectory(const QString& newTempDirectory);
 
+  /// Directory where the XML descriptions returned by the executables
+  /// with "--xml" are cached, so that executables are only run again when
+  /// they change. Caching is disabled if empty (default).
+  void setXmlDescriptionCacheDirectory(const QString& cacheDirectory);
+  QString xmlDescriptionCacheDirectory()const;
+
+  /// Run concurrently with "--xml" all the registered executables that need
+  /// it, at most QThread::idealThreadCount() at a time. It is done
+  /// automatically when the first executable is instantiated so that
+  /// startup doesn't pay for each executable in sequence.
+  void probeXmlDescriptions();
+
 protected:
   virtual bool isValidFile(const QFileInfo& file)const;
 
@@ -21,6 +21,7 @@
 #include "qSlicerCLIModule.h"
 
 // Qt includes
+#include <QCoreApplication>
 #include <QDebug>
 #include <QSettings>
 
@@ -102,6 +103,19 @@ vtkMRMLAbstractLogic* qSlicerCLIModule::createLogic()
     logic->DeleteTemporaryFilesOff();
     }
 
+  // Run executable CLIs in resident worker processes to save their startup
+  QString workerExecutable = QCoreApplication::applicationDirPath() + "/SlicerCLIWorker";
+#ifdef Q_OS_WIN
+  workerExecutable += ".exe";
+#endif
+  logic->SetWorkerExecutable(workerExecutable.toStdString());
+  logic->SetUseWorkerProcesses(settings.value("Modules/CLIWorkerProcesses", false).toBool());
+
+  // Run executable CLIs on a compute cluster, see vtkSlicerCLIModuleLogic::SetRemoteLauncher()
+  logic->SetRemoteLauncher(settings.value("Modules/CLIRemoteLauncher").toString().toStdString());
+  logic->SetRemoteDataExchangeDirectory(
+    settings.value("Modules/CLIRemoteDataExchangeDirectory").toString().toStdString());
+
   return logic;
 }
 
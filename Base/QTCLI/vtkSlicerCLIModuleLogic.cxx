@@ -16,6 +16,7 @@
 
 // SlicerExecutionModel includes
 #include <ModuleDescription.h>
+#include <ModuleProcessInformation.h>
 
 // MRML includes
 #include <vtkEventBroker.h>
@@ -34,10 +35,12 @@
 
 // VTK includes
 #include <vtkCallbackCommand.h>
+#include <vtkCollection.h>
 #include <vtkIntArray.h>
 #include <vtkMultiThreader.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkPolyData.h>
 #include <vtkStringArray.h>
 #include <vtksys/SystemTools.hxx>
 
@@ -60,6 +63,7 @@
 #include <set>
 
 #ifdef _WIN32
+#include <windows.h>
 #else
 #include <sys/types.h>
 #include <unistd.h>
@@ -79,6 +83,139 @@ struct DigitsToCharacters
     }
 };
 
+//----------------------------------------------------------------------------
+// Update the process information with the last progress reported in the
+// output of a module. Returns true if any progress was found.
+static bool UpdateProcessInformationFromOutput(ModuleProcessInformation* info,
+                                               const std::string& output)
+{
+  bool foundTag = false;
+  std::string::size_type tagend;
+  std::string::size_type tagstart;
+  // search for the last occurence of </filter-progress>
+  tagend = output.rfind("</filter-progress>");
+  if (tagend != std::string::npos)
+    {
+    tagstart = output.rfind("<filter-progress>");
+    if (tagstart != std::string::npos)
+      {
+      std::string progressString(output, tagstart+17,
+                                 tagend-tagstart-17);
+      info->Progress = atof(progressString.c_str());
+      foundTag = true;
+      }
+    }
+  // search for the last occurence of </filter-stage-progress>
+  tagend = output.rfind("</filter-stage-progress>");
+  if (tagend != std::string::npos)
+    {
+    tagstart = output.rfind("<filter-stage-progress>");
+    if (tagstart != std::string::npos)
+      {
+      std::string progressString(output, tagstart+23,
+                                 tagend-tagstart-23);
+      info->StageProgress = atof(progressString.c_str());
+      foundTag = true;
+      }
+    }
+
+  // search for the last occurence of </filter-name>
+  tagend = output.rfind("</filter-name>");
+  if (tagend != std::string::npos)
+    {
+    tagstart = output.rfind("<filter-name>");
+    if (tagstart != std::string::npos)
+      {
+      std::string filterString(output, tagstart+13,
+                               tagend-tagstart-13);
+      strncpy(info->ProgressMessage, filterString.c_str(), 1023);
+      foundTag = true;
+      }
+    }
+
+  // search for the last occurence of </filter-comment>
+  tagend = output.rfind("</filter-comment>");
+  if (tagend != std::string::npos)
+    {
+    tagstart = output.rfind("<filter-comment>");
+    if (tagstart != std::string::npos)
+      {
+      std::string progressMessage(output, tagstart+16,
+                                 tagend-tagstart-16);
+      strncpy (info->ProgressMessage, progressMessage.c_str(), 1023);
+      foundTag = true;
+      }
+    }
+  return foundTag;
+}
+
+//----------------------------------------------------------------------------
+static void RemoveProcessInformationTags(std::string& output)
+{
+  // remove the embedded XML from the stdout stream
+  //
+  // Note that itksys::RegularExpression gives begin()/end() as
+  // size_types not iterators. So we need to use the version of
+  // erase that takes a position and length to erase.
+  //
+  itksys::RegularExpression filterProgressRegExp("<filter-progress>[^<]*</filter-progress>[ \t\n\r]*");
+  while (filterProgressRegExp.find(output))
+    {
+    output.erase(filterProgressRegExp.start(),
+                       filterProgressRegExp.end()
+                       - filterProgressRegExp.start());
+    }
+  itksys::RegularExpression filterStageProgressRegExp("<filter-stage-progress>[^<]*</filter-stage-progress>[ \t\n\r]*");
+  while (filterStageProgressRegExp.find(output))
+    {
+    output.erase(filterStageProgressRegExp.start(),
+                       filterStageProgressRegExp.end()
+                       - filterStageProgressRegExp.start());
+    }
+  itksys::RegularExpression filterNameRegExp("<filter-name>[^<]*</filter-name>[ \t\n\r]*");
+  while (filterNameRegExp.find(output))
+    {
+    output.erase(filterNameRegExp.start(),
+                       filterNameRegExp.end()
+                       - filterNameRegExp.start());
+    }
+  itksys::RegularExpression filterCommentRegExp("<filter-comment>[^<]*</filter-comment>[ \t\n\r]*");
+  while (filterCommentRegExp.find(output))
+    {
+    output.erase(filterCommentRegExp.start(),
+                       filterCommentRegExp.end()
+                       - filterCommentRegExp.start());
+    }
+  itksys::RegularExpression filterTimeRegExp("<filter-time>[^<]*</filter-time>[ \t\n\r]*");
+  while (filterTimeRegExp.find(output))
+    {
+    output.erase(filterTimeRegExp.start(),
+                       filterTimeRegExp.end()
+                       - filterTimeRegExp.start());
+    }
+  itksys::RegularExpression filterStartRegExp("<filter-start>[^<]*</filter-start>[ \t\n\r]*");
+  while (filterStartRegExp.find(output))
+    {
+    output.erase(filterStartRegExp.start(),
+                       filterStartRegExp.end()
+                       - filterStartRegExp.start());
+    }
+  itksys::RegularExpression filterIntermediateOutputRegExp("<filter-intermediate-output>[^<]*</filter-intermediate-output>[ \t\n\r]*");
+  while (filterIntermediateOutputRegExp.find(output))
+    {
+    output.erase(filterIntermediateOutputRegExp.start(),
+                 filterIntermediateOutputRegExp.end()
+                 - filterIntermediateOutputRegExp.start());
+    }
+  itksys::RegularExpression filterEndRegExp("<filter-end>[^<]*</filter-end>[ \t\n\r]*");
+  while (filterEndRegExp.find(output))
+    {
+    output.erase(filterEndRegExp.start(),
+                       filterEndRegExp.end()
+                       - filterEndRegExp.start());
+    }
+}
+
 typedef std::pair<vtkSlicerCLIModuleLogic *, vtkMRMLCommandLineModuleNode *> LogicNodePair;
 class MRMLIDMap : public std::map<std::string, std::string> {};
 
@@ -92,8 +229,12 @@ public:
   }
   virtual void Execute(vtkObject* caller, unsigned long eid, void *callData)
   {
-    if (std::find(this->ThreadIDs.begin(), this->ThreadIDs.end(),
-                  vtkMultiThreader::GetCurrentThreadID()) != this->ThreadIDs.end())
+    // Several CLIs may run concurrently in different processing threads
+    this->ThreadIDsLock->Lock();
+    bool reschedule = (std::find(this->ThreadIDs.begin(), this->ThreadIDs.end(),
+      vtkMultiThreader::GetCurrentThreadID()) != this->ThreadIDs.end());
+    this->ThreadIDsLock->Unlock();
+    if (reschedule)
       {
       if (this->CLIModuleLogic)
         {
@@ -129,20 +270,25 @@ public:
       {
       return;
       }
+    this->ThreadIDsLock->Lock();
     if (reschedule)
       {
       this->ThreadIDs.push_back(id);
       }
     else
       {
-      std::remove(this->ThreadIDs.begin(), this->ThreadIDs.end(), id);
+      this->ThreadIDs.erase(
+        std::remove(this->ThreadIDs.begin(), this->ThreadIDs.end(), id),
+        this->ThreadIDs.end());
       }
+    this->ThreadIDsLock->Unlock();
   }
 protected:
   vtkSlicerCLIRescheduleCallback()
   {
     this->CLIModuleLogic = 0;
     this->Delay = 0;
+    this->ThreadIDsLock = itk::MutexLock::New();
   }
   ~vtkSlicerCLIRescheduleCallback()
   {
@@ -152,6 +298,7 @@ protected:
   vtkSlicerCLIModuleLogic* CLIModuleLogic;
   int Delay;
   std::vector<vtkMultiThreaderIDType> ThreadIDs;
+  itk::MutexLock::Pointer ThreadIDsLock;
 };
 
 //---------------------------------------------------------------------------
@@ -317,6 +464,132 @@ protected:
   std::string ReferenceNodeID;
 };
 
+//----------------------------------------------------------------------------
+// Resident process running the shared library of an executable module.
+// See SlicerCLIWorker.cxx for the protocol.
+struct vtkSlicerCLIWorkerProcess
+{
+  vtkSlicerCLIWorkerProcess()
+    : Process(0)
+#ifdef _WIN32
+    , Input(INVALID_HANDLE_VALUE)
+#else
+    , Input(-1)
+#endif
+  {
+  }
+  ~vtkSlicerCLIWorkerProcess()
+  {
+    // Closing the standard input of the worker makes it exit.
+#ifdef _WIN32
+    if (this->Input != INVALID_HANDLE_VALUE)
+      {
+      CloseHandle(this->Input);
+      }
+#else
+    if (this->Input >= 0)
+      {
+      close(this->Input);
+      }
+#endif
+    if (this->Process)
+      {
+      double timeout = 1.;
+      if (itksysProcess_GetState(this->Process) == itksysProcess_State_Executing &&
+          !itksysProcess_WaitForExit(this->Process, &timeout))
+        {
+        itksysProcess_Kill(this->Process);
+        itksysProcess_WaitForExit(this->Process, 0);
+        }
+      itksysProcess_Delete(this->Process);
+      }
+  }
+
+  /// Start the worker executable for the module library.
+  bool Start(const std::string& workerExecutable, const std::string& library)
+  {
+    itksysProcess_Pipe_Handle input[2];
+#ifdef _WIN32
+    if (!CreatePipe(&input[0], &input[1], 0, 0))
+      {
+      return false;
+      }
+#else
+    if (pipe(input) != 0)
+      {
+      return false;
+      }
+#endif
+    const char* command[3] = {workerExecutable.c_str(), library.c_str(), 0};
+    this->Process = itksysProcess_New();
+    itksysProcess_SetCommand(this->Process, command);
+    itksysProcess_SetOption(this->Process, itksysProcess_Option_Detach, 0);
+    itksysProcess_SetOption(this->Process, itksysProcess_Option_HideWindow, 1);
+    itksysProcess_SetPipeNative(this->Process, itksysProcess_Pipe_STDIN, input);
+    // Same as executable modules, don't load the itkMRMLIDIOPlugin plugin.
+    std::string saveITKAutoLoadPath;
+    itksys::SystemTools::GetEnv("ITK_AUTOLOAD_PATH", saveITKAutoLoadPath);
+    std::string emptyString("ITK_AUTOLOAD_PATH=");
+    itksys::SystemTools::PutEnv(const_cast <char *> (emptyString.c_str()));
+    itksysProcess_Execute(this->Process);
+    std::string putEnvString = std::string("ITK_AUTOLOAD_PATH=") + saveITKAutoLoadPath;
+    itksys::SystemTools::PutEnv(const_cast <char *> (putEnvString.c_str()));
+    // The read end now belongs to the worker.
+#ifdef _WIN32
+    CloseHandle(input[0]);
+#else
+    close(input[0]);
+#endif
+    this->Input = input[1];
+    this->Library = library;
+    return itksysProcess_GetState(this->Process) == itksysProcess_State_Executing;
+  }
+
+  /// Send the command line of a job to the worker.
+  bool Send(const std::vector<std::string>& commandLine)
+  {
+    std::ostringstream job;
+    std::ostringstream numberOfArguments;
+    numberOfArguments << commandLine.size();
+    job << numberOfArguments.str().size() << "\n" << numberOfArguments.str();
+    for (std::vector<std::string>::const_iterator it = commandLine.begin();
+         it != commandLine.end(); ++it)
+      {
+      job << it->size() << "\n" << *it;
+      }
+    const std::string buffer = job.str();
+    std::string::size_type written = 0;
+    while (written < buffer.size())
+      {
+#ifdef _WIN32
+      DWORD count = 0;
+      if (!WriteFile(this->Input, buffer.c_str() + written,
+                     static_cast<DWORD>(buffer.size() - written), &count, 0))
+        {
+        return false;
+        }
+#else
+      ssize_t count = write(this->Input, buffer.c_str() + written,
+                            buffer.size() - written);
+      if (count <= 0)
+        {
+        return false;
+        }
+#endif
+      written += count;
+      }
+    return true;
+  }
+
+  itksysProcess* Process;
+#ifdef _WIN32
+  HANDLE Input;
+#else
+  int Input;
+#endif
+  std::string Library;
+};
+
 //----------------------------------------------------------------------------
 class vtkSlicerCLIModuleLogic::vtkInternal
 {
@@ -326,9 +599,57 @@ public:
 
   int RedirectModuleStreams;
 
+  bool InMemoryModelTransfer;
+
+  bool SharedMemoryDataExchange;
+
   itk::MutexLock::Pointer ProcessesKillLock;
   std::vector<itksysProcess*> Processes;
 
+  double IntermediateOutputInterval;
+
+  bool UseWorkerProcesses;
+  std::string WorkerExecutable;
+  /// Workers waiting for a job, a busy worker is owned by the task running it.
+  itk::MutexLock::Pointer WorkerProcessesLock;
+  std::vector<vtkSlicerCLIWorkerProcess*> IdleWorkerProcesses;
+
+  std::string RemoteLauncher;
+  std::string RemoteDataExchangeDirectory;
+
+  /// Return an idle worker for the library or start a new one.
+  /// Returns 0 if no worker could be started.
+  vtkSlicerCLIWorkerProcess* TakeWorkerProcess(const std::string& library)
+  {
+    this->WorkerProcessesLock->Lock();
+    std::vector<vtkSlicerCLIWorkerProcess*>::iterator it;
+    for (it = this->IdleWorkerProcesses.begin();
+         it != this->IdleWorkerProcesses.end(); ++it)
+      {
+      if ((*it)->Library == library)
+        {
+        vtkSlicerCLIWorkerProcess* worker = *it;
+        this->IdleWorkerProcesses.erase(it);
+        this->WorkerProcessesLock->Unlock();
+        return worker;
+        }
+      }
+    this->WorkerProcessesLock->Unlock();
+    vtkSlicerCLIWorkerProcess* worker = new vtkSlicerCLIWorkerProcess;
+    if (!worker->Start(this->WorkerExecutable, library))
+      {
+      delete worker;
+      return 0;
+      }
+    return worker;
+  }
+  void ReleaseWorkerProcess(vtkSlicerCLIWorkerProcess* worker)
+  {
+    this->WorkerProcessesLock->Lock();
+    this->IdleWorkerProcesses.push_back(worker);
+    this->WorkerProcessesLock->Unlock();
+  }
+
   typedef std::vector<std::pair<int, vtkMRMLCommandLineModuleNode*> > RequestType;
   struct FindRequest
   {
@@ -425,6 +746,11 @@ vtkSlicerCLIModuleLogic::vtkSlicerCLIModuleLogic()
   this->Internal->ProcessesKillLock = itk::MutexLock::New();
   this->Internal->DeleteTemporaryFiles = 1;
   this->Internal->RedirectModuleStreams = 1;
+  this->Internal->InMemoryModelTransfer = false;
+  this->Internal->SharedMemoryDataExchange = false;
+  this->Internal->IntermediateOutputInterval = 1.;
+  this->Internal->UseWorkerProcesses = false;
+  this->Internal->WorkerProcessesLock = itk::MutexLock::New();
   this->Internal->RescheduleCallback =
     vtkSmartPointer<vtkSlicerCLIRescheduleCallback>::New();
   this->Internal->RescheduleCallback->SetCLIModuleLogic(this);
@@ -440,6 +766,12 @@ vtkSlicerCLIModuleLogic::~vtkSlicerCLIModuleLogic()
 {
   this->RemoveObserver(this->Internal->OneShotCallbackCallback);
 
+  for (std::vector<vtkSlicerCLIWorkerProcess*>::iterator it =
+         this->Internal->IdleWorkerProcesses.begin();
+       it != this->Internal->IdleWorkerProcesses.end(); ++it)
+    {
+    delete *it;
+    }
   delete this->Internal;
 }
 
@@ -540,6 +872,382 @@ int vtkSlicerCLIModuleLogic::GetRedirectModuleStreams() const
   return this->Internal->RedirectModuleStreams;
 }
 
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetInMemoryModelTransfer(bool enable)
+{
+  this->Internal->InMemoryModelTransfer = enable;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::GetInMemoryModelTransfer() const
+{
+  return this->Internal->InMemoryModelTransfer;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetSharedMemoryDataExchange(bool enable)
+{
+  this->Internal->SharedMemoryDataExchange = enable;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::GetSharedMemoryDataExchange() const
+{
+  return this->Internal->SharedMemoryDataExchange;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetIntermediateOutputInterval(double seconds)
+{
+  if (this->Internal->IntermediateOutputInterval == seconds)
+    {
+    return;
+    }
+  this->Internal->IntermediateOutputInterval = seconds;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerCLIModuleLogic::GetIntermediateOutputInterval() const
+{
+  return this->Internal->IntermediateOutputInterval;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::RequestIntermediateOutput(
+  vtkMRMLCommandLineModuleNode* node, const std::string& output,
+  std::string::size_type& position, const MRMLIDMap& intermediateOutputFiles,
+  double& lastRequestTime)
+{
+  const std::string startTag("<filter-intermediate-output>");
+  const std::string endTag("</filter-intermediate-output>");
+  std::string::size_type tagend = output.rfind(endTag);
+  if (tagend == std::string::npos || tagend < position)
+    {
+    return;
+    }
+  std::string::size_type tagstart = output.rfind(startTag, tagend);
+  position = tagend + endTag.size();
+  if (tagstart == std::string::npos ||
+      this->Internal->IntermediateOutputInterval < 0.)
+    {
+    return;
+    }
+  double now = itksys::SystemTools::GetTime();
+  if (now - lastRequestTime < this->Internal->IntermediateOutputInterval)
+    {
+    return;
+    }
+  std::string fileName(output, tagstart + startTag.size(),
+                       tagend - tagstart - startTag.size());
+  MRMLIDMap::const_iterator it = intermediateOutputFiles.find(fileName);
+  if (it == intermediateOutputFiles.end())
+    {
+    vtkWarningMacro(<< node->GetModuleDescription().GetTitle()
+                    << " reported an intermediate output that is not an output file: "
+                    << fileName);
+    return;
+    }
+  // The module may overwrite the file while it is read in the main thread,
+  // load a copy instead.
+  std::string copyName = itksys::SystemTools::GetFilenamePath(fileName)
+    + "/intermediate-" + itksys::SystemTools::GetFilenameName(fileName);
+  if (!itksys::SystemTools::CopyFileAlways(fileName.c_str(), copyName.c_str()))
+    {
+    return;
+    }
+  lastRequestTime = now;
+  this->GetApplicationLogic()->RequestReadData(it->second.c_str(),
+                                                copyName.c_str(), false, true);
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetUseWorkerProcesses(bool enable)
+{
+  if (this->Internal->UseWorkerProcesses == enable)
+    {
+    return;
+    }
+  this->Internal->UseWorkerProcesses = enable;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::GetUseWorkerProcesses() const
+{
+  return this->Internal->UseWorkerProcesses;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetWorkerExecutable(const std::string& path)
+{
+  if (this->Internal->WorkerExecutable == path)
+    {
+    return;
+    }
+  this->Internal->WorkerExecutable = path;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSlicerCLIModuleLogic::GetWorkerExecutable() const
+{
+  return this->Internal->WorkerExecutable;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetRemoteLauncher(const std::string& path)
+{
+  if (this->Internal->RemoteLauncher == path)
+    {
+    return;
+    }
+  this->Internal->RemoteLauncher = path;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSlicerCLIModuleLogic::GetRemoteLauncher() const
+{
+  return this->Internal->RemoteLauncher;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetRemoteDataExchangeDirectory(const std::string& path)
+{
+  if (this->Internal->RemoteDataExchangeDirectory == path)
+    {
+    return;
+    }
+  this->Internal->RemoteDataExchangeDirectory = path;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSlicerCLIModuleLogic::GetRemoteDataExchangeDirectory() const
+{
+  return this->Internal->RemoteDataExchangeDirectory;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSlicerCLIModuleLogic::FindWorkerLibrary(const ModuleDescription& d)
+{
+  if (!this->Internal->UseWorkerProcesses ||
+      !this->Internal->RemoteLauncher.empty() ||
+      this->Internal->WorkerExecutable.empty() ||
+      !itksys::SystemTools::FileExists(this->Internal->WorkerExecutable.c_str(), true))
+    {
+    return std::string();
+    }
+  // Modules run through another executable (e.g. an interpreter) can't be
+  // run by a worker.
+  if (d.GetLocation() != std::string("") && d.GetLocation() != d.GetTarget())
+    {
+    return std::string();
+    }
+  // Libraries of the CLIs built with SEMMacroBuildCLI are named after the
+  // executable with a "Lib" suffix and are in the same directory.
+  std::string directory = itksys::SystemTools::GetFilenamePath(d.GetTarget());
+  std::string name = itksys::SystemTools::GetFilenameWithoutExtension(d.GetTarget());
+#if defined(_WIN32)
+  std::string library = directory + "/" + name + "Lib.dll";
+#elif defined(__APPLE__)
+  std::string library = directory + "/lib" + name + "Lib.dylib";
+#else
+  std::string library = directory + "/lib" + name + "Lib.so";
+#endif
+  if (!itksys::SystemTools::FileExists(library.c_str(), true))
+    {
+    return std::string();
+    }
+  return library;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::RunInWorkerProcess(
+  vtkMRMLCommandLineModuleNode* node0, const std::string& library,
+  const std::vector<std::string>& commandLine,
+  const MRMLIDMap& intermediateOutputFiles)
+{
+  vtkSlicerCLIWorkerProcess* worker = this->Internal->TakeWorkerProcess(library);
+  if (!worker)
+    {
+    return false;
+    }
+  if (!worker->Send(commandLine))
+    {
+    // The worker may have exited since its last job, try a new one.
+    delete worker;
+    worker = this->Internal->TakeWorkerProcess(library);
+    if (!worker || !worker->Send(commandLine))
+      {
+      delete worker;
+      return false;
+      }
+    }
+  qDebug() << "Running" << node0->GetModuleDescription().GetTitle().c_str()
+           << "in worker process";
+
+  this->Internal->ProcessesKillLock->Lock();
+  this->Internal->Processes.push_back(worker->Process);
+  this->Internal->ProcessesKillLock->Unlock();
+
+  // Wait for the job to complete
+  ModuleProcessInformation* info =
+    node0->GetModuleDescription().GetProcessInformation();
+  const std::string doneStartTag("\n<cli-worker-done>");
+  const std::string doneEndTag("</cli-worker-done>\n");
+  char *tbuffer;
+  int length;
+  int pipe;
+  const double timeoutlimit = 0.1;    // tenth of a second
+  double timeout = timeoutlimit;
+  std::string stdoutbuffer;
+  std::string stderrbuffer;
+  std::string::size_type intermediateOutputPosition = 0;
+  double lastIntermediateOutputTime = 0.;
+  bool done = false;
+  bool cancelled = false;
+  int returnValue = 0;
+  while (!done && (pipe = itksysProcess_WaitForData(worker->Process, &tbuffer,
+                                                    &length, &timeout)) != 0)
+    {
+    info->ElapsedTime += (timeoutlimit - timeout);
+    this->GetApplicationLogic()->RequestModified( node0 );
+    timeout = timeoutlimit;
+
+    if (info->Abort)
+      {
+      cancelled = true;
+      info->Progress = 0;
+      info->StageProgress = 0;
+      this->GetApplicationLogic()->RequestModified( node0 );
+      break;
+      }
+    if (length == 0 || tbuffer == 0)
+      {
+      continue;
+      }
+    if (pipe == itksysProcess_Pipe_STDERR)
+      {
+      stderrbuffer.append(tbuffer, length);
+      continue;
+      }
+    if (pipe != itksysProcess_Pipe_STDOUT)
+      {
+      continue;
+      }
+    stdoutbuffer.append(tbuffer, length);
+    if (UpdateProcessInformationFromOutput(info, stdoutbuffer))
+      {
+      this->GetApplicationLogic()->RequestModified( node0 );
+      }
+    this->RequestIntermediateOutput(node0, stdoutbuffer, intermediateOutputPosition,
+                                    intermediateOutputFiles, lastIntermediateOutputTime);
+    // The standard error collected by the worker follows the done tag.
+    std::string::size_type tagstart = stdoutbuffer.find(doneStartTag);
+    std::string::size_type tagend = stdoutbuffer.find(doneEndTag, tagstart);
+    if (tagstart != std::string::npos && tagend != std::string::npos)
+      {
+      std::istringstream status(stdoutbuffer.substr(
+        tagstart + doneStartTag.size(), tagend - tagstart - doneStartTag.size()));
+      std::string::size_type errorLength = 0;
+      status >> returnValue >> errorLength;
+      std::string::size_type errorStart = tagend + doneEndTag.size();
+      if (stdoutbuffer.size() >= errorStart + errorLength)
+        {
+        stderrbuffer.append(stdoutbuffer, errorStart, errorLength);
+        stdoutbuffer.erase(tagstart);
+        done = true;
+        }
+      }
+    }
+
+  this->Internal->ProcessesKillLock->Lock();
+  this->Internal->Processes.erase(
+    std::find(this->Internal->Processes.begin(), this->Internal->Processes.end(), worker->Process));
+  this->Internal->ProcessesKillLock->Unlock();
+  if (done)
+    {
+    this->Internal->ReleaseWorkerProcess(worker);
+    }
+  else
+    {
+    // Cancelled or crashed, a new worker is started for the next execution.
+    itksysProcess_Kill(worker->Process);
+    delete worker;
+    }
+
+  RemoveProcessInformationTags(stdoutbuffer);
+  if (stdoutbuffer.size() > 0)
+    {
+    std::string tmp(" standard output:\n\n");
+    stdoutbuffer.insert(0, node0->GetModuleDescription().GetTitle()+tmp);
+    qDebug() << stdoutbuffer.c_str();
+    }
+  node0->SetOutputText(stdoutbuffer, false);
+  if (stderrbuffer.size() > 0)
+    {
+    std::string tmp(" standard error:\n\n");
+    stderrbuffer.insert(0, node0->GetModuleDescription().GetTitle()+tmp);
+    vtkErrorMacro( << stderrbuffer.c_str() );
+    }
+  node0->SetErrorText(stderrbuffer, false);
+
+  if (cancelled || node0->GetStatus() == vtkMRMLCommandLineModuleNode::Cancelling)
+    {
+    node0->SetStatus(vtkMRMLCommandLineModuleNode::Cancelled, false);
+    }
+  else if (!done)
+    {
+    vtkErrorMacro( << node0->GetModuleDescription().GetTitle()
+                   << " worker process terminated unexpectedly" );
+    node0->SetStatus(vtkMRMLCommandLineModuleNode::CompletedWithErrors, false);
+    }
+  else if (returnValue != 0)
+    {
+    vtkErrorMacro( << node0->GetModuleDescription().GetTitle()
+                   << " completed with errors" );
+    node0->SetStatus(vtkMRMLCommandLineModuleNode::CompletedWithErrors, false);
+    }
+  else
+    {
+    qDebug() << node0->GetModuleDescription().GetTitle().c_str()
+             << "completed without errors";
+    }
+  this->GetApplicationLogic()->RequestModified( node0 );
+  return true;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSlicerCLIModuleLogic::GetDataExchangeDirectory()
+{
+  // the jobs of a remote launcher can't read the local files
+  if (!this->Internal->RemoteLauncher.empty() &&
+      !this->Internal->RemoteDataExchangeDirectory.empty())
+    {
+    return this->Internal->RemoteDataExchangeDirectory;
+    }
+#ifndef _WIN32
+  // POSIX shared memory objects live in a memory backed file system
+  const char* sharedMemoryDirectory = "/dev/shm";
+  if (this->Internal->SharedMemoryDataExchange
+      && vtksys::SystemTools::FileIsDirectory(sharedMemoryDirectory)
+      && access(sharedMemoryDirectory, W_OK) == 0)
+    {
+    return sharedMemoryDirectory;
+    }
+#endif
+  // by default use the current directory
+  std::string temporaryDirectory = ".";
+  vtkSlicerApplicationLogic* appLogic = this->GetApplicationLogic();
+  if (appLogic)
+    {
+    temporaryDirectory = appLogic->GetTemporaryPath();
+    }
+  return temporaryDirectory;
+}
+
 //----------------------------------------------------------------------------
 std::string
 vtkSlicerCLIModuleLogic
@@ -575,13 +1283,7 @@ vtkSlicerCLIModuleLogic
 
   // By default, the filename is based on the temporary directory and
   // the pid
-  // by default use the current directory
-  std::string temporaryDirectory = ".";
-  vtkSlicerApplicationLogic* appLogic = this->GetApplicationLogic();
-  if (appLogic)
-    {
-    temporaryDirectory = appLogic->GetTemporaryPath();
-    }
+  std::string temporaryDirectory = this->GetDataExchangeDirectory();
   fname = temporaryDirectory + "/" + pid + "_" + fname + ".mrml";
 
   return fname;
@@ -650,12 +1352,7 @@ vtkSlicerCLIModuleLogic
 
   // By default, the filename is based on the temporary directory and
   // the pid
-  std::string temporaryDirectory = ".";
-  vtkSlicerApplicationLogic* appLogic = this->GetApplicationLogic();
-  if (appLogic)
-    {
-    temporaryDirectory = appLogic->GetTemporaryPath();
-    }
+  std::string temporaryDirectory = this->GetDataExchangeDirectory();
   fname = temporaryDirectory + "/" + pid + "_" + fname;
 
   if (tag == "image")
@@ -807,6 +1504,9 @@ void vtkSlicerCLIModuleLogic::Apply ( vtkMRMLCommandLineModuleNode* node, bool u
 
   vtkNew<vtkSlicerTask> task;
   task->SetTypeToProcessing();
+  task->SetPriority(node->GetPriority());
+  task->SetNumberOfThreads(node->GetRequiredNumberOfThreads());
+  task->SetMemorySize(node->GetRequiredMemorySize());
 
   // Pass the current node as client data to the task.  This allows
   // the user to switch to another parameter set after the task is
@@ -837,6 +1537,59 @@ void vtkSlicerCLIModuleLogic::Apply ( vtkMRMLCommandLineModuleNode* node, bool u
     }
 }
 
+//-----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::ApplyBatch(vtkMRMLCommandLineModuleNode* node,
+                                         const char* inputParameterName,
+                                         vtkStringArray* inputNodeIDs,
+                                         const char* outputParameterName,
+                                         vtkStringArray* outputNodeIDs,
+                                         vtkCollection* batchNodes,
+                                         bool updateDisplay)
+{
+  if (!node || !inputParameterName || !outputParameterName ||
+      !inputNodeIDs || !outputNodeIDs || !this->GetMRMLScene())
+    {
+    vtkErrorMacro(<< "ApplyBatch: invalid node, parameters or scene");
+    return false;
+    }
+  const ModuleDescription& description = node->GetModuleDescription();
+  if (!description.HasParameter(inputParameterName) ||
+      !description.HasParameter(outputParameterName))
+    {
+    vtkErrorMacro(<< "ApplyBatch: module " << description.GetTitle()
+                  << " has no parameter " << inputParameterName
+                  << " or " << outputParameterName);
+    return false;
+    }
+  if (inputNodeIDs->GetNumberOfValues() != outputNodeIDs->GetNumberOfValues())
+    {
+    vtkErrorMacro(<< "ApplyBatch: " << inputNodeIDs->GetNumberOfValues()
+                  << " inputs but " << outputNodeIDs->GetNumberOfValues()
+                  << " outputs");
+    return false;
+    }
+
+  for (vtkIdType i = 0; i < inputNodeIDs->GetNumberOfValues(); ++i)
+    {
+    vtkMRMLCommandLineModuleNode* batchNode = this->CreateNode();
+    batchNode->Copy(node);
+    batchNode->SetStatus(vtkMRMLCommandLineModuleNode::Idle, false);
+    batchNode->SetPriority(node->GetPriority());
+    batchNode->SetRequiredNumberOfThreads(node->GetRequiredNumberOfThreads());
+    batchNode->SetRequiredMemorySize(node->GetRequiredMemorySize());
+    batchNode->SetParameterAsString(inputParameterName, inputNodeIDs->GetValue(i));
+    batchNode->SetParameterAsString(outputParameterName, outputNodeIDs->GetValue(i));
+    this->GetMRMLScene()->AddNode(batchNode);
+    batchNode->Delete();
+    if (batchNodes)
+      {
+      batchNodes->AddItem(batchNode);
+      }
+    this->Apply(batchNode, updateDisplay);
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerCLIModuleLogic
 ::SetMRMLApplicationLogic(vtkMRMLApplicationLogic* logic)
@@ -1022,6 +1775,10 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
   // vector of files to delete
   std::set<std::string> filesToDelete;
 
+  // models written by a shared object module directly in memory. They are
+  // set to their node once the module completes.
+  std::map<std::string, vtkSmartPointer<vtkPolyData> > inMemoryModelOutputs;
+
   // iterators for parameter groups
   std::vector<ModuleParameterGroup>::iterator pgbeginit
     = node0->GetModuleDescription().GetParameterGroups().begin();
@@ -1071,7 +1828,35 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
                                              (*pit).GetFileExtensions(),
                                              commandType);
 
-        filesToDelete.insert(fname);
+        // Models of a shared object module may be communicated in memory
+        // using the same encoding as vtkPluginPolyDataIO.
+        vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(
+          this->GetMRMLScene()->GetNodeByID(id.c_str()));
+        if (commandType == SharedObjectModule
+            && this->Internal->InMemoryModelTransfer
+            && (*pit).GetTag() == "geometry"
+            && (*pit).GetMultiple() != "true"
+            && modelNode
+            && modelNode->GetMeshType() == vtkMRMLModelNode::PolyDataMeshType)
+          {
+          vtkPolyData* polyData = modelNode->GetPolyData();
+          if ((*pit).GetChannel() == "output")
+            {
+            polyData = vtkPolyData::New();
+            inMemoryModelOutputs[id].TakeReference(polyData);
+            }
+          if (polyData)
+            {
+            char reference[64];
+            sprintf(reference, "slicer:polydata:%p", static_cast<void*>(polyData));
+            fname = reference;
+            }
+          }
+
+        if (fname.compare(0, 16, "slicer:polydata:") != 0)
+          {
+          filesToDelete.insert(fname);
+          }
         if ((*pit).GetChannel() == "input")
           {
           nodesToWrite[id] = fname;
@@ -1096,13 +1881,7 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     }
 
   // Define a temporary directory for storing files
-  // by default use the current directory for storing files
-  std::string temporaryDirectory = ".";
-  vtkSlicerApplicationLogic* appLogic = this->GetApplicationLogic();
-  if (appLogic)
-    {
-    temporaryDirectory = appLogic->GetTemporaryPath();
-    }
+  std::string temporaryDirectory = this->GetDataExchangeDirectory();
 
   // write out the input datasets
   //
@@ -1147,6 +1926,11 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       // No need to write anything out with Python
       continue;
       }
+    if ((*id2fn0).second.compare(0, 16, "slicer:polydata:") == 0)
+      {
+      // Model is read by the module directly from memory
+      continue;
+      }
     if ((commandType == CommandLineModule) && defaultOut)
       {
       // Default case for CommandLineModule is to use a storage node
@@ -1898,6 +2682,12 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       }
     }
 
+  // the launcher runs the executable module on another host
+  if (commandType == CommandLineModule && !this->Internal->RemoteLauncher.empty())
+    {
+    commandLineAsString.insert(commandLineAsString.begin(), this->Internal->RemoteLauncher);
+    }
+
   // copy the command line arguments into an array of pointers to
   // chars
   char **command = new char*[commandLineAsString.size()+1];
@@ -1928,7 +2718,31 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
   node0->SetErrorText("", false);
   node0->SetStatus(vtkMRMLCommandLineModuleNode::Running, false);
   this->GetApplicationLogic()->RequestModified( node0 );
+  // Output files that can be loaded while the module runs
+  MRMLIDMap intermediateOutputFiles;
+  if (commandType == CommandLineModule)
+    {
+    for (MRMLIDToFileNameMap::const_iterator it = nodesToReload.begin();
+         it != nodesToReload.end(); ++it)
+      {
+      if (sceneToMiniSceneMap.find(it->first) == sceneToMiniSceneMap.end())
+        {
+        intermediateOutputFiles[it->second] = it->first;
+        }
+      }
+    }
+  std::string workerLibrary;
   if (commandType == CommandLineModule)
+    {
+    workerLibrary = this->FindWorkerLibrary(node0->GetModuleDescription());
+    }
+  if (!workerLibrary.empty() &&
+      this->RunInWorkerProcess(node0, workerLibrary, commandLineAsString,
+                               intermediateOutputFiles))
+    {
+    // Run in a resident worker process
+    }
+  else if (commandType == CommandLineModule)
     {
     // Run as a command line module
     //
@@ -1986,8 +2800,8 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     double timeout = timeoutlimit;
     std::string stdoutbuffer;
     std::string stderrbuffer;
-    std::string::size_type tagend;
-    std::string::size_type tagstart;
+    std::string::size_type intermediateOutputPosition = 0;
+    double lastIntermediateOutputTime = 0.;
     while ((pipe = itksysProcess_WaitForData(process ,&tbuffer,
                                              &length, &timeout)) != 0)
       {
@@ -2019,65 +2833,15 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
           //std::cout << "STDOUT: " << std::string(tbuffer, length) << std::endl;
           stdoutbuffer = stdoutbuffer.append(tbuffer, length);
 
-          bool foundTag = false;
-          // search for the last occurence of </filter-progress>
-          tagend = stdoutbuffer.rfind("</filter-progress>");
-          if (tagend != std::string::npos)
-            {
-            tagstart = stdoutbuffer.rfind("<filter-progress>");
-            if (tagstart != std::string::npos)
-              {
-              std::string progressString(stdoutbuffer, tagstart+17,
-                                         tagend-tagstart-17);
-              node0->GetModuleDescription().GetProcessInformation()->Progress = atof(progressString.c_str());
-              foundTag = true;
-              }
-            }
-          // search for the last occurence of </filter-stage-progress>
-          tagend = stdoutbuffer.rfind("</filter-stage-progress>");
-          if (tagend != std::string::npos)
-            {
-            tagstart = stdoutbuffer.rfind("<filter-stage-progress>");
-            if (tagstart != std::string::npos)
-              {
-              std::string progressString(stdoutbuffer, tagstart+23,
-                                         tagend-tagstart-23);
-              node0->GetModuleDescription().GetProcessInformation()->StageProgress = atof(progressString.c_str());
-              foundTag = true;
-              }
-            }
-
-          // search for the last occurence of </filter-name>
-          tagend = stdoutbuffer.rfind("</filter-name>");
-          if (tagend != std::string::npos)
-            {
-            tagstart = stdoutbuffer.rfind("<filter-name>");
-            if (tagstart != std::string::npos)
-              {
-              std::string filterString(stdoutbuffer, tagstart+13,
-                                       tagend-tagstart-13);
-              strncpy(node0->GetModuleDescription().GetProcessInformation()->ProgressMessage, filterString.c_str(), 1023);
-              foundTag = true;
-              }
-            }
-
-          // search for the last occurence of </filter-comment>
-          tagend = stdoutbuffer.rfind("</filter-comment>");
-          if (tagend != std::string::npos)
-            {
-            tagstart = stdoutbuffer.rfind("<filter-comment>");
-            if (tagstart != std::string::npos)
-              {
-              std::string progressMessage(stdoutbuffer, tagstart+16,
-                                         tagend-tagstart-16);
-              strncpy (node0->GetModuleDescription().GetProcessInformation()->ProgressMessage, progressMessage.c_str(), 1023);
-              foundTag = true;
-              }
-            }
-          if (foundTag)
+          if (UpdateProcessInformationFromOutput(
+                node0->GetModuleDescription().GetProcessInformation(), stdoutbuffer))
             {
             this->GetApplicationLogic()->RequestModified( node0 );
             }
+          this->RequestIntermediateOutput(node0, stdoutbuffer,
+                                          intermediateOutputPosition,
+                                          intermediateOutputFiles,
+                                          lastIntermediateOutputTime);
           }
         else if (pipe == itksysProcess_Pipe_STDERR)
           {
@@ -2089,61 +2853,7 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     itksysProcess_WaitForExit(process, 0);
     this->Internal->ProcessesKillLock->Unlock();
 
-    // remove the embedded XML from the stdout stream
-    //
-    // Note that itksys::RegularExpression gives begin()/end() as
-    // size_types not iterators. So we need to use the version of
-    // erase that takes a position and length to erase.
-    //
-    itksys::RegularExpression filterProgressRegExp("<filter-progress>[^<]*</filter-progress>[ \t\n\r]*");
-    while (filterProgressRegExp.find(stdoutbuffer))
-      {
-      stdoutbuffer.erase(filterProgressRegExp.start(),
-                         filterProgressRegExp.end()
-                         - filterProgressRegExp.start());
-      }
-    itksys::RegularExpression filterStageProgressRegExp("<filter-stage-progress>[^<]*</filter-stage-progress>[ \t\n\r]*");
-    while (filterStageProgressRegExp.find(stdoutbuffer))
-      {
-      stdoutbuffer.erase(filterStageProgressRegExp.start(),
-                         filterStageProgressRegExp.end()
-                         - filterStageProgressRegExp.start());
-      }
-    itksys::RegularExpression filterNameRegExp("<filter-name>[^<]*</filter-name>[ \t\n\r]*");
-    while (filterNameRegExp.find(stdoutbuffer))
-      {
-      stdoutbuffer.erase(filterNameRegExp.start(),
-                         filterNameRegExp.end()
-                         - filterNameRegExp.start());
-      }
-    itksys::RegularExpression filterCommentRegExp("<filter-comment>[^<]*</filter-comment>[ \t\n\r]*");
-    while (filterCommentRegExp.find(stdoutbuffer))
-      {
-      stdoutbuffer.erase(filterCommentRegExp.start(),
-                         filterCommentRegExp.end()
-                         - filterCommentRegExp.start());
-      }
-    itksys::RegularExpression filterTimeRegExp("<filter-time>[^<]*</filter-time>[ \t\n\r]*");
-    while (filterTimeRegExp.find(stdoutbuffer))
-      {
-      stdoutbuffer.erase(filterTimeRegExp.start(),
-                         filterTimeRegExp.end()
-                         - filterTimeRegExp.start());
-      }
-    itksys::RegularExpression filterStartRegExp("<filter-start>[^<]*</filter-start>[ \t\n\r]*");
-    while (filterStartRegExp.find(stdoutbuffer))
-      {
-      stdoutbuffer.erase(filterStartRegExp.start(),
-                         filterStartRegExp.end()
-                         - filterStartRegExp.start());
-      }
-    itksys::RegularExpression filterEndRegExp("<filter-end>[^<]*</filter-end>[ \t\n\r]*");
-    while (filterEndRegExp.find(stdoutbuffer))
-      {
-      stdoutbuffer.erase(filterEndRegExp.start(),
-                         filterEndRegExp.end()
-                         - filterEndRegExp.start());
-      }
+    RemoveProcessInformationTags(stdoutbuffer);
 
     if (stdoutbuffer.size() > 0)
       {
@@ -2451,6 +3161,22 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
   node0->GetModuleDescription().GetProcessInformation()->StageProgress = 0;
   this->GetApplicationLogic()->RequestModified( node0 );
 
+  // Set the models written in memory to their nodes while the node
+  // events are still rescheduled to the main thread.
+  if (node0->GetStatus() == vtkMRMLCommandLineModuleNode::Completing)
+    {
+    std::map<std::string, vtkSmartPointer<vtkPolyData> >::iterator mit;
+    for (mit = inMemoryModelOutputs.begin(); mit != inMemoryModelOutputs.end(); ++mit)
+      {
+      vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(
+        this->GetMRMLScene()->GetNodeByID(mit->first));
+      if (modelNode)
+        {
+        modelNode->SetAndObservePolyData(mit->second);
+        }
+      }
+    }
+
   // Stop rescheduling the output nodes events.
   if (commandType == SharedObjectModule)
     {
@@ -2469,6 +3195,14 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       // Is this node one that was put in the miniscene? Nodes in the
       // miniscene will be handled later
       //
+      if (inMemoryModelOutputs.find((*id2fn0).first) != inMemoryModelOutputs.end())
+        {
+        // Model has already been set from memory, nothing to load
+        vtkMRMLNode* node = this->GetMRMLScene()->GetNodeByID((*id2fn0).first);
+        this->Internal->StopRescheduleNodeEvents(node);
+        continue;
+        }
+
       MRMLIDMap::iterator mit = sceneToMiniSceneMap.find((*id2fn0).first);
       if (mit == sceneToMiniSceneMap.end())
         {
@@ -24,6 +24,8 @@ class ModuleParameter;
 // MRML include
 #include "vtkMRMLScene.h"
 class vtkMRMLModelHierarchyNode;
+class vtkCollection;
+class vtkStringArray;
 class MRMLIDMap;
 
 // STL includes
@@ -82,6 +84,80 @@ public:
   void SetRedirectModuleStreams(int value);
   int GetRedirectModuleStreams() const;
 
+  /// Communicate models to and from shared object modules in memory instead
+  /// of through temporary files. The model parameters are then passed as
+  /// "slicer:polydata:<address>" references that the module must read and
+  /// write with vtkPluginPolyDataIO (see Base/CLI).
+  /// Off by default as modules reading models with the VTK readers directly
+  /// would fail.
+  void SetInMemoryModelTransfer(bool enable);
+  bool GetInMemoryModelTransfer() const;
+
+  /// Write the files exchanged with the modules (inputs, outputs and
+  /// miniscenes) in shared memory instead of the application temporary
+  /// directory. On Linux, the POSIX shared memory file system (/dev/shm)
+  /// is used so that command line executables read their inputs with their
+  /// regular readers without any disk I/O. When no shared memory file system
+  /// is available, the application temporary directory is used.
+  /// Off by default as large datasets consume physical memory while the
+  /// module runs.
+  void SetSharedMemoryDataExchange(bool enable);
+  bool GetSharedMemoryDataExchange() const;
+
+  /// Run the executable modules in resident worker processes.
+  /// When enabled and the shared library of an executable module is found
+  /// next to the executable, the library is run by a worker process
+  /// (see SetWorkerExecutable()) that stays alive between the executions.
+  /// This saves the startup of the executable (loading libraries, registering
+  /// the IO factories...) that can exceed the processing time of fast filters.
+  /// The module still runs outside of the application: a crash or a
+  /// cancellation terminates the worker, a new one is started for the next
+  /// execution. Off by default.
+  void SetUseWorkerProcesses(bool enable);
+  bool GetUseWorkerProcesses() const;
+
+  /// Path of the SlicerCLIWorker executable used to run modules in worker
+  /// processes.
+  /// \sa SetUseWorkerProcesses()
+  void SetWorkerExecutable(const std::string& path);
+  std::string GetWorkerExecutable() const;
+
+  /// Run the executable modules through a launcher, e.g. to execute them on
+  /// a compute cluster. The launcher is an executable that receives the
+  /// command line of the module as arguments (for example "srun" or a site
+  /// script submitting the job with ssh or to a job queue). It must wait for
+  /// the job to complete and forward its standard output, so that progress
+  /// and return values are reported as for a local execution, and its exit
+  /// code. Cancelling the module terminates the launcher, which must then
+  /// cancel the job.
+  /// Shared object and Python modules run in the application and ignore the
+  /// launcher, worker processes are not used with a launcher.
+  /// Empty by default.
+  /// \sa SetRemoteDataExchangeDirectory()
+  void SetRemoteLauncher(const std::string& path);
+  std::string GetRemoteLauncher() const;
+
+  /// Directory where the files exchanged with the modules are written when a
+  /// remote launcher is set. It must be shared with the hosts executing the
+  /// jobs (e.g. a network file system mounted at the same path). If empty,
+  /// the regular data exchange directory is used.
+  /// \sa SetRemoteLauncher(), SetSharedMemoryDataExchange()
+  void SetRemoteDataExchangeDirectory(const std::string& path);
+  std::string GetRemoteDataExchangeDirectory() const;
+
+  /// Minimum time in seconds between two loads of the intermediate outputs
+  /// of a running executable module.
+  /// A module reports an intermediate output by writing it to the file of an
+  /// output parameter and then printing on its standard output:
+  /// \code
+  /// <filter-intermediate-output>outputFile</filter-intermediate-output>
+  /// \endcode
+  /// The file is then loaded into the output node without waiting for the
+  /// module to complete. Reports received within the interval are skipped,
+  /// a negative value ignores all of them. 1 second by default.
+  void SetIntermediateOutputInterval(double seconds);
+  double GetIntermediateOutputInterval() const;
+
   /// Schedules the command line module to run.
   /// The CLI is scheduled to be run in a separate thread. This methods
   /// is non blocking and returns immediately.
@@ -98,6 +174,25 @@ public:
   /// in the node selectors.
   void ApplyAndWait ( vtkMRMLCommandLineModuleNode* node, bool updateDisplay = true);
 
+  /// Schedules the command line module to run once for each input node.
+  /// For each i, a copy of \a node is added to the scene with the
+  /// \a inputParameterName parameter set to the i-th ID of \a inputNodeIDs
+  /// and the \a outputParameterName parameter set to the i-th ID of
+  /// \a outputNodeIDs, then scheduled with Apply(). The runs share the
+  /// remaining parameters of \a node and are processed concurrently when the
+  /// application logic has more than one processing thread, shared object
+  /// modules then run in parallel within the application.
+  /// The created nodes are added to \a batchNodes if not null, it is the
+  /// responsibility of the caller to remove them from the scene once
+  /// completed.
+  /// Returns false if a parameter is not found or if the number of input and
+  /// output node IDs differ.
+  /// \sa Apply(), vtkSlicerApplicationLogic::SetNumberOfProcessingThreads()
+  bool ApplyBatch(vtkMRMLCommandLineModuleNode* node,
+                  const char* inputParameterName, vtkStringArray* inputNodeIDs,
+                  const char* outputParameterName, vtkStringArray* outputNodeIDs,
+                  vtkCollection* batchNodes = 0, bool updateDisplay = false);
+
   void KillProcesses();
 
 //   void LazyEvaluateModuleTarget(ModuleDescription& moduleDescriptionObject);
@@ -125,12 +220,39 @@ protected:
                                      const std::vector<std::string>& extensions,
                                      CommandLineModuleType commandType);
   std::string ConstructTemporarySceneFileName(vtkMRMLScene *scene);
+  /// Return the directory where files exchanged with the modules are written.
+  /// \sa SetSharedMemoryDataExchange()
+  std::string GetDataExchangeDirectory();
   std::string FindHiddenNodeID(const ModuleDescription& d,
                                const ModuleParameter& p);
 
   // The method that runs the command line module
   void ApplyTask(void *clientdata);
 
+  /// Return the shared library of an executable module if it can be run in a
+  /// worker process, an empty string otherwise.
+  /// \sa SetUseWorkerProcesses()
+  std::string FindWorkerLibrary(const ModuleDescription& d);
+
+  /// Run the module library in a worker process.
+  /// Returns false if no worker process could be started, the module should
+  /// then be run as a regular executable.
+  bool RunInWorkerProcess(vtkMRMLCommandLineModuleNode* node,
+                          const std::string& library,
+                          const std::vector<std::string>& commandLine,
+                          const MRMLIDMap& intermediateOutputFiles);
+
+  /// Load the last intermediate output reported by a running module in
+  /// \a output after \a position, at most once per
+  /// GetIntermediateOutputInterval().
+  /// \a intermediateOutputFiles maps the output files to the output node IDs.
+  /// \sa SetIntermediateOutputInterval()
+  void RequestIntermediateOutput(vtkMRMLCommandLineModuleNode* node,
+                                 const std::string& output,
+                                 std::string::size_type& position,
+                                 const MRMLIDMap& intermediateOutputFiles,
+                                 double& lastRequestTime);
+
   // Communicate progress back to the node
   static void ProgressCallback(void *);
 
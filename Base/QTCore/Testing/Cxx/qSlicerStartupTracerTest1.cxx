@@ -0,0 +1,99 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// QT includes
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+
+// SlicerQt includes
+#include <qSlicerStartupTracer.h>
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+
+//-----------------------------------------------------------------------------
+int qSlicerStartupTracerTest1(int, char * [] )
+{
+  // Disabled by default: spans are ignored
+  if (qSlicerStartupTracer::isEnabled())
+    {
+    std::cerr << "Line " << __LINE__ << " - Tracer should be disabled by default" << std::endl;
+    return EXIT_FAILURE;
+    }
+  qSlicerStartupTracer::beginSpan("Ignored");
+  qSlicerStartupTracer::endSpan();
+  if (qSlicerStartupTracer::numberOfSpans() != 0)
+    {
+    std::cerr << "Line " << __LINE__ << " - Spans recorded while disabled" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  qSlicerStartupTracer::setEnabled(true);
+  {
+  qSlicerStartupTracerScope parent("Parent");
+    {
+    qSlicerStartupTracerScope child("Child \"quoted\"", "module");
+    }
+  }
+  // Unbalanced endSpan() must be harmless
+  qSlicerStartupTracer::endSpan();
+  // Open spans are not recorded
+  qSlicerStartupTracer::beginSpan("Open");
+
+  if (qSlicerStartupTracer::numberOfSpans() != 2)
+    {
+    std::cerr << "Line " << __LINE__ << " - Problem with numberOfSpans()\n"
+              << " expected: 2\n"
+              << " current: " << qSlicerStartupTracer::numberOfSpans() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  QString fileName = QDir::temp().filePath("qSlicerStartupTracerTest1.json");
+  if (!qSlicerStartupTracer::write(fileName))
+    {
+    std::cerr << "Line " << __LINE__ << " - Failed to write " << qPrintable(fileName) << std::endl;
+    return EXIT_FAILURE;
+    }
+  QFile file(fileName);
+  file.open(QIODevice::ReadOnly | QIODevice::Text);
+  QString content = QTextStream(&file).readAll();
+  file.close();
+  QFile::remove(fileName);
+
+  if (!content.startsWith("{\"traceEvents\":[")
+      || !content.contains("\"name\":\"Parent\"")
+      || !content.contains("\"name\":\"Child \\\"quoted\\\"\",\"cat\":\"module\"")
+      || content.contains("\"Open\""))
+    {
+    std::cerr << "Line " << __LINE__ << " - Unexpected trace content:\n"
+              << qPrintable(content) << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Re-enabling clears the recorded spans
+  qSlicerStartupTracer::setEnabled(true);
+  if (qSlicerStartupTracer::numberOfSpans() != 0)
+    {
+    std::cerr << "Line " << __LINE__ << " - Spans should be cleared" << std::endl;
+    return EXIT_FAILURE;
+    }
+  qSlicerStartupTracer::setEnabled(false);
+
+  return EXIT_SUCCESS;
+}
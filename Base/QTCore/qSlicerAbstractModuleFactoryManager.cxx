@@ -20,11 +20,13 @@
 
 // Qt includes
 #include <QDir>
+#include <QElapsedTimer>
 
 // SlicerQt includes
 #include "qSlicerCoreApplication.h"
 #include "qSlicerAbstractModuleFactoryManager.h"
 #include "qSlicerAbstractCoreModule.h"
+#include "qSlicerStartupTracer.h"
 
 // STD includes
 #include <csignal>
@@ -59,6 +61,7 @@ public:
   QMap<qSlicerModuleFactory*, int> Factories;
   QMap<QString, qSlicerModuleFactory*> RegisteredModules;
   QMap<QString, QStringList> ModuleDependees;
+  QMap<QString, int> ModuleInstantiationTimes;
 
   bool Verbose;
 };
@@ -400,12 +403,17 @@ qSlicerAbstractCoreModule* qSlicerAbstractModuleFactoryManager
     qCritical() << "Fail to instantiate module " << moduleName << " (not registered)";
     return 0;
     }
+  QElapsedTimer timer;
+  timer.start();
+  qSlicerStartupTracer::beginSpan(QString("Instantiate %1").arg(moduleName), "module");
   qSlicerAbstractCoreModule* module = factory->instantiate(moduleName);
+  qSlicerStartupTracer::endSpan();
   if (!module)
     {
     qCritical() << "Fail to instantiate module " << moduleName;
     return NULL;
     }
+  d->ModuleInstantiationTimes[moduleName] = static_cast<int>(timer.elapsed());
   module->setName(moduleName);
   module->setObjectName(QString("%1Module").arg(moduleName));
   foreach(const QString& associatedNodeType, module->associatedNodeTypes())
@@ -424,6 +432,13 @@ qSlicerAbstractCoreModule* qSlicerAbstractModuleFactoryManager
   return module;
 }
 
+//-----------------------------------------------------------------------------
+int qSlicerAbstractModuleFactoryManager::moduleInstantiationTime(const QString& moduleName)const
+{
+  Q_D(const qSlicerAbstractModuleFactoryManager);
+  return d->ModuleInstantiationTimes.value(moduleName, -1);
+}
+
 //-----------------------------------------------------------------------------
 QStringList qSlicerAbstractModuleFactoryManager::registeredModuleNames() const
 {
@@ -480,6 +495,7 @@ void qSlicerAbstractModuleFactoryManager::uninstantiateModule(const QString& mod
     }
   emit moduleAboutToBeUninstantiated(moduleName);
   factory->uninstantiate(moduleName);
+  d->ModuleInstantiationTimes.remove(moduleName);
   emit moduleUninstantiated(moduleName);
 }
 
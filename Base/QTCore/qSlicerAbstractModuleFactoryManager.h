@@ -183,6 +183,11 @@ public:
   /// Uninstantiate all instantiated modules
   void uninstantiateModules();
 
+  /// Return the time in msecs spent instantiating the module or -1 if the
+  /// module has not been instantiated.
+  /// \sa qSlicerModuleFactoryManager::moduleLoadTime()
+  Q_INVOKABLE int moduleInstantiationTime(const QString& moduleName)const;
+
   /// Enable/Disable verbose output during module discovery process
   void setVerboseModuleDiscovery(bool value);
 
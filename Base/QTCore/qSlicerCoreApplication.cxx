@@ -72,6 +72,7 @@
 #include "qSlicerLoadableModuleFactory.h"
 #include "qSlicerModuleFactoryManager.h"
 #include "qSlicerModuleManager.h"
+#include "qSlicerStartupTracer.h"
 #include "qSlicerUtils.h"
 
 // SlicerLogic includes
@@ -93,6 +94,7 @@
 #include <vtkMRMLScene.h>
 
 // VTK includes
+#include <vtkGraphicsFactory.h>
 #include <vtkNew.h>
 #include <vtksys/SystemTools.hxx>
 
@@ -205,6 +207,12 @@ void qSlicerCoreApplicationPrivate::init()
 
   this->parseArguments();
 
+  if (!q->coreCommandOptions()->startupTraceFile().isEmpty())
+    {
+    qSlicerStartupTracer::setEnabled(true);
+    }
+
+  qSlicerStartupTracer::beginSpan("Setup environment");
   this->SlicerHome = this->discoverSlicerHomeDirectory();
   this->setEnvironmentVariable("SLICER_HOME", this->SlicerHome);
 
@@ -235,6 +243,7 @@ void qSlicerCoreApplicationPrivate::init()
   this->setEnvironmentVariable("ITK_AUTOLOAD_PATH", this->ITKFactoriesDir);
   this->setPythonEnvironmentVariables();
   this->setTclEnvironmentVariables();
+  qSlicerStartupTracer::endSpan();
 
   // Load default settings if any.
   if (q->defaultSettings())
@@ -249,6 +258,7 @@ void qSlicerCoreApplicationPrivate::init()
     }
 
   // Create the application Logic object,
+  qSlicerStartupTracer::beginSpan("Create application logic");
   this->AppLogic = vtkSmartPointer<vtkSlicerApplicationLogic>::New();
   this->AppLogic->SetTemporaryPath(q->temporaryPath().toLatin1());
   q->qvtkConnect(this->AppLogic, vtkCommand::ModifiedEvent,
@@ -263,6 +273,8 @@ void qSlicerCoreApplicationPrivate::init()
               q, SLOT(onSlicerApplicationLogicRequest(vtkObject*,void*,ulong)));
   q->qvtkConnect(this->AppLogic, vtkSlicerApplicationLogic::RequestWriteDataEvent,
               q, SLOT(onSlicerApplicationLogicRequest(vtkObject*,void*,ulong)));
+  q->qvtkConnect(this->AppLogic, vtkSlicerApplicationLogic::RequestStreamedDataEvent,
+              q, SLOT(processAppLogicStreamedData()));
   vtkMRMLThreeDViewDisplayableManagerFactory::GetInstance()->SetMRMLApplicationLogic(
     this->AppLogic.GetPointer());
   vtkMRMLSliceViewDisplayableManagerFactory::GetInstance()->SetMRMLApplicationLogic(
@@ -275,16 +287,21 @@ void qSlicerCoreApplicationPrivate::init()
   //this->AppLogic->ProcessMRMLEvents(scene, vtkCommand::ModifiedEvent, NULL);
   //this->AppLogic->SetAndObserveMRMLScene(scene);
   this->AppLogic->CreateProcessingThread();
+  qSlicerStartupTracer::endSpan();
 
   // Set up Slicer to use the system proxy
   QNetworkProxyFactory::setUseSystemConfiguration(true);
 
   // Set up Data IO
+  qSlicerStartupTracer::beginSpan("Setup data IO");
   this->initDataIO();
+  qSlicerStartupTracer::endSpan();
 
   // Create MRML scene
+  qSlicerStartupTracer::beginSpan("Create MRML scene");
   vtkNew<vtkMRMLScene> scene;
   q->setMRMLScene(scene.GetPointer());
+  qSlicerStartupTracer::endSpan();
 
   // Instantiate moduleManager
   this->ModuleManager = QSharedPointer<qSlicerModuleManager>(new qSlicerModuleManager);
@@ -300,7 +317,9 @@ void qSlicerCoreApplicationPrivate::init()
     {
     if (q->corePythonManager())
       {
+      qSlicerStartupTracer::beginSpan("Initialize Python");
       q->corePythonManager()->mainContext(); // Initialize python
+      qSlicerStartupTracer::endSpan();
       q->corePythonManager()->setSystemExitExceptionHandlerEnabled(true);
       q->connect(q->corePythonManager(), SIGNAL(systemExitExceptionRaised(int)),
                  q, SLOT(terminate(int)));
@@ -315,6 +334,7 @@ void qSlicerCoreApplicationPrivate::init()
 
 #ifdef Slicer_BUILD_EXTENSIONMANAGER_SUPPORT
 
+  qSlicerStartupTracer::beginSpan("Setup extensions manager");
   qSlicerExtensionsManagerModel * model = new qSlicerExtensionsManagerModel(q);
   model->setExtensionsSettingsFilePath(q->slicerRevisionUserSettingsFilePath());
   model->setSlicerRequirements(q->repositoryRevision(), q->os(), q->arch());
@@ -343,6 +363,7 @@ void qSlicerCoreApplicationPrivate::init()
     {
     qDebug() << "Successfully uninstalled extension" << extensionName;
     }
+  qSlicerStartupTracer::endSpan();
 
 #endif
 
@@ -860,6 +881,12 @@ void qSlicerCoreApplication::handlePreApplicationCommandLineArguments()
     this->setAttribute(AA_EnableTesting);
     }
 
+  if (options->offscreenRendering())
+    {
+    // Must be set before any render window is instantiated
+    vtkGraphicsFactory::SetOffScreenOnlyMode(1);
+    }
+
 #ifdef Slicer_USE_PYTHONQT
   if (options->isPythonDisabled())
     {
@@ -873,6 +900,16 @@ void qSlicerCoreApplication::handleCommandLineArguments()
 {
   qSlicerCoreCommandOptions* options = this->coreCommandOptions();
 
+  // The event loop is started: the application startup is complete.
+  if (!options->startupTraceFile().isEmpty() && qSlicerStartupTracer::isEnabled())
+    {
+    if (!qSlicerStartupTracer::write(options->startupTraceFile()))
+      {
+      qWarning() << "Failed to write startup trace file" << options->startupTraceFile();
+      }
+    qSlicerStartupTracer::setEnabled(false);
+    }
+
   QStringList unparsedArguments = options->unparsedArguments();
   if (unparsedArguments.length() > 0 &&
       options->pythonScript().isEmpty() &&
@@ -1598,6 +1635,13 @@ void qSlicerCoreApplication::processAppLogicWriteData()
   d->AppLogic->ProcessWriteData();
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerCoreApplication::processAppLogicStreamedData()
+{
+  Q_D(qSlicerCoreApplication);
+  d->AppLogic->ProcessStreamedData();
+}
+
 //-----------------------------------------------------------------------------
 void qSlicerCoreApplication::terminate(int returnCode)
 {
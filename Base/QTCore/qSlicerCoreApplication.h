@@ -389,6 +389,7 @@ protected slots:
   void processAppLogicModified();
   void processAppLogicReadData();
   void processAppLogicWriteData();
+  void processAppLogicStreamedData();
 
   /// Set the ReturnCode flag and call QCoreApplication::exit()
   void terminate(int exitCode = qSlicerCoreApplication::ExitSuccess);
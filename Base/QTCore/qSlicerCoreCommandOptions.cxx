@@ -305,6 +305,13 @@ bool qSlicerCoreCommandOptions::verboseModuleDiscovery() const
   return d->ParsedArgs.value("verbose-module-discovery").toBool();
 }
 
+//-----------------------------------------------------------------------------
+QString qSlicerCoreCommandOptions::startupTraceFile() const
+{
+  Q_D(const qSlicerCoreCommandOptions);
+  return d->ParsedArgs.value("startup-trace").toString();
+}
+
 //-----------------------------------------------------------------------------
 bool qSlicerCoreCommandOptions::verbose()const
 {
@@ -329,6 +336,13 @@ bool qSlicerCoreCommandOptions::disableTerminalOutputs()const
 #endif
 }
 
+//-----------------------------------------------------------------------------
+bool qSlicerCoreCommandOptions::offscreenRendering()const
+{
+  Q_D(const qSlicerCoreCommandOptions);
+  return d->ParsedArgs.value("offscreen-rendering").toBool();
+}
+
 //-----------------------------------------------------------------------------
 bool qSlicerCoreCommandOptions::settingsDisabled() const
 {
@@ -454,6 +468,10 @@ void qSlicerCoreCommandOptions::addArguments()
   this->addArgument("verbose-module-discovery", "", QVariant::Bool,
                     "Enable verbose output during module discovery process.");
 
+  this->addArgument("startup-trace", "", QVariant::String,
+                    "Record the duration of the startup phases and write them into the given "
+                    "file using the Chrome trace event format.");
+
   this->addArgument("disable-settings", "", QVariant::Bool,
                     "Start application ignoring user settings and using new temporary settings.");
 
@@ -468,6 +486,10 @@ void qSlicerCoreCommandOptions::addArguments()
   this->addArgument("disable-terminal-outputs", "", QVariant::Bool,
                     "Start application disabling stdout/stderr outputs and capturing outputs only using the error log.");
 #endif
+
+  this->addArgument("offscreen-rendering", "", QVariant::Bool,
+                    "Create render windows offscreen only. Views can then be rendered without a display "
+                    "if VTK is built with OSMesa or EGL support (e.g. with --no-main-window).");
 }
 
 //-----------------------------------------------------------------------------
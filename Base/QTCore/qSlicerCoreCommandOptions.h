@@ -53,7 +53,9 @@ class Q_SLICER_BASE_QTCORE_EXPORT qSlicerCoreCommandOptions : public ctkCommandL
   Q_PROPERTY(bool displayTemporaryPathAndExit READ displayTemporaryPathAndExit CONSTANT)
   Q_PROPERTY(bool displayMessageAndExit READ displayMessageAndExit STORED false CONSTANT)
   Q_PROPERTY(bool verboseModuleDiscovery READ verboseModuleDiscovery CONSTANT)
+  Q_PROPERTY(QString startupTraceFile READ startupTraceFile CONSTANT)
   Q_PROPERTY(bool disableMessageHandlers READ disableMessageHandlers CONSTANT)
+  Q_PROPERTY(bool offscreenRendering READ offscreenRendering CONSTANT)
   Q_PROPERTY(bool testingEnabled READ isTestingEnabled CONSTANT)
 #ifdef Slicer_USE_PYTHONQT
   Q_PROPERTY(bool pythonDisabled READ isPythonDisabled CONSTANT)
@@ -157,6 +159,11 @@ public:
   /// Return True if slicer should display details regarding the module discovery process
   bool verboseModuleDiscovery()const;
 
+  /// Return the file the startup trace should be written into.
+  /// An empty string means startup tracing is disabled.
+  /// \sa qSlicerStartupTracer
+  QString startupTraceFile()const;
+
   /// Return True if slicer should display information at startup
   bool verbose()const;
 
@@ -170,6 +177,14 @@ public:
   /// \sa ctkErrorLogModel::setTerminalOutputs()
   bool disableTerminalOutputs()const;
 
+  /// Return True if the render windows should be created offscreen only.
+  ///
+  /// Combined with \a --no-main-window and \a --python-script, snapshots of
+  /// the views can be generated using vtkMRMLViewSnapshotRenderer without a
+  /// display when VTK is built with OSMesa or EGL support.
+  /// \sa vtkGraphicsFactory::SetOffScreenOnlyMode()
+  bool offscreenRendering()const;
+
   /// Return a value indicating if slicer settings should be disabled.
   ///
   /// When disabled, temporary settings file are created.
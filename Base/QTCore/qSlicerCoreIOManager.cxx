@@ -21,6 +21,7 @@
 // Qt includes
 #include <QDebug>
 #include <QFileInfo>
+#include <QTimer>
 
 // CTK includes
 #include <ctkUtils.h>
@@ -60,11 +61,15 @@ public:
   QList<qSlicerFileReader*> Readers;
   QList<qSlicerFileWriter*> Writers;
   QMap<qSlicerIO::IOFileType, QStringList> FileTypes;
+
+  bool AsynchronousSceneLoading;
+  QTimer DeferredReadDataTimer;
 };
 
 //-----------------------------------------------------------------------------
 qSlicerCoreIOManagerPrivate::qSlicerCoreIOManagerPrivate()
 {
+  this->AsynchronousSceneLoading = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -189,6 +194,10 @@ qSlicerCoreIOManager::qSlicerCoreIOManager(QObject* _parent)
   :QObject(_parent)
   , d_ptr(new qSlicerCoreIOManagerPrivate)
 {
+  Q_D(qSlicerCoreIOManager);
+  d->DeferredReadDataTimer.setInterval(0);
+  connect(&d->DeferredReadDataTimer, SIGNAL(timeout()),
+          this, SLOT(readNextDeferredData()));
 }
 
 //-----------------------------------------------------------------------------
@@ -479,6 +488,17 @@ bool qSlicerCoreIOManager::loadNodes(const qSlicerIO::IOFileType& fileType,
   // If no readers were able to read and load the file(s), success will remain false
   bool success = false;
 
+  // Only the nodes are created while the scene is loaded, the data is
+  // read by readNextDeferredData() once the reader returns.
+  vtkMRMLScene* scene = d->currentScene();
+  bool deferReadData = d->AsynchronousSceneLoading && scene &&
+    fileType == QString("SceneFile");
+  int wasDeferringReadData = scene ? scene->GetDeferReadDataOnLoad() : 0;
+  if (deferReadData)
+    {
+    scene->SetDeferReadDataOnLoad(1);
+    }
+
   QStringList nodes;
   foreach (qSlicerFileReader* reader, readers)
     {
@@ -503,6 +523,15 @@ bool qSlicerCoreIOManager::loadNodes(const qSlicerIO::IOFileType& fileType,
     break;
     }
 
+  if (deferReadData)
+    {
+    scene->SetDeferReadDataOnLoad(wasDeferringReadData);
+    if (scene->GetNumberOfDeferredReadDataNodes() > 0)
+      {
+      d->DeferredReadDataTimer.start();
+      }
+    }
+
   loadedFileParameters.insert("nodeIDs", nodes);
 
   emit newFileLoaded(loadedFileParameters);
@@ -551,6 +580,34 @@ vtkMRMLNode* qSlicerCoreIOManager::loadNodesAndGetFirst(
   return node;
 }
 
+//-----------------------------------------------------------------------------
+bool qSlicerCoreIOManager::asynchronousSceneLoading()const
+{
+  Q_D(const qSlicerCoreIOManager);
+  return d->AsynchronousSceneLoading;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCoreIOManager::setAsynchronousSceneLoading(bool asynchronous)
+{
+  Q_D(qSlicerCoreIOManager);
+  d->AsynchronousSceneLoading = asynchronous;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCoreIOManager::readNextDeferredData()
+{
+  Q_D(qSlicerCoreIOManager);
+  vtkMRMLScene* scene = d->currentScene();
+  // One node per timeout so that the views are rendered and the user
+  // events are processed between two reads.
+  if (!scene || scene->ReadNextDeferredData() == 0)
+    {
+    d->DeferredReadDataTimer.stop();
+    emit deferredDataLoaded();
+    }
+}
+
 //-----------------------------------------------------------------------------
 vtkMRMLStorageNode* qSlicerCoreIOManager::createAndAddDefaultStorageNode(
     vtkMRMLStorableNode* node)
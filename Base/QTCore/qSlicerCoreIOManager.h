@@ -46,6 +46,13 @@ class qSlicerFileWriter;
 class Q_SLICER_BASE_QTCORE_EXPORT qSlicerCoreIOManager:public QObject
 {
   Q_OBJECT;
+  /// If true, loading a scene file only creates the nodes and the data of
+  /// volumes and models is read afterward, one node per event loop
+  /// iteration. The views are displayed and the application remains
+  /// responsive while the data is read.
+  /// False by default.
+  /// \sa vtkMRMLScene::SetDeferReadDataOnLoad(), deferredDataLoaded()
+  Q_PROPERTY(bool asynchronousSceneLoading READ asynchronousSceneLoading WRITE setAsynchronousSceneLoading)
 public:
   qSlicerCoreIOManager(QObject* parent = 0);
   virtual ~qSlicerCoreIOManager();
@@ -149,6 +156,9 @@ public:
   /// Note also that the IOManager takes ownership of \a io
   void registerIO(qSlicerIO* io);
 
+  bool asynchronousSceneLoading()const;
+  void setAsynchronousSceneLoading(bool asynchronous);
+
   /// Create and add default storage node
   Q_INVOKABLE static vtkMRMLStorageNode* createAndAddDefaultStorageNode(vtkMRMLStorableNode* node);
 
@@ -166,6 +176,15 @@ signals:
   /// \sa loadNodes(const qSlicerIO::IOFileType&, const qSlicerIO::IOProperties&, vtkCollection*)
   void newFileLoaded(const qSlicerIO::IOProperties& loadedFileParameters);
 
+  /// This signal is emitted when the data deferred while loading a scene
+  /// asynchronously has been read.
+  /// \sa asynchronousSceneLoading
+  void deferredDataLoaded();
+
+protected slots:
+  /// Read the data of the next node deferred by the scene.
+  void readNextDeferredData();
+
 protected:
 
   /// Returns the list of registered readers
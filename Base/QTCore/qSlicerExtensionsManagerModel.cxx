@@ -25,6 +25,7 @@
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
+#include <QSet>
 #include <QSettings>
 #include <QStandardItemModel>
 #include <QTemporaryFile>
@@ -222,6 +223,11 @@ public:
   qMidasAPI CheckForUpdatesApi;
   QHash<QUuid, UpdateCheckInformation> CheckForUpdatesRequests;
 
+  /// Metadata retrieved from the server, indexed by server URL and extension
+  /// id. An extension id identifies an uploaded package, its metadata does not
+  /// change on the server.
+  QHash<QString, ExtensionMetadataType> RetrievedExtensionMetadata;
+
   QHash<QString, UpdateDownloadInformation> AvailableUpdates;
 
   QString ExtensionsSettingsFilePath;
@@ -826,6 +832,18 @@ qSlicerExtensionsManagerModel::ExtensionMetadataType qSlicerExtensionsManagerMod
 {
   Q_Q(const qSlicerExtensionsManagerModel);
 
+  // Queries of a given package are answered from the cache, queries of the
+  // latest package of an extension are always sent to the server.
+  QString cacheKey;
+  if (parameters.count() == 1 && parameters.contains("extension_id"))
+    {
+    cacheKey = q->serverUrl().toString() + "|" + parameters.value("extension_id");
+    if (this->RetrievedExtensionMetadata.contains(cacheKey))
+      {
+      return this->RetrievedExtensionMetadata.value(cacheKey);
+      }
+    }
+
   bool ok = false;
   QList<QVariantMap> results = qMidasAPI::synchronousQuery(
         ok, q->serverUrl().toString(),
@@ -849,6 +867,11 @@ qSlicerExtensionsManagerModel::ExtensionMetadataType qSlicerExtensionsManagerMod
       q->serverToExtensionDescriptionKey().value(key, key), result.value(key));
     }
 
+  if (!cacheKey.isEmpty())
+    {
+    this->RetrievedExtensionMetadata.insert(cacheKey, updatedExtensionMetadata);
+    }
+
   return updatedExtensionMetadata;
 }
 
@@ -961,15 +984,17 @@ qSlicerExtensionsManagerModel::ExtensionMetadataType qSlicerExtensionsManagerMod
     }
   int row = item->row();
 
-  foreach(const QString& columnName, d->columnNames())
+  const QStringList columnNames = d->columnNames();
+  for (int columnIdx = 0; columnIdx < columnNames.count(); ++columnIdx)
     {
+    const QString& columnName = columnNames.at(columnIdx);
     // TODO Server should provide us with depends. In the mean time, let's not export it.
     if (columnName == "depends")
       {
       continue;
       }
     metadata.insert(columnName, d->Model.data(
-          d->Model.index(row, d->columnNames().indexOf(columnName)), Qt::DisplayRole).toString());
+          d->Model.index(row, columnIdx), Qt::DisplayRole).toString());
     }
 
   return metadata;
@@ -1447,9 +1472,20 @@ void qSlicerExtensionsManagerModel::checkForUpdates(bool installUpdates)
 
   d->CheckForUpdatesApi.setServerUrl(this->serverUrl().toString());
 
+  // Extensions whose update check is still running are not queried again
+  QSet<QString> pendingExtensions;
+  foreach (const UpdateCheckInformation& pendingInfo, d->CheckForUpdatesRequests)
+    {
+    pendingExtensions.insert(pendingInfo.ExtensionName);
+    }
+
   // Loop over extensions
   foreach (const QString& extensionName, this->installedExtensions())
     {
+    if (pendingExtensions.contains(extensionName))
+      {
+      continue;
+      }
     const ExtensionMetadataType& extensionMetadata =
       this->extensionMetadata(extensionName);
     const QString& extensionId =
@@ -21,9 +21,14 @@
 // SlicerQt includes
 #include "qSlicerModuleFactoryManager.h"
 #include "qSlicerAbstractCoreModule.h"
+#include "qSlicerStartupTracer.h"
 
 #include "vtkSlicerConfigure.h" // XXX For modulePaths() function.
 
+// Qt includes
+#include <QDebug>
+#include <QElapsedTimer>
+
 // STD includes
 #include <algorithm>
 
@@ -37,6 +42,7 @@ public:
   qSlicerModuleFactoryManagerPrivate(qSlicerModuleFactoryManager& object);
 
   QStringList LoadedModules;
+  QMap<QString, int> ModuleLoadTimes;
   vtkSlicerApplicationLogic* AppLogic;
   vtkMRMLScene* MRMLScene;
 };
@@ -81,6 +87,10 @@ int qSlicerModuleFactoryManager::loadModules()
     {
     this->loadModule(name);
     }
+  if (this->isVerbose())
+    {
+    this->printModuleStartupTimes();
+    }
   emit this->modulesLoaded(this->loadedModuleNames());
   return this->loadedModuleNames().count();
 }
@@ -168,6 +178,10 @@ bool qSlicerModuleFactoryManager::loadModule(const QString& name, const QString&
   // Update internal Map
   d->LoadedModules << name;
 
+  QElapsedTimer timer;
+  timer.start();
+  qSlicerStartupTracerScope span(QString("Load %1").arg(name), "module");
+
   // Initialize module
   instance->initialize(d->AppLogic);
 
@@ -186,6 +200,8 @@ bool qSlicerModuleFactoryManager::loadModule(const QString& name, const QString&
   this->connect(this,SIGNAL(mrmlSceneChanged(vtkMRMLScene*)),
                 instance, SLOT(setMRMLScene(vtkMRMLScene*)));
 
+  d->ModuleLoadTimes[name] = static_cast<int>(timer.elapsed());
+
   // Handle post-load initialization
   emit this->moduleLoaded(name);
 
@@ -199,6 +215,39 @@ bool qSlicerModuleFactoryManager::isLoaded(const QString& name)const
   return d->LoadedModules.contains(name);
 }
 
+//---------------------------------------------------------------------------
+int qSlicerModuleFactoryManager::moduleLoadTime(const QString& name)const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  return d->ModuleLoadTimes.value(name, -1);
+}
+
+//---------------------------------------------------------------------------
+void qSlicerModuleFactoryManager::printModuleStartupTimes()const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  QList<QPair<int, QString> > startupTimes;
+  int totalTime = 0;
+  foreach(const QString& name, d->LoadedModules)
+    {
+    int moduleTime = qMax(this->moduleInstantiationTime(name), 0)
+      + qMax(this->moduleLoadTime(name), 0);
+    startupTimes << qMakePair(moduleTime, name);
+    totalTime += moduleTime;
+    }
+  std::sort(startupTimes.begin(), startupTimes.end());
+  std::reverse(startupTimes.begin(), startupTimes.end());
+  qDebug() << "Module startup times (instantiation + load, in msecs):";
+  for (int i = 0; i < startupTimes.count(); ++i)
+    {
+    const QString& name = startupTimes[i].second;
+    qDebug().nospace() << "  " << qPrintable(name) << ": " << startupTimes[i].first
+                       << " (" << this->moduleInstantiationTime(name)
+                       << " + " << this->moduleLoadTime(name) << ")";
+    }
+  qDebug() << "Total:" << totalTime << "msecs for" << startupTimes.count() << "modules";
+}
+
 //-----------------------------------------------------------------------------
 QStringList qSlicerModuleFactoryManager::loadedModuleNames()const
 {
@@ -244,6 +293,7 @@ void qSlicerModuleFactoryManager::unloadModule(const QString& name)
     }
   emit this->moduleAboutToBeUnloaded(name);
   d->LoadedModules.removeOne(name);
+  d->ModuleLoadTimes.remove(name);
   this->uninstantiateModule(name);
   emit this->moduleUnloaded(name);
 }
@@ -88,6 +88,16 @@ public:
   /// \todo move it as protected
   bool loadModule(const QString& name);
 
+  /// Return the time in msecs spent initializing the module when it was
+  /// loaded, not including its dependencies, or -1 if it is not loaded.
+  /// \sa moduleInstantiationTime(), printModuleStartupTimes()
+  Q_INVOKABLE int moduleLoadTime(const QString& name)const;
+
+  /// Print the instantiation and load times of the loaded modules, slowest
+  /// first. Called by loadModules() in verbose mode.
+  /// \sa isVerbose()
+  Q_INVOKABLE void printModuleStartupTimes()const;
+
   /// Return all module paths that are direct child of \a basePath.
   QStringList modulePaths(const QString& basePath);
 
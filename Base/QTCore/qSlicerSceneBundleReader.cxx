@@ -121,6 +121,10 @@ bool qSlicerSceneBundleReader::load(const qSlicerIO::IOProperties& properties)
     res = this->mrmlScene()->Import();
     }
 
+  // The unpacked files are removed below, data that was deferred
+  // must be read now.
+  this->mrmlScene()->ReadAllDeferredData();
+
   if (!ctk::removeDirRecursively(unpackPath))
     {
     return false;
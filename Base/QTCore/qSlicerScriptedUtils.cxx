@@ -19,6 +19,7 @@
 ==============================================================================*/
 
 #include "qSlicerScriptedUtils_p.h"
+#include "qSlicerStartupTracer.h"
 
 // Qt includes
 #include <QFileInfo>
@@ -32,6 +33,8 @@ bool qSlicerScriptedUtils::loadSourceAsModule(const QString& moduleName,
                                        PyObject * global_dict,
                                        PyObject * local_dict)
 {
+  // Executing the module source imports all its dependencies
+  qSlicerStartupTracerScope span(QString("Import %1").arg(moduleName), "python");
   PyObject* pyRes = 0;
   if (fileName.endsWith(".py"))
     {
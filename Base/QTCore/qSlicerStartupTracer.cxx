@@ -0,0 +1,191 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QStack>
+#include <QTextStream>
+
+// SlicerQt includes
+#include "qSlicerStartupTracer.h"
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+struct StartupSpan
+{
+  QString Name;
+  QString Category;
+  qint64 Start; // in usecs
+  qint64 Duration; // in usecs
+};
+
+//-----------------------------------------------------------------------------
+struct StartupTrace
+{
+  StartupTrace() : Enabled(false) {}
+
+  bool Enabled;
+  QElapsedTimer Timer;
+  QStack<StartupSpan> OpenSpans;
+  QList<StartupSpan> Spans;
+};
+
+//-----------------------------------------------------------------------------
+StartupTrace& startupTrace()
+{
+  static StartupTrace trace;
+  return trace;
+}
+
+//-----------------------------------------------------------------------------
+qint64 elapsedMicroseconds(const QElapsedTimer& timer)
+{
+  return timer.nsecsElapsed() / 1000;
+}
+
+//-----------------------------------------------------------------------------
+QString escapeJSON(const QString& text)
+{
+  QString escaped;
+  foreach(const QChar& c, text)
+    {
+    if (c == '"' || c == '\\')
+      {
+      escaped += '\\';
+      escaped += c;
+      }
+    else if (c.unicode() < 0x20)
+      {
+      escaped += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+      }
+    else
+      {
+      escaped += c;
+      }
+    }
+  return escaped;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+void qSlicerStartupTracer::setEnabled(bool enabled)
+{
+  StartupTrace& trace = startupTrace();
+  trace.Enabled = enabled;
+  trace.OpenSpans.clear();
+  if (enabled)
+    {
+    trace.Spans.clear();
+    trace.Timer.start();
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerStartupTracer::isEnabled()
+{
+  return startupTrace().Enabled;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerStartupTracer::beginSpan(const QString& name, const QString& category)
+{
+  StartupTrace& trace = startupTrace();
+  if (!trace.Enabled)
+    {
+    return;
+    }
+  StartupSpan span;
+  span.Name = name;
+  span.Category = category;
+  span.Start = elapsedMicroseconds(trace.Timer);
+  span.Duration = 0;
+  trace.OpenSpans.push(span);
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerStartupTracer::endSpan()
+{
+  StartupTrace& trace = startupTrace();
+  if (!trace.Enabled || trace.OpenSpans.isEmpty())
+    {
+    return;
+    }
+  StartupSpan span = trace.OpenSpans.pop();
+  span.Duration = elapsedMicroseconds(trace.Timer) - span.Start;
+  trace.Spans << span;
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerStartupTracer::numberOfSpans()
+{
+  return startupTrace().Spans.count();
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerStartupTracer::write(const QString& fileName)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+    return false;
+    }
+  qint64 pid = QCoreApplication::applicationPid();
+  QTextStream stream(&file);
+  stream << "{\"traceEvents\":[\n";
+  const QList<StartupSpan>& spans = startupTrace().Spans;
+  for (int i = 0; i < spans.count(); ++i)
+    {
+    const StartupSpan& span = spans[i];
+    stream << "{\"name\":\"" << escapeJSON(span.Name) << "\","
+           << "\"cat\":\"" << escapeJSON(span.Category) << "\","
+           << "\"ph\":\"X\","
+           << "\"ts\":" << span.Start << ","
+           << "\"dur\":" << span.Duration << ","
+           << "\"pid\":" << pid << ","
+           << "\"tid\":0}"
+           << (i < spans.count() - 1 ? ",\n" : "\n");
+    }
+  stream << "],\"displayTimeUnit\":\"ms\"}\n";
+  return stream.status() == QTextStream::Ok;
+}
+
+//-----------------------------------------------------------------------------
+qSlicerStartupTracerScope::qSlicerStartupTracerScope(const QString& name, const QString& category)
+{
+  // Remember the state so that a span opened before the recording is
+  // disabled doesn't close another one.
+  this->Enabled = qSlicerStartupTracer::isEnabled();
+  if (this->Enabled)
+    {
+    qSlicerStartupTracer::beginSpan(name, category);
+    }
+}
+
+//-----------------------------------------------------------------------------
+qSlicerStartupTracerScope::~qSlicerStartupTracerScope()
+{
+  if (this->Enabled)
+    {
+    qSlicerStartupTracer::endSpan();
+    }
+}
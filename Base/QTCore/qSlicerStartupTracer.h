@@ -0,0 +1,77 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qSlicerStartupTracer_h
+#define __qSlicerStartupTracer_h
+
+// Qt includes
+#include <QString>
+
+#include "qSlicerBaseQTCoreExport.h"
+
+/// \brief Record the time spent in the phases of the application startup.
+///
+/// Spans are nested: a span begun while another one is open is its child.
+/// Recording is disabled by default, it is enabled with the
+/// "--startup-trace <file>" command line option. The trace is then written
+/// in the Chrome trace event format (open it with chrome://tracing) once the
+/// application event loop is started.
+///
+/// Spans must be begun and ended in the main thread.
+///
+/// Example of use:
+/// \code
+/// qSlicerStartupTracerScope span("Load modules");
+/// \endcode
+/// \sa qSlicerCoreCommandOptions::startupTraceFile()
+class Q_SLICER_BASE_QTCORE_EXPORT qSlicerStartupTracer
+{
+public:
+  typedef qSlicerStartupTracer Self;
+
+  /// Enable/disable the recording of spans. Enabling the recording resets the
+  /// time origin and clears the spans recorded so far.
+  static void setEnabled(bool enabled);
+  static bool isEnabled();
+
+  /// Open a span named \a name. No-op if the recording is disabled.
+  static void beginSpan(const QString& name, const QString& category = QString("startup"));
+
+  /// Close the last opened span. No-op if the recording is disabled.
+  static void endSpan();
+
+  /// Return the number of recorded (closed) spans.
+  static int numberOfSpans();
+
+  /// Write the recorded spans into \a fileName using the Chrome trace event
+  /// JSON format. Spans still open are not written.
+  /// Return false if the file can't be written.
+  static bool write(const QString& fileName);
+};
+
+/// \brief Open a startup span for the lifetime of the object.
+/// \sa qSlicerStartupTracer
+class Q_SLICER_BASE_QTCORE_EXPORT qSlicerStartupTracerScope
+{
+public:
+  qSlicerStartupTracerScope(const QString& name, const QString& category = QString("startup"));
+  ~qSlicerStartupTracerScope();
+private:
+  bool Enabled;
+};
+
+#endif
@@ -17,6 +17,7 @@
 // SlicerQt includes
 #include "qSlicerApplication.h"
 #include "qSlicerPythonManager.h"
+#include "qSlicerStartupTracer.h"
 
 #ifdef Slicer_USE_PYTHONQT_WITH_TCL
 // SlicerVTK includes
@@ -61,7 +62,9 @@ void qSlicerPythonManager::executeInitializationScripts()
     }
 
   // Evaluate application script
+  qSlicerStartupTracer::beginSpan("Execute slicerqt.py", "python");
   this->executeFile(app->slicerHome() + "/bin/Python/slicer/slicerqt.py");
+  qSlicerStartupTracer::endSpan();
 
 #ifdef Slicer_USE_PYTHONQT_WITH_TCL
   // Evaluate application script specific to the TCL layer
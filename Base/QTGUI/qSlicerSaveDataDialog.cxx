@@ -254,6 +254,11 @@ void qSlicerSaveDataDialogPrivate::populateItems()
   // sorting the table while doing insertions is dangerous
   // Moreover, we want to have the MRML scene to be the first item.
   this->FileWidget->setSortingEnabled(false);
+  // don't repaint the table for each inserted row
+  bool wasUpdatesEnabled = this->FileWidget->updatesEnabled();
+  this->FileWidget->setUpdatesEnabled(false);
+  // writers don't change while populating
+  this->FileWriterExtensions.clear();
 
   this->DirectoryButton->setDirectory(this->MRMLScene->GetRootDirectory());
 
@@ -303,6 +308,7 @@ void qSlicerSaveDataDialogPrivate::populateItems()
   // Here we could have restore the sorting property but we want to keep the
   // MRML scene the first item of the list so we don't do restore the sorting.
   // this->FileWidget->setSortingEnabled(oldSortingEnabled);
+  this->FileWidget->setUpdatesEnabled(wasUpdatesEnabled);
 
   // Enable/disable nodes depending on the scene file format
   this->onSceneFormatChanged();
@@ -653,7 +659,7 @@ QWidget* qSlicerSaveDataDialogPrivate::createFileFormatsWidget(vtkMRMLStorableNo
     qSlicerCoreApplication::application()->coreIOManager();
   int currentFormat = -1;
   QString currentExtension = coreIOManager->completeSlicerWritableFileNameSuffix(node);
-  foreach(QString nameFilter, coreIOManager->fileWriterExtensions(node))
+  foreach(QString nameFilter, this->fileWriterExtensions(node))
     {
     QString extension = QString::fromStdString(
       vtkDataFileFormatHelper::GetFileExtensionFromFormatString(nameFilter.toLatin1()));
@@ -723,6 +729,25 @@ ctkDirectoryButton* qSlicerSaveDataDialogPrivate::createFileDirectoryWidget(cons
   return directoryButton;
 }
 
+//-----------------------------------------------------------------------------
+QStringList qSlicerSaveDataDialogPrivate::fileWriterExtensions(vtkMRMLStorableNode* node)
+{
+  vtkMRMLStorageNode* snode = node->GetStorageNode();
+  // The writers only depend on the node type and the storage node type
+  QString key = QString("%1/%2").arg(node->GetClassName())
+    .arg(snode ? snode->GetClassName() : "");
+  QHash<QString, QStringList>::const_iterator it = this->FileWriterExtensions.constFind(key);
+  if (it != this->FileWriterExtensions.constEnd())
+    {
+    return it.value();
+    }
+  qSlicerCoreIOManager* coreIOManager =
+    qSlicerCoreApplication::application()->coreIOManager();
+  QStringList extensions = coreIOManager->fileWriterExtensions(node);
+  this->FileWriterExtensions.insert(key, extensions);
+  return extensions;
+}
+
 //-----------------------------------------------------------------------------
 QString qSlicerSaveDataDialogPrivate::extractKnownExtension(const QString& fileName, vtkObject* object)
 {
@@ -957,7 +982,6 @@ vtkMRMLNode* qSlicerSaveDataDialogPrivate::getNodeByID(char *id, vtkMRMLScene* s
   if (node == 0)
     {
     // search in SceneView nodes
-    std::string sID(id);
     std::vector<vtkMRMLNode *> nodes;
     scene->GetNodesByClass("vtkMRMLSceneViewNode", nodes);
     std::vector<vtkMRMLNode *>::iterator it;
@@ -970,16 +994,11 @@ vtkMRMLNode* qSlicerSaveDataDialogPrivate::getNodeByID(char *id, vtkMRMLScene* s
         {
         continue;
         }
-      std::vector<vtkMRMLNode *> snodes;
-      svNode->GetNodesByClass("vtkMRMLStorableNode", snodes);
-      std::vector<vtkMRMLNode *>::iterator sit;
-      for (sit = snodes.begin(); sit != snodes.end(); sit++)
+      vtkMRMLScene* storedScene = svNode->GetStoredScene();
+      vtkMRMLNode* snode = storedScene ? storedScene->GetNodeByID(id) : 0;
+      if (snode && snode->IsA("vtkMRMLStorableNode"))
         {
-        vtkMRMLNode* snode = (*sit);
-        if (std::string(snode->GetID()) == sID)
-          {
-          return snode;
-          }
+        return snode;
         }
       }
     }
@@ -16,6 +16,7 @@
 #include <QDialog>
 #include <QDir>
 #include <QFileInfo>
+#include <QHash>
 #include <QStyledItemDelegate>
 
 // SlicerQt includes
@@ -108,6 +109,9 @@ protected:
   QTableWidgetItem* createFileNameItem(const QFileInfo& fileInfo, const QString& extension, const QString& nodeID);
   ctkDirectoryButton* createFileDirectoryWidget(const QFileInfo& fileInfo);
 
+  /// File formats the writers support for \a node, cached by node and
+  /// storage node class while populating the table.
+  QStringList fileWriterExtensions(vtkMRMLStorableNode* node);
   static QString extractKnownExtension(const QString& fileName, vtkObject* object);
   static QString stripKnownExtension(const QString& fileName, vtkObject* object);
 
@@ -123,6 +127,7 @@ protected:
   vtkMRMLScene* MRMLScene;
   QString MRMLSceneRootDirectoryBeforeSaving;
   QString LastMRMLSceneFileFormat;
+  QHash<QString, QStringList> FileWriterExtensions;
 
   friend class qSlicerFileNameItemDelegate;
 };
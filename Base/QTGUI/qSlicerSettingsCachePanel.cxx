@@ -75,6 +75,8 @@ void qSlicerSettingsCachePanelPrivate::init()
                    q, SLOT(setCacheFreeBufferSize(int)));
   QObject::connect(this->ForceRedownloadCheckBox, SIGNAL(toggled(bool)),
                    q, SLOT(setForceRedownload(bool)));
+  QObject::connect(this->EvictionCheckBox, SIGNAL(toggled(bool)),
+                   q, SLOT(setEvictionEnabled(bool)));
   QObject::connect(this->ClearCachePushButton, SIGNAL(clicked()),
                    q, SLOT(clearCache()));
 
@@ -123,6 +125,8 @@ void qSlicerSettingsCachePanel::setCacheManager(vtkCacheManager* cacheManager)
                          SIGNAL(valueChanged(int)));
   this->registerProperty("Cache/ForceRedownload", d->ForceRedownloadCheckBox, "checked",
                          SIGNAL(toggled(bool)));
+  this->registerProperty("Cache/EvictionEnabled", d->EvictionCheckBox, "checked",
+                         SIGNAL(toggled(bool)));
 }
 
 // --------------------------------------------------------------------------
@@ -167,6 +171,12 @@ void qSlicerSettingsCachePanel::updateFromCacheManager()
     d->CacheManager->GetRemoteCacheFreeBufferSize() );
   d->ForceRedownloadCheckBox->setChecked(
     d->CacheManager->GetEnableForceRedownload() == 1 );
+  d->EvictionCheckBox->setChecked(
+    d->CacheManager->GetEnableCacheEviction() == 1 );
+  d->CacheStatisticsLabel->setText(
+    tr("%1 hits, %2 misses")
+    .arg(d->CacheManager->GetNumberOfCacheHits())
+    .arg(d->CacheManager->GetNumberOfCacheMisses()) );
 
   d->FilesListWidget->clear();
   std::vector<std::string> cachedFiles = d->CacheManager->GetCachedFiles();
@@ -210,6 +220,13 @@ void qSlicerSettingsCachePanel::setForceRedownload(bool force)
   d->CacheManager->SetEnableForceRedownload(force ? 1 : 0);
 }
 
+// --------------------------------------------------------------------------
+void qSlicerSettingsCachePanel::setEvictionEnabled(bool enable)
+{
+  Q_D(qSlicerSettingsCachePanel);
+  d->CacheManager->SetEnableCacheEviction(enable ? 1 : 0);
+}
+
 // --------------------------------------------------------------------------
 void qSlicerSettingsCachePanel::clearCache()
 {
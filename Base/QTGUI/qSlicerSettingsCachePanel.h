@@ -56,6 +56,7 @@ public slots:
   void setCacheSize(int sizeInMB);
   void setCacheFreeBufferSize(int sizeInMB);
   void setForceRedownload(bool force);
+  void setEvictionEnabled(bool enable);
   void clearCache();
 
 protected slots:
@@ -35,6 +35,9 @@
 #include "qSlicerSettingsGeneralPanel.h"
 #include "ui_qSlicerSettingsGeneralPanel.h"
 
+// Logic includes
+#include <vtkSlicerApplicationLogic.h>
+
 #include "vtkSlicerConfigure.h" // For Slicer_QM_OUTPUT_DIRS, Slicer_BUILD_I18N_SUPPORT, Slicer_USE_PYTHONQT
 
 #ifdef Slicer_USE_PYTHONQT
@@ -142,6 +145,12 @@ void qSlicerSettingsGeneralPanelPrivate::init()
                       SIGNAL(valueChanged(int)),
                       "Max. number of 'Recently Loaded' menu items",
                       ctkSettingsPanel::OptionRequireRestart);
+  // Connected first so that the saved value is applied when registered
+  QObject::connect(this->MaximumNumberOfThreadsSpinBox, SIGNAL(valueChanged(int)),
+                   q, SLOT(setMaximumNumberOfThreads(int)));
+  q->registerProperty("Performance/MaximumNumberOfThreads", this->MaximumNumberOfThreadsSpinBox, "value",
+                      SIGNAL(valueChanged(int)),
+                      "Max. number of threads");
 }
 
 // --------------------------------------------------------------------------
@@ -167,6 +176,20 @@ void qSlicerSettingsGeneralPanel::setDefaultScenePath(const QString& path)
   qSlicerCoreApplication::application()->setDefaultScenePath(path);
 }
 
+// --------------------------------------------------------------------------
+void qSlicerSettingsGeneralPanel::setMaximumNumberOfThreads(int numberOfThreads)
+{
+  qSlicerCoreApplication* app = qSlicerCoreApplication::application();
+  if (!app->applicationLogic())
+    {
+    return;
+    }
+  app->applicationLogic()->SetMaximumNumberOfThreads(numberOfThreads);
+  // CLI modules run as executables read the ITK default from the environment
+  app->setEnvironmentVariable("ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS",
+    QString::number(itk::MultiThreader::GetGlobalDefaultNumberOfThreads()));
+}
+
 // --------------------------------------------------------------------------
 void qSlicerSettingsGeneralPanel::openSlicerRCFile()
 {
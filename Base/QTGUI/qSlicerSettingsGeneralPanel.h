@@ -49,6 +49,7 @@ public:
 
 public slots:
   void setDefaultScenePath(const QString& path);
+  void setMaximumNumberOfThreads(int numberOfThreads);
   void openSlicerRCFile();
 
 protected:
@@ -157,6 +157,49 @@ int vtkFSIO::ReadFloatZ (gzFile iFile, float& oFloat) {
   return result;
 }
 
+//------------------------------------------------------------------------------
+int vtkFSIO::ReadInts (FILE* iFile, int* oInts, int count) {
+
+  if (count <= 0) {
+    return 0;
+  }
+  int result = static_cast<int>(fread (oInts, sizeof(int), count, iFile));
+  vtkByteSwap::Swap4BERange (oInts, result);
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+int vtkFSIO::ReadInt3s (FILE* iFile, int* oInts, int count) {
+
+  if (count <= 0) {
+    return 0;
+  }
+  // Read all the three byte ints in the buffer of full sized ints, then
+  // expand them from the end so that no value is overwritten before it
+  // is decoded.
+  unsigned char* bytes = reinterpret_cast<unsigned char*>(oInts);
+  int result = static_cast<int>(fread (bytes, 3, count, iFile));
+  for (int i = result - 1; i >= 0; --i) {
+    const unsigned char* b = bytes + 3 * i;
+    oInts[i] = (b[0] << 16) | (b[1] << 8) | b[2];
+  }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+int vtkFSIO::ReadFloats (FILE* iFile, float* oFloats, int count) {
+
+  if (count <= 0) {
+    return 0;
+  }
+  int result = static_cast<int>(fread (oFloats, sizeof(float), count, iFile));
+  vtkByteSwap::Swap4BERange (oFloats, result);
+
+  return result;
+}
+
 //------------------------------------------------------------------------------
 // Utility methods for writing test files
 
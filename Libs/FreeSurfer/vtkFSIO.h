@@ -43,6 +43,14 @@ namespace vtkFSIO {
   int VTK_FreeSurfer_EXPORT ReadInt2Z (gzFile iFile, int& oInt);
   int VTK_FreeSurfer_EXPORT ReadFloatZ (gzFile iFile, float& oFloat);
 
+  /// Read \a count big-endian values in a single block into \a oValues
+  /// and swap them in place. Return the number of values read, which is
+  /// less than \a count on a short read.
+  /// Use these instead of reading values one at a time for per-vertex data.
+  int VTK_FreeSurfer_EXPORT ReadInts (FILE* iFile, int* oInts, int count);
+  int VTK_FreeSurfer_EXPORT ReadInt3s (FILE* iFile, int* oInts, int count);
+  int VTK_FreeSurfer_EXPORT ReadFloats (FILE* iFile, float* oFloats, int count);
+
   /// For testing purposes
   int VTK_FreeSurfer_EXPORT WriteInt (FILE* iFile, int iInt);
   int VTK_FreeSurfer_EXPORT WriteInt3 (FILE* iFile, int iInt);
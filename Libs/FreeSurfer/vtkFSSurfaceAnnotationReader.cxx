@@ -21,6 +21,9 @@
 #include <vtkLookupTable.h>
 #include <vtkObjectFactory.h>
 
+// STD includes
+#include <vector>
+
 //-------------------------------------------------------------------------
 vtkStandardNewMacro(vtkFSSurfaceAnnotationReader);
 
@@ -145,45 +148,29 @@ int vtkFSSurfaceAnnotationReader::ReadFSAnnotation()
   // table stuff.
   totalSteps = numLabels*2;
 
-  for (labelIndex = 0; labelIndex < numLabels; labelIndex ++ )
+  // The file stores a vertex index and an rgb value per label, read all
+  // the pairs in one block.
+  std::vector<int> vertexRGBs(2 * static_cast<size_t>(numLabels));
+  read = vtkFSIO::ReadInts (annotFile, &vertexRGBs[0], 2 * numLabels);
+  if (read != 2 * numLabels)
   {
-      if (feof (annotFile) )
-      {
-          vtkErrorMacro (<< "\nReadFSAnnotation: unexpected EOF after\n "
-                         << numLabels << " values read.");
-          fclose (annotFile);
-          free (rgbs);
-          free (labels);
-          return vtkFSSurfaceAnnotationReader::FS_ERROR_PARSING_ANNOTATION;
-      }
+      vtkErrorMacro (<< "\nReadFSAnnotation: unexpected EOF after\n "
+                     << read / 2 << " values read.");
+      fclose (annotFile);
+      free (rgbs);
+      free (labels);
+      return vtkFSSurfaceAnnotationReader::FS_ERROR_PARSING_ANNOTATION;
+  }
 
-      // Read a vertex index and an rgb value. Set the appropriate
-      // value in the rgb array.
-      read = vtkFSIO::ReadInt (annotFile, vertexIndex);
-      if (read != 1)
-      {
-          vtkErrorMacro (<< "\nReadFSAnnotation: error reading vertex index at\n"
-                         << labelIndex);
-          fclose (annotFile);
-          free (rgbs);
-          free (labels);
-          return vtkFSSurfaceAnnotationReader::FS_ERROR_PARSING_ANNOTATION;
-      }
-      read = vtkFSIO::ReadInt (annotFile, rgb);
-      if (read != 1)
-      {
-          vtkErrorMacro (<< "\nReadFSAnnotation: error reading rgb value at\n"
-                         << labelIndex);
-          fclose (annotFile);
-          free (rgbs);
-          free (labels);
-          return vtkFSSurfaceAnnotationReader::FS_ERROR_PARSING_ANNOTATION;
-      }
+  for (labelIndex = 0; labelIndex < numLabels; labelIndex ++ )
+  {
+      vertexIndex = vertexRGBs[2 * labelIndex];
+      rgb = vertexRGBs[2 * labelIndex + 1];
       if (labelIndex < 100)
       {
           vtkDebugMacro(<< "ReadFSAnnotation: Read vertex # " << vertexIndex << " rgb = " << rgb << endl);
       }
-      if (vertexIndex >= numLabels)
+      if (vertexIndex < 0 || vertexIndex >= numLabels)
         {
         vtkErrorMacro("ReadFSAnnotation: Read vertex # " << vertexIndex << " is out of bounds! Not in 0 to " << numLabels << " -1, rgb = " << rgb << endl);
         }
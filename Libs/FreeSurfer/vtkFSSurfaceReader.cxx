@@ -25,6 +25,9 @@
 #include <vtkPolyData.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 
+// STD includes
+#include <vector>
+
 //-------------------------------------------------------------------------
 vtkStandardNewMacro(vtkFSSurfaceReader);
 
@@ -259,6 +262,18 @@ int vtkFSSurfaceReader::RequestData(
 #endif
   vtkDebugMacro(<<"Got total steps = " << totalSteps);
 
+  // Read all the float vertex coordinates in one block instead of one
+  // value at a time.
+  std::vector<float> coordinates;
+  if (magicNumber != vtkFSSurfaceReader::FS_QUAD_FILE_MAGIC_NUMBER && numVertices > 0)
+    {
+    coordinates.resize(3 * static_cast<size_t>(numVertices), 0.f);
+    if (vtkFSIO::ReadFloats (surfaceFile, &coordinates[0], 3 * numVertices) != 3 * numVertices)
+      {
+      vtkErrorMacro("Error reading vertex coordinates from " << this->FileName);
+      }
+    }
+
   // For each vertex...
   for (vIndex = 0; vIndex < numVertices; vIndex++) {
 
@@ -280,9 +295,9 @@ int vtkFSSurfaceReader::RequestData(
           break;
       case vtkFSSurfaceReader::FS_NEW_QUAD_FILE_MAGIC_NUMBER:
       case vtkFSSurfaceReader::FS_TRIANGLE_FILE_MAGIC_NUMBER:
-          vtkFSIO::ReadFloat (surfaceFile, locations[0]);
-          vtkFSIO::ReadFloat (surfaceFile, locations[1]);
-          vtkFSIO::ReadFloat (surfaceFile, locations[2]);
+          locations[0] = coordinates[3 * vIndex];
+          locations[1] = coordinates[3 * vIndex + 1];
+          locations[2] = coordinates[3 * vIndex + 2];
           break;
       }
 
@@ -309,6 +324,31 @@ int vtkFSSurfaceReader::RequestData(
       }
   }
 
+  // Read all the face vertex indices in one block. Triangle format gets
+  // normal ints, quad formats get three byte ints.
+  int numFaceIndices = numFaces * faceMultiplier / faceIncrement * numVerticesPerFace;
+  std::vector<int> faceIndexBuffer(numFaceIndices > 0 ? numFaceIndices : 0, 0);
+  int numFaceIndicesRead = 0;
+  if (numFaceIndices > 0)
+    {
+    switch (magicNumber)
+      {
+      case vtkFSSurfaceReader::FS_QUAD_FILE_MAGIC_NUMBER:
+      case vtkFSSurfaceReader::FS_NEW_QUAD_FILE_MAGIC_NUMBER:
+        numFaceIndicesRead = vtkFSIO::ReadInt3s (surfaceFile, &faceIndexBuffer[0], numFaceIndices);
+        break;
+      case vtkFSSurfaceReader::FS_TRIANGLE_FILE_MAGIC_NUMBER:
+        numFaceIndicesRead = vtkFSIO::ReadInts (surfaceFile, &faceIndexBuffer[0], numFaceIndices);
+        break;
+      }
+    }
+  if (numFaceIndicesRead != numFaceIndices)
+    {
+    vtkErrorMacro("Error reading face indices, read " << numFaceIndicesRead
+                  << " of " << numFaceIndices);
+    }
+  const int* faceIndexIt = numFaceIndices > 0 ? &faceIndexBuffer[0] : NULL;
+
   // For each face...
   for (fIndex = 0;
        fIndex < numFaces * faceMultiplier;
@@ -319,25 +359,7 @@ int vtkFSSurfaceReader::RequestData(
 
         thisStep++;
 
-        // Read in a vertex index. Triangle format gets a normal int,
-        // quad formats get three byte ints.
-        switch (magicNumber) {
-        case vtkFSSurfaceReader::FS_QUAD_FILE_MAGIC_NUMBER:
-        case vtkFSSurfaceReader::FS_NEW_QUAD_FILE_MAGIC_NUMBER:
-            vtkFSIO::ReadInt3 (surfaceFile, tmpfIndex);
-            break;
-        case vtkFSSurfaceReader::FS_TRIANGLE_FILE_MAGIC_NUMBER:
-            retval = fread (&tmpfIndex, sizeof(int), 1, surfaceFile);
-            if (retval == 1)
-              {
-              vtkByteSwap::Swap4BE (&tmpfIndex);
-              }
-            else
-              {
-              vtkErrorMacro("Error reading integer at index " << fvIndex);
-              }
-            break;
-        }
+        tmpfIndex = *faceIndexIt++;
 
         faceIndices[fvIndex] = tmpfIndex;
 
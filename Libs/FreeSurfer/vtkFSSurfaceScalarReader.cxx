@@ -138,9 +138,28 @@ int vtkFSSurfaceScalarReader::ReadFSScalars()
   // Make our float array.
   FSscalars = (float*) calloc (numValues, sizeof(float));
 
-  // For each value, if it's a new style file read a float, otherwise
-  // read a two byte int and divide it by 100. Add this value to the
-  // array.
+  if (FSscalars == NULL) {
+    vtkErrorMacro (<< "vtkFSSurfaceScalarReader.cxx Execute: error allocating " << numValues << " floats.");
+    fclose (scalarFile);
+    return 0;
+  }
+
+  // New style files store all the values as floats, read them in one
+  // block.
+  if (this->FS_NEW_SCALAR_MAGIC_NUMBER == magicNumber) {
+    int numValuesRead = vtkFSIO::ReadFloats (scalarFile, FSscalars, numValues);
+    fclose (scalarFile);
+    if (numValuesRead != numValues) {
+      vtkErrorMacro (<< "vtkFSSurfaceScalarReader.cxx Execute: Unexpected EOF after " << numValuesRead << " values read.");
+      free (FSscalars);
+      return 0;
+    }
+    output->SetArray (FSscalars, numValues, 0);
+    return 1;
+  }
+
+  // For each value, read a two byte int and divide it by 100. Add this
+  // value to the array.
   for (vIndex = 0; vIndex < numValues; vIndex ++ ) {
 
     if (feof(scalarFile)) {
@@ -148,21 +167,8 @@ int vtkFSSurfaceScalarReader::ReadFSScalars()
       return 0;
     }
 
-    if (this->FS_NEW_SCALAR_MAGIC_NUMBER == magicNumber) {
-      size_t retval = fread (&fvalue, sizeof(float), 1, scalarFile);
-      if (retval == 1)
-        {
-        vtkByteSwap::Swap4BE (&fvalue);
-        }
-      else
-        {
-        vtkErrorMacro("Error reading fvalue from file " << this->FileName);
-        }
-
-    } else {
-      vtkFSIO::ReadInt2 (scalarFile, ivalue);
-      fvalue = ivalue / 100.0;
-    }
+    vtkFSIO::ReadInt2 (scalarFile, ivalue);
+    fvalue = ivalue / 100.0;
 
     FSscalars[vIndex] = fvalue;
 
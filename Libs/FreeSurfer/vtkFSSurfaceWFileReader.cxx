@@ -18,8 +18,13 @@
 
 // VTK includes
 #include <vtkFloatArray.h>
+#include <vtkByteSwap.h>
 #include <vtkObjectFactory.h>
 
+// STD includes
+#include <cstring>
+#include <vector>
+
 //-------------------------------------------------------------------------
 vtkStandardNewMacro(vtkFSSurfaceWFileReader);
 
@@ -123,14 +128,22 @@ int vtkFSSurfaceWFileReader::ReadWFile()
     return this->FS_ERROR_W_ALLOC;
     }
 
+  // Each value is stored as a 3 byte int index followed by a float,
+  // read all the records in one block.
+  const size_t recordSize = 7;
+  std::vector<unsigned char> records(recordSize * static_cast<size_t>(numValues) + 1);
+  size_t numRecordsRead = fread(&records[0], recordSize, numValues, wFile);
+
   // For each value in the wfile...
   for (vIndex = 0; vIndex < numValues; vIndex ++ )
     {
 
     // Check for eof.
-    if (feof(wFile))
+    if (static_cast<size_t>(vIndex) >= numRecordsRead)
       {
       vtkErrorMacro (<< "vtkFSSurfaceWFileReader.cxx Execute: Unexpected EOF after " << vIndex << " values read. Tried to read " << numValues);
+      fclose (wFile);
+      free (FSscalars);
       return this->FS_ERROR_W_EOF;
       }
 
@@ -141,8 +154,10 @@ int vtkFSSurfaceWFileReader::ReadWFile()
     // happen in practice. Additionally, these are usually written
     // with indices from 0->nvertices, so this index value isn't even
     // really needed.
-    vtkFSIO::ReadInt3 (wFile, vIndexFromFile);
-    vtkFSIO::ReadFloat (wFile, fvalue);
+    const unsigned char* record = &records[recordSize * vIndex];
+    vIndexFromFile = (record[0] << 16) | (record[1] << 8) | record[2];
+    memcpy(&fvalue, record + 3, sizeof(float));
+    vtkByteSwap::Swap4BE (&fvalue);
 
     // Make sure the index is in bounds. If not, print a warning and
     // try to do the next value. If this happens, there is probably a
@@ -28,6 +28,7 @@ Version:   $Revision: 1.2 $
 #include <vtkObjectFactory.h>
 
 // STD includes
+#include <algorithm>
 #include <sstream>
 
 
@@ -53,6 +54,11 @@ public:
   /// Delay in msecs to wait before the module is auto run.
   unsigned int AutoRunDelay;
 
+  /// Scheduling priority and expected cost of an execution
+  int Priority;
+  int RequiredNumberOfThreads;
+  unsigned int RequiredMemorySize;
+
   /// Last time the module was started.
   vtkTimeStamp LastRunTime;
   /// Last time a parameter was modified.
@@ -91,6 +97,9 @@ vtkMRMLCommandLineModuleNode::vtkMRMLCommandLineModuleNode()
     vtkMRMLCommandLineModuleNode::AutoRunOnChangedParameter
     | vtkMRMLCommandLineModuleNode::AutoRunCancelsRunningProcess;
   this->Internal->AutoRunDelay = 1000;
+  this->Internal->Priority = 0;
+  this->Internal->RequiredNumberOfThreads = 1;
+  this->Internal->RequiredMemorySize = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -277,6 +286,9 @@ void vtkMRMLCommandLineModuleNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Status: " << this->GetStatusString() << "\n";
   os << indent << "AutoRun:" << this->GetAutoRun() << "\n";
   os << indent << "AutoRunMode:" << this->GetAutoRunMode() << "\n";
+  os << indent << "Priority:" << this->GetPriority() << "\n";
+  os << indent << "RequiredNumberOfThreads:" << this->GetRequiredNumberOfThreads() << "\n";
+  os << indent << "RequiredMemorySize:" << this->GetRequiredMemorySize() << "\n";
 
   os << indent << "Parameter values:\n";
   std::vector<ModuleParameterGroup>::const_iterator pgbeginit = this->GetModuleDescription().GetParameterGroups().begin();
@@ -614,6 +626,58 @@ unsigned int vtkMRMLCommandLineModuleNode::GetAutoRunDelay() const
   return this->Internal->AutoRunDelay;
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLCommandLineModuleNode::SetPriority(int priority)
+{
+  if (this->Internal->Priority == priority)
+    {
+    return;
+    }
+  this->Internal->Priority = priority;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLCommandLineModuleNode::GetPriority() const
+{
+  return this->Internal->Priority;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLCommandLineModuleNode::SetRequiredNumberOfThreads(int numberOfThreads)
+{
+  numberOfThreads = std::max(numberOfThreads, 1);
+  if (this->Internal->RequiredNumberOfThreads == numberOfThreads)
+    {
+    return;
+    }
+  this->Internal->RequiredNumberOfThreads = numberOfThreads;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLCommandLineModuleNode::GetRequiredNumberOfThreads() const
+{
+  return this->Internal->RequiredNumberOfThreads;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLCommandLineModuleNode::SetRequiredMemorySize(unsigned int megabytes)
+{
+  if (this->Internal->RequiredMemorySize == megabytes)
+    {
+    return;
+    }
+  this->Internal->RequiredMemorySize = megabytes;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkMRMLCommandLineModuleNode::GetRequiredMemorySize() const
+{
+  return this->Internal->RequiredMemorySize;
+}
+
 //----------------------------------------------------------------------------
 vtkMTimeType vtkMRMLCommandLineModuleNode::GetLastRunTime() const
 {
@@ -197,6 +197,25 @@ public:
   /// \sa SetAutoRunDelay(), GetAutoRun(), GetAutoRunMode()
   unsigned int GetAutoRunDelay()const;
 
+  /// Set the priority of the module when it is scheduled to run.
+  /// Modules with a higher priority start first. 0 by default.
+  /// \sa GetPriority(), SetRequiredNumberOfThreads()
+  void SetPriority(int priority);
+  int GetPriority()const;
+
+  /// Set the number of threads the module is expected to use while running.
+  /// The module doesn't start while the other running modules use the
+  /// threads available for processing. 1 by default.
+  /// \sa GetRequiredNumberOfThreads(), SetRequiredMemorySize()
+  void SetRequiredNumberOfThreads(int numberOfThreads);
+  int GetRequiredNumberOfThreads()const;
+
+  /// Set the memory in megabytes the module is expected to use while
+  /// running. 0 (unknown) by default.
+  /// \sa GetRequiredMemorySize(), SetRequiredNumberOfThreads()
+  void SetRequiredMemorySize(unsigned int megabytes);
+  unsigned int GetRequiredMemorySize()const;
+
   /// Return the last time the module was ran.
   /// \sa GetParameterMTime(), GetInputMTime(), GetMTime()
   vtkMTimeType GetLastRunTime()const;
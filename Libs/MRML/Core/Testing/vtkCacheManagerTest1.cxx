@@ -0,0 +1,115 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkCacheManager.h"
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkNew.h>
+
+// VTKsys includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <fstream>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+void WriteFile(const std::string& fileName, const std::string& content, int repeat = 1)
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+  for (int i = 0; i < repeat; ++i)
+    {
+    file << content;
+    }
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkCacheManagerTest1(int argc, char * argv[])
+{
+  if (argc != 2)
+    {
+    std::cerr << "Line " << __LINE__
+              << " - Missing parameters !\n"
+              << "Usage: " << argv[0] << " /path/to/temp"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::string cacheDir = std::string(argv[1]) + "/vtkCacheManagerTest1";
+  vtksys::SystemTools::RemoveADirectory(cacheDir.c_str());
+
+  std::string fileA = cacheDir + "/a.nrrd";
+  std::string fileB = cacheDir + "/b.nrrd";
+  std::string fileC = cacheDir + "/c.raw";
+  std::string fileD = cacheDir + "/d.raw";
+
+  {
+    vtkNew<vtkCacheManager> cacheManager;
+    cacheManager->SetRemoteCacheDirectory(cacheDir.c_str());
+    CHECK_BOOL(vtksys::SystemTools::FileIsDirectory(cacheDir.c_str()), true);
+
+    // Identical content downloaded from two URIs is stored once
+    WriteFile(fileA, "same content");
+    WriteFile(fileB, "same content");
+    CHECK_STRING(cacheManager->AddCachedFile("http://host1/a.nrrd", fileA.c_str()).c_str(),
+                 fileA.c_str());
+    CHECK_STRING(cacheManager->AddCachedFile("http://host2/b.nrrd", fileB.c_str(), true).c_str(),
+                 fileA.c_str());
+    CHECK_BOOL(vtksys::SystemTools::FileExists(fileB.c_str()), false);
+    CHECK_STRING(cacheManager->GetFileFromURIMap("http://host2/b.nrrd"), fileA.c_str());
+    CHECK_INT(cacheManager->GetNumberOfCacheMisses(), 2);
+
+    cacheManager->MarkCacheHit(fileA.c_str());
+    CHECK_INT(cacheManager->GetNumberOfCacheHits(), 1);
+    cacheManager->ResetCacheStatistics();
+    CHECK_INT(cacheManager->GetNumberOfCacheHits(), 0);
+    CHECK_INT(cacheManager->GetNumberOfCacheMisses(), 0);
+
+    // The index file is not a cached file
+    cacheManager->UpdateCacheInformation();
+    CHECK_INT(static_cast<int>(cacheManager->GetCachedFiles().size()), 1);
+  }
+
+  {
+    // The URI mapping is restored in a new session
+    vtkNew<vtkCacheManager> cacheManager;
+    cacheManager->SetRemoteCacheDirectory(cacheDir.c_str());
+    CHECK_STRING(cacheManager->GetFileFromURIMap("http://host2/b.nrrd"), fileA.c_str());
+
+    // Least recently used files are removed first when the cache is full
+    cacheManager->SetRemoteCacheLimit(3);
+    cacheManager->SetRemoteCacheFreeBufferSize(1);
+    WriteFile(fileC, std::string(1000, 'c'), 1500);
+    cacheManager->AddCachedFile("http://host1/c.raw", fileC.c_str());
+    WriteFile(fileD, std::string(1000, 'd'), 1500);
+    cacheManager->AddCachedFile("http://host1/d.raw", fileD.c_str());
+    cacheManager->MarkCacheHit(fileC.c_str());
+
+    cacheManager->SetEnableCacheEviction(0);
+    CHECK_INT(cacheManager->EvictLeastRecentlyUsedFiles(), 0);
+    cacheManager->SetEnableCacheEviction(1);
+    CHECK_INT(cacheManager->EvictLeastRecentlyUsedFiles(), 2);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(fileA.c_str()), false);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(fileD.c_str()), false);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(fileC.c_str()), true);
+    CHECK_POINTER(cacheManager->GetFileFromURIMap("http://host2/b.nrrd"), NULL);
+    CHECK_INT(cacheManager->EvictLeastRecentlyUsedFiles(), 0);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,123 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkEventBroker.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkObservation.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkCommand.h>
+#include <vtkNew.h>
+#include <vtkTable.h>
+
+// STD includes
+#include <vector>
+
+namespace
+{
+
+std::vector<int> InvokedObservers;
+
+//---------------------------------------------------------------------------
+void RecordObserver1(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+                     void* vtkNotUsed(clientData), void* vtkNotUsed(callData))
+{
+  InvokedObservers.push_back(1);
+}
+
+//---------------------------------------------------------------------------
+void RecordObserver2(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+                     void* vtkNotUsed(clientData), void* vtkNotUsed(callData))
+{
+  InvokedObservers.push_back(2);
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkEventBrokerTest1(int vtkNotUsed(argc), char * vtkNotUsed(argv)[])
+{
+  vtkEventBroker* broker = vtkEventBroker::GetInstance();
+
+  vtkNew<vtkObject> subject;
+  vtkNew<vtkObject> observer1;
+  vtkNew<vtkObject> observer2;
+  vtkNew<vtkCallbackCommand> callback1;
+  callback1->SetCallback(RecordObserver1);
+  vtkNew<vtkCallbackCommand> callback2;
+  callback2->SetCallback(RecordObserver2);
+
+  // observer2 is added first but has a higher priority
+  broker->AddObservation(subject.GetPointer(), vtkCommand::ModifiedEvent,
+    observer2.GetPointer(), callback2.GetPointer(), 1.0f);
+  broker->AddObservation(subject.GetPointer(), vtkCommand::ModifiedEvent,
+    observer1.GetPointer(), callback1.GetPointer(), 0.0f);
+
+  // Synchronous mode: every event is delivered
+  subject->Modified();
+  subject->Modified();
+  CHECK_INT(static_cast<int>(InvokedObservers.size()), 4);
+  InvokedObservers.clear();
+
+  // Both observations have the same subject class, event and observer class
+  vtkNew<vtkTable> statistics;
+  broker->GetObservationStatistics(statistics.GetPointer());
+  CHECK_INT(statistics->GetNumberOfRows(), 1);
+  CHECK_STD_STRING(statistics->GetValueByName(0, "SubjectClass").ToString(), "vtkObject");
+  CHECK_STD_STRING(statistics->GetValueByName(0, "Event").ToString(), "ModifiedEvent");
+  CHECK_INT(statistics->GetValueByName(0, "InvocationCount").ToInt(), 4);
+  CHECK_INT(statistics->GetValueByName(0, "MaximumNestingLevel").ToInt(), 1);
+  broker->ResetObservationStatistics();
+  broker->GetObservationStatistics(statistics.GetPointer());
+  CHECK_INT(statistics->GetNumberOfRows(), 0);
+
+  // Asynchronous mode: repeated events are delivered once
+  broker->SetEventModeToAsynchronous();
+  broker->ResetEventCounters();
+  for (int i = 0; i < 10; ++i)
+    {
+    subject->Modified();
+    }
+  CHECK_INT(static_cast<int>(InvokedObservers.size()), 0);
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 2);
+  CHECK_INT(static_cast<int>(broker->GetNumberOfQueuedEvents()), 20);
+  CHECK_INT(static_cast<int>(broker->GetNumberOfCoalescedEvents()), 18);
+
+  broker->ProcessEventQueue();
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 0);
+  CHECK_INT(static_cast<int>(InvokedObservers.size()), 2);
+  // higher priority first
+  CHECK_INT(InvokedObservers[0], 2);
+  CHECK_INT(InvokedObservers[1], 1);
+  InvokedObservers.clear();
+
+  // Same with call data compression
+  broker->CompressCallDataOn();
+  broker->ResetEventCounters();
+  for (int i = 0; i < 10; ++i)
+    {
+    subject->Modified();
+    }
+  CHECK_INT(static_cast<int>(broker->GetNumberOfCoalescedEvents()), 18);
+  broker->ProcessEventQueue();
+  CHECK_INT(static_cast<int>(InvokedObservers.size()), 2);
+  InvokedObservers.clear();
+
+  broker->CompressCallDataOff();
+  broker->SetEventModeToSynchronous();
+  broker->RemoveObservations(subject.GetPointer(), observer1.GetPointer());
+  broker->RemoveObservations(subject.GetPointer(), observer2.GetPointer());
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,211 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkImageMapToWindowLevelThresholdColors.h"
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkAlgorithmOutput.h>
+#include <vtkImageAppendComponents.h>
+#include <vtkImageData.h>
+#include <vtkImageExtractComponents.h>
+#include <vtkImageLogic.h>
+#include <vtkImageMapToColors.h>
+#include <vtkImageMapToWindowLevelColors.h>
+#include <vtkImageStencil.h>
+#include <vtkImageStencilData.h>
+#include <vtkImageThreshold.h>
+#include <vtkLookupTable.h>
+#include <vtkNew.h>
+#include <vtkTrivialProducer.h>
+
+// STD includes
+#include <cstdlib>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Output of the multi-stage pipeline that vtkMRMLScalarVolumeDisplayNode
+// used to build.
+void ComputeReference(vtkImageData* image, vtkAlgorithmOutput* stencilConnection,
+                      vtkLookupTable* lut, double window, double level,
+                      double lower, double upper, bool applyThreshold,
+                      vtkImageData* reference)
+{
+  vtkNew<vtkImageMapToWindowLevelColors> windowLevel;
+  windowLevel->SetInputData(image);
+  windowLevel->SetOutputFormatToLuminance();
+  windowLevel->SetWindow(window);
+  windowLevel->SetLevel(level);
+
+  vtkNew<vtkImageMapToColors> mapToColors;
+  mapToColors->SetInputConnection(windowLevel->GetOutputPort());
+  mapToColors->SetOutputFormatToRGBA();
+  mapToColors->SetLookupTable(lut);
+
+  vtkNew<vtkImageExtractComponents> extractRGB;
+  extractRGB->SetInputConnection(mapToColors->GetOutputPort());
+  extractRGB->SetComponents(0, 1, 2);
+  vtkNew<vtkImageExtractComponents> extractAlpha;
+  extractAlpha->SetInputConnection(mapToColors->GetOutputPort());
+  extractAlpha->SetComponents(3);
+
+  vtkNew<vtkImageStencil> multiplyAlpha;
+  multiplyAlpha->SetInputConnection(extractAlpha->GetOutputPort());
+  multiplyAlpha->SetBackgroundValue(0);
+  multiplyAlpha->SetStencilConnection(stencilConnection);
+
+  vtkNew<vtkImageThreshold> threshold;
+  threshold->SetInputData(image);
+  threshold->ReplaceInOn();
+  threshold->SetInValue(255);
+  threshold->ReplaceOutOn();
+  threshold->SetOutValue(applyThreshold ? 0 : 255);
+  threshold->SetOutputScalarTypeToUnsignedChar();
+  threshold->ThresholdBetween(lower, upper);
+
+  vtkNew<vtkImageLogic> alphaLogic;
+  alphaLogic->SetOperationToAnd();
+  alphaLogic->SetOutputTrueValue(255);
+  alphaLogic->SetInputConnection(0, threshold->GetOutputPort());
+  alphaLogic->SetInputConnection(1, multiplyAlpha->GetOutputPort());
+
+  vtkNew<vtkImageAppendComponents> append;
+  append->AddInputConnection(0, extractRGB->GetOutputPort());
+  append->AddInputConnection(0, alphaLogic->GetOutputPort());
+  append->Update();
+  reference->DeepCopy(append->GetOutput());
+}
+
+//----------------------------------------------------------------------------
+bool CompareImages(vtkImageData* image, vtkImageData* reference, int line)
+{
+  if (image->GetNumberOfScalarComponents() != 4 ||
+      image->GetScalarType() != VTK_UNSIGNED_CHAR ||
+      image->GetNumberOfPoints() != reference->GetNumberOfPoints())
+    {
+    std::cerr << "Line " << line << ": unexpected output format" << std::endl;
+    return false;
+    }
+  const unsigned char* pixels = static_cast<unsigned char*>(image->GetScalarPointer());
+  const unsigned char* referencePixels = static_cast<unsigned char*>(reference->GetScalarPointer());
+  for (vtkIdType i = 0; i < 4 * image->GetNumberOfPoints(); ++i)
+    {
+    if (pixels[i] != referencePixels[i])
+      {
+      std::cerr << "Line " << line << ": value " << static_cast<int>(pixels[i])
+                << " of voxel " << i / 4 << " component " << i % 4
+                << " differs from the reference " << static_cast<int>(referencePixels[i]) << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkImageMapToWindowLevelThresholdColorsTest1(int , char * [] )
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(40, 30, 4);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* ptr = static_cast<short*>(image->GetScalarPointer());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    ptr[i] = static_cast<short>((i * 37) % 3000 - 1000);
+    }
+
+  // color ramp with transparent low values
+  vtkNew<vtkLookupTable> lut;
+  lut->SetNumberOfTableValues(256);
+  lut->SetTableRange(0, 255);
+  for (int i = 0; i < 256; ++i)
+    {
+    lut->SetTableValue(i, i / 255., 1. - i / 255., 0.5, i < 10 ? 0. : 1.);
+    }
+
+  // disk shaped stencil
+  vtkNew<vtkImageStencilData> stencil;
+  stencil->SetSpacing(image->GetSpacing());
+  stencil->SetOrigin(image->GetOrigin());
+  stencil->SetExtent(image->GetExtent());
+  stencil->AllocateExtents();
+  for (int z = 0; z < 4; ++z)
+    {
+    for (int y = 0; y < 30; ++y)
+      {
+      int halfWidth = 15 - abs(y - 15);
+      if (halfWidth > 0)
+        {
+        stencil->InsertNextExtent(20 - halfWidth, 20 + halfWidth, y, z);
+        }
+      }
+    }
+  vtkNew<vtkTrivialProducer> stencilProducer;
+  stencilProducer->SetOutput(stencil.GetPointer());
+
+  vtkNew<vtkImageMapToWindowLevelThresholdColors> colors;
+  EXERCISE_BASIC_OBJECT_METHODS(colors.GetPointer());
+  colors->SetInputData(image.GetPointer());
+  colors->SetLookupTable(lut.GetPointer());
+
+  const double windowLevels[3][2] = { {256., 128.}, {1500., 200.}, {-800., 0.} };
+  for (int wl = 0; wl < 3; ++wl)
+    {
+    for (int apply = 0; apply < 2; ++apply)
+      {
+      for (int useStencil = 0; useStencil < 2; ++useStencil)
+        {
+        colors->SetWindow(windowLevels[wl][0]);
+        colors->SetLevel(windowLevels[wl][1]);
+        colors->SetLowerThreshold(-200.);
+        colors->SetUpperThreshold(1200.);
+        colors->SetApplyThreshold(apply);
+        colors->SetStencilConnection(useStencil ? stencilProducer->GetOutputPort() : 0);
+        colors->Update();
+
+        vtkNew<vtkImageData> reference;
+        ComputeReference(image.GetPointer(), useStencil ? stencilProducer->GetOutputPort() : 0,
+                         lut.GetPointer(), windowLevels[wl][0], windowLevels[wl][1],
+                         -200., 1200., apply != 0, reference.GetPointer());
+        if (!CompareImages(colors->GetOutput(), reference.GetPointer(), __LINE__))
+          {
+          std::cerr << "window " << windowLevels[wl][0] << " level " << windowLevels[wl][1]
+                    << " applyThreshold " << apply << " stencil " << useStencil << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+  // Modifying the lookup table updates the output
+  for (int i = 0; i < 256; ++i)
+    {
+    lut->SetTableValue(i, 1. - i / 255., 0., i / 255., 1.);
+    }
+  colors->Update();
+  vtkNew<vtkImageData> reference;
+  ComputeReference(image.GetPointer(), colors->GetStencilConnection(), lut.GetPointer(),
+                   colors->GetWindow(), colors->GetLevel(), -200., 1200.,
+                   colors->GetApplyThreshold() != 0, reference.GetPointer());
+  if (!CompareImages(colors->GetOutput(), reference.GetPointer(), __LINE__))
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
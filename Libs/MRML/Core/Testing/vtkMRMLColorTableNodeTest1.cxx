@@ -21,6 +21,9 @@
 #include <vtkNew.h>
 #include <vtkSmartPointer.h>
 
+// STD includes
+#include <fstream>
+
 using namespace vtkMRMLCoreTestingUtilities;
 
 //---------------------------------------------------------------------------
@@ -100,6 +103,70 @@ int vtkMRMLColorTableNodeTest1(int argc, char * argv[])
     CHECK_STRING(colorNode->GetColorName(0), "zero")
     CHECK_STRING(colorNode->GetColorName(1), "one")
     CHECK_STRING(colorNode->GetColorName(2), "two")
+
+    CHECK_INT(colorNode->GetColorIndexByName("two"), 2);
+    CHECK_INT(colorNode->GetColorIndexByName("three"), -1);
+    // the name to index map follows the renamed colors
+    colorNode->SetColorName(2, "three");
+    CHECK_INT(colorNode->GetColorIndexByName("two"), -1);
+    CHECK_INT(colorNode->GetColorIndexByName("three"), 2);
+    // the lowest index is returned for duplicate names
+    colorNode->SetColorName(1, "three");
+    CHECK_INT(colorNode->GetColorIndexByName("three"), 1);
+    colorNode->SetNumberOfColors(5);
+    CHECK_INT(colorNode->GetColorIndexByName(colorNode->GetNoName()), 3);
+  }
+
+  {
+    // the colors of a node with a deferred read are read on first access
+    vtkNew<vtkMRMLScene> scene;
+    vtkNew<vtkMRMLColorTableStorageNode> colorStorageNode;
+    scene->AddNode(colorStorageNode.GetPointer());
+    colorStorageNode->SetFileName(colorTableFileName.c_str());
+
+    vtkNew<vtkMRMLColorTableNode> colorNode;
+    colorNode->SetTypeToFile();
+    scene->AddNode(colorNode.GetPointer());
+    colorNode->SetAndObserveStorageNodeID(colorStorageNode->GetID());
+    colorNode->DeferredReadOn();
+
+    CHECK_BOOL(colorNode->GetModifiedSinceRead(), false);
+    CHECK_BOOL(colorNode->GetDeferredRead(), true);
+    CHECK_INT(colorNode->GetNumberOfColors(), 3);
+    CHECK_BOOL(colorNode->GetDeferredRead(), false);
+    CHECK_STRING(colorNode->GetColorName(1), "one")
+  }
+
+  {
+    // labels above 32K, spaces, DOS line endings and missing alpha
+    std::string largeColorTableFileName = std::string(tempDir) + "/vtkMRMLColorTableNodeTest1Large.ctbl";
+    std::ofstream largeColorTableFile(largeColorTableFileName.c_str(), std::ios::binary);
+    largeColorTableFile << "# Color table file\r\n"
+                        << "0 Background 0 0 0 0\r\n"
+                        << "\r\n"
+                        << "  12  'left_label'\t255 128 0 255\r\n"
+                        << "40000 right_label 0 0 255\n"
+                        << "65535 last_label 10 20 30 40";
+    largeColorTableFile.close();
+
+    vtkNew<vtkMRMLScene> scene;
+    vtkNew<vtkMRMLColorTableStorageNode> colorStorageNode;
+    scene->AddNode(colorStorageNode.GetPointer());
+    colorStorageNode->SetFileName(largeColorTableFileName.c_str());
+    vtkNew<vtkMRMLColorTableNode> colorNode;
+    scene->AddNode(colorNode.GetPointer());
+    CHECK_INT(colorStorageNode->ReadData(colorNode.GetPointer()), 1);
+
+    CHECK_INT(colorNode->GetNumberOfColors(), 65536);
+    CHECK_STRING(colorNode->GetColorName(12), "left label");
+    CHECK_STRING(colorNode->GetColorName(13), colorNode->GetNoName());
+    CHECK_INT(colorNode->GetColorIndexByName("right label"), 40000);
+    CHECK_INT(colorNode->GetColorIndexByName("last label"), 65535);
+    double color[4] = {0.0, 0.0, 0.0, 0.0};
+    CHECK_BOOL(colorNode->GetColor(12, color), true);
+    CHECK_BOOL(color[0] == 1.0 && color[1] == 128.0 / 255.0 && color[2] == 0.0 && color[3] == 1.0, true);
+    CHECK_BOOL(colorNode->GetColor(40000, color), true);
+    CHECK_BOOL(color[2] == 1.0 && color[3] == 0.0, true);
   }
 
   return EXIT_SUCCESS;
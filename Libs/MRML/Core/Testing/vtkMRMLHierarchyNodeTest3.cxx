@@ -18,6 +18,7 @@
 #include "vtkMRMLScene.h"
 
 // VTK includes
+#include <vtkCollection.h>
 #include <vtkNew.h>
 
 // STD includes
@@ -295,6 +296,39 @@ int vtkMRMLHierarchyNodeTest3(int , char * [] )
       }
     }
 
+  // cached maps are kept up-to-date when nodes are added and removed
+
+  // associated node added after the hierarchy node
+  vtkNew<vtkMRMLModelHierarchyNode> lateHierarchyNode;
+  scene->AddNode(lateHierarchyNode.GetPointer());
+  lateHierarchyNode->SetParentNodeID(hnode2->GetID());
+  vtkNew<vtkMRMLModelNode> lateModelNode;
+  lateModelNode->SetID("vtkMRMLModelNodeLate");
+  lateHierarchyNode->SetDisplayableNodeID("vtkMRMLModelNodeLate");
+  CHECK_POINTER(vtkMRMLHierarchyNode::GetAssociatedHierarchyNode(scene.GetPointer(), "vtkMRMLModelNodeLate"),
+    lateHierarchyNode.GetPointer());
+  scene->AddNode(lateModelNode.GetPointer());
+  CHECK_POINTER(vtkMRMLHierarchyNode::GetAssociatedHierarchyNode(scene.GetPointer(), lateModelNode->GetID()),
+    lateHierarchyNode.GetPointer());
+  CHECK_INT(hnode2->GetNumberOfChildrenNodes(), (int)numModels + 1);
+
+  vtkNew<vtkCollection> associatedChildren;
+  hnode1->GetAssociatedChildrenNodes(associatedChildren.GetPointer(), "vtkMRMLModelNode");
+  CHECK_INT(associatedChildren->GetNumberOfItems(), (int)numModels + 1);
+
+  // reparent
+  lateHierarchyNode->SetParentNodeID(hnode1->GetID());
+  CHECK_INT(hnode1->GetNumberOfChildrenNodes(), 2);
+  CHECK_INT(hnode2->GetNumberOfChildrenNodes(), (int)numModels);
+
+  // remove
+  scene->RemoveNode(lateHierarchyNode.GetPointer());
+  CHECK_NULL(vtkMRMLHierarchyNode::GetAssociatedHierarchyNode(scene.GetPointer(), lateModelNode->GetID()));
+  CHECK_INT(hnode1->GetNumberOfChildrenNodes(), 1);
+  associatedChildren->RemoveAllItems();
+  hnode1->GetAssociatedChildrenNodes(associatedChildren.GetPointer(), "vtkMRMLModelNode");
+  CHECK_INT(associatedChildren->GetNumberOfItems(), (int)numModels);
+
 
   return EXIT_SUCCESS;
 }
@@ -112,5 +112,48 @@ int vtkMRMLLinearTransformNodeEventsTest(int , char * [] )
     return EXIT_FAILURE;
     }
 
+  // Pending matrices are coalesced: no event until they are applied,
+  // then a single TransformModifiedEvent with the last matrix.
+  vtkNew<vtkMatrix4x4> pendingMatrix;
+  CHECK_BOOL(linearTransformNode->HasPendingMatrixTransformToParent(), false);
+  for (int i = 1; i <= 10; ++i)
+    {
+    pendingMatrix->SetElement(1, 3, i * 10.0);
+    linearTransformNode->SetPendingMatrixTransformToParent(pendingMatrix.GetPointer());
+    }
+  CHECK_BOOL(linearTransformNode->HasPendingMatrixTransformToParent(), true);
+  if (callback->GetNumberOfEvents(vtkMRMLTransformNode::TransformModifiedEvent) != 0)
+    {
+    std::cerr << "vtkMRMLLinearTransformNode::SetPendingMatrixTransformToParent invoked events" << std::endl;
+    return EXIT_FAILURE;
+    }
+  CHECK_BOOL(linearTransformNode->ApplyPendingMatrixTransformToParent(), true);
+  CHECK_BOOL(linearTransformNode->HasPendingMatrixTransformToParent(), false);
+  if (!callback->GetErrorString().empty() ||
+      callback->GetNumberOfEvents(vtkMRMLTransformNode::TransformModifiedEvent) != 1)
+    {
+    std::cerr << "vtkMRMLLinearTransformNode::ApplyPendingMatrixTransformToParent failed."
+              << callback->GetErrorString().c_str() << " "
+              << "Number of TransformModifiedEvent: "
+              << callback->GetNumberOfEvents(vtkMRMLTransformNode::TransformModifiedEvent)
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  linearTransformNode->GetMatrixTransformToParent(matrixRetrieved.GetPointer());
+  if (fabs(matrixRetrieved->GetElement(1, 3) - 100.0) > 0.001)
+    {
+    std::cerr << "ApplyPendingMatrixTransformToParent() did not apply the last matrix" << std::endl;
+    return EXIT_FAILURE;
+    }
+  callback->ResetNumberOfEvents();
+
+  // Nothing pending anymore
+  CHECK_BOOL(linearTransformNode->ApplyPendingMatrixTransformToParent(), false);
+  if (callback->GetNumberOfEvents(vtkMRMLTransformNode::TransformModifiedEvent) != 0)
+    {
+    std::cerr << "ApplyPendingMatrixTransformToParent() invoked an event without pending matrix" << std::endl;
+    return EXIT_FAILURE;
+    }
+
   return EXIT_SUCCESS;
 }
@@ -183,6 +183,7 @@ bool TestRemoveReferencedNodeID();
 bool TestRemoveReferencedNode();
 bool TestRemoveReferencingNode();
 bool TestNodeReferences();
+bool TestReferencesOfRemovedNode();
 bool TestReferenceModifiedEvent();
 bool TestReferencesWithEvent();
 bool TestMultipleReferencesToSameNodeWithEvent();
@@ -209,6 +210,7 @@ int vtkMRMLNodeTest1(int , char * [] )
   res = res && TestRemoveReferencedNode();
   res = res && TestRemoveReferencingNode();
   res = res && TestNodeReferences();
+  res = res && TestReferencesOfRemovedNode();
   res = res && TestReferenceModifiedEvent();
   res = res && TestReferencesWithEvent();
   res = res && TestMultipleReferencesToSameNodeWithEvent();
@@ -1621,6 +1623,66 @@ bool TestNodeReferences()
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool TestReferencesOfRemovedNode()
+{
+  std::string role1("refrole1");
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLNodeTestHelper1> nodeA;
+  scene->AddNode(nodeA.GetPointer());
+  vtkNew<vtkMRMLNodeTestHelper1> nodeB;
+  scene->AddNode(nodeB.GetPointer());
+  vtkNew<vtkMRMLNodeTestHelper1> nodeC;
+  scene->AddNode(nodeC.GetPointer());
+
+  // A -> B -> C
+  nodeA->AddNodeReferenceID(role1.c_str(), nodeB->GetID());
+  nodeB->AddNodeReferenceID(role1.c_str(), nodeC->GetID());
+
+  vtkSmartPointer<vtkCollection> referencedNodes;
+  referencedNodes.TakeReference(scene->GetReferencedNodes(nodeA.GetPointer()));
+  std::vector<vtkMRMLNode*> referencingNodes;
+  scene->GetReferencingNodes(nodeC.GetPointer(), referencingNodes);
+  if (referencedNodes->GetNumberOfItems() != 3 ||
+      referencedNodes->GetItemAsObject(2) != nodeC.GetPointer() ||
+      referencingNodes.size() != 1 || referencingNodes[0] != nodeB.GetPointer() ||
+      scene->GetNumberOfNodeReferences() != 2)
+    {
+    std::cerr << "Line " << __LINE__ << ": GetReferencedNodes failed: "
+              << referencedNodes->GetNumberOfItems() << " referenced nodes, "
+              << referencingNodes.size() << " referencing nodes, "
+              << scene->GetNumberOfNodeReferences() << " references" << std::endl;
+    return false;
+    }
+
+  // The references from and to the removed node are removed
+  scene->RemoveNode(nodeB.GetPointer());
+  referencedNodes.TakeReference(scene->GetReferencedNodes(nodeA.GetPointer()));
+  scene->GetReferencingNodes(nodeC.GetPointer(), referencingNodes);
+  if (referencedNodes->GetNumberOfItems() != 1 ||
+      referencingNodes.size() != 0 ||
+      scene->GetNumberOfNodeReferences() != 0)
+    {
+    std::cerr << "Line " << __LINE__ << ": RemoveNode failed: "
+              << referencedNodes->GetNumberOfItems() << " referenced nodes, "
+              << referencingNodes.size() << " referencing nodes, "
+              << scene->GetNumberOfNodeReferences() << " references" << std::endl;
+    return false;
+    }
+
+  nodeA->AddNodeReferenceID(role1.c_str(), nodeC->GetID());
+  referencedNodes.TakeReference(scene->GetReferencedNodes(nodeA.GetPointer()));
+  if (referencedNodes->GetNumberOfItems() != 2 ||
+      referencedNodes->GetItemAsObject(1) != nodeC.GetPointer())
+    {
+    std::cerr << "Line " << __LINE__ << ": AddNodeReferenceID failed: "
+              << referencedNodes->GetNumberOfItems() << " referenced nodes" << std::endl;
+    return false;
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 bool TestReferenceModifiedEvent()
 {
@@ -0,0 +1,110 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeDisplayNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <cmath>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Background at 0 and a cube of foreground voxels at foregroundValue
+void SetupImageData(vtkImageData* imageData, short foregroundValue)
+{
+  imageData->SetDimensions(16, 16, 16);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  short* ptr = static_cast<short*>(imageData->GetScalarPointer());
+  for (int z = 0; z < 16; ++z)
+    {
+    for (int y = 0; y < 16; ++y)
+      {
+      for (int x = 0; x < 16; ++x)
+        {
+        *(ptr++) = (x >= 4 && x < 12 && y >= 4 && y < 12 && z >= 4 && z < 12) ?
+          foregroundValue + (x % 2) : 0;
+        }
+      }
+    }
+  imageData->Modified();
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLScalarVolumeDisplayNodeTest2(int , char * [] )
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLScalarVolumeDisplayNode> displayNode;
+  scene->AddNode(displayNode.GetPointer());
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  scene->AddNode(volumeNode.GetPointer());
+  volumeNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+
+  vtkNew<vtkImageData> imageData;
+  SetupImageData(imageData.GetPointer(), 1000);
+  volumeNode->SetAndObserveImageData(imageData.GetPointer());
+
+  displayNode->AutoWindowLevelOn();
+  displayNode->AutoThresholdOn();
+  displayNode->Modified();
+  double window = displayNode->GetWindow();
+  double level = displayNode->GetLevel();
+  if (window <= 0. || level <= 0. || level > 1001.)
+    {
+    std::cerr << "Line " << __LINE__ << ": unexpected auto window/level: "
+              << window << " " << level << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Modifying the display node does not change the auto levels
+  displayNode->SetInterpolate(!displayNode->GetInterpolate());
+  if (displayNode->GetWindow() != window || displayNode->GetLevel() != level)
+    {
+    std::cerr << "Line " << __LINE__ << ": auto window/level changed without image change" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Modifying the image data updates the auto levels
+  SetupImageData(imageData.GetPointer(), 3000);
+  displayNode->Modified();
+  if (displayNode->GetLevel() <= level)
+    {
+    std::cerr << "Line " << __LINE__ << ": auto window/level not updated after image change: "
+              << displayNode->GetWindow() << " " << displayNode->GetLevel() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Subsampling the image gives a similar estimate
+  displayNode->SetAutoLevelsMaximumNumberOfSamples(0);
+  level = displayNode->GetLevel();
+  displayNode->SetAutoLevelsMaximumNumberOfSamples(512);
+  if (fabs(displayNode->GetLevel() - level) > 2.)
+    {
+    std::cerr << "Line " << __LINE__ << ": subsampled auto level " << displayNode->GetLevel()
+              << " differs from full resolution auto level " << level << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeNode.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <cmath>
+
+//----------------------------------------------------------------------------
+int vtkMRMLScalarVolumeNodeTest3(int , char * [] )
+{
+  // 8x8x1 image with the x index as value
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(8, 8, 1);
+  imageData->AllocateScalars(VTK_FLOAT, 1);
+  for (int y = 0; y < 8; y++)
+    {
+    for (int x = 0; x < 8; x++)
+      {
+      imageData->SetScalarComponentFromFloat(x, y, 0, 0, x);
+      }
+    }
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(imageData.GetPointer());
+
+  // pyramid is disabled by default
+  if (volumeNode->GetPyramidLevelImageData(1) != NULL ||
+      volumeNode->GetPyramidLevelForResolution(10.) != 0)
+    {
+    std::cerr << "Line " << __LINE__ << ": pyramid is expected to be disabled" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (volumeNode->GetPyramidLevelImageData(0) != imageData.GetPointer())
+    {
+    std::cerr << "Line " << __LINE__ << ": level 0 is expected to be the image data" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  volumeNode->SetMaximumPyramidLevel(2);
+  const double voxelsPerPixel[] = {0.5, 1., 1.9, 2., 3.9, 4., 100.};
+  const int expectedLevels[] = {0, 0, 0, 1, 1, 2, 2};
+  for (int i = 0; i < 7; i++)
+    {
+    if (volumeNode->GetPyramidLevelForResolution(voxelsPerPixel[i]) != expectedLevels[i])
+      {
+      std::cerr << "Line " << __LINE__ << ": level for " << voxelsPerPixel[i] << " voxels per pixel is "
+                << volumeNode->GetPyramidLevelForResolution(voxelsPerPixel[i])
+                << " instead of " << expectedLevels[i] << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  if (volumeNode->GetPyramidLevelImageData(3) != NULL)
+    {
+    std::cerr << "Line " << __LINE__ << ": level 3 is expected to be NULL" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkImageData* level1 = volumeNode->GetPyramidLevelImageData(1);
+  int* dimensions = level1 ? level1->GetDimensions() : NULL;
+  if (!level1 || dimensions[0] != 4 || dimensions[1] != 4 || dimensions[2] != 1)
+    {
+    std::cerr << "Line " << __LINE__ << ": unexpected level 1 dimensions" << std::endl;
+    return EXIT_FAILURE;
+    }
+  double* origin = level1->GetOrigin();
+  double* spacing = level1->GetSpacing();
+  if (origin[0] != 0.5 || origin[1] != 0.5 || origin[2] != 0. ||
+      spacing[0] != 2. || spacing[1] != 2. || spacing[2] != 1.)
+    {
+    std::cerr << "Line " << __LINE__ << ": unexpected level 1 geometry: origin "
+              << origin[0] << " " << origin[1] << " " << origin[2] << ", spacing "
+              << spacing[0] << " " << spacing[1] << " " << spacing[2] << std::endl;
+    return EXIT_FAILURE;
+    }
+  // voxel 1 averages the voxels 2 and 3 of the image data
+  if (fabs(level1->GetScalarComponentAsDouble(1, 0, 0, 0) - 2.5) > 1e-6)
+    {
+    std::cerr << "Line " << __LINE__ << ": level 1 value is "
+              << level1->GetScalarComponentAsDouble(1, 0, 0, 0) << " instead of 2.5" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkImageData* level2 = volumeNode->GetPyramidLevelImageData(2);
+  if (!level2 || level2->GetDimensions()[0] != 2 ||
+      level2->GetOrigin()[0] != 1.5 || level2->GetSpacing()[0] != 4. ||
+      fabs(level2->GetScalarComponentAsDouble(1, 0, 0, 0) - 5.5) > 1e-6)
+    {
+    std::cerr << "Line " << __LINE__ << ": unexpected level 2" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // levels are computed again when the image data is modified
+  imageData->GetPointData()->GetScalars()->FillComponent(0, 1.);
+  imageData->Modified();
+  level1 = volumeNode->GetPyramidLevelImageData(1);
+  if (!level1 || fabs(level1->GetScalarComponentAsDouble(1, 0, 0, 0) - 1.) > 1e-6)
+    {
+    std::cerr << "Line " << __LINE__ << ": level 1 is not updated after the image data is modified" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelDisplayNode.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSceneEventRecorder.h"
+#include "vtkMRMLSliceNode.h"
+
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <iostream>
+#include <vector>
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneAddNodesTest(int vtkNotUsed(argc), char * vtkNotUsed(argv) [] )
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  vtkNew<vtkMRMLSliceNode> redSlice;
+  redSlice->SetLayoutName("Red");
+  scene->AddNode(redSlice.GetPointer());
+
+  vtkNew<vtkMRMLSceneEventRecorder> callback;
+  scene->AddObserver(vtkCommand::AnyEvent, callback.GetPointer());
+
+  std::vector<vtkSmartPointer<vtkMRMLNode> > nodesToAdd;
+  const int numberOfModels = 100;
+  for (int i = 0; i < numberOfModels; ++i)
+    {
+    vtkNew<vtkMRMLModelNode> model;
+    vtkNew<vtkMRMLModelDisplayNode> display;
+    nodesToAdd.push_back(model.GetPointer());
+    nodesToAdd.push_back(display.GetPointer());
+    }
+  // Singleton that replaces an existing node: not notified as a new node
+  vtkNew<vtkMRMLSliceNode> redSlice2;
+  redSlice2->SetLayoutName("Red");
+  nodesToAdd.push_back(redSlice2.GetPointer());
+
+  std::vector<vtkMRMLNode*> nodes(nodesToAdd.begin(), nodesToAdd.end());
+  std::vector<vtkMRMLNode*> addedNodes;
+  CHECK_INT(scene->AddNodes(nodes, &addedNodes), 2 * numberOfModels);
+
+  CHECK_INT(static_cast<int>(addedNodes.size()), static_cast<int>(nodes.size()));
+  CHECK_POINTER(addedNodes.back(), redSlice.GetPointer());
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLModelNode"), numberOfModels);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLSliceNode"), 1);
+  for (int i = 0; i < 2 * numberOfModels; ++i)
+    {
+    CHECK_NOT_NULL(nodes[i]->GetID());
+    CHECK_POINTER(scene->GetNodeByID(nodes[i]->GetID()), nodes[i]);
+    }
+
+  // Only one event pair is fired for all the nodes
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodesAboutToBeAddedEvent], 1);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodesAddedEvent], 1);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodeAboutToBeAddedEvent], 0);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodeAddedEvent], 0);
+  callback->CalledEvents.clear();
+
+  // Collection signature
+  vtkNew<vtkCollection> collection;
+  for (int i = 0; i < 10; ++i)
+    {
+    vtkNew<vtkMRMLModelNode> model;
+    collection->AddItem(model.GetPointer());
+    }
+  vtkNew<vtkCollection> addedCollection;
+  CHECK_INT(scene->AddNodes(collection.GetPointer(), addedCollection.GetPointer()), 10);
+  CHECK_INT(addedCollection->GetNumberOfItems(), 10);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLModelNode"), numberOfModels + 10);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodesAddedEvent], 1);
+  callback->CalledEvents.clear();
+
+  // Empty list: no event
+  std::vector<vtkMRMLNode*> noNodes;
+  CHECK_INT(scene->AddNodes(noNodes), 0);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodesAboutToBeAddedEvent], 0);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodesAddedEvent], 0);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLModelStorageNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkCylinderSource.h>
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneDeferReadDataTest(int argc, char * argv[])
+{
+  if (argc != 2)
+    {
+    std::cerr << "Line " << __LINE__
+              << " - Missing parameters !\n"
+              << "Usage: " << argv[0] << " /path/to/temp"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string fileName = std::string(argv[1]) + "/vtkMRMLSceneDeferReadDataTest.vtk";
+
+  // Save a scene with a model
+  std::string sceneXML;
+  int numberOfPoints = 0;
+  {
+    vtkNew<vtkMRMLScene> scene;
+    vtkNew<vtkCylinderSource> cylinder;
+    cylinder->Update();
+    numberOfPoints = cylinder->GetOutput()->GetNumberOfPoints();
+
+    vtkNew<vtkMRMLModelNode> modelNode;
+    modelNode->SetAndObservePolyData(cylinder->GetOutput());
+    scene->AddNode(modelNode.GetPointer());
+    CHECK_BOOL(modelNode->AddDefaultStorageNode(), true);
+    vtkMRMLStorageNode* storageNode = modelNode->GetStorageNode();
+    CHECK_NOT_NULL(storageNode);
+    storageNode->SetFileName(fileName.c_str());
+    CHECK_BOOL(storageNode->WriteData(modelNode.GetPointer()), true);
+
+    scene->SetSaveToXMLString(1);
+    CHECK_BOOL(scene->Commit() != 0, true);
+    sceneXML = scene->GetSceneXMLString();
+  }
+
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetLoadFromXMLString(1);
+  scene->SetSceneXMLString(sceneXML);
+
+  // The data is read during the import by default
+  CHECK_INT(scene->GetDeferReadDataOnLoad(), 0);
+  CHECK_BOOL(scene->Import() != 0, true);
+  CHECK_INT(scene->GetNumberOfDeferredReadDataNodes(), 0);
+  vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(
+    scene->GetFirstNodeByClass("vtkMRMLModelNode"));
+  CHECK_NOT_NULL(modelNode);
+  CHECK_NOT_NULL(modelNode->GetMesh());
+
+  // The data is read after the import when deferred
+  scene->Clear(0);
+  scene->DeferReadDataOnLoadOn();
+  CHECK_BOOL(scene->Import() != 0, true);
+  CHECK_INT(scene->GetNumberOfDeferredReadDataNodes(), 1);
+  modelNode = vtkMRMLModelNode::SafeDownCast(
+    scene->GetFirstNodeByClass("vtkMRMLModelNode"));
+  CHECK_NOT_NULL(modelNode);
+  CHECK_NULL(modelNode->GetMesh());
+  CHECK_INT(scene->ReadNextDeferredData(), 0);
+  CHECK_NOT_NULL(modelNode->GetMesh());
+  CHECK_INT(modelNode->GetMesh()->GetNumberOfPoints(), numberOfPoints);
+  CHECK_INT(scene->ReadNextDeferredData(), 0);
+
+  // Closing the scene drops the data that is not read yet
+  scene->Clear(0);
+  CHECK_BOOL(scene->Import() != 0, true);
+  CHECK_INT(scene->GetNumberOfDeferredReadDataNodes(), 1);
+  scene->Clear(0);
+  CHECK_INT(scene->GetNumberOfDeferredReadDataNodes(), 0);
+
+  return EXIT_SUCCESS;
+}
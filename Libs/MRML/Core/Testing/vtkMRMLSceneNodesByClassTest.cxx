@@ -0,0 +1,169 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLLinearTransformNode.h"
+#include "vtkMRMLModelDisplayNode.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+// Reference implementation: scan all the nodes of the scene.
+std::vector<vtkMRMLNode*> ScanNodesByClass(vtkMRMLScene* scene, const char* className)
+{
+  std::vector<vtkMRMLNode*> nodes;
+  for (int i = 0; i < scene->GetNumberOfNodes(); ++i)
+    {
+    vtkMRMLNode* node = scene->GetNthNode(i);
+    if (node->IsA(className))
+      {
+      nodes.push_back(node);
+      }
+    }
+  return nodes;
+}
+
+//---------------------------------------------------------------------------
+bool CheckNodesByClass(vtkMRMLScene* scene, const char* className, int line)
+{
+  std::vector<vtkMRMLNode*> expectedNodes = ScanNodesByClass(scene, className);
+  std::vector<vtkMRMLNode*> nodes;
+  scene->GetNodesByClass(className, nodes);
+  if (nodes != expectedNodes)
+    {
+    std::cerr << "Line " << line << ": GetNodesByClass(" << className << ") failed: "
+              << nodes.size() << " nodes instead of " << expectedNodes.size() << std::endl;
+    return false;
+    }
+  if (scene->GetNumberOfNodesByClass(className) != static_cast<int>(expectedNodes.size()))
+    {
+    std::cerr << "Line " << line << ": GetNumberOfNodesByClass(" << className << ") failed: "
+              << scene->GetNumberOfNodesByClass(className) << " instead of "
+              << expectedNodes.size() << std::endl;
+    return false;
+    }
+  for (int i = 0; i < static_cast<int>(expectedNodes.size()); ++i)
+    {
+    if (scene->GetNthNodeByClass(i, className) != expectedNodes[i])
+      {
+      std::cerr << "Line " << line << ": GetNthNodeByClass(" << i << ", " << className
+                << ") failed" << std::endl;
+      return false;
+      }
+    }
+  if (scene->GetNthNodeByClass(static_cast<int>(expectedNodes.size()), className) != 0)
+    {
+    std::cerr << "Line " << line << ": GetNthNodeByClass(" << expectedNodes.size()
+              << ", " << className << ") should be null" << std::endl;
+    return false;
+    }
+  vtkSmartPointer<vtkCollection> collection;
+  collection.TakeReference(scene->GetNodesByClass(className));
+  if (collection->GetNumberOfItems() != static_cast<int>(expectedNodes.size()))
+    {
+    std::cerr << "Line " << line << ": GetNodesByClass(" << className
+              << ") collection failed" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+bool CheckAllClasses(vtkMRMLScene* scene, int line)
+{
+  const char* classNames[] = {
+    "vtkMRMLNode", "vtkMRMLDisplayableNode", "vtkMRMLModelNode",
+    "vtkMRMLVolumeNode", "vtkMRMLScalarVolumeNode", "vtkMRMLTransformNode",
+    "vtkMRMLDisplayNode", "vtkMRMLModelDisplayNode", "vtkMRMLCameraNode" };
+  for (unsigned int i = 0; i < sizeof(classNames) / sizeof(classNames[0]); ++i)
+    {
+    if (!CheckNodesByClass(scene, classNames[i], line))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneNodesByClassTest(int vtkNotUsed(argc), char * vtkNotUsed(argv) [] )
+{
+  vtkNew<vtkMRMLScene> scene;
+  CHECK_BOOL(CheckAllClasses(scene.GetPointer(), __LINE__), true);
+
+  // Query before adding nodes to make sure the lists are kept up to date
+  std::vector<vtkSmartPointer<vtkMRMLNode> > nodes;
+  for (int i = 0; i < 10; ++i)
+    {
+    vtkNew<vtkMRMLModelNode> model;
+    scene->AddNode(model.GetPointer());
+    vtkNew<vtkMRMLModelDisplayNode> display;
+    scene->AddNode(display.GetPointer());
+    vtkNew<vtkMRMLScalarVolumeNode> volume;
+    scene->AddNode(volume.GetPointer());
+    vtkNew<vtkMRMLLinearTransformNode> transform;
+    scene->AddNode(transform.GetPointer());
+    nodes.push_back(model.GetPointer());
+    nodes.push_back(display.GetPointer());
+    nodes.push_back(volume.GetPointer());
+    nodes.push_back(transform.GetPointer());
+    }
+  CHECK_BOOL(CheckAllClasses(scene.GetPointer(), __LINE__), true);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLModelNode"), 10);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLDisplayableNode"), 20);
+
+  // Removal
+  scene->RemoveNode(nodes[0]);
+  scene->RemoveNode(nodes[6]);
+  CHECK_BOOL(CheckAllClasses(scene.GetPointer(), __LINE__), true);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLModelNode"), 9);
+
+  // Insertion at a given position must keep the scene order
+  vtkNew<vtkMRMLModelNode> insertedModel;
+  scene->InsertBeforeNode(nodes[1], insertedModel.GetPointer());
+  CHECK_BOOL(CheckAllClasses(scene.GetPointer(), __LINE__), true);
+  CHECK_POINTER(scene->GetNthNodeByClass(0, "vtkMRMLModelNode"), insertedModel.GetPointer());
+
+  // Name filtering
+  insertedModel->SetName("InsertedModel");
+  vtkSmartPointer<vtkCollection> namedNodes;
+  namedNodes.TakeReference(scene->GetNodesByClassByName("vtkMRMLDisplayableNode", "InsertedModel"));
+  CHECK_INT(namedNodes->GetNumberOfItems(), 1);
+  namedNodes.TakeReference(scene->GetNodesByClassByName("vtkMRMLVolumeNode", "InsertedModel"));
+  CHECK_INT(namedNodes->GetNumberOfItems(), 0);
+
+  // Clear
+  scene->Clear(1);
+  CHECK_BOOL(CheckAllClasses(scene.GetPointer(), __LINE__), true);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLModelNode"), 0);
+
+  return EXIT_SUCCESS;
+}
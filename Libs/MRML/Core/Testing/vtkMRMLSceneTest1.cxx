@@ -365,5 +365,56 @@ int vtkMRMLSceneTest1(int , char * [] )
       }
   }
 
+  //---------------------------------------------------------------------------
+  // Test that Commit() writes modified nodes again
+  //---------------------------------------------------------------------------
+
+  {
+    scene1->SetSaveToXMLString(1);
+    scene1->Commit();
+    std::string sceneXML = scene1->GetSceneXMLString();
+    scene1->Commit();
+    if (scene1->GetSceneXMLString() != sceneXML)
+      {
+      std::cerr << "Line " << __LINE__ << " - Problem with Commit(): "
+                << "unmodified scene is saved differently" << std::endl;
+      return EXIT_FAILURE;
+      }
+    node3->SetName("RenamedNode");
+    scene1->Commit();
+    if (scene1->GetSceneXMLString().find("RenamedNode") == std::string::npos)
+      {
+      std::cerr << "Line " << __LINE__ << " - Problem with Commit(): "
+                << "modified node is not saved" << std::endl;
+      return EXIT_FAILURE;
+      }
+    node3->SetName("Node");
+    scene1->SetSaveToXMLString(0);
+  }
+
+  //---------------------------------------------------------------------------
+  // Test lookup of registered node classes
+  //---------------------------------------------------------------------------
+
+  {
+    vtkNew<vtkMRMLScene> scene2;
+    vtkNew<vtkMRMLCustomNode> customNode;
+    scene2->RegisterNodeClass(customNode.GetPointer());
+    CHECK_STRING(scene2->GetClassNameByTag("Custom"), "vtkMRMLCustomNode");
+    CHECK_STRING(scene2->GetTagByClassName("vtkMRMLCustomNode"), "Custom");
+    CHECK_NULL(scene2->GetClassNameByTag("AnotherCustom"));
+
+    // Registering another class with the same tag replaces the previous one
+    vtkNew<vtkMRMLAnotherCustomNode> anotherCustomNode;
+    scene2->RegisterNodeClass(anotherCustomNode.GetPointer(), "Custom");
+    CHECK_STRING(scene2->GetClassNameByTag("Custom"), "vtkMRMLAnotherCustomNode");
+    CHECK_NULL(scene2->GetTagByClassName("vtkMRMLCustomNode"));
+    CHECK_NULL(scene2->CreateNodeByClass("vtkMRMLCustomNode"));
+
+    vtkSmartPointer<vtkMRMLNode> createdNode;
+    createdNode.TakeReference(scene2->CreateNodeByClass("vtkMRMLAnotherCustomNode"));
+    CHECK_NOT_NULL(vtkMRMLAnotherCustomNode::SafeDownCast(createdNode));
+  }
+
   return EXIT_SUCCESS;
 }
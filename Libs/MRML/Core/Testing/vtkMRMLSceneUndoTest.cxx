@@ -0,0 +1,115 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <iostream>
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneUndoTest(int vtkNotUsed(argc), char * vtkNotUsed(argv) [] )
+{
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetUndoOn();
+
+  vtkNew<vtkMRMLModelNode> model;
+  model->SetName("Model");
+  scene->AddNode(model.GetPointer());
+
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(64, 64, 64);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  vtkNew<vtkMRMLScalarVolumeNode> volume;
+  volume->SetName("Volume");
+  volume->SetAndObserveImageData(imageData.GetPointer());
+  scene->AddNode(volume.GetPointer());
+
+  //---------------------------------------------------------------------------
+  // Undo/Redo of a node modification
+  //---------------------------------------------------------------------------
+  scene->SaveStateForUndo(model.GetPointer());
+  model->SetName("Model2");
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 1);
+  scene->Undo();
+  CHECK_STRING(model->GetName(), "Model");
+  CHECK_INT(scene->GetNumberOfRedoLevels(), 1);
+  scene->Redo();
+  CHECK_STRING(model->GetName(), "Model2");
+
+  // Image data is shared with the scene, it is not counted
+  scene->ClearUndoStack();
+  scene->ClearRedoStack();
+  scene->SaveStateForUndo(volume.GetPointer());
+  CHECK_BOOL(scene->GetUndoMemorySize() < 64 * 64 * 64 * 2, true);
+
+  //---------------------------------------------------------------------------
+  // Number of levels limit
+  //---------------------------------------------------------------------------
+  scene->ClearUndoStack();
+  scene->SetUndoStackSize(3);
+  for (int i = 0; i < 10; ++i)
+    {
+    scene->SaveStateForUndo(model.GetPointer());
+    model->SetName("Model3");
+    }
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 3);
+  scene->SetUndoStackSize(100);
+
+  //---------------------------------------------------------------------------
+  // Unmodified nodes share the state saved in the previous level
+  //---------------------------------------------------------------------------
+  scene->ClearUndoStack();
+  scene->SaveStateForUndo();
+  vtkIdType memorySize = scene->GetUndoMemorySize();
+  scene->SaveStateForUndo();
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 3);
+  CHECK_INT(scene->GetUndoMemorySize(), memorySize);
+
+  //---------------------------------------------------------------------------
+  // Memory budget
+  //---------------------------------------------------------------------------
+  // Each saved state holds an image (512kB) that is no longer in the scene
+  // (except the last saved state that shares the image with the scene),
+  // only 3 levels fit in the budget.
+  scene->ClearUndoStack();
+  scene->SetUndoMemoryBudget(1300 * 1024);
+  CHECK_INT(scene->GetUndoMemoryBudget(), 1300 * 1024);
+  for (int i = 0; i < 5; ++i)
+    {
+    scene->SaveStateForUndo(volume.GetPointer());
+    CHECK_BOOL(scene->GetUndoMemorySize() <= scene->GetUndoMemoryBudget(), true);
+    vtkNew<vtkImageData> newImageData;
+    newImageData->SetDimensions(64, 64, 64);
+    newImageData->AllocateScalars(VTK_SHORT, 1);
+    volume->SetAndObserveImageData(newImageData.GetPointer());
+    }
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 3);
+
+  // The last saved state can be restored
+  vtkImageData* lastImageData = volume->GetImageData();
+  scene->Undo();
+  CHECK_POINTER_DIFFERENT(volume->GetImageData(), lastImageData);
+
+  return EXIT_SUCCESS;
+}
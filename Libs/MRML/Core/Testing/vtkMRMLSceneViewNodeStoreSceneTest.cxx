@@ -41,6 +41,7 @@ int storeAndRemoveVolume();
 int storeTwice();
 int storeAndRestoreTwice();
 int storeTwiceAndRemoveVolume();
+int storeAndRestoreModifiedNodes();
 int references();
 int storePerformance();
 
@@ -56,6 +57,7 @@ int vtkMRMLSceneViewNodeStoreSceneTest(int vtkNotUsed(argc),
   CHECK_EXIT_SUCCESS(storeTwice());
   CHECK_EXIT_SUCCESS(storeAndRestoreTwice());
   CHECK_EXIT_SUCCESS(storeTwiceAndRemoveVolume());
+  CHECK_EXIT_SUCCESS(storeAndRestoreModifiedNodes());
   CHECK_EXIT_SUCCESS(references());
   CHECK_EXIT_SUCCESS(storePerformance());
   return EXIT_SUCCESS;
@@ -235,6 +237,49 @@ int storeTwiceAndRemoveVolume()
   return EXIT_SUCCESS;
 }
 
+//---------------------------------------------------------------------------
+int storeAndRestoreModifiedNodes()
+{
+  vtkNew<vtkMRMLScene> scene;
+  populateScene(scene.GetPointer());
+
+  vtkNew<vtkMRMLSceneViewNode> sceneViewNode;
+  scene->AddNode(sceneViewNode.GetPointer());
+
+  vtkMRMLNode* volumeNode = scene->GetNodeByID("vtkMRMLScalarVolumeNode1");
+  vtkMRMLNode* displayNode = scene->GetNodeByID("vtkMRMLScalarVolumeDisplayNode1");
+  volumeNode->SetName("Original");
+
+  sceneViewNode->StoreScene();
+
+  vtkMRMLScene* storedScene = sceneViewNode->GetStoredScene();
+  vtkMRMLNode* storedVolumeNode = storedScene->GetNodeByID("vtkMRMLScalarVolumeNode1");
+  vtkMRMLNode* storedDisplayNode = storedScene->GetNodeByID("vtkMRMLScalarVolumeDisplayNode1");
+  vtkMTimeType storedDisplayNodeMTime = storedDisplayNode->GetMTime();
+
+  // Storing again keeps the stored nodes and only updates the modified ones.
+  volumeNode->SetName("Modified");
+  sceneViewNode->StoreScene();
+  CHECK_POINTER(storedScene->GetNodeByID("vtkMRMLScalarVolumeNode1"), storedVolumeNode);
+  CHECK_POINTER(storedScene->GetNodeByID("vtkMRMLScalarVolumeDisplayNode1"), storedDisplayNode);
+  CHECK_STRING(storedVolumeNode->GetName(), "Modified");
+  CHECK_BOOL(storedDisplayNode->GetMTime() == storedDisplayNodeMTime, true);
+
+  // Restoring copies the nodes modified since the last store.
+  volumeNode->SetName("Modified again");
+  sceneViewNode->RestoreScene();
+  CHECK_POINTER(scene->GetNodeByID("vtkMRMLScalarVolumeNode1"), volumeNode);
+  CHECK_STRING(volumeNode->GetName(), "Modified");
+
+  // Nodes removed from the scene are removed from the stored scene.
+  scene->RemoveNode(displayNode);
+  sceneViewNode->StoreScene();
+  CHECK_NULL(storedScene->GetNodeByID("vtkMRMLScalarVolumeDisplayNode1"));
+  CHECK_POINTER(storedScene->GetNodeByID("vtkMRMLScalarVolumeNode1"), storedVolumeNode);
+
+  return EXIT_SUCCESS;
+}
+
 //---------------------------------------------------------------------------
 int references()
 {
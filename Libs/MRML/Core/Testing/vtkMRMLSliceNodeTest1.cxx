@@ -32,6 +32,7 @@ int GetSliceOrientationPresetTest();
 int GetSliceOrientationPresetNameTest();
 int SetOrientationTest();
 int InitializeDefaultMatrixTest();
+int JumpSliceByOffsettingTest();
 
 //----------------------------------------------------------------------------
 int vtkMRMLSliceNodeTest1(int , char * [] )
@@ -48,6 +49,7 @@ int vtkMRMLSliceNodeTest1(int , char * [] )
   CHECK_EXIT_SUCCESS(GetSliceOrientationPresetNameTest());
   CHECK_EXIT_SUCCESS(SetOrientationTest());
   CHECK_EXIT_SUCCESS(InitializeDefaultMatrixTest());
+  CHECK_EXIT_SUCCESS(JumpSliceByOffsettingTest());
 
   return EXIT_SUCCESS;
 }
@@ -426,3 +428,22 @@ int InitializeDefaultMatrixTest()
 
   return EXIT_SUCCESS;
 }
+
+//----------------------------------------------------------------------------
+int JumpSliceByOffsettingTest()
+{
+  vtkNew<vtkMRMLSliceNode> sliceNode;
+  sliceNode->UpdateMatrices();
+
+  // jumping to a point of the slice plane doesn't modify the node
+  vtkMTimeType mtime = sliceNode->GetMTime();
+  sliceNode->JumpSliceByOffsetting(10., 20., 0.);
+  CHECK_BOOL(sliceNode->GetMTime() == mtime, true);
+
+  sliceNode->JumpSliceByOffsetting(10., 20., 5.);
+  CHECK_BOOL(sliceNode->GetMTime() > mtime, true);
+  CHECK_DOUBLE(sliceNode->GetSliceToRAS()->GetElement(2, 3), 5.);
+  CHECK_DOUBLE(sliceNode->GetSliceToRAS()->GetElement(0, 3), 0.);
+
+  return EXIT_SUCCESS;
+}
@@ -111,6 +111,37 @@ int vtkMRMLTableSQLiteStorageNodeTest(int , char * [] )
     return EXIT_FAILURE;
     }
 
+  // read a page of the table
+  if (storageNode->GetNumberOfRowsInDatabase() != numPoints)
+    {
+    std::cerr << "Unexpected number of rows in the database " << storageNode->GetFileName() <<std::endl;
+    removeFile(storageNode->GetFileName());
+    return EXIT_FAILURE;
+    }
+  storageNode->SetRowOffset(10);
+  storageNode->SetNumberOfRowsToRead(5);
+  storageNode->ReadData(tableNode.GetPointer());
+  if (tableNode->GetNumberOfRows() != 5
+    || fabs(tableNode->GetTable()->GetValue(0, 0).ToDouble() - 10 * inc) > 1e-4)
+    {
+    std::cerr << "Unable to read table page from the database " << storageNode->GetFileName() <<std::endl;
+    removeFile(storageNode->GetFileName());
+    return EXIT_FAILURE;
+    }
+
+  // column statistics computed in the database
+  vtkIdType count = 0;
+  double minimum = 0.0;
+  double maximum = 0.0;
+  double mean = 0.0;
+  if (!storageNode->GetColumnStatistics("X_Axis", count, minimum, maximum, mean)
+    || count != numPoints || fabs(minimum) > 1e-4 || fabs(maximum - 7.0) > 1e-4 || fabs(mean - 3.5) > 1e-4)
+    {
+    std::cerr << "Unexpected column statistics in the database " << storageNode->GetFileName() <<std::endl;
+    removeFile(storageNode->GetFileName());
+    return EXIT_FAILURE;
+    }
+
   // clean up
   removeFile(storageNode->GetFileName());
 
@@ -21,11 +21,67 @@
 ==============================================================================*/
 
 #include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLTableNode.h"
 #include "vtkMRMLTableStorageNode.h"
 
-int vtkMRMLTableStorageNodeTest1(int , char * [] )
+// VTK includes
+#include <vtkBitArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIntArray.h>
+#include <vtkStringArray.h>
+#include <vtkTable.h>
+
+// STD includes
+#include <fstream>
+
+int vtkMRMLTableStorageNodeTest1(int argc, char * argv[] )
 {
   vtkNew<vtkMRMLTableStorageNode> node1;
   EXERCISE_ALL_BASIC_MRML_METHODS(node1.GetPointer());
+
+  if (argc != 2)
+    {
+    std::cerr << "Line " << __LINE__
+              << " - Missing parameters !\n"
+              << "Usage: " << argv[0] << " /path/to/temp"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Columns with type specifiers are read into typed arrays
+  std::string tableFileName = std::string(argv[1]) + "/vtkMRMLTableStorageNodeTest1.tsv";
+  {
+    std::ofstream tableFile(tableFileName.c_str());
+    tableFile << "Name\tCount[type=int]\tVolume[type=double]\tValid[type=bool]\n";
+    tableFile << "first\t3\t1.5\t1\n";
+    tableFile << "second\t-12\t0.25\t0\n";
+  }
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLTableNode> tableNode;
+  scene->AddNode(tableNode.GetPointer());
+  vtkNew<vtkMRMLTableStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  tableNode->SetAndObserveStorageNodeID(storageNode->GetID());
+  storageNode->SetFileName(tableFileName.c_str());
+  CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()) != 0, true);
+
+  vtkTable* table = tableNode->GetTable();
+  CHECK_NOT_NULL(table);
+  CHECK_INT(table->GetNumberOfColumns(), 4);
+  CHECK_INT(table->GetNumberOfRows(), 2);
+  CHECK_NOT_NULL(vtkStringArray::SafeDownCast(table->GetColumnByName("Name")));
+  vtkIntArray* countColumn = vtkIntArray::SafeDownCast(table->GetColumnByName("Count"));
+  CHECK_NOT_NULL(countColumn);
+  CHECK_INT(countColumn->GetValue(1), -12);
+  vtkDoubleArray* volumeColumn = vtkDoubleArray::SafeDownCast(table->GetColumnByName("Volume"));
+  CHECK_NOT_NULL(volumeColumn);
+  CHECK_DOUBLE(volumeColumn->GetValue(0), 1.5);
+  vtkBitArray* validColumn = vtkBitArray::SafeDownCast(table->GetColumnByName("Valid"));
+  CHECK_NOT_NULL(validColumn);
+  CHECK_INT(validColumn->GetValue(0), 1);
+  CHECK_INT(validColumn->GetValue(1), 0);
+
   return EXIT_SUCCESS;
 }
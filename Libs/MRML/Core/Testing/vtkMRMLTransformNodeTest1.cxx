@@ -157,6 +157,21 @@ int vtkMRMLTransformNodeTest1(int , char * [] )
     return EXIT_FAILURE;
     }
 
+  // Cached transform to world is updated when a parent transform changes
+  vtkSmartPointer<vtkMatrix4x4> c_from_d_mx2 = vtkSmartPointer<vtkMatrix4x4>::Take(CreateTransformMatrix( 4, 13, -5, 61, -17, 3));
+  dTransform->SetMatrixTransformToParent(c_from_d_mx2.GetPointer());
+  vtkNew<vtkMatrix4x4> w_from_e_mx2;
+  vtkMatrix4x4::Multiply4x4(c_from_d_mx2.GetPointer(), d_from_e_mx.GetPointer(), w_from_e_mx2.GetPointer());
+  vtkMatrix4x4::Multiply4x4(b_from_c_mx.GetPointer(), w_from_e_mx2.GetPointer(), w_from_e_mx2.GetPointer());
+  vtkMatrix4x4::Multiply4x4(w_from_b_mx.GetPointer(), w_from_e_mx2.GetPointer(), w_from_e_mx2.GetPointer());
+  eTransform->GetMatrixTransformToWorld(test_mx.GetPointer());
+  if (!MatrixAreEqual(w_from_e_mx2.GetPointer(), test_mx.GetPointer()))
+    {
+    std::cerr << __LINE__ << " vtkMRMLTransformNodeTest1 failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  dTransform->SetMatrixTransformToParent(c_from_d_mx.GetPointer());
+
   // Test when there is a nonlinear transform above the common parent of two transform nodes.
   // Transform to world is nonlinear but the relative transform is linear.
   vtkNew<vtkMRMLBSplineTransformNode> nonlinearTransform;
@@ -178,6 +193,11 @@ int vtkMRMLTransformNodeTest1(int , char * [] )
     std::cerr << __LINE__ << " vtkMRMLTransformNodeTest1 failed" << std::endl;
     return EXIT_FAILURE;
     }
+  if (eTransform->IsTransformToWorldLinear())
+    {
+    std::cerr << __LINE__ << " vtkMRMLTransformNodeTest1 failed" << std::endl;
+    return EXIT_FAILURE;
+    }
   if (rTransform->GetFirstCommonParent(dTransform.GetPointer()) != bTransform.GetPointer())
     {
     std::cerr << __LINE__ << " vtkMRMLTransformNodeTest1 failed" << std::endl;
@@ -17,5 +17,9 @@ int vtkMRMLVolumeArchetypeStorageNodeTest1(int , char * [] )
 {
   vtkNew<vtkMRMLVolumeArchetypeStorageNode> node1;
   EXERCISE_ALL_BASIC_MRML_METHODS(node1.GetPointer());
+
+  TEST_SET_GET_BOOLEAN(node1.GetPointer(), StreamingRead);
+  TEST_SET_GET_DOUBLE(node1.GetPointer(), StreamingUpdateInterval, 0.5);
+
   return EXIT_SUCCESS;
 }
@@ -175,6 +175,47 @@ int vtkMRMLVolumeNodeEventsTest(int , char * [] )
     }
   callback->ResetNumberOfEvents();
 
+  // Replace image data, the connection is kept
+  vtkAlgorithmOutput* imageDataConnection = volumeNode->GetImageDataConnection();
+  vtkNew<vtkImageData> imageData3;
+  volumeNode->ReplaceImageData(imageData3.GetPointer());
+
+  if (!callback->GetErrorString().empty() ||
+      callback->GetNumberOfEvents(vtkCommand::ModifiedEvent) != 0 ||
+      callback->GetNumberOfEvents(vtkMRMLVolumeNode::ImageDataModifiedEvent) != 1 ||
+      volumeNode->GetImageDataConnection() != imageDataConnection ||
+      volumeNode->GetImageData() != imageData3.GetPointer())
+    {
+    std::cerr << __LINE__ << ": vtkMRMLVolumeNode::ReplaceImageData failed: "
+              << callback->GetErrorString().c_str() << " "
+              << "Number of ModifiedEvent: "
+              << callback->GetNumberOfEvents(vtkCommand::ModifiedEvent) << " "
+              << "Number of ImageDataModifiedEvent: "
+              << callback->GetNumberOfEvents(vtkMRMLVolumeNode::ImageDataModifiedEvent)
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  callback->ResetNumberOfEvents();
+
+  // Only the replacing image data is observed
+  imageData2->Modified();
+  imageData3->Modified();
+
+  if (!callback->GetErrorString().empty() ||
+      callback->GetNumberOfEvents(vtkCommand::ModifiedEvent) != 0 ||
+      callback->GetNumberOfEvents(vtkMRMLVolumeNode::ImageDataModifiedEvent) != 1)
+    {
+    std::cerr << __LINE__ << ": vtkMRMLVolumeNode::ReplaceImageData failed: "
+              << callback->GetErrorString().c_str() << " "
+              << "Number of ModifiedEvent: "
+              << callback->GetNumberOfEvents(vtkCommand::ModifiedEvent) << " "
+              << "Number of ImageDataModifiedEvent: "
+              << callback->GetNumberOfEvents(vtkMRMLVolumeNode::ImageDataModifiedEvent)
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  callback->ResetNumberOfEvents();
+
   // Clear image data
   volumeNode->SetAndObserveImageData(0);
 
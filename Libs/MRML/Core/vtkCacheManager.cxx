@@ -5,11 +5,18 @@
 #include "vtkMRMLStorageNode.h"
 
 #include <vtksys/Directory.hxx>
+#include <vtksys/MD5.h>
 #include <vtksys/SystemTools.hxx>
 
 #include <vtkCallbackCommand.h>
+#include <vtkMutexLock.h>
 #include <vtkObjectFactory.h>
 
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
 vtkStandardNewMacro ( vtkCacheManager );
 
 #define MB 1000000.0
@@ -25,9 +32,13 @@ vtkCacheManager::vtkCacheManager()
   this->RemoteCacheFreeBufferSize = 10;
   this->CurrentCacheSize = 0;
   this->EnableForceRedownload = 0;
+  this->EnableCacheEviction = 1;
   this->InsufficientFreeBufferNotificationFlag = 0;
   // this->EnableRemoteCacheOverwriting = 1;
   this->uriMap.clear();
+  this->NumberOfCacheHits = 0;
+  this->NumberOfCacheMisses = 0;
+  this->CacheIndexLock = vtkSimpleMutexLock::New();
 }
 
 
@@ -48,6 +59,8 @@ vtkCacheManager::~vtkCacheManager()
   this->EnableForceRedownload = 0;
   this->InsufficientFreeBufferNotificationFlag = 0;
 //  this->EnableRemoteCacheOverwriting = 1;
+  this->CacheIndex.clear();
+  this->CacheIndexLock->Delete();
 }
 
 
@@ -55,15 +68,18 @@ vtkCacheManager::~vtkCacheManager()
 const char* vtkCacheManager::GetFileFromURIMap (const char *uri )
 {
   std::string uriString (uri);
+  const char *fileName = NULL;
 
+  this->CacheIndexLock->Lock();
     //--- URI is first, local name is second
     std::map<std::string, std::string>::iterator iter = this->uriMap.find(uriString);
     if (iter != this->uriMap.end() )
       {
-      return iter->second.c_str();
+      fileName = iter->second.c_str();
       }
+  this->CacheIndexLock->Unlock();
 
-  return NULL;
+  return fileName;
 }
 
 
@@ -84,6 +100,7 @@ void vtkCacheManager::MapFileToURI ( const char *uri, const char *fname )
 
     //--- URI is first, local name is second
   int added = 0;
+  this->CacheIndexLock->Lock();
   for (iter = this->uriMap.begin();
        iter != this->uriMap.end();
        iter++)
@@ -97,6 +114,10 @@ void vtkCacheManager::MapFileToURI ( const char *uri, const char *fname )
   if ( !added )
     {
     this->uriMap.insert (std::make_pair (remote, local ));
+    }
+  this->CacheIndexLock->Unlock();
+  if ( !added )
+    {
     this->Modified();
     }
 }
@@ -133,6 +154,8 @@ void vtkCacheManager::SetRemoteCacheDirectory (const char *dir )
     {
     vtksys::SystemTools::MakeDirectory(this->RemoteCacheDirectory.c_str());
     }
+  // restore the access times and URI mapping of the previous sessions
+  this->ReadCacheIndex();
   // scan files in cache, it calls Modified
   this->UpdateCacheInformation();
 }
@@ -254,6 +277,9 @@ void vtkCacheManager::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "RemoteCacheFreeBufferSize: " << this->GetRemoteCacheFreeBufferSize() << "\n";
   //os << indent << "EnableRemoteCacheOverwriting: " << this->GetEnableRemoteCacheOverwriting() << "\n";
   os << indent << "EnableForceRedownload: " << this->GetEnableForceRedownload() << "\n";
+  os << indent << "EnableCacheEviction: " << this->GetEnableCacheEviction() << "\n";
+  os << indent << "NumberOfCacheHits: " << this->NumberOfCacheHits << "\n";
+  os << indent << "NumberOfCacheMisses: " << this->NumberOfCacheMisses << "\n";
 }
 
 
@@ -307,7 +333,8 @@ int vtkCacheManager::GetCachedFileList ( const char *dirname )
               return (0);
               }
             }
-          else
+          else if ( strcmp(dir.GetFile(static_cast<unsigned long>(fileNum)),
+                           vtkCacheManager::GetCacheIndexFileName()) )
             {
             this->CachedFileList.push_back ( dir.GetFile(static_cast<unsigned long>(fileNum) ));
             }
@@ -597,6 +624,11 @@ void vtkCacheManager::DeleteFromCache( const char *target )
         }
       }
     this->DeleteFromCachedFileList ( str.c_str() );
+
+    this->CacheIndexLock->Lock();
+    this->CacheIndex.erase ( this->GetRelativeCachePath ( str ) );
+    this->WriteCacheIndexLocked();
+    this->CacheIndexLock->Unlock();
     }
 }
 
@@ -643,6 +675,10 @@ int vtkCacheManager::ClearCache()
     this->MarkNodesBeforeDeletingDataFromCache ( this->RemoteCacheDirectory.c_str() );
     vtksys::SystemTools::RemoveADirectory ( this->RemoteCacheDirectory.c_str() );
     }
+  //--- the index file was in the directory
+  this->CacheIndexLock->Lock();
+  this->CacheIndex.clear();
+  this->CacheIndexLock->Unlock();
   if ( vtksys::SystemTools::MakeDirectory ( this->RemoteCacheDirectory.c_str() ) == false )
     {
     vtkWarningMacro ( "Cache cleared: Error: unable to recreate cache directory after deleting its contents." );
@@ -821,8 +857,7 @@ float vtkCacheManager::ComputeCacheSize( const char *dirName, unsigned long sz )
     return (-1);
     }
 
-  int byteSize = static_cast<int>(cachesize );
-  this->CurrentCacheSize =  (float)byteSize / MB;
+  this->CurrentCacheSize = static_cast<float>( cachesize / MB );
   return (this->CurrentCacheSize);
 }
 
@@ -997,3 +1032,398 @@ const char* vtkCacheManager::FindCachedFile ( const char * target, const char *d
     }
 
 }
+
+//----------------------------------------------------------------------------
+const char* vtkCacheManager::GetCacheIndexFileName()
+{
+  return ".SlicerCacheIndex.txt";
+}
+
+//----------------------------------------------------------------------------
+std::string vtkCacheManager::GetRelativeCachePath ( const std::string& fileName )
+{
+  if ( this->RemoteCacheDirectory.empty() )
+    {
+    return std::string();
+    }
+  std::string cacheDir = this->RemoteCacheDirectory;
+  vtksys::SystemTools::ConvertToUnixSlashes ( cacheDir );
+  cacheDir += "/";
+  std::string path = fileName;
+  vtksys::SystemTools::ConvertToUnixSlashes ( path );
+  if ( path.size() <= cacheDir.size() ||
+       path.compare ( 0, cacheDir.size(), cacheDir ) != 0 )
+    {
+    return std::string();
+    }
+  return path.substr ( cacheDir.size() );
+}
+
+//----------------------------------------------------------------------------
+std::string vtkCacheManager::ComputeFileContentHash ( const std::string& fileName )
+{
+  std::ifstream file ( fileName.c_str(), std::ios::in | std::ios::binary );
+  if ( !file.is_open() )
+    {
+    return std::string();
+    }
+  vtksysMD5 *md5 = vtksysMD5_New();
+  vtksysMD5_Initialize ( md5 );
+  char buffer[65536];
+  while ( file )
+    {
+    file.read ( buffer, sizeof(buffer) );
+    std::streamsize length = file.gcount();
+    if ( length > 0 )
+      {
+      vtksysMD5_Append ( md5, reinterpret_cast<unsigned char const*>(buffer),
+                         static_cast<int>(length) );
+      }
+    }
+  char hash[33];
+  vtksysMD5_FinalizeHex ( md5, hash );
+  hash[32] = '\0';
+  vtksysMD5_Delete ( md5 );
+  return std::string ( hash );
+}
+
+//----------------------------------------------------------------------------
+bool vtkCacheManager::IsFileReferencedInScene ( const std::string& fileName )
+{
+  if ( this->MRMLScene == NULL )
+    {
+    return false;
+    }
+  int nnodes = this->MRMLScene->GetNumberOfNodesByClass ( "vtkMRMLStorageNode" );
+  for ( int n = 0; n < nnodes; n++ )
+    {
+    vtkMRMLStorageNode *storageNode = vtkMRMLStorageNode::SafeDownCast (
+      this->MRMLScene->GetNthNodeByClass ( n, "vtkMRMLStorageNode" ) );
+    if ( storageNode == NULL )
+      {
+      continue;
+      }
+    if ( storageNode->GetFileName() != NULL &&
+         storageNode->GetFullNameFromFileName() == fileName )
+      {
+      return true;
+      }
+    for ( int i = 0; i < storageNode->GetNumberOfFileNames(); i++ )
+      {
+      if ( storageNode->GetFullNameFromNthFileName ( i ) == fileName )
+        {
+        return true;
+        }
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkCacheManager::AddCachedFile ( const char *uri, const char *fileName,
+                                             bool deduplicate )
+{
+  if ( fileName == NULL )
+    {
+    vtkErrorMacro ( "AddCachedFile: null file name." );
+    return std::string();
+    }
+  std::string cachedFile = fileName;
+  std::string relativePath = this->GetRelativeCachePath ( cachedFile );
+  if ( relativePath.empty() ||
+       !vtksys::SystemTools::FileExists ( cachedFile.c_str(), true ) )
+    {
+    //--- not downloaded into the cache directory, nothing to index.
+    this->CacheIndexLock->Lock();
+    this->NumberOfCacheMisses++;
+    this->CacheIndexLock->Unlock();
+    return cachedFile;
+    }
+
+  //--- hash outside of the lock, the whole file is read.
+  std::string hash = vtkCacheManager::ComputeFileContentHash ( cachedFile );
+
+  std::string duplicate;
+  this->CacheIndexLock->Lock();
+  this->NumberOfCacheMisses++;
+  if ( deduplicate && !hash.empty() )
+    {
+    std::map< std::string, CacheIndexEntry >::const_iterator it;
+    for ( it = this->CacheIndex.begin(); it != this->CacheIndex.end(); ++it )
+      {
+      if ( it->first != relativePath && it->second.ContentHash == hash &&
+           vtksys::SystemTools::FileExists (
+             (this->RemoteCacheDirectory + "/" + it->first).c_str(), true ) )
+        {
+        duplicate = it->first;
+        break;
+        }
+      }
+    }
+  if ( !duplicate.empty() )
+    {
+    //--- the downloaded file is removed below, the URI now points
+    //--- to the file that was already in the cache.
+    this->CacheIndex.erase ( relativePath );
+    relativePath = duplicate;
+    cachedFile = this->RemoteCacheDirectory + "/" + duplicate;
+    }
+  CacheIndexEntry& entry = this->CacheIndex[relativePath];
+  entry.LastAccessTime = vtksys::SystemTools::GetTime();
+  entry.ContentHash = hash;
+  if ( uri != NULL )
+    {
+    //--- don't reassign an unchanged mapping: GetFileFromURIMap() returns
+    //--- pointers to the mapped strings.
+    std::map< std::string, std::string >::iterator uriIt = this->uriMap.find ( uri );
+    if ( uriIt == this->uriMap.end() )
+      {
+      this->uriMap.insert ( std::make_pair ( std::string(uri), cachedFile ) );
+      }
+    else if ( uriIt->second != cachedFile )
+      {
+      uriIt->second = cachedFile;
+      }
+    }
+  this->WriteCacheIndexLocked();
+  this->CacheIndexLock->Unlock();
+
+  if ( !duplicate.empty() )
+    {
+    vtkDebugMacro ( "AddCachedFile: " << fileName << " has the same content as "
+                    << cachedFile << ", removing the duplicate." );
+    if ( !vtksys::SystemTools::RemoveFile ( fileName ) )
+      {
+      vtkWarningMacro ( "AddCachedFile: unable to remove duplicate file " << fileName );
+      }
+    }
+  return cachedFile;
+}
+
+//----------------------------------------------------------------------------
+void vtkCacheManager::MarkCacheHit ( const char *fileName )
+{
+  if ( fileName == NULL )
+    {
+    return;
+    }
+  std::string relativePath = this->GetRelativeCachePath ( fileName );
+  this->CacheIndexLock->Lock();
+  this->NumberOfCacheHits++;
+  if ( !relativePath.empty() )
+    {
+    this->CacheIndex[relativePath].LastAccessTime = vtksys::SystemTools::GetTime();
+    this->WriteCacheIndexLocked();
+    }
+  this->CacheIndexLock->Unlock();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkCacheManager::EvictLeastRecentlyUsedFiles ( )
+{
+  if ( !this->EnableCacheEviction ||
+       !vtksys::SystemTools::FileIsDirectory ( this->RemoteCacheDirectory.c_str() ) )
+    {
+    return 0;
+    }
+  double budget = ( this->RemoteCacheLimit - this->RemoteCacheFreeBufferSize ) * MB;
+  double cacheSize = this->ComputeCacheSize ( this->RemoteCacheDirectory.c_str(), 0 ) * MB;
+  if ( cacheSize <= budget )
+    {
+    return 0;
+    }
+
+  //--- files at the top of the cache directory, least recently used first.
+  //--- Files that were never indexed are as old as their last modification.
+  std::vector< std::pair< double, std::string > > candidates;
+  vtksys::Directory dir;
+  dir.Load ( this->RemoteCacheDirectory.c_str() );
+  this->CacheIndexLock->Lock();
+  for ( unsigned long fileNum = 0; fileNum < dir.GetNumberOfFiles(); ++fileNum )
+    {
+    std::string name = dir.GetFile ( fileNum );
+    if ( name == "." || name == ".." ||
+         name == vtkCacheManager::GetCacheIndexFileName() )
+      {
+      continue;
+      }
+    std::string fullName = this->RemoteCacheDirectory + "/" + name;
+    if ( vtksys::SystemTools::FileIsDirectory ( fullName.c_str() ) )
+      {
+      continue;
+      }
+    double lastAccessTime =
+      static_cast<double>( vtksys::SystemTools::ModifiedTime ( fullName.c_str() ) );
+    std::map< std::string, CacheIndexEntry >::const_iterator it =
+      this->CacheIndex.find ( name );
+    if ( it != this->CacheIndex.end() && it->second.LastAccessTime > 0. )
+      {
+      lastAccessTime = it->second.LastAccessTime;
+      }
+    candidates.push_back ( std::make_pair ( lastAccessTime, name ) );
+    }
+  this->CacheIndexLock->Unlock();
+  std::sort ( candidates.begin(), candidates.end() );
+
+  int numberOfRemovedFiles = 0;
+  std::vector< std::pair< double, std::string > >::const_iterator candidateIt;
+  for ( candidateIt = candidates.begin();
+        candidateIt != candidates.end() && cacheSize > budget; ++candidateIt )
+    {
+    std::string fullName = this->RemoteCacheDirectory + "/" + candidateIt->second;
+    if ( this->IsFileReferencedInScene ( fullName ) )
+      {
+      continue;
+      }
+    double fileSize = static_cast<double>(
+      vtksys::SystemTools::FileLength ( fullName.c_str() ) );
+    if ( !vtksys::SystemTools::RemoveFile ( fullName.c_str() ) )
+      {
+      vtkWarningMacro ( "EvictLeastRecentlyUsedFiles: unable to remove cached file "
+                        << fullName.c_str() );
+      continue;
+      }
+    vtkDebugMacro ( "EvictLeastRecentlyUsedFiles: removed " << fullName.c_str() );
+    cacheSize -= fileSize;
+    ++numberOfRemovedFiles;
+
+    this->CacheIndexLock->Lock();
+    this->CacheIndex.erase ( candidateIt->second );
+    std::map< std::string, std::string >::iterator uriIt = this->uriMap.begin();
+    while ( uriIt != this->uriMap.end() )
+      {
+      if ( this->GetRelativeCachePath ( uriIt->second ) == candidateIt->second )
+        {
+        this->uriMap.erase ( uriIt++ );
+        }
+      else
+        {
+        ++uriIt;
+        }
+      }
+    this->CacheIndexLock->Unlock();
+    }
+
+  if ( numberOfRemovedFiles > 0 )
+    {
+    this->WriteCacheIndex();
+    this->UpdateCacheInformation();
+    this->InvokeEvent ( vtkCacheManager::CacheDeleteEvent );
+    }
+  return numberOfRemovedFiles;
+}
+
+//----------------------------------------------------------------------------
+void vtkCacheManager::ReadCacheIndex ( )
+{
+  this->CacheIndexLock->Lock();
+  this->CacheIndex.clear();
+  std::string indexFileName =
+    this->RemoteCacheDirectory + "/" + vtkCacheManager::GetCacheIndexFileName();
+  std::ifstream indexFile ( indexFileName.c_str() );
+  std::string line;
+  while ( indexFile.is_open() && std::getline ( indexFile, line ) )
+    {
+    //--- "file<TAB>path<TAB>last access time<TAB>hash"
+    //--- or "uri<TAB>uri<TAB>path", paths are relative to the cache directory.
+    std::vector< std::string > fields;
+    std::string::size_type start = 0;
+    std::string::size_type tab;
+    while ( ( tab = line.find ( '\t', start ) ) != std::string::npos )
+      {
+      fields.push_back ( line.substr ( start, tab - start ) );
+      start = tab + 1;
+      }
+    fields.push_back ( line.substr ( start ) );
+    if ( fields.size() < 3 )
+      {
+      continue;
+      }
+    std::string fullName = this->RemoteCacheDirectory + "/" + fields[ fields[0] == "uri" ? 2 : 1 ];
+    if ( !vtksys::SystemTools::FileExists ( fullName.c_str(), true ) )
+      {
+      continue;
+      }
+    if ( fields[0] == "file" && fields.size() == 4 )
+      {
+      CacheIndexEntry& entry = this->CacheIndex[ fields[1] ];
+      entry.LastAccessTime = atof ( fields[2].c_str() );
+      entry.ContentHash = fields[3];
+      }
+    else if ( fields[0] == "uri" && this->uriMap.find ( fields[1] ) == this->uriMap.end() )
+      {
+      this->uriMap.insert ( std::make_pair ( fields[1], fullName ) );
+      }
+    }
+  this->CacheIndexLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkCacheManager::WriteCacheIndex ( )
+{
+  this->CacheIndexLock->Lock();
+  this->WriteCacheIndexLocked();
+  this->CacheIndexLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkCacheManager::WriteCacheIndexLocked ( )
+{
+  if ( !vtksys::SystemTools::FileIsDirectory ( this->RemoteCacheDirectory.c_str() ) )
+    {
+    return;
+    }
+  std::string indexFileName =
+    this->RemoteCacheDirectory + "/" + vtkCacheManager::GetCacheIndexFileName();
+  std::ofstream indexFile ( indexFileName.c_str() );
+  if ( !indexFile.is_open() )
+    {
+    vtkWarningMacro ( "WriteCacheIndex: unable to write " << indexFileName.c_str() );
+    return;
+    }
+  indexFile.precision ( 16 );
+  std::map< std::string, CacheIndexEntry >::const_iterator it;
+  for ( it = this->CacheIndex.begin(); it != this->CacheIndex.end(); ++it )
+    {
+    indexFile << "file\t" << it->first << "\t" << it->second.LastAccessTime
+              << "\t" << it->second.ContentHash << "\n";
+    }
+  std::map< std::string, std::string >::const_iterator uriIt;
+  for ( uriIt = this->uriMap.begin(); uriIt != this->uriMap.end(); ++uriIt )
+    {
+    std::string relativePath = this->GetRelativeCachePath ( uriIt->second );
+    if ( !relativePath.empty() )
+      {
+      indexFile << "uri\t" << uriIt->first << "\t" << relativePath << "\n";
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkCacheManager::GetNumberOfCacheHits ( )
+{
+  this->CacheIndexLock->Lock();
+  int hits = this->NumberOfCacheHits;
+  this->CacheIndexLock->Unlock();
+  return hits;
+}
+
+//----------------------------------------------------------------------------
+int vtkCacheManager::GetNumberOfCacheMisses ( )
+{
+  this->CacheIndexLock->Lock();
+  int misses = this->NumberOfCacheMisses;
+  this->CacheIndexLock->Unlock();
+  return misses;
+}
+
+//----------------------------------------------------------------------------
+void vtkCacheManager::ResetCacheStatistics ( )
+{
+  this->CacheIndexLock->Lock();
+  this->NumberOfCacheHits = 0;
+  this->NumberOfCacheMisses = 0;
+  this->CacheIndexLock->Unlock();
+  this->Modified();
+}
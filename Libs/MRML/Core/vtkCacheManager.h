@@ -5,6 +5,7 @@
 #include "vtkMRML.h"
 class vtkCallbackCommand;
 class vtkMRMLScene;
+class vtkSimpleMutexLock;
 
 // VTK includes
 #include <vtkObject.h>
@@ -116,6 +117,52 @@ class VTK_MRML_EXPORT vtkCacheManager : public vtkObject
 
   std::vector< std::string > GetCachedFiles()const;
 
+  ///
+  /// Records a file that has just been downloaded from \a uri into the
+  /// cache and counts it as a cache miss. The content of the file is
+  /// hashed: if \a deduplicate is true and a file with the same content
+  /// is already cached under another name, \a fileName is removed from
+  /// disk, \a uri is mapped to the existing file and the existing file is
+  /// returned. Otherwise \a fileName is returned.
+  /// The cache index is saved in the cache directory so that the mapping
+  /// and the access times survive across sessions.
+  /// This method can be called from the networking threads.
+  std::string AddCachedFile ( const char *uri, const char *fileName,
+                              bool deduplicate = false );
+
+  ///
+  /// Records that \a fileName was used from the cache instead of being
+  /// downloaded again: it counts as a cache hit and the file becomes the
+  /// most recently used one.
+  void MarkCacheHit ( const char *fileName );
+
+  ///
+  /// Removes the least recently used files from the cache until its size
+  /// fits within RemoteCacheLimit minus RemoteCacheFreeBufferSize.
+  /// Files referenced by a storage node of the scene are never removed.
+  /// Does nothing if EnableCacheEviction is off.
+  /// Returns the number of files removed.
+  int EvictLeastRecentlyUsedFiles ( );
+
+  ///
+  /// Reads/writes the cache index (access times, content hashes and
+  /// URI mapping) from/to the RemoteCacheDirectory.
+  /// The index is read when the cache directory is set and written
+  /// every time it changes.
+  void ReadCacheIndex ( );
+  void WriteCacheIndex ( );
+
+  ///
+  /// Name of the cache index file in the RemoteCacheDirectory.
+  static const char* GetCacheIndexFileName ( );
+
+  ///
+  /// Number of data files served from the cache and number of data files
+  /// downloaded since the last call to ResetCacheStatistics().
+  int GetNumberOfCacheHits ( );
+  int GetNumberOfCacheMisses ( );
+  void ResetCacheStatistics ( );
+
   ///
   vtkGetMacro ( RemoteCacheLimit, int );
   vtkSetMacro ( RemoteCacheLimit, int );
@@ -124,6 +171,11 @@ class VTK_MRML_EXPORT vtkCacheManager : public vtkObject
   vtkSetMacro ( RemoteCacheFreeBufferSize, int );
   vtkGetMacro ( EnableForceRedownload, int );
   vtkSetMacro ( EnableForceRedownload, int );
+  /// If on (default), EvictLeastRecentlyUsedFiles() removes files
+  /// from the cache when it is full.
+  vtkGetMacro ( EnableCacheEviction, int );
+  vtkSetMacro ( EnableCacheEviction, int );
+  vtkBooleanMacro ( EnableCacheEviction, int );
   //vtkGetMacro ( EnableRemoteCacheOverwriting, int );
   //vtkSetMacro ( EnableRemoteCacheOverwriting, int );
   void SetMRMLScene ( vtkMRMLScene *scene )
@@ -160,9 +212,34 @@ class VTK_MRML_EXPORT vtkCacheManager : public vtkObject
   float CurrentCacheSize;
   int RemoteCacheFreeBufferSize;
   int EnableForceRedownload;
+  int EnableCacheEviction;
   //int EnableRemoteCacheOverwriting;
   vtkMRMLScene *MRMLScene;
 
+  /// Cache index entry of a file, keyed by the file name relative
+  /// to the RemoteCacheDirectory.
+  struct CacheIndexEntry
+    {
+    CacheIndexEntry() : LastAccessTime(0.) {}
+    double LastAccessTime;
+    std::string ContentHash;
+    };
+  std::map< std::string, CacheIndexEntry > CacheIndex;
+  int NumberOfCacheHits;
+  int NumberOfCacheMisses;
+  /// Protects CacheIndex, uriMap and the hit/miss counters.
+  vtkSimpleMutexLock *CacheIndexLock;
+
+  /// Returns the path of \a fileName relative to the RemoteCacheDirectory
+  /// or an empty string if the file is not in the cache directory.
+  std::string GetRelativeCachePath ( const std::string& fileName );
+  /// Returns the MD5 hash of the content of the file.
+  static std::string ComputeFileContentHash ( const std::string& fileName );
+  /// Returns true if a storage node of the scene reads from \a fileName.
+  bool IsFileReferencedInScene ( const std::string& fileName );
+  /// Same as WriteCacheIndex() but expects CacheIndexLock to be locked.
+  void WriteCacheIndexLocked ( );
+
   std::string RemoteCacheDirectory;
   int GetCachedFileList(const char *dirname);
   std::vector< std::string > GetAllCachedFiles();
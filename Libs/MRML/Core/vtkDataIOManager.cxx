@@ -9,6 +9,7 @@
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
+#include <vtkMutexLock.h>
 #include <vtkObjectFactory.h>
 
 // STD includes
@@ -33,11 +34,17 @@ vtkDataIOManager::vtkDataIOManager()
   this->InUpdateCallbackFlag = 0;
 
   this->FileFormatHelper = NULL;
+
+  this->TransferStatisticsLock = vtkSimpleMutexLock::New();
+  this->TotalTransferredBytes = 0;
+  this->TotalTransferDuration = 0.;
+  this->NumberOfCompletedTransfers = 0;
 }
 
 //----------------------------------------------------------------------------
 vtkDataIOManager::~vtkDataIOManager()
 {
+  this->TransferStatisticsLock->Delete();
 
   if ( this->TransferUpdateCommand )
     {
@@ -100,6 +107,9 @@ void vtkDataIOManager::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "DataTransferCollection: " << this->GetDataTransferCollection() << "\n";
   os << indent << "CacheManager: " << this->GetCacheManager() << "\n";
   os << indent << "EnableAsynchronousIO: " << this->GetEnableAsynchronousIO() << "\n";
+  os << indent << "NumberOfCompletedTransfers: " << this->GetNumberOfCompletedTransfers() << "\n";
+  os << indent << "TotalTransferredBytes: " << this->GetTotalTransferredBytes() << "\n";
+  os << indent << "TotalTransferDuration: " << this->GetTotalTransferDuration() << "\n";
 
 }
 
@@ -554,4 +564,59 @@ vtkDataFileFormatHelper* vtkDataIOManager:: GetFileFormatHelper()
   return this->FileFormatHelper;
 }
 
+//----------------------------------------------------------------------------
+void vtkDataIOManager::AddTransferStatistics(vtkTypeInt64 bytes, double seconds)
+{
+  this->TransferStatisticsLock->Lock();
+  this->TotalTransferredBytes += bytes;
+  this->TotalTransferDuration += seconds;
+  ++this->NumberOfCompletedTransfers;
+  this->TransferStatisticsLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkDataIOManager::GetTotalTransferredBytes()
+{
+  this->TransferStatisticsLock->Lock();
+  vtkTypeInt64 bytes = this->TotalTransferredBytes;
+  this->TransferStatisticsLock->Unlock();
+  return bytes;
+}
+
+//----------------------------------------------------------------------------
+double vtkDataIOManager::GetTotalTransferDuration()
+{
+  this->TransferStatisticsLock->Lock();
+  double seconds = this->TotalTransferDuration;
+  this->TransferStatisticsLock->Unlock();
+  return seconds;
+}
 
+//----------------------------------------------------------------------------
+int vtkDataIOManager::GetNumberOfCompletedTransfers()
+{
+  this->TransferStatisticsLock->Lock();
+  int count = this->NumberOfCompletedTransfers;
+  this->TransferStatisticsLock->Unlock();
+  return count;
+}
+
+//----------------------------------------------------------------------------
+double vtkDataIOManager::GetAverageTransferRate()
+{
+  this->TransferStatisticsLock->Lock();
+  double rate = this->TotalTransferDuration > 0. ?
+    static_cast<double>(this->TotalTransferredBytes) / this->TotalTransferDuration : 0.;
+  this->TransferStatisticsLock->Unlock();
+  return rate;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataIOManager::ResetTransferStatistics()
+{
+  this->TransferStatisticsLock->Lock();
+  this->TotalTransferredBytes = 0;
+  this->TotalTransferDuration = 0.;
+  this->NumberOfCompletedTransfers = 0;
+  this->TransferStatisticsLock->Unlock();
+}
@@ -12,6 +12,7 @@ class vtkMRMLNode;
 #include <vtkObject.h>
 class vtkCallbackCommand;
 class vtkCollection;
+class vtkSimpleMutexLock;
 
 #ifndef vtkObjectPointer
 #define vtkObjectPointer(xx) (reinterpret_cast <vtkObject **>( (xx) ))
@@ -85,6 +86,24 @@ class VTK_MRML_EXPORT vtkDataIOManager : public vtkObject
 
   const char* GetTransferStatusString( vtkDataTransfer *transfer );
 
+  ///
+  /// Account for a completed transfer of \a bytes that took \a seconds.
+  /// Thread safe, called from the networking threads.
+  /// \sa GetTotalTransferredBytes(), GetAverageTransferRate()
+  void AddTransferStatistics(vtkTypeInt64 bytes, double seconds);
+  ///
+  /// Total number of bytes transferred and cumulated duration in seconds of
+  /// the transfers since the last ResetTransferStatistics().
+  vtkTypeInt64 GetTotalTransferredBytes();
+  double GetTotalTransferDuration();
+  int GetNumberOfCompletedTransfers();
+  ///
+  /// Average rate of a transfer in bytes per second, 0 if there was none.
+  /// Concurrent transfers are measured separately: the overall bandwidth
+  /// used can be higher.
+  double GetAverageTransferRate();
+  void ResetTransferStatistics();
+
   virtual void ProcessTransferUpdates ( vtkObject *caller, unsigned long event, void *callData );
 
   enum
@@ -113,6 +132,11 @@ class VTK_MRML_EXPORT vtkDataIOManager : public vtkObject
   vtkCacheManager *CacheManager;
   int EnableAsynchronousIO;
 
+  vtkSimpleMutexLock* TransferStatisticsLock;
+  vtkTypeInt64 TotalTransferredBytes;
+  double TotalTransferDuration;
+  int NumberOfCompletedTransfers;
+
   vtkDataFileFormatHelper* FileFormatHelper;
 
  protected:
@@ -23,6 +23,8 @@ vtkDataTransfer::vtkDataTransfer()
   this->CancelRequested = 0;
   this->TransferCached = 0;
   this->SizeOnDisk = 0;
+  this->TransferredBytes = 0;
+  this->TransferDuration = 0.;
 }
 
 
@@ -64,6 +66,8 @@ void vtkDataTransfer::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "TransferNodeID: " << this->GetTransferNodeID() << "\n";
   os << indent << "Progress: " << this->GetProgress() << "\n";
   os << indent << "SizeOnDisk: " << this->GetSizeOnDisk() << "\n";
+  os << indent << "TransferredBytes: " << this->GetTransferredBytes() << "\n";
+  os << indent << "TransferDuration: " << this->GetTransferDuration() << "\n";
 }
 
 
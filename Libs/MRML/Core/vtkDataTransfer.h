@@ -41,6 +41,14 @@ class VTK_MRML_EXPORT vtkDataTransfer : public vtkObject
   vtkGetMacro (TransferCached, int );
   vtkSetMacro (TransferCached, int );
 
+  /// Number of bytes transferred and time in seconds it took, set once the
+  /// transfer is completed.
+  /// \sa vtkDataIOManager::AddTransferStatistics()
+  vtkGetMacro (TransferredBytes, vtkTypeInt64 );
+  vtkSetMacro (TransferredBytes, vtkTypeInt64 );
+  vtkGetMacro (TransferDuration, double );
+  vtkSetMacro (TransferDuration, double );
+
   void SetTransferStatusNoModify ( int val)
       {
       this->TransferStatus = val;
@@ -120,6 +128,8 @@ class VTK_MRML_EXPORT vtkDataTransfer : public vtkObject
   char* TransferNodeID;
   int Progress;
   int CancelRequested;
+  vtkTypeInt64 TransferredBytes;
+  double TransferDuration;
 
 };
 
@@ -19,11 +19,47 @@
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
+#include <vtkDoubleArray.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkStringArray.h>
+#include <vtkTable.h>
 #include <vtkTimerLog.h>
 
+// STD includes
+#include <algorithm>
+#include <sstream>
+
 vtkCxxSetObjectMacro(vtkEventBroker, TimerLog, vtkTimerLog);
 
+namespace
+{
+//----------------------------------------------------------------------------
+bool HasHigherPriority(vtkObservation* observation1, vtkObservation* observation2)
+{
+  return observation1->GetPriority() > observation2->GetPriority();
+}
+
+//----------------------------------------------------------------------------
+struct ObservationStatistics
+{
+  ObservationStatistics() : InvocationCount(0), TotalElapsedTime(0.0), MaximumNestingLevel(0) {}
+  std::string SubjectClass;
+  std::string Event;
+  std::string ObserverClass;
+  unsigned long InvocationCount;
+  double TotalElapsedTime;
+  int MaximumNestingLevel;
+};
+
+//----------------------------------------------------------------------------
+bool HasLongerElapsedTime(const ObservationStatistics& statistics1, const ObservationStatistics& statistics2)
+{
+  return statistics1.TotalElapsedTime > statistics2.TotalElapsedTime;
+}
+}
+
 //----------------------------------------------------------------------------
 // The IO manager singleton.
 // This MUST be default initialized to zero by the compiler and is
@@ -96,6 +132,9 @@ vtkEventBroker::vtkEventBroker()
   this->EventNestingLevel = 0;
   this->TimerLog = vtkTimerLog::New();
   this->CompressCallData = 0;
+  this->EventQueueNeedsSorting = false;
+  this->NumberOfQueuedEvents = 0;
+  this->NumberOfCoalescedEvents = 0;
   this->LogFileName = NULL;
   this->ScriptHandler = NULL;
   this->ScriptHandlerClientData = NULL;
@@ -752,36 +791,60 @@ void vtkEventBroker::QueueObservation ( vtkObservation *observation,
   // If the event is not currently in the queue, add it and keep a flag.
   //
   vtkObservation::CallType call(eid, callData);
+  std::deque< vtkObservation::CallType >* callDataList = observation->GetCallDataList();
+  this->NumberOfQueuedEvents++;
   if ( this->GetCompressCallData() &&
        observation->GetEvent() != vtkCommand::AnyEvent)
     {
-    observation->GetCallDataList()->clear();
-    observation->GetCallDataList()->push_back( call );
+    if ( !callDataList->empty() )
+      {
+      this->NumberOfCoalescedEvents++;
+      }
+    callDataList->clear();
+    callDataList->push_back( call );
     }
   else
     {
-    std::deque< vtkObservation::CallType >::const_iterator dataIter;
-    for(dataIter=observation->GetCallDataList()->begin();dataIter != observation->GetCallDataList()->end(); dataIter++)
+    std::deque< vtkObservation::CallType >::iterator dataIter;
+    for(dataIter=callDataList->begin();dataIter != callDataList->end(); dataIter++)
       {
       if ( call.EventID == dataIter->EventID &&
-           call.CallData == dataIter->CallData)
+           (call.CallData == dataIter->CallData || this->GetCompressCallData()) )
         {
         break;
         }
       }
-    if ( dataIter == observation->GetCallDataList()->end() )
+    if ( dataIter == callDataList->end() )
+      {
+      callDataList->push_back( call );
+      }
+    else
       {
-      observation->GetCallDataList()->push_back( call );
+      // only keep the most recent call data
+      dataIter->CallData = call.CallData;
+      this->NumberOfCoalescedEvents++;
       }
     }
 
   if ( !observation->GetInEventQueue() )
     {
+    if ( !this->EventQueue.empty() &&
+         this->EventQueue.back()->GetPriority() < observation->GetPriority() )
+      {
+      this->EventQueueNeedsSorting = true;
+      }
     this->EventQueue.push_back( observation );
     observation->SetInEventQueue(1);
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkEventBroker::ResetEventCounters()
+{
+  this->NumberOfQueuedEvents = 0;
+  this->NumberOfCoalescedEvents = 0;
+}
+
 //----------------------------------------------------------------------------
 int vtkEventBroker::GetNumberOfQueuedObservations ()
 {
@@ -842,6 +905,11 @@ void vtkEventBroker::InvokeObservation ( vtkObservation *observation,
   double elapsedTime = this->TimerLog->GetUniversalTime() - startTime;
   observation->SetTotalElapsedTime (observation->GetTotalElapsedTime() + elapsedTime);
   observation->SetLastElapsedTime (elapsedTime);
+  observation->SetInvocationCount (observation->GetInvocationCount() + 1);
+  if ( this->EventNestingLevel > observation->GetMaximumNestingLevel() )
+    {
+    observation->SetMaximumNestingLevel (this->EventNestingLevel);
+    }
   this->LogEvent (observation);
 
   // clear reference to observation (may cause delete)
@@ -862,6 +930,13 @@ void vtkEventBroker::ProcessEventQueue ()
   //
   while ( this->GetNumberOfQueuedObservations() > 0 )
     {
+    if ( this->EventQueueNeedsSorting )
+      {
+      // higher priority observations first, stable to keep the order of
+      // observations with the same priority
+      std::stable_sort( this->EventQueue.begin(), this->EventQueue.end(), HasHigherPriority );
+      this->EventQueueNeedsSorting = false;
+      }
     vtkObservation *observation = this->EventQueue.front();
     observation->Register( this );
     int finished = 0;
@@ -878,11 +953,133 @@ void vtkEventBroker::ProcessEventQueue ()
         break;
         }
       }
-    this->DequeueObservation();
+    // the observation is already removed from the queue if it was removed
+    // from the broker while being invoked
+    if ( observation->GetInEventQueue() )
+      {
+      this->DequeueObservation();
+      }
     observation->Delete();
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkEventBroker::GetObservationStatistics(vtkTable* statistics)
+{
+  if (!statistics)
+    {
+    vtkErrorMacro("GetObservationStatistics: invalid table");
+    return;
+    }
+
+  // sum up observations that have the same subject class, event and observer class
+  std::map< std::string, ObservationStatistics > statisticsMap;
+  ObjectToObservationVectorMap::iterator mapIter;
+  for (mapIter = this->SubjectMap.begin(); mapIter != this->SubjectMap.end(); ++mapIter)
+    {
+    for (ObservationVector::iterator obsIter = mapIter->second.begin(); obsIter != mapIter->second.end(); ++obsIter)
+      {
+      vtkObservation* observation = *obsIter;
+      if (observation->GetInvocationCount() == 0)
+        {
+        continue;
+        }
+      ObservationStatistics entry;
+      entry.SubjectClass = observation->GetSubject() ? observation->GetSubject()->GetClassName() : "(none)";
+      unsigned long event = observation->GetEvent();
+      if (event < vtkCommand::UserEvent)
+        {
+        entry.Event = vtkCommand::GetStringFromEventId(event);
+        }
+      else
+        {
+        std::stringstream ss;
+        ss << event;
+        entry.Event = ss.str();
+        }
+      if (observation->GetScript())
+        {
+        entry.ObserverClass = "Script";
+        }
+      else if (observation->GetObserver())
+        {
+        entry.ObserverClass = observation->GetObserver()->GetClassName();
+        }
+      else
+        {
+        entry.ObserverClass = "(callback)";
+        }
+      std::string key = entry.SubjectClass + "/" + entry.Event + "/" + entry.ObserverClass;
+      std::map< std::string, ObservationStatistics >::iterator statisticsIt = statisticsMap.find(key);
+      if (statisticsIt == statisticsMap.end())
+        {
+        statisticsIt = statisticsMap.insert(std::make_pair(key, entry)).first;
+        }
+      statisticsIt->second.InvocationCount += observation->GetInvocationCount();
+      statisticsIt->second.TotalElapsedTime += observation->GetTotalElapsedTime();
+      if (observation->GetMaximumNestingLevel() > statisticsIt->second.MaximumNestingLevel)
+        {
+        statisticsIt->second.MaximumNestingLevel = observation->GetMaximumNestingLevel();
+        }
+      }
+    }
+
+  std::vector< ObservationStatistics > sortedStatistics;
+  for (std::map< std::string, ObservationStatistics >::iterator statisticsIt = statisticsMap.begin();
+       statisticsIt != statisticsMap.end(); ++statisticsIt)
+    {
+    sortedStatistics.push_back(statisticsIt->second);
+    }
+  std::stable_sort(sortedStatistics.begin(), sortedStatistics.end(), HasLongerElapsedTime);
+
+  vtkNew<vtkStringArray> subjectClassArray;
+  subjectClassArray->SetName("SubjectClass");
+  vtkNew<vtkStringArray> eventArray;
+  eventArray->SetName("Event");
+  vtkNew<vtkStringArray> observerClassArray;
+  observerClassArray->SetName("ObserverClass");
+  vtkNew<vtkIntArray> invocationCountArray;
+  invocationCountArray->SetName("InvocationCount");
+  vtkNew<vtkDoubleArray> totalElapsedTimeArray;
+  totalElapsedTimeArray->SetName("TotalElapsedTime");
+  vtkNew<vtkIntArray> maximumNestingLevelArray;
+  maximumNestingLevelArray->SetName("MaximumNestingLevel");
+  for (std::vector< ObservationStatistics >::iterator statisticsIt = sortedStatistics.begin();
+       statisticsIt != sortedStatistics.end(); ++statisticsIt)
+    {
+    subjectClassArray->InsertNextValue(statisticsIt->SubjectClass);
+    eventArray->InsertNextValue(statisticsIt->Event);
+    observerClassArray->InsertNextValue(statisticsIt->ObserverClass);
+    invocationCountArray->InsertNextValue(static_cast<int>(statisticsIt->InvocationCount));
+    totalElapsedTimeArray->InsertNextValue(statisticsIt->TotalElapsedTime);
+    maximumNestingLevelArray->InsertNextValue(statisticsIt->MaximumNestingLevel);
+    }
+
+  statistics->Initialize();
+  statistics->AddColumn(subjectClassArray.GetPointer());
+  statistics->AddColumn(eventArray.GetPointer());
+  statistics->AddColumn(observerClassArray.GetPointer());
+  statistics->AddColumn(invocationCountArray.GetPointer());
+  statistics->AddColumn(totalElapsedTimeArray.GetPointer());
+  statistics->AddColumn(maximumNestingLevelArray.GetPointer());
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::ResetObservationStatistics()
+{
+  ObjectToObservationVectorMap::iterator mapIter;
+  for (mapIter = this->SubjectMap.begin(); mapIter != this->SubjectMap.end(); ++mapIter)
+    {
+    for (ObservationVector::iterator obsIter = mapIter->second.begin(); obsIter != mapIter->second.end(); ++obsIter)
+      {
+      (*obsIter)->SetLastElapsedTime(0.0);
+      (*obsIter)->SetTotalElapsedTime(0.0);
+      (*obsIter)->SetInvocationCount(0);
+      (*obsIter)->SetMaximumNestingLevel(0);
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkEventBroker::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -893,6 +1090,9 @@ void vtkEventBroker::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "EventMode: " << this->GetEventModeAsString() << "\n";
   os << indent << "EventLogging: " << this->EventLogging << "\n";
   os << indent << "EventNestingLevel: " << this->EventNestingLevel << "\n";
+  os << indent << "CompressCallData: " << this->CompressCallData << "\n";
+  os << indent << "NumberOfQueuedEvents: " << this->NumberOfQueuedEvents << "\n";
+  os << indent << "NumberOfCoalescedEvents: " << this->NumberOfCoalescedEvents << "\n";
   os << indent << "LogFileName: " <<
     (this->LogFileName ? this->LogFileName : "(none)") << "\n";
 }
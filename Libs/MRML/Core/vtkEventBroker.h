@@ -32,6 +32,7 @@ class vtkTimerLog;
 class vtkCollection;
 class vtkCallbackCommand;
 class vtkObservation;
+class vtkTable;
 
 /// \brief Class that manages adding and deleting of observers with events.
 ///
@@ -168,6 +169,20 @@ public:
   /// based on the filename and the EventLogging variable)
   void LogEvent (vtkObservation *observation);
 
+  /// Observation statistics
+  ///
+  /// Fill the table with the invocation count, total elapsed time and
+  /// maximum nesting level of the observations, summed up for each
+  /// (subject class, event, observer class) combination.
+  /// Rows are sorted by decreasing total elapsed time.
+  /// Columns: SubjectClass, Event, ObserverClass, InvocationCount,
+  /// TotalElapsedTime (in seconds), MaximumNestingLevel.
+  /// Statistics of removed observations are not included.
+  void GetObservationStatistics(vtkTable* statistics);
+  ///
+  /// Reset elapsed times, invocation counts and nesting levels of all observations
+  void ResetObservationStatistics();
+
   /// Graph File
   ///
   /// Write out the current list of observations in graphviz format (.dot)
@@ -225,14 +240,29 @@ public:
   ///
   /// two modes -
   ///  - CompressCallDataOn: only keep the most recent call data.  this means that if the
-  ///    observation is in the queue, replace the call data with the current value
+  ///    observation is in the queue, replace the call data with the current value.
+  ///    Observations of AnyEvent keep the most recent call data of each event.
   ///  - CompressCallDataOff: maintain the list of all call data values, but only
   ///    one unique entry for each
-  ///  Compression is ON by default
+  ///  Compression is OFF by default
+  /// In both modes, the same event invoked multiple times by a subject
+  /// while it is queued is only delivered once to each observer.
+  /// Queued observations are invoked in the order of their priority
+  /// (higher priority first), and in the order they were queued for equal
+  /// priorities.
   vtkBooleanMacro (CompressCallData, int);
   vtkGetMacro (CompressCallData, int);
   vtkSetMacro (CompressCallData, int);
 
+  ///
+  /// Number of events added to the event queue since the last ResetEventCounters()
+  vtkGetMacro (NumberOfQueuedEvents, unsigned long);
+  ///
+  /// Number of queued events that were merged with an event already in the queue
+  /// (therefore not delivered separately) since the last ResetEventCounters()
+  vtkGetMacro (NumberOfCoalescedEvents, unsigned long);
+  void ResetEventCounters();
+
   ///
   /// Sets the method pointer to be used for processing script observations
   void SetScriptHandler ( void (*scriptHandler) (const char* script, void *clientData), void *clientData )
@@ -286,6 +316,11 @@ protected:
   int EventMode;
   int CompressCallData;
 
+  /// Set when an observation is queued after one with a lower priority
+  bool EventQueueNeedsSorting;
+  unsigned long NumberOfQueuedEvents;
+  unsigned long NumberOfCoalescedEvents;
+
   std::ofstream LogFile;
 private:
   /// DetachObservations is a fast (but dangerous) method to delete all the
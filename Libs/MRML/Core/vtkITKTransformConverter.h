@@ -968,18 +968,37 @@ bool vtkITKTransformConverter::SetVTKOrientedGridTransformFromITKImage(vtkObject
       << VTKDimension << " components but it actually contains " << numberOfScalarComponents );
     return false;
     }
-  gridImage_Ras->AllocateScalars(VTK_DOUBLE, 3);
-
-  double* displacementVectors_Ras = reinterpret_cast<double*>(gridImage_Ras->GetScalarPointer());
-  itk::ImageRegionConstIterator<GridImageType> inputIt(gridImage_Lps, gridImage_Lps->GetRequestedRegion());
-  inputIt.GoToBegin();
-  while( !inputIt.IsAtEnd() )
-    {
-    typename GridImageType::PixelType displacementVectorLps=inputIt.Get();
-    *(displacementVectors_Ras++) = -displacementVectorLps[0];
-    *(displacementVectors_Ras++) = -displacementVectorLps[1];
-    *(displacementVectors_Ras++) =  displacementVectorLps[2];
-    ++inputIt;
+  // Keep the precision of the ITK field: a single precision field is not
+  // converted (and doubled in size) to double precision.
+  bool isDoublePrecisionInput = (sizeof(T) == sizeof(double));
+  gridImage_Ras->AllocateScalars(isDoublePrecisionInput ? VTK_DOUBLE : VTK_FLOAT, 3);
+
+  T* displacementVectors_Ras = static_cast<T*>(gridImage_Ras->GetScalarPointer());
+  if (gridImage_Lps->GetBufferedRegion() == gridImage_Lps->GetRequestedRegion())
+    {
+    // The whole buffer is converted, flip the vector components in a
+    // single pass over the raw ITK buffer.
+    const T* displacementVectors_Lps = reinterpret_cast<const T*>(gridImage_Lps->GetBufferPointer());
+    const size_t numberOfVectors = gridImage_Lps->GetBufferedRegion().GetNumberOfPixels();
+    for (size_t i = 0; i < numberOfVectors; i++)
+      {
+      *(displacementVectors_Ras++) = -(*(displacementVectors_Lps++));
+      *(displacementVectors_Ras++) = -(*(displacementVectors_Lps++));
+      *(displacementVectors_Ras++) =  (*(displacementVectors_Lps++));
+      }
+    }
+  else
+    {
+    itk::ImageRegionConstIterator<GridImageType> inputIt(gridImage_Lps, gridImage_Lps->GetRequestedRegion());
+    inputIt.GoToBegin();
+    while( !inputIt.IsAtEnd() )
+      {
+      typename GridImageType::PixelType displacementVectorLps=inputIt.Get();
+      *(displacementVectors_Ras++) = -displacementVectorLps[0];
+      *(displacementVectors_Ras++) = -displacementVectorLps[1];
+      *(displacementVectors_Ras++) =  displacementVectorLps[2];
+      ++inputIt;
+      }
     }
 
   grid_Ras->SetDisplacementGridData( gridImage_Ras.GetPointer() );
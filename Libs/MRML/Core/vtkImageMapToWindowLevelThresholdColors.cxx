@@ -0,0 +1,330 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkImageMapToWindowLevelThresholdColors.h"
+
+// VTK includes
+#include <vtkAlgorithmOutput.h>
+#include <vtkImageData.h>
+#include <vtkImageStencilData.h>
+#include <vtkImageStencilIterator.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkScalarsToColors.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkImageMapToWindowLevelThresholdColors);
+vtkCxxSetObjectMacro(vtkImageMapToWindowLevelThresholdColors, LookupTable, vtkScalarsToColors);
+
+//----------------------------------------------------------------------------
+vtkImageMapToWindowLevelThresholdColors::vtkImageMapToWindowLevelThresholdColors()
+{
+  this->Window = 255.;
+  this->Level = 127.5;
+  this->LookupTable = NULL;
+  this->LowerThreshold = VTK_SHORT_MIN;
+  this->UpperThreshold = VTK_SHORT_MAX;
+  this->ApplyThreshold = 0;
+  for (int i = 0; i < 256; ++i)
+    {
+    this->Colors[4 * i] = this->Colors[4 * i + 1] = this->Colors[4 * i + 2] =
+      static_cast<unsigned char>(i);
+    this->Colors[4 * i + 3] = 255;
+    }
+  // port 1 is the stencil
+  this->SetNumberOfInputPorts(2);
+}
+
+//----------------------------------------------------------------------------
+vtkImageMapToWindowLevelThresholdColors::~vtkImageMapToWindowLevelThresholdColors()
+{
+  this->SetLookupTable(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageMapToWindowLevelThresholdColors::SetStencilConnection(vtkAlgorithmOutput* stencilConnection)
+{
+  this->SetInputConnection(1, stencilConnection);
+}
+
+//----------------------------------------------------------------------------
+vtkAlgorithmOutput* vtkImageMapToWindowLevelThresholdColors::GetStencilConnection()
+{
+  return this->GetNumberOfInputConnections(1) ? this->GetInputConnection(1, 0) : 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkImageMapToWindowLevelThresholdColors::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->LookupTable)
+    {
+    mTime = std::max(mTime, this->LookupTable->GetMTime());
+    }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageMapToWindowLevelThresholdColors::FillInputPortInformation(int port, vtkInformation* info)
+{
+  if (port == 1)
+    {
+    info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageStencilData");
+    info->Set(vtkAlgorithm::INPUT_IS_OPTIONAL(), 1);
+    return 1;
+    }
+  return this->Superclass::FillInputPortInformation(port, info);
+}
+
+//----------------------------------------------------------------------------
+int vtkImageMapToWindowLevelThresholdColors::RequestInformation(
+  vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** vtkNotUsed(inputVector),
+  vtkInformationVector* outputVector)
+{
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_UNSIGNED_CHAR, 4);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageMapToWindowLevelThresholdColors::RequestData(
+  vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  // The window/level luminances are unsigned char, the lookup table only
+  // needs to be evaluated for these 256 values.
+  if (this->LookupTable)
+    {
+    unsigned char luminances[256];
+    for (int i = 0; i < 256; ++i)
+      {
+      luminances[i] = static_cast<unsigned char>(i);
+      }
+    this->LookupTable->Build();
+    this->LookupTable->MapScalarsThroughTable2(
+      luminances, this->Colors, VTK_UNSIGNED_CHAR, 256, 1, VTK_RGBA);
+    }
+  else
+    {
+    for (int i = 0; i < 256; ++i)
+      {
+      this->Colors[4 * i] = this->Colors[4 * i + 1] = this->Colors[4 * i + 2] =
+        static_cast<unsigned char>(i);
+      this->Colors[4 * i + 3] = 255;
+      }
+    }
+  return this->Superclass::RequestData(request, inputVector, outputVector);
+}
+
+//----------------------------------------------------------------------------
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Same clamping as vtkImageMapToWindowLevelColors so that the luminances
+// are identical.
+template <class T>
+void WindowLevelClamps(vtkImageData* data, double w, double l,
+                       T& lower, T& upper,
+                       unsigned char& lowerValue, unsigned char& upperValue)
+{
+  double range[2] = { data->GetScalarTypeMin(), data->GetScalarTypeMax() };
+
+  double fLower = l - fabs(w) / 2.0;
+  double fUpper = fLower + fabs(w);
+  double adjustedLower = fLower;
+  double adjustedUpper = fUpper;
+
+  if (fLower <= range[1])
+    {
+    if (fLower >= range[0])
+      {
+      lower = static_cast<T>(fLower);
+      adjustedLower = fLower;
+      }
+    else
+      {
+      lower = static_cast<T>(range[0]);
+      adjustedLower = range[0];
+      }
+    }
+  else
+    {
+    lower = static_cast<T>(range[1]);
+    adjustedLower = range[1];
+    }
+
+  if (fUpper >= range[0])
+    {
+    if (fUpper <= range[1])
+      {
+      upper = static_cast<T>(fUpper);
+      adjustedUpper = fUpper;
+      }
+    else
+      {
+      upper = static_cast<T>(range[1]);
+      adjustedUpper = range[1];
+      }
+    }
+  else
+    {
+    upper = static_cast<T>(range[0]);
+    adjustedUpper = range[0];
+    }
+
+  double fLowerValue = 0.;
+  double fUpperValue = 0.;
+  if (w >= 0)
+    {
+    fLowerValue = 255.0 * (adjustedLower - fLower) / w;
+    fUpperValue = 255.0 * (adjustedUpper - fLower) / w;
+    }
+  else
+    {
+    fLowerValue = 255.0 + 255.0 * (adjustedLower - fLower) / w;
+    fUpperValue = 255.0 + 255.0 * (adjustedUpper - fLower) / w;
+    }
+
+  upperValue = fUpperValue > 255 ? 255 :
+    (fUpperValue < 0 ? 0 : static_cast<unsigned char>(fUpperValue));
+  lowerValue = fLowerValue > 255 ? 255 :
+    (fLowerValue < 0 ? 0 : static_cast<unsigned char>(fLowerValue));
+}
+
+//----------------------------------------------------------------------------
+// Same clamping as vtkImageThreshold
+template <class T>
+T ClampThreshold(vtkImageData* data, double threshold)
+{
+  if (threshold < data->GetScalarTypeMin())
+    {
+    return static_cast<T>(data->GetScalarTypeMin());
+    }
+  if (threshold > data->GetScalarTypeMax())
+    {
+    return static_cast<T>(data->GetScalarTypeMax());
+    }
+  return static_cast<T>(threshold);
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkImageMapToWindowLevelThresholdColorsExecute(
+  vtkImageMapToWindowLevelThresholdColors* self,
+  vtkImageData* inData, vtkImageData* outData, vtkImageStencilData* stencil,
+  const unsigned char* colors, int outExt[6], int threadId, T*)
+{
+  T lower, upper;
+  unsigned char lowerValue, upperValue;
+  WindowLevelClamps<T>(inData, self->GetWindow(), self->GetLevel(),
+                       lower, upper, lowerValue, upperValue);
+  const double shift = self->GetWindow() / 2.0 - self->GetLevel();
+  const double scale = 255.0 / self->GetWindow();
+
+  const bool applyThreshold = self->GetApplyThreshold() != 0;
+  const T lowerThreshold = ClampThreshold<T>(inData, self->GetLowerThreshold());
+  const T upperThreshold = ClampThreshold<T>(inData, self->GetUpperThreshold());
+
+  const int numberOfComponents = inData->GetNumberOfScalarComponents();
+
+  vtkImageStencilIterator<T> inIter(inData, stencil, outExt, self, threadId);
+  vtkImageStencilIterator<unsigned char> outIter(outData, stencil, outExt);
+  while (!outIter.IsAtEnd())
+    {
+    const T* inPtr = inIter.BeginSpan();
+    const T* inEnd = inIter.EndSpan();
+    unsigned char* outPtr = outIter.BeginSpan();
+    const bool inStencil = outIter.IsInStencil();
+    for (; inPtr != inEnd; inPtr += numberOfComponents, outPtr += 4)
+      {
+      const T value = *inPtr;
+      unsigned char luminance;
+      if (value <= lower)
+        {
+        luminance = lowerValue;
+        }
+      else if (value >= upper)
+        {
+        luminance = upperValue;
+        }
+      else
+        {
+        luminance = static_cast<unsigned char>((value + shift) * scale);
+        }
+      const unsigned char* color = colors + 4 * luminance;
+      outPtr[0] = color[0];
+      outPtr[1] = color[1];
+      outPtr[2] = color[2];
+      const bool visible = inStencil && color[3] != 0 &&
+        (!applyThreshold || (lowerThreshold <= value && value <= upperThreshold));
+      outPtr[3] = visible ? 255 : 0;
+      }
+    inIter.NextSpan();
+    outIter.NextSpan();
+    }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+void vtkImageMapToWindowLevelThresholdColors::ThreadedRequestData(
+  vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector,
+  vtkInformationVector* vtkNotUsed(outputVector),
+  vtkImageData*** inData,
+  vtkImageData** outData,
+  int outExt[6], int threadId)
+{
+  vtkImageData* input = inData[0][0];
+  vtkImageData* output = outData[0];
+  if (!input || !input->GetPointData()->GetScalars())
+    {
+    return;
+    }
+  vtkImageStencilData* stencil = NULL;
+  if (inputVector[1]->GetNumberOfInformationObjects() > 0)
+    {
+    stencil = vtkImageStencilData::SafeDownCast(
+      inputVector[1]->GetInformationObject(0)->Get(vtkDataObject::DATA_OBJECT()));
+    }
+
+  switch (input->GetScalarType())
+    {
+    vtkTemplateMacro(
+      vtkImageMapToWindowLevelThresholdColorsExecute(this, input, output, stencil,
+        this->Colors, outExt, threadId, static_cast<VTK_TT*>(0)));
+    default:
+      vtkErrorMacro("ThreadedRequestData: Unknown input ScalarType");
+      return;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageMapToWindowLevelThresholdColors::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Window: " << this->Window << "\n";
+  os << indent << "Level: " << this->Level << "\n";
+  os << indent << "LowerThreshold: " << this->LowerThreshold << "\n";
+  os << indent << "UpperThreshold: " << this->UpperThreshold << "\n";
+  os << indent << "ApplyThreshold: " << this->ApplyThreshold << "\n";
+  os << indent << "LookupTable: " << this->LookupTable << "\n";
+}
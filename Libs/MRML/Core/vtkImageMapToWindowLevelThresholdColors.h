@@ -0,0 +1,106 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#ifndef __vtkImageMapToWindowLevelThresholdColors_h
+#define __vtkImageMapToWindowLevelThresholdColors_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkThreadedImageAlgorithm.h>
+
+class vtkAlgorithmOutput;
+class vtkScalarsToColors;
+
+/// \brief Map scalars to RGBA colors in one pass.
+///
+/// Computes in a single multithreaded pass the output of the pipeline
+/// vtkImageMapToWindowLevelColors (luminance) -> vtkImageMapToColors (RGBA),
+/// where the output alpha is 255 only for the voxels whose color alpha is not
+/// 0, that are inside the optional stencil and, if ApplyThreshold is on, whose
+/// value is between LowerThreshold and UpperThreshold; alpha is 0 otherwise.
+/// Only the first component of the input is used. The lookup table is
+/// evaluated once per execution for the 256 window/level luminances, the
+/// output is unsigned char with 4 components.
+class VTK_MRML_EXPORT vtkImageMapToWindowLevelThresholdColors : public vtkThreadedImageAlgorithm
+{
+public:
+  static vtkImageMapToWindowLevelThresholdColors *New();
+  vtkTypeMacro(vtkImageMapToWindowLevelThresholdColors,vtkThreadedImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  ///
+  /// Window and level used to map the input scalars to luminances.
+  vtkSetMacro(Window, double);
+  vtkGetMacro(Window, double);
+  vtkSetMacro(Level, double);
+  vtkGetMacro(Level, double);
+
+  ///
+  /// Lookup table used to map the luminances to colors. Grey ramp if NULL.
+  virtual void SetLookupTable(vtkScalarsToColors* lookupTable);
+  vtkGetObjectMacro(LookupTable, vtkScalarsToColors);
+
+  ///
+  /// Voxels with a value outside of [LowerThreshold, UpperThreshold] are
+  /// transparent when ApplyThreshold is on.
+  vtkSetMacro(LowerThreshold, double);
+  vtkGetMacro(LowerThreshold, double);
+  vtkSetMacro(UpperThreshold, double);
+  vtkGetMacro(UpperThreshold, double);
+  vtkSetMacro(ApplyThreshold, int);
+  vtkGetMacro(ApplyThreshold, int);
+  vtkBooleanMacro(ApplyThreshold, int);
+
+  ///
+  /// Optional stencil, the voxels outside of the stencil are transparent.
+  void SetStencilConnection(vtkAlgorithmOutput* stencilConnection);
+  vtkAlgorithmOutput* GetStencilConnection();
+
+  ///
+  /// Take the lookup table modification time into account.
+  virtual vtkMTimeType GetMTime();
+
+protected:
+  vtkImageMapToWindowLevelThresholdColors();
+  ~vtkImageMapToWindowLevelThresholdColors();
+
+  virtual int FillInputPortInformation(int port, vtkInformation* info);
+  virtual int RequestInformation(vtkInformation* request,
+                                 vtkInformationVector** inputVector,
+                                 vtkInformationVector* outputVector);
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
+  virtual void ThreadedRequestData(vtkInformation* request,
+                                   vtkInformationVector** inputVector,
+                                   vtkInformationVector* outputVector,
+                                   vtkImageData*** inData,
+                                   vtkImageData** outData,
+                                   int outExt[6], int threadId);
+
+  double Window;
+  double Level;
+  vtkScalarsToColors* LookupTable;
+  double LowerThreshold;
+  double UpperThreshold;
+  int ApplyThreshold;
+
+  /// RGBA colors of the 256 luminances, computed in RequestData
+  unsigned char Colors[256 * 4];
+
+private:
+  vtkImageMapToWindowLevelThresholdColors(const vtkImageMapToWindowLevelThresholdColors&);  // Not implemented.
+  void operator=(const vtkImageMapToWindowLevelThresholdColors&);  // Not implemented.
+};
+
+#endif
@@ -42,6 +42,8 @@ vtkMRMLColorNode::vtkMRMLColorNode()
   this->SetNoName("(none)");
 
   this->NamesInitialised = 0;
+  this->DeferredRead = false;
+  this->ColorIndexByNameNumberOfColors = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -139,6 +141,7 @@ void vtkMRMLColorNode::Copy(vtkMRMLNode *anode)
 
   Superclass::Copy(anode);
   vtkMRMLColorNode *node = (vtkMRMLColorNode *) anode;
+  node->ReadDeferredColors();
 
   if (node->Type != -1)
     {
@@ -151,6 +154,7 @@ void vtkMRMLColorNode::Copy(vtkMRMLNode *anode)
 
   // copy names
   this->Names = node->Names;
+  this->ResetColorIndexByName();
 
   this->NamesInitialised = node->NamesInitialised;
 
@@ -175,6 +179,8 @@ void vtkMRMLColorNode::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Names array initialised: " << (this->GetNamesInitialised() ? "true" : "false") << "\n";
 
+  os << indent << "DeferredRead: " << (this->DeferredRead ? "true" : "false") << "\n";
+
   if (this->Names.size() > 0)
     {
     os << indent << "Color Names:\n";
@@ -275,6 +281,7 @@ void vtkMRMLColorNode::SetNamesFromColors()
   const int numPoints = this->GetNumberOfColors();
   // reset the names
   this->Names.resize(numPoints);
+  this->ResetColorIndexByName();
 
   for (int i = 0; i < numPoints; ++i)
     {
@@ -351,6 +358,8 @@ bool vtkMRMLColorNode::HasNameFromColor(int index)
 //---------------------------------------------------------------------------
 const char *vtkMRMLColorNode::GetColorName(int ind)
 {
+  this->ReadDeferredColors();
+
   if (!this->GetNamesInitialised())
     {
     this->SetNamesFromColors();
@@ -383,20 +392,42 @@ int vtkMRMLColorNode::GetColorIndexByName(const char *name)
     return -1;
     }
 
+  this->ReadDeferredColors();
+
   if (!this->GetNamesInitialised())
     {
     this->SetNamesFromColors();
     }
 
-  std::string strName = name;
-  for (int i = 0; i < this->GetNumberOfColors(); ++i)
+  const int numberOfColors = this->GetNumberOfColors();
+  const std::string noName = this->NoName ? this->NoName : "";
+  if (this->ColorIndexByNameNumberOfColors != numberOfColors ||
+      this->ColorIndexByNameNoName != noName)
     {
-    if (strName == this->GetColorName(i))
+    this->ResetColorIndexByName();
+    }
+  if (this->ColorIndexByName.empty())
+    {
+    for (int i = 0; i < numberOfColors; ++i)
       {
-      return i;
+      // insert() doesn't replace the index of a name already found
+      this->ColorIndexByName.insert(
+        std::pair<std::string, int>(this->GetColorName(i), i));
       }
+    this->ColorIndexByNameNumberOfColors = numberOfColors;
+    this->ColorIndexByNameNoName = noName;
     }
-  return -1;
+
+  std::map<std::string, int>::const_iterator it =
+    this->ColorIndexByName.find(name);
+  return it != this->ColorIndexByName.end() ? it->second : -1;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLColorNode::ResetColorIndexByName()
+{
+  this->ColorIndexByName.clear();
+  this->ColorIndexByNameNumberOfColors = 0;
 }
 
 //---------------------------------------------------------------------------
@@ -442,6 +473,8 @@ std::string vtkMRMLColorNode::GetColorNameAsFileName(int colorIndex, const char
 //---------------------------------------------------------------------------
 int vtkMRMLColorNode::SetColorName(int ind, const char *name)
 {
+  this->ReadDeferredColors();
+
   if (ind >= static_cast<int>(this->Names.size()) || ind < 0)
     {
     vtkErrorMacro("ERROR: SetColorName, index was out of bounds: "<< ind << ", current size is " << this->Names.size() << ", table name = " << (this->GetName() == NULL ? "null" : this->GetName()));
@@ -451,6 +484,7 @@ int vtkMRMLColorNode::SetColorName(int ind, const char *name)
   if (this->Names[ind] != newName)
     {
     this->Names[ind] = newName;
+    this->ResetColorIndexByName();
     this->StorableModifiedTime.Modified();
     // TBD: fire Modified?
     }
@@ -479,6 +513,7 @@ int vtkMRMLColorNode::SetColorNameWithSpaces(int ind, const char *name, const ch
 //---------------------------------------------------------------------------
 int vtkMRMLColorNode::GetNumberOfColors()
 {
+  this->ReadDeferredColors();
   return static_cast<int>(this->Names.size());
 }
 
@@ -499,7 +534,37 @@ void vtkMRMLColorNode::Reset(vtkMRMLNode* vtkNotUsed(defaultNode))
 //---------------------------------------------------------------------------
 bool vtkMRMLColorNode::GetModifiedSinceRead()
 {
+  if (this->DeferredRead)
+    {
+    // colors have not been read yet, they can't have been modified
+    return false;
+    }
   return this->Superclass::GetModifiedSinceRead() ||
     (this->GetScalarsToColors() &&
      this->GetScalarsToColors()->GetMTime() > this->GetStoredTime());
 }
+
+//---------------------------------------------------------------------------
+bool vtkMRMLColorNode::ReadDeferredColors()
+{
+  if (!this->DeferredRead)
+    {
+    return true;
+    }
+  // Reset the flag first: reading the file accesses the colors.
+  this->DeferredRead = false;
+  vtkMRMLStorageNode* storageNode = this->GetStorageNode();
+  if (storageNode == NULL)
+    {
+    vtkErrorMacro("ReadDeferredColors: no storage node to read the colors from");
+    return false;
+    }
+  vtkDebugMacro("ReadDeferredColors: reading " << (storageNode->GetFileName() ? storageNode->GetFileName() : ""));
+  if (storageNode->ReadData(this) == 0)
+    {
+    vtkErrorMacro("ReadDeferredColors: unable to read colors from file "
+                  << (storageNode->GetFileName() ? storageNode->GetFileName() : ""));
+    return false;
+    }
+  return true;
+}
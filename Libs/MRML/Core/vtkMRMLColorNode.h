@@ -23,6 +23,7 @@ class vtkLookupTable;
 class vtkScalarsToColors;
 
 // Std includes
+#include <map>
 #include <string>
 #include <vector>
 
@@ -115,7 +116,10 @@ public:
   const char *GetColorName(int ind);
 
   /// Return the index associated with this color name, which can then be used
-  /// to get the colour. Returns -1 on failure.
+  /// to get the colour. Returns -1 on failure. If several colors have the
+  /// same name, the lowest index is returned.
+  /// The name to index map is built at the first call and kept until the
+  /// names change, label atlases can have tens of thousands of colors.
   /// \sa GetColorName()
   int GetColorIndexByName(const char *name);
 
@@ -188,6 +192,22 @@ public:
   /// \sa vtkMRMLStorableNode::GetModifiedSinceRead()
   virtual bool GetModifiedSinceRead();
 
+  /// Get/Set the flag deferring the reading of the colors from the storage
+  /// node until they are first accessed (GetLookupTable(), GetColor(),
+  /// GetColorName()...). The flag is reset once the colors are read.
+  /// Used for the default color table nodes read from files, only a few of
+  /// them are used in a session.
+  /// False by default.
+  /// \sa ReadDeferredColors()
+  vtkGetMacro(DeferredRead, bool);
+  vtkSetMacro(DeferredRead, bool);
+  vtkBooleanMacro(DeferredRead, bool);
+
+  /// Read the colors from the storage node if their reading was deferred.
+  /// Return false if the colors could not be read.
+  /// \sa GetDeferredRead()
+  bool ReadDeferredColors();
+
   /// The list of valid color node types, added to in subclasses
   /// For backward compatibility, User and File keep the numbers that
   /// were in the ColorTable node
@@ -216,6 +236,10 @@ protected:
   /// \sa GetNoName()
   virtual bool HasNameFromColor(int index);
 
+  /// Must be called when the Names vector is modified directly.
+  /// \sa GetColorIndexByName()
+  void ResetColorIndexByName();
+
   /// Which type of color information does this node hold?
   /// Valid values are in the enumerated list
   int Type;
@@ -228,6 +252,9 @@ protected:
   /// A file name to read text attributes from
   char *FileName;
 
+  /// Colors still have to be read from the storage node
+  bool DeferredRead;
+
   ///
   /// the string used for an unnamed colour
   char *NoName;
@@ -235,6 +262,13 @@ protected:
   ///
   /// Have the colour names been set? Used to do lazy copy of the Names array.
   int NamesInitialised;
+
+  /// Lowest index of each color name, empty until GetColorIndexByName() is
+  /// called. NoName and the number of colors it was built with are kept to
+  /// detect changes not done with SetColorName().
+  std::map<std::string, int> ColorIndexByName;
+  std::string ColorIndexByNameNoName;
+  int ColorIndexByNameNumberOfColors;
 };
 
 #endif
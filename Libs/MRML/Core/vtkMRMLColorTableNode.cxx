@@ -178,9 +178,9 @@ void vtkMRMLColorTableNode::Copy(vtkMRMLNode *anode)
 
   Superclass::Copy(anode);
   vtkMRMLColorTableNode *node = (vtkMRMLColorTableNode *) anode;
-  if (node->LookupTable)
+  if (node->GetLookupTable())
     {
-    this->SetLookupTable(node->LookupTable);
+    this->SetLookupTable(node->GetLookupTable());
     }
   this->EndModify(disabledModify);
 
@@ -1088,6 +1088,7 @@ void vtkMRMLColorTableNode::SetType(int type)
       this->GetLookupTable()->SetTableRange(0,255);
       this->Names.clear();
       this->Names.resize(this->GetLookupTable()->GetNumberOfTableValues());
+      this->ResetColorIndexByName();
 
       if (this->SetColorName(0, "Black") != 0)
         {
@@ -1238,6 +1239,13 @@ void vtkMRMLColorTableNode::SetType(int type)
     this->InvokeEvent(vtkMRMLColorTableNode::TypeModifiedEvent);
 }
 
+//---------------------------------------------------------------------------
+vtkLookupTable* vtkMRMLColorTableNode::GetLookupTable()
+{
+  this->ReadDeferredColors();
+  return this->LookupTable;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLColorTableNode::SetNumberOfColors(int n)
 {
@@ -1266,6 +1274,7 @@ void vtkMRMLColorTableNode::SetNumberOfColors(int n)
   if (this->Names.size() != (unsigned int)n)
     {
     this->Names.resize(n);
+    this->ResetColorIndexByName();
     }
 
   this->Modified();
@@ -1398,6 +1407,7 @@ bool vtkMRMLColorTableNode::GetColor(int entry, double color[4])
 void vtkMRMLColorTableNode::ClearNames()
 {
   this->Names.clear();
+  this->ResetColorIndexByName();
   this->NamesInitialisedOff();
 }
 
@@ -52,7 +52,9 @@ public:
   /// Get node XML tag name (like Volume, Model)
   virtual const char* GetNodeTagName() {return "ColorTable";};
 
-  vtkGetObjectMacro(LookupTable, vtkLookupTable);
+  /// Return the lookup table, reading it first if its reading was deferred.
+  /// \sa vtkMRMLColorNode::GetDeferredRead()
+  virtual vtkLookupTable* GetLookupTable();
   virtual void SetLookupTable(vtkLookupTable* newLookupTable);
 
   ///
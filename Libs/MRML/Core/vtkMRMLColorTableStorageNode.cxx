@@ -23,16 +23,97 @@ Version:   $Revision: 1.6 $
 #include <vtkStringArray.h>
 
 // STD include
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
 #include <sstream>
+#include <vector>
 
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLColorTableStorageNode);
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+struct ColorTableEntry
+{
+  ColorTableEntry() : ID(0)
+  {
+    RGBA[0] = RGBA[1] = RGBA[2] = RGBA[3] = 0.0;
+  }
+  int ID;
+  std::string Name;
+  double RGBA[4];
+};
+
+//----------------------------------------------------------------------------
+// Skip the white spaces before \a end, the end of the line.
+const char* SkipSpaces(const char* p, const char* end)
+{
+  while (p < end && isspace(static_cast<unsigned char>(*p)))
+    {
+    ++p;
+    }
+  return p;
+}
+
+//----------------------------------------------------------------------------
+// Parse a "id name r g b a" line ending at \a end. Missing or invalid values
+// are left to 0. Return false if the line has less than 6 values.
+bool ParseColorTableLine(const char* p, const char* end, ColorTableEntry& entry)
+{
+  p = SkipSpaces(p, end);
+  if (p == end)
+    {
+    return false;
+    }
+  char* valueEnd = 0;
+  long id = strtol(p, &valueEnd, 10);
+  if (valueEnd == p || valueEnd > end)
+    {
+    return false;
+    }
+  entry.ID = static_cast<int>(id);
+  p = SkipSpaces(valueEnd, end);
+  const char* nameStart = p;
+  while (p < end && !isspace(static_cast<unsigned char>(*p)))
+    {
+    ++p;
+    }
+  entry.Name.assign(nameStart, p);
+  if (p == nameStart)
+    {
+    return false;
+    }
+  for (int c = 0; c < 4; ++c)
+    {
+    // values never span lines as the spaces are skipped first
+    p = SkipSpaces(p, end);
+    if (p == end)
+      {
+      return false;
+      }
+    double value = strtod(p, &valueEnd);
+    if (valueEnd == p || valueEnd > end)
+      {
+      return false;
+      }
+    entry.RGBA[c] = value;
+    p = valueEnd;
+    }
+  return true;
+}
+
+}
+
 //----------------------------------------------------------------------------
 vtkMRMLColorTableStorageNode::vtkMRMLColorTableStorageNode()
 {
-  // use 32K as a maximum color id for now
-  this->MaximumColorID = 32768;
+  // allow the labels of all the unsigned short label maps
+  this->MaximumColorID = 65535;
   this->DefaultWriteFileExtension = "ctbl";
 }
 
@@ -67,165 +148,138 @@ int vtkMRMLColorTableStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     vtkErrorMacro("ReadData: unable to cast input node " << refNode->GetID() << " to a known color table node");
     return 0;
     }
-  // open the file for reading input
+  // read the whole file at once, parsing line by line with string streams
+  // is slow for the large label atlases
   fstream fstr;
+  fstr.open(fullName.c_str(), fstream::in | fstream::binary);
+  if (!fstr.is_open())
+    {
+    vtkErrorMacro("ERROR opening colour file " << this->FileName << endl);
+    return 0;
+    }
+  std::string contents((std::istreambuf_iterator<char>(fstr)),
+                       std::istreambuf_iterator<char>());
+  fstr.close();
 
-  fstr.open(fullName.c_str(), fstream::in);
-
-  if (fstr.is_open())
+  // parse the valid lines, the table is set up once the max id is known
+  std::vector<ColorTableEntry> entries;
+  int maxID = 0;
+  const char* lineStart = contents.c_str();
+  const char* contentsEnd = lineStart + contents.size();
+  while (lineStart < contentsEnd)
     {
-    // clear out the table
-    int wasModifying = colorNode->StartModify();
-    colorNode->SetTypeToFile();
-    colorNode->NamesInitialisedOff();
-
-    char line[1024];
-    // save the valid lines in a vector, parse them once know the max id
-    std::vector<std::string>lines;
-    int maxID = 0;
-    while (fstr.good())
+    const char* lineEnd = std::find(lineStart, contentsEnd, '\n');
+    if (*lineStart == '#')
       {
-      fstr.getline(line, 1024);
-
-      // does it start with a #?
-      if (line[0] == '#')
+      // sanity check: does the procedural header match?
+      if (strncmp(lineStart, "# Color procedural file", 23) == 0)
         {
-        vtkDebugMacro("Comment line, skipping:\n\"" << line << "\"");
-        // sanity check: does the procedural header match?
-        if (strncmp(line, "# Color procedural file", 23) == 0)
-          {
-          vtkErrorMacro("ReadDataInternal:\nfound a comment that this file "
-                        << " is a procedural color file, returning:\n"
-                        << line);
-          return 0;
-          }
+        vtkErrorMacro("ReadDataInternal:\nfound a comment that this file "
+                      << " is a procedural color file, returning:\n"
+                      << std::string(lineStart, lineEnd));
+        return 0;
         }
-      else
+      }
+    else if (SkipSpaces(lineStart, lineEnd) == lineEnd)
+      {
+      // empty line, skipping
+      }
+    else
+      {
+      ColorTableEntry entry;
+      if (!ParseColorTableLine(lineStart, lineEnd, entry))
+        {
+        vtkDebugMacro("ReadDataInternal: missing values in line \""
+                      << std::string(lineStart, lineEnd) << "\"");
+        }
+      if (entry.ID > maxID)
         {
-        // is it empty?
-        if (line[0] == '\0')
-          {
-          vtkDebugMacro("Empty line, skipping:\n\"" << line << "\"");
-          }
-        else
-          {
-          vtkDebugMacro("got a line: \n\"" << line << "\"");
-          lines.push_back(std::string(line));
-          std::stringstream ss;
-          ss << line;
-          int id;
-          ss >> id;
-          if (id > maxID)
-            {
-            maxID = id;
-            }
-          }
+        maxID = entry.ID;
         }
+      entries.push_back(entry);
       }
-    fstr.close();
-    // now parse out the valid lines and set up the colour lookup table
-    vtkDebugMacro("The largest id is " << maxID);
-    if (maxID > this->MaximumColorID)
+    lineStart = lineEnd + 1;
+    }
+
+  // now set up the colour lookup table
+  vtkDebugMacro("The largest id is " << maxID);
+  int wasModifying = colorNode->StartModify();
+  colorNode->SetTypeToFile();
+  colorNode->NamesInitialisedOff();
+  if (maxID > this->MaximumColorID)
+    {
+    vtkErrorMacro("ReadData: maximum color id " << maxID << " is > "
+                  << this->MaximumColorID << ", invalid color file: "
+                  << this->GetFileName());
+    colorNode->SetNumberOfColors(0);
+    colorNode->EndModify(wasModifying);
+    return 0;
+    }
+  // extra one for zero, also resizes the names array
+  colorNode->SetNumberOfColors(maxID + 1);
+  if (colorNode->GetLookupTable())
+    {
+    colorNode->GetLookupTable()->SetTableRange(0, maxID);
+    }
+  // init the table to black/opacity 0 with no name, just in case we're missing values
+  const char *noName = colorNode->GetNoName();
+  for (int i = 0; i < maxID+1; i++)
+    {
+    colorNode->SetColor(i, noName, 0.0, 0.0, 0.0, 0.0);
+    }
+  // We are sure that all the names are initialized here, flag it as such
+  // to prevent unnecessary recomputation
+  colorNode->NamesInitialisedOn();
+  // do a little sanity check, if never get an rgb bigger than 1.0, report
+  // it as a possibly miswritten file
+  bool biggerThanOne = false;
+  for (size_t i = 0; i < entries.size(); i++)
+    {
+    ColorTableEntry& entry = entries[i];
+    double* rgba = entry.RGBA;
+    if (!biggerThanOne &&
+        (rgba[0] > 1.0 || rgba[1] > 1.0 || rgba[2] > 1.0))
       {
-      vtkErrorMacro("ReadData: maximum color id " << maxID << " is > "
-                    << this->MaximumColorID << ", invalid color file: "
-                    << this->GetFileName());
-      colorNode->SetNumberOfColors(0);
-      colorNode->EndModify(wasModifying);
-      return 0;
+      biggerThanOne = true;
       }
-    // extra one for zero, also resizes the names array
-    colorNode->SetNumberOfColors(maxID + 1);
-    if (colorNode->GetLookupTable())
+    // the file values are 0-255, colour look up table needs 0-1
+    // clamp the colors just in case
+    for (int c = 0; c < 4; ++c)
       {
-      colorNode->GetLookupTable()->SetTableRange(0, maxID);
+      rgba[c] = rgba[c] > 255.0 ? 255.0 : rgba[c];
+      rgba[c] = rgba[c] < 0.0 ? 0.0 : rgba[c];
+      // now shift to 0-1
+      rgba[c] = rgba[c] / 255.0;
       }
-    // init the table to black/opacity 0 with no name, just in case we're missing values
-    const char *noName = colorNode->GetNoName();
-    for (int i = 0; i < maxID+1; i++)
+    // if the name has ticks around it, from copying from a mrml file, trim
+    // them off the string
+    std::string& name = entry.Name;
+    if (name.find("'") != std::string::npos)
       {
-      colorNode->SetColor(i, noName, 0.0, 0.0, 0.0, 0.0);
+      size_t firstnottick = name.find_first_not_of("'");
+      size_t lastnottick = name.find_last_not_of("'");
+      std::string withoutTicks = firstnottick == std::string::npos ? std::string() :
+        name.substr(firstnottick, (lastnottick-firstnottick) + 1);
+      vtkDebugMacro("ReadDataInternal: Found ticks around name \"" << name << "\", using name without ticks instead:  \"" << withoutTicks << "\"");
+      name = withoutTicks;
       }
-    // We are sure that all the names are initialized here, flag it as such
-    // to prevent unnecessary recomputation
-    colorNode->NamesInitialisedOn();
-    // do a little sanity check, if never get an rgb bigger than 1.0, report
-    // it as a possibly miswritten file
-    bool biggerThanOne = false;
-    for (unsigned int i = 0; i < lines.size(); i++)
+    if (i < 10)
       {
-      std::stringstream ss;
-      ss << lines[i];
-      int id = 0;
-      std::string name;
-      double r = 0.0, g = 0.0, b = 0.0, a = 0.0;
-      ss >> id;
-      ss >> name;
-      ss >> r;
-      ss >> g;
-      ss >> b;
-      // check that there's still something left in the stream
-      if (ss.str().length() == 0)
-        {
-        std::cout << "Error in parsing line " << i << ", no alpha information!" << std::endl;
-        }
-      else
-        {
-        ss >> a;
-        }
-      if (!biggerThanOne &&
-          (r > 1.0 || g > 1.0 || b > 1.0))
-        {
-        biggerThanOne = true;
-        }
-      // the file values are 0-255, colour look up table needs 0-1
-      // clamp the colors just in case
-      r = r > 255.0 ? 255.0 : r;
-      r = r < 0.0 ? 0.0 : r;
-      g = g > 255.0 ? 255.0 : g;
-      g = g < 0.0 ? 0.0 : g;
-      b = b > 255.0 ? 255.0 : b;
-      b = b < 0.0 ? 0.0 : b;
-      a = a > 255.0 ? 255.0 : a;
-      a = a < 0.0 ? 0.0 : a;
-      // now shift to 0-1
-      r = r / 255.0;
-      g = g / 255.0;
-      b = b / 255.0;
-      a = a / 255.0;
-      // if the name has ticks around it, from copying from a mrml file, trim
-      // them off the string
-      if (name.find("'") != std::string::npos)
-        {
-        size_t firstnottick = name.find_first_not_of("'");
-        size_t lastnottick = name.find_last_not_of("'");
-        std::string withoutTicks = name.substr(firstnottick, (lastnottick-firstnottick) + 1);
-        vtkDebugMacro("ReadDataInternal: Found ticks around name \"" << name << "\", using name without ticks instead:  \"" << withoutTicks << "\"");
-        name = withoutTicks;
-        }
-      if (i < 10)
-        {
-        vtkDebugMacro("(first ten) Adding colour at id " << id << ", name = " << name.c_str() << ", r = " << r << ", g = " << g << ", b = " << b << ", a = " << a);
-        }
-      if (colorNode->SetColor(id, name.c_str(), r, g, b, a) == 0)
-        {
-        vtkWarningMacro("ReadData: unable to set color " << id << " with name " << name.c_str() << ", breaking the loop over " << lines.size() << " lines in the file " << this->FileName);
-        colorNode->EndModify(wasModifying);
-        return 0;
-        }
-      colorNode->SetColorNameWithSpaces(id, name.c_str(), "_");
+      vtkDebugMacro("(first ten) Adding colour at id " << entry.ID << ", name = " << name.c_str() << ", r = " << rgba[0] << ", g = " << rgba[1] << ", b = " << rgba[2] << ", a = " << rgba[3]);
       }
-    if (lines.size() > 0 && !biggerThanOne)
+    if (colorNode->SetColor(entry.ID, name.c_str(), rgba[0], rgba[1], rgba[2], rgba[3]) == 0)
       {
-      vtkWarningMacro("ReadDataInternal: possibly malformed colour table file:\n" << this->FileName << ".\n\tNo RGB values are greater than 1. Valid values are 0-255");
+      vtkWarningMacro("ReadData: unable to set color " << entry.ID << " with name " << name.c_str() << ", breaking the loop over " << entries.size() << " lines in the file " << this->FileName);
+      colorNode->EndModify(wasModifying);
+      return 0;
       }
-    colorNode->EndModify(wasModifying);
+    colorNode->SetColorNameWithSpaces(entry.ID, name.c_str(), "_");
     }
-  else
+  if (entries.size() > 0 && !biggerThanOne)
     {
-    vtkErrorMacro("ERROR opening colour file " << this->FileName << endl);
-    return 0;
+    vtkWarningMacro("ReadDataInternal: possibly malformed colour table file:\n" << this->FileName << ".\n\tNo RGB values are greater than 1. Valid values are 0-255");
     }
+  colorNode->EndModify(wasModifying);
 
   return 1;
 }
@@ -319,6 +319,12 @@ vtkAlgorithmOutput* vtkMRMLDiffusionTensorVolumeDisplayNode
     this->DTIMathematics->GetInputConnection(0, 0) : 0;
 }
 
+//----------------------------------------------------------------------------
+vtkAlgorithmOutput* vtkMRMLDiffusionTensorVolumeDisplayNode::GetOutputImageDataConnection()
+{
+  return this->AppendComponents->GetOutputPort();
+}
+
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 vtkAlgorithmOutput* vtkMRMLDiffusionTensorVolumeDisplayNode::GetBackgroundImageStencilDataConnection()
@@ -147,6 +147,9 @@ class VTK_MRML_EXPORT vtkMRMLDiffusionTensorVolumeDisplayNode : public vtkMRMLGl
   /// Get the input of the pipeline
   virtual vtkAlgorithmOutput* GetInputImageDataConnection();
 
+  /// Get the output of the pipeline, built from the AppendComponents filter
+  virtual vtkAlgorithmOutput* GetOutputImageDataConnection();
+
   ///
   /// Get background mask stencil
   /// Reimplemented to return 0 when the background mask is not used.
@@ -14,6 +14,7 @@ Version:   $Revision: 1.2 $
 
 // MRML includes
 #include "vtkMRMLDiffusionWeightedVolumeDisplayNode.h"
+#include "vtkImageMapToWindowLevelThresholdColors.h"
 
 // VTK includes
 #include <vtkImageAppendComponents.h>
@@ -38,6 +39,8 @@ vtkMRMLDiffusionWeightedVolumeDisplayNode::vtkMRMLDiffusionWeightedVolumeDisplay
   this->Threshold->SetInputConnection( this->ExtractComponent->GetOutputPort());
   this->MapToWindowLevelColors->SetInputConnection(
     this->ExtractComponent->GetOutputPort());
+  this->WindowLevelThresholdColors->SetInputConnection(
+    this->ExtractComponent->GetOutputPort());
 }
 
 //----------------------------------------------------------------------------
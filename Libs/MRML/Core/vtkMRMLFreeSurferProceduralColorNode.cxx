@@ -105,6 +105,7 @@ void vtkMRMLFreeSurferProceduralColorNode::ReadXMLAttributes(const char** atts)
       this->LookupTable->SetNumberOfColors(numColors);
       this->Names.clear();
       this->Names.resize(numColors);
+      this->ResetColorIndexByName();
       }
     else if (!strcmp(attName, "colors"))
       {
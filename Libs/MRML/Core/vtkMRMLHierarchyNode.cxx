@@ -172,6 +172,9 @@ void vtkMRMLHierarchyNode::Copy(vtkMRMLNode *anode)
   //this->SetParentNodeID(node->ParentNodeIDReference);
   this->SetParentNodeIDReference(node->ParentNodeIDReference);
   this->SetAssociatedNodeIDReference(node->AssociatedNodeIDReference);
+  // references are set directly, the cached maps have to be rebuilt
+  this->HierarchyIsModified(this->GetScene());
+  this->AssociatedHierarchyIsModified(this->GetScene());
   this->SortingValue = node->SortingValue;
   this->SetAllowMultipleChildren(node->AllowMultipleChildren);
 
@@ -211,6 +214,26 @@ void vtkMRMLHierarchyNode::SetSceneReferences()
   this->Scene->AddReferencedNodeID(this->AssociatedNodeIDReference, this);
 }
 
+//-----------------------------------------------------------
+void vtkMRMLHierarchyNode::SetScene(vtkMRMLScene* scene)
+{
+  if (this->Scene == scene)
+    {
+    return;
+    }
+  if (this->Scene)
+    {
+    this->RemoveFromChildrenMap(this->Scene);
+    this->RemoveFromAssociatedToHierarchyMap(this->Scene);
+    }
+  this->Superclass::SetScene(scene);
+  if (this->Scene)
+    {
+    this->AddToChildrenMap(this->Scene);
+    this->AddToAssociatedToHierarchyMap(this->Scene);
+    }
+}
+
 //-----------------------------------------------------------
 void vtkMRMLHierarchyNode::UpdateScene(vtkMRMLScene *scene)
 {
@@ -261,10 +284,11 @@ void vtkMRMLHierarchyNode::SetParentNodeID(const char* ref)
 
   int disableModify = this->StartModify();
 
+  this->RemoveFromChildrenMap(this->GetScene());
   this->SetParentNodeIDReference(ref);
   this->SetSortingValue(++MaximumSortingValue);
+  this->AddToChildrenMap(this->GetScene());
 
-  this->HierarchyIsModified(this->GetScene());
   if (this->GetScene())
     {
     this->GetScene()->AddReferencedNodeID(ref, this);
@@ -576,7 +600,7 @@ void vtkMRMLHierarchyNode::UpdateChildrenMap()
     siter->second.clear();
     }
 
-  if (this->GetScene()->GetNodes()->GetMTime() > titer->second)
+  if (titer->second == 0)
   {
     for (iter  = siter->second.begin();
          iter != siter->second.end();
@@ -597,31 +621,73 @@ void vtkMRMLHierarchyNode::UpdateChildrenMap()
       if (node)
         {
         vtkMRMLHierarchyNode *pnode = vtkMRMLHierarchyNode::SafeDownCast(node->GetParentNode());
-        if (pnode)
+        if (pnode && pnode->GetSortingValue() > maxSortingValue)
+          {
+          maxSortingValue = pnode->GetSortingValue();
+          }
+        // Children are stored by parent node ID, so that adding the parent node
+        // after the children does not invalidate the map.
+        if (node->GetParentNodeID())
           {
-          if (pnode->GetSortingValue() > maxSortingValue)
-            {
-            maxSortingValue = pnode->GetSortingValue();
-            }
-          iter = siter->second.find(std::string(pnode->GetID()));
-          if (iter == siter->second.end())
-            {
-            std::vector< vtkMRMLHierarchyNode *> children;
-            children.push_back(node);
-            siter->second[std::string(pnode->GetID())] = children;
-            }
-          else
-            {
-            iter->second.push_back(node);
-            }
+          siter->second[std::string(node->GetParentNodeID())].push_back(node);
           }
         }
       }
-    titer->second = this->GetScene()->GetNodes()->GetMTime();
+    titer->second = std::max<vtkMTimeType>(this->GetScene()->GetNodes()->GetMTime(), 1);
     this->MaximumSortingValue = maxSortingValue;
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLHierarchyNode::AddToChildrenMap(vtkMRMLScene *scene)
+{
+  if (scene == NULL || this->ParentNodeIDReference == NULL)
+    {
+    return;
+    }
+  std::map< vtkMRMLScene*, vtkMTimeType>::iterator titer =
+    SceneHierarchyChildrenNodesMTime.find(scene);
+  if (titer == SceneHierarchyChildrenNodesMTime.end() || titer->second == 0)
+    {
+    // map will be rebuilt anyway
+    return;
+    }
+  std::vector< vtkMRMLHierarchyNode *>& children =
+    SceneHierarchyChildrenNodes[scene][std::string(this->ParentNodeIDReference)];
+  if (std::find(children.begin(), children.end(), this) == children.end())
+    {
+    children.push_back(this);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLHierarchyNode::RemoveFromChildrenMap(vtkMRMLScene *scene)
+{
+  if (scene == NULL || this->ParentNodeIDReference == NULL)
+    {
+    return;
+    }
+  std::map< vtkMRMLScene*, vtkMTimeType>::iterator titer =
+    SceneHierarchyChildrenNodesMTime.find(scene);
+  if (titer == SceneHierarchyChildrenNodesMTime.end() || titer->second == 0)
+    {
+    return;
+    }
+  HierarchyChildrenNodesType& sceneChildren = SceneHierarchyChildrenNodes[scene];
+  HierarchyChildrenNodesType::iterator iter =
+    sceneChildren.find(std::string(this->ParentNodeIDReference));
+  if (iter == sceneChildren.end())
+    {
+    return;
+    }
+  iter->second.erase(std::remove(iter->second.begin(), iter->second.end(), this),
+    iter->second.end());
+  if (iter->second.empty())
+    {
+    sceneChildren.erase(iter);
+    }
+}
+
 void vtkMRMLHierarchyNode::HierarchyIsModified(vtkMRMLScene *scene)
 {
   if (scene == NULL)
@@ -645,34 +711,28 @@ void vtkMRMLHierarchyNode::GetAssociatedChildrenNodes(vtkCollection *children,
     //vtkErrorMacro("GetChildrenAssociatedNodes: scene is null, cannot find children of this node");
     return;
     }
-  vtkMRMLNode *mnode = NULL;
-  vtkMRMLHierarchyNode *hnode = NULL;
   std::string nodeClass("vtkMRMLNode");
   if (childClass)
     {
     nodeClass = childClass;
     }
 
-  int numNodes = scene->GetNumberOfNodesByClass(nodeClass.c_str());
-  for (int n=0; n < numNodes; n++)
+  // Collect the associated nodes of this node and all its children from the
+  // cached children map instead of looking up the hierarchy of every node of the scene
+  std::vector< vtkMRMLHierarchyNode *> hierarchyNodes;
+  hierarchyNodes.push_back(this);
+  this->GetAllChildrenNodes(hierarchyNodes);
+  for (std::vector< vtkMRMLHierarchyNode *>::iterator hit = hierarchyNodes.begin();
+       hit != hierarchyNodes.end(); ++hit)
     {
-    mnode = scene->GetNthNodeByClass(n, nodeClass.c_str());
-    // check for a hierarchy node for this displayble node
-    hnode = this->GetAssociatedHierarchyNode(this->GetScene(), mnode->GetID());
-    while (hnode)
+    vtkMRMLNode *mnode = (*hit)->vtkMRMLHierarchyNode::GetAssociatedNode();
+    // only count the node if this is the hierarchy node it is associated with
+    if (mnode && mnode->IsA(nodeClass.c_str()) &&
+        this->GetAssociatedHierarchyNode(scene, mnode->GetID()) == *hit)
       {
-      // hnode == this
-      if (hnode->GetID() && this->GetID() &&
-          strcmp(hnode->GetID(), this->GetID()) == 0)
-        {
-        children->AddItem(mnode);
-        break;
-        }
-      // the hierarchy node for this node may not be the one we're checking
-      // against, go up the tree
-      hnode = vtkMRMLHierarchyNode::SafeDownCast(hnode->GetParentNode());
-      }// end while
-    }// end for
+      children->AddItem(mnode);
+      }
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -736,7 +796,7 @@ int vtkMRMLHierarchyNode::UpdateAssociatedToHierarchyMap(vtkMRMLScene *scene)
   std::map< vtkMRMLScene*, vtkMTimeType>::iterator titer =
         SceneAssociatedHierarchyNodesMTime.find(scene);
 
-  if (scene->GetNodes()->GetMTime() > titer->second)
+  if (titer->second == 0)
   {
     siter->second.clear();
 
@@ -746,20 +806,68 @@ int vtkMRMLHierarchyNode::UpdateAssociatedToHierarchyMap(vtkMRMLScene *scene)
     for (int i=0; i<nnodes; i++)
       {
       vtkMRMLHierarchyNode *node =  vtkMRMLHierarchyNode::SafeDownCast(nodes[i]);
-      if (node)
+      // Associations are stored by associated node ID, so that adding the
+      // associated node after the hierarchy node does not invalidate the map.
+      if (node && node->GetAssociatedNodeID())
         {
-        vtkMRMLNode *mnode = node->vtkMRMLHierarchyNode::GetAssociatedNode();
-        if (mnode)
-          {
-          siter->second[std::string(mnode->GetID())] = node;
-          }
+        siter->second[std::string(node->GetAssociatedNodeID())] = node;
         }
       }
-    titer->second = scene->GetNodes()->GetMTime();
+    titer->second = std::max<vtkMTimeType>(scene->GetNodes()->GetMTime(), 1);
   }
   return static_cast<int>(siter->second.size());
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLHierarchyNode::AddToAssociatedToHierarchyMap(vtkMRMLScene *scene)
+{
+  if (scene == NULL || this->AssociatedNodeIDReference == NULL)
+    {
+    return;
+    }
+  std::map< vtkMRMLScene*, vtkMTimeType>::iterator titer =
+    SceneAssociatedHierarchyNodesMTime.find(scene);
+  if (titer == SceneAssociatedHierarchyNodesMTime.end() || titer->second == 0)
+    {
+    return;
+    }
+  AssociatedHierarchyNodesType& sceneAssociations = SceneAssociatedHierarchyNodes[scene];
+  AssociatedHierarchyNodesType::iterator iter =
+    sceneAssociations.find(std::string(this->AssociatedNodeIDReference));
+  if (iter == sceneAssociations.end())
+    {
+    sceneAssociations[std::string(this->AssociatedNodeIDReference)] = this;
+    }
+  else if (iter->second != this)
+    {
+    // multiple hierarchy nodes are associated, let the rebuild choose the same one as before
+    titer->second = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLHierarchyNode::RemoveFromAssociatedToHierarchyMap(vtkMRMLScene *scene)
+{
+  if (scene == NULL || this->AssociatedNodeIDReference == NULL)
+    {
+    return;
+    }
+  std::map< vtkMRMLScene*, vtkMTimeType>::iterator titer =
+    SceneAssociatedHierarchyNodesMTime.find(scene);
+  if (titer == SceneAssociatedHierarchyNodesMTime.end() || titer->second == 0)
+    {
+    return;
+    }
+  AssociatedHierarchyNodesType& sceneAssociations = SceneAssociatedHierarchyNodes[scene];
+  AssociatedHierarchyNodesType::iterator iter =
+    sceneAssociations.find(std::string(this->AssociatedNodeIDReference));
+  if (iter != sceneAssociations.end() && iter->second == this)
+    {
+    // another hierarchy node may be associated with the same node
+    titer->second = 0;
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkMRMLNode* vtkMRMLHierarchyNode::GetAssociatedNode()
 {
@@ -777,8 +885,9 @@ void vtkMRMLHierarchyNode::SetAssociatedNodeID(const char* ref)
   if ((this->AssociatedNodeIDReference && ref && strcmp(ref, this->AssociatedNodeIDReference)) ||
       (this->AssociatedNodeIDReference != ref))
     {
+    this->RemoveFromAssociatedToHierarchyMap(this->GetScene());
     this->SetAssociatedNodeIDReference(ref);
-    this->AssociatedHierarchyIsModified(this->GetScene());
+    this->AddToAssociatedToHierarchyMap(this->GetScene());
     if (this->Scene)
       {
       this->Scene->AddReferencedNodeID(ref, this);
@@ -53,6 +53,10 @@ public:
   /// Set the reference node to current scene.
   virtual void SetSceneReferences();
 
+  /// Reimplemented to keep the cached children and associated node maps of
+  /// the scene up-to-date when the node is added to or removed from the scene.
+  virtual void SetScene(vtkMRMLScene* scene);
+
   ///
   /// Updates this node if it depends on other nodes
   /// when the node is deleted in the scene
@@ -182,11 +186,23 @@ protected:
   /// Mark hierarchy as modified when you
   static void HierarchyIsModified(vtkMRMLScene *scene);
 
+  /// Add this node to (or remove from) the cached children map of the scene.
+  /// Maps that are already marked as modified are left untouched,
+  /// they are rebuilt when they are accessed next time.
+  void AddToChildrenMap(vtkMRMLScene *scene);
+  void RemoveFromChildrenMap(vtkMRMLScene *scene);
+
 
   ///////////////////////
 
   /// Mark hierarchy as modified
   static void AssociatedHierarchyIsModified(vtkMRMLScene *scene);
+
+  /// Add this node to (or remove from) the cached associated node map of the scene.
+  /// If the association is ambiguous (multiple hierarchy nodes are associated
+  /// with the same node) then the map is marked as modified instead.
+  void AddToAssociatedToHierarchyMap(vtkMRMLScene *scene);
+  void RemoveFromAssociatedToHierarchyMap(vtkMRMLScene *scene);
   ///
   /// String ID of the associated MRML node
   char *AssociatedNodeIDReference;
@@ -196,6 +212,9 @@ protected:
 
   typedef std::map<std::string, std::vector< vtkMRMLHierarchyNode *> > HierarchyChildrenNodesType;
 
+  /// Children of each hierarchy node, keyed by the parent node ID.
+  /// The maps are maintained incrementally as hierarchy nodes are added, removed or
+  /// reparented, and rebuilt only after HierarchyIsModified() is called.
   static std::map< vtkMRMLScene*, HierarchyChildrenNodesType> SceneHierarchyChildrenNodes;
   static std::map< vtkMRMLScene*, vtkMTimeType> SceneHierarchyChildrenNodesMTime;
 
@@ -207,6 +226,9 @@ protected:
 
   typedef std::map<std::string, vtkMRMLHierarchyNode *> AssociatedHierarchyNodesType;
 
+  /// Hierarchy node associated with each node, keyed by the associated node ID.
+  /// Maintained the same way as SceneHierarchyChildrenNodes, rebuilt after
+  /// AssociatedHierarchyIsModified() is called.
   static std::map< vtkMRMLScene*, AssociatedHierarchyNodesType> SceneAssociatedHierarchyNodes;
 
   static std::map< vtkMRMLScene*, vtkMTimeType> SceneAssociatedHierarchyNodesMTime;
@@ -226,6 +248,9 @@ protected:
   /// Invoke the event on the passed node if not null, otherwise on the
   /// associated node if not null.
   void InvokeHierarchyModifiedEvent(vtkMRMLNode *node = NULL);
+
+  /// The scene invalidates its cached maps when it is deleted
+  friend class vtkMRMLScene;
 };
 
 #endif
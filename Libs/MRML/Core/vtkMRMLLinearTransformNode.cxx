@@ -16,6 +16,7 @@ Version:   $Revision: 1.14 $
 #include "vtkMRMLLinearTransformNode.h"
 
 // VTK includes
+#include <vtkCriticalSection.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
@@ -29,6 +30,10 @@ vtkMRMLNodeNewMacro(vtkMRMLLinearTransformNode);
 //----------------------------------------------------------------------------
 vtkMRMLLinearTransformNode::vtkMRMLLinearTransformNode()
 {
+  this->PendingMatrixLock = new vtkSimpleCriticalSection;
+  this->PendingMatrixTransformToParentValid = false;
+  vtkMatrix4x4::Identity(this->PendingMatrixTransformToParent);
+
   vtkNew<vtkMatrix4x4> matrix;
   this->SetMatrixTransformToParent(matrix.GetPointer());
 }
@@ -36,6 +41,7 @@ vtkMRMLLinearTransformNode::vtkMRMLLinearTransformNode()
 //----------------------------------------------------------------------------
 vtkMRMLLinearTransformNode::~vtkMRMLLinearTransformNode()
 {
+  delete this->PendingMatrixLock;
 }
 
 //----------------------------------------------------------------------------
@@ -152,6 +158,53 @@ void vtkMRMLLinearTransformNode::Copy(vtkMRMLNode *anode)
   Superclass::Copy(anode);
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLLinearTransformNode::SetPendingMatrixTransformToParent(vtkMatrix4x4* matrix)
+{
+  // Only 16 values are copied while the lock is held, so the caller
+  // (typically a tracker thread) is never blocked by the rendering.
+  this->PendingMatrixLock->Lock();
+  if (matrix)
+    {
+    vtkMatrix4x4::DeepCopy(this->PendingMatrixTransformToParent, matrix);
+    }
+  else
+    {
+    vtkMatrix4x4::Identity(this->PendingMatrixTransformToParent);
+    }
+  this->PendingMatrixTransformToParentValid = true;
+  this->PendingMatrixLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLLinearTransformNode::HasPendingMatrixTransformToParent()
+{
+  this->PendingMatrixLock->Lock();
+  bool pending = this->PendingMatrixTransformToParentValid;
+  this->PendingMatrixLock->Unlock();
+  return pending;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLLinearTransformNode::ApplyPendingMatrixTransformToParent()
+{
+  vtkNew<vtkMatrix4x4> matrix;
+  this->PendingMatrixLock->Lock();
+  bool pending = this->PendingMatrixTransformToParentValid;
+  if (pending)
+    {
+    matrix->DeepCopy(this->PendingMatrixTransformToParent);
+    this->PendingMatrixTransformToParentValid = false;
+    }
+  this->PendingMatrixLock->Unlock();
+  if (!pending)
+    {
+    return false;
+    }
+  // Events are invoked outside of the lock, observers may take a long time
+  return this->SetMatrixTransformToParent(matrix.GetPointer()) != 0;
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLLinearTransformNode::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -20,6 +20,7 @@
 #include "vtkMRMLTransformNode.h"
 
 class vtkMRMLStorageNode;
+class vtkSimpleCriticalSection;
 class vtkTransform;
 class InternalTransformToParentMatrix;
 
@@ -28,6 +29,13 @@ class InternalTransformToParentMatrix;
 /// Internally, always the TransformToParent matrix is stored and TransformFromParent is computed by inverting
 /// the matrix. It makes the code simpler and faster to hardcode this. ToParent is stored because this is what
 /// we usually display to the user (it is more intuitive than the FromParent resampling transform).
+///
+/// High-rate sources (e.g., tracking devices streaming poses at 60-200 Hz) should not call
+/// SetMatrixTransformToParent for each received pose: each call invokes TransformModifiedEvent,
+/// which updates all the observers (transformed nodes, widgets, displayable managers).
+/// Instead, they can store the latest pose with SetPendingMatrixTransformToParent (which is
+/// thread-safe and does not invoke any event) and the application applies it once per rendered
+/// frame using ApplyPendingMatrixTransformToParent (or vtkSlicerTransformLogic::ApplyPendingTransforms).
 class VTK_MRML_EXPORT vtkMRMLLinearTransformNode : public vtkMRMLTransformNode
 {
   public:
@@ -60,11 +68,37 @@ class VTK_MRML_EXPORT vtkMRMLLinearTransformNode : public vtkMRMLTransformNode
     return Superclass::CreateDefaultStorageNode();
     };
 
+  ///
+  /// Store a matrix that will be set as transform to parent at the next
+  /// ApplyPendingMatrixTransformToParent call. Only the last pending matrix
+  /// is kept, previous ones are discarded.
+  /// The method does not invoke any event and can be called from any thread.
+  /// \sa ApplyPendingMatrixTransformToParent
+  void SetPendingMatrixTransformToParent(vtkMatrix4x4* matrix);
+
+  ///
+  /// Set the last pending matrix as transform to parent (invokes a single
+  /// TransformModifiedEvent however many matrices were set since the last call).
+  /// Must be called from the main thread.
+  /// Returns true if a pending matrix was applied, false if there was none.
+  /// \sa SetPendingMatrixTransformToParent
+  bool ApplyPendingMatrixTransformToParent();
+
+  ///
+  /// Returns true if a matrix has been set by SetPendingMatrixTransformToParent
+  /// and not applied yet.
+  bool HasPendingMatrixTransformToParent();
+
 protected:
   vtkMRMLLinearTransformNode();
   ~vtkMRMLLinearTransformNode();
   vtkMRMLLinearTransformNode(const vtkMRMLLinearTransformNode&);
   void operator=(const vtkMRMLLinearTransformNode&);
+
+  /// Latest matrix set by SetPendingMatrixTransformToParent, protected by PendingMatrixLock.
+  double PendingMatrixTransformToParent[16];
+  bool PendingMatrixTransformToParentValid;
+  vtkSimpleCriticalSection* PendingMatrixLock;
 };
 
 #endif
@@ -27,6 +27,7 @@ Version:   $Revision: 1.6 $
 // VTK includes
 #include <vtkImageChangeInformation.h>
 #include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkStringArray.h>
@@ -39,6 +40,13 @@ vtkMRMLNodeNewMacro(vtkMRMLNRRDStorageNode);
 vtkMRMLNRRDStorageNode::vtkMRMLNRRDStorageNode()
 {
   this->CenterImage = 0;
+  this->CompressionLevel = -1;
+  this->NumberOfThreads = 0;
+  for (int i = 0; i < 3; ++i)
+    {
+    this->ReadExtent[2 * i] = 0;
+    this->ReadExtent[2 * i + 1] = -1;
+    }
   this->DefaultWriteFileExtension = "nhdr";
 }
 
@@ -56,6 +64,14 @@ void vtkMRMLNRRDStorageNode::WriteXML(ostream& of, int nIndent)
   std::stringstream ss;
   ss << this->CenterImage;
   of << indent << " centerImage=\"" << ss.str() << "\"";
+  of << indent << " compressionLevel=\"" << this->CompressionLevel << "\"";
+  of << indent << " numberOfThreads=\"" << this->NumberOfThreads << "\"";
+  if (this->ReadExtent[0] <= this->ReadExtent[1])
+    {
+    of << indent << " readExtent=\"" << this->ReadExtent[0] << " " << this->ReadExtent[1]
+       << " " << this->ReadExtent[2] << " " << this->ReadExtent[3]
+       << " " << this->ReadExtent[4] << " " << this->ReadExtent[5] << "\"";
+    }
 
 }
 
@@ -78,6 +94,33 @@ void vtkMRMLNRRDStorageNode::ReadXMLAttributes(const char** atts)
       ss << attValue;
       ss >> this->CenterImage;
       }
+    else if (!strcmp(attName, "compressionLevel"))
+      {
+      std::stringstream ss;
+      ss << attValue;
+      int compressionLevel = -1;
+      ss >> compressionLevel;
+      this->SetCompressionLevel(compressionLevel);
+      }
+    else if (!strcmp(attName, "numberOfThreads"))
+      {
+      std::stringstream ss;
+      ss << attValue;
+      int numberOfThreads = 0;
+      ss >> numberOfThreads;
+      this->SetNumberOfThreads(numberOfThreads);
+      }
+    else if (!strcmp(attName, "readExtent"))
+      {
+      std::stringstream ss;
+      ss << attValue;
+      int readExtent[6] = { 0, -1, 0, -1, 0, -1 };
+      for (int i = 0; i < 6; ++i)
+        {
+        ss >> readExtent[i];
+        }
+      this->SetReadExtent(readExtent);
+      }
     }
 
   this->EndModify(disabledModify);
@@ -95,6 +138,9 @@ void vtkMRMLNRRDStorageNode::Copy(vtkMRMLNode *anode)
   vtkMRMLNRRDStorageNode *node = (vtkMRMLNRRDStorageNode *) anode;
 
   this->SetCenterImage(node->CenterImage);
+  this->SetCompressionLevel(node->CompressionLevel);
+  this->SetNumberOfThreads(node->NumberOfThreads);
+  this->SetReadExtent(node->ReadExtent);
 
   this->EndModify(disabledModify);
 
@@ -105,6 +151,11 @@ void vtkMRMLNRRDStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   vtkMRMLStorageNode::PrintSelf(os,indent);
   os << indent << "CenterImage:   " << this->CenterImage << "\n";
+  os << indent << "CompressionLevel:   " << this->CompressionLevel << "\n";
+  os << indent << "NumberOfThreads:   " << this->NumberOfThreads << "\n";
+  os << indent << "ReadExtent:   " << this->ReadExtent[0] << " " << this->ReadExtent[1]
+     << " " << this->ReadExtent[2] << " " << this->ReadExtent[3]
+     << " " << this->ReadExtent[4] << " " << this->ReadExtent[5] << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -175,6 +226,8 @@ int vtkMRMLNRRDStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     }
 
   reader->SetFileName(fullName.c_str());
+  reader->SetNumberOfThreads(this->NumberOfThreads);
+  reader->SetReadExtent(this->ReadExtent);
 
   // Check if this is a NRRD file that we can read
   if (!reader->CanReadFile(fullName.c_str()))
@@ -232,8 +285,16 @@ int vtkMRMLNRRDStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 
   reader->Update();
   // set volume attributes
-  vtkMatrix4x4* mat = reader->GetRasToIjkMatrix();
-  volNode->SetRASToIJKMatrix(mat);
+  // The image data extent starts at 0, the region of interest is placed by
+  // the RAS to IJK matrix.
+  int* outputExtent = reader->GetOutput()->GetExtent();
+  vtkNew<vtkMatrix4x4> rasToIjk;
+  rasToIjk->DeepCopy(reader->GetRasToIjkMatrix());
+  for (int i = 0; i < 3; ++i)
+    {
+    rasToIjk->SetElement(i, 3, rasToIjk->GetElement(i, 3) - outputExtent[2 * i]);
+    }
+  volNode->SetRASToIJKMatrix(rasToIjk.GetPointer());
 
   // set measurement frame
   vtkMatrix4x4 *mat2;
@@ -291,6 +352,7 @@ int vtkMRMLNRRDStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
   ici->SetInputConnection(reader->GetOutputPort());
   ici->SetOutputSpacing( 1, 1, 1 );
   ici->SetOutputOrigin( 0, 0, 0 );
+  ici->SetOutputExtentStart( 0, 0, 0 );
   ici->Update();
 
   volNode->SetImageDataConnection(ici->GetOutputPort());
@@ -368,6 +430,8 @@ int vtkMRMLNRRDStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
   writer->SetFileName(fullName.c_str());
   writer->SetInputConnection(volNode->GetImageDataConnection());
   writer->SetUseCompression(this->GetUseCompression());
+  writer->SetCompressionLevel(this->CompressionLevel);
+  writer->SetNumberOfThreads(this->NumberOfThreads);
 
   // set volume attributes
   writer->SetIJKToRASMatrix(ijkToRas.GetPointer());
@@ -396,6 +460,11 @@ int vtkMRMLNRRDStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     vtkErrorMacro("ERROR writing NRRD file " << (writer->GetFileName() == NULL ? "null" : writer->GetFileName()));
     writeFlag = 0;
     }
+  else
+    {
+    // the file now only contains the region that was read
+    this->SetReadExtent(0, -1, 0, -1, 0, -1);
+    }
 
   this->StageWriteData(refNode);
 
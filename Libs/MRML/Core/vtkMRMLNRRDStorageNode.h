@@ -53,6 +53,28 @@ class VTK_MRML_EXPORT vtkMRMLNRRDStorageNode : public vtkMRMLStorageNode
   vtkGetMacro(CenterImage, int);
   vtkSetMacro(CenterImage, int);
 
+  ///
+  /// zlib compression level used when compression is enabled,
+  /// from 0 (fastest) to 9 (smallest file). Default: -1 (zlib default level).
+  vtkSetClampMacro(CompressionLevel, int, -1, 9);
+  vtkGetMacro(CompressionLevel, int);
+
+  ///
+  /// Maximum number of threads used for compressing and decompressing the image data.
+  /// Default: 0 (vtkMultiThreader global default number of threads).
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
+  ///
+  /// Region of interest of the file: only the voxels in this IJK extent
+  /// are read, the volume node geometry is set so that the region is at the
+  /// same place as in the whole image. The volume is written as a whole
+  /// image, so the region is reset after writing.
+  /// An empty extent (default: 0, -1, 0, -1, 0, -1) reads the whole image.
+  /// \sa vtkNRRDReader::SetReadExtent()
+  vtkSetVector6Macro(ReadExtent, int);
+  vtkGetVector6Macro(ReadExtent, int);
+
   ///
   /// Access the nrrd header fields to create a diffusion gradient table
   int ParseDiffusionInformation(vtkNRRDReader *reader,vtkDoubleArray *grad,vtkDoubleArray *bvalues);
@@ -85,6 +107,9 @@ protected:
   virtual int WriteDataInternal(vtkMRMLNode *refNode);
 
   int CenterImage;
+  int CompressionLevel;
+  int NumberOfThreads;
+  int ReadExtent[6];
 
 };
 
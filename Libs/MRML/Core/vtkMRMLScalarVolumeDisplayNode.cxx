@@ -14,6 +14,7 @@ Version:   $Revision: 1.2 $
 
 // MRML includes
 #include "vtkEventBroker.h"
+#include "vtkImageMapToWindowLevelThresholdColors.h"
 #include "vtkMRMLScalarVolumeDisplayNode.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLProceduralColorNode.h"
@@ -23,14 +24,16 @@ Version:   $Revision: 1.2 $
 #include <vtkAlgorithmOutput.h>
 #include <vtkCallbackCommand.h>
 #include <vtkColorTransferFunction.h>
-#include <vtkImageAccumulate.h>
 #include <vtkImageAppendComponents.h>
 #include <vtkImageExtractComponents.h>
 #include <vtkImageBimodalAnalysis.h>
 #include <vtkImageCast.h>
+#include <vtkIdTypeArray.h>
 #include <vtkImageData.h>
+#include <vtkImageHistogram.h>
 #include <vtkImageLogic.h>
 #include <vtkImageMapToWindowLevelColors.h>
+#include <vtkImageShrink3D.h>
 #include <vtkImageStencil.h>
 #include <vtkImageThreshold.h>
 #include <vtkObjectFactory.h>
@@ -104,10 +107,23 @@ vtkMRMLScalarVolumeDisplayNode::vtkMRMLScalarVolumeDisplayNode()
   this->AppendComponents->AddInputConnection(0, this->ExtractRGB->GetOutputPort() );
   this->AppendComponents->AddInputConnection(0, this->AlphaLogic->GetOutputPort() );
 
+  // The filters above are kept for the subclasses that build their own
+  // pipeline, a scalar volume is displayed in one pass.
+  this->WindowLevelThresholdColors = vtkImageMapToWindowLevelThresholdColors::New();
+  this->WindowLevelThresholdColors->SetWindow(this->MapToWindowLevelColors->GetWindow());
+  this->WindowLevelThresholdColors->SetLevel(this->MapToWindowLevelColors->GetLevel());
+  this->WindowLevelThresholdColors->SetLowerThreshold(this->Threshold->GetLowerThreshold());
+  this->WindowLevelThresholdColors->SetUpperThreshold(this->Threshold->GetUpperThreshold());
 
   this->Bimodal = NULL;
-  this->Accumulate = NULL;
+  this->Histogram = NULL;
+  this->HistogramSampling = NULL;
+  this->HistogramImage = NULL;
+  this->AutoLevelsMaximumNumberOfSamples = 1 << 24;
   this->IsInCalculateAutoLevels = false;
+  this->BimodalImageData = NULL;
+  this->BimodalImageDataMTime = 0;
+  this->BimodalFailed = false;
 
   vtkEventBroker::GetInstance()->AddObservation(
     this, vtkCommand::ModifiedEvent, this, this->MRMLCallbackCommand  , 10000.);
@@ -126,17 +142,27 @@ vtkMRMLScalarVolumeDisplayNode::~vtkMRMLScalarVolumeDisplayNode()
   this->ExtractRGB->Delete();
   this->ExtractAlpha->Delete();
   this->MultiplyAlpha->Delete();
-
+  this->WindowLevelThresholdColors->Delete();
 
   if (this->Bimodal)
     {
     this->Bimodal->Delete();
     this->Bimodal = NULL;
     }
-  if (this->Accumulate)
+  if (this->Histogram)
+    {
+    this->Histogram->Delete();
+    this->Histogram = NULL;
+    }
+  if (this->HistogramSampling)
     {
-    this->Accumulate->Delete();
-    this->Accumulate = NULL;
+    this->HistogramSampling->Delete();
+    this->HistogramSampling = NULL;
+    }
+  if (this->HistogramImage)
+    {
+    this->HistogramImage->Delete();
+    this->HistogramImage = NULL;
     }
 }
 
@@ -179,6 +205,7 @@ void vtkMRMLScalarVolumeDisplayNode
 {
   this->Threshold->SetInputConnection(imageDataConnection);
   this->MapToWindowLevelColors->SetInputConnection(imageDataConnection);
+  this->WindowLevelThresholdColors->SetInputConnection(imageDataConnection);
 }
 
 //----------------------------------------------------------------------------
@@ -186,6 +213,7 @@ void vtkMRMLScalarVolumeDisplayNode
 ::SetBackgroundImageStencilDataConnection(vtkAlgorithmOutput *imageDataConnection)
 {
   this->MultiplyAlpha->SetStencilConnection(imageDataConnection);
+  this->WindowLevelThresholdColors->SetStencilConnection(imageDataConnection);
 }
 //----------------------------------------------------------------------------
 vtkAlgorithmOutput* vtkMRMLScalarVolumeDisplayNode::GetBackgroundImageStencilDataConnection()
@@ -207,7 +235,7 @@ vtkAlgorithmOutput* vtkMRMLScalarVolumeDisplayNode::GetInputImageDataConnection(
 //----------------------------------------------------------------------------
 vtkAlgorithmOutput* vtkMRMLScalarVolumeDisplayNode::GetOutputImageDataConnection()
 {
-  return this->AppendComponents->GetOutputPort();
+  return this->WindowLevelThresholdColors->GetOutputPort();
 }
 
 //----------------------------------------------------------------------------
@@ -364,6 +392,7 @@ void vtkMRMLScalarVolumeDisplayNode::Copy(vtkMRMLNode *anode)
   this->SetApplyThreshold(node->GetApplyThreshold());
   this->SetThreshold(node->GetLowerThreshold(), node->GetUpperThreshold());
   this->SetInterpolate(node->Interpolate);
+  this->SetAutoLevelsMaximumNumberOfSamples(node->GetAutoLevelsMaximumNumberOfSamples());
   for (int p = 0; p < node->GetNumberOfWindowLevelPresets(); p++)
     {
     this->AddWindowLevelPreset(node->GetWindowPreset(p), node->GetLevelPreset(p));
@@ -392,6 +421,21 @@ void vtkMRMLScalarVolumeDisplayNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "UpperThreshold:    " << this->GetUpperThreshold() << "\n";
   os << indent << "LowerThreshold:    " << this->GetLowerThreshold() << "\n";
   os << indent << "Interpolate:       " << this->Interpolate << "\n";
+  os << indent << "AutoLevelsMaximumNumberOfSamples: "
+     << this->AutoLevelsMaximumNumberOfSamples << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLScalarVolumeDisplayNode::SetAutoLevelsMaximumNumberOfSamples(vtkIdType numberOfSamples)
+{
+  if (this->AutoLevelsMaximumNumberOfSamples == numberOfSamples)
+    {
+    return;
+    }
+  this->AutoLevelsMaximumNumberOfSamples = numberOfSamples;
+  // force the histogram to be recomputed
+  this->BimodalImageData = NULL;
+  this->Modified();
 }
 
 //---------------------------------------------------------------------------
@@ -437,6 +481,7 @@ void vtkMRMLScalarVolumeDisplayNode::SetWindow(double window)
     }
 
   this->MapToWindowLevelColors->SetWindow(window);
+  this->WindowLevelThresholdColors->SetWindow(window);
   this->Modified();
 }
 
@@ -455,6 +500,7 @@ void vtkMRMLScalarVolumeDisplayNode::SetLevel(double level)
     }
 
   this->MapToWindowLevelColors->SetLevel(level);
+  this->WindowLevelThresholdColors->SetLevel(level);
   this->Modified();
 }
 
@@ -469,6 +515,8 @@ void vtkMRMLScalarVolumeDisplayNode::SetWindowLevel(double window, double level)
 
   this->MapToWindowLevelColors->SetWindow(window);
   this->MapToWindowLevelColors->SetLevel(level);
+  this->WindowLevelThresholdColors->SetWindow(window);
+  this->WindowLevelThresholdColors->SetLevel(level);
   this->Modified();
 }
 
@@ -505,6 +553,7 @@ void vtkMRMLScalarVolumeDisplayNode::SetApplyThreshold(int apply)
     }
   this->ApplyThreshold = apply;
   this->Threshold->SetOutValue(apply ? 0 : 255);
+  this->WindowLevelThresholdColors->SetApplyThreshold(apply);
   this->Modified();
 }
 
@@ -541,6 +590,8 @@ void vtkMRMLScalarVolumeDisplayNode::SetThreshold(double lowerThreshold, double
     return;
     }
   this->Threshold->ThresholdBetween( lowerThreshold, upperThreshold );
+  this->WindowLevelThresholdColors->SetLowerThreshold(lowerThreshold);
+  this->WindowLevelThresholdColors->SetUpperThreshold(upperThreshold);
   this->Modified();
 }
 
@@ -568,6 +619,7 @@ void vtkMRMLScalarVolumeDisplayNode::UpdateLookupTable(vtkMRMLColorNode* newColo
       }
     }
   this->MapToColors->SetLookupTable(lookupTable);
+  this->WindowLevelThresholdColors->SetLookupTable(lookupTable);
 }
 
 //---------------------------------------------------------------------------
@@ -760,27 +812,76 @@ void vtkMRMLScalarVolumeDisplayNode::CalculateAutoLevels()
     {
     // data type is VTK_INT or similar, so calculate window/level
     // check the scalar type, bimodal analysis only works on int
-    if (this->Bimodal == NULL)
-      {
-      this->Bimodal = vtkImageBimodalAnalysis::New();
-      }
-    if (this->Accumulate == NULL)
+    if (this->BimodalImageData != imageDataScalar ||
+        this->BimodalImageDataMTime != imageDataScalar->GetMTime())
       {
-      this->Accumulate = vtkImageAccumulate::New();
+      // The histogram is only recomputed when the image data is modified,
+      // not each time the display node is modified.
+      if (this->Bimodal == NULL)
+        {
+        this->Bimodal = vtkImageBimodalAnalysis::New();
+        }
+      if (this->Histogram == NULL)
+        {
+        // Multi-threaded, unlike vtkImageAccumulate.
+        // Setup filter to work with signed 16-bit integer.
+        this->Histogram = vtkImageHistogram::New();
+        this->Histogram->AutomaticBinningOff();
+        this->Histogram->SetNumberOfBins(65536);
+        this->Histogram->SetBinOrigin(-32768);
+        this->Histogram->SetBinSpacing(1.);
+        }
+      if (this->HistogramImage == NULL)
+        {
+        this->HistogramImage = vtkImageData::New();
+        this->HistogramImage->SetExtent(0, 65535, 0, 0, 0, 0);
+        this->HistogramImage->SetOrigin(-32768, 0, 0);
+        }
+      // Subsample large images with the same stride along each axis
+      int dimensions[3] = {0, 0, 0};
+      imageDataScalar->GetDimensions(dimensions);
+      vtkIdType numberOfVoxels = static_cast<vtkIdType>(dimensions[0]) * dimensions[1] * dimensions[2];
+      int stride = 1;
+      if (this->AutoLevelsMaximumNumberOfSamples > 0)
+        {
+        while (numberOfVoxels > this->AutoLevelsMaximumNumberOfSamples)
+          {
+          ++stride;
+          numberOfVoxels = 1;
+          for (int i = 0; i < 3; ++i)
+            {
+            numberOfVoxels *= (dimensions[i] + stride - 1) / stride;
+            }
+          }
+        }
+      if (stride > 1)
+        {
+        if (this->HistogramSampling == NULL)
+          {
+          this->HistogramSampling = vtkImageShrink3D::New();
+          this->HistogramSampling->AveragingOff();
+          }
+        this->HistogramSampling->SetShrinkFactors(stride, stride, stride);
+        this->HistogramSampling->SetInputData(imageDataScalar);
+        this->Histogram->SetInputConnection(this->HistogramSampling->GetOutputPort());
+        }
+      else
+        {
+        this->Histogram->SetInputData(imageDataScalar);
+        }
+      this->Histogram->Update();
+      this->HistogramImage->GetPointData()->SetScalars(this->Histogram->GetHistogram());
+      this->HistogramImage->Modified();
+      this->Bimodal->SetInputData(this->HistogramImage);
+      this->Bimodal->Update();
+      // Workaround for image data where all histogram samples fall
+      // within the same histogram bin
+      this->BimodalFailed = ( this->Bimodal->GetWindow() == 0.0 &&
+                              this->Bimodal->GetLevel() == 0.0 );
+      this->BimodalImageData = imageDataScalar;
+      this->BimodalImageDataMTime = imageDataScalar->GetMTime();
       }
-
-    // Setup filter to work with signed 16-bit integer.
-    int extent[6] = {0, 65535, 0, 0, 0, 0};
-    this->Accumulate->SetComponentExtent(extent);
-    double origin[3] = {-32768, 0, 0};
-    this->Accumulate->SetComponentOrigin(origin);
-    this->Accumulate->SetInputData(imageDataScalar);
-    this->Bimodal->SetInputConnection(this->Accumulate->GetOutputPort());
-    this->Bimodal->Update();
-    // Workaround for image data where all accumulate samples fall
-    // within the same histogram bin
-    if ( this->Bimodal->GetWindow() == 0.0 &&
-         this->Bimodal->GetLevel() == 0.0 )
+    if (this->BimodalFailed)
       {
       needAdHoc = 1;
       }
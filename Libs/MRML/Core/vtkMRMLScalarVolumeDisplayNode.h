@@ -20,12 +20,14 @@
 
 // VTK includes
 class vtkImageAlgorithm;
-class vtkImageAccumulate;
+class vtkImageHistogram;
+class vtkImageShrink3D;
 class vtkImageAppendComponents;
 class vtkImageBimodalAnalysis;
 class vtkImageCast;
 class vtkImageLogic;
 class vtkImageMapToColors;
+class vtkImageMapToWindowLevelThresholdColors;
 class vtkImageMapToWindowLevelColors;
 class vtkImageStencil;
 class vtkImageThreshold;
@@ -108,6 +110,15 @@ class VTK_MRML_EXPORT vtkMRMLScalarVolumeDisplayNode : public vtkMRMLVolumeDispl
   vtkGetMacro(AutoThreshold, int);
   vtkSetMacro(AutoThreshold, int);
 
+  ///
+  /// Maximum number of voxels used for computing the automatic window/level
+  /// and threshold. Larger images are subsampled with a regular stride,
+  /// which gives nearly the same histogram shape in a fraction of the time.
+  /// 0 means all the voxels are used. Default is 2^24 (e.g. 512x512x64).
+  /// This setting is not saved in the scene.
+  vtkGetMacro(AutoLevelsMaximumNumberOfSamples, vtkIdType);
+  void SetAutoLevelsMaximumNumberOfSamples(vtkIdType numberOfSamples);
+
   ///
   /// The lower threshold value to use when autoThreshold is 'no'
   /// Defaults to VTK_SHORT_MIN
@@ -229,6 +240,9 @@ protected:
   vtkImageExtractComponents *ExtractRGB;
   vtkImageExtractComponents *ExtractAlpha;
   vtkImageStencil *MultiplyAlpha;
+  /// Computes the output of the filters above in one pass, it is the output
+  /// of the scalar volume display pipeline.
+  vtkImageMapToWindowLevelThresholdColors *WindowLevelThresholdColors;
 
   ///
   /// window level presets
@@ -236,9 +250,19 @@ protected:
 
   ///
   /// Used internally in CalculateScalarAutoLevels and CalculateStatisticsAutoLevels
-  vtkImageAccumulate *Accumulate;
+  vtkImageHistogram *Histogram;
+  vtkImageShrink3D *HistogramSampling;
+  vtkImageData *HistogramImage;
+  vtkIdType AutoLevelsMaximumNumberOfSamples;
   vtkImageBimodalAnalysis *Bimodal;
   bool IsInCalculateAutoLevels;
+
+  ///
+  /// Results of the bimodal analysis of the scalar image data, which are
+  /// reused until the scalar image data is modified.
+  vtkImageData *BimodalImageData;
+  vtkMTimeType BimodalImageDataMTime;
+  bool BimodalFailed;
 };
 
 #endif
@@ -21,6 +21,7 @@ Version:   $Revision: 1.14 $
 #include <vtkDataArray.h>
 #include <vtkObjectFactory.h>
 #include <vtkImageData.h>
+#include <vtkImageShrink3D.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
 
@@ -30,6 +31,9 @@ vtkMRMLNodeNewMacro(vtkMRMLScalarVolumeNode);
 //----------------------------------------------------------------------------
 vtkMRMLScalarVolumeNode::vtkMRMLScalarVolumeNode()
 {
+  this->MaximumPyramidLevel = 0;
+  this->PyramidImageData = NULL;
+  this->PyramidImageDataMTime = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -79,7 +83,16 @@ void vtkMRMLScalarVolumeNode::ReadXMLAttributes(const char** atts)
 // Does NOT copy: ID, FilePrefix, Name, VolumeID
 void vtkMRMLScalarVolumeNode::Copy(vtkMRMLNode *anode)
 {
+  int disabledModify = this->StartModify();
+
   Superclass::Copy(anode);
+  vtkMRMLScalarVolumeNode *node = vtkMRMLScalarVolumeNode::SafeDownCast(anode);
+  if (node)
+    {
+    this->SetMaximumPyramidLevel(node->GetMaximumPyramidLevel());
+    }
+
+  this->EndModify(disabledModify);
 }
 
 //-----------------------------------------------------------
@@ -112,6 +125,102 @@ vtkMRMLScalarVolumeDisplayNode* vtkMRMLScalarVolumeNode::GetScalarVolumeDisplayN
 void vtkMRMLScalarVolumeNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os,indent);
+  os << indent << "MaximumPyramidLevel: " << this->MaximumPyramidLevel << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkMRMLScalarVolumeNode::GetPyramidLevelImageData(int level)
+{
+  vtkImageData* imageData = this->GetImageData();
+  if (level == 0 || imageData == NULL)
+    {
+    return imageData;
+    }
+  if (level < 0 || level > this->MaximumPyramidLevel)
+    {
+    return NULL;
+    }
+
+  if (this->PyramidImageData != imageData ||
+      this->PyramidImageDataMTime != imageData->GetMTime())
+    {
+    this->PyramidLevels.clear();
+    this->PyramidImageData = imageData;
+    this->PyramidImageDataMTime = imageData->GetMTime();
+    }
+
+  while (static_cast<int>(this->PyramidLevels.size()) < level)
+    {
+    vtkImageData* finerLevel = this->PyramidLevels.empty() ?
+      imageData : this->PyramidLevels.back().GetPointer();
+    int dimensions[3] = {0, 0, 0};
+    finerLevel->GetDimensions(dimensions);
+    // axes that are already a single voxel thick are not shrunk
+    int factors[3] = {1, 1, 1};
+    for (int i = 0; i < 3; ++i)
+      {
+      factors[i] = dimensions[i] > 1 ? 2 : 1;
+      }
+    vtkNew<vtkImageShrink3D> shrink;
+    shrink->SetInputData(finerLevel);
+    shrink->SetShrinkFactors(factors);
+    shrink->AveragingOn();
+    shrink->Update();
+
+    // A voxel of the coarser level is centered on the block of voxels
+    // it averages. Set the geometry explicitly so that it does not depend
+    // on the convention of the filter.
+    vtkSmartPointer<vtkImageData> coarserLevel = vtkSmartPointer<vtkImageData>::New();
+    coarserLevel->ShallowCopy(shrink->GetOutput());
+    double origin[3] = {0., 0., 0.};
+    double spacing[3] = {1., 1., 1.};
+    finerLevel->GetOrigin(origin);
+    finerLevel->GetSpacing(spacing);
+    for (int i = 0; i < 3; ++i)
+      {
+      origin[i] += spacing[i] * (factors[i] - 1) * 0.5;
+      spacing[i] *= factors[i];
+      }
+    coarserLevel->SetOrigin(origin);
+    coarserLevel->SetSpacing(spacing);
+    this->PyramidLevels.push_back(coarserLevel);
+    }
+  return this->PyramidLevels[level - 1];
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLScalarVolumeNode::GetPyramidLevelForResolution(double voxelsPerPixel)
+{
+  int level = 0;
+  while (level < this->MaximumPyramidLevel &&
+         static_cast<double>(2 << level) <= voxelsPerPixel)
+    {
+    ++level;
+    }
+  return level;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLScalarVolumeNode::GetPyramidMemorySize()
+{
+  vtkIdType size = 0;
+  for (std::vector<vtkSmartPointer<vtkImageData> >::iterator it = this->PyramidLevels.begin();
+       it != this->PyramidLevels.end(); ++it)
+    {
+    if (it->GetPointer())
+      {
+      size += static_cast<vtkIdType>((*it)->GetActualMemorySize()) * 1024;
+      }
+    }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLScalarVolumeNode::ReleasePyramidLevels()
+{
+  this->PyramidLevels.clear();
+  this->PyramidImageData = NULL;
+  this->PyramidImageDataMTime = 0;
 }
 
 //---------------------------------------------------------------------------
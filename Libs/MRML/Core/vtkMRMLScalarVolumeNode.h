@@ -19,6 +19,12 @@
 #include "vtkMRMLVolumeNode.h"
 class vtkMRMLScalarVolumeDisplayNode;
 
+// VTK includes
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <vector>
+
 /// \brief MRML node for representing a volume (image stack).
 ///
 /// Volume nodes describe data sets that can be thought of as stacks of 2D
@@ -71,11 +77,57 @@ class VTK_MRML_EXPORT vtkMRMLScalarVolumeNode : public vtkMRMLVolumeNode
   /// Create and observe default display node
   virtual void CreateDefaultDisplayNodes();
 
+  ///
+  /// Coarsest level of the multi-resolution pyramid of the image data.
+  /// Level n averages blocks of 2^n x 2^n x 2^n voxels of the image data.
+  /// Views that show the volume at a lower resolution than the image data
+  /// (e.g. zoomed out slice views) can use a coarser level instead.
+  /// 0 (default) disables the pyramid.
+  vtkSetClampMacro(MaximumPyramidLevel, int, 0, 16);
+  vtkGetMacro(MaximumPyramidLevel, int);
+
+  ///
+  /// Return the image data of a level of the multi-resolution pyramid.
+  /// Level 0 is the image data itself. The origin and spacing of the
+  /// coarser levels are in the IJK coordinates of the image data, so the
+  /// IJKToRAS matrix of the node applies to all the levels.
+  /// Levels are computed when they are first requested and recomputed
+  /// after the image data is modified.
+  /// Returns NULL if \a level is larger than MaximumPyramidLevel.
+  /// \sa GetPyramidLevelForResolution()
+  vtkImageData* GetPyramidLevelImageData(int level);
+
+  ///
+  /// Return the coarsest pyramid level whose voxels are not larger than
+  /// \a voxelsPerPixel voxels of the image data, i.e. the level to use
+  /// when a pixel of a view covers \a voxelsPerPixel voxels.
+  /// The levels are not computed by this method.
+  int GetPyramidLevelForResolution(double voxelsPerPixel);
+
+  ///
+  /// Number of bytes used by the pyramid levels computed so far.
+  /// The image data (level 0) is not included.
+  vtkIdType GetPyramidMemorySize();
+
+  ///
+  /// Free the computed pyramid levels, they are computed again by
+  /// GetPyramidLevelImageData() when needed.
+  void ReleasePyramidLevels();
+
 protected:
   vtkMRMLScalarVolumeNode();
   ~vtkMRMLScalarVolumeNode();
   vtkMRMLScalarVolumeNode(const vtkMRMLScalarVolumeNode&);
   void operator=(const vtkMRMLScalarVolumeNode&);
+
+  int MaximumPyramidLevel;
+
+  /// Levels 1 to PyramidLevels.size() of the pyramid
+  std::vector<vtkSmartPointer<vtkImageData> > PyramidLevels;
+  /// Image data the pyramid levels are computed from, and its
+  /// modification time when they were computed.
+  vtkImageData* PyramidImageData;
+  vtkMTimeType PyramidImageDataMTime;
 };
 
 #endif
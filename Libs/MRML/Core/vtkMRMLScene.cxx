@@ -33,6 +33,7 @@ Version:   $Revision: 1.18 $
 #include "vtkMRMLFreeSurferModelOverlayStorageNode.h"
 #include "vtkMRMLFreeSurferModelStorageNode.h"
 #include "vtkMRMLGridTransformNode.h"
+#include "vtkMRMLHierarchyNode.h"
 #include "vtkMRMLHierarchyStorageNode.h"
 #include "vtkMRMLLabelMapVolumeDisplayNode.h"
 #include "vtkMRMLLabelMapVolumeNode.h"
@@ -59,6 +60,7 @@ Version:   $Revision: 1.18 $
 #include "vtkMRMLVectorVolumeDisplayNode.h"
 #include "vtkMRMLViewNode.h"
 #include "vtkMRMLVolumeArchetypeStorageNode.h"
+#include "vtkMRMLVolumeNode.h"
 #include "vtkURIHandler.h"
 #include "vtkMRMLLayoutNode.h"
 
@@ -78,8 +80,14 @@ Version:   $Revision: 1.18 $
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
+#include <vtkDataObject.h>
 #include <vtkDebugLeaks.h>
+#include <vtkImageData.h>
+#include <vtkMultiThreader.h>
+#include <vtkMutexLock.h>
+#include <vtkPointSet.h>
 #include <vtkErrorCode.h>
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
 
@@ -90,6 +98,8 @@ Version:   $Revision: 1.18 $
 // STD includes
 #include <algorithm>
 #include <numeric>
+#include <utility>
+#include <vector>
 
 //#define MRMLSCENE_VERBOSE
 
@@ -106,18 +116,23 @@ vtkCxxSetObjectMacro(vtkMRMLScene, URIHandlerCollection, vtkCollection)
 vtkMRMLScene::vtkMRMLScene()
 {
   this->NodeIDsMTime = 0;
+  this->NodesByClassMTime = 0;
   this->SceneModifiedTime = 0;
 
   this->RegisteredNodeClasses.clear();
+  this->RegisteredNodeClassesByTag.clear();
+  this->RegisteredNodeClassesByClassName.clear();
   this->UniqueIDs.clear();
   this->UniqueNames.clear();
 
   this->Nodes =  vtkCollection::New();
   this->UndoStackSize = 100;
+  this->UndoMemoryBudget = 0;
   this->UndoFlag = false;
   this->InUndo = false;
 
   this->NodeReferences.clear();
+  this->ReferencingNodeReferences.clear();
   this->ReferencedIDChanges.clear();
 
   this->CacheManager = NULL;
@@ -133,6 +148,10 @@ vtkMRMLScene::vtkMRMLScene()
 
   this->ReadDataOnLoad = 1;
 
+  this->DeferReadDataOnLoad = 0;
+
+  this->NumberOfReadDataThreads = 1;
+
   this->LastLoadedVersion = NULL;
   this->Version = NULL;
   this->SetVersion(CURRENT_MRML_VERSION);
@@ -229,6 +248,10 @@ vtkMRMLScene::~vtkMRMLScene()
       vtkDebugMacro("CurrentScene should have already been cleared in DeleteEvent callback: ");
       this->Nodes->RemoveAllItems ( );
       }
+    // Another scene may be created at the same address, make sure the hierarchy
+    // maps cached for this scene are not reused.
+    vtkMRMLHierarchyNode::HierarchyIsModified(this);
+    vtkMRMLHierarchyNode::AssociatedHierarchyIsModified(this);
     this->Nodes->Delete();
     this->Nodes = NULL;
     }
@@ -298,7 +321,9 @@ void vtkMRMLScene::Clear(int removeSingletons)
 
   this->RemoveAllNodes(removeSingletons);
   this->NodeReferences.clear();
+  this->ReferencingNodeReferences.clear();
   this->ReferencedIDChanges.clear();
+  this->DeferredReadDataNodeIDs.clear();
   this->ResetNodes();
 
   this->ClearUndoStack ( );
@@ -438,13 +463,11 @@ vtkMRMLNode* vtkMRMLScene::CreateNodeByClass(const char* className)
     return NULL;
     }
   vtkMRMLNode* node = NULL;
-  for (unsigned int i=0; i<RegisteredNodeClasses.size(); i++)
+  std::map< std::string, vtkMRMLNode* >::const_iterator registeredNodeIt =
+    this->RegisteredNodeClassesByClassName.find(className);
+  if (registeredNodeIt != this->RegisteredNodeClassesByClassName.end())
     {
-    if (!strcmp(RegisteredNodeClasses[i]->GetClassName(), className))
-      {
-      node = RegisteredNodeClasses[i]->CreateNodeInstance();
-      break;
-      }
+    node = registeredNodeIt->second->CreateNodeInstance();
     }
   // non-registered nodes can have a registered factory
   if (node == NULL)
@@ -506,6 +529,7 @@ void vtkMRMLScene::RegisterNodeClass(vtkMRMLNode* node, const char* tagName)
   // By doing so we make sure there is no more than 1 node matching a given
   // XML tag. It allows plugins to MRML to overide default behavior when
   // instantiating nodes via XML tags.
+  bool replaced = false;
   for (unsigned int i = 0; i < this->RegisteredNodeTags.size(); ++i)
     {
     if (this->RegisteredNodeTags[i] == xmlTag)
@@ -524,6 +548,7 @@ void vtkMRMLScene::RegisterNodeClass(vtkMRMLNode* node, const char* tagName)
       // we could have replace the entry with the new node also.
       this->RegisteredNodeClasses.erase(this->RegisteredNodeClasses.begin() + i);
       this->RegisteredNodeTags.erase(this->RegisteredNodeTags.begin() + i);
+      replaced = true;
       // we found a matching tag, there is maximum one in the list, no need to
       // search any further
       break;
@@ -533,6 +558,37 @@ void vtkMRMLScene::RegisterNodeClass(vtkMRMLNode* node, const char* tagName)
   node->Register(this);
   this->RegisteredNodeClasses.push_back(node);
   this->RegisteredNodeTags.push_back(xmlTag);
+  if (replaced)
+    {
+    this->UpdateRegisteredNodeClassesIndex();
+    }
+  else
+    {
+    this->RegisteredNodeClassesByTag[xmlTag] = node;
+    if (node->GetClassName())
+      {
+      this->RegisteredNodeClassesByClassName.insert(
+        std::make_pair(std::string(node->GetClassName()), node));
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::UpdateRegisteredNodeClassesIndex()
+{
+  this->RegisteredNodeClassesByTag.clear();
+  this->RegisteredNodeClassesByClassName.clear();
+  for (unsigned int i = 0; i < this->RegisteredNodeClasses.size(); ++i)
+    {
+    vtkMRMLNode* node = this->RegisteredNodeClasses[i];
+    this->RegisteredNodeClassesByTag[this->RegisteredNodeTags[i]] = node;
+    if (node->GetClassName())
+      {
+      // insert() keeps the first registered node of the class
+      this->RegisteredNodeClassesByClassName.insert(
+        std::make_pair(std::string(node->GetClassName()), node));
+      }
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -584,14 +640,13 @@ const char* vtkMRMLScene::GetClassNameByTag(const char *tagName)
     vtkErrorMacro("GetClassNameByTag: tagname is null");
     return NULL;
     }
-  for (unsigned int i=0; i<RegisteredNodeTags.size(); i++)
+  std::map< std::string, vtkMRMLNode* >::const_iterator registeredNodeIt =
+    this->RegisteredNodeClassesByTag.find(tagName);
+  if (registeredNodeIt == this->RegisteredNodeClassesByTag.end())
     {
-    if (!strcmp(RegisteredNodeTags[i].c_str(), tagName))
-      {
-      return (RegisteredNodeClasses[i])->GetClassName();
-      }
+    return NULL;
     }
-  return NULL;
+  return registeredNodeIt->second->GetClassName();
 }
 
 //------------------------------------------------------------------------------
@@ -602,14 +657,13 @@ const char* vtkMRMLScene::GetTagByClassName(const char *className)
     vtkErrorMacro("GetTagByClassName: className is null");
     return NULL;
     }
-  for (unsigned int i=0; i<this->RegisteredNodeClasses.size(); i++)
+  std::map< std::string, vtkMRMLNode* >::const_iterator registeredNodeIt =
+    this->RegisteredNodeClassesByClassName.find(className);
+  if (registeredNodeIt == this->RegisteredNodeClassesByClassName.end())
     {
-    if (!strcmp(this->RegisteredNodeClasses[i]->GetClassName(), className))
-      {
-      return (this->RegisteredNodeClasses[i])->GetNodeTagName();
-      }
+    return NULL;
     }
-  return NULL;
+  return registeredNodeIt->second->GetNodeTagName();
 }
 
 //------------------------------------------------------------------------------
@@ -788,6 +842,15 @@ int vtkMRMLScene::Import()
 
     this->InvokeEvent(vtkMRMLScene::NewSceneEvent, NULL);
 
+    // Read the files of the storage nodes concurrently, UpdateScene() then
+    // only has to set the prefetched data into the nodes.
+    bool prefetch = this->NumberOfReadDataThreads > 1 &&
+      this->ReadDataOnLoad && !this->DeferReadDataOnLoad;
+    if (prefetch)
+      {
+      this->PrefetchStorableNodesData(addedNodes);
+      }
+
     // Notify the imported nodes about that all nodes are created
     // (so the observers can be attached to referenced nodes, etc.)
     // by calling UpdateScene on each node
@@ -812,6 +875,20 @@ int vtkMRMLScene::Import()
         }
       }
 
+    if (prefetch)
+      {
+      // Release the data of the storage nodes that were not read
+      vtkMRMLStorageNode* storageNode;
+      for (addedNodes->InitTraversal(it);
+           (node = (vtkMRMLNode*)addedNodes->GetNextItemAsObject(it)) ;)
+        {
+        if ((storageNode = vtkMRMLStorageNode::SafeDownCast(node)) != NULL)
+          {
+          storageNode->ClearPrefetchedData();
+          }
+        }
+      }
+
     this->Modified();
     this->RemoveUnusedNodeReferences();
 #ifdef MRMLSCENE_VERBOSE
@@ -857,6 +934,124 @@ int vtkMRMLScene::Import()
   return returnCode;
 }
 
+//------------------------------------------------------------------------------
+namespace
+{
+
+struct PrefetchDataTask
+{
+  std::vector<std::pair<vtkMRMLStorageNode*, vtkMRMLStorableNode*> > Items;
+  size_t NextItem;
+  vtkSimpleMutexLock* Lock;
+};
+
+//------------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE PrefetchDataThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  PrefetchDataTask* task = static_cast<PrefetchDataTask*>(info->UserData);
+  while (true)
+    {
+    task->Lock->Lock();
+    size_t item = task->NextItem++;
+    task->Lock->Unlock();
+    if (item >= task->Items.size())
+      {
+      break;
+      }
+    task->Items[item].first->PrefetchData(task->Items[item].second);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+} // end of anonymous namespace
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::PrefetchStorableNodesData(vtkCollection* nodes)
+{
+  vtkNew<vtkSimpleMutexLock> lock;
+  PrefetchDataTask task;
+  task.NextItem = 0;
+  task.Lock = lock.GetPointer();
+
+  vtkMRMLNode* node = NULL;
+  vtkCollectionSimpleIterator it;
+  for (nodes->InitTraversal(it);
+       (node = (vtkMRMLNode*)nodes->GetNextItemAsObject(it)) ;)
+    {
+    vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(node);
+    if (!storableNode || !storableNode->GetAddToScene())
+      {
+      continue;
+      }
+    for (int i = 0; i < storableNode->GetNumberOfStorageNodes(); ++i)
+      {
+      vtkMRMLStorageNode* storageNode = storableNode->GetNthStorageNode(i);
+      if (storageNode)
+        {
+        task.Items.push_back(std::make_pair(storageNode, storableNode));
+        }
+      }
+    }
+  if (task.Items.size() < 2)
+    {
+    // nothing to gain
+    return;
+    }
+
+  vtkNew<vtkMultiThreader> threader;
+  threader->SetNumberOfThreads(std::min(
+    std::min(this->NumberOfReadDataThreads, static_cast<int>(task.Items.size())),
+    static_cast<int>(VTK_MAX_THREADS)));
+  threader->SetSingleMethod(PrefetchDataThread, &task);
+  threader->SingleMethodExecute();
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::AddDeferredReadDataNode(vtkMRMLStorableNode* node)
+{
+  if (!node || !node->GetID())
+    {
+    return;
+    }
+  this->DeferredReadDataNodeIDs.push_back(node->GetID());
+}
+
+//------------------------------------------------------------------------------
+int vtkMRMLScene::GetNumberOfDeferredReadDataNodes()
+{
+  return static_cast<int>(this->DeferredReadDataNodeIDs.size());
+}
+
+//------------------------------------------------------------------------------
+int vtkMRMLScene::ReadNextDeferredData()
+{
+  if (this->DeferredReadDataNodeIDs.empty())
+    {
+    return 0;
+    }
+  std::string nodeID = this->DeferredReadDataNodeIDs.front();
+  this->DeferredReadDataNodeIDs.pop_front();
+
+  vtkMRMLStorableNode* node =
+    vtkMRMLStorableNode::SafeDownCast(this->GetNodeByID(nodeID.c_str()));
+  if (node && node->GetAddToScene())
+    {
+    vtkDebugMacro("ReadNextDeferredData: reading data of " << nodeID);
+    node->ReadStorageNodesData(this);
+    }
+  return static_cast<int>(this->DeferredReadDataNodeIDs.size());
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::ReadAllDeferredData()
+{
+  while (this->ReadNextDeferredData() > 0)
+    {
+    }
+}
+
 //------------------------------------------------------------------------------
 int vtkMRMLScene::LoadIntoScene(vtkCollection* nodeCollection)
 {
@@ -1028,6 +1223,13 @@ int vtkMRMLScene::Commit(const char* url)
   *os << ">\n";
   //--- END test of user tags
 
+  // Relative file paths written by storage nodes depend on the root directory
+  if (this->NodeXMLCacheRootDirectory != this->RootDirectory)
+    {
+    this->NodeXMLCache.clear();
+    this->NodeXMLCacheRootDirectory = this->RootDirectory;
+    }
+
   // Write each node
   int n;
   for (n=0; n < this->Nodes->GetNumberOfItems(); n++)
@@ -1044,17 +1246,34 @@ int vtkMRMLScene::Commit(const char* url)
       indent -=2;
       }
 
-    vtkIndent vindent(indent);
-    *os << vindent << "<" << node->GetNodeTagName() << "\n";
-
+    int tagIndent = indent;
     if(indent<=0)
       indent = 1;
 
-    node->WriteXML(*os, indent);
+    // Reuse the XML of the node if it has not been modified since the last
+    // commit (modifications are pending while modified events are disabled)
+    NodeXMLCacheEntry& cachedXML = this->NodeXMLCache[node];
+    vtkMTimeType nodeMTime = node->GetMTime();
+    if (cachedXML.NodeMTime != nodeMTime || cachedXML.TagIndent != tagIndent
+      || cachedXML.Indent != indent || node->GetModifiedEventPending() > 0
+      || cachedXML.XML.empty())
+      {
+      std::stringstream nodeXML;
+      vtkIndent vindent(tagIndent);
+      nodeXML << vindent << "<" << node->GetNodeTagName() << "\n";
+
+      node->WriteXML(nodeXML, indent);
 
-    *os << vindent << ">";
-    node->WriteNodeBodyXML(*os, indent);
-    *os << "</" << node->GetNodeTagName() << ">\n";
+      nodeXML << vindent << ">";
+      node->WriteNodeBodyXML(nodeXML, indent);
+      nodeXML << "</" << node->GetNodeTagName() << ">\n";
+
+      cachedXML.XML = nodeXML.str();
+      cachedXML.NodeMTime = nodeMTime;
+      cachedXML.TagIndent = tagIndent;
+      cachedXML.Indent = indent;
+      }
+    *os << cachedXML.XML;
 
     if ( deltaIndent > 0 )
       {
@@ -1182,10 +1401,12 @@ vtkMRMLNode*  vtkMRMLScene::AddNodeNoNotify(vtkMRMLNode *n)
     n->SetName(this->GenerateUniqueName(n).c_str());
     }
   n->SetScene( this );
+  this->ClearNodesByClassIfModified();
   this->Nodes->vtkCollection::AddItem((vtkObject *)n);
 
   // cache the node so the whole scene cache stays up-todate
   this->AddNodeID(n);
+  this->AddNodeToNodesByClass(n);
 
   //n->OnNodeAddedToScene();
 
@@ -1254,6 +1475,119 @@ vtkMRMLNode*  vtkMRMLScene::AddNode(vtkMRMLNode *n)
   return node;
 }
 
+//------------------------------------------------------------------------------
+int vtkMRMLScene::AddNodes(const std::vector<vtkMRMLNode*>& nodesToAdd,
+                           std::vector<vtkMRMLNode*>* addedNodes/*=0*/)
+{
+  // Nodes that will actually be appended to the scene: nodes that are not
+  // allowed to be added and singletons that will be merged into an existing
+  // node are not part of the notification.
+  vtkNew<vtkCollection> newNodes;
+  std::set<vtkMRMLNode*> newNodesSet;
+  for (std::vector<vtkMRMLNode*>::const_iterator it = nodesToAdd.begin();
+       it != nodesToAdd.end(); ++it)
+    {
+    vtkMRMLNode* node = *it;
+    if (!node)
+      {
+      vtkErrorMacro("AddNodes: unable to add a null node to the scene");
+      continue;
+      }
+    if (!node->GetAddToScene())
+      {
+      continue;
+      }
+    if (node->GetSingletonTag() != NULL && this->GetSingletonNode(node) != NULL)
+      {
+      continue;
+      }
+    newNodes->AddItem(node);
+    newNodesSet.insert(node);
+    }
+
+  if (newNodes->GetNumberOfItems() > 0)
+    {
+    this->InvokeEvent(vtkMRMLScene::NodesAboutToBeAddedEvent, newNodes.GetPointer());
+    }
+
+  std::map< std::string, std::string > referencedIDChanges = this->ReferencedIDChanges;
+  this->ReferencedIDChanges.clear();
+
+  vtkNew<vtkCollection> nodesInScene;
+  vtkNew<vtkCollection> appendedNodes;
+  for (std::vector<vtkMRMLNode*>::const_iterator it = nodesToAdd.begin();
+       it != nodesToAdd.end(); ++it)
+    {
+    vtkMRMLNode* node = (*it && (*it)->GetAddToScene()) ? this->AddNodeNoNotify(*it) : NULL;
+    if (addedNodes)
+      {
+      addedNodes->push_back(node);
+      }
+    if (node)
+      {
+      nodesInScene->AddItem(node);
+      }
+    if (node && node == *it && newNodesSet.count(node))
+      {
+      appendedNodes->AddItem(node);
+      }
+    }
+
+  // Update all at once the references to the nodes that got a new ID
+  // because of a conflict with a node already in the scene.
+  if (!this->ReferencedIDChanges.empty())
+    {
+    this->UpdateNodeReferences(nodesInScene.GetPointer());
+    }
+  // Restore the changes that may have been recorded by a pending Import().
+  this->ReferencedIDChanges.insert(referencedIDChanges.begin(), referencedIDChanges.end());
+
+  if (appendedNodes->GetNumberOfItems() > 0)
+    {
+    this->InvokeEvent(vtkMRMLScene::NodesAddedEvent, appendedNodes.GetPointer());
+    }
+  this->Modified();
+  return appendedNodes->GetNumberOfItems();
+}
+
+//------------------------------------------------------------------------------
+int vtkMRMLScene::AddNodes(vtkCollection* nodesToAdd, vtkCollection* addedNodes/*=0*/)
+{
+  if (!nodesToAdd)
+    {
+    vtkErrorMacro("AddNodes: invalid collection");
+    return 0;
+    }
+  std::vector<vtkMRMLNode*> nodes;
+  vtkObject* object = 0;
+  vtkCollectionSimpleIterator it;
+  for (nodesToAdd->InitTraversal(it);
+       (object = nodesToAdd->GetNextItemAsObject(it)) ;)
+    {
+    vtkMRMLNode* node = vtkMRMLNode::SafeDownCast(object);
+    if (!node)
+      {
+      vtkErrorMacro("AddNodes: collection contains a non-MRML node object");
+      continue;
+      }
+    nodes.push_back(node);
+    }
+  std::vector<vtkMRMLNode*> nodesInScene;
+  int numberOfAddedNodes = this->AddNodes(nodes, &nodesInScene);
+  if (addedNodes)
+    {
+    for (std::vector<vtkMRMLNode*>::iterator nodeIt = nodesInScene.begin();
+         nodeIt != nodesInScene.end(); ++nodeIt)
+      {
+      if (*nodeIt)
+        {
+        addedNodes->AddItem(*nodeIt);
+        }
+      }
+    }
+  return numberOfAddedNodes;
+}
+
 //------------------------------------------------------------------------------
 void vtkMRMLScene::NodeAdded(vtkMRMLNode *n)
 {
@@ -1315,7 +1649,10 @@ void vtkMRMLScene::RemoveNode(vtkMRMLNode *n)
     {
     n->SetScene(0);
     }
+  this->ClearNodesByClassIfModified();
   this->Nodes->vtkCollection::RemoveItem((vtkObject *)n);
+  this->RemoveNodeFromNodesByClass(n);
+  this->NodeXMLCache.erase(n);
 
   std::string nid=n->GetID();
   this->RemoveNodeID(n->GetID());
@@ -1374,6 +1711,11 @@ void vtkMRMLScene::RemoveReferencedNodeID(const char *id, vtkMRMLNode *referenci
     return;
     }
   referenceIt->second.erase(referencingNode->GetID());
+  NodeReferencesType::iterator referencingIt = this->ReferencingNodeReferences.find(referencingNode->GetID());
+  if (referencingIt != this->ReferencingNodeReferences.end())
+    {
+    referencingIt->second.erase(id);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -1391,18 +1733,24 @@ void vtkMRMLScene::RemoveNodeReferences(vtkMRMLNode *n)
     }
   std::string nid=n->GetID();
 
-  NodeReferencesType::value_type::second_type::iterator referringNodesIt;
-  for (NodeReferencesType::iterator referenceIt = this->NodeReferences.begin();
-    referenceIt != this->NodeReferences.end();
-    ++referenceIt)
+  NodeReferencesType::iterator referencingIt = this->ReferencingNodeReferences.find(nid);
+  if (referencingIt == this->ReferencingNodeReferences.end())
     {
-    referringNodesIt=referenceIt->second.find(nid);
-    if (referringNodesIt!=referenceIt->second.end())
+    // the node does not reference any node
+    return;
+    }
+  for (NodeReferencesType::value_type::second_type::iterator referencedIdIt = referencingIt->second.begin();
+    referencedIdIt != referencingIt->second.end();
+    ++referencedIdIt)
+    {
+    NodeReferencesType::iterator referenceIt = this->NodeReferences.find(*referencedIdIt);
+    if (referenceIt != this->NodeReferences.end())
       {
       // observation has been deleted, so remove it from the index
-      referenceIt->second.erase(referringNodesIt);
+      referenceIt->second.erase(nid);
       }
     }
+  this->ReferencingNodeReferences.erase(referencingIt);
 }
 
 //------------------------------------------------------------------------------
@@ -1449,17 +1797,51 @@ void vtkMRMLScene::RemoveUnusedNodeReferences()
     // go to next referenced ID
     ++referenceIt;
     }
+
+  this->UpdateReferencingNodeReferences();
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::UpdateReferencingNodeReferences()
+{
+  this->ReferencingNodeReferences.clear();
+  for (NodeReferencesType::iterator referenceIt = this->NodeReferences.begin();
+    referenceIt != this->NodeReferences.end();
+    ++referenceIt)
+    {
+    for (NodeReferencesType::value_type::second_type::iterator referringNodesIt = referenceIt->second.begin();
+      referringNodesIt != referenceIt->second.end();
+      ++referringNodesIt)
+      {
+      this->ReferencingNodeReferences[*referringNodesIt].insert(referenceIt->first);
+      }
+    }
 }
 
 //------------------------------------------------------------------------------
 void vtkMRMLScene::RemoveReferencesToNode(vtkMRMLNode *n)
 {
-  if (n == NULL && n->GetID() == NULL)
+  if (n == NULL || n->GetID() == NULL)
     {
     vtkErrorMacro("RemoveReferencesToNode: node is null or has null id, can't remove refs");
     return;
     }
-  this->NodeReferences.erase(n->GetID());
+  NodeReferencesType::iterator referenceIt = this->NodeReferences.find(n->GetID());
+  if (referenceIt == this->NodeReferences.end())
+    {
+    return;
+    }
+  for (NodeReferencesType::value_type::second_type::iterator referringNodesIt = referenceIt->second.begin();
+    referringNodesIt != referenceIt->second.end();
+    ++referringNodesIt)
+    {
+    NodeReferencesType::iterator referencingIt = this->ReferencingNodeReferences.find(*referringNodesIt);
+    if (referencingIt != this->ReferencingNodeReferences.end())
+      {
+      referencingIt->second.erase(n->GetID());
+      }
+    }
+  this->NodeReferences.erase(referenceIt);
 }
 
 //------------------------------------------------------------------------------
@@ -1494,18 +1876,7 @@ int vtkMRMLScene::GetNumberOfNodesByClass(const char *className)
     vtkErrorMacro("GetNumberOfNodesByClass: class name is null.");
     return 0;
     }
-  int num=0;
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
-    {
-    if (node->IsA(className))
-      {
-      num++;
-      }
-    }
-  return num;
+  return static_cast<int>(this->GetCachedNodesByClass(className).size());
 }
 
 //------------------------------------------------------------------------------
@@ -1516,16 +1887,8 @@ int vtkMRMLScene::GetNodesByClass(const char *className, std::vector<vtkMRMLNode
     vtkErrorMacro("GetNodesByClass: class name is null.");
     return 0;
     }
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
-    {
-    if (node->IsA(className))
-      {
-      nodes.push_back(node);
-      }
-    }
+  const std::vector< vtkMRMLNode* >& classNodes = this->GetCachedNodesByClass(className);
+  nodes.insert(nodes.end(), classNodes.begin(), classNodes.end());
   return static_cast<int>(nodes.size());
 }
 
@@ -1538,15 +1901,11 @@ vtkCollection* vtkMRMLScene::GetNodesByClass(const char *className)
     return 0;
     }
   vtkCollection* nodes = vtkCollection::New();
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector< vtkMRMLNode* >& classNodes = this->GetCachedNodesByClass(className);
+  for (std::vector< vtkMRMLNode* >::const_iterator it = classNodes.begin();
+       it != classNodes.end(); ++it)
     {
-    if (node->IsA(className))
-      {
-      nodes->AddItem(node);
-      }
+    nodes->AddItem(*it);
     }
   return nodes;
 }
@@ -1606,13 +1965,12 @@ vtkMRMLNode* vtkMRMLScene::GetSingletonNode(const char* singletonTag, const char
     return NULL;
     }
 
-  vtkCollectionSimpleIterator it;
-  vtkMRMLNode* node = NULL;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector< vtkMRMLNode* >& classNodes = this->GetCachedNodesByClass(className);
+  for (std::vector< vtkMRMLNode* >::const_iterator it = classNodes.begin();
+       it != classNodes.end(); ++it)
     {
-    if (node->IsA(className) &&
-        node->GetSingletonTag() != NULL &&
+    vtkMRMLNode* node = *it;
+    if (node->GetSingletonTag() != NULL &&
         strcmp(node->GetSingletonTag(), singletonTag) == 0)
       {
       return node;
@@ -1682,22 +2040,12 @@ vtkMRMLNode* vtkMRMLScene::GetNthNodeByClass(int n, const char *className)
     return NULL;
     }
 
-  int num=0;
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector< vtkMRMLNode* >& classNodes = this->GetCachedNodesByClass(className);
+  if (n >= static_cast<int>(classNodes.size()))
     {
-    if (node->IsA(className))
-      {
-      if (num == n)
-        {
-        return node;
-        }
-      num++;
-      }
+    return NULL;
     }
-  return NULL;
+  return classNodes[n];
 }
 
 //------------------------------------------------------------------------------
@@ -1838,11 +2186,12 @@ vtkCollection* vtkMRMLScene::GetNodesByClassByName(const char* className, const
     return nodes;
     }
 
-  vtkMRMLNode *node;
-  for (int n=0; n < this->Nodes->GetNumberOfItems(); n++)
+  const std::vector< vtkMRMLNode* >& classNodes = this->GetCachedNodesByClass(className);
+  for (std::vector< vtkMRMLNode* >::const_iterator it = classNodes.begin();
+       it != classNodes.end(); ++it)
     {
-    node = (vtkMRMLNode*)this->Nodes->GetItemAsObject(n);
-    if (!strcmp(node->GetName(), name) && node->IsA(className))
+    vtkMRMLNode* node = *it;
+    if (node->GetName() && !strcmp(node->GetName(), name))
       {
       nodes->AddItem(node);
       }
@@ -2290,6 +2639,7 @@ void vtkMRMLScene::SaveStateForUndo (vtkMRMLNode *node)
     {
     this->CopyNodeInUndoStack(node);
     }
+  this->TrimUndoStack();
 }
 
 //------------------------------------------------------------------------------
@@ -2321,6 +2671,7 @@ void vtkMRMLScene::SaveStateForUndo (std::vector<vtkMRMLNode *> nodes)
       this->CopyNodeInUndoStack(node);
       }
     }
+  this->TrimUndoStack();
 }
 
 //------------------------------------------------------------------------------
@@ -2360,6 +2711,7 @@ void vtkMRMLScene::SaveStateForUndo (vtkCollection* nodes)
       this->CopyNodeInUndoStack(node);
       }
     }
+  this->TrimUndoStack();
 }
 
 //------------------------------------------------------------------------------
@@ -2447,9 +2799,39 @@ void vtkMRMLScene::CopyNodeInUndoStack(vtkMRMLNode *copyNode)
     return;
     }
 
-  vtkMRMLNode *snode = copyNode->CreateNodeInstance();
-  if (snode != NULL)
+  vtkSmartPointer<vtkMRMLNode> snode;
+  // If the node has not been modified since its state was stored in the
+  // previous undo level, share that stored state instead of making a new copy.
+  // Stored states are never modified, therefore they can be shared between
+  // levels.
+  if (this->UndoStack.size() > 1 && copyNode->GetID())
     {
+    vtkCollection* previousUndoScene = *(++this->UndoStack.rbegin());
+    vtkMRMLNode *previousNode = 0;
+    vtkCollectionSimpleIterator it;
+    for (previousUndoScene->InitTraversal(it);
+         (previousNode = vtkMRMLNode::SafeDownCast(previousUndoScene->GetNextItemAsObject(it))) ;)
+      {
+      if (previousNode->GetID() && !strcmp(previousNode->GetID(), copyNode->GetID()))
+        {
+        break;
+        }
+      }
+    if (previousNode && previousNode != copyNode &&
+        strcmp(previousNode->GetClassName(), copyNode->GetClassName()) == 0 &&
+        copyNode->GetMTime() < previousNode->GetMTime())
+      {
+      snode = previousNode;
+      }
+    }
+  if (snode.GetPointer() == NULL)
+    {
+    snode.TakeReference(copyNode->CreateNodeInstance());
+    if (snode.GetPointer() == NULL)
+      {
+      vtkErrorMacro("CopyNodeInUndoStack: failed to create an instance of " << copyNode->GetClassName());
+      return;
+      }
     snode->CopyWithScene(copyNode);
     }
   vtkCollection* undoScene = dynamic_cast < vtkCollection *>( this->UndoStack.back() );
@@ -2463,7 +2845,96 @@ void vtkMRMLScene::CopyNodeInUndoStack(vtkMRMLNode *copyNode)
       break;
       }
     }
-  snode->Delete();
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::TrimUndoStack()
+{
+  while (this->UndoStackSize > 0 &&
+         static_cast<int>(this->UndoStack.size()) > this->UndoStackSize)
+    {
+    this->UndoStack.front()->RemoveAllItems();
+    this->UndoStack.front()->Delete();
+    this->UndoStack.pop_front();
+    }
+  if (this->UndoMemoryBudget <= 0)
+    {
+    return;
+    }
+  while (this->UndoStack.size() > 1 &&
+         this->GetUndoMemorySize() > this->UndoMemoryBudget)
+    {
+    this->UndoStack.front()->RemoveAllItems();
+    this->UndoStack.front()->Delete();
+    this->UndoStack.pop_front();
+    }
+}
+
+//------------------------------------------------------------------------------
+namespace
+{
+vtkDataObject* GetNodeBulkData(vtkMRMLNode* node)
+{
+  if (vtkMRMLVolumeNode::SafeDownCast(node))
+    {
+    return vtkMRMLVolumeNode::SafeDownCast(node)->GetImageData();
+    }
+  if (vtkMRMLModelNode::SafeDownCast(node))
+    {
+    return vtkMRMLModelNode::SafeDownCast(node)->GetMesh();
+    }
+  return 0;
+}
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkMRMLScene::GetUndoMemorySize()
+{
+  // Rough estimate of the memory used by a node without its bulk data
+  const vtkIdType nodeSize = 1024;
+
+  std::set<vtkMRMLNode*> sceneNodes;
+  std::set<vtkDataObject*> countedData;
+  vtkMRMLNode *node = 0;
+  vtkCollectionSimpleIterator it;
+  for (this->Nodes->InitTraversal(it);
+       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+    {
+    sceneNodes.insert(node);
+    vtkDataObject* data = GetNodeBulkData(node);
+    if (data)
+      {
+      // data still used by the scene, it doesn't cost anything to the stacks
+      countedData.insert(data);
+      }
+    }
+
+  vtkIdType memorySize = 0;
+  std::set<vtkMRMLNode*> countedNodes;
+  std::list< vtkCollection* >* stacks[2] = { &this->UndoStack, &this->RedoStack };
+  for (int stackIndex = 0; stackIndex < 2; ++stackIndex)
+    {
+    for (std::list< vtkCollection* >::iterator levelIt = stacks[stackIndex]->begin();
+         levelIt != stacks[stackIndex]->end(); ++levelIt)
+      {
+      for ((*levelIt)->InitTraversal(it);
+           (node = vtkMRMLNode::SafeDownCast((*levelIt)->GetNextItemAsObject(it))) ;)
+        {
+        if (sceneNodes.count(node) || !countedNodes.insert(node).second)
+          {
+          continue;
+          }
+        memorySize += nodeSize;
+        vtkDataObject* data = GetNodeBulkData(node);
+        if (data && countedData.insert(data).second)
+          {
+          // GetActualMemorySize() is in kibibytes
+          memorySize += static_cast<vtkIdType>(data->GetActualMemorySize()) * 1024;
+          }
+        }
+      }
+    }
+  return memorySize;
 }
 
 //------------------------------------------------------------------------------
@@ -2787,6 +3258,7 @@ void vtkMRMLScene::AddReferencedNodeID(const char *id, vtkMRMLNode *referencingN
     return;
     }
   this->NodeReferences[id].insert(referencingNode->GetID());
+  this->ReferencingNodeReferences[referencingNode->GetID()].insert(id);
 }
 
 //------------------------------------------------------------------------------
@@ -2860,6 +3332,22 @@ const char* vtkMRMLScene::GetChangedID(const char* id)
 //------------------------------------------------------------------------------
 void vtkMRMLScene::UpdateNodeReferences(vtkCollection* checkNodes/*=NULL*/)
 {
+  if (this->ReferencedIDChanges.empty())
+    {
+    return;
+    }
+  // Index the nodes to check, vtkCollection::IsItemPresent() is a linear search
+  std::set<vtkMRMLNode*> checkNodesSet;
+  if (checkNodes != NULL)
+    {
+    vtkMRMLNode* checkNode = NULL;
+    vtkCollectionSimpleIterator it;
+    for (checkNodes->InitTraversal(it);
+         (checkNode = vtkMRMLNode::SafeDownCast(checkNodes->GetNextItemAsObject(it))) ;)
+      {
+      checkNodesSet.insert(checkNode);
+      }
+    }
   for (std::map< std::string, std::string>::const_iterator iterChanged = this->ReferencedIDChanges.begin();
     iterChanged != this->ReferencedIDChanges.end(); iterChanged++)
     {
@@ -2882,7 +3370,7 @@ void vtkMRMLScene::UpdateNodeReferences(vtkCollection* checkNodes/*=NULL*/)
         {
         continue;
         }
-      if (checkNodes!=NULL && !checkNodes->IsItemPresent(node))
+      if (checkNodes!=NULL && checkNodesSet.find(node) == checkNodesSet.end())
         {
         continue;
         }
@@ -2902,15 +3390,15 @@ void vtkMRMLScene::AddReferencedNodes(vtkMRMLNode *node, vtkCollection *refNodes
 
   std::deque<vtkMRMLNode*> newFoundReferencedNodes;
 
-  for (NodeReferencesType::iterator referenceIt = this->NodeReferences.begin();
-    referenceIt != this->NodeReferences.end();
-    ++referenceIt)
+  NodeReferencesType::iterator referencingIt = this->ReferencingNodeReferences.find(node->GetID());
+  if (referencingIt != this->ReferencingNodeReferences.end())
     {
-    NodeReferencesType::value_type::second_type::iterator referringNodesIt = referenceIt->second.find(node->GetID());
-    if (referringNodesIt!=referenceIt->second.end())
+    for (NodeReferencesType::value_type::second_type::iterator referencedIdIt = referencingIt->second.begin();
+      referencedIdIt != referencingIt->second.end();
+      ++referencedIdIt)
       {
       // this ID is referenced by this node
-      vtkMRMLNode *referencedNode = this->GetNodeByID(referenceIt->first);
+      vtkMRMLNode *referencedNode = this->GetNodeByID(*referencedIdIt);
       if (referencedNode!=NULL && !refNodes->IsItemPresent(referencedNode))
         {
         // this ID is not yet in the list of reference nodes, so add it
@@ -2982,6 +3470,7 @@ void vtkMRMLScene::CopyNodeReferences(vtkMRMLScene *scene)
 
   //assuming the nodes exist in this scene
   this->NodeReferences=scene->NodeReferences;
+  this->ReferencingNodeReferences=scene->ReferencingNodeReferences;
 }
 
 //------------------------------------------------------------------------------
@@ -3080,6 +3569,76 @@ void vtkMRMLScene::ClearNodeIDs()
   }
 }
 
+//------------------------------------------------------------------------------
+const std::vector< vtkMRMLNode* >& vtkMRMLScene::GetCachedNodesByClass(const char* className)
+{
+  this->ClearNodesByClassIfModified();
+  NodesByClassType::iterator classIt = this->NodesByClass.find(className);
+  if (classIt != this->NodesByClass.end())
+    {
+    return classIt->second;
+    }
+  // First request for this class: scan the scene once, the list is then
+  // maintained by AddNodeToNodesByClass() and RemoveNodeFromNodesByClass().
+  std::vector< vtkMRMLNode* >& classNodes = this->NodesByClass[className];
+  vtkMRMLNode *node;
+  vtkCollectionSimpleIterator it;
+  for (this->Nodes->InitTraversal(it);
+       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+    {
+    if (node->IsA(className))
+      {
+      classNodes.push_back(node);
+      }
+    }
+  this->NodesByClassMTime = this->Nodes->GetMTime();
+  return classNodes;
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::AddNodeToNodesByClass(vtkMRMLNode* node)
+{
+  for (NodesByClassType::iterator classIt = this->NodesByClass.begin();
+       classIt != this->NodesByClass.end(); ++classIt)
+    {
+    if (node->IsA(classIt->first.c_str()))
+      {
+      classIt->second.push_back(node);
+      }
+    }
+  this->NodesByClassMTime = this->Nodes->GetMTime();
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::RemoveNodeFromNodesByClass(vtkMRMLNode* node)
+{
+  for (NodesByClassType::iterator classIt = this->NodesByClass.begin();
+       classIt != this->NodesByClass.end(); ++classIt)
+    {
+    if (!node->IsA(classIt->first.c_str()))
+      {
+      continue;
+      }
+    std::vector< vtkMRMLNode* >::iterator nodeIt =
+      std::find(classIt->second.begin(), classIt->second.end(), node);
+    if (nodeIt != classIt->second.end())
+      {
+      classIt->second.erase(nodeIt);
+      }
+    }
+  this->NodesByClassMTime = this->Nodes->GetMTime();
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::ClearNodesByClassIfModified()
+{
+  if (this->Nodes->GetMTime() > this->NodesByClassMTime)
+    {
+    this->NodesByClass.clear();
+    this->NodesByClassMTime = this->Nodes->GetMTime();
+    }
+}
+
 //------------------------------------------------------------------------------
 void vtkMRMLScene::AddURIHandler(vtkURIHandler *handler)
 {
@@ -43,6 +43,7 @@ class vtkGeneralTransform;
 class vtkURIHandler;
 class vtkMRMLNode;
 class vtkMRMLSceneViewNode;
+class vtkMRMLStorableNode;
 
 /// \brief A set of MRML Nodes that supports serialization and undo/redo.
 ///
@@ -162,6 +163,25 @@ public:
   /// into the already existing singleton node. That node is then returned.
   vtkMRMLNode* AddNode(vtkMRMLNode *nodeToAdd);
 
+  /// \brief Add a list of nodes to the scene and notify observers once.
+  ///
+  /// Unlike calling AddNode() for each node, a single
+  /// vtkMRMLScene::NodesAboutToBeAddedEvent and a single
+  /// vtkMRMLScene::NodesAddedEvent are fired (instead of a
+  /// NodeAboutToBeAddedEvent/NodeAddedEvent pair per node). The call data of
+  /// both events is a vtkCollection containing the nodes that are
+  /// effectively added (singletons that are merged into an existing node are
+  /// not part of it). References to nodes whose ID changed because of a
+  /// conflict with a node already in the scene are updated once for all the
+  /// added nodes.
+  /// Returns the number of nodes that have been added. If \a addedNodes is
+  /// not null, the nodes that are in the scene after the call (added nodes or
+  /// existing singletons, in the same order as \a nodesToAdd) are appended to it.
+  /// \sa AddNode(), NodesAddedEvent
+  int AddNodes(const std::vector<vtkMRMLNode*>& nodesToAdd,
+               std::vector<vtkMRMLNode*>* addedNodes = 0);
+  int AddNodes(vtkCollection* nodesToAdd, vtkCollection* addedNodes = 0);
+
   /// Add a copy of a node to the scene.
   vtkMRMLNode* CopyNode(vtkMRMLNode *n);
 
@@ -296,6 +316,31 @@ public:
   /// returns number of redo steps in the history buffer
   int GetNumberOfRedoLevels() { return (int)this->RedoStack.size();};
 
+  /// \brief Set/Get the maximum number of undo levels.
+  ///
+  /// When a new state is saved and the limit is reached, the oldest undo
+  /// levels are discarded. 0 means no limit. Default is 100.
+  vtkSetMacro(UndoStackSize, int);
+  vtkGetMacro(UndoStackSize, int);
+
+  /// \brief Set/Get the maximum amount of memory (in bytes) that the node
+  /// states stored in the undo and redo stacks may use.
+  ///
+  /// When a new state is saved and the budget is exceeded, the oldest undo
+  /// levels are discarded (the most recent level is always kept).
+  /// 0 (default) means no limit.
+  /// \sa GetUndoMemorySize()
+  vtkSetMacro(UndoMemoryBudget, vtkIdType);
+  vtkGetMacro(UndoMemoryBudget, vtkIdType);
+
+  /// \brief Estimate the memory (in bytes) used by the undo and redo stacks.
+  ///
+  /// Only the stored node states that are not part of the scene are counted.
+  /// Bulk data (image data, meshes) shared with the nodes of the scene or
+  /// between several stored states are counted once, or not at all if they
+  /// are still used by a node in the scene.
+  vtkIdType GetUndoMemorySize();
+
   /// Save current state in the undo buffer
   void SaveStateForUndo();
 
@@ -410,6 +455,48 @@ public:
   vtkSetMacro(ReadDataOnLoad,int);
   vtkGetMacro(ReadDataOnLoad,int);
 
+  /// \brief This property controls whether Import() reads the data of
+  /// volume and model nodes.
+  ///
+  /// If true, the nodes are added to the scene without their data and the
+  /// data is read later, one node at a time, by ReadNextDeferredData().
+  /// It lets the application show the scene and stay responsive while
+  /// the bulk data of a large scene is being read.
+  /// False by default.
+  /// \sa ReadNextDeferredData(), ReadAllDeferredData(), SetReadDataOnLoad()
+  vtkSetMacro(DeferReadDataOnLoad,int);
+  vtkGetMacro(DeferReadDataOnLoad,int);
+  vtkBooleanMacro(DeferReadDataOnLoad,int);
+
+  /// Register a node whose data is read by ReadNextDeferredData().
+  /// Called by vtkMRMLStorableNode::UpdateScene() when reading is deferred.
+  void AddDeferredReadDataNode(vtkMRMLStorableNode* node);
+
+  /// Number of nodes whose data has been deferred and is not read yet.
+  int GetNumberOfDeferredReadDataNodes();
+
+  /// Read the data of the oldest node registered with
+  /// AddDeferredReadDataNode(). Nodes removed from the scene meanwhile
+  /// are skipped. Read errors are reported in the scene error code.
+  /// Returns the number of nodes that remain to be read.
+  /// \sa ReadAllDeferredData()
+  int ReadNextDeferredData();
+
+  /// Read the data of all the deferred nodes.
+  /// \sa ReadNextDeferredData()
+  void ReadAllDeferredData();
+
+  /// \brief Number of threads used by Import() to read the storage node files.
+  ///
+  /// If greater than 1, the files are first read concurrently with
+  /// vtkMRMLStorageNode::PrefetchData(), then set into the nodes
+  /// sequentially in the scene order, so that node dependencies (e.g.
+  /// transforms and transformed nodes) are handled as usual.
+  /// 1 (sequential reading) by default.
+  /// \sa Import(), vtkMRMLStorageNode::PrefetchData()
+  vtkSetClampMacro(NumberOfReadDataThreads, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfReadDataThreads, int);
+
   void SetErrorMessage(const std::string &error);
   std::string GetErrorMessage();
 
@@ -564,6 +651,13 @@ public:
     NodeAddedEvent,
     NodeAboutToBeRemovedEvent,
     NodeRemovedEvent,
+    /// Fired by AddNodes() before the nodes are added.
+    /// The call data is a vtkCollection of the nodes to add.
+    NodesAboutToBeAddedEvent,
+    /// Fired by AddNodes() after the nodes are added, instead of a
+    /// NodeAddedEvent per node. The call data is a vtkCollection of the
+    /// added nodes.
+    NodesAddedEvent,
 
     NewSceneEvent = 66030,
     MetadataAddedEvent = 66032, // ### Slicer 4.5: Simplify - Do not explicitly set for backward compat. See issue #3472
@@ -652,6 +746,10 @@ protected:
   void CopyNodeInUndoStack(vtkMRMLNode *node);
   void CopyNodeInRedoStack(vtkMRMLNode *node);
 
+  /// Discard the oldest undo levels until the stack fits into UndoStackSize
+  /// and UndoMemoryBudget.
+  void TrimUndoStack();
+
   /// Add a node to the scene without invoking a vtkMRMLScene::NodeAddedEvent event.
   ///
   /// \warning Use with extreme caution as it might unsynchronize observer.
@@ -694,9 +792,36 @@ protected:
   /// Clear NodeIDs map used to speedup GetByID() method.
   void ClearNodeIDs();
 
+  /// \brief Return the nodes of class \a className (or of a subclass of
+  /// \a className) from the \a NodesByClass cache, in scene order.
+  ///
+  /// The list of nodes is computed on first request for a given class name
+  /// and then kept up to date when nodes are added or removed.
+  /// \sa AddNodeToNodesByClass(), RemoveNodeFromNodesByClass()
+  const std::vector< vtkMRMLNode* >& GetCachedNodesByClass(const char* className);
+
+  /// Append \a node to all the cached lists of \a NodesByClass it belongs to.
+  /// Must be called right after \a node is appended to the \a Nodes collection.
+  void AddNodeToNodesByClass(vtkMRMLNode* node);
+
+  /// Remove \a node from all the cached lists of \a NodesByClass.
+  /// Must be called right after \a node is removed from the \a Nodes collection.
+  void RemoveNodeFromNodesByClass(vtkMRMLNode* node);
+
+  /// Clear the \a NodesByClass cache if the \a Nodes collection has been
+  /// modified without the cache being updated (e.g. node insertion at a
+  /// given position).
+  void ClearNodesByClassIfModified();
+
+  /// Rebuild the by-tag and by-class-name indices of the registered node classes.
+  void UpdateRegisteredNodeClassesIndex();
+
   /// Get a NodeReferences iterator for a node reference.
   NodeReferencesType::iterator FindNodeReference(const char* referencedId, vtkMRMLNode* referencingNode);
 
+  /// Rebuild ReferencingNodeReferences from NodeReferences.
+  void UpdateReferencingNodeReferences();
+
   vtkCollection*  Nodes;
   vtkMTimeType    SceneModifiedTime;
 
@@ -709,6 +834,7 @@ protected:
   std::vector<unsigned long> States;
 
   int  UndoStackSize;
+  vtkIdType UndoMemoryBudget;
   bool UndoFlag;
   bool InUndo;
 
@@ -724,11 +850,27 @@ protected:
 
   std::vector< vtkMRMLNode* > RegisteredNodeClasses;
   std::vector< std::string >  RegisteredNodeTags;
+  /// Index of RegisteredNodeClasses by XML tag and by class name
+  /// (the first registered node is indexed if a class is registered
+  /// with multiple tags), used for fast lookup when parsing scenes.
+  std::map< std::string, vtkMRMLNode* > RegisteredNodeClassesByTag;
+  std::map< std::string, vtkMRMLNode* > RegisteredNodeClassesByClassName;
 
   NodeReferencesType NodeReferences; // ReferencedIDs (string), ReferencingNodes (node pointer)
+  /// Reverse index of NodeReferences: ReferencingNode IDs -> ReferencedIDs.
+  /// Kept in sync with NodeReferences so that the references of a node are
+  /// found without scanning all the references of the scene.
+  NodeReferencesType ReferencingNodeReferences;
   std::map< std::string, std::string > ReferencedIDChanges;
   std::map< std::string, vtkSmartPointer<vtkMRMLNode> > NodeIDs;
 
+  /// Cache used to speedup GetNodesByClass(), GetNthNodeByClass()...
+  /// For each requested class name, it stores the nodes (in scene order)
+  /// that are of that class or of a subclass.
+  typedef std::map< std::string, std::vector< vtkMRMLNode* > > NodesByClassType;
+  NodesByClassType NodesByClass;
+  vtkMTimeType NodesByClassMTime;
+
   // Stores default nodes. If a class is created or reset (using CreateNodeByClass or Clear) and
   // a default node is defined for it then the content of the default node will be used to initialize
   // the class. It is useful for overriding default values that are set in a node's constructor.
@@ -738,12 +880,36 @@ protected:
 
   std::string SceneXMLString;
 
+  /// XML written by Commit() for a node, reused as long as the node is not
+  /// modified and it is written with the same indentation.
+  struct NodeXMLCacheEntry
+    {
+    NodeXMLCacheEntry() : NodeMTime(0), TagIndent(0), Indent(0) {}
+    vtkMTimeType NodeMTime;
+    int TagIndent;
+    int Indent;
+    std::string XML;
+    };
+  typedef std::map< vtkMRMLNode*, NodeXMLCacheEntry > NodeXMLCacheType;
+  NodeXMLCacheType NodeXMLCache;
+  /// Root directory the cached XML was written with
+  std::string NodeXMLCacheRootDirectory;
+
   int LoadFromXMLString;
 
   int SaveToXMLString;
 
   int ReadDataOnLoad;
 
+  int DeferReadDataOnLoad;
+  std::list<std::string> DeferredReadDataNodeIDs;
+
+  int NumberOfReadDataThreads;
+
+  /// Read concurrently the files of the storage nodes of the storable
+  /// nodes in \a nodes. \sa SetNumberOfReadDataThreads()
+  void PrefetchStorableNodesData(vtkCollection* nodes);
+
   vtkMTimeType  NodeIDsMTime;
 
   void RemoveAllNodes(bool removeSingletons);
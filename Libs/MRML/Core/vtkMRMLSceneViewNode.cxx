@@ -213,6 +213,7 @@ void vtkMRMLSceneViewNode::ProcessChildNode(vtkMRMLNode *node)
     {
     this->SnapshotScene = vtkMRMLScene::New();
     }
+  this->SynchronizedNodeMTimes.clear();
   this->SnapshotScene->GetNodes()->vtkCollection::AddItem((vtkObject *)node);
 
   this->SnapshotScene->AddNodeID(node);
@@ -245,6 +246,7 @@ void vtkMRMLSceneViewNode::Copy(vtkMRMLNode *anode)
     this->SnapshotScene->GetNodes()->RemoveAllItems();
     this->SnapshotScene->ClearNodeIDs();
     }
+  this->SynchronizedNodeMTimes.clear();
   vtkMRMLNode *node = NULL;
   if ( snode->SnapshotScene != NULL )
     {
@@ -350,10 +352,7 @@ void vtkMRMLSceneViewNode::StoreScene()
   if (this->SnapshotScene == NULL)
     {
     this->SnapshotScene = vtkMRMLScene::New();
-    }
-  else
-    {
-    this->SnapshotScene->Clear(1);
+    this->SynchronizedNodeMTimes.clear();
     }
 
   if (this->GetScene())
@@ -391,13 +390,54 @@ void vtkMRMLSceneViewNode::StoreScene()
       }
     }
 
-  /// \todo: GetNumberOfNodes/GetNthNode is slow, fasten by using collection
-  /// iterators.
-  for (int n=0; n < this->Scene->GetNumberOfNodes(); n++)
+  // Remove the stored nodes that are not in the scene anymore or that have
+  // been replaced by a node of another class. The other stored nodes are
+  // kept and only updated if they changed since the last store or restore.
+  vtkMRMLNode *node = NULL;
+  vtkCollectionSimpleIterator it;
+  std::vector<vtkSmartPointer<vtkMRMLNode> > removedNodes;
+  vtkCollection* storedNodes = this->SnapshotScene->GetNodes();
+  for (storedNodes->InitTraversal(it);
+       (node = vtkMRMLNode::SafeDownCast(storedNodes->GetNextItemAsObject(it))) ;)
+    {
+    vtkMRMLNode* sceneNode = node->GetID() ? this->Scene->GetNodeByID(node->GetID()) : NULL;
+    if (!sceneNode ||
+        strcmp(sceneNode->GetClassName(), node->GetClassName()) != 0 ||
+        !this->IncludeNodeInSceneView(sceneNode) ||
+        !sceneNode->GetSaveWithScene())
+      {
+      removedNodes.push_back(vtkSmartPointer<vtkMRMLNode>(node));
+      }
+    }
+  for (std::vector<vtkSmartPointer<vtkMRMLNode> >::iterator removedIt = removedNodes.begin();
+       removedIt != removedNodes.end(); ++removedIt)
     {
-    vtkMRMLNode *node = this->Scene->GetNthNode(n);
-    if (this->IncludeNodeInSceneView(node) &&
-        node->GetSaveWithScene() )
+    if ((*removedIt)->GetID())
+      {
+      this->SynchronizedNodeMTimes.erase((*removedIt)->GetID());
+      }
+    this->SnapshotScene->RemoveNode(*removedIt);
+    }
+
+  vtkCollection* sceneNodes = this->Scene->GetNodes();
+  for (sceneNodes->InitTraversal(it);
+       (node = vtkMRMLNode::SafeDownCast(sceneNodes->GetNextItemAsObject(it))) ;)
+    {
+    if (!this->IncludeNodeInSceneView(node) ||
+        !node->GetSaveWithScene() )
+      {
+      continue;
+      }
+    vtkMRMLNode* storedNode = this->SnapshotScene->GetNodeByID(node->GetID());
+    if (storedNode)
+      {
+      if (!this->IsNodeSynchronized(node, storedNode))
+        {
+        storedNode->CopyWithoutModifiedEvent(node);
+        storedNode->SetAddToSceneNoModify(0);
+        }
+      }
+    else
       {
       vtkSmartPointer<vtkMRMLNode> newNode = vtkSmartPointer<vtkMRMLNode>::Take(node->CreateNodeInstance());
 
@@ -411,12 +451,39 @@ void vtkMRMLSceneViewNode::StoreScene()
 
       // sanity check
       assert(newNode->GetScene() == this->SnapshotScene);
+      storedNode = newNode;
       }
+    this->SetNodeSynchronized(node, storedNode);
     }
   this->SnapshotScene->CopyNodeReferences(this->GetScene());
   this->SnapshotScene->CopyNodeChangedIDs(this->GetScene());
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLSceneViewNode::IsNodeSynchronized(vtkMRMLNode* sceneNode, vtkMRMLNode* storedNode)
+{
+  if (!sceneNode || !storedNode || !sceneNode->GetID() ||
+      sceneNode->GetModifiedEventPending() > 0)
+    {
+    return false;
+    }
+  NodeMTimesType::const_iterator it = this->SynchronizedNodeMTimes.find(sceneNode->GetID());
+  return it != this->SynchronizedNodeMTimes.end() &&
+         it->second.first == sceneNode->GetMTime() &&
+         it->second.second == storedNode->GetMTime();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSceneViewNode::SetNodeSynchronized(vtkMRMLNode* sceneNode, vtkMRMLNode* storedNode)
+{
+  if (!sceneNode || !storedNode || !sceneNode->GetID())
+    {
+    return;
+    }
+  this->SynchronizedNodeMTimes[sceneNode->GetID()] =
+    std::make_pair(sceneNode->GetMTime(), storedNode->GetMTime());
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLSceneViewNode::AddMissingNodes()
 {
@@ -581,6 +648,8 @@ void vtkMRMLSceneViewNode::RestoreScene(bool removeNodes)
     }
 
   std::vector<vtkMRMLNode *> addedNodes;
+  // stored nodes that are identical to the scene nodes once restored
+  std::vector<vtkMRMLNode *> restoredNodes;
   for (n=0; n < numNodesInSceneView; n++)
     {
     node = vtkMRMLNode::SafeDownCast(this->SnapshotScene->GetNodes()->GetItemAsObject(n));
@@ -591,13 +660,19 @@ void vtkMRMLSceneViewNode::RestoreScene(bool removeNodes)
         {
         vtkMRMLNode *snode = this->Scene->GetNodeByID(node->GetID());
 
-        if (snode)
+        if (snode && this->IsNodeSynchronized(snode, node))
+          {
+          // the node has not been modified since it was stored or restored
+          restoredNodes.push_back(node);
+          }
+        else if (snode)
           {
           snode->SetScene(this->Scene);
           // to prevent copying of default info if not stored in sanpshot
           snode->CopyWithSingleModifiedEvent(node);
           // to prevent reading data on UpdateScene()
           snode->SetAddToSceneNoModify(0);
+          restoredNodes.push_back(node);
           }
         else
           {
@@ -607,6 +682,7 @@ void vtkMRMLSceneViewNode::RestoreScene(bool removeNodes)
           addedNodes.push_back(newNode);
           newNode->SetAddToSceneNoModify(1);
           this->Scene->AddNode(newNode);
+          restoredNodes.push_back(node);
           newNode->Delete();
 
           // to prevent reading data on UpdateScene()
@@ -637,6 +713,11 @@ void vtkMRMLSceneViewNode::RestoreScene(bool removeNodes)
     //this->Scene->InvokeEvent(vtkMRMLScene::NodeAddedEvent, addedNodes[n] );
     }
 
+  for(n=0; n<restoredNodes.size(); n++)
+    {
+    this->SetNodeSynchronized(this->Scene->GetNodeByID(restoredNodes[n]->GetID()), restoredNodes[n]);
+    }
+
   this->Scene->EndState(vtkMRMLScene::RestoreState);
 
 #ifndef NDEBUG
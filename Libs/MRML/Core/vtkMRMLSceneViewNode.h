@@ -19,6 +19,11 @@
 
 // VTK includes
 #include <vtkStdString.h>
+
+// STD includes
+#include <map>
+#include <string>
+
 class vtkCollection;
 class vtkImageData;
 
@@ -69,7 +74,10 @@ class VTK_MRML_EXPORT vtkMRMLSceneViewNode : public vtkMRMLStorableNode
   vtkMRMLScene* GetStoredScene();
 
   ///
-  /// Store content of the scene
+  /// Store content of the scene.
+  /// Only the nodes modified since the last StoreScene() or RestoreScene()
+  /// are copied again, the bulk data (images, meshes...) is shared with the
+  /// scene nodes and not duplicated.
   /// \sa GetStoredScene() RestoreScene()
   void StoreScene();
 
@@ -83,6 +91,8 @@ class VTK_MRML_EXPORT vtkMRMLSceneViewNode : public vtkMRMLStorableNode
   /// do no appear in the scene view. If it is false, and nodes are found that will be
   /// deleted, don't remove them, print a warning, set the scene error code to 1, save
   /// the warning to the scene error message, and return.
+  /// Scene nodes that have not been modified since they were last stored or
+  /// restored are not copied.
   /// \sa GetStoredScene() StoreScene() AddMissingNodes()
   void RestoreScene(bool removeNodes = true);
 
@@ -135,8 +145,20 @@ protected:
   void operator=(const vtkMRMLSceneViewNode&);
 
 
+  /// Return true if \a sceneNode and \a storedNode have not been modified
+  /// since they were last found identical by StoreScene() or RestoreScene().
+  bool IsNodeSynchronized(vtkMRMLNode* sceneNode, vtkMRMLNode* storedNode);
+  /// Record the modified times of \a sceneNode and \a storedNode once they
+  /// are identical.
+  void SetNodeSynchronized(vtkMRMLNode* sceneNode, vtkMRMLNode* storedNode);
+
   vtkMRMLScene* SnapshotScene;
 
+  /// Modified times of the scene nodes and of their stored copies, indexed
+  /// by node ID. Cleared when the stored scene is not filled by StoreScene().
+  typedef std::map<std::string, std::pair<vtkMTimeType, vtkMTimeType> > NodeMTimesType;
+  NodeMTimesType SynchronizedNodeMTimes;
+
   /// The associated Description
   vtkStdString SceneViewDescription;
 
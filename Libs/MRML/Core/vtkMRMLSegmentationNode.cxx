@@ -55,6 +55,7 @@
 
 // STD includes
 #include <algorithm>
+#include <set>
 
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLSegmentationNode);
@@ -717,3 +718,51 @@ void vtkMRMLSegmentationNode::SetReferenceImageGeometryParameterFromVolumeNode(v
   this->SetNodeReferenceID(
     vtkMRMLSegmentationNode::GetReferenceImageGeometryReferenceRole().c_str(), volumeNode->GetID() );
 }
+
+//---------------------------------------------------------------------------
+int vtkMRMLSegmentationNode::EvictDerivedRepresentations(bool hiddenSegmentsOnly/*=true*/)
+{
+  if (!this->Segmentation)
+    {
+    return 0;
+    }
+
+  std::set<std::string> visibleSegmentIDs;
+  if (hiddenSegmentsOnly)
+    {
+    for (int displayNodeIndex = 0; displayNodeIndex < this->GetNumberOfDisplayNodes(); ++displayNodeIndex)
+      {
+      vtkMRMLSegmentationDisplayNode* displayNode = vtkMRMLSegmentationDisplayNode::SafeDownCast(
+        this->GetNthDisplayNode(displayNodeIndex));
+      if (!displayNode || !displayNode->GetVisibility())
+        {
+        continue;
+        }
+      std::vector<std::string> segmentIDs;
+      displayNode->GetVisibleSegmentIDs(segmentIDs);
+      visibleSegmentIDs.insert(segmentIDs.begin(), segmentIDs.end());
+      }
+    }
+
+  int numberOfEvictedRepresentations = 0;
+  std::vector<std::string> segmentIDs;
+  this->Segmentation->GetSegmentIDs(segmentIDs);
+  for (std::vector<std::string>::iterator segmentIdIt = segmentIDs.begin(); segmentIdIt != segmentIDs.end(); ++segmentIdIt)
+    {
+    if (visibleSegmentIDs.find(*segmentIdIt) != visibleSegmentIDs.end())
+      {
+      continue;
+      }
+    vtkSegment* segment = this->Segmentation->GetSegment(*segmentIdIt);
+    std::vector<std::string> representationNames;
+    segment->GetContainedRepresentationNames(representationNames);
+    for (std::vector<std::string>::iterator nameIt = representationNames.begin(); nameIt != representationNames.end(); ++nameIt)
+      {
+      if (this->Segmentation->EvictSegmentRepresentation(*segmentIdIt, *nameIt))
+        {
+        ++numberOfEvictedRepresentations;
+        }
+      }
+    }
+  return numberOfEvictedRepresentations;
+}
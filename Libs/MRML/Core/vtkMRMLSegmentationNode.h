@@ -141,6 +141,13 @@ public:
   /// Set reference image geometry conversion parameter from the volume node, keeping reference
   virtual void SetReferenceImageGeometryParameterFromVolumeNode(vtkMRMLScalarVolumeNode* volumeNode);
 
+  /// Evict the representations other than the master from the segments to release memory.
+  /// They are converted again when requested, \sa vtkSegmentation::EvictSegmentRepresentation
+  /// \param hiddenSegmentsOnly If true (default) then only the segments that are not visible
+  ///   in any display node are evicted, they are not converted again until they are shown.
+  /// \return Number of evicted representations
+  virtual int EvictDerivedRepresentations(bool hiddenSegmentsOnly=true);
+
   /// Get segmentation object
   vtkGetObjectMacro(Segmentation, vtkSegmentation);
   /// Set and observe segmentation object
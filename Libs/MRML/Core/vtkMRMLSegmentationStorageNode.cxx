@@ -51,6 +51,7 @@
 #include <vtkTransform.h>
 #include <vtkXMLMultiBlockDataWriter.h>
 #include <vtkXMLMultiBlockDataReader.h>
+#include <vtksys/MD5.h>
 #include <vtksys/SystemTools.hxx>
 
 #ifdef SUPPORT_4D_SPATIAL_NRRD
@@ -80,6 +81,9 @@ static const std::string KEY_SEGMENTATION_CONVERSION_PARAMETERS = "ConversionPar
 static const std::string KEY_SEGMENTATION_EXTENT = "Extent"; // Deprecated, kept only for being able to read legacy files.
 static const std::string KEY_SEGMENTATION_REFERENCE_IMAGE_EXTENT_OFFSET = "ReferenceImageExtentOffset";
 static const std::string KEY_SEGMENTATION_CONTAINED_REPRESENTATION_NAMES = "ContainedRepresentationNames";
+static const std::string KEY_SEGMENTATION_DERIVED_REPRESENTATION_CACHE = "DerivedRepresentationCache";
+static const std::string KEY_SEGMENT_REPRESENTATION_NAME = "RepresentationName";
+static const std::string KEY_SEGMENT_LABELMAP_HASH = "LabelmapHash";
 
 static const int SINGLE_SEGMENT_INDEX = -1; // used as segment index when there is only a single segment
 //----------------------------------------------------------------------------
@@ -88,6 +92,9 @@ vtkMRMLNodeNewMacro(vtkMRMLSegmentationStorageNode);
 //----------------------------------------------------------------------------
 vtkMRMLSegmentationStorageNode::vtkMRMLSegmentationStorageNode()
 {
+  this->CompressionLevel = -1;
+  this->NumberOfThreads = 0;
+  this->SaveDerivedRepresentationCache = false;
 }
 
 //----------------------------------------------------------------------------
@@ -99,6 +106,9 @@ vtkMRMLSegmentationStorageNode::~vtkMRMLSegmentationStorageNode()
 void vtkMRMLSegmentationStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   vtkMRMLStorageNode::PrintSelf(os,indent);
+  os << indent << "CompressionLevel: " << this->CompressionLevel << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "SaveDerivedRepresentationCache: " << (this->SaveDerivedRepresentationCache ? "true" : "false") << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -108,6 +118,34 @@ void vtkMRMLSegmentationStorageNode::ReadXMLAttributes(const char** atts)
 
   Superclass::ReadXMLAttributes(atts);
 
+  const char* attName;
+  const char* attValue;
+  while (*atts != NULL)
+    {
+    attName = *(atts++);
+    attValue = *(atts++);
+    if (!strcmp(attName, "compressionLevel"))
+      {
+      std::stringstream ss;
+      ss << attValue;
+      int compressionLevel = -1;
+      ss >> compressionLevel;
+      this->SetCompressionLevel(compressionLevel);
+      }
+    else if (!strcmp(attName, "numberOfThreads"))
+      {
+      std::stringstream ss;
+      ss << attValue;
+      int numberOfThreads = 0;
+      ss >> numberOfThreads;
+      this->SetNumberOfThreads(numberOfThreads);
+      }
+    else if (!strcmp(attName, "saveDerivedRepresentationCache"))
+      {
+      this->SetSaveDerivedRepresentationCache(!strcmp(attValue, "true"));
+      }
+    }
+
   this->EndModify(disabledModify);
 }
 
@@ -116,6 +154,9 @@ void vtkMRMLSegmentationStorageNode::WriteXML(ostream& of, int nIndent)
 {
   Superclass::WriteXML(of, nIndent);
   vtkIndent indent(nIndent);
+  of << indent << " compressionLevel=\"" << this->CompressionLevel << "\"";
+  of << indent << " numberOfThreads=\"" << this->NumberOfThreads << "\"";
+  of << indent << " saveDerivedRepresentationCache=\"" << (this->SaveDerivedRepresentationCache ? "true" : "false") << "\"";
 }
 
 //----------------------------------------------------------------------------
@@ -126,6 +167,13 @@ void vtkMRMLSegmentationStorageNode::Copy(vtkMRMLNode *anode)
   int disabledModify = this->StartModify();
 
   Superclass::Copy(anode);
+  vtkMRMLSegmentationStorageNode* node = vtkMRMLSegmentationStorageNode::SafeDownCast(anode);
+  if (node)
+    {
+    this->SetCompressionLevel(node->GetCompressionLevel());
+    this->SetNumberOfThreads(node->GetNumberOfThreads());
+    this->SetSaveDerivedRepresentationCache(node->GetSaveDerivedRepresentationCache());
+    }
 
   this->EndModify(disabledModify);
 }
@@ -487,6 +535,7 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
 
   vtkNew<vtkNRRDReader> reader;
   reader->SetFileName(path.c_str());
+  reader->SetNumberOfThreads(this->NumberOfThreads);
 
   // Check if this is a NRRD file that we can read
   if (!reader->CanReadFile(path.c_str()))
@@ -608,6 +657,16 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
     containedRepresentationNames = reader->GetHeaderValue(GetSegmentationMetaDataKey(KEY_SEGMENTATION_CONTAINED_REPRESENTATION_NAMES).c_str());
     }
 
+  // Read name of the file containing the saved derived representations
+  std::string derivedRepresentationCacheFileName;
+  kit = std::find(keys.begin(), keys.end(), GetSegmentationMetaDataKey(KEY_SEGMENTATION_DERIVED_REPRESENTATION_CACHE));
+  if (kit != keys.end())
+    {
+    derivedRepresentationCacheFileName = reader->GetHeaderValue(GetSegmentationMetaDataKey(KEY_SEGMENTATION_DERIVED_REPRESENTATION_CACHE).c_str());
+    }
+  std::string conversionParameters = segmentation->SerializeAllConversionParameters();
+  std::map<std::string, std::string> segmentHashes;
+
   // Read segment binary labelmaps
   for (int segmentIndex = 0; segmentIndex < numberOfFrames; ++segmentIndex)
     {
@@ -703,6 +762,11 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
       }
     currentBinaryLabelmap->SetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
 
+    if (!derivedRepresentationCacheFileName.empty())
+      {
+      segmentHashes[currentSegmentID] = GetLabelmapHash(currentBinaryLabelmap, currentSegmentExtent, conversionParameters);
+      }
+
     // Set loaded binary labelmap to segment
     currentSegment->AddRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), currentBinaryLabelmap);
 
@@ -716,7 +780,16 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
 
   segmentationNode->EndModify(segmentationNodeWasModified);
 
-  // Create contained representations now that all the data is loaded
+  // Reuse the saved derived representations of the segments that have not changed since they were saved
+  if (!derivedRepresentationCacheFileName.empty())
+    {
+    std::string derivedRepresentationCachePath =
+      vtksys::SystemTools::GetParentDirectory(path) + "/" + derivedRepresentationCacheFileName;
+    this->ReadDerivedRepresentationCache(segmentation, derivedRepresentationCachePath, segmentHashes);
+    }
+
+  // Create contained representations now that all the data is loaded.
+  // Only the segments that miss a representation are converted.
   this->CreateRepresentationsBySerializedNames(segmentation, containedRepresentationNames);
 
   return 1;
@@ -956,6 +1029,8 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
   vtkNew<vtkNRRDWriter> writer;
   writer->SetFileName(fullName.c_str());
   writer->SetUseCompression(this->GetUseCompression());
+  writer->SetCompressionLevel(this->CompressionLevel);
+  writer->SetNumberOfThreads(this->NumberOfThreads);
 
   // Create metadata dictionary
 
@@ -989,6 +1064,32 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
   std::string containedRepresentationNames = this->SerializeContainedRepresentationNames(segmentation);
   writer->SetAttribute(GetSegmentationMetaDataKey(KEY_SEGMENTATION_CONTAINED_REPRESENTATION_NAMES).c_str(), containedRepresentationNames);
 
+  // Derived poly data representations are saved in a multiblock file next to the image
+  // so that they do not have to be converted again when loading
+  std::vector<std::string> cachedRepresentationNames;
+  std::map<std::string, std::string> segmentHashes;
+  std::string derivedRepresentationCachePath;
+  if (this->SaveDerivedRepresentationCache)
+    {
+    std::vector<std::string> representationNames;
+    segmentation->GetContainedRepresentationNames(representationNames);
+    vtkSegment* firstSegment = segmentation->GetNthSegment(0);
+    for (std::vector<std::string>::iterator reprIt = representationNames.begin(); reprIt != representationNames.end(); ++reprIt)
+      {
+      if (*reprIt != segmentation->GetMasterRepresentationName()
+        && vtkPolyData::SafeDownCast(firstSegment->GetRepresentation(*reprIt)))
+        {
+        cachedRepresentationNames.push_back(*reprIt);
+        }
+      }
+    }
+  if (!cachedRepresentationNames.empty())
+    {
+    std::string derivedRepresentationCacheFileName = vtksys::SystemTools::GetFilenameWithoutLastExtension(fullName) + ".cache.vtm";
+    derivedRepresentationCachePath = vtksys::SystemTools::GetParentDirectory(fullName) + "/" + derivedRepresentationCacheFileName;
+    writer->SetAttribute(GetSegmentationMetaDataKey(KEY_SEGMENTATION_DERIVED_REPRESENTATION_CACHE).c_str(), derivedRepresentationCacheFileName);
+    }
+
   vtkNew<vtkImageAppendComponents> appender;
 
   // Dimensions of the output 4D NRRD file: (i, j, k, segment)
@@ -1056,6 +1157,11 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
       currentBinaryLabelmap = commonGeometryImage;
       }
 
+    if (!derivedRepresentationCachePath.empty())
+      {
+      segmentHashes[currentSegmentID] = GetLabelmapHash(currentBinaryLabelmap, currentBinaryLabelmapExtent, conversionParameters);
+      }
+
     // Set metadata for current segment
     writer->SetAttribute(GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_ID).c_str(), currentSegmentID);
     writer->SetAttribute(GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_NAME).c_str(), currentSegment->GetName());
@@ -1085,9 +1191,193 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
     writeFlag = 0;
     }
 
+  if (writeFlag && !derivedRepresentationCachePath.empty())
+    {
+    this->AddFileName(fullName.c_str());
+    writeFlag = this->WriteDerivedRepresentationCache(segmentation, derivedRepresentationCachePath, cachedRepresentationNames, segmentHashes);
+    }
+
   return writeFlag;
 }
 
+//----------------------------------------------------------------------------
+int vtkMRMLSegmentationStorageNode::WriteDerivedRepresentationCache(vtkSegmentation* segmentation, std::string path,
+  const std::vector<std::string>& representationNames, std::map<std::string, std::string>& segmentHashes)
+{
+  if (!segmentation)
+    {
+    vtkErrorMacro("WriteDerivedRepresentationCache: Invalid segmentation!");
+    return 0;
+    }
+
+  vtkSmartPointer<vtkMultiBlockDataSet> multiBlockDataset = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  unsigned int blockIndex = 0;
+  std::vector< std::string > segmentIDs;
+  segmentation->GetSegmentIDs(segmentIDs);
+  for (std::vector< std::string >::const_iterator segmentIdIt = segmentIDs.begin(); segmentIdIt != segmentIDs.end(); ++segmentIdIt)
+    {
+    vtkSegment* currentSegment = segmentation->GetSegment(*segmentIdIt);
+    std::map<std::string, std::string>::iterator hashIt = segmentHashes.find(*segmentIdIt);
+    if (!currentSegment || hashIt == segmentHashes.end())
+      {
+      // Segment was not written to the image file
+      continue;
+      }
+    for (std::vector<std::string>::const_iterator reprIt = representationNames.begin(); reprIt != representationNames.end(); ++reprIt)
+      {
+      vtkPolyData* currentPolyData = vtkPolyData::SafeDownCast(currentSegment->GetRepresentation(*reprIt));
+      if (!currentPolyData)
+        {
+        continue;
+        }
+      // Tag a shallow copy so that the representation in the segment is not changed
+      vtkSmartPointer<vtkPolyData> currentPolyDataCopy = vtkSmartPointer<vtkPolyData>::New();
+      currentPolyDataCopy->ShallowCopy(currentPolyData);
+      vtkSmartPointer<vtkFieldData> fieldData = vtkSmartPointer<vtkFieldData>::New();
+      fieldData->DeepCopy(currentPolyData->GetFieldData());
+      currentPolyDataCopy->SetFieldData(fieldData);
+
+      const std::string tagKeys[3] = { KEY_SEGMENT_ID, KEY_SEGMENT_REPRESENTATION_NAME, KEY_SEGMENT_LABELMAP_HASH };
+      const std::string tagValues[3] = { *segmentIdIt, *reprIt, hashIt->second };
+      for (int tagIndex = 0; tagIndex < 3; ++tagIndex)
+        {
+        vtkSmartPointer<vtkStringArray> tagArray = vtkSmartPointer<vtkStringArray>::New();
+        tagArray->SetNumberOfValues(1);
+        tagArray->SetValue(0, tagValues[tagIndex]);
+        tagArray->SetName(GetSegmentMetaDataKey(SINGLE_SEGMENT_INDEX, tagKeys[tagIndex]).c_str());
+        fieldData->AddArray(tagArray);
+        }
+
+      multiBlockDataset->SetBlock(blockIndex++, currentPolyDataCopy);
+      }
+    }
+
+  vtkSmartPointer<vtkXMLMultiBlockDataWriter> writer = vtkSmartPointer<vtkXMLMultiBlockDataWriter>::New();
+  writer->SetInputData(multiBlockDataset);
+  writer->SetFileName(path.c_str());
+  writer->SetDataModeToBinary();
+  writer->SetCompressorTypeToZLib();
+  writer->Write();
+  if (writer->GetErrorCode())
+    {
+    vtkErrorMacro("WriteDerivedRepresentationCache: Failed to write file " << path);
+    return 0;
+    }
+
+  // Add all files to storage node (multiblock dataset writes blocks to individual files in a separate folder)
+  this->AddFileName(path.c_str());
+  std::string fileNameWithoutExtension = vtksys::SystemTools::GetFilenameWithoutLastExtension(path);
+  std::string multiBlockDirectory = vtksys::SystemTools::GetParentDirectory(path) + "/" + fileNameWithoutExtension;
+  for (unsigned int fileIndex = 0; fileIndex < blockIndex; ++fileIndex)
+    {
+    std::stringstream ssBlockFilePath;
+    ssBlockFilePath << multiBlockDirectory << "/" << fileNameWithoutExtension << "_" << fileIndex << ".vtp";
+    this->AddFileName(ssBlockFilePath.str().c_str());
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLSegmentationStorageNode::ReadDerivedRepresentationCache(vtkSegmentation* segmentation, std::string path,
+  std::map<std::string, std::string>& segmentHashes)
+{
+  if (!segmentation)
+    {
+    vtkErrorMacro("ReadDerivedRepresentationCache: Invalid segmentation!");
+    return 0;
+    }
+  if (!vtksys::SystemTools::FileExists(path.c_str()))
+    {
+    // Representations will be converted from the master representation
+    vtkWarningMacro("ReadDerivedRepresentationCache: Derived representation file " << path << " is not found");
+    return 0;
+    }
+
+  vtkSmartPointer<vtkXMLMultiBlockDataReader> reader = vtkSmartPointer<vtkXMLMultiBlockDataReader>::New();
+  reader->SetFileName(path.c_str());
+  reader->Update();
+  vtkMultiBlockDataSet* multiBlockDataset = vtkMultiBlockDataSet::SafeDownCast(reader->GetOutputDataObject(0));
+  if (!multiBlockDataset)
+    {
+    vtkWarningMacro("ReadDerivedRepresentationCache: Failed to read file " << path);
+    return 0;
+    }
+
+  std::string idKey = GetSegmentMetaDataKey(SINGLE_SEGMENT_INDEX, KEY_SEGMENT_ID);
+  std::string representationNameKey = GetSegmentMetaDataKey(SINGLE_SEGMENT_INDEX, KEY_SEGMENT_REPRESENTATION_NAME);
+  std::string hashKey = GetSegmentMetaDataKey(SINGLE_SEGMENT_INDEX, KEY_SEGMENT_LABELMAP_HASH);
+  for (unsigned int blockIndex = 0; blockIndex < multiBlockDataset->GetNumberOfBlocks(); ++blockIndex)
+    {
+    vtkPolyData* currentPolyData = vtkPolyData::SafeDownCast(multiBlockDataset->GetBlock(blockIndex));
+    if (!currentPolyData)
+      {
+      continue;
+      }
+    vtkStringArray* idArray = vtkStringArray::SafeDownCast(currentPolyData->GetFieldData()->GetAbstractArray(idKey.c_str()));
+    vtkStringArray* representationNameArray = vtkStringArray::SafeDownCast(
+      currentPolyData->GetFieldData()->GetAbstractArray(representationNameKey.c_str()));
+    vtkStringArray* hashArray = vtkStringArray::SafeDownCast(currentPolyData->GetFieldData()->GetAbstractArray(hashKey.c_str()));
+    if (!idArray || idArray->GetNumberOfValues() < 1
+      || !representationNameArray || representationNameArray->GetNumberOfValues() < 1
+      || !hashArray || hashArray->GetNumberOfValues() < 1)
+      {
+      continue;
+      }
+    std::string segmentId = idArray->GetValue(0);
+    std::map<std::string, std::string>::iterator hashIt = segmentHashes.find(segmentId);
+    vtkSegment* segment = segmentation->GetSegment(segmentId);
+    if (!segment || hashIt == segmentHashes.end() || hashIt->second != hashArray->GetValue(0))
+      {
+      // The labelmap or the conversion parameters changed since the representation was saved
+      continue;
+      }
+
+    std::string representationName = representationNameArray->GetValue(0);
+    currentPolyData->GetFieldData()->RemoveArray(idKey.c_str());
+    currentPolyData->GetFieldData()->RemoveArray(representationNameKey.c_str());
+    currentPolyData->GetFieldData()->RemoveArray(hashKey.c_str());
+    segment->AddRepresentation(representationName, currentPolyData);
+    }
+
+  this->AddFileName(path.c_str());
+  std::string fileNameWithoutExtension = vtksys::SystemTools::GetFilenameWithoutLastExtension(path);
+  std::string multiBlockDirectory = vtksys::SystemTools::GetParentDirectory(path) + "/" + fileNameWithoutExtension;
+  for (unsigned int fileIndex = 0; fileIndex < multiBlockDataset->GetNumberOfBlocks(); ++fileIndex)
+    {
+    std::stringstream ssBlockFilePath;
+    ssBlockFilePath << multiBlockDirectory << "/" << fileNameWithoutExtension << "_" << fileIndex << ".vtp";
+    this->AddFileName(ssBlockFilePath.str().c_str());
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLSegmentationStorageNode::GetLabelmapHash(vtkImageData* labelmap, int extent[6], const std::string& conversionParameters)
+{
+  vtksysMD5* md5 = vtksysMD5_New();
+  vtksysMD5_Initialize(md5);
+  std::string header = conversionParameters + SERIALIZATION_SEPARATOR + GetImageExtentAsString(extent);
+  vtksysMD5_Append(md5, reinterpret_cast<const unsigned char*>(header.c_str()), static_cast<int>(header.size()));
+  if (labelmap && extent[0] <= extent[1] && extent[2] <= extent[3] && extent[4] <= extent[5])
+    {
+    int rowSize = (extent[1] - extent[0] + 1) * labelmap->GetScalarSize() * labelmap->GetNumberOfScalarComponents();
+    for (int z = extent[4]; z <= extent[5]; ++z)
+      {
+      for (int y = extent[2]; y <= extent[3]; ++y)
+        {
+        const unsigned char* rowPtr = static_cast<const unsigned char*>(labelmap->GetScalarPointer(extent[0], y, z));
+        vtksysMD5_Append(md5, rowPtr, rowSize);
+        }
+      }
+    }
+  char hexDigest[32];
+  vtksysMD5_FinalizeHex(md5, hexDigest);
+  vtksysMD5_Delete(md5);
+  return std::string(hexDigest, 32);
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLSegmentationStorageNode::WritePolyDataRepresentation(vtkMRMLSegmentationNode* segmentationNode, std::string path)
 {
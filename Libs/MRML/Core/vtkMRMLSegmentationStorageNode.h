@@ -33,6 +33,12 @@
   #include <itkImageRegionIteratorWithIndex.h>
 #endif
 
+// STD includes
+#include <map>
+#include <string>
+#include <vector>
+
+class vtkImageData;
 class vtkMRMLSegmentationNode;
 class vtkMatrix4x4;
 class vtkPolyData;
@@ -86,6 +92,29 @@ public:
   /// Reset supported write file types. Called when master representation is changed
   void ResetSupportedWriteFileTypes();
 
+  ///
+  /// zlib compression level used when compression is enabled,
+  /// from 0 (fastest) to 9 (smallest file). Default: -1 (zlib default level).
+  vtkSetClampMacro(CompressionLevel, int, -1, 9);
+  vtkGetMacro(CompressionLevel, int);
+
+  ///
+  /// Maximum number of threads used for compressing and decompressing the image data.
+  /// Default: 0 (vtkMultiThreader global default number of threads).
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
+  ///
+  /// Save the poly data representations other than the master (e.g. closed surface)
+  /// next to binary labelmap segmentation files, in a multiblock file (*.cache.vtm).
+  /// Each saved representation is tagged with a hash of the segment labelmap and of
+  /// the conversion parameters. When the segmentation is read, the saved representations
+  /// are used instead of converting them again if the hashes still match.
+  /// Default: false.
+  vtkSetMacro(SaveDerivedRepresentationCache, bool);
+  vtkGetMacro(SaveDerivedRepresentationCache, bool);
+  vtkBooleanMacro(SaveDerivedRepresentationCache, bool);
+
 protected:
   /// Initialize all the supported read file types
   virtual void InitializeSupportedReadFileTypes();
@@ -129,6 +158,20 @@ protected:
   /// Create representations based on serialized representation names string
   void CreateRepresentationsBySerializedNames(vtkSegmentation* segmentation, std::string representationNames);
 
+  /// Write the derived poly data representations of the segments in the multiblock file \a path,
+  /// tagged with the hash of their segment. \sa SaveDerivedRepresentationCache
+  /// \param segmentHashes Hash of the labelmap of each segment, by segment ID
+  int WriteDerivedRepresentationCache(vtkSegmentation* segmentation, std::string path,
+    const std::vector<std::string>& representationNames, std::map<std::string, std::string>& segmentHashes);
+
+  /// Add the representations saved in the multiblock file \a path to the segments whose
+  /// labelmap hash is unchanged. \return Number of added representations
+  int ReadDerivedRepresentationCache(vtkSegmentation* segmentation, std::string path,
+    std::map<std::string, std::string>& segmentHashes);
+
+  /// Hash identifying the content of the \a extent region of a labelmap and the conversion parameters.
+  static std::string GetLabelmapHash(vtkImageData* labelmap, int extent[6], const std::string& conversionParameters);
+
   static std::string GetSegmentMetaDataKey(int segmentIndex, const std::string& keyName);
 
   static std::string GetSegmentationMetaDataKey(const std::string& keyName);
@@ -147,6 +190,10 @@ protected:
   vtkMRMLSegmentationStorageNode();
   ~vtkMRMLSegmentationStorageNode();
 
+  int CompressionLevel;
+  int NumberOfThreads;
+  bool SaveDerivedRepresentationCache;
+
 private:
   vtkMRMLSegmentationStorageNode(const vtkMRMLSegmentationStorageNode&);  /// Not implemented.
   void operator=(const vtkMRMLSegmentationStorageNode&);  /// Not implemented.
@@ -38,6 +38,9 @@ vtkMRMLSliceCompositeNode::vtkMRMLSliceCompositeNode()
   this->ForegroundVolumeID = NULL;
   this->LabelVolumeID = NULL;
   this->Compositing = 0;
+  this->CheckerboardSize = 32;
+  this->SwipePosition = 0.5;
+  this->FlickerForeground = 0;
   this->ForegroundOpacity = 0.0; // start by showing only the background volume
   this->LabelOpacity = 1.0; // Show the label if there is one
   this->LinkedControl = 0;
@@ -85,6 +88,8 @@ void vtkMRMLSliceCompositeNode::WriteXML(ostream& of, int nIndent)
    (this->LabelVolumeID ? this->LabelVolumeID : "") << "\"";
 
   of << indent << " compositing=\"" << this->Compositing << "\"";
+  of << indent << " checkerboardSize=\"" << this->CheckerboardSize << "\"";
+  of << indent << " swipePosition=\"" << this->SwipePosition << "\"";
   of << indent << " foregroundOpacity=\"" << this->ForegroundOpacity << "\"";
   of << indent << " labelOpacity=\"" << this->LabelOpacity << "\"";
   of << indent << " linkedControl=\"" << this->LinkedControl << "\"";
@@ -260,6 +265,14 @@ void vtkMRMLSliceCompositeNode::ReadXMLAttributes(const char** atts)
       {
       this->SetCompositing( atoi(attValue) );
       }
+    else if (!strcmp(attName, "checkerboardSize"))
+      {
+      this->SetCheckerboardSize( atoi(attValue) );
+      }
+    else if (!strcmp(attName, "swipePosition"))
+      {
+      this->SetSwipePosition( atof(attValue) );
+      }
     else if (!strcmp(attName, "foregroundOpacity"))
       {
       this->SetForegroundOpacity( atof(attValue) );
@@ -354,6 +367,9 @@ void vtkMRMLSliceCompositeNode::Copy(vtkMRMLNode *anode)
   this->SetForegroundVolumeID(node->GetForegroundVolumeID());
   this->SetLabelVolumeID(node->GetLabelVolumeID());
   this->SetCompositing(node->GetCompositing());
+  this->SetCheckerboardSize(node->GetCheckerboardSize());
+  this->SetSwipePosition(node->GetSwipePosition());
+  this->SetFlickerForeground(node->GetFlickerForeground());
   this->SetForegroundOpacity(node->GetForegroundOpacity());
   this->SetLabelOpacity(node->GetLabelOpacity());
   this->SetLinkedControl (node->GetLinkedControl());
@@ -379,6 +395,9 @@ void vtkMRMLSliceCompositeNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "LabelVolumeID: " <<
     (this->LabelVolumeID ? this->LabelVolumeID : "(none)") << "\n";
   os << indent << "Compositing: " << this->Compositing << "\n";
+  os << indent << "CheckerboardSize: " << this->CheckerboardSize << "\n";
+  os << indent << "SwipePosition: " << this->SwipePosition << "\n";
+  os << indent << "FlickerForeground: " << this->FlickerForeground << "\n";
   os << indent << "ForegroundOpacity: " << this->ForegroundOpacity << "\n";
   os << indent << "LabelOpacity: " << this->LabelOpacity << "\n";
   os << indent << "LinkedControl: " << this->LinkedControl << "\n";
@@ -80,10 +80,29 @@ class VTK_MRML_EXPORT vtkMRMLSliceCompositeNode : public vtkMRMLNode
 
   ///
   /// Compositing mode for foreground and background can be alpha
-  /// blending, reverse alpha blending, addition, or subtraction
+  /// blending, reverse alpha blending, addition, subtraction or one of
+  /// the compare modes (checkerboard, swipe, difference, flicker).
   vtkGetMacro (Compositing, int);
   vtkSetMacro (Compositing, int);
 
+  ///
+  /// Size in screen pixels of the squares of the Checkerboard compositing.
+  vtkGetMacro (CheckerboardSize, int);
+  vtkSetClampMacro (CheckerboardSize, int, 1, VTK_INT_MAX);
+
+  ///
+  /// Position of the Swipe compositing line, as a fraction of the view
+  /// width. The foreground is shown on the left of the line.
+  vtkGetMacro (SwipePosition, double);
+  vtkSetClampMacro (SwipePosition, double, 0., 1.);
+
+  ///
+  /// Layer shown by the Flicker compositing: foreground if on, background
+  /// otherwise. Toggled periodically by the view controllers.
+  vtkGetMacro (FlickerForeground, int);
+  vtkSetMacro (FlickerForeground, int);
+  vtkBooleanMacro (FlickerForeground, int);
+
   ///
   /// opacity of the Foreground for rendering over background
   /// TODO: make this an arbitrary list of layers
@@ -184,7 +203,11 @@ class VTK_MRML_EXPORT vtkMRMLSliceCompositeNode : public vtkMRMLNode
       Alpha = 0,
       ReverseAlpha,
       Add,
-      Subtract
+      Subtract,
+      Checkerboard,
+      Swipe,
+      Difference,
+      Flicker
     };
 
   /// Get/Set a flag indicating whether this node is actively being
@@ -249,6 +272,9 @@ protected:
   double ForegroundOpacity;
 
   int Compositing;
+  int CheckerboardSize;
+  double SwipePosition;
+  int FlickerForeground;
 
   double LabelOpacity;
   int LinkedControl;
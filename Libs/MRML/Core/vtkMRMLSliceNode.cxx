@@ -1579,9 +1579,17 @@ void vtkMRMLSliceNode::JumpSliceByOffsetting(double r, double a, double s)
   d = (r-sr)*sliceToRAS->GetElement(0,2)
       + (a-sa)*sliceToRAS->GetElement(1,2)
       + (s-ss)*sliceToRAS->GetElement(2,2);
-  sr += (d - this->ActiveSlice*sliceSpacing)*sliceToRAS->GetElement(0,2);
-  sa += (d - this->ActiveSlice*sliceSpacing)*sliceToRAS->GetElement(1,2);
-  ss += (d - this->ActiveSlice*sliceSpacing)*sliceToRAS->GetElement(2,2);
+  double offset = d - this->ActiveSlice*sliceSpacing;
+  // The point is already in the slice plane (e.g. the crosshair moves
+  // within a linked view of the same orientation): don't update the
+  // matrices, it would trigger a reslice and a render of the view.
+  if (fabs(offset) <= 1e-6 * sliceSpacing)
+    {
+    return;
+    }
+  sr += offset*sliceToRAS->GetElement(0,2);
+  sa += offset*sliceToRAS->GetElement(1,2);
+  ss += offset*sliceToRAS->GetElement(2,2);
 
   sliceToRAS->SetElement( 0, 3, sr );
   sliceToRAS->SetElement( 1, 3, sa );
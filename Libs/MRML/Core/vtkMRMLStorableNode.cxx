@@ -278,12 +278,30 @@ void vtkMRMLStorableNode::UpdateScene(vtkMRMLScene *scene)
     return;
     }
 
+  // Only bulk data (volumes and models) is deferred, other nodes are
+  // small and often expected to be loaded when the import ends.
+  if (scene && scene->GetDeferReadDataOnLoad() && scene->IsImporting() &&
+      (this->IsA("vtkMRMLVolumeNode") || this->IsA("vtkMRMLModelNode")) &&
+      this->GetNumberOfNodeReferences(this->GetStorageNodeReferenceRole()) > 0)
+    {
+    vtkDebugMacro("UpdateScene: deferring reading data of " << this->GetID());
+    scene->AddDeferredReadDataNode(this);
+    return;
+    }
+
+  this->ReadStorageNodesData(scene);
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLStorableNode::ReadStorageNodesData(vtkMRMLScene *scene)
+{
+  int res = 1;
   int numStorageNodes = this->GetNumberOfNodeReferences(this->GetStorageNodeReferenceRole());
 
-  vtkDebugMacro("UpdateScene: going through the storage node ids: " <<  numStorageNodes);
+  vtkDebugMacro("ReadStorageNodesData: going through the storage node ids: " <<  numStorageNodes);
   for (int i=0; i < numStorageNodes; i++)
     {
-    vtkDebugMacro("UpdateScene: getting storage node at i = " << i);
+    vtkDebugMacro("ReadStorageNodesData: getting storage node at i = " << i);
     vtkMRMLStorageNode *pnode = this->GetNthStorageNode(i);
 
     std::string fname = std::string("(null)");
@@ -297,23 +315,28 @@ void vtkMRMLStorableNode::UpdateScene(vtkMRMLScene *scene)
         {
         fname = std::string(pnode->GetURI());
         }
-      vtkDebugMacro("UpdateScene: calling ReadData, fname = " << fname.c_str());
+      vtkDebugMacro("ReadStorageNodesData: calling ReadData, fname = " << fname.c_str());
       if (pnode->ReadData(this) == 0)
         {
-        scene->SetErrorCode(1);
-        std::string msg = std::string("Error reading file ") + fname;
-        scene->SetErrorMessage(msg);
+        res = 0;
+        if (scene)
+          {
+          scene->SetErrorCode(1);
+          std::string msg = std::string("Error reading file ") + fname;
+          scene->SetErrorMessage(msg);
+          }
         }
       else
         {
-        vtkDebugMacro("UpdateScene: read data called and succeeded reading " << fname.c_str());
+        vtkDebugMacro("ReadStorageNodesData: read data called and succeeded reading " << fname.c_str());
         }
       }
     else
       {
-      vtkErrorMacro("UpdateScene: error getting " << i << "th storage node, id = " << (this->GetNthStorageNodeID(i) == NULL ? "null" : this->GetNthStorageNodeID(i)));
+      vtkErrorMacro("ReadStorageNodesData: error getting " << i << "th storage node, id = " << (this->GetNthStorageNodeID(i) == NULL ? "null" : this->GetNthStorageNodeID(i)));
       }
     }
+  return res;
 }
 
 vtkMRMLStorageNode* vtkMRMLStorableNode::GetNthStorageNode(int n)
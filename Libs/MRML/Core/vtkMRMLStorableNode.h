@@ -63,8 +63,18 @@ public:
 
   ///
   /// Finds the storage node and read the data
+  /// If the scene defers reading data on load, volume and model nodes
+  /// are only registered for a later ReadStorageNodesData().
+  /// \sa vtkMRMLScene::SetDeferReadDataOnLoad()
   virtual void UpdateScene(vtkMRMLScene *scene);
 
+  ///
+  /// Read the data of all the storage nodes into this node.
+  /// Errors are reported in the scene error code and message.
+  /// Returns 0 if any of the storage nodes failed to read, 1 otherwise.
+  /// \sa UpdateScene(), vtkMRMLScene::ReadNextDeferredData()
+  virtual int ReadStorageNodesData(vtkMRMLScene *scene);
+
   ///
   /// alternative method to propagate events generated in Storage nodes
   virtual void ProcessMRMLEvents ( vtkObject * /*caller*/,
@@ -1225,6 +1225,12 @@ int vtkMRMLStorageNode::WriteData(vtkMRMLNode* refNode)
   return res;
 }
 
+//------------------------------------------------------------------------------
+bool vtkMRMLStorageNode::PrefetchData(vtkMRMLNode* vtkNotUsed(refNode))
+{
+  return false;
+}
+
 //------------------------------------------------------------------------------
 int vtkMRMLStorageNode::ReadDataInternal(vtkMRMLNode* vtkNotUsed(refNode))
 {
@@ -294,6 +294,18 @@ public:
   /// instance to turn off compression.
   virtual void ConfigureForDataExchange() {};
 
+  /// Read the file into memory without modifying \a refNode, so that
+  /// the next ReadData() into \a refNode only has to set the data.
+  /// It is called from worker threads by vtkMRMLScene::Import() and must
+  /// not touch the scene or invoke events.
+  /// Returns true if the data was prefetched, false by default
+  /// (prefetch not supported).
+  /// \sa ClearPrefetchedData(), vtkMRMLScene::SetNumberOfReadDataThreads()
+  virtual bool PrefetchData(vtkMRMLNode* refNode);
+
+  /// Release the data read by PrefetchData() if ReadData() did not use it.
+  virtual void ClearPrefetchedData() {};
+
   /// Helper function for getting extension from a full filename.
   /// It always returns lowercase extension.
   static std::string GetLowercaseExtensionFromFileName(const std::string& filename);
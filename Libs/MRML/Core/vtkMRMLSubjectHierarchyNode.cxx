@@ -392,14 +392,23 @@ void vtkMRMLSubjectHierarchyNode::GetAssociatedChildrenNodes(vtkCollection *chil
     nodeClass = childClass;
     }
 
-  int numNodes = this->Scene->GetNumberOfNodesByClass(nodeClass.c_str());
-  for (int n=0; n < numNodes; n++)
+  // Only visit the nodes in the branch using the cached children map
+  // instead of looking up the hierarchy of every node of the scene
+  std::vector<vtkMRMLHierarchyNode*> branchNodes;
+  branchNodes.push_back(this);
+  this->GetAllChildrenNodes(branchNodes);
+  for (std::vector<vtkMRMLHierarchyNode*>::iterator branchIt=branchNodes.begin(); branchIt!=branchNodes.end(); ++branchIt)
     {
-    vtkMRMLNode* currentNode = this->Scene->GetNthNodeByClass(n, nodeClass.c_str());
+    vtkMRMLHierarchyNode* branchNode = (*branchIt);
+    vtkMRMLNode* currentNode = branchNode->vtkMRMLHierarchyNode::GetAssociatedNode();
 
-    // Don't include intermediate nodes in nested associations
+    // Skip intermediate nodes in nested associations, use the node at the end of the association
     vtkMRMLHierarchyNode* currentHierarchyNode = vtkMRMLHierarchyNode::SafeDownCast(currentNode);
     if (currentHierarchyNode && currentHierarchyNode->GetAssociatedNodeID())
+      {
+      currentNode = currentHierarchyNode->vtkMRMLHierarchyNode::GetAssociatedNode();
+      }
+    if (!currentNode || !currentNode->IsA(nodeClass.c_str()))
       {
       continue;
       }
@@ -417,16 +426,10 @@ void vtkMRMLSubjectHierarchyNode::GetAssociatedChildrenNodes(vtkCollection *chil
         }
       }
 
-    while (hierarchyNode)
+    // Only add the node once, for the hierarchy node that it belongs to
+    if (hierarchyNode == branchNode)
       {
-      if (hierarchyNode == this)
-        {
-        children->AddItem(currentNode);
-        break;
-        }
-
-      // The hierarchy node for this node may not be the one we're checking against, go up the tree
-      hierarchyNode = vtkMRMLHierarchyNode::SafeDownCast(hierarchyNode->GetParentNode());
+      children->AddItem(currentNode);
       }
     }
 }
@@ -594,8 +597,8 @@ vtkMRMLSubjectHierarchyNode* vtkMRMLSubjectHierarchyNode::GetAssociatedSubjectHi
     return NULL;
     }
 
-  AssociatedHierarchyNodesType sceneAssociations = sceneIt->second;
-  std::map<std::string, vtkMRMLHierarchyNode*>::iterator assocIt =
+  const AssociatedHierarchyNodesType& sceneAssociations = sceneIt->second;
+  std::map<std::string, vtkMRMLHierarchyNode*>::const_iterator assocIt =
     sceneAssociations.find(associatedNode->GetID());
   if (assocIt != sceneAssociations.end())
     {
@@ -608,7 +611,7 @@ vtkMRMLSubjectHierarchyNode* vtkMRMLSubjectHierarchyNode::GetAssociatedSubjectHi
     // was used, or the node does not have an associated subject hierarchy node
     else
       {
-      std::map<std::string, vtkMRMLHierarchyNode*>::iterator nestedIt =
+      std::map<std::string, vtkMRMLHierarchyNode*>::const_iterator nestedIt =
         sceneAssociations.find(associatedHierarchyNode->GetID());
       if (nestedIt != sceneAssociations.end())
         {
@@ -48,6 +48,8 @@ vtkMRMLTableSQLiteStorageNode::vtkMRMLTableSQLiteStorageNode()
 {
   this->TableName = 0;
   this->Password = 0;
+  this->RowOffset = 0;
+  this->NumberOfRowsToRead = -1;
   this->DefaultWriteFileExtension = "sqlite3";
 }
 
@@ -60,6 +62,9 @@ vtkMRMLTableSQLiteStorageNode::~vtkMRMLTableSQLiteStorageNode()
 void vtkMRMLTableSQLiteStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   vtkMRMLStorageNode::PrintSelf(os,indent);
+  os << indent << "TableName: " << (this->TableName ? this->TableName : "(none)") << "\n";
+  os << indent << "RowOffset: " << this->RowOffset << "\n";
+  os << indent << "NumberOfRowsToRead: " << this->NumberOfRowsToRead << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -92,29 +97,13 @@ int vtkMRMLTableSQLiteStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     return 0;
     }
 
-  std::string dbname = std::string("sqlite://") + fullName;
-  vtkSmartPointer<vtkSQLiteDatabase> database = vtkSmartPointer<vtkSQLiteDatabase>::Take(
-                   vtkSQLiteDatabase::SafeDownCast( vtkSQLiteDatabase::CreateFromURL(dbname.c_str())));
-
-  if (!database.GetPointer() || !database->Open(this->GetPassword(), vtkSQLiteDatabase::USE_EXISTING))
+  vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+  if (!this->ReadTableRows(table, this->RowOffset, this->NumberOfRowsToRead))
     {
-    vtkErrorMacro("ReadData: database file '" << fullName << "cannot be openned");
+    vtkErrorMacro("ReadData: failed to read table from file: " << fullName);
     return 0;
     }
 
-  vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(
-                   vtkSQLiteQuery::SafeDownCast( database->GetQueryInstance()));
-  std::string queryString("select * from ");
-  queryString += std::string(this->TableName);
-  query->SetQuery(queryString.c_str());
-  query->Execute();
-
-  vtkSmartPointer<vtkRowQueryToTable> queryToTable = vtkSmartPointer<vtkRowQueryToTable>::New();
-  queryToTable->SetQuery(query);
-  queryToTable->Update();
-
-  vtkSmartPointer<vtkTable> table = queryToTable->GetOutput();
-
   tableNode->SetAndObserveTable(table);
 
   vtkDebugMacro("ReadData: successfully read table from file: " << fullName);
@@ -236,27 +225,36 @@ int vtkMRMLTableSQLiteStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     vtkErrorMacro(<<"Error performing 'create table' query");
     }
 
-  //iterate over the rows of the vtkTable to complete the insert query
+  //insert all the rows with one prepared statement in a single transaction
+  //(committing each row separately would be orders of magnitude slower)
+  std::string insertQuery = insertPreamble;
+  for (vtkIdType j = 0; j < numColumns; j++)
+    {
+    insertQuery += (j < numColumns - 1 ? "?, " : "?);");
+    }
+  if (!query->BeginTransaction())
+    {
+    vtkErrorMacro(<<"Error starting transaction: " << query->GetLastErrorText());
+    }
+  query->SetQuery(insertQuery.c_str());
   vtkIdType numRows = table->GetNumberOfRows();
   for(vtkIdType i = 0; i < numRows; i++)
     {
-    std::string insertQuery = insertPreamble;
     for (vtkIdType j = 0; j < numColumns; j++)
       {
-      insertQuery += "'" + table->GetValue(i, j).ToString() + "'";
-      if(j < numColumns - 1)
-        {
-        insertQuery += ", ";
-        }
+      // the vtkVariant overload binds the value according to its type
+      query->vtkSQLQuery::BindParameter(static_cast<int>(j), table->GetValue(i, j));
       }
-    insertQuery += ");";
     //perform the insert query for this row
-    query->SetQuery(insertQuery.c_str());
     if(!query->Execute())
       {
       vtkErrorMacro(<<"Error performing 'insert' query");
       }
     }
+  if (!query->CommitTransaction())
+    {
+    vtkErrorMacro(<<"Error committing transaction: " << query->GetLastErrorText());
+    }
 
   //cleanup and return
   query->Delete();
@@ -267,6 +265,139 @@ int vtkMRMLTableSQLiteStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
   return 1;
 }
 
+//----------------------------------------------------------------------------
+vtkSQLiteDatabase* vtkMRMLTableSQLiteStorageNode::OpenDatabase(int mode)
+{
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty())
+    {
+    vtkErrorMacro("OpenDatabase: File name not specified");
+    return NULL;
+    }
+  std::string dbname = std::string("sqlite://") + fullName;
+  vtkSQLiteDatabase* database = vtkSQLiteDatabase::SafeDownCast(vtkSQLiteDatabase::CreateFromURL(dbname.c_str()));
+  if (!database || !database->Open(this->GetPassword(), mode))
+    {
+    vtkErrorMacro("OpenDatabase: database file '" << fullName << "' cannot be opened");
+    if (database)
+      {
+      database->Delete();
+      }
+    return NULL;
+    }
+  return database;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTableSQLiteStorageNode::ReadTableRows(vtkTable* table, vtkIdType firstRow, vtkIdType numberOfRows)
+{
+  if (!table)
+    {
+    vtkErrorMacro("ReadTableRows: invalid output table");
+    return false;
+    }
+  if (!this->TableName || std::string(this->TableName).empty())
+    {
+    vtkErrorMacro("ReadTableRows: no table name specified");
+    return false;
+    }
+  vtkSmartPointer<vtkSQLiteDatabase> database = vtkSmartPointer<vtkSQLiteDatabase>::Take(
+    this->OpenDatabase(vtkSQLiteDatabase::USE_EXISTING));
+  if (!database.GetPointer())
+    {
+    return false;
+    }
+
+  vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(
+                   vtkSQLiteQuery::SafeDownCast( database->GetQueryInstance()));
+  std::string queryString("select * from ");
+  queryString += std::string(this->TableName);
+  if (firstRow > 0 || numberOfRows >= 0)
+    {
+    // SQLite requires a limit for using an offset, negative limit means no limit
+    queryString += " limit ? offset ?";
+    }
+  query->SetQuery(queryString.c_str());
+  if (firstRow > 0 || numberOfRows >= 0)
+    {
+    query->BindParameter(0, static_cast<vtkTypeInt64>(numberOfRows >= 0 ? numberOfRows : -1));
+    query->BindParameter(1, static_cast<vtkTypeInt64>(firstRow > 0 ? firstRow : 0));
+    }
+
+  // the query is executed by the filter
+  vtkSmartPointer<vtkRowQueryToTable> queryToTable = vtkSmartPointer<vtkRowQueryToTable>::New();
+  queryToTable->SetQuery(query);
+  queryToTable->Update();
+  if (query->HasError())
+    {
+    vtkErrorMacro("ReadTableRows: query failed: " << query->GetLastErrorText());
+    return false;
+    }
+  table->ShallowCopy(queryToTable->GetOutput());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLTableSQLiteStorageNode::GetNumberOfRowsInDatabase()
+{
+  if (!this->TableName || std::string(this->TableName).empty())
+    {
+    vtkErrorMacro("GetNumberOfRowsInDatabase: no table name specified");
+    return -1;
+    }
+  vtkSmartPointer<vtkSQLiteDatabase> database = vtkSmartPointer<vtkSQLiteDatabase>::Take(
+    this->OpenDatabase(vtkSQLiteDatabase::USE_EXISTING));
+  if (!database.GetPointer())
+    {
+    return -1;
+    }
+  vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(
+                   vtkSQLiteQuery::SafeDownCast( database->GetQueryInstance()));
+  std::string queryString("select count(*) from ");
+  queryString += std::string(this->TableName);
+  query->SetQuery(queryString.c_str());
+  if (!query->Execute() || !query->NextRow())
+    {
+    vtkErrorMacro("GetNumberOfRowsInDatabase: query failed: " << query->GetLastErrorText());
+    return -1;
+    }
+  return query->DataValue(0).ToTypeInt64();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTableSQLiteStorageNode::GetColumnStatistics(const char* columnName, vtkIdType& count,
+  double& minimum, double& maximum, double& mean)
+{
+  if (!columnName || !this->TableName || std::string(this->TableName).empty())
+    {
+    vtkErrorMacro("GetColumnStatistics: no table or column name specified");
+    return false;
+    }
+  vtkSmartPointer<vtkSQLiteDatabase> database = vtkSmartPointer<vtkSQLiteDatabase>::Take(
+    this->OpenDatabase(vtkSQLiteDatabase::USE_EXISTING));
+  if (!database.GetPointer())
+    {
+    return false;
+    }
+  vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(
+                   vtkSQLiteQuery::SafeDownCast( database->GetQueryInstance()));
+  std::string quotedColumnName = std::string("\"") + columnName + "\"";
+  std::string queryString = "select count(" + quotedColumnName + "), min(" + quotedColumnName
+    + "), max(" + quotedColumnName + "), avg(" + quotedColumnName + ") from " + std::string(this->TableName);
+  query->SetQuery(queryString.c_str());
+  if (!query->Execute() || !query->NextRow())
+    {
+    vtkErrorMacro("GetColumnStatistics: query failed: " << query->GetLastErrorText());
+    return false;
+    }
+  count = query->DataValue(0).ToTypeInt64();
+  minimum = query->DataValue(1).ToDouble();
+  maximum = query->DataValue(2).ToDouble();
+  mean = query->DataValue(3).ToDouble();
+  return true;
+}
+
+//----------------------------------------------------------------------------
 int vtkMRMLTableSQLiteStorageNode::DropTable(char *tableName, vtkSQLiteDatabase* database)
 {
   if(!tableName || std::string(tableName).empty())
@@ -30,9 +30,16 @@
 /// vtkMRMLTableSQLiteStorageNode allows reading/writing of table node from
 /// SQLight database.
 ///
+/// Large database tables can be read in pages: only NumberOfRowsToRead rows
+/// starting at RowOffset are read into the table node. Other pages can be
+/// read using ReadTableRows() and column statistics can be computed in the
+/// database (GetColumnStatistics()) without reading the entire table.
+///
+/// Rows are written in a single transaction, using a prepared statement.
 ///
 
 class vtkSQLiteDatabase;
+class vtkTable;
 
 class VTK_MRML_EXPORT vtkMRMLTableSQLiteStorageNode : public vtkMRMLStorageNode
 {
@@ -57,6 +64,30 @@ public:
   vtkSetStringMacro(TableName);
   vtkGetStringMacro(TableName);
 
+  /// Index of the first database table row that is read into the table node.
+  /// Default is 0.
+  vtkSetMacro(RowOffset, vtkIdType);
+  vtkGetMacro(RowOffset, vtkIdType);
+
+  /// Maximum number of rows that are read into the table node.
+  /// All rows are read if negative (default).
+  vtkSetMacro(NumberOfRowsToRead, vtkIdType);
+  vtkGetMacro(NumberOfRowsToRead, vtkIdType);
+
+  /// Read a range of rows of the database table into the output table.
+  /// All the remaining rows are read if numberOfRows is negative.
+  /// Returns false on failure.
+  bool ReadTableRows(vtkTable* table, vtkIdType firstRow, vtkIdType numberOfRows);
+
+  /// Get the number of rows of the database table, -1 on failure.
+  vtkIdType GetNumberOfRowsInDatabase();
+
+  /// Compute number of non-null values, minimum, maximum, and mean of a column
+  /// of the database table using an SQL query.
+  /// Returns false on failure.
+  bool GetColumnStatistics(const char* columnName, vtkIdType& count,
+    double& minimum, double& maximum, double& mean);
+
   /// Drop a specified table from the database
   static int DropTable(char *tableName, vtkSQLiteDatabase* database);
 
@@ -78,8 +109,14 @@ protected:
   /// Write data from a  referenced node. Returns 0 on failure.
   virtual int WriteDataInternal(vtkMRMLNode *refNode);
 
+  /// Open the database of the file of the storage node.
+  /// Returns NULL on failure, the caller is responsible for deleting the returned database.
+  vtkSQLiteDatabase* OpenDatabase(int mode);
+
   char *TableName;
   char *Password;
+  vtkIdType RowOffset;
+  vtkIdType NumberOfRowsToRead;
 };
 
 #endif
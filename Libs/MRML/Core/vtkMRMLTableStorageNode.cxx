@@ -32,9 +32,52 @@
 #include <vtkTable.h>
 #include <vtkStringArray.h>
 #include <vtkBitArray.h>
+#include <vtkDataArray.h>
 #include <vtkNew.h>
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <cstdlib>
+#include <limits>
+
+namespace
+{
+//----------------------------------------------------------------------------
+template <class T>
+void ParseNumericValues(vtkStringArray* strings, T* values)
+{
+  vtkIdType numberOfValues = strings->GetNumberOfValues();
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+    {
+    const char* str = strings->GetValue(i).c_str();
+    if (std::numeric_limits<T>::is_integer)
+      {
+      values[i] = static_cast<T>(strtoll(str, NULL, 10));
+      }
+    else
+      {
+      values[i] = static_cast<T>(strtod(str, NULL));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int GetScalarTypeFromString(const std::string& typeName)
+{
+  const int numericTypes[] = { VTK_CHAR, VTK_SIGNED_CHAR, VTK_UNSIGNED_CHAR,
+    VTK_SHORT, VTK_UNSIGNED_SHORT, VTK_INT, VTK_UNSIGNED_INT, VTK_LONG, VTK_UNSIGNED_LONG,
+    VTK_LONG_LONG, VTK_UNSIGNED_LONG_LONG, VTK_FLOAT, VTK_DOUBLE };
+  for (unsigned int i = 0; i < sizeof(numericTypes) / sizeof(int); ++i)
+    {
+    if (typeName == vtkImageScalarTypeNameMacro(numericTypes[i]))
+      {
+      return numericTypes[i];
+      }
+    }
+  return VTK_VOID;
+}
+}
+
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLTableStorageNode);
 
@@ -156,15 +199,45 @@ int vtkMRMLTableStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     // Bool type: copy contents into bit array
     else if (!typeSpecifier.compare("type=bool"))
       {
+      vtkStringArray* stringColumn = vtkStringArray::SafeDownCast(column);
       vtkSmartPointer<vtkBitArray> boolColumn = vtkSmartPointer<vtkBitArray>::New();
       boolColumn->SetName(cleanColumnName.c_str());
       boolColumn->SetNumberOfTuples(column->GetNumberOfTuples());
-      for (int row=0; row<column->GetNumberOfTuples(); ++row)
+      for (vtkIdType row=0; row<column->GetNumberOfTuples(); ++row)
         {
-        boolColumn->SetVariantValue(row, column->GetVariantValue(row));
+        if (stringColumn)
+          {
+          boolColumn->SetValue(row, strtol(stringColumn->GetValue(row).c_str(), NULL, 10) != 0);
+          }
+        else
+          {
+          boolColumn->SetVariantValue(row, column->GetVariantValue(row));
+          }
         }
       table->AddColumn(boolColumn);
       }
+    // Numeric type (type=double, type=int, ...): parse the values directly into a typed array
+    else if (!typeSpecifier.compare(0, 5, "type=")
+      && GetScalarTypeFromString(typeSpecifier.substr(5)) != VTK_VOID
+      && vtkStringArray::SafeDownCast(column))
+      {
+      vtkStringArray* stringColumn = vtkStringArray::SafeDownCast(column);
+      vtkSmartPointer<vtkDataArray> numericColumn = vtkSmartPointer<vtkDataArray>::Take(
+        vtkDataArray::CreateDataArray(GetScalarTypeFromString(typeSpecifier.substr(5))));
+      numericColumn->SetName(cleanColumnName.c_str());
+      numericColumn->SetNumberOfTuples(stringColumn->GetNumberOfValues());
+      switch (numericColumn->GetDataType())
+        {
+        vtkTemplateMacro(ParseNumericValues(stringColumn, static_cast<VTK_TT*>(numericColumn->GetVoidPointer(0))));
+        }
+      table->AddColumn(numericColumn);
+      }
+    else
+      {
+      vtkWarningMacro("ReadData: unknown type specifier '" << typeSpecifier << "' in column " << columnName
+        << " in file: " << fullName << ", column is read as string");
+      table->AddColumn(column);
+      }
     }
   tableNode->SetAndObserveTable(table);
 
@@ -197,18 +270,26 @@ int vtkMRMLTableStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
   // Add type specifiers to column names in a temporary copy of the table
   // NOTE: In the future it may be necessary to specify not just type but also display,
   //       e.g. color and position data have the same type, but displayed differently
+  // Only the columns that are renamed are copied, the others are shared with the original table.
   vtkSmartPointer<vtkTable> tableCopy = vtkSmartPointer<vtkTable>::New();
-  tableCopy->DeepCopy(tableNode->GetTable());
-  for (int col=0; col<tableCopy->GetNumberOfColumns(); ++col)
+  vtkTable* table = tableNode->GetTable();
+  for (int col=0; table && col<table->GetNumberOfColumns(); ++col)
     {
-    vtkAbstractArray* column = tableCopy->GetColumn(col);
+    vtkAbstractArray* column = table->GetColumn(col);
 
     // Boolean type
     if (vtkBitArray::SafeDownCast(column))
       {
+      vtkSmartPointer<vtkBitArray> columnCopy = vtkSmartPointer<vtkBitArray>::New();
+      columnCopy->DeepCopy(vtkBitArray::SafeDownCast(column));
       std::string columnName(column->GetName() ? column->GetName() : "?");
       columnName.append("[type=bool]");
-      column->SetName(columnName.c_str());
+      columnCopy->SetName(columnName.c_str());
+      tableCopy->AddColumn(columnCopy);
+      }
+    else
+      {
+      tableCopy->AddColumn(column);
       }
     }
   
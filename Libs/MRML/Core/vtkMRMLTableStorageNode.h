@@ -38,6 +38,11 @@
 /// Values in comma-separated files may not contain quotation marks but may contain
 /// any other characters (including commas and tabs).
 ///
+/// Columns are read as strings unless the column name is followed by a type specifier:
+/// "[type=bool]" columns are read into a vtkBitArray, numeric type specifiers
+/// (such as "[type=double]", "[type=int]", "[type=unsigned char]") make the values
+/// parsed directly into a numeric array of that type.
+///
 class VTK_MRML_EXPORT vtkMRMLTableStorageNode : public vtkMRMLStorageNode
 {
 public:
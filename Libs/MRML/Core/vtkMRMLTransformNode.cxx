@@ -39,6 +39,7 @@ Version:   $Revision: 1.14 $
 #include <vtkTransform.h>
 
 // STD includes
+#include <algorithm>
 #include <sstream>
 #include <stack>
 
@@ -54,6 +55,12 @@ vtkMRMLTransformNode::vtkMRMLTransformNode()
 
   this->CachedMatrixTransformToParent=vtkMatrix4x4::New();
   this->CachedMatrixTransformFromParent=vtkMatrix4x4::New();
+
+  this->CachedMatrixTransformToWorld=vtkMatrix4x4::New();
+  this->CachedTransformToWorldLinear=true;
+  this->CachedTransformToWorldValid=false;
+  this->CachedTransformToWorldParent=NULL;
+  this->CachedTransformToWorldMTime=0;
 }
 
 //----------------------------------------------------------------------------
@@ -66,6 +73,8 @@ vtkMRMLTransformNode::~vtkMRMLTransformNode()
   this->CachedMatrixTransformToParent=NULL;
   this->CachedMatrixTransformFromParent->Delete();
   this->CachedMatrixTransformFromParent=NULL;
+  this->CachedMatrixTransformToWorld->Delete();
+  this->CachedMatrixTransformToWorld=NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -370,15 +379,51 @@ vtkAbstractTransform* vtkMRMLTransformNode::GetTransformFromParent()
 //----------------------------------------------------------------------------
 int  vtkMRMLTransformNode::IsTransformToWorldLinear()
 {
-  for (vtkMRMLTransformNode* current = this; current != NULL; current = current->GetParentTransformNode())
+  return this->UpdateCachedTransformToWorld() ? 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTransformNode::UpdateCachedTransformToWorld()
+{
+  vtkMRMLTransformNode* parent = this->GetParentTransformNode();
+  bool parentLinear = true;
+  vtkMTimeType latestMTime = 0;
+  if (parent != NULL)
     {
-    if (!current->IsLinear())
-      {
-      return 0;
-      }
+    parentLinear = parent->UpdateCachedTransformToWorld();
+    // the parent node modification time is included to detect when a parent
+    // node is replaced by another one
+    latestMTime = std::max(parent->CachedTransformToWorldMTime, parent->GetMTime());
     }
-  // not found non-linear transform component, therefore it's a linear transform
-  return 1;
+  vtkAbstractTransform* transformToParent = this->GetTransformToParent();
+  if (transformToParent != NULL)
+    {
+    latestMTime = std::max(latestMTime, transformToParent->GetMTime());
+    }
+
+  if (this->CachedTransformToWorldValid
+    && this->CachedTransformToWorldParent == parent
+    && this->CachedTransformToWorldMTime == latestMTime)
+    {
+    return this->CachedTransformToWorldLinear;
+    }
+
+  this->CachedTransformToWorldValid = true;
+  this->CachedTransformToWorldParent = parent;
+  this->CachedTransformToWorldMTime = latestMTime;
+  this->CachedTransformToWorldLinear = (parentLinear && this->IsLinear());
+  if (!this->CachedTransformToWorldLinear)
+    {
+    this->CachedMatrixTransformToWorld->Identity();
+    return false;
+    }
+  this->GetMatrixTransformToParent(this->CachedMatrixTransformToWorld);
+  if (parent != NULL)
+    {
+    vtkMatrix4x4::Multiply4x4(parent->CachedMatrixTransformToWorld, this->CachedMatrixTransformToWorld,
+      this->CachedMatrixTransformToWorld);
+    }
+  return true;
 }
 
 //----------------------------------------------------------------------------
@@ -828,12 +873,22 @@ int vtkMRMLTransformNode::GetMatrixTransformFromParent(vtkMatrix4x4* matrix)
 //----------------------------------------------------------------------------
 int  vtkMRMLTransformNode::GetMatrixTransformToWorld(vtkMatrix4x4* transformToWorld)
 {
+  if (transformToWorld != NULL && this->UpdateCachedTransformToWorld())
+    {
+    transformToWorld->DeepCopy(this->CachedMatrixTransformToWorld);
+    return 1;
+    }
   return vtkMRMLTransformNode::GetMatrixTransformBetweenNodes(this, NULL, transformToWorld);
 }
 
 //----------------------------------------------------------------------------
 int  vtkMRMLTransformNode::GetMatrixTransformFromWorld(vtkMatrix4x4* transformFromWorld)
 {
+  if (transformFromWorld != NULL && this->UpdateCachedTransformToWorld())
+    {
+    vtkMatrix4x4::Invert(this->CachedMatrixTransformToWorld, transformFromWorld);
+    return 1;
+    }
   return vtkMRMLTransformNode::GetMatrixTransformBetweenNodes(NULL, this, transformFromWorld);
 }
 
@@ -864,6 +919,28 @@ int  vtkMRMLTransformNode::GetMatrixTransformBetweenNodes(vtkMRMLTransformNode*
     return 1;
     }
 
+  // If both nodes are linearly transformed to world then use the cached
+  // transforms to world: sourceToTarget = inverse(targetToWorld) * sourceToWorld
+  bool sourceToWorldLinear = (sourceNode == NULL || sourceNode->UpdateCachedTransformToWorld());
+  bool targetToWorldLinear = (targetNode == NULL || targetNode->UpdateCachedTransformToWorld());
+  if (sourceToWorldLinear && targetToWorldLinear)
+    {
+    vtkNew<vtkMatrix4x4> worldToTarget;
+    if (targetNode != NULL)
+      {
+      vtkMatrix4x4::Invert(targetNode->CachedMatrixTransformToWorld, worldToTarget.GetPointer());
+      }
+    if (sourceNode != NULL)
+      {
+      vtkMatrix4x4::Multiply4x4(worldToTarget.GetPointer(), sourceNode->CachedMatrixTransformToWorld, transformSourceToTarget);
+      }
+    else
+      {
+      transformSourceToTarget->DeepCopy(worldToTarget.GetPointer());
+      }
+    return 1;
+    }
+
   if (sourceNode && sourceNode->IsTransformNodeMyParent(targetNode))
     {
     transformSourceToTarget->Identity();
@@ -364,6 +364,14 @@ protected:
   /// Sets and observes a transform and deletes the inverse (so that the inverse will be computed automatically)
   virtual void SetAndObserveTransform(vtkAbstractTransform** originalTransformPtr, vtkAbstractTransform** inverseTransformPtr, vtkAbstractTransform *transform);
 
+  ///
+  /// Recompute the cached transform to world if this node, any of its parents
+  /// or the parent hierarchy changed since the last computation.
+  /// Parent caches are updated first, therefore nodes that share parents
+  /// compute the common part of the hierarchy only once.
+  /// Returns true if the transform to world is linear.
+  bool UpdateCachedTransformToWorld();
+
   ///
   /// These transforms store the transforms that were set externally.
   /// We use the capability of generic transforms for concatenating and inverting the same
@@ -383,6 +391,15 @@ protected:
   /// GetMatrixTransformToParent and GetMatrixFromParent methods
   vtkMatrix4x4* CachedMatrixTransformToParent;
   vtkMatrix4x4* CachedMatrixTransformFromParent;
+
+  /// Cached matrix transform to world (identity if the transform to world is not linear)
+  /// and the parent node and latest modification time that it was computed for.
+  /// \sa UpdateCachedTransformToWorld
+  vtkMatrix4x4* CachedMatrixTransformToWorld;
+  bool CachedTransformToWorldLinear;
+  bool CachedTransformToWorldValid;
+  vtkMRMLTransformNode* CachedTransformToWorldParent;
+  vtkMTimeType CachedTransformToWorldMTime;
 };
 
 #endif
@@ -81,6 +81,12 @@ vtkAlgorithmOutput* vtkMRMLVectorVolumeDisplayNode::GetInputImageDataConnection(
     this->ShiftScale->GetInputConnection(0,0) : 0;
 }
 
+//----------------------------------------------------------------------------
+vtkAlgorithmOutput* vtkMRMLVectorVolumeDisplayNode::GetOutputImageDataConnection()
+{
+  return this->AppendComponents->GetOutputPort();
+}
+
 //---------------------------------------------------------------------------
 vtkAlgorithmOutput* vtkMRMLVectorVolumeDisplayNode::GetScalarImageDataConnection()
 {
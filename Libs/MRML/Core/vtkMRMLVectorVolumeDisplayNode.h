@@ -100,6 +100,9 @@ class VTK_MRML_EXPORT vtkMRMLVectorVolumeDisplayNode : public vtkMRMLGlyphableVo
   /// Get the input of the pipeline
   virtual vtkAlgorithmOutput* GetInputImageDataConnection();
 
+  /// Get the output of the pipeline, built from the AppendComponents filter
+  virtual vtkAlgorithmOutput* GetOutputImageDataConnection();
+
   virtual void UpdateImageDataPipeline();
 
   ///
@@ -34,17 +34,25 @@ Version:   $Revision: 1.6 $
 
 // VTK includes
 #include <vtkCallbackCommand.h>
+#include <vtkCriticalSection.h>
 #include <vtkDataArray.h>
 #include <vtkImageChangeInformation.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkMultiThreader.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
 #include <vtkSmartPointer.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkStringArray.h>
+#include <vtkTimerLog.h>
 #include <vtksys/Directory.hxx>
 
 // STD includes
 #include <algorithm>
+#include <cstring>
 #include <iterator>
+#include <utility>
 
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLVolumeArchetypeStorageNode);
@@ -55,6 +63,8 @@ vtkMRMLVolumeArchetypeStorageNode::vtkMRMLVolumeArchetypeStorageNode()
   this->CenterImage = 0;
   this->SingleFile  = 0;
   this->UseOrientationFromFile = 1;
+  this->StreamingRead = 0;
+  this->StreamingUpdateInterval = 0.25;
   this->DefaultWriteFileExtension = "nrrd";
 }
 
@@ -131,6 +141,8 @@ void vtkMRMLVolumeArchetypeStorageNode::Copy(vtkMRMLNode *anode)
   this->SetCenterImage(node->CenterImage);
   this->SetSingleFile(node->SingleFile);
   this->SetUseOrientationFromFile(node->UseOrientationFromFile);
+  this->SetStreamingRead(node->StreamingRead);
+  this->SetStreamingUpdateInterval(node->StreamingUpdateInterval);
 
   this->EndModify(disabledModify);
 }
@@ -142,6 +154,8 @@ void vtkMRMLVolumeArchetypeStorageNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "CenterImage:   " << this->CenterImage << "\n";
   os << indent << "SingleFile:   " << this->SingleFile << "\n";
   os << indent << "UseOrientationFromFile:   " << this->UseOrientationFromFile << "\n";
+  os << indent << "StreamingRead:   " << this->StreamingRead << "\n";
+  os << indent << "StreamingUpdateInterval:   " << this->StreamingUpdateInterval << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -254,8 +268,119 @@ void ApplyImageSeriesReaderWorkaround(vtkMRMLVolumeArchetypeStorageNode * storag
       }
     }
 }
+
+/// Serializes the creation of the readers made by PrefetchData().
+vtkSimpleCriticalSection PrefetchReaderInformationLock;
+
 } // end of anonymous namespace
 
+//----------------------------------------------------------------------------
+vtkITKArchetypeImageSeriesReader* vtkMRMLVolumeArchetypeStorageNode
+::InstantiateReader(vtkMRMLNode *refNode, const std::string& fullName)
+{
+  vtkSmartPointer<vtkITKArchetypeImageSeriesReader> reader;
+
+  if (refNode->IsA("vtkMRMLVectorVolumeNode"))
+    {
+    reader.TakeReference(this->InstantiateVectorVolumeReader(fullName));
+    }
+  else if (refNode->IsA("vtkMRMLDiffusionTensorVolumeNode"))
+    {
+    reader = vtkSmartPointer<vtkITKArchetypeDiffusionTensorImageReaderFile>::New();
+    reader->SetSingleFile( this->GetSingleFile() );
+    reader->SetUseOrientationFromFile( this->GetUseOrientationFromFile() );
+    }
+  else
+    {
+    reader = vtkSmartPointer<vtkITKArchetypeImageSeriesScalarReader>::New();
+    reader->SetSingleFile( this->GetSingleFile() );
+    reader->SetUseOrientationFromFile( this->GetUseOrientationFromFile() );
+    }
+
+  if (reader.GetPointer() == NULL)
+    {
+    return NULL;
+    }
+
+  // Set the list of file names on the reader
+  reader->ResetFileNames();
+  reader->SetArchetype(fullName.c_str());
+
+  // Workaround
+  ApplyImageSeriesReaderWorkaround(this, reader, fullName);
+
+  // Center image
+  reader->SetOutputScalarTypeToNative();
+  reader->SetDesiredCoordinateOrientationToNative();
+  if (this->CenterImage)
+    {
+    reader->SetUseNativeOriginOff();
+    }
+  else
+    {
+    reader->SetUseNativeOriginOn();
+    }
+
+  reader->Register(0);
+  return reader;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeArchetypeStorageNode::PrefetchData(vtkMRMLNode *refNode)
+{
+  this->ClearPrefetchedData();
+
+  std::string fullName = this->GetFullNameFromFileName();
+  if (refNode == NULL || fullName.empty() ||
+      !vtksys::SystemTools::FileExists(fullName.c_str(), true) ||
+      !this->CanReadInReferenceNode(refNode))
+    {
+    return false;
+    }
+
+  // Creating the ITK image IO goes through the ITK object factories,
+  // only the bulk read is done concurrently.
+  vtkSmartPointer<vtkITKArchetypeImageSeriesReader> reader;
+  PrefetchReaderInformationLock.Lock();
+  try
+    {
+    reader.TakeReference(this->InstantiateReader(refNode, fullName));
+    if (reader.GetPointer() != NULL)
+      {
+      reader->UpdateInformation();
+      }
+    }
+  catch (...)
+    {
+    reader = NULL;
+    }
+  PrefetchReaderInformationLock.Unlock();
+  if (reader.GetPointer() == NULL)
+    {
+    return false;
+    }
+
+  try
+    {
+    reader->Update();
+    }
+  catch (...)
+    {
+    // ReadData() reads the file again and reports the error.
+    return false;
+    }
+  this->PrefetchedReader = reader;
+  this->PrefetchedFileName = fullName;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeArchetypeStorageNode::ClearPrefetchedData()
+{
+  this->PrefetchedReader = NULL;
+  this->PrefetchedFileName.clear();
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 {
@@ -292,23 +417,18 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     }
 
   vtkSmartPointer<vtkITKArchetypeImageSeriesReader> reader;
-
-  if (refNode->IsA("vtkMRMLVectorVolumeNode"))
+  bool prefetched = (this->PrefetchedReader.GetPointer() != NULL &&
+                     this->PrefetchedFileName == fullName);
+  if (prefetched)
     {
-    reader.TakeReference(this->InstantiateVectorVolumeReader(fullName));
-    }
-  else if (refNode->IsA("vtkMRMLDiffusionTensorVolumeNode"))
-    {
-    reader = vtkSmartPointer<vtkITKArchetypeDiffusionTensorImageReaderFile>::New();
-    reader->SetSingleFile( this->GetSingleFile() );
-    reader->SetUseOrientationFromFile( this->GetUseOrientationFromFile() );
+    // the file was already read by PrefetchData(), Update() is a no-op.
+    reader = this->PrefetchedReader;
     }
   else
     {
-    reader = vtkSmartPointer<vtkITKArchetypeImageSeriesScalarReader>::New();
-    reader->SetSingleFile( this->GetSingleFile() );
-    reader->SetUseOrientationFromFile( this->GetUseOrientationFromFile() );
+    reader.TakeReference(this->InstantiateReader(refNode, fullName));
     }
+  this->ClearPrefetchedData();
 
   if (reader.GetPointer() == NULL)
     {
@@ -323,81 +443,71 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     volNode->SetAndObserveImageData(NULL);
     }
 
-  // Set the list of file names on the reader
-  reader->ResetFileNames();
-  reader->SetArchetype(fullName.c_str());
-
-  // Workaround
-  ApplyImageSeriesReaderWorkaround(this, reader, fullName);
-
-  // Center image
-  reader->SetOutputScalarTypeToNative();
-  reader->SetDesiredCoordinateOrientationToNative();
-  if (this->CenterImage)
+  bool streamed = false;
+  if (this->StreamingRead && !prefetched)
     {
-    reader->SetUseNativeOriginOff();
-    }
-  else
-    {
-    reader->SetUseNativeOriginOn();
+    streamed = this->ReadDataStreaming(volNode, reader);
     }
 
-  try
-    {
-    vtkDebugMacro("ReadData: right before reader update, reader num files = " << reader->GetNumberOfFileNames());
-    reader->Update();
-    }
-  catch (itk::ExceptionObject& e)
+  if (!streamed)
     {
-    std::string reader0thFileName;
-    if (reader->GetFileName(0) != NULL)
+    try
       {
-      reader0thFileName = std::string("reader 0th file name = ") + std::string(reader->GetFileName(0));
+      vtkDebugMacro("ReadData: right before reader update, reader num files = " << reader->GetNumberOfFileNames());
+      reader->Update();
       }
-    vtkErrorMacro("ReadData: Cannot read file as a volume of type "
-                  << (refNode ? refNode->GetNodeTagName() : "null")
-                  << "[" << "fullName = " << fullName << "]\n"
-                  << "\tNumber of files listed in the node = "
-                  << this->GetNumberOfFileNames() << ".\n"
-                  << "\tFile reader says it was able to read "
-                  << reader->GetNumberOfFileNames() << " files.\n"
-                  << "\tFile reader used the archetype file name of " << reader->GetArchetype()
-                  << " [" << reader0thFileName.c_str() << "]\n"
-                  << "ITK exception info: error in " << e.GetLocation() << "\n"
-                  << e.GetDescription() << "\n");
-    return 0;
-    }
-
-  if (reader->GetOutput() == NULL || reader->GetOutput()->GetPointData() == NULL)
-    {
-    vtkErrorMacro("ReadData: Unable to read data from file: " << fullName);
-    return 0;
-    }
-
-  vtkPointData * pointData = reader->GetOutput()->GetPointData();
-  if (volNode->IsA("vtkMRMLDiffusionTensorVolumeNode"))
-    {
-    if (pointData->GetTensors() == NULL || pointData->GetTensors()->GetNumberOfTuples() == 0)
+    catch (itk::ExceptionObject& e)
       {
-      vtkErrorMacro("ReadData: Unable to read DiffusionTensorVolume data from file: " << fullName );
+      std::string reader0thFileName;
+      if (reader->GetFileName(0) != NULL)
+        {
+        reader0thFileName = std::string("reader 0th file name = ") + std::string(reader->GetFileName(0));
+        }
+      vtkErrorMacro("ReadData: Cannot read file as a volume of type "
+                    << (refNode ? refNode->GetNodeTagName() : "null")
+                    << "[" << "fullName = " << fullName << "]\n"
+                    << "\tNumber of files listed in the node = "
+                    << this->GetNumberOfFileNames() << ".\n"
+                    << "\tFile reader says it was able to read "
+                    << reader->GetNumberOfFileNames() << " files.\n"
+                    << "\tFile reader used the archetype file name of " << reader->GetArchetype()
+                    << " [" << reader0thFileName.c_str() << "]\n"
+                    << "ITK exception info: error in " << e.GetLocation() << "\n"
+                    << e.GetDescription() << "\n");
       return 0;
       }
-    }
-  else
-    {
-    if (pointData->GetScalars() == NULL || pointData->GetScalars()->GetNumberOfTuples() == 0)
+
+    if (reader->GetOutput() == NULL || reader->GetOutput()->GetPointData() == NULL)
       {
-      vtkErrorMacro("ReadData: Unable to read ScalarVolume data from file: " << fullName );
+      vtkErrorMacro("ReadData: Unable to read data from file: " << fullName);
       return 0;
       }
-    }
 
-  if (!volNode->IsA("vtkMRMLVectorVolumeNode")
-      && !volNode->IsA("vtkMRMLDiffusionTensorVolumeNode")
-      && reader->GetNumberOfComponents() != 1)
-    {
-    vtkErrorMacro("ReadData: Not a scalar volume file: " << fullName );
-    return 0;
+    vtkPointData * pointData = reader->GetOutput()->GetPointData();
+    if (volNode->IsA("vtkMRMLDiffusionTensorVolumeNode"))
+      {
+      if (pointData->GetTensors() == NULL || pointData->GetTensors()->GetNumberOfTuples() == 0)
+        {
+        vtkErrorMacro("ReadData: Unable to read DiffusionTensorVolume data from file: " << fullName );
+        return 0;
+        }
+      }
+    else
+      {
+      if (pointData->GetScalars() == NULL || pointData->GetScalars()->GetNumberOfTuples() == 0)
+        {
+        vtkErrorMacro("ReadData: Unable to read ScalarVolume data from file: " << fullName );
+        return 0;
+        }
+      }
+
+    if (!volNode->IsA("vtkMRMLVectorVolumeNode")
+        && !volNode->IsA("vtkMRMLDiffusionTensorVolumeNode")
+        && reader->GetNumberOfComponents() != 1)
+      {
+      vtkErrorMacro("ReadData: Not a scalar volume file: " << fullName );
+      return 0;
+      }
     }
 
   // Set volume attributes
@@ -430,27 +540,31 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
       }
     }
 
-  vtkNew<vtkImageChangeInformation> ici;
-  ici->SetInputConnection(reader->GetOutputPort());
-  ici->SetOutputSpacing( 1, 1, 1 );
-  ici->SetOutputOrigin( 0, 0, 0 );
-  ici->Update();
-
-  if (ici->GetOutput() == NULL)
+  if (!streamed)
     {
-    vtkErrorMacro("vtkMRMLVolumeArchetypeStorageNode: Cannot read file: " << fullName);
-    return 0;
-    }
+    vtkNew<vtkImageChangeInformation> ici;
+    ici->SetInputConnection(reader->GetOutputPort());
+    ici->SetOutputSpacing( 1, 1, 1 );
+    ici->SetOutputOrigin( 0, 0, 0 );
+    ici->Update();
 
-  vtkNew<vtkImageData> iciOutputCopy;
-  iciOutputCopy->ShallowCopy(ici->GetOutput());
-  volNode->SetAndObserveImageData(iciOutputCopy.GetPointer());
+    if (ici->GetOutput() == NULL)
+      {
+      vtkErrorMacro("vtkMRMLVolumeArchetypeStorageNode: Cannot read file: " << fullName);
+      return 0;
+      }
+
+    vtkNew<vtkImageData> iciOutputCopy;
+    iciOutputCopy->ShallowCopy(ici->GetOutput());
+    volNode->SetAndObserveImageData(iciOutputCopy.GetPointer());
+    }
 
   // Log volume size to the application log. It helps to identify potential out-of-memory issues.
+  vtkImageData* imageData = volNode->GetImageData();
   vtkInfoMacro(<<"Loaded volume from file: "<<fullName \
-    <<". Dimensions: "<<iciOutputCopy->GetDimensions()[0]<<"x"<<iciOutputCopy->GetDimensions()[1]<<"x"<<iciOutputCopy->GetDimensions()[2] \
-    <<". Number of components: "<<iciOutputCopy->GetNumberOfScalarComponents() \
-    <<". Pixel type: "<<vtkImageScalarTypeNameMacro(iciOutputCopy->GetScalarType())<<".");
+    <<". Dimensions: "<<imageData->GetDimensions()[0]<<"x"<<imageData->GetDimensions()[1]<<"x"<<imageData->GetDimensions()[2] \
+    <<". Number of components: "<<imageData->GetNumberOfScalarComponents() \
+    <<". Pixel type: "<<vtkImageScalarTypeNameMacro(imageData->GetScalarType())<<".");
 
   vtkMatrix4x4* mat = reader->GetRasToIjkMatrix();
   if ( mat == NULL )
@@ -468,6 +582,95 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
   return 1;
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeArchetypeStorageNode::ReadDataStreaming(vtkMRMLVolumeNode *volNode,
+                                                          vtkITKArchetypeImageSeriesReader *reader)
+{
+  vtkITKArchetypeImageSeriesScalarReader* scalarReader =
+    vtkITKArchetypeImageSeriesScalarReader::SafeDownCast(reader);
+  if (scalarReader == NULL || volNode->IsA("vtkMRMLVectorVolumeNode")
+      || volNode->IsA("vtkMRMLDiffusionTensorVolumeNode"))
+    {
+    return false;
+    }
+  try
+    {
+    scalarReader->UpdateInformation();
+    }
+  catch (itk::ExceptionObject&)
+    {
+    // the error is reported when the whole volume is read
+    return false;
+    }
+
+  int extent[6] = {0, -1, 0, -1, 0, -1};
+  scalarReader->GetOutputInformation(0)->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent);
+  int numberOfSlices = static_cast<int>(scalarReader->GetNumberOfFileNames());
+  if (numberOfSlices < 2 || scalarReader->GetNumberOfComponents() != 1
+      || extent[5] - extent[4] + 1 != numberOfSlices
+      || extent[1] < extent[0] || extent[3] < extent[2])
+    {
+    return false;
+    }
+
+  // Same geometry as the image data read by ReadDataInternal(), the slices
+  // that are not decoded yet are black.
+  vtkNew<vtkImageData> imageData;
+  imageData->SetExtent(extent);
+  imageData->AllocateScalars(scalarReader->GetOutputScalarType(), 1);
+  memset(imageData->GetScalarPointer(), 0,
+         static_cast<size_t>(imageData->GetNumberOfPoints()) * imageData->GetScalarSize());
+  volNode->SetRASToIJKMatrix(scalarReader->GetRasToIjkMatrix());
+  volNode->SetAndObserveImageData(imageData.GetPointer());
+
+  // Decode the central slices first, then alternate above and below.
+  int blockSize = std::max(1, vtkMultiThreader::GetGlobalDefaultNumberOfThreads());
+  std::vector<std::pair<int, int> > blocks;
+  int below = std::max(0, numberOfSlices / 2 - blockSize / 2);
+  int above = std::min(numberOfSlices, below + blockSize);
+  blocks.push_back(std::make_pair(below, above - 1));
+  --below;
+  while (above < numberOfSlices || below >= 0)
+    {
+    if (above < numberOfSlices)
+      {
+      int last = std::min(numberOfSlices, above + blockSize) - 1;
+      blocks.push_back(std::make_pair(above, last));
+      above = last + 1;
+      }
+    if (below >= 0)
+      {
+      int first = std::max(0, below - blockSize + 1);
+      blocks.push_back(std::make_pair(first, below));
+      below = first - 1;
+      }
+    }
+
+  int numberOfDecodedSlices = 0;
+  double lastUpdateTime = vtkTimerLog::GetUniversalTime();
+  for (std::vector<std::pair<int, int> >::const_iterator block = blocks.begin();
+       block != blocks.end(); ++block)
+    {
+    if (!scalarReader->ReadSlices(imageData.GetPointer(), block->first, block->second))
+      {
+      vtkDebugMacro("ReadDataStreaming: slices " << block->first << "-" << block->second
+                    << " cannot be decoded directly, reading the whole volume");
+      return false;
+      }
+    numberOfDecodedSlices += block->second - block->first + 1;
+    double currentTime = vtkTimerLog::GetUniversalTime();
+    if (currentTime - lastUpdateTime >= this->StreamingUpdateInterval)
+      {
+      lastUpdateTime = currentTime;
+      imageData->Modified();
+      double progress = static_cast<double>(numberOfDecodedSlices) / numberOfSlices;
+      this->InvokeEvent(vtkCommand::ProgressEvent, &progress);
+      }
+    }
+  imageData->Modified();
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLVolumeArchetypeStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
 {
@@ -17,8 +17,12 @@
 
 #include "vtkMRMLStorageNode.h"
 
+// VTK includes
+#include <vtkSmartPointer.h>
+
 class vtkImageData;
 class vtkITKArchetypeImageSeriesReader;
+class vtkMRMLVolumeNode;
 
 /// \brief MRML node for representing a volume storage.
 ///
@@ -72,6 +76,22 @@ public:
   vtkSetMacro(UseOrientationFromFile, int);
   vtkGetMacro(UseOrientationFromFile, int);
 
+  ///
+  /// Whether to read series of scalar slices in streaming mode: the image
+  /// data is set in the volume node as soon as the header is read, and it
+  /// is filled in from the central slice outwards. The image data is
+  /// modified at most every StreamingUpdateInterval seconds so that views
+  /// can show the slices already decoded. Off by default.
+  vtkSetMacro(StreamingRead, int);
+  vtkGetMacro(StreamingRead, int);
+  vtkBooleanMacro(StreamingRead, int);
+
+  ///
+  /// Minimum time in seconds between two modifications of the image data
+  /// while it is read in streaming mode. Default is 0.25s.
+  vtkSetMacro(StreamingUpdateInterval, double);
+  vtkGetMacro(StreamingUpdateInterval, double);
+
   /// Return true if the reference node is supported by the storage node
   virtual bool CanReadInReferenceNode(vtkMRMLNode* refNode);
   virtual bool CanWriteFromReferenceNode(vtkMRMLNode* refNode);
@@ -82,6 +102,13 @@ public:
   /// instance to turn off compression.
   virtual void ConfigureForDataExchange();
 
+  ///
+  /// Read the file with a reader that is not connected to the
+  /// reference node. The next ReadData() of the same file reuses it.
+  /// \sa vtkMRMLStorageNode::PrefetchData()
+  virtual bool PrefetchData(vtkMRMLNode *refNode);
+  virtual void ClearPrefetchedData();
+
 protected:
   vtkMRMLVolumeArchetypeStorageNode();
   ~vtkMRMLVolumeArchetypeStorageNode();
@@ -93,15 +120,33 @@ protected:
 
   vtkITKArchetypeImageSeriesReader* InstantiateVectorVolumeReader(const std::string &fullName);
 
+  /// Create a reader suitable for \a refNode and configured from the
+  /// storage node properties to read \a fullName.
+  /// The caller takes the ownership of the returned reader.
+  vtkITKArchetypeImageSeriesReader* InstantiateReader(vtkMRMLNode *refNode,
+                                                      const std::string &fullName);
+
   /// Read data and set it in the referenced node
   virtual int ReadDataInternal(vtkMRMLNode *refNode);
 
+  /// Set an image allocated from the output information of the reader in
+  /// \a volNode and decode the slices into it. Returns false if the file
+  /// cannot be read in streaming mode, the whole volume must be read then.
+  /// \sa StreamingRead
+  bool ReadDataStreaming(vtkMRMLVolumeNode *volNode,
+                         vtkITKArchetypeImageSeriesReader *reader);
+
   /// Write data from a referenced node
   virtual int WriteDataInternal(vtkMRMLNode *refNode);
 
   int CenterImage;
   int SingleFile;
   int UseOrientationFromFile;
+  int StreamingRead;
+  double StreamingUpdateInterval;
+
+  vtkSmartPointer<vtkITKArchetypeImageSeriesReader> PrefetchedReader;
+  std::string PrefetchedFileName;
 
 };
 
@@ -18,12 +18,16 @@ Version:   $Revision: 1.14 $
 #include "vtkMRMLVolumeNode.h"
 #include "vtkMRMLTransformNode.h"
 
+// SegmentationCore includes
+#include "vtkOrientedImageDataResample.h"
+
 // VTK includes
 #include <vtkAlgorithmOutput.h>
 #include <vtkAppendPolyData.h>
 #include <vtkCallbackCommand.h>
 #include <vtkEventForwarderCommand.h>
 #include <vtkGeneralTransform.h>
+#include <vtkGridTransform.h>
 #include <vtkHomogeneousTransform.h>
 #include <vtkImageData.h>
 #include <vtkImageDataGeometryFilter.h>
@@ -738,6 +742,28 @@ void vtkMRMLVolumeNode::SetAndObserveImageData(vtkImageData *imageData)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeNode::ReplaceImageData(vtkImageData *imageData)
+{
+  vtkTrivialProducer* producer = vtkTrivialProducer::SafeDownCast(
+    this->GetImageDataConnection() ? this->GetImageDataConnection()->GetProducer() : 0);
+  vtkDataObject* oldImageData = producer ? producer->GetOutputDataObject(0) : 0;
+  if (!imageData || !oldImageData || !this->DataEventForwarder)
+    {
+    this->SetAndObserveImageData(imageData);
+    return;
+    }
+  if (oldImageData == imageData)
+    {
+    return;
+    }
+  oldImageData->RemoveObservers(vtkCommand::ModifiedEvent, this->DataEventForwarder);
+  imageData->AddObserver(vtkCommand::ModifiedEvent, this->DataEventForwarder);
+  this->StorableModifiedTime.Modified();
+  // Modifies the producer: ImageDataModifiedEvent is invoked by ProcessMRMLEvents
+  producer->SetOutput(imageData);
+}
+
 //---------------------------------------------------------------------------
 vtkImageData* vtkMRMLVolumeNode::GetImageData()
 {
@@ -1134,7 +1160,35 @@ void vtkMRMLVolumeNode::ApplyNonLinearTransform(vtkAbstractTransform* transform)
     }
   else
     {
-    reslice->SetResliceTransform(resampleXform.GetPointer());
+    // Evaluating the non-linear transform (and its inverse) at each voxel of a large volume
+    // is very slow, therefore evaluate it at a coarse grid and interpolate between the grid points.
+    // The grid is defined in voxel coordinates, which is only valid if the image data has unit spacing
+    // and zero origin (as it is normally the case for images stored in volume nodes).
+    const double minimumNumberOfVoxelsForGridApproximation = 1.0e6;
+    const int gridSpacingVoxels = 4;
+    double numberOfVoxels = double(extent[1] - extent[0] + 1)
+      * double(extent[3] - extent[2] + 1) * double(extent[5] - extent[4] + 1);
+    double* imageDataOrigin = this->GetImageData()->GetOrigin();
+    double* imageDataSpacing = this->GetImageData()->GetSpacing();
+    bool voxelCoordinates = true;
+    for (int i = 0; i < 3; i++)
+      {
+      if (imageDataOrigin[i] != 0.0 || imageDataSpacing[i] != 1.0)
+        {
+        voxelCoordinates = false;
+        }
+      }
+    vtkNew<vtkGridTransform> approximateResampleXform;
+    if (voxelCoordinates && numberOfVoxels >= minimumNumberOfVoxelsForGridApproximation
+      && vtkOrientedImageDataResample::ApproximateTransformWithGrid(resampleXform.GetPointer(), extent,
+        gridSpacingVoxels, approximateResampleXform.GetPointer()))
+      {
+      reslice->SetResliceTransform(approximateResampleXform.GetPointer());
+      }
+    else
+      {
+      reslice->SetResliceTransform(resampleXform.GetPointer());
+      }
     }
 
   reslice->SetInputConnection(this->ImageDataConnection);
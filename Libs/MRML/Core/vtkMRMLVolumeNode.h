@@ -172,6 +172,19 @@ public:
   /// \sa GetImageData(), SetImageDataConnection()
   void SetAndObserveImageData(vtkImageData *ImageData);
   virtual vtkImageData* GetImageData();
+  /// Replace the image data and keep the image data connection.
+  /// Unlike SetAndObserveImageData(), the display nodes and the pipelines
+  /// connected to the volume (slice reslicing, volume rendering) are not
+  /// reconnected, they just re-execute with the new image. Only
+  /// ImageDataModifiedEvent is invoked. This is meant for switching the
+  /// frames of a time sequence or of a live stream, where the images have
+  /// the same geometry.
+  /// The image data is set on the current trivial producer, so nodes that
+  /// share the image data connection (e.g. copies) get the new image too.
+  /// Falls back to SetAndObserveImageData() if the image data does not come
+  /// from SetAndObserveImageData().
+  /// \sa SetAndObserveImageData()
+  void ReplaceImageData(vtkImageData *imageData);
   /// Set and observe image data pipeline.
   /// It is propagated to the display nodes.
   /// \sa GetImageDataConnection()
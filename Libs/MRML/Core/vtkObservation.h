@@ -90,6 +90,14 @@ class VTK_MRML_EXPORT vtkObservation : public vtkObject
   vtkGetMacro (TotalElapsedTime, double);
   vtkSetMacro (TotalElapsedTime, double);
 
+  /// Description
+  /// Number of invocations and deepest event nesting level the observation
+  /// was invoked at (1 if it was only invoked from outside of any observation)
+  vtkGetMacro (InvocationCount, unsigned long);
+  vtkSetMacro (InvocationCount, unsigned long);
+  vtkGetMacro (MaximumNestingLevel, int);
+  vtkSetMacro (MaximumNestingLevel, int);
+
   struct CallType
   {
     inline CallType(unsigned long eventID, void* callData);
@@ -159,6 +167,8 @@ protected:
 
   double LastElapsedTime;
   double TotalElapsedTime;
+  unsigned long InvocationCount;
+  int MaximumNestingLevel;
 
 };
 
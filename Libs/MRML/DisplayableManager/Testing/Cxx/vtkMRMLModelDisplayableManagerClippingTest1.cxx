@@ -0,0 +1,158 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLDisplayableManager includes
+#include <vtkMRMLDisplayableManagerGroup.h>
+#include <vtkMRMLModelDisplayableManager.h>
+
+// MRMLLogic includes
+#include <vtkMRMLApplicationLogic.h>
+
+// MRML includes
+#include <vtkMRMLClipModelsNode.h>
+#include <vtkMRMLCoreTestingMacros.h>
+#include <vtkMRMLModelDisplayNode.h>
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSliceNode.h>
+#include <vtkMRMLViewNode.h>
+
+// VTK includes
+#include <vtkActor.h>
+#include <vtkAlgorithm.h>
+#include <vtkMapper.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPlaneCollection.h>
+#include <vtkPropCollection.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkSphereSource.h>
+
+namespace
+{
+//----------------------------------------------------------------------------
+vtkMapper* GetModelMapper(vtkRenderer* renderer)
+{
+  vtkPropCollection* props = renderer->GetViewProps();
+  props->InitTraversal();
+  for (vtkProp* prop = props->GetNextProp(); prop; prop = props->GetNextProp())
+    {
+    vtkActor* actor = vtkActor::SafeDownCast(prop);
+    if (actor)
+      {
+      return actor->GetMapper();
+      }
+    }
+  return 0;
+}
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLModelDisplayableManagerClippingTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkRenderWindow> renderWindow;
+  vtkNew<vtkRenderWindowInteractor> renderWindowInteractor;
+  renderWindow->AddRenderer(renderer.GetPointer());
+  renderWindow->SetInteractor(renderWindowInteractor.GetPointer());
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLApplicationLogic> applicationLogic;
+  applicationLogic->SetMRMLScene(scene.GetPointer());
+
+  vtkNew<vtkMRMLViewNode> viewNode;
+  scene->AddNode(viewNode.GetPointer());
+
+  // Models are clipped by the slice planes of the Red, Green and Yellow views
+  vtkNew<vtkMRMLSliceNode> redSliceNode;
+  redSliceNode->SetLayoutName("Red");
+  scene->AddNode(redSliceNode.GetPointer());
+  vtkNew<vtkMRMLSliceNode> greenSliceNode;
+  greenSliceNode->SetLayoutName("Green");
+  scene->AddNode(greenSliceNode.GetPointer());
+  vtkNew<vtkMRMLSliceNode> yellowSliceNode;
+  yellowSliceNode->SetLayoutName("Yellow");
+  scene->AddNode(yellowSliceNode.GetPointer());
+  vtkNew<vtkMRMLClipModelsNode> clipModelsNode;
+  scene->AddNode(clipModelsNode.GetPointer());
+
+  vtkNew<vtkMRMLDisplayableManagerGroup> displayableManagerGroup;
+  displayableManagerGroup->SetRenderer(renderer.GetPointer());
+  displayableManagerGroup->SetMRMLDisplayableNode(viewNode.GetPointer());
+
+  vtkNew<vtkMRMLModelDisplayableManager> modelDisplayableManager;
+  modelDisplayableManager->SetMRMLApplicationLogic(applicationLogic.GetPointer());
+  displayableManagerGroup->AddDisplayableManager(modelDisplayableManager.GetPointer());
+  displayableManagerGroup->GetInteractor()->Initialize();
+
+  vtkNew<vtkSphereSource> sphereSource;
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelNode->SetPolyDataConnection(sphereSource->GetOutputPort());
+  scene->AddNode(modelNode.GetPointer());
+  vtkNew<vtkMRMLModelDisplayNode> modelDisplayNode;
+  modelDisplayNode->SetClipping(1);
+  scene->AddNode(modelDisplayNode.GetPointer());
+  modelNode->SetAndObserveDisplayNodeID(modelDisplayNode->GetID());
+
+  vtkMapper* mapper = GetModelMapper(renderer.GetPointer());
+  CHECK_NOT_NULL(mapper);
+  CHECK_NULL(mapper->GetClippingPlanes());
+
+  // A single clipping plane is handled by the mapper
+  clipModelsNode->SetRedSliceClipState(vtkMRMLClipModelsNode::ClipPositiveSpace);
+  mapper = GetModelMapper(renderer.GetPointer());
+  CHECK_NOT_NULL(mapper);
+  CHECK_NOT_NULL(mapper->GetClippingPlanes());
+  CHECK_INT(mapper->GetClippingPlanes()->GetNumberOfItems(), 1);
+  CHECK_BOOL(mapper->GetInputAlgorithm()->IsA("vtkClipPolyData") != 0, false);
+
+  // Moving the slice does not rebuild the mapper
+  redSliceNode->GetSliceToRAS()->SetElement(2, 3, 5.);
+  redSliceNode->UpdateMatrices();
+  if (GetModelMapper(renderer.GetPointer()) != mapper)
+    {
+    std::cerr << "Line " << __LINE__ << " - Mapper was recreated" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The union of the kept half spaces requires a clipping filter
+  clipModelsNode->SetGreenSliceClipState(vtkMRMLClipModelsNode::ClipNegativeSpace);
+  mapper = GetModelMapper(renderer.GetPointer());
+  CHECK_NOT_NULL(mapper);
+  CHECK_NULL(mapper->GetClippingPlanes());
+  CHECK_BOOL(mapper->GetInputAlgorithm()->IsA("vtkClipPolyData") != 0, true);
+
+  // Intersection of the kept half spaces is handled by the mapper
+  clipModelsNode->SetRedSliceClipState(vtkMRMLClipModelsNode::ClipOff);
+  clipModelsNode->SetGreenSliceClipState(vtkMRMLClipModelsNode::ClipOff);
+  clipModelsNode->SetClipType(vtkMRMLClipModelsNode::ClipUnion);
+  clipModelsNode->SetRedSliceClipState(vtkMRMLClipModelsNode::ClipPositiveSpace);
+  clipModelsNode->SetYellowSliceClipState(vtkMRMLClipModelsNode::ClipPositiveSpace);
+  mapper = GetModelMapper(renderer.GetPointer());
+  CHECK_NOT_NULL(mapper);
+  CHECK_NOT_NULL(mapper->GetClippingPlanes());
+  CHECK_INT(mapper->GetClippingPlanes()->GetNumberOfItems(), 2);
+
+  // No clipping
+  clipModelsNode->SetRedSliceClipState(vtkMRMLClipModelsNode::ClipOff);
+  clipModelsNode->SetYellowSliceClipState(vtkMRMLClipModelsNode::ClipOff);
+  mapper = GetModelMapper(renderer.GetPointer());
+  CHECK_NOT_NULL(mapper);
+  CHECK_NULL(mapper->GetClippingPlanes());
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,455 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLDisplayableManager includes
+#include <vtkMRMLViewSnapshotRenderer.h>
+
+// MRMLLogic includes
+#include <vtkMRMLSliceLogic.h>
+
+// MRML includes
+#include <vtkMRMLColorTableNode.h>
+#include <vtkMRMLLabelMapVolumeDisplayNode.h>
+#include <vtkMRMLLabelMapVolumeNode.h>
+#include <vtkMRMLModelDisplayNode.h>
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLScalarVolumeDisplayNode.h>
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSliceCompositeNode.h>
+#include <vtkMRMLSliceNode.h>
+
+// SegmentationCore includes
+#include <vtkBinaryLabelmapToClosedSurfaceConversionRule.h>
+#include <vtkOrientedImageData.h>
+#include <vtkSegment.h>
+#include <vtkSegmentation.h>
+#include <vtkSegmentationConverter.h>
+#include <vtkSegmentationConverterFactory.h>
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Measures the frame times of slice views on synthetic data.
+//
+// Usage: vtkMRMLSliceViewPerformanceTest1 [-v numberOfViews] [-s volumeSize]
+//          [-t short|uchar|float] [-f framesPerSequence] [-o results.json]
+//
+// A scalar volume, a labelmap and the closed surfaces of a segmentation
+// are generated and shown in offscreen slice views. Pan, zoom, scroll and
+// window/level sequences are played in each view and the 50th, 95th and
+// 99th percentiles of the frame times are reported in seconds.
+//
+// The sequences are played once with the reslicing pipeline only, once
+// per slice view displayable manager and once with all of them, so that
+// the cost of each displayable manager can be compared with the pipeline.
+
+namespace
+{
+
+typedef std::vector<std::pair<std::string, double> > BenchmarkResultsType;
+
+// Displayable managers instantiated by qMRMLSliceView
+const char* SliceViewDisplayableManagers[] = {
+  "vtkMRMLVolumeGlyphSliceDisplayableManager",
+  "vtkMRMLModelSliceDisplayableManager",
+  "vtkMRMLCrosshairDisplayableManager",
+  "vtkMRMLOrientationMarkerDisplayableManager",
+  "vtkMRMLRulerDisplayableManager",
+  0
+};
+
+const char* SliceOrientations[] = { "Axial", "Sagittal", "Coronal" };
+
+const int VIEW_SIZE = 512;
+
+//-----------------------------------------------------------------------------
+// Fill the image with spheres of increasing values centered on a grid,
+// over a smooth ramp if \a background is true.
+void fillSyntheticImage(vtkImageData* image, int numberOfSpheres, bool background)
+{
+  int dimensions[3] = { 0, 0, 0 };
+  image->GetDimensions(dimensions);
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  double radius = dimensions[0] / (2. * numberOfSpheres);
+  vtkIdType voxelIndex = 0;
+  for (int k = 0; k < dimensions[2]; ++k)
+    {
+    for (int j = 0; j < dimensions[1]; ++j)
+      {
+      for (int i = 0; i < dimensions[0]; ++i, ++voxelIndex)
+        {
+        int sphereIndex = static_cast<int>(i / (2. * radius));
+        double dx = i - (2 * sphereIndex + 1) * radius;
+        double dy = j - dimensions[1] / 2.;
+        double dz = k - dimensions[2] / 2.;
+        bool inside = (dx * dx + dy * dy + dz * dz <= radius * radius);
+        double value = (background ? (i + j + k) % 50 : 0);
+        if (inside)
+          {
+          value = (background ? 50 * (sphereIndex + 2) : sphereIndex + 1);
+          }
+        scalars->SetTuple1(voxelIndex, value);
+        }
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+vtkMRMLScalarVolumeNode* addSyntheticVolume(vtkMRMLScene* scene, int size, int scalarType)
+{
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(size, size, size);
+  imageData->AllocateScalars(scalarType, 1);
+  fillSyntheticImage(imageData.GetPointer(), 4, true);
+
+  vtkNew<vtkMRMLColorTableNode> colorNode;
+  colorNode->SetTypeToGrey();
+  scene->AddNode(colorNode.GetPointer());
+  vtkNew<vtkMRMLScalarVolumeDisplayNode> displayNode;
+  displayNode->SetAutoWindowLevel(false);
+  displayNode->SetWindowLevel(300., 150.);
+  scene->AddNode(displayNode.GetPointer());
+  displayNode->SetAndObserveColorNodeID(colorNode->GetID());
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetName("SyntheticVolume");
+  volumeNode->SetOrigin(-size / 2., -size / 2., -size / 2.);
+  volumeNode->SetAndObserveImageData(imageData.GetPointer());
+  scene->AddNode(volumeNode.GetPointer());
+  volumeNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+  return volumeNode.GetPointer();
+}
+
+//-----------------------------------------------------------------------------
+vtkMRMLLabelMapVolumeNode* addSyntheticLabelmap(vtkMRMLScene* scene, int size)
+{
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(size, size, size);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  fillSyntheticImage(imageData.GetPointer(), 4, false);
+
+  vtkNew<vtkMRMLColorTableNode> colorNode;
+  colorNode->SetTypeToLabels();
+  scene->AddNode(colorNode.GetPointer());
+  vtkNew<vtkMRMLLabelMapVolumeDisplayNode> displayNode;
+  scene->AddNode(displayNode.GetPointer());
+  displayNode->SetAndObserveColorNodeID(colorNode->GetID());
+
+  vtkNew<vtkMRMLLabelMapVolumeNode> labelmapNode;
+  labelmapNode->SetName("SyntheticLabelmap");
+  labelmapNode->SetOrigin(-size / 2., -size / 2., -size / 2.);
+  labelmapNode->SetAndObserveImageData(imageData.GetPointer());
+  scene->AddNode(labelmapNode.GetPointer());
+  labelmapNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+  return labelmapNode.GetPointer();
+}
+
+//-----------------------------------------------------------------------------
+// Segments are shown in slice views by the Segmentations module, which the
+// displayable managers of the library cannot depend on. The closed surfaces
+// of the segments are shown as model slice intersections instead.
+void addSyntheticSegmentation(vtkMRMLScene* scene, int size, int numberOfSegments)
+{
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkBinaryLabelmapToClosedSurfaceConversionRule>::New());
+
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetMasterRepresentationName(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName());
+  for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+    {
+    vtkNew<vtkOrientedImageData> labelmap;
+    labelmap->SetDimensions(size, size, size);
+    labelmap->SetOrigin(-size / 2., -size / 2., -size / 2.);
+    labelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+    fillSyntheticImage(labelmap.GetPointer(), numberOfSegments, false);
+    // Keep only the sphere of the current segment
+    vtkDataArray* scalars = labelmap->GetPointData()->GetScalars();
+    for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+      {
+      scalars->SetTuple1(i, scalars->GetTuple1(i) == segmentIndex + 1 ? 1 : 0);
+      }
+    vtkNew<vtkSegment> segment;
+    segment->AddRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(),
+      labelmap.GetPointer());
+    segmentation->AddSegment(segment.GetPointer());
+    }
+  segmentation->CreateRepresentation(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName());
+
+  std::vector<std::string> segmentIDs;
+  segmentation->GetSegmentIDs(segmentIDs);
+  for (std::vector<std::string>::iterator segmentIdIt = segmentIDs.begin(); segmentIdIt != segmentIDs.end(); ++segmentIdIt)
+    {
+    vtkPolyData* closedSurface = vtkPolyData::SafeDownCast(segmentation->GetSegment(*segmentIdIt)->GetRepresentation(
+      vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName()));
+    vtkNew<vtkMRMLModelDisplayNode> displayNode;
+    displayNode->SetSliceIntersectionVisibility(1);
+    scene->AddNode(displayNode.GetPointer());
+    vtkNew<vtkMRMLModelNode> modelNode;
+    modelNode->SetName(segmentIdIt->c_str());
+    modelNode->SetAndObservePolyData(closedSurface);
+    scene->AddNode(modelNode.GetPointer());
+    modelNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+    }
+}
+
+//-----------------------------------------------------------------------------
+double percentile(std::vector<double> frameTimes, double fraction)
+{
+  if (frameTimes.empty())
+    {
+    return 0.;
+    }
+  std::sort(frameTimes.begin(), frameTimes.end());
+  int index = static_cast<int>(std::ceil(fraction * frameTimes.size())) - 1;
+  index = std::max(0, std::min(index, static_cast<int>(frameTimes.size()) - 1));
+  return frameTimes[index];
+}
+
+//-----------------------------------------------------------------------------
+void addFrameTimes(BenchmarkResultsType& results, const std::string& configuration,
+  const char* sequence, const std::vector<double>& frameTimes)
+{
+  const double fractions[3] = { 0.50, 0.95, 0.99 };
+  const char* suffixes[3] = { "p50", "p95", "p99" };
+  std::cout << configuration << " " << sequence << ":";
+  for (int i = 0; i < 3; ++i)
+    {
+    double value = percentile(frameTimes, fractions[i]);
+    results.push_back(std::make_pair(configuration + "_" + sequence + "_" + suffixes[i], value));
+    std::cout << " " << suffixes[i] << "=" << value << "s";
+    }
+  std::cout << std::endl;
+}
+
+//-----------------------------------------------------------------------------
+double renderFrame(vtkMRMLViewSnapshotRenderer* view, double start)
+{
+  view->Render();
+  return vtkTimerLog::GetUniversalTime() - start;
+}
+
+//-----------------------------------------------------------------------------
+void runSequences(vtkMRMLScene* scene, vtkMRMLScalarVolumeDisplayNode* volumeDisplayNode,
+  vtkStringArray* displayableManagerClassNames, const std::string& configuration,
+  int numberOfViews, int numberOfFrames, BenchmarkResultsType& results)
+{
+  std::vector<vtkSmartPointer<vtkMRMLViewSnapshotRenderer> > views;
+  for (int viewIndex = 0; viewIndex < numberOfViews; ++viewIndex)
+    {
+    std::stringstream ss;
+    ss << "SliceView" << viewIndex;
+    vtkMRMLSliceNode* sliceNode = vtkMRMLSliceNode::SafeDownCast(
+      scene->GetSingletonNode(ss.str().c_str(), "vtkMRMLSliceNode"));
+    vtkSmartPointer<vtkMRMLViewSnapshotRenderer> view = vtkSmartPointer<vtkMRMLViewSnapshotRenderer>::New();
+    view->SetSize(VIEW_SIZE, VIEW_SIZE);
+    view->SetDisplayableManagerClassNames(displayableManagerClassNames);
+    view->SetViewNode(sliceNode);
+    view->GetSliceLogic()->FitSliceToAll(VIEW_SIZE, VIEW_SIZE);
+    // First render builds the pipeline
+    view->Render();
+    views.push_back(view);
+    }
+
+  std::vector<double> panTimes;
+  std::vector<double> zoomTimes;
+  std::vector<double> scrollTimes;
+  std::vector<double> windowLevelTimes;
+  for (int viewIndex = 0; viewIndex < numberOfViews; ++viewIndex)
+    {
+    vtkMRMLViewSnapshotRenderer* view = views[viewIndex];
+    vtkMRMLSliceLogic* sliceLogic = view->GetSliceLogic();
+    vtkMRMLSliceNode* sliceNode = sliceLogic->GetSliceNode();
+
+    for (int frame = 0; frame < numberOfFrames; ++frame)
+      {
+      double start = vtkTimerLog::GetUniversalTime();
+      vtkMatrix4x4* sliceToRAS = sliceNode->GetSliceToRAS();
+      sliceToRAS->SetElement(0, 3, sliceToRAS->GetElement(0, 3) + 1.);
+      sliceToRAS->SetElement(1, 3, sliceToRAS->GetElement(1, 3) + 1.);
+      sliceNode->UpdateMatrices();
+      panTimes.push_back(renderFrame(view, start));
+      }
+
+    double fieldOfView[3] = { 0., 0., 0. };
+    sliceNode->GetFieldOfView(fieldOfView);
+    for (int frame = 0; frame < numberOfFrames; ++frame)
+      {
+      double start = vtkTimerLog::GetUniversalTime();
+      double zoomFactor = 1. - 0.5 * frame / numberOfFrames;
+      sliceNode->SetFieldOfView(fieldOfView[0] * zoomFactor, fieldOfView[1] * zoomFactor, fieldOfView[2]);
+      zoomTimes.push_back(renderFrame(view, start));
+      }
+    sliceLogic->FitSliceToAll(VIEW_SIZE, VIEW_SIZE);
+
+    double offset = sliceLogic->GetSliceOffset();
+    for (int frame = 0; frame < numberOfFrames; ++frame)
+      {
+      double start = vtkTimerLog::GetUniversalTime();
+      sliceLogic->SetSliceOffset(offset + frame - numberOfFrames / 2);
+      scrollTimes.push_back(renderFrame(view, start));
+      }
+    sliceLogic->SetSliceOffset(offset);
+    }
+
+  // Window/level changes are shown in all the views at once
+  for (int frame = 0; frame < numberOfFrames; ++frame)
+    {
+    double start = vtkTimerLog::GetUniversalTime();
+    volumeDisplayNode->SetWindowLevel(300. - 200. * frame / numberOfFrames, 150. + 50. * frame / numberOfFrames);
+    for (int viewIndex = 0; viewIndex < numberOfViews; ++viewIndex)
+      {
+      views[viewIndex]->Render();
+      }
+    windowLevelTimes.push_back(vtkTimerLog::GetUniversalTime() - start);
+    }
+  volumeDisplayNode->SetWindowLevel(300., 150.);
+
+  addFrameTimes(results, configuration, "Pan", panTimes);
+  addFrameTimes(results, configuration, "Zoom", zoomTimes);
+  addFrameTimes(results, configuration, "Scroll", scrollTimes);
+  addFrameTimes(results, configuration, "WindowLevel", windowLevelTimes);
+}
+
+//-----------------------------------------------------------------------------
+bool writeResults(const std::string& fileName, const BenchmarkResultsType& results)
+{
+  std::ofstream output(fileName.c_str());
+  if (!output.is_open())
+    {
+    return false;
+    }
+  output << "{\n  \"benchmarks\": {\n";
+  for (BenchmarkResultsType::const_iterator resultIt = results.begin(); resultIt != results.end(); ++resultIt)
+    {
+    output << "    \"" << resultIt->first << "\": " << resultIt->second
+           << (resultIt + 1 != results.end() ? ",\n" : "\n");
+    }
+  output << "  }\n}\n";
+  return output.good();
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkMRMLSliceViewPerformanceTest1(int argc, char* argv[])
+{
+  int numberOfViews = 3;
+  int volumeSize = 128;
+  int scalarType = VTK_SHORT;
+  int numberOfFrames = 20;
+  std::string resultsFileName;
+  for (int i = 1; i + 1 < argc; i += 2)
+    {
+    std::string option = argv[i];
+    std::string value = argv[i + 1];
+    if (option == "-v")
+      {
+      numberOfViews = std::max(1, atoi(value.c_str()));
+      }
+    else if (option == "-s")
+      {
+      volumeSize = std::max(8, atoi(value.c_str()));
+      }
+    else if (option == "-t" && (value == "short" || value == "uchar" || value == "float"))
+      {
+      scalarType = (value == "short" ? VTK_SHORT : (value == "uchar" ? VTK_UNSIGNED_CHAR : VTK_FLOAT));
+      }
+    else if (option == "-f")
+      {
+      numberOfFrames = std::max(1, atoi(value.c_str()));
+      }
+    else if (option == "-o")
+      {
+      resultsFileName = value;
+      }
+    else
+      {
+      std::cerr << "Usage: " << argv[0] << " [-v numberOfViews] [-s volumeSize]"
+                << " [-t short|uchar|float] [-f framesPerSequence] [-o results.json]" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLSliceNode::AddDefaultSliceOrientationPresets(scene.GetPointer());
+
+  vtkMRMLScalarVolumeNode* volumeNode = addSyntheticVolume(scene.GetPointer(), volumeSize, scalarType);
+  vtkMRMLLabelMapVolumeNode* labelmapNode = addSyntheticLabelmap(scene.GetPointer(), volumeSize);
+  addSyntheticSegmentation(scene.GetPointer(), volumeSize, 3);
+
+  for (int viewIndex = 0; viewIndex < numberOfViews; ++viewIndex)
+    {
+    std::stringstream ss;
+    ss << "SliceView" << viewIndex;
+    vtkNew<vtkMRMLSliceNode> sliceNode;
+    sliceNode->SetLayoutName(ss.str().c_str());
+    sliceNode->SetOrientation(SliceOrientations[viewIndex % 3]);
+    scene->AddNode(sliceNode.GetPointer());
+    vtkNew<vtkMRMLSliceCompositeNode> sliceCompositeNode;
+    sliceCompositeNode->SetLayoutName(ss.str().c_str());
+    sliceCompositeNode->SetBackgroundVolumeID(volumeNode->GetID());
+    sliceCompositeNode->SetLabelVolumeID(labelmapNode->GetID());
+    sliceCompositeNode->SetLabelOpacity(0.5);
+    scene->AddNode(sliceCompositeNode.GetPointer());
+    }
+
+  vtkMRMLScalarVolumeDisplayNode* volumeDisplayNode =
+    vtkMRMLScalarVolumeDisplayNode::SafeDownCast(volumeNode->GetDisplayNode());
+  BenchmarkResultsType results;
+
+  // Reslicing pipeline only
+  vtkNew<vtkStringArray> noDisplayableManagers;
+  runSequences(scene.GetPointer(), volumeDisplayNode, noDisplayableManagers.GetPointer(),
+    "SliceLogic", numberOfViews, numberOfFrames, results);
+
+  // One displayable manager at a time
+  for (const char** displayableManager = SliceViewDisplayableManagers; *displayableManager; ++displayableManager)
+    {
+    vtkNew<vtkStringArray> classNames;
+    classNames->InsertNextValue(*displayableManager);
+    runSequences(scene.GetPointer(), volumeDisplayNode, classNames.GetPointer(),
+      *displayableManager, numberOfViews, numberOfFrames, results);
+    }
+
+  // Same displayable managers as the slice views of the application
+  runSequences(scene.GetPointer(), volumeDisplayNode, 0,
+    "AllDisplayableManagers", numberOfViews, numberOfFrames, results);
+
+  if (!resultsFileName.empty() && !writeResults(resultsFileName, results))
+    {
+    std::cerr << "Failed to write benchmark results to " << resultsFileName << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
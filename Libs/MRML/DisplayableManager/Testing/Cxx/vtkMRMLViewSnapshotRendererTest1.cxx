@@ -0,0 +1,126 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLDisplayableManager includes
+#include <vtkMRMLAbstractDisplayableManager.h>
+#include <vtkMRMLDisplayableManagerGroup.h>
+#include <vtkMRMLViewSnapshotRenderer.h>
+
+// MRMLLogic includes
+#include <vtkMRMLSliceLogic.h>
+
+// MRML includes
+#include <vtkMRMLCoreTestingMacros.h>
+#include <vtkMRMLModelDisplayNode.h>
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSliceCompositeNode.h>
+#include <vtkMRMLSliceNode.h>
+#include <vtkMRMLViewNode.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkRenderWindow.h>
+#include <vtkSphereSource.h>
+
+//----------------------------------------------------------------------------
+int vtkMRMLViewSnapshotRendererTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  vtkNew<vtkMRMLViewNode> viewNode;
+  scene->AddNode(viewNode.GetPointer());
+
+  vtkNew<vtkSphereSource> sphereSource;
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelNode->SetPolyDataConnection(sphereSource->GetOutputPort());
+  scene->AddNode(modelNode.GetPointer());
+  vtkNew<vtkMRMLModelDisplayNode> modelDisplayNode;
+  scene->AddNode(modelDisplayNode.GetPointer());
+  modelNode->SetAndObserveDisplayNodeID(modelDisplayNode->GetID());
+
+  vtkNew<vtkMRMLViewSnapshotRenderer> snapshotRenderer;
+  CHECK_NULL(snapshotRenderer->GetRenderWindow());
+  CHECK_NULL(snapshotRenderer->GetDisplayableManagerGroup());
+
+  // 3D view
+  snapshotRenderer->SetSize(320, 240);
+  snapshotRenderer->SetViewNode(viewNode.GetPointer());
+  CHECK_NOT_NULL(snapshotRenderer->GetRenderWindow());
+  CHECK_INT(snapshotRenderer->GetRenderWindow()->GetOffScreenRendering(), 1);
+  CHECK_NOT_NULL(snapshotRenderer->GetDisplayableManagerGroup());
+  CHECK_NULL(snapshotRenderer->GetSliceLogic());
+  CHECK_NOT_NULL(snapshotRenderer->GetDisplayableManagerGroup()->
+    GetDisplayableManagerByClassName("vtkMRMLModelDisplayableManager"));
+
+  vtkImageData* image = snapshotRenderer->CaptureImage();
+  CHECK_NOT_NULL(image);
+  int dimensions[3] = {0, 0, 0};
+  image->GetDimensions(dimensions);
+  CHECK_INT(dimensions[0], 320);
+  CHECK_INT(dimensions[1], 240);
+
+  // Timing
+  vtkMRMLDisplayableManagerGroup* group = snapshotRenderer->GetDisplayableManagerGroup();
+  vtkMRMLAbstractDisplayableManager* modelDisplayableManager =
+    group->GetDisplayableManagerByClassName("vtkMRMLModelDisplayableManager");
+  CHECK_BOOL(modelDisplayableManager->GetTimingEnabled(), false);
+  group->SetTimingOverlayVisible(true);
+  CHECK_BOOL(group->GetTimingEnabled(), true);
+  CHECK_BOOL(modelDisplayableManager->GetTimingEnabled(), true);
+  group->ResetTimings();
+  modelDisplayNode->SetColor(1., 0., 0.);
+  snapshotRenderer->CaptureImage();
+  CHECK_BOOL(modelDisplayableManager->GetTimingCount(
+    vtkMRMLAbstractDisplayableManager::MRMLNodesEventsTiming) > 0, true);
+  CHECK_INT(group->GetRenderTimingCount(), 1);
+  CHECK_BOOL(group->GetTimingReport().find("vtkMRMLModelDisplayableManager") != std::string::npos, true);
+  group->SetTimingOverlayVisible(false);
+  group->SetTimingEnabled(false);
+  CHECK_BOOL(modelDisplayableManager->GetTimingEnabled(), false);
+
+  // Slice view
+  vtkNew<vtkMRMLSliceNode> sliceNode;
+  sliceNode->SetLayoutName("Red");
+  sliceNode->SetOrientation("Axial");
+  scene->AddNode(sliceNode.GetPointer());
+  vtkNew<vtkMRMLSliceCompositeNode> sliceCompositeNode;
+  sliceCompositeNode->SetLayoutName("Red");
+  scene->AddNode(sliceCompositeNode.GetPointer());
+
+  snapshotRenderer->SetSize(200, 100);
+  snapshotRenderer->SetViewNode(sliceNode.GetPointer());
+  CHECK_NOT_NULL(snapshotRenderer->GetSliceLogic());
+  CHECK_NOT_NULL(snapshotRenderer->GetDisplayableManagerGroup()->
+    GetDisplayableManagerByClassName("vtkMRMLModelSliceDisplayableManager"));
+
+  image = snapshotRenderer->CaptureImage();
+  CHECK_NOT_NULL(image);
+  image->GetDimensions(dimensions);
+  CHECK_INT(dimensions[0], 200);
+  CHECK_INT(dimensions[1], 100);
+  // The slice node is resized to the snapshot
+  CHECK_INT(sliceNode->GetDimensions()[0], 200);
+  CHECK_INT(sliceNode->GetDimensions()[1], 100);
+
+  CHECK_BOOL(snapshotRenderer->WriteImage("snapshot.unknown"), false);
+
+  snapshotRenderer->SetViewNode(0);
+  CHECK_NULL(snapshotRenderer->GetRenderWindow());
+  CHECK_NULL(snapshotRenderer->GetSliceLogic());
+
+  return EXIT_SUCCESS;
+}
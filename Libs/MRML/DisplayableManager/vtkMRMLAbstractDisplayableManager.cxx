@@ -40,6 +40,7 @@
 #include <vtkRenderWindow.h>
 #include <vtkRenderWindowInteractor.h>
 #include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
 #include <vtkWeakPointer.h>
 
 // STD includes
@@ -139,6 +140,32 @@ public:
   std::vector<std::pair<int,float> >        InteractorStyleObservableEvents;
   vtkWeakPointer<vtkMRMLLightBoxRendererManagerProxy> LightBoxRendererManagerProxy;
 
+  /// Time spent in one of the TimingCategory
+  struct TimingStatistics
+    {
+    TimingStatistics() : Count(0), Total(0.), Maximum(0.) {}
+    int Count;
+    double Total;
+    double Maximum;
+    };
+
+  /// Measure the time spent from construction to destruction and add it to
+  /// the statistics of \a category. Nested scopes of a same category are
+  /// ignored so that recursive calls are not counted twice.
+  class TimingScope
+    {
+  public:
+    TimingScope(vtkInternal* internal, int category);
+    ~TimingScope();
+  private:
+    vtkInternal* Internal;
+    int Category;
+    double StartTime;
+    };
+
+  bool                                      TimingEnabled;
+  TimingStatistics                          Timings[TimingCategory_Last];
+  bool                                      TimingActive[TimingCategory_Last];
 };
 
 //----------------------------------------------------------------------------
@@ -190,6 +217,12 @@ vtkMRMLAbstractDisplayableManager::vtkInternal::vtkInternal(
   this->InteractorStyleObservableEvents.push_back(std::make_pair(vtkCommand::MouseWheelForwardEvent,0.0));
   this->InteractorStyleObservableEvents.push_back(std::make_pair(vtkCommand::EnterEvent,0.0));
   this->InteractorStyleObservableEvents.push_back(std::make_pair(vtkCommand::LeaveEvent,0.0));
+
+  this->TimingEnabled = false;
+  for (int category = 0; category < TimingCategory_Last; ++category)
+    {
+    this->TimingActive[category] = false;
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -337,6 +370,35 @@ void vtkMRMLAbstractDisplayableManager::vtkInternal::SetAndObserveInteractorStyl
   this->InteractorStyle = newInteractorStyle;
 }
 
+//----------------------------------------------------------------------------
+vtkMRMLAbstractDisplayableManager::vtkInternal::TimingScope::TimingScope(
+    vtkInternal* internal, int category)
+  : Internal(0), Category(category), StartTime(0.)
+{
+  if (!internal->TimingEnabled || internal->TimingActive[category])
+    {
+    return;
+    }
+  this->Internal = internal;
+  this->Internal->TimingActive[category] = true;
+  this->StartTime = vtkTimerLog::GetUniversalTime();
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLAbstractDisplayableManager::vtkInternal::TimingScope::~TimingScope()
+{
+  if (!this->Internal)
+    {
+    return;
+    }
+  double elapsed = vtkTimerLog::GetUniversalTime() - this->StartTime;
+  this->Internal->TimingActive[this->Category] = false;
+  TimingStatistics& timing = this->Internal->Timings[this->Category];
+  ++timing.Count;
+  timing.Total += elapsed;
+  timing.Maximum = std::max(timing.Maximum, elapsed);
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLAbstractDisplayableManager::vtkInternal::DoInteractorCallback(
     vtkObject* vtk_obj, unsigned long event, void* client_data, void* vtkNotUsed(call_data))
@@ -351,6 +413,7 @@ void vtkMRMLAbstractDisplayableManager::vtkInternal::DoInteractorCallback(
       reinterpret_cast<vtkMRMLAbstractDisplayableManager*>(client_data);
   assert(self);
 
+  TimingScope timing(self->Internal, InteractionEventsTiming);
   self->OnInteractorEvent(event);
 }
 
@@ -368,6 +431,7 @@ void vtkMRMLAbstractDisplayableManager::vtkInternal::DoInteractorStyleCallback(
       reinterpret_cast<vtkMRMLAbstractDisplayableManager*>(client_data);
   assert(self);
 
+  TimingScope timing(self->Internal, InteractionEventsTiming);
   self->OnInteractorStyleEvent(event);
 }
 
@@ -540,11 +604,23 @@ vtkMRMLAbstractDisplayableManager::vtkMRMLAbstractDisplayableManager()
   widgetsObserver->GetCallbackCommand()->SetClientData(this);
   widgetsObserver->GetCallbackCommand()->SetCallback(
     vtkMRMLAbstractDisplayableManager::WidgetsCallback);
+
+  // Relay MRML events through the timing callbacks
+  this->GetMRMLSceneCallbackCommand()->SetCallback(
+    vtkMRMLAbstractDisplayableManager::MRMLSceneTimingCallback);
+  this->GetMRMLNodesCallbackCommand()->SetCallback(
+    vtkMRMLAbstractDisplayableManager::MRMLNodesTimingCallback);
 }
 
 //----------------------------------------------------------------------------
 vtkMRMLAbstractDisplayableManager::~vtkMRMLAbstractDisplayableManager()
 {
+  // The superclass may still receive events once Internal is deleted
+  this->GetMRMLSceneCallbackCommand()->SetCallback(
+    vtkMRMLAbstractLogic::MRMLSceneCallback);
+  this->GetMRMLNodesCallbackCommand()->SetCallback(
+    vtkMRMLAbstractLogic::MRMLNodesCallback);
+
   if (this->Internal->Renderer)
     {
     this->Internal->Renderer->UnRegister(this);
@@ -556,6 +632,118 @@ vtkMRMLAbstractDisplayableManager::~vtkMRMLAbstractDisplayableManager()
 void vtkMRMLAbstractDisplayableManager::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "TimingEnabled: " << this->Internal->TimingEnabled << "\n";
+  if (this->Internal->TimingEnabled)
+    {
+    for (int category = 0; category < TimingCategory_Last; ++category)
+      {
+      os << indent << GetTimingCategoryAsString(category) << ": "
+         << this->GetTimingCount(category) << " calls, "
+         << this->GetTimingTotal(category) << " s total, "
+         << this->GetTimingMaximum(category) << " s max\n";
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLAbstractDisplayableManager::SetTimingEnabled(bool enabled)
+{
+  if (this->Internal->TimingEnabled == enabled)
+    {
+    return;
+    }
+  this->Internal->TimingEnabled = enabled;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLAbstractDisplayableManager::GetTimingEnabled()
+{
+  return this->Internal->TimingEnabled;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLAbstractDisplayableManager::GetTimingCount(int category)
+{
+  if (category < 0 || category >= TimingCategory_Last)
+    {
+    vtkErrorMacro("GetTimingCount: invalid category " << category);
+    return 0;
+    }
+  return this->Internal->Timings[category].Count;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLAbstractDisplayableManager::GetTimingTotal(int category)
+{
+  if (category < 0 || category >= TimingCategory_Last)
+    {
+    vtkErrorMacro("GetTimingTotal: invalid category " << category);
+    return 0.;
+    }
+  return this->Internal->Timings[category].Total;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLAbstractDisplayableManager::GetTimingMaximum(int category)
+{
+  if (category < 0 || category >= TimingCategory_Last)
+    {
+    vtkErrorMacro("GetTimingMaximum: invalid category " << category);
+    return 0.;
+    }
+  return this->Internal->Timings[category].Maximum;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLAbstractDisplayableManager::ResetTimings()
+{
+  for (int category = 0; category < TimingCategory_Last; ++category)
+    {
+    this->Internal->Timings[category] = vtkInternal::TimingStatistics();
+    }
+}
+
+//----------------------------------------------------------------------------
+const char* vtkMRMLAbstractDisplayableManager::GetTimingCategoryAsString(int category)
+{
+  switch (category)
+    {
+    case MRMLNodesEventsTiming: return "MRMLNodesEvents";
+    case MRMLSceneEventsTiming: return "MRMLSceneEvents";
+    case UpdateFromMRMLTiming: return "UpdateFromMRML";
+    case InteractionEventsTiming: return "InteractionEvents";
+    case WidgetsEventsTiming: return "WidgetsEvents";
+    default:
+      break;
+    }
+  return "";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLAbstractDisplayableManager::MRMLSceneTimingCallback(vtkObject *caller,
+                                                                unsigned long eid,
+                                                                void *clientData,
+                                                                void *callData)
+{
+  vtkMRMLAbstractDisplayableManager* self =
+    reinterpret_cast<vtkMRMLAbstractDisplayableManager *>(clientData);
+  assert(self);
+  vtkInternal::TimingScope timing(self->Internal, MRMLSceneEventsTiming);
+  vtkMRMLAbstractLogic::MRMLSceneCallback(caller, eid, clientData, callData);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLAbstractDisplayableManager::MRMLNodesTimingCallback(vtkObject *caller,
+                                                                unsigned long eid,
+                                                                void *clientData,
+                                                                void *callData)
+{
+  vtkMRMLAbstractDisplayableManager* self =
+    reinterpret_cast<vtkMRMLAbstractDisplayableManager *>(clientData);
+  assert(self);
+  vtkInternal::TimingScope timing(self->Internal, MRMLNodesEventsTiming);
+  vtkMRMLAbstractLogic::MRMLNodesCallback(caller, eid, clientData, callData);
 }
 
 //----------------------------------------------------------------------------
@@ -743,6 +931,7 @@ void vtkMRMLAbstractDisplayableManager::WidgetsCallback(vtkObject *caller,
   vtkMRMLAbstractDisplayableManager* self =
     reinterpret_cast<vtkMRMLAbstractDisplayableManager *>(clientData);
   assert(!caller->IsA("vtkMRMLNode"));
+  vtkInternal::TimingScope timing(self->Internal, WidgetsEventsTiming);
   self->ProcessWidgetsEvents(caller, eid, callData);
 }
 
@@ -851,6 +1040,7 @@ void vtkMRMLAbstractDisplayableManager::RequestRender()
 
   if (this->Internal->UpdateFromMRMLRequested)
     {
+    vtkInternal::TimingScope timing(this->Internal, UpdateFromMRMLTiming);
     this->UpdateFromMRML();
     }
 
@@ -90,6 +90,44 @@ public:
   virtual std::string GetDataProbeInfoStringForPosition(
       double vtkNotUsed(xyz)[3]) { return ""; }
 
+  /// Categories of the time spent by the displayable manager.
+  /// \sa SetTimingEnabled(), GetTimingTotal()
+  enum TimingCategory
+    {
+    /// ProcessMRMLNodesEvents() and the OnMRMLDisplayableNode* callbacks
+    MRMLNodesEventsTiming = 0,
+    /// ProcessMRMLSceneEvents() and the OnMRMLScene* callbacks
+    MRMLSceneEventsTiming,
+    /// UpdateFromMRML() called by RequestRender()
+    UpdateFromMRMLTiming,
+    /// OnInteractorEvent() and OnInteractorStyleEvent()
+    InteractionEventsTiming,
+    /// ProcessWidgetsEvents()
+    WidgetsEventsTiming,
+    TimingCategory_Last
+    };
+
+  /// Record the time spent in each TimingCategory.
+  /// Disabled by default: no timer is queried when disabled.
+  /// Times are inclusive: UpdateFromMRML() triggered from a node event is
+  /// counted both as MRMLNodesEventsTiming and UpdateFromMRMLTiming.
+  /// Nested calls of the same category are counted once.
+  /// \sa vtkMRMLDisplayableManagerGroup::SetTimingEnabled()
+  void SetTimingEnabled(bool enabled);
+  bool GetTimingEnabled();
+
+  /// Number of timed calls, accumulated time and longest call in seconds
+  /// for a given TimingCategory since the last ResetTimings().
+  int GetTimingCount(int category);
+  double GetTimingTotal(int category);
+  double GetTimingMaximum(int category);
+
+  /// Clear the recorded times.
+  void ResetTimings();
+
+  /// Human readable name of a TimingCategory.
+  static const char* GetTimingCategoryAsString(int category);
+
 protected:
 
   vtkMRMLAbstractDisplayableManager();
@@ -142,6 +180,14 @@ protected:
   static void WidgetsCallback(vtkObject *caller, unsigned long eid,
                               void *clientData, void *callData);
 
+  /// Relay the MRML scene and node events to the superclass callbacks and
+  /// record the time spent in them if timing is enabled.
+  /// \sa SetTimingEnabled()
+  static void MRMLSceneTimingCallback(vtkObject *caller, unsigned long eid,
+                                      void *clientData, void *callData);
+  static void MRMLNodesTimingCallback(vtkObject *caller, unsigned long eid,
+                                      void *clientData, void *callData);
+
   /// Get vtkWidget callbackCommand
   vtkCallbackCommand * GetWidgetsCallbackCommand();
 
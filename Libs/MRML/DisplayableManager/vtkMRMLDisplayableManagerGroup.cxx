@@ -34,15 +34,20 @@
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkInstantiator.h>
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkRenderer.h>
 #include <vtkRenderWindow.h>
 #include <vtkSmartPointer.h>
+#include <vtkTextActor.h>
+#include <vtkTextProperty.h>
+#include <vtkTimerLog.h>
 #include <vtkWeakPointer.h>
 
 // STD includes
 #include <algorithm>
 #include <cassert>
+#include <sstream>
 #include <vector>
 
 //----------------------------------------------------------------------------
@@ -72,6 +77,15 @@ public:
   vtkMRMLNode*                          MRMLDisplayableNode;
   vtkRenderer*                          Renderer;
   vtkWeakPointer<vtkMRMLLightBoxRendererManagerProxy> LightBoxRendererManagerProxy;
+
+  // Render timing
+  vtkSmartPointer<vtkCallbackCommand>   RendererCallBackCommand;
+  bool                                  TimingEnabled;
+  int                                   RenderCount;
+  double                                RenderTotal;
+  double                                RenderMaximum;
+  double                                RenderStartTime;
+  vtkSmartPointer<vtkTextActor>         TimingOverlayActor;
 };
 
 //----------------------------------------------------------------------------
@@ -85,6 +99,33 @@ vtkMRMLDisplayableManagerGroup::vtkInternal::vtkInternal()
   this->CallBackCommand = vtkSmartPointer<vtkCallbackCommand>::New();
   this->DisplayableManagerFactory = 0;
   this->LightBoxRendererManagerProxy = 0;
+  this->RendererCallBackCommand = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->TimingEnabled = false;
+  this->RenderCount = 0;
+  this->RenderTotal = 0.;
+  this->RenderMaximum = 0.;
+  this->RenderStartTime = -1.;
+}
+
+//----------------------------------------------------------------------------
+namespace
+{
+struct DisplayableManagerTimeGreater
+{
+  bool operator()(vtkMRMLAbstractDisplayableManager* dm1,
+                  vtkMRMLAbstractDisplayableManager* dm2) const
+  {
+    double total1 = 0.;
+    double total2 = 0.;
+    for (int category = 0;
+         category < vtkMRMLAbstractDisplayableManager::TimingCategory_Last; ++category)
+      {
+      total1 += dm1->GetTimingTotal(category);
+      total2 += dm2->GetTimingTotal(category);
+      }
+    return total1 > total2;
+  }
+};
 }
 
 //----------------------------------------------------------------------------
@@ -96,6 +137,8 @@ vtkMRMLDisplayableManagerGroup::vtkMRMLDisplayableManagerGroup()
   this->Internal = new vtkInternal;
   this->Internal->CallBackCommand->SetCallback(Self::DoCallback);
   this->Internal->CallBackCommand->SetClientData(this);
+  this->Internal->RendererCallBackCommand->SetCallback(Self::DoRendererCallback);
+  this->Internal->RendererCallBackCommand->SetClientData(this);
 }
 
 //----------------------------------------------------------------------------
@@ -111,6 +154,11 @@ vtkMRMLDisplayableManagerGroup::~vtkMRMLDisplayableManagerGroup()
 
   if (this->Internal->Renderer)
     {
+    this->Internal->Renderer->RemoveObserver(this->Internal->RendererCallBackCommand);
+    if (this->Internal->TimingOverlayActor)
+      {
+      this->Internal->Renderer->RemoveViewProp(this->Internal->TimingOverlayActor);
+      }
     this->Internal->Renderer->UnRegister(this);
     }
 
@@ -126,6 +174,8 @@ vtkMRMLDisplayableManagerGroup::~vtkMRMLDisplayableManagerGroup()
 void vtkMRMLDisplayableManagerGroup::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "TimingEnabled: " << this->Internal->TimingEnabled << "\n";
+  os << indent << "TimingOverlayVisible: " << this->GetTimingOverlayVisible() << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -276,6 +326,11 @@ void vtkMRMLDisplayableManagerGroup::AddDisplayableManager(
 
   displayableManager->SetAndObserveMRMLDisplayableNode(this->GetMRMLDisplayableNode());
 
+  if (this->Internal->TimingEnabled)
+    {
+    displayableManager->SetTimingEnabled(true);
+    }
+
   displayableManager->Register(this);
   this->Internal->DisplayableManagers.push_back(displayableManager);
   this->Internal->NameToDisplayableManagerMap[displayableManagerClassName] = displayableManager;
@@ -312,14 +367,28 @@ void vtkMRMLDisplayableManagerGroup::SetRenderer(vtkRenderer* newRenderer)
 
   if (this->Internal->Renderer)
     {
+    this->Internal->Renderer->RemoveObserver(this->Internal->RendererCallBackCommand);
+    if (this->Internal->TimingOverlayActor)
+      {
+      this->Internal->Renderer->RemoveViewProp(this->Internal->TimingOverlayActor);
+      }
     this->Internal->Renderer->Delete();
     }
 
   this->Internal->Renderer = newRenderer;
+  this->Internal->RenderStartTime = -1.;
 
   if (this->Internal->Renderer)
     {
     this->Internal->Renderer->Register(this);
+    this->Internal->Renderer->AddObserver(
+      vtkCommand::StartEvent, this->Internal->RendererCallBackCommand);
+    this->Internal->Renderer->AddObserver(
+      vtkCommand::EndEvent, this->Internal->RendererCallBackCommand);
+    if (this->Internal->TimingOverlayActor)
+      {
+      this->Internal->Renderer->AddViewProp(this->Internal->TimingOverlayActor);
+      }
     }
 
   vtkDebugMacro(<< this->GetClassName() << " (" << this << "): "
@@ -498,3 +567,174 @@ vtkMRMLLightBoxRendererManagerProxy* vtkMRMLDisplayableManagerGroup::GetLightBox
 {
   return this->Internal->LightBoxRendererManagerProxy;
 }
+
+//---------------------------------------------------------------------------
+void vtkMRMLDisplayableManagerGroup::SetTimingEnabled(bool enabled)
+{
+  if (this->Internal->TimingEnabled == enabled)
+    {
+    return;
+    }
+  this->Internal->TimingEnabled = enabled;
+  this->Internal->RenderStartTime = -1.;
+  for (size_t i=0; i < this->Internal->DisplayableManagers.size(); ++i)
+    {
+    this->Internal->DisplayableManagers[i]->SetTimingEnabled(enabled);
+    }
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLDisplayableManagerGroup::GetTimingEnabled()
+{
+  return this->Internal->TimingEnabled;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLDisplayableManagerGroup::ResetTimings()
+{
+  this->Internal->RenderCount = 0;
+  this->Internal->RenderTotal = 0.;
+  this->Internal->RenderMaximum = 0.;
+  for (size_t i=0; i < this->Internal->DisplayableManagers.size(); ++i)
+    {
+    this->Internal->DisplayableManagers[i]->ResetTimings();
+    }
+}
+
+//---------------------------------------------------------------------------
+int vtkMRMLDisplayableManagerGroup::GetRenderTimingCount()
+{
+  return this->Internal->RenderCount;
+}
+
+//---------------------------------------------------------------------------
+double vtkMRMLDisplayableManagerGroup::GetRenderTimingTotal()
+{
+  return this->Internal->RenderTotal;
+}
+
+//---------------------------------------------------------------------------
+double vtkMRMLDisplayableManagerGroup::GetRenderTimingMaximum()
+{
+  return this->Internal->RenderMaximum;
+}
+
+//---------------------------------------------------------------------------
+std::string vtkMRMLDisplayableManagerGroup::GetTimingReport()
+{
+  std::vector<vtkMRMLAbstractDisplayableManager*> displayableManagers =
+    this->Internal->DisplayableManagers;
+  std::stable_sort(displayableManagers.begin(), displayableManagers.end(),
+                   DisplayableManagerTimeGreater());
+
+  std::stringstream report;
+  report.setf(std::ios::fixed);
+  report.precision(2);
+  for (size_t i=0; i < displayableManagers.size(); ++i)
+    {
+    vtkMRMLAbstractDisplayableManager* displayableManager = displayableManagers[i];
+    bool first = true;
+    for (int category = 0;
+         category < vtkMRMLAbstractDisplayableManager::TimingCategory_Last; ++category)
+      {
+      int count = displayableManager->GetTimingCount(category);
+      if (count == 0)
+        {
+        continue;
+        }
+      report << (first ? displayableManager->GetClassName() : "") << (first ? ": " : ", ")
+             << vtkMRMLAbstractDisplayableManager::GetTimingCategoryAsString(category) << " "
+             << count << "x "
+             << 1000. * displayableManager->GetTimingTotal(category) / count << "ms"
+             << " (max " << 1000. * displayableManager->GetTimingMaximum(category) << "ms)";
+      first = false;
+      }
+    if (!first)
+      {
+      report << "\n";
+      }
+    }
+  if (this->Internal->RenderCount > 0)
+    {
+    report << "Render: " << this->Internal->RenderCount << "x "
+           << 1000. * this->Internal->RenderTotal / this->Internal->RenderCount << "ms"
+           << " (max " << 1000. * this->Internal->RenderMaximum << "ms)\n";
+    }
+  return report.str();
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLDisplayableManagerGroup::SetTimingOverlayVisible(bool visible)
+{
+  if (this->GetTimingOverlayVisible() == visible)
+    {
+    return;
+    }
+  if (visible)
+    {
+    this->SetTimingEnabled(true);
+    vtkNew<vtkTextActor> overlayActor;
+    overlayActor->SetPickable(0);
+    overlayActor->GetPositionCoordinate()->SetCoordinateSystemToNormalizedViewport();
+    overlayActor->SetPosition(0.01, 0.99);
+    overlayActor->GetTextProperty()->SetFontSize(12);
+    overlayActor->GetTextProperty()->SetVerticalJustificationToTop();
+    overlayActor->GetTextProperty()->SetColor(1., 1., 0.);
+    overlayActor->GetTextProperty()->ShadowOn();
+    this->Internal->TimingOverlayActor = overlayActor.GetPointer();
+    if (this->Internal->Renderer)
+      {
+      this->Internal->Renderer->AddViewProp(overlayActor.GetPointer());
+      }
+    }
+  else
+    {
+    if (this->Internal->Renderer)
+      {
+      this->Internal->Renderer->RemoveViewProp(this->Internal->TimingOverlayActor);
+      }
+    this->Internal->TimingOverlayActor = 0;
+    }
+  this->Modified();
+  this->RequestRender();
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLDisplayableManagerGroup::GetTimingOverlayVisible()
+{
+  return this->Internal->TimingOverlayActor.GetPointer() != 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLDisplayableManagerGroup::DoRendererCallback(vtkObject* vtkNotUsed(vtk_obj),
+                                                        unsigned long event,
+                                                        void* client_data,
+                                                        void* vtkNotUsed(call_data))
+{
+  vtkMRMLDisplayableManagerGroup* self =
+      reinterpret_cast<vtkMRMLDisplayableManagerGroup*>(client_data);
+  assert(self);
+  vtkInternal* internal = self->Internal;
+  if (!internal->TimingEnabled)
+    {
+    return;
+    }
+  if (event == vtkCommand::StartEvent)
+    {
+    // Show the times recorded up to the previous render
+    if (internal->TimingOverlayActor)
+      {
+      internal->TimingOverlayActor->SetInput(self->GetTimingReport().c_str());
+      }
+    internal->RenderStartTime = vtkTimerLog::GetUniversalTime();
+    }
+  else if (event == vtkCommand::EndEvent && internal->RenderStartTime >= 0.)
+    {
+    double elapsed = vtkTimerLog::GetUniversalTime() - internal->RenderStartTime;
+    internal->RenderStartTime = -1.;
+    ++internal->RenderCount;
+    internal->RenderTotal += elapsed;
+    internal->RenderMaximum = std::max(internal->RenderMaximum, elapsed);
+    }
+}
@@ -56,10 +56,12 @@
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPlane.h>
+#include <vtkPlaneCollection.h>
 #include <vtkPointData.h>
 #include <vtkPointSet.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProperty.h>
+#include <vtkQuadricLODActor.h>
 #include <vtkRenderWindowInteractor.h>
 #include <vtkSmartPointer.h>
 #include <vtkTransformFilter.h>
@@ -79,6 +81,43 @@
 //---------------------------------------------------------------------------
 vtkStandardNewMacro (vtkMRMLModelDisplayableManager );
 
+namespace
+{
+/// Non-linearly transformed meshes are shared by the model displayable
+/// managers of all the 3D views: a mesh shown in several views is transformed
+/// and kept in memory only once. Each displayable manager holds a reference
+/// on the filters it uses, a filter is deleted when no view uses it anymore.
+typedef std::map<vtkMRMLDisplayNode*, vtkWeakPointer<vtkTransformFilter> > SharedTransformFiltersType;
+SharedTransformFiltersType SharedTransformFilters;
+
+//---------------------------------------------------------------------------
+vtkSmartPointer<vtkTransformFilter> SharedTransformFilter(vtkMRMLDisplayNode* displayNode)
+{
+  SharedTransformFiltersType::iterator it = SharedTransformFilters.begin();
+  // Forget the filters that are not used by any view anymore
+  while (it != SharedTransformFilters.end())
+    {
+    if (it->second.GetPointer() == 0)
+      {
+      SharedTransformFilters.erase(it++);
+      }
+    else
+      {
+      ++it;
+      }
+    }
+  it = SharedTransformFilters.find(displayNode);
+  if (it != SharedTransformFilters.end())
+    {
+    return it->second.GetPointer();
+    }
+  vtkSmartPointer<vtkTransformFilter> transformFilter =
+    vtkSmartPointer<vtkTransformFilter>::New();
+  SharedTransformFilters[displayNode] = transformFilter;
+  return transformFilter;
+}
+}
+
 //---------------------------------------------------------------------------
 class vtkMRMLModelDisplayableManager::vtkInternal
 {
@@ -88,6 +127,20 @@ public:
 
   void CreateClipSlices();
 
+  /// Update ClippingPlanes with the slice planes that clip the models.
+  void UpdateClippingPlanes();
+
+  /// Return true if the models can be clipped by the mapper (i.e. on the GPU)
+  /// instead of being cut by a vtkClipPolyData filter.
+  /// Mapper clipping planes keep the intersection of the positive half
+  /// spaces of the planes, which matches ClipUnion, or any type with a single
+  /// plane. It is not supported for unstructured grids.
+  bool CanClipWithMapper(vtkMRMLModelNode::MeshTypeHint meshType);
+
+  /// Return true if a displayed model is clipped by a filter, such a model
+  /// must be updated when the slice planes move.
+  bool HasPipelineClippedModels();
+
   /// Reset all the pick vars
   void ResetPick();
 
@@ -97,7 +150,7 @@ public:
   std::map<std::string, int>                       DisplayedVisibility;
   std::map<std::string, vtkMRMLDisplayableNode *>  DisplayableNodes;
   std::map<std::string, int>                       RegisteredModelHierarchies;
-  std::map<std::string, vtkTransformFilter *>      DisplayNodeTransformFilters;
+  std::map<std::string, vtkSmartPointer<vtkTransformFilter> > DisplayNodeTransformFilters;
 
   vtkMRMLSliceNode *   RedSliceNode;
   vtkMRMLSliceNode *   GreenSliceNode;
@@ -107,6 +160,8 @@ public:
   vtkSmartPointer<vtkPlane>           RedSlicePlane;
   vtkSmartPointer<vtkPlane>           GreenSlicePlane;
   vtkSmartPointer<vtkPlane>           YellowSlicePlane;
+  /// Slice planes in world coordinates shared by the mappers clipping the models
+  vtkSmartPointer<vtkPlaneCollection> ClippingPlanes;
 
   vtkMRMLClipModelsNode * ClipModelsNode;
   int                     ClipType;
@@ -171,6 +226,7 @@ void vtkMRMLModelDisplayableManager::vtkInternal::CreateClipSlices()
   this->RedSlicePlane = vtkSmartPointer<vtkPlane>::New();
   this->GreenSlicePlane = vtkSmartPointer<vtkPlane>::New();
   this->YellowSlicePlane = vtkSmartPointer<vtkPlane>::New();
+  this->ClippingPlanes = vtkSmartPointer<vtkPlaneCollection>::New();
 
   this->ClipType = vtkMRMLClipModelsNode::ClipIntersection;
 
@@ -181,6 +237,59 @@ void vtkMRMLModelDisplayableManager::vtkInternal::CreateClipSlices()
   this->ClippingOn = false;
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLModelDisplayableManager::vtkInternal::UpdateClippingPlanes()
+{
+  this->ClippingPlanes->RemoveAllItems();
+  if (this->RedSliceClipState != vtkMRMLClipModelsNode::ClipOff)
+    {
+    this->ClippingPlanes->AddItem(this->RedSlicePlane);
+    }
+  if (this->GreenSliceClipState != vtkMRMLClipModelsNode::ClipOff)
+    {
+    this->ClippingPlanes->AddItem(this->GreenSlicePlane);
+    }
+  if (this->YellowSliceClipState != vtkMRMLClipModelsNode::ClipOff)
+    {
+    this->ClippingPlanes->AddItem(this->YellowSlicePlane);
+    }
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLModelDisplayableManager::vtkInternal
+::CanClipWithMapper(vtkMRMLModelNode::MeshTypeHint meshType)
+{
+  if (meshType == vtkMRMLModelNode::UnstructuredGridMeshType)
+    {
+    return false;
+    }
+  return this->ClipType == vtkMRMLClipModelsNode::ClipUnion ||
+    this->ClippingPlanes->GetNumberOfItems() <= 1;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLModelDisplayableManager::vtkInternal::HasPipelineClippedModels()
+{
+  std::map<std::string, int>::iterator clipIt;
+  for (clipIt = this->DisplayedClipState.begin();
+       clipIt != this->DisplayedClipState.end(); ++clipIt)
+    {
+    if (!clipIt->second)
+      {
+      continue;
+      }
+    std::map<std::string, vtkProp3D *>::iterator actorIt =
+      this->DisplayedActors.find(clipIt->first);
+    vtkActor* actor = actorIt != this->DisplayedActors.end() ?
+      vtkActor::SafeDownCast(actorIt->second) : 0;
+    if (!actor || !actor->GetMapper() || !actor->GetMapper()->GetClippingPlanes())
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLModelDisplayableManager::vtkInternal::ResetPick()
 {
@@ -215,17 +324,7 @@ vtkMRMLModelDisplayableManager::~vtkMRMLModelDisplayableManager()
   // release the DisplayedModelActors
   this->Internal->DisplayedActors.clear();
 
-  // release transforms
-  std::map<std::string, vtkTransformFilter *>::iterator tit;
-  for (tit = this->Internal->DisplayNodeTransformFilters.begin();
-       tit != this->Internal->DisplayNodeTransformFilters.end(); tit++ )
-    {
-    vtkTransformFilter  *transformFilter = (*tit).second;
-    transformFilter->SetInputConnection(0);
-    transformFilter->SetTransform(0);
-    transformFilter->Delete();
-    }
-
+  // release transforms, they may still be used by the other views
   this->Internal->DisplayNodeTransformFilters.clear();
 
   delete this->Internal;
@@ -417,6 +516,11 @@ int vtkMRMLModelDisplayableManager::UpdateClipSlicesFromMRML()
     this->Internal->YellowSliceClipState = this->Internal->ClipModelsNode->GetYellowSliceClipState();
     }
 
+  if (modifiedState)
+    {
+    this->Internal->UpdateClippingPlanes();
+    }
+
   // compute clipping on/off
   if (this->Internal->ClipModelsNode->GetRedSliceClipState() == vtkMRMLClipModelsNode::ClipOff &&
       this->Internal->ClipModelsNode->GetGreenSliceClipState() == vtkMRMLClipModelsNode::ClipOff &&
@@ -531,11 +635,14 @@ void vtkMRMLModelDisplayableManager::ProcessMRMLNodesEvents(vtkObject *caller,
     bool requestRender = true;
     if (event == vtkCommand::ModifiedEvent)
       {
-      if (this->UpdateClipSlicesFromMRML() || this->Internal->ClippingOn)
+      // Models clipped by their mapper use the slice planes updated in
+      // UpdateClipSlicesFromMRML(), they only need to be rendered again.
+      if (this->UpdateClipSlicesFromMRML() ||
+          (this->Internal->ClippingOn && this->Internal->HasPipelineClippedModels()))
         {
         this->SetUpdateFromMRMLRequested(1);
         }
-      else
+      else if (!this->Internal->ClippingOn)
         {
         requestRender = vtkMRMLSliceNode::SafeDownCast(caller)->GetSliceVisible() == 1;
         }
@@ -962,11 +1069,11 @@ void vtkMRMLModelDisplayableManager
     vtkTransformFilter* transformFilter = NULL;
     if (hasNonLinearTransform)
       {
-      std::map<std::string, vtkTransformFilter *>::iterator tit;
+      std::map<std::string, vtkSmartPointer<vtkTransformFilter> >::iterator tit;
       tit = this->Internal->DisplayNodeTransformFilters.find(displayNode->GetID());
       if (tit == this->Internal->DisplayNodeTransformFilters.end() )
         {
-        transformFilter = vtkTransformFilter::New();
+        transformFilter = SharedTransformFilter(displayNode);
         this->Internal->DisplayNodeTransformFilters[displayNode->GetID()] = transformFilter;
         }
       else
@@ -987,7 +1094,21 @@ void vtkMRMLModelDisplayableManager
       {
       if (!prop)
         {
-        prop = vtkActor::New();
+        if (modelNode && modelNode->GetMeshType() == vtkMRMLModelNode::UnstructuredGridMeshType)
+          {
+          prop = vtkActor::New();
+          }
+        else
+          {
+          // Render a decimated version of surface meshes while the view is
+          // interacted with and the full resolution mesh cannot be rendered at
+          // the desired update rate. The decimated mesh is only computed when
+          // it is first needed, and the full resolution mesh is rendered again
+          // when interaction stops.
+          vtkQuadricLODActor* lodActor = vtkQuadricLODActor::New();
+          lodActor->DeferLODConstructionOn();
+          prop = lodActor;
+          }
         }
       }
     else
@@ -1002,15 +1123,25 @@ void vtkMRMLModelDisplayableManager
         // caches information to skip steps if the display node has already rendered. but we
         // can have rendered a display node but not rendered its current mesh.
         vtkActor *actor = vtkActor::SafeDownCast(prop);
+        bool mapperClipping = false;
+        bool createClipper = false;
         if (actor)
           {
           vtkMapper *mapper = actor->GetMapper();
-
-          if (transformFilter)
+          mapperClipping = mapper && mapper->GetClippingPlanes() != 0;
+          if (mapperClipping && modelNode &&
+              !this->Internal->CanClipWithMapper(modelNode->GetMeshType()))
+            {
+            // the clipping planes can no longer be handled by the mapper,
+            // a clipper filter must be created
+            mapperClipping = false;
+            createClipper = true;
+            }
+          else if (transformFilter)
             {
             mapper->SetInputConnection(transformFilter->GetOutputPort());
             }
-          else if (mapper && !(this->Internal->ClippingOn && clipping))
+          else if (mapper && (mapperClipping || !(this->Internal->ClippingOn && clipping)))
             {
             mapper->SetInputConnection(meshConnection);
             }
@@ -1018,7 +1149,10 @@ void vtkMRMLModelDisplayableManager
         vtkMRMLTransformNode* tnode = displayableNode->GetParentTransformNode();
         // clipped model could be transformed
         // TODO: handle non-linear transforms
-        if (clipping == 0 || tnode == 0 || !tnode->IsTransformToWorldLinear())
+        // Mapper clipping planes are in world coordinates, they apply to
+        // transformed models as well.
+        if (!createClipper && (mapperClipping ||
+            clipping == 0 || tnode == 0 || !tnode->IsTransformToWorldLinear()))
           {
           continue;
           }
@@ -1027,12 +1161,20 @@ void vtkMRMLModelDisplayableManager
 
     vtkActor *actor = vtkActor::SafeDownCast(prop);
     vtkAlgorithm *clipper = 0;
+    bool mapperClipping = false;
     if(actor)
       {
       vtkMRMLModelNode::MeshTypeHint meshType = modelNode->GetMeshType();
       if (this->Internal->ClippingOn && modelDisplayNode != 0 && clipping)
         {
-        clipper = this->CreateTransformedClipper(modelNode->GetParentTransformNode(), meshType);
+        // Clipping in the mapper does not re-execute any filter when the
+        // slice planes move, which keeps large meshes (e.g. tractography
+        // polylines) interactive.
+        mapperClipping = this->Internal->CanClipWithMapper(meshType);
+        if (!mapperClipping)
+          {
+          clipper = this->CreateTransformedClipper(modelNode->GetParentTransformNode(), meshType);
+          }
         }
 
       vtkMapper *mapper = NULL;
@@ -1059,6 +1201,10 @@ void vtkMRMLModelDisplayableManager
         {
         mapper->SetInputConnection(meshConnection);
         }
+      if (mapperClipping)
+        {
+        mapper->SetClippingPlanes(this->Internal->ClippingPlanes);
+        }
 
       actor->SetMapper(mapper);
       mapper->Delete();
@@ -1079,15 +1225,12 @@ void vtkMRMLModelDisplayableManager
         this->Internal->DisplayedVisibility[modelDisplayNode->GetID()] = 1;
         }
 
+      this->Internal->DisplayedClipState[modelDisplayNode->GetID()] =
+        (clipper || mapperClipping) ? 1 : 0;
       if (clipper)
         {
-        this->Internal->DisplayedClipState[modelDisplayNode->GetID()] = 1;
         clipper->Delete();
         }
-      else
-        {
-        this->Internal->DisplayedClipState[modelDisplayNode->GetID()] = 0;
-        }
       prop->Delete();
       }
     else if (!hasMesh)
@@ -1096,15 +1239,12 @@ void vtkMRMLModelDisplayableManager
       }
     else
       {
+      this->Internal->DisplayedClipState[modelDisplayNode->GetID()] =
+        (clipper || mapperClipping) ? 1 : 0;
       if (clipper)
         {
-        this->Internal->DisplayedClipState[modelDisplayNode->GetID()] = 1;
         clipper->Delete();
         }
-      else
-        {
-        this->Internal->DisplayedClipState[modelDisplayNode->GetID()] = 0;
-        }
       }
     }
   worldTransform->Delete();
@@ -31,6 +31,9 @@
 #include <vtkMRMLSliceNode.h>
 #include <vtkMRMLTransformNode.h>
 
+// MRMLLogic includes
+#include <vtkAcceleratedPlaneCutter.h>
+
 // VTK includes
 #include <vtkActor2D.h>
 #include <vtkAlgorithmOutput.h>
@@ -50,12 +53,8 @@
 #include <vtkTransformFilter.h>
 #include <vtkTransformPolyDataFilter.h>
 #include <vtkWeakPointer.h>
-#include <vtkPointLocator.h>
 #include <vtkVersion.h>
 
-// VTK includes: customization
-#include <vtkCutter.h>
-
 // STD includes
 #include <algorithm>
 #include <cassert>
@@ -76,7 +75,7 @@ public:
     vtkSmartPointer<vtkTransformPolyDataFilter> Transformer;
     vtkSmartPointer<vtkTransformFilter> ModelWarper;
     vtkSmartPointer<vtkPlane> Plane;
-    vtkSmartPointer<vtkCutter> Cutter;
+    vtkSmartPointer<vtkAcceleratedPlaneCutter> Cutter;
     vtkSmartPointer<vtkProp> Actor;
     };
 
@@ -333,7 +332,7 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal
   // Create pipeline
   Pipeline* pipeline = new Pipeline();
   pipeline->Actor = actor.GetPointer();
-  pipeline->Cutter = vtkSmartPointer<vtkCutter>::New();
+  pipeline->Cutter = vtkSmartPointer<vtkAcceleratedPlaneCutter>::New();
   pipeline->TransformToSlice = vtkSmartPointer<vtkTransform>::New();
   pipeline->NodeToWorld = vtkSmartPointer<vtkGeneralTransform>::New();
   pipeline->Transformer = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
@@ -343,8 +342,7 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal
   // Set up pipeline
   pipeline->Transformer->SetTransform(pipeline->TransformToSlice);
   pipeline->Transformer->SetInputConnection(pipeline->Cutter->GetOutputPort());
-  pipeline->Cutter->SetCutFunction(pipeline->Plane);
-  pipeline->Cutter->SetGenerateCutScalars(0);
+  pipeline->Cutter->SetPlane(pipeline->Plane);
   pipeline->Cutter->SetInputConnection(pipeline->ModelWarper->GetOutputPort());
   pipeline->Actor->SetVisibility(0);
 
@@ -437,17 +435,6 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal
   vtkMatrix4x4::Invert(this->SliceXYToRAS, rasToSliceXY.GetPointer());
   pipeline->TransformToSlice->SetMatrix(rasToSliceXY.GetPointer());
 
-  // optimization for slice to slice intersections which are 1 quad polydatas
-  // no need for 50^3 default locator divisons
-  if (pointSet->GetPoints() != NULL && pointSet->GetNumberOfPoints() <= 4)
-    {
-    vtkNew<vtkPointLocator> locator;
-    double *bounds = pointSet->GetBounds();
-    locator->SetDivisions(2,2,2);
-    locator->InitPointInsertion(pointSet->GetPoints(), bounds);
-    pipeline->Cutter->SetLocator(locator.GetPointer());
-    }
-
   // Update pipeline actor
   vtkActor2D* actor = vtkActor2D::SafeDownCast(pipeline->Actor);
   vtkPolyDataMapper2D* mapper = vtkPolyDataMapper2D::SafeDownCast(actor->GetMapper());
@@ -26,7 +26,6 @@
 #include "vtkMRMLDisplayableManagerWin32Header.h"
 
 class vtkMRMLDisplayableNode;
-class vtkCutter;
 class vtkProp;
 
 /// \brief Displayable manager for slice (2D) views.
@@ -0,0 +1,390 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLDisplayableManager includes
+#include "vtkMRMLViewSnapshotRenderer.h"
+#include "vtkMRMLAbstractDisplayableManager.h"
+#include "vtkMRMLDisplayableManagerGroup.h"
+#include "vtkMRMLSliceViewDisplayableManagerFactory.h"
+#include "vtkMRMLThreeDViewDisplayableManagerFactory.h"
+
+// MRMLLogic includes
+#include <vtkMRMLSliceLogic.h>
+
+// MRML includes
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSliceNode.h>
+#include <vtkMRMLViewNode.h>
+
+// VTK includes
+#include <vtkActor2D.h>
+#include <vtkBMPWriter.h>
+#include <vtkGenericRenderWindowInteractor.h>
+#include <vtkImageData.h>
+#include <vtkImageMapper.h>
+#include <vtkJPEGWriter.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPNGWriter.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+#include <vtkTIFFWriter.h>
+#include <vtkWindowToImageFilter.h>
+
+// STD includes
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+// Displayable managers instantiated by qMRMLThreeDView
+const char* ThreeDViewDisplayableManagers[] = {
+  "vtkMRMLCameraDisplayableManager",
+  "vtkMRMLViewDisplayableManager",
+  "vtkMRMLModelDisplayableManager",
+  "vtkMRMLThreeDReformatDisplayableManager",
+  "vtkMRMLCrosshairDisplayableManager3D",
+  "vtkMRMLOrientationMarkerDisplayableManager",
+  "vtkMRMLRulerDisplayableManager",
+  0
+};
+
+// Displayable managers instantiated by qMRMLSliceView
+const char* SliceViewDisplayableManagers[] = {
+  "vtkMRMLVolumeGlyphSliceDisplayableManager",
+  "vtkMRMLModelSliceDisplayableManager",
+  "vtkMRMLCrosshairDisplayableManager",
+  "vtkMRMLOrientationMarkerDisplayableManager",
+  "vtkMRMLRulerDisplayableManager",
+  0
+};
+
+//---------------------------------------------------------------------------
+void RegisterDefaultDisplayableManagers(vtkMRMLDisplayableManagerFactory* factory,
+                                        const char** displayableManagers)
+{
+  for (const char** displayableManager = displayableManagers;
+       *displayableManager; ++displayableManager)
+    {
+    if (!factory->IsDisplayableManagerRegistered(*displayableManager))
+      {
+      factory->RegisterDisplayableManager(*displayableManager);
+      }
+    }
+}
+}
+
+//---------------------------------------------------------------------------
+vtkStandardNewMacro(vtkMRMLViewSnapshotRenderer);
+
+//---------------------------------------------------------------------------
+vtkMRMLViewSnapshotRenderer::vtkMRMLViewSnapshotRenderer()
+{
+  this->ViewNode = 0;
+  this->Size[0] = 600;
+  this->Size[1] = 600;
+  this->DisplayableManagerClassNames = 0;
+  this->RenderWindow = 0;
+  this->Renderer = 0;
+  this->DisplayableManagerGroup = 0;
+  this->SliceLogic = 0;
+  this->SliceImageMapper = 0;
+  this->SliceImageActor = 0;
+  this->WindowToImageFilter = vtkWindowToImageFilter::New();
+  this->WindowToImageFilter->ReadFrontBufferOff();
+  this->WindowToImageFilter->ShouldRerenderOff();
+  this->Image = vtkImageData::New();
+}
+
+//---------------------------------------------------------------------------
+vtkMRMLViewSnapshotRenderer::~vtkMRMLViewSnapshotRenderer()
+{
+  this->SetViewNode(0);
+  this->SetDisplayableManagerClassNames(0);
+  this->WindowToImageFilter->Delete();
+  this->Image->Delete();
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLViewSnapshotRenderer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ViewNode: "
+     << (this->ViewNode && this->ViewNode->GetID() ? this->ViewNode->GetID() : "(none)") << "\n";
+  os << indent << "Size: " << this->Size[0] << " " << this->Size[1] << "\n";
+  os << indent << "DisplayableManagerClassNames:";
+  if (this->DisplayableManagerClassNames)
+    {
+    for (vtkIdType i = 0; i < this->DisplayableManagerClassNames->GetNumberOfValues(); ++i)
+      {
+      os << " " << this->DisplayableManagerClassNames->GetValue(i);
+      }
+    os << "\n";
+    }
+  else
+    {
+    os << " (default)\n";
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLViewSnapshotRenderer::SetViewNode(vtkMRMLAbstractViewNode* viewNode)
+{
+  if (viewNode == this->ViewNode)
+    {
+    return;
+    }
+  this->DeletePipeline();
+  vtkSetObjectBodyMacro(ViewNode, vtkMRMLAbstractViewNode, viewNode);
+  this->CreatePipeline();
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLViewSnapshotRenderer::SetDisplayableManagerClassNames(vtkStringArray* classNames)
+{
+  if (classNames == this->DisplayableManagerClassNames)
+    {
+    return;
+    }
+  this->DeletePipeline();
+  vtkSetObjectBodyMacro(DisplayableManagerClassNames, vtkStringArray, classNames);
+  this->CreatePipeline();
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLViewSnapshotRenderer::CreatePipeline()
+{
+  if (!this->ViewNode)
+    {
+    return;
+    }
+  vtkMRMLScene* scene = this->ViewNode->GetScene();
+  if (!scene)
+    {
+    vtkErrorMacro(<< "CreatePipeline: view node " << this->ViewNode->GetID()
+                  << " is not in a scene");
+    return;
+    }
+  vtkMRMLSliceNode* sliceNode = vtkMRMLSliceNode::SafeDownCast(this->ViewNode);
+  if (!sliceNode && !vtkMRMLViewNode::SafeDownCast(this->ViewNode))
+    {
+    vtkErrorMacro(<< "CreatePipeline: " << this->ViewNode->GetClassName()
+                  << " is not a 3D or slice view node");
+    return;
+    }
+
+  this->Renderer = vtkRenderer::New();
+  this->RenderWindow = vtkRenderWindow::New();
+  this->RenderWindow->OffScreenRenderingOn();
+  this->RenderWindow->SetSize(this->Size);
+  this->RenderWindow->AddRenderer(this->Renderer);
+  // Displayable managers observe the interactor, a generic interactor does
+  // not need a windowing system.
+  vtkNew<vtkGenericRenderWindowInteractor> interactor;
+  this->RenderWindow->SetInteractor(interactor.GetPointer());
+
+  vtkMRMLDisplayableManagerFactory* factory = 0;
+  if (sliceNode)
+    {
+    factory = vtkMRMLSliceViewDisplayableManagerFactory::GetInstance();
+    RegisterDefaultDisplayableManagers(factory, SliceViewDisplayableManagers);
+
+    this->SliceLogic = vtkMRMLSliceLogic::New();
+    this->SliceLogic->SetName(sliceNode->GetLayoutName());
+    this->SliceLogic->SetMRMLScene(scene);
+    this->SliceLogic->SetSliceNode(sliceNode);
+
+    // Same mapping as the light box renderer manager of the slice views
+    this->SliceImageMapper = vtkImageMapper::New();
+    this->SliceImageMapper->SetColorWindow(255.);
+    this->SliceImageMapper->SetColorLevel(127.5);
+    this->SliceImageActor = vtkActor2D::New();
+    this->SliceImageActor->SetMapper(this->SliceImageMapper);
+    this->Renderer->AddViewProp(this->SliceImageActor);
+    }
+  else
+    {
+    factory = vtkMRMLThreeDViewDisplayableManagerFactory::GetInstance();
+    RegisterDefaultDisplayableManagers(factory, ThreeDViewDisplayableManagers);
+    }
+
+  if (!this->DisplayableManagerClassNames)
+    {
+    this->DisplayableManagerGroup = factory->InstantiateDisplayableManagers(this->Renderer);
+    }
+  else
+    {
+    this->DisplayableManagerGroup = vtkMRMLDisplayableManagerGroup::New();
+    this->DisplayableManagerGroup->SetRenderer(this->Renderer);
+    for (vtkIdType i = 0; i < this->DisplayableManagerClassNames->GetNumberOfValues(); ++i)
+      {
+      std::string className = this->DisplayableManagerClassNames->GetValue(i);
+      vtkSmartPointer<vtkMRMLAbstractDisplayableManager> displayableManager;
+      displayableManager.TakeReference(
+        vtkMRMLDisplayableManagerGroup::InstantiateDisplayableManager(className.c_str()));
+      if (!displayableManager)
+        {
+        vtkErrorMacro(<< "CreatePipeline: failed to instantiate displayable manager " << className);
+        continue;
+        }
+      displayableManager->SetMRMLApplicationLogic(factory->GetMRMLApplicationLogic());
+      this->DisplayableManagerGroup->AddDisplayableManager(displayableManager);
+      }
+    }
+  this->DisplayableManagerGroup->SetMRMLDisplayableNode(this->ViewNode);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLViewSnapshotRenderer::DeletePipeline()
+{
+  if (this->DisplayableManagerGroup)
+    {
+    this->DisplayableManagerGroup->SetMRMLDisplayableNode(0);
+    this->DisplayableManagerGroup->Delete();
+    this->DisplayableManagerGroup = 0;
+    }
+  if (this->SliceLogic)
+    {
+    this->SliceLogic->SetSliceNode(0);
+    this->SliceLogic->SetMRMLScene(0);
+    this->SliceLogic->Delete();
+    this->SliceLogic = 0;
+    }
+  if (this->SliceImageActor)
+    {
+    this->SliceImageActor->Delete();
+    this->SliceImageActor = 0;
+    }
+  if (this->SliceImageMapper)
+    {
+    this->SliceImageMapper->Delete();
+    this->SliceImageMapper = 0;
+    }
+  this->WindowToImageFilter->SetInput(0);
+  if (this->RenderWindow)
+    {
+    this->RenderWindow->Finalize();
+    this->RenderWindow->Delete();
+    this->RenderWindow = 0;
+    }
+  if (this->Renderer)
+    {
+    this->Renderer->Delete();
+    this->Renderer = 0;
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLViewSnapshotRenderer::UpdateSliceImage()
+{
+  if (!this->SliceLogic)
+    {
+    return;
+    }
+  // The slice node dimensions are the ones of the rendered image
+  this->SliceLogic->ResizeSliceNode(this->Size[0], this->Size[1]);
+  this->SliceLogic->UpdatePipeline();
+  vtkAlgorithmOutput* imageDataConnection = this->SliceLogic->GetImageDataConnection();
+  // No volume is shown in the slice view
+  this->SliceImageActor->SetVisibility(imageDataConnection != 0);
+  if (imageDataConnection)
+    {
+    this->SliceImageMapper->SetInputConnection(imageDataConnection);
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLViewSnapshotRenderer::Render()
+{
+  if (!this->RenderWindow)
+    {
+    vtkErrorMacro(<< "Render: no view to render");
+    return;
+    }
+  this->RenderWindow->SetSize(this->Size);
+  this->UpdateSliceImage();
+  this->RenderWindow->Render();
+}
+
+//---------------------------------------------------------------------------
+vtkImageData* vtkMRMLViewSnapshotRenderer::CaptureImage()
+{
+  if (!this->RenderWindow)
+    {
+    vtkErrorMacro(<< "CaptureImage: no view to render");
+    return 0;
+    }
+  this->Render();
+
+  this->WindowToImageFilter->SetInput(this->RenderWindow);
+  this->WindowToImageFilter->Modified();
+  this->WindowToImageFilter->Update();
+  this->Image->DeepCopy(this->WindowToImageFilter->GetOutput());
+  return this->Image;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLViewSnapshotRenderer::WriteImage(const char* fileName)
+{
+  if (!fileName || !*fileName)
+    {
+    vtkErrorMacro(<< "WriteImage: invalid file name");
+    return false;
+    }
+  std::string extension = fileName;
+  std::string::size_type dotPosition = extension.find_last_of('.');
+  extension = (dotPosition != std::string::npos ? extension.substr(dotPosition + 1) : "");
+  std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+  vtkSmartPointer<vtkImageWriter> writer;
+  if (extension == "png")
+    {
+    writer = vtkSmartPointer<vtkPNGWriter>::New();
+    }
+  else if (extension == "jpg" || extension == "jpeg")
+    {
+    writer = vtkSmartPointer<vtkJPEGWriter>::New();
+    }
+  else if (extension == "bmp")
+    {
+    writer = vtkSmartPointer<vtkBMPWriter>::New();
+    }
+  else if (extension == "tif" || extension == "tiff")
+    {
+    writer = vtkSmartPointer<vtkTIFFWriter>::New();
+    }
+  else
+    {
+    vtkErrorMacro(<< "WriteImage: unsupported file format " << fileName);
+    return false;
+    }
+
+  vtkImageData* image = this->CaptureImage();
+  if (!image)
+    {
+    return false;
+    }
+  writer->SetInputData(image);
+  writer->SetFileName(fileName);
+  writer->Write();
+  if (writer->GetErrorCode() != 0)
+    {
+    vtkErrorMacro(<< "WriteImage: failed to write " << fileName);
+    return false;
+    }
+  return true;
+}
@@ -0,0 +1,135 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLViewSnapshotRenderer_h
+#define __vtkMRMLViewSnapshotRenderer_h
+
+// VTK includes
+#include <vtkObject.h>
+
+#include "vtkMRMLDisplayableManagerWin32Header.h"
+
+class vtkActor2D;
+class vtkImageData;
+class vtkImageMapper;
+class vtkMRMLAbstractViewNode;
+class vtkMRMLDisplayableManagerGroup;
+class vtkMRMLSliceLogic;
+class vtkRenderer;
+class vtkRenderWindow;
+class vtkStringArray;
+class vtkWindowToImageFilter;
+
+/// \brief Render a 3D or slice view into an offscreen render window.
+///
+/// The displayable managers registered in the 3D or slice view factory
+/// (and, for slice views, the vtkMRMLSliceLogic reslicing pipeline) are
+/// instantiated against an offscreen render window, no Qt widget is needed.
+/// It allows generating snapshots of saved scenes from a batch script:
+/// \code
+/// renderer = slicer.vtkMRMLViewSnapshotRenderer()
+/// renderer.SetSize(800, 600)
+/// renderer.SetViewNode(slicer.util.getNode('vtkMRMLViewNode1'))
+/// renderer.WriteImage('/tmp/3d.png')
+/// \endcode
+/// Running the application with \c --no-main-window and
+/// \c --offscreen-rendering does not require a display when VTK is built
+/// with OSMesa or EGL support.
+/// A renderer can be reused for any number of snapshots, the pipeline is
+/// only rebuilt when the view node changes.
+class VTK_MRML_DISPLAYABLEMANAGER_EXPORT vtkMRMLViewSnapshotRenderer
+  : public vtkObject
+{
+public:
+  static vtkMRMLViewSnapshotRenderer* New();
+  vtkTypeMacro(vtkMRMLViewSnapshotRenderer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  /// View to render, either a vtkMRMLViewNode or a vtkMRMLSliceNode.
+  /// The view node must be in a scene.
+  void SetViewNode(vtkMRMLAbstractViewNode* viewNode);
+  vtkGetObjectMacro(ViewNode, vtkMRMLAbstractViewNode);
+
+  /// Size in pixels of the rendered images. 600x600 by default.
+  vtkSetVector2Macro(Size, int);
+  vtkGetVector2Macro(Size, int);
+
+  vtkGetObjectMacro(RenderWindow, vtkRenderWindow);
+  vtkGetObjectMacro(Renderer, vtkRenderer);
+
+  /// Displayable managers of the view.
+  /// NULL if no view node is set.
+  vtkGetObjectMacro(DisplayableManagerGroup, vtkMRMLDisplayableManagerGroup);
+
+  /// Class names of the displayable managers to instantiate.
+  /// If NULL (default), the displayable managers registered in the 3D or
+  /// slice view factory are instantiated. An empty list only renders the
+  /// resliced image of slice views, which allows measuring the cost of
+  /// each displayable manager separately.
+  /// The pipeline is rebuilt if a view node is set.
+  void SetDisplayableManagerClassNames(vtkStringArray* classNames);
+  vtkGetObjectMacro(DisplayableManagerClassNames, vtkStringArray);
+
+  /// Logic computing the resliced image of a slice view.
+  /// NULL if the view node is not a slice node.
+  vtkGetObjectMacro(SliceLogic, vtkMRMLSliceLogic);
+
+  /// Update the slice pipeline and render the view, without reading back
+  /// the rendered image.
+  void Render();
+
+  /// Render the view and return the image read back from the render window.
+  /// The image is owned by the snapshot renderer and is overwritten by the
+  /// next capture. Returns NULL if no view node is set.
+  vtkImageData* CaptureImage();
+
+  /// Render the view and write the image into \a fileName.
+  /// The file format is chosen from the extension: png, jpg, jpeg, bmp,
+  /// tif or tiff.
+  /// Returns false if the image could not be captured or written.
+  bool WriteImage(const char* fileName);
+
+protected:
+  vtkMRMLViewSnapshotRenderer();
+  virtual ~vtkMRMLViewSnapshotRenderer();
+
+  /// Instantiate the displayable managers (and slice pipeline) of ViewNode.
+  void CreatePipeline();
+  void DeletePipeline();
+
+  /// Connect the slice logic output to the 2D image actor.
+  void UpdateSliceImage();
+
+  vtkMRMLAbstractViewNode* ViewNode;
+  int Size[2];
+  vtkStringArray* DisplayableManagerClassNames;
+
+  vtkRenderWindow* RenderWindow;
+  vtkRenderer* Renderer;
+  vtkMRMLDisplayableManagerGroup* DisplayableManagerGroup;
+
+  vtkMRMLSliceLogic* SliceLogic;
+  vtkImageMapper* SliceImageMapper;
+  vtkActor2D* SliceImageActor;
+
+  vtkWindowToImageFilter* WindowToImageFilter;
+  vtkImageData* Image;
+
+private:
+  vtkMRMLViewSnapshotRenderer(const vtkMRMLViewSnapshotRenderer&); // Not implemented
+  void operator=(const vtkMRMLViewSnapshotRenderer&);              // Not implemented
+};
+
+#endif
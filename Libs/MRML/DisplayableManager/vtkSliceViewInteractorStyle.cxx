@@ -67,12 +67,19 @@ vtkSliceViewInteractorStyle::vtkSliceViewInteractorStyle()
   this->LastVolumeWindowLevel[0] = 0;
   this->LastVolumeWindowLevel[1] = 0;
 
+  this->InteractionPreviewDelay = 200;
+  this->InteractionPreviewTimerId = 0;
+
   this->SliceLogic = 0;
 }
 
 //----------------------------------------------------------------------------
 vtkSliceViewInteractorStyle::~vtkSliceViewInteractorStyle()
 {
+  if (this->InteractionPreviewTimerId && this->Interactor)
+    {
+    this->Interactor->DestroyTimer(this->InteractionPreviewTimerId);
+    }
   this->SetSliceLogic(0);
 }
 
@@ -81,6 +88,7 @@ void vtkSliceViewInteractorStyle::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
 
+  os << indent << "InteractionPreviewDelay: " << this->InteractionPreviewDelay << "\n";
   os << indent << "\nSlice Logic:\n";
   if (this->SliceLogic)
     {
@@ -286,6 +294,7 @@ void vtkSliceViewInteractorStyle::OnRightButtonDown()
   this->SliceLogic->GetMRMLScene()->SaveStateForUndo(this->SliceLogic->GetSliceNode());
   this->SetActionState(vtkSliceViewInteractorStyle::Zoom);
   this->SliceLogic->StartSliceNodeInteraction(vtkMRMLSliceNode::FieldOfViewFlag);
+  this->StartInteractionPreview();
   vtkMRMLSliceNode *sliceNode = this->SliceLogic->GetSliceNode();
   sliceNode->GetFieldOfView(this->StartActionFOV);
   this->GetInteractor()->GetEventPosition(this->StartActionEventPosition);
@@ -296,6 +305,7 @@ void vtkSliceViewInteractorStyle::OnRightButtonUp()
 {
   this->SetActionState(vtkSliceViewInteractorStyle::None);
   this->SliceLogic->EndSliceNodeInteraction();
+  this->EndInteractionPreview();
 }
 
 //----------------------------------------------------------------------------
@@ -556,6 +566,67 @@ void vtkSliceViewInteractorStyle::OnLeave()
   this->Superclass::OnLeave();
 }
 
+//----------------------------------------------------------------------------
+void vtkSliceViewInteractorStyle::OnTimer()
+{
+  if (this->InteractionPreviewTimerId != 0 &&
+      this->Interactor->GetTimerEventId() == this->InteractionPreviewTimerId)
+    {
+    this->Interactor->DestroyTimer(this->InteractionPreviewTimerId);
+    this->InteractionPreviewTimerId = 0;
+    // Keep the preview while panning or zooming
+    if (this->ActionState != this->Translate && this->ActionState != this->Zoom)
+      {
+      this->EndInteractionPreview();
+      }
+    return;
+    }
+  this->Superclass::OnTimer();
+}
+
+//----------------------------------------------------------------------------
+void vtkSliceViewInteractorStyle::StartInteractionPreview()
+{
+  if (this->InteractionPreviewDelay <= 0 || !this->SliceLogic)
+    {
+    return;
+    }
+  this->SliceLogic->SetInteractionPreview(1);
+}
+
+//----------------------------------------------------------------------------
+void vtkSliceViewInteractorStyle::StartTimedInteractionPreview()
+{
+  if (this->InteractionPreviewDelay <= 0 || !this->SliceLogic || !this->Interactor)
+    {
+    return;
+    }
+  if (this->InteractionPreviewTimerId != 0)
+    {
+    this->Interactor->DestroyTimer(this->InteractionPreviewTimerId);
+    }
+  this->InteractionPreviewTimerId =
+    this->Interactor->CreateOneShotTimer(this->InteractionPreviewDelay);
+  if (this->InteractionPreviewTimerId != 0)
+    {
+    this->SliceLogic->SetInteractionPreview(1);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSliceViewInteractorStyle::EndInteractionPreview()
+{
+  if (!this->SliceLogic || !this->SliceLogic->GetInteractionPreview())
+    {
+    return;
+    }
+  this->SliceLogic->SetInteractionPreview(0);
+  if (this->Interactor)
+    {
+    this->Interactor->Render();
+    }
+}
+
 //----------------------------------------------------------------------------
 double vtkSliceViewInteractorStyle::GetSliceSpacing()
 {
@@ -593,6 +664,7 @@ void vtkSliceViewInteractorStyle::MoveSlice(double delta)
   this->SliceLogic->GetSliceBounds(sliceBounds);
   if (newOffset >= sliceBounds[4] && newOffset <= sliceBounds[5])
     {
+    this->StartTimedInteractionPreview();
     this->SliceLogic->StartSliceNodeInteraction(vtkMRMLSliceNode::SliceToRASFlag);
     this->SliceLogic->SetSliceOffset(newOffset);
     this->SliceLogic->EndSliceNodeInteraction();
@@ -605,6 +677,7 @@ void vtkSliceViewInteractorStyle::StartTranslate()
   vtkMRMLSliceNode *sliceNode = this->SliceLogic->GetSliceNode();
   this->SliceLogic->GetMRMLScene()->SaveStateForUndo(sliceNode);
   this->SliceLogic->StartSliceNodeInteraction(vtkMRMLSliceNode::XYZOriginFlag);
+  this->StartInteractionPreview();
 
   this->SetActionState(this->Translate);
 }
@@ -613,6 +686,7 @@ void vtkSliceViewInteractorStyle::EndTranslate()
 {
   this->SetActionState(this->None);
   this->SliceLogic->EndSliceNodeInteraction();
+  this->EndInteractionPreview();
 }
 
 //----------------------------------------------------------------------------
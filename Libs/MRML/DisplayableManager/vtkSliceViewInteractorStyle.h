@@ -70,6 +70,7 @@ public:
   virtual void OnConfigure();
   virtual void OnEnter();
   virtual void OnLeave();
+  virtual void OnTimer();
 
   /// Internal state management for multi-event sequences (like click-drag-release)
 
@@ -120,6 +121,14 @@ public:
   /// The 4th component is 1 so it can be used with a homogenous transform.
   void GetEventXYZ(double xyz[4]);
 
+  /// Time (in ms) without slice motion after which the slice is refined
+  /// when it was rendered as a preview (nearest neighbor reslicing) while
+  /// scrolling with the mouse wheel, panning or zooming.
+  /// A value of 0 disables the interaction preview. 200 by default.
+  /// \sa vtkMRMLSliceLogic::SetInteractionPreview()
+  vtkSetMacro(InteractionPreviewDelay, int);
+  vtkGetMacro(InteractionPreviewDelay, int);
+
   ///
   /// Get/Set the SliceLogic
   void SetSliceLogic(vtkMRMLSliceLogic* SliceLogic);
@@ -143,6 +152,13 @@ protected:
   vtkSliceViewInteractorStyle();
   ~vtkSliceViewInteractorStyle();
 
+  /// Render the slice as a preview until the interaction ends.
+  void StartInteractionPreview();
+  /// Render the slice as a preview until no slice motion happened for
+  /// InteractionPreviewDelay ms.
+  void StartTimedInteractionPreview();
+  void EndInteractionPreview();
+
   int GetMouseInteractionMode();
 
   /// Returns true if mouse is inside the selected layer volume.
@@ -160,6 +176,9 @@ protected:
   double LastLabelOpacity;
   double LastVolumeWindowLevel[2];
 
+  int InteractionPreviewDelay;
+  int InteractionPreviewTimerId;
+
   vtkMRMLSliceLogic *SliceLogic;
 
 private:
@@ -0,0 +1,118 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// MRMLLogic includes
+#include "vtkAcceleratedPlaneCutter.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCubeSource.h>
+#include <vtkCutter.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPlane.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+
+// STD includes
+#include <cmath>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+double TotalLineLength(vtkPolyData* polyData)
+{
+  double length = 0.0;
+  vtkCellArray* lines = polyData->GetLines();
+  vtkIdType npts = 0;
+  vtkIdType* pts = NULL;
+  for (lines->InitTraversal(); lines->GetNextCell(npts, pts); )
+    {
+    for (vtkIdType i = 0; i + 1 < npts; ++i)
+      {
+      double p0[3] = { 0.0, 0.0, 0.0 };
+      double p1[3] = { 0.0, 0.0, 0.0 };
+      polyData->GetPoint(pts[i], p0);
+      polyData->GetPoint(pts[i + 1], p1);
+      length += sqrt(vtkMath::Distance2BetweenPoints(p0, p1));
+      }
+    }
+  return length;
+}
+
+//----------------------------------------------------------------------------
+bool TestCuts(vtkPolyData* mesh, double normal[3], double firstOffset, double lastOffset, bool compareCells)
+{
+  vtkNew<vtkPlane> plane;
+  plane->SetNormal(normal);
+
+  vtkNew<vtkAcceleratedPlaneCutter> acceleratedCutter;
+  acceleratedCutter->SetInputData(mesh);
+  acceleratedCutter->SetPlane(plane.GetPointer());
+
+  vtkNew<vtkCutter> referenceCutter;
+  referenceCutter->SetInputData(mesh);
+  referenceCutter->SetCutFunction(plane.GetPointer());
+
+  double unitNormal[3] = { normal[0], normal[1], normal[2] };
+  vtkMath::Normalize(unitNormal);
+  const int numberOfCuts = 17;
+  for (int cut = 0; cut < numberOfCuts; ++cut)
+    {
+    double offset = firstOffset + (lastOffset - firstOffset) * cut / (numberOfCuts - 1);
+    plane->SetOrigin(offset * unitNormal[0], offset * unitNormal[1], offset * unitNormal[2]);
+    acceleratedCutter->Update();
+    referenceCutter->Update();
+    vtkPolyData* output = acceleratedCutter->GetOutput();
+    vtkPolyData* expected = referenceCutter->GetOutput();
+    if ((compareCells && output->GetNumberOfLines() != expected->GetNumberOfLines())
+      || (compareCells && output->GetNumberOfPoints() != expected->GetNumberOfPoints())
+      || fabs(TotalLineLength(output) - TotalLineLength(expected)) > 1e-4)
+      {
+      std::cerr << "Line " << __LINE__ << ": cut mismatch at offset " << offset
+                << ": lines " << output->GetNumberOfLines() << " (expected " << expected->GetNumberOfLines() << ")"
+                << ", points " << output->GetNumberOfPoints() << " (expected " << expected->GetNumberOfPoints() << ")"
+                << ", length " << TotalLineLength(output) << " (expected " << TotalLineLength(expected) << ")"
+                << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkAcceleratedPlaneCutterTest1(int vtkNotUsed(argc), char * vtkNotUsed(argv)[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(10.0);
+  sphere->SetThetaResolution(40);
+  sphere->SetPhiResolution(30);
+  sphere->Update();
+
+  double axialNormal[3] = { 0.0, 0.0, 1.0 };
+  CHECK_BOOL(TestCuts(sphere->GetOutput(), axialNormal, -12.3, 12.1, true), true);
+  double obliqueNormal[3] = { 0.3, -0.5, 0.8 };
+  CHECK_BOOL(TestCuts(sphere->GetOutput(), obliqueNormal, -9.7, 9.9, true), true);
+
+  // Quads are triangulated, therefore only the shape of the cut is the same
+  vtkNew<vtkCubeSource> cube;
+  cube->SetXLength(4.0);
+  cube->SetYLength(6.0);
+  cube->SetZLength(8.0);
+  cube->Update();
+  CHECK_BOOL(TestCuts(cube->GetOutput(), obliqueNormal, -4.1, 4.3, false), true);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,131 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// MRMLLogic includes
+#include "vtkImageCompareBlend.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkTrivialProducer.h>
+
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void CreateImage(vtkImageData* image, int seed)
+{
+  image->SetExtent(0, 39, 0, 29, 0, 0);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 4);
+  unsigned char* ptr = static_cast<unsigned char*>(image->GetScalarPointer());
+  for (vtkIdType i = 0; i < 4 * image->GetNumberOfPoints(); ++i)
+    {
+    ptr[i] = static_cast<unsigned char>((i * seed + 17) % 256);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Reference value of a pixel component.
+int ExpectedValue(vtkImageCompareBlend* filter, vtkImageData* background,
+                  vtkImageData* foreground, int x, int y, int c)
+{
+  const int backgroundValue = static_cast<unsigned char*>(background->GetScalarPointer(x, y, 0))[c];
+  const int foregroundValue = static_cast<unsigned char*>(foreground->GetScalarPointer(x, y, 0))[c];
+  const int size = filter->GetCheckerboardSize();
+  switch (filter->GetMode())
+    {
+    case vtkImageCompareBlend::Checkerboard:
+      return ((x / size + y / size) % 2 == 0) ? foregroundValue : backgroundValue;
+    case vtkImageCompareBlend::Swipe:
+      return (x < static_cast<int>(filter->GetSwipePosition() * 40 + 0.5)) ? foregroundValue : backgroundValue;
+    case vtkImageCompareBlend::Difference:
+      return c == 3 ? std::max(foregroundValue, backgroundValue) : abs(foregroundValue - backgroundValue);
+    case vtkImageCompareBlend::Flicker:
+      return filter->GetFlickerForeground() ? foregroundValue : backgroundValue;
+    }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+bool TestMode(vtkImageCompareBlend* filter, vtkImageData* background, vtkImageData* foreground)
+{
+  filter->Update();
+  vtkImageData* output = filter->GetOutput();
+  if (output->GetNumberOfScalarComponents() != 4)
+    {
+    std::cerr << "Mode " << filter->GetMode() << ": wrong number of components" << std::endl;
+    return false;
+    }
+  for (int y = 0; y < 30; ++y)
+    {
+    for (int x = 0; x < 40; ++x)
+      {
+      for (int c = 0; c < 4; ++c)
+        {
+        const int value = static_cast<unsigned char*>(output->GetScalarPointer(x, y, 0))[c];
+        const int expected = ExpectedValue(filter, background, foreground, x, y, c);
+        if (value != expected)
+          {
+          std::cerr << "Mode " << filter->GetMode() << ": wrong value at ("
+                    << x << ", " << y << ") component " << c << ": " << value
+                    << " instead of " << expected << std::endl;
+          return false;
+          }
+        }
+      }
+    }
+  return true;
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkImageCompareBlendTest1(int , char * [] )
+{
+  vtkNew<vtkImageCompareBlend> filter;
+  EXERCISE_BASIC_OBJECT_METHODS(filter.GetPointer());
+
+  vtkNew<vtkImageData> background;
+  CreateImage(background.GetPointer(), 7);
+  vtkNew<vtkImageData> foreground;
+  CreateImage(foreground.GetPointer(), 13);
+  vtkNew<vtkTrivialProducer> backgroundProducer;
+  backgroundProducer->SetOutput(background.GetPointer());
+  vtkNew<vtkTrivialProducer> foregroundProducer;
+  foregroundProducer->SetOutput(foreground.GetPointer());
+  filter->SetBackgroundInputConnection(backgroundProducer->GetOutputPort());
+  filter->SetForegroundInputConnection(foregroundProducer->GetOutputPort());
+
+  filter->SetMode(vtkImageCompareBlend::Checkerboard);
+  CHECK_BOOL(TestMode(filter.GetPointer(), background.GetPointer(), foreground.GetPointer()), true);
+  filter->SetCheckerboardSize(7);
+  CHECK_BOOL(TestMode(filter.GetPointer(), background.GetPointer(), foreground.GetPointer()), true);
+
+  filter->SetMode(vtkImageCompareBlend::Swipe);
+  CHECK_BOOL(TestMode(filter.GetPointer(), background.GetPointer(), foreground.GetPointer()), true);
+  filter->SetSwipePosition(0.1);
+  CHECK_BOOL(TestMode(filter.GetPointer(), background.GetPointer(), foreground.GetPointer()), true);
+
+  filter->SetMode(vtkImageCompareBlend::Difference);
+  CHECK_BOOL(TestMode(filter.GetPointer(), background.GetPointer(), foreground.GetPointer()), true);
+
+  filter->SetMode(vtkImageCompareBlend::Flicker);
+  CHECK_BOOL(TestMode(filter.GetPointer(), background.GetPointer(), foreground.GetPointer()), true);
+  filter->FlickerForegroundOn();
+  CHECK_BOOL(TestMode(filter.GetPointer(), background.GetPointer(), foreground.GetPointer()), true);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,112 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// MRMLLogic includes
+#include "vtkImageLabelOutline.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Reference implementation: a labeled pixel is an outline pixel if its
+// neighborhood contains another label or reaches outside of the image.
+unsigned char ExpectedOutline(vtkImageData* image, int x, int y, int outline)
+{
+  int* extent = image->GetExtent();
+  unsigned char label = *static_cast<unsigned char*>(image->GetScalarPointer(x, y, 0));
+  if (label == 0)
+    {
+    return 0;
+    }
+  for (int j = y - outline; j <= y + outline; ++j)
+    {
+    for (int i = x - outline; i <= x + outline; ++i)
+      {
+      if (i < extent[0] || i > extent[1] || j < extent[2] || j > extent[3])
+        {
+        return label;
+        }
+      if (*static_cast<unsigned char*>(image->GetScalarPointer(i, j, 0)) != label)
+        {
+        return label;
+        }
+      }
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+bool TestOutline(vtkImageData* image, int outline)
+{
+  vtkNew<vtkImageLabelOutline> filter;
+  filter->SetInputData(image);
+  filter->SetOutline(outline);
+  filter->Update();
+  vtkImageData* output = filter->GetOutput();
+  int* extent = image->GetExtent();
+  for (int y = extent[2]; y <= extent[3]; ++y)
+    {
+    for (int x = extent[0]; x <= extent[1]; ++x)
+      {
+      int value = *static_cast<unsigned char*>(output->GetScalarPointer(x, y, 0));
+      int expected = ExpectedOutline(image, x, y, outline);
+      if (value != expected)
+        {
+        std::cerr << "Outline " << outline << ": wrong value at ("
+                  << x << ", " << y << "): " << value
+                  << " instead of " << expected << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLabelOutlineTest1(int , char * [] )
+{
+  vtkNew<vtkImageLabelOutline> filter;
+  EXERCISE_BASIC_OBJECT_METHODS(filter.GetPointer());
+
+  // A square label, a label touching the image border and a label next to it
+  vtkNew<vtkImageData> image;
+  image->SetExtent(0, 19, 0, 14, 0, 0);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char* ptr = static_cast<unsigned char*>(image->GetScalarPointer());
+  for (int y = 0; y < 15; ++y)
+    {
+    for (int x = 0; x < 20; ++x, ++ptr)
+      {
+      *ptr = 0;
+      if (x >= 3 && x <= 9 && y >= 4 && y <= 10)
+        {
+        *ptr = 1;
+        }
+      else if (x >= 14)
+        {
+        *ptr = (y < 7 ? 2 : 3);
+        }
+      }
+    }
+
+  CHECK_BOOL(TestOutline(image.GetPointer(), 1), true);
+  CHECK_BOOL(TestOutline(image.GetPointer(), 2), true);
+  CHECK_BOOL(TestOutline(image.GetPointer(), 3), true);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLLogic includes
+#include "vtkMRMLMemoryLogic.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLScene.h>
+
+// VTK includes
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkStringArray.h>
+
+//-----------------------------------------------------------------------------
+int vtkMRMLMemoryLogicTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLMemoryLogic> memoryLogic;
+  memoryLogic->SetMRMLScene(scene.GetPointer());
+  CHECK_INT(memoryLogic->GetTotalMemorySize(), 0);
+
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(64, 64, 16);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  vtkIdType imageSize = static_cast<vtkIdType>(imageData->GetActualMemorySize()) * 1024;
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(imageData.GetPointer());
+  scene->AddNode(volumeNode.GetPointer());
+  CHECK_INT(vtkMRMLMemoryLogic::GetNodeMemorySize(volumeNode.GetPointer()), imageSize);
+
+  // Image data shared by two volumes is counted once
+  vtkNew<vtkMRMLScalarVolumeNode> sharingVolumeNode;
+  sharingVolumeNode->SetAndObserveImageData(imageData.GetPointer());
+  scene->AddNode(sharingVolumeNode.GetPointer());
+  CHECK_INT(memoryLogic->GetSceneDataMemorySize(), imageSize);
+
+  vtkNew<vtkStringArray> nodeIDs;
+  vtkNew<vtkIdTypeArray> memorySizes;
+  memoryLogic->GetNodeMemorySizes(nodeIDs.GetPointer(), memorySizes.GetPointer());
+  CHECK_INT(nodeIDs->GetNumberOfValues(), 2);
+  CHECK_INT(memorySizes->GetValue(0), imageSize);
+
+  // Pyramid levels are caches
+  CHECK_NOT_NULL(volumeNode->GetPyramidLevelImageData(1));
+  vtkIdType pyramidSize = volumeNode->GetPyramidMemorySize();
+  CHECK_BOOL(pyramidSize > 0, true);
+  CHECK_INT(memoryLogic->GetCacheMemorySize(), pyramidSize);
+  CHECK_INT(memoryLogic->GetTotalMemorySize(), imageSize + pyramidSize);
+
+  // No budget, nothing is released
+  CHECK_INT(memoryLogic->EnforceMemoryBudget(), 0);
+  CHECK_INT(volumeNode->GetPyramidMemorySize(), pyramidSize);
+
+  memoryLogic->SetMemoryBudget(imageSize);
+  CHECK_INT(memoryLogic->EnforceMemoryBudget(), pyramidSize);
+  CHECK_INT(volumeNode->GetPyramidMemorySize(), 0);
+  CHECK_INT(memoryLogic->GetTotalMemorySize(), imageSize);
+
+  // The levels are computed again when needed
+  CHECK_NOT_NULL(volumeNode->GetPyramidLevelImageData(1));
+  CHECK_INT(volumeNode->GetPyramidMemorySize(), pyramidSize);
+
+  return EXIT_SUCCESS;
+}
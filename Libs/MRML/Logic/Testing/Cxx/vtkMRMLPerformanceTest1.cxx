@@ -0,0 +1,518 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLLogic includes
+#include <vtkMRMLSliceLayerLogic.h>
+#include <vtkMRMLSliceLogic.h>
+
+// MRML includes
+#include <vtkMRMLColorTableNode.h>
+#include <vtkMRMLLinearTransformNode.h>
+#include <vtkMRMLScalarVolumeDisplayNode.h>
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSliceCompositeNode.h>
+#include <vtkMRMLSliceNode.h>
+
+// SegmentationCore includes
+#include <vtkBinaryLabelmapToClosedSurfaceConversionRule.h>
+#include <vtkOrientedImageData.h>
+#include <vtkOrientedImageDataResample.h>
+#include <vtkSegment.h>
+#include <vtkSegmentation.h>
+#include <vtkSegmentationConverter.h>
+#include <vtkSegmentationConverterFactory.h>
+
+// VTK includes
+#include <vtkAlgorithm.h>
+#include <vtkAlgorithmOutput.h>
+#include <vtkGeneralTransform.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Times the hot paths of MRML and writes the results as JSON.
+//
+// Usage: vtkMRMLPerformanceTest1 [-n maxNodes] [-o results.json]
+//                                [-b baseline.json] [-t tolerance]
+//
+// Each benchmark is run several times and the fastest run is reported in
+// seconds. If a baseline file (a results file of a previous run) is given,
+// the test fails when a benchmark is slower than its baseline by more than
+// the tolerance (0.5 = 50% by default).
+
+namespace
+{
+
+typedef std::vector<std::pair<std::string, double> > BenchmarkResultsType;
+
+//-----------------------------------------------------------------------------
+// Keep the fastest of several runs of a benchmark
+class BenchmarkTimer
+{
+public:
+  BenchmarkTimer() : Start(0.), Best(-1.) {}
+  void StartRun() { this->Start = vtkTimerLog::GetUniversalTime(); }
+  void StopRun() { this->AddRun(vtkTimerLog::GetUniversalTime() - this->Start); }
+  void AddRun(double seconds)
+    {
+    if (this->Best < 0. || seconds < this->Best)
+      {
+      this->Best = seconds;
+      }
+    }
+  double GetBest() { return this->Best; }
+private:
+  double Start;
+  double Best;
+};
+
+const int NUMBER_OF_RUNS = 3;
+
+//-----------------------------------------------------------------------------
+std::string benchmarkName(const char* name, int size)
+{
+  std::stringstream ss;
+  ss << name << "_" << size;
+  return ss.str();
+}
+
+//-----------------------------------------------------------------------------
+void addResult(BenchmarkResultsType& results, const std::string& name, double seconds)
+{
+  results.push_back(std::make_pair(name, seconds));
+  std::cout << name << ": " << seconds << " s" << std::endl;
+}
+
+//-----------------------------------------------------------------------------
+void benchmarkSceneNodes(int numberOfNodes, BenchmarkResultsType& results)
+{
+  BenchmarkTimer addTimer;
+  BenchmarkTimer lookupTimer;
+  BenchmarkTimer removeTimer;
+  for (int run = 0; run < NUMBER_OF_RUNS; ++run)
+    {
+    vtkNew<vtkMRMLScene> scene;
+    std::vector<vtkSmartPointer<vtkMRMLScalarVolumeNode> > nodes;
+    for (int i = 0; i < numberOfNodes; ++i)
+      {
+      nodes.push_back(vtkSmartPointer<vtkMRMLScalarVolumeNode>::New());
+      }
+
+    addTimer.StartRun();
+    for (int i = 0; i < numberOfNodes; ++i)
+      {
+      scene->AddNode(nodes[i]);
+      }
+    addTimer.StopRun();
+
+    std::vector<std::string> nodeIDs;
+    for (int i = 0; i < numberOfNodes; ++i)
+      {
+      nodeIDs.push_back(nodes[i]->GetID());
+      }
+    lookupTimer.StartRun();
+    for (int i = 0; i < numberOfNodes; ++i)
+      {
+      scene->GetNodeByID(nodeIDs[i]);
+      }
+    scene->GetNodesByClass("vtkMRMLScalarVolumeNode")->Delete();
+    lookupTimer.StopRun();
+
+    removeTimer.StartRun();
+    for (int i = numberOfNodes - 1; i >= 0; --i)
+      {
+      scene->RemoveNode(nodes[i]);
+      }
+    removeTimer.StopRun();
+    }
+  addResult(results, benchmarkName("SceneAddNode", numberOfNodes), addTimer.GetBest());
+  addResult(results, benchmarkName("SceneGetNodeByID", numberOfNodes), lookupTimer.GetBest());
+  addResult(results, benchmarkName("SceneRemoveNode", numberOfNodes), removeTimer.GetBest());
+}
+
+//-----------------------------------------------------------------------------
+void benchmarkSceneCommitImport(int numberOfNodes, BenchmarkResultsType& results)
+{
+  vtkNew<vtkMRMLScene> scene;
+  for (int i = 0; i < numberOfNodes; ++i)
+    {
+    vtkNew<vtkMRMLScalarVolumeNode> node;
+    scene->AddNode(node.GetPointer());
+    }
+
+  BenchmarkTimer commitTimer;
+  BenchmarkTimer importTimer;
+  for (int run = 0; run < NUMBER_OF_RUNS; ++run)
+    {
+    scene->SetSaveToXMLString(1);
+    commitTimer.StartRun();
+    scene->Commit();
+    commitTimer.StopRun();
+
+    vtkNew<vtkMRMLScene> importedScene;
+    importedScene->SetLoadFromXMLString(1);
+    importedScene->SetSceneXMLString(scene->GetSceneXMLString());
+    importTimer.StartRun();
+    importedScene->Import();
+    importTimer.StopRun();
+    }
+  addResult(results, benchmarkName("SceneCommit", numberOfNodes), commitTimer.GetBest());
+  addResult(results, benchmarkName("SceneImport", numberOfNodes), importTimer.GetBest());
+}
+
+//-----------------------------------------------------------------------------
+vtkMRMLScalarVolumeNode* addVolume(vtkMRMLScene* scene, vtkMRMLColorTableNode* colorNode, int dimension)
+{
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(dimension, dimension, dimension);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  short* voxelPtr = static_cast<short*>(imageData->GetScalarPointer());
+  vtkIdType numberOfVoxels = imageData->GetNumberOfPoints();
+  for (vtkIdType i = 0; i < numberOfVoxels; ++i)
+    {
+    voxelPtr[i] = static_cast<short>(i % 1000);
+    }
+
+  vtkNew<vtkMRMLScalarVolumeDisplayNode> displayNode;
+  displayNode->SetAutoWindowLevel(false);
+  displayNode->SetWindowLevel(1000., 500.);
+  scene->AddNode(displayNode.GetPointer());
+  displayNode->SetAndObserveColorNodeID(colorNode->GetID());
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(imageData.GetPointer());
+  scene->AddNode(volumeNode.GetPointer());
+  volumeNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+  return volumeNode.GetPointer();
+}
+
+//-----------------------------------------------------------------------------
+void updateConnection(vtkAlgorithmOutput* connection)
+{
+  if (connection && connection->GetProducer())
+    {
+    connection->GetProducer()->Update();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void benchmarkSliceLogic(BenchmarkResultsType& results)
+{
+  const int volumeDimension = 128;
+  const int numberOfSlices = 50;
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLSliceNode::AddDefaultSliceOrientationPresets(scene.GetPointer());
+
+  vtkNew<vtkMRMLColorTableNode> colorNode;
+  colorNode->SetTypeToGrey();
+  scene->AddNode(colorNode.GetPointer());
+
+  vtkNew<vtkMRMLSliceLogic> sliceLogic;
+  sliceLogic->SetName("Red");
+  sliceLogic->SetMRMLScene(scene.GetPointer());
+  sliceLogic->ResizeSliceNode(512, 512);
+
+  vtkNew<vtkMRMLSliceLayerLogic> backgroundLayer;
+  vtkNew<vtkMRMLSliceLayerLogic> foregroundLayer;
+  sliceLogic->SetBackgroundLayer(backgroundLayer.GetPointer());
+  sliceLogic->SetForegroundLayer(foregroundLayer.GetPointer());
+
+  vtkMRMLScalarVolumeNode* backgroundVolume = addVolume(scene.GetPointer(), colorNode.GetPointer(), volumeDimension);
+  vtkMRMLScalarVolumeNode* foregroundVolume = addVolume(scene.GetPointer(), colorNode.GetPointer(), volumeDimension);
+  vtkMRMLSliceCompositeNode* sliceCompositeNode = sliceLogic->GetSliceCompositeNode();
+  sliceCompositeNode->SetBackgroundVolumeID(backgroundVolume->GetID());
+  sliceCompositeNode->SetForegroundVolumeID(foregroundVolume->GetID());
+  sliceCompositeNode->SetForegroundOpacity(0.5);
+  updateConnection(sliceLogic->GetImageDataConnection());
+
+  BenchmarkTimer backgroundTimer;
+  BenchmarkTimer foregroundTimer;
+  BenchmarkTimer blendTimer;
+  for (int run = 0; run < NUMBER_OF_RUNS; ++run)
+    {
+    double backgroundTime = 0.;
+    double foregroundTime = 0.;
+    double blendTime = 0.;
+    for (int slice = 0; slice < numberOfSlices; ++slice)
+      {
+      sliceLogic->SetSliceOffset(slice - numberOfSlices / 2);
+      // Layers are updated one by one so that the last update only blends
+      double start = vtkTimerLog::GetUniversalTime();
+      updateConnection(backgroundLayer->GetImageDataConnection());
+      double backgroundEnd = vtkTimerLog::GetUniversalTime();
+      updateConnection(foregroundLayer->GetImageDataConnection());
+      double foregroundEnd = vtkTimerLog::GetUniversalTime();
+      updateConnection(sliceLogic->GetImageDataConnection());
+      double blendEnd = vtkTimerLog::GetUniversalTime();
+      backgroundTime += backgroundEnd - start;
+      foregroundTime += foregroundEnd - backgroundEnd;
+      blendTime += blendEnd - foregroundEnd;
+      }
+    backgroundTimer.AddRun(backgroundTime);
+    foregroundTimer.AddRun(foregroundTime);
+    blendTimer.AddRun(blendTime);
+    }
+  addResult(results, benchmarkName("SliceResliceBackground", numberOfSlices), backgroundTimer.GetBest());
+  addResult(results, benchmarkName("SliceResliceForeground", numberOfSlices), foregroundTimer.GetBest());
+  addResult(results, benchmarkName("SliceBlend", numberOfSlices), blendTimer.GetBest());
+}
+
+//-----------------------------------------------------------------------------
+vtkOrientedImageData* createSphereLabelmap(int dimension, double radiusFactor)
+{
+  vtkOrientedImageData* labelmap = vtkOrientedImageData::New();
+  labelmap->SetDimensions(dimension, dimension, dimension);
+  labelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char* voxelPtr = static_cast<unsigned char*>(labelmap->GetScalarPointer());
+  double center = (dimension - 1) / 2.;
+  double radius = dimension * radiusFactor;
+  for (int k = 0; k < dimension; ++k)
+    {
+    for (int j = 0; j < dimension; ++j)
+      {
+      for (int i = 0; i < dimension; ++i)
+        {
+        double distance2 = (i - center) * (i - center) + (j - center) * (j - center) + (k - center) * (k - center);
+        *(voxelPtr++) = (distance2 <= radius * radius ? 1 : 0);
+        }
+      }
+    }
+  return labelmap;
+}
+
+//-----------------------------------------------------------------------------
+void benchmarkSegmentation(BenchmarkResultsType& results)
+{
+  const int labelmapDimension = 128;
+
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkBinaryLabelmapToClosedSurfaceConversionRule>::New());
+
+  vtkSmartPointer<vtkOrientedImageData> labelmap = vtkSmartPointer<vtkOrientedImageData>::Take(
+    createSphereLabelmap(labelmapDimension, 0.4));
+  vtkNew<vtkSegment> segment;
+  segment->AddRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), labelmap);
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetMasterRepresentationName(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName());
+  segmentation->AddSegment(segment.GetPointer());
+
+  BenchmarkTimer conversionTimer;
+  for (int run = 0; run < NUMBER_OF_RUNS; ++run)
+    {
+    conversionTimer.StartRun();
+    segmentation->CreateRepresentation(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName(), true);
+    conversionTimer.StopRun();
+    }
+  addResult(results, benchmarkName("SegmentationLabelmapToClosedSurface", labelmapDimension), conversionTimer.GetBest());
+
+  // Paint a smaller sphere into the labelmap, as the segment editor effects do
+  vtkSmartPointer<vtkOrientedImageData> modifierLabelmap = vtkSmartPointer<vtkOrientedImageData>::Take(
+    createSphereLabelmap(labelmapDimension, 0.2));
+  BenchmarkTimer modifyTimer;
+  for (int run = 0; run < NUMBER_OF_RUNS; ++run)
+    {
+    modifyTimer.StartRun();
+    vtkOrientedImageDataResample::ModifyImage(labelmap, modifierLabelmap, vtkOrientedImageDataResample::OPERATION_MAXIMUM);
+    modifyTimer.StopRun();
+    }
+  addResult(results, benchmarkName("ModifyImage", labelmapDimension), modifyTimer.GetBest());
+}
+
+//-----------------------------------------------------------------------------
+void benchmarkTransformChain(BenchmarkResultsType& results)
+{
+  const int chainLength = 100;
+  const int numberOfEvaluations = 1000;
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLLinearTransformNode* parentTransformNode = NULL;
+  for (int i = 0; i < chainLength; ++i)
+    {
+    vtkNew<vtkMatrix4x4> matrix;
+    matrix->SetElement(0, 3, 1.);
+    vtkNew<vtkMRMLLinearTransformNode> transformNode;
+    transformNode->SetMatrixTransformToParent(matrix.GetPointer());
+    scene->AddNode(transformNode.GetPointer());
+    if (parentTransformNode)
+      {
+      transformNode->SetAndObserveTransformNodeID(parentTransformNode->GetID());
+      }
+    parentTransformNode = transformNode.GetPointer();
+    }
+
+  BenchmarkTimer matrixTimer;
+  BenchmarkTimer generalTimer;
+  vtkNew<vtkMatrix4x4> matrixToWorld;
+  for (int run = 0; run < NUMBER_OF_RUNS; ++run)
+    {
+    matrixTimer.StartRun();
+    for (int i = 0; i < numberOfEvaluations; ++i)
+      {
+      parentTransformNode->GetMatrixTransformToWorld(matrixToWorld.GetPointer());
+      }
+    matrixTimer.StopRun();
+
+    generalTimer.StartRun();
+    for (int i = 0; i < numberOfEvaluations; ++i)
+      {
+      vtkNew<vtkGeneralTransform> transformToWorld;
+      parentTransformNode->GetTransformToWorld(transformToWorld.GetPointer());
+      double point[3] = { 0., 0., 0. };
+      transformToWorld->TransformPoint(point, point);
+      }
+    generalTimer.StopRun();
+    }
+  addResult(results, benchmarkName("TransformChainMatrixToWorld", chainLength), matrixTimer.GetBest());
+  addResult(results, benchmarkName("TransformChainGeneralToWorld", chainLength), generalTimer.GetBest());
+}
+
+//-----------------------------------------------------------------------------
+bool writeResults(const std::string& fileName, const BenchmarkResultsType& results)
+{
+  std::ofstream output(fileName.c_str());
+  if (!output.is_open())
+    {
+    return false;
+    }
+  output << "{\n  \"benchmarks\": {\n";
+  for (BenchmarkResultsType::const_iterator resultIt = results.begin(); resultIt != results.end(); ++resultIt)
+    {
+    output << "    \"" << resultIt->first << "\": " << resultIt->second
+           << (resultIt + 1 != results.end() ? ",\n" : "\n");
+    }
+  output << "  }\n}\n";
+  return output.good();
+}
+
+//-----------------------------------------------------------------------------
+// Read a file written by writeResults(): one "name": seconds pair per line
+bool readResults(const std::string& fileName, std::map<std::string, double>& results)
+{
+  std::ifstream input(fileName.c_str());
+  if (!input.is_open())
+    {
+    return false;
+    }
+  std::string line;
+  while (std::getline(input, line))
+    {
+    std::string::size_type nameStart = line.find('"');
+    std::string::size_type nameEnd = line.find('"', nameStart + 1);
+    std::string::size_type separator = line.find(':', nameEnd);
+    if (nameStart == std::string::npos || nameEnd == std::string::npos || separator == std::string::npos)
+      {
+      continue;
+      }
+    std::stringstream ss(line.substr(separator + 1));
+    double seconds = 0.;
+    if (ss >> seconds)
+      {
+      results[line.substr(nameStart + 1, nameEnd - nameStart - 1)] = seconds;
+      }
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkMRMLPerformanceTest1(int argc, char* argv[])
+{
+  int maxNumberOfNodes = 10000;
+  std::string resultsFileName;
+  std::string baselineFileName;
+  double tolerance = 0.5;
+  for (int i = 1; i + 1 < argc; i += 2)
+    {
+    std::string option = argv[i];
+    if (option == "-n")
+      {
+      maxNumberOfNodes = atoi(argv[i + 1]);
+      }
+    else if (option == "-o")
+      {
+      resultsFileName = argv[i + 1];
+      }
+    else if (option == "-b")
+      {
+      baselineFileName = argv[i + 1];
+      }
+    else if (option == "-t")
+      {
+      tolerance = atof(argv[i + 1]);
+      }
+    else
+      {
+      std::cerr << "Usage: " << argv[0] << " [-n maxNodes] [-o results.json] [-b baseline.json] [-t tolerance]" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  BenchmarkResultsType results;
+  for (int numberOfNodes = 1000; numberOfNodes <= maxNumberOfNodes; numberOfNodes *= 10)
+    {
+    benchmarkSceneNodes(numberOfNodes, results);
+    benchmarkSceneCommitImport(numberOfNodes, results);
+    }
+  benchmarkSliceLogic(results);
+  benchmarkSegmentation(results);
+  benchmarkTransformChain(results);
+
+  if (!resultsFileName.empty() && !writeResults(resultsFileName, results))
+    {
+    std::cerr << "Failed to write benchmark results to " << resultsFileName << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (baselineFileName.empty())
+    {
+    return EXIT_SUCCESS;
+    }
+  std::map<std::string, double> baseline;
+  if (!readResults(baselineFileName, baseline))
+    {
+    std::cerr << "Failed to read benchmark baseline " << baselineFileName << std::endl;
+    return EXIT_FAILURE;
+    }
+  bool regression = false;
+  for (BenchmarkResultsType::const_iterator resultIt = results.begin(); resultIt != results.end(); ++resultIt)
+    {
+    std::map<std::string, double>::iterator baselineIt = baseline.find(resultIt->first);
+    if (baselineIt == baseline.end())
+      {
+      continue;
+      }
+    if (resultIt->second > baselineIt->second * (1. + tolerance))
+      {
+      std::cerr << "Performance regression in " << resultIt->first << ": " << resultIt->second
+                << " s, baseline: " << baselineIt->second << " s" << std::endl;
+      regression = true;
+      }
+    }
+  return regression ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -39,6 +39,7 @@
 namespace
 {
 bool testDTIPipeline();
+int testDataProbe();
 }
 
 //----------------------------------------------------------------------------
@@ -73,6 +74,7 @@ int vtkMRMLSliceLayerLogicTest(int , char * [] )
 
   bool res = true;
   res = res && testDTIPipeline();
+  res = res && (testDataProbe() == EXIT_SUCCESS);
   return res ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
@@ -136,4 +138,56 @@ bool testDTIPipeline()
   return true;
 }
 
+//----------------------------------------------------------------------------
+int testDataProbe()
+{
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(3,3,3);
+  imageData->AllocateScalars(VTK_FLOAT, 1);
+  imageData->GetPointData()->GetScalars()->FillComponent(0, 0.);
+  imageData->SetScalarComponentFromDouble(1, 2, 2, 0, 2.5);
+  imageData->SetScalarComponentFromDouble(2, 0, 0, 0, 7.);
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetOrigin(10., 0., 0.);
+  volumeNode->SetAndObserveImageData(imageData.GetPointer());
+
+  vtkNew<vtkMRMLSliceLayerLogic> logic;
+  int ijk[3] = {-1, -1, -1};
+  double xyz[3] = {11.4, 1.6, 2.};
+  if (logic->GetIJKAtXY(xyz, ijk) || ijk[0] != 0 || ijk[1] != 0 || ijk[2] != 0)
+    {
+    std::cerr << "Line " << __LINE__ << " - GetIJKAtXY failed without volume" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  logic->SetVolumeNode(volumeNode.GetPointer());
+  logic->UpdateTransforms();
+  // There is no slice node, XY is the same as RAS
+  if (!logic->GetIJKAtXY(xyz, ijk) || ijk[0] != 1 || ijk[1] != 2 || ijk[2] != 2)
+    {
+    std::cerr << "Line " << __LINE__ << " - GetIJKAtXY failed: "
+              << ijk[0] << ", " << ijk[1] << ", " << ijk[2] << std::endl;
+    return EXIT_FAILURE;
+    }
+  CHECK_STD_STRING(logic->GetPixelDescriptionAtIJK(ijk), "2.5");
+
+  int ijk2[3] = {2, 0, 0};
+  CHECK_STD_STRING(logic->GetPixelDescriptionAtIJK(ijk2), "7");
+
+  int outside[3] = {3, 0, 0};
+  CHECK_STD_STRING(logic->GetPixelDescriptionAtIJK(outside), "Out of Frame");
+
+  // Cached matrix is updated when the volume moves
+  volumeNode->SetOrigin(11., 0., 0.);
+  logic->UpdateTransforms();
+  if (!logic->GetIJKAtXY(xyz, ijk) || ijk[0] != 0)
+    {
+    std::cerr << "Line " << __LINE__ << " - GetIJKAtXY failed after volume origin change: "
+              << ijk[0] << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+
 }
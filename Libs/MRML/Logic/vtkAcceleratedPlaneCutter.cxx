@@ -0,0 +1,394 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#include "vtkAcceleratedPlaneCutter.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCutter.h>
+#include <vtkDataSet.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPlane.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkTriangleFilter.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <utility>
+
+namespace
+{
+
+/// Maximum number of slabs of the triangle index
+const vtkIdType MAXIMUM_NUMBER_OF_SLABS = 65536;
+
+//----------------------------------------------------------------------------
+/// Intersection points of the cut, by mesh edge. Vertices that lie exactly
+/// on the plane are stored with an edge that starts and ends at the vertex,
+/// so that all the triangles sharing the vertex use the same output point.
+class EdgePointLocator
+{
+public:
+  EdgePointLocator(vtkPoints* inPoints, vtkPointData* inPD,
+    vtkPoints* outPoints, vtkPointData* outPD)
+    : InPoints(inPoints), InPD(inPD), OutPoints(outPoints), OutPD(outPD)
+    {
+    }
+
+  vtkIdType GetPoint(vtkIdType p0, double s0, vtkIdType p1, double s1)
+    {
+    // Always interpolate from the lower point ID so that both triangles
+    // sharing an edge compute the same point
+    if (p1 < p0)
+      {
+      std::swap(p0, p1);
+      std::swap(s0, s1);
+      }
+    double t = s0 / (s0 - s1);
+    if (s0 == 0.0)
+      {
+      p1 = p0;
+      t = 0.0;
+      }
+    else if (s1 == 0.0)
+      {
+      p0 = p1;
+      t = 0.0;
+      }
+    std::pair<vtkIdType, vtkIdType> edge(p0, p1);
+    std::map< std::pair<vtkIdType, vtkIdType>, vtkIdType >::iterator edgeIt = this->Points.find(edge);
+    if (edgeIt != this->Points.end())
+      {
+      return edgeIt->second;
+      }
+    double x0[3] = { 0.0, 0.0, 0.0 };
+    double x1[3] = { 0.0, 0.0, 0.0 };
+    this->InPoints->GetPoint(p0, x0);
+    this->InPoints->GetPoint(p1, x1);
+    double x[3] = { x0[0] + t * (x1[0] - x0[0]), x0[1] + t * (x1[1] - x0[1]), x0[2] + t * (x1[2] - x0[2]) };
+    vtkIdType pointId = this->OutPoints->InsertNextPoint(x);
+    this->OutPD->InterpolateEdge(this->InPD, pointId, p0, p1, t);
+    this->Points[edge] = pointId;
+    return pointId;
+    }
+
+private:
+  vtkPoints* InPoints;
+  vtkPointData* InPD;
+  vtkPoints* OutPoints;
+  vtkPointData* OutPD;
+  std::map< std::pair<vtkIdType, vtkIdType>, vtkIdType > Points;
+};
+
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkAcceleratedPlaneCutter);
+vtkCxxSetObjectMacro(vtkAcceleratedPlaneCutter, Plane, vtkPlane);
+
+//----------------------------------------------------------------------------
+vtkAcceleratedPlaneCutter::vtkAcceleratedPlaneCutter()
+{
+  this->Plane = NULL;
+  this->Cutter = vtkSmartPointer<vtkCutter>::New();
+  this->IndexNormal[0] = 0.0;
+  this->IndexNormal[1] = 0.0;
+  this->IndexNormal[2] = 0.0;
+  this->IndexInput = NULL;
+  this->IndexValid = false;
+  this->IndexRange[0] = 0.0;
+  this->IndexRange[1] = 0.0;
+  this->SlabOrigin = 0.0;
+  this->SlabWidth = 1.0;
+}
+
+//----------------------------------------------------------------------------
+vtkAcceleratedPlaneCutter::~vtkAcceleratedPlaneCutter()
+{
+  this->SetPlane(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkAcceleratedPlaneCutter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Plane: " << this->Plane << "\n";
+  os << indent << "IndexValid: " << this->IndexValid << "\n";
+  os << indent << "NumberOfSlabs: " << (this->SlabOffsets.empty() ? 0 : this->SlabOffsets.size() - 1) << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkAcceleratedPlaneCutter::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->Plane)
+    {
+    mTime = std::max(mTime, this->Plane->GetMTime());
+    }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkAcceleratedPlaneCutter::FillInputPortInformation(int vtkNotUsed(port), vtkInformation* info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkAcceleratedPlaneCutter::RequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkDataSet* input = vtkDataSet::GetData(inputVector[0]);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector);
+  if (!input || !output)
+    {
+    return 0;
+    }
+  if (!this->Plane)
+    {
+    vtkErrorMacro("RequestData: no plane specified");
+    return 0;
+    }
+
+  double normal[3] = { 0.0, 0.0, 0.0 };
+  this->Plane->GetNormal(normal);
+  if (vtkMath::Normalize(normal) == 0.0)
+    {
+    vtkErrorMacro("RequestData: invalid plane normal");
+    return 0;
+    }
+
+  if (!this->IndexValid || this->IndexInput != input || this->IndexTime < input->GetMTime()
+    || normal[0] != this->IndexNormal[0] || normal[1] != this->IndexNormal[1] || normal[2] != this->IndexNormal[2])
+    {
+    this->IndexValid = this->BuildIndex(input, normal);
+    this->IndexInput = input;
+    this->IndexNormal[0] = normal[0];
+    this->IndexNormal[1] = normal[1];
+    this->IndexNormal[2] = normal[2];
+    this->IndexTime.Modified();
+    }
+
+  if (!this->IndexValid)
+    {
+    // Not a surface mesh, use the generic cutter
+    this->Cutter->SetCutFunction(this->Plane);
+    this->Cutter->SetInputData(input);
+    this->Cutter->Update();
+    output->ShallowCopy(this->Cutter->GetOutput());
+    return 1;
+    }
+
+  this->CutIndexedTriangles(vtkMath::Dot(normal, this->Plane->GetOrigin()), output);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkAcceleratedPlaneCutter::BuildIndex(vtkDataSet* input, const double normal[3])
+{
+  this->Triangles = NULL;
+  this->PointPositions.clear();
+  this->TrianglePoints.clear();
+  this->TriangleRanges.clear();
+  this->SlabOffsets.clear();
+  this->SlabTriangles.clear();
+
+  vtkPolyData* polyData = vtkPolyData::SafeDownCast(input);
+  if (!polyData || !polyData->GetPoints()
+    || polyData->GetNumberOfVerts() > 0 || polyData->GetNumberOfLines() > 0
+    || polyData->GetNumberOfPolys() + polyData->GetNumberOfStrips() == 0)
+    {
+    return false;
+    }
+
+  // Triangulate the input if it contains strips or polygons that are not triangles
+  bool trianglesOnly = (polyData->GetNumberOfStrips() == 0);
+  vtkIdType npts = 0;
+  vtkIdType* pts = NULL;
+  vtkCellArray* polys = polyData->GetPolys();
+  for (polys->InitTraversal(); trianglesOnly && polys->GetNextCell(npts, pts); )
+    {
+    trianglesOnly = (npts == 3);
+    }
+  if (trianglesOnly)
+    {
+    this->Triangles = polyData;
+    }
+  else
+    {
+    vtkSmartPointer<vtkPolyData> inputCopy = vtkSmartPointer<vtkPolyData>::New();
+    inputCopy->ShallowCopy(polyData);
+    vtkNew<vtkTriangleFilter> triangleFilter;
+    triangleFilter->SetInputData(inputCopy);
+    triangleFilter->PassVertsOff();
+    triangleFilter->PassLinesOff();
+    triangleFilter->Update();
+    this->Triangles = triangleFilter->GetOutput();
+    }
+
+  // Position of the points along the normal
+  vtkPoints* points = this->Triangles->GetPoints();
+  vtkIdType numberOfPoints = points->GetNumberOfPoints();
+  this->PointPositions.resize(numberOfPoints);
+  for (vtkIdType pointId = 0; pointId < numberOfPoints; ++pointId)
+    {
+    double x[3] = { 0.0, 0.0, 0.0 };
+    points->GetPoint(pointId, x);
+    this->PointPositions[pointId] = vtkMath::Dot(normal, x);
+    }
+
+  // Range of the triangles along the normal
+  vtkIdType numberOfTriangles = this->Triangles->GetNumberOfPolys();
+  this->TrianglePoints.reserve(3 * numberOfTriangles);
+  this->TriangleRanges.reserve(2 * numberOfTriangles);
+  double totalTriangleExtent = 0.0;
+  this->IndexRange[0] = VTK_DOUBLE_MAX;
+  this->IndexRange[1] = -VTK_DOUBLE_MAX;
+  polys = this->Triangles->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); )
+    {
+    double range[2] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+    for (int i = 0; i < 3; ++i)
+      {
+      this->TrianglePoints.push_back(pts[i]);
+      range[0] = std::min(range[0], this->PointPositions[pts[i]]);
+      range[1] = std::max(range[1], this->PointPositions[pts[i]]);
+      }
+    this->TriangleRanges.push_back(range[0]);
+    this->TriangleRanges.push_back(range[1]);
+    totalTriangleExtent += range[1] - range[0];
+    this->IndexRange[0] = std::min(this->IndexRange[0], range[0]);
+    this->IndexRange[1] = std::max(this->IndexRange[1], range[1]);
+    }
+  if (numberOfTriangles == 0)
+    {
+    this->IndexRange[0] = 0.0;
+    this->IndexRange[1] = -1.0;
+    this->SlabOffsets.resize(2, 0);
+    return true;
+    }
+
+  // Make the slabs about as thick as the triangles, so that each triangle is
+  // stored in only a few slabs and each slab contains only a few triangles
+  double meshExtent = this->IndexRange[1] - this->IndexRange[0];
+  double averageTriangleExtent = totalTriangleExtent / numberOfTriangles;
+  vtkIdType numberOfSlabs = 1;
+  if (averageTriangleExtent > 0.0)
+    {
+    numberOfSlabs = static_cast<vtkIdType>(meshExtent / averageTriangleExtent);
+    }
+  numberOfSlabs = std::max(vtkIdType(1), std::min(numberOfSlabs, std::min(numberOfTriangles, MAXIMUM_NUMBER_OF_SLABS)));
+  this->SlabOrigin = this->IndexRange[0];
+  this->SlabWidth = (meshExtent > 0.0 ? meshExtent / numberOfSlabs : 1.0);
+
+  // Store the triangles by slab (first count, then fill)
+  this->SlabOffsets.resize(numberOfSlabs + 1, 0);
+  for (vtkIdType triangleId = 0; triangleId < numberOfTriangles; ++triangleId)
+    {
+    vtkIdType firstSlab = std::min(numberOfSlabs - 1,
+      static_cast<vtkIdType>((this->TriangleRanges[2 * triangleId] - this->SlabOrigin) / this->SlabWidth));
+    vtkIdType lastSlab = std::min(numberOfSlabs - 1,
+      static_cast<vtkIdType>((this->TriangleRanges[2 * triangleId + 1] - this->SlabOrigin) / this->SlabWidth));
+    for (vtkIdType slab = firstSlab; slab <= lastSlab; ++slab)
+      {
+      ++this->SlabOffsets[slab + 1];
+      }
+    }
+  for (vtkIdType slab = 0; slab < numberOfSlabs; ++slab)
+    {
+    this->SlabOffsets[slab + 1] += this->SlabOffsets[slab];
+    }
+  this->SlabTriangles.resize(this->SlabOffsets[numberOfSlabs]);
+  std::vector<vtkIdType> slabFill(this->SlabOffsets.begin(), this->SlabOffsets.end() - 1);
+  for (vtkIdType triangleId = 0; triangleId < numberOfTriangles; ++triangleId)
+    {
+    vtkIdType firstSlab = std::min(numberOfSlabs - 1,
+      static_cast<vtkIdType>((this->TriangleRanges[2 * triangleId] - this->SlabOrigin) / this->SlabWidth));
+    vtkIdType lastSlab = std::min(numberOfSlabs - 1,
+      static_cast<vtkIdType>((this->TriangleRanges[2 * triangleId + 1] - this->SlabOrigin) / this->SlabWidth));
+    for (vtkIdType slab = firstSlab; slab <= lastSlab; ++slab)
+      {
+      this->SlabTriangles[slabFill[slab]++] = triangleId;
+      }
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkAcceleratedPlaneCutter::CutIndexedTriangles(double planeOffset, vtkPolyData* output)
+{
+  vtkPoints* inPoints = this->Triangles->GetPoints();
+  vtkPointData* inPD = this->Triangles->GetPointData();
+  vtkCellData* inCD = this->Triangles->GetCellData();
+
+  vtkSmartPointer<vtkPoints> outPoints = vtkSmartPointer<vtkPoints>::New();
+  outPoints->SetDataType(inPoints->GetDataType());
+  vtkSmartPointer<vtkCellArray> outLines = vtkSmartPointer<vtkCellArray>::New();
+  vtkPointData* outPD = output->GetPointData();
+  vtkCellData* outCD = output->GetCellData();
+  outPD->InterpolateAllocate(inPD);
+  outCD->CopyAllocate(inCD);
+
+  if (planeOffset >= this->IndexRange[0] && planeOffset <= this->IndexRange[1])
+    {
+    vtkIdType numberOfSlabs = static_cast<vtkIdType>(this->SlabOffsets.size()) - 1;
+    vtkIdType slab = std::min(numberOfSlabs - 1,
+      static_cast<vtkIdType>((planeOffset - this->SlabOrigin) / this->SlabWidth));
+    EdgePointLocator locator(inPoints, inPD, outPoints, outPD);
+    for (vtkIdType i = this->SlabOffsets[slab]; i < this->SlabOffsets[slab + 1]; ++i)
+      {
+      vtkIdType triangleId = this->SlabTriangles[i];
+      if (this->TriangleRanges[2 * triangleId] > planeOffset || this->TriangleRanges[2 * triangleId + 1] < planeOffset)
+        {
+        continue;
+        }
+      const vtkIdType* trianglePoints = &this->TrianglePoints[3 * triangleId];
+      double s[3] = { 0.0, 0.0, 0.0 };
+      for (int k = 0; k < 3; ++k)
+        {
+        s[k] = this->PointPositions[trianglePoints[k]] - planeOffset;
+        }
+      // Points on the plane are considered to be above it, so that a cut
+      // crosses exactly zero or two edges of each triangle
+      vtkIdType linePoints[2] = { 0, 0 };
+      int numberOfLinePoints = 0;
+      for (int k = 0; k < 3; ++k)
+        {
+        int k1 = (k + 1) % 3;
+        if ((s[k] >= 0.0) != (s[k1] >= 0.0))
+          {
+          linePoints[numberOfLinePoints++] = locator.GetPoint(trianglePoints[k], s[k], trianglePoints[k1], s[k1]);
+          }
+        }
+      if (numberOfLinePoints != 2 || linePoints[0] == linePoints[1])
+        {
+        continue;
+        }
+      vtkIdType lineId = outLines->InsertNextCell(2, linePoints);
+      outCD->CopyData(inCD, triangleId, lineId);
+      }
+    }
+
+  output->SetPoints(outPoints);
+  output->SetLines(outLines);
+  output->Squeeze();
+}
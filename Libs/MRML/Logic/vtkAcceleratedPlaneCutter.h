@@ -0,0 +1,99 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#ifndef __vtkAcceleratedPlaneCutter_h
+#define __vtkAcceleratedPlaneCutter_h
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkMRMLLogicWin32Header.h"
+
+// STD includes
+#include <vector>
+
+class vtkCutter;
+class vtkPlane;
+class vtkPolyData;
+
+/// \brief Cut a surface mesh with a plane, using an index built once per mesh.
+///
+/// Computes the same intersection lines as vtkCutter for surface meshes, but
+/// only visits the triangles that may intersect the plane. The first cut
+/// sorts the triangles into slabs along the plane normal. The index is kept
+/// until the input or the direction of the plane normal changes, therefore
+/// moving the plane along its normal (as scrolling through slices does) only
+/// touches the triangles near the plane.
+/// Point and cell data are interpolated and copied the same way as vtkCutter does.
+/// Inputs that are not surface meshes (for example unstructured grids or
+/// polydata with vertices or lines) are cut by an internal vtkCutter.
+class VTK_MRML_LOGIC_EXPORT vtkAcceleratedPlaneCutter : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkAcceleratedPlaneCutter *New();
+  vtkTypeMacro(vtkAcceleratedPlaneCutter, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  /// Plane used for cutting the input.
+  virtual void SetPlane(vtkPlane* plane);
+  vtkGetObjectMacro(Plane, vtkPlane);
+
+  /// Include the plane modification time.
+  virtual vtkMTimeType GetMTime();
+
+protected:
+  vtkAcceleratedPlaneCutter();
+  ~vtkAcceleratedPlaneCutter();
+
+  virtual int FillInputPortInformation(int port, vtkInformation* info);
+  virtual int RequestData(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector);
+
+  /// Rebuild the triangle index for the current input and plane normal.
+  /// Returns false if the input is not a surface mesh.
+  bool BuildIndex(vtkDataSet* input, const double normal[3]);
+
+  /// Cut the indexed triangles with the plane at the given offset along the normal.
+  void CutIndexedTriangles(double planeOffset, vtkPolyData* output);
+
+  vtkPlane* Plane;
+  vtkSmartPointer<vtkCutter> Cutter;
+
+  /// Triangles of the input (the input itself if it only contains triangles)
+  vtkSmartPointer<vtkPolyData> Triangles;
+  /// Normal that the index was built for
+  double IndexNormal[3];
+  /// Input that the index was built for
+  vtkDataSet* IndexInput;
+  vtkTimeStamp IndexTime;
+  bool IndexValid;
+
+  /// Position of each point along the normal
+  std::vector<double> PointPositions;
+  /// Point IDs of each triangle
+  std::vector<vtkIdType> TrianglePoints;
+  /// Range of each triangle along the normal
+  std::vector<double> TriangleRanges;
+  double IndexRange[2];
+  /// Slab boundaries and triangles in each slab (slab i contains
+  /// SlabTriangles[SlabOffsets[i]] ... SlabTriangles[SlabOffsets[i+1]-1])
+  double SlabOrigin;
+  double SlabWidth;
+  std::vector<vtkIdType> SlabOffsets;
+  std::vector<vtkIdType> SlabTriangles;
+
+private:
+  vtkAcceleratedPlaneCutter(const vtkAcceleratedPlaneCutter&);  // Not implemented.
+  void operator=(const vtkAcceleratedPlaneCutter&);  // Not implemented.
+};
+
+#endif
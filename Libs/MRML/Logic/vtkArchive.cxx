@@ -20,7 +20,10 @@
 
 // STD includes
 #include <cstring>
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 
 namespace
 {
@@ -58,6 +61,41 @@ public:
   }
 };
 
+// --------------------------------------------------------------------------
+// Returns true if the file content is already compressed, therefore
+// deflating it again would take time without making the archive smaller.
+bool is_compressed_file(const std::string& fileName)
+{
+  static const char* compressedExtensions[] = {
+    ".gz", ".bz2", ".xz", ".zip", ".mrb", ".png", ".jpg", ".jpeg", ".mp4", 0 };
+  std::string lowerFileName = vtksys::SystemTools::LowerCase(fileName);
+  for (const char** extension = compressedExtensions; *extension; ++extension)
+    {
+    if (vtksys::SystemTools::StringEndsWith(lowerFileName, *extension))
+      {
+      return true;
+      }
+    }
+  if (!vtksys::SystemTools::StringEndsWith(lowerFileName, ".nrrd"))
+    {
+    return false;
+    }
+  // Attached header NRRD files are compressed if the encoding is gzip or bzip2
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  std::string line;
+  // the header ends at the first empty line
+  for (int lineIndex = 0; lineIndex < 1000 && std::getline(file, line) && !line.empty() && line != "\r"; ++lineIndex)
+    {
+    if (line.compare(0, 9, "encoding:") == 0)
+      {
+      std::string encoding = vtksys::SystemTools::LowerCase(line.substr(9));
+      return encoding.find("gz") != std::string::npos || encoding.find("bz2") != std::string::npos
+        || encoding.find("bzip2") != std::string::npos;
+      }
+    }
+  return false;
+}
+
 // --------------------------------------------------------------------------
 #define BSDTAR_FILESIZE_PRINTF  "%lu"
 #define BSDTAR_FILESIZE_TYPE    unsigned long
@@ -344,7 +382,7 @@ bool extract_tar(const char* tarFileName, bool verbose, bool extract, std::vecto
 //-----------------------------------------------------------------------------
 // creates a zip file with the full contents of the directory (recurses)
 // zip entries will include relative path of including tail of directoryToZip
-bool zip(const char* zipFileName, const char* directoryToZip)
+bool zip(const char* zipFileName, const char* directoryToZip, int compressionLevel)
 {
 
   //
@@ -386,7 +424,10 @@ bool zip(const char* zipFileName, const char* directoryToZip)
   // now zip it up using LibArchive
   struct archive *zipArchive;
   struct archive_entry *entry, *dirEntry;
-  char buff[BUFSIZ];
+  // Copy the files in large blocks: bundles of large volumes are several GB
+  // and small reads dominate the time spent storing already compressed files.
+  const size_t copyBlockSize = 1024 * 1024;
+  std::vector<char> buff(copyBlockSize);
   size_t len;
   // have to read the contents of the files to add them to the archive
   FILE *fd;
@@ -402,9 +443,29 @@ bool zip(const char* zipFileName, const char* directoryToZip)
 
   archive_write_set_format_zip(zipArchive);
 
+  if (compressionLevel == 0)
+    {
+    compression_type = "store";
+    }
   archive_write_set_format_option(zipArchive, "zip", "compression", compression_type.c_str());
+#if ARCHIVE_VERSION_NUMBER >= 3002000
+  if (compressionLevel > 0 && compression_type == "deflate")
+    {
+    std::stringstream compressionLevelStr;
+    compressionLevelStr << std::min(compressionLevel, 9);
+    archive_write_set_format_option(zipArchive, "zip", "compression-level", compressionLevelStr.str().c_str());
+    }
+#endif
 
-  archive_write_open_filename(zipArchive, zipFileName);
+  // write the archive in blocks of the same size instead of the default 10 kB
+  archive_write_set_bytes_per_block(zipArchive, static_cast<int>(copyBlockSize));
+  archive_write_set_bytes_in_last_block(zipArchive, 1);
+  if (archive_write_open_filename(zipArchive, zipFileName) != ARCHIVE_OK)
+    {
+    vtkArchiveTools::Error("Zip: cannot create:", archive_error_string(zipArchive));
+    archive_write_free(zipArchive);
+    return false;
+    }
 
   // add the data directory
   dirEntry = archive_entry_new();
@@ -441,6 +502,12 @@ bool zip(const char* zipFileName, const char* directoryToZip)
     archive_entry_set_size(entry, fileLength);
     archive_entry_set_filetype(entry, AE_IFREG);
     archive_entry_set_perm(entry, 0644);
+    // already compressed files are stored, deflating them again only costs time
+    if (compression_type == "deflate")
+      {
+      archive_write_set_format_option(zipArchive, "zip", "compression",
+        is_compressed_file(fileName) ? "store" : "deflate");
+      }
     archive_write_header(zipArchive, entry);
 
     //
@@ -449,15 +516,19 @@ bool zip(const char* zipFileName, const char* directoryToZip)
     fd = fopen(fileName, "rb");
     if (!fd)
       {
-      vtkArchiveTools::Error("Zip: cannot open:", (*sit).c_str());
+      vtkArchiveTools::Error("Zip: cannot open:", fileName);
       }
     else
       {
-      len = fread(buff, sizeof(char), sizeof(buff), fd);
+      len = fread(&buff[0], sizeof(char), buff.size(), fd);
       while ( len > 0 )
         {
-        archive_write_data(zipArchive, buff, len);
-        len = fread(buff, sizeof(char), sizeof(buff), fd);
+        if (archive_write_data(zipArchive, &buff[0], len) < 0)
+          {
+          vtkArchiveTools::Error("Zip: cannot write:", archive_error_string(zipArchive));
+          break;
+          }
+        len = fread(&buff[0], sizeof(char), buff.size(), fd);
         }
       fclose(fd);
       }
@@ -476,7 +547,8 @@ bool zip(const char* zipFileName, const char* directoryToZip)
 
 //-----------------------------------------------------------------------------
 // unzips zip file into destinationDirectory
-bool unzip(const char* zipFileName, const char* destinationDirectory)
+bool unzip(const char* zipFileName, const char* destinationDirectory,
+           std::vector<std::string> * extracted_files)
 {
   //
   // Unziping the archive
@@ -524,8 +596,10 @@ bool unzip(const char* zipFileName, const char* destinationDirectory)
   // we will typically have zip files, but support all archive types (why not?)
   archive_read_support_filter_all(zipArchive);
   archive_read_support_format_all(zipArchive);
-  // Note: the 10240 is just a suggested block size
-  result = archive_read_open_filename(zipArchive, zipFileName, 10240);
+  // Read large blocks: bundles can be several GB, and stored (uncompressed)
+  // entries are copied to disk directly from the read buffer.
+  const size_t readBlockSize = 1024 * 1024;
+  result = archive_read_open_filename(zipArchive, zipFileName, readBlockSize);
   if (result != ARCHIVE_OK)
     {
     vtkArchiveTools::Error("Unzip:", "Cannot open archive file");
@@ -562,6 +636,10 @@ bool unzip(const char* zipFileName, const char* destinationDirectory)
       }
     else
       {
+      if (extracted_files)
+        {
+        extracted_files->push_back(archive_entry_pathname(entry));
+        }
       // copy data
       const void *buff;
       size_t size;
@@ -37,11 +37,20 @@ VTK_MRML_LOGIC_EXPORT bool extract_tar(const char* tarFileName, bool verbose, bo
 
 // creates a zip file with the full contents of the directory (recurses)
 // zip entries will include relative path of including tail of directoryToZip
-VTK_MRML_LOGIC_EXPORT bool zip(const char* zipFileName, const char* directoryToZip);
+// compressionLevel: -1 = default deflate level, 0 = store all files without compression,
+// 1 (fastest) to 9 (smallest). Files that are already compressed (gzip encoded nrrd,
+// png, jpg, gz, ...) are always stored, as deflating them again does not make them smaller.
+// Files are read and the archive is written in 1 MB blocks.
+VTK_MRML_LOGIC_EXPORT bool zip(const char* zipFileName, const char* directoryToZip,
+                               int compressionLevel = -1);
 
 // unzips zip file into specified directory
 // (internally this supports many formats of archive, not just zip)
-VTK_MRML_LOGIC_EXPORT bool unzip(const char* zipFileName, const char *destinationDirectory);
+// The archive is read in a single sequential pass. If extracted_files is
+// not null, the path (relative to destinationDirectory) of each extracted
+// entry is appended to it, so callers do not need to scan the directory.
+VTK_MRML_LOGIC_EXPORT bool unzip(const char* zipFileName, const char *destinationDirectory,
+                                 std::vector<std::string> * extracted_files = 0);
 #ifdef __cplusplus
 }
 #endif
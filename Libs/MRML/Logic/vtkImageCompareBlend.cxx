@@ -0,0 +1,202 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRMLLogic includes
+#include "vtkImageCompareBlend.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkImageCompareBlend);
+
+//----------------------------------------------------------------------------
+vtkImageCompareBlend::vtkImageCompareBlend()
+{
+  this->Mode = Checkerboard;
+  this->CheckerboardSize = 32;
+  this->SwipePosition = 0.5;
+  this->FlickerForeground = 0;
+  this->SetNumberOfInputPorts(2);
+}
+
+//----------------------------------------------------------------------------
+vtkImageCompareBlend::~vtkImageCompareBlend()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkImageCompareBlend::SetBackgroundInputConnection(vtkAlgorithmOutput* input)
+{
+  this->SetInputConnection(0, input);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageCompareBlend::SetForegroundInputConnection(vtkAlgorithmOutput* input)
+{
+  this->SetInputConnection(1, input);
+}
+
+//----------------------------------------------------------------------------
+namespace
+{
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkImageCompareBlendExecute(vtkImageCompareBlend* self,
+                                 vtkImageData* background, vtkImageData* foreground,
+                                 vtkImageData* output, int wholeExtent[6],
+                                 int outExt[6], T*)
+{
+  const int mode = self->GetMode();
+  const int checkerboardSize = self->GetCheckerboardSize();
+  const int swipeColumn = wholeExtent[0] + static_cast<int>(
+    self->GetSwipePosition() * (wholeExtent[1] - wholeExtent[0] + 1) + 0.5);
+  const bool flickerForeground = self->GetFlickerForeground() != 0;
+
+  const int numberOfComponents = output->GetNumberOfScalarComponents();
+  const int foregroundComponents = foreground->GetNumberOfScalarComponents();
+
+  const T* backgroundPtr = static_cast<T*>(background->GetScalarPointerForExtent(outExt));
+  const T* foregroundPtr = static_cast<T*>(foreground->GetScalarPointerForExtent(outExt));
+  T* outPtr = static_cast<T*>(output->GetScalarPointerForExtent(outExt));
+  vtkIdType backgroundIncrements[3];
+  vtkIdType foregroundIncrements[3];
+  vtkIdType outIncrements[3];
+  background->GetContinuousIncrements(outExt,
+    backgroundIncrements[0], backgroundIncrements[1], backgroundIncrements[2]);
+  foreground->GetContinuousIncrements(outExt,
+    foregroundIncrements[0], foregroundIncrements[1], foregroundIncrements[2]);
+  output->GetContinuousIncrements(outExt,
+    outIncrements[0], outIncrements[1], outIncrements[2]);
+
+  for (int k = outExt[4]; k <= outExt[5]; ++k)
+    {
+    for (int j = outExt[2]; j <= outExt[3]; ++j)
+      {
+      const int row = (j - wholeExtent[2]) / checkerboardSize;
+      for (int i = outExt[0]; i <= outExt[1]; ++i)
+        {
+        bool showForeground = false;
+        switch (mode)
+          {
+          case vtkImageCompareBlend::Checkerboard:
+            showForeground = (((i - wholeExtent[0]) / checkerboardSize + row) % 2) == 0;
+            break;
+          case vtkImageCompareBlend::Swipe:
+            showForeground = i < swipeColumn;
+            break;
+          case vtkImageCompareBlend::Flicker:
+            showForeground = flickerForeground;
+            break;
+          default:
+            break;
+          }
+        for (int c = 0; c < numberOfComponents; ++c)
+          {
+          const T backgroundValue = backgroundPtr[c];
+          const T foregroundValue = c < foregroundComponents ? foregroundPtr[c] : backgroundValue;
+          if (mode == vtkImageCompareBlend::Difference)
+            {
+            if (c == 3)
+              {
+              outPtr[c] = foregroundValue > backgroundValue ? foregroundValue : backgroundValue;
+              }
+            else
+              {
+              outPtr[c] = foregroundValue > backgroundValue ?
+                static_cast<T>(foregroundValue - backgroundValue) :
+                static_cast<T>(backgroundValue - foregroundValue);
+              }
+            }
+          else
+            {
+            outPtr[c] = showForeground ? foregroundValue : backgroundValue;
+            }
+          }
+        backgroundPtr += numberOfComponents;
+        foregroundPtr += foregroundComponents;
+        outPtr += numberOfComponents;
+        }
+      backgroundPtr += backgroundIncrements[1];
+      foregroundPtr += foregroundIncrements[1];
+      outPtr += outIncrements[1];
+      }
+    backgroundPtr += backgroundIncrements[2];
+    foregroundPtr += foregroundIncrements[2];
+    outPtr += outIncrements[2];
+    }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+void vtkImageCompareBlend::ThreadedRequestData(
+  vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector,
+  vtkInformationVector* vtkNotUsed(outputVector),
+  vtkImageData*** inData,
+  vtkImageData** outData,
+  int outExt[6], int vtkNotUsed(threadId))
+{
+  vtkImageData* background = inData[0][0];
+  vtkImageData* foreground = inData[1] ? inData[1][0] : 0;
+  vtkImageData* output = outData[0];
+  if (!background || !foreground ||
+      !background->GetPointData()->GetScalars() ||
+      !foreground->GetPointData()->GetScalars())
+    {
+    return;
+    }
+  if (foreground->GetScalarType() != background->GetScalarType())
+    {
+    vtkErrorMacro("ThreadedRequestData: foreground and background must have the same scalar type");
+    return;
+    }
+  int foregroundExtent[6];
+  foreground->GetExtent(foregroundExtent);
+  if (outExt[0] < foregroundExtent[0] || outExt[1] > foregroundExtent[1] ||
+      outExt[2] < foregroundExtent[2] || outExt[3] > foregroundExtent[3] ||
+      outExt[4] < foregroundExtent[4] || outExt[5] > foregroundExtent[5])
+    {
+    vtkErrorMacro("ThreadedRequestData: foreground does not cover the background extent");
+    return;
+    }
+
+  int wholeExtent[6];
+  inputVector[0]->GetInformationObject(0)->Get(
+    vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent);
+
+  switch (background->GetScalarType())
+    {
+    vtkTemplateMacro(
+      vtkImageCompareBlendExecute(this, background, foreground, output,
+                                  wholeExtent, outExt, static_cast<VTK_TT*>(0)));
+    default:
+      vtkErrorMacro("ThreadedRequestData: Unknown input ScalarType");
+      return;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageCompareBlend::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Mode: " << this->Mode << "\n";
+  os << indent << "CheckerboardSize: " << this->CheckerboardSize << "\n";
+  os << indent << "SwipePosition: " << this->SwipePosition << "\n";
+  os << indent << "FlickerForeground: " << this->FlickerForeground << "\n";
+}
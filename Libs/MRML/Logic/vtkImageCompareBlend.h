@@ -0,0 +1,100 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#ifndef __vtkImageCompareBlend_h
+#define __vtkImageCompareBlend_h
+
+#include "vtkMRMLLogicWin32Header.h"
+
+// VTK includes
+#include <vtkThreadedImageAlgorithm.h>
+
+class vtkAlgorithmOutput;
+
+/// \brief Compare two images of the same geometry pixel by pixel.
+///
+/// Used by vtkMRMLSliceLogic to compare the foreground and background layers
+/// of a slice view (e.g. for registration quality assessment). The inputs are
+/// the unsigned char color images of the layers, the output has the type and
+/// number of components of the background:
+/// - Checkerboard: foreground and background alternate in squares of
+///   CheckerboardSize pixels, starting with the foreground.
+/// - Swipe: the foreground is shown left of the column at SwipePosition
+///   (fraction of the image width), the background on the right.
+/// - Difference: absolute difference of the color components, the alpha
+///   (4th) component is the maximum of the two.
+/// - Flicker: only the foreground is shown if FlickerForeground is on, only
+///   the background otherwise.
+/// The pattern is computed in the index space of the whole image.
+class VTK_MRML_LOGIC_EXPORT vtkImageCompareBlend : public vtkThreadedImageAlgorithm
+{
+public:
+  static vtkImageCompareBlend *New();
+  vtkTypeMacro(vtkImageCompareBlend,vtkThreadedImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  enum
+    {
+    Checkerboard = 0,
+    Swipe,
+    Difference,
+    Flicker
+    };
+
+  ///
+  /// Comparison mode, Checkerboard by default.
+  vtkSetClampMacro(Mode, int, Checkerboard, Flicker);
+  vtkGetMacro(Mode, int);
+
+  ///
+  /// Size in pixels of the checkerboard squares. 32 by default.
+  vtkSetClampMacro(CheckerboardSize, int, 1, VTK_INT_MAX);
+  vtkGetMacro(CheckerboardSize, int);
+
+  ///
+  /// Position of the swipe line as a fraction of the image width.
+  /// 0.5 by default.
+  vtkSetClampMacro(SwipePosition, double, 0., 1.);
+  vtkGetMacro(SwipePosition, double);
+
+  ///
+  /// Image shown in Flicker mode. Off (background) by default.
+  vtkSetMacro(FlickerForeground, int);
+  vtkGetMacro(FlickerForeground, int);
+  vtkBooleanMacro(FlickerForeground, int);
+
+  ///
+  /// Background (port 0) and foreground (port 1) images.
+  void SetBackgroundInputConnection(vtkAlgorithmOutput* input);
+  void SetForegroundInputConnection(vtkAlgorithmOutput* input);
+
+protected:
+  vtkImageCompareBlend();
+  ~vtkImageCompareBlend();
+
+  virtual void ThreadedRequestData(vtkInformation* request,
+                                   vtkInformationVector** inputVector,
+                                   vtkInformationVector* outputVector,
+                                   vtkImageData*** inData,
+                                   vtkImageData** outData,
+                                   int outExt[6], int threadId);
+
+  int Mode;
+  int CheckerboardSize;
+  double SwipePosition;
+  int FlickerForeground;
+
+private:
+  vtkImageCompareBlend(const vtkImageCompareBlend&);  // Not implemented.
+  void operator=(const vtkImageCompareBlend&);  // Not implemented.
+};
+
+#endif
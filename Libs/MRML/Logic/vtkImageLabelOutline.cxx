@@ -20,6 +20,10 @@
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkVersion.h>
 
+// STD includes
+#include <algorithm>
+#include <vector>
+
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkImageLabelOutline);
 
@@ -45,81 +49,45 @@ vtkImageLabelOutline::~vtkImageLabelOutline()
 
 // Description:
 // This templated function executes the filter for any type of data.
+// A non background pixel is an outline pixel if a pixel of its
+// (2*Outline+1)x(2*Outline+1) neighborhood has a different label or if its
+// neighborhood reaches outside of the input. The neighborhood comparisons
+// are done on entire rows at once, without branches, so that the compiler
+// can vectorize them.
 template <class T>
 static void vtkImageLabelOutlineExecute(vtkImageLabelOutline *self,
-                     vtkImageData *inData, T *inPtr,
+                     vtkImageData *inData, T *vtkNotUsed(inPtr),
                      vtkImageData *outData,
                      int outExt[6], int id)
 {
-  int *kernelMiddle, *kernelSize;
-  // For looping though output (and input) pixels.
-  int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
-  int outIdx0, outIdx1, outIdx2;
-  vtkIdType inInc0, inInc1, inInc2;
-  vtkIdType outInc0, outInc1, outInc2;
-  T *inPtr0, *inPtr1, *inPtr2;
-  T *outPtr0, *outPtr1, *outPtr2;
-  // For looping through hood pixels
-  int hoodMin0, hoodMax0, hoodMin1, hoodMax1, hoodMin2, hoodMax2;
-  int hoodIdx0, hoodIdx1, hoodIdx2;
-  T *hoodPtr0, *hoodPtr1, *hoodPtr2;
-  // The extent of the whole input image
-  int inImageMin0, inImageMin1, inImageMin2;
-  int inImageMax0, inImageMax1, inImageMax2;
-  // Other
-  T backgroundLabelValue = (T)(self->GetBackground());
-  T inLabelValue;
-  T *outPtr = (T*)outData->GetScalarPointerForExtent(outExt);
-  unsigned long count = 0;
-  unsigned long target;
-
-  // Get information to march through data
+  const T backgroundLabelValue = (T)(self->GetBackground());
+  const int outline = self->GetOutline();
 
-  inData->GetIncrements(inInc0, inInc1, inInc2);
+  // The extent of the whole input image
   int inExt[6];
   self->GetInputInformation()->Get(
         vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), inExt);
-  inImageMin0 = inExt[0]; inImageMax0 = inExt[1];
-  inImageMin1 = inExt[2]; inImageMax1 = inExt[3];
-  inImageMin2 = inExt[4]; inImageMax2 = inExt[5];
-  outData->GetIncrements(outInc0, outInc1, outInc2);
-  outMin0 = outExt[0];   outMax0 = outExt[1];
-  outMin1 = outExt[2];   outMax1 = outExt[3];
-  outMin2 = outExt[4];   outMax2 = outExt[5];
-
-  // Neighborhood around current voxel
-  kernelSize = self->GetKernelSize();
-  kernelMiddle = self->GetKernelMiddle();
-  hoodMin0 = kernelMiddle[0] - kernelSize[0]/2; // truncate on purpose
-  hoodMin1 = kernelMiddle[1] - kernelSize[1]/2; // to round down odd sizes
-  hoodMin2 = kernelMiddle[2] - kernelSize[2]/2;
-  hoodMax0 = hoodMin0 + kernelSize[0];
-  hoodMax1 = hoodMin1 + kernelSize[1];
-  hoodMax2 = hoodMin2 + kernelSize[2];
+  vtkIdType inInc0, inInc1, inInc2;
+  inData->GetIncrements(inInc0, inInc1, inInc2);
 
-  int outline = self->GetOutline();
-  hoodMin0 = - outline;
-  hoodMin1 = - outline;
-  hoodMin2 = 0;
-  hoodMax0 = outline;
-  hoodMax1 = outline;
-  hoodMax2 = 0;
+  // Columns with a neighborhood fully inside the input along the rows
+  const int rowLength = outExt[1] - outExt[0] + 1;
+  int interiorMin0 = inExt[0] + outline - outExt[0];
+  int interiorMax0 = inExt[1] - outline - outExt[0];
+  interiorMin0 = interiorMin0 > 0 ? interiorMin0 : 0;
+  interiorMax0 = interiorMax0 < rowLength - 1 ? interiorMax0 : rowLength - 1;
 
-  // in and out should be marching through corresponding pixels.
-  inPtr = (T *)(inData->GetScalarPointer(outMin0, outMin1, outMin2));
+  // Non zero for the pixels having a different label in their neighborhood
+  std::vector<unsigned char> transitions(rowLength > 0 ? rowLength : 1);
 
-  target = (unsigned long)((outMax2-outMin2+1)*(outMax1-outMin1+1)/50.0);
+  unsigned long count = 0;
+  unsigned long target = (unsigned long)((outExt[5]-outExt[4]+1)*(outExt[3]-outExt[2]+1)/50.0);
   target++;
 
-  // loop through pixels of output
-  outPtr2 = outPtr;
-  inPtr2 = inPtr;
-  for (outIdx2 = outMin2; outIdx2 <= outMax2; outIdx2++)
+  for (int outIdx2 = outExt[4]; outIdx2 <= outExt[5]; outIdx2++)
     {
-    outPtr1 = outPtr2;
-    inPtr1 = inPtr2;
-    for (outIdx1 = outMin1;
-      !self->AbortExecute && outIdx1 <= outMax1; outIdx1++)
+    for (int outIdx1 = outExt[2];
+      !self->AbortExecute && outIdx1 <= outExt[3]; outIdx1++)
       {
       if (!id)
         {
@@ -129,74 +97,43 @@ static void vtkImageLabelOutlineExecute(vtkImageLabelOutline *self,
           }
         count++;
         }
-      outPtr0 = outPtr1;
-      inPtr0 = inPtr1;
-      for (outIdx0 = outMin0; outIdx0 <= outMax0; outIdx0++)
-        {
-        inLabelValue = *inPtr0;
-        // Default output equal to backgroundLabelValue
-        // on the assumption this is not an outline pixel
-        *outPtr0 = backgroundLabelValue;
+      const T* inRow = static_cast<T*>(inData->GetScalarPointer(outExt[0], outIdx1, outIdx2));
+      T* outRow = static_cast<T*>(outData->GetScalarPointer(outExt[0], outIdx1, outIdx2));
 
-        // look at neighborhood around non-background
-        // pixels to see if there is a transition.
-        // If there is, then this is an outline pixel
-        if (inLabelValue != backgroundLabelValue)
+      // If the neighborhood of the row reaches outside of the input, all the
+      // labeled pixels of the row are outline pixels.
+      bool interiorRow = (outIdx1 - outline >= inExt[2] && outIdx1 + outline <= inExt[3]);
+      if (interiorRow)
+        {
+        std::fill(transitions.begin(), transitions.end(), 0);
+        for (int hoodIdx1 = -outline; hoodIdx1 <= outline; ++hoodIdx1)
           {
-          // Loop through neighborhood pixels
-          // Note: hood pointer marches out of bounds.
-          // start at lower left pixel
-          hoodPtr2 = inPtr0 + hoodMin0 * inInc0
-                            + hoodMin1 * inInc1
-                            + hoodMin2 * inInc2;
-
-          for (hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
+          for (int hoodIdx0 = -outline; hoodIdx0 <= outline; ++hoodIdx0)
             {
-            hoodPtr1 = hoodPtr2;
-            for (hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
+            if (hoodIdx0 == 0 && hoodIdx1 == 0)
               {
-              hoodPtr0 = hoodPtr1;
-              for (hoodIdx0 = hoodMin0; hoodIdx0 <= hoodMax0; ++hoodIdx0)
-                {
-                // handle boundaries
-                if (outIdx0 + hoodIdx0 >= inImageMin0 &&
-                    outIdx0 + hoodIdx0 <= inImageMax0 &&
-                    outIdx1 + hoodIdx1 >= inImageMin1 &&
-                    outIdx1 + hoodIdx1 <= inImageMax1 &&
-                    outIdx2 + hoodIdx2 >= inImageMin2 &&
-                    outIdx2 + hoodIdx2 <= inImageMax2)
-                  {
-                  // If the neighbor value is not the same label value
-                  // that means this is an outline pixel
-                  // (border is within neighborhood).
-                  // so set the output to foreground
-                  if (*hoodPtr0 != inLabelValue)
-                    {
-                    *outPtr0 = inLabelValue;
-                    }
-                  }
-                else
-                  {
-                  // neighborhood reaches outside of the input
-                  // domain, so this is also an outline pixel
-                  *outPtr0 = inLabelValue;
-                  }
-                hoodPtr0 += inInc0;
-                }//for0
-              hoodPtr1 += inInc1;
-              }//for1
-            hoodPtr2 += inInc2;
-            }//for2
-          }//if
-        inPtr0 += inInc0;
-        outPtr0 += outInc0;
-        }//for0
-      inPtr1 += inInc1;
-      outPtr1 += outInc1;
-      }//for1
-    inPtr2 += inInc2;
-    outPtr2 += outInc2;
-    }//for2
+              continue;
+              }
+            const T* hoodRow = inRow + hoodIdx1 * inInc1 + hoodIdx0 * inInc0;
+            unsigned char* transitionsPtr = &transitions[0];
+            for (int idx0 = interiorMin0; idx0 <= interiorMax0; ++idx0)
+              {
+              transitionsPtr[idx0] |= (hoodRow[idx0] != inRow[idx0]);
+              }
+            }
+          }
+        }
+      for (int idx0 = 0; idx0 < rowLength; ++idx0)
+        {
+        const T inLabelValue = inRow[idx0];
+        bool outlinePixel = !interiorRow ||
+          idx0 < interiorMin0 || idx0 > interiorMax0 ||
+          transitions[idx0] != 0;
+        outRow[idx0] = (inLabelValue != backgroundLabelValue && outlinePixel) ?
+          inLabelValue : backgroundLabelValue;
+        }
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -22,6 +22,9 @@
 
 // VTK includes
 #include <vtkCallbackCommand.h>
+#include <vtkCollection.h>
+#include <vtkFloatArray.h>
+#include <vtkIntArray.h>
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
 
@@ -353,8 +356,44 @@ void vtkMRMLAbstractLogic::SetAndObserveMRMLSceneEventsInternal(vtkMRMLScene *ne
                                                                 vtkFloatArray *priorities
 )
 {
+  // Logics observing vtkMRMLScene::NodeAddedEvent are also notified of the
+  // nodes added by vtkMRMLScene::AddNodes(): ProcessMRMLSceneEvents()
+  // calls OnMRMLSceneNodeAdded() for each node of a NodesAddedEvent.
+  vtkSmartPointer<vtkIntArray> sceneEvents = events;
+  vtkSmartPointer<vtkFloatArray> scenePriorities = priorities;
+  if (events)
+    {
+    int nodeAddedEventIndex = -1;
+    bool nodesAddedEventObserved = false;
+    for (int i = 0; i < events->GetNumberOfTuples(); ++i)
+      {
+      if (events->GetValue(i) == vtkMRMLScene::NodeAddedEvent)
+        {
+        nodeAddedEventIndex = i;
+        }
+      else if (events->GetValue(i) == vtkMRMLScene::NodesAddedEvent)
+        {
+        nodesAddedEventObserved = true;
+        }
+      }
+    if (nodeAddedEventIndex >= 0 && !nodesAddedEventObserved)
+      {
+      sceneEvents = vtkSmartPointer<vtkIntArray>::New();
+      sceneEvents->DeepCopy(events);
+      sceneEvents->InsertNextValue(vtkMRMLScene::NodesAddedEvent);
+      if (priorities)
+        {
+        scenePriorities = vtkSmartPointer<vtkFloatArray>::New();
+        scenePriorities->DeepCopy(priorities);
+        scenePriorities->InsertNextValue(
+          nodeAddedEventIndex < priorities->GetNumberOfTuples() ?
+          priorities->GetValue(nodeAddedEventIndex) : 0.);
+        }
+      }
+    }
   this->GetMRMLSceneObserverManager()->SetAndObserveObjectEvents(
-    vtkObjectPointer(&this->Internal->MRMLScene), newScene, events, priorities);
+    vtkObjectPointer(&this->Internal->MRMLScene), newScene,
+    sceneEvents.GetPointer(), scenePriorities.GetPointer());
 }
 
 //----------------------------------------------------------------------------
@@ -474,6 +513,18 @@ void vtkMRMLAbstractLogic
       assert(node);
       this->OnMRMLSceneNodeAdded(node);
       break;
+    case vtkMRMLScene::NodesAddedEvent:
+      {
+      vtkCollection* nodes = reinterpret_cast<vtkCollection*>(callData);
+      assert(nodes);
+      vtkCollectionSimpleIterator it;
+      for (nodes->InitTraversal(it);
+           (node = vtkMRMLNode::SafeDownCast(nodes->GetNextItemAsObject(it))) ;)
+        {
+        this->OnMRMLSceneNodeAdded(node);
+        }
+      }
+      break;
     case vtkMRMLScene::NodeRemovedEvent:
       node = reinterpret_cast<vtkMRMLNode*>(callData);
       assert(node);
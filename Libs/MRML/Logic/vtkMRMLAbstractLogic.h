@@ -303,7 +303,8 @@ protected:
   /// \sa OnMRMLSceneStartImport, OnMRMLSceneEndImport
   virtual void OnMRMLSceneNew(){}
   /// If vtkMRMLScene::NodeAddedEvent has been set to be observed in
-  ///  SetMRMLSceneInternal, it is called when the scene fires the event
+  ///  SetMRMLSceneInternal, it is called when the scene fires the event.
+  /// It is also called for each node of a vtkMRMLScene::NodesAddedEvent.
   /// \sa ProcessMRMLSceneEvents, SetMRMLSceneInternal
   /// \sa OnMRMLSceneNodeRemoved, vtkMRMLScene::NodeAboutToBeAdded
   virtual void OnMRMLSceneNodeAdded(vtkMRMLNode* /*node*/){}
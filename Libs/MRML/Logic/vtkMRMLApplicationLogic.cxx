@@ -26,6 +26,7 @@
 #include "vtkMRMLColorLogic.h"
 #include "vtkMRMLSliceLogic.h"
 #include <vtkMRMLSliceLinkLogic.h>
+#include <vtkMRMLMemoryLogic.h>
 #include <vtkMRMLModelHierarchyLogic.h>
 
 // MRML includes
@@ -48,9 +49,9 @@
 
 // VTKSYS includes
 #include <vtksys/SystemTools.hxx>
-#include <vtksys/Glob.hxx>
 
 // STD includes
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 
@@ -80,6 +81,7 @@ public:
   vtkSmartPointer<vtkMRMLSliceLinkLogic> SliceLinkLogic;
   vtkSmartPointer<vtkMRMLModelHierarchyLogic> ModelHierarchyLogic;
   vtkSmartPointer<vtkMRMLColorLogic> ColorLogic;
+  vtkSmartPointer<vtkMRMLMemoryLogic> MemoryLogic;
   std::string TemporaryPath;
 
 };
@@ -94,6 +96,7 @@ vtkMRMLApplicationLogic::vtkInternal::vtkInternal(vtkMRMLApplicationLogic * exte
   this->SliceLinkLogic = vtkSmartPointer<vtkMRMLSliceLinkLogic>::New();
   this->ModelHierarchyLogic = vtkSmartPointer<vtkMRMLModelHierarchyLogic>::New();
   this->ColorLogic = vtkSmartPointer<vtkMRMLColorLogic>::New();
+  this->MemoryLogic = vtkSmartPointer<vtkMRMLMemoryLogic>::New();
 }
 
 //----------------------------------------------------------------------------
@@ -152,6 +155,7 @@ vtkMRMLApplicationLogic::vtkMRMLApplicationLogic()
   this->Internal->SliceLinkLogic->SetMRMLApplicationLogic(this);
   this->Internal->ModelHierarchyLogic->SetMRMLApplicationLogic(this);
   this->Internal->ColorLogic->SetMRMLApplicationLogic(this);
+  this->Internal->MemoryLogic->SetMRMLApplicationLogic(this);
 }
 
 //----------------------------------------------------------------------------
@@ -184,6 +188,12 @@ vtkMRMLModelHierarchyLogic* vtkMRMLApplicationLogic::GetModelHierarchyLogic()con
   return this->Internal->ModelHierarchyLogic;
 }
 
+//----------------------------------------------------------------------------
+vtkMRMLMemoryLogic* vtkMRMLApplicationLogic::GetMemoryLogic()const
+{
+  return this->Internal->MemoryLogic;
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLApplicationLogic::SetColorLogic(vtkMRMLColorLogic* colorLogic)
 {
@@ -330,6 +340,7 @@ void vtkMRMLApplicationLogic::SetMRMLSceneInternal(vtkMRMLScene *newScene)
 
   this->Internal->SliceLinkLogic->SetMRMLScene(newScene);
   this->Internal->ModelHierarchyLogic->SetMRMLScene(newScene);
+  this->Internal->MemoryLogic->SetMRMLScene(newScene);
 }
 
 //----------------------------------------------------------------------------
@@ -439,10 +450,10 @@ void vtkMRMLApplicationLogic::FitSliceToAll(bool onlyIfPropagateVolumeSelectionA
 }
 
 //----------------------------------------------------------------------------
-bool vtkMRMLApplicationLogic::Zip(const char *zipFileName, const char *directoryToZip)
+bool vtkMRMLApplicationLogic::Zip(const char *zipFileName, const char *directoryToZip, int compressionLevel)
 {
   // call function in vtkArchive
-  return zip(zipFileName, directoryToZip);
+  return zip(zipFileName, directoryToZip, compressionLevel);
 }
 
 //----------------------------------------------------------------------------
@@ -455,29 +466,38 @@ bool vtkMRMLApplicationLogic::Unzip(const char *zipFileName, const char *destina
 //----------------------------------------------------------------------------
 std::string vtkMRMLApplicationLogic::UnpackSlicerDataBundle(const char *sdbFilePath, const char *temporaryDirectory)
 {
-  if ( !this->Unzip(sdbFilePath, temporaryDirectory) )
+  // The list of extracted files gives the scene file without having to
+  // scan the (possibly large) extracted directory tree.
+  std::vector<std::string> files;
+  if ( !unzip(sdbFilePath, temporaryDirectory, &files) )
     {
     vtkErrorMacro("could not open bundle file");
     return "";
     }
 
-  vtksys::Glob glob;
-  glob.RecurseOn();
-  glob.RecurseThroughSymlinksOff();
-  std::string globPattern(temporaryDirectory);
-  if ( !glob.FindFiles( globPattern + "/*.mrml" ) )
+  // Use the scene file closest to the bundle root
+  std::string mrmlFile;
+  size_t mrmlFileDepth = 0;
+  for (std::vector<std::string>::const_iterator it = files.begin(); it != files.end(); ++it)
     {
-    vtkErrorMacro("could not search archive");
-    return "";
+    if (vtksys::SystemTools::LowerCase(vtksys::SystemTools::GetFilenameLastExtension(*it)) != ".mrml")
+      {
+      continue;
+      }
+    size_t depth = std::count(it->begin(), it->end(), '/');
+    if (mrmlFile.empty() || depth < mrmlFileDepth)
+      {
+      mrmlFile = *it;
+      mrmlFileDepth = depth;
+      }
     }
-  std::vector<std::string> files = glob.GetFiles();
-  if ( files.size() <= 0 )
+  if ( mrmlFile.empty() )
     {
     vtkErrorMacro("could not find mrml file in archive");
     return "";
     }
 
-  return( files[0] );
+  return std::string(temporaryDirectory) + "/" + mrmlFile;
 }
 
 //----------------------------------------------------------------------------
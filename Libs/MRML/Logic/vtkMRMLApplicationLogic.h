@@ -27,6 +27,7 @@
 #include "vtkMRMLLogicWin32Header.h"
 
 class vtkMRMLColorLogic;
+class vtkMRMLMemoryLogic;
 class vtkMRMLModelDisplayNode;
 class vtkMRMLSliceNode;
 class vtkMRMLSliceLogic;
@@ -69,6 +70,10 @@ public:
   /// Get ModelHierarchyLogic
   vtkMRMLModelHierarchyLogic* GetModelHierarchyLogic() const;
 
+  /// Get the logic accounting for the memory used by the scene data and
+  /// enforcing the memory budget.
+  vtkMRMLMemoryLogic* GetMemoryLogic() const;
+
   /// Set/Get color logic.
   /// The application typically sets a custom color logic (i.e.
   /// vtkSlicerColorLogic) that contains default color nodes.
@@ -129,8 +134,10 @@ public:
   void PropagateTableSelection();
 
   /// zip the directory into a zip file
+  /// compressionLevel: -1 = default, 0 = no compression, 1 (fastest) to 9 (smallest file).
+  /// Files that are already compressed are stored without compressing them again.
   /// Returns success or failure.
-  bool Zip(const char *zipFileName, const char *directoryToZip);
+  bool Zip(const char *zipFileName, const char *directoryToZip, int compressionLevel = -1);
 
   /// unzip the zip file to the current working directory
   /// Returns success or failure.
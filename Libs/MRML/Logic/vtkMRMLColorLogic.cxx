@@ -664,7 +664,7 @@ vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateFreeSurferFileNode(const char* f
     return 0;
     }
 
-  vtkMRMLColorTableNode* node = this->CreateFileNode(fileName);
+  vtkMRMLColorTableNode* node = this->CreateFileNode(fileName, true);
 
   if (!node)
     {
@@ -727,7 +727,8 @@ vtkMRMLdGEMRICProceduralColorNode* vtkMRMLColorLogic::CreatedGEMRICColorNode(int
 //---------------------------------------------------------------------------------
 vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateDefaultFileNode(const std::string& colorFileName)
 {
-  vtkMRMLColorTableNode* ctnode = this->CreateFileNode(colorFileName.c_str());
+  // default color files are only read when used
+  vtkMRMLColorTableNode* ctnode = this->CreateFileNode(colorFileName.c_str(), true);
 
   if (!ctnode)
     {
@@ -783,7 +784,7 @@ std::vector<std::string> vtkMRMLColorLogic::FindUserColorFiles()
 }
 
 //--------------------------------------------------------------------------------
-vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateFileNode(const char* fileName)
+vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateFileNode(const char* fileName, bool deferRead)
 {
   vtkMRMLColorTableNode * ctnode =  vtkMRMLColorTableNode::New();
   ctnode->SetTypeToFile();
@@ -807,7 +808,14 @@ vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateFileNode(const char* fileName)
 
   vtkDebugMacro("CreateFileNode: About to read user file " << fileName);
 
-  if (ctnode->GetStorageNode()->ReadData(ctnode) == 0)
+  if (deferRead && this->GetMRMLScene() &&
+      vtksys::SystemTools::FileExists(fileName, true))
+    {
+    // the file is read the first time the colors are accessed, the storage
+    // node has to be in the scene for the node to find it
+    ctnode->SetDeferredRead(true);
+    }
+  else if (ctnode->GetStorageNode()->ReadData(ctnode) == 0)
     {
     vtkErrorMacro("Unable to read file as color table " << (ctnode->GetFileName() ? ctnode->GetFileName() : ""));
 
@@ -388,7 +388,11 @@ protected:
   vtkMRMLdGEMRICProceduralColorNode* CreatedGEMRICColorNode(int type);
   vtkMRMLColorTableNode* CreateDefaultFileNode(const std::string& colorname);
   vtkMRMLColorTableNode* CreateUserFileNode(const std::string& colorname);
-  vtkMRMLColorTableNode* CreateFileNode(const char* fileName);
+  /// Create a color table node read from \a fileName.
+  /// If \a deferRead is true, the file is only read when the colors are
+  /// first accessed.
+  /// \sa vtkMRMLColorNode::GetDeferredRead()
+  vtkMRMLColorTableNode* CreateFileNode(const char* fileName, bool deferRead = false);
   vtkMRMLProceduralColorNode* CreateProceduralFileNode(const char* fileName);
 
   void AddLabelsNode();
@@ -0,0 +1,387 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLLogic includes
+#include "vtkMRMLApplicationLogic.h"
+#include "vtkMRMLMemoryLogic.h"
+#include "vtkMRMLSliceLogic.h"
+
+// MRML includes
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSegmentationNode.h>
+
+// SegmentationCore includes
+#include <vtkSegment.h>
+#include <vtkSegmentation.h>
+
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkDataObject.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointSet.h>
+#include <vtkStringArray.h>
+
+// STD includes
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+typedef std::set<vtkDataObject*> DataObjectSetType;
+
+//----------------------------------------------------------------------------
+void AddNodeDataObjects(vtkMRMLNode* node, DataObjectSetType& dataObjects)
+{
+  vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(node);
+  if (volumeNode && volumeNode->GetImageData())
+    {
+    dataObjects.insert(volumeNode->GetImageData());
+    }
+  vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(node);
+  if (modelNode && modelNode->GetMesh())
+    {
+    dataObjects.insert(modelNode->GetMesh());
+    }
+  vtkMRMLSegmentationNode* segmentationNode = vtkMRMLSegmentationNode::SafeDownCast(node);
+  vtkSegmentation* segmentation =
+    segmentationNode ? segmentationNode->GetSegmentation() : 0;
+  if (segmentation)
+    {
+    std::vector<std::string> segmentIDs;
+    segmentation->GetSegmentIDs(segmentIDs);
+    for (std::vector<std::string>::iterator segmentIt = segmentIDs.begin();
+         segmentIt != segmentIDs.end(); ++segmentIt)
+      {
+      vtkSegment* segment = segmentation->GetSegment(*segmentIt);
+      if (!segment)
+        {
+        continue;
+        }
+      std::vector<std::string> representationNames;
+      segment->GetContainedRepresentationNames(representationNames);
+      for (std::vector<std::string>::iterator nameIt = representationNames.begin();
+           nameIt != representationNames.end(); ++nameIt)
+        {
+        vtkDataObject* representation = segment->GetRepresentation(*nameIt);
+        if (representation)
+          {
+          dataObjects.insert(representation);
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType GetDataObjectsMemorySize(const DataObjectSetType& dataObjects)
+{
+  vtkIdType size = 0;
+  for (DataObjectSetType::const_iterator it = dataObjects.begin();
+       it != dataObjects.end(); ++it)
+    {
+    // GetActualMemorySize() is in kibibytes
+    size += static_cast<vtkIdType>((*it)->GetActualMemorySize()) * 1024;
+    }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType GetPyramidMemorySize(vtkMRMLNode* node)
+{
+  vtkMRMLScalarVolumeNode* scalarVolumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(node);
+  return scalarVolumeNode ? scalarVolumeNode->GetPyramidMemorySize() : 0;
+}
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkMRMLMemoryLogic);
+
+//----------------------------------------------------------------------------
+vtkMRMLMemoryLogic::vtkMRMLMemoryLogic()
+{
+  this->MemoryBudget = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLMemoryLogic::~vtkMRMLMemoryLogic()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMemoryLogic::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MemoryBudget: " << this->MemoryBudget << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMemoryLogic::SetMRMLSceneInternal(vtkMRMLScene* newScene)
+{
+  vtkNew<vtkIntArray> events;
+  events->InsertNextValue(vtkMRMLScene::NodeAddedEvent);
+  events->InsertNextValue(vtkMRMLScene::EndImportEvent);
+  events->InsertNextValue(vtkMRMLScene::EndBatchProcessEvent);
+  this->SetAndObserveMRMLSceneEventsInternal(newScene, events.GetPointer());
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMemoryLogic::OnMRMLSceneNodeAdded(vtkMRMLNode* vtkNotUsed(node))
+{
+  if (this->GetMRMLScene()->IsBatchProcessing())
+    {
+    return;
+    }
+  this->EnforceMemoryBudget();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMemoryLogic::OnMRMLSceneEndImport()
+{
+  this->EnforceMemoryBudget();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMemoryLogic::OnMRMLSceneEndBatchProcess()
+{
+  this->EnforceMemoryBudget();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLMemoryLogic::GetNodeMemorySize(vtkMRMLNode* node)
+{
+  if (!node)
+    {
+    return 0;
+    }
+  DataObjectSetType dataObjects;
+  AddNodeDataObjects(node, dataObjects);
+  return GetDataObjectsMemorySize(dataObjects) + GetPyramidMemorySize(node);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLMemoryLogic::GetSceneDataMemorySize()
+{
+  vtkMRMLScene* scene = this->GetMRMLScene();
+  if (!scene)
+    {
+    return 0;
+    }
+  DataObjectSetType dataObjects;
+  vtkIdType pyramidSize = 0;
+  vtkCollectionSimpleIterator it;
+  vtkCollection* nodes = scene->GetNodes();
+  vtkMRMLNode* node = 0;
+  for (nodes->InitTraversal(it);
+       (node = vtkMRMLNode::SafeDownCast(nodes->GetNextItemAsObject(it)));)
+    {
+    AddNodeDataObjects(node, dataObjects);
+    pyramidSize += GetPyramidMemorySize(node);
+    }
+  return GetDataObjectsMemorySize(dataObjects) + pyramidSize;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLMemoryLogic::GetUndoMemorySize()
+{
+  vtkMRMLScene* scene = this->GetMRMLScene();
+  return scene ? scene->GetUndoMemorySize() : 0;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLMemoryLogic::GetSliceImageCacheMemorySize()
+{
+  vtkMRMLApplicationLogic* appLogic = this->GetMRMLApplicationLogic();
+  vtkCollection* sliceLogics = appLogic ? appLogic->GetSliceLogics() : 0;
+  if (!sliceLogics)
+    {
+    return 0;
+    }
+  vtkIdType size = 0;
+  vtkCollectionSimpleIterator it;
+  vtkMRMLSliceLogic* sliceLogic = 0;
+  for (sliceLogics->InitTraversal(it);
+       (sliceLogic = vtkMRMLSliceLogic::SafeDownCast(sliceLogics->GetNextItemAsObject(it)));)
+    {
+    size += sliceLogic->GetSliceImageCacheMemorySize();
+    }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLMemoryLogic::GetCacheMemorySize()
+{
+  vtkIdType size = this->GetSliceImageCacheMemorySize();
+  vtkMRMLScene* scene = this->GetMRMLScene();
+  if (!scene)
+    {
+    return size;
+    }
+  vtkCollectionSimpleIterator it;
+  vtkCollection* nodes = scene->GetNodes();
+  vtkMRMLNode* node = 0;
+  for (nodes->InitTraversal(it);
+       (node = vtkMRMLNode::SafeDownCast(nodes->GetNextItemAsObject(it)));)
+    {
+    size += GetPyramidMemorySize(node);
+    }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLMemoryLogic::GetTotalMemorySize()
+{
+  return this->GetSceneDataMemorySize() + this->GetUndoMemorySize()
+    + this->GetSliceImageCacheMemorySize();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMemoryLogic::GetNodeMemorySizes(vtkStringArray* nodeIDs,
+                                            vtkIdTypeArray* memorySizes)
+{
+  if (!nodeIDs || !memorySizes)
+    {
+    vtkErrorMacro(<< "GetNodeMemorySizes: invalid output arrays");
+    return;
+    }
+  nodeIDs->Reset();
+  memorySizes->Reset();
+  vtkMRMLScene* scene = this->GetMRMLScene();
+  if (!scene)
+    {
+    return;
+    }
+  vtkCollectionSimpleIterator it;
+  vtkCollection* nodes = scene->GetNodes();
+  vtkMRMLNode* node = 0;
+  for (nodes->InitTraversal(it);
+       (node = vtkMRMLNode::SafeDownCast(nodes->GetNextItemAsObject(it)));)
+    {
+    vtkIdType size = vtkMRMLMemoryLogic::GetNodeMemorySize(node);
+    if (size > 0)
+      {
+      nodeIDs->InsertNextValue(node->GetID() ? node->GetID() : "");
+      memorySizes->InsertNextValue(size);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLMemoryLogic::ReleaseSliceImageCaches()
+{
+  vtkIdType size = this->GetSliceImageCacheMemorySize();
+  vtkMRMLApplicationLogic* appLogic = this->GetMRMLApplicationLogic();
+  vtkCollection* sliceLogics = appLogic ? appLogic->GetSliceLogics() : 0;
+  if (!sliceLogics)
+    {
+    return 0;
+    }
+  vtkCollectionSimpleIterator it;
+  vtkMRMLSliceLogic* sliceLogic = 0;
+  for (sliceLogics->InitTraversal(it);
+       (sliceLogic = vtkMRMLSliceLogic::SafeDownCast(sliceLogics->GetNextItemAsObject(it)));)
+    {
+    sliceLogic->ClearSliceImageCache();
+    }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLMemoryLogic::ReleasePyramidLevels()
+{
+  vtkIdType size = 0;
+  vtkCollectionSimpleIterator it;
+  vtkCollection* nodes = this->GetMRMLScene()->GetNodes();
+  vtkMRMLNode* node = 0;
+  for (nodes->InitTraversal(it);
+       (node = vtkMRMLNode::SafeDownCast(nodes->GetNextItemAsObject(it)));)
+    {
+    vtkMRMLScalarVolumeNode* scalarVolumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(node);
+    if (scalarVolumeNode)
+      {
+      size += scalarVolumeNode->GetPyramidMemorySize();
+      scalarVolumeNode->ReleasePyramidLevels();
+      }
+    }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLMemoryLogic::ReleaseUndoHistory()
+{
+  vtkIdType size = this->GetUndoMemorySize();
+  this->GetMRMLScene()->ClearUndoStack();
+  this->GetMRMLScene()->ClearRedoStack();
+  return size;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLMemoryLogic::ReleaseDerivedSegmentRepresentations(bool hiddenSegmentsOnly)
+{
+  vtkIdType sizeBefore = this->GetSceneDataMemorySize();
+  std::vector<vtkMRMLNode*> segmentationNodes;
+  this->GetMRMLScene()->GetNodesByClass("vtkMRMLSegmentationNode", segmentationNodes);
+  for (std::vector<vtkMRMLNode*>::iterator it = segmentationNodes.begin();
+       it != segmentationNodes.end(); ++it)
+    {
+    vtkMRMLSegmentationNode* segmentationNode = vtkMRMLSegmentationNode::SafeDownCast(*it);
+    if (segmentationNode)
+      {
+      segmentationNode->EvictDerivedRepresentations(hiddenSegmentsOnly);
+      }
+    }
+  vtkIdType sizeAfter = this->GetSceneDataMemorySize();
+  return sizeBefore > sizeAfter ? sizeBefore - sizeAfter : 0;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLMemoryLogic::EnforceMemoryBudget()
+{
+  if (this->MemoryBudget <= 0 || !this->GetMRMLScene())
+    {
+    return 0;
+    }
+  vtkIdType totalSize = this->GetTotalMemorySize();
+  if (totalSize <= this->MemoryBudget)
+    {
+    return 0;
+    }
+  vtkIdType releasedSize = 0;
+  // Release what is the cheapest to recompute first
+  const int numberOfSteps = 5;
+  for (int step = 0; step < numberOfSteps && totalSize - releasedSize > this->MemoryBudget; ++step)
+    {
+    switch (step)
+      {
+      case 0: releasedSize += this->ReleaseSliceImageCaches(); break;
+      case 1: releasedSize += this->ReleasePyramidLevels(); break;
+      case 2: releasedSize += this->ReleaseDerivedSegmentRepresentations(true); break;
+      case 3: releasedSize += this->ReleaseUndoHistory(); break;
+      default: releasedSize += this->ReleaseDerivedSegmentRepresentations(false); break;
+      }
+    }
+  if (totalSize - releasedSize > this->MemoryBudget)
+    {
+    vtkWarningMacro(<< "EnforceMemoryBudget: the scene uses " << (totalSize - releasedSize)
+                    << " bytes, more than the budget of " << this->MemoryBudget << " bytes");
+    }
+  return releasedSize;
+}
@@ -0,0 +1,125 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLMemoryLogic_h
+#define __vtkMRMLMemoryLogic_h
+
+// MRMLLogic includes
+#include "vtkMRMLAbstractLogic.h"
+
+class vtkIdTypeArray;
+class vtkMRMLNode;
+class vtkStringArray;
+
+/// \brief Account for the memory used by the bulk data of the scene.
+///
+/// The memory is reported in bytes for:
+/// - the data of the nodes: volume image data, model meshes and all the
+///   representations of the segments
+/// - the caches that can be recomputed: coarser levels of the volume
+///   pyramids and the slice image caches of the slice logics
+/// - the undo and redo history of the scene
+///
+/// A data object shared by several nodes is counted once.
+///
+/// When a MemoryBudget is set, EnforceMemoryBudget() releases memory until
+/// the total fits into the budget, from the cheapest to recompute to the
+/// most expensive:
+/// -# slice image caches
+/// -# volume pyramid levels
+/// -# segment representations other than the master representation of the
+///    hidden segments
+/// -# undo and redo history
+/// -# segment representations other than the master representation of the
+///    visible segments
+///
+/// Evicted segment representations are converted again when they are shown.
+/// \sa vtkMRMLSegmentationNode::EvictDerivedRepresentations()
+///
+/// The budget is enforced automatically after nodes are added to the scene
+/// and after a scene is imported.
+/// \code
+/// memoryLogic = slicer.app.applicationLogic().GetMemoryLogic()
+/// memoryLogic.SetMemoryBudget(8 * 1024 * 1024 * 1024)
+/// print(memoryLogic.GetTotalMemorySize())
+/// \endcode
+class VTK_MRML_LOGIC_EXPORT vtkMRMLMemoryLogic : public vtkMRMLAbstractLogic
+{
+public:
+  static vtkMRMLMemoryLogic* New();
+  vtkTypeMacro(vtkMRMLMemoryLogic, vtkMRMLAbstractLogic);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  /// Number of bytes used by the bulk data of \a node, including the
+  /// caches owned by the node (e.g. pyramid levels).
+  static vtkIdType GetNodeMemorySize(vtkMRMLNode* node);
+
+  /// Number of bytes used by the bulk data of all the nodes of the scene.
+  vtkIdType GetSceneDataMemorySize();
+
+  /// Number of bytes used by the undo and redo stacks of the scene.
+  /// \sa vtkMRMLScene::GetUndoMemorySize()
+  vtkIdType GetUndoMemorySize();
+
+  /// Number of bytes used by the caches that can be recomputed: volume
+  /// pyramid levels and slice image caches.
+  vtkIdType GetCacheMemorySize();
+
+  /// Sum of GetSceneDataMemorySize(), GetUndoMemorySize() and the slice
+  /// image caches.
+  vtkIdType GetTotalMemorySize();
+
+  /// Fill \a nodeIDs and \a memorySizes with the ID and the number of bytes
+  /// of the nodes that have bulk data, in scene order.
+  void GetNodeMemorySizes(vtkStringArray* nodeIDs, vtkIdTypeArray* memorySizes);
+
+  /// Maximum number of bytes the scene data, caches and undo history should
+  /// use. 0 (default) means no budget.
+  /// \sa EnforceMemoryBudget()
+  vtkSetMacro(MemoryBudget, vtkIdType);
+  vtkGetMacro(MemoryBudget, vtkIdType);
+
+  /// Release caches, undo history and derived segment representations until
+  /// the total memory size fits into the budget.
+  /// Returns the number of bytes that have been released.
+  /// Nothing is done if no budget is set.
+  vtkIdType EnforceMemoryBudget();
+
+protected:
+  vtkMRMLMemoryLogic();
+  virtual ~vtkMRMLMemoryLogic();
+
+  virtual void SetMRMLSceneInternal(vtkMRMLScene* newScene);
+  virtual void OnMRMLSceneNodeAdded(vtkMRMLNode* node);
+  virtual void OnMRMLSceneEndImport();
+  virtual void OnMRMLSceneEndBatchProcess();
+
+  /// Sum of the slice image caches of the application slice logics.
+  vtkIdType GetSliceImageCacheMemorySize();
+
+  /// Release each kind of memory, return the number of released bytes.
+  vtkIdType ReleaseSliceImageCaches();
+  vtkIdType ReleasePyramidLevels();
+  vtkIdType ReleaseUndoHistory();
+  vtkIdType ReleaseDerivedSegmentRepresentations(bool hiddenSegmentsOnly);
+
+  vtkIdType MemoryBudget;
+
+private:
+  vtkMRMLMemoryLogic(const vtkMRMLMemoryLogic&); // Not implemented
+  void operator=(const vtkMRMLMemoryLogic&);     // Not implemented
+};
+
+#endif
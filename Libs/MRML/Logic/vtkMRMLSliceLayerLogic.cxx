@@ -16,6 +16,7 @@
 #include "vtkMRMLSliceLayerLogic.h"
 
 // MRML includes
+#include "vtkMRMLColorNode.h"
 #include "vtkMRMLLabelMapVolumeNode.h"
 #include "vtkMRMLLabelMapVolumeDisplayNode.h"
 #include "vtkMRMLVectorVolumeDisplayNode.h"
@@ -36,6 +37,8 @@
 #include <vtkImageReslice.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
@@ -49,6 +52,8 @@
 
 // STD includes
 #include <algorithm>
+#include <cstdio>
+#include <sstream>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkMRMLSliceLayerLogic);
@@ -99,6 +104,22 @@ void SnapToPermuteMatrix(vtkTransform* transform)
   }
 }
 
+//----------------------------------------------------------------------------
+// Return the number of voxels covered by a pixel of the slice view, along
+// the slice axis where voxels are the smallest.
+//----------------------------------------------------------------------------
+double GetVoxelsPerPixel(vtkAbstractTransform* xyToIJK)
+{
+  double origin[3] = {0., 0., 0.};
+  const double x[3] = {1., 0., 0.};
+  const double y[3] = {0., 1., 0.};
+  double xIJK[3] = {0., 0., 0.};
+  double yIJK[3] = {0., 0., 0.};
+  xyToIJK->TransformVectorAtPoint(origin, x, xIJK);
+  xyToIJK->TransformVectorAtPoint(origin, y, yIJK);
+  return std::min(vtkMath::Norm(xIJK), vtkMath::Norm(yIJK));
+}
+
 //----------------------------------------------------------------------------
 vtkMRMLSliceLayerLogic::vtkMRMLSliceLayerLogic()
 {
@@ -110,6 +131,9 @@ vtkMRMLSliceLayerLogic::vtkMRMLSliceLayerLogic()
 
   this->XYToIJKTransform = vtkGeneralTransform ::New();
   this->UVWToIJKTransform = vtkGeneralTransform ::New();
+  this->XYToIJKMatrix = vtkMatrix4x4::New();
+  this->XYToIJKMatrixIsLinear = false;
+  this->XYToIJKMatrixTime = 0;
 
   this->IsLabelLayer = 0;
 
@@ -145,6 +169,7 @@ vtkMRMLSliceLayerLogic::vtkMRMLSliceLayerLogic()
   this->ResliceUVW->SetOutputDimensionality( 3 );
   this->ResliceUVW->GenerateStencilOutputOn();
 
+  this->InteractionPreview = 0;
   this->UpdatingTransforms = 0;
 }
 
@@ -168,6 +193,7 @@ vtkMRMLSliceLayerLogic::~vtkMRMLSliceLayerLogic()
   this->SetVolumeNode(0);
   this->XYToIJKTransform->Delete();
   this->UVWToIJKTransform->Delete();
+  this->XYToIJKMatrix->Delete();
 
   this->Reslice->SetInputConnection( 0 );
   this->ResliceUVW->SetInputConnection( 0 );
@@ -632,6 +658,18 @@ vtkAlgorithmOutput* vtkMRMLSliceLayerLogic::GetImageDataConnectionUVW()
   return this->GetVolumeDisplayNodeUVW()->GetOutputImageDataConnection();
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::SetInteractionPreview(int preview)
+{
+  if (this->InteractionPreview == preview)
+    {
+    return;
+    }
+  this->InteractionPreview = preview;
+  // UpdateImageDisplay() calls Modified() if the reslice changed
+  this->UpdateImageDisplay();
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
 {
@@ -660,7 +698,14 @@ void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
     }
   else
     {
-    this->Reslice->SetInterpolationModeToLinear();
+    if (this->InteractionPreview)
+      {
+      this->Reslice->SetInterpolationModeToNearestNeighbor();
+      }
+    else
+      {
+      this->Reslice->SetInterpolationModeToLinear();
+      }
     this->ResliceUVW->SetInterpolationModeToLinear();
     }
 
@@ -736,7 +781,22 @@ void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
 //      {
 //      volumeNode->GetImageData()->Print(std::cout);
 //      }
-    this->Reslice->SetInputData(volumeNode->GetImageData());
+    // Reslice a coarser level of the multi-resolution pyramid if the
+    // slice view shows the volume at a lower resolution. The UVW reslice
+    // always uses the full resolution image data.
+    vtkImageData* resliceInput = volumeNode->GetImageData();
+    vtkMRMLScalarVolumeNode* scalarVolumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(volumeNode);
+    if (resliceInput && scalarVolumeNode && !labelMapVolumeDisplayNode &&
+        this->SliceNode && scalarVolumeNode->GetMaximumPyramidLevel() > 0)
+      {
+      int level = scalarVolumeNode->GetPyramidLevelForResolution(
+        GetVoxelsPerPixel(this->XYToIJKTransform));
+      if (level > 0 && scalarVolumeNode->GetPyramidLevelImageData(level))
+        {
+        resliceInput = scalarVolumeNode->GetPyramidLevelImageData(level);
+        }
+      }
+    this->Reslice->SetInputData(resliceInput);
     this->ResliceUVW->SetInputData(volumeNode->GetImageData());
     // use the label outline if we have a label map volume, this is the label
     // layer (turned on in slice logic when the label layer is instantiated)
@@ -898,6 +958,107 @@ void vtkMRMLSliceLayerLogic::UpdateGlyphs()
     }
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLSliceLayerLogic::GetIJKAtXY(double xyz[3], int ijk[3])
+{
+  ijk[0] = ijk[1] = ijk[2] = 0;
+  if (!this->VolumeNode)
+    {
+    return false;
+    }
+  if (this->XYToIJKMatrixTime != this->XYToIJKTransform->GetMTime())
+    {
+    vtkNew<vtkTransform> linearTransform;
+    this->XYToIJKMatrixIsLinear = vtkMRMLTransformNode::IsGeneralTransformLinear(
+      this->XYToIJKTransform, linearTransform.GetPointer());
+    if (this->XYToIJKMatrixIsLinear)
+      {
+      linearTransform->GetMatrix(this->XYToIJKMatrix);
+      }
+    this->XYToIJKMatrixTime = this->XYToIJKTransform->GetMTime();
+    }
+  double xyzw[4] = { xyz[0], xyz[1], xyz[2], 1.0 };
+  double ijkw[4] = { 0.0, 0.0, 0.0, 1.0 };
+  if (this->XYToIJKMatrixIsLinear)
+    {
+    this->XYToIJKMatrix->MultiplyPoint(xyzw, ijkw);
+    }
+  else
+    {
+    this->XYToIJKTransform->TransformPoint(xyzw, ijkw);
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    ijk[i] = vtkMath::IsNan(ijkw[i]) ? 0 : vtkMath::Round(ijkw[i]);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLSliceLayerLogic::GetPixelDescriptionAtIJK(int ijk[3])
+{
+  if (!this->VolumeNode)
+    {
+    return "No volume";
+    }
+  vtkImageData* imageData = this->VolumeNode->GetImageData();
+  if (!imageData)
+    {
+    return "No Image";
+    }
+  int dims[3] = { 0, 0, 0 };
+  imageData->GetDimensions(dims);
+  for (int i = 0; i < 3; ++i)
+    {
+    if (ijk[i] < 0 || ijk[i] >= dims[i])
+      {
+      return "Out of Frame";
+      }
+    }
+
+  if (this->VolumeNode->IsA("vtkMRMLLabelMapVolumeNode"))
+    {
+    int labelIndex = static_cast<int>(imageData->GetScalarComponentAsDouble(ijk[0], ijk[1], ijk[2], 0));
+    const char* labelValue = 0;
+    vtkMRMLDisplayNode* displayNode = this->VolumeNode->GetDisplayNode();
+    vtkMRMLColorNode* colorNode = displayNode ? displayNode->GetColorNode() : 0;
+    if (colorNode)
+      {
+      labelValue = colorNode->GetColorName(labelIndex);
+      }
+    std::stringstream ss;
+    ss << (labelValue ? labelValue : "Unknown") << " (" << labelIndex << ")";
+    return ss.str();
+    }
+
+  if (this->VolumeNode->IsA("vtkMRMLDiffusionTensorVolumeNode"))
+    {
+    return "";
+    }
+
+  int numberOfComponents = imageData->GetNumberOfScalarComponents();
+  std::stringstream ss;
+  if (numberOfComponents > 3)
+    {
+    ss << numberOfComponents << " components";
+    return ss.str();
+    }
+  for (int c = 0; c < numberOfComponents; ++c)
+    {
+    // Same format as "%4f" with trailing zeros and decimal point removed
+    char componentString[64];
+    sprintf(componentString, "%4f", imageData->GetScalarComponentAsDouble(ijk[0], ijk[1], ijk[2], c));
+    std::string component(componentString);
+    if (component.find('.') != std::string::npos)
+      {
+      component.erase(component.find_last_not_of('0') + 1);
+      component.erase(component.find_last_not_of('.') + 1);
+      }
+    ss << (c > 0 ? ", " : "") << component;
+    }
+  return ss.str();
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLSliceLayerLogic::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -907,6 +1068,7 @@ void vtkMRMLSliceLayerLogic::PrintSelf(ostream& os, vtkIndent indent)
   nextIndent = indent.GetNextIndent();
 
   os << indent << "SlicerSliceLayerLogic:             " << this->GetClassName() << "\n";
+  os << indent << "InteractionPreview: " << this->InteractionPreview << "\n";
 
   if (this->VolumeNode)
     {
@@ -53,8 +53,10 @@ class vtkGeneralTransform;
 
 // STL includes
 //#include <cstdlib>
+#include <string>
 
 class vtkImageLabelOutline;
+class vtkMatrix4x4;
 class vtkTransform;
 
 class VTK_MRML_LOGIC_EXPORT vtkMRMLSliceLayerLogic
@@ -96,6 +98,15 @@ public:
   vtkSetMacro (IsLabelLayer, int);
   vtkBooleanMacro (IsLabelLayer, int);
 
+  ///
+  /// Render a cheaper preview of the slice, typically while the slice is
+  /// interactively moved: the volume is resliced with nearest neighbor
+  /// interpolation. Only the 2D view pipeline is affected, not the UVW one.
+  /// Off by default.
+  void SetInteractionPreview(int preview);
+  vtkGetMacro (InteractionPreview, int);
+  vtkBooleanMacro (InteractionPreview, int);
+
   ///
   /// The filter that turns the label map into an outline
   vtkGetObjectMacro (LabelOutline, vtkImageLabelOutline);
@@ -129,6 +140,21 @@ public:
   /// The current reslice transform XYToIJK
   vtkGetObjectMacro (XYToIJKTransform, vtkGeneralTransform);
 
+  ///
+  /// Get the voxel coordinates of the volume at the \a xyz slice view position,
+  /// rounded to the nearest voxel. If the XYToIJK transform is linear then its
+  /// matrix is cached, which makes this call cheap enough to be called on
+  /// every mouse move.
+  /// Returns false (and ijk is set to 0) if there is no volume in the layer.
+  bool GetIJKAtXY(double xyz[3], int ijk[3]);
+
+  ///
+  /// Get a human readable description of the voxel value of the volume at \a ijk:
+  /// "ColorName (label)" for labelmap volumes, comma separated component values
+  /// for scalar and vector volumes, "Out of Frame" if \a ijk is outside the image.
+  /// Returns an empty string for diffusion tensor volumes, that are not supported.
+  std::string GetPixelDescriptionAtIJK(int ijk[3]);
+
 
 protected:
   vtkMRMLSliceLayerLogic();
@@ -179,7 +205,13 @@ protected:
   vtkGeneralTransform *XYToIJKTransform;
   vtkGeneralTransform *UVWToIJKTransform;
 
+  /// Matrix of XYToIJKTransform if it is linear, used by GetIJKAtXY()
+  vtkMatrix4x4 *XYToIJKMatrix;
+  bool XYToIJKMatrixIsLinear;
+  vtkMTimeType XYToIJKMatrixTime;
+
   int IsLabelLayer;
+  int InteractionPreview;
 
   int UpdatingTransforms;
 };
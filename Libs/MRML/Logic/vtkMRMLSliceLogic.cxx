@@ -15,9 +15,12 @@
 // MRMLLogic includes
 #include "vtkMRMLSliceLogic.h"
 #include "vtkMRMLSliceLayerLogic.h"
+#include "vtkImageCompareBlend.h"
+#include "vtkImageLabelOutline.h"
 
 // MRML includes
 #include <vtkEventBroker.h>
+#include <vtkMRMLColorNode.h>
 #include <vtkMRMLCrosshairNode.h>
 #include <vtkMRMLDiffusionTensorVolumeSliceDisplayNode.h>
 #include <vtkMRMLGlyphableVolumeDisplayNode.h>
@@ -35,23 +38,37 @@
 #include <vtkImageBlend.h>
 #include <vtkImageResample.h>
 #include <vtkImageCast.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkHomogeneousTransform.h>
+#include <vtkImageAlgorithm.h>
 #include <vtkImageData.h>
 #include <vtkImageMathematics.h>
 #include <vtkImageReslice.h>
 #include <vtkInformation.h>
+#include <vtkInformationVector.h>
 #include <vtkMath.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPlaneSource.h>
+#include <vtkPointData.h>
 #include <vtkPolyDataCollection.h>
+#include <vtkScalarsToColors.h>
 #include <vtkSmartPointer.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkStringArray.h>
 #include <vtkTransform.h>
 #include <vtkVersion.h>
+#include <vtkWeakPointer.h>
 
 #include <vtkAddonMathUtilities.h>
 
 // STD includes
+#include <cstring>
+#include <iomanip>
+#include <list>
+#include <map>
+#include <sstream>
 
 //----------------------------------------------------------------------------
 // Convenient macros
@@ -69,6 +86,298 @@ const int vtkMRMLSliceLogic::SLICE_INDEX_OUT_OF_VOLUME=-2;
 const int vtkMRMLSliceLogic::SLICE_INDEX_NO_VOLUME=-3;
 const std::string vtkMRMLSliceLogic::SLICE_MODEL_NODE_NAME_SUFFIX = std::string("Volume Slice");
 
+//----------------------------------------------------------------------------
+/// \brief Cache of the composited images of a slice logic.
+///
+/// The filter has no input connection so that the blend pipeline is
+/// updated only when the image is not found in the cache.
+class vtkMRMLSliceLogicImageCache : public vtkImageAlgorithm
+{
+public:
+  static vtkMRMLSliceLogicImageCache* New();
+  vtkTypeMacro(vtkMRMLSliceLogicImageCache, vtkImageAlgorithm);
+
+  /// Slice logic computing the cache keys, not reference counted.
+  vtkMRMLSliceLogic* SliceLogic;
+  /// Filter producing the composited image.
+  vtkImageAlgorithm* Source;
+  /// Maximum number of bytes of the cached images.
+  size_t MaximumSize;
+
+  virtual vtkMTimeType GetMTime()
+  {
+    vtkMTimeType mTime = this->Superclass::GetMTime();
+    if (this->SliceLogic)
+      {
+      vtkMTimeType sliceLogicMTime = this->SliceLogic->GetSliceImageCacheMTime();
+      mTime = sliceLogicMTime > mTime ? sliceLogicMTime : mTime;
+      }
+    return mTime;
+  }
+
+  void Clear()
+  {
+    this->Images.clear();
+    this->ImageIndex.clear();
+    this->Size = 0;
+  }
+
+  void SetMaximumSize(size_t maximumSize)
+  {
+    this->MaximumSize = maximumSize;
+    this->Evict();
+  }
+
+  /// Number of bytes of the cached images.
+  size_t GetSize()
+  {
+    return this->Size;
+  }
+
+protected:
+  vtkMRMLSliceLogicImageCache()
+  {
+    this->SliceLogic = 0;
+    this->Source = 0;
+    this->MaximumSize = 0;
+    this->Size = 0;
+    this->SetNumberOfInputPorts(0);
+  }
+
+  virtual int RequestInformation(vtkInformation* vtkNotUsed(request),
+                                 vtkInformationVector** vtkNotUsed(inputVector),
+                                 vtkInformationVector* outputVector)
+  {
+    if (!this->Source)
+      {
+      return 0;
+      }
+    this->Source->UpdateInformation();
+    vtkInformation* sourceInfo = this->Source->GetOutputInformation(0);
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    outInfo->CopyEntry(sourceInfo, vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT());
+    outInfo->CopyEntry(sourceInfo, vtkDataObject::SPACING());
+    outInfo->CopyEntry(sourceInfo, vtkDataObject::ORIGIN());
+    vtkInformation* scalarInfo = vtkDataObject::GetActiveFieldInformation(sourceInfo,
+      vtkDataObject::FIELD_ASSOCIATION_POINTS, vtkDataSetAttributes::SCALARS);
+    if (scalarInfo)
+      {
+      vtkDataObject::SetPointDataActiveScalarInfo(outInfo,
+        scalarInfo->Get(vtkDataObject::FIELD_ARRAY_TYPE()),
+        scalarInfo->Get(vtkDataObject::FIELD_NUMBER_OF_COMPONENTS()));
+      }
+    return 1;
+  }
+
+  virtual int RequestData(vtkInformation* vtkNotUsed(request),
+                          vtkInformationVector** vtkNotUsed(inputVector),
+                          vtkInformationVector* outputVector)
+  {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    vtkImageData* output = vtkImageData::GetData(outputVector);
+    if (!this->Source || !output)
+      {
+      return 0;
+      }
+    int wholeExtent[6] = {0, -1, 0, -1, 0, -1};
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent);
+
+    std::string stateKey;
+    std::vector<std::string> tileKeys;
+    if (this->SliceLogic && this->MaximumSize > 0)
+      {
+      this->SliceLogic->GetSliceImageCacheKeys(stateKey, tileKeys);
+      }
+    int numberOfTiles = static_cast<int>(tileKeys.size());
+    if (stateKey.empty() || numberOfTiles != wholeExtent[5] - wholeExtent[4] + 1)
+      {
+      this->Clear();
+      this->Source->UpdateWholeExtent();
+      output->ShallowCopy(this->Source->GetOutputDataObject(0));
+      return 1;
+      }
+    if (stateKey != this->StateKey)
+      {
+      // the cached images are not valid anymore
+      this->Clear();
+      this->StateKey = stateKey;
+      }
+
+    // Look for the tiles (the lightbox frames) in the cache, then in the
+    // caches of the other slice logics. The keys don't depend on the slice
+    // view, linked slice views showing the same slice of the same layers
+    // can use the same image.
+    SharedImageMapType& sharedImages = vtkMRMLSliceLogicImageCache::GetSharedImages();
+    std::vector<vtkSmartPointer<vtkImageData> > tiles(numberOfTiles);
+    int firstMissingTile = numberOfTiles;
+    int lastMissingTile = -1;
+    for (int tile = 0; tile < numberOfTiles; ++tile)
+      {
+      tiles[tile] = this->FindImage(tileKeys[tile]);
+      if (!tiles[tile])
+        {
+        SharedImageMapType::iterator sharedIt =
+          sharedImages.find(stateKey + "#" + tileKeys[tile]);
+        if (sharedIt != sharedImages.end() && sharedIt->second.GetPointer())
+          {
+          tiles[tile] = sharedIt->second.GetPointer();
+          this->AddImage(tileKeys[tile], tiles[tile]);
+          }
+        }
+      if (!tiles[tile])
+        {
+        firstMissingTile = tile < firstMissingTile ? tile : firstMissingTile;
+        lastMissingTile = tile;
+        }
+      }
+
+    if (lastMissingTile >= 0)
+      {
+      // Only compute the missing tiles: when a lightbox is scrolled, most of
+      // its frames were already displayed.
+      int updateExtent[6] = {wholeExtent[0], wholeExtent[1],
+                             wholeExtent[2], wholeExtent[3],
+                             wholeExtent[4] + firstMissingTile,
+                             wholeExtent[4] + lastMissingTile};
+      this->Source->UpdateExtent(updateExtent);
+      vtkImageData* sourceImage =
+        vtkImageData::SafeDownCast(this->Source->GetOutputDataObject(0));
+      if (!sourceImage || !sourceImage->GetPointData()->GetScalars())
+        {
+        this->Clear();
+        this->Source->UpdateWholeExtent();
+        output->ShallowCopy(this->Source->GetOutputDataObject(0));
+        return 1;
+        }
+      vtkMRMLSliceLogicImageCache::RemoveExpiredSharedImages();
+      for (int tile = firstMissingTile; tile <= lastMissingTile; ++tile)
+        {
+        if (tiles[tile])
+          {
+          continue;
+          }
+        tiles[tile] = ExtractTile(sourceImage, wholeExtent, wholeExtent[4] + tile);
+        this->AddImage(tileKeys[tile], tiles[tile]);
+        sharedImages[stateKey + "#" + tileKeys[tile]] = tiles[tile].GetPointer();
+        }
+      }
+
+    if (numberOfTiles == 1)
+      {
+      output->ShallowCopy(tiles[0]);
+      output->SetExtent(wholeExtent);
+      return 1;
+      }
+    // Assemble the lightbox frames
+    output->SetExtent(wholeExtent);
+    output->SetOrigin(tiles[0]->GetOrigin());
+    output->SetSpacing(tiles[0]->GetSpacing());
+    output->AllocateScalars(tiles[0]->GetScalarType(),
+                            tiles[0]->GetNumberOfScalarComponents());
+    size_t tileSize = static_cast<size_t>(tiles[0]->GetNumberOfPoints()) *
+      tiles[0]->GetScalarSize() * tiles[0]->GetNumberOfScalarComponents();
+    for (int tile = 0; tile < numberOfTiles; ++tile)
+      {
+      memcpy(output->GetScalarPointer(wholeExtent[0], wholeExtent[2], wholeExtent[4] + tile),
+             tiles[tile]->GetScalarPointer(), tileSize);
+      }
+    return 1;
+  }
+
+  /// Copy the frame \a z of \a image into a new image of depth 1.
+  static vtkSmartPointer<vtkImageData> ExtractTile(vtkImageData* image, int extent[6], int z)
+  {
+    vtkSmartPointer<vtkImageData> tile = vtkSmartPointer<vtkImageData>::New();
+    tile->SetExtent(extent[0], extent[1], extent[2], extent[3], 0, 0);
+    tile->SetOrigin(image->GetOrigin());
+    tile->SetSpacing(image->GetSpacing());
+    tile->AllocateScalars(image->GetScalarType(), image->GetNumberOfScalarComponents());
+    size_t rowSize = static_cast<size_t>(extent[1] - extent[0] + 1) *
+      image->GetScalarSize() * image->GetNumberOfScalarComponents();
+    for (int y = extent[2]; y <= extent[3]; ++y)
+      {
+      memcpy(tile->GetScalarPointer(extent[0], y, 0),
+             image->GetScalarPointer(extent[0], y, z), rowSize);
+      }
+    return tile;
+  }
+
+  vtkImageData* FindImage(const std::string& key)
+  {
+    std::map<std::string, ImageListType::iterator>::iterator indexIt =
+      this->ImageIndex.find(key);
+    if (indexIt == this->ImageIndex.end())
+      {
+      return 0;
+      }
+    // move the image at the front of the most recently used list
+    this->Images.splice(this->Images.begin(), this->Images, indexIt->second);
+    return indexIt->second->second;
+  }
+
+  void AddImage(const std::string& key, vtkImageData* image)
+  {
+    size_t imageSize = static_cast<size_t>(image->GetActualMemorySize()) * 1024;
+    if (imageSize > this->MaximumSize)
+      {
+      return;
+      }
+    this->Images.push_front(std::make_pair(key, vtkSmartPointer<vtkImageData>(image)));
+    this->ImageIndex[key] = this->Images.begin();
+    this->Size += imageSize;
+    this->Evict();
+  }
+
+  void Evict()
+  {
+    while (this->Size > this->MaximumSize && !this->Images.empty())
+      {
+      vtkImageData* image = this->Images.back().second;
+      size_t imageSize = static_cast<size_t>(image->GetActualMemorySize()) * 1024;
+      this->Size = imageSize < this->Size ? this->Size - imageSize : 0;
+      this->ImageIndex.erase(this->Images.back().first);
+      this->Images.pop_back();
+      }
+  }
+
+  typedef std::map<std::string, vtkWeakPointer<vtkImageData> > SharedImageMapType;
+  /// Images cached by all the slice logics. The images are owned by the
+  /// caches that contain them.
+  static SharedImageMapType& GetSharedImages()
+  {
+    static SharedImageMapType sharedImages;
+    return sharedImages;
+  }
+  static void RemoveExpiredSharedImages()
+  {
+    SharedImageMapType& sharedImages = vtkMRMLSliceLogicImageCache::GetSharedImages();
+    for (SharedImageMapType::iterator it = sharedImages.begin(); it != sharedImages.end();)
+      {
+      if (it->second.GetPointer() == 0)
+        {
+        sharedImages.erase(it++);
+        }
+      else
+        {
+        ++it;
+        }
+      }
+  }
+
+  typedef std::list<std::pair<std::string, vtkSmartPointer<vtkImageData> > > ImageListType;
+  /// Cached images, most recently used first.
+  ImageListType Images;
+  std::map<std::string, ImageListType::iterator> ImageIndex;
+  std::string StateKey;
+  size_t Size;
+
+private:
+  vtkMRMLSliceLogicImageCache(const vtkMRMLSliceLogicImageCache&); // Not implemented
+  void operator=(const vtkMRMLSliceLogicImageCache&); // Not implemented
+};
+
+vtkStandardNewMacro(vtkMRMLSliceLogicImageCache);
+
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkMRMLSliceLogic);
 
@@ -84,6 +393,13 @@ vtkMRMLSliceLogic::vtkMRMLSliceLogic()
   this->SliceCompositeNode = 0;
   this->Blend = vtkImageBlend::New();
   this->BlendUVW = vtkImageBlend::New();
+  this->CompareBlend = vtkImageCompareBlend::New();
+  this->CompareBlendUVW = vtkImageCompareBlend::New();
+
+  this->SliceImageCache = vtkMRMLSliceLogicImageCache::New();
+  this->SliceImageCache->SliceLogic = this;
+  this->SliceImageCache->Source = this->Blend;
+  this->SliceImageCache->SetMaximumSize(64 * 1024 * 1024);
 
   this->ExtractModelTexture = vtkImageReslice::New();
   this->ExtractModelTexture->SetOutputDimensionality (2);
@@ -100,6 +416,7 @@ vtkMRMLSliceLogic::vtkMRMLSliceLogic()
   this->ImageDataConnection = 0;
   this->SliceSpacing[0] = this->SliceSpacing[1] = this->SliceSpacing[2] = 1;
   this->AddingSliceModelNodes = false;
+  this->InteractionPreview = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -123,6 +440,23 @@ vtkMRMLSliceLogic::~vtkMRMLSliceLogic()
     this->BlendUVW->Delete();
     this->BlendUVW = 0;
     }
+  if (this->CompareBlend)
+    {
+    this->CompareBlend->Delete();
+    this->CompareBlend = 0;
+    }
+  if (this->CompareBlendUVW)
+    {
+    this->CompareBlendUVW->Delete();
+    this->CompareBlendUVW = 0;
+    }
+  if (this->SliceImageCache)
+    {
+    this->SliceImageCache->SliceLogic = 0;
+    this->SliceImageCache->Source = 0;
+    this->SliceImageCache->Delete();
+    this->SliceImageCache = 0;
+    }
   if (this->ExtractModelTexture)
     {
     this->ExtractModelTexture->Delete();
@@ -819,8 +1153,8 @@ void vtkMRMLSliceLogic::UpdateImageData ()
 {
   if (this->SliceNode->GetSliceResolutionMode() == vtkMRMLSliceNode::SliceResolutionMatch2DView)
     {
-    this->ExtractModelTexture->SetInputConnection( this->Blend->GetOutputPort() );
-    this->ImageDataConnection = this->Blend->GetOutputPort();
+    this->ExtractModelTexture->SetInputConnection( this->SliceImageCache->GetOutputPort() );
+    this->ImageDataConnection = this->SliceImageCache->GetOutputPort();
     }
   else
     {
@@ -833,9 +1167,9 @@ void vtkMRMLSliceLogic::UpdateImageData ()
        (this->GetForegroundLayer() != 0 && this->GetForegroundLayer()->GetImageDataConnection() != 0) ||
        (this->GetLabelLayer() != 0 && this->GetLabelLayer()->GetImageDataConnection() != 0) )
     {
-    if (this->ImageDataConnection == 0 || this->Blend->GetOutputPort()->GetMTime() > this->ImageDataConnection->GetMTime())
+    if (this->ImageDataConnection == 0 || this->SliceImageCache->GetOutputPort()->GetMTime() > this->ImageDataConnection->GetMTime())
       {
-      this->ImageDataConnection = this->Blend->GetOutputPort();
+      this->ImageDataConnection = this->SliceImageCache->GetOutputPort();
       }
     }
   else
@@ -852,6 +1186,190 @@ void vtkMRMLSliceLogic::UpdateImageData ()
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::SetSliceImageCacheSize(int sizeInMB)
+{
+  size_t size = static_cast<size_t>(sizeInMB > 0 ? sizeInMB : 0) * 1024 * 1024;
+  if (size == this->SliceImageCache->MaximumSize)
+    {
+    return;
+    }
+  this->SliceImageCache->SetMaximumSize(size);
+  this->SliceImageCache->Modified();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLSliceLogic::GetSliceImageCacheSize()
+{
+  return static_cast<int>(this->SliceImageCache->MaximumSize / (1024 * 1024));
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMRMLSliceLogic::GetSliceImageCacheMemorySize()
+{
+  return static_cast<vtkIdType>(this->SliceImageCache->GetSize());
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::ClearSliceImageCache()
+{
+  this->SliceImageCache->Clear();
+}
+
+//----------------------------------------------------------------------------
+vtkAlgorithmOutput* vtkMRMLSliceLogic::GetSliceModelTextureConnection()
+{
+  if (!this->SliceNode ||
+      this->ExtractModelTexture->GetNumberOfInputConnections(0) == 0)
+    {
+    return this->ExtractModelTexture->GetOutputPort();
+    }
+  int* dimensions =
+    this->SliceNode->GetSliceResolutionMode() == vtkMRMLSliceNode::SliceResolutionMatch2DView ?
+    this->SliceNode->GetDimensions() : this->SliceNode->GetUVWDimensions();
+  if (dimensions[2] > 1)
+    {
+    // Lightbox: only the first slice is textured
+    return this->ExtractModelTexture->GetOutputPort();
+    }
+  // Share the image of the slice view instead of copying it
+  return this->ExtractModelTexture->GetInputConnection(0, 0);
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkMRMLSliceLogic::GetSliceImageCacheMTime()
+{
+  vtkMTimeType mTime = this->Blend->GetMTime();
+  vtkObject* objects[2] = { this->SliceNode, this->SliceCompositeNode };
+  for (int i = 0; i < 2; ++i)
+    {
+    if (objects[i] && objects[i]->GetMTime() > mTime)
+      {
+      mTime = objects[i]->GetMTime();
+      }
+    }
+  vtkMRMLSliceLayerLogic* layers[3] =
+    { this->BackgroundLayer, this->ForegroundLayer, this->LabelLayer };
+  for (int i = 0; i < 3; ++i)
+    {
+    if (!layers[i])
+      {
+      continue;
+      }
+    mTime = layers[i]->GetMTime() > mTime ? layers[i]->GetMTime() : mTime;
+    vtkMRMLVolumeNode* volumeNode = layers[i]->GetVolumeNode();
+    vtkImageData* imageData = volumeNode ? volumeNode->GetImageData() : 0;
+    if (imageData && imageData->GetMTime() > mTime)
+      {
+      mTime = imageData->GetMTime();
+      }
+    vtkMRMLVolumeDisplayNode* displayNode = layers[i]->GetVolumeDisplayNode();
+    vtkMRMLColorNode* colorNode = displayNode ? displayNode->GetColorNode() : 0;
+    vtkScalarsToColors* colors = colorNode ? colorNode->GetScalarsToColors() : 0;
+    if (colors && colors->GetMTime() > mTime)
+      {
+      mTime = colors->GetMTime();
+      }
+    }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::GetSliceImageCacheKeys(std::string& stateKey,
+                                               std::vector<std::string>& tileKeys)
+{
+  stateKey.clear();
+  tileKeys.clear();
+  if (!this->SliceNode || !this->SliceCompositeNode)
+    {
+    return;
+    }
+  std::stringstream state;
+  state << this->SliceCompositeNode->GetCompositing() << " "
+        << this->SliceCompositeNode->GetForegroundOpacity() << " "
+        << this->SliceCompositeNode->GetLabelOpacity() << " "
+        << this->SliceCompositeNode->GetCheckerboardSize() << " "
+        << this->SliceCompositeNode->GetSwipePosition() << " "
+        << this->SliceCompositeNode->GetFlickerForeground() << " "
+        << this->SliceNode->GetUseLabelOutline() << " "
+        << this->Blend->GetNumberOfInputConnections(0);
+
+  std::vector<vtkMatrix4x4*> resliceMatrices;
+  int numberOfTiles = 0;
+  vtkMRMLSliceLayerLogic* layers[3] =
+    { this->BackgroundLayer, this->ForegroundLayer, this->LabelLayer };
+  for (int i = 0; i < 3; ++i)
+    {
+    state << "|";
+    if (!layers[i] || !layers[i]->GetImageDataConnection())
+      {
+      continue;
+      }
+    vtkMRMLVolumeNode* volumeNode = layers[i]->GetVolumeNode();
+    vtkMRMLVolumeDisplayNode* displayNode = layers[i]->GetVolumeDisplayNode();
+    vtkHomogeneousTransform* resliceTransform = vtkHomogeneousTransform::SafeDownCast(
+      layers[i]->GetReslice()->GetResliceTransform());
+    if (!volumeNode || !volumeNode->GetImageData() || !displayNode ||
+        // glyphs depend on more than the reslice transform
+        vtkMRMLGlyphableVolumeDisplayNode::SafeDownCast(displayNode) ||
+        // non linear transforms are not supported
+        !resliceTransform)
+      {
+      return;
+      }
+    vtkMRMLColorNode* colorNode = displayNode->GetColorNode();
+    vtkScalarsToColors* colors = colorNode ? colorNode->GetScalarsToColors() : 0;
+    int* extent = layers[i]->GetReslice()->GetOutputExtent();
+    // The display node of the layer is a copy of the volume display node,
+    // use the latter so that the key is the same in all the slice views.
+    vtkMRMLDisplayNode* volumeDisplayNode = volumeNode->GetDisplayNode();
+    state << volumeNode << " " << volumeNode->GetImageData()->GetMTime() << " "
+          << (volumeDisplayNode ? volumeDisplayNode->GetMTime() : displayNode->GetMTime()) << " "
+          << (colors ? colors->GetMTime() : 0) << " "
+          << layers[i]->GetLabelOutline()->GetMTime() << " "
+          << layers[i]->GetReslice()->GetInterpolationMode() << " "
+          << extent[0] << " " << extent[1] << " " << extent[2] << " "
+          << extent[3] << " " << extent[4] << " " << extent[5];
+    resliceMatrices.push_back(resliceTransform->GetMatrix());
+    numberOfTiles = extent[5] - extent[4] + 1;
+    }
+  if (resliceMatrices.empty() || numberOfTiles < 1)
+    {
+    return;
+    }
+
+  // The frame z of the reslice output is the slice of the reslice matrix
+  // translated by z along its third column. The elements are rounded so
+  // that the keys of a lightbox frame are the same after scrolling.
+  std::stringstream tile;
+  tile << std::fixed << std::setprecision(0);
+  for (int z = 0; z < numberOfTiles; ++z)
+    {
+    tile.str("");
+    for (size_t layer = 0; layer < resliceMatrices.size(); ++layer)
+      {
+      vtkMatrix4x4* matrix = resliceMatrices[layer];
+      for (int row = 0; row < 4; ++row)
+        {
+        for (int column = 0; column < 4; ++column)
+          {
+          double element = matrix->GetElement(row, column);
+          if (column == 3)
+            {
+            element += z * matrix->GetElement(row, 2);
+            }
+          double roundedElement = floor(element * 1e6 + 0.5);
+          tile << (roundedElement == 0. ? 0. : roundedElement) << " ";
+          }
+        }
+      tile << "|";
+      }
+    tileKeys.push_back(tile.str());
+    }
+  stateKey = state.str();
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLSliceLogic::UpdatePipeline()
 {
@@ -941,6 +1459,9 @@ void vtkMRMLSliceLogic::UpdatePipeline()
     // alpha blend or reverse alpha blend
     bool alphaBlending = (sliceCompositing == vtkMRMLSliceCompositeNode::Alpha ||
                           sliceCompositing == vtkMRMLSliceCompositeNode::ReverseAlpha);
+    // checkerboard, swipe, difference or flicker
+    const bool compareBlending = (sliceCompositing >= vtkMRMLSliceCompositeNode::Checkerboard &&
+                                  sliceCompositing <= vtkMRMLSliceCompositeNode::Flicker);
 
     vtkAlgorithmOutput* backgroundImagePort = this->BackgroundLayer ? this->BackgroundLayer->GetImageDataConnection() : 0;
     vtkAlgorithmOutput* foregroundImagePort = this->ForegroundLayer ? this->ForegroundLayer->GetImageDataConnection() : 0;
@@ -952,18 +1473,83 @@ void vtkMRMLSliceLogic::UpdatePipeline()
       {
       if (!backgroundImagePort || !foregroundImagePort)
         {
-        // not enough inputs for add/subtract, so use alpha blending
+        // not enough inputs for add/subtract/compare, so use alpha blending
         // pipeline
         alphaBlending = true;
         }
       }
+    else if (this->SliceCompositeNode->GetForegroundOpacity() <= 0.)
+      {
+      // A fully transparent layer that is blended over another layer has no
+      // visual impact: don't connect it to the blend so that it does not get
+      // resliced and mapped to colors each time the slice is moved.
+      if (sliceCompositing == vtkMRMLSliceCompositeNode::Alpha)
+        {
+        if (backgroundImagePort)
+          {
+          foregroundImagePort = 0;
+          }
+        if (backgroundImagePortUVW)
+          {
+          foregroundImagePortUVW = 0;
+          }
+        }
+      else
+        {
+        if (foregroundImagePort)
+          {
+          backgroundImagePort = 0;
+          }
+        if (foregroundImagePortUVW)
+          {
+          backgroundImagePortUVW = 0;
+          }
+        }
+      }
     vtkMTimeType oldBlendMTime = this->Blend->GetMTime();
     vtkMTimeType oldBlendUVWMTime = this->BlendUVW->GetMTime();
 
     int layerIndex = 0;
     int layerIndexUVW = 0;
 
-    if (!alphaBlending)
+    if (!alphaBlending && compareBlending)
+      {
+      // The layers are compared when the slice image is blended, changing
+      // the compare parameters only re-executes the compare filters.
+      vtkImageCompareBlend* compareBlends[2] = { this->CompareBlend, this->CompareBlendUVW };
+      for (int i = 0; i < 2; ++i)
+        {
+        switch (sliceCompositing)
+          {
+          case vtkMRMLSliceCompositeNode::Checkerboard:
+            compareBlends[i]->SetMode(vtkImageCompareBlend::Checkerboard);
+            break;
+          case vtkMRMLSliceCompositeNode::Swipe:
+            compareBlends[i]->SetMode(vtkImageCompareBlend::Swipe);
+            break;
+          case vtkMRMLSliceCompositeNode::Difference:
+            compareBlends[i]->SetMode(vtkImageCompareBlend::Difference);
+            break;
+          default:
+            compareBlends[i]->SetMode(vtkImageCompareBlend::Flicker);
+            break;
+          }
+        compareBlends[i]->SetCheckerboardSize(this->SliceCompositeNode->GetCheckerboardSize());
+        compareBlends[i]->SetSwipePosition(this->SliceCompositeNode->GetSwipePosition());
+        compareBlends[i]->SetFlickerForeground(this->SliceCompositeNode->GetFlickerForeground());
+        }
+      this->CompareBlend->SetBackgroundInputConnection( backgroundImagePort );
+      this->CompareBlend->SetForegroundInputConnection( foregroundImagePort );
+      this->Blend->SetInputConnection( this->CompareBlend->GetOutputPort() );
+      this->Blend->SetOpacity( layerIndex++, 1.0 );
+
+      // UVW pipeline
+      this->CompareBlendUVW->SetBackgroundInputConnection( backgroundImagePortUVW );
+      this->CompareBlendUVW->SetForegroundInputConnection( foregroundImagePortUVW );
+      this->BlendUVW->SetInputConnection( this->CompareBlendUVW->GetOutputPort() );
+      this->BlendUVW->SetOpacity( layerIndexUVW++, 1.0 );
+      }
+    else if (!alphaBlending)
       {
       vtkNew<vtkImageMathematics> tempMath;
       if (sliceCompositing == vtkMRMLSliceCompositeNode::Add)
@@ -1019,7 +1605,7 @@ void vtkMRMLSliceLogic::UpdatePipeline()
       {
       this->Blend->RemoveAllInputs();
       this->BlendUVW->RemoveAllInputs();
-      if (sliceCompositing ==  vtkMRMLSliceCompositeNode::Alpha)
+      if (sliceCompositing != vtkMRMLSliceCompositeNode::ReverseAlpha)
         {
         if ( backgroundImagePort )
           {
@@ -1069,6 +1655,18 @@ void vtkMRMLSliceLogic::UpdatePipeline()
     // always blending the label layer
     vtkAlgorithmOutput* labelImagePort = this->LabelLayer ? this->LabelLayer->GetImageDataConnection() : 0;
     vtkAlgorithmOutput* labelImagePortUVW = this->LabelLayer ? this->LabelLayer->GetImageDataConnectionUVW() : 0;
+    if (this->SliceCompositeNode->GetLabelOpacity() <= 0.)
+      {
+      // transparent label layer, see foreground above
+      if (layerIndex > 0)
+        {
+        labelImagePort = 0;
+        }
+      if (layerIndexUVW > 0)
+        {
+        labelImagePortUVW = 0;
+        }
+      }
     if ( labelImagePort )
       {
       this->Blend->AddInputConnection( labelImagePort );
@@ -1112,9 +1710,9 @@ void vtkMRMLSliceLogic::UpdatePipeline()
         {
         displayNode->SetTextureImageDataConnection(0);
         }
-      else if (displayNode->GetTextureImageDataConnection() != this->ExtractModelTexture->GetOutputPort())
+      else if (displayNode->GetTextureImageDataConnection() != this->GetSliceModelTextureConnection())
         {
-        displayNode->SetTextureImageDataConnection(this->ExtractModelTexture->GetOutputPort());
+        displayNode->SetTextureImageDataConnection(this->GetSliceModelTextureConnection());
         }
         if ( this->LabelLayer && this->LabelLayer->GetImageDataConnection())
           {
@@ -1217,6 +1815,8 @@ void vtkMRMLSliceLogic::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << "BlendUVW: (none)\n";
     }
 
+  os << indent << "SliceImageCacheSize: " << this->GetSliceImageCacheSize() << "MB\n";
+
   os << indent << "SLICE_MODEL_NODE_NAME_SUFFIX: " << this->SLICE_MODEL_NODE_NAME_SUFFIX << "\n";
 
 }
@@ -1313,7 +1913,7 @@ void vtkMRMLSliceLogic::CreateSliceModel()
     this->SliceModelDisplayNode->SetAmbient(1);
     this->SliceModelDisplayNode->SetBackfaceCulling(0);
     this->SliceModelDisplayNode->SetDiffuse(0);
-    this->SliceModelDisplayNode->SetTextureImageDataConnection(this->ExtractModelTexture->GetOutputPort());
+    this->SliceModelDisplayNode->SetTextureImageDataConnection(this->GetSliceModelTextureConnection());
     this->SliceModelDisplayNode->SetSaveWithScene(0);
     this->SliceModelDisplayNode->SetDisableModifiedEvent(0);
     // set an attribute to distinguish this from regular model display nodes
@@ -1353,7 +1953,7 @@ void vtkMRMLSliceLogic::CreateSliceModel()
     this->SliceModelNode->SetAndObserveDisplayNodeID(this->SliceModelDisplayNode->GetID());
     this->GetMRMLScene()->AddNode(this->SliceModelNode);
     this->AddingSliceModelNodes = false;
-    this->SliceModelDisplayNode->SetTextureImageDataConnection(this->ExtractModelTexture->GetOutputPort());
+    this->SliceModelDisplayNode->SetTextureImageDataConnection(this->GetSliceModelTextureConnection());
     this->SliceModelNode->SetAndObserveTransformNodeID(this->SliceModelTransformNode->GetID());
     }
 
@@ -2099,6 +2699,25 @@ void vtkMRMLSliceLogic::EndSliceNodeInteraction()
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::SetInteractionPreview(int preview)
+{
+  if (this->InteractionPreview == preview)
+    {
+    return;
+    }
+  this->InteractionPreview = preview;
+  vtkMRMLSliceLayerLogic* layers[3] =
+    { this->BackgroundLayer, this->ForegroundLayer, this->LabelLayer };
+  for (int i = 0; i < 3; ++i)
+    {
+    if (layers[i])
+      {
+      layers[i]->SetInteractionPreview(preview);
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLSliceLogic::StartSliceOffsetInteraction()
 {
@@ -19,6 +19,7 @@
 #include "vtkMRMLAbstractLogic.h"
 
 // STD includes
+#include <string>
 #include <vector>
 
 class vtkMRMLDisplayNode;
@@ -33,9 +34,11 @@ class vtkMRMLVolumeNode;
 class vtkAlgorithmOutput;
 class vtkCollection;
 class vtkImageBlend;
+class vtkImageCompareBlend;
 class vtkTransform;
 class vtkImageData;
 class vtkImageReslice;
+class vtkMRMLSliceLogicImageCache;
 class vtkPolyDataCollection;
 class vtkTransform;
 
@@ -131,6 +134,30 @@ public:
   vtkGetObjectMacro(Blend, vtkImageBlend);
   vtkGetObjectMacro(BlendUVW, vtkImageBlend);
 
+  ///
+  /// The filters comparing the foreground and background layers in the
+  /// checkerboard, swipe, difference and flicker compositing modes.
+  vtkGetObjectMacro(CompareBlend, vtkImageCompareBlend);
+  vtkGetObjectMacro(CompareBlendUVW, vtkImageCompareBlend);
+
+  ///
+  /// Maximum memory (in MB) used to keep the composited slice images of the
+  /// recently displayed slice positions. Moving back to a cached slice
+  /// position (e.g. when scrolling back and forth or during cine playback)
+  /// doesn't reslice and blend the layers again. The cache is emptied when
+  /// the layers, their display or the compositing change.
+  /// A size of 0 disables the cache. 64MB by default.
+  void SetSliceImageCacheSize(int sizeInMB);
+  int GetSliceImageCacheSize();
+
+  /// Number of bytes currently used by the images of the slice image cache.
+  /// \sa SetSliceImageCacheSize()
+  vtkIdType GetSliceImageCacheMemorySize();
+
+  /// Remove all the images from the slice image cache.
+  /// \sa SetSliceImageCacheSize()
+  void ClearSliceImageCache();
+
   ///
   /// The offset to the correct slice for lightbox mode
   vtkGetObjectMacro(ActiveSliceTransform, vtkTransform);
@@ -288,6 +315,14 @@ public:
   /// Indicate an interaction with the slice composite node has been completed
   void EndSliceCompositeNodeInteraction();
 
+  /// Render a cheaper preview of the slice in all the layers (nearest
+  /// neighbor reslicing) while the slice is being interactively moved.
+  /// It is up to the caller to turn it off (e.g. when the mouse stops) to
+  /// refine the slice.
+  /// \sa vtkMRMLSliceLayerLogic::SetInteractionPreview()
+  void SetInteractionPreview(int preview);
+  vtkGetMacro(InteractionPreview, int);
+
   /// Indicate the slice offset value is starting to change
   void StartSliceOffsetInteraction();
 
@@ -382,7 +417,24 @@ protected:
   /// Helper to set Window/Level in any layer
   void SetWindowLevel(double window, double level, int layer);
 
+  friend class vtkMRMLSliceLogicImageCache;
+  /// Return the latest modification time of the inputs of the slice image
+  /// cache (the slice node, the composite node and the layers).
+  vtkMTimeType GetSliceImageCacheMTime();
+  /// Compute the keys the composited image is cached with: \a stateKey
+  /// identifies the layers and their display, \a tileKeys identify the
+  /// slice position of each lightbox frame. \a stateKey is empty if the
+  /// image can't be cached.
+  void GetSliceImageCacheKeys(std::string& stateKey, std::vector<std::string>& tileKeys);
+
+  /// Return the connection the slice model texture is read from.
+  /// When the slice image is a single slice, it is directly the image shown
+  /// in the slice view (or the UVW blend), there is no need to extract it
+  /// with ExtractModelTexture.
+  vtkAlgorithmOutput* GetSliceModelTextureConnection();
+
   bool                        AddingSliceModelNodes;
+  int                         InteractionPreview;
   bool                        Initialized;
 
   char *                      Name;
@@ -395,6 +447,9 @@ protected:
 
   vtkImageBlend *   Blend;
   vtkImageBlend *   BlendUVW;
+  vtkImageCompareBlend * CompareBlend;
+  vtkImageCompareBlend * CompareBlendUVW;
+  vtkMRMLSliceLogicImageCache * SliceImageCache;
   vtkImageReslice * ExtractModelTexture;
   vtkAlgorithmOutput *    ImageDataConnection;
   vtkTransform *    ActiveSliceTransform;
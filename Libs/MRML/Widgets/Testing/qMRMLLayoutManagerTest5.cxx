@@ -0,0 +1,92 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+#include <QSignalSpy>
+#include <QWidget>
+
+// Slicer includes
+#include "qMRMLLayoutManager.h"
+#include "qMRMLSliceWidget.h"
+#include "qMRMLThreeDWidget.h"
+
+// MRML includes
+#include <vtkMRMLApplicationLogic.h>
+#include <vtkMRMLLayoutNode.h>
+#include <vtkMRMLScene.h>
+
+// VTK includes
+#include <vtkNew.h>
+
+// STD includes
+#include <iostream>
+
+// Check that switching layouts reuses the view widgets and that modifying
+// the layout node without changing the layout does not set it up again.
+int qMRMLLayoutManagerTest5(int argc, char * argv[] )
+{
+  QApplication app(argc, argv);
+
+  QWidget w;
+  w.show();
+
+  qMRMLLayoutManager layoutManager(&w, &w);
+
+  vtkNew<vtkMRMLApplicationLogic> applicationLogic;
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLLayoutNode> layoutNode;
+  scene->AddNode(layoutNode.GetPointer());
+  applicationLogic->SetMRMLScene(scene.GetPointer());
+  layoutManager.setMRMLScene(scene.GetPointer());
+
+  layoutManager.setLayout(vtkMRMLLayoutNode::SlicerLayoutConventionalView);
+  qMRMLThreeDWidget* threeDWidget = layoutManager.threeDWidget(0);
+  qMRMLSliceWidget* redSliceWidget = layoutManager.sliceWidget("Red");
+  if (!threeDWidget || !redSliceWidget)
+    {
+    std::cerr << "Line " << __LINE__ << " - Missing views in conventional layout" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  QSignalSpy layoutChangedSpy(&layoutManager, SIGNAL(layoutChanged(int)));
+
+  // Panel sizes are saved in the layout node but do not change the layout
+  layoutNode->SetMainPanelSize(layoutNode->GetMainPanelSize() + 10);
+  if (layoutChangedSpy.count() != 0)
+    {
+    std::cerr << "Line " << __LINE__ << " - Layout was set up again: "
+              << layoutChangedSpy.count() << " layoutChanged signals" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  layoutManager.setLayout(vtkMRMLLayoutNode::SlicerLayoutOneUpRedSliceView);
+  layoutManager.setLayout(vtkMRMLLayoutNode::SlicerLayoutConventionalView);
+  if (layoutChangedSpy.count() != 2)
+    {
+    std::cerr << "Line " << __LINE__ << " - Expected 2 layoutChanged signals, got "
+              << layoutChangedSpy.count() << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (layoutManager.threeDWidget(0) != threeDWidget ||
+      layoutManager.sliceWidget("Red") != redSliceWidget)
+    {
+    std::cerr << "Line " << __LINE__ << " - View widgets were recreated" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -98,6 +98,14 @@ int qMRMLNodeComboBoxTest9( int argc, char * argv [] )
   filter = nodeSelectorB.sortFilterProxyModel()->attributeFilter("vtkMRMLScalarVolumeNode", testingAttributeName);
   CHECK_QVARIANT(filter, QVariant("a"));
 
+  // modified nodes are filtered again
+  validAttributeNode->SetAttribute(testingAttributeName, "b");
+  CHECK_INT(nodeSelectorB.nodeCount(), 0);
+  emptyStringAttributeNode->SetAttribute(testingAttributeName, "a");
+  CHECK_INT(nodeSelectorB.nodeCount(), 1);
+  validAttributeNode->SetAttribute(testingAttributeName, "a");
+  CHECK_INT(nodeSelectorB.nodeCount(), 2);
+
   nodeSelectorB.removeAttribute("vtkMRMLScalarVolumeNode", testingAttributeName);
   CHECK_INT(nodeSelectorB.nodeCount(), 3);
 
@@ -0,0 +1,84 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+
+// qMRML includes
+#include "qMRMLRenderScheduler.h"
+#include "qMRMLThreeDView.h"
+
+// STD includes
+#include <iostream>
+
+//-----------------------------------------------------------------------------
+int qMRMLRenderSchedulerTest1(int argc, char * argv [] )
+{
+  QApplication app(argc, argv);
+
+  qMRMLRenderScheduler scheduler;
+  qMRMLThreeDView view;
+  view.show();
+  app.processEvents();
+
+  // Multiple requests are rendered once
+  scheduler.requestRender(&view);
+  scheduler.requestRender(&view);
+  if (!scheduler.isRenderPending(&view))
+    {
+    std::cerr << "Line " << __LINE__ << " - render request is not pending" << std::endl;
+    return EXIT_FAILURE;
+    }
+  scheduler.renderPendingViews();
+  if (scheduler.isRenderPending(&view) || scheduler.renderCount(&view) != 1)
+    {
+    std::cerr << "Line " << __LINE__ << " - expected 1 render, got "
+              << scheduler.renderCount(&view) << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (scheduler.lastFrameTime(&view) < 0. ||
+      scheduler.averageFrameTime(&view) != scheduler.lastFrameTime(&view))
+    {
+    std::cerr << "Line " << __LINE__ << " - invalid frame time statistics" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Hidden views are rendered when shown
+  view.hide();
+  scheduler.requestRender(&view);
+  scheduler.renderPendingViews();
+  if (!scheduler.isRenderPending(&view) || scheduler.renderCount(&view) != 1)
+    {
+    std::cerr << "Line " << __LINE__ << " - hidden view is rendered" << std::endl;
+    return EXIT_FAILURE;
+    }
+  view.show();
+  app.processEvents();
+  scheduler.renderPendingViews();
+  if (scheduler.isRenderPending(&view) || scheduler.renderCount(&view) != 2)
+    {
+    std::cerr << "Line " << __LINE__ << " - view is not rendered when shown" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  scheduler.resetStatistics();
+  if (scheduler.renderCount(&view) != 0)
+    {
+    std::cerr << "Line " << __LINE__ << " - statistics are not reset" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
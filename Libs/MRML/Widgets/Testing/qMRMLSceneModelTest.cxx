@@ -28,6 +28,7 @@
 // MRML includes
 #include "qMRMLSceneFactoryWidget.h"
 #include "qMRMLSceneModel.h"
+#include <vtkMRMLModelNode.h>
 #include <vtkMRMLScene.h>
 #include <vtkMRMLViewNode.h>
 
@@ -43,6 +44,8 @@ private slots:
   void testDefaults();
   void testSetsAndGets();
   void testSetScene();
+  void testDelayedNodeUpdate();
+  void testNodeClasses();
   void testSetColumns();
   void testSetColumns_data();
   void testSetColumnsWithScene();
@@ -55,6 +58,8 @@ void qMRMLSceneModelTester::testDefaults()
   qMRMLSceneModel sceneModel;
   QCOMPARE(sceneModel.listenNodeModifiedEvent(), qMRMLSceneModel::OnlyVisibleNodes);
   QCOMPARE(sceneModel.lazyUpdate(), false);
+  QCOMPARE(sceneModel.delayedNodeUpdate(), false);
+  QCOMPARE(sceneModel.nodeClasses(), QStringList());
   QCOMPARE(sceneModel.nameColumn(), 0);
   QCOMPARE(sceneModel.idColumn(), -1);
   QCOMPARE(sceneModel.checkableColumn(), -1);
@@ -108,6 +113,68 @@ void qMRMLSceneModelTester::testSetScene()
   QCOMPARE(sceneModel.columnCount(sceneModel.mrmlSceneIndex()), 1);
 }
 
+// ----------------------------------------------------------------------------
+void qMRMLSceneModelTester::testDelayedNodeUpdate()
+{
+  qMRMLSceneModel sceneModel;
+  sceneModel.setListenNodeModifiedEvent(qMRMLSceneModel::AllNodes);
+  sceneModel.setDelayedNodeUpdate(true);
+  QCOMPARE(sceneModel.delayedNodeUpdate(), true);
+
+  vtkNew<vtkMRMLScene> scene;
+  sceneModel.setMRMLScene(scene.GetPointer());
+  vtkNew<vtkMRMLViewNode> node;
+  node->SetName("first");
+  scene->AddNode(node.GetPointer());
+  QCOMPARE(sceneModel.itemFromNode(node.GetPointer())->text(), QString("first"));
+
+  // Items are updated once control returns to the event loop
+  node->SetName("second");
+  node->SetName("third");
+  QCOMPARE(sceneModel.itemFromNode(node.GetPointer())->text(), QString("first"));
+  QCoreApplication::processEvents();
+  QCOMPARE(sceneModel.itemFromNode(node.GetPointer())->text(), QString("third"));
+
+  // Pending updates are applied when the delay is turned off
+  node->SetName("fourth");
+  sceneModel.setDelayedNodeUpdate(false);
+  QCOMPARE(sceneModel.itemFromNode(node.GetPointer())->text(), QString("fourth"));
+
+  // Removed nodes are not updated anymore
+  sceneModel.setDelayedNodeUpdate(true);
+  node->SetName("fifth");
+  scene->RemoveNode(node.GetPointer());
+  QCoreApplication::processEvents();
+  QVERIFY(sceneModel.itemFromNode(node.GetPointer()) == 0);
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLSceneModelTester::testNodeClasses()
+{
+  qMRMLSceneModel sceneModel;
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLViewNode> viewNode;
+  scene->AddNode(viewNode.GetPointer());
+  vtkNew<vtkMRMLModelNode> modelNode;
+  scene->AddNode(modelNode.GetPointer());
+
+  sceneModel.setNodeClasses(QStringList() << "vtkMRMLModelNode");
+  sceneModel.setMRMLScene(scene.GetPointer());
+  QVERIFY(sceneModel.itemFromNode(viewNode.GetPointer()) == 0);
+  QVERIFY(sceneModel.itemFromNode(modelNode.GetPointer()) != 0);
+
+  // Nodes added later are filtered too
+  vtkNew<vtkMRMLViewNode> viewNode2;
+  scene->AddNode(viewNode2.GetPointer());
+  QVERIFY(sceneModel.itemFromNode(viewNode2.GetPointer()) == 0);
+
+  // Empty list accepts all the nodes
+  sceneModel.setNodeClasses(QStringList());
+  QVERIFY(sceneModel.itemFromNode(viewNode.GetPointer()) != 0);
+  QVERIFY(sceneModel.itemFromNode(viewNode2.GetPointer()) != 0);
+  QVERIFY(sceneModel.itemFromNode(modelNode.GetPointer()) != 0);
+}
+
 // ----------------------------------------------------------------------------
 void qMRMLSceneModelTester::testSetColumns()
 {
@@ -17,6 +17,8 @@
 
 // Qt includes
 #include <QDebug>
+#include <QApplication>
+#include <QDesktopWidget>
 #include <QEvent>
 #include <QFileInfo>
 #include <QHBoxLayout>
@@ -91,6 +93,7 @@ qMRMLChartViewPrivate::qMRMLChartViewPrivate(qMRMLChartView& object)
   this->ColorLogic = 0;
   this->PinButton = 0;
   this->PopupWidget = 0;
+  this->MaximumNumberOfBins = 0;
 }
 
 //---------------------------------------------------------------------------
@@ -202,6 +205,7 @@ void qMRMLChartViewPrivate::updateWidgetFromMRML()
   if (!chartnodeid)
     {
     q->setHtml("");
+    this->LastHtml = QString();
     //q->show();
     return;
     }
@@ -211,10 +215,17 @@ void qMRMLChartViewPrivate::updateWidgetFromMRML()
   if (!cn)
     {
     q->setHtml("");
+    this->LastHtml = QString();
     //q->show();
     return;
     }
 
+  // Series with much more points than pixels are decimated, the screen width
+  // is used so that the chart does not need to be regenerated when resized.
+  this->MaximumNumberOfBins = static_cast<unsigned int>(
+    qMax(QApplication::desktop()->screenGeometry(q).width(), q->width()));
+  this->DecimatedPointIndices.clear();
+
 
   // Generate javascript for the data, ticks, options
   //
@@ -340,8 +351,15 @@ void qMRMLChartViewPrivate::updateWidgetFromMRML()
 
   //qDebug() << plot.join("");
 
-  // show the plot
-  q->setHtml(plot.join(""));
+  // show the plot, reloading the page is slow so it is skipped if the chart
+  // did not change
+  QString html = plot.join("");
+  if (html == this->LastHtml)
+    {
+    return;
+    }
+  this->LastHtml = html;
+  q->setHtml(html);
   //q->show();
 
 
@@ -521,31 +539,110 @@ QString qMRMLChartViewPrivate::seriesDateTicksString(vtkMRMLDoubleArrayNode *dn)
 }
 
 //---------------------------------------------------------------------------
-QString qMRMLChartViewPrivate::seriesDataString(vtkMRMLDoubleArrayNode *dn)
+QString qMRMLChartViewPrivate::seriesDataString(vtkMRMLDoubleArrayNode *dn, int seriesIndex)
 {
-  QStringList data;
-
-  data << "[";
+  QString data("[");
 
   if (dn)
     {
+    QVector<unsigned int> pointIndices;
+    bool decimated = (seriesIndex >= 0
+      && this->decimatedPointIndices(dn, this->MaximumNumberOfBins, pointIndices));
+    if (decimated)
+      {
+      this->DecimatedPointIndices[seriesIndex] = pointIndices;
+      }
+    unsigned int numberOfPoints = (decimated ? pointIndices.size() : dn->GetSize());
+    // about 30 characters per point
+    data.reserve(30 * numberOfPoints + 2);
+
     double x, y;
 
     // for each value
-    for (unsigned int j = 0; j < dn->GetSize(); ++j)
+    for (unsigned int j = 0; j < numberOfPoints; ++j)
       {
-      dn->GetXYValue(j, &x, &y);
-      data << "[" << QString("%1").arg(x) << ", " << QString("%1").arg(y) << "]";
-      if (j < dn->GetSize()-1)
+      dn->GetXYValue(decimated ? pointIndices[j] : j, &x, &y);
+      data.append('[');
+      data.append(QString::number(x));
+      data.append(", ");
+      data.append(QString::number(y));
+      data.append(']');
+      if (j < numberOfPoints-1)
         {
-        data << ",";
+        data.append(',');
         }
       }
     }
 
-  data << "]";
+  data.append(']');
 
-  return data.join("");
+  return data;
+}
+
+//---------------------------------------------------------------------------
+bool qMRMLChartViewPrivate::decimatedPointIndices(vtkMRMLDoubleArrayNode *dn,
+  unsigned int maximumNumberOfBins, QVector<unsigned int>& pointIndices)
+{
+  unsigned int numberOfPoints = dn->GetSize();
+  if (maximumNumberOfBins == 0 || numberOfPoints <= 2 * maximumNumberOfBins + 2)
+    {
+    return false;
+    }
+  pointIndices.clear();
+  pointIndices.reserve(2 * maximumNumberOfBins + 2);
+  pointIndices.push_back(0);
+  double x, y;
+  for (unsigned int bin = 0; bin < maximumNumberOfBins; ++bin)
+    {
+    unsigned int firstIndex = static_cast<unsigned int>(
+      static_cast<unsigned long long>(bin) * numberOfPoints / maximumNumberOfBins);
+    unsigned int lastIndex = static_cast<unsigned int>(
+      static_cast<unsigned long long>(bin + 1) * numberOfPoints / maximumNumberOfBins);
+    unsigned int minimumIndex = firstIndex;
+    unsigned int maximumIndex = firstIndex;
+    double minimum = 0.0;
+    double maximum = 0.0;
+    for (unsigned int j = firstIndex; j < lastIndex; ++j)
+      {
+      dn->GetXYValue(j, &x, &y);
+      if (j == firstIndex || y < minimum)
+        {
+        minimum = y;
+        minimumIndex = j;
+        }
+      if (j == firstIndex || y > maximum)
+        {
+        maximum = y;
+        maximumIndex = j;
+        }
+      }
+    // keep the original order of the points
+    unsigned int binIndices[2] = { qMin(minimumIndex, maximumIndex), qMax(minimumIndex, maximumIndex) };
+    for (int i = 0; i < 2; ++i)
+      {
+      if (binIndices[i] != pointIndices.back())
+        {
+        pointIndices.push_back(binIndices[i]);
+        }
+      }
+    }
+  if (pointIndices.back() != numberOfPoints - 1)
+    {
+    pointIndices.push_back(numberOfPoints - 1);
+    }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+unsigned int qMRMLChartViewPrivate::arrayPointIndex(int series, int pointidx)const
+{
+  QHash<int, QVector<unsigned int> >::const_iterator it = this->DecimatedPointIndices.constFind(series);
+  if (it == this->DecimatedPointIndices.constEnd()
+    || pointidx < 0 || pointidx >= it.value().size())
+    {
+    return pointidx;
+    }
+  return it.value()[pointidx];
 }
 
 //---------------------------------------------------------------------------
@@ -613,6 +710,10 @@ QString qMRMLChartViewPrivate::lineData(vtkMRMLChartNode *cn)
   vtkStringArray *arrayIDs = cn->GetArrays();
   const char *xAxisType = cn->GetProperty("default", "xAxisType");
 
+  // only lines can be decimated, all the points are shown in scatter plots
+  const char *type = cn->GetProperty("default", "type");
+  bool decimate = (!type || !strcmp(type, "Line"));
+
   data << "var data = [";
 
   // for each curve
@@ -632,7 +733,7 @@ QString qMRMLChartViewPrivate::lineData(vtkMRMLChartNode *cn)
       else
         {
         // convert the data array into a string of quantitative values
-        data << this->seriesDataString(dn);
+        data << this->seriesDataString(dn, decimate ? idx : -1);
         }
 
       if (idx < arrayIDs->GetNumberOfValues()-1)
@@ -1642,7 +1743,7 @@ void qMRMLChartViewPrivate::onDataMouseOver(int series, int pointidx, double x,
   if (series >= 0 && series < arrayIDs->GetNumberOfValues())
     {
     //qDebug() << "Array: " << arrayIDs->GetValue(series) << ", Pointidx: " << pointidx << ": " << x << ", " << y;
-    emit q->dataMouseOver(arrayIDs->GetValue(series), pointidx, x, y);
+    emit q->dataMouseOver(arrayIDs->GetValue(series), this->arrayPointIndex(series, pointidx), x, y);
     }
 }
 
@@ -1687,7 +1788,7 @@ void qMRMLChartViewPrivate::onDataPointClicked(int series, int pointidx, double
   if (series >= 0 && series < arrayIDs->GetNumberOfValues())
     {
     //qDebug() << "Array: " << arrayIDs->GetValue(series) << ", Pointidx: " << pointidx << ": " << x << ", " << y;
-    emit q->dataPointClicked(arrayIDs->GetValue(series), pointidx, x, y);
+    emit q->dataPointClicked(arrayIDs->GetValue(series), this->arrayPointIndex(series, pointidx), x, y);
     }
 }
 
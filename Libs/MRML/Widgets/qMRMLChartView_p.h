@@ -15,6 +15,10 @@
 // Qt includes
 class QToolButton;
 
+// Qt includes
+#include <QHash>
+#include <QVector>
+
 // VTK includes
 #include <vtkWeakPointer.h>
 
@@ -84,8 +88,20 @@ protected:
   QString seriesColorsString(vtkMRMLColorNode*, vtkMRMLDoubleArrayNode*);
 
   // Convert a data array into a string that can be passed as the data
-  // for a series.
-  QString seriesDataString(vtkMRMLDoubleArrayNode*);
+  // for a series. If seriesIndex is not negative then series with more points
+  // than the view can display are decimated, the indices of the kept points
+  // are stored in DecimatedPointIndices.
+  QString seriesDataString(vtkMRMLDoubleArrayNode*, int seriesIndex = -1);
+
+  // Get the indices of the points of a series to display if the series is
+  // decimated: the first and last points and the points with minimum and
+  // maximum values for each of the maximumNumberOfBins consecutive ranges of
+  // points. Returns false if the series does not need to be decimated.
+  static bool decimatedPointIndices(vtkMRMLDoubleArrayNode*,
+    unsigned int maximumNumberOfBins, QVector<unsigned int>& pointIndices);
+
+  // Map the index of a point in the displayed series to the index in the array
+  unsigned int arrayPointIndex(int series, int pointidx)const;
 
   // Convert a data array into a string that can be passed as the data
   // for a series. This version will use values in the ArrayNode to
@@ -183,6 +199,13 @@ protected:
 
   QToolButton*                       PinButton;
   ctkPopupWidget*                    PopupWidget;
+
+  // Series are decimated to about two points per pixel column
+  unsigned int                       MaximumNumberOfBins;
+  // Index of the displayed points in the arrays of decimated series
+  QHash<int, QVector<unsigned int> > DecimatedPointIndices;
+  // Page currently shown, to avoid reloading the same chart
+  QString                            LastHtml;
 };
 
 #endif
@@ -49,6 +49,7 @@ namespace
     NameColumn = 0,
     ElapsedTimeColumn,
     TotalTimeColumn,
+    InvocationCountColumn,
     CommentColumn
   };
 }
@@ -257,6 +258,10 @@ void qMRMLEventBrokerWidgetPrivate::addObservation(vtkObservation* observation)
   observationItem->setText(TotalTimeColumn, QString::number(observation->GetTotalElapsedTime()) + " s");
   observationItem->setToolTip(TotalTimeColumn, QString::number(1. / observation->GetTotalElapsedTime()) + " fps");
   observationItem->setFlags(observationItem->flags() | Qt::ItemIsEditable);
+  // Invocation count
+  observationItem->setText(InvocationCountColumn, QString::number(observation->GetInvocationCount()));
+  observationItem->setToolTip(InvocationCountColumn, QString("Maximum nesting level: %1")
+    .arg(observation->GetMaximumNestingLevel()));
   // Comments
   observationItem->setText(CommentColumn, observation->GetComment());
 
@@ -272,7 +277,7 @@ void qMRMLEventBrokerWidgetPrivate::setupUi(QWidget* parentWidget)
   this->ConnectionsTreeWidget = new QTreeWidget;
 
   QStringList headers;
-  headers << "Object/Type"  << "Elapsed" << "Total" << "Comment";
+  headers << "Object/Type"  << "Elapsed" << "Total" << "Calls" << "Comment";
   this->ConnectionsTreeWidget->setHeaderLabels(headers);
 
   QObject::connect(this->ConnectionsTreeWidget, SIGNAL(itemChanged(QTreeWidgetItem*,int)),
@@ -367,13 +372,7 @@ void qMRMLEventBrokerWidget::onCurrentItemChanged(QTreeWidgetItem* currentItem)
 //------------------------------------------------------------------------------
 void qMRMLEventBrokerWidget::resetElapsedTimes()
 {
-  vtkEventBroker* eventBroker = vtkEventBroker::GetInstance();
-  for (int i = 0; i < eventBroker->GetNumberOfObservations(); ++i)
-    {
-    vtkObservation* observation = eventBroker->GetNthObservation(i);
-    observation->SetTotalElapsedTime(0.);
-    observation->SetLastElapsedTime(0.);
-    }
+  vtkEventBroker::GetInstance()->ResetObservationStatistics();
   this->refresh();
 }
 
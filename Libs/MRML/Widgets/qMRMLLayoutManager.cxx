@@ -296,6 +296,7 @@ qMRMLLayoutManagerPrivate::qMRMLLayoutManagerPrivate(qMRMLLayoutManager& object)
   this->ActiveMRMLThreeDViewNode = 0;
   this->ActiveMRMLChartViewNode = 0;
   this->ActiveMRMLTableViewNode = 0;
+  this->AppliedViewArrangement = -1;
   //this->SavedCurrentViewArrangement = vtkMRMLLayoutNode::SlicerLayoutNone;
 }
 
@@ -554,6 +555,8 @@ void qMRMLLayoutManagerPrivate::onNodeRemovedEvent(vtkObject* scene, vtkObject*
       {
       mrmlViewFactory->onViewNodeRemoved(viewNode);
       }
+    // The view widget may be in the current layout
+    this->resetAppliedLayout();
     }
   else if (node->IsA("vtkMRMLSegmentationNode"))
     {
@@ -569,6 +572,7 @@ void qMRMLLayoutManagerPrivate::onSceneRestoredEvent()
   if (this->MRMLLayoutNode)
     {
     // trigger an update to the layout
+    this->resetAppliedLayout();
     this->MRMLLayoutNode->Modified();
     }
 }
@@ -583,6 +587,7 @@ void qMRMLLayoutManagerPrivate::onSceneAboutToBeClosedEvent()
     }
   // remove the layout during closing.
   q->clearLayout();
+  this->resetAppliedLayout();
 }
 
 //------------------------------------------------------------------------------
@@ -626,7 +631,6 @@ void qMRMLLayoutManagerPrivate::updateLayoutFromMRMLScene()
   this->setMRMLLayoutNode(this->MRMLLayoutLogic->GetLayoutNode());
 }
 
-/*
 //------------------------------------------------------------------------------
 bool qMRMLLayoutManagerPrivate::startUpdateLayout()
 {
@@ -650,7 +654,6 @@ void qMRMLLayoutManagerPrivate::endUpdateLayout(bool updatesEnabled)
     }
   q->viewport()->setUpdatesEnabled(updatesEnabled);
 }
-*/
 
 //------------------------------------------------------------------------------
 void qMRMLLayoutManagerPrivate::updateLayoutInternal()
@@ -665,16 +668,37 @@ void qMRMLLayoutManagerPrivate::updateLayoutInternal()
     return;
     }
 
+  QString layoutDescription = QString(
+    this->MRMLLayoutNode ?
+    this->MRMLLayoutNode->GetCurrentLayoutDescription() : "");
+  // The layout node is also modified when the panel sizes or visibilities
+  // change. The view widgets are kept by the view factories, but rebuilding
+  // the layout widgets and reparenting the views is expensive.
+  if (layout == this->AppliedViewArrangement &&
+      layoutDescription == this->AppliedLayoutDescription)
+    {
+    return;
+    }
+
   // TBD: modify the dom doc manually, don't create a new one
   QDomDocument newLayout;
-  newLayout.setContent(QString(
-    this->MRMLLayoutNode ?
-    this->MRMLLayoutNode->GetCurrentLayoutDescription() : ""));
+  newLayout.setContent(layoutDescription);
+  bool updatesEnabled = this->startUpdateLayout();
   q->setLayout(newLayout);
+  this->endUpdateLayout(updatesEnabled);
+  this->AppliedViewArrangement = layout;
+  this->AppliedLayoutDescription = layoutDescription;
 
   emit q->layoutChanged(layout);
 }
 
+//------------------------------------------------------------------------------
+void qMRMLLayoutManagerPrivate::resetAppliedLayout()
+{
+  this->AppliedViewArrangement = -1;
+  this->AppliedLayoutDescription = QString();
+}
+
 //------------------------------------------------------------------------------
 void qMRMLLayoutManagerPrivate::setLayoutNumberOfCompareViewRowsInternal(int num)
 {
@@ -813,6 +837,7 @@ void qMRMLLayoutManager
 void qMRMLLayoutManager::onViewportChanged()
 {
   Q_D(qMRMLLayoutManager);
+  d->resetAppliedLayout();
   d->updateLayoutFromMRMLScene();
   this->Superclass::onViewportChanged();
 }
@@ -950,6 +975,7 @@ void qMRMLLayoutManager::setMRMLScene(vtkMRMLScene* scene)
     {
     viewFactory->setMRMLScene(d->MRMLScene);
     }
+  d->resetAppliedLayout();
   d->updateLayoutFromMRMLScene();
 }
 
@@ -91,14 +91,20 @@ public:
   void setActiveMRMLChartViewNode(vtkMRMLChartViewNode * node);
   void setActiveMRMLTableViewNode(vtkMRMLTableViewNode * node);
 
-  /// Enable/disable paint event associated with the TargetWidget
-  //bool startUpdateLayout();
-  //void endUpdateLayout(bool updateEnabled);
+  /// Enable/disable paint event associated with the viewport
+  bool startUpdateLayout();
+  void endUpdateLayout(bool updatesEnabled);
 
   /// Refresh the viewport with the current layout from the layout
   /// layout node. Empty the view if there is no layout node.
+  /// Nothing is done if the layout is the one already set up.
+  /// \sa resetAppliedLayout()
   void updateLayoutInternal();
 
+  /// Force the next updateLayoutInternal() to set up the layout again,
+  /// e.g. because the viewport was cleared or view widgets were deleted.
+  void resetAppliedLayout();
+
   void setLayoutNumberOfCompareViewRowsInternal(int num);
   void setLayoutNumberOfCompareViewColumnsInternal(int num);
 
@@ -143,6 +149,9 @@ public:
   vtkMRMLViewNode*        ActiveMRMLThreeDViewNode;
   vtkMRMLChartViewNode*   ActiveMRMLChartViewNode;
   vtkMRMLTableViewNode*   ActiveMRMLTableViewNode;
+  /// Layout currently set up in the viewport
+  int                     AppliedViewArrangement;
+  QString                 AppliedLayoutDescription;
 protected:
   void showWidget(QWidget* widget);
 };
@@ -20,6 +20,7 @@
 
 // Qt includes
 #include <QDebug>
+#include <QTimer>
 
 // qMRML includes
 #include "qMRMLUtils.h"
@@ -43,6 +44,8 @@ public:
     this->CoordinateReference = qMRMLMatrixWidget::GLOBAL;
     this->MRMLTransformNode = 0;
     this->UserUpdates = true;
+    this->UpdateTimer = 0;
+    this->UpdatePending = false;
     }
 
   qMRMLMatrixWidget::CoordinateReferenceType   CoordinateReference;
@@ -52,6 +55,10 @@ public:
   vtkSmartPointer<vtkTransform>                Transform;
   // Indicates whether the changes come from the user or are programatic
   bool                                         UserUpdates;
+  // Throttles the updates from the transform node
+  QTimer*                                      UpdateTimer;
+  // Indicates whether the transform node has been modified since the last update
+  bool                                         UpdatePending;
 };
 
 // --------------------------------------------------------------------------
@@ -59,8 +66,14 @@ qMRMLMatrixWidget::qMRMLMatrixWidget(QWidget* _parent)
   : Superclass(_parent)
   , d_ptr(new qMRMLMatrixWidgetPrivate)
 {
+  Q_D(qMRMLMatrixWidget);
   connect(this, SIGNAL(matrixChanged()),
           this, SLOT(updateTransformNode()));
+  d->UpdateTimer = new QTimer(this);
+  d->UpdateTimer->setSingleShot(true);
+  d->UpdateTimer->setInterval(0);
+  connect(d->UpdateTimer, SIGNAL(timeout()),
+          this, SLOT(onUpdateTimeout()));
 }
 
 // --------------------------------------------------------------------------
@@ -107,7 +120,7 @@ void qMRMLMatrixWidget::setMRMLTransformNode(vtkMRMLTransformNode* transformNode
 
   this->qvtkReconnect(d->MRMLTransformNode, transformNode,
                       vtkMRMLTransformableNode::TransformModifiedEvent,
-                      this, SLOT(updateMatrix()));
+                      this, SLOT(onTransformModified()));
 
   d->MRMLTransformNode = transformNode;
 
@@ -123,10 +136,55 @@ vtkMRMLTransformNode* qMRMLMatrixWidget::mrmlTransformNode()const
   return d->MRMLTransformNode;
 }
 
+// --------------------------------------------------------------------------
+void qMRMLMatrixWidget::setMinimumUpdateInterval(int msec)
+{
+  Q_D(qMRMLMatrixWidget);
+  d->UpdateTimer->setInterval(qMax(msec, 0));
+}
+
+// --------------------------------------------------------------------------
+int qMRMLMatrixWidget::minimumUpdateInterval()const
+{
+  Q_D(const qMRMLMatrixWidget);
+  return d->UpdateTimer->interval();
+}
+
+// --------------------------------------------------------------------------
+void qMRMLMatrixWidget::onTransformModified()
+{
+  Q_D(qMRMLMatrixWidget);
+  if (d->UpdateTimer->interval() <= 0)
+    {
+    this->updateMatrix();
+    return;
+    }
+  if (d->UpdateTimer->isActive())
+    {
+    // the matrix will be updated at the end of the interval
+    d->UpdatePending = true;
+    return;
+    }
+  this->updateMatrix();
+  d->UpdateTimer->start();
+}
+
+// --------------------------------------------------------------------------
+void qMRMLMatrixWidget::onUpdateTimeout()
+{
+  Q_D(qMRMLMatrixWidget);
+  if (d->UpdatePending)
+    {
+    this->updateMatrix();
+    d->UpdateTimer->start();
+    }
+}
+
 // --------------------------------------------------------------------------
 void qMRMLMatrixWidget::updateMatrix()
 {
   Q_D(qMRMLMatrixWidget);
+  d->UpdatePending = false;
 
   if (d->MRMLTransformNode == 0)
     {
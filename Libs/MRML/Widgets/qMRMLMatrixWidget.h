@@ -38,6 +38,7 @@ class QMRML_WIDGETS_EXPORT qMRMLMatrixWidget : public ctkVTKAbstractMatrixWidget
   Q_OBJECT
   QVTK_OBJECT
   Q_PROPERTY(CoordinateReferenceType coordinateReference READ coordinateReference WRITE setCoordinateReference)
+  Q_PROPERTY(int minimumUpdateInterval READ minimumUpdateInterval WRITE setMinimumUpdateInterval)
   Q_ENUMS(CoordinateReferenceType)
 
 public:
@@ -56,6 +57,17 @@ public:
 
   vtkMRMLTransformNode* mrmlTransformNode()const;
 
+  ///
+  /// Minimum time (in msec) between two updates of the matrix when the
+  /// transform node is modified. Modifications within the interval are
+  /// coalesced: the matrix is updated once with the latest transform at the
+  /// end of the interval. It prevents the widget from slowing down the
+  /// application when the transform is streamed at a high rate (e.g., by a
+  /// tracking device).
+  /// 0 (default) updates the matrix at each modification.
+  void setMinimumUpdateInterval(int msec);
+  int minimumUpdateInterval()const;
+
 public slots:
   ///
   /// Set the MRML node of interest
@@ -67,6 +79,12 @@ protected slots:
   /// Triggered upon MRML transform node updates
   void updateMatrix();
 
+  ///
+  /// Triggered upon MRML transform node updates, calls updateMatrix()
+  /// immediately or after minimumUpdateInterval.
+  void onTransformModified();
+  void onUpdateTimeout();
+
   ///
   /// Triggered when the user modifies the cells of the matrix.
   /// Synchronize with the node.
@@ -871,6 +871,21 @@ void qMRMLNodeComboBox::setNodeTypes(const QStringList& _nodeTypes)
   QStringList nodeTypesFiltered = _nodeTypes;
   nodeTypesFiltered.removeAll("");
 
+  // The default scene model has no hierarchy, nodes of other types don't need
+  // to be in the model at all. It spares each combobox the processing of the
+  // scene events of the unrelated nodes.
+  if (d->MRMLSceneModel->metaObject() == &qMRMLSceneModel::staticMetaObject
+    && d->MRMLSceneModel->nodeClasses() != nodeTypesFiltered)
+    {
+    QString oldCurrentNode = this->currentNodeID();
+    d->MRMLSceneModel->setNodeClasses(nodeTypesFiltered);
+    if (d->MRMLSceneModel->mrmlScene())
+      {
+      // the node items have been recreated, try to set the current item back
+      this->setCurrentNodeID(oldCurrentNode);
+      }
+    }
+
   this->sortFilterProxyModel()->setNodeTypes(nodeTypesFiltered);
   d->updateDefaultText();
   d->updateActionItems();
@@ -0,0 +1,286 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+#include <QCursor>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QSet>
+#include <QTimer>
+
+// CTK includes
+#include <ctkVTKAbstractView.h>
+
+// qMRML includes
+#include "qMRMLRenderScheduler.h"
+
+//------------------------------------------------------------------------------
+class qMRMLRenderSchedulerPrivate
+{
+  Q_DECLARE_PUBLIC(qMRMLRenderScheduler);
+protected:
+  qMRMLRenderScheduler* const q_ptr;
+public:
+  qMRMLRenderSchedulerPrivate(qMRMLRenderScheduler& object);
+
+  void init();
+
+  /// Return true if the view is shown and not completely covered.
+  bool isViewVisible(ctkVTKAbstractView* view)const;
+
+  /// Milliseconds to wait before the next frame can be rendered.
+  int timeToNextFrame()const;
+
+  struct ViewStatistics
+    {
+    ViewStatistics() : RenderCount(0), LastFrameTime(0.), TotalFrameTime(0.) {}
+    int RenderCount;
+    double LastFrameTime;
+    double TotalFrameTime;
+    };
+
+  double MaximumFrameRate;
+  QTimer FrameTimer;
+  QElapsedTimer LastFrame;
+  /// Views to render in the next frame
+  QList< QPointer<ctkVTKAbstractView> > PendingViews;
+  /// Views that had a render request while hidden
+  QSet<QObject*> DeferredViews;
+  /// Views the scheduler has installed its event filter on
+  QSet<QObject*> ObservedViews;
+  QHash<QObject*, ViewStatistics> Statistics;
+};
+
+//------------------------------------------------------------------------------
+qMRMLRenderSchedulerPrivate::qMRMLRenderSchedulerPrivate(qMRMLRenderScheduler& object)
+  : q_ptr(&object)
+{
+  this->MaximumFrameRate = 60.;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLRenderSchedulerPrivate::init()
+{
+  Q_Q(qMRMLRenderScheduler);
+  this->FrameTimer.setSingleShot(true);
+  QObject::connect(&this->FrameTimer, SIGNAL(timeout()),
+                   q, SLOT(renderPendingViews()));
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLRenderSchedulerPrivate::isViewVisible(ctkVTKAbstractView* view)const
+{
+  return view->isVisible() && !view->visibleRegion().isEmpty();
+}
+
+//------------------------------------------------------------------------------
+int qMRMLRenderSchedulerPrivate::timeToNextFrame()const
+{
+  if (!this->LastFrame.isValid())
+    {
+    return 0;
+    }
+  int framePeriod = static_cast<int>(1000. / this->MaximumFrameRate);
+  int elapsed = static_cast<int>(this->LastFrame.elapsed());
+  return elapsed < framePeriod ? framePeriod - elapsed : 0;
+}
+
+//------------------------------------------------------------------------------
+qMRMLRenderScheduler::qMRMLRenderScheduler(QObject* parentObject)
+  : Superclass(parentObject)
+  , d_ptr(new qMRMLRenderSchedulerPrivate(*this))
+{
+  Q_D(qMRMLRenderScheduler);
+  d->init();
+}
+
+//------------------------------------------------------------------------------
+qMRMLRenderScheduler::~qMRMLRenderScheduler()
+{
+}
+
+//------------------------------------------------------------------------------
+qMRMLRenderScheduler* qMRMLRenderScheduler::instance()
+{
+  static QPointer<qMRMLRenderScheduler> Instance;
+  if (Instance.isNull())
+    {
+    Instance = new qMRMLRenderScheduler(QCoreApplication::instance());
+    }
+  return Instance;
+}
+
+//------------------------------------------------------------------------------
+double qMRMLRenderScheduler::maximumFrameRate()const
+{
+  Q_D(const qMRMLRenderScheduler);
+  return d->MaximumFrameRate;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLRenderScheduler::setMaximumFrameRate(double framesPerSecond)
+{
+  Q_D(qMRMLRenderScheduler);
+  d->MaximumFrameRate = qMax(framesPerSecond, 1.);
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLRenderScheduler::isRenderPending(ctkVTKAbstractView* view)const
+{
+  Q_D(const qMRMLRenderScheduler);
+  return d->PendingViews.contains(view) || d->DeferredViews.contains(view);
+}
+
+//------------------------------------------------------------------------------
+int qMRMLRenderScheduler::renderCount(ctkVTKAbstractView* view)const
+{
+  Q_D(const qMRMLRenderScheduler);
+  return d->Statistics.value(view).RenderCount;
+}
+
+//------------------------------------------------------------------------------
+double qMRMLRenderScheduler::lastFrameTime(ctkVTKAbstractView* view)const
+{
+  Q_D(const qMRMLRenderScheduler);
+  return d->Statistics.value(view).LastFrameTime;
+}
+
+//------------------------------------------------------------------------------
+double qMRMLRenderScheduler::averageFrameTime(ctkVTKAbstractView* view)const
+{
+  Q_D(const qMRMLRenderScheduler);
+  qMRMLRenderSchedulerPrivate::ViewStatistics statistics = d->Statistics.value(view);
+  return statistics.RenderCount > 0 ?
+    statistics.TotalFrameTime / statistics.RenderCount : 0.;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLRenderScheduler::resetStatistics()
+{
+  Q_D(qMRMLRenderScheduler);
+  d->Statistics.clear();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLRenderScheduler::requestRender(ctkVTKAbstractView* view)
+{
+  Q_D(qMRMLRenderScheduler);
+  if (!view)
+    {
+    return;
+    }
+  if (!d->ObservedViews.contains(view))
+    {
+    d->ObservedViews.insert(view);
+    view->installEventFilter(this);
+    connect(view, SIGNAL(destroyed(QObject*)),
+            this, SLOT(onViewDestroyed(QObject*)));
+    }
+  d->DeferredViews.remove(view);
+  if (!d->PendingViews.contains(view))
+    {
+    d->PendingViews << view;
+    }
+  if (!d->FrameTimer.isActive())
+    {
+    d->FrameTimer.start(d->timeToNextFrame());
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLRenderScheduler::renderPendingViews()
+{
+  Q_D(qMRMLRenderScheduler);
+  d->FrameTimer.stop();
+
+  // Render the view under the mouse first, that is the one the user
+  // interacts with.
+  QWidget* widgetUnderMouse = QApplication::widgetAt(QCursor::pos());
+  QList< QPointer<ctkVTKAbstractView> > views;
+  foreach(const QPointer<ctkVTKAbstractView>& view, d->PendingViews)
+    {
+    if (view.isNull())
+      {
+      continue;
+      }
+    if (widgetUnderMouse &&
+        (view.data() == widgetUnderMouse || view->isAncestorOf(widgetUnderMouse)))
+      {
+      views.prepend(view);
+      }
+    else
+      {
+      views.append(view);
+      }
+    }
+  d->PendingViews.clear();
+
+  foreach(const QPointer<ctkVTKAbstractView>& view, views)
+    {
+    // A view may be deleted by a slot connected to viewRendered()
+    if (view.isNull())
+      {
+      continue;
+      }
+    if (!d->isViewVisible(view))
+      {
+      // Hidden views are rendered when shown
+      d->DeferredViews.insert(view);
+      continue;
+      }
+    if (!view->renderEnabled())
+      {
+      // Let the view render when rendering is enabled again
+      view->scheduleRender();
+      continue;
+      }
+    QElapsedTimer renderTimer;
+    renderTimer.start();
+    view->forceRender();
+    double frameTime = renderTimer.nsecsElapsed() / 1000000.;
+
+    qMRMLRenderSchedulerPrivate::ViewStatistics& statistics = d->Statistics[view];
+    ++statistics.RenderCount;
+    statistics.LastFrameTime = frameTime;
+    statistics.TotalFrameTime += frameTime;
+    emit viewRendered(view, frameTime);
+    }
+  d->LastFrame.start();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLRenderScheduler::onViewDestroyed(QObject* view)
+{
+  Q_D(qMRMLRenderScheduler);
+  // PendingViews are guarded pointers, they are skipped once null
+  d->DeferredViews.remove(view);
+  d->ObservedViews.remove(view);
+  d->Statistics.remove(view);
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLRenderScheduler::eventFilter(QObject* object, QEvent* event)
+{
+  Q_D(qMRMLRenderScheduler);
+  if (event->type() == QEvent::Show && d->DeferredViews.contains(object))
+    {
+    this->requestRender(qobject_cast<ctkVTKAbstractView*>(object));
+    }
+  return this->Superclass::eventFilter(object, event);
+}
@@ -0,0 +1,96 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qMRMLRenderScheduler_h
+#define __qMRMLRenderScheduler_h
+
+// Qt includes
+#include <QObject>
+
+// CTK includes
+#include <ctkPimpl.h>
+
+#include "qMRMLWidgetsExport.h"
+
+class ctkVTKAbstractView;
+class qMRMLRenderSchedulerPrivate;
+
+/// \brief Application-wide scheduler of the render requests of the views.
+///
+/// Render requests of all the views (e.g. the ones of the displayable managers
+/// of slice and 3D views) are collected and the requested views are rendered
+/// together once per frame, at most \a maximumFrameRate times per second.
+/// A view is rendered only once per frame, however many times it is requested.
+/// The view under the mouse pointer is rendered first.
+/// Views that are hidden (e.g. because another view is maximized in the layout)
+/// or completely covered are not rendered, they are rendered when they are shown.
+///
+/// Render time of each view is measured and available from \a lastFrameTime()
+/// and \a averageFrameTime().
+/// \sa qMRMLThreeDView, qMRMLSliceView
+class QMRML_WIDGETS_EXPORT qMRMLRenderScheduler : public QObject
+{
+  Q_OBJECT
+  /// Maximum number of frames rendered per second. 60 by default.
+  Q_PROPERTY(double maximumFrameRate READ maximumFrameRate WRITE setMaximumFrameRate)
+public:
+  typedef QObject Superclass;
+  explicit qMRMLRenderScheduler(QObject* parent = 0);
+  virtual ~qMRMLRenderScheduler();
+
+  /// Scheduler shared by all the views of the application.
+  static qMRMLRenderScheduler* instance();
+
+  double maximumFrameRate()const;
+  void setMaximumFrameRate(double framesPerSecond);
+
+  /// Returns true if \a view has a render request that is not processed yet.
+  Q_INVOKABLE bool isRenderPending(ctkVTKAbstractView* view)const;
+
+  /// Number of times \a view has been rendered by the scheduler.
+  Q_INVOKABLE int renderCount(ctkVTKAbstractView* view)const;
+  /// Duration (in milliseconds) of the last render of \a view.
+  Q_INVOKABLE double lastFrameTime(ctkVTKAbstractView* view)const;
+  /// Average duration (in milliseconds) of the renders of \a view.
+  Q_INVOKABLE double averageFrameTime(ctkVTKAbstractView* view)const;
+  /// Clear the render statistics of all the views.
+  Q_INVOKABLE void resetStatistics();
+
+public slots:
+  /// Render \a view in the next frame.
+  void requestRender(ctkVTKAbstractView* view);
+
+  /// Render all the requested views now.
+  void renderPendingViews();
+
+signals:
+  /// Emitted after \a view is rendered, \a frameTime is the render
+  /// duration in milliseconds.
+  void viewRendered(ctkVTKAbstractView* view, double frameTime);
+
+protected slots:
+  void onViewDestroyed(QObject* view);
+
+protected:
+  virtual bool eventFilter(QObject* object, QEvent* event);
+
+  QScopedPointer<qMRMLRenderSchedulerPrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qMRMLRenderScheduler);
+  Q_DISABLE_COPY(qMRMLRenderScheduler);
+};
+
+#endif
@@ -20,6 +20,7 @@
 
 // Qt includes
 #include <QDebug>
+#include <QSet>
 #include <QTimer>
 
 // qMRML includes
@@ -47,6 +48,7 @@ qMRMLSceneModelPrivate::qMRMLSceneModelPrivate(qMRMLSceneModel& object)
   this->LazyUpdate = false;
   this->ListenNodeModifiedEvent = qMRMLSceneModel::NoNodes;
   this->PendingItemModified = -1; // -1 means not updating
+  this->DelayedNodeUpdate = false;
 
   this->NameColumn = -1;
   this->IDColumn = -1;
@@ -118,6 +120,27 @@ QModelIndexList qMRMLSceneModelPrivate::indexes(const QString& nodeID)const
   return nodeIndexes;
 }
 
+//------------------------------------------------------------------------------
+bool qMRMLSceneModelPrivate::isNodeClassAccepted(vtkMRMLNode* node)const
+{
+  if (this->NodeClassNames.isEmpty())
+    {
+    return true;
+    }
+  if (!node)
+    {
+    return false;
+    }
+  foreach(const QByteArray& nodeClassName, this->NodeClassNames)
+    {
+    if (node->IsA(nodeClassName.constData()))
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
 //------------------------------------------------------------------------------
 void qMRMLSceneModelPrivate::listenNodeModifiedEvent()
 {
@@ -349,6 +372,7 @@ void qMRMLSceneModel::setMRMLScene(vtkMRMLScene* scene)
     {
     scene->AddObserver(vtkMRMLScene::NodeAboutToBeAddedEvent, d->CallBack, -10.);
     scene->AddObserver(vtkMRMLScene::NodeAddedEvent, d->CallBack, 10.);
+    scene->AddObserver(vtkMRMLScene::NodesAddedEvent, d->CallBack, 10.);
     scene->AddObserver(vtkMRMLScene::NodeAboutToBeRemovedEvent, d->CallBack, -10.);
     scene->AddObserver(vtkMRMLScene::NodeRemovedEvent, d->CallBack, 10.);
     scene->AddObserver(vtkCommand::DeleteEvent, d->CallBack);
@@ -500,8 +524,23 @@ QModelIndex qMRMLSceneModel::indexFromNode(vtkMRMLNode* node, int column)const
 //------------------------------------------------------------------------------
 QModelIndexList qMRMLSceneModel::indexes(vtkMRMLNode* node)const
 {
-  Q_D(const qMRMLSceneModel);
-  return d->indexes(QString(node->GetID()));
+  // indexFromNode() uses the row cache, it is much faster than searching
+  // the whole model by UID.
+  QModelIndexList nodeIndexes;
+  QModelIndex nodeIndex = this->indexFromNode(node);
+  if (!nodeIndex.isValid())
+    {
+    return nodeIndexes;
+    }
+  nodeIndexes << nodeIndex;
+  // Add the QModelIndexes from the other columns
+  QModelIndex nodeParentIndex = nodeIndex.parent();
+  const int columnCount = this->columnCount(nodeParentIndex);
+  for (int j = 1; j < columnCount; ++j)
+    {
+    nodeIndexes << this->index(nodeIndex.row(), j, nodeParentIndex);
+    }
+  return nodeIndexes;
 }
 
 //------------------------------------------------------------------------------
@@ -538,7 +577,7 @@ int qMRMLSceneModel::nodeIndex(vtkMRMLNode* node)const
        (n = (vtkMRMLNode*)(nodes->GetNextItemAsObject(it))) ;)
     {
     // note: parent can be NULL, it means that the scene is the parent
-    if (parent == this->parentNode(n))
+    if (parent == this->parentNode(n) && d->isNodeClassAccepted(n))
       {
       ++index;
       if (node==n)
@@ -554,7 +593,7 @@ int qMRMLSceneModel::nodeIndex(vtkMRMLNode* node)const
        (n = (vtkMRMLNode*)nodes->GetNextItemAsObject(it)) ;)
     {
     // note: parent can be NULL, it means that the scene is the parent
-    if (parent == this->parentNode(n))
+    if (parent == this->parentNode(n) && d->isNodeClassAccepted(n))
       {
       ++index;
       nId = n->GetID();
@@ -648,6 +687,55 @@ bool qMRMLSceneModel::lazyUpdate()const
   return d->LazyUpdate;
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSceneModel::setDelayedNodeUpdate(bool delayed)
+{
+  Q_D(qMRMLSceneModel);
+  if (d->DelayedNodeUpdate == delayed)
+    {
+    return;
+    }
+  d->DelayedNodeUpdate = delayed;
+  if (!delayed)
+    {
+    this->updatePendingNodeItems();
+    }
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLSceneModel::delayedNodeUpdate()const
+{
+  Q_D(const qMRMLSceneModel);
+  return d->DelayedNodeUpdate;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneModel::setNodeClasses(const QStringList& nodeClasses)
+{
+  Q_D(qMRMLSceneModel);
+  if (d->NodeClasses == nodeClasses)
+    {
+    return;
+    }
+  d->NodeClasses = nodeClasses;
+  d->NodeClassNames.clear();
+  foreach(const QString& nodeClass, nodeClasses)
+    {
+    d->NodeClassNames << nodeClass.toLatin1();
+    }
+  if (d->MRMLScene)
+    {
+    this->updateScene();
+    }
+}
+
+//------------------------------------------------------------------------------
+QStringList qMRMLSceneModel::nodeClasses()const
+{
+  Q_D(const qMRMLSceneModel);
+  return d->NodeClasses;
+}
+
 //------------------------------------------------------------------------------
 QMimeData* qMRMLSceneModel::mimeData(const QModelIndexList& indexes)const
 {
@@ -699,6 +787,8 @@ void qMRMLSceneModel::updateScene()
                  this, SLOT(onMRMLNodeIDChanged(vtkObject*,void*)));
 
   d->RowCache.clear();
+  // All the items are recreated from the nodes
+  d->PendingModifiedNodes.clear();
 
   // Enabled so it can be interacted with
   this->invisibleRootItem()->setFlags(Qt::ItemIsEnabled);
@@ -776,6 +866,10 @@ void qMRMLSceneModel::populateScene()
   for (d->MRMLScene->GetNodes()->InitTraversal(it);
        (node = (vtkMRMLNode*)d->MRMLScene->GetNodes()->GetNextItemAsObject(it)) ;)
     {
+    if (!d->isNodeClassAccepted(node))
+      {
+      continue;
+      }
     index++;
     d->insertNode(node, index);
     }
@@ -785,10 +879,57 @@ void qMRMLSceneModel::populateScene()
     }
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSceneModel::insertNodes(vtkCollection* nodes)
+{
+  Q_D(qMRMLSceneModel);
+  if (!d->MRMLScene || !nodes || nodes->GetNumberOfItems() == 0)
+    {
+    return;
+    }
+  if (nodes->GetNumberOfItems() == 1)
+    {
+    this->insertNode(vtkMRMLNode::SafeDownCast(nodes->GetItemAsObject(0)));
+    return;
+    }
+  QSet<vtkMRMLNode*> nodesToInsert;
+  vtkMRMLNode *node = 0;
+  vtkCollectionSimpleIterator it;
+  for (nodes->InitTraversal(it);
+       (node = vtkMRMLNode::SafeDownCast(nodes->GetNextItemAsObject(it))) ;)
+    {
+    nodesToInsert.insert(node);
+    }
+  // Same as populateScene(), but only the new nodes are inserted.
+  int index = -1;
+  d->MisplacedNodes.clear();
+  for (d->MRMLScene->GetNodes()->InitTraversal(it);
+       (node = (vtkMRMLNode*)d->MRMLScene->GetNodes()->GetNextItemAsObject(it)) ;)
+    {
+    if (!d->isNodeClassAccepted(node))
+      {
+      continue;
+      }
+    index++;
+    if (nodesToInsert.contains(node))
+      {
+      d->insertNode(node, index);
+      }
+    }
+  foreach(vtkMRMLNode* misplacedNode, d->MisplacedNodes)
+    {
+    this->onMRMLNodeModified(misplacedNode);
+    }
+}
+
 //------------------------------------------------------------------------------
 QStandardItem* qMRMLSceneModel::insertNode(vtkMRMLNode* node)
 {
   Q_D(qMRMLSceneModel);
+  if (!d->isNodeClassAccepted(node))
+    {
+    return 0;
+    }
   return d->insertNode(node, this->nodeIndex(node));
 }
 
@@ -796,6 +937,10 @@ QStandardItem* qMRMLSceneModel::insertNode(vtkMRMLNode* node)
 QStandardItem* qMRMLSceneModelPrivate::insertNode(vtkMRMLNode* node, int nodeIndex)
 {
   Q_Q(qMRMLSceneModel);
+  if (!this->isNodeClassAccepted(node))
+    {
+    return 0;
+    }
   QStandardItem* nodeItem = q->itemFromNode(node);
   if (nodeItem != 0)
     {
@@ -873,6 +1018,18 @@ void qMRMLSceneModel::observeNode(vtkMRMLNode* node)
               this, SLOT(onMRMLNodeIDChanged(vtkObject*,void*)));
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSceneModel::emitNodeDataChanged(vtkMRMLNode* node)
+{
+  QModelIndex nodeIndex = this->indexFromNode(node);
+  if (!nodeIndex.isValid())
+    {
+    return;
+    }
+  QModelIndex lastIndex = nodeIndex.sibling(nodeIndex.row(), this->columnCount(nodeIndex.parent()) - 1);
+  emit dataChanged(nodeIndex, lastIndex);
+}
+
 //------------------------------------------------------------------------------
 void qMRMLSceneModel::updateItemFromNode(QStandardItem* item, vtkMRMLNode* node, int column)
 {
@@ -1162,6 +1319,11 @@ void qMRMLSceneModel::onMRMLSceneEvent(vtkObject* vtk_obj, unsigned long event,
       Q_ASSERT(node);
       sceneModel->onMRMLSceneNodeAdded(scene, node);
       break;
+    case vtkMRMLScene::NodesAddedEvent:
+      Q_ASSERT(call_data);
+      sceneModel->onMRMLSceneNodesAdded(
+        scene, reinterpret_cast<vtkCollection*>(call_data));
+      break;
     case vtkMRMLScene::NodeAboutToBeRemovedEvent:
       Q_ASSERT(node);
       sceneModel->onMRMLSceneNodeAboutToBeRemoved(scene, node);
@@ -1222,6 +1384,21 @@ void qMRMLSceneModel::onMRMLSceneNodeAdded(vtkMRMLScene* scene, vtkMRMLNode* nod
   this->insertNode(node);
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSceneModel::onMRMLSceneNodesAdded(vtkMRMLScene* scene, vtkCollection* nodes)
+{
+  Q_D(qMRMLSceneModel);
+  Q_UNUSED(d);
+  Q_UNUSED(scene);
+  Q_ASSERT(scene == d->MRMLScene);
+
+  if (d->LazyUpdate && d->MRMLScene->IsBatchProcessing())
+    {
+    return;
+    }
+  this->insertNodes(nodes);
+}
+
 //------------------------------------------------------------------------------
 void qMRMLSceneModel::onMRMLSceneNodeAboutToBeRemoved(vtkMRMLScene* scene, vtkMRMLNode* node)
 {
@@ -1249,11 +1426,14 @@ void qMRMLSceneModel::onMRMLSceneNodeAboutToBeRemoved(vtkMRMLScene* scene, vtkMR
   Q_UNUSED(connectionsRemoved);
   // Remove all the observations on the node
   qvtkDisconnect(node, vtkCommand::NoEvent, this, 0);
+  d->PendingModifiedNodes.remove(node);
 
-  // TODO: can be fasten by browsing the tree only once
-  QModelIndexList indexes = this->match(this->mrmlSceneIndex(), qMRMLSceneModel::UIDRole,
-                                        QString(node->GetID()), 1,
-                                        Qt::MatchExactly | Qt::MatchRecursive);
+  QModelIndexList indexes;
+  QModelIndex nodeIndex = this->indexFromNode(node);
+  if (nodeIndex.isValid())
+    {
+    indexes << nodeIndex;
+    }
   if (indexes.count())
     {
     QStandardItem* item = this->itemFromIndex(indexes[0].sibling(indexes[0].row(),0));
@@ -1275,6 +1455,7 @@ void qMRMLSceneModel::onMRMLSceneNodeAboutToBeRemoved(vtkMRMLScene* scene, vtkMR
       }
     this->removeRow(indexes[0].row(), indexes[0].parent());
     }
+  d->RowCache.remove(node);
 }
 
 //------------------------------------------------------------------------------
@@ -1366,10 +1547,44 @@ void qMRMLSceneModel::updateNodeItems()
 //------------------------------------------------------------------------------
 void qMRMLSceneModel::onMRMLNodeModified(vtkObject* node)
 {
+  Q_D(qMRMLSceneModel);
   vtkMRMLNode* modifiedNode = vtkMRMLNode::SafeDownCast(node);
+  if (d->DelayedNodeUpdate)
+    {
+    if (d->PendingModifiedNodes.isEmpty())
+      {
+      QTimer::singleShot(0, this, SLOT(updatePendingNodeItems()));
+      }
+    d->PendingModifiedNodes.insert(modifiedNode);
+    return;
+    }
   this->updateNodeItems(modifiedNode, QString(modifiedNode->GetID()));
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSceneModel::updatePendingNodeItems()
+{
+  Q_D(qMRMLSceneModel);
+  QSet<vtkMRMLNode*> modifiedNodes;
+  modifiedNodes.swap(d->PendingModifiedNodes);
+  if (!d->MRMLScene || d->MRMLScene->IsClosing()
+    || (d->LazyUpdate && d->MRMLScene->IsBatchProcessing()))
+    {
+    // All the items are updated when the scene is closed or batch processed
+    return;
+    }
+  foreach(vtkMRMLNode* modifiedNode, modifiedNodes)
+    {
+    // Nodes are removed from the pending list when they are removed from the
+    // scene, only update the nodes that are still in the model.
+    if (!d->RowCache.contains(modifiedNode) || !modifiedNode->GetID())
+      {
+      continue;
+      }
+    this->updateNodeItems(modifiedNode, QString(modifiedNode->GetID()));
+    }
+}
+
 //------------------------------------------------------------------------------
 void qMRMLSceneModel::onMRMLNodeIDChanged(vtkObject* node, void* callData)
 {
@@ -1399,7 +1614,9 @@ void qMRMLSceneModel::updateNodeItems(vtkMRMLNode* node, const QString& nodeUID)
     return;
     }
   //Q_ASSERT(node->GetScene()->IsNodePresent(node));
-  QModelIndexList nodeIndexes = d->indexes(nodeUID);
+  // Use the row cache when the node ID has not changed
+  QModelIndexList nodeIndexes = (node->GetID() && nodeUID == QLatin1String(node->GetID())) ?
+    this->indexes(node) : d->indexes(nodeUID);
   //qDebug() << "onMRMLNodeModified" << node->GetID() << nodeIndexes;
   Q_ASSERT(nodeIndexes.count());
   for (int i = 0; i < nodeIndexes.size(); ++i)
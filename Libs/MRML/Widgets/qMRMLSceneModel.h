@@ -31,6 +31,7 @@
 // qMRML includes
 #include "qMRMLWidgetsExport.h"
 
+class vtkCollection;
 class vtkMRMLNode;
 class vtkMRMLScene;
 class QAction;
@@ -75,6 +76,22 @@ class QMRML_WIDGETS_EXPORT qMRMLSceneModel : public QStandardItemModel
   /// imported/restored.
   Q_PROPERTY (bool lazyUpdate READ lazyUpdate WRITE setLazyUpdate)
 
+  /// Control when the items of modified nodes are updated.
+  /// If DelayedNodeUpdate is true, the items of a node that is modified are
+  /// updated when control returns to the event loop, only once no matter how
+  /// many times the node has been modified. It is useful for views of large
+  /// scenes where nodes are modified many times in a row.
+  /// False by default (items are updated at each node ModifiedEvent).
+  Q_PROPERTY (bool delayedNodeUpdate READ delayedNodeUpdate WRITE setDelayedNodeUpdate)
+
+  /// Only nodes of these classes (or of their subclasses) are added to the
+  /// model. All the nodes are added if empty (default).
+  /// Nodes of other classes are ignored when they are added, removed or
+  /// modified, which is cheaper than filtering them out with a proxy model.
+  /// It is meant for models without hierarchy (e.g. qMRMLSceneModel), where
+  /// the parent of a node is never filtered out.
+  Q_PROPERTY (QStringList nodeClasses READ nodeClasses WRITE setNodeClasses)
+
   /// Control in which column vtkMRMLNode names are displayed (Qt::DisplayRole).
   /// A value of -1 hides it. First column (0) by default.
   /// If no property is set in a column, nothing is displayed.
@@ -152,6 +169,12 @@ public:
   bool lazyUpdate()const;
   void setLazyUpdate(bool lazy);
 
+  bool delayedNodeUpdate()const;
+  void setDelayedNodeUpdate(bool delayed);
+
+  QStringList nodeClasses()const;
+  void setNodeClasses(const QStringList& nodeClasses);
+
   int nameColumn()const;
   void setNameColumn(int column);
 
@@ -219,12 +242,20 @@ public:
   /// \sa listenNodeModifiedEvent
   virtual void observeNode(vtkMRMLNode* node);
 
+  /// Emit dataChanged() for the row of the node without updating the items.
+  /// It allows proxy models to filter the row of the node again when the node
+  /// changed in a way that is not reflected by the item data.
+  void emitNodeDataChanged(vtkMRMLNode* node);
+
 protected slots:
 
   virtual void onMRMLSceneNodeAboutToBeAdded(vtkMRMLScene* scene, vtkMRMLNode* node);
   virtual void onMRMLSceneNodeAboutToBeRemoved(vtkMRMLScene* scene, vtkMRMLNode* node);
   virtual void onMRMLSceneNodeAdded(vtkMRMLScene* scene, vtkMRMLNode* node);
   virtual void onMRMLSceneNodeRemoved(vtkMRMLScene* scene, vtkMRMLNode* node);
+  /// Called when nodes are added with vtkMRMLScene::AddNodes().
+  /// \sa insertNodes()
+  virtual void onMRMLSceneNodesAdded(vtkMRMLScene* scene, vtkCollection* nodes);
 
   virtual void onMRMLSceneAboutToBeImported(vtkMRMLScene* scene);
   virtual void onMRMLSceneImported(vtkMRMLScene* scene);
@@ -239,6 +270,9 @@ protected slots:
   /// The node has its ID changed. The scene model needs to update the UIDRole
   /// associated with the node in order to keep being in sync.
   void onMRMLNodeIDChanged(vtkObject* node, void* callData);
+  /// Update the items of the nodes modified since the last call.
+  /// \sa delayedNodeUpdate
+  void updatePendingNodeItems();
   virtual void onItemChanged(QStandardItem * item);
   virtual void delayedItemChanged();
 
@@ -270,6 +304,10 @@ protected:
   virtual void populateScene();
   virtual QStandardItem* insertNode(vtkMRMLNode* node);
   virtual QStandardItem* insertNode(vtkMRMLNode* node, QStandardItem* parent, int row = -1);
+  /// Insert all the \a nodes into the model with a single scene traversal
+  /// (instead of one traversal per node with insertNode(vtkMRMLNode*)).
+  /// \sa populateScene()
+  virtual void insertNodes(vtkCollection* nodes);
 
   virtual bool isANode(const QStandardItem* item)const;
   virtual QFlags<Qt::ItemFlag> nodeFlags(vtkMRMLNode* node, int column)const;
@@ -36,11 +36,13 @@
 class QStandardItemModel;
 #include <QFlags>
 #include <QMap>
+#include <QSet>
 
 // qMRML includes
 #include "qMRMLSceneModel.h"
 
 // MRML includes
+class vtkMRMLNode;
 class vtkMRMLScene;
 
 // VTK includes
@@ -62,6 +64,9 @@ public:
 
   QModelIndexList indexes(const QString& nodeID)const;
 
+  /// Return true if the node class is in NodeClasses or if NodeClasses is empty.
+  bool isNodeClassAccepted(vtkMRMLNode* node)const;
+
   QStringList extraItems(QStandardItem* parent, const QString& extraType)const;
   void insertExtraItem(int row, QStandardItem* parent,
                        const QString& text, const QString& extraType,
@@ -81,6 +86,12 @@ public:
   qMRMLSceneModel::NodeTypes ListenNodeModifiedEvent;
   bool LazyUpdate;
   int PendingItemModified;
+  bool DelayedNodeUpdate;
+  // Nodes modified since the last updatePendingNodeItems() call
+  QSet<vtkMRMLNode*> PendingModifiedNodes;
+  QStringList NodeClasses;
+  // NodeClasses as char arrays, to not convert them at each IsA() call
+  QList<QByteArray> NodeClassNames;
 
   int NameColumn;
   int IDColumn;
@@ -27,6 +27,7 @@
 #include <QMessageBox>
 #include <QPushButton>
 #include <QSpinBox>
+#include <QTimer>
 #include <QWidgetAction>
 
 // CTK includes
@@ -89,6 +90,7 @@ qMRMLSliceControllerWidgetPrivate::qMRMLSliceControllerWidgetPrivate(qMRMLSliceC
 
   this->LightboxMenu = 0;
   this->CompositingMenu = 0;
+  this->FlickerTimer = 0;
   this->SliceSpacingMenu = 0;
   this->SliceModelMenu = 0;
   this->SegmentationMenu = 0;
@@ -204,6 +206,14 @@ void qMRMLSliceControllerWidgetPrivate::setupPopupUi()
                    q, SLOT(setCompositingToAdd()));
   QObject::connect(this->actionCompositingSubtract, SIGNAL(triggered()),
                    q, SLOT(setCompositingToSubtract()));
+  QObject::connect(this->actionCompositingCheckerboard, SIGNAL(triggered()),
+                   q, SLOT(setCompositingToCheckerboard()));
+  QObject::connect(this->actionCompositingSwipe, SIGNAL(triggered()),
+                   q, SLOT(setCompositingToSwipe()));
+  QObject::connect(this->actionCompositingDifference, SIGNAL(triggered()),
+                   q, SLOT(setCompositingToDifference()));
+  QObject::connect(this->actionCompositingFlicker, SIGNAL(triggered()),
+                   q, SLOT(setCompositingToFlicker()));
   QObject::connect(this->actionSliceSpacingModeAutomatic, SIGNAL(toggled(bool)),
                    q, SLOT(setSliceSpacingMode(bool)));
 
@@ -238,6 +248,10 @@ void qMRMLSliceControllerWidgetPrivate::setupPopupUi()
                    q, SLOT(setLightboxTo6x6()));
   this->setupLightboxMenu();
   this->setupCompositingMenu();
+  this->FlickerTimer = new QTimer(q);
+  this->FlickerTimer->setInterval(500);
+  QObject::connect(this->FlickerTimer, SIGNAL(timeout()),
+                   this, SLOT(toggleFlicker()));
   this->setupSliceSpacingMenu();
   this->setupSliceModelMenu();
   this->setupSegmentationMenu();
@@ -535,11 +549,20 @@ void qMRMLSliceControllerWidgetPrivate::setupCompositingMenu()
   this->CompositingMenu->addAction(this->actionCompositingReverse_alpha_blend);
   this->CompositingMenu->addAction(this->actionCompositingAdd);
   this->CompositingMenu->addAction(this->actionCompositingSubtract);
+  this->CompositingMenu->addSeparator();
+  this->CompositingMenu->addAction(this->actionCompositingCheckerboard);
+  this->CompositingMenu->addAction(this->actionCompositingSwipe);
+  this->CompositingMenu->addAction(this->actionCompositingDifference);
+  this->CompositingMenu->addAction(this->actionCompositingFlicker);
   QActionGroup* compositingGroup = new QActionGroup(this->CompositingMenu);
   compositingGroup->addAction(this->actionCompositingAlpha_blend);
   compositingGroup->addAction(this->actionCompositingReverse_alpha_blend);
   compositingGroup->addAction(this->actionCompositingAdd);
   compositingGroup->addAction(this->actionCompositingSubtract);
+  compositingGroup->addAction(this->actionCompositingCheckerboard);
+  compositingGroup->addAction(this->actionCompositingSwipe);
+  compositingGroup->addAction(this->actionCompositingDifference);
+  compositingGroup->addAction(this->actionCompositingFlicker);
 }
 
 
@@ -1063,6 +1086,29 @@ void qMRMLSliceControllerWidgetPrivate::updateWidgetFromMRMLSliceCompositeNode()
     case vtkMRMLSliceCompositeNode::Subtract:
       this->actionCompositingSubtract->setChecked(true);
       break;
+    case vtkMRMLSliceCompositeNode::Checkerboard:
+      this->actionCompositingCheckerboard->setChecked(true);
+      break;
+    case vtkMRMLSliceCompositeNode::Swipe:
+      this->actionCompositingSwipe->setChecked(true);
+      break;
+    case vtkMRMLSliceCompositeNode::Difference:
+      this->actionCompositingDifference->setChecked(true);
+      break;
+    case vtkMRMLSliceCompositeNode::Flicker:
+      this->actionCompositingFlicker->setChecked(true);
+      break;
+    }
+  if (this->MRMLSliceCompositeNode->GetCompositing() == vtkMRMLSliceCompositeNode::Flicker)
+    {
+    if (!this->FlickerTimer->isActive())
+      {
+      this->FlickerTimer->start();
+      }
+    }
+  else
+    {
+    this->FlickerTimer->stop();
     }
 
   // Since we blocked the signals when setting the
@@ -1072,6 +1118,19 @@ void qMRMLSliceControllerWidgetPrivate::updateWidgetFromMRMLSliceCompositeNode()
 }
 
 
+// --------------------------------------------------------------------------
+void qMRMLSliceControllerWidgetPrivate::toggleFlicker()
+{
+  if (!this->MRMLSliceCompositeNode ||
+      this->MRMLSliceCompositeNode->GetCompositing() != vtkMRMLSliceCompositeNode::Flicker)
+    {
+    this->FlickerTimer->stop();
+    return;
+    }
+  this->MRMLSliceCompositeNode->SetFlickerForeground(
+    !this->MRMLSliceCompositeNode->GetFlickerForeground());
+}
+
 // --------------------------------------------------------------------------
 void qMRMLSliceControllerWidgetPrivate::onForegroundLayerNodeSelected(vtkMRMLNode * node)
 {
@@ -1903,6 +1962,8 @@ void qMRMLSliceControllerWidget::setSliceOffsetValue(double offset)
   d->SliceLogic->StartSliceOffsetInteraction();
   d->SliceLogic->SetSliceOffset(offset);
   d->SliceLogic->EndSliceOffsetInteraction();
+  // refine the slice rendered while tracking the slider
+  d->SliceLogic->SetInteractionPreview(0);
 }
 
 // --------------------------------------------------------------------------
@@ -1914,6 +1975,7 @@ void qMRMLSliceControllerWidget::trackSliceOffsetValue(double offset)
     return;
     }
   //qDebug() << "qMRMLSliceControllerWidget::trackSliceOffsetValue";
+  d->SliceLogic->SetInteractionPreview(1);
   d->SliceLogic->StartSliceOffsetInteraction();
   d->SliceLogic->SetSliceOffset(offset);
 }
@@ -2351,6 +2413,30 @@ void qMRMLSliceControllerWidget::setCompositingToSubtract()
   this->setCompositing(vtkMRMLSliceCompositeNode::Subtract);
 }
 
+//---------------------------------------------------------------------------
+void qMRMLSliceControllerWidget::setCompositingToCheckerboard()
+{
+  this->setCompositing(vtkMRMLSliceCompositeNode::Checkerboard);
+}
+
+//---------------------------------------------------------------------------
+void qMRMLSliceControllerWidget::setCompositingToSwipe()
+{
+  this->setCompositing(vtkMRMLSliceCompositeNode::Swipe);
+}
+
+//---------------------------------------------------------------------------
+void qMRMLSliceControllerWidget::setCompositingToDifference()
+{
+  this->setCompositing(vtkMRMLSliceCompositeNode::Difference);
+}
+
+//---------------------------------------------------------------------------
+void qMRMLSliceControllerWidget::setCompositingToFlicker()
+{
+  this->setCompositing(vtkMRMLSliceCompositeNode::Flicker);
+}
+
 //---------------------------------------------------------------------------
 void qMRMLSliceControllerWidget::setSliceSpacingMode(bool automatic)
 {
@@ -220,6 +220,10 @@ public slots:
   void setCompositingToReverseAlphaBlend();
   void setCompositingToAdd();
   void setCompositingToSubtract();
+  void setCompositingToCheckerboard();
+  void setCompositingToSwipe();
+  void setCompositingToDifference();
+  void setCompositingToFlicker();
   /// Slice spacing
   void setSliceSpacingMode(bool automatic);
   void setSliceSpacing(double spacing);
@@ -55,6 +55,7 @@ class ctkSignalMapper;
 class ctkDoubleSpinBox;
 class ctkVTKSliceView;
 class QSpinBox;
+class QTimer;
 class qMRMLSliderWidget;
 class vtkMRMLSliceNode;
 class vtkObject;
@@ -124,6 +125,9 @@ public slots:
   /// Update widget state using the associated MRML slice composite node
   void updateWidgetFromMRMLSliceCompositeNode();
 
+  /// Show the other layer in Flicker compositing mode
+  void toggleFlicker();
+
   /// Called after a foreground layer volume node is selected
   /// using the associated qMRMLNodeComboBox
   void onForegroundLayerNodeSelected(vtkMRMLNode* node);
@@ -183,6 +187,7 @@ public:
 
   QMenu*                              LightboxMenu;
   QMenu*                              CompositingMenu;
+  QTimer*                             FlickerTimer;
   QMenu*                              SliceSpacingMenu;
   QMenu*                              SliceModelMenu;
   QMenu*                              SegmentationMenu;
@@ -32,6 +32,7 @@
 
 // qMRML includes
 #include "qMRMLColors.h"
+#include "qMRMLRenderScheduler.h"
 #include "qMRMLSliceView_p.h"
 
 // MRMLDisplayableManager includes
@@ -185,8 +186,8 @@ void qMRMLSliceViewPrivate::initDisplayableManagers()
     = factory->InstantiateDisplayableManagers(
       q->lightBoxRendererManager()->GetRenderer(0));
   // Observe displayable manager group to catch RequestRender events
-  q->qvtkConnect(this->DisplayableManagerGroup, vtkCommand::UpdateEvent,
-                 q, SLOT(scheduleRender()));
+  this->qvtkConnect(this->DisplayableManagerGroup, vtkCommand::UpdateEvent,
+                    this, SLOT(requestRender()));
 
   // pass the lightbox manager proxy onto the display managers
   this->DisplayableManagerGroup->SetLightBoxRendererManagerProxy(this->LightBoxRendererManagerProxy);
@@ -229,6 +230,13 @@ void qMRMLSliceViewPrivate::onSceneEndProcessing()
   q->setRenderEnabled(true);
 }
 
+// --------------------------------------------------------------------------
+void qMRMLSliceViewPrivate::requestRender()
+{
+  Q_Q(qMRMLSliceView);
+  qMRMLRenderScheduler::instance()->requestRender(q);
+}
+
 // --------------------------------------------------------------------------
 void qMRMLSliceViewPrivate::updateWidgetFromMRML()
 {
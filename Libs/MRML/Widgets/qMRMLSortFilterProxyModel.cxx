@@ -19,6 +19,7 @@
 ==============================================================================*/
 
 // Qt includes
+#include <QHash>
 
 // qMRML includes
 #include "qMRMLSceneModel.h"
@@ -37,6 +38,17 @@ class qMRMLSortFilterProxyModelPrivate
 public:
   qMRMLSortFilterProxyModelPrivate();
 
+  /// Index in NodeTypes of the type that the node is shown for, -1 if the
+  /// node type is rejected. The result only depends on the node class, it is
+  /// computed once per class.
+  int nodeTypeIndex(vtkMRMLNode* node)const;
+  /// Return true if the node is shown even if HideFromEditors is on.
+  /// The result is computed once per class.
+  bool isShownHiddenType(vtkMRMLNode* node)const;
+  /// To be called when NodeTypes, ShowChildNodeTypes, HideChildNodeTypes or
+  /// ShowHiddenForTypes is changed.
+  void clearNodeClassCache();
+
   QStringList                      NodeTypes;
   bool                             ShowHidden;
   QStringList                      ShowHiddenForTypes;
@@ -48,6 +60,11 @@ public:
   typedef QPair<QString, QVariant> AttributeType;
   QHash<QString, AttributeType>    Attributes;
   qMRMLSortFilterProxyModel::FilterType Filter;
+
+  mutable QHash<QString, int>      NodeTypeIndexes;
+  mutable QHash<QString, bool>     ShownHiddenTypes;
+  /// Last filter result of the nodes observed for attribute changes
+  mutable QHash<vtkMRMLNode*, int> ObservedNodeAccepts;
 };
 
 // -----------------------------------------------------------------------------
@@ -58,6 +75,77 @@ qMRMLSortFilterProxyModelPrivate::qMRMLSortFilterProxyModelPrivate()
   this->Filter = qMRMLSortFilterProxyModel::UseFilters;
 }
 
+// -----------------------------------------------------------------------------
+int qMRMLSortFilterProxyModelPrivate::nodeTypeIndex(vtkMRMLNode* node)const
+{
+  const QString className = QString::fromLatin1(node->GetClassName());
+  QHash<QString, int>::const_iterator it = this->NodeTypeIndexes.constFind(className);
+  if (it != this->NodeTypeIndexes.constEnd())
+    {
+    return it.value();
+    }
+  int typeIndex = -1;
+  for (int i = 0; i < this->NodeTypes.count(); ++i)
+    {
+    const QString& nodeType = this->NodeTypes[i];
+    // filter by node type
+    if (!node->IsA(nodeType.toLatin1()))
+      {
+      continue;
+      }
+    // filter by excluded child node types
+    if (!this->ShowChildNodeTypes && nodeType != className)
+      {
+      continue;
+      }
+    typeIndex = i;
+    // filter by HideChildNodeType
+    if (this->ShowChildNodeTypes)
+      {
+      foreach(const QString& hideChildNodeType, this->HideChildNodeTypes)
+        {
+        if (node->IsA(hideChildNodeType.toLatin1()))
+          {
+          typeIndex = -1;
+          break;
+          }
+        }
+      }
+    break;
+    }
+  this->NodeTypeIndexes[className] = typeIndex;
+  return typeIndex;
+}
+
+// -----------------------------------------------------------------------------
+bool qMRMLSortFilterProxyModelPrivate::isShownHiddenType(vtkMRMLNode* node)const
+{
+  const QString className = QString::fromLatin1(node->GetClassName());
+  QHash<QString, bool>::const_iterator it = this->ShownHiddenTypes.constFind(className);
+  if (it != this->ShownHiddenTypes.constEnd())
+    {
+    return it.value();
+    }
+  bool shown = false;
+  foreach(const QString& nodeType, this->ShowHiddenForTypes)
+    {
+    if (node->IsA(nodeType.toLatin1()))
+      {
+      shown = true;
+      break;
+      }
+    }
+  this->ShownHiddenTypes[className] = shown;
+  return shown;
+}
+
+// -----------------------------------------------------------------------------
+void qMRMLSortFilterProxyModelPrivate::clearNodeClassCache()
+{
+  this->NodeTypeIndexes.clear();
+  this->ShownHiddenTypes.clear();
+}
+
 // -----------------------------------------------------------------------------
 // qMRMLSortFilterProxyModel
 
@@ -169,6 +257,7 @@ QVariant qMRMLSortFilterProxyModel::attributeFilter(const QString& nodeType,
 //------------------------------------------------------------------------------
 bool qMRMLSortFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent)const
 {
+  Q_D(const qMRMLSortFilterProxyModel);
   QStandardItem* parentItem = this->sourceItem(source_parent);
   if (parentItem == 0)
     {
@@ -193,6 +282,10 @@ bool qMRMLSortFilterProxyModel::filterAcceptsRow(int source_row, const QModelInd
   qMRMLSceneModel* sceneModel = qobject_cast<qMRMLSceneModel*>(this->sourceModel());
   vtkMRMLNode* node = sceneModel->mrmlNodeFromItem(item);
   AcceptType accept = this->filterAcceptsNode(node);
+  if (node && d->ObservedNodeAccepts.contains(node))
+    {
+    d->ObservedNodeAccepts[node] = accept;
+    }
   bool acceptRow = (accept == Accept);
   if (accept == AcceptButPotentiallyRejectable)
     {
@@ -235,21 +328,10 @@ qMRMLSortFilterProxyModel::AcceptType qMRMLSortFilterProxyModel
     return Accept;
     }
   // HideFromEditors property
-  if (!d->ShowHidden && node->GetHideFromEditors())
+  if (!d->ShowHidden && node->GetHideFromEditors() &&
+      !d->isShownHiddenType(node))
     {
-    bool hide = true;
-    foreach(const QString& nodeType, d->ShowHiddenForTypes)
-      {
-      if (node->IsA(nodeType.toLatin1()))
-        {
-        hide = false;
-        break;
-        }
-      }
-    if (hide)
-      {
-      return Reject;
-      }
+    return Reject;
     }
 
   if (!d->HideNodesUnaffiliatedWithNodeID.isEmpty())
@@ -269,66 +351,76 @@ qMRMLSortFilterProxyModel::AcceptType qMRMLSortFilterProxyModel
     // Apply filter if any
     return AcceptButPotentiallyRejectable;
     }
-  foreach(const QString& nodeType, d->NodeTypes)
+  int typeIndex = d->nodeTypeIndex(node);
+  if (typeIndex < 0)
     {
-    // filter by node type
-    if (!node->IsA(nodeType.toAscii().data()))
-      {
-      //std::cout << "Reject node: " << node->GetName() << "(" << node->GetID()
-      //          << ") type: " << typeid(*node).name() <<std::endl;
-      continue;
-      }
-    // filter by excluded child node types
-    if (!d->ShowChildNodeTypes && nodeType != node->GetClassName())
+    return Reject;
+    }
+  const QString& nodeType = d->NodeTypes[typeIndex];
+
+  // filter by attributes
+  if (d->Attributes.contains(nodeType))
+    {
+    if (!d->ObservedNodeAccepts.contains(node))
       {
-      continue;
+      // Only the row of the node is filtered again when the node is modified
+      // \sa onNodeModified()
+      qMRMLSortFilterProxyModel* self = const_cast<qMRMLSortFilterProxyModel*>(this);
+      self->qvtkConnect(node, vtkCommand::ModifiedEvent,
+                        self, SLOT(onNodeModified(vtkObject*)));
+      self->qvtkConnect(node, vtkCommand::DeleteEvent,
+                        self, SLOT(onNodeDeleted(vtkObject*)));
+      d->ObservedNodeAccepts[node] = Reject;
       }
-    // filter by HideChildNodeType
-    if (d->ShowChildNodeTypes)
+
+    const QString& attributeName = d->Attributes[nodeType].first;
+    const char *nodeAttribute = node->GetAttribute(attributeName.toLatin1());
+    // fail if the attribute isn't defined on the node at all
+    if (nodeAttribute == 0)
       {
-      foreach(const QString& hideChildNodeType, d->HideChildNodeTypes)
-        {
-        if (node->IsA(hideChildNodeType.toAscii().data()))
-          {
-          return Reject;
-          }
-        }
+      return RejectButPotentiallyAcceptable;
       }
-
-    // filter by attributes
-    if (d->Attributes.contains(nodeType))
+    // if the filter value is null, any node attribute value will match
+    const QVariant& testAttribute = d->Attributes[nodeType].second;
+    if (!testAttribute.isNull())
       {
-      // can be optimized if the event is AttributeModifiedEvent instead of modifiedevent
-      const_cast<qMRMLSortFilterProxyModel*>(this)->qvtkConnect(
-        node, vtkCommand::ModifiedEvent,
-        const_cast<qMRMLSortFilterProxyModel*>(this),
-        SLOT(invalidate()),0., Qt::UniqueConnection);
-
-      QString attributeName = d->Attributes[nodeType].first;
-      const char *nodeAttribute = node->GetAttribute(attributeName.toLatin1());
-      QString nodeAttributeQString = node->GetAttribute(attributeName.toLatin1());
-      QString testAttribute = d->Attributes[nodeType].second.toString();
-
-      //std::cout << "attribute name = " << qPrintable(attributeName) << "\n\ttestAttribute = " << qPrintable(testAttribute) << "\n\t" << node->GetID() << " nodeAttributeQString = " << qPrintable(nodeAttributeQString) << "\n\t\tas char str = " << (nodeAttribute ? nodeAttribute : "null") << "." << std::endl;
-      // fail if the attribute isn't defined on the node at all
-      if (nodeAttribute == 0)
+      // otherwise, the node and filter attributes have to match
+      if (testAttribute.toString() != nodeAttribute)
         {
         return RejectButPotentiallyAcceptable;
         }
-      // if the filter value is null, any node attribute value will match
-      if (!d->Attributes[nodeType].second.isNull())
-        {
-        // otherwise, the node and filter attributes have to match
-        if (testAttribute != nodeAttribute)
-          {
-          return RejectButPotentiallyAcceptable;
-          }
-        }
       }
-    // Apply filter if any
-    return AcceptButPotentiallyRejectable;
     }
-  return Reject;
+  // Apply filter if any
+  return AcceptButPotentiallyRejectable;
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLSortFilterProxyModel::onNodeModified(vtkObject* object)
+{
+  Q_D(qMRMLSortFilterProxyModel);
+  vtkMRMLNode* node = vtkMRMLNode::SafeDownCast(object);
+  qMRMLSceneModel* sceneModel = this->sceneModel();
+  if (!node || !sceneModel || !d->ObservedNodeAccepts.contains(node))
+    {
+    return;
+    }
+  AcceptType accept = this->filterAcceptsNode(node);
+  if (accept == d->ObservedNodeAccepts[node])
+    {
+    return;
+    }
+  d->ObservedNodeAccepts[node] = accept;
+  // Filtering the row of the node again is enough, no need to invalidate the
+  // whole model.
+  sceneModel->emitNodeDataChanged(node);
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLSortFilterProxyModel::onNodeDeleted(vtkObject* object)
+{
+  Q_D(qMRMLSortFilterProxyModel);
+  d->ObservedNodeAccepts.remove(vtkMRMLNode::SafeDownCast(object));
 }
 
 //-----------------------------------------------------------------------------
@@ -354,6 +446,7 @@ void qMRMLSortFilterProxyModel::setHideChildNodeTypes(const QStringList& _nodeTy
     return;
     }
   d->HideChildNodeTypes = _nodeTypes;
+  d->clearNodeClassCache();
   this->invalidateFilter();
 }
 
@@ -366,6 +459,7 @@ void qMRMLSortFilterProxyModel::setNodeTypes(const QStringList& _nodeTypes)
     return;
     }
   d->NodeTypes = _nodeTypes;
+  d->clearNodeClassCache();
   this->invalidateFilter();
 }
 
@@ -378,6 +472,7 @@ void qMRMLSortFilterProxyModel::setShowChildNodeTypes(bool _show)
     return;
     }
   d->ShowChildNodeTypes = _show;
+  d->clearNodeClassCache();
   invalidateFilter();
 }
 
@@ -416,6 +511,7 @@ void qMRMLSortFilterProxyModel::setShowHiddenForTypes(const QStringList& types)
     return;
     }
   d->ShowHiddenForTypes = types;
+  d->clearNodeClassCache();
   this->invalidateFilter();
 }
 
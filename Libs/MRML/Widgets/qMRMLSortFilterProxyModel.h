@@ -34,6 +34,7 @@ class QStandardItem;
 
 class vtkMRMLNode;
 class vtkMRMLScene;
+class vtkObject;
 class qMRMLAbstractItemHelper;
 class qMRMLSceneModel;
 class qMRMLSortFilterProxyModelPrivate;
@@ -232,6 +233,12 @@ public slots:
   void setHideAll(bool hide);
 
   // TODO Add setMRMLScene() to propagate to the scene model
+protected slots:
+  /// Filter the row of an observed node again if its filter result changed.
+  /// \sa filterAcceptsNode()
+  void onNodeModified(vtkObject* node);
+  void onNodeDeleted(vtkObject* node);
+
 protected:
   /// This enum type is used to describe the behavior of a node with regard to
   /// filtering:
@@ -240,8 +247,8 @@ protected:
   ///   * Accept if the node should be visible and will always be.
   ///   * RejectButPotentiallyAcceptable if the node should not be visible but
   ///     has the potential for being visible. This can happen if a property is
-  ///     changed. The node should be observed by the model and invalidate the
-  ///     filter when modified to make sure its visibility state is correct.
+  ///     changed. The node should be observed by the model and filtered again
+  ///     when modified to make sure its visibility state is correct.
   ///   * AcceptButPotentiallyRejectable if the node should be visible but has
   ///     the potential for being hidden. See \a RejectButPotentiallyAcceptable.
   enum AcceptType
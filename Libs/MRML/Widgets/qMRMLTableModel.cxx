@@ -21,8 +21,7 @@
 ==============================================================================*/
 
 // Qt includes
-#include <QApplication>
-#include <QPalette>
+#include <QFont>
 
 // qMRML includes
 #include "qMRMLUtils.h"
@@ -53,9 +52,19 @@ public:
   // Returns Excel-style column names from index (A, B, C, ..., Z, AA, AB, AC, ..., AZ, AAA, AAB, ...)
   static QString columnNameFromIndex(int index);
 
+  /// Table of the table node, NULL if there is no table node
+  vtkTable* table()const;
+
   vtkSmartPointer<vtkCallbackCommand> CallBack;
   vtkSmartPointer<vtkMRMLTableNode>   MRMLTableNode;
   bool Transposed;
+
+  // Number of model rows and columns, updated in updateModelFromMRML()
+  int RowCount;
+  int ColumnCount;
+  // tableIndex = modelIndex + offset
+  int TableRowOffset;
+  int TableColumnOffset;
 };
 
 //------------------------------------------------------------------------------
@@ -64,6 +73,10 @@ qMRMLTableModelPrivate::qMRMLTableModelPrivate(qMRMLTableModel& object)
 {
   this->CallBack = vtkSmartPointer<vtkCallbackCommand>::New();
   this->Transposed = false;
+  this->RowCount = 0;
+  this->ColumnCount = 0;
+  this->TableRowOffset = 0;
+  this->TableColumnOffset = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -81,8 +94,12 @@ void qMRMLTableModelPrivate::init()
   Q_Q(qMRMLTableModel);
   this->CallBack->SetClientData(q);
   this->CallBack->SetCallback(qMRMLTableModel::onMRMLNodeEvent);
-  q->setColumnCount(0);
-  QObject::connect(q, SIGNAL(itemChanged(QStandardItem*)), q, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
+}
+
+//------------------------------------------------------------------------------
+vtkTable* qMRMLTableModelPrivate::table()const
+{
+  return (this->MRMLTableNode ? this->MRMLTableNode->GetTable() : NULL);
 }
 
 
@@ -103,7 +120,7 @@ QString qMRMLTableModelPrivate::columnNameFromIndex(int index)
 // qMRMLTableModel
 //------------------------------------------------------------------------------
 qMRMLTableModel::qMRMLTableModel(QObject *_parent)
-  : QStandardItemModel(_parent)
+  : QAbstractTableModel(_parent)
   , d_ptr(new qMRMLTableModelPrivate(*this))
 {
   Q_D(qMRMLTableModel);
@@ -112,7 +129,7 @@ qMRMLTableModel::qMRMLTableModel(QObject *_parent)
 
 //------------------------------------------------------------------------------
 qMRMLTableModel::qMRMLTableModel(qMRMLTableModelPrivate* pimpl, QObject *parentObject)
-  : QStandardItemModel(parentObject)
+  : QAbstractTableModel(parentObject)
   , d_ptr(pimpl)
 {
   Q_D(qMRMLTableModel);
@@ -136,7 +153,11 @@ void qMRMLTableModel::setMRMLTableNode(vtkMRMLTableNode* tableNode)
     {
     tableNode->AddObserver(vtkCommand::ModifiedEvent, d->CallBack);
     }
+  this->beginResetModel();
   d->MRMLTableNode = tableNode;
+  d->RowCount = 0;
+  d->ColumnCount = 0;
+  this->endResetModel();
   this->updateModelFromMRML();
 }
 
@@ -152,255 +173,283 @@ void qMRMLTableModel::updateModelFromMRML()
 {
   Q_D(qMRMLTableModel);
 
-  QObject::disconnect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)));
-
-  vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(d->MRMLTableNode);
-  vtkTable* table = (tableNode ? tableNode->GetTable() : NULL);
-  if (table==NULL || table->GetNumberOfColumns()==0)
+  vtkTable* table = d->table();
+  int newRowCount = 0;
+  int newColumnCount = 0;
+  if (table && table->GetNumberOfColumns() > 0)
     {
-    // setRowCount and setColumnCount to 0 would not be enough, it's necessary to remove the header as well
-    setRowCount(0);
-    setColumnCount(0);
-    reset();
-    QObject::connect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
-    return;
+    bool labelInFirstTableColumn = d->MRMLTableNode->GetUseFirstColumnAsRowHeader();
+    bool useColumnNameAsColumnHeader = d->MRMLTableNode->GetUseColumnNameAsColumnHeader();
+    // offset: modelIndex = mrmlIndex - offset
+    d->TableColumnOffset = labelInFirstTableColumn ? 1 : 0;
+    d->TableRowOffset = useColumnNameAsColumnHeader ? 0 : -1;
+    int numberOfModelTableColumns = static_cast<int>(table->GetNumberOfColumns() - d->TableColumnOffset);
+    int numberOfModelTableRows = static_cast<int>(table->GetNumberOfRows() - d->TableRowOffset);
+    newRowCount = d->Transposed ? numberOfModelTableColumns : numberOfModelTableRows;
+    newColumnCount = d->Transposed ? numberOfModelTableRows : numberOfModelTableColumns;
     }
 
-  bool locked = tableNode->GetLocked();
-  bool labelInFirstTableColumn = tableNode->GetUseFirstColumnAsRowHeader();
-  bool useColumnNameAsColumnHeader = tableNode->GetUseColumnNameAsColumnHeader();
-
-  vtkIdType numberOfTableColumns = table->GetNumberOfColumns();
-  vtkIdType numberOfTableRows = table->GetNumberOfRows();
-  // offset: modelIndex = mrmlIndex - offset
-  vtkIdType tableColOffset = labelInFirstTableColumn ? 1 : 0;
-  vtkIdType tableRowOffset = useColumnNameAsColumnHeader ? 0 : -1;
-  if (d->Transposed)
+  // Cells are not stored in the model, only the size of the model is updated
+  if (newRowCount < d->RowCount)
     {
-    setRowCount(static_cast<int>(numberOfTableColumns-tableColOffset));
-    setColumnCount(static_cast<int>(numberOfTableRows-tableRowOffset));
+    this->beginRemoveRows(QModelIndex(), newRowCount, d->RowCount - 1);
+    d->RowCount = newRowCount;
+    this->endRemoveRows();
     }
-  else
+  else if (newRowCount > d->RowCount)
+    {
+    this->beginInsertRows(QModelIndex(), d->RowCount, newRowCount - 1);
+    d->RowCount = newRowCount;
+    this->endInsertRows();
+    }
+  if (newColumnCount < d->ColumnCount)
+    {
+    this->beginRemoveColumns(QModelIndex(), newColumnCount, d->ColumnCount - 1);
+    d->ColumnCount = newColumnCount;
+    this->endRemoveColumns();
+    }
+  else if (newColumnCount > d->ColumnCount)
     {
-    setRowCount(static_cast<int>(numberOfTableRows-tableRowOffset));
-    setColumnCount(static_cast<int>(numberOfTableColumns-tableColOffset));
+    this->beginInsertColumns(QModelIndex(), d->ColumnCount, newColumnCount - 1);
+    d->ColumnCount = newColumnCount;
+    this->endInsertColumns();
     }
 
-  // Setup items for each table column
-  for (vtkIdType tableCol = tableColOffset; tableCol < numberOfTableColumns; ++tableCol)
+  // Any of the cells may have changed (views only request the visible cells again)
+  if (d->RowCount > 0 && d->ColumnCount > 0)
+    {
+    emit dataChanged(this->index(0, 0), this->index(d->RowCount - 1, d->ColumnCount - 1));
+    }
+  if (d->ColumnCount > 0)
+    {
+    emit headerDataChanged(Qt::Horizontal, 0, d->ColumnCount - 1);
+    }
+  if (d->RowCount > 0)
     {
-    int modelCol = static_cast<int>(tableCol - tableColOffset);
+    emit headerDataChanged(Qt::Vertical, 0, d->RowCount - 1);
+    }
+}
+
+//------------------------------------------------------------------------------
+int qMRMLTableModel::rowCount(const QModelIndex& parent)const
+{
+  Q_D(const qMRMLTableModel);
+  return parent.isValid() ? 0 : d->RowCount;
+}
 
-    QString columnName(table->GetColumnName(tableCol));
-    vtkAbstractArray* columnArray = table->GetColumn(tableCol);
+//------------------------------------------------------------------------------
+int qMRMLTableModel::columnCount(const QModelIndex& parent)const
+{
+  Q_D(const qMRMLTableModel);
+  return parent.isValid() ? 0 : d->ColumnCount;
+}
+
+//------------------------------------------------------------------------------
+QVariant qMRMLTableModel::data(const QModelIndex& index, int role)const
+{
+  Q_D(const qMRMLTableModel);
+  vtkTable* table = d->table();
+  if (!index.isValid() || table == NULL)
+    {
+    return QVariant();
+    }
+  int tableRow = this->mrmlTableRowIndex(index);
+  int tableCol = this->mrmlTableColumnIndex(index);
+  if (tableCol < 0 || tableCol >= table->GetNumberOfColumns() || tableRow >= table->GetNumberOfRows())
+    {
+    return QVariant();
+    }
 
-    if (useColumnNameAsColumnHeader)
+  if (tableRow < 0)
+    {
+    // Column names are displayed in the first row in bold
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
       {
-      setHeaderData(modelCol, d->Transposed ? Qt::Vertical : Qt::Horizontal, columnName);
+      return QString(table->GetColumnName(tableCol));
       }
-    else
+    else if (role == Qt::FontRole)
       {
-      QString autoColumnHeader = d->columnNameFromIndex(modelCol);
-      setHeaderData(modelCol, d->Transposed ? Qt::Vertical : Qt::Horizontal, autoColumnHeader);
-      }
-
-    // Go through the rows of the current column
-    for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
-      {
-      int modelRow = static_cast<int>(tableRow - tableRowOffset);
-
-      // Use existing item if already created
-      QStandardItem* existingItem = NULL;
-      if (d->Transposed)
-        {
-        existingItem = this->item(modelCol, static_cast<int>(modelRow));
-        }
-      else
-        {
-        existingItem = this->item(static_cast<int>(modelRow), modelCol);
-        }
-      QStandardItem* item = existingItem;
-      // Create item if did not exist
-      if (item==NULL)
-        {
-        item = new QStandardItem();
-        }
-
-      // Items in first row use bold font, the others regular
-      if (tableRow>=0)
-        {
-        vtkVariant variant = table->GetValue(tableRow, tableCol);
-        if (tableRow==0)
-          {
-          // the first row might have been bold earlier, make sure
-          // it is reset to non-bold
-          QFont font;
-          item->setData(font, Qt::FontRole);
-          }
-
-        // Set item property for known types.
-        // Special types are defined to be displayed differently, handled by qMRMLTableItemDelegate.
-        // NOTE: The data type itself can be enough, but in future types it will be necessary to define display role
-        //       as well, e.g. double array can be both color and position.
-        if (vtkBitArray::SafeDownCast(columnArray))
-          {
-          // Boolean values indicated by a column of vtkBitArray type are displayed as checkboxes
-          item->setData(vtkMRMLTableNode::BoolType, Qt::WhatsThisRole);
-          item->setCheckable(true);
-          item->setCheckState(variant.ToInt() ? Qt::Checked : Qt::Unchecked);
-          item->setText(QString()); // No text is supposed to be in the cell
-          }
-        // Default display as text
-        else
-          {
-          item->setText(QString(variant.ToString()));
-          }
-        }
-      else
-        {
-        item->setText(columnName);
-        QFont font;
-        font.setBold(true);
-        item->setData(font, Qt::FontRole);
-        }
-
-      // Handle locked flag
-      if (locked)
-        {
-        // Item is view-only, clear the ItemIsEditable flag
-        item->setFlags(item->flags() & (~Qt::ItemIsEditable));
-        }
-      else
-        {
-        // Item is editable, set the ItemIsEditable flag
-        item->setFlags(item->flags() | Qt::ItemIsEditable);
-        }
-
-      // Add item if just created
-      if (item!=existingItem)
-        {
-        if (d->Transposed)
-          {
-          setItem(modelCol, static_cast<int>(modelRow), item);
-          }
-        else
-          {
-          setItem(static_cast<int>(modelRow), modelCol, item);
-          }
-        }
+      QFont font;
+      font.setBold(true);
+      return font;
       }
+    return QVariant();
     }
-  // Set row label: either simply 1, 2, ... or values of the first column
-  for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+
+  // Special types are defined to be displayed differently, handled by qMRMLTableItemDelegate.
+  // NOTE: The data type itself can be enough, but in future types it will be necessary to define display role
+  //       as well, e.g. double array can be both color and position.
+  if (vtkBitArray::SafeDownCast(table->GetColumn(tableCol)))
     {
-    int modelRow = static_cast<int>(tableRow - tableRowOffset);
-    QString rowLabel;
-    if(labelInFirstTableColumn)
+    // Boolean values indicated by a column of vtkBitArray type are displayed as checkboxes,
+    // no text is supposed to be in the cell
+    if (role == Qt::CheckStateRole)
       {
-      if (tableRow>=0)
-        {
-        rowLabel = QString(table->GetValue(tableRow, 0).ToString());
-        }
-      else
-        {
-        rowLabel = QString(table->GetColumnName(0));;
-        }
+      return static_cast<int>(table->GetValue(tableRow, tableCol).ToInt() ? Qt::Checked : Qt::Unchecked);
       }
-    else
+    else if (role == Qt::WhatsThisRole)
       {
-      rowLabel = QString::number(modelRow+1);
+      return vtkMRMLTableNode::BoolType;
       }
-    setHeaderData(static_cast<int>(modelRow), d->Transposed ? Qt::Horizontal : Qt::Vertical, rowLabel);
+    return QVariant();
     }
 
-  QObject::connect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
+  // Default display as text
+  if (role == Qt::DisplayRole || role == Qt::EditRole)
+    {
+    return QString(table->GetValue(tableRow, tableCol).ToString());
+    }
+  return QVariant();
 }
 
 //------------------------------------------------------------------------------
-void qMRMLTableModel::updateMRMLFromModel(QStandardItem* item)
+bool qMRMLTableModel::setData(const QModelIndex& index, const QVariant& value, int role)
 {
   Q_D(qMRMLTableModel);
-  if (item == NULL)
+  if (!index.isValid())
     {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: item is invalid");
-    return;
+    return false;
     }
-  vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(d->MRMLTableNode);
-  if (tableNode==NULL)
-    {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: tableNode is invalid");
-    return;
-    }
-  vtkTable* table = tableNode->GetTable();
+  vtkTable* table = d->table();
   if (table==NULL)
     {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: table is invalid");
-    return;
+    qCritical("qMRMLTableModel::setData failed: table is invalid");
+    return false;
     }
 
-  int tableRow = mrmlTableRowIndex(item->index());
-  int tableCol = mrmlTableColumnIndex(item->index());
+  int tableRow = mrmlTableRowIndex(index);
+  int tableCol = mrmlTableColumnIndex(index);
+  if (tableCol < 0 || tableCol >= table->GetNumberOfColumns() || tableRow >= table->GetNumberOfRows())
+    {
+    return false;
+    }
 
   if (tableRow>=0)
     {
-    // Get item value according to type
-    int type = item->data(Qt::WhatsThisRole).toInt();
-    if (type == vtkMRMLTableNode::BoolType)
+    if (vtkBitArray::SafeDownCast(table->GetColumn(tableCol)))
       {
+      if (role != Qt::CheckStateRole)
+        {
+        return false;
+        }
       // Cell bool value changed
-      int checked = item->checkState();
+      int checked = (value.toInt() == Qt::Checked ? 1 : 0);
       int valueBefore = table->GetValue(tableRow, tableCol).ToInt();
       if (checked == valueBefore)
         {
-        // The value is not changed, this means that the table cannot store this value - revert the value in the table
-        this->blockSignals(true);
-        item->setCheckState(valueBefore ? Qt::Checked : Qt::Unchecked);
-        item->setText(QString()); // No text is supposed to be in the cell
-        this->blockSignals(false);
-        }
-      else
-        {
-        table->SetValue(tableRow, tableCol, vtkVariant(checked));
-        table->GetColumn(tableCol)->Modified(); // Enable observation of checked state changed separately
-        table->Modified();
+        return false;
         }
+      table->SetValue(tableRow, tableCol, vtkVariant(checked));
+      table->GetColumn(tableCol)->Modified(); // Enable observation of checked state changed separately
+      table->Modified();
       }
     else
       {
+      if (role != Qt::EditRole)
+        {
+        return false;
+        }
       // Cell text value changed
-      vtkVariant itemText(item->text().toLatin1().constData()); // the vtkVariant constructor makes a copy of the input buffer, so using constData is safe
+      vtkVariant itemText(value.toString().toLatin1().constData()); // the vtkVariant constructor makes a copy of the input buffer, so using constData is safe
       vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol);
       table->SetValue(tableRow, tableCol, itemText);
       vtkVariant valueInTableAfter = table->GetValue(tableRow, tableCol);
       if (valueInTableBefore == valueInTableAfter)
         {
-        // The value is not changed, this means that the table cannot store this value - revert the value in the table
-        this->blockSignals(true);
-        item->setText(QString(valueInTableBefore.ToString()));
-        this->blockSignals(false);
-        }
-      else
-        {
-        table->Modified();
+        // The value is not changed, this means that the table cannot store this value
+        return false;
         }
+      table->Modified();
       }
     }
   else
     {
     // Column header changed
     vtkAbstractArray* column = table->GetColumn(tableCol);
-    if (column)
+    if (role != Qt::EditRole || !column)
       {
-      QString valueBefore = QString::fromStdString(column->GetName()?column->GetName():"");
-      if (valueBefore!=item->text())
-        {
-        column->SetName(item->text().toLatin1().constData());
-        table->Modified();
-        }
+      return false;
+      }
+    QString valueBefore = QString::fromStdString(column->GetName()?column->GetName():"");
+    if (valueBefore == value.toString())
+      {
+      return false;
+      }
+    column->SetName(value.toString().toLatin1().constData());
+    table->Modified();
+    }
+  emit dataChanged(index, index);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+QVariant qMRMLTableModel::headerData(int section, Qt::Orientation orientation, int role)const
+{
+  Q_D(const qMRMLTableModel);
+  vtkTable* table = d->table();
+  if (role != Qt::DisplayRole || table == NULL)
+    {
+    return this->Superclass::headerData(section, orientation, role);
+    }
+  if (orientation == (d->Transposed ? Qt::Vertical : Qt::Horizontal))
+    {
+    // Column header: either column name or Excel-style name
+    int tableCol = section + d->TableColumnOffset;
+    if (tableCol < 0 || tableCol >= table->GetNumberOfColumns())
+      {
+      return QVariant();
+      }
+    if (d->MRMLTableNode->GetUseColumnNameAsColumnHeader())
+      {
+      return QString(table->GetColumnName(tableCol));
+      }
+    return d->columnNameFromIndex(section);
+    }
+  else
+    {
+    // Row label: either simply 1, 2, ... or values of the first column
+    if (!d->MRMLTableNode->GetUseFirstColumnAsRowHeader())
+      {
+      return QString::number(section+1);
+      }
+    int tableRow = section + d->TableRowOffset;
+    if (tableRow >= table->GetNumberOfRows() || table->GetNumberOfColumns() == 0)
+      {
+      return QVariant();
+      }
+    if (tableRow < 0)
+      {
+      return QString(table->GetColumnName(0));
       }
+    return QString(table->GetValue(tableRow, 0).ToString());
     }
 }
 
+//------------------------------------------------------------------------------
+Qt::ItemFlags qMRMLTableModel::flags(const QModelIndex& index)const
+{
+  Q_D(const qMRMLTableModel);
+  vtkTable* table = d->table();
+  if (!index.isValid() || table == NULL)
+    {
+    return Qt::NoItemFlags;
+    }
+  Qt::ItemFlags itemFlags = Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+  // Handle locked flag: locked items are view-only
+  if (!d->MRMLTableNode->GetLocked())
+    {
+    itemFlags |= Qt::ItemIsEditable;
+    }
+  int tableRow = this->mrmlTableRowIndex(index);
+  int tableCol = this->mrmlTableColumnIndex(index);
+  if (tableRow >= 0 && tableCol >= 0 && tableCol < table->GetNumberOfColumns()
+    && vtkBitArray::SafeDownCast(table->GetColumn(tableCol)))
+    {
+    itemFlags |= Qt::ItemIsUserCheckable;
+    }
+  return itemFlags;
+}
+
 //-----------------------------------------------------------------------------
 void qMRMLTableModel::onMRMLNodeEvent(vtkObject* vtk_obj, unsigned long event,
                                       void* client_data, void* vtkNotUsed(call_data))
@@ -429,16 +478,6 @@ void qMRMLTableModel::onMRMLTableNodeModified(vtkObject* node)
   this->updateModelFromMRML();
 }
 
-//------------------------------------------------------------------------------
-void qMRMLTableModel::onItemChanged(QStandardItem * item)
-{
-  if (item == this->invisibleRootItem())
-    {
-    return;
-    }
-  this->updateMRMLFromModel(item);
-}
-
 //------------------------------------------------------------------------------
 void qMRMLTableModel::setTransposed(bool transposed)
 {
@@ -447,7 +486,12 @@ void qMRMLTableModel::setTransposed(bool transposed)
     {
     return;
     }
+  // rows and columns are swapped, it is simpler to start from an empty model
+  this->beginResetModel();
   d->Transposed = transposed;
+  d->RowCount = 0;
+  d->ColumnCount = 0;
+  this->endResetModel();
   this->updateModelFromMRML();
 }
 
@@ -24,7 +24,7 @@
 #define __qMRMLTableModel_h
 
 // Qt includes
-#include <QStandardItemModel>
+#include <QAbstractTableModel>
 
 // CTK includes
 #include <ctkPimpl.h>
@@ -35,12 +35,19 @@
 
 class vtkMRMLNode;
 class vtkMRMLTableNode;
+class vtkObject;
 class QAction;
 
 class qMRMLTableModelPrivate;
 
 //------------------------------------------------------------------------------
-class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QStandardItemModel
+/// \brief Item model of a MRML table node.
+///
+/// The model does not store the table content, cell values are read from the
+/// columns of the vtkTable when they are requested by the view (only the
+/// visible cells are accessed), and edits are written directly into the table.
+/// Therefore large tables can be displayed without copying them.
+class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QAbstractTableModel
 {
   Q_OBJECT
   QVTK_OBJECT
@@ -48,7 +55,7 @@ class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QStandardItemModel
   Q_PROPERTY(bool transposed READ transposed WRITE setTransposed)
 
 public:
-  typedef QAbstractItemModel Superclass;
+  typedef QAbstractTableModel Superclass;
   qMRMLTableModel(QObject *parent=0);
   virtual ~qMRMLTableModel();
 
@@ -64,10 +71,8 @@ public:
   void setTransposed(bool transposed);
   bool transposed()const;
 
-  /// Return the VTK table cell associated to the node index.
-  void updateMRMLFromModel(QStandardItem* item);
-
-  /// Update the entire table from the MRML node
+  /// Update the number of rows and columns from the MRML node and
+  /// notify the views that all the cells may have changed.
   void updateModelFromMRML();
 
   /// Get MRML table index from model index
@@ -82,9 +87,18 @@ public:
   /// model columns are deleted.
   int removeSelectionFromMRML(QModelIndexList selection, bool removeModelRow);
 
+  virtual int rowCount(const QModelIndex& parent = QModelIndex())const;
+  virtual int columnCount(const QModelIndex& parent = QModelIndex())const;
+  /// Cell values are read from the MRML table
+  virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole)const;
+  /// Cell values are written into the MRML table. Returns false if the cell
+  /// value cannot be set (for example the value cannot be converted to the type of the column).
+  virtual bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole);
+  virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole)const;
+  virtual Qt::ItemFlags flags(const QModelIndex& index)const;
+
 protected slots:
   void onMRMLTableNodeModified(vtkObject* node);
-  void onItemChanged(QStandardItem * item);
 
 protected:
 
@@ -312,7 +312,7 @@ void qMRMLTableView::copySelection()
         {
         textToCopy.append('\t');
         }
-      textToCopy.append(mrmlModel->item(rowIndex,columnIndex)->text());
+      textToCopy.append(mrmlModel->data(mrmlModel->index(rowIndex,columnIndex)).toString());
       }
     }
 
@@ -397,11 +397,11 @@ void qMRMLTableView::pasteSelection()
           }
         mrmlModel->updateModelFromMRML();
         }
-      // Set values in items
-      QStandardItem* item = mrmlModel->item(rowIndex,columnIndex);
-      if (item != NULL)
+      // Set values in cells
+      QModelIndex index = mrmlModel->index(rowIndex,columnIndex);
+      if (index.isValid())
         {
-        item->setText(cell);
+        mrmlModel->setData(index, cell);
         }
       else
         {
@@ -30,6 +30,7 @@
 
 // qMRML includes
 #include "qMRMLColors.h"
+#include "qMRMLRenderScheduler.h"
 #include "qMRMLThreeDView_p.h"
 
 // MRMLDisplayableManager includes
@@ -125,7 +126,7 @@ void qMRMLThreeDViewPrivate::initDisplayableManagers()
     = factory->InstantiateDisplayableManagers(q->renderer());
   // Observe displayable manager group to catch RequestRender events
   this->qvtkConnect(this->DisplayableManagerGroup, vtkCommand::UpdateEvent,
-                    q, SLOT(scheduleRender()));
+                    this, SLOT(requestRender()));
 }
 
 //---------------------------------------------------------------------------
@@ -191,6 +192,13 @@ void qMRMLThreeDViewPrivate::onSceneEndProcessing()
   q->setRenderEnabled(true);
 }
 
+// --------------------------------------------------------------------------
+void qMRMLThreeDViewPrivate::requestRender()
+{
+  Q_Q(qMRMLThreeDView);
+  qMRMLRenderScheduler::instance()->requestRender(q);
+}
+
 // --------------------------------------------------------------------------
 void qMRMLThreeDViewPrivate::updateWidgetFromMRML()
 {
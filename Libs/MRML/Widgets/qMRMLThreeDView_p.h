@@ -71,6 +71,10 @@ public slots:
 
   void updateWidgetFromMRML();
 
+  /// Handle render requests of the displayable managers
+  /// \sa qMRMLRenderScheduler
+  void requestRender();
+
 protected:
   void initDisplayableManagers();
 
@@ -5,9 +5,17 @@
 // MRML includes
 #include <vtkPermissionPrompter.h>
 
+// VTK includes
+#include <vtkMutexLock.h>
+#include <vtksys/SystemTools.hxx>
+
 // CURL includes
 #include <curl/curl.h>
 
+// STD includes
+#include <cstdio>
+#include <vector>
+
 #if defined(_MSC_VER)
 #pragma warning ( disable : 4786 )
 #endif
@@ -19,9 +27,22 @@ public:
   vtkInternal(vtkHTTPHandler* external);
   ~vtkInternal();
 
+  /// Return an idle curl handle from the pool, or a new one if there is none.
+  /// Reusing handles keeps their connections alive between transfers.
+  CURL* AcquireHandle();
+
+  /// Give back a handle after a transfer. The handle is kept for another
+  /// transfer unless \a reusable is false.
+  void ReleaseHandle(CURL* handle, bool reusable);
+
+  /// Cleanup all the idle handles, closing their connections.
+  void ClearHandles();
+
   vtkHTTPHandler* External;
-  CURL* CurlHandle;
+  std::vector<CURL*> IdleHandles;
+  vtkSimpleMutexLock* IdleHandlesLock;
   int ForbidReuse;
+  int ResumeDownloads;
 };
 
 //----------------------------------------------------------------------------
@@ -30,14 +51,69 @@ public:
 //----------------------------------------------------------------------------
 vtkHTTPHandler::vtkInternal::vtkInternal(vtkHTTPHandler* external):External(external)
 {
-  this->CurlHandle = NULL;
+  this->IdleHandlesLock = vtkSimpleMutexLock::New();
   this->ForbidReuse = 0;
+  this->ResumeDownloads = 1;
 }
 
 //-----------------------------------------------------------------------------
 vtkHTTPHandler::vtkInternal::~vtkInternal()
 {
-  this->CurlHandle = NULL;
+  this->ClearHandles();
+  this->IdleHandlesLock->Delete();
+}
+
+//-----------------------------------------------------------------------------
+CURL* vtkHTTPHandler::vtkInternal::AcquireHandle()
+{
+  CURL* handle = NULL;
+  this->IdleHandlesLock->Lock();
+  if (!this->IdleHandles.empty())
+    {
+    handle = this->IdleHandles.back();
+    this->IdleHandles.pop_back();
+    }
+  this->IdleHandlesLock->Unlock();
+  if (handle)
+    {
+    // reset the options but keep the live connections and DNS cache
+    curl_easy_reset(handle);
+    }
+  else
+    {
+    handle = curl_easy_init();
+    }
+  return handle;
+}
+
+//-----------------------------------------------------------------------------
+void vtkHTTPHandler::vtkInternal::ReleaseHandle(CURL* handle, bool reusable)
+{
+  if (handle == NULL)
+    {
+    return;
+    }
+  if (!reusable || this->ForbidReuse)
+    {
+    curl_easy_cleanup(handle);
+    return;
+    }
+  this->IdleHandlesLock->Lock();
+  this->IdleHandles.push_back(handle);
+  this->IdleHandlesLock->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+void vtkHTTPHandler::vtkInternal::ClearHandles()
+{
+  this->IdleHandlesLock->Lock();
+  std::vector<CURL*> handles;
+  handles.swap(this->IdleHandles);
+  this->IdleHandlesLock->Unlock();
+  for (std::vector<CURL*>::iterator it = handles.begin(); it != handles.end(); ++it)
+    {
+    curl_easy_cleanup(*it);
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -91,9 +167,67 @@ size_t ProgressCallback(FILE* vtkNotUsed( outputFile ), double dltotal, double d
   return 0;
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+
+//----------------------------------------------------------------------------
+void InitializeCurl()
+{
+  // curl_global_init is not thread safe, it is called once from the thread
+  // instantiating the first handler.
+  static bool initialized = false;
+  if (!initialized)
+    {
+    curl_global_init(CURL_GLOBAL_ALL);
+    initialized = true;
+    }
+}
+
+//----------------------------------------------------------------------------
+CURLcode DownloadFile(CURL* handle, const char* source, const std::string& fileName,
+                      curl_off_t resumeFrom, bool forbidReuse, long* responseCode)
+{
+  *responseCode = 0;
+  FILE* file = fopen(fileName.c_str(), resumeFrom > 0 ? "ab" : "wb");
+  if (file == NULL)
+    {
+    return CURLE_WRITE_ERROR;
+    }
+  if (forbidReuse)
+    {
+    curl_easy_setopt(handle, CURLOPT_FORBID_REUSE, 1L);
+    }
+  curl_easy_setopt(handle, CURLOPT_HTTPGET, 1L);
+  curl_easy_setopt(handle, CURLOPT_URL, source);
+  curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+  // don't write error pages into the file
+  curl_easy_setopt(handle, CURLOPT_FAILONERROR, 1L);
+  // use the default curl write call back, output goes into file, must be FILE*
+  curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, NULL);
+  curl_easy_setopt(handle, CURLOPT_WRITEDATA, file);
+  // quick timeout during connection phase if URL is not accessible (e.g. blocked by a firewall)
+  curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, 3L); // in seconds (type long)
+#if LIBCURL_VERSION_NUM >= 0x071900
+  // keep the idle pooled connections alive
+  curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+#endif
+  if (resumeFrom > 0)
+    {
+    curl_easy_setopt(handle, CURLOPT_RESUME_FROM_LARGE, resumeFrom);
+    }
+  CURLcode retval = curl_easy_perform(handle);
+  curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, responseCode);
+  fclose(file);
+  return retval;
+}
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 vtkHTTPHandler::vtkHTTPHandler()
 {
+  InitializeCurl();
   this->Internal = new vtkInternal(this);
 }
 
@@ -107,6 +241,11 @@ vtkHTTPHandler::~vtkHTTPHandler()
 void vtkHTTPHandler::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf ( os, indent );
+  os << indent << "ForbidReuse: " << this->Internal->ForbidReuse << "\n";
+  os << indent << "ResumeDownloads: " << this->Internal->ResumeDownloads << "\n";
+  this->Internal->IdleHandlesLock->Lock();
+  os << indent << "Idle connections: " << this->Internal->IdleHandles.size() << "\n";
+  this->Internal->IdleHandlesLock->Unlock();
 }
 
 //----------------------------------------------------------------------------
@@ -163,25 +302,36 @@ int vtkHTTPHandler::GetForbidReuse()
 }
 
 //----------------------------------------------------------------------------
-void vtkHTTPHandler::InitTransfer( )
+void vtkHTTPHandler::SetResumeDownloads(int value)
 {
-  curl_global_init(CURL_GLOBAL_ALL);
-  vtkDebugMacro("vtkHTTPHandler: InitTransfer: initialising CurlHandle");
-  this->Internal->CurlHandle = curl_easy_init();
-  if (this->Internal->CurlHandle == NULL)
+  if (this->Internal->ResumeDownloads == value)
     {
-    vtkErrorMacro("InitTransfer: unable to initialise");
+    return;
     }
+  this->Internal->ResumeDownloads = value;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkHTTPHandler::GetResumeDownloads()
+{
+  return this->Internal->ResumeDownloads;
+}
+
+//----------------------------------------------------------------------------
+void vtkHTTPHandler::InitTransfer( )
+{
+  InitializeCurl();
 }
 
 //----------------------------------------------------------------------------
 int vtkHTTPHandler::CloseTransfer( )
 {
-  curl_easy_cleanup(this->Internal->CurlHandle);
+  vtkDebugMacro("vtkHTTPHandler: CloseTransfer: closing idle connections");
+  this->Internal->ClearHandles();
   return EXIT_SUCCESS;
 }
 
-
 //----------------------------------------------------------------------------
 void vtkHTTPHandler::StageFileRead(const char * source, const char * destination)
 {
@@ -190,47 +340,57 @@ void vtkHTTPHandler::StageFileRead(const char * source, const char * destination
     vtkErrorMacro("StageFileRead: source or dest is null!");
     return;
     }
-  /*
-  if (this->LocalFile)
+
+  CURL* handle = this->Internal->AcquireHandle();
+  if (handle == NULL)
     {
-    this->LocalFile->close();
-    delete this->LocalFile;
-    this->LocalFile = NULL;
+    vtkErrorMacro("StageFileRead: unable to initialise");
+    return;
     }
-  this->LocalFile = new std::ofstream(destination, std::ios::binary);
-  */
-  this->InitTransfer( );
 
-
-  if ( this->Internal->ForbidReuse )
+  // Download into a partial file renamed once complete, an interrupted
+  // download is resumed from where it stopped.
+  std::string partialFileName = std::string(destination) + ".part";
+  curl_off_t resumeFrom = 0;
+  if (this->Internal->ResumeDownloads &&
+      vtksys::SystemTools::FileExists(partialFileName.c_str(), true))
     {
-    curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_FORBID_REUSE, 1);
+    resumeFrom = static_cast<curl_off_t>(
+      vtksys::SystemTools::FileLength(partialFileName.c_str()));
     }
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_HTTPGET, 1);
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_URL, source);
-//  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_NOPROGRESS, false);
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_FOLLOWLOCATION, true);
-  // use the default curl write call back
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_WRITEFUNCTION, NULL); // write_callback);
-  this->LocalFile = fopen(destination, "wb");
-  // output goes into LocalFile, must be  FILE*
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_WRITEDATA, this->LocalFile);
-//  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_PROGRESSDATA, NULL);
-//  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_PROGRESSFUNCTION, ProgressCallback);
-
-  // quick timeout during connection phase if URL is not accessible (e.g. blocked by a firewall)
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_CONNECTTIMEOUT, 3); // in seconds (type long)
 
-  vtkDebugMacro("StageFileRead: about to do the curl download... source = " << source << ", dest = " << destination);
-  CURLcode retval = curl_easy_perform(this->Internal->CurlHandle);
+  vtkDebugMacro("StageFileRead: about to do the curl download... source = " << source
+                << ", dest = " << destination << ", resume from = " << resumeFrom);
+  long responseCode = 0;
+  CURLcode retval = DownloadFile(handle, source, partialFileName, resumeFrom,
+                                 this->Internal->ForbidReuse != 0, &responseCode);
+  if (resumeFrom > 0 &&
+      (retval == CURLE_RANGE_ERROR ||
+       (retval == CURLE_HTTP_RETURNED_ERROR && responseCode == 416)))
+    {
+    // the server doesn't support range requests or the file changed,
+    // download it again
+    vtkDebugMacro("StageFileRead: unable to resume download, restarting it");
+    curl_easy_reset(handle);
+    retval = DownloadFile(handle, source, partialFileName, 0,
+                          this->Internal->ForbidReuse != 0, &responseCode);
+    }
+  this->Internal->ReleaseHandle(handle, true);
 
   if (retval == CURLE_OK)
     {
     vtkDebugMacro("StageFileRead: successful return from curl");
+    vtksys::SystemTools::RemoveFile(destination);
+    if (rename(partialFileName.c_str(), destination) != 0)
+      {
+      vtkErrorMacro("StageFileRead: unable to rename " << partialFileName << " into " << destination);
+      }
+    return;
     }
-  else if (retval == CURLE_BAD_FUNCTION_ARGUMENT)
+
+  if (retval == CURLE_BAD_FUNCTION_ARGUMENT)
     {
-    vtkErrorMacro("StageFileRead: bad function argument to curl, did you init CurlHandle?");
+    vtkErrorMacro("StageFileRead: bad function argument to curl");
     }
   else if (retval == CURLE_OUT_OF_MEMORY)
     {
@@ -249,16 +409,11 @@ void vtkHTTPHandler::StageFileRead(const char * source, const char * destination
       this->GetPermissionPrompter()->SetRemember ( 0 );
       }
     }
-  this->CloseTransfer();
-
-  /*
-  this->LocalFile->close();
-  delete this->LocalFile;
-  this->LocalFile = NULL;
-  */
-  if (this->LocalFile)
+  // keep what has been downloaded to resume later
+  if (!this->Internal->ResumeDownloads ||
+      vtksys::SystemTools::FileLength(partialFileName.c_str()) == 0)
     {
-    fclose(this->LocalFile);
+    vtksys::SystemTools::RemoveFile(partialFileName.c_str());
     }
 }
 
@@ -266,35 +421,49 @@ void vtkHTTPHandler::StageFileRead(const char * source, const char * destination
 //----------------------------------------------------------------------------
 void vtkHTTPHandler::StageFileWrite(const char * source, const char * destination)
 {
-  //--- check these arguments...
-  /*
-  if (this->LocalFile)
+  if (source == NULL || destination == NULL)
+    {
+    vtkErrorMacro("StageFileWrite: source or dest is null!");
+    return;
+    }
+  FILE* localFile = fopen(source, "rb");
+  if (localFile == NULL)
     {
-    this->LocalFile->close();
-    delete this->LocalFile;
-    this->LocalFile = NULL;
+    vtkErrorMacro("StageFileWrite: unable to open " << source);
+    return;
     }
-  this->LocalFile = new std::ofstream(destination, std::ios::binary);
-  */
-  this->LocalFile = fopen(source, "r");
 
-  this->InitTransfer( );
+  CURL* handle = this->Internal->AcquireHandle();
+  if (handle == NULL)
+    {
+    vtkErrorMacro("StageFileWrite: unable to initialise");
+    fclose(localFile);
+    return;
+    }
 
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_PUT, 1);
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_URL, destination);
-//  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_NOPROGRESS, false);
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_FOLLOWLOCATION, true);
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_READFUNCTION, read_callback);
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_READDATA, this->LocalFile);
-//  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_PROGRESSDATA, NULL);
-  //curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_PROGRESSFUNCTION, ProgressCallback);
-  CURLcode retval = curl_easy_perform(this->Internal->CurlHandle);
+  if ( this->Internal->ForbidReuse )
+    {
+    curl_easy_setopt(handle, CURLOPT_FORBID_REUSE, 1L);
+    }
+  curl_easy_setopt(handle, CURLOPT_PUT, 1L);
+  curl_easy_setopt(handle, CURLOPT_URL, destination);
+  curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+  curl_easy_setopt(handle, CURLOPT_READFUNCTION, read_callback);
+  curl_easy_setopt(handle, CURLOPT_READDATA, localFile);
+  curl_easy_setopt(handle, CURLOPT_INFILESIZE_LARGE,
+                   static_cast<curl_off_t>(vtksys::SystemTools::FileLength(source)));
+#if LIBCURL_VERSION_NUM >= 0x071900
+  curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+#endif
+  CURLcode retval = curl_easy_perform(handle);
+  this->Internal->ReleaseHandle(handle, true);
+  fclose(localFile);
 
-   if (retval == CURLE_OK)
+  if (retval == CURLE_OK)
     {
     vtkDebugMacro("StageFileWrite: successful return from curl");
     }
-   else
+  else
     {
     const char *stringError = curl_easy_strerror(retval);
     vtkErrorMacro("StageFileWrite: error running curl: " << stringError);
@@ -307,13 +476,4 @@ void vtkHTTPHandler::StageFileWrite(const char * source, const char * destinatio
       this->GetPermissionPrompter()->SetRemember ( 0 );
       }
     }
-
-  this->CloseTransfer();
-
-  fclose(this->LocalFile);
-  /*
-  this->LocalFile->close();
-  delete this->LocalFile;
-  this->LocalFile = NULL;
-  */
 }
@@ -32,12 +32,24 @@ public:
   void SetForbidReuse(int value);
   int GetForbidReuse();
 
-  /// This function wraps curl functionality to download a specified URL to a specified dir
+  /// When set, downloads are written into a "<destination>.part" file that
+  /// is kept if the transfer fails, the next download of the same file
+  /// resumes from where it stopped using a range request.
+  /// On by default.
+  void SetResumeDownloads(int value);
+  int GetResumeDownloads();
+
+  /// Download \a source into \a destination.
+  /// The handler is thread safe: transfers can run concurrently, each one
+  /// uses its own curl handle. Handles are kept after a transfer and reused
+  /// by the next one so that connections to the servers stay open.
   void StageFileRead(const char * source, const char * destination);
   using vtkURIHandler::StageFileRead;
   void StageFileWrite(const char * source, const char * destination);
   using vtkURIHandler::StageFileWrite;
+  /// Initialize curl.
   virtual void InitTransfer ( );
+  /// Close the connections kept open for reuse.
   virtual int CloseTransfer ( );
 
 protected:
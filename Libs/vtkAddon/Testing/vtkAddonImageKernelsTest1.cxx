@@ -0,0 +1,305 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include "vtkAddonImageKernels.h"
+#include "vtkAddonTestingMacros.h"
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+
+using namespace vtkAddonTestingUtilities;
+
+//----------------------------------------------------------------------------
+int RegistryTest();
+int ScalarRangeTest();
+int ThresholdTest();
+int HistogramTest();
+int MaskedCopyTest();
+int RemapLabelsTest();
+
+//----------------------------------------------------------------------------
+int vtkAddonImageKernelsTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkAddonImageKernels> kernels;
+  kernels->Print(std::cout);
+
+  CHECK_EXIT_SUCCESS(RegistryTest());
+  CHECK_EXIT_SUCCESS(ScalarRangeTest());
+  CHECK_EXIT_SUCCESS(ThresholdTest());
+  CHECK_EXIT_SUCCESS(HistogramTest());
+  CHECK_EXIT_SUCCESS(MaskedCopyTest());
+  CHECK_EXIT_SUCCESS(RemapLabelsTest());
+  return EXIT_SUCCESS;
+}
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// 13x11x7 image (not a multiple of the vector sizes) of pseudo-random values
+void CreateImage(vtkImageData* image, int scalarType, int numberOfComponents, int seed)
+{
+  image->SetDimensions(13, 11, 7);
+  image->AllocateScalars(scalarType, numberOfComponents);
+  vtkMath::RandomSeed(seed);
+  const vtkIdType numberOfValues = image->GetNumberOfPoints() * numberOfComponents;
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+    {
+    const double value = scalarType == VTK_UNSIGNED_CHAR ?
+      floor(vtkMath::Random(0., 4.)) : vtkMath::Random(-1000., 1000.);
+    image->GetPointData()->GetScalars()->SetComponent(
+      i / numberOfComponents, i % numberOfComponents, value);
+    }
+}
+
+//----------------------------------------------------------------------------
+void TestScalarRange(const void* vtkNotUsed(values), vtkIdType vtkNotUsed(numberOfValues), double range[2])
+{
+  range[0] = -1.;
+  range[1] = 1.;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int RegistryTest()
+{
+  CHECK_BOOL(vtkAddonImageKernels::IsCPUFeatureSupported(vtkAddonImageKernels::Generic), true);
+  CHECK_BOOL(vtkAddonImageKernels::IsCPUFeatureSupported(vtkAddonImageKernels::CPUFeature_Last), false);
+  CHECK_BOOL(vtkAddonImageKernels::GetUseOptimizedKernels(), true);
+
+  // Generic kernels are registered for all the scalar types
+  const char* names[] = {
+    vtkAddonImageKernels::ScalarRangeKernelName, vtkAddonImageKernels::ThresholdKernelName,
+    vtkAddonImageKernels::HistogramKernelName, vtkAddonImageKernels::MaskedCopyKernelName,
+    vtkAddonImageKernels::RemapLabelsKernelName };
+  const int scalarTypes[] = {
+    VTK_CHAR, VTK_SIGNED_CHAR, VTK_UNSIGNED_CHAR, VTK_SHORT, VTK_UNSIGNED_SHORT, VTK_INT,
+    VTK_UNSIGNED_INT, VTK_LONG, VTK_UNSIGNED_LONG, VTK_FLOAT, VTK_DOUBLE, VTK_ID_TYPE };
+  for (int i = 0; i < 5; ++i)
+    {
+    for (int j = 0; j < 12; ++j)
+      {
+      int feature = -1;
+      CHECK_NOT_NULL(vtkAddonImageKernels::GetKernel(names[i], scalarTypes[j], &feature));
+      CHECK_BOOL(vtkAddonImageKernels::IsCPUFeatureSupported(feature), true);
+      }
+    }
+  int feature = 0;
+  CHECK_NULL(vtkAddonImageKernels::GetKernel("UnknownKernel", VTK_FLOAT, &feature));
+  CHECK_INT(feature, -1);
+
+  // Registered kernels are selected, unless the feature is not supported
+  vtkAddonImageKernels::RegisterKernel("TestKernel", VTK_INT, vtkAddonImageKernels::Generic,
+    reinterpret_cast<vtkAddonImageKernels::KernelFunction>(&TestScalarRange));
+  CHECK_BOOL(vtkAddonImageKernels::GetKernel("TestKernel", VTK_INT, &feature) ==
+    reinterpret_cast<vtkAddonImageKernels::KernelFunction>(&TestScalarRange), true);
+  CHECK_INT(feature, vtkAddonImageKernels::Generic);
+  CHECK_NULL(vtkAddonImageKernels::GetKernel("TestKernel", VTK_FLOAT));
+
+  vtkAddonImageKernels::RegisterKernel("TestKernel", VTK_FLOAT, vtkAddonImageKernels::AVX512,
+    reinterpret_cast<vtkAddonImageKernels::KernelFunction>(&TestScalarRange));
+  CHECK_BOOL(vtkAddonImageKernels::GetKernel("TestKernel", VTK_FLOAT) != 0,
+    vtkAddonImageKernels::IsCPUFeatureSupported(vtkAddonImageKernels::AVX512));
+  vtkAddonImageKernels::SetUseOptimizedKernels(false);
+  CHECK_NULL(vtkAddonImageKernels::GetKernel("TestKernel", VTK_FLOAT));
+  vtkAddonImageKernels::SetUseOptimizedKernels(true);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int ScalarRangeTest()
+{
+  const int scalarTypes[] = { VTK_UNSIGNED_CHAR, VTK_SHORT, VTK_INT, VTK_FLOAT, VTK_DOUBLE };
+  for (int i = 0; i < 5; ++i)
+    {
+    vtkNew<vtkImageData> image;
+    CreateImage(image.GetPointer(), scalarTypes[i], 2, i);
+    double expectedRange[2] = { 0., 0. };
+    image->GetPointData()->GetScalars()->GetRange(expectedRange, -1);
+
+    double range[2] = { 0., 0. };
+    CHECK_BOOL(vtkAddonImageKernels::GetScalarRange(image.GetPointer(), range), true);
+    CHECK_DOUBLE(range[0], expectedRange[0]);
+    CHECK_DOUBLE(range[1], expectedRange[1]);
+
+    vtkAddonImageKernels::SetUseOptimizedKernels(false);
+    CHECK_BOOL(vtkAddonImageKernels::GetScalarRange(image.GetPointer(), range), true);
+    vtkAddonImageKernels::SetUseOptimizedKernels(true);
+    CHECK_DOUBLE(range[0], expectedRange[0]);
+    CHECK_DOUBLE(range[1], expectedRange[1]);
+    }
+
+  // NaNs are ignored
+  vtkNew<vtkImageData> image;
+  CreateImage(image.GetPointer(), VTK_FLOAT, 1, 5);
+  double expectedRange[2] = { 0., 0. };
+  image->GetScalarRange(expectedRange);
+  image->SetScalarComponentFromDouble(3, 2, 1, 0, vtkMath::Nan());
+  double range[2] = { 0., 0. };
+  CHECK_BOOL(vtkAddonImageKernels::GetScalarRange(image.GetPointer(), range), true);
+  CHECK_DOUBLE(range[0], expectedRange[0]);
+  CHECK_DOUBLE(range[1], expectedRange[1]);
+
+  vtkNew<vtkImageData> emptyImage;
+  CHECK_BOOL(vtkAddonImageKernels::GetScalarRange(emptyImage.GetPointer(), range), false);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int ThresholdTest()
+{
+  const int scalarTypes[] = { VTK_SHORT, VTK_INT, VTK_FLOAT, VTK_DOUBLE };
+  for (int i = 0; i < 4; ++i)
+    {
+    vtkNew<vtkImageData> image;
+    CreateImage(image.GetPointer(), scalarTypes[i], 1, i);
+    vtkNew<vtkImageData> output;
+    CHECK_BOOL(vtkAddonImageKernels::Threshold(image.GetPointer(), -100.5, 250.25, 1., 2., output.GetPointer()), true);
+    CHECK_INT(output->GetScalarType(), scalarTypes[i]);
+    CHECK_INT(output->GetNumberOfPoints(), image->GetNumberOfPoints());
+
+    vtkNew<vtkImageData> genericOutput;
+    vtkAddonImageKernels::SetUseOptimizedKernels(false);
+    CHECK_BOOL(vtkAddonImageKernels::Threshold(image.GetPointer(), -100.5, 250.25, 1., 2., genericOutput.GetPointer()), true);
+    vtkAddonImageKernels::SetUseOptimizedKernels(true);
+
+    vtkDataArray* scalars = image->GetPointData()->GetScalars();
+    for (vtkIdType j = 0; j < image->GetNumberOfPoints(); ++j)
+      {
+      const double value = scalars->GetTuple1(j);
+      const double expectedValue = (value >= -100.5 && value <= 250.25) ? 1. : 2.;
+      CHECK_DOUBLE(output->GetPointData()->GetScalars()->GetTuple1(j), expectedValue);
+      CHECK_DOUBLE(genericOutput->GetPointData()->GetScalars()->GetTuple1(j), expectedValue);
+      }
+
+    // In place, output values are clamped to the scalar type
+    CHECK_BOOL(vtkAddonImageKernels::Threshold(image.GetPointer(), 0., VTK_DOUBLE_MAX, 1e5, -1e5, image.GetPointer()), true);
+    double range[2] = { 0., 0. };
+    image->GetScalarRange(range);
+    CHECK_DOUBLE(range[0], std::max(-1e5, image->GetScalarTypeMin()));
+    CHECK_DOUBLE(range[1], std::min(1e5, image->GetScalarTypeMax()));
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int HistogramTest()
+{
+  vtkNew<vtkImageData> image;
+  CreateImage(image.GetPointer(), VTK_SHORT, 1, 7);
+  vtkNew<vtkIdTypeArray> bins;
+  CHECK_BOOL(vtkAddonImageKernels::ComputeHistogram(image.GetPointer(), -500., 100., 10, bins.GetPointer()), true);
+  CHECK_INT(bins->GetNumberOfTuples(), 10);
+
+  vtkIdType expectedBins[10] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    const int bin = static_cast<int>(floor((scalars->GetTuple1(i) + 500.) / 100.));
+    if (bin >= 0 && bin < 10)
+      {
+      ++expectedBins[bin];
+      }
+    }
+  for (int i = 0; i < 10; ++i)
+    {
+    CHECK_INT(bins->GetValue(i), expectedBins[i]);
+    }
+
+  TESTING_OUTPUT_ASSERT_WARNINGS_BEGIN();
+  CHECK_BOOL(vtkAddonImageKernels::ComputeHistogram(image.GetPointer(), 0., 0., 10, bins.GetPointer()), false);
+  TESTING_OUTPUT_ASSERT_WARNINGS_END();
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int MaskedCopyTest()
+{
+  vtkNew<vtkImageData> source;
+  CreateImage(source.GetPointer(), VTK_FLOAT, 3, 1);
+  vtkNew<vtkImageData> target;
+  CreateImage(target.GetPointer(), VTK_FLOAT, 3, 2);
+  vtkNew<vtkImageData> originalTarget;
+  originalTarget->DeepCopy(target.GetPointer());
+  vtkNew<vtkImageData> mask;
+  CreateImage(mask.GetPointer(), VTK_UNSIGNED_CHAR, 1, 3);
+
+  CHECK_BOOL(vtkAddonImageKernels::MaskedCopy(source.GetPointer(), mask.GetPointer(), target.GetPointer()), true);
+  for (vtkIdType i = 0; i < target->GetNumberOfPoints(); ++i)
+    {
+    vtkImageData* expected = mask->GetPointData()->GetScalars()->GetTuple1(i) != 0. ?
+      source.GetPointer() : originalTarget.GetPointer();
+    for (int c = 0; c < 3; ++c)
+      {
+      CHECK_DOUBLE(target->GetPointData()->GetScalars()->GetComponent(i, c),
+                   expected->GetPointData()->GetScalars()->GetComponent(i, c));
+      }
+    }
+
+  // The mask must be unsigned char
+  TESTING_OUTPUT_ASSERT_WARNINGS_BEGIN();
+  CHECK_BOOL(vtkAddonImageKernels::MaskedCopy(source.GetPointer(), source.GetPointer(), target.GetPointer()), false);
+  TESTING_OUTPUT_ASSERT_WARNINGS_END();
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int RemapLabelsTest()
+{
+  // The lookup table (unsigned char) and map (int) implementations
+  const int scalarTypes[] = { VTK_UNSIGNED_CHAR, VTK_INT };
+  for (int i = 0; i < 2; ++i)
+    {
+    vtkNew<vtkImageData> image;
+    CreateImage(image.GetPointer(), VTK_UNSIGNED_CHAR, 1, 4);
+    vtkNew<vtkImageData> labelmap;
+    labelmap->SetDimensions(image->GetDimensions());
+    labelmap->AllocateScalars(scalarTypes[i], 1);
+    labelmap->GetPointData()->GetScalars()->DeepCopy(image->GetPointData()->GetScalars());
+
+    // 1 <-> 2, 3 -> 0, 0.5 is not a label
+    vtkNew<vtkDoubleArray> fromLabels;
+    vtkNew<vtkDoubleArray> toLabels;
+    fromLabels->InsertNextValue(1.);
+    toLabels->InsertNextValue(2.);
+    fromLabels->InsertNextValue(2.);
+    toLabels->InsertNextValue(1.);
+    fromLabels->InsertNextValue(3.);
+    toLabels->InsertNextValue(0.);
+    fromLabels->InsertNextValue(0.5);
+    toLabels->InsertNextValue(3.);
+    CHECK_BOOL(vtkAddonImageKernels::RemapLabels(labelmap.GetPointer(), fromLabels.GetPointer(), toLabels.GetPointer()), true);
+
+    const double expectedLabels[4] = { 0., 2., 1., 0. };
+    for (vtkIdType j = 0; j < image->GetNumberOfPoints(); ++j)
+      {
+      const int label = static_cast<int>(image->GetPointData()->GetScalars()->GetTuple1(j));
+      CHECK_DOUBLE(labelmap->GetPointData()->GetScalars()->GetTuple1(j), expectedLabels[label]);
+      }
+    }
+  return EXIT_SUCCESS;
+}
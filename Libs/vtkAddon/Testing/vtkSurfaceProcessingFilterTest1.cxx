@@ -0,0 +1,289 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include "vtkAddonTestingMacros.h"
+#include "vtkSurfaceProcessingFilter.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPlaneSource.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkSphereSource.h>
+#include <vtkTriangleFilter.h>
+
+// STD includes
+#include <cmath>
+#include <vector>
+
+using namespace vtkAddonTestingUtilities;
+
+//----------------------------------------------------------------------------
+int NormalsTest();
+int LaplaceSmoothingTest();
+int BoundarySmoothingTest();
+int DecimationTest();
+int MirrorTest();
+
+//----------------------------------------------------------------------------
+int vtkSurfaceProcessingFilterTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(NormalsTest());
+  CHECK_EXIT_SUCCESS(LaplaceSmoothingTest());
+  CHECK_EXIT_SUCCESS(BoundarySmoothingTest());
+  CHECK_EXIT_SUCCESS(DecimationTest());
+  CHECK_EXIT_SUCCESS(MirrorTest());
+  return EXIT_SUCCESS;
+}
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void CreateSphere(vtkPolyData* sphere)
+{
+  vtkNew<vtkSphereSource> source;
+  source->SetThetaResolution(60);
+  source->SetPhiResolution(40);
+  source->SetRadius(10.);
+  source->Update();
+  sphere->DeepCopy(source->GetOutput());
+}
+
+//----------------------------------------------------------------------------
+// Deterministic displacement of all the points along z.
+void AddNoise(vtkPolyData* surface)
+{
+  vtkPoints* points = surface->GetPoints();
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+    {
+    double point[3];
+    points->GetPoint(i, point);
+    point[2] += 0.5 * sin(static_cast<double>(i * 7919 % 1000));
+    points->SetPoint(i, point);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Mean absolute deviation of the distances of the points to the origin.
+double RadiusDeviation(vtkPolyData* surface)
+{
+  const vtkIdType numberOfPoints = surface->GetNumberOfPoints();
+  std::vector<double> radii(numberOfPoints);
+  double meanRadius = 0.;
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+    double point[3];
+    surface->GetPoint(i, point);
+    radii[i] = vtkMath::Norm(point);
+    meanRadius += radii[i] / numberOfPoints;
+    }
+  double deviation = 0.;
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+    deviation += fabs(radii[i] - meanRadius) / numberOfPoints;
+    }
+  return deviation;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int NormalsTest()
+{
+  vtkNew<vtkPolyData> sphere;
+  CreateSphere(sphere.GetPointer());
+
+  vtkNew<vtkPolyDataNormals> reference;
+  reference->SetInputData(sphere.GetPointer());
+  reference->ConsistencyOn();
+  reference->SplittingOff();
+  reference->AutoOrientNormalsOn();
+  reference->Update();
+
+  vtkNew<vtkSurfaceProcessingFilter> filter;
+  filter->SetInputData(sphere.GetPointer());
+  filter->NormalsOn();
+  filter->AutoOrientNormalsOn();
+  filter->SetNumberOfThreads(4);
+  filter->Update();
+
+  vtkDataArray* expectedNormals = reference->GetOutput()->GetPointData()->GetNormals();
+  vtkDataArray* normals = filter->GetOutput()->GetPointData()->GetNormals();
+  CHECK_NOT_NULL(normals);
+  CHECK_INT(normals->GetNumberOfTuples(), expectedNormals->GetNumberOfTuples());
+  for (vtkIdType i = 0; i < normals->GetNumberOfTuples(); ++i)
+    {
+    double normal[3];
+    double expectedNormal[3];
+    normals->GetTuple(i, normal);
+    expectedNormals->GetTuple(i, expectedNormal);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Dot(normal, expectedNormal), 1., 1e-5);
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int LaplaceSmoothingTest()
+{
+  vtkNew<vtkPolyData> sphere;
+  CreateSphere(sphere.GetPointer());
+  AddNoise(sphere.GetPointer());
+
+  vtkNew<vtkSurfaceProcessingFilter> filter;
+  filter->SetInputData(sphere.GetPointer());
+  filter->SmoothingOn();
+  filter->SetSmoothingMethodToLaplace();
+  filter->SetLaplaceNumberOfIterations(20);
+
+  // Result must not depend on the number of threads
+  filter->SetNumberOfThreads(1);
+  filter->Update();
+  vtkNew<vtkPolyData> singleThreaded;
+  singleThreaded->DeepCopy(filter->GetOutput());
+  filter->SetNumberOfThreads(5);
+  filter->Update();
+  vtkPolyData* multiThreaded = filter->GetOutput();
+
+  CHECK_INT(multiThreaded->GetNumberOfPoints(), sphere->GetNumberOfPoints());
+  CHECK_INT(multiThreaded->GetNumberOfPolys(), sphere->GetNumberOfPolys());
+  for (vtkIdType i = 0; i < multiThreaded->GetNumberOfPoints(); ++i)
+    {
+    double point[3];
+    double expectedPoint[3];
+    multiThreaded->GetPoint(i, point);
+    singleThreaded->GetPoint(i, expectedPoint);
+    CHECK_DOUBLE(point[0], expectedPoint[0]);
+    CHECK_DOUBLE(point[1], expectedPoint[1]);
+    CHECK_DOUBLE(point[2], expectedPoint[2]);
+    }
+
+  // Smoothing brings the points closer to a sphere (that shrinks a little)
+  const double inputDeviation = RadiusDeviation(sphere.GetPointer());
+  const double outputDeviation = RadiusDeviation(multiThreaded);
+  if (outputDeviation >= inputDeviation)
+    {
+    std::cerr << "Line " << __LINE__ << ": smoothing did not reduce the noise: "
+              << inputDeviation << " -> " << outputDeviation << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int BoundarySmoothingTest()
+{
+  vtkNew<vtkPlaneSource> plane;
+  plane->SetResolution(20, 20);
+  vtkNew<vtkTriangleFilter> triangle;
+  triangle->SetInputConnection(plane->GetOutputPort());
+  triangle->Update();
+  vtkNew<vtkPolyData> surface;
+  surface->DeepCopy(triangle->GetOutput());
+  AddNoise(surface.GetPointer());
+
+  vtkNew<vtkSurfaceProcessingFilter> filter;
+  filter->SetInputData(surface.GetPointer());
+  filter->SmoothingOn();
+  filter->BoundarySmoothingOff();
+  filter->SetLaplaceNumberOfIterations(10);
+  filter->Update();
+
+  // Boundary points are fixed, interior points are flattened.
+  double inputDeviation = 0.;
+  double outputDeviation = 0.;
+  for (vtkIdType i = 0; i < surface->GetNumberOfPoints(); ++i)
+    {
+    double inputPoint[3];
+    double point[3];
+    surface->GetPoint(i, inputPoint);
+    filter->GetOutput()->GetPoint(i, point);
+    const bool boundary = fabs(fabs(inputPoint[0]) - 0.5) < 1e-6 || fabs(fabs(inputPoint[1]) - 0.5) < 1e-6;
+    if (boundary)
+      {
+      CHECK_DOUBLE(point[0], inputPoint[0]);
+      CHECK_DOUBLE(point[1], inputPoint[1]);
+      CHECK_DOUBLE(point[2], inputPoint[2]);
+      }
+    else
+      {
+      inputDeviation += fabs(inputPoint[2]);
+      outputDeviation += fabs(point[2]);
+      }
+    }
+  if (outputDeviation >= inputDeviation)
+    {
+    std::cerr << "Line " << __LINE__ << ": smoothing did not flatten the plane: "
+              << inputDeviation << " -> " << outputDeviation << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int DecimationTest()
+{
+  vtkNew<vtkPolyData> sphere;
+  CreateSphere(sphere.GetPointer());
+
+  vtkNew<vtkSurfaceProcessingFilter> filter;
+  filter->SetInputData(sphere.GetPointer());
+  filter->DecimationOn();
+  filter->SetDecimationMethodToQuadricDecimation();
+  filter->SetTargetNumberOfTriangles(sphere->GetNumberOfPolys() / 10);
+  filter->CleanOn();
+  filter->ConnectivityOn();
+  filter->Update();
+
+  const vtkIdType numberOfTriangles = filter->GetOutput()->GetNumberOfPolys();
+  if (numberOfTriangles == 0 || numberOfTriangles > sphere->GetNumberOfPolys() / 8)
+    {
+    std::cerr << "Line " << __LINE__ << ": unexpected number of triangles after decimation: "
+              << numberOfTriangles << " (target: " << sphere->GetNumberOfPolys() / 10 << ")" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  CHECK_BOOL(filter->GetOutput()->GetNumberOfPoints() < sphere->GetNumberOfPoints(), true);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int MirrorTest()
+{
+  vtkNew<vtkPolyData> sphere;
+  CreateSphere(sphere.GetPointer());
+  AddNoise(sphere.GetPointer());
+
+  vtkNew<vtkSurfaceProcessingFilter> filter;
+  filter->SetInputData(sphere.GetPointer());
+  filter->MirrorOn();
+  filter->MirrorXOn();
+  filter->Update();
+
+  double bounds[6];
+  double expectedBounds[6];
+  filter->GetOutput()->GetBounds(bounds);
+  sphere->GetBounds(expectedBounds);
+  CHECK_DOUBLE_TOLERANCE(bounds[0], -expectedBounds[1], 1e-6);
+  CHECK_DOUBLE_TOLERANCE(bounds[1], -expectedBounds[0], 1e-6);
+  CHECK_DOUBLE_TOLERANCE(bounds[4], expectedBounds[4], 1e-6);
+  CHECK_DOUBLE_TOLERANCE(bounds[5], expectedBounds[5], 1e-6);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,652 @@
+/*=auto==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+===============================================================================auto=*/
+
+// vtkAddon includes
+#include "vtkAddonImageKernels.h"
+#ifdef vtkAddon_HAS_AVX2_KERNELS
+#include "vtkAddonImageKernelsAVX2.h"
+#endif
+
+// VTK includes
+#include <vtkCriticalSection.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <cmath>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# include <intrin.h>
+# define vtkAddonImageKernels_X86
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# include <cpuid.h>
+# define vtkAddonImageKernels_X86
+#endif
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkAddonImageKernels);
+
+const char* vtkAddonImageKernels::ScalarRangeKernelName = "ScalarRange";
+const char* vtkAddonImageKernels::ThresholdKernelName = "Threshold";
+const char* vtkAddonImageKernels::HistogramKernelName = "Histogram";
+const char* vtkAddonImageKernels::MaskedCopyKernelName = "MaskedCopy";
+const char* vtkAddonImageKernels::RemapLabelsKernelName = "RemapLabels";
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// CPU feature detection
+
+#ifdef vtkAddonImageKernels_X86
+//----------------------------------------------------------------------------
+bool CPUID(unsigned int leaf, unsigned int registers[4])
+{
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (static_cast<unsigned int>(info[0]) < leaf)
+    {
+    return false;
+    }
+  __cpuidex(info, static_cast<int>(leaf), 0);
+  for (int i = 0; i < 4; ++i)
+    {
+    registers[i] = static_cast<unsigned int>(info[i]);
+    }
+  return true;
+#else
+  if (__get_cpuid_max(0, 0) < leaf)
+    {
+    return false;
+    }
+  __cpuid_count(leaf, 0, registers[0], registers[1], registers[2], registers[3]);
+  return true;
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Register states saved by the operating system on context switches.
+unsigned long long XGETBV()
+{
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  unsigned int eax = 0;
+  unsigned int edx = 0;
+  __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+//----------------------------------------------------------------------------
+bool DetectCPUFeature(int feature)
+{
+  switch (feature)
+    {
+    case vtkAddonImageKernels::Generic:
+      return true;
+    case vtkAddonImageKernels::NEON:
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+      return true;
+#else
+      return false;
+#endif
+    case vtkAddonImageKernels::AVX2:
+    case vtkAddonImageKernels::AVX512:
+      {
+#ifdef vtkAddonImageKernels_X86
+      unsigned int registers[4];
+      // OSXSAVE and AVX
+      if (!CPUID(1, registers) || (registers[2] & (1u << 27)) == 0 || (registers[2] & (1u << 28)) == 0)
+        {
+        return false;
+        }
+      // XMM, YMM (and opmask, ZMM for AVX-512) states
+      const unsigned long long stateMask = (feature == vtkAddonImageKernels::AVX2 ? 0x6ull : 0xe6ull);
+      if ((XGETBV() & stateMask) != stateMask || !CPUID(7, registers))
+        {
+        return false;
+        }
+      // AVX2 or AVX512F
+      return (registers[1] & (feature == vtkAddonImageKernels::AVX2 ? (1u << 5) : (1u << 16))) != 0;
+#else
+      return false;
+#endif
+      }
+    default:
+      return false;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Registry
+
+struct KernelImplementations
+{
+  KernelImplementations()
+    {
+    for (int i = 0; i < vtkAddonImageKernels::CPUFeature_Last; ++i)
+      {
+      this->Functions[i] = 0;
+      }
+    }
+  vtkAddonImageKernels::KernelFunction Functions[vtkAddonImageKernels::CPUFeature_Last];
+};
+
+typedef std::map<std::pair<std::string, int>, KernelImplementations> KernelMap;
+
+vtkSimpleCriticalSection RegistryLock;
+bool UseOptimizedKernels = true;
+
+//----------------------------------------------------------------------------
+// Generic kernels
+
+//----------------------------------------------------------------------------
+template <class T>
+T ClampValue(double value)
+{
+  const T minimum = std::numeric_limits<T>::is_integer ?
+    std::numeric_limits<T>::min() : static_cast<T>(-std::numeric_limits<T>::max());
+  const T maximum = std::numeric_limits<T>::max();
+  if (value >= static_cast<double>(maximum))
+    {
+    return maximum;
+    }
+  if (value <= static_cast<double>(minimum))
+    {
+    return minimum;
+    }
+  if (std::numeric_limits<T>::is_integer && value != value)
+    {
+    return 0;
+    }
+  return static_cast<T>(value);
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void GenericScalarRange(const void* values, vtkIdType numberOfValues, double range[2])
+{
+  const T* ptr = static_cast<const T*>(values);
+  T minimum = std::numeric_limits<T>::has_infinity ?
+    std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+  T maximum = std::numeric_limits<T>::has_infinity ?
+    static_cast<T>(-std::numeric_limits<T>::infinity()) : std::numeric_limits<T>::min();
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+    {
+    // NaN comparisons are false
+    minimum = ptr[i] < minimum ? ptr[i] : minimum;
+    maximum = ptr[i] > maximum ? ptr[i] : maximum;
+    }
+  range[0] = static_cast<double>(minimum);
+  range[1] = static_cast<double>(maximum);
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void GenericThreshold(const void* input, vtkIdType numberOfValues,
+  double lower, double upper, double inValue, double outValue, void* output)
+{
+  const T* inPtr = static_cast<const T*>(input);
+  T* outPtr = static_cast<T*>(output);
+  const T in = ClampValue<T>(inValue);
+  const T out = ClampValue<T>(outValue);
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+    {
+    const double value = static_cast<double>(inPtr[i]);
+    outPtr[i] = (value >= lower && value <= upper) ? in : out;
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void GenericHistogram(const void* values, vtkIdType numberOfValues,
+  double minimum, double binWidth, int numberOfBins, vtkIdType* bins)
+{
+  const T* ptr = static_cast<const T*>(values);
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+    {
+    const double bin = floor((static_cast<double>(ptr[i]) - minimum) / binWidth);
+    if (bin >= 0. && bin < numberOfBins)
+      {
+      ++bins[static_cast<int>(bin)];
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void GenericMaskedCopy(const void* source, const unsigned char* mask,
+  vtkIdType numberOfVoxels, int numberOfComponents, void* target)
+{
+  const T* sourcePtr = static_cast<const T*>(source);
+  T* targetPtr = static_cast<T*>(target);
+  for (vtkIdType i = 0; i < numberOfVoxels; ++i)
+    {
+    if (mask[i])
+      {
+      for (int c = 0; c < numberOfComponents; ++c)
+        {
+        targetPtr[c] = sourcePtr[c];
+        }
+      }
+    sourcePtr += numberOfComponents;
+    targetPtr += numberOfComponents;
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void GenericRemapLabels(void* values, vtkIdType numberOfValues,
+  const double* fromLabels, const double* toLabels, int numberOfLabels)
+{
+  T* ptr = static_cast<T*>(values);
+  if (std::numeric_limits<T>::is_integer && sizeof(T) <= 2)
+    {
+    // Lookup table of all the values of the type
+    const double minimum = static_cast<double>(std::numeric_limits<T>::min());
+    std::vector<T> table(1 << (8 * sizeof(T)));
+    for (size_t i = 0; i < table.size(); ++i)
+      {
+      table[i] = static_cast<T>(minimum + i);
+      }
+    for (int i = 0; i < numberOfLabels; ++i)
+      {
+      const T fromLabel = ClampValue<T>(fromLabels[i]);
+      if (static_cast<double>(fromLabel) == fromLabels[i])
+        {
+        table[static_cast<size_t>(fromLabel - minimum)] = ClampValue<T>(toLabels[i]);
+        }
+      }
+    for (vtkIdType i = 0; i < numberOfValues; ++i)
+      {
+      ptr[i] = table[static_cast<size_t>(ptr[i] - minimum)];
+      }
+    return;
+    }
+
+  std::map<T, T> labels;
+  for (int i = 0; i < numberOfLabels; ++i)
+    {
+    const T fromLabel = ClampValue<T>(fromLabels[i]);
+    if (static_cast<double>(fromLabel) == fromLabels[i])
+      {
+      labels[fromLabel] = ClampValue<T>(toLabels[i]);
+      }
+    }
+  if (labels.empty())
+    {
+    return;
+    }
+  typename std::map<T, T>::const_iterator label;
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+    {
+    label = labels.find(ptr[i]);
+    if (label != labels.end())
+      {
+      ptr[i] = label->second;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void RegisterGenericKernels(KernelMap& kernels, int scalarType, T*)
+{
+  kernels[std::make_pair(std::string(vtkAddonImageKernels::ScalarRangeKernelName), scalarType)]
+    .Functions[vtkAddonImageKernels::Generic] =
+    reinterpret_cast<vtkAddonImageKernels::KernelFunction>(&GenericScalarRange<T>);
+  kernels[std::make_pair(std::string(vtkAddonImageKernels::ThresholdKernelName), scalarType)]
+    .Functions[vtkAddonImageKernels::Generic] =
+    reinterpret_cast<vtkAddonImageKernels::KernelFunction>(&GenericThreshold<T>);
+  kernels[std::make_pair(std::string(vtkAddonImageKernels::HistogramKernelName), scalarType)]
+    .Functions[vtkAddonImageKernels::Generic] =
+    reinterpret_cast<vtkAddonImageKernels::KernelFunction>(&GenericHistogram<T>);
+  kernels[std::make_pair(std::string(vtkAddonImageKernels::MaskedCopyKernelName), scalarType)]
+    .Functions[vtkAddonImageKernels::Generic] =
+    reinterpret_cast<vtkAddonImageKernels::KernelFunction>(&GenericMaskedCopy<T>);
+  kernels[std::make_pair(std::string(vtkAddonImageKernels::RemapLabelsKernelName), scalarType)]
+    .Functions[vtkAddonImageKernels::Generic] =
+    reinterpret_cast<vtkAddonImageKernels::KernelFunction>(&GenericRemapLabels<T>);
+}
+
+//----------------------------------------------------------------------------
+// Return the kernels, registering the built-in ones the first time.
+// RegistryLock must be locked.
+KernelMap& GetKernels()
+{
+  static KernelMap kernels;
+  static bool initialized = false;
+  if (initialized)
+    {
+    return kernels;
+    }
+  initialized = true;
+  for (int scalarType = VTK_CHAR; scalarType <= VTK_UNSIGNED___INT64; ++scalarType)
+    {
+    switch (scalarType)
+      {
+      vtkTemplateMacro(RegisterGenericKernels(kernels, scalarType, static_cast<VTK_TT*>(0)));
+      default:
+        break;
+      }
+    }
+#ifdef vtkAddon_HAS_AVX2_KERNELS
+  kernels[std::make_pair(std::string(vtkAddonImageKernels::ScalarRangeKernelName), VTK_FLOAT)]
+    .Functions[vtkAddonImageKernels::AVX2] =
+    reinterpret_cast<vtkAddonImageKernels::KernelFunction>(&vtkAddonImageKernelsAVX2ScalarRangeFloat);
+  kernels[std::make_pair(std::string(vtkAddonImageKernels::ScalarRangeKernelName), VTK_SHORT)]
+    .Functions[vtkAddonImageKernels::AVX2] =
+    reinterpret_cast<vtkAddonImageKernels::KernelFunction>(&vtkAddonImageKernelsAVX2ScalarRangeShort);
+  kernels[std::make_pair(std::string(vtkAddonImageKernels::ThresholdKernelName), VTK_FLOAT)]
+    .Functions[vtkAddonImageKernels::AVX2] =
+    reinterpret_cast<vtkAddonImageKernels::KernelFunction>(&vtkAddonImageKernelsAVX2ThresholdFloat);
+  kernels[std::make_pair(std::string(vtkAddonImageKernels::ThresholdKernelName), VTK_SHORT)]
+    .Functions[vtkAddonImageKernels::AVX2] =
+    reinterpret_cast<vtkAddonImageKernels::KernelFunction>(&vtkAddonImageKernelsAVX2ThresholdShort);
+#endif
+  return kernels;
+}
+
+//----------------------------------------------------------------------------
+// Scalars of the image and their number of values, NULL if there is none.
+vtkDataArray* GetScalars(vtkImageData* image, vtkIdType& numberOfValues)
+{
+  vtkDataArray* scalars = (image && image->GetPointData()) ? image->GetPointData()->GetScalars() : 0;
+  numberOfValues = scalars ? scalars->GetNumberOfTuples() * scalars->GetNumberOfComponents() : 0;
+  return scalars;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+vtkAddonImageKernels::vtkAddonImageKernels()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkAddonImageKernels::~vtkAddonImageKernels()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkAddonImageKernels::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "SupportedCPUFeatures:";
+  for (int feature = Generic; feature < CPUFeature_Last; ++feature)
+    {
+    if (vtkAddonImageKernels::IsCPUFeatureSupported(feature))
+      {
+      os << " " << vtkAddonImageKernels::GetCPUFeatureAsString(feature);
+      }
+    }
+  os << "\n";
+  os << indent << "UseOptimizedKernels: " << vtkAddonImageKernels::GetUseOptimizedKernels() << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkAddonImageKernels::IsCPUFeatureSupported(int feature)
+{
+  // Detection is cheap but not free, results are cached.
+  static int supported[CPUFeature_Last] = { -1, -1, -1, -1 };
+  if (feature < Generic || feature >= CPUFeature_Last)
+    {
+    return false;
+    }
+  if (supported[feature] < 0)
+    {
+    supported[feature] = DetectCPUFeature(feature) ? 1 : 0;
+    }
+  return supported[feature] == 1;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkAddonImageKernels::GetCPUFeatureAsString(int feature)
+{
+  switch (feature)
+    {
+    case Generic: return "Generic";
+    case NEON: return "NEON";
+    case AVX2: return "AVX2";
+    case AVX512: return "AVX512";
+    default:
+      return "";
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAddonImageKernels::SetUseOptimizedKernels(bool use)
+{
+  RegistryLock.Lock();
+  UseOptimizedKernels = use;
+  RegistryLock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+bool vtkAddonImageKernels::GetUseOptimizedKernels()
+{
+  RegistryLock.Lock();
+  const bool use = UseOptimizedKernels;
+  RegistryLock.Unlock();
+  return use;
+}
+
+//----------------------------------------------------------------------------
+void vtkAddonImageKernels::RegisterKernel(const char* name, int scalarType, int feature,
+                                          KernelFunction function)
+{
+  if (!name || feature < Generic || feature >= CPUFeature_Last)
+    {
+    vtkGenericWarningMacro("vtkAddonImageKernels::RegisterKernel failed: invalid kernel name or CPU feature");
+    return;
+    }
+  RegistryLock.Lock();
+  GetKernels()[std::make_pair(std::string(name), scalarType)].Functions[feature] = function;
+  RegistryLock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+vtkAddonImageKernels::KernelFunction vtkAddonImageKernels::GetKernel(
+  const char* name, int scalarType, int* selectedFeature/*=0*/)
+{
+  if (!name)
+    {
+    return 0;
+    }
+  KernelFunction function = 0;
+  int feature = Generic;
+  RegistryLock.Lock();
+  KernelMap& kernels = GetKernels();
+  KernelMap::const_iterator kernel = kernels.find(std::make_pair(std::string(name), scalarType));
+  if (kernel != kernels.end())
+    {
+    for (feature = UseOptimizedKernels ? CPUFeature_Last - 1 : Generic; feature >= Generic; --feature)
+      {
+      function = kernel->second.Functions[feature];
+      if (function && vtkAddonImageKernels::IsCPUFeatureSupported(feature))
+        {
+        break;
+        }
+      function = 0;
+      }
+    }
+  RegistryLock.Unlock();
+  if (selectedFeature)
+    {
+    *selectedFeature = function ? feature : -1;
+    }
+  return function;
+}
+
+//----------------------------------------------------------------------------
+bool vtkAddonImageKernels::GetScalarRange(vtkImageData* image, double range[2])
+{
+  vtkIdType numberOfValues = 0;
+  vtkDataArray* scalars = GetScalars(image, numberOfValues);
+  ScalarRangeKernel kernel = scalars ? reinterpret_cast<ScalarRangeKernel>(
+    vtkAddonImageKernels::GetKernel(ScalarRangeKernelName, scalars->GetDataType())) : 0;
+  if (!kernel)
+    {
+    return false;
+    }
+  (*kernel)(scalars->GetVoidPointer(0), numberOfValues, range);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkAddonImageKernels::Threshold(vtkImageData* input, double lower, double upper,
+                                     double inValue, double outValue, vtkImageData* output)
+{
+  vtkIdType numberOfValues = 0;
+  vtkDataArray* scalars = GetScalars(input, numberOfValues);
+  ThresholdKernel kernel = (scalars && output) ? reinterpret_cast<ThresholdKernel>(
+    vtkAddonImageKernels::GetKernel(ThresholdKernelName, scalars->GetDataType())) : 0;
+  if (!kernel)
+    {
+    return false;
+    }
+  if (output != input)
+    {
+    vtkIdType numberOfOutputValues = 0;
+    vtkDataArray* outputScalars = GetScalars(output, numberOfOutputValues);
+    output->CopyStructure(input);
+    if (!outputScalars || outputScalars->GetDataType() != scalars->GetDataType()
+      || outputScalars->GetNumberOfComponents() != scalars->GetNumberOfComponents()
+      || numberOfOutputValues != numberOfValues)
+      {
+      output->AllocateScalars(scalars->GetDataType(), scalars->GetNumberOfComponents());
+      }
+    }
+  (*kernel)(scalars->GetVoidPointer(0), numberOfValues, lower, upper, inValue, outValue,
+            output->GetPointData()->GetScalars()->GetVoidPointer(0));
+  output->GetPointData()->GetScalars()->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkAddonImageKernels::ComputeHistogram(vtkImageData* image, double minimum, double binWidth,
+                                            int numberOfBins, vtkIdTypeArray* bins)
+{
+  vtkIdType numberOfValues = 0;
+  vtkDataArray* scalars = GetScalars(image, numberOfValues);
+  if (!bins || numberOfBins < 0 || !(binWidth > 0.))
+    {
+    vtkGenericWarningMacro("vtkAddonImageKernels::ComputeHistogram failed: invalid bins");
+    return false;
+    }
+  HistogramKernel kernel = scalars ? reinterpret_cast<HistogramKernel>(
+    vtkAddonImageKernels::GetKernel(HistogramKernelName, scalars->GetDataType())) : 0;
+  if (!kernel)
+    {
+    return false;
+    }
+  bins->SetNumberOfComponents(1);
+  bins->SetNumberOfTuples(numberOfBins);
+  vtkIdType* binsPtr = bins->GetPointer(0);
+  for (int i = 0; i < numberOfBins; ++i)
+    {
+    binsPtr[i] = 0;
+    }
+  (*kernel)(scalars->GetVoidPointer(0), numberOfValues, minimum, binWidth, numberOfBins, binsPtr);
+  bins->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkAddonImageKernels::MaskedCopy(vtkImageData* source, vtkImageData* mask, vtkImageData* target)
+{
+  vtkIdType numberOfSourceValues = 0;
+  vtkIdType numberOfMaskValues = 0;
+  vtkIdType numberOfTargetValues = 0;
+  vtkDataArray* sourceScalars = GetScalars(source, numberOfSourceValues);
+  vtkDataArray* maskScalars = GetScalars(mask, numberOfMaskValues);
+  vtkDataArray* targetScalars = GetScalars(target, numberOfTargetValues);
+  if (!sourceScalars || !maskScalars || !targetScalars)
+    {
+    return false;
+    }
+  int sourceDimensions[3] = { 0, 0, 0 };
+  int maskDimensions[3] = { 0, 0, 0 };
+  int targetDimensions[3] = { 0, 0, 0 };
+  source->GetDimensions(sourceDimensions);
+  mask->GetDimensions(maskDimensions);
+  target->GetDimensions(targetDimensions);
+  for (int i = 0; i < 3; ++i)
+    {
+    if (sourceDimensions[i] != maskDimensions[i] || sourceDimensions[i] != targetDimensions[i])
+      {
+      vtkGenericWarningMacro("vtkAddonImageKernels::MaskedCopy failed: image dimensions do not match");
+      return false;
+      }
+    }
+  if (maskScalars->GetDataType() != VTK_UNSIGNED_CHAR || maskScalars->GetNumberOfComponents() != 1
+    || sourceScalars->GetDataType() != targetScalars->GetDataType()
+    || numberOfSourceValues != numberOfTargetValues)
+    {
+    vtkGenericWarningMacro("vtkAddonImageKernels::MaskedCopy failed: scalar types do not match");
+    return false;
+    }
+  MaskedCopyKernel kernel = reinterpret_cast<MaskedCopyKernel>(
+    vtkAddonImageKernels::GetKernel(MaskedCopyKernelName, sourceScalars->GetDataType()));
+  if (!kernel)
+    {
+    return false;
+    }
+  (*kernel)(sourceScalars->GetVoidPointer(0),
+            static_cast<unsigned char*>(maskScalars->GetVoidPointer(0)),
+            numberOfMaskValues, sourceScalars->GetNumberOfComponents(),
+            targetScalars->GetVoidPointer(0));
+  targetScalars->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkAddonImageKernels::RemapLabels(vtkImageData* image, vtkDoubleArray* fromLabels, vtkDoubleArray* toLabels)
+{
+  vtkIdType numberOfValues = 0;
+  vtkDataArray* scalars = GetScalars(image, numberOfValues);
+  if (!fromLabels || !toLabels
+    || fromLabels->GetNumberOfComponents() != 1 || toLabels->GetNumberOfComponents() != 1
+    || fromLabels->GetNumberOfTuples() != toLabels->GetNumberOfTuples())
+    {
+    vtkGenericWarningMacro("vtkAddonImageKernels::RemapLabels failed: invalid labels");
+    return false;
+    }
+  RemapLabelsKernel kernel = scalars ? reinterpret_cast<RemapLabelsKernel>(
+    vtkAddonImageKernels::GetKernel(RemapLabelsKernelName, scalars->GetDataType())) : 0;
+  if (!kernel)
+    {
+    return false;
+    }
+  if (fromLabels->GetNumberOfTuples() > 0)
+    {
+    (*kernel)(scalars->GetVoidPointer(0), numberOfValues,
+              fromLabels->GetPointer(0), toLabels->GetPointer(0),
+              static_cast<int>(fromLabels->GetNumberOfTuples()));
+    }
+  scalars->Modified();
+  return true;
+}
@@ -0,0 +1,142 @@
+/*=auto==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+===============================================================================auto=*/
+
+#ifndef __vtkAddonImageKernels_h
+#define __vtkAddonImageKernels_h
+
+#include <vtkAddon.h>
+#include <vtkObject.h>
+
+class vtkDoubleArray;
+class vtkIdTypeArray;
+class vtkImageData;
+
+/// \brief Registry of inner loops of common voxel operations.
+///
+/// Each kernel is identified by a name (see the *KernelName constants) and
+/// the VTK scalar type of the voxels it processes. Several implementations
+/// of the same kernel can be registered, each requiring a CPU feature: the
+/// one with the highest feature supported by the processor is selected at
+/// runtime. Generic implementations of all the kernels are registered for
+/// all the scalar types, AVX2 implementations of the scalar range and
+/// threshold kernels are registered for float and short when the library is
+/// built with an x86 compiler supporting them.
+///
+/// Extensions can register their own implementations with RegisterKernel(),
+/// they are used by all the callers of the image level functions below.
+/// The kernels operate on all the components of the scalars of an image and
+/// are not multi-threaded: threaded filters call GetKernel() once and run the
+/// kernel on the scalars of their output extent.
+class VTK_ADDON_EXPORT vtkAddonImageKernels : public vtkObject
+{
+public:
+  static vtkAddonImageKernels *New();
+  vtkTypeMacro(vtkAddonImageKernels,vtkObject);
+  virtual void PrintSelf(ostream& os, vtkIndent indent);
+
+  /// CPU features a kernel implementation can require, in order of
+  /// preference.
+  enum CPUFeature
+    {
+    Generic = 0,
+    NEON,
+    AVX2,
+    AVX512,
+    CPUFeature_Last
+    };
+
+  /// Return true if the processor (and the operating system) supports the
+  /// instructions of \a feature. Generic is always supported.
+  static bool IsCPUFeatureSupported(int feature);
+  static const char* GetCPUFeatureAsString(int feature);
+
+  /// If off, only the Generic implementations are selected. Used to compare
+  /// the results of the optimized implementations. On by default.
+  static void SetUseOptimizedKernels(bool use);
+  static bool GetUseOptimizedKernels();
+
+  /// Kernel names and signatures. \a numberOfValues is the number of voxels
+  /// times the number of components.
+  ///
+  /// Range of the values, NaNs are ignored. range[0] > range[1] if there is
+  /// no value.
+  static const char* ScalarRangeKernelName;
+  /// Write \a inValue where lower <= value <= upper, \a outValue elsewhere.
+  /// \a output has the scalar type of \a input, \a inValue and \a outValue
+  /// are clamped to the range of the type.
+  static const char* ThresholdKernelName;
+  /// Increment bins[floor((value - minimum) / binWidth)], values outside the
+  /// bins are ignored.
+  static const char* HistogramKernelName;
+  /// Copy the \a numberOfComponents values of the voxels of \a source into
+  /// \a target where \a mask (one value per voxel) is not 0.
+  static const char* MaskedCopyKernelName;
+  /// Replace in place the values found in \a fromLabels by the value of
+  /// \a toLabels at the same index.
+  static const char* RemapLabelsKernelName;
+
+  typedef void (*KernelFunction)();
+  typedef void (*ScalarRangeKernel)(const void* values, vtkIdType numberOfValues, double range[2]);
+  typedef void (*ThresholdKernel)(const void* input, vtkIdType numberOfValues,
+    double lower, double upper, double inValue, double outValue, void* output);
+  typedef void (*HistogramKernel)(const void* values, vtkIdType numberOfValues,
+    double minimum, double binWidth, int numberOfBins, vtkIdType* bins);
+  typedef void (*MaskedCopyKernel)(const void* source, const unsigned char* mask,
+    vtkIdType numberOfVoxels, int numberOfComponents, void* target);
+  typedef void (*RemapLabelsKernel)(void* values, vtkIdType numberOfValues,
+    const double* fromLabels, const double* toLabels, int numberOfLabels);
+
+  /// Register an implementation of kernel \a name for \a scalarType.
+  /// It replaces a previously registered implementation requiring
+  /// the same \a feature. Thread-safe.
+  static void RegisterKernel(const char* name, int scalarType, int feature,
+                             KernelFunction function);
+
+  /// Return the best registered implementation of kernel \a name for
+  /// \a scalarType supported by the processor, NULL if there is none.
+  /// \a selectedFeature, if not NULL, is set to the feature the implementation
+  /// requires. Thread-safe.
+  static KernelFunction GetKernel(const char* name, int scalarType, int* selectedFeature = 0);
+
+  /// Image level interface. All the functions return false (and process
+  /// nothing) if an image has no scalars or the images don't match.
+  ///
+  /// Range of all the components of the scalars of \a image.
+  static bool GetScalarRange(vtkImageData* image, double range[2]);
+  /// Threshold into \a output, that is allocated with the geometry and the
+  /// scalar type of \a input if needed. \a output can be \a input.
+  static bool Threshold(vtkImageData* input, double lower, double upper,
+                        double inValue, double outValue, vtkImageData* output);
+  /// Histogram of the scalars of \a image, \a bins is resized to
+  /// \a numberOfBins.
+  static bool ComputeHistogram(vtkImageData* image, double minimum, double binWidth,
+                               int numberOfBins, vtkIdTypeArray* bins);
+  /// Copy the scalars of \a source into \a target where the unsigned char
+  /// single component \a mask is not 0. The images must have the same
+  /// dimensions, scalar type and number of components.
+  static bool MaskedCopy(vtkImageData* source, vtkImageData* mask, vtkImageData* target);
+  /// Remap in place the scalars of \a image.
+  static bool RemapLabels(vtkImageData* image, vtkDoubleArray* fromLabels, vtkDoubleArray* toLabels);
+
+protected:
+  vtkAddonImageKernels();
+  ~vtkAddonImageKernels();
+
+private:
+  vtkAddonImageKernels(const vtkAddonImageKernels&);  // Not implemented.
+  void operator=(const vtkAddonImageKernels&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,263 @@
+/*=auto==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+===============================================================================auto=*/
+
+// This file is compiled with AVX2 enabled, see vtkAddonImageKernelsAVX2.h
+// before including any other header.
+#include "vtkAddonImageKernelsAVX2.h"
+
+#include <float.h>
+#include <immintrin.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+union FloatBits
+{
+  float Value;
+  int Bits;
+};
+
+//----------------------------------------------------------------------------
+float FloatInfinity(bool positive)
+{
+  FloatBits infinity;
+  infinity.Bits = positive ? 0x7f800000 : static_cast<int>(0xff800000);
+  return infinity.Value;
+}
+
+//----------------------------------------------------------------------------
+// Smallest float >= value (value is not NaN).
+float FloatNotLessThan(double value)
+{
+  if (value > FLT_MAX)
+    {
+    return FloatInfinity(true);
+    }
+  if (value < -FLT_MAX)
+    {
+    return value < -VTK_DOUBLE_MAX ? FloatInfinity(false) : -FLT_MAX;
+    }
+  FloatBits result;
+  result.Value = static_cast<float>(value);
+  if (static_cast<double>(result.Value) < value)
+    {
+    if (result.Value == 0.f)
+      {
+      result.Bits = 1;
+      }
+    else
+      {
+      result.Bits += result.Value > 0.f ? 1 : -1;
+      }
+    }
+  return result.Value;
+}
+
+//----------------------------------------------------------------------------
+// Largest float <= value (value is not NaN).
+float FloatNotGreaterThan(double value)
+{
+  return -FloatNotLessThan(-value);
+}
+
+//----------------------------------------------------------------------------
+float ClampToFloat(double value)
+{
+  return static_cast<float>(value < -FLT_MAX ? -FLT_MAX :
+    (value > FLT_MAX ? FLT_MAX : value));
+}
+
+//----------------------------------------------------------------------------
+short ClampToShort(double value)
+{
+  if (value != value)
+    {
+    return 0;
+    }
+  return static_cast<short>(value < VTK_SHORT_MIN ? VTK_SHORT_MIN :
+    (value > VTK_SHORT_MAX ? VTK_SHORT_MAX : value));
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+void vtkAddonImageKernelsAVX2ScalarRangeFloat(const void* values,
+  vtkIdType numberOfValues, double range[2])
+{
+  const float* ptr = static_cast<const float*>(values);
+  float minimum = FloatInfinity(true);
+  float maximum = FloatInfinity(false);
+  vtkIdType i = 0;
+  if (numberOfValues >= 8)
+    {
+    // min/max return their second operand if one of them is NaN
+    __m256 minimums = _mm256_set1_ps(minimum);
+    __m256 maximums = _mm256_set1_ps(maximum);
+    for (; i + 8 <= numberOfValues; i += 8)
+      {
+      const __m256 v = _mm256_loadu_ps(ptr + i);
+      minimums = _mm256_min_ps(v, minimums);
+      maximums = _mm256_max_ps(v, maximums);
+      }
+    float minimumLanes[8];
+    float maximumLanes[8];
+    _mm256_storeu_ps(minimumLanes, minimums);
+    _mm256_storeu_ps(maximumLanes, maximums);
+    for (int lane = 0; lane < 8; ++lane)
+      {
+      minimum = minimumLanes[lane] < minimum ? minimumLanes[lane] : minimum;
+      maximum = maximumLanes[lane] > maximum ? maximumLanes[lane] : maximum;
+      }
+    }
+  for (; i < numberOfValues; ++i)
+    {
+    minimum = ptr[i] < minimum ? ptr[i] : minimum;
+    maximum = ptr[i] > maximum ? ptr[i] : maximum;
+    }
+  range[0] = minimum;
+  range[1] = maximum;
+}
+
+//----------------------------------------------------------------------------
+void vtkAddonImageKernelsAVX2ScalarRangeShort(const void* values,
+  vtkIdType numberOfValues, double range[2])
+{
+  const short* ptr = static_cast<const short*>(values);
+  short minimum = VTK_SHORT_MAX;
+  short maximum = VTK_SHORT_MIN;
+  vtkIdType i = 0;
+  if (numberOfValues >= 16)
+    {
+    __m256i minimums = _mm256_set1_epi16(minimum);
+    __m256i maximums = _mm256_set1_epi16(maximum);
+    for (; i + 16 <= numberOfValues; i += 16)
+      {
+      const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + i));
+      minimums = _mm256_min_epi16(v, minimums);
+      maximums = _mm256_max_epi16(v, maximums);
+      }
+    short minimumLanes[16];
+    short maximumLanes[16];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(minimumLanes), minimums);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(maximumLanes), maximums);
+    for (int lane = 0; lane < 16; ++lane)
+      {
+      minimum = minimumLanes[lane] < minimum ? minimumLanes[lane] : minimum;
+      maximum = maximumLanes[lane] > maximum ? maximumLanes[lane] : maximum;
+      }
+    }
+  for (; i < numberOfValues; ++i)
+    {
+    minimum = ptr[i] < minimum ? ptr[i] : minimum;
+    maximum = ptr[i] > maximum ? ptr[i] : maximum;
+    }
+  range[0] = minimum;
+  range[1] = maximum;
+}
+
+//----------------------------------------------------------------------------
+void vtkAddonImageKernelsAVX2ThresholdFloat(const void* input, vtkIdType numberOfValues,
+  double lower, double upper, double inValue, double outValue, void* output)
+{
+  const float* inPtr = static_cast<const float*>(input);
+  float* outPtr = static_cast<float*>(output);
+  const float outFloat = ClampToFloat(outValue);
+  const float inFloat = ClampToFloat(inValue);
+  // Comparing the floats to these bounds is the same as comparing their
+  // double values to lower and upper.
+  const bool empty = lower != lower || upper != upper;
+  const float lowerFloat = empty ? 0.f : FloatNotLessThan(lower);
+  const float upperFloat = empty ? 0.f : FloatNotGreaterThan(upper);
+
+  vtkIdType i = 0;
+  if (empty)
+    {
+    for (; i < numberOfValues; ++i)
+      {
+      outPtr[i] = outFloat;
+      }
+    return;
+    }
+  const __m256 lowers = _mm256_set1_ps(lowerFloat);
+  const __m256 uppers = _mm256_set1_ps(upperFloat);
+  const __m256 ins = _mm256_set1_ps(inFloat);
+  const __m256 outs = _mm256_set1_ps(outFloat);
+  for (; i + 8 <= numberOfValues; i += 8)
+    {
+    const __m256 v = _mm256_loadu_ps(inPtr + i);
+    // ordered comparisons are false for NaN
+    const __m256 inside = _mm256_and_ps(
+      _mm256_cmp_ps(v, lowers, _CMP_GE_OQ), _mm256_cmp_ps(v, uppers, _CMP_LE_OQ));
+    _mm256_storeu_ps(outPtr + i, _mm256_blendv_ps(outs, ins, inside));
+    }
+  for (; i < numberOfValues; ++i)
+    {
+    outPtr[i] = (inPtr[i] >= lowerFloat && inPtr[i] <= upperFloat) ? inFloat : outFloat;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAddonImageKernelsAVX2ThresholdShort(const void* input, vtkIdType numberOfValues,
+  double lower, double upper, double inValue, double outValue, void* output)
+{
+  const short* inPtr = static_cast<const short*>(input);
+  short* outPtr = static_cast<short*>(output);
+  const short outShort = ClampToShort(outValue);
+  const short inShort = ClampToShort(inValue);
+
+  // Integer bounds of the values between lower and upper
+  bool empty = lower != lower || upper != upper
+    || lower > VTK_SHORT_MAX || upper < VTK_SHORT_MIN;
+  int lowerInt = VTK_SHORT_MIN;
+  int upperInt = VTK_SHORT_MAX;
+  if (!empty && lower > VTK_SHORT_MIN)
+    {
+    lowerInt = static_cast<int>(lower);
+    lowerInt += lowerInt < lower ? 1 : 0;
+    }
+  if (!empty && upper < VTK_SHORT_MAX)
+    {
+    upperInt = static_cast<int>(upper);
+    upperInt -= upperInt > upper ? 1 : 0;
+    }
+  empty = empty || lowerInt > upperInt;
+
+  vtkIdType i = 0;
+  if (empty)
+    {
+    for (; i < numberOfValues; ++i)
+      {
+      outPtr[i] = outShort;
+      }
+    return;
+    }
+  const __m256i lowers = _mm256_set1_epi16(static_cast<short>(lowerInt));
+  const __m256i uppers = _mm256_set1_epi16(static_cast<short>(upperInt));
+  const __m256i ins = _mm256_set1_epi16(inShort);
+  const __m256i outs = _mm256_set1_epi16(outShort);
+  for (; i + 16 <= numberOfValues; i += 16)
+    {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inPtr + i));
+    const __m256i outside = _mm256_or_si256(
+      _mm256_cmpgt_epi16(lowers, v), _mm256_cmpgt_epi16(v, uppers));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(outPtr + i),
+      _mm256_blendv_epi8(ins, outs, outside));
+    }
+  for (; i < numberOfValues; ++i)
+    {
+    outPtr[i] = (inPtr[i] >= lowerInt && inPtr[i] <= upperInt) ? inShort : outShort;
+    }
+}
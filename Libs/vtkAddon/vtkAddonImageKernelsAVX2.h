@@ -0,0 +1,38 @@
+/*=auto==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+===============================================================================auto=*/
+
+/// AVX2 implementations of vtkAddonImageKernels kernels, registered by
+/// vtkAddonImageKernels when the processor supports AVX2.
+///
+/// vtkAddonImageKernelsAVX2.cxx is the only file compiled with AVX2
+/// enabled. It must only include headers that define no inline function
+/// (such as vtkType.h): an inline function compiled with AVX2 could be the
+/// one kept by the linker and be called on any processor.
+
+#ifndef __vtkAddonImageKernelsAVX2_h
+#define __vtkAddonImageKernelsAVX2_h
+
+#include <vtkType.h>
+
+void vtkAddonImageKernelsAVX2ScalarRangeFloat(const void* values,
+  vtkIdType numberOfValues, double range[2]);
+void vtkAddonImageKernelsAVX2ScalarRangeShort(const void* values,
+  vtkIdType numberOfValues, double range[2]);
+void vtkAddonImageKernelsAVX2ThresholdFloat(const void* input, vtkIdType numberOfValues,
+  double lower, double upper, double inValue, double outValue, void* output);
+void vtkAddonImageKernelsAVX2ThresholdShort(const void* input, vtkIdType numberOfValues,
+  double lower, double upper, double inValue, double outValue, void* output);
+
+#endif
@@ -0,0 +1,597 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#include "vtkSurfaceProcessingFilter.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCleanPolyData.h>
+#include <vtkDecimatePro.h>
+#include <vtkFloatArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkMultiThreader.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataConnectivityFilter.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkQuadricDecimation.h>
+#include <vtkReverseSense.h>
+#include <vtkSmartPointer.h>
+#include <vtkSmoothPolyDataFilter.h>
+#include <vtkTransform.h>
+#include <vtkTransformPolyDataFilter.h>
+#include <vtkTriangleFilter.h>
+#include <vtkWindowedSincPolyDataFilter.h>
+
+// STD includes
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+vtkStandardNewMacro(vtkSurfaceProcessingFilter);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+typedef std::pair<vtkIdType, vtkIdType> EdgeType;
+
+//----------------------------------------------------------------------------
+// Sorted edges of all the polygons, each edge is listed once per polygon
+// using it.
+void GetPolygonEdges(vtkCellArray* polys, std::vector<EdgeType>& edges)
+{
+  edges.clear();
+  edges.reserve(polys->GetNumberOfConnectivityEntries());
+  vtkIdType npts = 0;
+  vtkIdType* pts = 0;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+    {
+    for (vtkIdType i = 0; i < npts; ++i)
+      {
+      const vtkIdType a = pts[i];
+      const vtkIdType b = pts[(i + 1) % npts];
+      if (a != b)
+        {
+        edges.push_back(EdgeType(std::min(a, b), std::max(a, b)));
+        }
+      }
+    }
+  std::sort(edges.begin(), edges.end());
+}
+
+//----------------------------------------------------------------------------
+// Compressed lists of the points each point is averaged with.
+// Points only used by interior edges (shared by 2 polygons) are averaged with
+// all their neighbors. Points on boundary or non-manifold edges are averaged
+// with the 2 neighbors along these edges if boundarySmoothing is true and
+// they have exactly 2 such edges, they are fixed otherwise.
+void BuildLaplaceNeighbors(vtkPolyData* surface, bool boundarySmoothing,
+                           std::vector<vtkIdType>& offsets,
+                           std::vector<vtkIdType>& neighbors)
+{
+  const vtkIdType numberOfPoints = surface->GetNumberOfPoints();
+  std::vector<EdgeType> edges;
+  GetPolygonEdges(surface->GetPolys(), edges);
+
+  std::vector<vtkIdType> interiorEdgeCount(numberOfPoints, 0);
+  std::vector<vtkIdType> boundaryEdgeCount(numberOfPoints, 0);
+  for (size_t first = 0, last = 0; first < edges.size(); first = last)
+    {
+    for (last = first + 1; last < edges.size() && edges[last] == edges[first]; ++last)
+      {
+      }
+    std::vector<vtkIdType>& count = (last - first == 2) ? interiorEdgeCount : boundaryEdgeCount;
+    ++count[edges[first].first];
+    ++count[edges[first].second];
+    }
+
+  offsets.assign(numberOfPoints + 1, 0);
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+    vtkIdType numberOfNeighbors = 0;
+    if (boundaryEdgeCount[i] == 0)
+      {
+      numberOfNeighbors = interiorEdgeCount[i];
+      }
+    else if (boundarySmoothing && boundaryEdgeCount[i] == 2)
+      {
+      numberOfNeighbors = 2;
+      }
+    offsets[i + 1] = offsets[i] + numberOfNeighbors;
+    }
+
+  neighbors.resize(offsets[numberOfPoints]);
+  std::vector<vtkIdType> cursors(offsets.begin(), offsets.end() - 1);
+  for (size_t first = 0, last = 0; first < edges.size(); first = last)
+    {
+    for (last = first + 1; last < edges.size() && edges[last] == edges[first]; ++last)
+      {
+      }
+    const bool interior = (last - first == 2);
+    const vtkIdType ends[2] = { edges[first].first, edges[first].second };
+    for (int e = 0; e < 2; ++e)
+      {
+      const vtkIdType p = ends[e];
+      if (cursors[p] < offsets[p + 1] && interior == (boundaryEdgeCount[p] == 0))
+        {
+        neighbors[cursors[p]++] = ends[1 - e];
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+struct LaplaceData
+{
+  const vtkIdType* Offsets;
+  const vtkIdType* Neighbors;
+  const double* Source;
+  double* Target;
+  vtkIdType NumberOfPoints;
+  double RelaxationFactor;
+};
+
+//----------------------------------------------------------------------------
+// One Laplace iteration on a range of points, from Source to Target.
+VTK_THREAD_RETURN_TYPE LaplaceThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  const LaplaceData* data = static_cast<LaplaceData*>(info->UserData);
+  const vtkIdType begin = data->NumberOfPoints * info->ThreadID / info->NumberOfThreads;
+  const vtkIdType end = data->NumberOfPoints * (info->ThreadID + 1) / info->NumberOfThreads;
+  const double relaxation = data->RelaxationFactor;
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    const double* x = data->Source + 3 * i;
+    double* y = data->Target + 3 * i;
+    const vtkIdType first = data->Offsets[i];
+    const vtkIdType last = data->Offsets[i + 1];
+    if (first == last)
+      {
+      y[0] = x[0];
+      y[1] = x[1];
+      y[2] = x[2];
+      continue;
+      }
+    double mean[3] = { 0., 0., 0. };
+    for (vtkIdType j = first; j < last; ++j)
+      {
+      const double* neighbor = data->Source + 3 * data->Neighbors[j];
+      mean[0] += neighbor[0];
+      mean[1] += neighbor[1];
+      mean[2] += neighbor[2];
+      }
+    const double scale = 1. / static_cast<double>(last - first);
+    for (int k = 0; k < 3; ++k)
+      {
+      y[k] = x[k] + relaxation * (mean[k] * scale - x[k]);
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+struct PointNormalsData
+{
+  const vtkIdType* Offsets;
+  const vtkIdType* Cells;
+  vtkDataArray* CellNormals;
+  float* PointNormals;
+  vtkIdType NumberOfPoints;
+};
+
+//----------------------------------------------------------------------------
+// Point normals of a range of points: normalized sum of the normals of the
+// polygons using the point, as in vtkPolyDataNormals.
+VTK_THREAD_RETURN_TYPE PointNormalsThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  const PointNormalsData* data = static_cast<PointNormalsData*>(info->UserData);
+  const vtkIdType begin = data->NumberOfPoints * info->ThreadID / info->NumberOfThreads;
+  const vtkIdType end = data->NumberOfPoints * (info->ThreadID + 1) / info->NumberOfThreads;
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    double normal[3] = { 0., 0., 0. };
+    for (vtkIdType j = data->Offsets[i]; j < data->Offsets[i + 1]; ++j)
+      {
+      double cellNormal[3];
+      data->CellNormals->GetTuple(data->Cells[j], cellNormal);
+      normal[0] += cellNormal[0];
+      normal[1] += cellNormal[1];
+      normal[2] += cellNormal[2];
+      }
+    vtkMath::Normalize(normal);
+    float* pointNormal = data->PointNormals + 3 * i;
+    pointNormal[0] = static_cast<float>(normal[0]);
+    pointNormal[1] = static_cast<float>(normal[1]);
+    pointNormal[2] = static_cast<float>(normal[2]);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+bool IsTriangleMesh(vtkPolyData* surface)
+{
+  return surface->GetNumberOfVerts() == 0 &&
+         surface->GetNumberOfLines() == 0 &&
+         surface->GetNumberOfStrips() == 0 &&
+         surface->GetNumberOfPolys() > 0 &&
+         surface->GetPolys()->GetMaxCellSize() == 3;
+}
+
+//----------------------------------------------------------------------------
+void RunFilter(vtkPolyDataAlgorithm* filter, vtkSmartPointer<vtkPolyData>& surface)
+{
+  filter->SetInputData(surface);
+  filter->Update();
+  surface = filter->GetOutput();
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+vtkSurfaceProcessingFilter::vtkSurfaceProcessingFilter()
+{
+  this->Decimation = 0;
+  this->DecimationMethod = DecimatePro;
+  this->TargetReduction = 0.8;
+  this->TargetNumberOfTriangles = 0;
+  this->BoundaryVertexDeletion = 1;
+
+  this->Smoothing = 0;
+  this->SmoothingMethod = LaplaceSmoothing;
+  this->LaplaceNumberOfIterations = 100;
+  this->LaplaceRelaxationFactor = 0.5;
+  this->TaubinNumberOfIterations = 30;
+  this->TaubinPassBand = 0.1;
+  this->BoundarySmoothing = 1;
+
+  this->Normals = 0;
+  this->AutoOrientNormals = 0;
+  this->FlipNormals = 0;
+  this->Splitting = 0;
+  this->FeatureAngle = 30.0;
+
+  this->Mirror = 0;
+  this->MirrorX = 0;
+  this->MirrorY = 0;
+  this->MirrorZ = 0;
+
+  this->Clean = 0;
+  this->Connectivity = 0;
+
+  this->NumberOfThreads = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkSurfaceProcessingFilter::~vtkSurfaceProcessingFilter()
+{
+}
+
+//----------------------------------------------------------------------------
+int vtkSurfaceProcessingFilter::GetNumberOfThreadsToUse()
+{
+  int numberOfThreads = this->NumberOfThreads;
+  if (numberOfThreads <= 0)
+    {
+    numberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    }
+  return std::min(numberOfThreads, VTK_MAX_THREADS);
+}
+
+//----------------------------------------------------------------------------
+int vtkSurfaceProcessingFilter::RequestData(
+  vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  vtkPolyData* input = vtkPolyData::GetData(inputVector[0]);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector);
+
+  // Each step replaces the surface, the previous one is released as soon as
+  // it is not referenced by the step anymore.
+  vtkSmartPointer<vtkPolyData> surface = vtkSmartPointer<vtkPolyData>::New();
+  surface->ShallowCopy(input);
+
+  const int numberOfSteps = this->Decimation + this->Smoothing + this->Normals +
+    this->Mirror + this->Clean + this->Connectivity;
+  int step = 0;
+
+  if (this->Decimation && !this->GetAbortExecute())
+    {
+    vtkSmartPointer<vtkPolyData> decimated = vtkSmartPointer<vtkPolyData>::New();
+    this->ApplyDecimation(surface, decimated);
+    surface = decimated;
+    this->UpdateProgress(static_cast<double>(++step) / numberOfSteps);
+    }
+
+  if (this->Smoothing && !this->GetAbortExecute())
+    {
+    if (this->SmoothingMethod == LaplaceSmoothing)
+      {
+      vtkSmartPointer<vtkPolyData> smoothed = vtkSmartPointer<vtkPolyData>::New();
+      this->ApplyLaplaceSmoothing(surface, smoothed);
+      surface = smoothed;
+      }
+    else
+      {
+      vtkNew<vtkWindowedSincPolyDataFilter> smoothing;
+      smoothing->SetBoundarySmoothing(this->BoundarySmoothing);
+      smoothing->SetNumberOfIterations(this->TaubinNumberOfIterations);
+      smoothing->SetPassBand(this->TaubinPassBand);
+      RunFilter(smoothing.GetPointer(), surface);
+      }
+    this->UpdateProgress(static_cast<double>(++step) / numberOfSteps);
+    }
+
+  if (this->Normals && !this->GetAbortExecute())
+    {
+    vtkSmartPointer<vtkPolyData> withNormals = vtkSmartPointer<vtkPolyData>::New();
+    this->ApplyNormals(surface, withNormals);
+    surface = withNormals;
+    this->UpdateProgress(static_cast<double>(++step) / numberOfSteps);
+    }
+
+  if (this->Mirror && !this->GetAbortExecute())
+    {
+    vtkNew<vtkTransform> mirrorTransform;
+    mirrorTransform->Scale(this->MirrorX ? -1. : 1.,
+                           this->MirrorY ? -1. : 1.,
+                           this->MirrorZ ? -1. : 1.);
+    vtkNew<vtkTransformPolyDataFilter> transformFilter;
+    transformFilter->SetTransform(mirrorTransform.GetPointer());
+    RunFilter(transformFilter.GetPointer(), surface);
+    if ((this->MirrorX + this->MirrorY + this->MirrorZ) % 2)
+      {
+      vtkNew<vtkReverseSense> reverse;
+      RunFilter(reverse.GetPointer(), surface);
+      }
+    this->UpdateProgress(static_cast<double>(++step) / numberOfSteps);
+    }
+
+  if (this->Clean && !this->GetAbortExecute())
+    {
+    vtkNew<vtkCleanPolyData> cleaner;
+    RunFilter(cleaner.GetPointer(), surface);
+    this->UpdateProgress(static_cast<double>(++step) / numberOfSteps);
+    }
+
+  if (this->Connectivity && !this->GetAbortExecute())
+    {
+    vtkNew<vtkPolyDataConnectivityFilter> connectivity;
+    connectivity->SetExtractionModeToLargestRegion();
+    RunFilter(connectivity.GetPointer(), surface);
+    this->UpdateProgress(static_cast<double>(++step) / numberOfSteps);
+    }
+
+  output->ShallowCopy(surface);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkSurfaceProcessingFilter::ApplyDecimation(vtkPolyData* input, vtkPolyData* output)
+{
+  // The decimation filters only process triangles, the triangulation is
+  // skipped when the surface is already made of triangles only.
+  vtkSmartPointer<vtkPolyData> surface = input;
+  if (!IsTriangleMesh(input))
+    {
+    vtkNew<vtkTriangleFilter> triangle;
+    RunFilter(triangle.GetPointer(), surface);
+    }
+
+  double reduction = this->TargetReduction;
+  if (this->TargetNumberOfTriangles > 0)
+    {
+    const vtkIdType numberOfTriangles = surface->GetNumberOfPolys();
+    reduction = numberOfTriangles > this->TargetNumberOfTriangles ?
+      1. - static_cast<double>(this->TargetNumberOfTriangles) / numberOfTriangles : 0.;
+    }
+
+  if (this->DecimationMethod == QuadricDecimation)
+    {
+    vtkNew<vtkQuadricDecimation> decimation;
+    decimation->SetTargetReduction(reduction);
+    RunFilter(decimation.GetPointer(), surface);
+    }
+  else
+    {
+    vtkNew<vtkDecimatePro> decimation;
+    decimation->SetTargetReduction(reduction);
+    decimation->SetBoundaryVertexDeletion(this->BoundaryVertexDeletion);
+    decimation->PreserveTopologyOn();
+    RunFilter(decimation.GetPointer(), surface);
+    }
+  output->ShallowCopy(surface);
+}
+
+//----------------------------------------------------------------------------
+void vtkSurfaceProcessingFilter::ApplyLaplaceSmoothing(vtkPolyData* input, vtkPolyData* output)
+{
+  vtkPoints* inputPoints = input->GetPoints();
+  if (!inputPoints || input->GetNumberOfPolys() == 0 ||
+      input->GetNumberOfVerts() > 0 ||
+      input->GetNumberOfLines() > 0 ||
+      input->GetNumberOfStrips() > 0)
+    {
+    // Vertices, lines and strips constrain the smoothing in ways only
+    // implemented by vtkSmoothPolyDataFilter.
+    vtkSmartPointer<vtkPolyData> surface = input;
+    vtkNew<vtkSmoothPolyDataFilter> smoothing;
+    smoothing->SetBoundarySmoothing(this->BoundarySmoothing);
+    smoothing->SetNumberOfIterations(this->LaplaceNumberOfIterations);
+    smoothing->SetRelaxationFactor(this->LaplaceRelaxationFactor);
+    RunFilter(smoothing.GetPointer(), surface);
+    output->ShallowCopy(surface);
+    return;
+    }
+
+  std::vector<vtkIdType> offsets;
+  std::vector<vtkIdType> neighbors;
+  BuildLaplaceNeighbors(input, this->BoundarySmoothing != 0, offsets, neighbors);
+
+  const vtkIdType numberOfPoints = inputPoints->GetNumberOfPoints();
+  std::vector<double> source(3 * numberOfPoints);
+  std::vector<double> target(3 * numberOfPoints);
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+    inputPoints->GetPoint(i, &source[3 * i]);
+    }
+
+  LaplaceData data;
+  data.Offsets = &offsets[0];
+  data.Neighbors = neighbors.empty() ? 0 : &neighbors[0];
+  data.NumberOfPoints = numberOfPoints;
+  data.RelaxationFactor = this->LaplaceRelaxationFactor;
+
+  vtkNew<vtkMultiThreader> threader;
+  threader->SetNumberOfThreads(static_cast<int>(
+    std::min<vtkIdType>(this->GetNumberOfThreadsToUse(), std::max<vtkIdType>(numberOfPoints, 1))));
+  threader->SetSingleMethod(LaplaceThreadFunction, &data);
+  for (int iteration = 0; iteration < this->LaplaceNumberOfIterations; ++iteration)
+    {
+    if (this->GetAbortExecute())
+      {
+      break;
+      }
+    data.Source = &source[0];
+    data.Target = &target[0];
+    threader->SingleMethodExecute();
+    source.swap(target);
+    }
+
+  vtkNew<vtkPoints> points;
+  points->SetDataType(inputPoints->GetDataType());
+  points->SetNumberOfPoints(numberOfPoints);
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+    points->SetPoint(i, &source[3 * i]);
+    }
+  output->ShallowCopy(input);
+  output->SetPoints(points.GetPointer());
+}
+
+//----------------------------------------------------------------------------
+void vtkSurfaceProcessingFilter::ApplyNormals(vtkPolyData* input, vtkPolyData* output)
+{
+  vtkSmartPointer<vtkPolyData> surface = input;
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetAutoOrientNormals(this->AutoOrientNormals);
+  normals->SetFlipNormals(this->FlipNormals);
+  normals->SetSplitting(this->Splitting);
+  normals->SetFeatureAngle(this->FeatureAngle);
+  normals->ConsistencyOn();
+
+  // Splitting duplicates points along the feature edges, it is left to
+  // vtkPolyDataNormals. Otherwise only the polygon orientation and normals
+  // are computed by vtkPolyDataNormals, the point normals are averaged here
+  // in parallel.
+  const bool threadedPointNormals = !this->Splitting && input->GetNumberOfStrips() == 0;
+  normals->SetComputePointNormals(!threadedPointNormals);
+  normals->SetComputeCellNormals(threadedPointNormals);
+  RunFilter(normals.GetPointer(), surface);
+
+  vtkDataArray* cellNormals = surface->GetCellData()->GetNormals();
+  if (!threadedPointNormals || !cellNormals ||
+      cellNormals->GetNumberOfTuples() != surface->GetNumberOfCells())
+    {
+    output->ShallowCopy(surface);
+    return;
+    }
+
+  // Cells of each point, the polygons are after the vertices and lines in
+  // the cell ids.
+  const vtkIdType numberOfPoints = surface->GetNumberOfPoints();
+  const vtkIdType firstPolyId = surface->GetNumberOfVerts() + surface->GetNumberOfLines();
+  vtkCellArray* polys = surface->GetPolys();
+  std::vector<vtkIdType> offsets(numberOfPoints + 1, 0);
+  vtkIdType npts = 0;
+  vtkIdType* pts = 0;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+    {
+    for (vtkIdType i = 0; i < npts; ++i)
+      {
+      ++offsets[pts[i] + 1];
+      }
+    }
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+    offsets[i + 1] += offsets[i];
+    }
+  std::vector<vtkIdType> cells(offsets[numberOfPoints]);
+  std::vector<vtkIdType> cursors(offsets.begin(), offsets.end() - 1);
+  vtkIdType cellId = firstPolyId;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); ++cellId)
+    {
+    for (vtkIdType i = 0; i < npts; ++i)
+      {
+      cells[cursors[pts[i]]++] = cellId;
+      }
+    }
+
+  vtkNew<vtkFloatArray> pointNormals;
+  pointNormals->SetName("Normals");
+  pointNormals->SetNumberOfComponents(3);
+  pointNormals->SetNumberOfTuples(numberOfPoints);
+
+  PointNormalsData data;
+  data.Offsets = &offsets[0];
+  data.Cells = cells.empty() ? 0 : &cells[0];
+  data.CellNormals = cellNormals;
+  data.PointNormals = pointNormals->GetPointer(0);
+  data.NumberOfPoints = numberOfPoints;
+
+  vtkNew<vtkMultiThreader> threader;
+  threader->SetNumberOfThreads(static_cast<int>(
+    std::min<vtkIdType>(this->GetNumberOfThreadsToUse(), std::max<vtkIdType>(numberOfPoints, 1))));
+  threader->SetSingleMethod(PointNormalsThreadFunction, &data);
+  threader->SingleMethodExecute();
+
+  // Same arrays as vtkPolyDataNormals computing point normals only.
+  output->ShallowCopy(surface);
+  output->GetPointData()->SetNormals(pointNormals.GetPointer());
+  output->GetCellData()->RemoveArray(cellNormals->GetName());
+}
+
+//----------------------------------------------------------------------------
+void vtkSurfaceProcessingFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Decimation: " << this->Decimation << "\n";
+  os << indent << "DecimationMethod: " << this->DecimationMethod << "\n";
+  os << indent << "TargetReduction: " << this->TargetReduction << "\n";
+  os << indent << "TargetNumberOfTriangles: " << this->TargetNumberOfTriangles << "\n";
+  os << indent << "BoundaryVertexDeletion: " << this->BoundaryVertexDeletion << "\n";
+  os << indent << "Smoothing: " << this->Smoothing << "\n";
+  os << indent << "SmoothingMethod: " << this->SmoothingMethod << "\n";
+  os << indent << "LaplaceNumberOfIterations: " << this->LaplaceNumberOfIterations << "\n";
+  os << indent << "LaplaceRelaxationFactor: " << this->LaplaceRelaxationFactor << "\n";
+  os << indent << "TaubinNumberOfIterations: " << this->TaubinNumberOfIterations << "\n";
+  os << indent << "TaubinPassBand: " << this->TaubinPassBand << "\n";
+  os << indent << "BoundarySmoothing: " << this->BoundarySmoothing << "\n";
+  os << indent << "Normals: " << this->Normals << "\n";
+  os << indent << "AutoOrientNormals: " << this->AutoOrientNormals << "\n";
+  os << indent << "FlipNormals: " << this->FlipNormals << "\n";
+  os << indent << "Splitting: " << this->Splitting << "\n";
+  os << indent << "FeatureAngle: " << this->FeatureAngle << "\n";
+  os << indent << "Mirror: " << this->Mirror << "\n";
+  os << indent << "MirrorX: " << this->MirrorX << "\n";
+  os << indent << "MirrorY: " << this->MirrorY << "\n";
+  os << indent << "MirrorZ: " << this->MirrorZ << "\n";
+  os << indent << "Clean: " << this->Clean << "\n";
+  os << indent << "Connectivity: " << this->Connectivity << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+}
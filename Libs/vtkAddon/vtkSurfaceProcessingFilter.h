@@ -0,0 +1,221 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+/// \brief vtkSurfaceProcessingFilter - decimate, smooth, compute normals,
+/// mirror, clean and extract the largest region of a surface in one filter.
+///
+/// The enabled steps are run in this order on the output of the previous
+/// step, the intermediate surfaces are released as soon as they are used.
+/// Laplace smoothing and the point normals (when splitting is off) are
+/// computed with NumberOfThreads threads. Laplace smoothing moves all the
+/// points simultaneously from their previous position (Jacobi iterations),
+/// the result does not depend on the number of threads.
+///
+
+#ifndef __vtkSurfaceProcessingFilter_h
+#define __vtkSurfaceProcessingFilter_h
+
+#include "vtkAddon.h"
+
+#include <vtkPolyDataAlgorithm.h>
+
+class VTK_ADDON_EXPORT vtkSurfaceProcessingFilter : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkSurfaceProcessingFilter *New();
+  vtkTypeMacro(vtkSurfaceProcessingFilter, vtkPolyDataAlgorithm);
+  virtual void PrintSelf(ostream& os, vtkIndent indent);
+
+  enum
+    {
+    DecimatePro = 0,
+    QuadricDecimation
+    };
+
+  enum
+    {
+    LaplaceSmoothing = 0,
+    TaubinSmoothing
+    };
+
+  // Description:
+  // Triangulate and decimate the surface. Off by default.
+  vtkSetMacro(Decimation, int);
+  vtkGetMacro(Decimation, int);
+  vtkBooleanMacro(Decimation, int);
+
+  // Description:
+  // Decimation algorithm: vtkDecimatePro (topology preserving) or
+  // vtkQuadricDecimation. DecimatePro by default.
+  vtkSetClampMacro(DecimationMethod, int, DecimatePro, QuadricDecimation);
+  vtkGetMacro(DecimationMethod, int);
+  void SetDecimationMethodToDecimatePro()
+    { this->SetDecimationMethod(DecimatePro); }
+  void SetDecimationMethodToQuadricDecimation()
+    { this->SetDecimationMethod(QuadricDecimation); }
+
+  // Description:
+  // Requested fraction of triangles to remove. 0.8 by default.
+  vtkSetClampMacro(TargetReduction, double, 0.0, 1.0);
+  vtkGetMacro(TargetReduction, double);
+
+  // Description:
+  // Requested number of triangles after decimation. When strictly positive,
+  // it is used instead of TargetReduction. 0 by default.
+  vtkSetClampMacro(TargetNumberOfTriangles, vtkIdType, 0, VTK_ID_MAX);
+  vtkGetMacro(TargetNumberOfTriangles, vtkIdType);
+
+  // Description:
+  // Allow DecimatePro to delete boundary vertices. On by default.
+  vtkSetMacro(BoundaryVertexDeletion, int);
+  vtkGetMacro(BoundaryVertexDeletion, int);
+  vtkBooleanMacro(BoundaryVertexDeletion, int);
+
+  // Description:
+  // Smooth the surface. Off by default.
+  vtkSetMacro(Smoothing, int);
+  vtkGetMacro(Smoothing, int);
+  vtkBooleanMacro(Smoothing, int);
+
+  // Description:
+  // Smoothing algorithm: multithreaded Laplace or Taubin
+  // (vtkWindowedSincPolyDataFilter). Laplace by default.
+  vtkSetClampMacro(SmoothingMethod, int, LaplaceSmoothing, TaubinSmoothing);
+  vtkGetMacro(SmoothingMethod, int);
+  void SetSmoothingMethodToLaplace()
+    { this->SetSmoothingMethod(LaplaceSmoothing); }
+  void SetSmoothingMethodToTaubin()
+    { this->SetSmoothingMethod(TaubinSmoothing); }
+
+  // Description:
+  // Laplace smoothing parameters. 100 iterations and 0.5 by default.
+  vtkSetClampMacro(LaplaceNumberOfIterations, int, 0, VTK_INT_MAX);
+  vtkGetMacro(LaplaceNumberOfIterations, int);
+  vtkSetClampMacro(LaplaceRelaxationFactor, double, 0.0, 1.0);
+  vtkGetMacro(LaplaceRelaxationFactor, double);
+
+  // Description:
+  // Taubin smoothing parameters. 30 iterations and 0.1 by default.
+  vtkSetClampMacro(TaubinNumberOfIterations, int, 0, VTK_INT_MAX);
+  vtkGetMacro(TaubinNumberOfIterations, int);
+  vtkSetClampMacro(TaubinPassBand, double, 0.0, 2.0);
+  vtkGetMacro(TaubinPassBand, double);
+
+  // Description:
+  // Smooth the boundary vertices along the boundary. When off, the boundary
+  // vertices are not moved. On by default.
+  vtkSetMacro(BoundarySmoothing, int);
+  vtkGetMacro(BoundarySmoothing, int);
+  vtkBooleanMacro(BoundarySmoothing, int);
+
+  // Description:
+  // Compute consistently oriented point normals. Off by default.
+  vtkSetMacro(Normals, int);
+  vtkGetMacro(Normals, int);
+  vtkBooleanMacro(Normals, int);
+
+  // Description:
+  // Normals parameters, see vtkPolyDataNormals. AutoOrientNormals, FlipNormals
+  // and Splitting are off, FeatureAngle is 30 degrees by default.
+  vtkSetMacro(AutoOrientNormals, int);
+  vtkGetMacro(AutoOrientNormals, int);
+  vtkBooleanMacro(AutoOrientNormals, int);
+  vtkSetMacro(FlipNormals, int);
+  vtkGetMacro(FlipNormals, int);
+  vtkBooleanMacro(FlipNormals, int);
+  vtkSetMacro(Splitting, int);
+  vtkGetMacro(Splitting, int);
+  vtkBooleanMacro(Splitting, int);
+  vtkSetClampMacro(FeatureAngle, double, 0.0, 180.0);
+  vtkGetMacro(FeatureAngle, double);
+
+  // Description:
+  // Mirror the surface along the enabled axes. The cell orientation is
+  // reversed when an odd number of axes is mirrored. Off by default.
+  vtkSetMacro(Mirror, int);
+  vtkGetMacro(Mirror, int);
+  vtkBooleanMacro(Mirror, int);
+  vtkSetMacro(MirrorX, int);
+  vtkGetMacro(MirrorX, int);
+  vtkBooleanMacro(MirrorX, int);
+  vtkSetMacro(MirrorY, int);
+  vtkGetMacro(MirrorY, int);
+  vtkBooleanMacro(MirrorY, int);
+  vtkSetMacro(MirrorZ, int);
+  vtkGetMacro(MirrorZ, int);
+  vtkBooleanMacro(MirrorZ, int);
+
+  // Description:
+  // Merge duplicate points and remove degenerate cells (vtkCleanPolyData).
+  // Off by default.
+  vtkSetMacro(Clean, int);
+  vtkGetMacro(Clean, int);
+  vtkBooleanMacro(Clean, int);
+
+  // Description:
+  // Only keep the largest connected region. Off by default.
+  vtkSetMacro(Connectivity, int);
+  vtkGetMacro(Connectivity, int);
+  vtkBooleanMacro(Connectivity, int);
+
+  // Description:
+  // Number of threads used by the multithreaded steps.
+  // 0 (default) uses vtkMultiThreader::GetGlobalDefaultNumberOfThreads().
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+protected:
+  vtkSurfaceProcessingFilter();
+  ~vtkSurfaceProcessingFilter();
+
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
+
+  void ApplyDecimation(vtkPolyData* surface, vtkPolyData* output);
+  void ApplyLaplaceSmoothing(vtkPolyData* surface, vtkPolyData* output);
+  void ApplyNormals(vtkPolyData* surface, vtkPolyData* output);
+  int GetNumberOfThreadsToUse();
+
+  int Decimation;
+  int DecimationMethod;
+  double TargetReduction;
+  vtkIdType TargetNumberOfTriangles;
+  int BoundaryVertexDeletion;
+
+  int Smoothing;
+  int SmoothingMethod;
+  int LaplaceNumberOfIterations;
+  double LaplaceRelaxationFactor;
+  int TaubinNumberOfIterations;
+  double TaubinPassBand;
+  int BoundarySmoothing;
+
+  int Normals;
+  int AutoOrientNormals;
+  int FlipNormals;
+  int Splitting;
+  double FeatureAngle;
+
+  int Mirror;
+  int MirrorX;
+  int MirrorY;
+  int MirrorZ;
+
+  int Clean;
+  int Connectivity;
+
+  int NumberOfThreads;
+
+private:
+  vtkSurfaceProcessingFilter(const vtkSurfaceProcessingFilter&);  // Not implemented.
+  void operator=(const vtkSurfaceProcessingFilter&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,99 @@
+import unittest
+import vtk
+import vtkITK
+from vtk.util import numpy_support as ns
+import numpy
+
+"""
+To run as test from slicer python console, replace the following with your source tree path and paste:
+
+execfile('/path/to/Slicer/Libs/vtkITK/Testing/vtkITKFastMarchingSegmentation.py'); t = vtkITKFastMarchingSegmentationTest(); t.runTest()
+"""
+
+class vtkITKFastMarchingSegmentationTest(unittest.TestCase):
+    def setUp(self):
+        # bright sphere of radius 10 in a dark 64^3 image
+        self.dim = 64
+        k, j, i = numpy.mgrid[0:self.dim, 0:self.dim, 0:self.dim]
+        self.sphere = ((i - 32) ** 2 + (j - 32) ** 2 + (k - 32) ** 2) < 10 ** 2
+        intensity = numpy.where(self.sphere, 200, 20).astype(numpy.int16)
+        self.intensityImage = self.imageFromArray(intensity)
+
+        labels = numpy.zeros(intensity.shape, numpy.int16)
+        labels[31:34, 31:34, 31:34] = 1
+        # other labels are never overwritten
+        labels[32, 32, 40] = 2
+        self.labelImage = self.imageFromArray(labels)
+
+        self.fm = vtkITK.vtkITKFastMarchingSegmentation()
+        self.fm.SetInputData(0, self.intensityImage)
+        self.fm.SetInputData(1, self.labelImage)
+        self.fm.SetLabel(1)
+
+    def imageFromArray(self, array):
+        image = vtk.vtkImageData()
+        image.SetDimensions(self.dim, self.dim, self.dim)
+        vtkArray = ns.numpy_to_vtk(array.ravel(), deep=True, array_type=vtk.VTK_SHORT)
+        image.GetPointData().SetScalars(vtkArray)
+        return image
+
+    def output(self):
+        return ns.vtk_to_numpy(self.fm.GetOutput().GetPointData().GetScalars()).reshape(
+            self.dim, self.dim, self.dim)
+
+    def test_march(self):
+        numberOfVoxels = int(self.sphere.sum()) - 27
+        self.fm.SetTargetNumberOfVoxels(numberOfVoxels)
+        self.fm.Update()
+        self.assertEqual(self.fm.GetNumberOfMarchedVoxels(), numberOfVoxels)
+        self.assertEqual(self.fm.GetNumberOfShownVoxels(), numberOfVoxels)
+
+        output = self.output()
+        self.assertEqual(output.dtype, numpy.int16)
+        # the front stays in the sphere
+        self.assertTrue((output[self.sphere] == 1).sum() > 0.95 * self.sphere.sum())
+        self.assertEqual(output[32, 32, 40], 2)
+        # the input label map is left untouched
+        self.assertEqual((ns.vtk_to_numpy(self.labelImage.GetPointData().GetScalars()) == 1).sum(), 27)
+
+        # only the neighborhood of the sphere is allocated
+        extent = [0] * 6
+        self.fm.GetRegionExtent(extent)
+        self.assertTrue(extent[1] - extent[0] < self.dim - 1)
+
+    def test_reuse(self):
+        self.fm.SetTargetNumberOfVoxels(1000)
+        self.fm.Update()
+        firstOutput = self.output().copy()
+
+        # showing a fraction does not march again
+        self.fm.SetShowFraction(0.5)
+        self.fm.Update()
+        self.assertEqual(self.fm.GetNumberOfMarchedVoxels(), 1000)
+        self.assertEqual(self.fm.GetNumberOfShownVoxels(), 500)
+        self.assertEqual((self.output() == 1).sum(), 27 + 500)
+
+        # a larger target resumes the marching where it stopped
+        self.fm.SetShowFraction(1.)
+        self.fm.SetTargetNumberOfVoxels(2000)
+        self.fm.Update()
+        self.assertEqual(self.fm.GetNumberOfMarchedVoxels(), 2000)
+        output = self.output()
+        self.assertTrue(numpy.all(output[firstOutput == 1] == 1))
+
+        # back to the first target, same result as the first march
+        self.fm.SetTargetNumberOfVoxels(1000)
+        self.fm.Update()
+        self.assertTrue(numpy.array_equal(self.output(), firstOutput))
+
+        # new seeds restart the marching
+        self.labelImage.GetPointData().GetScalars().Modified()
+        self.fm.Update()
+        self.assertEqual(self.fm.GetNumberOfMarchedVoxels(), 1000)
+        self.assertTrue(numpy.array_equal(self.output(), firstOutput))
+
+    def runTest(self):
+        self.setUp()
+        self.test_march()
+        self.setUp()
+        self.test_reuse()
@@ -0,0 +1,74 @@
+import unittest
+import vtk
+import vtkITK
+from vtk.util import numpy_support as ns
+import numpy
+
+"""
+To run as test from slicer python console, replace the following with your source tree path and paste:
+
+execfile('/path/to/Slicer/Libs/vtkITK/Testing/vtkITKLevelTracing.py'); t = vtkITKLevelTracingTest(); t.runTest()
+"""
+
+class vtkITKLevelTracingTest(unittest.TestCase):
+    def setUp(self):
+        # bright cube in a dark 40^3 image
+        self.dim = 40
+        array = numpy.zeros((self.dim, self.dim, self.dim), numpy.int16)
+        array[10:30, 10:30, 10:30] = 100
+        self.image = vtk.vtkImageData()
+        self.image.SetDimensions(self.dim, self.dim, self.dim)
+        self.image.GetPointData().SetScalars(ns.numpy_to_vtk(array.ravel(), deep=True, array_type=vtk.VTK_SHORT))
+
+    def test_trace2D(self):
+        tracing = vtkITK.vtkITKLevelTracingImageFilter()
+        tracing.SetInputData(self.image)
+        tracing.SetPlaneToIJ()
+        tracing.SetSeed(10, 20, 20)
+        tracing.Update()
+        numberOfPoints = tracing.GetOutput().GetNumberOfPoints()
+        self.assertEqual(numberOfPoints, 4 * 19)
+        self.assertEqual(tracing.GetNumberOfCachedTraces(), 1)
+
+        # another pixel of the same curve reuses the trace
+        tracing.SetSeed(15, 10, 20)
+        tracing.Update()
+        self.assertEqual(tracing.GetOutput().GetNumberOfPoints(), numberOfPoints)
+        self.assertEqual(tracing.GetNumberOfCachedTraces(), 1)
+
+        # another level is traced
+        tracing.SetSeed(9, 20, 20)
+        tracing.Update()
+        self.assertEqual(tracing.GetNumberOfCachedTraces(), 2)
+
+        # modifying the input discards the cache
+        self.image.GetPointData().GetScalars().Modified()
+        tracing.SetSeed(10, 20, 20)
+        tracing.Update()
+        self.assertEqual(tracing.GetOutput().GetNumberOfPoints(), numberOfPoints)
+        self.assertEqual(tracing.GetNumberOfCachedTraces(), 1)
+
+    def test_trace3D(self):
+        outputs = []
+        for numberOfThreads in [1, 4]:
+            tracing = vtkITK.vtkITKLevelTracing3DImageFilter()
+            tracing.SetInputData(self.image)
+            tracing.SetNumberOfThreads(numberOfThreads)
+            tracing.SetSeed(10, 20, 20)
+            tracing.Update()
+            outputs.append(ns.vtk_to_numpy(tracing.GetOutput().GetPointData().GetScalars()).copy())
+        # the surface of the cube
+        self.assertEqual(outputs[0].sum(), 20 ** 3 - 18 ** 3)
+        self.assertTrue(numpy.array_equal(outputs[0], outputs[1]))
+
+        # a seed on the same surface gives the same output
+        tracing.SetSeed(29, 15, 15)
+        tracing.Update()
+        self.assertTrue(numpy.array_equal(
+            ns.vtk_to_numpy(tracing.GetOutput().GetPointData().GetScalars()), outputs[0]))
+
+    def runTest(self):
+        self.setUp()
+        self.test_trace2D()
+        self.setUp()
+        self.test_trace3D()
@@ -23,9 +23,24 @@
 #include "itkExtractImageFilter.h"
 #include "itkImageToImageFilter.h"
 #include "itksys/hash_map.hxx"
+#include <map>
+#include <utility>
+#include <vector>
 
 namespace itk
 {
+/** Interpolation between two labeled slices, kept for incremental updates.
+ *  Region is the region of the first slice in which the label is processed,
+ *  masks are the label pixels of the two slices in this region, runs are
+ *  the interpolated pixels (start index and length along the first axis). */
+template< typename TImage >
+struct SlicePairInterpolation
+{
+  typename TImage::RegionType region;
+  std::vector< bool > iMask, jMask;
+  std::vector< std::pair< typename TImage::IndexType, SizeValueType > > runs;
+};
+
 /** \class MorphologicalContourInterpolator
  *
  *  \brief Interpolates contours between slices. Based on a paper by Albu et al.
@@ -156,6 +171,24 @@ public:
   /** Use ball instead of default cross structuring element for repeated dilations. */
   itkGetConstMacro( UseBallStructuringElement, bool );
 
+  /** Keep the interpolations between pairs of labeled slices and reuse them in the next
+  *   update if the content of both slices has not changed. When slices are drawn one by
+  *   one and the filter is updated after each of them, only the gaps next to the modified
+  *   slices are interpolated again. Default is OFF. */
+  itkSetMacro( Incremental, bool );
+
+  /** Keep the interpolations between pairs of labeled slices and reuse them in the next
+  *   update if the content of both slices has not changed. Default is OFF. */
+  itkGetConstMacro( Incremental, bool );
+  itkBooleanMacro( Incremental );
+
+  /** Forget the interpolations kept for incremental updates. */
+  void
+  ClearIncrementalCache()
+  {
+    m_SlicePairs.clear();
+  }
+
   /** If there is a pixel whose all 4-way neighbors belong the the same label
   except along one axis, and along that axis its neighbors are 0 (background),
   then that axis should be interpolated along. Interpolation is possible
@@ -222,6 +255,7 @@ protected:
   bool                       m_UseDistanceTransform;
   bool                       m_UseBallStructuringElement;
   bool                       m_UseCustomSlicePositions;
+  bool                       m_Incremental;
   IdentifierType             m_MinAlignIters; // minimum number of iterations in align method
   IdentifierType             m_MaxAlignIters; // maximum number of iterations in align method
   IdentifierType             m_ThreadCount;   // for thread local instances
@@ -240,6 +274,28 @@ protected:
   virtual void
   GenerateData() ITK_OVERRIDE;
 
+  /** Identifies a pair of labeled slices: (axis, label), (first slice, second slice). */
+  typedef std::pair< std::pair< int, typename TImage::PixelType >,
+    std::pair< typename TImage::IndexValueType, typename TImage::IndexValueType > > SlicePairKeyType;
+  typedef std::map< SlicePairKeyType, SlicePairInterpolation< TImage > > SlicePairsType;
+  SlicePairsType m_SlicePairs;         // interpolations of the current (or last) update
+  SlicePairsType m_PreviousSlicePairs; // interpolations of the previous update, during an update
+  typename TImage::RegionType m_SlicePairsRegion; // requested region of the kept interpolations
+  typename TImage::SpacingType m_SlicePairsSpacing; // input spacing of the kept interpolations
+  unsigned int m_SlicePairsParameters; // alignment, distance transform and structuring element options
+
+  /** Interpolation being computed by each thread (NULL if not recorded) */
+  std::vector< SlicePairInterpolation< TImage >* > m_ThreadSlicePairs;
+
+  /** Label pixels of a slice within the region (of size 0 or 1 along the axis) */
+  void
+  SliceMask( typename TImage::RegionType region, int axis, typename TImage::PixelType label, std::vector< bool >& mask );
+
+  /** Writes interpolated pixels kept from a previous update into the output */
+  void
+  ReplaySlicePairInterpolation( const SlicePairInterpolation< TImage >& interpolation, TImage* out,
+    typename TImage::PixelType label );
+
   /** Determines correspondances between two slices and calls apropriate methods. */
   void
   InterpolateBetweenTwo( int axis,
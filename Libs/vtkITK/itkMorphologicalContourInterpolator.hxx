@@ -49,6 +49,7 @@ struct SegmentBetweenTwo
   TImage* out;
   int label, i, j;
   typename MorphologicalContourInterpolator< TImage >::SliceType::Pointer iconn, jconn;
+  SlicePairInterpolation< TImage >* interpolation; // records the result if not NULL
 };
 
 template< typename TImage >
@@ -94,6 +95,7 @@ private:
     // Look only at the range of cells by the set of indices in the subDomain.
     for ( itk::IndexValueType ii = subDomain[0]; ii <= subDomain[1] && ii < IndexValueType( m_WorkArray.size() ); ++ii )
       {
+      this->m_Associate->m_ThreadSlicePairs[threadId] = m_WorkArray[ii].interpolation;
       this->m_Associate->InterpolateBetweenTwo(
         m_WorkArray[ii].axis,
         m_WorkArray[ii].out,
@@ -103,6 +105,7 @@ private:
         m_WorkArray[ii].iconn,
         m_WorkArray[ii].jconn,
         threadId );
+      this->m_Associate->m_ThreadSlicePairs[threadId] = ITK_NULLPTR;
       }
   } // ThreadedExecution
 
@@ -146,10 +149,13 @@ MorphologicalContourInterpolator< TImage >
   m_UseDistanceTransform( true ),
   m_UseBallStructuringElement( false ),
   m_UseCustomSlicePositions( false ),
+  m_Incremental( false ),
   m_MinAlignIters( pow( 2, TImage::ImageDimension ) ), // smaller of this and pixel count of the search image
   m_MaxAlignIters( pow( 6, TImage::ImageDimension ) ), // bigger of this and root of pixel count of the search image
   m_ThreadCount( MultiThreader::GetGlobalDefaultNumberOfThreads() ),
-  m_LabeledSlices( TImage::ImageDimension ) // initialize with empty sets
+  m_LabeledSlices( TImage::ImageDimension ), // initialize with empty sets
+  m_SlicePairsParameters( 0 ),
+  m_ThreadSlicePairs( ITK_MAX_THREADS, ITK_NULLPTR )
 {
   // set up pipeline for regioned connected components
   m_RoI = RoiType::New();
@@ -856,6 +862,37 @@ MorphologicalContourInterpolator< TImage >
       }
 
     mutex.Unlock();
+
+    SlicePairInterpolation< TImage >* interpolation = m_ThreadSlicePairs[threadId];
+    if ( interpolation ) // keep the written pixels for incremental updates
+      {
+      seqIt.GoToBegin();
+      ImageRegionConstIteratorWithIndex< TImage > indexIt( out, outRegion );
+      while ( !indexIt.IsAtEnd() )
+        {
+        if ( seqIt.Get() )
+          {
+          typename TImage::IndexType ind = indexIt.GetIndex();
+          bool continuesRun = false;
+          if ( !interpolation->runs.empty() )
+            {
+            typename TImage::IndexType runEnd = interpolation->runs.back().first;
+            runEnd[0] += interpolation->runs.back().second;
+            continuesRun = ( runEnd == ind );
+            }
+          if ( continuesRun )
+            {
+            ++interpolation->runs.back().second;
+            }
+          else
+            {
+            interpolation->runs.push_back( std::make_pair( ind, SizeValueType( 1 ) ) );
+            }
+          }
+        ++seqIt;
+        ++indexIt;
+        }
+      }
     } // iterator destroyed here
 
   // recurse if needed
@@ -1537,6 +1574,40 @@ MorphologicalContourInterpolator< TImage >
     } // M-to-N
 } // void MorphologicalContourInterpolator::InterpolateBetweenTwo()
 
+template< typename TImage >
+void
+MorphologicalContourInterpolator< TImage >
+::SliceMask( typename TImage::RegionType region, int axis, typename TImage::PixelType label, std::vector< bool >& mask )
+{
+  region.SetSize( axis, 1 );
+  mask.resize( region.GetNumberOfPixels() );
+  ImageRegionConstIterator< TImage > it( this->GetInput(), region );
+  for ( std::vector< bool >::size_type n = 0; !it.IsAtEnd(); ++it, ++n )
+    {
+    mask[n] = ( it.Get() == label );
+    }
+}
+
+template< typename TImage >
+void
+MorphologicalContourInterpolator< TImage >
+::ReplaySlicePairInterpolation( const SlicePairInterpolation< TImage >& interpolation, TImage* out,
+  typename TImage::PixelType label )
+{
+  for ( typename std::vector< std::pair< typename TImage::IndexType, SizeValueType > >::const_iterator run =
+        interpolation.runs.begin(); run != interpolation.runs.end(); ++run )
+    {
+    typename TImage::IndexType ind = run->first;
+    for ( SizeValueType n = 0; n < run->second; ++n, ++ind[0] )
+      {
+      if ( out->GetPixel( ind ) < label )
+        {
+        out->SetPixel( ind, label );
+        }
+      }
+    }
+}
+
 template< typename TImage >
 void
 MorphologicalContourInterpolator< TImage >
@@ -1573,8 +1644,13 @@ MorphologicalContourInterpolator< TImage >
       ri.SetSize( axis, 0 );
       ri.SetIndex( axis, *prev );
       IdentifierType xCount;
-      typename SliceType::Pointer iconn = this->RegionedConnectedComponents( ri, it->first, xCount );
-      iconn->DisconnectPipeline();
+      // connected components are only computed for slices which need to be interpolated
+      typename SliceType::Pointer iconn;
+      std::vector< bool > iMask;
+      if ( m_Incremental )
+        {
+        this->SliceMask( ri, axis, it->first, iMask );
+        }
       int iReq = *prev < reqRegion.GetIndex( axis ) ? -1 :
         ( *prev > reqRegion.GetIndex( axis ) + IndexValueType( reqRegion.GetSize( axis ) ) ? +1 : 0 );
 
@@ -1583,8 +1659,12 @@ MorphologicalContourInterpolator< TImage >
         {
         typename TImage::RegionType rj = ri;
         rj.SetIndex( axis, *next );
-        typename SliceType::Pointer jconn = this->RegionedConnectedComponents( rj, it->first, xCount );
-        jconn->DisconnectPipeline();
+        typename SliceType::Pointer jconn;
+        std::vector< bool > jMask;
+        if ( m_Incremental )
+          {
+          this->SliceMask( rj, axis, it->first, jMask );
+          }
         int jReq = *next < reqRegion.GetIndex( axis ) ? -1 :
           ( *next > reqRegion.GetIndex( axis ) + IndexValueType( reqRegion.GetSize( axis ) ) ? +1 : 0 );
 
@@ -1592,17 +1672,50 @@ MorphologicalContourInterpolator< TImage >
              && abs(iReq + jReq) <= 1 ) // and not out of the requested region
         // unless they are on opposite ends
           {
-          SegmentBetweenTwo< TImage > s;
-          s.axis = axis;
-          s.out = out;
-          s.label = it->first;
-          s.i = *prev;
-          s.j = *next;
-          s.iconn = iconn;
-          s.jconn = jconn;
-          segments.push_back( s );
+          SlicePairInterpolation< TImage >* interpolation = ITK_NULLPTR;
+          bool reused = false;
+          if ( m_Incremental )
+            {
+            SlicePairKeyType key( std::make_pair( axis, it->first ), std::make_pair( *prev, *next ) );
+            interpolation = &m_SlicePairs[key];
+            typename SlicePairsType::iterator previous = m_PreviousSlicePairs.find( key );
+            if ( previous != m_PreviousSlicePairs.end() && previous->second.region == ri
+                 && previous->second.iMask == iMask && previous->second.jMask == jMask )
+              {
+              // neither slice has changed since the previous update
+              interpolation->runs.swap( previous->second.runs );
+              this->ReplaySlicePairInterpolation( *interpolation, out, it->first );
+              reused = true;
+              }
+            interpolation->region = ri;
+            interpolation->iMask = iMask;
+            interpolation->jMask = jMask;
+            }
+          if ( !reused )
+            {
+            if ( iconn.IsNull() )
+              {
+              iconn = this->RegionedConnectedComponents( ri, it->first, xCount );
+              iconn->DisconnectPipeline();
+              }
+            jconn = this->RegionedConnectedComponents( rj, it->first, xCount );
+            jconn->DisconnectPipeline();
+
+            SegmentBetweenTwo< TImage > s;
+            s.axis = axis;
+            s.out = out;
+            s.label = it->first;
+            s.i = *prev;
+            s.j = *next;
+            s.iconn = iconn;
+            s.jconn = jconn;
+            s.interpolation = interpolation;
+            segments.push_back( s );
+            }
           }
+        ri = rj;
         iconn = jconn;
+        iMask.swap( jMask );
         iReq = jReq;
         prev = next;
         }
@@ -1647,6 +1760,20 @@ MorphologicalContourInterpolator< TImage >
   typename TImage::Pointer m_Output = this->GetOutput();
   this->AllocateOutputs();
 
+  // Interpolations of the previous update can only be reused if they were computed the same way
+  m_PreviousSlicePairs.clear();
+  const unsigned int parameters = ( m_HeuristicAlignment ? 1 : 0 ) | ( m_UseDistanceTransform ? 2 : 0 )
+    | ( m_UseBallStructuringElement ? 4 : 0 );
+  if ( m_Incremental && m_SlicePairsRegion == m_Output->GetRequestedRegion()
+       && m_SlicePairsSpacing == m_Input->GetSpacing() && m_SlicePairsParameters == parameters )
+    {
+    m_PreviousSlicePairs.swap( m_SlicePairs );
+    }
+  m_SlicePairs.clear();
+  m_SlicePairsRegion = m_Output->GetRequestedRegion();
+  m_SlicePairsSpacing = m_Input->GetSpacing();
+  m_SlicePairsParameters = parameters;
+
   if ( m_UseCustomSlicePositions )
     {
     SliceIndicesType t = m_LabeledSlices;
@@ -1662,6 +1789,7 @@ MorphologicalContourInterpolator< TImage >
     {
     ImageAlgorithm::Copy< TImage, TImage >( m_Input.GetPointer(), m_Output.GetPointer(),
       m_Output->GetRequestedRegion(), m_Output->GetRequestedRegion() );
+    m_PreviousSlicePairs.clear();
     return; // no contours detected
     }
 
@@ -1702,6 +1830,7 @@ MorphologicalContourInterpolator< TImage >
     {
     this->InterpolateAlong( m_Axis, m_Output );
     }
+  m_PreviousSlicePairs.clear(); // interpolations that are not reused anymore
 
   // Overwrites m_Output with non non-zeroes from m_Input
   ImageRegionIterator< TImage > itO( this->GetOutput(), this->GetOutput()->GetBufferedRegion() );
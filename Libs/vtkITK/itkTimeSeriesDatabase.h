@@ -7,6 +7,8 @@
 #include <itkImageSource.h>
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <vector>
 #include <itkTimeSeriesDatabaseHelper.h>
 
 #define TimeSeriesBlockSize 16
@@ -94,13 +96,54 @@ public:
    */
   void GetVoxelTimeSeries ( typename OutputImageType::IndexType idx, ArrayType& array );
 
+  /** Extract the time series of all voxels of a region in one pass.
+   * Each block of the region is read once per volume. The result is stored
+   * in timeSeries[voxel * NumberOfVolumes + volume], voxels are ordered as
+   * in the region (first index is the fastest).
+   */
+  void GetRegionTimeSeries ( const typename OutputImageType::RegionType& region, std::vector<TPixel>& timeSeries );
+
+  /** Extract the time series of all voxels where the mask is equal to label.
+   * The mask must have the same size as the images of the database.
+   * The result is stored in timeSeries[voxel * NumberOfVolumes + volume], voxels
+   * are ordered as in the mask (first index is the fastest). If voxelIndices is
+   * specified, then it receives the index of each extracted voxel.
+   */
+  template <class TMaskImage>
+  void GetMaskedTimeSeries ( const TMaskImage* mask, typename TMaskImage::PixelType label, std::vector<TPixel>& timeSeries,
+                             std::vector<typename OutputImageType::IndexType>* voxelIndices = 0 );
+
   /** Set the size of the cache in MiB (1 MiB = 2^20 bytes)
+   * The cache is only used if the database files are not memory mapped.
    */
   void SetCacheSizeInMiB ( float sz );
   /** Get the size of the cache in MiB (1 MiB = 2^20 bytes)
    */
   float GetCacheSizeInMiB ();
 
+  /** Access the database files through memory mapping (default: on).
+   * Memory mapped pages are loaded by the operating system on demand and
+   * shared between all readers of the database, therefore the database
+   * can be larger than the physical memory. If mapping fails then the
+   * files are read through the block cache.
+   * Takes effect at the next Connect.
+   */
+  itkSetMacro ( UseMemoryMapping, bool );
+  itkGetMacro ( UseMemoryMapping, bool );
+  itkBooleanMacro ( UseMemoryMapping );
+
+  /** Number of images following the current image that are prefetched
+   * after the current image is read (default: 1). This allows playing
+   * the series without waiting for the disk at each image.
+   */
+  itkSetMacro ( NumberOfPrefetchedImages, unsigned int );
+  itkGetMacro ( NumberOfPrefetchedImages, unsigned int );
+
+  /** Ask the operating system to read an image in the background.
+   * Only has an effect if the database files are memory mapped.
+   */
+  void PrefetchImage ( unsigned int image );
+
 
 protected:
   TimeSeriesDatabase();
@@ -114,6 +157,7 @@ protected:
   typename OutputImageType::PointType m_OutputOrigin;
   typename OutputImageType::DirectionType m_OutputDirection;
   typedef itk::TimeSeriesDatabaseHelper::counted_ptr<std::fstream> StreamPtr;
+  typedef itk::TimeSeriesDatabaseHelper::counted_ptr<itk::TimeSeriesDatabaseHelper::MappedFile> MappedFilePtr;
 
   static std::streampos CalculatePosition ( unsigned long index, unsigned long BlocksPerFile );
 
@@ -137,13 +181,32 @@ protected:
   std::vector<std::string> m_DatabaseFileNames;
   unsigned long m_BlocksPerFile;
 
+  /// Memory mapped database files (empty if the files are read through the cache)
+  std::vector<MappedFilePtr> m_MappedFiles;
+  bool m_UseMemoryMapping;
+  unsigned int m_NumberOfPrefetchedImages;
+
   /// our cache
   struct CacheBlock
   {
     TPixel data[TimeSeriesBlockSize*TimeSeriesBlockSize*TimeSeriesBlockSize];
   };
   TimeSeriesDatabaseHelper::LRUCache<unsigned long, CacheBlock> m_Cache;
-  CacheBlock* GetCacheBlock ( unsigned long index );
+  /// Get a block from the mapped file or from the cache (reading it from file if needed).
+  /// The returned pointer is only valid until the next call.
+  const CacheBlock* GetCacheBlock ( unsigned long index );
+
+  /// Voxels to extract from one block: offset in the block and position in the output
+  struct BlockVoxels
+  {
+    Size<3> Block;
+    std::vector<unsigned int> BlockOffsets;
+    std::vector< ::size_t > VoxelOrdinals;
+  };
+  /// Blocks that contain extracted voxels, sorted by block position within an image
+  typedef std::map<unsigned long, BlockVoxels> BlockVoxelsMap;
+  void AddVoxelToBlocks ( const typename OutputImageType::IndexType& idx, ::size_t voxelOrdinal, BlockVoxelsMap& blocks );
+  void ExtractTimeSeries ( const BlockVoxelsMap& blocks, ::size_t numberOfVoxels, std::vector<TPixel>& timeSeries );
 };
 
 } // end namespace itk
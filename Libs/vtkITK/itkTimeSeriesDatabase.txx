@@ -4,6 +4,7 @@
 #include <itkImageRegionConstIterator.h>
 #include <itkImageRegionIteratorWithIndex.h>
 #include <itkImageRegionIterator.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
 #include <itksys/SystemTools.hxx>
 #include <itkImage.h>
 #include <itkImageFileReader.h>
@@ -60,12 +61,14 @@ bool TimeSeriesDatabase<TPixel>::IsOpen () const
 template <class TPixel>
 void TimeSeriesDatabase<TPixel>::Disconnect ()
 {
-  for ( int idx = 0; idx < this->m_DatabaseFiles.size(); idx++ )
+  for ( ::size_t idx = 0; idx < this->m_DatabaseFiles.size(); idx++ )
     {
     this->m_DatabaseFiles[idx]->close();
     }
   this->m_DatabaseFiles.clear();
   this->m_DatabaseFileNames.clear();
+  this->m_MappedFiles.clear();
+  this->m_Cache.clear();
 }
 
 template <class TPixel>
@@ -131,6 +134,23 @@ void TimeSeriesDatabase<TPixel>::Connect ( const char* filename )
     this->m_DatabaseFileNames.push_back ( Filename );
     this->m_DatabaseFiles.push_back ( StreamPtr ( new std::fstream ( Filename.c_str(), ::std::ios::in | ::std::ios::binary ) ) );
     }
+  // Map the files, fall back to reading through the cache if any of them fails
+  this->m_MappedFiles.clear();
+  this->m_Cache.clear();
+  if ( this->m_UseMemoryMapping )
+    {
+    for ( ::size_t idx = 0; idx < this->m_DatabaseFileNames.size(); idx++ )
+      {
+      MappedFilePtr mappedFile ( new TimeSeriesDatabaseHelper::MappedFile );
+      if ( !mappedFile->Open ( this->m_DatabaseFileNames[idx].c_str() ) )
+        {
+        itkDebugMacro ( "TimeSeriesDatabase::Connect: failed to map " << this->m_DatabaseFileNames[idx] << ", using cached file reading" );
+        this->m_MappedFiles.clear();
+        break;
+        }
+      this->m_MappedFiles.push_back ( mappedFile );
+      }
+    }
   /*
   std::cout << "ImageSize: " << m_OutputRegion.GetSize() << endl;
   std::cout << "ImageOrigin: " << m_OutputOrigin << endl;
@@ -184,13 +204,23 @@ template <class TPixel>
 
 
 template <class TPixel>
-typename TimeSeriesDatabase<TPixel>::CacheBlock* TimeSeriesDatabase<TPixel>::GetCacheBlock ( unsigned long index )
+const typename TimeSeriesDatabase<TPixel>::CacheBlock* TimeSeriesDatabase<TPixel>::GetCacheBlock ( unsigned long index )
 {
+  int FileIdx = this->CalculateFileIndex ( index );
+  if ( FileIdx < static_cast<int>( this->m_MappedFiles.size() ) )
+    {
+    // Blocks start at multiples of the block size, so they are suitably aligned in the mapped file
+    const TimeSeriesDatabaseHelper::MappedFile* mappedFile = this->m_MappedFiles[FileIdx].get();
+    ::size_t position = static_cast< ::size_t >( ( index % this->m_BlocksPerFile ) * sizeof ( TPixel ) * TimeSeriesVolumeBlockSize );
+    if ( position + sizeof ( CacheBlock ) <= mappedFile->GetSize() )
+      {
+      return reinterpret_cast<const CacheBlock*> ( mappedFile->GetData() + position );
+      }
+    }
   CacheBlock* Buffer = this->m_Cache.find ( index );
   if ( Buffer == 0 ) {
     // Fill it in
     CacheBlock B;
-    int FileIdx = this->CalculateFileIndex ( index );
 
     this->m_DatabaseFiles[FileIdx]->seekg ( this->CalculatePosition ( index, this->m_BlocksPerFile ) );
     this->m_DatabaseFiles[FileIdx]->read ( reinterpret_cast<char*> ( B.data ), TimeSeriesVolumeBlockSize * sizeof ( TPixel ) );
@@ -209,20 +239,162 @@ void TimeSeriesDatabase<TPixel>::GetVoxelTimeSeries ( typename OutputImageType::
   Size<3> CurrentBlock;
   Size<3> Offset;
   for ( int i = 0; i < 3; i++ ) {
-    if ( idx[i] < 0 || idx[i] > this->m_OutputRegion.Size[i] ) {
-      throw 1;
+    if ( idx[i] < 0 || idx[i] >= static_cast<IndexValueType>( this->m_Dimensions[i] ) ) {
+      itkExceptionMacro ( "TimeSeriesDatabase::GetVoxelTimeSeries: index " << idx << " is outside of the image" );
     }
-    CurrentBlock[i] = reinterpret_cast<unsigned long> ( idx[i] / (double)TimeSeriesBlockSize );
+    CurrentBlock[i] = idx[i] / TimeSeriesBlockSize;
     Offset[i] = idx[i] % TimeSeriesBlockSize;
   }
   unsigned long offset = Offset[0] + Offset[1] * TimeSeriesBlockSize + Offset[2] * TimeSeriesBlockSizeP2;
-  array = ArrayType ( this->m_Dimensions[3] );
-  for ( int volume = 0; volume < this->m_Dimensions[3]; volume++ ) {
-    CacheBlock* cache = this->GetCacheBlock ( CurrentBlock, volume );
+  array.SetSize ( this->m_Dimensions[3] );
+  for ( unsigned int volume = 0; volume < this->m_Dimensions[3]; volume++ ) {
+    const CacheBlock* cache = this->GetCacheBlock ( this->CalculateIndex ( CurrentBlock, volume ) );
     array[volume] = cache->data[offset];
   }
 }
 
+template <class TPixel>
+void TimeSeriesDatabase<TPixel>::AddVoxelToBlocks ( const typename OutputImageType::IndexType& idx, ::size_t voxelOrdinal, BlockVoxelsMap& blocks )
+{
+  Size<3> CurrentBlock;
+  for ( int i = 0; i < 3; i++ )
+    {
+    CurrentBlock[i] = idx[i] / TimeSeriesBlockSize;
+    }
+  unsigned long blockKey = CurrentBlock[0]
+    + CurrentBlock[1] * this->m_BlocksPerImage[0]
+    + CurrentBlock[2] * this->m_BlocksPerImage[0] * this->m_BlocksPerImage[1];
+  BlockVoxels& blockVoxels = blocks[blockKey];
+  blockVoxels.Block = CurrentBlock;
+  blockVoxels.BlockOffsets.push_back ( static_cast<unsigned int> ( idx[0] % TimeSeriesBlockSize
+    + ( idx[1] % TimeSeriesBlockSize ) * TimeSeriesBlockSize
+    + ( idx[2] % TimeSeriesBlockSize ) * TimeSeriesBlockSizeP2 ) );
+  blockVoxels.VoxelOrdinals.push_back ( voxelOrdinal );
+}
+
+template <class TPixel>
+void TimeSeriesDatabase<TPixel>::ExtractTimeSeries ( const BlockVoxelsMap& blocks, ::size_t numberOfVoxels, std::vector<TPixel>& timeSeries )
+{
+  const unsigned int numberOfVolumes = this->m_Dimensions[3];
+  timeSeries.resize ( numberOfVoxels * numberOfVolumes );
+  if ( numberOfVoxels == 0 )
+    {
+    return;
+    }
+  TPixel* output = &timeSeries[0];
+  // Visit each block once and read all its voxels for all volumes, so each
+  // block is only fetched once and is not evicted from the cache while it is needed.
+  for ( typename BlockVoxelsMap::const_iterator blockIt = blocks.begin(); blockIt != blocks.end(); ++blockIt )
+    {
+    const BlockVoxels& blockVoxels = blockIt->second;
+    const ::size_t numberOfBlockVoxels = blockVoxels.BlockOffsets.size();
+    for ( unsigned int volume = 0; volume < numberOfVolumes; volume++ )
+      {
+      const CacheBlock* block = this->GetCacheBlock ( this->CalculateIndex ( blockVoxels.Block, volume ) );
+      for ( ::size_t k = 0; k < numberOfBlockVoxels; k++ )
+        {
+        output[blockVoxels.VoxelOrdinals[k] * numberOfVolumes + volume] = block->data[blockVoxels.BlockOffsets[k]];
+        }
+      }
+    }
+}
+
+template <class TPixel>
+void TimeSeriesDatabase<TPixel>::GetRegionTimeSeries ( const typename OutputImageType::RegionType& region, std::vector<TPixel>& timeSeries )
+{
+  if ( !this->IsOpen() )
+    {
+    itkExceptionMacro ( "TimeSeriesDatabase::GetRegionTimeSeries: not open for reading" );
+    }
+  if ( !this->m_OutputRegion.IsInside ( region ) )
+    {
+    itkExceptionMacro ( "TimeSeriesDatabase::GetRegionTimeSeries: region " << region << " is outside of the image" );
+    }
+  BlockVoxelsMap blocks;
+  typename OutputImageType::IndexType idx;
+  const typename OutputImageType::IndexType& start = region.GetIndex();
+  const typename OutputImageType::SizeType& size = region.GetSize();
+  ::size_t voxelOrdinal = 0;
+  for ( idx[2] = start[2]; idx[2] < start[2] + static_cast<IndexValueType>( size[2] ); idx[2]++ )
+    {
+    for ( idx[1] = start[1]; idx[1] < start[1] + static_cast<IndexValueType>( size[1] ); idx[1]++ )
+      {
+      for ( idx[0] = start[0]; idx[0] < start[0] + static_cast<IndexValueType>( size[0] ); idx[0]++ )
+        {
+        this->AddVoxelToBlocks ( idx, voxelOrdinal++, blocks );
+        }
+      }
+    }
+  this->ExtractTimeSeries ( blocks, voxelOrdinal, timeSeries );
+}
+
+template <class TPixel>
+template <class TMaskImage>
+void TimeSeriesDatabase<TPixel>::GetMaskedTimeSeries ( const TMaskImage* mask, typename TMaskImage::PixelType label, std::vector<TPixel>& timeSeries,
+                                                       std::vector<typename OutputImageType::IndexType>* voxelIndices )
+{
+  if ( !this->IsOpen() )
+    {
+    itkExceptionMacro ( "TimeSeriesDatabase::GetMaskedTimeSeries: not open for reading" );
+    }
+  if ( !mask || mask->GetBufferedRegion().GetSize() != this->m_OutputRegion.GetSize() )
+    {
+    itkExceptionMacro ( "TimeSeriesDatabase::GetMaskedTimeSeries: mask size does not match the image size" );
+    }
+  if ( voxelIndices )
+    {
+    voxelIndices->clear();
+    }
+  BlockVoxelsMap blocks;
+  ::size_t voxelOrdinal = 0;
+  ImageRegionConstIteratorWithIndex<TMaskImage> it ( mask, mask->GetBufferedRegion() );
+  const typename TMaskImage::IndexType maskStart = mask->GetBufferedRegion().GetIndex();
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != label )
+      {
+      continue;
+      }
+    typename OutputImageType::IndexType idx;
+    for ( int i = 0; i < 3; i++ )
+      {
+      idx[i] = it.GetIndex()[i] - maskStart[i];
+      }
+    this->AddVoxelToBlocks ( idx, voxelOrdinal++, blocks );
+    if ( voxelIndices )
+      {
+      voxelIndices->push_back ( idx );
+      }
+    }
+  this->ExtractTimeSeries ( blocks, voxelOrdinal, timeSeries );
+}
+
+template <class TPixel>
+void TimeSeriesDatabase<TPixel>::PrefetchImage ( unsigned int image )
+{
+  if ( this->m_MappedFiles.empty() || image >= this->m_Dimensions[3] )
+    {
+    return;
+    }
+  // Blocks of an image are stored consecutively, but may be split between files
+  Size<3> FirstBlock = {{ 0, 0, 0 }};
+  unsigned long firstIndex = this->CalculateIndex ( FirstBlock, image );
+  unsigned long endIndex = firstIndex + this->m_BlocksPerImage[0] * this->m_BlocksPerImage[1] * this->m_BlocksPerImage[2];
+  const ::size_t blockBytes = sizeof ( TPixel ) * TimeSeriesVolumeBlockSize;
+  unsigned long index = firstIndex;
+  while ( index < endIndex )
+    {
+    unsigned int FileIdx = this->CalculateFileIndex ( index );
+    if ( FileIdx >= this->m_MappedFiles.size() )
+      {
+      break;
+      }
+    unsigned long fileEndIndex = TSD_MIN<unsigned long> ( endIndex, ( FileIdx + 1 ) * this->m_BlocksPerFile );
+    this->m_MappedFiles[FileIdx]->WillNeed ( ( index % this->m_BlocksPerFile ) * blockBytes, ( fileEndIndex - index ) * blockBytes );
+    index = fileEndIndex;
+    }
+}
+
 
 template <class TPixel>
 void TimeSeriesDatabase<TPixel>::GenerateOutputInformation ( )
@@ -275,7 +447,7 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
         typename OutputImageType::RegionType BR, IR;
         if ( print ) {  std::cout << "For Block Index: " << CurrentBlock << std::endl; }
         unsigned long index = this->CalculateIndex ( CurrentBlock, this->m_CurrentImage );
-        CacheBlock* Buffer = this->GetCacheBlock ( index );
+        const CacheBlock* Buffer = this->GetCacheBlock ( index );
         if ( this->CalculateIntersection ( CurrentBlock, Region, BR, IR ) ) {
           // Just iterate over whole block
           // Good we can use an iterator!
@@ -290,7 +462,7 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
           BlockRegion.SetIndex ( BlockIndex );
           ImageRegionIterator<OutputImageType> it ( output, IR );
           it.GoToBegin();
-          TPixel* ptr = Buffer->data;
+          const TPixel* ptr = Buffer->data;
           while ( !it.IsAtEnd() ) {
             it.Set ( *ptr );
             ++it;
@@ -334,7 +506,11 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
       }
     }
 
-  return;
+  // Let the operating system read the next images while this one is processed
+  for ( unsigned int i = 1; i <= this->m_NumberOfPrefetchedImages; i++ )
+    {
+    this->PrefetchImage ( this->m_CurrentImage + i );
+    }
 }
 
 
@@ -569,14 +745,15 @@ void TimeSeriesDatabase<TPixel>::SetCacheSizeInMiB ( float sz )
 {
   // How many blocks is this?
   double BlockSizeInMiB = sizeof ( TPixel ) * TimeSeriesVolumeBlockSize / ( 1024*1024.);
-  unsigned long int blocks = (unsigned long int) ceil ( sz * BlockSizeInMiB );
+  unsigned long int blocks = (unsigned long int) ceil ( sz / BlockSizeInMiB );
   this->m_Cache.set_maxsize ( blocks );
 }
 
 
 
 template <class TPixel>
-TimeSeriesDatabase<TPixel>::TimeSeriesDatabase () : m_Cache ( 1024 ){
+TimeSeriesDatabase<TPixel>::TimeSeriesDatabase ()
+  : m_CurrentImage ( 0 ), m_BlocksPerFile ( 1 ), m_UseMemoryMapping ( true ), m_NumberOfPrefetchedImages ( 1 ), m_Cache ( 1024 ){
   this->m_Dimensions.SetSize ( 4 );
   this->m_BlocksPerImage.SetSize ( 4 );
 }
@@ -601,9 +778,12 @@ TimeSeriesDatabase<TPixel>
   os << indent << "OutputRegion: " << m_OutputRegion;
   os << indent << "OutputOrigin: " << m_OutputOrigin << "\n";
   os << indent << "OutputDirection: " << m_OutputDirection << "\n";
+  os << indent << "UseMemoryMapping: " << m_UseMemoryMapping << "\n";
+  os << indent << "NumberOfPrefetchedImages: " << m_NumberOfPrefetchedImages << "\n";
   if ( this->IsOpen() ) {
     os << indent << "Database is open." << "\n";
     os << indent << "Blocks per file: " << this->m_BlocksPerFile << "\n";
+    os << indent << "Memory mapped: " << ( this->m_MappedFiles.empty() ? "no" : "yes" ) << "\n";
     os << indent << "File names: " << "\n";
     for ( ::size_t idx = 0; idx < this->m_DatabaseFileNames.size(); idx++ )
       {
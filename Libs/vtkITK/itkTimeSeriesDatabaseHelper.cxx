@@ -0,0 +1,155 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   vtkITK
+
+==========================================================================*/
+
+#include "itkTimeSeriesDatabaseHelper.h"
+
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace itk {
+  namespace TimeSeriesDatabaseHelper {
+
+//----------------------------------------------------------------------------
+MappedFile::MappedFile()
+  : Data(0)
+  , Size(0)
+#ifdef _WIN32
+  , FileHandle(0)
+  , MappingHandle(0)
+#endif
+{
+}
+
+//----------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+  this->Close();
+}
+
+//----------------------------------------------------------------------------
+bool MappedFile::Open(const char* filename)
+{
+  this->Close();
+  if (!filename)
+    {
+    return false;
+    }
+#ifdef _WIN32
+  HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+    {
+    return false;
+    }
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0
+    || static_cast<unsigned long long>(fileSize.QuadPart) > static_cast<size_t>(-1))
+    {
+    CloseHandle(file);
+    return false;
+    }
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (!mapping)
+    {
+    CloseHandle(file);
+    return false;
+    }
+  void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!data)
+    {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+    }
+  this->FileHandle = file;
+  this->MappingHandle = mapping;
+  this->Data = static_cast<const char*>(data);
+  this->Size = static_cast<size_t>(fileSize.QuadPart);
+#else
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    {
+    return false;
+    }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0)
+    {
+    close(fd);
+    return false;
+    }
+  size_t size = static_cast<size_t>(fileStat.st_size);
+  void* data = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping keeps a reference to the file, the descriptor is not needed anymore
+  close(fd);
+  if (data == MAP_FAILED)
+    {
+    return false;
+    }
+  this->Data = static_cast<const char*>(data);
+  this->Size = size;
+#endif
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void MappedFile::Close()
+{
+  if (!this->Data)
+    {
+    return;
+    }
+#ifdef _WIN32
+  UnmapViewOfFile(this->Data);
+  CloseHandle(static_cast<HANDLE>(this->MappingHandle));
+  CloseHandle(static_cast<HANDLE>(this->FileHandle));
+  this->MappingHandle = 0;
+  this->FileHandle = 0;
+#else
+  munmap(const_cast<char*>(this->Data), this->Size);
+#endif
+  this->Data = 0;
+  this->Size = 0;
+}
+
+//----------------------------------------------------------------------------
+void MappedFile::WillNeed(size_t offset, size_t length) const
+{
+  if (!this->Data || offset >= this->Size)
+    {
+    return;
+    }
+  if (length > this->Size - offset)
+    {
+    length = this->Size - offset;
+    }
+#ifndef _WIN32
+  // madvise requires a page aligned start address
+  size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t alignedOffset = offset - offset % pageSize;
+  madvise(const_cast<char*>(this->Data) + alignedOffset, length + (offset - alignedOffset), MADV_WILLNEED);
+#else
+  // Pages are read on first access (PrefetchVirtualMemory is not available on all supported Windows versions)
+  (void)offset;
+  (void)length;
+#endif
+}
+
+  } // end namespace TimeSeriesDatabaseHelper
+} // end namespace itk
@@ -6,9 +6,51 @@
 #include <string>
 #include <cstdarg>
 #include <cassert>
+#include <cstddef>
+
+#include "vtkITKWin32Header.h"
 
 namespace itk {
   namespace TimeSeriesDatabaseHelper {
+    /// Read-only memory mapping of a file.
+    ///
+    /// Pages of the mapped file are loaded on demand by the operating system
+    /// and are shared by all readers of the same file, therefore files
+    /// larger than the physical memory can be accessed without copying
+    /// them into a private cache.
+    class VTK_ITK_EXPORT MappedFile
+      {
+      public:
+        MappedFile();
+        ~MappedFile();
+
+        /// Map the whole file into memory. Returns false if the file
+        /// cannot be mapped (in that case regular file reading must be used).
+        bool Open(const char* filename);
+        void Close();
+        bool IsOpen() const { return this->Data != 0; }
+
+        /// Start of the mapped file content (NULL if not open)
+        const char* GetData() const { return this->Data; }
+        /// Size of the mapped file in bytes
+        size_t GetSize() const { return this->Size; }
+
+        /// Ask the operating system to read the given range of the file
+        /// in the background, so that a later access does not need to wait for the disk.
+        void WillNeed(size_t offset, size_t length) const;
+
+      private:
+        MappedFile(const MappedFile&); /// Not implemented.
+        void operator=(const MappedFile&); /// Not implemented.
+
+        const char* Data;
+        size_t Size;
+#ifdef _WIN32
+        void* FileHandle;
+        void* MappingHandle;
+#endif
+      };
+
     /// Some useful classes
     /*
      * counted_ptr - simple reference counted pointer.
@@ -21,7 +21,9 @@
 #include <vtkMatrix4x4.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
+#include <vtkMultiThreader.h>
 #include <vtkObjectFactory.h>
+#include <vtkSimpleCriticalSection.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 
 // ITK includes
@@ -30,7 +32,13 @@
 #include <itkMetaDataObject.h>
 #include <itkTimeProbe.h>
 
+// GDCM includes
+#include <gdcmReader.h>
+
 // STD includes
+#include <algorithm>
+#include <map>
+#include <set>
 #include <vector>
 
 #include "itkArchetypeSeriesFileNames.h"
@@ -41,6 +49,170 @@
 
 vtkStandardNewMacro(vtkITKArchetypeImageSeriesReader);
 
+namespace
+{
+
+/// DICOM tags used for grouping and sorting the files
+enum DICOMHeaderTagIndex
+{
+  SeriesInstanceUIDTag = 0,
+  ContentTimeTag,
+  TriggerTimeTag,
+  EchoNumbersTag,
+  DiffusionGradientOrientationTag,
+  SliceLocationTag,
+  ImageOrientationPatientTag,
+  ImagePositionPatientTag,
+  NumberOfDICOMHeaderTags
+};
+
+const gdcm::Tag DICOMHeaderTags[NumberOfDICOMHeaderTags] =
+{
+  gdcm::Tag(0x0020, 0x000e), // series instance UID
+  gdcm::Tag(0x0008, 0x0033), // content time
+  gdcm::Tag(0x0018, 0x1060), // trigger time
+  gdcm::Tag(0x0018, 0x0086), // echo numbers
+  gdcm::Tag(0x0010, 0x9089), // diffusion gradient orientation
+  gdcm::Tag(0x0020, 0x1041), // slice location
+  gdcm::Tag(0x0020, 0x0037), // image orientation patient
+  gdcm::Tag(0x0020, 0x0032)  // image position patient
+};
+
+/// Reading of the header is stopped at this tag, as all the tags above precede it
+const gdcm::Tag DICOMHeaderLastTag(0x0020, 0x1042);
+
+//----------------------------------------------------------------------------
+struct DICOMHeaderValues
+{
+  DICOMHeaderValues() : ModifiedTime(0), FileSize(0) {}
+  long int ModifiedTime;
+  unsigned long FileSize;
+  std::string Values[NumberOfDICOMHeaderTags];
+};
+
+/// Tag values of the files that have been scanned,
+/// valid as long as the modification time and size of the file are unchanged.
+std::map<std::string, DICOMHeaderValues> DICOMHeaderCache;
+vtkSimpleCriticalSection DICOMHeaderCacheLock;
+/// The cache is emptied when it gets larger than this
+const size_t DICOMHeaderCacheMaximumSize = 200000;
+
+//----------------------------------------------------------------------------
+/// Read the tag values from the beginning of the file, without reading the rest
+/// of the header or the pixel data.
+void ReadDICOMHeaderValues(const std::string& fileName, DICOMHeaderValues& header)
+{
+  gdcm::Reader reader;
+  reader.SetFileName(fileName.c_str());
+  std::set<gdcm::Tag> skipTags;
+  if (!reader.ReadUpToTag(DICOMHeaderLastTag, skipTags))
+    {
+    return;
+    }
+  const gdcm::DataSet& dataSet = reader.GetFile().GetDataSet();
+  for (int tagIndex = 0; tagIndex < NumberOfDICOMHeaderTags; tagIndex++)
+    {
+    if (!dataSet.FindDataElement(DICOMHeaderTags[tagIndex]))
+      {
+      continue;
+      }
+    const gdcm::ByteValue* value = dataSet.GetDataElement(DICOMHeaderTags[tagIndex]).GetByteValue();
+    if (!value || !value->GetPointer())
+      {
+      continue;
+      }
+    std::string valueStr(value->GetPointer(), value->GetLength());
+    // remove padding
+    size_t valueEnd = valueStr.find_last_not_of(std::string(" \0", 2));
+    valueStr.erase(valueEnd == std::string::npos ? 0 : valueEnd + 1);
+    header.Values[tagIndex] = valueStr;
+    }
+}
+
+//----------------------------------------------------------------------------
+struct DICOMHeaderScanData
+{
+  const std::vector<std::string>* FileNames;
+  std::vector<DICOMHeaderValues>* Headers;
+  /// Files that are not in the cache
+  std::vector<size_t> FilesToScan;
+};
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE ScanDICOMHeadersThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  DICOMHeaderScanData* data = static_cast<DICOMHeaderScanData*>(info->UserData);
+  for (size_t i = info->ThreadID; i < data->FilesToScan.size(); i += info->NumberOfThreads)
+    {
+    size_t fileIndex = data->FilesToScan[i];
+    ReadDICOMHeaderValues((*data->FileNames)[fileIndex], (*data->Headers)[fileIndex]);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+/// Get tag values of all the files, scanning the files that are not in the cache in parallel
+void ScanDICOMHeaders(const std::vector<std::string>& fileNames, std::vector<DICOMHeaderValues>& headers)
+{
+  headers.clear();
+  headers.resize(fileNames.size());
+
+  DICOMHeaderScanData data;
+  data.FileNames = &fileNames;
+  data.Headers = &headers;
+
+  DICOMHeaderCacheLock.Lock();
+  for (size_t f = 0; f < fileNames.size(); f++)
+    {
+    headers[f].ModifiedTime = itksys::SystemTools::ModifiedTime(fileNames[f].c_str());
+    headers[f].FileSize = itksys::SystemTools::FileLength(fileNames[f].c_str());
+    std::map<std::string, DICOMHeaderValues>::iterator cachedHeader = DICOMHeaderCache.find(fileNames[f]);
+    if (cachedHeader != DICOMHeaderCache.end()
+      && cachedHeader->second.ModifiedTime == headers[f].ModifiedTime
+      && cachedHeader->second.FileSize == headers[f].FileSize)
+      {
+      headers[f] = cachedHeader->second;
+      }
+    else
+      {
+      data.FilesToScan.push_back(f);
+      }
+    }
+  DICOMHeaderCacheLock.Unlock();
+
+  if (data.FilesToScan.empty())
+    {
+    return;
+    }
+
+  // Reading the headers is mostly waiting for the (network) file system,
+  // therefore it is worth using threads even for a small number of files.
+  int numberOfThreads = std::min(vtkMultiThreader::GetGlobalDefaultNumberOfThreads(), VTK_MAX_THREADS);
+  if (static_cast<size_t>(numberOfThreads) > data.FilesToScan.size())
+    {
+    numberOfThreads = static_cast<int>(data.FilesToScan.size());
+    }
+  vtkMultiThreader* threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(std::max(numberOfThreads, 1));
+  threader->SetSingleMethod(ScanDICOMHeadersThreadFunction, &data);
+  threader->SingleMethodExecute();
+  threader->Delete();
+
+  DICOMHeaderCacheLock.Lock();
+  if (DICOMHeaderCache.size() + data.FilesToScan.size() > DICOMHeaderCacheMaximumSize)
+    {
+    DICOMHeaderCache.clear();
+    }
+  for (std::vector<size_t>::iterator f = data.FilesToScan.begin(); f != data.FilesToScan.end(); ++f)
+    {
+    DICOMHeaderCache[fileNames[*f]] = headers[*f];
+    }
+  DICOMHeaderCacheLock.Unlock();
+}
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 vtkITKArchetypeImageSeriesReader::vtkITKArchetypeImageSeriesReader()
 {
@@ -1041,16 +1213,15 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
   // if Archetype is a Dicom File
-  gdcmIO->SetFileName( this->Archetype );
+  std::vector<DICOMHeaderValues> headers;
+  ScanDICOMHeaders(this->AllFileNames, headers);
   for (int f = 0; f < nFiles; f++)
   {
-    gdcmIO->SetFileName( this->AllFileNames[f] );
-    gdcmIO->ReadImageInformation();
-    itk::MetaDataDictionary &dict = gdcmIO->GetMetaDataDictionary();
+    const std::string* tagValues = headers[f].Values;
     std::string tagValue;
 
     // series instance UID
-    tagValue.clear(); itk::ExposeMetaData<std::string>( dict, "0020|000e", tagValue );
+    tagValue = tagValues[SeriesInstanceUIDTag];
     if ( tagValue.length() > 0 )
     {
       int idx = InsertSeriesInstanceUIDs( tagValue.c_str() );
@@ -1062,7 +1233,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // content time
-    tagValue.clear(); itk::ExposeMetaData<std::string>( dict, "0008|0033", tagValue );
+    tagValue = tagValues[ContentTimeTag];
     if ( tagValue.length() > 0 )
     {
       int idx = InsertContentTime( tagValue.c_str() );
@@ -1074,7 +1245,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // trigger time
-    tagValue.clear(); itk::ExposeMetaData<std::string>( dict, "0018|1060", tagValue );
+    tagValue = tagValues[TriggerTimeTag];
     if ( tagValue.length() > 0 )
     {
       int idx = InsertTriggerTime( tagValue.c_str() );
@@ -1086,7 +1257,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // echo numbers
-    tagValue.clear(); itk::ExposeMetaData<std::string>( dict, "0018|0086", tagValue );
+    tagValue = tagValues[EchoNumbersTag];
     if ( tagValue.length() > 0 )
     {
       int idx = InsertEchoNumbers( tagValue.c_str() );
@@ -1098,7 +1269,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // diffision gradient orientation
-    tagValue.clear(); itk::ExposeMetaData<std::string>( dict, "0010|9089", tagValue );
+    tagValue = tagValues[DiffusionGradientOrientationTag];
     if ( tagValue.length() > 0 )
     {
       float a[3];
@@ -1112,7 +1283,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // slice location
-    tagValue.clear(); itk::ExposeMetaData<std::string>( dict, "0020|1041", tagValue );
+    tagValue = tagValues[SliceLocationTag];
     if ( tagValue.length() > 0 )
     {
       float a;
@@ -1126,7 +1297,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // image orientation patient
-    tagValue.clear(); itk::ExposeMetaData<std::string>( dict, "0020|0037", tagValue );
+    tagValue = tagValues[ImageOrientationPatientTag];
     if ( tagValue.length() > 0 )
     {
       float a[6];
@@ -1139,7 +1310,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       this->IndexImageOrientationPatient[f] = -1;
     }
     // image position patient
-    tagValue.clear(); itk::ExposeMetaData<std::string>( dict, "0020|0032", tagValue );
+    tagValue = tagValues[ImagePositionPatientTag];
     if( tagValue.length() > 0 )
     {
         float a[3];
@@ -1160,6 +1331,14 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
   return;
 }
 
+//----------------------------------------------------------------------------
+void vtkITKArchetypeImageSeriesReader::ClearDICOMHeaderCache()
+{
+  DICOMHeaderCacheLock.Lock();
+  DICOMHeaderCache.clear();
+  DICOMHeaderCacheLock.Unlock();
+}
+
 //----------------------------------------------------------------------------
 const itk::MetaDataDictionary&
 vtkITKArchetypeImageSeriesReader
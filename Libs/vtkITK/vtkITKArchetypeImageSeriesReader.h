@@ -50,6 +50,13 @@ public:
 
   typedef itk::SpatialOrientation::ValidCoordinateOrientationFlags CoordinateOrientationCode;
 
+  ///
+  /// DICOM header values that are used for grouping and sorting the files are
+  /// cached for all reader instances, so that the files are not scanned again
+  /// while their modification time and size are unchanged.
+  /// This method removes all files from the cache.
+  static void ClearDICOMHeaderCache();
+
   ///
   /// Specify the archetype filename for the series.
   vtkSetStringMacro(Archetype);
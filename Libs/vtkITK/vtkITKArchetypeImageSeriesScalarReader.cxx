@@ -21,15 +21,23 @@
 #include <vtkImageData.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
+#include <vtkMultiThreader.h>
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkVersion.h>
 
 // ITK includes
+#include <itkImageIOFactory.h>
 #include <itkOrientImageFilter.h>
 #include <itkImageSeriesReader.h>
 
+// STD includes
+#include <algorithm>
+#include <typeinfo>
+#include <vector>
+
 vtkStandardNewMacro(vtkITKArchetypeImageSeriesScalarReader);
 
 namespace {
@@ -40,6 +48,157 @@ vtkAOSDataArrayTemplate<T>* DownCast(vtkAbstractArray* a)
   return vtkAOSDataArrayTemplate<T>::FastDownCast(a);
 }
 
+//----------------------------------------------------------------------------
+template <class T>
+struct SliceDecodingData
+{
+  const std::vector<std::string>* FileNames;
+  /// One image IO per thread
+  std::vector<itk::ImageIOBase::Pointer> ImageIOs;
+  /// Slices [FirstSlice, FirstSlice + SliceStatus.size()) are decoded
+  size_t FirstSlice;
+  T* Buffer;
+  itk::SizeValueType NumberOfPixelsPerSlice;
+  std::vector<int> SliceStatus;
+};
+
+//----------------------------------------------------------------------------
+/// Decode slices directly into their position in the volume buffer.
+/// A slice fails if its pixel type or size does not match the volume.
+template <class T>
+VTK_THREAD_RETURN_TYPE DecodeSlicesThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  SliceDecodingData<T>* data = static_cast<SliceDecodingData<T>*>(info->UserData);
+  itk::ImageIOBase* imageIO = data->ImageIOs[info->ThreadID];
+  for (size_t i = info->ThreadID; i < data->SliceStatus.size(); i += info->NumberOfThreads)
+    {
+    size_t slice = data->FirstSlice + i;
+    try
+      {
+      imageIO->SetFileName((*data->FileNames)[slice]);
+      imageIO->ReadImageInformation();
+      if (imageIO->GetComponentTypeInfo() != typeid(T)
+        || imageIO->GetNumberOfComponents() != 1
+        || imageIO->GetImageSizeInPixels() != data->NumberOfPixelsPerSlice)
+        {
+        continue;
+        }
+      itk::ImageIORegion ioRegion(imageIO->GetNumberOfDimensions());
+      for (unsigned int dim = 0; dim < imageIO->GetNumberOfDimensions(); dim++)
+        {
+        ioRegion.SetSize(dim, imageIO->GetDimensions(dim));
+        }
+      imageIO->SetIORegion(ioRegion);
+      imageIO->Read(data->Buffer + slice * data->NumberOfPixelsPerSlice);
+      data->SliceStatus[i] = 1;
+      }
+    catch (itk::ExceptionObject&)
+      {
+      // the series is read by the series reader instead
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+int GetNumberOfSliceDecodingThreads(size_t numberOfSlices)
+{
+  int numberOfThreads = std::min(vtkMultiThreader::GetGlobalDefaultNumberOfThreads(), VTK_MAX_THREADS);
+  if (static_cast<size_t>(numberOfThreads) > numberOfSlices)
+    {
+    numberOfThreads = static_cast<int>(numberOfSlices);
+    }
+  return std::max(numberOfThreads, 1);
+}
+
+//----------------------------------------------------------------------------
+/// Decode \a numberOfSlices slices starting at \a firstSlice into \a buffer,
+/// which points to the first voxel of the volume.
+/// Returns false if any of the slices cannot be decoded directly.
+template <class T>
+bool DecodeSlices(const std::vector<std::string>& fileNames, size_t firstSlice, size_t numberOfSlices,
+                  T* buffer, itk::SizeValueType numberOfPixelsPerSlice, int numberOfThreads)
+{
+  SliceDecodingData<T> data;
+  try
+    {
+    for (int thread = 0; thread < numberOfThreads; thread++)
+      {
+      itk::ImageIOBase::Pointer imageIO = itk::ImageIOFactory::CreateImageIO(
+        fileNames[firstSlice].c_str(), itk::ImageIOFactory::ReadMode);
+      if (imageIO.IsNull())
+        {
+        return false;
+        }
+      data.ImageIOs.push_back(imageIO);
+      }
+    }
+  catch (itk::ExceptionObject&)
+    {
+    return false;
+    }
+  data.FileNames = &fileNames;
+  data.FirstSlice = firstSlice;
+  data.Buffer = buffer;
+  data.NumberOfPixelsPerSlice = numberOfPixelsPerSlice;
+  data.SliceStatus.resize(numberOfSlices, 0);
+
+  vtkNew<vtkMultiThreader> threader;
+  threader->SetNumberOfThreads(numberOfThreads);
+  threader->SetSingleMethod(DecodeSlicesThreadFunction<T>, &data);
+  threader->SingleMethodExecute();
+
+  return std::find(data.SliceStatus.begin(), data.SliceStatus.end(), 0) == data.SliceStatus.end();
+}
+
+//----------------------------------------------------------------------------
+/// Read the slices of the series in parallel into a volume that has the geometry
+/// computed by the series reader. Returns NULL if any of the slices cannot be
+/// decoded directly into the volume (the series reader has to be used then).
+template <class T>
+typename itk::Image<T,3>::Pointer ReadSlicesInParallel(
+  itk::ImageSeriesReader<itk::Image<T,3> >* seriesReader, const std::vector<std::string>& fileNames)
+{
+  typedef itk::Image<T,3> ImageType;
+  if (fileNames.size() < 2)
+    {
+    return NULL;
+    }
+  int numberOfThreads = GetNumberOfSliceDecodingThreads(fileNames.size());
+  if (numberOfThreads < 2)
+    {
+    return NULL;
+    }
+
+  typename ImageType::Pointer image = ImageType::New();
+  try
+    {
+    seriesReader->UpdateOutputInformation();
+    typename ImageType::RegionType region = seriesReader->GetOutput()->GetLargestPossibleRegion();
+    if (region.GetSize()[2] != fileNames.size())
+      {
+      return NULL;
+      }
+    image->CopyInformation(seriesReader->GetOutput());
+    image->SetRegions(region);
+    image->Allocate();
+    }
+  catch (itk::ExceptionObject&)
+    {
+    return NULL;
+    }
+
+  itk::SizeValueType numberOfPixelsPerSlice =
+    image->GetLargestPossibleRegion().GetSize()[0] * image->GetLargestPossibleRegion().GetSize()[1];
+  if (!DecodeSlices<T>(fileNames, 0, fileNames.size(),
+                       image->GetBufferPointer(), numberOfPixelsPerSlice, numberOfThreads))
+    {
+    return NULL;
+    }
+  return image;
+}
+
 };
 
 //----------------------------------------------------------------------------
@@ -100,6 +259,7 @@ int vtkITKArchetypeImageSeriesScalarReader::RequestData(
           reader##typeN->AddObserver(itk::ProgressEvent(),pcl); \
       reader##typeN->SetFileNames(this->FileNames); \
       reader##typeN->ReleaseDataFlagOn(); \
+      image##typeN::Pointer slices##typeN = ReadSlicesInParallel<type>(reader##typeN, this->FileNames); \
       if (this->UseNativeCoordinateOrientation) \
         { \
         filter = reader##typeN; \
@@ -109,14 +269,19 @@ int vtkITKArchetypeImageSeriesScalarReader::RequestData(
         itk::OrientImageFilter<image##typeN,image##typeN>::Pointer orient##typeN = \
             itk::OrientImageFilter<image##typeN,image##typeN>::New(); \
         if (this->Debug) {orient##typeN->DebugOn();} \
-        orient##typeN->SetInput(reader##typeN->GetOutput()); \
+        orient##typeN->SetInput(slices##typeN.IsNotNull() ? slices##typeN.GetPointer() : reader##typeN->GetOutput()); \
         orient##typeN->UseImageDirectionOn(); \
         orient##typeN->SetDesiredCoordinateOrientation(this->DesiredCoordinateOrientation); \
         filter = orient##typeN; \
         }\
-      filter->UpdateLargestPossibleRegion(); \
+      image##typeN::Pointer output##typeN = slices##typeN; \
+      if (slices##typeN.IsNull() || !this->UseNativeCoordinateOrientation) \
+        { \
+        filter->UpdateLargestPossibleRegion(); \
+        output##typeN = filter->GetOutput(); \
+        } \
       itk::ImportImageContainer<itk::SizeValueType, type>::Pointer PixelContainer##typeN;\
-      PixelContainer##typeN = filter->GetOutput()->GetPixelContainer();\
+      PixelContainer##typeN = output##typeN->GetPixelContainer();\
       void *ptr = static_cast<void *> (PixelContainer##typeN->GetBufferPointer());\
       DownCast<type>(data->GetPointData()->GetScalars())                \
         ->SetVoidArray(ptr, PixelContainer##typeN->Size(), 0,\
@@ -215,6 +380,52 @@ int vtkITKArchetypeImageSeriesScalarReader::RequestData(
 }
 
 
+//----------------------------------------------------------------------------
+bool vtkITKArchetypeImageSeriesScalarReader::ReadSlices(vtkImageData* image, int firstSlice, int lastSlice)
+{
+  int* extent = image ? image->GetExtent() : NULL;
+  if (image == NULL
+    || image->GetPointData()->GetScalars() == NULL
+    || image->GetScalarType() != this->OutputScalarType
+    || image->GetNumberOfScalarComponents() != 1
+    || this->NumberOfComponents != 1
+    || this->FileNames.size() < 2
+    || static_cast<size_t>(extent[5] - extent[4] + 1) != this->FileNames.size()
+    || firstSlice < 0 || lastSlice < firstSlice
+    || static_cast<size_t>(lastSlice) >= this->FileNames.size())
+    {
+    return false;
+    }
+  size_t numberOfSlices = static_cast<size_t>(lastSlice - firstSlice + 1);
+  itk::SizeValueType numberOfPixelsPerSlice =
+    static_cast<itk::SizeValueType>(extent[1] - extent[0] + 1) * (extent[3] - extent[2] + 1);
+  int numberOfThreads = GetNumberOfSliceDecodingThreads(numberOfSlices);
+  void* buffer = image->GetScalarPointer();
+
+#define vtkITKReadSlices(typeN, type) \
+    case typeN: \
+      return DecodeSlices<type>(this->FileNames, firstSlice, numberOfSlices, \
+        static_cast<type*>(buffer), numberOfPixelsPerSlice, numberOfThreads)
+
+  switch (this->OutputScalarType)
+    {
+    vtkITKReadSlices(VTK_DOUBLE, double);
+    vtkITKReadSlices(VTK_FLOAT, float);
+    vtkITKReadSlices(VTK_LONG, long);
+    vtkITKReadSlices(VTK_UNSIGNED_LONG, unsigned long);
+    vtkITKReadSlices(VTK_INT, int);
+    vtkITKReadSlices(VTK_UNSIGNED_INT, unsigned int);
+    vtkITKReadSlices(VTK_SHORT, short);
+    vtkITKReadSlices(VTK_UNSIGNED_SHORT, unsigned short);
+    vtkITKReadSlices(VTK_CHAR, char);
+    vtkITKReadSlices(VTK_UNSIGNED_CHAR, unsigned char);
+    default:
+      return false;
+    }
+#undef vtkITKReadSlices
+}
+
+//----------------------------------------------------------------------------
 void vtkITKArchetypeImageSeriesScalarReader::ReadProgressCallback(itk::ProcessObject* obj,const itk::ProgressEvent&,void* data)
 {
   vtkITKArchetypeImageSeriesScalarReader* me=reinterpret_cast<vtkITKArchetypeImageSeriesScalarReader*>(data);
@@ -26,6 +26,15 @@ class VTK_ITK_EXPORT vtkITKArchetypeImageSeriesScalarReader : public vtkITKArche
   vtkTypeMacro(vtkITKArchetypeImageSeriesScalarReader,vtkITKArchetypeImageSeriesReader);
   void PrintSelf(ostream& os, vtkIndent indent);
 
+  /// Decode the slices \a firstSlice to \a lastSlice of a series of single
+  /// component files directly into the scalars of \a image, in parallel.
+  /// \a image must be allocated with the extent and scalar type of the output
+  /// information (UpdateInformation() must be called first).
+  /// Returns false if the slices cannot be decoded directly into the image
+  /// (e.g. single file, different pixel type or slice size), Update() must
+  /// be used then.
+  bool ReadSlices(vtkImageData* image, int firstSlice, int lastSlice);
+
  protected:
   vtkITKArchetypeImageSeriesScalarReader();
   ~vtkITKArchetypeImageSeriesScalarReader();
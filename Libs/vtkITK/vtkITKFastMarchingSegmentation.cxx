@@ -0,0 +1,887 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+
+#include "vtkITKFastMarchingSegmentation.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkITKFastMarchingSegmentation);
+
+namespace
+{
+
+enum VoxelStatus
+  {
+  Far = 0,
+  Trial,
+  Known,
+  Fixed ///< border of the image and voxels of the other labels
+  };
+
+/// Arrival time of the voxels the front has not reached.
+const float FAR_TIME = VTK_FLOAT_MAX;
+
+/// Number of voxels the region is grown by at least, on each side that
+/// the front gets close to.
+const int REGION_GROWTH = 16;
+
+//-----------------------------------------------------------------------------
+/// Median and inhomogeneity (difference between the 21st and the 5th of the
+/// 27 sorted values) of the 3x3x3 neighborhood of a voxel.
+template <class T>
+void vtkITKFastMarchingNeighborhoodStatistics(const void* intensity,
+  vtkIdType index, const vtkIdType offsets[27], double& median, double& inhomogeneity)
+{
+  const T* ptr = static_cast<const T*>(intensity) + index;
+  double values[27];
+  for (int n = 0; n < 27; ++n)
+    {
+    values[n] = static_cast<double>(ptr[offsets[n]]);
+    }
+  std::sort(values, values + 27);
+  median = values[13];
+  inhomogeneity = values[21] - values[5];
+}
+
+//-----------------------------------------------------------------------------
+/// Bounding box of the voxels equal to \a label, in voxel coordinates.
+template <class T>
+bool vtkITKFastMarchingSeedBounds(const T* labels, const int dims[3], int label, int bounds[6])
+{
+  bool found = false;
+  bounds[0] = bounds[2] = bounds[4] = VTK_INT_MAX;
+  bounds[1] = bounds[3] = bounds[5] = -1;
+  const T seedLabel = static_cast<T>(label);
+  for (int k = 0; k < dims[2]; ++k)
+    {
+    for (int j = 0; j < dims[1]; ++j)
+      {
+      for (int i = 0; i < dims[0]; ++i, ++labels)
+        {
+        if (*labels != seedLabel)
+          {
+          continue;
+          }
+        found = true;
+        bounds[0] = std::min(bounds[0], i);
+        bounds[1] = std::max(bounds[1], i);
+        bounds[2] = std::min(bounds[2], j);
+        bounds[3] = std::max(bounds[3], j);
+        bounds[4] = std::min(bounds[4], k);
+        bounds[5] = std::max(bounds[5], k);
+        }
+      }
+    }
+  return found;
+}
+
+//-----------------------------------------------------------------------------
+/// Set the status of the voxels of \a region from the labels.
+template <class T>
+void vtkITKFastMarchingInitializeStatus(const T* labels, const int dims[3], int label,
+  const int region[6], unsigned char* status, float* times)
+{
+  const vtkIdType incY = dims[0];
+  const vtkIdType incZ = static_cast<vtkIdType>(dims[0]) * dims[1];
+  const T seedLabel = static_cast<T>(label);
+  for (int k = region[4]; k <= region[5]; ++k)
+    {
+    for (int j = region[2]; j <= region[3]; ++j)
+      {
+      const T* labelPtr = labels + region[0] + j * incY + k * incZ;
+      const bool borderRow = (j == 0 || j == dims[1] - 1 || k == 0 || k == dims[2] - 1);
+      for (int i = region[0]; i <= region[1]; ++i, ++labelPtr, ++status, ++times)
+        {
+        *times = FAR_TIME;
+        if (borderRow || i == 0 || i == dims[0] - 1)
+          {
+          // the neighborhood of these voxels is not entirely in the image
+          *status = Fixed;
+          }
+        else if (*labelPtr == seedLabel)
+          {
+          *status = Known;
+          *times = 0.f;
+          }
+        else if (*labelPtr != 0)
+          {
+          *status = Fixed;
+          }
+        else
+          {
+          *status = Far;
+          }
+        }
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+template <class T>
+void vtkITKFastMarchingWriteLabel(T* labels, const std::vector<vtkIdType>& voxels,
+  vtkIdType numberOfVoxels, int label)
+{
+  const T value = static_cast<T>(label);
+  for (vtkIdType n = 0; n < numberOfVoxels; ++n)
+    {
+    labels[voxels[n]] = value;
+    }
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+class vtkITKFastMarchingSegmentation::vtkInternal
+{
+public:
+  typedef void (*StatisticsFunctionType)(const void*, vtkIdType, const vtkIdType[27], double&, double&);
+
+  vtkInternal();
+
+  void Reset();
+
+  /// Allocate the region around the seeds, estimate the speed model and
+  /// put the neighbors of the seeds in the queue.
+  /// Returns false if there is no seed.
+  bool Initialize(vtkImageData* intensity, vtkImageData* seeds, int label,
+                  double speedPower, double minimumSpeed);
+
+  /// March until \a numberOfVoxels voxels are known or the front stops.
+  void March(vtkIdType numberOfVoxels, vtkAlgorithm* self);
+
+  // Region
+  void LocalToIJK(vtkIdType local, int ijk[3]) const;
+  vtkIdType IJKToGlobal(const int ijk[3]) const;
+  /// Grow the region so that the 2-voxel neighborhood of \a ijk is in it.
+  void EnsureInRegion(const int ijk[3]);
+  void AllocateRegion(const int region[6]);
+
+  // Front
+  float Speed(vtkIdType local, vtkIdType global);
+  float ComputeTime(vtkIdType local, vtkIdType global);
+  void UpdateNeighbors(vtkIdType local, vtkIdType global);
+
+  // Bucket queue
+  void Push(vtkIdType local, float time);
+  bool Pop(vtkIdType& local);
+
+  // Whole image
+  int Dimensions[3];
+  vtkIdType IncrementsGlobal[3];
+  vtkIdType NeighborhoodOffsets[27];
+  double Spacing[3];
+  const void* IntensityPointer;
+  StatisticsFunctionType StatisticsFunction;
+  const void* SeedPointer;
+  int SeedScalarType;
+  int Label;
+
+  // Region, in voxel coordinates of the whole image
+  int Region[6];
+  vtkIdType IncrementsLocal[3];
+  std::vector<float> Times;
+  std::vector<float> Speeds;
+  std::vector<unsigned char> Status;
+
+  // Speed model
+  double SpeedPower;
+  double MinimumSpeed;
+  double MedianMean;
+  double MedianVariance;
+  double InhomogeneityMean;
+  double InhomogeneityVariance;
+
+  // Untidy priority queue: circular array of buckets of width BucketWidth
+  std::vector< std::vector<vtkIdType> > Buckets;
+  double BucketWidth;
+  vtkIdType CurrentBucket;
+  vtkIdType NumberOfQueuedVoxels;
+
+  /// Global index of the marched voxels, in arrival order.
+  std::vector<vtkIdType> KnownVoxels;
+
+  // What the marching has been computed from
+  bool Initialized;
+  vtkMTimeType IntensityMTime;
+  vtkMTimeType SeedMTime;
+};
+
+//-----------------------------------------------------------------------------
+vtkITKFastMarchingSegmentation::vtkInternal::vtkInternal()
+{
+  this->Reset();
+}
+
+//-----------------------------------------------------------------------------
+void vtkITKFastMarchingSegmentation::vtkInternal::Reset()
+{
+  for (int i = 0; i < 3; ++i)
+    {
+    this->Dimensions[i] = 0;
+    this->IncrementsGlobal[i] = 0;
+    this->IncrementsLocal[i] = 0;
+    this->Spacing[i] = 1.;
+    }
+  this->IntensityPointer = 0;
+  this->StatisticsFunction = 0;
+  this->SeedPointer = 0;
+  this->SeedScalarType = VTK_VOID;
+  this->Label = 0;
+  this->Region[0] = this->Region[2] = this->Region[4] = 0;
+  this->Region[1] = this->Region[3] = this->Region[5] = -1;
+  // release the memory, clear() would keep it
+  std::vector<float>().swap(this->Times);
+  std::vector<float>().swap(this->Speeds);
+  std::vector<unsigned char>().swap(this->Status);
+  std::vector< std::vector<vtkIdType> >().swap(this->Buckets);
+  std::vector<vtkIdType>().swap(this->KnownVoxels);
+  this->SpeedPower = 1.;
+  this->MinimumSpeed = 1e-3;
+  this->MedianMean = 0.;
+  this->MedianVariance = 1.;
+  this->InhomogeneityMean = 0.;
+  this->InhomogeneityVariance = 1.;
+  this->BucketWidth = 1.;
+  this->CurrentBucket = 0;
+  this->NumberOfQueuedVoxels = 0;
+  this->Initialized = false;
+  this->IntensityMTime = 0;
+  this->SeedMTime = 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkITKFastMarchingSegmentation::vtkInternal::LocalToIJK(vtkIdType local, int ijk[3]) const
+{
+  ijk[2] = static_cast<int>(local / this->IncrementsLocal[2]);
+  local -= ijk[2] * this->IncrementsLocal[2];
+  ijk[1] = static_cast<int>(local / this->IncrementsLocal[1]);
+  ijk[0] = static_cast<int>(local - ijk[1] * this->IncrementsLocal[1]);
+  ijk[0] += this->Region[0];
+  ijk[1] += this->Region[2];
+  ijk[2] += this->Region[4];
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkITKFastMarchingSegmentation::vtkInternal::IJKToGlobal(const int ijk[3]) const
+{
+  return ijk[0] + ijk[1] * this->IncrementsGlobal[1] + ijk[2] * this->IncrementsGlobal[2];
+}
+
+//-----------------------------------------------------------------------------
+void vtkITKFastMarchingSegmentation::vtkInternal::AllocateRegion(const int region[6])
+{
+  const int oldRegion[6] = { this->Region[0], this->Region[1], this->Region[2],
+                             this->Region[3], this->Region[4], this->Region[5] };
+  const vtkIdType oldIncrements[3] = { this->IncrementsLocal[0],
+                                       this->IncrementsLocal[1], this->IncrementsLocal[2] };
+  const vtkIdType oldSizeX = oldRegion[1] - oldRegion[0] + 1;
+
+  std::copy(region, region + 6, this->Region);
+  this->IncrementsLocal[0] = 1;
+  this->IncrementsLocal[1] = region[1] - region[0] + 1;
+  this->IncrementsLocal[2] = this->IncrementsLocal[1] * (region[3] - region[2] + 1);
+  const vtkIdType numberOfVoxels = this->IncrementsLocal[2] * (region[5] - region[4] + 1);
+
+  std::vector<float> times(numberOfVoxels);
+  std::vector<float> speeds(numberOfVoxels, -1.f);
+  std::vector<unsigned char> status(numberOfVoxels);
+  switch (this->SeedScalarType)
+    {
+    vtkTemplateMacro(vtkITKFastMarchingInitializeStatus(
+      static_cast<const VTK_TT*>(this->SeedPointer), this->Dimensions, this->Label,
+      region, &status[0], &times[0]));
+    }
+
+  // the previous region is inside the new one, copy what has been computed
+  if (oldSizeX > 0)
+    {
+    for (int k = oldRegion[4]; k <= oldRegion[5]; ++k)
+      {
+      for (int j = oldRegion[2]; j <= oldRegion[3]; ++j)
+        {
+        const vtkIdType oldRow = (j - oldRegion[2]) * oldIncrements[1]
+          + (k - oldRegion[4]) * oldIncrements[2];
+        const vtkIdType newRow = (oldRegion[0] - region[0])
+          + (j - region[2]) * this->IncrementsLocal[1]
+          + (k - region[4]) * this->IncrementsLocal[2];
+        std::copy(this->Times.begin() + oldRow, this->Times.begin() + oldRow + oldSizeX,
+                  times.begin() + newRow);
+        std::copy(this->Speeds.begin() + oldRow, this->Speeds.begin() + oldRow + oldSizeX,
+                  speeds.begin() + newRow);
+        std::copy(this->Status.begin() + oldRow, this->Status.begin() + oldRow + oldSizeX,
+                  status.begin() + newRow);
+        }
+      }
+    // the queue holds local indices
+    for (size_t b = 0; b < this->Buckets.size(); ++b)
+      {
+      std::vector<vtkIdType>& bucket = this->Buckets[b];
+      for (size_t n = 0; n < bucket.size(); ++n)
+        {
+        vtkIdType local = bucket[n];
+        const vtkIdType k = local / oldIncrements[2];
+        local -= k * oldIncrements[2];
+        const vtkIdType j = local / oldIncrements[1];
+        const vtkIdType i = local - j * oldIncrements[1];
+        bucket[n] = (i + oldRegion[0] - region[0])
+          + (j + oldRegion[2] - region[2]) * this->IncrementsLocal[1]
+          + (k + oldRegion[4] - region[4]) * this->IncrementsLocal[2];
+        }
+      }
+    }
+
+  this->Times.swap(times);
+  this->Speeds.swap(speeds);
+  this->Status.swap(status);
+}
+
+//-----------------------------------------------------------------------------
+void vtkITKFastMarchingSegmentation::vtkInternal::EnsureInRegion(const int ijk[3])
+{
+  int region[6];
+  std::copy(this->Region, this->Region + 6, region);
+  bool grow = false;
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    const int growth = std::max(REGION_GROWTH,
+      this->Region[2 * axis + 1] - this->Region[2 * axis] + 1);
+    if (ijk[axis] - 2 < region[2 * axis] && region[2 * axis] > 0)
+      {
+      region[2 * axis] = std::max(0, region[2 * axis] - growth);
+      grow = true;
+      }
+    if (ijk[axis] + 2 > region[2 * axis + 1] && region[2 * axis + 1] < this->Dimensions[axis] - 1)
+      {
+      region[2 * axis + 1] = std::min(this->Dimensions[axis] - 1, region[2 * axis + 1] + growth);
+      grow = true;
+      }
+    }
+  if (grow)
+    {
+    this->AllocateRegion(region);
+    }
+}
+
+//-----------------------------------------------------------------------------
+float vtkITKFastMarchingSegmentation::vtkInternal::Speed(vtkIdType local, vtkIdType global)
+{
+  float& speed = this->Speeds[local];
+  if (speed >= 0.f)
+    {
+    return speed;
+    }
+  double median = 0.;
+  double inhomogeneity = 0.;
+  this->StatisticsFunction(this->IntensityPointer, global, this->NeighborhoodOffsets,
+                           median, inhomogeneity);
+  // (pI^2 pH)^SpeedPower with Gaussian likelihoods, computed as one exponential
+  const double dm = median - this->MedianMean;
+  double exponent = -dm * dm / this->MedianVariance;
+  // being more homogeneous than the seeds is not penalized
+  if (inhomogeneity > this->InhomogeneityMean)
+    {
+    const double dh = inhomogeneity - this->InhomogeneityMean;
+    exponent -= dh * dh / (2. * this->InhomogeneityVariance);
+    }
+  speed = static_cast<float>(
+    std::max(this->MinimumSpeed, std::exp(this->SpeedPower * exponent)));
+  return speed;
+}
+
+//-----------------------------------------------------------------------------
+float vtkITKFastMarchingSegmentation::vtkInternal::ComputeTime(vtkIdType local, vtkIdType global)
+{
+  // smallest known arrival time along each axis
+  double times[3];
+  double weights[3];
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    const vtkIdType inc = this->IncrementsLocal[axis];
+    double time = FAR_TIME;
+    if (this->Status[local - inc] == Known)
+      {
+      time = this->Times[local - inc];
+      }
+    if (this->Status[local + inc] == Known)
+      {
+      time = std::min(time, static_cast<double>(this->Times[local + inc]));
+      }
+    times[axis] = time;
+    weights[axis] = 1. / (this->Spacing[axis] * this->Spacing[axis]);
+    }
+  // sort by arrival time
+  for (int a = 0; a < 2; ++a)
+    {
+    for (int b = a + 1; b < 3; ++b)
+      {
+      if (times[b] < times[a])
+        {
+        std::swap(times[a], times[b]);
+        std::swap(weights[a], weights[b]);
+        }
+      }
+    }
+
+  // Solve sum(w (T - t)^2) = 1/s^2 with the axes whose known time is
+  // lower than the solution (upwind scheme)
+  const double speed = this->Speed(local, global);
+  const double rhs = 1. / (speed * speed);
+  double a = 0.;
+  double b = 0.;
+  double c = -rhs;
+  double solution = FAR_TIME;
+  for (int axis = 0; axis < 3 && times[axis] < FAR_TIME; ++axis)
+    {
+    if (axis > 0 && solution <= times[axis])
+      {
+      break;
+      }
+    a += weights[axis];
+    b -= 2. * weights[axis] * times[axis];
+    c += weights[axis] * times[axis] * times[axis];
+    const double discriminant = b * b - 4. * a * c;
+    if (discriminant < 0.)
+      {
+      break;
+      }
+    solution = (-b + std::sqrt(discriminant)) / (2. * a);
+    }
+  return static_cast<float>(std::min(solution, static_cast<double>(FAR_TIME)));
+}
+
+//-----------------------------------------------------------------------------
+void vtkITKFastMarchingSegmentation::vtkInternal::Push(vtkIdType local, float time)
+{
+  vtkIdType bucket = static_cast<vtkIdType>(time / this->BucketWidth);
+  const vtkIdType numberOfBuckets = static_cast<vtkIdType>(this->Buckets.size());
+  // the increments are bounded by the minimum speed, clamp for rounding
+  bucket = std::max(this->CurrentBucket, std::min(bucket, this->CurrentBucket + numberOfBuckets - 1));
+  this->Buckets[bucket % numberOfBuckets].push_back(local);
+  ++this->NumberOfQueuedVoxels;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkITKFastMarchingSegmentation::vtkInternal::Pop(vtkIdType& local)
+{
+  const vtkIdType numberOfBuckets = static_cast<vtkIdType>(this->Buckets.size());
+  while (this->NumberOfQueuedVoxels > 0)
+    {
+    std::vector<vtkIdType>& bucket = this->Buckets[this->CurrentBucket % numberOfBuckets];
+    while (!bucket.empty())
+      {
+      local = bucket.back();
+      bucket.pop_back();
+      --this->NumberOfQueuedVoxels;
+      // a voxel is queued again each time its time decreases, skip the
+      // outdated entries
+      if (this->Status[local] == Trial)
+        {
+        return true;
+        }
+      }
+    ++this->CurrentBucket;
+    }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+void vtkITKFastMarchingSegmentation::vtkInternal::UpdateNeighbors(vtkIdType local, vtkIdType global)
+{
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    for (int direction = -1; direction <= 1; direction += 2)
+      {
+      const vtkIdType neighbor = local + direction * this->IncrementsLocal[axis];
+      const unsigned char status = this->Status[neighbor];
+      if (status != Far && status != Trial)
+        {
+        continue;
+        }
+      const float time = this->ComputeTime(neighbor, global + direction * this->IncrementsGlobal[axis]);
+      if (time < this->Times[neighbor])
+        {
+        this->Times[neighbor] = time;
+        this->Status[neighbor] = Trial;
+        this->Push(neighbor, time);
+        }
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkITKFastMarchingSegmentation::vtkInternal::Initialize(vtkImageData* intensity,
+  vtkImageData* seeds, int label, double speedPower, double minimumSpeed)
+{
+  this->Reset();
+
+  intensity->GetDimensions(this->Dimensions);
+  intensity->GetSpacing(this->Spacing);
+  this->IncrementsGlobal[0] = 1;
+  this->IncrementsGlobal[1] = this->Dimensions[0];
+  this->IncrementsGlobal[2] = static_cast<vtkIdType>(this->Dimensions[0]) * this->Dimensions[1];
+  int n = 0;
+  for (int k = -1; k <= 1; ++k)
+    {
+    for (int j = -1; j <= 1; ++j)
+      {
+      for (int i = -1; i <= 1; ++i)
+        {
+        this->NeighborhoodOffsets[n++] =
+          i + j * this->IncrementsGlobal[1] + k * this->IncrementsGlobal[2];
+        }
+      }
+    }
+
+  this->IntensityPointer = intensity->GetScalarPointer();
+  switch (intensity->GetScalarType())
+    {
+    vtkTemplateMacro(this->StatisticsFunction = &vtkITKFastMarchingNeighborhoodStatistics<VTK_TT>);
+    default:
+      return false;
+    }
+  this->SeedPointer = seeds->GetScalarPointer();
+  this->SeedScalarType = seeds->GetScalarType();
+  this->Label = label;
+  this->SpeedPower = speedPower;
+  this->MinimumSpeed = minimumSpeed;
+
+  int bounds[6] = { 0, -1, 0, -1, 0, -1 };
+  bool found = false;
+  switch (this->SeedScalarType)
+    {
+    vtkTemplateMacro(found = vtkITKFastMarchingSeedBounds(
+      static_cast<const VTK_TT*>(this->SeedPointer), this->Dimensions, label, bounds));
+    default:
+      return false;
+    }
+  if (!found)
+    {
+    return false;
+    }
+
+  int region[6];
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    region[2 * axis] = std::max(0, bounds[2 * axis] - REGION_GROWTH);
+    region[2 * axis + 1] = std::min(this->Dimensions[axis] - 1, bounds[2 * axis + 1] + REGION_GROWTH);
+    }
+  this->AllocateRegion(region);
+
+  // Speed model from the neighborhood of the seeds
+  std::vector<vtkIdType> seedVoxels;
+  double medianSum = 0.;
+  double medianSum2 = 0.;
+  double inhomogeneitySum = 0.;
+  double inhomogeneitySum2 = 0.;
+  const vtkIdType numberOfRegionVoxels = static_cast<vtkIdType>(this->Status.size());
+  for (vtkIdType local = 0; local < numberOfRegionVoxels; ++local)
+    {
+    if (this->Status[local] != Known)
+      {
+      continue;
+      }
+    seedVoxels.push_back(local);
+    int ijk[3];
+    this->LocalToIJK(local, ijk);
+    double median = 0.;
+    double inhomogeneity = 0.;
+    this->StatisticsFunction(this->IntensityPointer, this->IJKToGlobal(ijk),
+                             this->NeighborhoodOffsets, median, inhomogeneity);
+    medianSum += median;
+    medianSum2 += median * median;
+    inhomogeneitySum += inhomogeneity;
+    inhomogeneitySum2 += inhomogeneity * inhomogeneity;
+    }
+  if (seedVoxels.empty())
+    {
+    // all the seeds are on the border of the image
+    return false;
+    }
+  const double count = static_cast<double>(seedVoxels.size());
+  this->MedianMean = medianSum / count;
+  this->InhomogeneityMean = inhomogeneitySum / count;
+  // keep the model usable on perfectly homogeneous seeds
+  this->MedianVariance = std::max(medianSum2 / count - this->MedianMean * this->MedianMean,
+    1e-6 + 1e-4 * this->MedianMean * this->MedianMean);
+  this->InhomogeneityVariance = std::max(
+    inhomogeneitySum2 / count - this->InhomogeneityMean * this->InhomogeneityMean,
+    1e-6 + 1e-4 * this->InhomogeneityMean * this->InhomogeneityMean);
+
+  // Buckets: the time increases by at most maxSpacing / minimumSpeed from
+  // a known voxel to its neighbors, the circular array must cover it.
+  const double minSpacing = std::min(this->Spacing[0], std::min(this->Spacing[1], this->Spacing[2]));
+  const double maxSpacing = std::max(this->Spacing[0], std::max(this->Spacing[1], this->Spacing[2]));
+  this->BucketWidth = 0.5 * minSpacing;
+  const vtkIdType numberOfBuckets = static_cast<vtkIdType>(
+    std::ceil(maxSpacing / (this->MinimumSpeed * this->BucketWidth))) + 2;
+  this->Buckets.resize(numberOfBuckets);
+
+  // Initial front
+  for (size_t s = 0; s < seedVoxels.size(); ++s)
+    {
+    int ijk[3];
+    this->LocalToIJK(seedVoxels[s], ijk);
+    const int previousRegion[6] = { this->Region[0], this->Region[1], this->Region[2],
+                                    this->Region[3], this->Region[4], this->Region[5] };
+    this->EnsureInRegion(ijk);
+    if (!std::equal(previousRegion, previousRegion + 6, this->Region))
+      {
+      // indices of the remaining seeds changed
+      for (size_t r = s; r < seedVoxels.size(); ++r)
+        {
+        int seedIJK[3];
+        vtkIdType local = seedVoxels[r];
+        const vtkIdType incY = previousRegion[1] - previousRegion[0] + 1;
+        const vtkIdType incZ = incY * (previousRegion[3] - previousRegion[2] + 1);
+        seedIJK[2] = static_cast<int>(local / incZ) + previousRegion[4];
+        local %= incZ;
+        seedIJK[1] = static_cast<int>(local / incY) + previousRegion[2];
+        seedIJK[0] = static_cast<int>(local % incY) + previousRegion[0];
+        seedVoxels[r] = (seedIJK[0] - this->Region[0])
+          + (seedIJK[1] - this->Region[2]) * this->IncrementsLocal[1]
+          + (seedIJK[2] - this->Region[4]) * this->IncrementsLocal[2];
+        }
+      }
+    this->UpdateNeighbors(seedVoxels[s], this->IJKToGlobal(ijk));
+    }
+
+  this->Initialized = true;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkITKFastMarchingSegmentation::vtkInternal::March(vtkIdType numberOfVoxels, vtkAlgorithm* self)
+{
+  const vtkIdType start = static_cast<vtkIdType>(this->KnownVoxels.size());
+  if (numberOfVoxels <= start)
+    {
+    return;
+    }
+  const vtkIdType progressStep = std::max(static_cast<vtkIdType>(1), (numberOfVoxels - start) / 20);
+  vtkIdType local = 0;
+  while (static_cast<vtkIdType>(this->KnownVoxels.size()) < numberOfVoxels && this->Pop(local))
+    {
+    this->Status[local] = Known;
+    int ijk[3];
+    this->LocalToIJK(local, ijk);
+    const vtkIdType global = this->IJKToGlobal(ijk);
+    this->KnownVoxels.push_back(global);
+
+    const vtkIdType previousSize = static_cast<vtkIdType>(this->Status.size());
+    this->EnsureInRegion(ijk);
+    if (static_cast<vtkIdType>(this->Status.size()) != previousSize)
+      {
+      local = (ijk[0] - this->Region[0])
+        + (ijk[1] - this->Region[2]) * this->IncrementsLocal[1]
+        + (ijk[2] - this->Region[4]) * this->IncrementsLocal[2];
+      }
+    this->UpdateNeighbors(local, global);
+
+    const vtkIdType marched = static_cast<vtkIdType>(this->KnownVoxels.size()) - start;
+    if (marched % progressStep == 0)
+      {
+      self->UpdateProgress(static_cast<double>(marched) / (numberOfVoxels - start));
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+vtkITKFastMarchingSegmentation::vtkITKFastMarchingSegmentation()
+{
+  this->Label = 1;
+  this->TargetNumberOfVoxels = 0;
+  this->ShowFraction = 1.;
+  this->SpeedPower = 1.;
+  this->MinimumSpeed = 1e-3;
+  this->NumberOfShownVoxels = 0;
+  this->Internal = new vtkInternal;
+  this->SetNumberOfInputPorts(2);
+}
+
+//-----------------------------------------------------------------------------
+vtkITKFastMarchingSegmentation::~vtkITKFastMarchingSegmentation()
+{
+  delete this->Internal;
+}
+
+//-----------------------------------------------------------------------------
+void vtkITKFastMarchingSegmentation::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Label: " << this->Label << "\n";
+  os << indent << "TargetNumberOfVoxels: " << this->TargetNumberOfVoxels << "\n";
+  os << indent << "ShowFraction: " << this->ShowFraction << "\n";
+  os << indent << "SpeedPower: " << this->SpeedPower << "\n";
+  os << indent << "MinimumSpeed: " << this->MinimumSpeed << "\n";
+  os << indent << "NumberOfMarchedVoxels: " << this->GetNumberOfMarchedVoxels() << "\n";
+  os << indent << "NumberOfShownVoxels: " << this->NumberOfShownVoxels << "\n";
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkITKFastMarchingSegmentation::GetNumberOfMarchedVoxels()
+{
+  return static_cast<vtkIdType>(this->Internal->KnownVoxels.size());
+}
+
+//-----------------------------------------------------------------------------
+void vtkITKFastMarchingSegmentation::GetRegionExtent(int extent[6])
+{
+  std::copy(this->Internal->Region, this->Internal->Region + 6, extent);
+  if (this->Internal->Initialized && this->GetNumberOfInputConnections(0) > 0)
+    {
+    int wholeExtent[6];
+    this->GetInputInformation(0, 0)->Get(
+      vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent);
+    for (int i = 0; i < 6; ++i)
+      {
+      extent[i] += wholeExtent[i - i % 2];
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkITKFastMarchingSegmentation::ResetMarching()
+{
+  this->Internal->Reset();
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+int vtkITKFastMarchingSegmentation::FillInputPortInformation(int port, vtkInformation* info)
+{
+  if (!this->Superclass::FillInputPortInformation(port, info))
+    {
+    return 0;
+    }
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+int vtkITKFastMarchingSegmentation::RequestInformation(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkInformation* intensityInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* seedInfo = inputVector[1]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  if (!intensityInfo || !seedInfo)
+    {
+    return 0;
+    }
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
+    seedInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+  // the output is a copy of the label map
+  vtkInformation* scalarInfo = vtkDataObject::GetActiveFieldInformation(seedInfo,
+    vtkDataObject::FIELD_ASSOCIATION_POINTS, vtkDataSetAttributes::SCALARS);
+  if (scalarInfo)
+    {
+    vtkDataObject::SetPointDataActiveScalarInfo(outInfo,
+      scalarInfo->Get(vtkDataObject::FIELD_ARRAY_TYPE()), 1);
+    }
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+int vtkITKFastMarchingSegmentation::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* vtkNotUsed(outputVector))
+{
+  // the front can go anywhere, it needs the whole images
+  for (int port = 0; port < 2; ++port)
+    {
+    vtkInformation* inInfo = inputVector[port]->GetInformationObject(0);
+    if (inInfo)
+      {
+      inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+        inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+      }
+    }
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+int vtkITKFastMarchingSegmentation::RequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkImageData* intensity = vtkImageData::GetData(inputVector[0]);
+  vtkImageData* seeds = vtkImageData::GetData(inputVector[1]);
+  vtkImageData* output = vtkImageData::GetData(outputVector);
+  this->NumberOfShownVoxels = 0;
+  if (!intensity || !seeds || !output
+      || !intensity->GetPointData()->GetScalars() || !seeds->GetPointData()->GetScalars())
+    {
+    vtkErrorMacro("RequestData: an intensity image and a label map are required");
+    return 0;
+    }
+  if (intensity->GetNumberOfScalarComponents() != 1 || seeds->GetNumberOfScalarComponents() != 1)
+    {
+    vtkErrorMacro("RequestData: the inputs must have one scalar component");
+    return 0;
+    }
+  int intensityExtent[6];
+  int seedExtent[6];
+  intensity->GetExtent(intensityExtent);
+  seeds->GetExtent(seedExtent);
+  if (!std::equal(intensityExtent, intensityExtent + 6, seedExtent))
+    {
+    vtkErrorMacro("RequestData: the intensity image and the label map must have the same extent");
+    return 0;
+    }
+
+  // the output is the label map with the shown voxels set to Label
+  output->CopyStructure(seeds);
+  vtkDataArray* seedScalars = seeds->GetPointData()->GetScalars();
+  vtkDataArray* outputScalars = seedScalars->NewInstance();
+  outputScalars->DeepCopy(seedScalars);
+  output->GetPointData()->SetScalars(outputScalars);
+  outputScalars->Delete();
+
+  vtkInternal* internal = this->Internal;
+  if (!internal->Initialized
+      || internal->IntensityMTime != intensity->GetMTime()
+      || internal->SeedMTime != seeds->GetMTime()
+      || internal->Label != this->Label
+      || internal->SpeedPower != this->SpeedPower
+      || internal->MinimumSpeed != this->MinimumSpeed)
+    {
+    if (!internal->Initialize(intensity, seeds, this->Label, this->SpeedPower, this->MinimumSpeed))
+      {
+      vtkWarningMacro("RequestData: no seed with label " << this->Label
+                      << " inside the image, nothing to march from");
+      internal->Reset();
+      return 1;
+      }
+    internal->IntensityMTime = intensity->GetMTime();
+    internal->SeedMTime = seeds->GetMTime();
+    }
+
+  internal->March(this->TargetNumberOfVoxels, this);
+
+  this->NumberOfShownVoxels = static_cast<vtkIdType>(
+    this->ShowFraction * std::min(this->TargetNumberOfVoxels, this->GetNumberOfMarchedVoxels()) + 0.5);
+  switch (outputScalars->GetDataType())
+    {
+    vtkTemplateMacro(vtkITKFastMarchingWriteLabel(
+      static_cast<VTK_TT*>(output->GetScalarPointer()), internal->KnownVoxels,
+      this->NumberOfShownVoxels, this->Label));
+    }
+  return 1;
+}
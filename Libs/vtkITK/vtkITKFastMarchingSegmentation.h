@@ -0,0 +1,122 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+
+#ifndef __vtkITKFastMarchingSegmentation_h
+#define __vtkITKFastMarchingSegmentation_h
+
+#include "vtkITK.h"
+
+// VTK includes
+#include <vtkImageAlgorithm.h>
+
+/// \brief Grow a label from seeds by fast marching on an intensity image.
+///
+/// Input 0 is the intensity image (any scalar type, one component).
+/// Input 1 is the label map holding the seeds: the voxels equal to Label.
+/// The output is the label map with the first voxels reached by the front
+/// set to Label. Voxels of other nonzero labels are never overwritten.
+///
+/// The front speed is estimated from the median intensity and the
+/// inhomogeneity (spread of the intensities) of the 3x3x3 neighborhood of
+/// the seed voxels, as in the Editor's original fast marching effect.
+///
+/// Only a cropped region around the seeds is allocated. It is grown as the
+/// front gets close to its boundary, so the memory used depends on the
+/// size of the marched structure rather than on the size of the image.
+/// The front is propagated with a bucket queue of the quantized arrival
+/// times (untidy priority queue), which costs O(1) per voxel.
+///
+/// The arrival order is kept between updates:
+/// - increasing TargetNumberOfVoxels resumes the marching where it stopped
+/// - decreasing TargetNumberOfVoxels or changing ShowFraction only updates
+///   the output
+/// The marching is restarted when the inputs, Label or the speed
+/// parameters are modified.
+///
+/// \code
+/// fm = vtkITK.vtkITKFastMarchingSegmentation()
+/// fm.SetInputData(0, intensityImage)
+/// fm.SetInputData(1, labelImage)
+/// fm.SetLabel(1)
+/// fm.SetTargetNumberOfVoxels(100000)
+/// fm.Update()
+/// fm.SetShowFraction(0.5) # display the first 50000 voxels
+/// fm.Update()
+/// \endcode
+class VTK_ITK_EXPORT vtkITKFastMarchingSegmentation : public vtkImageAlgorithm
+{
+public:
+  static vtkITKFastMarchingSegmentation *New();
+  vtkTypeMacro(vtkITKFastMarchingSegmentation, vtkImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  /// Label of the seeds and of the marched voxels. Default is 1.
+  vtkSetMacro(Label, int);
+  vtkGetMacro(Label, int);
+
+  /// Number of voxels to march, seeds excluded. Default is 0.
+  vtkSetClampMacro(TargetNumberOfVoxels, vtkIdType, 0, VTK_ID_MAX);
+  vtkGetMacro(TargetNumberOfVoxels, vtkIdType);
+
+  /// Fraction of the marched voxels that are labeled in the output, in
+  /// arrival order. Default is 1.
+  vtkSetClampMacro(ShowFraction, double, 0.0, 1.0);
+  vtkGetMacro(ShowFraction, double);
+
+  /// Exponent applied to the speed. Larger values slow down the front
+  /// more strongly on voxels that do not look like the seeds.
+  /// Default is 1.
+  vtkSetClampMacro(SpeedPower, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(SpeedPower, double);
+
+  /// Lowest speed of the front, relative to the speed in the seeds.
+  /// It bounds the arrival time increments and therefore the number of
+  /// buckets of the queue. Default is 1e-3.
+  vtkSetClampMacro(MinimumSpeed, double, 1e-6, 1.0);
+  vtkGetMacro(MinimumSpeed, double);
+
+  /// Number of voxels marched so far. It is lower than
+  /// TargetNumberOfVoxels when the front could not go further.
+  vtkIdType GetNumberOfMarchedVoxels();
+
+  /// Number of marched voxels labeled in the last output.
+  vtkGetMacro(NumberOfShownVoxels, vtkIdType);
+
+  /// Extent of the region currently allocated for the marching.
+  /// It is empty before the first update.
+  void GetRegionExtent(int extent[6]);
+
+  /// Discard the arrival times, the next update marches from the seeds.
+  void ResetMarching();
+
+protected:
+  vtkITKFastMarchingSegmentation();
+  ~vtkITKFastMarchingSegmentation();
+
+  virtual int FillInputPortInformation(int port, vtkInformation* info);
+  virtual int RequestInformation(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+  virtual int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+  virtual int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
+  int Label;
+  vtkIdType TargetNumberOfVoxels;
+  double ShowFraction;
+  double SpeedPower;
+  double MinimumSpeed;
+  vtkIdType NumberOfShownVoxels;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkITKFastMarchingSegmentation(const vtkITKFastMarchingSegmentation&);  // Not implemented.
+  void operator=(const vtkITKFastMarchingSegmentation&);  // Not implemented.
+};
+
+#endif
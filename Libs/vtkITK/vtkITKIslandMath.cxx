@@ -25,6 +25,9 @@
 #include "itkRelabelComponentImageFilter.h"
 #include "itkCommand.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkITKIslandMath);
 
 vtkITKIslandMath::vtkITKIslandMath()
@@ -77,6 +80,38 @@ void vtkITKIslandMathExecute(vtkITKIslandMath *self, vtkImageData* input,
   input->GetDimensions(dims);
   double spacing[3];
   input->GetSpacing(spacing);
+  const vtkIdType numberOfVoxels =
+    static_cast<vtkIdType>(dims[0]) * dims[1] * dims[2];
+
+  // Islands only exist within the bounding box of the non-zero voxels,
+  // restrict the computation to it.
+  int box[6] = {dims[0], -1, dims[1], -1, dims[2], -1};
+  T* voxelPtr = inPtr;
+  for (int k = 0; k < dims[2]; ++k)
+    {
+    for (int j = 0; j < dims[1]; ++j)
+      {
+      for (int i = 0; i < dims[0]; ++i, ++voxelPtr)
+        {
+        if (*voxelPtr != 0)
+          {
+          box[0] = std::min(box[0], i); box[1] = std::max(box[1], i);
+          box[2] = std::min(box[2], j); box[3] = std::max(box[3], j);
+          box[4] = std::min(box[4], k); box[5] = std::max(box[5], k);
+          }
+        }
+      }
+    }
+  memset(outPtr, 0, numberOfVoxels * sizeof(T));
+  if (box[1] < box[0])
+    {
+    self->SetNumberOfIslands(0);
+    self->SetOriginalNumberOfIslands(0);
+    return;
+    }
+  const bool cropped = (box[0] > 0 || box[2] > 0 || box[4] > 0 ||
+    box[1] < dims[0] - 1 || box[3] < dims[1] - 1 || box[5] < dims[2] - 1);
+  const int boxDims[3] = {box[1] - box[0] + 1, box[3] - box[2] + 1, box[5] - box[4] + 1};
 
   // Wrap scalars into an ITK image
   // - mostly rely on defaults for spacing, origin etc for this filter
@@ -86,14 +121,30 @@ void vtkITKIslandMathExecute(vtkITKIslandMath *self, vtkImageData* input,
   typename ImageType::IndexType index;
   typename ImageType::SizeType size;
 
-  inImage->GetPixelContainer()->SetImportPointer(inPtr, dims[0]*dims[1]*dims[2], false);
   index[0] = index[1] = index[2] = 0;
   region.SetIndex(index);
-  size[0] = dims[0]; size[1] = dims[1]; size[2] = dims[2];
+  size[0] = boxDims[0]; size[1] = boxDims[1]; size[2] = boxDims[2];
   region.SetSize(size);
   inImage->SetLargestPossibleRegion(region);
   inImage->SetBufferedRegion(region);
   inImage->SetSpacing(spacing);
+  if (cropped)
+    {
+    inImage->Allocate();
+    T* boxPtr = inImage->GetBufferPointer();
+    for (int k = box[4]; k <= box[5]; ++k)
+      {
+      for (int j = box[2]; j <= box[3]; ++j, boxPtr += boxDims[0])
+        {
+        memcpy(boxPtr, inPtr + (static_cast<vtkIdType>(k) * dims[1] + j) * dims[0] + box[0],
+               boxDims[0] * sizeof(T));
+        }
+      }
+    }
+  else
+    {
+    inImage->GetPixelContainer()->SetImportPointer(inPtr, numberOfVoxels, false);
+    }
 
   // set up the progress callback
   itk::CStyleCommand::Pointer progressCommand = itk::CStyleCommand::New();
@@ -117,12 +168,41 @@ void vtkITKIslandMathExecute(vtkITKIslandMath *self, vtkImageData* input,
   relabel->SetInput( ccfilter->GetOutput() );
   relabel->SetMinimumObjectSize( self->GetMinimumSize() );
   relabel->Update();
-  self->SetNumberOfIslands(relabel->GetNumberOfObjects());
+
+  // Islands are sorted by decreasing size, the ones larger than the maximum
+  // size are the first labels and are removed while copying to the output.
+  const std::vector<typename RelabelComponentType::ObjectSizeType>& sizes =
+    relabel->GetSizeOfObjectsInPixels();
+  unsigned long numberOfLargeIslands = 0;
+  while (numberOfLargeIslands < sizes.size() &&
+         static_cast<vtkIdType>(sizes[numberOfLargeIslands]) > self->GetMaximumSize())
+    {
+    ++numberOfLargeIslands;
+    }
+  self->SetNumberOfIslands(relabel->GetNumberOfObjects() - numberOfLargeIslands);
   self->SetOriginalNumberOfIslands(relabel->GetOriginalNumberOfObjects());
 
   // Copy to the output
-  memcpy(outPtr, relabel->GetOutput()->GetBufferPointer(),
-         relabel->GetOutput()->GetBufferedRegion().GetNumberOfPixels() * sizeof(T));
+  const T* labelPtr = relabel->GetOutput()->GetBufferPointer();
+  const T largeIslandLabel = static_cast<T>(numberOfLargeIslands);
+  for (int k = box[4]; k <= box[5]; ++k)
+    {
+    for (int j = box[2]; j <= box[3]; ++j)
+      {
+      T* rowPtr = outPtr + (static_cast<vtkIdType>(k) * dims[1] + j) * dims[0] + box[0];
+      if (numberOfLargeIslands == 0)
+        {
+        memcpy(rowPtr, labelPtr, boxDims[0] * sizeof(T));
+        labelPtr += boxDims[0];
+        continue;
+        }
+      for (int i = 0; i < boxDims[0]; ++i, ++labelPtr)
+        {
+        rowPtr[i] = (*labelPtr > largeIslandLabel) ?
+          static_cast<T>(*labelPtr - largeIslandLabel) : static_cast<T>(0);
+        }
+      }
+    }
 
 }
 
@@ -14,20 +14,44 @@ PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
 #include "vtkITKLevelTracing3DImageFilter.h"
-#include "itkLevelTracingImageFilter.h"
 
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkStructuredPoints.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
 #include <vtkVersion.h>
 
+#include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkITKLevelTracing3DImageFilter);
 
+//----------------------------------------------------------------------------
+class vtkITKLevelTracing3DImageFilter::vtkInternal
+{
+public:
+  vtkInternal()
+    {
+    this->InputMTime = 0;
+    this->Threshold = 0.;
+    }
+
+  /// Last traced surface and what it has been traced from
+  vtkSmartPointer<vtkUnsignedCharArray> Output;
+  vtkMTimeType InputMTime;
+  double Threshold;
+  int Extent[6];
+
+  /// Grayscale conversion of RGB inputs
+  vtkSmartPointer<vtkUnsignedCharArray> GrayScalars;
+};
+
 // Description:
 // Construct object with initial range (0,1) and single contour value
 // of 0.0. ComputeNormal is on, ComputeGradients is off and ComputeScalars is on.
@@ -36,60 +60,169 @@ vtkITKLevelTracing3DImageFilter::vtkITKLevelTracing3DImageFilter()
   this->Seed[0] = 0;
   this->Seed[1] = 0;
   this->Seed[2] = 0;
+
+  this->NumberOfThreads = 0;
+
+  this->Internal = new vtkInternal;
 }
 
 vtkITKLevelTracing3DImageFilter::~vtkITKLevelTracing3DImageFilter()
 {
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+struct vtkITKLevelTracing3DThreadData
+{
+  const T* Scalars;
+  unsigned char* Output;
+  int Dims[3];
+  T Threshold;
+};
+
+//----------------------------------------------------------------------------
+// Label the voxels that are above the level (>= threshold) and that have a
+// neighbor below it, in its 3x3x3 neighborhood, as candidates (2).
+// The outside of the image is below the level. Each thread processes every
+// NumberOfThreads-th slice.
+template <class T>
+VTK_THREAD_RETURN_TYPE vtkITKLevelTracing3DBoundaryThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkITKLevelTracing3DThreadData<T>* data =
+    static_cast<vtkITKLevelTracing3DThreadData<T>*>(info->UserData);
+  const int* dims = data->Dims;
+  const vtkIdType incY = dims[0];
+  const vtkIdType incZ = static_cast<vtkIdType>(dims[0]) * dims[1];
+  vtkIdType offsets[26];
+  int n = 0;
+  for (int dk = -1; dk <= 1; ++dk)
+    {
+    for (int dj = -1; dj <= 1; ++dj)
+      {
+      for (int di = -1; di <= 1; ++di)
+        {
+        if (di != 0 || dj != 0 || dk != 0)
+          {
+          offsets[n++] = di + dj * incY + dk * incZ;
+          }
+        }
+      }
+    }
+  const T threshold = data->Threshold;
+  for (int k = info->ThreadID; k < dims[2]; k += info->NumberOfThreads)
+    {
+    for (int j = 0; j < dims[1]; ++j)
+      {
+      const vtkIdType rowStart = j * incY + k * incZ;
+      const T* scalars = data->Scalars + rowStart;
+      unsigned char* output = data->Output + rowStart;
+      const bool borderRow = (j == 0 || j == dims[1] - 1 || k == 0 || k == dims[2] - 1);
+      for (int i = 0; i < dims[0]; ++i, ++scalars, ++output)
+        {
+        if (*scalars < threshold)
+          {
+          *output = 0;
+          continue;
+          }
+        bool boundary = borderRow || i == 0 || i == dims[0] - 1;
+        for (n = 0; n < 26 && !boundary; ++n)
+          {
+          boundary = (scalars[offsets[n]] < threshold);
+          }
+        *output = boundary ? 2 : 0;
+        }
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
 }
 
+//----------------------------------------------------------------------------
+// Discard the candidates that are not connected to the seed.
+VTK_THREAD_RETURN_TYPE vtkITKLevelTracing3DCleanThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkITKLevelTracing3DThreadData<unsigned char>* data =
+    static_cast<vtkITKLevelTracing3DThreadData<unsigned char>*>(info->UserData);
+  const vtkIdType sliceSize = static_cast<vtkIdType>(data->Dims[0]) * data->Dims[1];
+  for (int k = info->ThreadID; k < data->Dims[2]; k += info->NumberOfThreads)
+    {
+    unsigned char* output = data->Output + k * sliceSize;
+    for (vtkIdType i = 0; i < sliceSize; ++i)
+      {
+      if (output[i] == 2)
+        {
+        output[i] = 0;
+        }
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
 
+//----------------------------------------------------------------------------
 template <class T>
 void vtkITKLevelTracing3DTrace(vtkITKLevelTracing3DImageFilter *vtkNotUsed(self),
                                T* scalars, int dims[3], int extent[6],
-                               double origin[3], double spacing[3],
                                unsigned char *oscalars,
-                               int seed[3])
+                               int seed[3], int numberOfThreads)
 {
+  const vtkIdType incY = dims[0];
+  const vtkIdType incZ = static_cast<vtkIdType>(dims[0]) * dims[1];
+  int seedIJK[3] = { seed[0] - extent[0], seed[1] - extent[2], seed[2] - extent[4] };
+  const vtkIdType seedIndex = seedIJK[0] + seedIJK[1] * incY + seedIJK[2] * incZ;
+
+  // The level is the value at the seed
+  vtkITKLevelTracing3DThreadData<T> data;
+  data.Scalars = scalars;
+  data.Output = oscalars;
+  std::copy(dims, dims + 3, data.Dims);
+  data.Threshold = scalars[seedIndex];
+
+  vtkNew<vtkMultiThreader> threader;
+  threader->SetNumberOfThreads(numberOfThreads);
+  threader->SetSingleMethod(vtkITKLevelTracing3DBoundaryThreadFunction<T>, &data);
+  threader->SingleMethodExecute();
+
+  // Face connected flood fill of the candidates from the seed. It only
+  // visits the traced surface.
+  if (oscalars[seedIndex] == 2)
+    {
+    oscalars[seedIndex] = 1;
+    std::vector<int> stack(seedIJK, seedIJK + 3);
+    while (!stack.empty())
+      {
+      const int k = stack.back(); stack.pop_back();
+      const int j = stack.back(); stack.pop_back();
+      const int i = stack.back(); stack.pop_back();
+      const int neighbors[6][3] = { { i - 1, j, k }, { i + 1, j, k },
+                                    { i, j - 1, k }, { i, j + 1, k },
+                                    { i, j, k - 1 }, { i, j, k + 1 } };
+      for (int n = 0; n < 6; ++n)
+        {
+        const int* ijk = neighbors[n];
+        if (ijk[0] < 0 || ijk[0] >= dims[0] || ijk[1] < 0 || ijk[1] >= dims[1]
+            || ijk[2] < 0 || ijk[2] >= dims[2])
+          {
+          continue;
+          }
+        unsigned char& value = oscalars[ijk[0] + ijk[1] * incY + ijk[2] * incZ];
+        if (value == 2)
+          {
+          value = 1;
+          stack.insert(stack.end(), ijk, ijk + 3);
+          }
+        }
+      }
+    }
 
-  // Wrap scalars into an ITK image
-  typedef itk::Image<T, 3> ImageType;
-  typename ImageType::Pointer image = ImageType::New();
-  image->GetPixelContainer()->SetImportPointer(scalars, dims[0]*dims[1]*dims[2], false);
-  image->SetOrigin( origin );
-  image->SetSpacing( spacing );
-
-  typename ImageType::RegionType region;
-  typename ImageType::IndexType index;
-  typename ImageType::SizeType size;
-  index[0] = extent[0];
-  index[1] = extent[2];
-  index[2] = extent[4];
-  region.SetIndex( index );
-  size[0] = extent[1] - extent[0] + 1;
-  size[1] = extent[3] - extent[2] + 1;
-  size[2] = extent[5] - extent[4] + 1;
-  region.SetSize( size );
-  image->SetRegions(region);
-
-  // Trace the level curve using itk::LevelTracingImageFilter
-  typedef itk::Image<unsigned char, 3> LabelImageType;
-  typedef itk::LevelTracingImageFilter<ImageType, LabelImageType> LevelTracingType;
-  typename LevelTracingType::Pointer tracing = LevelTracingType::New();
-
-  typename ImageType::IndexType seedIndex;
-  seedIndex[0] = seed[0];
-  seedIndex[1] = seed[1];
-  seedIndex[2] = seed[2];
-
-  tracing->SetSeed(seedIndex);
-
-  tracing->SetInput( image );
-  tracing->Update();
-
-  // Copy to the output
-  memcpy(oscalars, tracing->GetOutput()->GetBufferPointer(),
-         tracing->GetOutput()->GetBufferedRegion().GetNumberOfPixels());
-
+  vtkITKLevelTracing3DThreadData<unsigned char> cleanData;
+  cleanData.Scalars = oscalars;
+  cleanData.Output = oscalars;
+  std::copy(dims, dims + 3, cleanData.Dims);
+  cleanData.Threshold = 0;
+  threader->SetSingleMethod(vtkITKLevelTracing3DCleanThreadFunction, &cleanData);
+  threader->SingleMethodExecute();
 }
 
 //
@@ -110,17 +243,8 @@ int vtkITKLevelTracing3DImageFilter::RequestData(
   vtkImageData *output = vtkImageData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  output->SetExtent(
-    outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()));
-  output->AllocateScalars(outInfo);
-
-  vtkUnsignedCharArray *oScalars
-    = vtkUnsignedCharArray::SafeDownCast(output->GetPointData()->GetScalars());
-  void* os = oScalars->GetVoidPointer(0);
-
   vtkDataArray *inScalars;
   int dims[3], extent[6];
-  double spacing[3], origin[3];
 
   vtkDebugMacro(<< "Executing level tracing");
 
@@ -141,64 +265,98 @@ int vtkITKLevelTracing3DImageFilter::RequestData(
   }
 
   input->GetDimensions(dims);
-  input->GetOrigin(origin);
-  input->GetSpacing(spacing);
 
   inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent);
 
-////////// These types are not defined in itk::NumericTraits ////////////
-#ifdef vtkTemplateMacroCase_ui64
-#undef vtkTemplateMacroCase_ui64
-# define vtkTemplateMacroCase_ui64(typeN, type, call)
-#endif
-#ifdef vtkTemplateMacroCase_si64
-#undef vtkTemplateMacroCase_si64
-# define vtkTemplateMacroCase_si64(typeN, type, call)
-#endif
-#ifdef vtkTemplateMacroCase_ll
-#undef vtkTemplateMacroCase_ll
-# define vtkTemplateMacroCase_ll(typeN, type, call)
-#endif
-  if (inScalars->GetNumberOfComponents() == 1 )
-  {
-    void* scalars = inScalars->GetVoidPointer(0);
-    switch (inScalars->GetDataType())
+  output->SetExtent(
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()));
+
+  for (int axis = 0; axis < 3; ++axis)
     {
-      vtkTemplateMacro(
-        vtkITKLevelTracing3DTrace(this, static_cast<VTK_TT*>(scalars),
-                                  dims,extent,origin,spacing,
-                                  (unsigned char*) os,this->Seed)
-        );
-    } //switch
-  }
-  else if (inScalars->GetNumberOfComponents() == 3)
+    if (this->Seed[axis] < extent[2 * axis] || this->Seed[axis] > extent[2 * axis + 1])
+      {
+      vtkErrorMacro(<< "Seed is outside of the image");
+      return 1;
+      }
+    }
+
+  vtkDataArray* traceScalars = inScalars;
+  if (inScalars->GetNumberOfComponents() == 3)
     {
-    // RGB - convert for now...
-    vtkSmartPointer<vtkUnsignedCharArray> grayScalars
-      = vtkUnsignedCharArray::New();
-    grayScalars->SetNumberOfTuples( inScalars->GetNumberOfTuples() );
-
-    double in[3];
-    unsigned char out;
-    for (vtkIdType i=0; i < inScalars->GetNumberOfTuples(); ++i)
+    // RGB - convert for now... only once per input modification
+    if (!this->Internal->GrayScalars || this->Internal->InputMTime != input->GetMTime())
       {
-      inScalars->GetTuple(i, in);
+      vtkSmartPointer<vtkUnsignedCharArray> grayScalars
+        = vtkSmartPointer<vtkUnsignedCharArray>::New();
+      grayScalars->SetNumberOfTuples( inScalars->GetNumberOfTuples() );
 
-      out = static_cast<unsigned char>((2125.0 * in[0] +  7154.0 * in[1] +  0721.0 * in[2]) / 10000.0);
+      double in[3];
+      unsigned char out;
+      for (vtkIdType i=0; i < inScalars->GetNumberOfTuples(); ++i)
+        {
+        inScalars->GetTuple(i, in);
 
-      grayScalars->SetTypedTuple(i, &out);
-      }
+        out = static_cast<unsigned char>((2125.0 * in[0] +  7154.0 * in[1] +  0721.0 * in[2]) / 10000.0);
 
-    vtkITKLevelTracing3DTrace(this,
-                              (unsigned char *)grayScalars->GetVoidPointer(0),
-                              dims, extent, origin, spacing,
-                              (unsigned char *)os, this->Seed);
+        grayScalars->SetTypedTuple(i, &out);
+        }
+      this->Internal->GrayScalars = grayScalars;
+      }
+    traceScalars = this->Internal->GrayScalars;
     }
-  else
+  else if (inScalars->GetNumberOfComponents() != 1)
     {
     vtkErrorMacro(<< "Can only trace scalar and RGB images.");
+    return 1;
     }
+  else
+    {
+    this->Internal->GrayScalars = 0;
+    }
+
+  // A seed on the last traced surface, at the same level, gives the same
+  // surface: reuse it.
+  const vtkIdType seedIndex = (this->Seed[0] - extent[0])
+    + (this->Seed[1] - extent[2]) * static_cast<vtkIdType>(dims[0])
+    + (this->Seed[2] - extent[4]) * static_cast<vtkIdType>(dims[0]) * dims[1];
+  const double threshold = traceScalars->GetComponent(seedIndex, 0);
+  vtkUnsignedCharArray* lastOutput = this->Internal->Output;
+  if (lastOutput
+      && this->Internal->InputMTime == input->GetMTime()
+      && this->Internal->Threshold == threshold
+      && std::equal(extent, extent + 6, this->Internal->Extent)
+      && lastOutput->GetValue(seedIndex) == 1)
+    {
+    vtkDebugMacro(<< "Reusing the surface traced at level " << threshold);
+    output->GetPointData()->SetScalars(lastOutput);
+    return 1;
+    }
+
+  output->AllocateScalars(outInfo);
+
+  vtkUnsignedCharArray *oScalars
+    = vtkUnsignedCharArray::SafeDownCast(output->GetPointData()->GetScalars());
+  void* os = oScalars->GetVoidPointer(0);
+
+  int numberOfThreads = this->NumberOfThreads > 0 ? this->NumberOfThreads
+    : vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  numberOfThreads = std::min(numberOfThreads, static_cast<int>(VTK_MAX_THREADS));
+  numberOfThreads = std::max(std::min(numberOfThreads, dims[2]), 1);
+
+  void* scalars = traceScalars->GetVoidPointer(0);
+  switch (traceScalars->GetDataType())
+    {
+    vtkTemplateMacro(
+      vtkITKLevelTracing3DTrace(this, static_cast<VTK_TT*>(scalars),
+                                dims, extent,
+                                (unsigned char*) os, this->Seed, numberOfThreads)
+      );
+    } //switch
 
+  this->Internal->Output = oScalars;
+  this->Internal->InputMTime = input->GetMTime();
+  this->Internal->Threshold = threshold;
+  std::copy(extent, extent + 6, this->Internal->Extent);
   return 1;
 }
 
@@ -237,4 +395,5 @@ void vtkITKLevelTracing3DImageFilter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Seed point location: [" << Seed[0] << "," << Seed[1] << "," << Seed[2] << "]"
     << std::endl;
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << std::endl;
 }
@@ -16,6 +16,10 @@
 /// This filter is specialized to volumes. If you are interested in
 /// contouring other types of data, use the general vtkContourFilter. If you
 /// want to contour an image (i.e., a volume slice), use vtkMarchingSquares.
+///
+/// The voxels of the level surface are found in parallel and the surface
+/// connected to the seed is then filled (face connectivity). The last
+/// surface is kept: a seed on it, at the same level, reuses it.
 class VTK_ITK_EXPORT vtkITKLevelTracing3DImageFilter : public vtkImageAlgorithm
 {
 public:
@@ -27,6 +31,11 @@ public:
   vtkSetVector3Macro(Seed, int);
   vtkGetVector3Macro(Seed, int);
 
+  /// Number of threads used to find the voxels of the level surface.
+  /// 0 (default) uses vtkMultiThreader::GetGlobalDefaultNumberOfThreads().
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
 protected:
   vtkITKLevelTracing3DImageFilter();
   ~vtkITKLevelTracing3DImageFilter();
@@ -36,6 +45,10 @@ protected:
   virtual int FillInputPortInformation(int port, vtkInformation *info);
 
   int Seed[3];
+  int NumberOfThreads;
+
+  class vtkInternal;
+  vtkInternal* Internal;
 
 private:
   vtkITKLevelTracing3DImageFilter(const vtkITKLevelTracing3DImageFilter&);  /// Not implemented.
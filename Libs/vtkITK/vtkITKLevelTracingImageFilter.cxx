@@ -23,11 +23,101 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkStructuredPoints.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
 
 #include "itkExtractImageFilter.h"
 
+#include <algorithm>
+#include <deque>
+#include <vector>
+
 vtkStandardNewMacro(vtkITKLevelTracingImageFilter);
 
+/// Number of traces kept for the current slice
+static const size_t MAXIMUM_NUMBER_OF_CACHED_TRACES = 16;
+
+//----------------------------------------------------------------------------
+class vtkITKLevelTracingImageFilter::vtkInternal
+{
+public:
+  vtkInternal()
+    {
+    this->InputMTime = 0;
+    this->InputScalarType = VTK_VOID;
+    this->Plane = -1;
+    this->SliceIndex = -1;
+    this->GrayScalarsMTime = 0;
+    }
+
+  /// Discard the cached slice and traces if the input, the plane or the
+  /// slice changed.
+  void UpdateSliceKey(vtkMTimeType inputMTime, int scalarType, int plane, int sliceIndex)
+    {
+    if (inputMTime == this->InputMTime && scalarType == this->InputScalarType
+        && plane == this->Plane && sliceIndex == this->SliceIndex)
+      {
+      return;
+      }
+    this->InputMTime = inputMTime;
+    this->InputScalarType = scalarType;
+    this->Plane = plane;
+    this->SliceIndex = sliceIndex;
+    this->Slice = 0;
+    this->Traces.clear();
+    }
+
+  struct Trace
+    {
+    double Threshold;
+    /// Sorted indices, in the slice, of the pixels of the traced curve and
+    /// of the seeds it has been traced from.
+    std::vector<vtkIdType> Pixels;
+    vtkSmartPointer<vtkPolyData> Output;
+    };
+
+  /// Return the cached trace from \a pixel at \a threshold, if any.
+  /// Any pixel of a traced curve gives the same curve at the same level.
+  Trace* FindTrace(double threshold, vtkIdType pixel)
+    {
+    for (std::deque<Trace>::iterator it = this->Traces.begin(); it != this->Traces.end(); ++it)
+      {
+      if (it->Threshold == threshold
+          && std::binary_search(it->Pixels.begin(), it->Pixels.end(), pixel))
+        {
+        return &(*it);
+        }
+      }
+    return 0;
+    }
+
+  void AddTrace(double threshold, std::vector<vtkIdType>& pixels, vtkPolyData* output)
+    {
+    if (this->Traces.size() >= MAXIMUM_NUMBER_OF_CACHED_TRACES)
+      {
+      this->Traces.pop_back();
+      }
+    this->Traces.push_front(Trace());
+    Trace& trace = this->Traces.front();
+    trace.Threshold = threshold;
+    std::sort(pixels.begin(), pixels.end());
+    trace.Pixels.swap(pixels);
+    trace.Output = vtkSmartPointer<vtkPolyData>::New();
+    trace.Output->DeepCopy(output);
+    }
+
+  vtkMTimeType InputMTime;
+  int InputScalarType;
+  int Plane;
+  int SliceIndex;
+  /// Slice extracted from the input (itk::Image<T, 2>)
+  itk::DataObject::Pointer Slice;
+  std::deque<Trace> Traces;
+
+  /// Grayscale conversion of RGB inputs
+  vtkSmartPointer<vtkUnsignedCharArray> GrayScalars;
+  vtkMTimeType GrayScalarsMTime;
+};
+
 // Description:
 // Construct object with initial range (0,1) and single contour value
 // of 0.0. ComputeNormal is on, ComputeGradients is off and ComputeScalars is on.
@@ -38,90 +128,118 @@ vtkITKLevelTracingImageFilter::vtkITKLevelTracingImageFilter()
   this->Seed[2] = 0;
 
   this->Plane = 2;  // Default to XY plane
+
+  this->Internal = new vtkInternal;
 }
 
 vtkITKLevelTracingImageFilter::~vtkITKLevelTracingImageFilter()
 {
+  delete this->Internal;
 }
 
 
-template <class T>
-void vtkITKLevelTracingTrace(vtkITKLevelTracingImageFilter *vtkNotUsed(self), T* scalars,
-                             int dims[3], int extent[6], double origin[3], double spacing[3],
-                             vtkPoints *newPoints,
-                             vtkCellArray *newPolys,
-                             int seed[3], int plane)
+//----------------------------------------------------------------------------
+// Index of the seed in the slice of \a plane, origin and row size of the
+// slice.
+static void vtkITKLevelTracingSliceGeometry(int plane, const int dims[3], const int extent[6],
+                                            const int seed[3], itk::Index<2>& seed2D,
+                                            int sliceOrigin[2], int& sliceSizeX)
 {
-
-  // Wrap scalars into an ITK image
-  typedef itk::Image<T, 3> ImageType;
-  typename ImageType::Pointer image = ImageType::New();
-  image->GetPixelContainer()->SetImportPointer(scalars, dims[0]*dims[1]*dims[2], false);
-  image->SetOrigin( origin );
-  image->SetSpacing( spacing );
-
-  typename ImageType::RegionType region;
-  typename ImageType::IndexType index;
-  typename ImageType::SizeType size;
-  index[0] = extent[0];
-  index[1] = extent[2];
-  index[2] = extent[4];
-  region.SetIndex( index );
-  size[0] = extent[1] - extent[0] + 1;
-  size[1] = extent[3] - extent[2] + 1;
-  size[2] = extent[5] - extent[4] + 1;
-  region.SetSize( size );
-  image->SetRegions(region);
-
-  // Extract the 2D slice to process
-  typedef itk::Image<T,2> Image2DType;
-  typedef itk::ExtractImageFilter<ImageType, Image2DType> ExtractType;
-  typename ExtractType::Pointer extract = ExtractType::New();
-  extract->SetDirectionCollapseToIdentity(); //If you don't care about resulting image dimension
-
-  typedef typename ExtractType::InputImageRegionType ExtractionRegionType;
-  ExtractionRegionType extractRegion;
-  typename ExtractionRegionType::IndexType extractIndex;
-  typename ExtractionRegionType::SizeType extractSize;
-
-  extractIndex = index;
-  extractSize = size;
-  extract->SetInput( image );
-
-  // Trace the level curve using itk::LevelTracingImageFilter
-  typedef itk::LevelTracingImageFilter<Image2DType, Image2DType> LevelTracingType;
-  typename LevelTracingType::Pointer tracing = LevelTracingType::New();
-
-  itk::Index<2> seed2D = {{0,0}};
   switch(plane)
   {
+  default:
   case 0: //JK plane
     seed2D[0] = seed[1];
     seed2D[1] = seed[2];
-    extractSize[0] = 0;
-    extractIndex[0] = seed[0];
+    sliceOrigin[0] = extent[2];
+    sliceOrigin[1] = extent[4];
+    sliceSizeX = dims[1];
     break;
   case 1:  //IK plane
     seed2D[0] = seed[0];
     seed2D[1] = seed[2];
-    extractSize[1] = 0;
-    extractIndex[1] = seed[1];
+    sliceOrigin[0] = extent[0];
+    sliceOrigin[1] = extent[4];
+    sliceSizeX = dims[0];
     break;
   case 2:  //IJ plane (axials)
     seed2D[0] = seed[0];
     seed2D[1] = seed[1];
-    extractSize[2] = 0;
-    extractIndex[2] = seed[2];
+    sliceOrigin[0] = extent[0];
+    sliceOrigin[1] = extent[2];
+    sliceSizeX = dims[0];
     break;
   }
+}
 
-  extractRegion.SetIndex( extractIndex );
-  extractRegion.SetSize( extractSize );
-  extract->SetExtractionRegion( extractRegion );
+template <class T>
+void vtkITKLevelTracingTrace(vtkITKLevelTracingImageFilter *vtkNotUsed(self), T* scalars,
+                             int dims[3], int extent[6], double origin[3], double spacing[3],
+                             vtkPoints *newPoints,
+                             vtkCellArray *newPolys,
+                             int seed[3], int plane,
+                             itk::DataObject::Pointer& cachedSlice,
+                             std::vector<vtkIdType>& pixels)
+{
+  typedef itk::Image<T, 3> ImageType;
+  typedef itk::Image<T,2> Image2DType;
 
-  tracing->SetSeed(seed2D);
+  itk::Index<2> seed2D = {{0,0}};
+  int sliceOrigin[2] = {0, 0};
+  int sliceSizeX = 0;
+  vtkITKLevelTracingSliceGeometry(plane, dims, extent, seed, seed2D, sliceOrigin, sliceSizeX);
 
-  tracing->SetInput( extract->GetOutput() );
+  Image2DType* slice = dynamic_cast<Image2DType*>(cachedSlice.GetPointer());
+  if (!slice)
+    {
+    // Wrap scalars into an ITK image
+    typename ImageType::Pointer image = ImageType::New();
+    image->GetPixelContainer()->SetImportPointer(scalars, dims[0]*dims[1]*dims[2], false);
+    image->SetOrigin( origin );
+    image->SetSpacing( spacing );
+
+    typename ImageType::RegionType region;
+    typename ImageType::IndexType index;
+    typename ImageType::SizeType size;
+    index[0] = extent[0];
+    index[1] = extent[2];
+    index[2] = extent[4];
+    region.SetIndex( index );
+    size[0] = extent[1] - extent[0] + 1;
+    size[1] = extent[3] - extent[2] + 1;
+    size[2] = extent[5] - extent[4] + 1;
+    region.SetSize( size );
+    image->SetRegions(region);
+
+    // Extract the 2D slice to process, it is reused until the slice changes
+    typedef itk::ExtractImageFilter<ImageType, Image2DType> ExtractType;
+    typename ExtractType::Pointer extract = ExtractType::New();
+    extract->SetDirectionCollapseToIdentity(); //If you don't care about resulting image dimension
+
+    typedef typename ExtractType::InputImageRegionType ExtractionRegionType;
+    ExtractionRegionType extractRegion;
+    typename ExtractionRegionType::IndexType extractIndex = index;
+    typename ExtractionRegionType::SizeType extractSize = size;
+    extractSize[plane] = 0;
+    extractIndex[plane] = seed[plane];
+
+    extractRegion.SetIndex( extractIndex );
+    extractRegion.SetSize( extractSize );
+    extract->SetExtractionRegion( extractRegion );
+    extract->SetInput( image );
+    extract->Update();
+
+    typename Image2DType::Pointer extracted = extract->GetOutput();
+    extracted->DisconnectPipeline();
+    cachedSlice = extracted.GetPointer();
+    slice = extracted.GetPointer();
+    }
+
+  // Trace the level curve using itk::LevelTracingImageFilter
+  typedef itk::LevelTracingImageFilter<Image2DType, Image2DType> LevelTracingType;
+  typename LevelTracingType::Pointer tracing = LevelTracingType::New();
+  tracing->SetSeed(seed2D);
+  tracing->SetInput( slice );
   tracing->Update();
 
   // Convert chain code output to points and polys (remember to put
@@ -149,6 +267,7 @@ void vtkITKLevelTracingTrace(vtkITKLevelTracingImageFilter *vtkNotUsed(self), T*
 
   unsigned int i=0;
   typename ImageType::IndexType chain3D;
+  pixels.reserve(pixels.size() + numberChain);
 
   do
     {
@@ -173,6 +292,8 @@ void vtkITKLevelTracingTrace(vtkITKLevelTracingImageFilter *vtkNotUsed(self), T*
       }
 
     newPoints->InsertPoint(i, chain3D[0], chain3D[1], chain3D[2]);
+    pixels.push_back((chainTemp[0] - sliceOrigin[0])
+      + static_cast<vtkIdType>(chainTemp[1] - sliceOrigin[1]) * sliceSizeX);
     ptIds[i] = i;
     offset = chain->IncrementInput(i);
     chainTemp[0] = chainTemp[0] + offset[0];
@@ -236,14 +357,78 @@ int vtkITKLevelTracingImageFilter::RequestData(
 
   inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent);
 
-  // estimate the number of points from the volume dimensions
-  estimatedSize = (int) pow ((double) (dims[0] * dims[1] * dims[2]), .75);
-  estimatedSize = estimatedSize / 1024 * 1024; //multiple of 1024
-  if (estimatedSize < 1024)
-  {
-    estimatedSize = 1024;
-  }
-  vtkDebugMacro(<< "Estimated allocation size is " << estimatedSize);
+  if (this->Plane < 0 || this->Plane > 2)
+    {
+    vtkErrorMacro(<< "Invalid plane " << this->Plane);
+    return 1;
+    }
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    if (this->Seed[axis] < extent[2 * axis] || this->Seed[axis] > extent[2 * axis + 1])
+      {
+      vtkErrorMacro(<< "Seed is outside of the image");
+      return 1;
+      }
+    }
+  if (inScalars->GetNumberOfComponents() != 1 && inScalars->GetNumberOfComponents() != 3)
+    {
+    vtkErrorMacro(<< "Can only trace scalar and RGB images.");
+    return 1;
+    }
+  this->Internal->UpdateSliceKey(input->GetMTime(), inScalars->GetDataType(),
+                                 this->Plane, this->Seed[this->Plane]);
+
+  vtkDataArray* traceScalars = inScalars;
+  if (inScalars->GetNumberOfComponents() == 3)
+    {
+    // RGB - convert for now... only once per input modification
+    if (!this->Internal->GrayScalars
+        || this->Internal->GrayScalarsMTime != input->GetMTime())
+      {
+      vtkSmartPointer<vtkUnsignedCharArray> grayScalars
+        = vtkSmartPointer<vtkUnsignedCharArray>::New();
+      grayScalars->SetNumberOfTuples( inScalars->GetNumberOfTuples() );
+
+      double in[3];
+      unsigned char out;
+      for (vtkIdType i=0; i < inScalars->GetNumberOfTuples(); ++i)
+        {
+        inScalars->GetTuple(i, in);
+
+        out = static_cast<unsigned char>((2125.0 * in[0] +  7154.0 * in[1] +  0721.0 * in[2]) / 10000.0);
+
+        grayScalars->SetTypedTuple(i, &out);
+        }
+      this->Internal->GrayScalars = grayScalars;
+      this->Internal->GrayScalarsMTime = input->GetMTime();
+      }
+    traceScalars = this->Internal->GrayScalars;
+    }
+
+  // Moving the cursor along a curve that has already been traced at the
+  // same level gives the same curve, reuse it
+  const vtkIdType seedOffset = (this->Seed[0] - extent[0])
+    + (this->Seed[1] - extent[2]) * static_cast<vtkIdType>(dims[0])
+    + (this->Seed[2] - extent[4]) * static_cast<vtkIdType>(dims[0]) * dims[1];
+  const double threshold = traceScalars->GetComponent(seedOffset, 0);
+  itk::Index<2> seed2D = {{0,0}};
+  int sliceOrigin[2] = {0, 0};
+  int sliceSizeX = 0;
+  vtkITKLevelTracingSliceGeometry(this->Plane, dims, extent, this->Seed,
+                                  seed2D, sliceOrigin, sliceSizeX);
+  const vtkIdType seedPixel = (seed2D[0] - sliceOrigin[0])
+    + static_cast<vtkIdType>(seed2D[1] - sliceOrigin[1]) * sliceSizeX;
+  vtkInternal::Trace* cachedTrace = this->Internal->FindTrace(threshold, seedPixel);
+  if (cachedTrace)
+    {
+    vtkDebugMacro(<< "Reusing the curve traced at level " << threshold);
+    output->DeepCopy(cachedTrace->Output);
+    return 1;
+    }
+
+  // the curves are short, there is no need to estimate their size from
+  // the volume dimensions
+  estimatedSize = 1024;
 
   newPts = vtkPoints::New();
   newPts->Allocate(estimatedSize,estimatedSize/2);
@@ -251,6 +436,9 @@ int vtkITKLevelTracingImageFilter::RequestData(
   newPolys = vtkCellArray::New();
   newPolys->Allocate(newPolys->EstimateSize(estimatedSize,2));
 
+  std::vector<vtkIdType> pixels;
+  pixels.push_back(seedPixel);
+
 ////////// These types are not defined in itk::NumericTraits ////////////
 #ifdef vtkTemplateMacroCase_ui64
 #undef vtkTemplateMacroCase_ui64
@@ -264,46 +452,17 @@ int vtkITKLevelTracingImageFilter::RequestData(
 #undef vtkTemplateMacroCase_ll
 # define vtkTemplateMacroCase_ll(typeN, type, call)
 #endif
-  if (inScalars->GetNumberOfComponents() == 1 )
+  void* scalars = traceScalars->GetVoidPointer(0);
+  switch (traceScalars->GetDataType())
   {
-    void* scalars = inScalars->GetVoidPointer(0);
-    switch (inScalars->GetDataType())
-    {
-      vtkTemplateMacro(
-        vtkITKLevelTracingTrace(this, static_cast<VTK_TT*>(scalars),
-        dims,extent,origin,spacing,
-        newPts,newPolys,this->Seed, this->Plane
-        )
-        );
-    } //switch
-  }
-  else if (inScalars->GetNumberOfComponents() == 3)
-    {
-    // RGB - convert for now...
-    vtkSmartPointer<vtkUnsignedCharArray> grayScalars
-      = vtkUnsignedCharArray::New();
-    grayScalars->SetNumberOfTuples( inScalars->GetNumberOfTuples() );
-
-    double in[3];
-    unsigned char out;
-    for (vtkIdType i=0; i < inScalars->GetNumberOfTuples(); ++i)
-      {
-      inScalars->GetTuple(i, in);
-
-      out = static_cast<unsigned char>((2125.0 * in[0] +  7154.0 * in[1] +  0721.0 * in[2]) / 10000.0);
-
-      grayScalars->SetTypedTuple(i, &out);
-      }
-
-    vtkITKLevelTracingTrace(this,
-                            (unsigned char *)grayScalars->GetVoidPointer(0),
-                            dims, extent, origin, spacing,
-                            newPts, newPolys, this->Seed, this->Plane);
-    }
-  else
-    {
-    vtkErrorMacro(<< "Can only trace scalar and RGB images.");
-    }
+    vtkTemplateMacro(
+      vtkITKLevelTracingTrace(this, static_cast<VTK_TT*>(scalars),
+      dims,extent,origin,spacing,
+      newPts,newPolys,this->Seed, this->Plane,
+      this->Internal->Slice, pixels
+      )
+      );
+  } //switch
 
   vtkDebugMacro(<<"Created: "
     << newPts->GetNumberOfPoints() << " points. " );
@@ -318,12 +477,24 @@ int vtkITKLevelTracingImageFilter::RequestData(
   newPolys->Delete();
 
   output->Squeeze();
+
+  this->Internal->AddTrace(threshold, pixels, output);
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkITKLevelTracingImageFilter::ClearCache()
+{
+  this->Internal->UpdateSliceKey(0, VTK_VOID, -1, -1);
+  this->Internal->GrayScalars = 0;
+  this->Internal->GrayScalarsMTime = 0;
+}
 
-
-
+//----------------------------------------------------------------------------
+int vtkITKLevelTracingImageFilter::GetNumberOfCachedTraces()
+{
+  return static_cast<int>(this->Internal->Traces.size());
+}
 
 int vtkITKLevelTracingImageFilter::FillInputPortInformation(int, vtkInformation *info)
 {
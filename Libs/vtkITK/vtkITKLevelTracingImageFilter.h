@@ -16,6 +16,11 @@
 /// This filter is specialized to volumes. If you are interested in
 /// contouring other types of data, use the general vtkContourFilter. If you
 /// want to contour an image (i.e., a volume slice), use vtkMarchingSquares.
+///
+/// The filter is meant to be updated on every mouse move: the extracted
+/// slice is kept until the input, the plane or the slice changes, and the
+/// last traced curves are kept with their level. A seed on one of these
+/// curves, at the same level, reuses the curve without tracing again.
 class VTK_ITK_EXPORT vtkITKLevelTracingImageFilter : public vtkPolyDataAlgorithm
 {
 public:
@@ -35,6 +40,13 @@ public:
   void SetPlaneToIK() {this->SetPlane(1);}
   void SetPlaneToJK() {this->SetPlane(0);}
 
+  /// Discard the extracted slice and the traced curves.
+  /// They are discarded automatically when the input is modified.
+  void ClearCache();
+
+  /// Number of traced curves kept for the current slice.
+  int GetNumberOfCachedTraces();
+
 protected:
   vtkITKLevelTracingImageFilter();
   ~vtkITKLevelTracingImageFilter();
@@ -45,6 +57,9 @@ protected:
   int Seed[3];
   int Plane;
 
+  class vtkInternal;
+  vtkInternal* Internal;
+
 private:
   vtkITKLevelTracingImageFilter(const vtkITKLevelTracingImageFilter&);  /// Not implemented.
   void operator=(const vtkITKLevelTracingImageFilter&);  /// Not implemented.
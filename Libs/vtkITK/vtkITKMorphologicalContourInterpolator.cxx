@@ -23,24 +23,35 @@
 
 vtkStandardNewMacro(vtkITKMorphologicalContourInterpolator);
 
+class vtkITKMorphologicalContourInterpolator::vtkInternal
+{
+public:
+  /// Filter kept between executions in incremental mode (its type depends on the scalar type)
+  itk::ProcessObject::Pointer Filter;
+};
+
 vtkITKMorphologicalContourInterpolator::vtkITKMorphologicalContourInterpolator()
   : Label(0)
   , Axis(-1)
   , HeuristicAlignment(true)
   , UseDistanceTransform(false)
   , UseBallStructuringElement(false)
+  , Incremental(false)
 {
+  this->Internal = new vtkInternal;
 }
 
 vtkITKMorphologicalContourInterpolator::~vtkITKMorphologicalContourInterpolator()
 {
+  delete this->Internal;
+  this->Internal = NULL;
 }
 
 
 template <class T>
 void vtkITKMorphologicalContourInterpolatorExecute(vtkITKMorphologicalContourInterpolator *self, vtkImageData* input,
                 vtkImageData* vtkNotUsed(output),
-                T* inPtr, T* outPtr)
+                T* inPtr, T* outPtr, itk::ProcessObject::Pointer& keptFilter)
 {
 
   int dims[3];
@@ -67,15 +78,26 @@ void vtkITKMorphologicalContourInterpolatorExecute(vtkITKMorphologicalContourInt
   inImage->SetSpacing(spacing);
 
 
-  // Calculate the distance transform
+  // Interpolate. In incremental mode the filter of the previous execution is reused,
+  // as it keeps the interpolations between unchanged slices.
   typedef itk::MorphologicalContourInterpolator<ImageType> ContourInterpolatorType;
-  typename ContourInterpolatorType::Pointer interpolatorFilter = ContourInterpolatorType::New();
+  typename ContourInterpolatorType::Pointer interpolatorFilter;
+  if (self->GetIncremental())
+    {
+    interpolatorFilter = dynamic_cast<ContourInterpolatorType*>(keptFilter.GetPointer());
+    }
+  if (interpolatorFilter.IsNull())
+    {
+    interpolatorFilter = ContourInterpolatorType::New();
+    }
+  keptFilter = self->GetIncremental() ? interpolatorFilter.GetPointer() : NULL;
 
   interpolatorFilter->SetLabel(static_cast<T>(self->GetLabel()));
   interpolatorFilter->SetAxis(self->GetAxis());
   interpolatorFilter->SetHeuristicAlignment(self->GetHeuristicAlignment());
   interpolatorFilter->SetUseDistanceTransform(self->GetUseDistanceTransform());
   interpolatorFilter->SetUseBallStructuringElement(self->GetUseBallStructuringElement());
+  interpolatorFilter->SetIncremental(self->GetIncremental());
 
   interpolatorFilter->SetInput( inImage );
   interpolatorFilter->Update();
@@ -84,6 +106,9 @@ void vtkITKMorphologicalContourInterpolatorExecute(vtkITKMorphologicalContourInt
   memcpy(outPtr, interpolatorFilter->GetOutput()->GetBufferPointer(),
          interpolatorFilter->GetOutput()->GetBufferedRegion().GetNumberOfPixels() * sizeof(T));
 
+  // The input buffer is owned by VTK, do not keep a reference to it
+  interpolatorFilter->SetInput(NULL);
+
 }
 
 
@@ -120,7 +145,7 @@ void vtkITKMorphologicalContourInterpolator::SimpleExecute(vtkImageData *input,
 #undef VTK_TYPE_USE_LONG_LONG
 #undef VTK_TYPE_USE___INT64
 
-#define CALL  vtkITKMorphologicalContourInterpolatorExecute(this, input, output, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr));
+#define CALL  vtkITKMorphologicalContourInterpolatorExecute(this, input, output, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr), this->Internal->Filter);
 
     void* inPtr = input->GetScalarPointer();
     void* outPtr = output->GetScalarPointer();
@@ -152,4 +177,5 @@ void vtkITKMorphologicalContourInterpolator::PrintSelf(ostream& os, vtkIndent in
   os << indent << "HeuristicAlignment: " << HeuristicAlignment << std::endl;
   os << indent << "UseDistanceTransform: " << UseDistanceTransform << std::endl;
   os << indent << "UseBallStructuringElement: " << UseBallStructuringElement << std::endl;
+  os << indent << "Incremental: " << Incremental << std::endl;
 }
@@ -44,6 +44,14 @@ public:
   vtkGetMacro(UseBallStructuringElement, bool);
   vtkSetMacro(UseBallStructuringElement, bool);
 
+  /// Reuse interpolations of the previous execution between pairs of slices that have not changed.
+  /// When the input is updated after each newly drawn slice, only the gaps next to the
+  /// modified slices are interpolated again. Input extent must remain the same.
+  /// Default is OFF.
+  vtkGetMacro(Incremental, bool);
+  vtkSetMacro(Incremental, bool);
+  vtkBooleanMacro(Incremental, bool);
+
 protected:
   vtkITKMorphologicalContourInterpolator();
   ~vtkITKMorphologicalContourInterpolator();
@@ -55,6 +63,10 @@ protected:
   bool HeuristicAlignment;
   bool UseDistanceTransform;
   bool UseBallStructuringElement;
+  bool Incremental;
+
+  class vtkInternal;
+  vtkInternal* Internal;
 
 private:
   vtkITKMorphologicalContourInterpolator(const vtkITKMorphologicalContourInterpolator&);  /// Not implemented.
@@ -66,6 +66,18 @@ public:
   int GetNumberOfVolumes()
   { DelegateITKOutputMacro ( GetNumberOfVolumes ); };
 
+  /// Get/Set the number of images after the current image that are read ahead
+  void SetNumberOfPrefetchedImages ( unsigned int value )
+  { DelegateITKInputMacro ( SetNumberOfPrefetchedImages, value); };
+  unsigned int GetNumberOfPrefetchedImages()
+  { DelegateITKOutputMacro ( GetNumberOfPrefetchedImages ); };
+
+  /// Get/Set if the database files are memory mapped (takes effect at next connect)
+  void SetUseMemoryMapping ( bool value )
+  { DelegateITKInputMacro ( SetUseMemoryMapping, value); };
+  bool GetUseMemoryMapping()
+  { DelegateITKOutputMacro ( GetUseMemoryMapping ); };
+
 protected:
   vtkITKTimeSeriesDatabase()
     {
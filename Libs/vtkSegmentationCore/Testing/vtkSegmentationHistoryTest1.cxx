@@ -0,0 +1,180 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Csaba Pinter, PerkLab, Queen's University
+  and was supported through the Applied Cancer Research Unit program of Cancer Care
+  Ontario with funds provided by the Ontario Ministry of Health and Long-Term Care
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// SegmentationCore includes
+#include "vtkOrientedImageData.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+#include "vtkSegmentationHistory.h"
+
+namespace
+{
+//----------------------------------------------------------------------------
+void FillLabelmap(vtkOrientedImageData* imageData, int cubeSize)
+{
+  imageData->SetExtent(0, 63, 0, 63, 0, 63);
+  imageData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char* voxels = static_cast<unsigned char*>(imageData->GetScalarPointer());
+  for (int k = 0; k < 64; ++k)
+    {
+    for (int j = 0; j < 64; ++j)
+      {
+      for (int i = 0; i < 64; ++i)
+        {
+        *(voxels++) = (i < cubeSize && j < cubeSize && k < cubeSize) ? 1 : 0;
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int GetNumberOfNonZeroVoxels(vtkSegmentation* segmentation, const std::string& segmentId)
+{
+  vtkOrientedImageData* imageData = vtkOrientedImageData::SafeDownCast(
+    segmentation->GetSegmentRepresentation(segmentId,
+    vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
+  if (!imageData || !imageData->GetPointData()->GetScalars())
+    {
+    return -1;
+    }
+  int numberOfNonZeroVoxels = 0;
+  unsigned char* voxels = static_cast<unsigned char*>(imageData->GetScalarPointer());
+  for (vtkIdType i = 0; i < imageData->GetNumberOfPoints(); ++i)
+    {
+    if (voxels[i] != 0)
+      {
+      numberOfNonZeroVoxels++;
+      }
+    }
+  return numberOfNonZeroVoxels;
+}
+}
+
+//----------------------------------------------------------------------------
+int vtkSegmentationHistoryTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  const std::string labelmapName = vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName();
+
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetMasterRepresentationName(labelmapName);
+
+  vtkNew<vtkOrientedImageData> labelmap;
+  FillLabelmap(labelmap.GetPointer(), 10);
+  vtkNew<vtkSegment> segment;
+  segment->SetName("cube");
+  segment->AddRepresentation(labelmapName, labelmap.GetPointer());
+  segmentation->AddSegment(segment.GetPointer(), "cube");
+
+  vtkNew<vtkSegmentationHistory> history;
+  history->SetSegmentation(segmentation.GetPointer());
+  if (!history->SaveState())
+    {
+    std::cerr << __LINE__ << ": Failed to save state!" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Labelmaps are stored compressed
+  vtkIdType compressedMemorySize = history->GetMemorySize();
+  if (compressedMemorySize <= 0 || compressedMemorySize >= 64 * 64 * 64)
+    {
+    std::cerr << __LINE__ << ": Unexpected memory size of compressed state: " << compressedMemorySize << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Modify the labelmap and undo the change
+  FillLabelmap(labelmap.GetPointer(), 20);
+  labelmap->Modified();
+  segment->Modified();
+  if (!history->RestorePreviousState())
+    {
+    std::cerr << __LINE__ << ": Failed to restore previous state!" << std::endl;
+    return EXIT_FAILURE;
+    }
+  int numberOfVoxels = GetNumberOfNonZeroVoxels(segmentation.GetPointer(), "cube");
+  if (numberOfVoxels != 10 * 10 * 10)
+    {
+    std::cerr << __LINE__ << ": Undo failed: expected 1000 non-zero voxels, found " << numberOfVoxels << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkOrientedImageData* restoredLabelmap = vtkOrientedImageData::SafeDownCast(
+    segmentation->GetSegmentRepresentation("cube", labelmapName));
+  if (vtkSegmentationHistory::IsCompressedLabelmap(restoredLabelmap))
+    {
+    std::cerr << __LINE__ << ": Restored labelmap is not decompressed!" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Redo
+  if (!history->RestoreNextState())
+    {
+    std::cerr << __LINE__ << ": Failed to restore next state!" << std::endl;
+    return EXIT_FAILURE;
+    }
+  numberOfVoxels = GetNumberOfNonZeroVoxels(segmentation.GetPointer(), "cube");
+  if (numberOfVoxels != 20 * 20 * 20)
+    {
+    std::cerr << __LINE__ << ": Redo failed: expected 8000 non-zero voxels, found " << numberOfVoxels << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Without compression the full labelmap is stored
+  history->RemoveAllStates();
+  history->CompressLabelmapsOff();
+  history->SaveState();
+  if (history->GetMemorySize() < 64 * 64 * 64)
+    {
+    std::cerr << __LINE__ << ": Unexpected memory size of uncompressed state: " << history->GetMemorySize() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Memory limit removes the oldest states but keeps the last two
+  for (int i = 0; i < 4; ++i)
+    {
+    vtkOrientedImageData* currentLabelmap = vtkOrientedImageData::SafeDownCast(
+      segmentation->GetSegmentRepresentation("cube", labelmapName));
+    FillLabelmap(currentLabelmap, 5 + i);
+    currentLabelmap->Modified();
+    history->SaveState();
+    }
+  if (history->GetNumberOfStates() != 5)
+    {
+    std::cerr << __LINE__ << ": Expected 5 states, found " << history->GetNumberOfStates() << std::endl;
+    return EXIT_FAILURE;
+    }
+  history->SetMaximumMemorySize(1);
+  if (history->GetNumberOfStates() != 2)
+    {
+    std::cerr << __LINE__ << ": Expected 2 states after setting memory limit, found " << history->GetNumberOfStates() << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!history->IsRestorePreviousStateAvailable())
+    {
+    std::cerr << __LINE__ << ": Undo is not available after memory limit is applied!" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Segmentation history test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -25,6 +25,10 @@
 #include <vtkSphereSource.h>
 #include <vtkMatrix4x4.h>
 #include <vtkImageAccumulate.h>
+#include <vtkCallbackCommand.h>
+#include <vtkCommand.h>
+#include <vtkDataArray.h>
+#include <vtkPointData.h>
 
 // SegmentationCore includes
 #include "vtkSegmentation.h"
@@ -37,6 +41,14 @@
 
 void CreateSpherePolyData(vtkPolyData* polyData);
 void CreateCubeLabelmap(vtkOrientedImageData* imageData);
+void CreateBoxLabelmap(vtkOrientedImageData* imageData, int boxExtent[6]);
+
+//----------------------------------------------------------------------------
+void ProgressCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid), void* clientData, void* vtkNotUsed(callData))
+{
+  int* numberOfProgressEvents = reinterpret_cast<int*>(clientData);
+  (*numberOfProgressEvents)++;
+}
 
 //----------------------------------------------------------------------------
 int vtkSegmentationTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
@@ -264,6 +276,178 @@ int vtkSegmentationTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
     return EXIT_FAILURE;
     }
 
+  //////////////////////////////////////////////////////////////////////////
+  // Convert multiple segments using multiple threads
+
+  vtkNew<vtkSegmentation> multiSegmentation;
+  multiSegmentation->SetMasterRepresentationName(
+    vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName() );
+  multiSegmentation->SetNumberOfConversionThreads(3);
+  const int numberOfMultiSegments = 5;
+  for (int segmentIndex = 0; segmentIndex < numberOfMultiSegments; ++segmentIndex)
+    {
+    vtkNew<vtkOrientedImageData> multiCubeImageData;
+    CreateCubeLabelmap(multiCubeImageData.GetPointer());
+    vtkNew<vtkSegment> multiSegment;
+    multiSegment->AddRepresentation(
+      vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), multiCubeImageData.GetPointer());
+    multiSegmentation->AddSegment(multiSegment.GetPointer());
+    }
+  int numberOfProgressEvents = 0;
+  vtkNew<vtkCallbackCommand> progressCallbackCommand;
+  progressCallbackCommand->SetClientData(&numberOfProgressEvents);
+  progressCallbackCommand->SetCallback(ProgressCallback);
+  multiSegmentation->AddObserver(vtkCommand::ProgressEvent, progressCallbackCommand.GetPointer());
+  if (!multiSegmentation->CreateRepresentation(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName()))
+    {
+    std::cerr << __LINE__ << ": Failed to convert multiple segments to closed surface using multiple threads!" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (numberOfProgressEvents != numberOfMultiSegments)
+    {
+    std::cerr << __LINE__ << ": Unexpected number of progress events: " << numberOfProgressEvents << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::vector<std::string> multiSegmentIds;
+  multiSegmentation->GetSegmentIDs(multiSegmentIds);
+  for (std::vector<std::string>::iterator segmentIdIt = multiSegmentIds.begin(); segmentIdIt != multiSegmentIds.end(); ++segmentIdIt)
+    {
+    vtkPolyData* multiClosedSurfaceModel = vtkPolyData::SafeDownCast(multiSegmentation->GetSegmentRepresentation(
+      *segmentIdIt, vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName()) );
+    if (!multiClosedSurfaceModel || multiClosedSurfaceModel->GetNumberOfPoints() != closedSurfaceModel->GetNumberOfPoints())
+      {
+      std::cerr << __LINE__ << ": Closed surface converted using multiple threads differs from the one converted using a single thread!" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Evict derived representations and convert them again on demand
+
+  std::string closedSurfaceName = vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName();
+  std::string evictedSegmentId = multiSegmentIds[0];
+  if (multiSegmentation->EvictSegmentRepresentation(evictedSegmentId,
+    vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()))
+    {
+    std::cerr << __LINE__ << ": Master representation must not be evicted!" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!multiSegmentation->EvictSegmentRepresentation(evictedSegmentId, closedSurfaceName)
+    || multiSegmentation->GetSegment(evictedSegmentId)->GetRepresentation(closedSurfaceName)
+    || !multiSegmentation->IsSegmentRepresentationEvicted(evictedSegmentId, closedSurfaceName))
+    {
+    std::cerr << __LINE__ << ": Failed to evict closed surface representation!" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!multiSegmentation->ContainsRepresentation(closedSurfaceName))
+    {
+    std::cerr << __LINE__ << ": Evicted representation is no longer contained in the segmentation!" << std::endl;
+    return EXIT_FAILURE;
+    }
+  // Evicted representations are not converted again by CreateRepresentation
+  multiSegmentation->CreateRepresentation(closedSurfaceName);
+  if (!multiSegmentation->IsSegmentRepresentationEvicted(evictedSegmentId, closedSurfaceName))
+    {
+    std::cerr << __LINE__ << ": Evicted representation has been converted before being requested!" << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkPolyData* regeneratedClosedSurfaceModel = vtkPolyData::SafeDownCast(
+    multiSegmentation->GetSegmentRepresentation(evictedSegmentId, closedSurfaceName));
+  if (!regeneratedClosedSurfaceModel
+    || regeneratedClosedSurfaceModel->GetNumberOfPoints() != closedSurfaceModel->GetNumberOfPoints()
+    || multiSegmentation->IsSegmentRepresentationEvicted(evictedSegmentId, closedSurfaceName))
+    {
+    std::cerr << __LINE__ << ": Failed to convert evicted closed surface representation on demand!" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Pack segments into shared labelmap layers
+
+  vtkNew<vtkSegmentation> layeredSegmentation;
+  layeredSegmentation->SetMasterRepresentationName(
+    vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName() );
+  int boxExtents[3][6] = { { 2, 8, 2, 8, 2, 8 }, { 11, 17, 2, 8, 2, 8 }, { 5, 14, 5, 14, 5, 14 } };
+  for (int boxIndex = 0; boxIndex < 3; ++boxIndex)
+    {
+    vtkNew<vtkOrientedImageData> boxImageData;
+    CreateBoxLabelmap(boxImageData.GetPointer(), boxExtents[boxIndex]);
+    vtkNew<vtkSegment> boxSegment;
+    boxSegment->AddRepresentation(
+      vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), boxImageData.GetPointer());
+    layeredSegmentation->AddSegment(boxSegment.GetPointer());
+    }
+  std::vector< vtkSmartPointer<vtkOrientedImageData> > layers;
+  std::map<std::string, int> segmentLayerIndices;
+  std::map<std::string, int> segmentLabelValues;
+  if (!layeredSegmentation->GenerateSharedLabelmapLayers(layers, segmentLayerIndices, segmentLabelValues))
+    {
+    std::cerr << __LINE__ << ": Failed to generate shared labelmap layers!" << std::endl;
+    return EXIT_FAILURE;
+    }
+  // The first two boxes do not overlap, the third overlaps with both
+  if (layers.size() != 2 || segmentLayerIndices.size() != 3)
+    {
+    std::cerr << __LINE__ << ": Unexpected number of shared labelmap layers: " << layers.size() << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::vector<std::string> layeredSegmentIds;
+  layeredSegmentation->GetSegmentIDs(layeredSegmentIds);
+  for (int boxIndex = 0; boxIndex < 3; ++boxIndex)
+    {
+    std::string segmentId = layeredSegmentIds[boxIndex];
+    vtkNew<vtkOrientedImageData> extractedLabelmap;
+    if (!vtkSegmentation::ExtractSegmentFromSharedLabelmapLayer(layers[segmentLayerIndices[segmentId]],
+      segmentLabelValues[segmentId], extractedLabelmap.GetPointer()))
+      {
+      std::cerr << __LINE__ << ": Failed to extract segment from shared labelmap layer!" << std::endl;
+      return EXIT_FAILURE;
+      }
+    imageAccumulate->SetInputData(extractedLabelmap.GetPointer());
+    imageAccumulate->IgnoreZeroOn();
+    imageAccumulate->Update();
+    int* boxExtent = boxExtents[boxIndex];
+    vtkIdType expectedVoxelCount = (boxExtent[1] - boxExtent[0] + 1) * (boxExtent[3] - boxExtent[2] + 1) * (boxExtent[5] - boxExtent[4] + 1);
+    if (imageAccumulate->GetVoxelCount() != expectedVoxelCount)
+      {
+      std::cerr << __LINE__ << ": Segment extracted from shared labelmap layer has " << imageAccumulate->GetVoxelCount()
+        << " voxels, expected " << expectedVoxelCount << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  imageAccumulate->IgnoreZeroOff();
+
+  //////////////////////////////////////////////////////////////////////////
+  // Notify in place modification of the master representation
+
+  layeredSegmentation->CreateRepresentation(closedSurfaceName);
+  std::string modifiedSegmentId = layeredSegmentIds[0];
+  vtkOrientedImageData* modifiedLabelmap = vtkOrientedImageData::SafeDownCast(
+    layeredSegmentation->GetSegmentRepresentation(modifiedSegmentId,
+    vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
+  vtkDataObject* unmodifiedClosedSurface = layeredSegmentation->GetSegmentRepresentation(layeredSegmentIds[1], closedSurfaceName);
+  modifiedLabelmap->GetPointData()->GetScalars()->FillComponent(0, 0);
+  int numberOfMasterRepresentationModifiedEvents = 0;
+  vtkNew<vtkCallbackCommand> modifiedCallbackCommand;
+  modifiedCallbackCommand->SetClientData(&numberOfMasterRepresentationModifiedEvents);
+  modifiedCallbackCommand->SetCallback(ProgressCallback);
+  layeredSegmentation->AddObserver(vtkSegmentation::MasterRepresentationModified, modifiedCallbackCommand.GetPointer());
+  if (!layeredSegmentation->UpdateSegmentFromMasterRepresentation(modifiedSegmentId, boxExtents[0])
+    || numberOfMasterRepresentationModifiedEvents != 1)
+    {
+    std::cerr << __LINE__ << ": Failed to notify in place modification of the master representation!" << std::endl;
+    return EXIT_FAILURE;
+    }
+  layeredSegmentation->RemoveObserver(modifiedCallbackCommand.GetPointer());
+  vtkPolyData* updatedClosedSurface = vtkPolyData::SafeDownCast(
+    layeredSegmentation->GetSegmentRepresentation(modifiedSegmentId, closedSurfaceName));
+  if (!updatedClosedSurface || updatedClosedSurface->GetNumberOfPoints() != 0
+    || layeredSegmentation->GetSegmentRepresentation(layeredSegmentIds[1], closedSurfaceName) != unmodifiedClosedSurface)
+    {
+    std::cerr << __LINE__ << ": Representations not updated after in place modification of the master representation!" << std::endl;
+    return EXIT_FAILURE;
+    }
+
   //////////////////////////////////////////////////////////////////////////
   // Copy and move segments between segmentations
 
@@ -339,3 +523,28 @@ void CreateCubeLabelmap(vtkOrientedImageData* imageData)
 
   imageData->DeepCopy(identityImageData.GetPointer());
 }
+
+//----------------------------------------------------------------------------
+void CreateBoxLabelmap(vtkOrientedImageData* imageData, int boxExtent[6])
+{
+  if (!imageData)
+    {
+    return;
+    }
+
+  imageData->SetExtent(0, 19, 0, 19, 0, 19);
+  imageData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char* imagePtr = (unsigned char*)imageData->GetScalarPointer();
+  for (int z = 0; z < 20; ++z)
+    {
+    for (int y = 0; y < 20; ++y)
+      {
+      for (int x = 0; x < 20; ++x)
+        {
+        bool inside = (x >= boxExtent[0] && x <= boxExtent[1] && y >= boxExtent[2] && y <= boxExtent[3]
+          && z >= boxExtent[4] && z <= boxExtent[5]);
+        *(imagePtr++) = (inside ? 1 : 0);
+        }
+      }
+    }
+}
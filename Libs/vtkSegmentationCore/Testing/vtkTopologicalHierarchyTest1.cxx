@@ -0,0 +1,93 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataCollection.h>
+
+// SegmentationCore includes
+#include "vtkTopologicalHierarchy.h"
+
+namespace
+{
+//----------------------------------------------------------------------------
+void AddBox(vtkPolyDataCollection* collection, double center, double halfSize)
+{
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(center - halfSize, center - halfSize, center - halfSize);
+  points->InsertNextPoint(center + halfSize, center + halfSize, center + halfSize);
+  vtkNew<vtkPolyData> polyData;
+  polyData->SetPoints(points.GetPointer());
+  collection->AddItem(polyData.GetPointer());
+}
+
+//----------------------------------------------------------------------------
+bool CheckLevels(vtkTopologicalHierarchy* hierarchy, const int* expectedLevels, int numberOfLevels)
+{
+  vtkIntArray* levels = hierarchy->GetOutputLevels();
+  if (levels->GetNumberOfTuples() != numberOfLevels)
+    {
+    std::cerr << "Unexpected number of levels: " << levels->GetNumberOfTuples() << std::endl;
+    return false;
+    }
+  for (int i = 0; i < numberOfLevels; ++i)
+    {
+    if (levels->GetValue(i) != expectedLevels[i])
+      {
+      std::cerr << "Unexpected level for poly data " << i << ": " << levels->GetValue(i)
+                << " instead of " << expectedLevels[i] << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+//----------------------------------------------------------------------------
+int vtkTopologicalHierarchyTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkPolyDataCollection> collection;
+  AddBox(collection.GetPointer(), 0.0, 10.0); // contains the next two boxes
+  AddBox(collection.GetPointer(), 0.0, 5.0); // contains the next box
+  AddBox(collection.GetPointer(), 0.0, 1.0);
+  AddBox(collection.GetPointer(), 21.0, 1.0); // separate from the others
+  AddBox(collection.GetPointer(), -9.0, 0.5); // in the first box only
+
+  vtkNew<vtkTopologicalHierarchy> hierarchy;
+  hierarchy->SetInputPolyDataCollection(collection.GetPointer());
+  hierarchy->Update();
+  const int expectedLevels[5] = { 2, 1, 0, 0, 0 };
+  if (!CheckLevels(hierarchy.GetPointer(), expectedLevels, 5))
+    {
+    std::cerr << __LINE__ << ": Wrong levels without constraint" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The first box is now too small to contain the second one with the required gap
+  hierarchy->SetContainConstraintFactor(0.3);
+  hierarchy->Update();
+  const int expectedConstrainedLevels[5] = { 1, 1, 0, 0, 0 };
+  if (!CheckLevels(hierarchy.GetPointer(), expectedConstrainedLevels, 5))
+    {
+    std::cerr << __LINE__ << ": Wrong levels with constraint" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
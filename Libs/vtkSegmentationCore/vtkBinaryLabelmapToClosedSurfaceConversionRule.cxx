@@ -22,6 +22,7 @@
 #include "vtkBinaryLabelmapToClosedSurfaceConversionRule.h"
 
 #include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
 
 // VTK includes
 #include <vtkDecimatePro.h>
@@ -137,20 +138,25 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::Convert(vtkDataObject* sour
     return true;
     }
 
-  /// If input labelmap has non-background border voxels, then those regions remain open in the output closed surface.
-  /// This function adds a 1 voxel padding to the labelmap in these cases.
-  bool paddingNecessary = this->IsLabelmapPaddingNecessary(binaryLabelMap);
-  if (paddingNecessary)
+  // Labelmaps typically have the extent of the whole reference volume while the segment only occupies
+  // a small region of it. Restrict the processing to the effective extent (region that contains non-background voxels)
+  // to avoid running marching cubes on empty regions.
+  int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!vtkOrientedImageDataResample::CalculateEffectiveExtent(orientedBinaryLabelMap, effectiveExtent))
     {
-    vtkSmartPointer<vtkImageConstantPad> padder = vtkSmartPointer<vtkImageConstantPad>::New();
-    padder->SetInputData(binaryLabelMap);
-    int extent[6] = { 0, -1, 0, -1, 0, -1 };
-    binaryLabelMap->GetExtent(extent);
-    // Set the output extent to the new size
-    padder->SetOutputWholeExtent(extent[0] - 1, extent[1] + 1, extent[2] - 1, extent[3] + 1, extent[4] - 1, extent[5] + 1);
-    padder->Update();
-    binaryLabelMap = padder->GetOutput();
+    vtkDebugMacro("Convert: No polygons can be created, all voxels are empty");
+    closedSurfacePolyData->Reset();
+    return true;
     }
+  // A 1 voxel background padding makes sure that regions at the border are closed in the output surface.
+  // The constant pad filter crops the labelmap to the effective extent and adds the padding in one step.
+  vtkSmartPointer<vtkImageConstantPad> padder = vtkSmartPointer<vtkImageConstantPad>::New();
+  padder->SetInputData(binaryLabelMap);
+  padder->SetConstant(0);
+  padder->SetOutputWholeExtent(effectiveExtent[0] - 1, effectiveExtent[1] + 1, effectiveExtent[2] - 1,
+    effectiveExtent[3] + 1, effectiveExtent[4] - 1, effectiveExtent[5] + 1);
+  padder->Update();
+  binaryLabelMap = padder->GetOutput();
   // Clone labelmap and set identity geometry so that the whole transform can be done in IJK space and then
   // the whole transform can be applied on the poly data to transform it to the world coordinate system
   vtkSmartPointer<vtkImageData> binaryLabelmapWithIdentityGeometry = vtkSmartPointer<vtkImageData>::New();
@@ -258,26 +264,31 @@ void IsLabelmapPaddingNecessaryGeneric(vtkImageData* binaryLabelMap, bool &paddi
 
   ImageScalarType* imagePtr = (ImageScalarType*)binaryLabelMap->GetScalarPointerForExtent(extent);
 
-  for (int i=0; i<dimensions[0]; ++i)
+  // Only border voxels are checked. Voxels are visited in memory order: rows in the first and last
+  // slices and first and last rows of each slice are checked entirely, other rows only at their two ends.
+  // This way the check scales with the surface of the image instead of its volume.
+  for (int k=0; k<dimensions[2]; ++k)
     {
+    bool borderSlice = (k==0 || k==dimensions[2]-1);
     for (int j=0; j<dimensions[1]; ++j)
       {
-      for (int k=0; k<dimensions[2]; ++k)
+      ImageScalarType* rowPtr = imagePtr + j*dimensions[0] + k*dimensions[0]*dimensions[1];
+      if (borderSlice || j==0 || j==dimensions[1]-1)
         {
-        if (i!=0 && i!=dimensions[0]-1 && j!=0 && j!=dimensions[1]-1 && k!=0 && k!=dimensions[2]-1)
+        for (int i=0; i<dimensions[0]; ++i)
           {
-          // Skip non-border voxels
-          continue;
-          }
-        int voxelValue = 0;
-        voxelValue = (*(imagePtr + i + j*dimensions[0] + k*dimensions[0]*dimensions[1]));
-
-        if (voxelValue != 0)
-          {
-          paddingNecessary = true;
-          return;
+          if (rowPtr[i] != 0)
+            {
+            paddingNecessary = true;
+            return;
+            }
           }
         }
+      else if (rowPtr[0] != 0 || rowPtr[dimensions[0]-1] != 0)
+        {
+        paddingNecessary = true;
+        return;
+        }
       }
     }
 
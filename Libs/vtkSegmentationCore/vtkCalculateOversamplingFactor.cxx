@@ -23,6 +23,7 @@
 
 // VTK includes
 #include <vtkCollection.h>
+#include <vtkCriticalSection.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
@@ -31,10 +32,36 @@
 #include <vtkPiecewiseFunction.h>
 #include <vtkSmartPointer.h>
 #include <vtkVersion.h>
+#include <vtkWeakPointer.h>
 
 // STD includes
 #include <math.h>
 #include <algorithm>
+#include <map>
+
+//----------------------------------------------------------------------------
+namespace
+{
+
+/// Mass properties of a poly data, valid as long as the poly data is not modified
+struct MassPropertiesCacheEntry
+{
+  vtkWeakPointer<vtkPolyData> PolyData;
+  vtkMTimeType MTime;
+  double Volume;
+  double VolumeProjected;
+  double NormalizedShapeIndex;
+};
+
+typedef std::map<vtkPolyData*, MassPropertiesCacheEntry> MassPropertiesCacheType;
+
+/// Mass properties of the poly data the oversampling factor was last calculated for.
+/// Conversions of all the segments are repeated each time the reference geometry or
+/// the conversion parameters change, this avoids recomputing the surface properties.
+MassPropertiesCacheType MassPropertiesCache;
+vtkSimpleCriticalSection MassPropertiesCacheLock;
+
+}
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkCalculateOversamplingFactor);
@@ -45,7 +72,9 @@ vtkCalculateOversamplingFactor::vtkCalculateOversamplingFactor()
   this->InputPolyData = NULL;
   this->ReferenceGeometryImageData = NULL;
   this->OutputOversamplingFactor = 1;
-  this->MassPropertiesAlgorithm = NULL;
+  this->StructureVolume = 0.0;
+  this->StructureVolumeProjected = 0.0;
+  this->StructureNormalizedShapeIndex = 0.0;
   this->LogSpeedMeasurementsOff();
 }
 
@@ -54,7 +83,6 @@ vtkCalculateOversamplingFactor::~vtkCalculateOversamplingFactor()
 {
   this->SetInputPolyData(NULL);
   this->SetReferenceGeometryImageData(NULL);
-  this->SetMassPropertiesAlgorithm(NULL);
 }
 
 //----------------------------------------------------------------------------
@@ -86,12 +114,8 @@ bool vtkCalculateOversamplingFactor::CalculateOversamplingFactor()
   double checkpointStart = timer->GetUniversalTime();
 #endif
 
-  // Create mass properties algorithm for common use
-  vtkSmartPointer<vtkMassProperties> massProperties = vtkSmartPointer<vtkMassProperties>::New();
-  this->SetMassPropertiesAlgorithm(massProperties);
-  massProperties->SetInputData(this->InputPolyData);
-  // Run algorithm so that results can be extracted for relative structure size calculation and complexity measure
-  massProperties->Update();
+  // Get mass properties for relative structure size calculation and complexity measure
+  this->ComputeMassProperties();
 
   // Get relative structure size
   double relativeStructureSize = this->CalculateRelativeStructureSize();
@@ -127,12 +151,64 @@ bool vtkCalculateOversamplingFactor::CalculateOversamplingFactor()
       << "\tDetermining oversampling factor using fuzzy rules: " << checkpointEnd-checkpointFuzzyStart << " s");
     }
 
-  // Clean up (triggers destruction of member)
-  this->SetMassPropertiesAlgorithm(NULL);
-
   return true;
 }
 
+//----------------------------------------------------------------------------
+void vtkCalculateOversamplingFactor::ComputeMassProperties()
+{
+  vtkMTimeType polyDataMTime = this->InputPolyData->GetMTime();
+  MassPropertiesCacheLock.Lock();
+  MassPropertiesCacheType::iterator cacheIt = MassPropertiesCache.find(this->InputPolyData);
+  if ( cacheIt != MassPropertiesCache.end()
+    && cacheIt->second.PolyData.GetPointer() == this->InputPolyData
+    && cacheIt->second.MTime == polyDataMTime )
+    {
+    this->StructureVolume = cacheIt->second.Volume;
+    this->StructureVolumeProjected = cacheIt->second.VolumeProjected;
+    this->StructureNormalizedShapeIndex = cacheIt->second.NormalizedShapeIndex;
+    MassPropertiesCacheLock.Unlock();
+    return;
+    }
+  MassPropertiesCacheLock.Unlock();
+
+  vtkSmartPointer<vtkMassProperties> massProperties = vtkSmartPointer<vtkMassProperties>::New();
+  massProperties->SetInputData(this->InputPolyData);
+  massProperties->Update();
+  this->StructureVolume = massProperties->GetVolume();
+  this->StructureVolumeProjected = massProperties->GetVolumeProjected();
+  this->StructureNormalizedShapeIndex = massProperties->GetNormalizedShapeIndex();
+
+  MassPropertiesCacheLock.Lock();
+  // Forget the poly data that have been deleted
+  for (cacheIt = MassPropertiesCache.begin(); cacheIt != MassPropertiesCache.end(); )
+    {
+    if (cacheIt->second.PolyData.GetPointer() == NULL)
+      {
+      MassPropertiesCache.erase(cacheIt++);
+      }
+    else
+      {
+      ++cacheIt;
+      }
+    }
+  MassPropertiesCacheEntry& entry = MassPropertiesCache[this->InputPolyData];
+  entry.PolyData = this->InputPolyData;
+  entry.MTime = polyDataMTime;
+  entry.Volume = this->StructureVolume;
+  entry.VolumeProjected = this->StructureVolumeProjected;
+  entry.NormalizedShapeIndex = this->StructureNormalizedShapeIndex;
+  MassPropertiesCacheLock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkCalculateOversamplingFactor::ClearCache()
+{
+  MassPropertiesCacheLock.Lock();
+  MassPropertiesCache.clear();
+  MassPropertiesCacheLock.Unlock();
+}
+
 //----------------------------------------------------------------------------
 double vtkCalculateOversamplingFactor::CalculateRelativeStructureSize()
 {
@@ -146,17 +222,12 @@ double vtkCalculateOversamplingFactor::CalculateRelativeStructureSize()
     vtkErrorMacro("CalculateRelativeStructureSize: Invalid rasterization reference volume node!");
     return -1.0;
     }
-  if (!this->MassPropertiesAlgorithm)
-    {
-    vtkErrorMacro("CalculateRelativeStructureSize: Invalid mass properties algorithm!");
-    return -1.0;
-    }
 
   // Get structure volume in mm^3
-  double structureVolume = this->MassPropertiesAlgorithm->GetVolume();
+  double structureVolume = this->StructureVolume;
 
   // Sanity check
-  double structureProjectedVolume = this->MassPropertiesAlgorithm->GetVolumeProjected();
+  double structureProjectedVolume = this->StructureVolumeProjected;
   double error = (structureVolume - structureProjectedVolume);
   if (error * 10000 > structureVolume)
     {
@@ -187,15 +258,10 @@ double vtkCalculateOversamplingFactor::CalculateComplexityMeasure()
     vtkErrorMacro("CalculateComplexityMeasure: Invalid input poly data!");
     return -1.0;
     }
-  if (!this->MassPropertiesAlgorithm)
-    {
-    vtkErrorMacro("CalculateComplexityMeasure: Invalid mass properties algorithm!");
-    return -1.0;
-    }
 
   // Normalized shape index (NSI) characterizes the deviation of the shape of an object
   // from a sphere (from surface area and volume). A sphere's NSI is one. This number is always >= 1.0
-  double normalizedShapeIndex = this->MassPropertiesAlgorithm->GetNormalizedShapeIndex();
+  double normalizedShapeIndex = this->StructureNormalizedShapeIndex;
 
   // Map raw measurement to the fuzzy input scale
   double complexityMeasure = std::max(normalizedShapeIndex - 1.0, 0.0); // If smaller then 0, then return 0
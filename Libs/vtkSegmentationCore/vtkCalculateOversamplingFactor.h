@@ -48,13 +48,21 @@ public:
 public:
   /// Calculate oversampling factor for the input model and its rasterization reference volume
   /// based on model properties using fuzzy logics.
+  /// The mass properties of the input model are cached until the model is modified,
+  /// so recalculating the factor for another reference geometry is cheap.
   bool CalculateOversamplingFactor();
 
+  /// Forget the cached mass properties of all the models
+  static void ClearCache();
+
   /// Apply oversampling factor on image data geometry.
   /// Changes spacing and extent of oversampling factor is not 1 (and sensible)
   static void ApplyOversamplingOnImageGeometry(vtkOrientedImageData* imageData, double oversamplingFactor);
 
 protected:
+  /// Get the mass properties of the input model from the cache or compute them
+  void ComputeMassProperties();
+
   /// Calculate relative structure size from input model and rasterization reference volume
   double CalculateRelativeStructureSize();
 
@@ -88,10 +96,6 @@ public:
   vtkSetMacro(LogSpeedMeasurements, bool);
   vtkBooleanMacro(LogSpeedMeasurements, bool);
 
-protected:
-  vtkGetObjectMacro(MassPropertiesAlgorithm, vtkMassProperties);
-  vtkSetObjectMacro(MassPropertiesAlgorithm, vtkMassProperties);
-
 protected:
   /// Input poly data to rasterize
   vtkPolyData* InputPolyData;
@@ -105,9 +109,11 @@ protected:
   /// Flag telling whether the speed measurements are logged on standard output
   bool LogSpeedMeasurements;
 
-  /// Temporary storage for mass properties algorithm that is used in both sub-calculations
+  /// Mass properties of the input model that are used in both sub-calculations
   /// \sa CalculateRelativeStructureSize and CalculateComplexityMeasure
-  vtkMassProperties* MassPropertiesAlgorithm;
+  double StructureVolume;
+  double StructureVolumeProjected;
+  double StructureNormalizedShapeIndex;
 
 protected:
   vtkCalculateOversamplingFactor();
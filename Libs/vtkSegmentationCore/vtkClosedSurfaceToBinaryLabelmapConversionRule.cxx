@@ -35,8 +35,7 @@
 #include <vtkPolyData.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
-#include <vtkImageCast.h>
-#include <vtkImageStencil.h>
+#include <vtkImageStencilData.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkStripper.h>
 #include <vtkTriangleFilter.h>
@@ -200,19 +199,31 @@ bool vtkClosedSurfaceToBinaryLabelmapConversionRule::Convert(vtkDataObject* sour
   polyDataToImageStencil->SetOutputOrigin(binaryLabelMap->GetOrigin());
   polyDataToImageStencil->SetOutputWholeExtent(binaryLabelMap->GetExtent());
 
-  // Convert stencil to image
-  vtkNew<vtkImageStencil> stencil;
-  stencil->SetInputData(binaryLabelMap);
-  stencil->SetStencilConnection(polyDataToImageStencil->GetOutputPort());
-  stencil->ReverseStencilOn();
-  stencil->SetBackgroundValue(1); // General foreground value is 1 (background value because of reverse stencil)
-
-  // Save result to output
-  vtkNew<vtkImageCast> imageCast;
-  imageCast->SetInputConnection(stencil->GetOutputPort());
-  imageCast->SetOutputScalarTypeToUnsignedChar();
-  imageCast->Update();
-  binaryLabelMap->ShallowCopy(imageCast->GetOutput());
+  polyDataToImageStencil->Update();
+
+  // Write the stencil into the zero-filled labelmap directly. Only the voxels inside the surface are visited,
+  // which is much faster than applying the stencil to the whole (often oversampled) image and casting the result.
+  vtkImageStencilData* stencilData = polyDataToImageStencil->GetOutput();
+  int extent[6] = {0,-1,0,-1,0,-1};
+  binaryLabelMap->GetExtent(extent);
+  vtkIdType increments[3] = {0,0,0};
+  binaryLabelMap->GetIncrements(increments);
+  unsigned char* binaryLabelMapVoxels = static_cast<unsigned char*>(binaryLabelMapVoxelsPointer);
+  for (int z = extent[4]; z <= extent[5]; ++z)
+    {
+    for (int y = extent[2]; y <= extent[3]; ++y)
+      {
+      unsigned char* rowPointer = binaryLabelMapVoxels + (y - extent[2]) * increments[1] + (z - extent[4]) * increments[2];
+      int iter = 0;
+      int r1 = 0;
+      int r2 = 0;
+      while (stencilData->GetNextExtent(r1, r2, extent[0], extent[1], y, z, iter))
+        {
+        memset(rowPointer + (r1 - extent[0]), 1, r2 - r1 + 1); // General foreground value is 1
+        }
+      }
+    }
+  binaryLabelMap->Modified();
 
   // Restore geometry of the labelmap that we set to identity before conversion
   // (so that we can perform the stencil operations in IJK space)
@@ -26,6 +26,7 @@
 // VTK includes
 #include <vtkAppendPolyData.h>
 #include <vtkGeneralTransform.h>
+#include <vtkGridTransform.h>
 #include <vtkImageReslice.h>
 #include <vtkImageConstantPad.h>
 #include <vtkMatrix4x4.h>
@@ -35,6 +36,7 @@
 #include <vtkPointData.h>
 #include <vtkSmartPointer.h>
 #include <vtkTransform.h>
+#include <vtkTransformToGrid.h>
 #include <vtkTransformPolyDataFilter.h>
 #include <vtkVersionMacros.h>
 #include <vtkVector.h>
@@ -44,6 +46,57 @@
 
 vtkStandardNewMacro(vtkOrientedImageDataResample);
 
+//----------------------------------------------------------------------------
+// Row kernels used by MergeImageGeneric2. They contain no branches that depend on voxel values
+// so that they are auto-vectorized for the common cases (unsigned char or short base and modifier images).
+// Return true if any voxel of the base row is changed.
+template <class BaseImageScalarType, class ModifierImageScalarType>
+bool MergeRowMaximum(BaseImageScalarType* baseRow, const ModifierImageScalarType* modifierRow, vtkIdType rowLength)
+{
+  unsigned char modified = 0;
+  for (vtkIdType idx = 0; idx < rowLength; idx++)
+    {
+    const BaseImageScalarType baseValue = baseRow[idx];
+    const BaseImageScalarType modifierValue = static_cast<BaseImageScalarType>(modifierRow[idx]);
+    const BaseImageScalarType newValue = (modifierValue > baseValue) ? modifierValue : baseValue;
+    modified |= static_cast<unsigned char>(newValue != baseValue);
+    baseRow[idx] = newValue;
+    }
+  return modified != 0;
+}
+
+//----------------------------------------------------------------------------
+template <class BaseImageScalarType, class ModifierImageScalarType>
+bool MergeRowMinimum(BaseImageScalarType* baseRow, const ModifierImageScalarType* modifierRow, vtkIdType rowLength)
+{
+  unsigned char modified = 0;
+  for (vtkIdType idx = 0; idx < rowLength; idx++)
+    {
+    const BaseImageScalarType baseValue = baseRow[idx];
+    const BaseImageScalarType modifierValue = static_cast<BaseImageScalarType>(modifierRow[idx]);
+    const BaseImageScalarType newValue = (modifierValue < baseValue) ? modifierValue : baseValue;
+    modified |= static_cast<unsigned char>(newValue != baseValue);
+    baseRow[idx] = newValue;
+    }
+  return modified != 0;
+}
+
+//----------------------------------------------------------------------------
+template <class BaseImageScalarType, class ModifierImageScalarType>
+bool MergeRowMasking(BaseImageScalarType* baseRow, const ModifierImageScalarType* modifierRow, vtkIdType rowLength,
+  int maskThreshold, BaseImageScalarType fillValue)
+{
+  unsigned char modified = 0;
+  for (vtkIdType idx = 0; idx < rowLength; idx++)
+    {
+    const BaseImageScalarType baseValue = baseRow[idx];
+    const BaseImageScalarType newValue = (static_cast<int>(modifierRow[idx]) > maskThreshold) ? fillValue : baseValue;
+    modified |= static_cast<unsigned char>(newValue != baseValue);
+    baseRow[idx] = newValue;
+    }
+  return modified != 0;
+}
+
 //----------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
 template <class BaseImageScalarType, class ModifierImageScalarType>
@@ -112,81 +165,30 @@ void MergeImageGeneric2(
 
   bool baseImageModified = false;
 
-  // Loop through output pixels
-  // There is difference in only one line between min/max computation but the comparison
-  // is performed for each pixel, so it is faster to make the conditional expression in the outer loop.
-  // Looping is performed in two step: first we just check if any of the pixels have to be changed,
-  // if we find any, then we set baseImageModified flag and to the second loop without need to set
-  // baseImageModified flag again (setting a flag in a hot loop may impact speed).
-  if (operation == vtkOrientedImageDataResample::OPERATION_MAXIMUM)
-    {
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
-      {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
-        {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
-          {
-          if (static_cast<BaseImageScalarType>(*modifierImagePtr) > *baseImagePtr)
-            {
-            *baseImagePtr = *modifierImagePtr;
-            baseImageModified = true;
-            }
-          baseImagePtr++;
-          modifierImagePtr++;
-          }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
-        }
-      baseImagePtr += baseIncZ;
-      modifierImagePtr += modifierIncZ;
-      }
-    }
-  else if (operation == vtkOrientedImageDataResample::OPERATION_MINIMUM)
+  // Loop through output pixels row by row. Row kernels are branch-free, so that the compiler can vectorize them.
+  const vtkIdType rowLength = maxX + 1;
+  const BaseImageScalarType fillValueBaseImageType = static_cast<BaseImageScalarType>(fillValue);
+  for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
     {
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
+    for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
       {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
+      if (operation == vtkOrientedImageDataResample::OPERATION_MAXIMUM)
         {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
-          {
-          if (static_cast<BaseImageScalarType>(*modifierImagePtr) < *baseImagePtr)
-            {
-            *baseImagePtr = *modifierImagePtr;
-            baseImageModified = true;
-            }
-          baseImagePtr++;
-          modifierImagePtr++;
-          }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
+        baseImageModified |= MergeRowMaximum(baseImagePtr, modifierImagePtr, rowLength);
         }
-      baseImagePtr += baseIncZ;
-      modifierImagePtr += modifierIncZ;
-      }
-    }
-  else if (operation == vtkOrientedImageDataResample::OPERATION_MASKING)
-    {
-    BaseImageScalarType fillValueBaseImageType = static_cast<BaseImageScalarType>(fillValue);
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
-      {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
+      else if (operation == vtkOrientedImageDataResample::OPERATION_MINIMUM)
         {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
-          {
-          if (static_cast<int>(*modifierImagePtr) > maskThreshold)
-            {
-            *baseImagePtr = fillValueBaseImageType;
-            baseImageModified = true;
-            }
-          baseImagePtr++;
-          modifierImagePtr++;
+        baseImageModified |= MergeRowMinimum(baseImagePtr, modifierImagePtr, rowLength);
         }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
+      else if (operation == vtkOrientedImageDataResample::OPERATION_MASKING)
+        {
+        baseImageModified |= MergeRowMasking(baseImagePtr, modifierImagePtr, rowLength, maskThreshold, fillValueBaseImageType);
         }
-      baseImagePtr += baseIncZ;
-      modifierImagePtr += modifierIncZ;
+      baseImagePtr += rowLength + baseIncY;
+      modifierImagePtr += rowLength + modifierIncY;
       }
+    baseImagePtr += baseIncZ;
+    modifierImagePtr += modifierIncZ;
     }
   if (baseImageModified)
     {
@@ -218,6 +220,53 @@ void MergeImageGeneric(
     }
 }
 
+//----------------------------------------------------------------------------
+// Compute the extent where the modifier image may change the base image: voxels outside the effective extent
+// of the modifier image do not change the base image in masking mode (if the mask threshold is not negative)
+// and in maximum mode (if neither image can contain negative values).
+// Returns false if the extent cannot be restricted for the operation.
+static bool GetModifierEffectiveExtent(vtkOrientedImageData* baseImage, vtkOrientedImageData* modifierImage,
+  int operation, int maskThreshold, const int extent[6], int modifierEffectiveExtent[6])
+{
+  if (operation == vtkOrientedImageDataResample::OPERATION_MASKING)
+    {
+    if (maskThreshold < 0)
+      {
+      return false;
+      }
+    }
+  else if (operation == vtkOrientedImageDataResample::OPERATION_MAXIMUM)
+    {
+    if (baseImage->GetScalarTypeMin() < 0 || modifierImage->GetScalarTypeMin() < 0)
+      {
+      return false;
+      }
+    }
+  else
+    {
+    return false;
+    }
+  if (!vtkOrientedImageDataResample::CalculateEffectiveExtent(modifierImage, modifierEffectiveExtent))
+    {
+    // modifier image is empty
+    for (int idx = 0; idx < 3; ++idx)
+      {
+      modifierEffectiveExtent[idx * 2] = 0;
+      modifierEffectiveExtent[idx * 2 + 1] = -1;
+      }
+    return true;
+    }
+  if (extent)
+    {
+    for (int idx = 0; idx < 3; ++idx)
+      {
+      modifierEffectiveExtent[idx * 2] = std::max(modifierEffectiveExtent[idx * 2], extent[idx * 2]);
+      modifierEffectiveExtent[idx * 2 + 1] = std::min(modifierEffectiveExtent[idx * 2 + 1], extent[idx * 2 + 1]);
+      }
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 vtkOrientedImageDataResample::vtkOrientedImageDataResample()
 {
@@ -929,6 +978,44 @@ bool vtkOrientedImageDataResample::IsTransformLinear(vtkAbstractTransform* input
   return false;
 }
 
+//----------------------------------------------------------------------------
+bool vtkOrientedImageDataResample::ApproximateTransformWithGrid(vtkAbstractTransform* transform, const int extent[6],
+  int gridSpacingVoxels, vtkGridTransform* gridTransform)
+{
+  if (!transform || !gridTransform || gridSpacingVoxels < 2)
+    {
+    return false;
+    }
+  if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+    {
+    return false;
+    }
+
+  // Place grid points at every gridSpacingVoxels-th voxel, making sure the last grid point is not inside the extent
+  int gridExtent[6] = { 0, 0, 0, 0, 0, 0 };
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    int numberOfVoxels = extent[axis * 2 + 1] - extent[axis * 2];
+    gridExtent[axis * 2 + 1] = (numberOfVoxels + gridSpacingVoxels - 1) / gridSpacingVoxels;
+    }
+
+  vtkNew<vtkTransformToGrid> transformToGrid;
+  transformToGrid->SetInput(transform);
+  transformToGrid->SetGridOrigin(extent[0], extent[2], extent[4]);
+  transformToGrid->SetGridSpacing(gridSpacingVoxels, gridSpacingVoxels, gridSpacingVoxels);
+  transformToGrid->SetGridExtent(gridExtent);
+  transformToGrid->SetGridScalarTypeToDouble();
+  transformToGrid->Update();
+
+  vtkSmartPointer<vtkImageData> displacementGrid = vtkSmartPointer<vtkImageData>::New();
+  displacementGrid->ShallowCopy(transformToGrid->GetOutput());
+  gridTransform->SetDisplacementGridData(displacementGrid);
+  gridTransform->SetDisplacementScale(transformToGrid->GetDisplacementScale());
+  gridTransform->SetDisplacementShift(transformToGrid->GetDisplacementShift());
+  gridTransform->SetInterpolationModeToLinear();
+  return true;
+}
+
 //----------------------------------------------------------------------------
 bool vtkOrientedImageDataResample::DoesTransformMatrixContainShear(vtkMatrix4x4* matrix)
 {
@@ -980,6 +1067,17 @@ bool vtkOrientedImageDataResample::PadImageToContainImage(vtkOrientedImageData*
                          std::min(containedImageExtentInInputImageFrame[2],inputImageExtent[2]), std::max(containedImageExtentInInputImageFrame[3],inputImageExtent[3]),
                          std::min(containedImageExtentInInputImageFrame[4],inputImageExtent[4]), std::max(containedImageExtentInInputImageFrame[5],inputImageExtent[5]) };
 
+  // If the input image already contains the image then there is no need to allocate and fill a padded image
+  // (this is the most common case when a segment is modified in place)
+  if (std::equal(unionExtent, unionExtent + 6, inputImageExtent))
+    {
+    if (outputImage != inputImage)
+      {
+      outputImage->DeepCopy(inputImage);
+      }
+    return true;
+    }
+
   // Pad image by expansion extent (extents are fitted to the structure, dilate will reach the edge of the image)
   vtkSmartPointer<vtkImageConstantPad> padder = vtkSmartPointer<vtkImageConstantPad>::New();
   padder->SetInputData(inputImage);
@@ -990,8 +1088,9 @@ bool vtkOrientedImageDataResample::PadImageToContainImage(vtkOrientedImageData*
   vtkSmartPointer<vtkMatrix4x4> inputImageToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
   inputImage->GetImageToWorldMatrix(inputImageToWorldMatrix);
 
-  // Set output
-  outputImage->DeepCopy(padder->GetOutput());
+  // Set output. The padded image is newly allocated and not used anywhere else,
+  // therefore it is not necessary to make another copy of the voxels.
+  outputImage->ShallowCopy(padder->GetOutput());
   outputImage->SetGeometryFromImageToWorldMatrix(inputImageToWorldMatrix);
 
   return true;
@@ -1022,6 +1121,23 @@ bool vtkOrientedImageDataResample::MergeImage(
     vtkGenericWarningMacro("vtkOrientedImageDataResample::MergeImage failed: geometry mismatch between inputImage and imageToAppend");
     return false;
     }
+  // Only process the region that the appended image may change
+  int modifierEffectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (GetModifierEffectiveExtent(inputImage, imageToAppend, operation, maskThreshold, extent, modifierEffectiveExtent))
+    {
+    if (modifierEffectiveExtent[0] > modifierEffectiveExtent[1]
+      || modifierEffectiveExtent[2] > modifierEffectiveExtent[3]
+      || modifierEffectiveExtent[4] > modifierEffectiveExtent[5])
+      {
+      // The appended image does not change the input image
+      if (outputImage != inputImage)
+        {
+        outputImage->DeepCopy(inputImage);
+        }
+      return true;
+      }
+    extent = modifierEffectiveExtent;
+    }
   if (!vtkOrientedImageDataResample::PadImageToContainImage(inputImage, imageToAppend, outputImage, extent))
     {
     vtkGenericWarningMacro("vtkOrientedImageDataResample::MergeImage: Failed to pad segment labelmap");
@@ -1067,6 +1183,12 @@ bool vtkOrientedImageDataResample::ModifyImage(
     vtkGenericWarningMacro("vtkOrientedImageDataResample::ModifyImage failed: geometry mismatch between inputImage and modifierImage");
     return false;
     }
+  // Only process the region that the modifier image may change
+  int modifierEffectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (GetModifierEffectiveExtent(inputImage, modifierImage, operation, maskThreshold, extent, modifierEffectiveExtent))
+    {
+    extent = modifierEffectiveExtent;
+    }
   switch (inputImage->GetScalarType())
     {
     vtkTemplateMacro(MergeImageGeneric<VTK_TT>(
@@ -1184,6 +1306,22 @@ void vtkOrientedImageDataResample::TransformOrientedImage(
     resliceTransform->Concatenate(transformedWorldToWorldTransform);
     resliceTransform->Concatenate(worldToImageMatrix);
 
+    // For large images, evaluating the non-linear transform (typically an inverse that has to be computed
+    // iteratively) at each voxel is very slow. Evaluate it only at the points of a coarse grid instead
+    // and interpolate the displacements between them.
+    vtkSmartPointer<vtkAbstractTransform> outputToInputTransform = resliceTransform;
+    vtkSmartPointer<vtkGridTransform> approximateResliceTransform = vtkSmartPointer<vtkGridTransform>::New();
+    const double minimumNumberOfVoxelsForGridApproximation = 1.0e6;
+    const int gridSpacingVoxels = 4;
+    double numberOfOutputVoxels = double(outputExtent[1] - outputExtent[0] + 1)
+      * double(outputExtent[3] - outputExtent[2] + 1) * double(outputExtent[5] - outputExtent[4] + 1);
+    if (numberOfOutputVoxels >= minimumNumberOfVoxelsForGridApproximation
+      && vtkOrientedImageDataResample::ApproximateTransformWithGrid(resliceTransform, outputExtent,
+        gridSpacingVoxels, approximateResliceTransform))
+      {
+      outputToInputTransform = approximateResliceTransform;
+      }
+
     // Perform resampling
     vtkNew<vtkImageReslice> reslice;
     reslice->SetInputData(identityInputImage);
@@ -1208,7 +1346,7 @@ void vtkOrientedImageDataResample::TransformOrientedImage(
     reslice->SetOutputOrigin(0, 0, 0);
     reslice->SetOutputSpacing(1, 1, 1);
     reslice->SetOutputExtent(outputExtent);
-    reslice->SetResliceTransform(resliceTransform);
+    reslice->SetResliceTransform(outputToInputTransform);
     reslice->Update();
 
     image->DeepCopy(reslice->GetOutput());
@@ -31,6 +31,7 @@ class vtkMatrix4x4;
 class vtkOrientedImageData;
 class vtkTransform;
 class vtkAbstractTransform;
+class vtkGridTransform;
 
 /// \ingroup SegmentationCore
 /// \brief Utility functions for resampling oriented image data
@@ -149,6 +150,18 @@ public:
   /// \return True if input is linear, false otherwise.
   static bool IsTransformLinear(vtkAbstractTransform* transform, vtkTransform* linearTransform);
 
+  /// Approximate a (typically non-linear, composite) transform by a displacement grid.
+  /// The transform is evaluated only at the grid points, which are placed at every gridSpacingVoxels-th
+  /// voxel of the extent. Evaluating the grid transform then only requires a trilinear lookup, which is much
+  /// faster than evaluating a B-spline transform or an iteratively computed inverse at each voxel.
+  /// \param transform Transform to approximate. Input and output points are assumed to be in voxel coordinates.
+  /// \param extent Extent of the region where the approximating transform will be used
+  /// \param gridSpacingVoxels Distance between grid points, in voxels (at least 2)
+  /// \param gridTransform Output transform
+  /// \return True if the grid was computed successfully
+  static bool ApproximateTransformWithGrid(vtkAbstractTransform* transform, const int extent[6],
+    int gridSpacingVoxels, vtkGridTransform* gridTransform);
+
   /// Determine if a transform matrix contains shear
   static bool DoesTransformMatrixContainShear(vtkMatrix4x4* matrix);
 
@@ -37,8 +37,6 @@
 #include <vtkPolyDataNormals.h>
 #include <vtkTriangleFilter.h>
 #include <vtkStripper.h>
-#include <vtkImageStencil.h>
-#include <vtkImageCast.h>
 
 // std includes
 #include <map>
@@ -425,22 +423,6 @@ int vtkPolyDataToFractionalLabelmapFilter::RequestData(
   int extent[6];
   outputData->GetExtent(extent);
 
-  vtkSmartPointer<vtkImageData> emptyImageData = vtkSmartPointer<vtkImageData>::New();
-  emptyImageData->SetExtent(extent);
-  emptyImageData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
-
-  void* emptyImageDataPointer = emptyImageData->GetScalarPointerForExtent(emptyImageData->GetExtent());
-  if (!emptyImageDataPointer)
-  {
-    vtkErrorMacro("Convert: Failed to allocate memory for output labelmap image!");
-    return false;
-  }
-  else
-  {
-    memset(emptyImageDataPointer, 0, ((extent[1]-extent[0]+1)*(extent[3]-extent[2]+1)*(extent[5]-extent[4]+1) * emptyImageData->GetScalarSize() * emptyImageData->GetNumberOfScalarComponents()));
-  }
-
-
   // The magnitude of the offset step size ( n-1 / 2n )
   double offsetStepSize = (double)(this->NumberOfOffsets-1.0)/(2 * this->NumberOfOffsets);
 
@@ -448,16 +430,6 @@ int vtkPolyDataToFractionalLabelmapFilter::RequestData(
   imageStencilData->SetExtent(extent);
   imageStencilData->SetSpacing(1.0, 1.0, 1.0);
 
-  vtkNew<vtkImageStencil> imageStencil;
-  imageStencil->SetInputData(emptyImageData);
-  imageStencil->SetStencilData(imageStencilData);
-  imageStencil->ReverseStencilOn();
-  imageStencil->SetBackgroundValue(1); // General foreground value is 1 (background value because of reverse stencil)
-
-  vtkNew<vtkImageCast> imageCast;
-  imageCast->SetInputConnection(imageStencil->GetOutputPort());
-  imageCast->SetOutputScalarTypeToUnsignedChar();
-
   // Iterate through "NumberOfOffsets" in each of the dimensions and create a binary labelmap at each offset
   for (int k = 0; k < this->NumberOfOffsets; ++k)
   {
@@ -477,8 +449,7 @@ int vtkPolyDataToFractionalLabelmapFilter::RequestData(
         this->FillImageStencilData(imageStencilData, transformedClosedSurface, extent);
 
         // Save result to output
-        imageCast->Update();
-        this->AddBinaryLabelMapToFractionalLabelMap(imageCast->GetOutput(), outputData);
+        this->AddImageStencilDataToFractionalLabelMap(imageStencilData, outputData);
 
         this->UpdateProgress(((i+1)*(j+1)*(k+1))/(this->NumberOfOffsets*this->NumberOfOffsets*this->NumberOfOffsets));
 
@@ -529,6 +500,51 @@ void vtkPolyDataToFractionalLabelmapFilter::AddBinaryLabelMapToFractionalLabelMa
 
 }
 
+//----------------------------------------------------------------------------
+void vtkPolyDataToFractionalLabelmapFilter::AddImageStencilDataToFractionalLabelMap(vtkImageStencilData* stencilData, vtkImageData* fractionalLabelMap)
+{
+  if (!stencilData)
+  {
+    vtkErrorMacro("AddImageStencilDataToFractionalLabelMap: Invalid vtkImageStencilData!");
+    return;
+  }
+
+  if (!fractionalLabelMap)
+  {
+    vtkErrorMacro("AddImageStencilDataToFractionalLabelMap: Invalid vtkImageData!");
+    return;
+  }
+
+  int fractionalExtent[6] = {0,-1,0,-1,0,-1};
+  fractionalLabelMap->GetExtent(fractionalExtent);
+  vtkIdType increments[3] = {0,0,0};
+  fractionalLabelMap->GetIncrements(increments);
+  FRACTIONAL_DATA_TYPE* fractionalLabelMapPointer = (FRACTIONAL_DATA_TYPE*)fractionalLabelMap->GetScalarPointerForExtent(fractionalExtent);
+  if (!fractionalLabelMapPointer)
+  {
+    return;
+  }
+
+  for (int z = fractionalExtent[4]; z <= fractionalExtent[5]; ++z)
+  {
+    for (int y = fractionalExtent[2]; y <= fractionalExtent[3]; ++y)
+    {
+      FRACTIONAL_DATA_TYPE* rowPointer = fractionalLabelMapPointer
+        + (y - fractionalExtent[2]) * increments[1] + (z - fractionalExtent[4]) * increments[2];
+      int iter = 0;
+      int r1 = 0;
+      int r2 = 0;
+      while (stencilData->GetNextExtent(r1, r2, fractionalExtent[0], fractionalExtent[1], y, z, iter))
+      {
+        for (int x = r1; x <= r2; ++x)
+        {
+          rowPointer[x - fractionalExtent[0]] += FRACTIONAL_STEP_SIZE;
+        }
+      }
+    }
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkPolyDataToFractionalLabelmapFilter::FillImageStencilData(
   vtkImageStencilData *data, vtkPolyData* closedSurface,
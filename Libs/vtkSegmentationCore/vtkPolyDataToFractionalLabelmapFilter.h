@@ -125,6 +125,13 @@ protected:
   /// \param fractionalLabelMap The fractional labelmap that the binary labelmap is added to
   void AddBinaryLabelMapToFractionalLabelMap(vtkImageData* binaryLabelMap, vtkImageData* fractionalLabelMap);
 
+  /// Add the voxels inside the stencil to the fractional labelmap.
+  /// Only the voxels covered by the stencil are visited, which is faster than
+  /// converting the stencil to a binary labelmap and adding that.
+  /// \param stencilData Stencil of the closed surface at the current offset
+  /// \param fractionalLabelMap The fractional labelmap that the stencil is added to
+  void AddImageStencilDataToFractionalLabelMap(vtkImageStencilData* stencilData, vtkImageData* fractionalLabelMap);
+
   /// Clip the polydata at the specified z coordinate to create a planar contour.
   /// This method is a modified version of vtkPolyDataToImageStencil::PolyDataCutter to decrease execution time
   /// \param input The closed surface that is being cut
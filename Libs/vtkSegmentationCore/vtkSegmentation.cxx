@@ -34,17 +34,25 @@
 #include <vtkMath.h>
 #include <vtkVersion.h>
 #include <vtkCallbackCommand.h>
+#include <vtkCommand.h>
+#include <vtkConditionVariable.h>
+#include <vtkMultiThreader.h>
+#include <vtkMutexLock.h>
 #include <vtkStringArray.h>
 #include <vtkAbstractTransform.h>
 #include <vtkMatrix4x4.h>
 #include <vtkTransform.h>
 #include <vtkPolyData.h>
 #include <vtkTransformPolyDataFilter.h>
+#include <vtkImageCast.h>
+#include <vtkPointData.h>
 
 // STD includes
 #include <sstream>
 #include <algorithm>
 #include <functional>
+#include <cstring>
+#include <vector>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSegmentation);
@@ -60,6 +68,123 @@ public:
     }
 };
 
+namespace
+{
+//----------------------------------------------------------------------------
+/// Conversion of a single segment, performed by a worker thread
+struct SegmentConversionJob
+{
+  std::string SegmentId;
+  vtkSmartPointer<vtkSegment> Segment;
+  /// Target representation before the conversion (and its modification time),
+  /// to determine if the representation has been changed
+  vtkDataObject* RepresentationBefore;
+  vtkMTimeType RepresentationBeforeMTime;
+  /// Converted representations, one for each step of the conversion path (NULL if the step is skipped)
+  std::vector< vtkSmartPointer<vtkDataObject> > ConvertedRepresentations;
+  bool Success;
+};
+
+//----------------------------------------------------------------------------
+/// Data shared between the thread that calls CreateRepresentation and the conversion worker threads.
+/// All members after Lock may only be accessed while Lock is locked.
+struct SegmentConversionThreadData
+{
+  std::vector<SegmentConversionJob> Jobs;
+  /// Each worker thread uses its own copy of the rules of the conversion path
+  std::vector< std::vector< vtkSmartPointer<vtkSegmentationConverterRule> > > WorkerPaths;
+  bool OverwriteExisting;
+
+  vtkMutexLock* Lock;
+  vtkConditionVariable* JobCompleted;
+  size_t NextWorkerIndex;
+  size_t NextJobIndex;
+  std::deque<size_t> CompletedJobIndices;
+  bool Cancelled;
+};
+
+//----------------------------------------------------------------------------
+/// Convert segment along the path without modifying the segment, the results are stored in convertedRepresentations.
+bool ConvertSegmentWithoutModifying(vtkSegment* segment, std::vector< vtkSmartPointer<vtkSegmentationConverterRule> >& path,
+  bool overwriteExisting, std::vector< vtkSmartPointer<vtkDataObject> >& convertedRepresentations)
+{
+  convertedRepresentations.clear();
+  std::map<std::string, vtkDataObject*> newRepresentations;
+  for (std::vector< vtkSmartPointer<vtkSegmentationConverterRule> >::iterator pathIt = path.begin(); pathIt != path.end(); ++pathIt)
+    {
+    vtkSegmentationConverterRule* currentConversionRule = pathIt->GetPointer();
+    if (!currentConversionRule)
+      {
+      return false;
+      }
+    std::string sourceRepresentationName = currentConversionRule->GetSourceRepresentationName();
+    std::string targetRepresentationName = currentConversionRule->GetTargetRepresentationName();
+
+    // Source representation is either created in a previous step or it is expected to exist in the segment
+    vtkDataObject* sourceRepresentation = NULL;
+    std::map<std::string, vtkDataObject*>::iterator newRepresentationIt = newRepresentations.find(sourceRepresentationName);
+    if (newRepresentationIt != newRepresentations.end())
+      {
+      sourceRepresentation = newRepresentationIt->second;
+      }
+    else
+      {
+      sourceRepresentation = segment->GetRepresentation(sourceRepresentationName);
+      }
+    if (!sourceRepresentation)
+      {
+      return false;
+      }
+
+    // If target representation exists and we do not overwrite existing representations,
+    // then no conversion is necessary with this conversion rule
+    if (!overwriteExisting && newRepresentations.find(targetRepresentationName) == newRepresentations.end()
+      && segment->GetRepresentation(targetRepresentationName))
+      {
+      convertedRepresentations.push_back(NULL);
+      continue;
+      }
+
+    // Always convert into a new object, as representations of the segment may be in use on other threads
+    vtkSmartPointer<vtkDataObject> targetRepresentation = vtkSmartPointer<vtkDataObject>::Take(
+      currentConversionRule->ConstructRepresentationObjectByRepresentation(targetRepresentationName) );
+    if (!targetRepresentation.GetPointer())
+      {
+      return false;
+      }
+    currentConversionRule->Convert(sourceRepresentation, targetRepresentation);
+    newRepresentations[targetRepresentationName] = targetRepresentation.GetPointer();
+    convertedRepresentations.push_back(targetRepresentation);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE SegmentConversionThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  SegmentConversionThreadData* data = static_cast<SegmentConversionThreadData*>(threadInfo->UserData);
+
+  data->Lock->Lock();
+  size_t workerIndex = data->NextWorkerIndex++;
+  while (!data->Cancelled && data->NextJobIndex < data->Jobs.size())
+    {
+    size_t jobIndex = data->NextJobIndex++;
+    data->Lock->Unlock();
+
+    SegmentConversionJob& job = data->Jobs[jobIndex];
+    job.Success = ConvertSegmentWithoutModifying(job.Segment, data->WorkerPaths[workerIndex],
+      data->OverwriteExisting, job.ConvertedRepresentations);
+
+    data->Lock->Lock();
+    data->CompletedJobIndices.push_back(jobIndex);
+    data->JobCompleted->Signal();
+    }
+  data->Lock->Unlock();
+  return VTK_THREAD_RETURN_VALUE;
+}
+}
+
 //----------------------------------------------------------------------------
 vtkSegmentation::vtkSegmentation()
 {
@@ -77,6 +202,10 @@ vtkSegmentation::vtkSegmentation()
   this->MasterRepresentationModifiedEnabled = true;
 
   this->SegmentIdAutogeneratorIndex = 0;
+
+  this->NumberOfConversionThreads = 0;
+
+  this->SetModifiedExtent(NULL);
 }
 
 //----------------------------------------------------------------------------
@@ -171,6 +300,10 @@ void vtkSegmentation::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "MasterRepresentationName:  " << this->MasterRepresentationName << "\n";
   os << indent << "Number of segments:  " << this->Segments.size() << "\n";
+  os << indent << "NumberOfConversionThreads:  " << this->NumberOfConversionThreads << "\n";
+  os << indent << "ModifiedExtent:  " << this->ModifiedExtent[0] << " " << this->ModifiedExtent[1] << " "
+    << this->ModifiedExtent[2] << " " << this->ModifiedExtent[3] << " "
+    << this->ModifiedExtent[4] << " " << this->ModifiedExtent[5] << "\n";
 
   for (std::deque< std::string >::iterator segmentIdIt = this->SegmentIds.begin();
     segmentIdIt != this->SegmentIds.end(); ++segmentIdIt)
@@ -265,6 +398,16 @@ bool vtkSegmentation::SetMasterRepresentationModifiedEnabled(bool enabled)
   return !enabled; // return old value
 }
 
+//---------------------------------------------------------------------------
+void vtkSegmentation::SetModifiedExtent(const int extent[6])
+{
+  for (int i = 0; i < 6; ++i)
+    {
+    // Empty extent if not specified
+    this->ModifiedExtent[i] = (extent ? extent[i] : (i % 2 ? -1 : 0));
+    }
+}
+
 //---------------------------------------------------------------------------
 std::string vtkSegmentation::GenerateUniqueSegmentID(std::string id)
 {
@@ -517,6 +660,8 @@ void vtkSegmentation::RemoveSegment(SegmentMap::iterator segmentIt)
     masterRepresentation->RemoveObservers(vtkCommand::ModifiedEvent, this->MasterRepresentationCallbackCommand);
     }
 
+  this->EvictedRepresentations.erase(segmentIt->second.GetPointer());
+
   // Remove segment
   this->SegmentIds.erase(std::remove(this->SegmentIds.begin(), this->SegmentIds.end(), segmentId), this->SegmentIds.end());
   this->Segments.erase(segmentIt);
@@ -869,6 +1014,180 @@ bool vtkSegmentation::ConvertSegmentUsingPath(vtkSegment* segment, vtkSegmentati
   return true;
 }
 
+//---------------------------------------------------------------------------
+int vtkSegmentation::GetNumberOfConversionThreadsToUse(int numberOfSegments)
+{
+  int numberOfThreads = this->NumberOfConversionThreads;
+  if (numberOfThreads <= 0)
+    {
+    numberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    }
+  // No need for more threads than segments. Spawned thread count is limited in vtkMultiThreader.
+  numberOfThreads = std::min(numberOfThreads, numberOfSegments);
+  numberOfThreads = std::min(numberOfThreads, VTK_MAX_THREADS);
+  return std::max(numberOfThreads, 1);
+}
+
+//---------------------------------------------------------------------------
+bool vtkSegmentation::ConvertSegmentsUsingPath(vtkSegmentationConverter::ConversionPathType path, bool overwriteExisting,
+  bool alwaysInvokeRepresentationModified)
+{
+  if (path.empty())
+    {
+    return false;
+    }
+  std::string targetRepresentationName = path.back()->GetTargetRepresentationName();
+  const int numberOfSegments = this->Segments.size();
+  const int numberOfThreads = this->GetNumberOfConversionThreadsToUse(numberOfSegments);
+  int numberOfCompletedSegments = 0;
+
+  if (numberOfThreads < 2)
+    {
+    for (SegmentMap::iterator segmentIt = this->Segments.begin(); segmentIt != this->Segments.end(); ++segmentIt)
+      {
+      vtkDataObject* representationBefore = segmentIt->second->GetRepresentation(targetRepresentationName);
+      vtkMTimeType representationBeforeMTime = (representationBefore ? representationBefore->GetMTime() : 0);
+      if (!this->ConvertSegmentUsingPath(segmentIt->second, path, overwriteExisting))
+        {
+        return false;
+        }
+      vtkDataObject* representationAfter = segmentIt->second->GetRepresentation(targetRepresentationName);
+      if (alwaysInvokeRepresentationModified || representationBefore != representationAfter
+        || (representationAfter != NULL && representationBeforeMTime != representationAfter->GetMTime()) )
+        {
+        // representation has been modified
+        const char* segmentId = segmentIt->first.c_str();
+        this->InvokeEvent(vtkSegmentation::RepresentationModified, (void*)segmentId);
+        }
+      double progress = static_cast<double>(++numberOfCompletedSegments) / numberOfSegments;
+      this->InvokeEvent(vtkCommand::ProgressEvent, &progress);
+      }
+    return true;
+    }
+
+  // Set up conversion jobs and thread-local copies of the conversion rules
+  vtkNew<vtkMutexLock> lock;
+  vtkNew<vtkConditionVariable> jobCompleted;
+  SegmentConversionThreadData data;
+  data.OverwriteExisting = overwriteExisting;
+  data.Lock = lock.GetPointer();
+  data.JobCompleted = jobCompleted.GetPointer();
+  data.NextWorkerIndex = 0;
+  data.NextJobIndex = 0;
+  data.Cancelled = false;
+  data.Jobs.resize(numberOfSegments);
+  int jobIndex = 0;
+  for (SegmentMap::iterator segmentIt = this->Segments.begin(); segmentIt != this->Segments.end(); ++segmentIt, ++jobIndex)
+    {
+    SegmentConversionJob& job = data.Jobs[jobIndex];
+    job.SegmentId = segmentIt->first;
+    job.Segment = segmentIt->second;
+    job.RepresentationBefore = segmentIt->second->GetRepresentation(targetRepresentationName);
+    job.RepresentationBeforeMTime = (job.RepresentationBefore ? job.RepresentationBefore->GetMTime() : 0);
+    job.Success = false;
+    }
+  data.WorkerPaths.resize(numberOfThreads);
+  for (int workerIndex = 0; workerIndex < numberOfThreads; ++workerIndex)
+    {
+    for (vtkSegmentationConverter::ConversionPathType::iterator pathIt = path.begin(); pathIt != path.end(); ++pathIt)
+      {
+      if (!(*pathIt))
+        {
+        vtkErrorMacro("ConvertSegmentsUsingPath: Invalid converter rule!");
+        return false;
+        }
+      data.WorkerPaths[workerIndex].push_back(vtkSmartPointer<vtkSegmentationConverterRule>::Take((*pathIt)->Clone()));
+      }
+    }
+
+  // Start worker threads
+  vtkNew<vtkMultiThreader> threader;
+  std::vector<int> threadIds;
+  for (int workerIndex = 0; workerIndex < numberOfThreads; ++workerIndex)
+    {
+    int threadId = threader->SpawnThread(SegmentConversionThreadFunction, &data);
+    if (threadId < 0)
+      {
+      break;
+      }
+    threadIds.push_back(threadId);
+    }
+  if (threadIds.empty())
+    {
+    // Failed to start threads, convert all segments on this thread
+    vtkMultiThreader::ThreadInfo threadInfo;
+    threadInfo.UserData = &data;
+    SegmentConversionThreadFunction(&threadInfo);
+    }
+
+  // Add converted representations to the segments on this thread, as soon as they become available
+  bool success = true;
+  lock->Lock();
+  while (static_cast<size_t>(numberOfCompletedSegments) < data.NextJobIndex
+    || (!data.Cancelled && data.NextJobIndex < data.Jobs.size()))
+    {
+    while (data.CompletedJobIndices.empty())
+      {
+      jobCompleted->Wait(lock.GetPointer());
+      }
+    SegmentConversionJob& job = data.Jobs[data.CompletedJobIndices.front()];
+    data.CompletedJobIndices.pop_front();
+    if (!job.Success)
+      {
+      // Segments that have not been started yet are not converted
+      data.Cancelled = true;
+      }
+    lock->Unlock();
+    numberOfCompletedSegments++;
+
+    if (!job.Success)
+      {
+      vtkErrorMacro("ConvertSegmentsUsingPath: Failed to convert segment " << job.SegmentId);
+      success = false;
+      }
+    else if (success)
+      {
+      for (size_t stepIndex = 0; stepIndex < path.size(); ++stepIndex)
+        {
+        vtkDataObject* convertedRepresentation = job.ConvertedRepresentations[stepIndex];
+        if (!convertedRepresentation)
+          {
+          continue;
+          }
+        std::string representationName = path[stepIndex]->GetTargetRepresentationName();
+        vtkDataObject* existingRepresentation = job.Segment->GetRepresentation(representationName);
+        if (existingRepresentation && !strcmp(existingRepresentation->GetClassName(), convertedRepresentation->GetClassName()))
+          {
+          // Update the existing object, as it may be used by observers
+          existingRepresentation->ShallowCopy(convertedRepresentation);
+          }
+        else
+          {
+          job.Segment->AddRepresentation(representationName, convertedRepresentation);
+          }
+        }
+      vtkDataObject* representationAfter = job.Segment->GetRepresentation(targetRepresentationName);
+      if (alwaysInvokeRepresentationModified || job.RepresentationBefore != representationAfter
+        || (representationAfter != NULL && job.RepresentationBeforeMTime != representationAfter->GetMTime()) )
+        {
+        // representation has been modified
+        const char* segmentId = job.SegmentId.c_str();
+        this->InvokeEvent(vtkSegmentation::RepresentationModified, (void*)segmentId);
+        }
+      double progress = static_cast<double>(numberOfCompletedSegments) / numberOfSegments;
+      this->InvokeEvent(vtkCommand::ProgressEvent, &progress);
+      }
+    lock->Lock();
+    }
+  lock->Unlock();
+
+  for (std::vector<int>::iterator threadIdIt = threadIds.begin(); threadIdIt != threadIds.end(); ++threadIdIt)
+    {
+    threader->TerminateThread(*threadIdIt);
+    }
+  return success;
+}
+
 //---------------------------------------------------------------------------
 bool vtkSegmentation::CreateRepresentation(const std::string& targetRepresentationName, bool alwaysConvert/*=false*/)
 {
@@ -884,7 +1203,8 @@ bool vtkSegmentation::CreateRepresentation(const std::string& targetRepresentati
     bool representationExists = true;
     for (SegmentMap::iterator segmentIt = this->Segments.begin(); segmentIt != this->Segments.end(); ++segmentIt)
       {
-      if (!segmentIt->second->GetRepresentation(targetRepresentationName))
+      if (!segmentIt->second->GetRepresentation(targetRepresentationName)
+        && !this->IsSegmentRepresentationEvicted(segmentIt->first, targetRepresentationName))
         {
         // All segments should have the same representation configuration,
         // so checking each segment is mostly a safety measure
@@ -931,22 +1251,10 @@ bool vtkSegmentation::CreateRepresentation(const std::string& targetRepresentati
     }
 
   // Perform conversion on all segments (no overwrites)
-  for (SegmentMap::iterator segmentIt = this->Segments.begin(); segmentIt != this->Segments.end(); ++segmentIt)
+  if (!this->ConvertSegmentsUsingPath(cheapestPath, alwaysConvert, false))
     {
-    vtkDataObject* representationBefore = segmentIt->second->GetRepresentation(targetRepresentationName);
-    if (!this->ConvertSegmentUsingPath(segmentIt->second, cheapestPath, alwaysConvert))
-      {
-      vtkErrorMacro("CreateRepresentation: Conversion failed");
-      return false;
-      }
-    vtkDataObject* representationAfter = segmentIt->second->GetRepresentation(targetRepresentationName);
-    if (representationBefore != representationAfter
-      || (representationBefore != NULL && representationAfter != NULL && representationBefore->GetMTime() != representationAfter->GetMTime()) )
-      {
-      // representation has been modified
-      const char* segmentId = segmentIt->first.c_str();
-      this->InvokeEvent(vtkSegmentation::RepresentationModified, (void*)segmentId);
-      }
+    vtkErrorMacro("CreateRepresentation: Conversion failed");
+    return false;
     }
 
   this->InvokeEvent(vtkSegmentation::ContainedRepresentationNamesModified);
@@ -971,15 +1279,10 @@ bool vtkSegmentation::CreateRepresentation(vtkSegmentationConverter::ConversionP
   this->Converter->SetConversionParameters(parameters);
 
   // Perform conversion on all segments (do overwrites)
-  for (SegmentMap::iterator segmentIt = this->Segments.begin(); segmentIt != this->Segments.end(); ++segmentIt)
+  if (!this->ConvertSegmentsUsingPath(path, true, true))
     {
-    if (!this->ConvertSegmentUsingPath(segmentIt->second, path, true))
-      {
-      vtkErrorMacro("CreateRepresentation: Conversion failed");
-      return false;
-      }
-    const char* segmentId = segmentIt->first.c_str();
-    this->InvokeEvent(vtkSegmentation::RepresentationModified, (void*)segmentId);
+    vtkErrorMacro("CreateRepresentation: Conversion failed");
+    return false;
     }
 
   this->InvokeEvent(vtkSegmentation::ContainedRepresentationNamesModified);
@@ -993,6 +1296,11 @@ void vtkSegmentation::RemoveRepresentation(const std::string& representationName
     {
     segmentIt->second->RemoveRepresentation(representationName);
     }
+  for (std::map<vtkSegment*, std::set<std::string> >::iterator evictedIt = this->EvictedRepresentations.begin();
+    evictedIt != this->EvictedRepresentations.end(); ++evictedIt)
+    {
+    evictedIt->second.erase(representationName);
+    }
 
   this->InvokeEvent(vtkSegmentation::ContainedRepresentationNamesModified);
 }
@@ -1005,9 +1313,65 @@ vtkDataObject* vtkSegmentation::GetSegmentRepresentation(std::string segmentId,
     {
     return NULL;
     }
+  vtkDataObject* representation = segment->GetRepresentation(representationName);
+  if (representation || !this->IsSegmentRepresentationEvicted(segmentId, representationName))
+    {
+    return representation;
+    }
+
+  // Convert the evicted representation again, reusing the existing intermediate representations
+  vtkSegmentationConverter::ConversionPathAndCostListType pathCosts;
+  this->Converter->GetPossibleConversions(this->MasterRepresentationName, representationName, pathCosts);
+  vtkSegmentationConverter::ConversionPathType cheapestPath = vtkSegmentationConverter::GetCheapestPath(pathCosts);
+  if (cheapestPath.empty() || !this->ConvertSegmentUsingPath(segment, cheapestPath, false))
+    {
+    vtkErrorMacro("GetSegmentRepresentation: Failed to convert evicted representation "
+      << representationName << " of segment " << segmentId);
+    return NULL;
+    }
+  this->EvictedRepresentations[segment].erase(representationName);
   return segment->GetRepresentation(representationName);
 }
 
+//---------------------------------------------------------------------------
+bool vtkSegmentation::EvictSegmentRepresentation(const std::string& segmentId, const std::string& representationName)
+{
+  if (representationName == this->MasterRepresentationName)
+    {
+    return false;
+    }
+  vtkSegment* segment = this->GetSegment(segmentId);
+  if (!segment || !segment->GetRepresentation(representationName))
+    {
+    return false;
+    }
+  vtkSegmentationConverter::ConversionPathAndCostListType pathCosts;
+  this->Converter->GetPossibleConversions(this->MasterRepresentationName, representationName, pathCosts);
+  if (pathCosts.empty())
+    {
+    // It could not be converted again
+    return false;
+    }
+
+  // Record the eviction before removing, observers of the segment may request the representation
+  this->EvictedRepresentations[segment].insert(representationName);
+  segment->RemoveRepresentation(representationName);
+  return true;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSegmentation::IsSegmentRepresentationEvicted(const std::string& segmentId, const std::string& representationName)
+{
+  vtkSegment* segment = this->GetSegment(segmentId);
+  if (!segment || segment->GetRepresentation(representationName))
+    {
+    return false;
+    }
+  std::map<vtkSegment*, std::set<std::string> >::iterator evictedIt = this->EvictedRepresentations.find(segment);
+  return evictedIt != this->EvictedRepresentations.end()
+    && evictedIt->second.find(representationName) != evictedIt->second.end();
+}
+
 //---------------------------------------------------------------------------
 void vtkSegmentation::InvalidateNonMasterRepresentations()
 {
@@ -1016,6 +1380,52 @@ void vtkSegmentation::InvalidateNonMasterRepresentations()
     {
     segmentIt->second->RemoveAllRepresentations(this->MasterRepresentationName);
     }
+  this->EvictedRepresentations.clear();
+}
+
+//---------------------------------------------------------------------------
+bool vtkSegmentation::UpdateSegmentFromMasterRepresentation(const std::string& segmentId)
+{
+  return this->UpdateSegmentFromMasterRepresentation(segmentId, NULL);
+}
+
+//---------------------------------------------------------------------------
+bool vtkSegmentation::UpdateSegmentFromMasterRepresentation(const std::string& segmentId, const int extent[6])
+{
+  vtkSegment* segment = this->GetSegment(segmentId);
+  if (!segment)
+    {
+    vtkErrorMacro("UpdateSegmentFromMasterRepresentation: Failed to find segment with ID " << segmentId);
+    return false;
+    }
+
+  // Update pipelines using the master representation without invalidating the other segments
+  bool wasMasterRepresentationModifiedEnabled = this->SetMasterRepresentationModifiedEnabled(false);
+  vtkDataObject* masterRepresentation = segment->GetRepresentation(this->MasterRepresentationName);
+  if (masterRepresentation)
+    {
+    masterRepresentation->Modified();
+    }
+
+  // Re-convert the other representations of the segment so that all segments keep the same representations
+  std::vector<std::string> representationNames;
+  segment->GetContainedRepresentationNames(representationNames);
+  for (std::vector<std::string>::iterator reprIt = representationNames.begin();
+    reprIt != representationNames.end(); ++reprIt)
+    {
+    if (reprIt->compare(this->MasterRepresentationName))
+      {
+      this->ConvertSingleSegment(segmentId, *reprIt);
+      }
+    }
+  this->SetMasterRepresentationModifiedEnabled(wasMasterRepresentationModifiedEnabled);
+
+  this->SetModifiedExtent(extent);
+  const char* segmentIdChar = segmentId.c_str();
+  this->InvokeEvent(vtkSegmentation::MasterRepresentationModified, (void*)segmentIdChar);
+  this->InvokeEvent(vtkSegmentation::RepresentationModified, (void*)segmentIdChar);
+  this->SetModifiedExtent(NULL);
+  return true;
 }
 
 //---------------------------------------------------------------------------
@@ -1028,6 +1438,20 @@ void vtkSegmentation::GetContainedRepresentationNames(std::vector<std::string>&
 
   vtkSegment* firstSegment = this->Segments.begin()->second;
   firstSegment->GetContainedRepresentationNames(representationNames);
+
+  // Evicted representations are still contained
+  std::map<vtkSegment*, std::set<std::string> >::iterator evictedIt = this->EvictedRepresentations.find(firstSegment);
+  if (evictedIt == this->EvictedRepresentations.end())
+    {
+    return;
+    }
+  for (std::set<std::string>::iterator nameIt = evictedIt->second.begin(); nameIt != evictedIt->second.end(); ++nameIt)
+    {
+    if (!firstSegment->GetRepresentation(*nameIt))
+      {
+      representationNames.push_back(*nameIt);
+      }
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -1488,3 +1912,152 @@ void vtkSegmentation::DeserializeConversionParameters(std::string conversionPara
 {
   this->Converter->DeserializeConversionParameters(conversionParametersString);
 }
+
+//-----------------------------------------------------------------------------
+bool vtkSegmentation::GenerateSharedLabelmapLayers(std::vector< vtkSmartPointer<vtkOrientedImageData> >& layers,
+  std::map<std::string, int>& segmentLayerIndices, std::map<std::string, int>& segmentLabelValues,
+  const std::vector<std::string>& segmentIDs/*=std::vector<std::string>()*/)
+{
+  layers.clear();
+  segmentLayerIndices.clear();
+  segmentLabelValues.clear();
+
+  if (!this->IsMasterRepresentationImageData())
+    {
+    vtkErrorMacro("GenerateSharedLabelmapLayers: Master representation is not image data");
+    return false;
+    }
+
+  std::vector<std::string> sharedSegmentIDs;
+  if (segmentIDs.empty())
+    {
+    this->GetSegmentIDs(sharedSegmentIDs);
+    }
+  else
+    {
+    sharedSegmentIDs = segmentIDs;
+    }
+
+  std::string commonGeometryString = this->DetermineCommonLabelmapGeometry(EXTENT_UNION_OF_EFFECTIVE_SEGMENTS, sharedSegmentIDs);
+  vtkSmartPointer<vtkOrientedImageData> commonGeometryImage = vtkSmartPointer<vtkOrientedImageData>::New();
+  vtkSegmentationConverter::DeserializeImageGeometry(commonGeometryString, commonGeometryImage, false);
+  const vtkIdType numberOfVoxels = commonGeometryImage->GetNumberOfPoints();
+
+  // Number of labels used in each layer
+  std::vector<int> numberOfLabelsInLayers;
+  for (std::vector<std::string>::iterator segmentIdIt = sharedSegmentIDs.begin(); segmentIdIt != sharedSegmentIDs.end(); ++segmentIdIt)
+    {
+    vtkSegment* segment = this->GetSegment(*segmentIdIt);
+    if (!segment)
+      {
+      vtkErrorMacro("GenerateSharedLabelmapLayers: Segment not found: " << *segmentIdIt);
+      return false;
+      }
+    vtkOrientedImageData* binaryLabelmap = vtkOrientedImageData::SafeDownCast(
+      segment->GetRepresentation(this->MasterRepresentationName));
+    vtkSmartPointer<vtkOrientedImageData> segmentLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+    if (numberOfVoxels > 0 && binaryLabelmap && binaryLabelmap->GetPointData()->GetScalars())
+      {
+      if (!vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(binaryLabelmap, commonGeometryImage, segmentLabelmap))
+        {
+        vtkErrorMacro("GenerateSharedLabelmapLayers: Segment " << *segmentIdIt << " cannot be resampled to common geometry");
+        return false;
+        }
+      if (segmentLabelmap->GetScalarType() != VTK_UNSIGNED_CHAR)
+        {
+        vtkNew<vtkImageCast> castFilter;
+        castFilter->SetInputData(segmentLabelmap);
+        castFilter->SetOutputScalarType(VTK_UNSIGNED_CHAR);
+        castFilter->Update();
+        segmentLabelmap->ShallowCopy(castFilter->GetOutput());
+        }
+      }
+    unsigned char* segmentVoxels = NULL;
+    if (segmentLabelmap->GetPointData()->GetScalars() && segmentLabelmap->GetNumberOfPoints() == numberOfVoxels)
+      {
+      segmentVoxels = static_cast<unsigned char*>(segmentLabelmap->GetScalarPointer());
+      }
+
+    // Find the first layer where the segment does not overlap with other segments
+    int layerIndex = 0;
+    for (; layerIndex < static_cast<int>(layers.size()); ++layerIndex)
+      {
+      if (numberOfLabelsInLayers[layerIndex] >= VTK_SHORT_MAX)
+        {
+        continue;
+        }
+      if (!segmentVoxels)
+        {
+        // empty segment fits in any layer
+        break;
+        }
+      short* layerVoxels = static_cast<short*>(layers[layerIndex]->GetScalarPointer());
+      bool overlap = false;
+      for (vtkIdType voxelIndex = 0; voxelIndex < numberOfVoxels; ++voxelIndex)
+        {
+        if (segmentVoxels[voxelIndex] && layerVoxels[voxelIndex])
+          {
+          overlap = true;
+          break;
+          }
+        }
+      if (!overlap)
+        {
+        break;
+        }
+      }
+    if (layerIndex == static_cast<int>(layers.size()))
+      {
+      vtkSmartPointer<vtkOrientedImageData> newLayer = vtkSmartPointer<vtkOrientedImageData>::New();
+      newLayer->ShallowCopy(commonGeometryImage);
+      newLayer->AllocateScalars(VTK_SHORT, 1);
+      vtkOrientedImageDataResample::FillImage(newLayer, 0);
+      layers.push_back(newLayer);
+      numberOfLabelsInLayers.push_back(0);
+      }
+
+    const short labelValue = static_cast<short>(++numberOfLabelsInLayers[layerIndex]);
+    if (segmentVoxels)
+      {
+      short* layerVoxels = static_cast<short*>(layers[layerIndex]->GetScalarPointer());
+      for (vtkIdType voxelIndex = 0; voxelIndex < numberOfVoxels; ++voxelIndex)
+        {
+        if (segmentVoxels[voxelIndex])
+          {
+          layerVoxels[voxelIndex] = labelValue;
+          }
+        }
+      layers[layerIndex]->Modified();
+      }
+    segmentLayerIndices[*segmentIdIt] = layerIndex;
+    segmentLabelValues[*segmentIdIt] = labelValue;
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSegmentation::ExtractSegmentFromSharedLabelmapLayer(vtkOrientedImageData* layer, int labelValue, vtkOrientedImageData* binaryLabelmap)
+{
+  if (!layer || !binaryLabelmap || !layer->GetPointData()->GetScalars()
+    || layer->GetScalarType() != VTK_SHORT || layer->GetNumberOfScalarComponents() != 1)
+    {
+    vtkGenericWarningMacro("vtkSegmentation::ExtractSegmentFromSharedLabelmapLayer failed: invalid inputs");
+    return false;
+    }
+  binaryLabelmap->SetExtent(layer->GetExtent());
+  binaryLabelmap->SetOrigin(layer->GetOrigin());
+  binaryLabelmap->SetSpacing(layer->GetSpacing());
+  binaryLabelmap->CopyDirections(layer);
+  binaryLabelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+
+  const vtkIdType numberOfVoxels = layer->GetNumberOfPoints();
+  const short* layerVoxels = static_cast<short*>(layer->GetScalarPointer());
+  unsigned char* segmentVoxels = static_cast<unsigned char*>(binaryLabelmap->GetScalarPointer());
+  for (vtkIdType voxelIndex = 0; voxelIndex < numberOfVoxels; ++voxelIndex)
+    {
+    segmentVoxels[voxelIndex] = (layerVoxels[voxelIndex] == labelValue ? 1 : 0);
+    }
+  binaryLabelmap->Modified();
+  return true;
+}
@@ -28,6 +28,7 @@
 // STD includes
 #include <map>
 #include <deque>
+#include <set>
 
 // SegmentationCore includes
 #include "vtkSegment.h"
@@ -170,7 +171,28 @@ public:
   /// \param computeEffectiveExtent Specifies if the extent of a segment is the whole extent or the effective extent (where voxel values >0 found)
   void DetermineCommonLabelmapExtent(int commonGeometryExtent[6], vtkOrientedImageData* commonGeometryImage,
     const std::vector<std::string>& segmentIDs = std::vector<std::string>(), bool computeEffectiveExtent=false, bool addPadding=false);
+
+  /// Pack binary labelmaps of segments into as few shared labelmap layers as possible.
+  /// Segments that do not overlap are stored in the same layer, each segment with a different
+  /// label value (starting from 1). A new layer is only added where segments overlap, therefore
+  /// a layer typically takes a fraction of the memory needed for storing each segment separately.
+  /// All layers use the common labelmap geometry of the segments (\sa DetermineCommonLabelmapGeometry).
+  /// \param layers Output labelmap layers (short scalar type)
+  /// \param segmentLayerIndices Index of the layer containing each segment, by segment ID
+  /// \param segmentLabelValues Label value of each segment in its layer, by segment ID
+  /// \param segmentIDs List of IDs of segments to include. If empty or missing, then all segments are included
+  /// \return Success flag
+  bool GenerateSharedLabelmapLayers(std::vector< vtkSmartPointer<vtkOrientedImageData> >& layers,
+    std::map<std::string, int>& segmentLayerIndices, std::map<std::string, int>& segmentLabelValues,
+    const std::vector<std::string>& segmentIDs = std::vector<std::string>());
 //ETX
+
+  /// Extract binary labelmap of a segment from a shared labelmap layer created by \sa GenerateSharedLabelmapLayers.
+  /// \param layer Shared labelmap layer
+  /// \param labelValue Label value of the segment in the layer
+  /// \param binaryLabelmap Output binary labelmap (unsigned char scalar type, same geometry as the layer)
+  /// \return Success flag
+  static bool ExtractSegmentFromSharedLabelmapLayer(vtkOrientedImageData* layer, int labelValue, vtkOrientedImageData* binaryLabelmap);
 #endif // __VTK_WRAP__
 
   /// Determine common labelmap geometry for whole segmentation, for python compatibility.
@@ -244,9 +266,21 @@ public:
   /// \return Vector of segments containing the requested tag
   std::vector<vtkSegment*> GetSegmentsByTag(std::string tag, std::string value="");
 
-  /// Get representation from segment
+  /// Get representation from segment.
+  /// If the representation has been evicted (\sa EvictSegmentRepresentation) then it is
+  /// converted again from the master representation.
   vtkDataObject* GetSegmentRepresentation(std::string segmentId, std::string representationName);
 
+  /// Remove a derived representation from a segment to release its memory.
+  /// Unlike \sa RemoveRepresentation, the segmentation still contains the representation:
+  /// it is converted again when requested by \sa GetSegmentRepresentation.
+  /// Only representations that can be converted from the master representation are evicted.
+  /// \return True if the representation has been removed from the segment
+  bool EvictSegmentRepresentation(const std::string& segmentId, const std::string& representationName);
+
+  /// Determine if a representation of a segment has been evicted and not converted again since.
+  bool IsSegmentRepresentationEvicted(const std::string& segmentId, const std::string& representationName);
+
   /// Copy segment from one segmentation to this one
   /// \param fromSegmentation Source segmentation
   /// \param segmentId ID of segment to copy
@@ -279,6 +313,15 @@ public:
   /// Invalidate (remove) non-master representations in all the segments if this segmentation node
   void InvalidateNonMasterRepresentations();
 
+  /// Update the other representations of a segment after its master representation has been
+  /// modified in place (e.g., through a NumPy array sharing its memory), then invoke
+  /// \sa MasterRepresentationModified and \sa RepresentationModified once with the segment ID.
+  /// \param extent Region of the master representation that has been modified, in the IJK
+  ///   coordinates of its binary labelmap. It is reported by \sa GetModifiedExtent while the events are invoked.
+  /// \return Success flag
+  bool UpdateSegmentFromMasterRepresentation(const std::string& segmentId, const int extent[6]);
+  bool UpdateSegmentFromMasterRepresentation(const std::string& segmentId);
+
 // Conversion related methods
 
   /// Create a representation in all segments, using the conversion path with the
@@ -290,7 +333,12 @@ public:
   ///       specific, and also to allow optimizations (steps before per-segment conversion).
   /// \param targetRepresentationName Name of the representation to create
   /// \param alwaysConvert If true, then conversion takes place even if target representation exists. False by default.
+  ///   Evicted representations are considered existing, they are only converted again on demand
+  ///   (\sa GetSegmentRepresentation) unless alwaysConvert is true.
   /// \return true on success
+  /// Segments are converted in parallel (\sa NumberOfConversionThreads). Converted representations are added
+  /// to the segments on the calling thread and a vtkCommand::ProgressEvent (with the completed fraction as
+  /// double* call data) is invoked after each segment.
   bool CreateRepresentation(const std::string& targetRepresentationName, bool alwaysConvert=false);
 
   /// Generate or update a representation in all segments, using the specified conversion
@@ -353,6 +401,19 @@ public:
   /// the segmentation! Use \sa CreateRepresentation for that.
   virtual void SetMasterRepresentationName(const std::string& representationName);
 
+  /// Number of threads used for converting segments in \sa CreateRepresentation.
+  /// Each thread converts one segment at a time, using its own copy of the conversion rules.
+  /// 0 means the default number of threads of vtkMultiThreader (default), 1 disables multithreading.
+  vtkSetClampMacro(NumberOfConversionThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfConversionThreads, int);
+
+  /// Region of the master representation of the segment that is changed by the modification
+  /// being notified, in the IJK coordinates of its binary labelmap.
+  /// Only valid while MasterRepresentationModified and RepresentationModified events are invoked
+  /// (the segment ID is passed as call data): observers can use it to only update the modified
+  /// region. The extent is empty (e.g., 0,-1,0,-1,0,-1) if the whole segment may have changed.
+  vtkGetVector6Macro(ModifiedExtent, int);
+
 protected:
   /// Convert given segment along a specified path
   /// \param segment Segment to convert
@@ -362,6 +423,19 @@ protected:
   /// \return Success flag
   bool ConvertSegmentUsingPath(vtkSegment* segment, vtkSegmentationConverter::ConversionPathType path, bool overwriteExisting=false);
 
+  /// Convert all segments along a specified path, using multiple threads if enabled.
+  /// Representations are added to the segments on the calling thread, as soon as the conversion of
+  /// a segment is completed. \sa RepresentationModified and vtkCommand::ProgressEvent are invoked for each segment.
+  /// \param overwriteExisting If true then do each conversion step regardless the target representation exists.
+  /// \param alwaysInvokeRepresentationModified If false then \sa RepresentationModified is only invoked
+  ///   if the target representation is changed.
+  /// \return Success flag
+  bool ConvertSegmentsUsingPath(vtkSegmentationConverter::ConversionPathType path, bool overwriteExisting,
+    bool alwaysInvokeRepresentationModified);
+
+  /// Get the number of threads to use for converting the specified number of segments
+  int GetNumberOfConversionThreadsToUse(int numberOfSegments);
+
   /// Converts a single segment to a representation.
   bool ConvertSingleSegment(std::string segmentId, std::string targetRepresentationName);
 
@@ -375,6 +449,10 @@ protected:
   /// state when calling SetMasterRepresentationModifiedEnabled in nested functions.
   bool SetMasterRepresentationModifiedEnabled(bool enabled);
 
+  /// Set the region reported by \sa GetModifiedExtent. Does not invoke any event.
+  /// Set NULL to indicate that the whole segment may have changed.
+  void SetModifiedExtent(const int extent[6]);
+
 protected:
   /// Callback function invoked when segment is modified.
   /// It calls Modified on the segmentation and rebuilds observations on the master representation of each segment
@@ -420,6 +498,16 @@ protected:
   /// alphabetical order)
   std::deque< std::string > SegmentIds;
 
+  /// Number of threads used for converting segments. \sa SetNumberOfConversionThreads
+  int NumberOfConversionThreads;
+
+  /// Region changed by the modification being notified. \sa GetModifiedExtent
+  int ModifiedExtent[6];
+
+  /// Representations removed from each segment by \sa EvictSegmentRepresentation.
+  /// An entry is only valid while the segment does not contain the representation.
+  std::map<vtkSegment*, std::set<std::string> > EvictedRepresentations;
+
   friend class vtkSlicerSegmentationsModuleLogic;
   friend class qMRMLSegmentEditorWidgetPrivate;
 };
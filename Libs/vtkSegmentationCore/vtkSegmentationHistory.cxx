@@ -22,11 +22,90 @@
 #include "vtkSegmentationHistory.h"
 #include "vtkSegmentationConverterFactory.h"
 #include "vtkSegmentation.h"
+#include "vtkOrientedImageData.h"
 
 // VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkFieldData.h>
+#include <vtkIntArray.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
-#include <vtkCallbackCommand.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+
+// STD includes
+#include <cstring>
+#include <set>
+#include <vector>
+
+namespace
+{
+const char* COMPRESSED_VOXELS_ARRAY_NAME = "SegmentationHistoryCompressedVoxels";
+const char* COMPRESSION_INFO_ARRAY_NAME = "SegmentationHistoryCompressionInfo";
+
+enum
+{
+  CompressionInfoScalarType = 0,
+  CompressionInfoNumberOfComponents,
+  CompressionInfoRunLengthEncoded,
+  CompressionInfoSize
+};
+
+/// Each run is stored as a 32-bit repeat count followed by the bytes of the repeated element.
+/// Returns false if the encoded buffer would not be smaller than the input.
+bool EncodeRunLength(const unsigned char* data, vtkIdType numberOfElements, int elementSize,
+  std::vector<unsigned char>& encoded)
+{
+  encoded.clear();
+  const vtkIdType maximumEncodedSize = numberOfElements * elementSize;
+  const unsigned int maximumRunLength = 0xffffffff;
+  vtkIdType elementIndex = 0;
+  while (elementIndex < numberOfElements)
+    {
+    const unsigned char* element = data + elementIndex * elementSize;
+    unsigned int runLength = 1;
+    while (elementIndex + runLength < numberOfElements && runLength < maximumRunLength
+      && memcmp(element, element + runLength * elementSize, elementSize) == 0)
+      {
+      runLength++;
+      }
+    if (static_cast<vtkIdType>(encoded.size() + sizeof(unsigned int) + elementSize) >= maximumEncodedSize)
+      {
+      // compression would not save memory
+      return false;
+      }
+    const unsigned char* runLengthBytes = reinterpret_cast<const unsigned char*>(&runLength);
+    encoded.insert(encoded.end(), runLengthBytes, runLengthBytes + sizeof(unsigned int));
+    encoded.insert(encoded.end(), element, element + elementSize);
+    elementIndex += runLength;
+    }
+  return true;
+}
+
+bool DecodeRunLength(const unsigned char* encoded, vtkIdType encodedSize, int elementSize,
+  unsigned char* data, vtkIdType numberOfElements)
+{
+  const unsigned char* encodedEnd = encoded + encodedSize;
+  unsigned char* dataEnd = data + numberOfElements * elementSize;
+  while (encoded + sizeof(unsigned int) + elementSize <= encodedEnd)
+    {
+    unsigned int runLength = 0;
+    memcpy(&runLength, encoded, sizeof(unsigned int));
+    encoded += sizeof(unsigned int);
+    if (data + static_cast<vtkIdType>(runLength) * elementSize > dataEnd)
+      {
+      return false;
+      }
+    for (unsigned int i = 0; i < runLength; ++i)
+      {
+      memcpy(data, encoded, elementSize);
+      data += elementSize;
+      }
+    encoded += elementSize;
+    }
+  return (data == dataEnd && encoded == encodedEnd);
+}
+}
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSegmentationHistory);
@@ -37,6 +116,8 @@ vtkSegmentationHistory::vtkSegmentationHistory()
   this->Segmentation = NULL;
 
   this->MaximumNumberOfStates = 5;
+  this->MaximumMemorySize = 0;
+  this->CompressLabelmaps = true;
 
   this->LastRestoredState = 0;
   this->RestoreStateInProgress = false;
@@ -95,6 +176,9 @@ void vtkSegmentationHistory::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Modified Time: " << this->GetMTime() << "\n";
 
   os << indent << "Number of saved states:  " << this->SegmentationStates.size() << "\n";
+  os << indent << "Maximum number of states:  " << this->MaximumNumberOfStates << "\n";
+  os << indent << "Maximum memory size:  " << this->MaximumMemorySize << "\n";
+  os << indent << "Compress labelmaps:  " << (this->CompressLabelmaps ? "true" : "false") << "\n";
 }
 
 //---------------------------------------------------------------------------
@@ -178,6 +262,16 @@ void vtkSegmentationHistory::CopySegment(vtkSegment* destination, vtkSegment* so
       }
     else
       {
+      if (this->CompressLabelmaps)
+        {
+        vtkDataObject* compressedRepresentation = vtkSegmentationHistory::CreateCompressedLabelmap(sourceRepresentation);
+        if (compressedRepresentation)
+          {
+          destination->AddRepresentation(*representationNameIt, compressedRepresentation);
+          compressedRepresentation->Delete(); // this representation is now owned by the segment
+          continue;
+          }
+        }
       vtkDataObject* representationCopy =
         vtkSegmentationConverterFactory::GetInstance()->ConstructRepresentationObjectByClass(sourceRepresentation->GetClassName());
       if (!representationCopy)
@@ -192,6 +286,152 @@ void vtkSegmentationHistory::CopySegment(vtkSegment* destination, vtkSegment* so
     }
 }
 
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::RestoreSegment(vtkSegment* destination, vtkSegment* storedSegment)
+{
+  destination->DeepCopyMetadata(storedSegment);
+
+  // Remove representations that are not in the stored segment
+  std::vector<std::string> destinationRepresentationNames;
+  destination->GetContainedRepresentationNames(destinationRepresentationNames);
+  for (std::vector<std::string>::iterator representationNameIt = destinationRepresentationNames.begin();
+    representationNameIt != destinationRepresentationNames.end(); ++representationNameIt)
+    {
+    if (storedSegment->GetRepresentation(*representationNameIt) == NULL)
+      {
+      destination->RemoveRepresentation(*representationNameIt);
+      }
+    }
+
+  // Copy representations
+  std::vector<std::string> representationNames;
+  storedSegment->GetContainedRepresentationNames(representationNames);
+  for (std::vector<std::string>::iterator representationNameIt = representationNames.begin();
+    representationNameIt != representationNames.end(); ++representationNameIt)
+    {
+    vtkDataObject* storedRepresentation = storedSegment->GetRepresentation(*representationNameIt);
+    vtkDataObject* representationCopy = NULL;
+    if (vtkSegmentationHistory::IsCompressedLabelmap(storedRepresentation))
+      {
+      representationCopy = vtkSegmentationHistory::CreateDecompressedLabelmap(storedRepresentation);
+      }
+    else
+      {
+      representationCopy = vtkSegmentationConverterFactory::GetInstance()->ConstructRepresentationObjectByClass(
+        storedRepresentation->GetClassName());
+      if (representationCopy)
+        {
+        representationCopy->DeepCopy(storedRepresentation);
+        }
+      }
+    if (!representationCopy)
+      {
+      vtkErrorMacro("RestoreSegment: Unable to restore representation '" << *representationNameIt << "'");
+      continue;
+      }
+    destination->AddRepresentation(*representationNameIt, representationCopy);
+    representationCopy->Delete(); // this representation is now owned by the segment
+    }
+}
+
+//---------------------------------------------------------------------------
+vtkDataObject* vtkSegmentationHistory::CreateCompressedLabelmap(vtkDataObject* labelmap)
+{
+  vtkOrientedImageData* image = vtkOrientedImageData::SafeDownCast(labelmap);
+  if (!image || !image->GetPointData() || !image->GetPointData()->GetScalars())
+    {
+    return NULL;
+    }
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  const vtkIdType numberOfElements = scalars->GetNumberOfTuples();
+  const int elementSize = image->GetScalarSize() * image->GetNumberOfScalarComponents();
+  if (numberOfElements < 1 || numberOfElements != image->GetNumberOfPoints())
+    {
+    return NULL;
+    }
+
+  std::vector<unsigned char> encoded;
+  if (!EncodeRunLength(static_cast<unsigned char*>(scalars->GetVoidPointer(0)), numberOfElements, elementSize, encoded))
+    {
+    // voxel values change too frequently, compression would not save memory
+    return NULL;
+    }
+
+  // Image geometry without scalars
+  vtkOrientedImageData* compressedImage = vtkOrientedImageData::New();
+  compressedImage->SetExtent(image->GetExtent());
+  compressedImage->SetOrigin(image->GetOrigin());
+  compressedImage->SetSpacing(image->GetSpacing());
+  compressedImage->CopyDirections(image);
+
+  vtkNew<vtkUnsignedCharArray> voxelsArray;
+  voxelsArray->SetName(COMPRESSED_VOXELS_ARRAY_NAME);
+  voxelsArray->SetNumberOfValues(encoded.size());
+  if (!encoded.empty())
+    {
+    memcpy(voxelsArray->GetPointer(0), &(encoded[0]), encoded.size());
+    }
+  compressedImage->GetFieldData()->AddArray(voxelsArray.GetPointer());
+
+  vtkNew<vtkIntArray> infoArray;
+  infoArray->SetName(COMPRESSION_INFO_ARRAY_NAME);
+  infoArray->SetNumberOfValues(CompressionInfoSize);
+  infoArray->SetValue(CompressionInfoScalarType, image->GetScalarType());
+  infoArray->SetValue(CompressionInfoNumberOfComponents, image->GetNumberOfScalarComponents());
+  infoArray->SetValue(CompressionInfoRunLengthEncoded, 1);
+  compressedImage->GetFieldData()->AddArray(infoArray.GetPointer());
+
+  return compressedImage;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSegmentationHistory::IsCompressedLabelmap(vtkDataObject* representation)
+{
+  vtkOrientedImageData* image = vtkOrientedImageData::SafeDownCast(representation);
+  if (!image || !image->GetFieldData())
+    {
+    return false;
+    }
+  return (image->GetFieldData()->GetAbstractArray(COMPRESSION_INFO_ARRAY_NAME) != NULL);
+}
+
+//---------------------------------------------------------------------------
+vtkDataObject* vtkSegmentationHistory::CreateDecompressedLabelmap(vtkDataObject* compressedLabelmap)
+{
+  if (!vtkSegmentationHistory::IsCompressedLabelmap(compressedLabelmap))
+    {
+    return NULL;
+    }
+  vtkOrientedImageData* compressedImage = vtkOrientedImageData::SafeDownCast(compressedLabelmap);
+  vtkIntArray* infoArray = vtkIntArray::SafeDownCast(
+    compressedImage->GetFieldData()->GetAbstractArray(COMPRESSION_INFO_ARRAY_NAME));
+  vtkUnsignedCharArray* voxelsArray = vtkUnsignedCharArray::SafeDownCast(
+    compressedImage->GetFieldData()->GetAbstractArray(COMPRESSED_VOXELS_ARRAY_NAME));
+  if (!infoArray || infoArray->GetNumberOfValues() < CompressionInfoSize || !voxelsArray)
+    {
+    vtkGenericWarningMacro("vtkSegmentationHistory::CreateDecompressedLabelmap failed: invalid compressed labelmap");
+    return NULL;
+    }
+
+  vtkOrientedImageData* image = vtkOrientedImageData::New();
+  image->SetExtent(compressedImage->GetExtent());
+  image->SetOrigin(compressedImage->GetOrigin());
+  image->SetSpacing(compressedImage->GetSpacing());
+  image->CopyDirections(compressedImage);
+  image->AllocateScalars(infoArray->GetValue(CompressionInfoScalarType),
+    infoArray->GetValue(CompressionInfoNumberOfComponents));
+
+  const int elementSize = image->GetScalarSize() * image->GetNumberOfScalarComponents();
+  if (!DecodeRunLength(voxelsArray->GetPointer(0), voxelsArray->GetNumberOfValues(), elementSize,
+    static_cast<unsigned char*>(image->GetScalarPointer()), image->GetNumberOfPoints()))
+    {
+    vtkGenericWarningMacro("vtkSegmentationHistory::CreateDecompressedLabelmap failed: corrupted compressed labelmap");
+    image->Delete();
+    return NULL;
+    }
+  return image;
+}
+
 //---------------------------------------------------------------------------
 bool vtkSegmentationHistory::RestorePreviousState()
 {
@@ -254,13 +494,13 @@ bool vtkSegmentationHistory::RestoreState(unsigned int stateIndex)
     vtkSegment* segment = this->Segmentation->GetSegment(restoredSegmentsIt->first);
     if (segment != NULL)
       {
-      segment->DeepCopy(restoredSegmentsIt->second);
+      this->RestoreSegment(segment, restoredSegmentsIt->second);
       segment->Modified();
       }
     else
       {
       vtkSmartPointer<vtkSegment> newSegment = vtkSmartPointer<vtkSegment>::New();
-      newSegment->DeepCopy(restoredSegmentsIt->second);
+      this->RestoreSegment(newSegment, restoredSegmentsIt->second);
       this->Segmentation->AddSegment(newSegment);
       }
     }
@@ -329,6 +569,17 @@ void vtkSegmentationHistory::RemoveAllObsoleteStates()
     this->LastRestoredState--;
     modified = true;
    }
+  if (this->MaximumMemorySize > 0)
+    {
+    // Keep the last restored state and the one before it so that the last change can be undone
+    while (this->SegmentationStates.size() > 2 && this->LastRestoredState > 1
+      && this->GetMemorySize() > this->MaximumMemorySize)
+      {
+      this->SegmentationStates.pop_front();
+      this->LastRestoredState--;
+      modified = true;
+      }
+    }
   if (modified)
     {
     this->Modified();
@@ -347,6 +598,46 @@ void vtkSegmentationHistory::SetMaximumNumberOfStates(unsigned int maximumNumber
   this->Modified();
 }
 
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::SetMaximumMemorySize(vtkIdType maximumMemorySize)
+{
+  if (maximumMemorySize == this->MaximumMemorySize)
+    {
+    return;
+    }
+  this->MaximumMemorySize = maximumMemorySize;
+  this->RemoveAllObsoleteStates();
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+vtkIdType vtkSegmentationHistory::GetMemorySize()
+{
+  vtkIdType memorySizeKiB = 0;
+  std::set<vtkDataObject*> countedRepresentations;
+  for (std::deque<SegmentationState>::iterator stateIt = this->SegmentationStates.begin();
+    stateIt != this->SegmentationStates.end(); ++stateIt)
+    {
+    for (SegmentsMap::iterator segmentIt = stateIt->Segments.begin(); segmentIt != stateIt->Segments.end(); ++segmentIt)
+      {
+      std::vector<std::string> representationNames;
+      segmentIt->second->GetContainedRepresentationNames(representationNames);
+      for (std::vector<std::string>::iterator representationNameIt = representationNames.begin();
+        representationNameIt != representationNames.end(); ++representationNameIt)
+        {
+        vtkDataObject* representation = segmentIt->second->GetRepresentation(*representationNameIt);
+        if (representation == NULL || !countedRepresentations.insert(representation).second)
+          {
+          // invalid or already counted (representations are shared between states if unchanged)
+          continue;
+          }
+        memorySizeKiB += representation->GetActualMemorySize();
+        }
+      }
+    }
+  return memorySizeKiB * 1024;
+}
+
 //---------------------------------------------------------------------------
 void vtkSegmentationHistory::OnSegmentationModified(vtkObject* vtkNotUsed(caller),
   unsigned long vtkNotUsed(eid),
@@ -379,3 +670,9 @@ void vtkSegmentationHistory::RemoveAllStates()
   this->LastRestoredState = 0;
   this->Modified();
 }
+
+//---------------------------------------------------------------------------
+int vtkSegmentationHistory::GetNumberOfStates()
+{
+  return this->SegmentationStates.size();
+}
@@ -32,6 +32,7 @@
 #include "vtkSegmentationCoreConfigure.h"
 
 class vtkCallbackCommand;
+class vtkDataObject;
 class vtkSegment;
 class vtkSegmentation;
 
@@ -74,6 +75,9 @@ public:
   /// Delete all states from memory
   void RemoveAllStates();
 
+  /// Get the number of stored states.
+  int GetNumberOfStates();
+
   /// Limits how many states may be stored.
   /// If the number of stored states exceed the limit then the oldest state is removed.
   void SetMaximumNumberOfStates(unsigned int maximumNumberOfStates);
@@ -81,6 +85,27 @@ public:
   /// Get the limit of how many states may be stored.
   vtkGetMacro(MaximumNumberOfStates, unsigned int);
 
+  /// Limits how much memory (in bytes) the stored states may use.
+  /// If the limit is exceeded then the oldest states are removed (the two most
+  /// recent states are always kept to allow undo/redo of the last change).
+  /// 0 means no limit (default).
+  void SetMaximumMemorySize(vtkIdType maximumMemorySize);
+
+  /// Get the limit of how much memory (in bytes) the stored states may use.
+  vtkGetMacro(MaximumMemorySize, vtkIdType);
+
+  /// Compute the memory (in bytes) used by the stored states.
+  /// Representations that are shared between states are counted once.
+  vtkIdType GetMemorySize();
+
+  /// If enabled (default) then labelmap representations are stored run-length
+  /// encoded and only decoded when the state is restored. Segment labelmaps
+  /// mostly contain long runs of the same value, therefore this typically
+  /// reduces the memory usage by orders of magnitude.
+  vtkSetMacro(CompressLabelmaps, bool);
+  vtkGetMacro(CompressLabelmaps, bool);
+  vtkBooleanMacro(CompressLabelmaps, bool);
+
 protected:
   /// Callback function called when the segmentation has been modified.
   /// It clears all states that are more recent than the last restored state.
@@ -90,6 +115,7 @@ protected:
   void RemoveAllNextStates();
 
   /// Delete all old states so that we keep only up to MaximumNumberOfStates states
+  /// and the stored states do not use more than MaximumMemorySize memory
   void RemoveAllObsoleteStates();
 
   /// Restores a state defined by stateIndex.
@@ -102,8 +128,24 @@ protected:
 
   /// Deep copies source segment to destination segment. If the same representation is found in baseline
   /// with up-to-date timestamp then the representation is reused from baseline.
+  /// Labelmap representations are stored compressed if CompressLabelmaps is enabled.
   void CopySegment(vtkSegment* destination, vtkSegment* source, vtkSegment* baseline);
 
+  /// Deep copies a segment of a stored state into a segment of the segmentation.
+  /// Compressed representations are decompressed.
+  void RestoreSegment(vtkSegment* destination, vtkSegment* storedSegment);
+
+  /// Create a run-length encoded copy of a labelmap. The returned image contains the geometry
+  /// of the input image but no scalars, the encoded voxels are stored in its field data.
+  /// Returns NULL if the image cannot be compressed (in this case it has to be deep-copied).
+  static vtkDataObject* CreateCompressedLabelmap(vtkDataObject* labelmap);
+
+  /// Returns true if the representation has been created by CreateCompressedLabelmap.
+  static bool IsCompressedLabelmap(vtkDataObject* representation);
+
+  /// Create a full labelmap from an image created by CreateCompressedLabelmap.
+  static vtkDataObject* CreateDecompressedLabelmap(vtkDataObject* compressedLabelmap);
+
 protected:  /// Container type for segments. Maps segment IDs to segment objects
   typedef std::map<std::string, vtkSmartPointer<vtkSegment> > SegmentsMap;
 
@@ -116,6 +158,8 @@ protected:  /// Container type for segments. Maps segment IDs to segment objects
   vtkCallbackCommand* SegmentationModifiedCallbackCommand;
   std::deque<SegmentationState> SegmentationStates;
   unsigned int MaximumNumberOfStates;
+  vtkIdType MaximumMemorySize;
+  bool CompressLabelmaps;
 
   // Index of the state in SegmentationStates that was restored last.
   // If index == size of states then it means that the segmentation has changed
@@ -27,6 +27,11 @@
 #include <vtkPolyDataCollection.h>
 #include <vtkIntArray.h>
 
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkTopologicalHierarchy);
 
@@ -68,7 +73,7 @@ vtkIntArray* vtkTopologicalHierarchy::GetOutputLevels()
 //----------------------------------------------------------------------------
 bool vtkTopologicalHierarchy::Contains(vtkPolyData* polyOut, vtkPolyData* polyIn)
 {
-  if (!polyOut || !polyOut)
+  if (!polyOut || !polyIn)
     {
     vtkErrorMacro("Contains: Empty input parameters!");
     return false;
@@ -80,6 +85,12 @@ bool vtkTopologicalHierarchy::Contains(vtkPolyData* polyOut, vtkPolyData* polyIn
   double extentIn[6] = {0.0,0.0,0.0,0.0,0.0,0.0};
   polyIn->GetBounds(extentIn);
 
+  return this->Contains(extentOut, extentIn);
+}
+
+//----------------------------------------------------------------------------
+bool vtkTopologicalHierarchy::Contains(const double extentOut[6], const double extentIn[6])
+{
   if ( extentOut[0] < extentIn[0] - this->ContainConstraintFactor * (extentOut[1]-extentOut[0])
     && extentOut[1] > extentIn[1] + this->ContainConstraintFactor * (extentOut[1]-extentOut[0])
     && extentOut[2] < extentIn[2] - this->ContainConstraintFactor * (extentOut[3]-extentOut[2])
@@ -105,7 +116,8 @@ void vtkTopologicalHierarchy::Update()
   this->OutputLevels->Initialize();
   unsigned int numberOfPolyData = this->InputPolyDataCollection->GetNumberOfItems();
 
-  // Check input polydata collection
+  // Check input polydata collection and get the bounds once
+  std::vector<double> bounds(6 * numberOfPolyData, 0.0);
   for (unsigned int polyOutIndex=0; polyOutIndex<numberOfPolyData; ++polyOutIndex)
     {
     vtkPolyData* polyOut = vtkPolyData::SafeDownCast(this->InputPolyDataCollection->GetItemAsObject(polyOutIndex));
@@ -114,7 +126,26 @@ void vtkTopologicalHierarchy::Update()
       vtkErrorMacro("Update: Input collection contains invalid object at item " << polyOutIndex);
       return;
       }
+    polyOut->GetBounds(&bounds[6 * polyOutIndex]);
+    }
+
+  // Index the poly data by the lower X bound of their bounding box, so that only the
+  // poly data with a lower X bound inside the X range of a poly data are tested for
+  // containment. Poly data with invalid bounds (e.g. no points) are always tested.
+  std::vector<std::pair<double, unsigned int> > sortedLowerBounds;
+  std::vector<unsigned int> invalidBounds;
+  for (unsigned int polyIndex=0; polyIndex<numberOfPolyData; ++polyIndex)
+    {
+    if (!(bounds[6*polyIndex] <= bounds[6*polyIndex+1]))
+      {
+      invalidBounds.push_back(polyIndex);
+      }
+    else
+      {
+      sortedLowerBounds.push_back(std::make_pair(bounds[6*polyIndex], polyIndex));
+      }
     }
+  std::sort(sortedLowerBounds.begin(), sortedLowerBounds.end());
 
   std::vector<std::vector<unsigned int> > containedPolyData(numberOfPolyData);
   this->OutputLevels->SetNumberOfComponents(1);
@@ -122,21 +153,38 @@ void vtkTopologicalHierarchy::Update()
   this->OutputLevels->FillComponent(0, -1);
 
   // Step 1: Set level of polydata containing no other polydata to 0
-  this->InputPolyDataCollection->InitTraversal();
   for (unsigned int polyOutIndex=0; polyOutIndex<numberOfPolyData; ++polyOutIndex)
     {
-    vtkPolyData* polyOut = vtkPolyData::SafeDownCast(this->InputPolyDataCollection->GetItemAsObject(polyOutIndex));
+    const double* extentOut = &bounds[6 * polyOutIndex];
+
+    // An inner polydata must have its lower X bound between these values. The range is
+    // slightly enlarged to account for rounding, the exact test is done by Contains.
+    double margin = this->ContainConstraintFactor * (extentOut[1]-extentOut[0]);
+    double lowest = extentOut[0] + margin;
+    double highest = extentOut[1] - margin;
+    double tolerance = 1e-9 * (fabs(lowest) + fabs(highest) + 1.0);
+    std::vector<std::pair<double, unsigned int> >::iterator beginIt = std::lower_bound(
+      sortedLowerBounds.begin(), sortedLowerBounds.end(), std::make_pair(lowest - tolerance, 0u));
+    std::vector<std::pair<double, unsigned int> >::iterator endIt = std::lower_bound(
+      beginIt, sortedLowerBounds.end(), std::make_pair(highest + tolerance, 0u));
+
+    std::vector<unsigned int> candidates(invalidBounds);
+    for (std::vector<std::pair<double, unsigned int> >::iterator it = beginIt; it != endIt; ++it)
+      {
+      candidates.push_back(it->second);
+      }
+    // Keep the contained poly data in index order
+    std::sort(candidates.begin(), candidates.end());
 
-    for (unsigned int polyInIndex=0; polyInIndex<numberOfPolyData; ++polyInIndex)
+    for (std::vector<unsigned int>::iterator it = candidates.begin(); it != candidates.end(); ++it)
       {
+      unsigned int polyInIndex = (*it);
       if (polyOutIndex==polyInIndex)
         {
         continue;
         }
 
-      vtkPolyData* polyIn = vtkPolyData::SafeDownCast(this->InputPolyDataCollection->GetItemAsObject(polyInIndex));
-
-      if (this->Contains(polyOut, polyIn))
+      if (this->Contains(extentOut, &bounds[6 * polyInIndex]))
         {
         containedPolyData[polyOutIndex].push_back(polyInIndex);
         }
@@ -169,31 +217,11 @@ void vtkTopologicalHierarchy::Update()
       //   The level that is to be set cannot be lower than the current level value, because then we would
       //   already have assigned it in the previous iterations.
       bool allContainedPolydataHasLevelValueAssigned = true;
-      for (unsigned int polyInIndex = 0;
-           polyInIndex < numberOfPolyData;
-           ++polyInIndex)
+      for (std::vector<unsigned int>::iterator it = containedPolyData[polyOutIndex].begin();
+           it != containedPolyData[polyOutIndex].end();
+           ++it)
         {
-        if (polyOutIndex==polyInIndex)
-          {
-          continue;
-          }
-        bool isContained = false;
-        for (std::vector<unsigned int>::iterator it = containedPolyData[polyOutIndex].begin();
-             it != containedPolyData[polyOutIndex].end();
-             ++it)
-          {
-          if ((*it) == polyInIndex)
-            {
-            isContained = true;
-            break;
-            }
-          }
-        if (!isContained)
-          {
-          continue;
-          }
-
-        if (outputLevelsSnapshot->GetValue(polyInIndex) == -1)
+        if (outputLevelsSnapshot->GetValue(*it) == -1)
           {
           allContainedPolydataHasLevelValueAssigned = false;
           break;
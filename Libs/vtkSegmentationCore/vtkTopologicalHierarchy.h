@@ -52,7 +52,8 @@ public:
   virtual vtkIntArray* GetOutputLevels();
 
   /// Compute topological hierarchy levels for input poly data models using
-  /// their bounding boxes.
+  /// their bounding boxes. The bounding boxes are sorted along the X axis so
+  /// that each model is only compared with the models overlapping it.
   /// This function has to be explicitly called!
   /// Output can be get using GetOutputLevels()
   virtual void Update();
@@ -74,6 +75,10 @@ protected:
   /// /sa ContainConstraintFactor
   bool Contains(vtkPolyData* polyOut, vtkPolyData* polyIn);
 
+  /// Determines if the bounding box extentOut contains extentIn considering the
+  /// constraint factor
+  bool Contains(const double extentOut[6], const double extentIn[6]);
+
   /// Determines if there are empty entries in the output level array
   bool OutputContainsEmptyLevels();
 
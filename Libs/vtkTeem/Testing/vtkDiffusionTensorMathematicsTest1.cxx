@@ -24,6 +24,7 @@
 // VTK includes
 #include <vtkDataArray.h>
 #include <vtkImageData.h>
+#include <vtkMath.h>
 #include <vtkMultiThreader.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
@@ -119,5 +120,71 @@ int vtkDiffusionTensorMathematicsTest1(int vtkNotUsed(argc), char* vtkNotUsed(ar
       }
     std::cout << std::endl << std::endl;
     }
+
+  // Compute several maps in one pass and compare them with the maps
+  // computed one operation at a time.
+  const int operations[4] = {
+    vtkDiffusionTensorMathematics::VTK_TENS_FRACTIONAL_ANISOTROPY,
+    vtkDiffusionTensorMathematics::VTK_TENS_TRACE,
+    vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION,
+    vtkDiffusionTensorMathematics::VTK_TENS_MODE};
+  vtkNew<vtkDiffusionTensorMathematics> multipleFilter;
+  multipleFilter->SetInputData(tensorImage.GetPointer());
+  multipleFilter->SetScalarMask(maskImage.GetPointer());
+  multipleFilter->SetMaskLabelValue(0);
+  multipleFilter->SetMaskWithScalars(1);
+  multipleFilter->SetOperation(operations[0]);
+  for (int i = 1; i < 4; ++i)
+    {
+    multipleFilter->AddAdditionalOperation(operations[i]);
+    }
+  if (multipleFilter->GetNumberOfOutputPorts() != 4 ||
+      multipleFilter->GetNumberOfAdditionalOperations() != 3 ||
+      multipleFilter->GetAdditionalOperation(1) != operations[2])
+    {
+    std::cerr << "Line " << __LINE__ << " - Failed to add operations" << std::endl;
+    return EXIT_FAILURE;
+    }
+  multipleFilter->Update();
+  for (int i = 0; i < 4; ++i)
+    {
+    filter->SetOperation(operations[i]);
+    filter->Update();
+    vtkImageData* expected = filter->GetOutput();
+    vtkImageData* output = multipleFilter->GetOutput(i);
+    if (output->GetScalarType() != expected->GetScalarType() ||
+        output->GetNumberOfScalarComponents() != expected->GetNumberOfScalarComponents())
+      {
+      std::cerr << "Line " << __LINE__ << " - Wrong scalars for operation "
+                << operations[i] << std::endl;
+      return EXIT_FAILURE;
+      }
+    vtkDataArray* expectedScalars = expected->GetPointData()->GetScalars();
+    vtkDataArray* outputScalars = output->GetPointData()->GetScalars();
+    for (vtkIdType t = 0; t < expectedScalars->GetNumberOfTuples(); ++t)
+      {
+      for (int c = 0; c < expectedScalars->GetNumberOfComponents(); ++c)
+        {
+        double expectedValue = expectedScalars->GetComponent(t, c);
+        double outputValue = outputScalars->GetComponent(t, c);
+        // NaN values are expected for some of the masked voxels
+        if (expectedValue != outputValue &&
+            !(vtkMath::IsNan(expectedValue) && vtkMath::IsNan(outputValue)))
+          {
+          std::cerr << "Line " << __LINE__ << " - Operation " << operations[i]
+                    << " at " << t << ": " << outputValue
+                    << " instead of " << expectedValue << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+  multipleFilter->RemoveAllAdditionalOperations();
+  if (multipleFilter->GetNumberOfOutputPorts() != 1)
+    {
+    std::cerr << "Line " << __LINE__ << " - Failed to remove operations" << std::endl;
+    return EXIT_FAILURE;
+    }
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,115 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkImageLabelCombine.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+//----------------------------------------------------------------------------
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> createLabelmap(int extent[6], unsigned char label)
+{
+  vtkSmartPointer<vtkImageData> labelmap = vtkSmartPointer<vtkImageData>::New();
+  labelmap->SetExtent(extent);
+  labelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char* ptr = static_cast<unsigned char*>(labelmap->GetScalarPointer());
+  for (vtkIdType i = 0; i < labelmap->GetNumberOfPoints(); ++i)
+    {
+    ptr[i] = label;
+    }
+  return labelmap;
+}
+
+//----------------------------------------------------------------------------
+int labelAt(vtkImageData* image, int i, int j, int k)
+{
+  return static_cast<int>(image->GetScalarComponentAsDouble(i, j, k, 0));
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkImageLabelCombineTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  int fullExtent[6] = {0, 9, 0, 9, 0, 9};
+  int lowExtent[6] = {0, 5, 0, 5, 0, 5};
+  int highExtent[6] = {4, 12, 4, 12, 4, 12};
+  vtkSmartPointer<vtkImageData> background = createLabelmap(fullExtent, 0);
+  vtkSmartPointer<vtkImageData> low = createLabelmap(lowExtent, 1);
+  vtkSmartPointer<vtkImageData> high = createLabelmap(highExtent, 2);
+
+  // Two full size inputs: the first one has priority
+  vtkSmartPointer<vtkImageData> full = createLabelmap(fullExtent, 3);
+  vtkNew<vtkImageLabelCombine> combine;
+  combine->SetInput1(background);
+  combine->SetInput2(full);
+  combine->Update();
+  if (labelAt(combine->GetOutput(), 5, 5, 5) != 3)
+    {
+    std::cerr << "Line " << __LINE__ << ": empty voxels of the first input must be filled by the second input"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Intersection of the input extents
+  combine->SetInput1(low);
+  combine->SetInput2(high);
+  combine->Update();
+  int* outExtent = combine->GetOutput()->GetExtent();
+  if (outExtent[0] != 4 || outExtent[1] != 5 || labelAt(combine->GetOutput(), 4, 4, 4) != 1)
+    {
+    std::cerr << "Line " << __LINE__ << ": unexpected output of the intersection of the input extents"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Union of the extents of three inputs
+  combine->SetInput1(background);
+  combine->SetInput2(low);
+  combine->AddInputData(1, high);
+  combine->UseUnionOfInputExtentsOn();
+  combine->Update();
+  outExtent = combine->GetOutput()->GetExtent();
+  if (outExtent[0] != 0 || outExtent[1] != 12
+    || labelAt(combine->GetOutput(), 0, 0, 0) != 1
+    || labelAt(combine->GetOutput(), 5, 5, 5) != 1
+    || labelAt(combine->GetOutput(), 12, 12, 12) != 2
+    || labelAt(combine->GetOutput(), 0, 9, 0) != 0)
+    {
+    std::cerr << "Line " << __LINE__ << ": unexpected output of the union of the input extents"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Last inputs have priority
+  combine->SetOverwriteInput(1);
+  combine->Update();
+  if (labelAt(combine->GetOutput(), 5, 5, 5) != 2
+    || labelAt(combine->GetOutput(), 0, 0, 0) != 1)
+    {
+    std::cerr << "Line " << __LINE__ << ": last inputs must have priority when OverwriteInput is set"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// vtkTeem includes
+#include <vtkNRRDReader.h>
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+const int Dimensions[3] = { 5, 4, 3 };
+
+//----------------------------------------------------------------------------
+bool WriteDetachedNRRD(const std::string& directory)
+{
+  std::ofstream header((directory + "/vtkNRRDReaderTest1.nhdr").c_str());
+  header << "NRRD0004\n"
+         << "type: short\n"
+         << "dimension: 3\n"
+         << "space: left-posterior-superior\n"
+         << "sizes: " << Dimensions[0] << " " << Dimensions[1] << " " << Dimensions[2] << "\n"
+         << "space directions: (1,0,0) (0,1,0) (0,0,1)\n"
+         << "kinds: domain domain domain\n"
+#ifdef VTK_WORDS_BIGENDIAN
+         << "endian: big\n"
+#else
+         << "endian: little\n"
+#endif
+         << "encoding: raw\n"
+         << "space origin: (0,0,0)\n"
+         << "data file: vtkNRRDReaderTest1.raw\n";
+  std::ofstream data((directory + "/vtkNRRDReaderTest1.raw").c_str(), std::ios::binary);
+  for (short i = 0; i < Dimensions[0] * Dimensions[1] * Dimensions[2]; i++)
+    {
+    short value = i * 3;
+    data.write(reinterpret_cast<char*>(&value), sizeof(value));
+    }
+  return header.good() && data.good();
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> ReadNRRD(const std::string& fileName, bool useMemoryMapping)
+{
+  vtkNew<vtkNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetUseMemoryMapping(useMemoryMapping);
+  reader->Update();
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->ShallowCopy(reader->GetOutput());
+  return image;
+}
+
+//----------------------------------------------------------------------------
+bool CheckValues(vtkImageData* image)
+{
+  vtkDataArray* scalars = image ? image->GetPointData()->GetScalars() : NULL;
+  if (!scalars || scalars->GetNumberOfTuples() != Dimensions[0] * Dimensions[1] * Dimensions[2])
+    {
+    std::cerr << "Line " << __LINE__ << ": invalid scalars" << std::endl;
+    return false;
+    }
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    if (scalars->GetTuple1(i) != i * 3)
+      {
+      std::cerr << "Line " << __LINE__ << ": value mismatch at " << i << ": "
+                << scalars->GetTuple1(i) << " (expected " << i * 3 << ")" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkNRRDReaderTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: vtkNRRDReaderTest1 <temporary directory>" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string directory = argv[1];
+  if (!WriteDetachedNRRD(directory))
+    {
+    std::cerr << "Failed to write test file in " << directory << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string fileName = directory + "/vtkNRRDReaderTest1.nhdr";
+
+  vtkSmartPointer<vtkImageData> readImage = ReadNRRD(fileName, false);
+  if (!CheckValues(readImage))
+    {
+    return EXIT_FAILURE;
+    }
+
+  vtkSmartPointer<vtkImageData> mappedImage = ReadNRRD(fileName, true);
+  if (!CheckValues(mappedImage))
+    {
+    return EXIT_FAILURE;
+    }
+  if (mappedImage->GetPointData()->GetScalars()->GetInformation()->Get(vtkNRRDReader::MAPPED_DATA()) == NULL)
+    {
+    std::cerr << "Line " << __LINE__ << ": data file was not memory mapped" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Modifying the mapped image must not change the file
+  mappedImage->GetPointData()->GetScalars()->SetTuple1(0, 1234);
+  if (!CheckValues(ReadNRRD(fileName, true)))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
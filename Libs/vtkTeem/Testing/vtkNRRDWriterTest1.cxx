@@ -0,0 +1,187 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// vtkTeem includes
+#include <vtkNRRDReader.h>
+#include <vtkNRRDWriter.h>
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+const int Dimensions[3] = { 40, 30, 20 };
+
+//----------------------------------------------------------------------------
+short ExpectedValue(vtkIdType i)
+{
+  return static_cast<short>((i * 7) % 1000 - 500);
+}
+
+//----------------------------------------------------------------------------
+bool WriteNRRD(vtkImageData* image, const std::string& fileName, vtkIdType blockSize, int numberOfThreads,
+               bool useCompression = true)
+{
+  vtkNew<vtkNRRDWriter> writer;
+  writer->SetInputData(image);
+  writer->SetFileName(fileName.c_str());
+  writer->SetUseCompression(useCompression);
+  writer->SetCompressionLevel(1);
+  writer->SetCompressionBlockSize(blockSize);
+  writer->SetNumberOfThreads(numberOfThreads);
+  writer->Write();
+  return !writer->GetWriteError();
+}
+
+//----------------------------------------------------------------------------
+bool CheckNRRD(const std::string& fileName, bool expectBlocks)
+{
+  vtkNew<vtkNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetNumberOfThreads(3);
+  reader->Update();
+  bool hasBlocks = (reader->GetHeaderValue(vtkNRRDWriter::GetCompressedBlockSizesKey()) != NULL);
+  if (hasBlocks != expectBlocks)
+    {
+    std::cerr << "Line " << __LINE__ << ": " << fileName << " block index "
+              << (hasBlocks ? "found" : "not found") << std::endl;
+    return false;
+    }
+  vtkDataArray* scalars = reader->GetOutput()->GetPointData()->GetScalars();
+  if (!scalars || scalars->GetNumberOfTuples() != Dimensions[0] * Dimensions[1] * Dimensions[2])
+    {
+    std::cerr << "Line " << __LINE__ << ": invalid scalars in " << fileName << std::endl;
+    return false;
+    }
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    if (scalars->GetTuple1(i) != ExpectedValue(i))
+      {
+      std::cerr << "Line " << __LINE__ << ": value mismatch in " << fileName << " at " << i << ": "
+                << scalars->GetTuple1(i) << " (expected " << ExpectedValue(i) << ")" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool CheckNRRDRegion(const std::string& fileName, int region[6])
+{
+  vtkNew<vtkNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetReadExtent(region);
+  reader->Update();
+  int* extent = reader->GetOutput()->GetExtent();
+  for (int i = 0; i < 6; i++)
+    {
+    if (extent[i] != region[i])
+      {
+      std::cerr << "Line " << __LINE__ << ": " << fileName << " region extent " << extent[0] << " " << extent[1]
+                << " " << extent[2] << " " << extent[3] << " " << extent[4] << " " << extent[5] << " (expected "
+                << region[0] << " " << region[1] << " " << region[2] << " " << region[3] << " "
+                << region[4] << " " << region[5] << ")" << std::endl;
+      return false;
+      }
+    }
+  vtkImageData* output = reader->GetOutput();
+  for (int k = region[4]; k <= region[5]; k++)
+    {
+    for (int j = region[2]; j <= region[3]; j++)
+      {
+      for (int i = region[0]; i <= region[1]; i++)
+        {
+        vtkIdType index = (static_cast<vtkIdType>(k) * Dimensions[1] + j) * Dimensions[0] + i;
+        if (output->GetScalarComponentAsDouble(i, j, k, 0) != ExpectedValue(index))
+          {
+          std::cerr << "Line " << __LINE__ << ": region value mismatch in " << fileName << " at "
+                    << i << " " << j << " " << k << ": " << output->GetScalarComponentAsDouble(i, j, k, 0)
+                    << " (expected " << ExpectedValue(index) << ")" << std::endl;
+          return false;
+          }
+        }
+      }
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkNRRDWriterTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: vtkNRRDWriterTest1 <temporary directory>" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string directory = argv[1];
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(Dimensions[0], Dimensions[1], Dimensions[2]);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  for (vtkIdType i = 0; i < Dimensions[0] * Dimensions[1] * Dimensions[2]; i++)
+    {
+    voxels[i] = ExpectedValue(i);
+    }
+
+  // Single gzip stream written by teem
+  std::string singleBlockFileName = directory + "/vtkNRRDWriterTest1_single.nrrd";
+  if (!WriteNRRD(image.GetPointer(), singleBlockFileName, 0, 1)
+    || !CheckNRRD(singleBlockFileName, false))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Blocks compressed in parallel, the last block is partial
+  std::string blocksFileName = directory + "/vtkNRRDWriterTest1_blocks.nrrd";
+  if (!WriteNRRD(image.GetPointer(), blocksFileName, 7000, 4)
+    || !CheckNRRD(blocksFileName, true))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Detached data files are not compressed in blocks
+  std::string detachedFileName = directory + "/vtkNRRDWriterTest1_detached.nhdr";
+  if (!WriteNRRD(image.GetPointer(), detachedFileName, 7000, 4)
+    || !CheckNRRD(detachedFileName, false))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Regions of interest, read directly from raw data, from the blocks
+  // that contain the region, and cropped after reading the whole file
+  std::string rawFileName = directory + "/vtkNRRDWriterTest1_raw.nrrd";
+  if (!WriteNRRD(image.GetPointer(), rawFileName, 0, 1, false))
+    {
+    return EXIT_FAILURE;
+    }
+  int slab[6] = { 0, Dimensions[0] - 1, 0, Dimensions[1] - 1, 12, 15 };
+  int box[6] = { 3, 17, 5, 9, 2, 18 };
+  if (!CheckNRRDRegion(rawFileName, slab) || !CheckNRRDRegion(rawFileName, box)
+    || !CheckNRRDRegion(blocksFileName, slab) || !CheckNRRDRegion(blocksFileName, box)
+    || !CheckNRRDRegion(singleBlockFileName, box) || !CheckNRRDRegion(detachedFileName, box))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
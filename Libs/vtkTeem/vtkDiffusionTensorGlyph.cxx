@@ -15,6 +15,7 @@
 
 #include "vtkCellArray.h"
 #include "vtkFloatArray.h"
+#include "vtkIdList.h"
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -28,6 +29,7 @@
 #include "vtkDiffusionTensorMathematics.h"
 
 #include <ctime>
+#include <vector>
 
 vtkCxxSetObjectMacro(vtkDiffusionTensorGlyph,Mask,vtkImageData);
 vtkCxxSetObjectMacro(vtkDiffusionTensorGlyph,VolumePositionMatrix,vtkMatrix4x4);
@@ -170,8 +172,6 @@ int vtkDiffusionTensorGlyph::RequestData(
   vtkFloatArray *newNormals=NULL;
   double x[3], x2[3], s;
   vtkTransform *trans;
-  vtkCell *cell;
-  vtkIdList *cellPts;
   int npts;
   vtkIdType *pts;
   vtkIdType cellId;
@@ -365,6 +365,35 @@ int vtkDiffusionTensorGlyph::RequestData(
   //
   trans->PreMultiply();
 
+  // The glyph topology is the same for every input point: read the source
+  // cells once instead of instantiating each source cell for every glyph.
+  std::vector<int> sourceCellTypes(numSourceCells);
+  std::vector<vtkIdType> sourceCellOffsets(numSourceCells + 1, 0);
+  std::vector<vtkIdType> sourceCellPointIds;
+  vtkNew<vtkIdList> sourceCellPts;
+  for (cellId=0; cellId < numSourceCells; cellId++)
+    {
+    sourceCellTypes[cellId] = source->GetCellType(cellId);
+    source->GetCellPoints(cellId, sourceCellPts.GetPointer());
+    for (i=0; i < sourceCellPts->GetNumberOfIds(); i++)
+      {
+      sourceCellPointIds.push_back(sourceCellPts->GetId(i));
+      }
+    sourceCellOffsets[cellId + 1] = static_cast<vtkIdType>(sourceCellPointIds.size());
+    }
+
+  // These do not depend on the input point
+  int flipNormals = 0;
+  if ( this->TensorRotationMatrix && this->TensorRotationMatrix->Determinant() < 0 )
+    {
+    flipNormals = 1;
+    }
+  vtkNew<vtkTransform> tensorRotation;
+  if (this->TensorRotationMatrix)
+    {
+    tensorRotation->SetMatrix(this->TensorRotationMatrix);
+    }
+
   for (inPtId=0; inPtId < numPts; inPtId += skipCols)
     {
     if (col >= rowLength)
@@ -404,9 +433,8 @@ int vtkDiffusionTensorGlyph::RequestData(
       // copy topology of output glyph for this point
       for (cellId=0; cellId < numSourceCells; cellId++)
         {
-        cell = this->GetSource()->GetCell(cellId);
-        cellPts = cell->GetPointIds();
-        npts = cellPts->GetNumberOfIds();
+        const vtkIdType* cellPts = &sourceCellPointIds[0] + sourceCellOffsets[cellId];
+        npts = static_cast<int>(sourceCellOffsets[cellId + 1] - sourceCellOffsets[cellId]);
         for (dir=0; dir < numDirs; dir++)
           {
           // This variable may be removed, but that
@@ -418,9 +446,9 @@ int vtkDiffusionTensorGlyph::RequestData(
 
           for (i=0; i < npts; i++)
             {
-            pts[i] = cellPts->GetId(i) + subIncr;
+            pts[i] = cellPts[i] + subIncr;
             }
-          output->InsertNextCell(cell->GetCellType(),npts,pts);
+          output->InsertNextCell(sourceCellTypes[cellId],npts,pts);
           }
         }
 
@@ -510,9 +538,7 @@ int vtkDiffusionTensorGlyph::RequestData(
             v_maj[2]=v[2][0];
             if (this->TensorRotationMatrix)
               {
-              vtkNew<vtkTransform> rotate;
-              rotate->SetMatrix(this->TensorRotationMatrix);
-              rotate->TransformPoint(v_maj,v_maj);
+              tensorRotation->TransformPoint(v_maj,v_maj);
               }
             // TO DO: here output as RGB. Need to allocate 3-component scalars first.
             s = 0;
@@ -592,10 +618,13 @@ int vtkDiffusionTensorGlyph::RequestData(
       // a separate glyph for each (or two loops per eigenvector
       // allowing two symmetric glyphs for each)
 
-      int flipNormals = 0;
-      if ( this->TensorRotationMatrix && this->TensorRotationMatrix->Determinant() < 0 )
+      // translate Source to Input point
+      input->GetPoint(inPtId, x);
+      // If we have a user-specified matrix modifying the output point locations
+      if ( userVolumeTransform != NULL )
         {
-        flipNormals = 1;
+        userVolumeTransform->TransformPoint(x,x2);
+        x[0] = x2[0]; x[1] = x2[1]; x[2] = x2[2];
         }
 
       for (dir=0; dir < numDirs; dir++)
@@ -625,19 +654,7 @@ int vtkDiffusionTensorGlyph::RequestData(
             }
           }
 
-        // translate Source to Input point
-        input->GetPoint(inPtId, x);
-
-        // If we have a user-specified matrix modifying the output point locations
-        if ( userVolumeTransform != NULL )
-          {
-          userVolumeTransform->TransformPoint(x,x2);
-          trans->Translate(x2[0], x2[1], x2[2]);
-          }
-        else
-          {
-          trans->Translate(x[0], x[1], x[2]);
-          }
+        trans->Translate(x[0], x[1], x[2]);
 
         // If we have a user-specified matrix rotating each tensor
         if (this->TensorRotationMatrix)
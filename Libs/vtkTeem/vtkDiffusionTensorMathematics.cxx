@@ -25,6 +25,7 @@
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkDiffusionTensorMathematics.h"
 #include "vtkMath.h"
+#include <vtkNew.h>
 #include "vtkObjectFactory.h"
 #include "vtkTransform.h"
 #include "vtkPointData.h"
@@ -38,6 +39,7 @@ extern "C" {
 
 #include <ctime>
 #include <limits>
+#include <vector>
 
 #define VTK_EPS 1e-16
 #define DOUBLE_NAN (std::numeric_limits<double>::quiet_NaN())
@@ -106,21 +108,27 @@ int vtkDiffusionTensorMathematics::RequestInformation (
     ext[3] << " " << ext[4] << " " << ext[5]);
 
 
-  // We always want to output float, unless it is color
-  if (this->Operation == VTK_TENS_COLOR_ORIENTATION)
+  // Output port i > 0 holds the result of the additional operation i - 1
+  for (int port = 0; port < this->GetNumberOfOutputPorts(); ++port)
     {
-    // output color (RGBA)
-    vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_UNSIGNED_CHAR, 4);
-    }
-  else if (this->Operation == VTK_TENS_COLOR_MODE)
-    {
-    // output color (RGBA)
-    vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_UNSIGNED_CHAR, 4);
-    }
-  else {
-    vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_FLOAT, 1);
+    outInfo = outputVector->GetInformationObject(port);
+    int operation = (port == 0 ? this->Operation : this->AdditionalOperations[port - 1]);
+    // We always want to output float, unless it is color
+    if (operation == VTK_TENS_COLOR_ORIENTATION)
+      {
+      // output color (RGBA)
+      vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_UNSIGNED_CHAR, 4);
+      }
+    else if (operation == VTK_TENS_COLOR_MODE)
+      {
+      // output color (RGBA)
+      vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_UNSIGNED_CHAR, 4);
+      }
+    else {
+      vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_FLOAT, 1);
+      }
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), ext, 6);
     }
-  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), ext, 6);
   return 1;
 }
 
@@ -143,6 +151,16 @@ int vtkDiffusionTensorMathematics
 ::RequestData(vtkInformation* request, vtkInformationVector** inputVector,
               vtkInformationVector* outputVector)
 {
+  // The additional outputs are computed in the same pass as the first
+  // output, over the extent requested on the first output.
+  int updateExtent[6];
+  outputVector->GetInformationObject(0)->Get(
+    vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), updateExtent);
+  for (int i = 1; i < this->GetNumberOfOutputPorts(); ++i)
+    {
+    outputVector->GetInformationObject(i)->Set(
+      vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), updateExtent, 6);
+    }
   int res = this->Superclass::RequestData(request, inputVector, outputVector);
   for (int i = 0; i < this->GetNumberOfOutputPorts(); ++i)
     {
@@ -193,6 +211,36 @@ static void GetContinuousIncrements(vtkImageData* img, int extent[6], vtkIdType
   incZ = inc[2] - (e3 - e2 + 1)*inc[1];
 }
 
+//----------------------------------------------------------------------------
+// Compute at one voxel an operation that does not require the eigensystem.
+template <class T>
+static void vtkDiffusionTensorMathematicsTensorPixel(int op, double tensor[3][3],
+                                                     double scaleFactor, T *outPtr)
+{
+  switch (op)
+    {
+    case vtkDiffusionTensorMathematics::VTK_TENS_D11:
+      *outPtr = (T)(scaleFactor*tensor[0][0]);
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_D22:
+      *outPtr = (T)(scaleFactor*tensor[1][1]);
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_D33:
+      *outPtr = (T)(scaleFactor*tensor[2][2]);
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_TRACE:
+      *outPtr = static_cast<T> (scaleFactor*vtkDiffusionTensorMathematics::Trace(tensor));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_DETERMINANT:
+      *outPtr = static_cast<T> (scaleFactor*vtkDiffusionTensorMathematics::Determinant(tensor));
+      break;
+    }
+}
+
 //----------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
 // Handles the one input operations.
@@ -307,34 +355,7 @@ static void vtkDiffusionTensorMathematicsExecute1(vtkDiffusionTensorMathematics
           tensor[2][1] = static_cast<double>(inPtr[7]);
           tensor[2][2] = static_cast<double>(inPtr[8]);
 
-          // pixel operation
-          switch (op)
-            {
-          case vtkDiffusionTensorMathematics::VTK_TENS_D11:
-            *outPtr = (T)(scaleFactor*tensor[0][0]);
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_D22:
-            *outPtr = (T)(scaleFactor*tensor[1][1]);
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_D33:
-            *outPtr = (T)(scaleFactor*tensor[2][2]);
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_TRACE:
-            /////////////////////*outPtr = (T)(scaleFactor*(tensor[0][0]
-            //               +tensor[1][1]
-            //               +tensor[2][2]));
-            *outPtr = static_cast<T> (scaleFactor*vtkDiffusionTensorMathematics::Trace(tensor));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_DETERMINANT:
-            //*outPtr =
-            //  (T)(scaleFactor*(vtkMath::Determinant3x3(tensor)));
-            *outPtr = static_cast<T> (scaleFactor*vtkDiffusionTensorMathematics::Determinant(tensor));
-            break;
-            }
+          vtkDiffusionTensorMathematicsTensorPixel(op, tensor, scaleFactor, outPtr);
         }
 
         outPtr++;
@@ -364,6 +385,284 @@ inline Type tensor_math_clamp(const Type a,
                   const Type b,
                   const Type c) { return (a) > (b) ? ((a) < (c) ? (a) : (c)) : (b) ; }
 
+//----------------------------------------------------------------------------
+// Compute the eigenvalues w (sorted in decreasing order) and eigenvectors
+// (columns of v) of the tensor at one voxel.
+static void vtkDiffusionTensorMathematicsEigensystem(double tensor[3][3],
+                                                     int extractEigenvalues,
+                                                     int fixNegativeEigenvalues,
+                                                     double w[3], double **v)
+{
+  double *m[3];
+  double m0[3], m1[3], m2[3];
+  m[0] = m0; m[1] = m1; m[2] = m2;
+  int i, j;
+
+  // get eigenvalues and eigenvectors appropriately
+  if (extractEigenvalues)
+    {
+    for (j=0; j<3; j++)
+      {
+      for (i=0; i<3; i++)
+        {
+        // transpose
+        m[i][j] = tensor[j][i];
+        }
+      }
+    // compute eigensystem
+    //vtkMath::Jacobi(m, w, v);
+    vtkDiffusionTensorMathematics::TeemEigenSolver(m,w,v);
+    }
+  else
+    {
+    // tensor columns are evectors scaled by evals
+    for (i=0; i<3; i++)
+      {
+      v[0][i] = tensor[i][0];
+      v[1][i] = tensor[i][1];
+      v[2][i] = tensor[i][2];
+      }
+    w[0] = vtkMath::Normalize(v[0]);
+    w[1] = vtkMath::Normalize(v[1]);
+    w[2] = vtkMath::Normalize(v[2]);
+    }
+
+  //Correct for negative eigenvalues. Three possible options:
+  //  1. Round to zero
+  //  2. Take absolute value
+  //  3. Increase eigenvalues by negative part
+  // The two first options have been problematic. Try 3
+  if (fixNegativeEigenvalues==1){
+    const double min_eval = MIN3(w[0], w[1], w[2]);
+    if (min_eval < 0)
+      {
+        const double add_to_eval = -min_eval + VTK_EPS;
+        w[0] += add_to_eval;
+        w[1] += add_to_eval;
+        w[2] += add_to_eval;
+      }
+//            if (vtkDiffusionTensorMathematics::FixNegativeEigenvaluesMethod(w)) {
+//              vtkGenericWarningMacro( "Warning: Eigenvalues are not properly sorted" );
+//            }
+    if ((w[0] < 0) || (w[1] < 0) || (w[2] < 0))
+      vtkGenericWarningMacro( "Warning: Negative Eigenvalues after positivity fix" );
+  } else {
+    if (w[0] < 0)
+      w[0] = DOUBLE_NAN;
+    if (w[1] < 0)
+      w[1] = DOUBLE_NAN;
+    if (w[2] < 0)
+      w[2] = DOUBLE_NAN;
+  }
+}
+
+//----------------------------------------------------------------------------
+// Compute at one voxel an operation that requires the eigensystem.
+// Color operations write RGBA, outPtr is left on the last written component.
+// The tensor orientation is transformed by trans if not NULL.
+template <class T>
+static void vtkDiffusionTensorMathematicsEigenPixel(int op, double w[3], double **v,
+                                                    vtkTransform *trans,
+                                                    double scaleFactor,
+                                                    double rgb_scale, T *&outPtr)
+{
+  double v_maj[3];
+  double r, g, b;
+  double cl;
+  double rgb_temp = 0.;
+
+  // pixel operation
+  switch (op)
+    {
+    case vtkDiffusionTensorMathematics::VTK_TENS_RELATIVE_ANISOTROPY:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::RelativeAnisotropy(w));
+      break;
+    case vtkDiffusionTensorMathematics::VTK_TENS_FRACTIONAL_ANISOTROPY:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::FractionalAnisotropy(w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_LINEAR_MEASURE:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::LinearMeasure(w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_PLANAR_MEASURE:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::PlanarMeasure(w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_SPHERICAL_MEASURE:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::SphericalMeasure(w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE:
+      *outPtr = (T)w[0];
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_MID_EIGENVALUE:
+      *outPtr = (T)w[1];
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_MIN_EIGENVALUE:
+      *outPtr = (T)w[2];
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_PARALLEL_DIFFUSIVITY:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::ParallelDiffusivity(w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_PERPENDICULAR_DIFFUSIVITY:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::PerpendicularDiffusivity(w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJX:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvalueProjectionX(v,w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJY:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvalueProjectionY(v,w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJZ:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvalueProjectionZ(v,w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJX:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::RAIMaxEigenvecX(v,w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJY:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::RAIMaxEigenvecY(v,w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJZ:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::RAIMaxEigenvecZ(v,w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJX:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvecX(v,w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJY:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvecY(v,w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJZ:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvecZ(v,w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_MODE:
+      *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::Mode(w));
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_MODE:
+
+      vtkDiffusionTensorMathematics::ColorByMode(w,r,g,b);
+      // scale maps 0..1 values into the range a char takes on
+      rgb_temp = (rgb_scale*r);
+      *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
+      outPtr++;
+      rgb_temp = (rgb_scale*g);
+      *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
+      outPtr++;
+      rgb_temp = (rgb_scale*b);
+      *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
+      outPtr++;
+      *outPtr = (T)VTK_UNSIGNED_CHAR_MAX; //alpha
+
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION:
+      // If the user has set the rotation matrix
+      // then transform the eigensystem first
+      // This is used to rotate the vector into RAS space
+      // for consistent anatomical coloring.
+      v_maj[0]=v[0][0];
+      v_maj[1]=v[1][0];
+      v_maj[2]=v[2][0];
+      if (trans)
+        {
+        trans->TransformPoint(v_maj,v_maj);
+        }
+      // Color R, G, B depending on max eigenvector
+      // scale maps 0..1 values into the range a char takes on
+      cl = vtkDiffusionTensorMathematics::LinearMeasure(w);
+      rgb_temp = (rgb_scale*fabs(v_maj[0])*cl);
+      *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
+      outPtr++;
+      rgb_temp = (rgb_scale*fabs(v_maj[1])*cl);
+      *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
+      outPtr++;
+      rgb_temp = (rgb_scale*fabs(v_maj[2])*cl);
+      *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
+      outPtr++;
+      *outPtr = (T)VTK_UNSIGNED_CHAR_MAX; //alpha
+
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION_MIDDLE_EIGENVECTOR:
+      // If the user has set the rotation matrix
+      // then transform the eigensystem first
+      // This is used to rotate the vector into RAS space
+      // for consistent anatomical coloring.
+      v_maj[0]=v[0][1];
+      v_maj[1]=v[1][1];
+      v_maj[2]=v[2][1];
+      if (trans)
+        {
+        trans->TransformPoint(v_maj,v_maj);
+        }
+      // Color R, G, B depending on max eigenvector
+      // scale maps 0..1 values into the range a char takes on
+      cl = vtkDiffusionTensorMathematics::LinearMeasure(w);
+      rgb_temp = (rgb_scale*fabs(v_maj[0])*cl);
+      *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
+      outPtr++;
+      rgb_temp = (rgb_scale*fabs(v_maj[1])*cl);
+      *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
+      outPtr++;
+      rgb_temp = (rgb_scale*fabs(v_maj[2])*cl);
+      *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
+      outPtr++;
+      *outPtr = (T)VTK_UNSIGNED_CHAR_MAX; //alpha
+
+      break;
+
+    case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION_MIN_EIGENVECTOR:
+      // If the user has set the rotation matrix
+      // then transform the eigensystem first
+      // This is used to rotate the vector into RAS space
+      // for consistent anatomical coloring.
+      v_maj[0]=v[0][2];
+      v_maj[1]=v[1][2];
+      v_maj[2]=v[2][2];
+      if (trans)
+        {
+        trans->TransformPoint(v_maj,v_maj);
+        }
+      // Color R, G, B depending on max eigenvector
+      // scale maps 0..1 values into the range a char takes on
+      cl = vtkDiffusionTensorMathematics::LinearMeasure(w);
+      rgb_temp = (rgb_scale*fabs(v_maj[0])*cl);
+      *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
+      outPtr++;
+      rgb_temp = (rgb_scale*fabs(v_maj[1])*cl);
+      *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
+      outPtr++;
+      rgb_temp = (rgb_scale*fabs(v_maj[2])*cl);
+      *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
+      outPtr++;
+      *outPtr = (T)VTK_UNSIGNED_CHAR_MAX; //alpha
+
+      break;
+    }
+
+  // scale double if the user requested this
+  if (scaleFactor != 1 && op !=  vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION
+    && op !=  vtkDiffusionTensorMathematics::VTK_TENS_COLOR_MODE)
+    {
+    *outPtr = (T) ((*outPtr) * scaleFactor);
+    }
+}
+
 //----------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
 // Handles the one input operations.
@@ -397,23 +696,17 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
   tStart = clock();
 #endif
   // working matrices
-  double *m[3], w[3], *v[3];
-  double m0[3], m1[3], m2[3];
+  double w[3], *v[3];
   double v0[3], v1[3], v2[3];
-  double v_maj[3];
-  m[0] = m0; m[1] = m1; m[2] = m2;
   v[0] = v0; v[1] = v1; v[2] = v2;
-  int i, j;
-  double r, g, b;
   int extractEigenvalues;
-  double cl;
+  int fixNegativeEigenvalues = self->GetFixNegativeEigenvalues();
   // scaling
   double scaleFactor = self->GetScaleFactor();
 
   // map 0..1 values into the range a char takes on
   // but use scaleFactor so user can bump up the brightness
   const double rgb_scale = (double)VTK_UNSIGNED_CHAR_MAX * scaleFactor / 1000.;
-  double rgb_temp = 0.;
 
   // find the input region to loop over
   pd = in1Data->GetPointData();
@@ -523,279 +816,262 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
           tensor[2][1] = static_cast<double>(inPtr[7]);
           tensor[2][2] = static_cast<double>(inPtr[8]);
 
-          // get eigenvalues and eigenvectors appropriately
-          if (extractEigenvalues)
-            {
-            for (j=0; j<3; j++)
-              {
-              for (i=0; i<3; i++)
-                {
-                // transpose
-                m[i][j] = tensor[j][i];
-                }
-              }
-            // compute eigensystem
-            //vtkMath::Jacobi(m, w, v);
-            vtkDiffusionTensorMathematics::TeemEigenSolver(m,w,v);
-            }
-          else
-            {
-            // tensor columns are evectors scaled by evals
-            for (i=0; i<3; i++)
-              {
-              v0[i] = tensor[i][0];
-              v1[i] = tensor[i][1];
-              v2[i] = tensor[i][2];
-              }
-            w[0] = vtkMath::Normalize(v0);
-            w[1] = vtkMath::Normalize(v1);
-            w[2] = vtkMath::Normalize(v2);
-            }
+          vtkDiffusionTensorMathematicsEigensystem(tensor, extractEigenvalues,
+            fixNegativeEigenvalues, w, v);
 
-          //Correct for negative eigenvalues. Three possible options:
-          //  1. Round to zero
-          //  2. Take absolute value
-          //  3. Increase eigenvalues by negative part
-          // The two first options have been problematic. Try 3
-          if (self->GetFixNegativeEigenvalues()==1){
-            const double min_eval = MIN3(w[0], w[1], w[2]);
-            if (min_eval < 0)
-              {
-                const double add_to_eval = -min_eval + VTK_EPS;
-                w[0] += add_to_eval;
-                w[1] += add_to_eval;
-                w[2] += add_to_eval;
-              }
-//            if (vtkDiffusionTensorMathematics::FixNegativeEigenvaluesMethod(w)) {
-//              vtkGenericWarningMacro( "Warning: Eigenvalues are not properly sorted" );
-//            }
-            if ((w[0] < 0) || (w[1] < 0) || (w[2] < 0))
-              vtkGenericWarningMacro( "Warning: Negative Eigenvalues after positivity fix" );
-          } else {
-            if (w[0] < 0)
-              w[0] = DOUBLE_NAN;
-            if (w[1] < 0)
-              w[1] = DOUBLE_NAN;
-            if (w[2] < 0)
-              w[2] = DOUBLE_NAN;
+          vtkDiffusionTensorMathematicsEigenPixel(op, w, v, useTransform ? trans : 0,
+            scaleFactor, rgb_scale, outPtr);
           }
 
-          // pixel operation
-          switch (op)
-            {
-          case vtkDiffusionTensorMathematics::VTK_TENS_RELATIVE_ANISOTROPY:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::RelativeAnisotropy(w));
-            break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_FRACTIONAL_ANISOTROPY:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::FractionalAnisotropy(w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_LINEAR_MEASURE:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::LinearMeasure(w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_PLANAR_MEASURE:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::PlanarMeasure(w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_SPHERICAL_MEASURE:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::SphericalMeasure(w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE:
-            *outPtr = (T)w[0];
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_MID_EIGENVALUE:
-            *outPtr = (T)w[1];
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_MIN_EIGENVALUE:
-            *outPtr = (T)w[2];
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_PARALLEL_DIFFUSIVITY:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::ParallelDiffusivity(w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_PERPENDICULAR_DIFFUSIVITY:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::PerpendicularDiffusivity(w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJX:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvalueProjectionX(v,w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJY:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvalueProjectionY(v,w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJZ:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvalueProjectionZ(v,w));
-            break;
-
-      case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJX:
-        *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::RAIMaxEigenvecX(v,w));
-        break;
 
-      case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJY:
-        *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::RAIMaxEigenvecY(v,w));
-        break;
+        outPtr++;
+        inPtr+=9;
+        inMaskPtr++;
+        }
+      outPtr += outIncY;
+      inPtr += inIncY;
+      inMaskPtr += maskIncY;
+      }
+    outPtr += outIncZ;
+    inPtr += inIncZ;
+    inMaskPtr += maskIncZ;
+    }
+  // Cleanup
+  trans->Delete();
 
-      case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJZ:
-        *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::RAIMaxEigenvecZ(v,w));
-        break;
+#ifndef NDEBUG
+  tEnd = clock();
+  tDiff = tEnd - tStart;
+  vtkDebugWithObjectMacro(self, << "tDiff:" << tDiff);
+#endif
+}
 
-      case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJX:
-        *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvecX(v,w));
-        break;
+//----------------------------------------------------------------------------
+// Output of vtkDiffusionTensorMathematicsExecuteMultiple
+struct vtkDiffusionTensorMathematicsOutput
+{
+  int Operation;
+  int ScalarType;
+  int NumberOfComponents;
+  void* Pointer;
+  vtkIdType IncY;
+  vtkIdType IncZ;
+};
 
-      case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJY:
-        *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvecY(v,w));
-        break;
+//----------------------------------------------------------------------------
+template <class T>
+static void vtkDiffusionTensorMathematicsWriteTypedPixel(
+  vtkDiffusionTensorMathematicsOutput& output, bool masked,
+  double tensor[3][3], double w[3], double **v, vtkTransform *trans,
+  double scaleFactor, double rgb_scale)
+{
+  T* outPtr = static_cast<T*>(output.Pointer);
+  if (masked)
+    {
+    for (int i = 0; i < output.NumberOfComponents; ++i)
+      {
+      outPtr[i] = 0;
+      }
+    if (output.NumberOfComponents == 4)
+      {
+      outPtr[3] = (T)VTK_UNSIGNED_CHAR_MAX; // alpha
+      }
+    outPtr += output.NumberOfComponents;
+    }
+  else if (vtkDiffusionTensorMathematics::OperationRequiresEigensystem(output.Operation))
+    {
+    vtkDiffusionTensorMathematicsEigenPixel(output.Operation, w, v, trans,
+      scaleFactor, rgb_scale, outPtr);
+    outPtr++;
+    }
+  else
+    {
+    vtkDiffusionTensorMathematicsTensorPixel(output.Operation, tensor, scaleFactor, outPtr);
+    outPtr++;
+    }
+  output.Pointer = outPtr;
+}
 
-      case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJZ:
-        *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvecZ(v,w));
-        break;
+//----------------------------------------------------------------------------
+static void vtkDiffusionTensorMathematicsWritePixel(
+  vtkDiffusionTensorMathematicsOutput& output, bool masked,
+  double tensor[3][3], double w[3], double **v, vtkTransform *trans,
+  double scaleFactor, double rgb_scale)
+{
+  // See RequestInformation for the possible output scalar types
+  if (output.ScalarType == VTK_UNSIGNED_CHAR)
+    {
+    vtkDiffusionTensorMathematicsWriteTypedPixel<unsigned char>(
+      output, masked, tensor, w, v, trans, scaleFactor, rgb_scale);
+    }
+  else
+    {
+    vtkDiffusionTensorMathematicsWriteTypedPixel<float>(
+      output, masked, tensor, w, v, trans, scaleFactor, rgb_scale);
+    }
+}
 
+//----------------------------------------------------------------------------
+static void vtkDiffusionTensorMathematicsSkip(
+  vtkDiffusionTensorMathematicsOutput& output, vtkIdType increment)
+{
+  if (output.ScalarType == VTK_UNSIGNED_CHAR)
+    {
+    output.Pointer = static_cast<unsigned char*>(output.Pointer) + increment;
+    }
+  else
+    {
+    output.Pointer = static_cast<float*>(output.Pointer) + increment;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Handles Operation and the AdditionalOperations in a single pass: the
+// tensor of each voxel is read, and its eigensystem computed, only once
+// for all the outputs.
+static void vtkDiffusionTensorMathematicsExecuteMultiple(vtkDiffusionTensorMathematics *self,
+                          vtkImageData *in1Data,
+                          vtkImageData **outData,
+                          int numberOfOutputs,
+                          int outExt[6], int id)
+{
+  // image variables
+  int idxR, idxY, idxZ;
+  int maxY, maxZ;
+  vtkIdType inIncX, inIncY, inIncZ;
+  int rowLength;
+  // progress
+  unsigned long count = 0;
+  unsigned long target;
+  // tensor variables
+  double tensor[3][3];
+  // working matrices
+  double w[3], *v[3];
+  double v0[3], v1[3], v2[3];
+  v[0] = v0; v[1] = v1; v[2] = v2;
+  int extractEigenvalues = self->GetExtractEigenvalues();
+  int fixNegativeEigenvalues = self->GetFixNegativeEigenvalues();
+  // scaling
+  double scaleFactor = self->GetScaleFactor();
+  const double rgb_scale = (double)VTK_UNSIGNED_CHAR_MAX * scaleFactor / 1000.;
 
-      case vtkDiffusionTensorMathematics::VTK_TENS_MODE:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::Mode(w));
-            break;
+  vtkDataArray *inTensors = in1Data->GetPointData()->GetTensors();
+  if ( !inTensors || in1Data->GetNumberOfPoints() < 1 )
+    {
+    vtkGenericWarningMacro(<<"No input tensor data to filter!");
+    return;
+    }
+  if (self->GetScalarMask() && self->GetScalarMask()->GetScalarType() != VTK_SHORT)
+    {
+    vtkGenericWarningMacro(<<"scalr type for mask must be short!");
+    return;
+    }
 
-          case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_MODE:
+  std::vector<vtkDiffusionTensorMathematicsOutput> outputs(numberOfOutputs);
+  bool computeEigensystem = false;
+  for (int i = 0; i < numberOfOutputs; ++i)
+    {
+    vtkDiffusionTensorMathematicsOutput& output = outputs[i];
+    output.Operation = (i == 0 ? self->GetOperation() : self->GetAdditionalOperation(i - 1));
+    output.ScalarType = outData[i]->GetScalarType();
+    output.NumberOfComponents = outData[i]->GetNumberOfScalarComponents();
+    output.Pointer = outData[i]->GetScalarPointerForExtent(outExt);
+    vtkIdType outIncX;
+    outData[i]->GetContinuousIncrements(outExt, outIncX, output.IncY, output.IncZ);
+    computeEigensystem = computeEigensystem ||
+      vtkDiffusionTensorMathematics::OperationRequiresEigensystem(output.Operation);
+    }
 
-            vtkDiffusionTensorMathematics::ColorByMode(w,r,g,b);
-            // scale maps 0..1 values into the range a char takes on
-            rgb_temp = (rgb_scale*r);
-            *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-            outPtr++;
-            rgb_temp = (rgb_scale*g);
-            *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-            outPtr++;
-            rgb_temp = (rgb_scale*b);
-            *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-            outPtr++;
-            *outPtr = (T)VTK_UNSIGNED_CHAR_MAX; //alpha
-
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION:
-            // If the user has set the rotation matrix
-            // then transform the eigensystem first
-            // This is used to rotate the vector into RAS space
-            // for consistent anatomical coloring.
-            v_maj[0]=v[0][0];
-            v_maj[1]=v[1][0];
-            v_maj[2]=v[2][0];
-            if (useTransform)
-              {
-              trans->TransformPoint(v_maj,v_maj);
-              }
-            // Color R, G, B depending on max eigenvector
-            // scale maps 0..1 values into the range a char takes on
-            cl = vtkDiffusionTensorMathematics::LinearMeasure(w);
-            rgb_temp = (rgb_scale*fabs(v_maj[0])*cl);
-            *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-            outPtr++;
-            rgb_temp = (rgb_scale*fabs(v_maj[1])*cl);
-            *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-            outPtr++;
-            rgb_temp = (rgb_scale*fabs(v_maj[2])*cl);
-            *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-            outPtr++;
-            *outPtr = (T)VTK_UNSIGNED_CHAR_MAX; //alpha
-
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION_MIDDLE_EIGENVECTOR:
-            // If the user has set the rotation matrix
-            // then transform the eigensystem first
-            // This is used to rotate the vector into RAS space
-            // for consistent anatomical coloring.
-            v_maj[0]=v[0][1];
-            v_maj[1]=v[1][1];
-            v_maj[2]=v[2][1];
-            if (useTransform)
-              {
-              trans->TransformPoint(v_maj,v_maj);
-              }
-            // Color R, G, B depending on max eigenvector
-            // scale maps 0..1 values into the range a char takes on
-            cl = vtkDiffusionTensorMathematics::LinearMeasure(w);
-            rgb_temp = (rgb_scale*fabs(v_maj[0])*cl);
-            *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-            outPtr++;
-            rgb_temp = (rgb_scale*fabs(v_maj[1])*cl);
-            *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-            outPtr++;
-            rgb_temp = (rgb_scale*fabs(v_maj[2])*cl);
-            *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-            outPtr++;
-            *outPtr = (T)VTK_UNSIGNED_CHAR_MAX; //alpha
-
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION_MIN_EIGENVECTOR:
-            // If the user has set the rotation matrix
-            // then transform the eigensystem first
-            // This is used to rotate the vector into RAS space
-            // for consistent anatomical coloring.
-            v_maj[0]=v[0][2];
-            v_maj[1]=v[1][2];
-            v_maj[2]=v[2][2];
-            if (useTransform)
-              {
-              trans->TransformPoint(v_maj,v_maj);
-              }
-            // Color R, G, B depending on max eigenvector
-            // scale maps 0..1 values into the range a char takes on
-            cl = vtkDiffusionTensorMathematics::LinearMeasure(w);
-            rgb_temp = (rgb_scale*fabs(v_maj[0])*cl);
-            *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-            outPtr++;
-            rgb_temp = (rgb_scale*fabs(v_maj[1])*cl);
-            *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-            outPtr++;
-            rgb_temp = (rgb_scale*fabs(v_maj[2])*cl);
-            *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-            outPtr++;
-            *outPtr = (T)VTK_UNSIGNED_CHAR_MAX; //alpha
+  // find the output region to loop over
+  rowLength = (outExt[1] - outExt[0]+1);
+  maxY = outExt[3] - outExt[2];
+  maxZ = outExt[5] - outExt[4];
+  target = (unsigned long)((maxZ+1)*(maxY+1)/50.0);
+  target++;
 
-            break;
+  // Call special version of GetContinuousIncrements that works for Tensors
+  GetContinuousIncrements(in1Data, outExt, inIncX, inIncY, inIncZ);
+  float* inPtr = reinterpret_cast<float*>(in1Data->GetArrayPointerForExtent(inTensors, outExt));
 
+  // transformation of tensor orientations for coloring
+  vtkNew<vtkTransform> trans;
+  vtkTransform* tensorTransform = 0;
+  if (self->GetTensorRotationMatrix())
+    {
+    trans->SetMatrix(self->GetTensorRotationMatrix());
+    tensorTransform = trans.GetPointer();
+    }
 
-            }
+  // Check for masking
+  bool doMasking = false;
+  short * inMaskPtr = 0;
+  vtkIdType maskIncX = 0;
+  vtkIdType maskIncY = 0;
+  vtkIdType maskIncZ = 0;
+  if (self->GetMaskWithScalars() && self->GetScalarMask())
+    {
+    self->GetScalarMask()->GetContinuousIncrements(outExt, maskIncX, maskIncY, maskIncZ);
+    inMaskPtr = reinterpret_cast<short *>(self->GetScalarMask()->GetScalarPointerForExtent(outExt));
+    doMasking = self->GetScalarMask()->GetPointData()->GetScalars() != 0;
+    }
+  int maskLabelValue = self->GetMaskLabelValue();
+
+  for (idxZ = 0; idxZ <= maxZ; idxZ++)
+    {
+    for (idxY = 0; idxY <= maxY; idxY++)
+      {
+      if (!id)
+        {
+        if (!(count%target))
+          {
+          self->UpdateProgress(count/(50.0*target));
+          }
+        count++;
+        }
 
-          // scale double if the user requested this
-          if (scaleFactor != 1 && op !=  vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION
-            && op !=  vtkDiffusionTensorMathematics::VTK_TENS_COLOR_MODE)
+      for (idxR = 0; idxR < rowLength; idxR++)
+        {
+        bool masked = doMasking && *inMaskPtr != maskLabelValue;
+        if (!masked)
+          {
+          // tensor at this voxel
+          tensor[0][0] = static_cast<double>(inPtr[0]);
+          tensor[0][1] = static_cast<double>(inPtr[1]);
+          tensor[0][2] = static_cast<double>(inPtr[2]);
+          tensor[1][0] = static_cast<double>(inPtr[3]);
+          tensor[1][1] = static_cast<double>(inPtr[4]);
+          tensor[1][2] = static_cast<double>(inPtr[5]);
+          tensor[2][0] = static_cast<double>(inPtr[6]);
+          tensor[2][1] = static_cast<double>(inPtr[7]);
+          tensor[2][2] = static_cast<double>(inPtr[8]);
+          if (computeEigensystem)
             {
-            *outPtr = (T) ((*outPtr) * scaleFactor);
+            vtkDiffusionTensorMathematicsEigensystem(tensor, extractEigenvalues,
+              fixNegativeEigenvalues, w, v);
             }
           }
-
-
-        outPtr++;
+        for (int i = 0; i < numberOfOutputs; ++i)
+          {
+          vtkDiffusionTensorMathematicsWritePixel(outputs[i], masked,
+            tensor, w, v, tensorTransform, scaleFactor, rgb_scale);
+          }
         inPtr+=9;
         inMaskPtr++;
         }
-      outPtr += outIncY;
+      for (int i = 0; i < numberOfOutputs; ++i)
+        {
+        vtkDiffusionTensorMathematicsSkip(outputs[i], outputs[i].IncY);
+        }
       inPtr += inIncY;
       inMaskPtr += maskIncY;
       }
-    outPtr += outIncZ;
+    for (int i = 0; i < numberOfOutputs; ++i)
+      {
+      vtkDiffusionTensorMathematicsSkip(outputs[i], outputs[i].IncZ);
+      }
     inPtr += inIncZ;
     inMaskPtr += maskIncZ;
     }
-  // Cleanup
-  trans->Delete();
-
-#ifndef NDEBUG
-  tEnd = clock();
-  tDiff = tEnd - tStart;
-  vtkDebugWithObjectMacro(self, << "tDiff:" << tDiff);
-#endif
 }
 
 //----------------------------------------------------------------------------
@@ -850,6 +1126,13 @@ void vtkDiffusionTensorMathematics::ThreadedRequestData(
   // single input only for now
   vtkDebugMacro ("In Threaded Execute. scalar type is " << inData[0][0]->GetScalarType() << "op is: " << this->Operation);
 
+  if (!this->AdditionalOperations.empty())
+    {
+    vtkDiffusionTensorMathematicsExecuteMultiple(this, inData[0][0], outData,
+      this->GetNumberOfOutputPorts(), outExt, id);
+    return;
+    }
+
   switch (this->GetOperation())
     {
 
@@ -1149,6 +1432,70 @@ void vtkDiffusionTensorMathematics::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "Operation: " << this->Operation << "\n";
+  os << indent << "AdditionalOperations:";
+  for (size_t i = 0; i < this->AdditionalOperations.size(); ++i)
+    {
+    os << " " << this->AdditionalOperations[i];
+    }
+  os << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkDiffusionTensorMathematics::AddAdditionalOperation(int operation)
+{
+  if (operation < VTK_TENS_TRACE || operation > VTK_TENS_PERPENDICULAR_DIFFUSIVITY)
+    {
+    vtkErrorMacro(<< "AddAdditionalOperation: invalid operation " << operation);
+    return;
+    }
+  this->AdditionalOperations.push_back(operation);
+  this->SetNumberOfOutputPorts(1 + static_cast<int>(this->AdditionalOperations.size()));
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkDiffusionTensorMathematics::RemoveAllAdditionalOperations()
+{
+  if (this->AdditionalOperations.empty())
+    {
+    return;
+    }
+  this->AdditionalOperations.clear();
+  this->SetNumberOfOutputPorts(1);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkDiffusionTensorMathematics::GetNumberOfAdditionalOperations()
+{
+  return static_cast<int>(this->AdditionalOperations.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkDiffusionTensorMathematics::GetAdditionalOperation(int index)
+{
+  if (index < 0 || index >= this->GetNumberOfAdditionalOperations())
+    {
+    vtkErrorMacro(<< "GetAdditionalOperation: invalid index " << index);
+    return -1;
+    }
+  return this->AdditionalOperations[index];
+}
+
+//----------------------------------------------------------------------------
+bool vtkDiffusionTensorMathematics::OperationRequiresEigensystem(int operation)
+{
+  switch (operation)
+    {
+    case VTK_TENS_D11:
+    case VTK_TENS_D22:
+    case VTK_TENS_D33:
+    case VTK_TENS_TRACE:
+    case VTK_TENS_DETERMINANT:
+      return false;
+    default:
+      return true;
+    }
 }
 
 // Colormap: convert our mode value (-1..1) to RGB
@@ -32,6 +32,9 @@
 // VTK includes
 #include <vtkThreadedImageAlgorithm.h>
 
+// STD includes
+#include <vector>
+
 class vtkMatrix4x4;
 class vtkImageData;
 class VTK_Teem_EXPORT vtkDiffusionTensorMathematics : public vtkThreadedImageAlgorithm
@@ -174,6 +177,22 @@ public:
   void SetOperationToColorByMode()
     {this->SetOperation(VTK_TENS_COLOR_MODE);};
 
+  ///
+  /// Operations computed in the same pass as Operation.
+  /// The result of the additional operation i is produced on the
+  /// output port i+1, Operation is still produced on the output port 0.
+  /// The eigensystem of a voxel is computed only once for all the
+  /// operations, which is faster than running one filter per map.
+  void AddAdditionalOperation(int operation);
+  void RemoveAllAdditionalOperations();
+  int GetNumberOfAdditionalOperations();
+  int GetAdditionalOperation(int index);
+
+  ///
+  /// Return true if the eigenvalues and eigenvectors of the tensors must
+  /// be computed to perform \a operation.
+  static bool OperationRequiresEigensystem(int operation);
+
   ///
   /// Specify scale factor to scale output (float) scalars by.
   /// This is not used when the output is RGBA (char color data).
@@ -274,6 +293,7 @@ protected:
   ~vtkDiffusionTensorMathematics();
 
   int Operation; /// math operation to perform
+  std::vector<int> AdditionalOperations; /// operations of the output ports 1..n
   double ScaleFactor; /// Scale factor for output scalars
   int ExtractEigenvalues; /// Boolean controls eigenfunction extraction
 
@@ -17,20 +17,45 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkPointData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 vtkStandardNewMacro(vtkImageLabelCombine);
 
+namespace
+{
+//----------------------------------------------------------------------------
+bool vtkImageLabelCombineIsEmptyExtent(const int extent[6])
+{
+  return extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5];
+}
+
+//----------------------------------------------------------------------------
+void vtkImageLabelCombineIntersectExtent(const int extent1[6], const int extent2[6], int intersection[6])
+{
+  for (int idx = 0; idx < 3; ++idx)
+    {
+    intersection[idx*2] = std::max(extent1[idx*2], extent2[idx*2]);
+    intersection[idx*2+1] = std::min(extent1[idx*2+1], extent2[idx*2+1]);
+    }
+}
+}
+
 //----------------------------------------------------------------------------
 vtkImageLabelCombine::vtkImageLabelCombine()
 {
   this->SetNumberOfInputPorts(2);
   this->OverwriteInput = 0;
+  this->UseUnionOfInputExtents = 0;
 }
 
 //----------------------------------------------------------------------------
-// The output extent is the intersection.
+// The output extent is the intersection (or the union) of the input extents.
 int vtkImageLabelCombine::RequestInformation (
   vtkInformation * vtkNotUsed(request),
   vtkInformationVector **inputVector,
@@ -38,30 +63,45 @@ int vtkImageLabelCombine::RequestInformation (
 {
   // get the info objects
   vtkInformation *outInfo = outputVector->GetInformationObject(0);
-  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
-  vtkInformation *inInfo2 = inputVector[1]->GetInformationObject(0);
 
-  int ext[6], ext2[6], idx;
-
-  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), ext);
-
-  // two input take intersection
-  if (!inInfo2)
+  if (this->GetNumberOfInputConnections(1) == 0)
     {
     vtkErrorMacro(<< "Second input must be specified for this operation.");
     return 1;
     }
 
-  inInfo2->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), ext2);
-  for (idx = 0; idx < 3; ++idx)
+  int ext[6] = {0, -1, 0, -1, 0, -1};
+  bool firstInput = true;
+  for (int port = 0; port < 2; ++port)
     {
-    if (ext2[idx*2] > ext[idx*2])
-      {
-      ext[idx*2] = ext2[idx*2];
-      }
-    if (ext2[idx*2+1] < ext[idx*2+1])
+    for (int connection = 0; connection < this->GetNumberOfInputConnections(port); ++connection)
       {
-      ext[idx*2+1] = ext2[idx*2+1];
+      vtkInformation *inInfo = inputVector[port]->GetInformationObject(connection);
+      int inExt[6];
+      inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), inExt);
+      if (this->UseUnionOfInputExtents && vtkImageLabelCombineIsEmptyExtent(inExt))
+        {
+        continue;
+        }
+      for (int idx = 0; idx < 3; ++idx)
+        {
+        if (firstInput)
+          {
+          ext[idx*2] = inExt[idx*2];
+          ext[idx*2+1] = inExt[idx*2+1];
+          }
+        else if (this->UseUnionOfInputExtents)
+          {
+          ext[idx*2] = std::min(ext[idx*2], inExt[idx*2]);
+          ext[idx*2+1] = std::max(ext[idx*2+1], inExt[idx*2+1]);
+          }
+        else
+          {
+          ext[idx*2] = std::max(ext[idx*2], inExt[idx*2]);
+          ext[idx*2+1] = std::min(ext[idx*2+1], inExt[idx*2+1]);
+          }
+        }
+      firstInput = false;
       }
     }
 
@@ -70,111 +110,108 @@ int vtkImageLabelCombine::RequestInformation (
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// Only request the part of each input that is within the output extent.
+int vtkImageLabelCombine::RequestUpdateExtent(
+  vtkInformation * vtkNotUsed(request),
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  int outExt[6];
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt);
+
+  for (int port = 0; port < 2; ++port)
+    {
+    for (int connection = 0; connection < this->GetNumberOfInputConnections(port); ++connection)
+      {
+      vtkInformation *inInfo = inputVector[port]->GetInformationObject(connection);
+      int inWholeExt[6];
+      inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), inWholeExt);
+      int inExt[6];
+      vtkImageLabelCombineIntersectExtent(outExt, inWholeExt, inExt);
+      if (vtkImageLabelCombineIsEmptyExtent(inExt))
+        {
+        inExt[0] = inExt[2] = inExt[4] = 0;
+        inExt[1] = inExt[3] = inExt[5] = -1;
+        }
+      inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), inExt, 6);
+      }
+    }
+  return 1;
+}
 
 //----------------------------------------------------------------------------
-// This templated function executes the filter for any type of data.
-// Handles the two input operations
+// Copy the labels of an input into the output within ext.
+// If initialize is true, the output is assumed to contain no data yet.
+// The loop has no branch so that it can be vectorized.
 template <class T>
-void vtkImageLabelCombineExecute2(vtkImageLabelCombine *self,
-                                 vtkImageData *in1Data, T *in1Ptr,
-                                 vtkImageData *in2Data, T *in2Ptr,
-                                 vtkImageData *outData, T *outPtr,
-                                 int outExt[6], int id)
+void vtkImageLabelCombinePaint(vtkImageData *inData, vtkImageData *outData,
+                               int ext[6], bool initialize, T *)
 {
-  int idxR, idxY, idxZ;
-  int maxY, maxZ;
+  T *inPtr = static_cast<T *>(inData->GetScalarPointerForExtent(ext));
+  T *outPtr = static_cast<T *>(outData->GetScalarPointerForExtent(ext));
+
   vtkIdType inIncX, inIncY, inIncZ;
-  vtkIdType in2IncX, in2IncY, in2IncZ;
   vtkIdType outIncX, outIncY, outIncZ;
-  int rowLength;
-  unsigned long count = 0;
-  unsigned long target;
-  int op = self->GetOverwriteInput();
-
-  // find the region to loop over
-  rowLength = (outExt[1] - outExt[0]+1)*in1Data->GetNumberOfScalarComponents();
-
-  maxY = outExt[3] - outExt[2];
-  maxZ = outExt[5] - outExt[4];
-  target = (unsigned long)((maxZ+1)*(maxY+1)/50.0);
-  target++;
+  inData->GetContinuousIncrements(ext, inIncX, inIncY, inIncZ);
+  outData->GetContinuousIncrements(ext, outIncX, outIncY, outIncZ);
+  vtkIdType rowLength = (ext[1] - ext[0] + 1) * outData->GetNumberOfScalarComponents();
 
-  T v1;
-  T v2;
-
-  // Get increments to march through data
-  in1Data->GetContinuousIncrements(outExt, inIncX, inIncY, inIncZ);
-  in2Data->GetContinuousIncrements(outExt, in2IncX, in2IncY, in2IncZ);
-  outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
-
-  // Loop through ouput pixels
-  for (idxZ = 0; idxZ <= maxZ; idxZ++)
+  const T zero = static_cast<T>(0);
+  for (int idxZ = ext[4]; idxZ <= ext[5]; ++idxZ)
     {
-    for (idxY = 0; !self->AbortExecute && idxY <= maxY; idxY++)
+    for (int idxY = ext[2]; idxY <= ext[3]; ++idxY)
       {
-      if (!id)
+      if (initialize)
         {
-        if (!(count%target))
+        for (vtkIdType idxR = 0; idxR < rowLength; ++idxR)
           {
-          self->UpdateProgress(count/(50.0*target));
+          T value = inPtr[idxR];
+          outPtr[idxR] = (value > zero) ? value : zero;
           }
-        count++;
         }
-      for (idxR = 0; idxR < rowLength; idxR++)
+      else
         {
-        // Pixel operation
-        v1 = *in1Ptr;
-        v2 = *in2Ptr;
-        if (op == 0)
+        for (vtkIdType idxR = 0; idxR < rowLength; ++idxR)
           {
-          if (v1 > 0)
-            {
-            *outPtr = v1;
-            }
-          else if (v2 > 0 && v1 == 0)
-            {
-            *outPtr = v2;
-            }
-          else
-            {
-            *outPtr = 0;
-            }
+          T value = inPtr[idxR];
+          T current = outPtr[idxR];
+          outPtr[idxR] = (value > zero) ? value : ((value == zero) ? current : zero);
           }
-        else
-          {
-          if (v2 > 0)
-            {
-            *outPtr = v2;
-            }
-          else if (v1 > 0 && v2 == 0)
-            {
-            *outPtr = v1;
-            }
-          else
-            {
-            *outPtr = 0;
-            }
-          }
-        outPtr++;
-        in1Ptr++;
-        in2Ptr++;
         }
-      outPtr += outIncY;
-      in1Ptr += inIncY;
-      in2Ptr += in2IncY;
+      inPtr += rowLength + inIncY;
+      outPtr += rowLength + outIncY;
       }
+    inPtr += inIncZ;
     outPtr += outIncZ;
-    in1Ptr += inIncZ;
-    in2Ptr += in2IncZ;
     }
 }
 
+//----------------------------------------------------------------------------
+template <class T>
+void vtkImageLabelCombineClear(vtkImageData *outData, int ext[6], T *)
+{
+  T *outPtr = static_cast<T *>(outData->GetScalarPointerForExtent(ext));
+  vtkIdType outIncX, outIncY, outIncZ;
+  outData->GetContinuousIncrements(ext, outIncX, outIncY, outIncZ);
+  vtkIdType rowLength = (ext[1] - ext[0] + 1) * outData->GetNumberOfScalarComponents();
+  for (int idxZ = ext[4]; idxZ <= ext[5]; ++idxZ)
+    {
+    for (int idxY = ext[2]; idxY <= ext[3]; ++idxY)
+      {
+      memset(outPtr, 0, rowLength * sizeof(T));
+      outPtr += rowLength + outIncY;
+      }
+    outPtr += outIncZ;
+    }
+}
 
 //----------------------------------------------------------------------------
 // This method is passed a input and output datas, and executes the filter
 // algorithm to fill the output from the inputs.
-// It just executes a switch statement to call the correct function for
-// the datas data types.
+// The inputs are painted onto the output from the lowest to the highest
+// priority, each one only within the part of the output extent it covers.
 void vtkImageLabelCombine::ThreadedRequestData(
   vtkInformation * vtkNotUsed( request ),
   vtkInformationVector ** vtkNotUsed( inputVector ),
@@ -183,63 +220,103 @@ void vtkImageLabelCombine::ThreadedRequestData(
   vtkImageData **outData,
   int outExt[6], int id)
 {
-  void *inPtr1;
-  void *outPtr;
-
-  inPtr1 = inData[0][0]->GetScalarPointerForExtent(outExt);
-  outPtr = outData[0]->GetScalarPointerForExtent(outExt);
-
-  void *inPtr2;
-
   if (!inData[1] || ! inData[1][0])
     {
     vtkErrorMacro("ImageMathematics requested to perform a two input operation with only one input\n");
     return;
     }
 
-  inPtr2 = inData[1][0]->GetScalarPointerForExtent(outExt);
-
-  // this filter expects that input is the same type as output.
-  if (inData[0][0]->GetScalarType() != outData[0]->GetScalarType())
+  // Inputs from the highest to the lowest priority
+  std::vector<vtkImageData*> inputs;
+  inputs.push_back(inData[0][0]);
+  for (int connection = 0; connection < this->GetNumberOfInputConnections(1); ++connection)
     {
-      vtkErrorMacro(<< "Execute: input1 ScalarType, "
-                    <<  inData[0][0]->GetScalarType()
-                    << ", must match output ScalarType "
-                    << outData[0]->GetScalarType());
-      return;
+    inputs.push_back(inData[1][connection]);
+    }
+  if (this->OverwriteInput)
+    {
+    std::reverse(inputs.begin(), inputs.end());
     }
-  /**
-  if (inData[1][0]->GetScalarType() != outData[0]->GetScalarType())
+
+  // this filter expects that inputs are the same type as output and have
+  // the same number of components
+  for (size_t i = 0; i < inputs.size(); ++i)
     {
-      vtkErrorMacro(<< "Execute: input2 ScalarType, "
-                    << inData[1][0]->GetScalarType()
+    if (!inputs[i])
+      {
+      vtkErrorMacro(<< "Execute: input " << i << " is missing");
+      return;
+      }
+    if (inputs[i]->GetScalarType() != outData[0]->GetScalarType())
+      {
+      vtkErrorMacro(<< "Execute: input ScalarType, "
+                    << inputs[i]->GetScalarType()
                     << ", must match output ScalarType "
                     << outData[0]->GetScalarType());
       return;
-    }
-  **/
-  // this filter expects that inputs that have the same number of components
-  if (inData[0][0]->GetNumberOfScalarComponents() !=
-      inData[1][0]->GetNumberOfScalarComponents())
-    {
-      vtkErrorMacro(<< "Execute: input1 NumberOfScalarComponents, "
-                    << inData[0][0]->GetNumberOfScalarComponents()
-                    << ", must match out input2 NumberOfScalarComponents "
-                    << inData[1][0]->GetNumberOfScalarComponents());
+      }
+    if (inputs[i]->GetNumberOfScalarComponents() !=
+        inputs[0]->GetNumberOfScalarComponents())
+      {
+      vtkErrorMacro(<< "Execute: all inputs must have "
+                    << inputs[0]->GetNumberOfScalarComponents()
+                    << " components, input has "
+                    << inputs[i]->GetNumberOfScalarComponents());
       return;
+      }
     }
 
-  switch (inData[0][0]->GetScalarType())
+  // Paint from the lowest priority input
+  bool initialized = false;
+  int processed = 0;
+  for (std::vector<vtkImageData*>::reverse_iterator inputIt = inputs.rbegin();
+       inputIt != inputs.rend() && !this->AbortExecute; ++inputIt)
     {
-    vtkTemplateMacro(
-                     vtkImageLabelCombineExecute2(this,inData[0][0], (VTK_TT *)(inPtr1),
-                                                  inData[1][0], (VTK_TT *)(inPtr2),
-                                                  outData[0], (VTK_TT *)(outPtr), outExt, id));
-    default:
-      vtkErrorMacro(<< "Execute: Unknown ScalarType");
-      return;
+    vtkImageData *input = *inputIt;
+    int paintExt[6];
+    vtkImageLabelCombineIntersectExtent(outExt, input->GetExtent(), paintExt);
+    if (vtkImageLabelCombineIsEmptyExtent(paintExt) || !input->GetPointData()->GetScalars())
+      {
+      continue;
+      }
+    bool coversOutput = std::equal(paintExt, paintExt + 6, outExt);
+    if (!initialized && !coversOutput)
+      {
+      switch (outData[0]->GetScalarType())
+        {
+        vtkTemplateMacro(vtkImageLabelCombineClear(outData[0], outExt, static_cast<VTK_TT *>(0)));
+        default:
+          vtkErrorMacro(<< "Execute: Unknown ScalarType");
+          return;
+        }
+      initialized = true;
+      }
+    switch (outData[0]->GetScalarType())
+      {
+      vtkTemplateMacro(vtkImageLabelCombinePaint(input, outData[0], paintExt, !initialized,
+                                                 static_cast<VTK_TT *>(0)));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+        return;
+      }
+    initialized = true;
+    if (!id)
+      {
+      this->UpdateProgress(static_cast<double>(++processed) / inputs.size());
+      }
     }
 
+  if (!initialized)
+    {
+    // no input covers the output extent
+    switch (outData[0]->GetScalarType())
+      {
+      vtkTemplateMacro(vtkImageLabelCombineClear(outData[0], outExt, static_cast<VTK_TT *>(0)));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+        return;
+      }
+    }
 }
 
 int vtkImageLabelCombine::FillInputPortInformation(
@@ -255,6 +332,6 @@ void vtkImageLabelCombine::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "OverwriteInput: " << this->OverwriteInput  << "\n";
+  os << indent << "UseUnionOfInputExtents: " << this->UseUnionOfInputExtents  << "\n";
 
 }
-
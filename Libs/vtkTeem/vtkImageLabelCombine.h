@@ -22,11 +22,23 @@
 
 #include "vtkThreadedImageAlgorithm.h"
 
-/// \brief Add, subtract, multiply, divide, invert, sin, cos, exp, log.
+/// \brief Combine label maps into a single label map.
 ///
-/// vtkImageLabelCombine implements basic mathematic operations SetOperation is
-/// used to select the filters behavior.  The filter can take two or one
-/// input.
+/// The first label map is set on the first input port, the others are
+/// added to the second input port (e.g. SetInput2() then AddInputData(1, ...)),
+/// so that any number of label maps is combined in one pass. At each voxel,
+/// the label map of highest priority with a non-zero value defines the
+/// output: the label if it is positive, 0 otherwise.
+/// Label maps are ordered from the highest to the lowest priority, unless
+/// OverwriteInput is set, in which case the last label maps have the highest
+/// priority.
+///
+/// All the label maps must have the same scalar type and number of components.
+/// By default the output extent is the intersection of the input extents. If
+/// UseUnionOfInputExtents is set, the output extent is their union, voxels
+/// outside of a label map are considered 0 and only the region covered by a
+/// label map is processed for it: combining many label maps cropped to their
+/// structure is much faster than combining full size label maps.
 class VTK_Teem_EXPORT vtkImageLabelCombine : public vtkThreadedImageAlgorithm
 {
 public:
@@ -35,10 +47,18 @@ public:
   void PrintSelf(ostream& os, vtkIndent indent);
 
   ///
-  /// Set/Get the Operation to perform.
+  /// If 0 (default) the first label maps have the highest priority,
+  /// otherwise the last label maps have the highest priority.
   vtkSetMacro(OverwriteInput,int);
   vtkGetMacro(OverwriteInput,int);
 
+  ///
+  /// If set, the output extent is the union of the input extents instead of
+  /// their intersection. 0 by default.
+  vtkSetMacro(UseUnionOfInputExtents,int);
+  vtkGetMacro(UseUnionOfInputExtents,int);
+  vtkBooleanMacro(UseUnionOfInputExtents,int);
+
   ///
   /// Set the two inputs to this filter
   virtual void SetInput1(vtkDataObject *in)
@@ -55,11 +75,16 @@ protected:
   ~vtkImageLabelCombine() {};
 
   int OverwriteInput;
+  int UseUnionOfInputExtents;
 
   virtual int RequestInformation (vtkInformation *,
                                   vtkInformationVector **,
                                   vtkInformationVector *);
 
+  virtual int RequestUpdateExtent(vtkInformation *,
+                                  vtkInformationVector **,
+                                  vtkInformationVector *);
+
   virtual void ThreadedRequestData(vtkInformation *request,
                                    vtkInformationVector **inputVector,
                                    vtkInformationVector *outputVector,
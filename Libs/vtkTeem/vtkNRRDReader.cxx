@@ -27,6 +27,7 @@
 =========================================================================*/
 // vtkTeem includes
 #include "vtkNRRDReader.h"
+#include "vtkNRRDWriter.h"
 
 // VTK includes
 #include "vtkBitArray.h"
@@ -35,10 +36,12 @@
 #include "vtkFloatArray.h"
 #include "vtkImageData.h"
 #include <vtkInformation.h>
+#include <vtkInformationObjectBaseKey.h>
 #include <vtkInformationVector.h>
 #include "vtkIntArray.h"
 #include "vtkLongArray.h"
 #include "vtkMath.h"
+#include <vtkMultiThreader.h>
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkShortArray.h"
@@ -47,12 +50,242 @@
 #include "vtkUnsignedShortArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnsignedLongArray.h"
+#include <vtk_zlib.h>
 #include <vtksys/SystemTools.hxx>
 
 // Teem includes
 #include "teem/ten.h"
 
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Copy-on-write memory mapping of a part of a file.
+/// The mapping is released when the object is deleted.
+class vtkNRRDMappedData : public vtkObject
+{
+public:
+  static vtkNRRDMappedData *New();
+  vtkTypeMacro(vtkNRRDMappedData, vtkObject);
+
+  /// Map length bytes of the file, starting at offset.
+  bool Open(const char* fileName, vtkTypeInt64 offset, size_t length)
+  {
+    this->Close();
+    if (length == 0)
+      {
+      return false;
+      }
+#ifdef _WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    vtkTypeInt64 alignedOffset = offset - offset % systemInfo.dwAllocationGranularity;
+    HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+      {
+      return false;
+      }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)
+      || fileSize.QuadPart < offset + static_cast<vtkTypeInt64>(length))
+      {
+      CloseHandle(file);
+      return false;
+      }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping)
+      {
+      return false;
+      }
+    size_t mappedLength = length + static_cast<size_t>(offset - alignedOffset);
+    void* mapped = MapViewOfFile(mapping, FILE_MAP_COPY,
+      static_cast<DWORD>(alignedOffset >> 32), static_cast<DWORD>(alignedOffset & 0xFFFFFFFF), mappedLength);
+    CloseHandle(mapping);
+    if (!mapped)
+      {
+      return false;
+      }
+#else
+    vtkTypeInt64 pageSize = static_cast<vtkTypeInt64>(sysconf(_SC_PAGESIZE));
+    vtkTypeInt64 alignedOffset = offset - offset % pageSize;
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0)
+      {
+      return false;
+      }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0
+      || static_cast<vtkTypeInt64>(fileStat.st_size) < offset + static_cast<vtkTypeInt64>(length))
+      {
+      close(fd);
+      return false;
+      }
+    size_t mappedLength = length + static_cast<size_t>(offset - alignedOffset);
+    // Private mapping: pages that are modified in memory are copied, the file is not changed
+    void* mapped = mmap(NULL, mappedLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, static_cast<off_t>(alignedOffset));
+    close(fd);
+    if (mapped == MAP_FAILED)
+      {
+      return false;
+      }
+#endif
+    this->MappedAddress = mapped;
+    this->MappedLength = mappedLength;
+    this->Data = static_cast<char*>(mapped) + (offset - alignedOffset);
+    return true;
+  }
+
+  void Close()
+  {
+    if (!this->MappedAddress)
+      {
+      return;
+      }
+#ifdef _WIN32
+    UnmapViewOfFile(this->MappedAddress);
+#else
+    munmap(this->MappedAddress, this->MappedLength);
+#endif
+    this->MappedAddress = NULL;
+    this->MappedLength = 0;
+    this->Data = NULL;
+  }
+
+  void* GetData() { return this->Data; }
+
+protected:
+  vtkNRRDMappedData()
+    : MappedAddress(NULL)
+    , MappedLength(0)
+    , Data(NULL)
+  {
+  }
+  ~vtkNRRDMappedData()
+  {
+    this->Close();
+  }
+
+  void* MappedAddress;
+  size_t MappedLength;
+  void* Data;
+
+private:
+  vtkNRRDMappedData(const vtkNRRDMappedData&);  /// Not implemented.
+  void operator=(const vtkNRRDMappedData&);  /// Not implemented.
+};
+
+vtkStandardNewMacro(vtkNRRDMappedData);
+
+//----------------------------------------------------------------------------
+struct BlockDecompressionData
+{
+  /// Compressed blocks, starting with the first decompressed block
+  const unsigned char* CompressedData;
+  /// Start of each compressed block (and the end of the last block)
+  std::vector<size_t> CompressedOffsets;
+  /// Uncompressed data, starting with the first decompressed block
+  unsigned char* Data;
+  /// Uncompressed size of all the blocks
+  size_t DataSize;
+  size_t BlockSize;
+  /// Blocks [FirstBlock, FirstBlock + BlockStatus.size()) are decompressed
+  size_t FirstBlock;
+  std::vector<int> BlockStatus;
+};
+
+//----------------------------------------------------------------------------
+/// Decompress a complete gzip member into a buffer of the exact uncompressed size
+bool DecompressBlock(const unsigned char* compressed, size_t compressedSize, unsigned char* data, size_t size)
+{
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  // 15 + 16 window bits: maximum window size with gzip header and trailer
+  if (inflateInit2(&stream, 15 + 16) != Z_OK)
+    {
+    return false;
+    }
+  stream.next_in = const_cast<Bytef*>(compressed);
+  stream.avail_in = static_cast<uInt>(compressedSize);
+  stream.next_out = data;
+  stream.avail_out = static_cast<uInt>(size);
+  int status = inflate(&stream, Z_FINISH);
+  bool success = (status == Z_STREAM_END && stream.total_out == size && stream.avail_in == 0);
+  inflateEnd(&stream);
+  return success;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE DecompressBlocksThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  BlockDecompressionData* data = static_cast<BlockDecompressionData*>(info->UserData);
+  size_t numberOfBlocks = data->BlockStatus.size();
+  for (size_t i = info->ThreadID; i < numberOfBlocks; i += info->NumberOfThreads)
+    {
+    size_t block = data->FirstBlock + i;
+    size_t blockStart = block * data->BlockSize;
+    size_t blockSize = std::min(data->BlockSize, data->DataSize - blockStart);
+    data->BlockStatus[i] = DecompressBlock(
+      data->CompressedData + (data->CompressedOffsets[block] - data->CompressedOffsets[data->FirstBlock]),
+      data->CompressedOffsets[block + 1] - data->CompressedOffsets[block],
+      data->Data + (blockStart - data->FirstBlock * data->BlockSize), blockSize) ? 1 : 0;
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+/// Offset in bytes of the voxel (i, j, k) in a volume of \a extent
+size_t GetVoxelOffset(const int extent[6], int i, int j, int k, size_t voxelSize)
+{
+  size_t dimensions[2] = {
+    static_cast<size_t>(extent[1] - extent[0] + 1),
+    static_cast<size_t>(extent[3] - extent[2] + 1) };
+  return ((static_cast<size_t>(k - extent[4]) * dimensions[1]
+    + static_cast<size_t>(j - extent[2])) * dimensions[0]
+    + static_cast<size_t>(i - extent[0])) * voxelSize;
+}
+
+//----------------------------------------------------------------------------
+/// Copy the voxels of \a region out of a volume of \a extent.
+/// \a volume holds the bytes of the volume starting at \a volumeStart.
+void CopyRegion(const unsigned char* volume, size_t volumeStart, const int extent[6],
+                const int region[6], size_t voxelSize, unsigned char* output)
+{
+  size_t rowSize = static_cast<size_t>(region[1] - region[0] + 1) * voxelSize;
+  for (int k = region[4]; k <= region[5]; ++k)
+    {
+    for (int j = region[2]; j <= region[3]; ++j)
+      {
+      memcpy(output, volume + (GetVoxelOffset(extent, region[0], j, k, voxelSize) - volumeStart), rowSize);
+      output += rowSize;
+      }
+    }
+}
+
+} // end of anonymous namespace
+
 vtkStandardNewMacro(vtkNRRDReader);
+vtkInformationKeyMacro(vtkNRRDReader, MAPPED_DATA, ObjectBase);
 
 //----------------------------------------------------------------------------
 vtkNRRDReader::vtkNRRDReader()
@@ -66,6 +299,18 @@ vtkNRRDReader::vtkNRRDReader()
   this->PointDataType = -1;
   this->DataType = -1;
   this->NumberOfComponents = -1;
+  this->UseMemoryMapping = false;
+  this->MappableDataFileOffset = 0;
+  this->NumberOfThreads = 0;
+  this->CompressionBlockSize = 0;
+  this->RawDataFileOffset = 0;
+  for (int i = 0; i < 3; ++i)
+    {
+    this->ReadExtent[2 * i] = 0;
+    this->ReadExtent[2 * i + 1] = -1;
+    this->FileExtent[2 * i] = 0;
+    this->FileExtent[2 * i + 1] = -1;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -346,6 +591,10 @@ void vtkNRRDReader::ExecuteInformation()
 
   nrrdNuke(this->nrrd); // nuke and reallocate to reset the state
   this->nrrd = nrrdNew();
+  this->MappableDataFileName.clear();
+  this->MappableDataFileOffset = 0;
+  this->CompressionBlockSize = 0;
+  this->CompressedBlockSizes.clear();
 
   NrrdIoState *nio = nrrdIoStateNew();
 
@@ -578,6 +827,32 @@ void vtkNRRDReader::ExecuteInformation()
 
   this->RasToIjkMatrix->SetElement(3, 3, 1.0);
 
+  // Only the region of interest is read, voxel indices are kept so that
+  // RasToIjkMatrix is the same as for the whole image.
+  memcpy(this->FileExtent, dataExtent, sizeof(this->FileExtent));
+  if (this->ReadExtent[0] <= this->ReadExtent[1]
+    && this->ReadExtent[2] <= this->ReadExtent[3]
+    && this->ReadExtent[4] <= this->ReadExtent[5])
+    {
+    int readExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    bool emptyExtent = false;
+    for (int i = 0; i < 3; i++)
+      {
+      readExtent[2 * i] = std::max(dataExtent[2 * i], this->ReadExtent[2 * i]);
+      readExtent[2 * i + 1] = std::min(dataExtent[2 * i + 1], this->ReadExtent[2 * i + 1]);
+      emptyExtent = emptyExtent || readExtent[2 * i] > readExtent[2 * i + 1];
+      }
+    if (emptyExtent)
+      {
+      vtkWarningMacro("ReadImageInformation: ReadExtent does not intersect the image in "
+        << this->GetFileName() << ", the whole image is read");
+      }
+    else
+      {
+      memcpy(dataExtent, readExtent, sizeof(readExtent));
+      }
+    }
+
   this->SetDataSpacing(spacing);
   //this->SetDataOrigin(origin);
   this->SetDataExtent(dataExtent);
@@ -658,10 +933,390 @@ void vtkNRRDReader::ExecuteInformation()
       }
     }
 
+  this->UpdateMappableDataFile(nio);
+  this->UpdateCompressedDataBlocks(nio);
+  this->UpdateRawDataFile(nio);
+
   this->vtkImageReader2::ExecuteInformation();
   nio = nrrdIoStateNix(nio);
 }
 
+//----------------------------------------------------------------------------
+void vtkNRRDReader::UpdateMappableDataFile(NrrdIoState* nio)
+{
+  this->MappableDataFileName.clear();
+  this->MappableDataFileOffset = 0;
+
+  // Only a single raw data file, that can be located without reading the header lines, is mapped
+  if (nio->encoding != nrrdEncodingRaw || nio->dataFNFormat != NULL
+    || nio->dataFNArr == NULL || nio->dataFNArr->len != 1
+    || nio->lineSkip != 0 || nio->byteSkip < 0)
+    {
+    return;
+    }
+  const char* dataFileName = nio->dataFN[0];
+  if (dataFileName == NULL || strcmp(dataFileName, "LOCAL") == 0)
+    {
+    return;
+    }
+  if (!this->HasVTKDataLayout(nio)
+    || nio->byteSkip % nrrdElementSize(this->nrrd) != 0)
+    {
+    return;
+    }
+
+  std::string fullDataFileName = dataFileName;
+  if (!vtksys::SystemTools::FileIsFullPath(dataFileName))
+    {
+    std::string headerDirectory = nio->path ? std::string(nio->path)
+      : vtksys::SystemTools::GetFilenamePath(this->GetFileName());
+    fullDataFileName = vtksys::SystemTools::CollapseFullPath(dataFileName, headerDirectory.c_str());
+    }
+  this->MappableDataFileName = fullDataFileName;
+  this->MappableDataFileOffset = nio->byteSkip;
+}
+
+//----------------------------------------------------------------------------
+void vtkNRRDReader::UpdateRawDataFile(NrrdIoState* nio)
+{
+  this->RawDataFileName.clear();
+  this->RawDataFileOffset = 0;
+  if (!this->IsReadingRegion())
+    {
+    return;
+    }
+  if (!this->MappableDataFileName.empty())
+    {
+    this->RawDataFileName = this->MappableDataFileName;
+    this->RawDataFileOffset = this->MappableDataFileOffset;
+    return;
+    }
+
+  // Raw data attached to the header is at the end of the file
+  if (nio->encoding != nrrdEncodingRaw || nio->detachedHeader
+    || (nio->dataFNArr != NULL && nio->dataFNArr->len > 0)
+    || nio->lineSkip != 0 || nio->byteSkip != 0
+    || !this->HasVTKDataLayout(nio))
+    {
+    return;
+    }
+  std::ifstream file(this->GetFileName(), std::ios::in | std::ios::binary);
+  if (!file)
+    {
+    return;
+    }
+  file.seekg(0, std::ios::end);
+  vtkTypeInt64 fileSize = static_cast<vtkTypeInt64>(file.tellg());
+  vtkTypeInt64 dataSize = static_cast<vtkTypeInt64>(nrrdElementNumber(this->nrrd) * nrrdElementSize(this->nrrd));
+  if (fileSize < dataSize)
+    {
+    return;
+    }
+  this->RawDataFileName = this->GetFileName();
+  this->RawDataFileOffset = fileSize - dataSize;
+}
+
+//----------------------------------------------------------------------------
+bool vtkNRRDReader::IsReadingRegion()
+{
+  for (int i = 0; i < 6; i++)
+    {
+    if (this->DataExtent[i] != this->FileExtent[i])
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkNRRDReader::ReadRawDataRegion(void* data)
+{
+  if (this->RawDataFileName.empty() || data == NULL)
+    {
+    return false;
+    }
+  std::ifstream file(this->RawDataFileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file)
+    {
+    return false;
+    }
+  size_t voxelSize = nrrdElementSize(this->nrrd) * this->GetNumberOfComponents();
+  const int* region = this->DataExtent;
+  // A row of the region is contiguous in the file, so are all the rows of
+  // a slice if the region spans the whole rows.
+  bool wholeRows = (region[0] == this->FileExtent[0] && region[1] == this->FileExtent[1]);
+  size_t rowSize = static_cast<size_t>(region[1] - region[0] + 1) * voxelSize;
+  size_t readSize = wholeRows ? rowSize * (region[3] - region[2] + 1) : rowSize;
+  char* output = static_cast<char*>(data);
+  for (int k = region[4]; k <= region[5]; ++k)
+    {
+    for (int j = region[2]; j <= region[3]; j += (wholeRows ? region[3] - region[2] + 1 : 1))
+      {
+      vtkTypeInt64 offset = this->RawDataFileOffset
+        + static_cast<vtkTypeInt64>(GetVoxelOffset(this->FileExtent, region[0], j, k, voxelSize));
+      file.seekg(offset, std::ios::beg);
+      file.read(output, readSize);
+      if (!file)
+        {
+        vtkDebugMacro("ReadRawDataRegion: cannot read " << this->RawDataFileName << ", reading the file instead");
+        return false;
+        }
+      output += readSize;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkNRRDReader::ReadCompressedDataRegion(void* data)
+{
+  if (this->CompressedBlockSizes.empty() || data == NULL)
+    {
+    return false;
+    }
+  // Only the blocks that contain voxels of the region are decompressed
+  size_t voxelSize = nrrdElementSize(this->nrrd) * this->GetNumberOfComponents();
+  const int* region = this->DataExtent;
+  size_t regionStart = GetVoxelOffset(this->FileExtent, region[0], region[2], region[4], voxelSize);
+  size_t regionEnd = GetVoxelOffset(this->FileExtent, region[1], region[3], region[5], voxelSize) + voxelSize;
+  size_t blockSize = static_cast<size_t>(this->CompressionBlockSize);
+  size_t dataSize = nrrdElementNumber(this->nrrd) * nrrdElementSize(this->nrrd);
+  size_t firstBlock = regionStart / blockSize;
+  size_t lastBlock = (regionEnd - 1) / blockSize;
+  size_t blocksStart = firstBlock * blockSize;
+  std::vector<unsigned char> blocks(std::min((lastBlock + 1) * blockSize, dataSize) - blocksStart);
+  if (!this->DecompressDataBlocks(firstBlock, lastBlock, &blocks[0]))
+    {
+    return false;
+    }
+  CopyRegion(&blocks[0], blocksStart, this->FileExtent, region, voxelSize, static_cast<unsigned char*>(data));
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkNRRDReader::HasVTKDataLayout(NrrdIoState* nio)
+{
+  // The voxels must be usable in the file without conversion
+  size_t elementSize = nrrdElementSize(this->nrrd);
+  if (nrrdTypeBlock == this->nrrd->type || elementSize == 0
+    || this->NrrdToVTKScalarType(this->nrrd->type) == VTK_VOID)
+    {
+    return false;
+    }
+#ifdef VTK_WORDS_BIGENDIAN
+  const int hostEndian = airEndianBig;
+#else
+  const int hostEndian = airEndianLittle;
+#endif
+  if (elementSize > 1 && nio->endian != hostEndian)
+    {
+    return false;
+    }
+  unsigned int rangeAxisIdx[NRRD_DIM_MAX] = { 0 };
+  unsigned int rangeAxisNum = nrrdRangeAxesGet(this->nrrd, rangeAxisIdx);
+  if (rangeAxisNum > 1 || (rangeAxisNum == 1 && rangeAxisIdx[0] != 0))
+    {
+    return false;
+    }
+  if (nrrdKind3DMaskedSymMatrix == this->nrrd->axis[0].kind
+    || nrrdKind3DSymMatrix == this->nrrd->axis[0].kind)
+    {
+    // tensors are converted after reading
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkNRRDReader::UpdateCompressedDataBlocks(NrrdIoState* nio)
+{
+  this->CompressionBlockSize = 0;
+  this->CompressedBlockSizes.clear();
+
+  // Only data written by vtkNRRDWriter as gzip members after an attached header
+  // is decompressed in blocks
+  std::map<std::string, std::string>::iterator blockSizeIt =
+    this->HeaderKeyValue.find(vtkNRRDWriter::GetCompressionBlockSizeKey());
+  std::map<std::string, std::string>::iterator compressedBlockSizesIt =
+    this->HeaderKeyValue.find(vtkNRRDWriter::GetCompressedBlockSizesKey());
+  if (blockSizeIt == this->HeaderKeyValue.end()
+    || compressedBlockSizesIt == this->HeaderKeyValue.end()
+    || nio->encoding != nrrdEncodingGzip || nio->detachedHeader
+    || (nio->dataFNArr != NULL && nio->dataFNArr->len > 0)
+    || nio->lineSkip != 0 || nio->byteSkip != 0
+    || !this->HasVTKDataLayout(nio))
+    {
+    return;
+    }
+
+  vtkTypeInt64 blockSize = 0;
+  std::stringstream blockSizeStr(blockSizeIt->second);
+  blockSizeStr >> blockSize;
+  std::vector<vtkTypeInt64> compressedBlockSizes;
+  std::stringstream compressedBlockSizesStr(compressedBlockSizesIt->second);
+  vtkTypeInt64 compressedBlockSize = 0;
+  while (compressedBlockSizesStr >> compressedBlockSize)
+    {
+    if (compressedBlockSize <= 0)
+      {
+      return;
+      }
+    compressedBlockSizes.push_back(compressedBlockSize);
+    }
+  size_t dataSize = nrrdElementNumber(this->nrrd) * nrrdElementSize(this->nrrd);
+  if (blockSize <= 0 || compressedBlockSizes.empty()
+    || compressedBlockSizes.size() != (dataSize + static_cast<size_t>(blockSize) - 1) / static_cast<size_t>(blockSize))
+    {
+    vtkDebugMacro("UpdateCompressedDataBlocks: invalid block sizes in " << this->GetFileName());
+    return;
+    }
+  this->CompressionBlockSize = blockSize;
+  this->CompressedBlockSizes = compressedBlockSizes;
+}
+
+//----------------------------------------------------------------------------
+bool vtkNRRDReader::ReadCompressedDataBlocks(void* data, size_t dataSize)
+{
+  if (this->CompressedBlockSizes.empty() || data == NULL
+    || dataSize != nrrdElementNumber(this->nrrd) * nrrdElementSize(this->nrrd))
+    {
+    return false;
+    }
+  return this->DecompressDataBlocks(0, this->CompressedBlockSizes.size() - 1, static_cast<unsigned char*>(data));
+}
+
+//----------------------------------------------------------------------------
+bool vtkNRRDReader::DecompressDataBlocks(size_t firstBlock, size_t lastBlock, unsigned char* data)
+{
+  if (lastBlock < firstBlock || lastBlock >= this->CompressedBlockSizes.size())
+    {
+    return false;
+    }
+
+  BlockDecompressionData blockData;
+  vtkTypeInt64 compressedOffset = 0;
+  for (std::vector<vtkTypeInt64>::iterator it = this->CompressedBlockSizes.begin();
+    it != this->CompressedBlockSizes.end(); ++it)
+    {
+    blockData.CompressedOffsets.push_back(static_cast<size_t>(compressedOffset));
+    compressedOffset += *it;
+    }
+  blockData.CompressedOffsets.push_back(static_cast<size_t>(compressedOffset));
+  // compressedOffset is now the size of all the compressed blocks
+
+  // The compressed blocks are at the end of the file, right after the header.
+  // Only the requested blocks are read.
+  std::ifstream file(this->GetFileName(), std::ios::in | std::ios::binary);
+  if (!file)
+    {
+    return false;
+    }
+  file.seekg(0, std::ios::end);
+  vtkTypeInt64 fileSize = static_cast<vtkTypeInt64>(file.tellg());
+  if (fileSize < compressedOffset)
+    {
+    return false;
+    }
+  size_t compressedStart = blockData.CompressedOffsets[firstBlock];
+  size_t compressedSize = blockData.CompressedOffsets[lastBlock + 1] - compressedStart;
+  std::vector<char> compressedData(compressedSize);
+  file.seekg(fileSize - compressedOffset + static_cast<vtkTypeInt64>(compressedStart), std::ios::beg);
+  file.read(&compressedData[0], compressedSize);
+  if (!file)
+    {
+    return false;
+    }
+
+  blockData.CompressedData = reinterpret_cast<unsigned char*>(&compressedData[0]);
+  blockData.Data = data;
+  blockData.DataSize = nrrdElementNumber(this->nrrd) * nrrdElementSize(this->nrrd);
+  blockData.BlockSize = static_cast<size_t>(this->CompressionBlockSize);
+  blockData.FirstBlock = firstBlock;
+  size_t numberOfBlocks = lastBlock - firstBlock + 1;
+  blockData.BlockStatus.resize(numberOfBlocks, 0);
+
+  int numberOfThreads = this->NumberOfThreads > 0 ? this->NumberOfThreads
+    : vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  numberOfThreads = std::min(numberOfThreads, static_cast<int>(VTK_MAX_THREADS));
+  if (static_cast<size_t>(numberOfThreads) > numberOfBlocks)
+    {
+    numberOfThreads = static_cast<int>(numberOfBlocks);
+    }
+  numberOfThreads = std::max(numberOfThreads, 1);
+
+  vtkNew<vtkMultiThreader> threader;
+  threader->SetNumberOfThreads(numberOfThreads);
+  threader->SetSingleMethod(DecompressBlocksThreadFunction, &blockData);
+  threader->SingleMethodExecute();
+
+  if (std::find(blockData.BlockStatus.begin(), blockData.BlockStatus.end(), 0) != blockData.BlockStatus.end())
+    {
+    vtkDebugMacro("DecompressDataBlocks: block decompression failed, reading the file instead");
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkNRRDReader::ReadMappedData(vtkImageData* imageData, vtkInformation* outInfo)
+{
+  // Make sure information is up-to-date (same as in AllocateOutputData)
+  this->ExecuteInformation();
+  if (this->MappableDataFileName.empty() || this->DataType == VTK_VOID)
+    {
+    return false;
+    }
+
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  memcpy(extent, this->GetUpdateExtent(), sizeof(extent));
+  vtkIdType numberOfTuples = vtkIdType(extent[1] - extent[0] + 1)
+    * vtkIdType(extent[3] - extent[2] + 1) * vtkIdType(extent[5] - extent[4] + 1);
+  vtkIdType numberOfValues = numberOfTuples * this->GetNumberOfComponents();
+  size_t dataSize = nrrdElementNumber(this->nrrd) * nrrdElementSize(this->nrrd);
+  if (numberOfValues <= 0 || static_cast<size_t>(numberOfValues) * nrrdElementSize(this->nrrd) != dataSize)
+    {
+    // only the whole image can be mapped
+    return false;
+    }
+
+  vtkSmartPointer<vtkDataArray> pd = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(this->DataType));
+  vtkNew<vtkNRRDMappedData> mappedData;
+  if (!pd || pd->GetDataTypeSize() != static_cast<int>(nrrdElementSize(this->nrrd))
+    || !mappedData->Open(this->MappableDataFileName.c_str(), this->MappableDataFileOffset, dataSize))
+    {
+    vtkDebugMacro("ReadMappedData: cannot map " << this->MappableDataFileName << ", reading the file instead");
+    return false;
+    }
+  pd->SetNumberOfComponents(this->GetNumberOfComponents());
+  // The array must not free the mapped memory, the mapping is released when the array information is deleted
+  pd->SetVoidArray(mappedData->GetData(), numberOfValues, 1);
+  pd->GetInformation()->Set(vtkNRRDReader::MAPPED_DATA(), mappedData.GetPointer());
+  pd->SetName("NRRDImage");
+
+  imageData->SetExtent(extent);
+  switch (this->PointDataType)
+    {
+    case vtkDataSetAttributes::SCALARS:
+      imageData->GetPointData()->SetScalars(pd);
+      vtkDataObject::SetPointDataActiveScalarInfo(outInfo, this->DataType, this->GetNumberOfComponents());
+      break;
+    case vtkDataSetAttributes::VECTORS:
+      imageData->GetPointData()->SetVectors(pd);
+      break;
+    case vtkDataSetAttributes::NORMALS:
+      imageData->GetPointData()->SetNormals(pd);
+      break;
+    case vtkDataSetAttributes::TENSORS:
+      imageData->GetPointData()->SetTensors(pd);
+      break;
+    default:
+      vtkErrorMacro("Unknown PointData Type.");
+      return false;
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 vtkImageData *vtkNRRDReader::AllocateOutputData(vtkDataObject *out, vtkInformation* outInfo)
 {
@@ -899,28 +1554,19 @@ void vtkNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInforma
         vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
     }
 
-  vtkImageData *imageData = this->AllocateOutputData(output, outInfo);
-
   if (this->GetFileName() == NULL)
     {
     vtkErrorMacro(<< "Either a FileName or FilePrefix must be specified.");
     return;
     }
 
-  // Read in the this->nrrd.  Yes, this means that the header is being read
-  // twice: once by ExecuteInformation, and once here
-  if ( nrrdLoad(this->nrrd, this->GetFileName(), NULL) != 0 )
+  if (this->UseMemoryMapping && vtkImageData::SafeDownCast(output)
+    && this->ReadMappedData(vtkImageData::SafeDownCast(output), outInfo))
     {
-    char *err =  biffGetDone(NRRD); // would be nice to free(err)
-    vtkErrorMacro("Read: Error reading " << this->GetFileName() << ":\n" << err);
     return;
     }
 
-  if (this->nrrd->data == NULL)
-    {
-    vtkErrorMacro(<< "data is null.");
-    return;
-    }
+  vtkImageData *imageData = this->AllocateOutputData(output, outInfo);
 
   void *ptr = NULL;
   switch(this->PointDataType)
@@ -946,6 +1592,40 @@ void vtkNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInforma
     }
   this->ComputeDataIncrements();
 
+  // Only the part of the file that contains the region of interest is read if possible
+  if (ptr && this->IsReadingRegion()
+    && (this->ReadRawDataRegion(ptr) || this->ReadCompressedDataRegion(ptr)))
+    {
+    return;
+    }
+
+  // Data compressed by vtkNRRDWriter in independent blocks is decompressed in parallel.
+  // The data layout has already been checked, no conversion is needed after reading.
+  if (ptr && !this->CompressedBlockSizes.empty())
+    {
+    vtkDataArray* dataArray = vtkDataArray::SafeDownCast(imageData->GetPointData()->GetAbstractArray("NRRDImage"));
+    size_t dataSize = dataArray ? static_cast<size_t>(dataArray->GetNumberOfValues()) * dataArray->GetDataTypeSize() : 0;
+    if (this->ReadCompressedDataBlocks(ptr, dataSize))
+      {
+      return;
+      }
+    }
+
+  // Read in the this->nrrd.  Yes, this means that the header is being read
+  // twice: once by ExecuteInformation, and once here
+  if ( nrrdLoad(this->nrrd, this->GetFileName(), NULL) != 0 )
+    {
+    char *err =  biffGetDone(NRRD); // would be nice to free(err)
+    vtkErrorMacro("Read: Error reading " << this->GetFileName() << ":\n" << err);
+    return;
+    }
+
+  if (this->nrrd->data == NULL)
+    {
+    vtkErrorMacro(<< "data is null.");
+    return;
+    }
+
   unsigned int rangeAxisIdx[NRRD_DIM_MAX] = { 0 };
   unsigned int rangeAxisNum = nrrdRangeAxesGet(this->nrrd, rangeAxisIdx);
   if (rangeAxisNum > 1)
@@ -1083,7 +1763,15 @@ void vtkNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInforma
     // be called here if it existed.
     }
 
-  if (ptr)
+  if (ptr && this->IsReadingRegion())
+    {
+    size_t numberOfVoxels = static_cast<size_t>(this->FileExtent[1] - this->FileExtent[0] + 1)
+      * (this->FileExtent[3] - this->FileExtent[2] + 1) * (this->FileExtent[5] - this->FileExtent[4] + 1);
+    size_t voxelSize = nrrdElementSize(this->nrrd) * nrrdElementNumber(this->nrrd) / numberOfVoxels;
+    CopyRegion(static_cast<unsigned char*>(this->nrrd->data), 0, this->FileExtent, this->DataExtent,
+      voxelSize, static_cast<unsigned char*>(ptr));
+    }
+  else if (ptr)
     {
     memcpy(ptr, this->nrrd->data, nrrdElementSize(this->nrrd)*nrrdElementNumber(this->nrrd));
     }
@@ -1096,4 +1784,9 @@ void vtkNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInforma
 void vtkNRRDReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "UseMemoryMapping: " << (this->UseMemoryMapping ? "true" : "false") << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "ReadExtent: " << this->ReadExtent[0] << " " << this->ReadExtent[1] << " "
+     << this->ReadExtent[2] << " " << this->ReadExtent[3] << " "
+     << this->ReadExtent[4] << " " << this->ReadExtent[5] << "\n";
 }
@@ -31,6 +31,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <iostream>
 
 #include "vtkTeemConfigure.h"
@@ -46,6 +47,8 @@
 
 #include "teem/nrrd.h"
 
+class vtkInformationObjectBaseKey;
+
 /// \brief Reads Nearly Raw Raster Data files.
 ///
 /// Reads Nearly Raw Raster Data files using the nrrdio library as used in ITK
@@ -142,6 +145,40 @@ public:
     UseNativeOrigin = false;
   }
 
+  ///
+  /// Map the data file into memory instead of reading it (default: off).
+  /// Only raw encoded, detached header NRRD files that store the voxels in the
+  /// layout and byte order of vtkImageData are mapped, other files are read.
+  /// Pages of the file are only loaded when they are accessed and modified pages
+  /// are private copies, so the file is never changed. The data file must not be
+  /// overwritten while the image data exists.
+  vtkSetMacro(UseMemoryMapping, bool);
+  vtkGetMacro(UseMemoryMapping, bool);
+  vtkBooleanMacro(UseMemoryMapping, bool);
+
+  ///
+  /// Maximum number of threads used for decompressing data that vtkNRRDWriter
+  /// compressed in independent blocks (other files are read by a single thread).
+  /// 0 (default) uses vtkMultiThreader global default number of threads.
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
+  ///
+  /// Region of interest: only the voxels of this extent are read.
+  /// The output extent is the intersection of ReadExtent with the extent of
+  /// the image, voxel indices (and RasToIjkMatrix) are the same as when the
+  /// whole image is read. Raw encoded files and data compressed by
+  /// vtkNRRDWriter in blocks are only read where the region is, other files
+  /// are read completely then cropped.
+  /// An empty extent (default: 0, -1, 0, -1, 0, -1) reads the whole image.
+  vtkSetVector6Macro(ReadExtent, int);
+  vtkGetVector6Macro(ReadExtent, int);
+
+  ///
+  /// Key of the data array information that keeps the memory mapped data file
+  /// open while the array exists.
+  static vtkInformationObjectBaseKey* MAPPED_DATA();
+
   int NrrdToVTKScalarType( const int nrrdPixelType ) const
   {
   switch( nrrdPixelType )
@@ -237,6 +274,33 @@ protected:
 
   static bool GetPointType(Nrrd* nrrdTemp, int& pointDataType, int &numOfComponents);
 
+  /// Store the data file name and offset if the voxels can be used directly from the file
+  void UpdateMappableDataFile(NrrdIoState* nio);
+  /// Use the memory mapped data file as point data of the output.
+  /// Returns false if the file cannot be mapped.
+  bool ReadMappedData(vtkImageData* imageData, vtkInformation* outInfo);
+  /// Returns true if the voxels are stored in the file in the layout and byte order of vtkImageData
+  bool HasVTKDataLayout(NrrdIoState* nio);
+  /// Store the block sizes if the data was compressed by vtkNRRDWriter in independent blocks
+  void UpdateCompressedDataBlocks(NrrdIoState* nio);
+  /// Decompress the blocks in parallel into the data buffer.
+  /// Returns false if the data is not compressed in blocks or decompression fails.
+  bool ReadCompressedDataBlocks(void* data, size_t dataSize);
+  /// Decompress the blocks [firstBlock, lastBlock] in parallel, \a data
+  /// points to the first voxel of \a firstBlock.
+  bool DecompressDataBlocks(size_t firstBlock, size_t lastBlock, unsigned char* data);
+  /// Returns true if only a region of the image is read
+  /// \sa ReadExtent
+  bool IsReadingRegion();
+  /// Store the data file name and offset if the region can be read directly from the file
+  void UpdateRawDataFile(NrrdIoState* nio);
+  /// Read the voxels of the region from the raw data file.
+  /// Returns false if the data is not raw or cannot be read.
+  bool ReadRawDataRegion(void* data);
+  /// Decompress the blocks that contain the voxels of the region.
+  /// Returns false if the data is not compressed in blocks or decompression fails.
+  bool ReadCompressedDataRegion(void* data);
+
   vtkSmartPointer<vtkMatrix4x4> RasToIjkMatrix;
   vtkSmartPointer<vtkMatrix4x4> MeasurementFrameMatrix;
   vtkSmartPointer<vtkMatrix4x4> NRRDWorldToRasMatrix;
@@ -251,6 +315,20 @@ protected:
   int DataType;
   int NumberOfComponents;
   bool UseNativeOrigin;
+  bool UseMemoryMapping;
+  /// Data file that can be memory mapped (empty if the data has to be read)
+  std::string MappableDataFileName;
+  vtkTypeInt64 MappableDataFileOffset;
+  int NumberOfThreads;
+  /// Uncompressed and compressed sizes of the gzip blocks (empty if the data is not compressed in blocks)
+  vtkTypeInt64 CompressionBlockSize;
+  std::vector<vtkTypeInt64> CompressedBlockSizes;
+  /// Raw data file the region is read from (empty if the whole file has to be read)
+  std::string RawDataFileName;
+  vtkTypeInt64 RawDataFileOffset;
+  int ReadExtent[6];
+  /// Extent of the whole image in the file
+  int FileExtent[6];
 
   std::map <std::string, std::string> HeaderKeyValue;
   std::string HeaderKeys; // buffer for returning key list
@@ -7,11 +7,74 @@
 #include "vtkPointData.h"
 #include "vtkObjectFactory.h"
 #include "vtkInformation.h"
+#include <vtkMultiThreader.h>
+#include <vtkNew.h>
 #include <vtkVersion.h>
+#include <vtk_zlib.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
 
 class AttributeMapType: public std::map<std::string, std::string> {};
 class AxisInfoMapType : public std::map<unsigned int, std::string> {};
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+struct BlockCompressionData
+{
+  const unsigned char* Buffer;
+  size_t DataSize;
+  size_t BlockSize;
+  int CompressionLevel;
+  std::vector<std::string>* CompressedBlocks;
+  std::vector<int> BlockStatus;
+};
+
+//----------------------------------------------------------------------------
+/// Compress a block into a complete gzip member
+bool CompressBlock(const unsigned char* data, size_t size, int level, std::string& compressed)
+{
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  // 15 + 16 window bits: maximum window size with gzip header and trailer
+  if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+    return false;
+    }
+  compressed.resize(deflateBound(&stream, static_cast<uLong>(size)));
+  stream.next_in = const_cast<Bytef*>(data);
+  stream.avail_in = static_cast<uInt>(size);
+  stream.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+  stream.avail_out = static_cast<uInt>(compressed.size());
+  int status = deflate(&stream, Z_FINISH);
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  return status == Z_STREAM_END;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE CompressBlocksThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  BlockCompressionData* data = static_cast<BlockCompressionData*>(info->UserData);
+  size_t numberOfBlocks = data->CompressedBlocks->size();
+  for (size_t block = info->ThreadID; block < numberOfBlocks; block += info->NumberOfThreads)
+    {
+    size_t blockStart = block * data->BlockSize;
+    size_t blockSize = std::min(data->BlockSize, data->DataSize - blockStart);
+    data->BlockStatus[block] = CompressBlock(data->Buffer + blockStart, blockSize,
+      data->CompressionLevel, (*data->CompressedBlocks)[block]) ? 1 : 0;
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+} // end of anonymous namespace
+
 vtkStandardNewMacro(vtkNRRDWriter);
 
 //----------------------------------------------------------------------------
@@ -23,6 +86,9 @@ vtkNRRDWriter::vtkNRRDWriter()
   this->IJKToRASMatrix = vtkMatrix4x4::New();
   this->MeasurementFrameMatrix = vtkMatrix4x4::New();
   this->UseCompression = 1;
+  this->CompressionLevel = -1;
+  this->CompressionBlockSize = 4 * 1024 * 1024;
+  this->NumberOfThreads = 0;
   this->DiffusionWeigthedData = 0;
   this->FileType = VTK_BINARY;
   this->WriteErrorOff();
@@ -364,6 +430,37 @@ void vtkNRRDWriter::WriteData()
 
   // set endianness as unknown of output
   nio->endian = airEndianUnknown;
+  nio->zlibLevel = this->CompressionLevel;
+
+  // Block index of a previously read file must not be written for different data
+  nrrdKeyValueErase(nrrd, vtkNRRDWriter::GetCompressionBlockSizeKey());
+  nrrdKeyValueErase(nrrd, vtkNRRDWriter::GetCompressedBlockSizesKey());
+
+  // Compress large attached data in parallel, detached data files are written by teem
+  std::vector<std::string> compressedBlocks;
+  size_t dataSize = nrrdElementNumber(nrrd) * nrrdElementSize(nrrd);
+  bool useBlockCompression = (nio->encoding == nrrdEncodingGzip
+    && this->CompressionBlockSize > 0
+    && dataSize > static_cast<size_t>(this->CompressionBlockSize)
+    && !vtksys::SystemTools::StringEndsWith(this->GetFileName(), ".nhdr"));
+  if (useBlockCompression)
+    {
+    useBlockCompression = this->CompressDataBlocks(buffer, dataSize, compressedBlocks);
+    }
+  if (useBlockCompression)
+    {
+    std::stringstream blockSizeStr;
+    blockSizeStr << this->CompressionBlockSize;
+    std::stringstream compressedBlockSizesStr;
+    for (size_t block = 0; block < compressedBlocks.size(); ++block)
+      {
+      compressedBlockSizesStr << (block > 0 ? " " : "") << compressedBlocks[block].size();
+      }
+    nrrdKeyValueAdd(nrrd, vtkNRRDWriter::GetCompressionBlockSizeKey(), blockSizeStr.str().c_str());
+    nrrdKeyValueAdd(nrrd, vtkNRRDWriter::GetCompressedBlockSizesKey(), compressedBlockSizesStr.str().c_str());
+    // teem only writes the header, the data is appended after it
+    nio->skipData = 1;
+    }
 
   // Write the nrrd to file.
   if (nrrdSave(this->GetFileName(), nrrd, nio))
@@ -373,16 +470,87 @@ void vtkNRRDWriter::WriteData()
                       << this->GetFileName() << ":\n" << err);
     this->WriteErrorOn();
     }
+  else if (useBlockCompression && !this->AppendCompressedDataBlocks(compressedBlocks))
+    {
+    vtkErrorMacro("Write: Error writing compressed data to " << this->GetFileName());
+    this->WriteErrorOn();
+    }
   // Free the nrrd struct but don't touch nrrd->data
   nrrd = nrrdNix(nrrd);
   nio = nrrdIoStateNix(nio);
   return;
 }
 
+//----------------------------------------------------------------------------
+bool vtkNRRDWriter::CompressDataBlocks(const void* buffer, size_t dataSize, std::vector<std::string>& compressedBlocks)
+{
+  size_t blockSize = static_cast<size_t>(this->CompressionBlockSize);
+  size_t numberOfBlocks = (dataSize + blockSize - 1) / blockSize;
+  compressedBlocks.clear();
+  compressedBlocks.resize(numberOfBlocks);
+
+  BlockCompressionData data;
+  data.Buffer = static_cast<const unsigned char*>(buffer);
+  data.DataSize = dataSize;
+  data.BlockSize = blockSize;
+  data.CompressionLevel = this->CompressionLevel;
+  data.CompressedBlocks = &compressedBlocks;
+  data.BlockStatus.resize(numberOfBlocks, 0);
+
+  int numberOfThreads = this->NumberOfThreads > 0 ? this->NumberOfThreads
+    : vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  numberOfThreads = std::min(numberOfThreads, static_cast<int>(VTK_MAX_THREADS));
+  if (static_cast<size_t>(numberOfThreads) > numberOfBlocks)
+    {
+    numberOfThreads = static_cast<int>(numberOfBlocks);
+    }
+  numberOfThreads = std::max(numberOfThreads, 1);
+
+  vtkNew<vtkMultiThreader> threader;
+  threader->SetNumberOfThreads(numberOfThreads);
+  threader->SetSingleMethod(CompressBlocksThreadFunction, &data);
+  threader->SingleMethodExecute();
+
+  if (std::find(data.BlockStatus.begin(), data.BlockStatus.end(), 0) != data.BlockStatus.end())
+    {
+    vtkWarningMacro("CompressDataBlocks: block compression failed, writing the data in a single block");
+    compressedBlocks.clear();
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkNRRDWriter::AppendCompressedDataBlocks(const std::vector<std::string>& compressedBlocks)
+{
+  FILE* file = fopen(this->GetFileName(), "ab");
+  if (!file)
+    {
+    return false;
+    }
+  bool success = true;
+  for (std::vector<std::string>::const_iterator blockIt = compressedBlocks.begin();
+    blockIt != compressedBlocks.end() && success; ++blockIt)
+    {
+    success = (fwrite(blockIt->data(), 1, blockIt->size(), file) == blockIt->size());
+    }
+  if (fclose(file) != 0)
+    {
+    success = false;
+    }
+  return success;
+}
+
+//----------------------------------------------------------------------------
 void vtkNRRDWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
 
+  os << indent << "UseCompression: " << this->UseCompression << "\n";
+  os << indent << "CompressionLevel: " << this->CompressionLevel << "\n";
+  os << indent << "CompressionBlockSize: " << this->CompressionBlockSize << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+
   os << indent << "RAS to IJK Matrix: ";
      this->IJKToRASMatrix->PrintSelf(os,indent);
   os << indent << "Measurement frame: ";
@@ -11,6 +11,10 @@
 
 #include "vtkTeemConfigure.h"
 
+// STD includes
+#include <string>
+#include <vector>
+
 class vtkImageData;
 class AttributeMapType;
 class AxisInfoMapType;
@@ -55,6 +59,33 @@ public:
   vtkGetMacro(UseCompression,int);
   vtkBooleanMacro(UseCompression,int);
 
+  ///
+  /// zlib compression level, from 0 (no compression) to 9 (smallest file).
+  /// The default (-1) uses the zlib default level.
+  vtkSetClampMacro(CompressionLevel,int,-1,9);
+  vtkGetMacro(CompressionLevel,int);
+
+  ///
+  /// Size of the blocks (in bytes) that are gzip compressed independently and in parallel.
+  /// The compressed blocks are written as consecutive gzip members, which is a
+  /// valid gzip stream that can be read by any NRRD reader. The block sizes are
+  /// stored in the header so that vtkNRRDReader can decompress the blocks in parallel.
+  /// Blocks are only used for attached header (.nrrd) files larger than one block.
+  /// 0 disables block compression. Default is 4 MiB.
+  vtkSetMacro(CompressionBlockSize,vtkIdType);
+  vtkGetMacro(CompressionBlockSize,vtkIdType);
+
+  ///
+  /// Maximum number of threads used for compression.
+  /// 0 (default) uses vtkMultiThreader global default number of threads.
+  vtkSetClampMacro(NumberOfThreads,int,0,VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads,int);
+
+  /// Header field that stores the uncompressed size of the compressed blocks.
+  static const char* GetCompressionBlockSizeKey() { return "NRRD_gzip_block_size"; }
+  /// Header field that stores the compressed size of each block.
+  static const char* GetCompressedBlockSizesKey() { return "NRRD_gzip_compressed_block_sizes"; }
+
   vtkSetClampMacro(FileType,int,VTK_ASCII,VTK_BINARY);
   vtkGetMacro(FileType,int);
   void SetFileTypeToASCII() {this->SetFileType(VTK_ASCII);};
@@ -84,6 +115,13 @@ protected:
   /// Write method. It is called by vtkWriter::Write();
   void WriteData();
 
+  ///
+  /// Compress the data in blocks using multiple threads and append the
+  /// compressed blocks to the file after the header has been written.
+  /// Returns false if block compression cannot be used for this file.
+  bool CompressDataBlocks(const void* buffer, size_t dataSize, std::vector<std::string>& compressedBlocks);
+  bool AppendCompressedDataBlocks(const std::vector<std::string>& compressedBlocks);
+
   ///
   /// Flag to set to on when a write error occured
   int WriteError;
@@ -97,6 +135,9 @@ protected:
   vtkMatrix4x4* MeasurementFrameMatrix;
 
   int UseCompression;
+  int CompressionLevel;
+  vtkIdType CompressionBlockSize;
+  int NumberOfThreads;
   int FileType;
 
   AttributeMapType *Attributes;
@@ -11,12 +11,18 @@ command line processing and additional features have been added.
 
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
-#include "itkHessianToObjectnessMeasureImageFilter.h"
-#include "itkMultiScaleHessianBasedMeasureImageFilter.h"
+#include "itkMultiThreader.h"
+#include "itkSmoothingRecursiveGaussianImageFilter.h"
+#include "itkSymmetricEigenAnalysis.h"
+#include "itkSymmetricSecondRankTensor.h"
 
 #include "BlobDetectionCLP.h"
 #include "itkPluginUtilities.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 // Use an anonymous namespace to keep class types and function names
 // from colliding when module is used as shared object module.  Every
 // thing should be in an anonymous namespace except for the module
@@ -25,6 +31,157 @@ command line processing and additional features have been added.
 namespace
 {
 
+typedef itk::Image<float, 3>                     FloatImageType;
+typedef itk::SymmetricSecondRankTensor<double, 3> HessianType;
+typedef itk::FixedArray<double, 3>               EigenValuesType;
+typedef itk::SymmetricEigenAnalysis<HessianType, EigenValuesType> EigenAnalysisType;
+
+// Blobness of the voxels of one level of the scale space. The Hessian is
+// computed by finite differences on the smoothed volume and normalized
+// across scales, the measure is the one of HessianToObjectnessMeasureImageFilter
+// with an object dimension of 0 (beta is not used for blobs). The output
+// keeps the maximum over the levels.
+struct ScaleLevel
+{
+  const FloatImageType* Smoothed;
+  FloatImageType*       Output;
+  double                Sigma;
+  bool                  FirstLevel;
+  bool                  BrightObject;
+  double                Alpha;
+  double                Gamma;
+};
+
+double Blobness(const ScaleLevel& level, const HessianType& hessian)
+{
+  // The largest eigenvalue is larger than the diagonal values and the
+  // smallest one smaller, which rejects most voxels before their eigenvalues
+  // are computed.
+  for( unsigned int d = 0; d < 3; ++d )
+    {
+    if( (level.BrightObject && hessian(d, d) > 0.0) || (!level.BrightObject && hessian(d, d) < 0.0) )
+      {
+      return 0.0;
+      }
+    }
+
+  EigenAnalysisType eigenAnalysis;
+  eigenAnalysis.SetDimension( 3 );
+  eigenAnalysis.SetOrderEigenMagnitudes( true );
+  EigenValuesType eigenValues;
+  eigenAnalysis.ComputeEigenValues( hessian, eigenValues );
+  for( unsigned int d = 0; d < 3; ++d )
+    {
+    if( (level.BrightObject && eigenValues[d] > 0.0) || (!level.BrightObject && eigenValues[d] < 0.0) )
+      {
+      return 0.0;
+      }
+    }
+
+  double blobness = 1.0;
+  double denominator = std::fabs( eigenValues[1] * eigenValues[2] );
+  if( denominator <= 0.0 )
+    {
+    return 0.0;
+    }
+  if( std::fabs( level.Alpha ) > 0.0 )
+    {
+    double rA = std::fabs( eigenValues[0] ) / std::sqrt( denominator );
+    blobness *= 1.0 - std::exp( -0.5 * rA * rA / ( level.Alpha * level.Alpha ) );
+    }
+  if( std::fabs( level.Gamma ) > 0.0 )
+    {
+    double frobeniusNormSquared = 0.0;
+    for( unsigned int d = 0; d < 3; ++d )
+      {
+      frobeniusNormSquared += eigenValues[d] * eigenValues[d];
+      }
+    blobness *= 1.0 - std::exp( -0.5 * frobeniusNormSquared / ( level.Gamma * level.Gamma ) );
+    }
+  return blobness;
+}
+
+// Each thread processes a slab of slices. The neighbors are clamped at the
+// boundaries of the volume.
+ITK_THREAD_RETURN_TYPE ScaleLevelThreadFunction(void* arg)
+{
+  itk::MultiThreader::ThreadInfoStruct* info = static_cast<itk::MultiThreader::ThreadInfoStruct*>(arg);
+  const ScaleLevel& level = *static_cast<ScaleLevel*>(info->UserData);
+
+  const FloatImageType::SizeType size = level.Smoothed->GetBufferedRegion().GetSize();
+  const FloatImageType::SpacingType spacing = level.Smoothed->GetSpacing();
+  const float* smoothed = level.Smoothed->GetBufferPointer();
+  float* output = level.Output->GetBufferPointer();
+  const itk::OffsetValueType stride[3] = {
+    1,
+    static_cast<itk::OffsetValueType>( size[0] ),
+    static_cast<itk::OffsetValueType>( size[0] * size[1] ) };
+  // Second derivatives are scaled by sigma^2 to be comparable across scales.
+  const double normalization = level.Sigma * level.Sigma;
+
+  const itk::SizeValueType firstSlice = size[2] * info->ThreadID / info->NumberOfThreads;
+  const itk::SizeValueType lastSlice = size[2] * ( info->ThreadID + 1 ) / info->NumberOfThreads;
+  itk::SizeValueType index[3];
+  for( index[2] = firstSlice; index[2] < lastSlice; ++index[2] )
+    {
+    for( index[1] = 0; index[1] < size[1]; ++index[1] )
+      {
+      itk::OffsetValueType v = stride[2] * index[2] + stride[1] * index[1];
+      for( index[0] = 0; index[0] < size[0]; ++index[0], ++v )
+        {
+        itk::OffsetValueType previous[3];
+        itk::OffsetValueType next[3];
+        for( unsigned int d = 0; d < 3; ++d )
+          {
+          previous[d] = index[d] > 0 ? -stride[d] : 0;
+          next[d] = index[d] + 1 < size[d] ? stride[d] : 0;
+          }
+        const float* center = smoothed + v;
+        HessianType hessian;
+        for( unsigned int d = 0; d < 3; ++d )
+          {
+          hessian(d, d) = normalization * ( center[next[d]] - 2.0 * center[0] + center[previous[d]] )
+            / ( spacing[d] * spacing[d] );
+          for( unsigned int e = d + 1; e < 3; ++e )
+            {
+            if( next[d] == previous[d] || next[e] == previous[e] )
+              {
+              hessian(d, e) = 0.0;
+              continue;
+              }
+            double distance = ( ( next[d] - previous[d] ) / stride[d] ) * spacing[d]
+              * ( ( next[e] - previous[e] ) / stride[e] ) * spacing[e];
+            hessian(d, e) = normalization * ( center[next[d] + next[e]] - center[next[d] + previous[e]]
+                                              - center[previous[d] + next[e]] + center[previous[d] + previous[e]] )
+              / distance;
+            }
+          }
+        float blobness = static_cast<float>( Blobness( level, hessian ) );
+        if( level.FirstLevel || blobness > output[v] )
+          {
+          output[v] = blobness;
+          }
+        }
+      }
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template <class TImage>
+FloatImageType::Pointer Smooth(const TImage* image, double sigma, ModuleProcessInformation* processInformation,
+                               double fraction, double start)
+{
+  typedef itk::SmoothingRecursiveGaussianImageFilter<TImage, FloatImageType> SmoothingFilterType;
+  typename SmoothingFilterType::Pointer smoothingFilter = SmoothingFilterType::New();
+  itk::PluginFilterWatcher watchFilter(smoothingFilter, "Processing", processInformation, fraction, start);
+  smoothingFilter->SetInput( image );
+  smoothingFilter->SetSigma( sigma );
+  smoothingFilter->Update();
+  FloatImageType::Pointer smoothed = smoothingFilter->GetOutput();
+  smoothed->DisconnectPipeline();
+  return smoothed;
+}
+
 template <class Tin>
 int DoIt( int argc, char * argv[])
 {
@@ -33,35 +190,17 @@ int DoIt( int argc, char * argv[])
   typedef Tin     InputPixelType;
 
   typedef itk::Image<InputPixelType, 3>                           InputImageType;
-  typedef itk::Image<float, 3>                                    OutputImageType;
+  typedef FloatImageType                                          OutputImageType;
 
   typedef itk::ImageFileReader<InputImageType>                    ReaderType;
   typedef itk::ImageFileWriter<OutputImageType>                   WriterType;
 
-  typename InputImageType::Pointer image;
-  typename ReaderType::Pointer  reader = ReaderType::New();
-
-  typedef itk::SymmetricSecondRankTensor<float, 3>                HessianPixelType;
-  typedef itk::Image<HessianPixelType, 3>                         HessianImageType;
-  typedef itk::HessianToObjectnessMeasureImageFilter<HessianImageType, OutputImageType> ObjectnessFilterType;
-  typedef itk::MultiScaleHessianBasedMeasureImageFilter<InputImageType, HessianImageType, OutputImageType>  MultiScaleEnhancementFilterType;
-
   typename ReaderType::Pointer reader1 = ReaderType::New();
   itk::PluginFilterWatcher watchReader1(reader1, "Read Volume", CLPProcessInformation);
 
   reader1->SetFileName( InputVolume.c_str() );
   reader1->Update();
 
-  typename ObjectnessFilterType::Pointer objectnessFilter =
-      ObjectnessFilterType::New();
-
-  objectnessFilter->SetScaleObjectnessMeasure(false);
-  objectnessFilter->SetBrightObject(DetectBrightObjects);
-  objectnessFilter->SetAlpha(alpha < 0.0 ? 0.5 : alpha);
-  objectnessFilter->SetBeta(beta < 0.0 ? 0.5 : beta);
-  objectnessFilter->SetGamma(gamma < 0.0 ? 5.0 : gamma);
-  objectnessFilter->SetObjectDimension(0);
-
   typename InputImageType::SpacingType spacing = reader1->GetOutput()->GetSpacing();
 
   float sx = spacing[0];
@@ -81,23 +220,70 @@ int DoIt( int argc, char * argv[])
 
   autoSteps = autoSteps < 1 ? 1 : autoSteps;
 
-  typename MultiScaleEnhancementFilterType::Pointer multiScaleEnhancementFilter =
-      MultiScaleEnhancementFilterType::New();
-  itk::PluginFilterWatcher watchFilter(multiScaleEnhancementFilter,   "Processing", CLPProcessInformation);
+  // Logarithmic sigma steps, as MultiScaleHessianBasedMeasureImageFilter.
+  double sigmaMinimum = minScale;
+  double sigmaMaximum = scale < minScale ? minScale : scale;
+  int numberOfSigmaSteps = steps <= 0 ? autoSteps : steps;
+  std::vector<double> sigmas;
+  for( int s = 0; s < numberOfSigmaSteps; ++s )
+    {
+    if( numberOfSigmaSteps < 2 )
+      {
+      sigmas.push_back( sigmaMinimum );
+      break;
+      }
+    double stepSize = std::max( 1e-10, ( std::log( sigmaMaximum ) - std::log( sigmaMinimum ) ) / ( numberOfSigmaSteps - 1 ) );
+    sigmas.push_back( std::exp( std::log( sigmaMinimum ) + stepSize * s ) );
+    }
+
+  OutputImageType::Pointer output = OutputImageType::New();
+  output->CopyInformation( reader1->GetOutput() );
+  output->SetRegions( reader1->GetOutput()->GetLargestPossibleRegion() );
+  output->Allocate();
+
+  ScaleLevel level;
+  level.Output = output;
+  level.BrightObject = DetectBrightObjects;
+  level.Alpha = alpha < 0.0 ? 0.5 : alpha;
+  level.Gamma = gamma < 0.0 ? 5.0 : gamma;
+  // Beta only weighs line-like and plate-like objects.
+  (void)beta;
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads( std::min( threader->GetNumberOfThreads(),
+                                          static_cast<itk::ThreadIdType>( output->GetLargestPossibleRegion().GetSize()[2] ) ) );
+
+  // Each level of the scale space is smoothed from the previous one by the
+  // difference of the variances rather than from the input volume, so that
+  // the smoothing of a level costs the same as the smoothing of the first.
+  FloatImageType::Pointer smoothed;
+  for( size_t s = 0; s < sigmas.size(); ++s )
+    {
+    double fraction = 1.0 / sigmas.size();
+    if( s == 0 )
+      {
+      smoothed = Smooth( reader1->GetOutput(), sigmas[0], CLPProcessInformation, fraction, 0.0 );
+      reader1->GetOutput()->ReleaseData();
+      }
+    else if( sigmas[s] > sigmas[s - 1] )
+      {
+      smoothed = Smooth( smoothed.GetPointer(), std::sqrt( sigmas[s] * sigmas[s] - sigmas[s - 1] * sigmas[s - 1] ),
+                         CLPProcessInformation, fraction, fraction * s );
+      }
 
-  multiScaleEnhancementFilter->SetInput(reader1->GetOutput());
-  multiScaleEnhancementFilter->SetSigmaMinimum(minScale);
-  multiScaleEnhancementFilter->SetSigmaMaximum(scale < minScale ? minScale : scale);
-  multiScaleEnhancementFilter->SetNumberOfSigmaSteps(steps <= 0 ? autoSteps : steps);
-  multiScaleEnhancementFilter->SetGenerateScalesOutput(false);
-  multiScaleEnhancementFilter->SetHessianToMeasureFilter(objectnessFilter);
+    level.Smoothed = smoothed;
+    level.Sigma = sigmas[s];
+    level.FirstLevel = ( s == 0 );
+    threader->SetSingleMethod( ScaleLevelThreadFunction, &level );
+    threader->SingleMethodExecute();
+    }
 
   typename WriterType::Pointer writer = WriterType::New();
   itk::PluginFilterWatcher watchWriter(writer,
                                        "Write Volume",
                                        CLPProcessInformation);
   writer->SetFileName( OutputVolume.c_str() );
-  writer->SetInput( multiScaleEnhancementFilter->GetOutput() );
+  writer->SetInput( output );
   writer->Update();
 
   return EXIT_SUCCESS;
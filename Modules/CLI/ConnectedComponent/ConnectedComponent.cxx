@@ -11,11 +11,15 @@ command line processing and additional features have been added.
 
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
-#include "itkConnectedComponentImageFilter.h"
+#include "itkMultiThreader.h"
 
 #include "ConnectedComponentCLP.h"
 #include "itkPluginUtilities.h"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 // Use an anonymous namespace to keep class types and function names
 // from colliding when module is used as shared object module.  Every
 // thing should be in an anonymous namespace except for the module
@@ -24,44 +28,445 @@ command line processing and additional features have been added.
 namespace
 {
 
-template <class Tin>
-int DoIt( int argc, char * argv[])
+typedef itk::ImageBase<3> ImageBaseType;
+
+// Offset to a neighbor that precedes a voxel in raster order.
+struct NeighborOffset
 {
-  PARSE_ARGS;
+  int I;
+  int J;
+  int K;
+  itk::OffsetValueType Step;
+};
 
-  typedef Tin     InputPixelType;
+/** Multithreaded labeling of the connected components of the nonzero voxels.
+ *
+ * The volume is split in slabs of slices, one per thread. Each thread builds
+ * the union-find trees of the voxels of its slab. The parent of a voxel is
+ * stored in the Parents array, in place of a provisional label, and a root is
+ * always attached to the root with the lowest index: the root of a component
+ * is its first voxel in raster order. The trees are then merged across the
+ * slab boundaries and the components are numbered in the order of their
+ * roots, which gives the same labels as itk::ConnectedComponentImageFilter.
+ *
+ * TIndex holds voxel indices: 32 bits are enough for volumes of less than 4G
+ * voxels and take half the memory of itk::SizeValueType.
+ */
+template <class TIndex>
+class ComponentLabeling
+{
+public:
+  ComponentLabeling(const itk::Size<3>& size, bool fullyConnected, itk::ThreadIdType numberOfThreads)
+  {
+    for( unsigned int d = 0; d < 3; ++d )
+      {
+      this->Size[d] = size[d];
+      }
+    this->Parents.resize( size[0] * size[1] * size[2] );
 
-  typedef itk::Image<InputPixelType, 3>                        InputImageType;
+    // Backward neighbors: all the voxels of the 3x3x3 neighborhood that come
+    // first in raster order, or only the face neighbors.
+    for( int k = -1; k <= 0; ++k )
+      {
+      for( int j = -1; j <= 1; ++j )
+        {
+        for( int i = -1; i <= 1; ++i )
+          {
+          if( (k == 0 && j > 0) || (k == 0 && j == 0 && i >= 0) )
+            {
+            continue;
+            }
+          if( !fullyConnected && (i != 0) + (j != 0) + (k != 0) > 1 )
+            {
+            continue;
+            }
+          NeighborOffset offset;
+          offset.I = i;
+          offset.J = j;
+          offset.K = k;
+          offset.Step = i + static_cast<itk::OffsetValueType>( size[0] )
+            * ( j + static_cast<itk::OffsetValueType>( size[1] ) * k );
+          this->Neighbors.push_back( offset );
+          }
+        }
+      }
 
-  typedef itk::ImageFileReader<InputImageType>                    ReaderType;
-  typedef itk::ImageFileWriter<InputImageType>                    WriterType;
+    itk::SizeValueType numberOfSlabs = std::max( std::min( static_cast<itk::SizeValueType>( numberOfThreads ), this->Size[2] ),
+                                                 static_cast<itk::SizeValueType>( 1 ) );
+    for( itk::SizeValueType t = 0; t <= numberOfSlabs; ++t )
+      {
+      this->FirstSlices.push_back( this->Size[2] * t / numberOfSlabs );
+      }
+    this->NumberOfRoots.resize( numberOfSlabs, 0 );
+    this->FirstLabels.resize( numberOfSlabs, 0 );
+  }
 
-  typename InputImageType::Pointer image;
-  typename ReaderType::Pointer  reader = ReaderType::New();
+  /// Build the trees of the foreground voxels of \a input, merge them and
+  /// count the components. \a input is not accessed afterward.
+  template <class TInput>
+  void Label(const TInput* input)
+  {
+    SlabPass<TInput> pass;
+    pass.Labeling = this;
+    pass.Input = input;
+    this->Execute( &SlabPass<TInput>::LabelSlab, &pass );
 
-  typedef itk::ConnectedComponentImageFilter<InputImageType, InputImageType>  FilterType;
+    this->MergeSlabs();
 
-  typename ReaderType::Pointer reader1 = ReaderType::New();
-  itk::PluginFilterWatcher watchReader1(reader1, "Read Volume", CLPProcessInformation);
+    this->Execute( &ComponentLabeling::CountRootsThreadFunction, this );
+    itk::SizeValueType label = 0;
+    for( size_t t = 0; t < this->NumberOfRoots.size(); ++t )
+      {
+      this->FirstLabels[t] = label;
+      label += this->NumberOfRoots[t];
+      }
+    this->NumberOfComponents = label;
+  }
 
-  reader1->SetFileName( InputVolume.c_str() );
+  itk::SizeValueType GetNumberOfComponents() const
+  {
+    return this->NumberOfComponents;
+  }
+
+  /// Write the consecutive labels of the components in \a output, 0 in the
+  /// background. TOutput must hold GetNumberOfComponents().
+  template <class TOutput>
+  void Relabel(TOutput* output)
+  {
+    RelabelPass<TOutput> pass;
+    pass.Labeling = this;
+    pass.Output = output;
+    // The roots are labeled first: the other voxels of a component find
+    // their label at its root, which can be in the slab of another thread.
+    this->Execute( &RelabelPass<TOutput>::LabelRoots, &pass );
+    this->Execute( &RelabelPass<TOutput>::LabelVoxels, &pass );
+  }
+
+protected:
+  template <class TInput>
+  struct SlabPass
+  {
+    ComponentLabeling* Labeling;
+    const TInput*      Input;
+
+    static ITK_THREAD_RETURN_TYPE LabelSlab(void* arg)
+    {
+      itk::MultiThreader::ThreadInfoStruct* info = static_cast<itk::MultiThreader::ThreadInfoStruct*>(arg);
+      SlabPass* pass = static_cast<SlabPass*>(info->UserData);
+      pass->Labeling->LabelSlab( pass->Input, info->ThreadID );
+      return ITK_THREAD_RETURN_VALUE;
+    }
+  };
+
+  template <class TOutput>
+  struct RelabelPass
+  {
+    ComponentLabeling* Labeling;
+    TOutput*           Output;
+
+    static ITK_THREAD_RETURN_TYPE LabelRoots(void* arg)
+    {
+      itk::MultiThreader::ThreadInfoStruct* info = static_cast<itk::MultiThreader::ThreadInfoStruct*>(arg);
+      RelabelPass* pass = static_cast<RelabelPass*>(info->UserData);
+      ComponentLabeling* labeling = pass->Labeling;
+      TIndex first, last;
+      labeling->GetSlabVoxels( info->ThreadID, first, last );
+      TOutput label = static_cast<TOutput>( labeling->FirstLabels[info->ThreadID] );
+      for( TIndex v = first; v < last; ++v )
+        {
+        if( labeling->Parents[v] == v + 1 )
+          {
+          pass->Output[v] = ++label;
+          }
+        }
+      return ITK_THREAD_RETURN_VALUE;
+    }
 
-  typename FilterType::Pointer filter = FilterType::New();
-  itk::PluginFilterWatcher watchFilter(filter,   "Processing", CLPProcessInformation);
+    static ITK_THREAD_RETURN_TYPE LabelVoxels(void* arg)
+    {
+      itk::MultiThreader::ThreadInfoStruct* info = static_cast<itk::MultiThreader::ThreadInfoStruct*>(arg);
+      RelabelPass* pass = static_cast<RelabelPass*>(info->UserData);
+      const std::vector<TIndex>& parents = pass->Labeling->Parents;
+      TIndex first, last;
+      pass->Labeling->GetSlabVoxels( info->ThreadID, first, last );
+      for( TIndex v = first; v < last; ++v )
+        {
+        if( parents[v] == 0 )
+          {
+          pass->Output[v] = 0;
+          continue;
+          }
+        // The parent of a voxel is the root of its slab tree, whose parent is
+        // the root of the component once the slabs are merged.
+        TIndex root = parents[parents[v] - 1] - 1;
+        if( root != v )
+          {
+          pass->Output[v] = pass->Output[root];
+          }
+        }
+      return ITK_THREAD_RETURN_VALUE;
+    }
+  };
+
+  void Execute(itk::ThreadFunctionType function, void* data)
+  {
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    threader->SetNumberOfThreads( static_cast<itk::ThreadIdType>( this->NumberOfRoots.size() ) );
+    threader->SetSingleMethod( function, data );
+    threader->SingleMethodExecute();
+  }
 
-  filter->SetInput(reader1->GetOutput());
+  void GetSlabVoxels(itk::ThreadIdType slab, TIndex& first, TIndex& last) const
+  {
+    const itk::SizeValueType sliceSize = this->Size[0] * this->Size[1];
+    first = static_cast<TIndex>( this->FirstSlices[slab] * sliceSize );
+    last = static_cast<TIndex>( this->FirstSlices[slab + 1] * sliceSize );
+  }
+
+  TIndex FindRoot(TIndex voxel)
+  {
+    TIndex root = voxel;
+    while( this->Parents[root] - 1 != root )
+      {
+      root = this->Parents[root] - 1;
+      }
+    while( voxel != root )
+      {
+      TIndex parent = this->Parents[voxel] - 1;
+      this->Parents[voxel] = root + 1;
+      voxel = parent;
+      }
+    return root;
+  }
+
+  /// Merge the trees of two voxels. Return false when they are in the same
+  /// tree already, otherwise \a attachedRoot is set to the root that was
+  /// attached to the other.
+  bool Merge(TIndex voxel, TIndex neighbor, TIndex& attachedRoot)
+  {
+    TIndex root = this->FindRoot( voxel );
+    TIndex neighborRoot = this->FindRoot( neighbor );
+    if( root == neighborRoot )
+      {
+      return false;
+      }
+    if( root < neighborRoot )
+      {
+      std::swap( root, neighborRoot );
+      }
+    this->Parents[root] = neighborRoot + 1;
+    attachedRoot = root;
+    return true;
+  }
+
+  template <class TInput>
+  void LabelSlab(const TInput* input, itk::ThreadIdType slab)
+  {
+    const itk::SizeValueType firstSlice = this->FirstSlices[slab];
+    const itk::SizeValueType lastSlice = this->FirstSlices[slab + 1];
+    TIndex v = static_cast<TIndex>( firstSlice * this->Size[0] * this->Size[1] );
+    for( itk::SizeValueType k = firstSlice; k < lastSlice; ++k )
+      {
+      for( itk::SizeValueType j = 0; j < this->Size[1]; ++j )
+        {
+        for( itk::SizeValueType i = 0; i < this->Size[0]; ++i, ++v )
+          {
+          if( input[v] == 0 )
+            {
+            this->Parents[v] = 0;
+            continue;
+            }
+          this->Parents[v] = v + 1;
+          TIndex attached;
+          for( size_t n = 0; n < this->Neighbors.size(); ++n )
+            {
+            const NeighborOffset& offset = this->Neighbors[n];
+            if( (offset.K < 0 && k == firstSlice)
+                || (offset.J < 0 && j == 0) || (offset.J > 0 && j + 1 == this->Size[1])
+                || (offset.I < 0 && i == 0) || (offset.I > 0 && i + 1 == this->Size[0]) )
+              {
+              continue;
+              }
+            TIndex neighbor = static_cast<TIndex>( v + offset.Step );
+            if( this->Parents[neighbor] != 0 )
+              {
+              this->Merge( v, neighbor, attached );
+              }
+            }
+          }
+        }
+      }
+
+    // Point all the voxels to the root of their tree. Parents come first in
+    // raster order so they already point to the root.
+    TIndex first, last;
+    this->GetSlabVoxels( slab, first, last );
+    for( v = first; v < last; ++v )
+      {
+      if( this->Parents[v] != 0 && this->Parents[v] != v + 1 )
+        {
+        this->Parents[v] = this->Parents[this->Parents[v] - 1];
+        }
+      }
+  }
+
+  // Merge the trees across the first slice of each slab and the last slice
+  // of the previous one. Only the roots of the slab trees are modified.
+  void MergeSlabs()
+  {
+    std::vector<TIndex> attachedRoots;
+    const itk::SizeValueType sliceSize = this->Size[0] * this->Size[1];
+    for( size_t slab = 1; slab + 1 < this->FirstSlices.size(); ++slab )
+      {
+      const itk::SizeValueType k = this->FirstSlices[slab];
+      TIndex v = static_cast<TIndex>( k * sliceSize );
+      for( itk::SizeValueType j = 0; j < this->Size[1]; ++j )
+        {
+        for( itk::SizeValueType i = 0; i < this->Size[0]; ++i, ++v )
+          {
+          if( this->Parents[v] == 0 )
+            {
+            continue;
+            }
+          for( size_t n = 0; n < this->Neighbors.size(); ++n )
+            {
+            const NeighborOffset& offset = this->Neighbors[n];
+            if( offset.K == 0
+                || (offset.J < 0 && j == 0) || (offset.J > 0 && j + 1 == this->Size[1])
+                || (offset.I < 0 && i == 0) || (offset.I > 0 && i + 1 == this->Size[0]) )
+              {
+              continue;
+              }
+            TIndex neighbor = static_cast<TIndex>( v + offset.Step );
+            TIndex attached;
+            if( this->Parents[neighbor] != 0 && this->Merge( v, neighbor, attached ) )
+              {
+              attachedRoots.push_back( attached );
+              }
+            }
+          }
+        }
+      }
+    // Point the attached roots to the root of their component.
+    for( size_t r = 0; r < attachedRoots.size(); ++r )
+      {
+      this->FindRoot( attachedRoots[r] );
+      }
+  }
+
+  static ITK_THREAD_RETURN_TYPE CountRootsThreadFunction(void* arg)
+  {
+    itk::MultiThreader::ThreadInfoStruct* info = static_cast<itk::MultiThreader::ThreadInfoStruct*>(arg);
+    ComponentLabeling* labeling = static_cast<ComponentLabeling*>(info->UserData);
+    TIndex first, last;
+    labeling->GetSlabVoxels( info->ThreadID, first, last );
+    itk::SizeValueType numberOfRoots = 0;
+    for( TIndex v = first; v < last; ++v )
+      {
+      if( labeling->Parents[v] == v + 1 )
+        {
+        ++numberOfRoots;
+        }
+      }
+    labeling->NumberOfRoots[info->ThreadID] = numberOfRoots;
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+  itk::SizeValueType               Size[3];
+  /// 1 + the index of the parent of each foreground voxel, 0 in the background.
+  std::vector<TIndex>              Parents;
+  std::vector<NeighborOffset>      Neighbors;
+  std::vector<itk::SizeValueType>  FirstSlices;
+  std::vector<itk::SizeValueType>  NumberOfRoots;
+  std::vector<itk::SizeValueType>  FirstLabels;
+  itk::SizeValueType               NumberOfComponents;
+};
+
+template <class TIndex, class TOutput>
+int WriteLabels(ComponentLabeling<TIndex>& labeling, const ImageBaseType* reference,
+                const std::string& fileName, ModuleProcessInformation* processInformation)
+{
+  typedef itk::Image<TOutput, 3>              OutputImageType;
+  typedef itk::ImageFileWriter<OutputImageType> WriterType;
+
+  typename OutputImageType::Pointer output = OutputImageType::New();
+  output->CopyInformation( reference );
+  output->SetRegions( reference->GetLargestPossibleRegion() );
+  output->Allocate();
+  labeling.Relabel( output->GetBufferPointer() );
 
   typename WriterType::Pointer writer = WriterType::New();
   itk::PluginFilterWatcher watchWriter(writer,
                                        "Write Volume",
-                                       CLPProcessInformation);
-  writer->SetFileName( OutputVolume.c_str() );
-  writer->SetInput( filter->GetOutput() );
+                                       processInformation);
+  writer->SetFileName( fileName.c_str() );
+  writer->SetInput( output );
   writer->Update();
 
   return EXIT_SUCCESS;
 }
 
+template <class TInput, class TIndex>
+int LabelComponents(itk::Image<TInput, 3>* input, bool fullyConnected,
+                    const std::string& fileName, ModuleProcessInformation* processInformation)
+{
+  ImageBaseType::Pointer reference = ImageBaseType::New();
+  reference->CopyInformation( input );
+  reference->SetLargestPossibleRegion( input->GetLargestPossibleRegion() );
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  ComponentLabeling<TIndex> labeling( input->GetLargestPossibleRegion().GetSize(),
+                                      fullyConnected, threader->GetNumberOfThreads() );
+  labeling.Label( input->GetBufferPointer() );
+  input->ReleaseData();
+
+  // The labels are written with the pixel type of the input volume, or the
+  // smallest unsigned type that holds all the components.
+  itk::SizeValueType numberOfComponents = labeling.GetNumberOfComponents();
+  if( numberOfComponents <= static_cast<itk::SizeValueType>( std::numeric_limits<TInput>::max() ) )
+    {
+    return WriteLabels<TIndex, TInput>( labeling, reference, fileName, processInformation );
+    }
+  std::cout << numberOfComponents << " components do not fit in the input pixel type,"
+            << " the output pixel type is promoted." << std::endl;
+  if( numberOfComponents <= std::numeric_limits<unsigned short>::max() )
+    {
+    return WriteLabels<TIndex, unsigned short>( labeling, reference, fileName, processInformation );
+    }
+  if( numberOfComponents <= std::numeric_limits<unsigned int>::max() )
+    {
+    return WriteLabels<TIndex, unsigned int>( labeling, reference, fileName, processInformation );
+    }
+  return WriteLabels<TIndex, itk::SizeValueType>( labeling, reference, fileName, processInformation );
+}
+
+template <class Tin>
+int DoIt( int argc, char * argv[])
+{
+  PARSE_ARGS;
+
+  typedef Tin     InputPixelType;
+
+  typedef itk::Image<InputPixelType, 3>                        InputImageType;
+
+  typedef itk::ImageFileReader<InputImageType>                    ReaderType;
+
+  typename ReaderType::Pointer reader1 = ReaderType::New();
+  itk::PluginFilterWatcher watchReader1(reader1, "Read Volume", CLPProcessInformation);
+
+  reader1->SetFileName( InputVolume.c_str() );
+  reader1->Update();
+
+  InputImageType* input = reader1->GetOutput();
+  if( input->GetLargestPossibleRegion().GetNumberOfPixels() < std::numeric_limits<unsigned int>::max() )
+    {
+    return LabelComponents<InputPixelType, unsigned int>( input, fullyConnected,
+                                                          OutputVolume, CLPProcessInformation );
+    }
+  return LabelComponents<InputPixelType, itk::SizeValueType>( input, fullyConnected,
+                                                              OutputVolume, CLPProcessInformation );
+}
+
 } // end of anonymous namespace
 
 int main( int argc, char* argv[] )
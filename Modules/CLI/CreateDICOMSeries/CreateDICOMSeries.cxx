@@ -15,6 +15,10 @@ command line processing and additional features have been added.
 #include "itkShiftScaleImageFilter.h"
 #include "itkGDCMImageIO.h"
 #include "itkMetaDataObject.h"
+#include "itkMultiThreader.h"
+#include "itkMutexLock.h"
+
+#include "gdcmUIDGenerator.h"
 
 #include "CreateDICOMSeriesCLP.h"
 
@@ -26,6 +30,201 @@ command line processing and additional features have been added.
 namespace
 {
 
+// Slices are written by a pool of threads, each thread takes the next slice
+// to write. The slices are extracted under the lock (the pipeline of the
+// volume is shared), the encoding and the writing of the files happen
+// concurrently, with one writer and one GDCMImageIO per thread.
+template <class TPixel>
+class SliceWriterPass
+{
+public:
+  typedef itk::Image<TPixel, 3>                     Image3DType;
+  typedef itk::Image<TPixel, 2>                     Image2DType;
+  typedef itk::ImageFileWriter<Image2DType>         WriterType;
+  typedef itk::GDCMImageIO                          ImageIOType;
+  typedef itk::ExtractImageFilter<Image3DType, Image2DType> ExtractType;
+
+  typename Image3DType::Pointer Image;
+  // Tags shared by all the slices, including the study and series UIDs
+  itk::MetaDataDictionary SeriesDictionary;
+  // Preallocated SOP instance UIDs and file names, one per slice
+  std::vector<std::string> InstanceUIDs;
+  std::vector<std::string> FileNames;
+  bool ReverseImages;
+  bool UseCompression;
+
+  std::vector<typename WriterType::Pointer>  Writers;
+  std::vector<typename ImageIOType::Pointer> ImageIOs;
+
+  itk::MutexLock::Pointer Lock;
+  unsigned int            NextSlice;
+  unsigned int            NumberOfWrittenSlices;
+  bool                    Failed;
+
+  SliceWriterPass()
+    : ReverseImages(false), UseCompression(false),
+      NextSlice(0), NumberOfWrittenSlices(0), Failed(false)
+  {
+    this->Lock = itk::MutexLock::New();
+  }
+
+  unsigned int GetNumberOfSlices() const
+  {
+    return static_cast<unsigned int>(this->FileNames.size() );
+  }
+
+  static ITK_THREAD_RETURN_TYPE ThreadFunction(void* arg)
+  {
+    itk::MultiThreader::ThreadInfoStruct* info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+    SliceWriterPass* pass = static_cast<SliceWriterPass *>(info->UserData);
+    while( true )
+      {
+      unsigned int slice;
+      typename Image2DType::Pointer sliceImage;
+      itk::MetaDataDictionary dictionary;
+      pass->Lock->Lock();
+      slice = pass->NextSlice++;
+      if( pass->Failed || slice >= pass->GetNumberOfSlices() )
+        {
+        pass->Lock->Unlock();
+        break;
+        }
+      try
+        {
+        sliceImage = pass->ExtractSlice(slice);
+        }
+      catch( itk::ExceptionObject & excp )
+        {
+        std::cerr << "Exception thrown while extracting the slice " << slice << std::endl;
+        std::cerr << excp << std::endl;
+        pass->Failed = true;
+        pass->Lock->Unlock();
+        break;
+        }
+      dictionary = pass->SeriesDictionary;
+      pass->Lock->Unlock();
+
+      bool written = pass->WriteSlice(info->ThreadID, slice, sliceImage, dictionary);
+
+      pass->Lock->Lock();
+      if( written )
+        {
+        pass->NumberOfWrittenSlices++;
+        std::cout << "<filter-progress>"
+                  << static_cast<float>(pass->NumberOfWrittenSlices) / pass->GetNumberOfSlices()
+                  << "</filter-progress>"
+                  << std::endl
+                  << std::flush;
+        }
+      else
+        {
+        pass->Failed = true;
+        }
+      pass->Lock->Unlock();
+      }
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+  typename Image2DType::Pointer ExtractSlice(unsigned int i)
+  {
+    unsigned int numberOfSlices = this->GetNumberOfSlices();
+    typename Image3DType::RegionType extractRegion;
+    typename Image3DType::SizeType   extractSize;
+    typename Image3DType::IndexType  extractIndex;
+    extractSize = this->Image->GetLargestPossibleRegion().GetSize();
+    extractIndex.Fill(0);
+    if( this->ReverseImages )
+      {
+      extractIndex[2] = numberOfSlices - i - 1;
+      }
+    else
+      {
+      extractIndex[2] = i;
+      }
+    extractSize[2] = 0;
+    extractRegion.SetSize(extractSize);
+    extractRegion.SetIndex(extractIndex);
+
+    typename ExtractType::Pointer extract = ExtractType::New();
+    extract->SetDirectionCollapseToGuess();  // ITKv3 compatible, but not recommended
+    extract->SetNumberOfThreads(1);
+    extract->SetInput(this->Image );
+    extract->SetExtractionRegion(extractRegion);
+    extract->Update();
+
+    typename Image2DType::Pointer sliceImage = extract->GetOutput();
+    sliceImage->DisconnectPipeline();
+    return sliceImage;
+  }
+
+  bool WriteSlice(int threadId, unsigned int i, Image2DType* sliceImage, itk::MetaDataDictionary & dictionary)
+  {
+    typename Image3DType::PointType    origin;
+    typename Image3DType::IndexType    index;
+    index.Fill(0);
+    index[2] = i;
+    this->Image->TransformIndexToPhysicalPoint(index, origin);
+
+    std::ostringstream value;
+    value.str("");
+    value << origin[0] << "\\" << origin[1] << "\\" << origin[2];
+    itk::EncapsulateMetaData<std::string>(dictionary, "0020|0032", value.str() );
+
+    value.str("");
+    value << i + 1;
+    itk::EncapsulateMetaData<std::string>(dictionary, "0020|0013", value.str() );
+
+    itk::EncapsulateMetaData<std::string>(dictionary, "0008|0018", this->InstanceUIDs[i] ); // SOP Instance UID
+    itk::EncapsulateMetaData<std::string>(dictionary, "0002|0003", this->InstanceUIDs[i] ); // Media Storage SOP
+                                                                                         // Instance UID
+
+    itk::ImageRegionIterator<Image2DType> it( sliceImage, sliceImage->GetLargestPossibleRegion() );
+    typename Image2DType::PixelType                minValue = itk::NumericTraits<typename Image2DType::PixelType>::max();
+    typename Image2DType::PixelType                maxValue = itk::NumericTraits<typename Image2DType::PixelType>::min();
+    for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      typename Image2DType::PixelType p = it.Get();
+      if( p > maxValue )
+        {
+        maxValue = p;
+        }
+      if( p < minValue )
+        {
+        minValue = p;
+        }
+      }
+    typename Image2DType::PixelType windowCenter = (minValue + maxValue) / 2;
+    typename Image2DType::PixelType windowWidth = (maxValue - minValue);
+
+    value.str("");
+    value << windowCenter;
+    itk::EncapsulateMetaData<std::string>(dictionary, "0028|1050", value.str() );
+    value.str("");
+    value << windowWidth;
+    itk::EncapsulateMetaData<std::string>(dictionary, "0028|1051", value.str() );
+    sliceImage->SetMetaDataDictionary(dictionary);
+
+    WriterType* writer = this->Writers[threadId];
+    writer->SetFileName(this->FileNames[i].c_str() );
+    writer->SetInput(sliceImage );
+    writer->SetUseCompression(this->UseCompression);
+    try
+      {
+      writer->SetImageIO(this->ImageIOs[threadId]);
+      writer->Update();
+      }
+    catch( itk::ExceptionObject & excp )
+      {
+      this->Lock->Lock();
+      std::cerr << "Exception thrown while writing the file " << this->FileNames[i] << std::endl;
+      std::cerr << excp << std::endl;
+      this->Lock->Unlock();
+      return false;
+      }
+    return true;
+  }
+};
+
 template <class Tin>
 int DoIt( int argc, char * argv[])
 {
@@ -86,10 +285,165 @@ int DoIt( int argc, char * argv[])
     }
 
   typedef itk::MetaDataDictionary DictionaryType;
+  typedef SliceWriterPass<InputPixelType> PassType;
   unsigned int numberOfSlices = image->GetLargestPossibleRegion().GetSize()[2];
 
-  typename ImageIOType::Pointer gdcmIO = ImageIOType::New();
   DictionaryType       dictionary;
+  std::ostringstream value;
+
+  // Set all required DICOM fields
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0008", std::string("ORIGINAL\\PRIMARY\\AXIAL") );  // Image
+                                                                                                             // Type
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0016", std::string("1.2.840.10008.5.1.4.1.1.2") ); // SOP
+                                                                                                             // Class
+                                                                                                             // UID
+  itk::EncapsulateMetaData<std::string>(dictionary, "0010|0030", std::string("20060101") );                  //
+                                                                                                             // Patient's
+                                                                                                             // Birthdate
+  itk::EncapsulateMetaData<std::string>(dictionary, "0010|0032", std::string("010100.000000") );             //
+                                                                                                             // Patient's
+                                                                                                             // Birth
+                                                                                                             // Time
+  itk::EncapsulateMetaData<std::string>(dictionary, "0010|0040", std::string("M") );                         //
+                                                                                                             // Patient's
+                                                                                                             // Sex
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0020", std::string("20050101") );                  // Study
+                                                                                                             // Date
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0030", std::string("010100.000000") );             // Study
+                                                                                                             // Time
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0050", std::string("1") );                         //
+                                                                                                             // Accession
+                                                                                                             // Number
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0090", std::string("Unknown") );                   //
+                                                                                                             // Referring
+                                                                                                             // Physician's
+                                                                                                             // Name
+  itk::EncapsulateMetaData<std::string>(dictionary, "0018|5100", std::string("HFS") );                       //
+                                                                                                             // Patient
+                                                                                                             // Position
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|1040", std::string("SN") );                        //
+                                                                                                             // Position
+                                                                                                             // Reference
+                                                                                                             // Indicator
+  // itk::EncapsulateMetaData<std::string>(dictionary,"0020|0037",
+  // std::string("1.000000\\0.000000\\0.000000\\0.000000\\1.000000\\0.000000")); // Image Orientation (Patient)
+  value.str("");
+  value << oMatrix[0][0] << "\\" << oMatrix[1][0] << "\\" << oMatrix[2][0] << "\\";
+  value << oMatrix[0][1] << "\\" << oMatrix[1][1] << "\\" << oMatrix[2][1];
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0037", value.str() ); // Image Orientation (Patient)
+  value.str("");
+  value << spacing[2];
+  itk::EncapsulateMetaData<std::string>(dictionary, "0018|0050", value.str() ); // Slice Thickness
+
+  // Parameters from the command line
+  if( patientName.size() > 0 )
+    {
+    itk::EncapsulateMetaData<std::string>(dictionary, "0010|0010", patientName);
+    }
+  if( patientID.size() > 0 )
+    {
+    itk::EncapsulateMetaData<std::string>(dictionary, "0010|0020", patientID);
+    }
+  if( patientComments.size() > 0 )
+    {
+    itk::EncapsulateMetaData<std::string>(dictionary, "0010|4000", patientComments);
+    }
+  if( studyID.size() > 0 )
+    {
+    itk::EncapsulateMetaData<std::string>(dictionary, "0020|0010", studyID);
+    }
+  if( studyDate.size() > 0 )
+    {
+    itk::EncapsulateMetaData<std::string>(dictionary, "0008|0020", studyDate);
+    }
+  if( studyComments.size() > 0 )
+    {
+    itk::EncapsulateMetaData<std::string>(dictionary, "0032|4000", studyComments);
+    }
+  if( studyDescription.size() > 0 )
+    {
+    itk::EncapsulateMetaData<std::string>(dictionary, "0008|1030", studyDescription);
+    }
+  if( modality.size() > 0 )
+    {
+    itk::EncapsulateMetaData<std::string>(dictionary, "0008|0060", modality);
+    }
+  if( manufacturer.size() > 0 )
+    {
+    itk::EncapsulateMetaData<std::string>(dictionary, "0008|0070", manufacturer);
+    }
+  if( model.size() > 0 )
+    {
+    itk::EncapsulateMetaData<std::string>(dictionary, "0008|1090", model);
+    }
+  if( seriesNumber.size() > 0 )
+    {
+    itk::EncapsulateMetaData<std::string>(dictionary, "0020|0011", seriesNumber);
+    }
+  if( seriesDescription.size() > 0 )
+    {
+    itk::EncapsulateMetaData<std::string>(dictionary, "0008|103e", seriesDescription);
+    }
+
+  // Always set the rescale interscept and rescale slope (even if
+  // they are at their defaults of 0 and 1 respectively).
+  // value.str("");
+  // value << rescaleIntercept;
+  // itk::EncapsulateMetaData<std::string>(dictionary, "0028|1052", value.str());
+  // value.str("");
+  // value << rescaleSlope;
+  // itk::EncapsulateMetaData<std::string>(dictionary, "0028|1053", value.str());
+
+
+  // The UIDs are allocated before writing so that the slices written by
+  // different threads belong to the same study and series.
+  typename ImageIOType::Pointer gdcmIO = ImageIOType::New();
+  gdcm::UIDGenerator uidGenerator;
+  uidGenerator.SetRoot(gdcmIO->GetUIDPrefix().c_str() );
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|000d", std::string(uidGenerator.Generate() ) ); // Study
+                                                                                                       // Instance
+                                                                                                       // UID
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|000e", std::string(uidGenerator.Generate() ) ); // Series
+                                                                                                       // Instance
+                                                                                                       // UID
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0052", std::string(uidGenerator.Generate() ) ); // Frame of
+                                                                                                       // Reference
+                                                                                                       // UID
+
+  PassType pass;
+  pass.Image = image;
+  pass.SeriesDictionary = dictionary;
+  pass.ReverseImages = reverseImages;
+  pass.UseCompression = useCompression;
+  for( unsigned int i = 0; i < numberOfSlices; i++ )
+    {
+    pass.InstanceUIDs.push_back(uidGenerator.Generate() );
+
+    char                imageNumber[BUFSIZ];
+#if WIN32
+#define snprintf sprintf_s
+#endif
+    snprintf(imageNumber, BUFSIZ, dicomNumberFormat.c_str(), i + 1);
+    value.str("");
+    value << dicomDirectory << "/" << dicomPrefix << imageNumber << ".dcm";
+    pass.FileNames.push_back(value.str() );
+    }
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  int numberOfThreads = threader->GetNumberOfThreads();
+  if( static_cast<unsigned int>(numberOfThreads) > numberOfSlices )
+    {
+    numberOfThreads = numberOfSlices > 0 ? numberOfSlices : 1;
+    threader->SetNumberOfThreads(numberOfThreads);
+    }
+  for( int t = 0; t < numberOfThreads; ++t )
+    {
+    typename ImageIOType::Pointer threadIO = ImageIOType::New();
+    // the UIDs come from the dictionary
+    threadIO->KeepOriginalUIDOn();
+    pass.ImageIOs.push_back(threadIO);
+    pass.Writers.push_back(WriterType::New() );
+    }
 
   // Progress
   std::cout << "<filter-start>"
@@ -105,206 +459,12 @@ int DoIt( int argc, char * argv[])
   std::cout << "</filter-start>"
             << std::endl;
   std::cout << std::flush;
-  float progress = 1.0 / (float) numberOfSlices;
-  for( unsigned int i = 0; i < numberOfSlices; i++ )
-    {
-    std::cout << "<filter-progress>"
-              << (i + 1) * progress
-              << "</filter-progress>"
-              << std::endl
-              << std::flush;
-
-    typename Image3DType::PointType    origin;
-    typename Image3DType::IndexType    index;
-    index.Fill(0);
-    index[2] = i;
-    image->TransformIndexToPhysicalPoint(index, origin);
-
-    std::ostringstream value;
-    // Set all required DICOM fields
-    value.str("");
-    value << origin[0] << "\\" << origin[1] << "\\" << origin[2];
-    itk::EncapsulateMetaData<std::string>(dictionary, "0020|0032", value.str() );
-
-    value.str("");
-    value << i + 1;
-    itk::EncapsulateMetaData<std::string>(dictionary, "0020|0013", value.str() );
 
-    itk::EncapsulateMetaData<std::string>(dictionary, "0008|0008", std::string("ORIGINAL\\PRIMARY\\AXIAL") );  // Image
-                                                                                                               // Type
-    itk::EncapsulateMetaData<std::string>(dictionary, "0008|0016", std::string("1.2.840.10008.5.1.4.1.1.2") ); // SOP
-                                                                                                               // Class
-                                                                                                               // UID
-    itk::EncapsulateMetaData<std::string>(dictionary, "0010|0030", std::string("20060101") );                  //
-                                                                                                               // Patient's
-                                                                                                               // Birthdate
-    itk::EncapsulateMetaData<std::string>(dictionary, "0010|0032", std::string("010100.000000") );             //
-                                                                                                               // Patient's
-                                                                                                               // Birth
-                                                                                                               // Time
-    itk::EncapsulateMetaData<std::string>(dictionary, "0010|0040", std::string("M") );                         //
-                                                                                                               // Patient's
-                                                                                                               // Sex
-    itk::EncapsulateMetaData<std::string>(dictionary, "0008|0020", std::string("20050101") );                  // Study
-                                                                                                               // Date
-    itk::EncapsulateMetaData<std::string>(dictionary, "0008|0030", std::string("010100.000000") );             // Study
-                                                                                                               // Time
-    itk::EncapsulateMetaData<std::string>(dictionary, "0008|0050", std::string("1") );                         //
-                                                                                                               // Accession
-                                                                                                               // Number
-    itk::EncapsulateMetaData<std::string>(dictionary, "0008|0090", std::string("Unknown") );                   //
-                                                                                                               // Referring
-                                                                                                               // Physician's
-                                                                                                               // Name
-    itk::EncapsulateMetaData<std::string>(dictionary, "0018|5100", std::string("HFS") );                       //
-                                                                                                               // Patient
-                                                                                                               // Position
-    itk::EncapsulateMetaData<std::string>(dictionary, "0020|1040", std::string("SN") );                        //
-                                                                                                               // Position
-                                                                                                               // Reference
-                                                                                                               // Indicator
-    // itk::EncapsulateMetaData<std::string>(dictionary,"0020|0037",
-    // std::string("1.000000\\0.000000\\0.000000\\0.000000\\1.000000\\0.000000")); // Image Orientation (Patient)
-    value.str("");
-    value << oMatrix[0][0] << "\\" << oMatrix[1][0] << "\\" << oMatrix[2][0] << "\\";
-    value << oMatrix[0][1] << "\\" << oMatrix[1][1] << "\\" << oMatrix[2][1];
-    itk::EncapsulateMetaData<std::string>(dictionary, "0020|0037", value.str() ); // Image Orientation (Patient)
-    value.str("");
-    value << spacing[2];
-    itk::EncapsulateMetaData<std::string>(dictionary, "0018|0050", value.str() ); // Slice Thickness
-
-    // Parameters from the command line
-    if( patientName.size() > 0 )
-      {
-      itk::EncapsulateMetaData<std::string>(dictionary, "0010|0010", patientName);
-      }
-    if( patientID.size() > 0 )
-      {
-      itk::EncapsulateMetaData<std::string>(dictionary, "0010|0020", patientID);
-      }
-    if( patientComments.size() > 0 )
-      {
-      itk::EncapsulateMetaData<std::string>(dictionary, "0010|4000", patientComments);
-      }
-    if( studyID.size() > 0 )
-      {
-      itk::EncapsulateMetaData<std::string>(dictionary, "0020|0010", studyID);
-      }
-    if( studyDate.size() > 0 )
-      {
-      itk::EncapsulateMetaData<std::string>(dictionary, "0008|0020", studyDate);
-      }
-    if( studyComments.size() > 0 )
-      {
-      itk::EncapsulateMetaData<std::string>(dictionary, "0032|4000", studyComments);
-      }
-    if( studyDescription.size() > 0 )
-      {
-      itk::EncapsulateMetaData<std::string>(dictionary, "0008|1030", studyDescription);
-      }
-    if( modality.size() > 0 )
-      {
-      itk::EncapsulateMetaData<std::string>(dictionary, "0008|0060", modality);
-      }
-    if( manufacturer.size() > 0 )
-      {
-      itk::EncapsulateMetaData<std::string>(dictionary, "0008|0070", manufacturer);
-      }
-    if( model.size() > 0 )
-      {
-      itk::EncapsulateMetaData<std::string>(dictionary, "0008|1090", model);
-      }
-    if( seriesNumber.size() > 0 )
-      {
-      itk::EncapsulateMetaData<std::string>(dictionary, "0020|0011", seriesNumber);
-      }
-    if( seriesDescription.size() > 0 )
-      {
-      itk::EncapsulateMetaData<std::string>(dictionary, "0008|103e", seriesDescription);
-      }
-
-    // Always set the rescale interscept and rescale slope (even if
-    // they are at their defaults of 0 and 1 respectively).
-    // value.str("");
-    // value << rescaleIntercept;
-    // itk::EncapsulateMetaData<std::string>(dictionary, "0028|1052", value.str());
-    // value.str("");
-    // value << rescaleSlope;
-    // itk::EncapsulateMetaData<std::string>(dictionary, "0028|1053", value.str());
-
-    typename Image3DType::RegionType extractRegion;
-    typename Image3DType::SizeType   extractSize;
-    typename Image3DType::IndexType  extractIndex;
-    extractSize = image->GetLargestPossibleRegion().GetSize();
-    extractIndex.Fill(0);
-    if( reverseImages )
-      {
-      extractIndex[2] = numberOfSlices - i - 1;
-      }
-    else
-      {
-      extractIndex[2] = i;
-      }
-    extractSize[2] = 0;
-    extractRegion.SetSize(extractSize);
-    extractRegion.SetIndex(extractIndex);
-
-    typedef itk::ExtractImageFilter<Image3DType, Image2DType> ExtractType;
-    typename ExtractType::Pointer extract = ExtractType::New();
-    extract->SetDirectionCollapseToGuess();  // ITKv3 compatible, but not recommended
-    extract->SetInput(image );
-    extract->SetExtractionRegion(extractRegion);
-    extract->GetOutput()->SetMetaDataDictionary(dictionary);
-    extract->Update();
-
-    itk::ImageRegionIterator<Image2DType> it( extract->GetOutput(), extract->GetOutput()->GetLargestPossibleRegion() );
-    typename Image2DType::PixelType                minValue = itk::NumericTraits<typename Image2DType::PixelType>::max();
-    typename Image2DType::PixelType                maxValue = itk::NumericTraits<typename Image2DType::PixelType>::min();
-    for( it.GoToBegin(); !it.IsAtEnd(); ++it )
-      {
-      typename Image2DType::PixelType p = it.Get();
-      if( p > maxValue )
-        {
-        maxValue = p;
-        }
-      if( p < minValue )
-        {
-        minValue = p;
-        }
-      }
-    typename Image2DType::PixelType windowCenter = (minValue + maxValue) / 2;
-    typename Image2DType::PixelType windowWidth = (maxValue - minValue);
-
-    value.str("");
-    value << windowCenter;
-    itk::EncapsulateMetaData<std::string>(dictionary, "0028|1050", value.str() );
-    value.str("");
-    value << windowWidth;
-    itk::EncapsulateMetaData<std::string>(dictionary, "0028|1051", value.str() );
-
-    typename WriterType::Pointer writer = WriterType::New();
-    char                imageNumber[BUFSIZ];
-#if WIN32
-#define snprintf sprintf_s
-#endif
-    snprintf(imageNumber, BUFSIZ, dicomNumberFormat.c_str(), i + 1);
-    value.str("");
-    value << dicomDirectory << "/" << dicomPrefix << imageNumber << ".dcm";
-    writer->SetFileName(value.str().c_str() );
-
-    writer->SetInput(extract->GetOutput() );
-    writer->SetUseCompression(useCompression);
-    try
-      {
-      writer->SetImageIO(gdcmIO);
-      writer->Update();
-      }
-    catch( itk::ExceptionObject & excp )
-      {
-      std::cerr << "Exception thrown while writing the file " << std::endl;
-      std::cerr << excp << std::endl;
-      return EXIT_FAILURE;
-      }
+  threader->SetSingleMethod(PassType::ThreadFunction, &pass);
+  threader->SingleMethodExecute();
+  if( pass.Failed )
+    {
+    return EXIT_FAILURE;
     }
   std::cout << "<filter-end>"
             << std::endl;
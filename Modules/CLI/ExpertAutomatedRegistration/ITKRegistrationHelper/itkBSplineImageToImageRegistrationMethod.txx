@@ -637,6 +637,7 @@ BSplineImageToImageRegistrationMethod<TImage>
     typedef BSplineImageToImageRegistrationMethod<ImageType> BSplineRegType;
     typename BSplineRegType::Pointer reg = BSplineRegType::New();
     reg->SetReportProgress( this->GetReportProgress() );
+    reg->SetRegistrationNumberOfThreads( this->GetRegistrationNumberOfThreads() );
     reg->SetFixedImage( fixedImage );
     reg->SetMovingImage( movingImage );
     reg->SetNumberOfControlPoints( levelNumberOfControlPoints );
@@ -224,6 +224,13 @@ OptimizedImageToImageRegistrationMethod<TImage>
           typedMetric->SetUseExplicitPDFDerivatives( false );
           typedMetric->SetUseCachingOfBSplineWeights( false );
           }
+        else if( m_TransformMethodEnum == BSPLINE_TRANSFORM )
+          {
+          // Explicit PDF derivatives have (bins x bins x parameters) elements that have to be
+          // cleared and accumulated at each iteration, computing them on the fly is much faster
+          // for the large number of parameters of a bspline transform.
+          typedMetric->SetUseExplicitPDFDerivatives( false );
+          }
         metric = typedMetric;
         }
       break;
@@ -249,6 +256,9 @@ OptimizedImageToImageRegistrationMethod<TImage>
   metric->SetFixedImage( fixedImage );
   metric->SetMovingImage( movingImage );
 
+  // The metric evaluates the samples in parallel, use the same number of threads as the registration
+  metric->SetNumberOfThreads( this->GetRegistrationNumberOfThreads() );
+
   metric->SetNumberOfSpatialSamples( m_NumberOfSamples );
 
   if( this->GetUseRegionOfInterest() ||
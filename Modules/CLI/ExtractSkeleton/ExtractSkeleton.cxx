@@ -19,6 +19,21 @@
 #include "SkelGraph.h"
 #include "tilg_iso_3D.h"
 
+// SlicerBaseCLI includes
+#include <vtkPluginPolyDataIO.h>
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkUnsignedCharArray.h>
+
+// STD includes
+#include <set>
+
 // Use an anonymous namespace to keep class types and function names
 // from colliding when module is used as shared object module.  Every
 // thing should be in an anonymous namespace except for the module
@@ -27,6 +42,48 @@
 namespace
 {
 
+// One polyline per branch of the skeleton graph, in RAS. The branches that
+// start at a junction include the junction voxel so that the lines of a
+// graph node meet. The cell data tell the branch ID and whether the branch
+// is on the maximal axis.
+template <class TImage>
+void SkeletonGraphToPolyData(SkelGraph* graph, const TImage* image, vtkPolyData* polyData)
+{
+  list<int> maxAxisBranchIDs;
+  graph->Get_max_axis_branches(&maxAxisBranchIDs);
+  std::set<int> maxAxisBranches(maxAxisBranchIDs.begin(), maxAxisBranchIDs.end() );
+
+  vtkNew<vtkPoints>            points;
+  vtkNew<vtkCellArray>         lines;
+  vtkNew<vtkIntArray>          branchIDs;
+  vtkNew<vtkUnsignedCharArray> maxAxis;
+  branchIDs->SetName("BranchId");
+  maxAxis->SetName("MaximalAxis");
+
+  const list<skel_branch> * branches = graph->Get_branches();
+  for( list<skel_branch>::const_iterator branch = branches->begin(); branch != branches->end(); ++branch )
+    {
+    lines->InsertNextCell( static_cast<vtkIdType>( branch->voxels->size() ) );
+    for( list<point>::const_iterator voxel = branch->voxels->begin(); voxel != branch->voxels->end(); ++voxel )
+      {
+      typename TImage::IndexType index;
+      index[0] = voxel->x;
+      index[1] = voxel->y;
+      index[2] = voxel->z;
+      typename TImage::PointType lps;
+      image->TransformIndexToPhysicalPoint(index, lps);
+      lines->InsertCellPoint( points->InsertNextPoint(-lps[0], -lps[1], lps[2]) );
+      }
+    branchIDs->InsertNextValue(branch->branchID);
+    maxAxis->InsertNextValue(maxAxisBranches.count(branch->branchID) ? 1 : 0);
+    }
+
+  polyData->SetPoints(points.GetPointer() );
+  polyData->SetLines(lines.GetPointer() );
+  polyData->GetCellData()->AddArray(branchIDs.GetPointer() );
+  polyData->GetCellData()->AddArray(maxAxis.GetPointer() );
+}
+
 } // end of anonymous namespace
 
 /** Main command */
@@ -89,8 +146,24 @@ int main(int argc, char * *argv)
     graph->Extract_max_axis_in_graph();
     graph->Sample_along_axis(NumberOfPoints, &axisPoints);
 
+    if( !OutputModelFileName.empty() )
+      {
+      vtkNew<vtkPolyData> skeletonModel;
+      SkeletonGraphToPolyData(graph, outputImage.GetPointer(), skeletonModel.GetPointer() );
+      if( !vtkPluginPolyDataIO::WritePolyData(OutputModelFileName, skeletonModel.GetPointer() ) )
+        {
+        delete graph;
+        return EXIT_FAILURE;
+        }
+      std::cout << "Wrote skeleton model." << std::endl;
+      }
+    delete graph;
+
     std::ofstream writeOutputFile;
-    writeOutputFile.open(OutputPointsFileName.c_str() );
+    if( !OutputPointsFileName.empty() )
+      {
+      writeOutputFile.open(OutputPointsFileName.c_str() );
+      }
 
     if( !DontPruneBranches )
       {
@@ -112,14 +185,20 @@ int main(int argc, char * *argv)
         outputImage->SetPixel(pt, 255);
         }
 
-      writeOutputFile << i << " " << iter->x
-                      << " " << iter->y
-                      << " " << iter->z << std::endl;
+      if( writeOutputFile.is_open() )
+        {
+        writeOutputFile << i << " " << iter->x
+                        << " " << iter->y
+                        << " " << iter->z << std::endl;
+        }
       iter++;
       i++;
       }
 
-    std::cout << "Wrote points file." << std::endl;
+    if( writeOutputFile.is_open() )
+      {
+      std::cout << "Wrote points file." << std::endl;
+      }
 
     WriterType::Pointer writer = WriterType::New();
     writer->SetFileName(OutputImageFileName.c_str() );
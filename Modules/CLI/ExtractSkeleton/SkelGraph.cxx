@@ -144,6 +144,10 @@ void SkelGraph::ResetGraph()
         {
         delete elem->max_path;
         }
+      if( elem->voxels )
+        {
+        delete elem->voxels;
+        }
       elem++;
       }
 
@@ -180,6 +184,10 @@ void SkelGraph::ResetGraph()
         {
         delete elem->max_path;
         }
+      if( elem->voxels )
+        {
+        delete elem->voxels;
+        }
       elem++;
       }
 
@@ -246,6 +254,7 @@ void SkelGraph::Extract_skel_graph(unsigned char *orig_image, int orig_dim[3])
       branch_elem->end_1_point->x = branch_elem->end_2_point->x = act_endpoint->x;
       branch_elem->end_1_point->y = branch_elem->end_2_point->y = act_endpoint->y;
       branch_elem->end_1_point->z = branch_elem->end_2_point->z = act_endpoint->z;
+      branch_elem->voxels->push_back(*act_endpoint);
 
       list<skel_branch>::iterator act_branch;
       act_branch = to_do->begin();
@@ -279,6 +288,7 @@ void SkelGraph::Extract_skel_graph(unsigned char *orig_image, int orig_dim[3])
                                         + abs(act_point->y - pt->y)
                                         + abs(act_point->z - pt->z) );
             act_point->x = pt->x; act_point->y = pt->y; act_point->z = pt->z;
+            act_branch->voxels->push_back(*pt);
             label_image[act_point->x
                         + dim[0] * (act_point->y + dim[1] * act_point->z)] = branchID;
             }
@@ -297,6 +307,8 @@ void SkelGraph::Extract_skel_graph(unsigned char *orig_image, int orig_dim[3])
               elems[i]->end_1_point->x = elems[i]->end_2_point->x = pt->x;
               elems[i]->end_1_point->y = elems[i]->end_2_point->y = pt->y;
               elems[i]->end_1_point->z = elems[i]->end_2_point->z = pt->z;
+              elems[i]->voxels->push_back(*act_point);
+              elems[i]->voxels->push_back(*pt);
               label_image[pt->x + dim[0]
                           * (pt->y + dim[1] * pt->z)] = elems[i]->branchID;
               // update ends with act_branch
@@ -734,6 +746,21 @@ void SkelGraph::Sample_along_axis(int n_dim, list<point> * axis_points)
   //   }
 }
 
+const list<skel_branch> * SkelGraph::Get_branches()
+// branches of the graph, in the order of their branchID
+{
+  return graph;
+}
+
+void SkelGraph::Get_max_axis_branches(list<int> * branchIDs)
+// branchID's of the branches along the maximal path
+{
+  if( max_node && max_node->max_path )
+    {
+    branchIDs->insert(branchIDs->end(), max_node->max_path->begin(), max_node->max_path->end() );
+    }
+}
+
 // -------------------------------------------------------------------------
 // Private Methods
 // -------------------------------------------------------------------------
@@ -815,6 +842,7 @@ void SkelGraph::Add_new_elem_to_todo(skel_branch * & newElem)
 
   new_elem.acc_length = new_elem.max_length = 0.0;
   new_elem.acc_path = new_elem.max_path = NULL;
+  new_elem.voxels = new list<point>;
 
   newElem = &(*(to_do->insert(to_do->end(), new_elem) ) );
 
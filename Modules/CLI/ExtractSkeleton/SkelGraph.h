@@ -34,6 +34,8 @@ typedef struct skel_branch_struct
   point * end_2_point;
   list<int> * end_1_neighbors; // id's == one can use advance for random access
   list<int> * end_2_neighbors;
+
+  list<point> * voxels; // from end 1 to end 2, starting at the junction voxel
   } skel_branch;
 
 class SkelGraph
@@ -97,6 +99,14 @@ public:
 
   // sample along the medial axis and perpendicular to it
 
+  const list<skel_branch> * Get_branches();
+
+  // branches of the graph, in the order of their branchID
+
+  void Get_max_axis_branches(list<int> * branchIDs);
+
+  // branchID's of the branches along the maximal path
+
 };
 
 #endif
@@ -23,6 +23,9 @@
 /*****************************************************************************/
 #include <cstdio>
 #include <cstdlib>
+#include <vector>
+
+#include "itkMultiThreader.h"
 
 /********************************  Konstanten  *******************************/
 #define LIM  1 /* Voxelwert >= LIM => Objekt (Input-Bild) */
@@ -592,6 +595,47 @@ int Tilg_Test_3(int c, int d, int type)
   return OBJ;
 }
 
+// A subcycle deletes the voxels in parallel: they are all tested on the
+// unmodified image and deleted afterward. The object voxels are therefore
+// split between threads, each thread lists the voxels it can delete.
+struct tilg_subcycle
+{
+  const std::vector<int> *voxels;
+  int dir;
+  int dir_mask;
+  int type;
+  std::vector<std::vector<int> > deletions; // per thread
+};
+
+ITK_THREAD_RETURN_TYPE tilg_subcycle_thread(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  tilg_subcycle *subcycle = static_cast<tilg_subcycle *>(info->UserData);
+  const std::vector<int>& voxels = *subcycle->voxels;
+  std::vector<int>& deletions = subcycle->deletions[info->ThreadID];
+  size_t first = voxels.size() * info->ThreadID / info->NumberOfThreads;
+  size_t last = voxels.size() * (info->ThreadID + 1) / info->NumberOfThreads;
+  int    nc;
+
+  deletions.clear();
+  for( size_t v = first; v < last; v++ )
+    {
+    int i = voxels[v];
+    nc = Env_Code_3(i);
+    if( ( (~ nc) & subcycle->dir_mask) == subcycle->dir_mask )
+      {
+      if( bitcount(nc) > 2 )
+        {
+        if( Tilg_Test_3(nc, subcycle->dir, subcycle->type) == BG )
+          {
+          deletions.push_back(i);
+          }
+        }
+      }
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 void tilg_iso_3D(int dx, int dy, int dz,
                  unsigned char *data,
                  unsigned char *res,
@@ -602,11 +646,9 @@ void tilg_iso_3D(int dx, int dy, int dz,
 // if type == 0 -> full tilg
 {
 
-  int cnt = 0, cnt1 = 0;
+  int cnt = 0;
   int nc, x, y, z;
-  int end, i, dir, dir_mask;
-  // int free_mask;
-  int *list;
+  int end, i, dir;
   int  dir_tab[26];
 
   // int b[3][3][3];
@@ -618,12 +660,6 @@ void tilg_iso_3D(int dx, int dy, int dz,
 
   workbuf = data;
   nzz = nx * ny;
-  /* Speicher allozieren */
-  if( (list = (int *) malloc(nzz * nz * sizeof(int) / 4) ) == NULL )
-    {
-    printf("out of memory\n");
-    return;
-    }
   /* Arbeitskopie des Bildes erstellen und binaerisieren */
   end = nx * ny * nz;
   for( i = 0; i < end; i++ )
@@ -693,39 +729,52 @@ void tilg_iso_3D(int dx, int dy, int dz,
   f_tab[16] =   131072;    /* 17 */
   f_tab[17] =      512;    /*  9 */
 
-  /* eigentliches Bildparsing */
+  // only the object voxels are tested, not the whole image
+  std::vector<int> voxels;
   end = end - nzz - nx - 1;
+  for( i = nzz + nx + 1; i < end; i++ )
+    {
+    if( result[i] == OBJ )
+      {
+      voxels.push_back(i);
+      }
+    }
+
+  /* eigentliches Bildparsing */
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  tilg_subcycle               subcycle;
+  subcycle.voxels = &voxels;
+  subcycle.type = type;
+  subcycle.deletions.resize(threader->GetNumberOfThreads() );
+  threader->SetSingleMethod(tilg_subcycle_thread, &subcycle);
   cnt = 1;
   while( cnt )
     {
     cnt = 0;
     for( dir = 0; dir < 18; dir++ )
       {
-      cnt1 = 0;
-      dir_mask = dir_tab[dir];
-      for( i = nzz + nx + 1; i < end; i++ )
+      subcycle.dir = dir;
+      subcycle.dir_mask = dir_tab[dir];
+      threader->SingleMethodExecute();
+      /* Voxel der Liste loeschen */
+      for( size_t t = 0; t < subcycle.deletions.size(); t++ )
         {
-        if( result[i] == OBJ )
+        for( size_t v = 0; v < subcycle.deletions[t].size(); v++ )
           {
-          nc = Env_Code_3(i);
-          if( ( (~ nc) & dir_mask) == dir_mask )
-            {
-            if( bitcount(nc) > 2 )
-              {
-              if( Tilg_Test_3(nc, dir, type) == BG )
-                {
-                list[cnt1++] = i;
-                }
-              }
-            }
+          result[subcycle.deletions[t][v]] = BG;
           }
+        cnt += static_cast<int>(subcycle.deletions[t].size() );
         }
-      /* Voxel der Liste loeschen */
-      for( i = 0; i < cnt1; i++ )
+      // remove the deleted voxels from the object voxels
+      size_t remaining = 0;
+      for( size_t v = 0; v < voxels.size(); v++ )
         {
-        result[list[i]] = BG;
+        if( result[voxels[v]] == OBJ )
+          {
+          voxels[remaining++] = voxels[v];
+          }
         }
-      cnt += cnt1;
+      voxels.resize(remaining);
       }
     }
 
@@ -734,8 +783,9 @@ void tilg_iso_3D(int dx, int dy, int dz,
   while( cnt )
     {
     cnt = 0;
-    for( i = nzz + nx + 1; i < end; i++ )
+    for( size_t v = 0; v < voxels.size(); v++ )
       {
+      i = voxels[v];
       if( result[i] == OBJ )
         {
         nc = Env_Code_3(i);
@@ -750,6 +800,4 @@ void tilg_iso_3D(int dx, int dy, int dz,
         }
       }
     }
-
-  free(list);
 }
@@ -1,4 +1,5 @@
 #include "itkImageFileWriter.h"
+#include "itkMultiThreader.h"
 
 #include "itkSmoothingRecursiveGaussianImageFilter.h"
 
@@ -19,6 +20,11 @@ int DoIt( int argc, char * argv[], T )
 {
   PARSE_ARGS;
 
+  if( numberOfThreads > 0 )
+    {
+    itk::MultiThreader::SetGlobalDefaultNumberOfThreads( numberOfThreads );
+    }
+
   typedef    T InputPixelType;
   typedef    T OutputPixelType;
 
@@ -38,6 +44,9 @@ int DoIt( int argc, char * argv[], T )
   typename FilterType::Pointer filter = FilterType::New();
   filter->SetInput( reader->GetOutput() );
   filter->SetSigma( sigma );
+  // The input volume is not needed after filtering, reuse its buffer for
+  // the output
+  filter->InPlaceOn();
 
   typename WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( outputVolume.c_str() );
@@ -16,6 +16,7 @@
 =========================================================================*/
 #include "itkImageFileWriter.h"
 #include "itkCastImageFilter.h"
+#include "itkMultiThreader.h"
 
 #include "itkGradientAnisotropicDiffusionImageFilter.h"
 
@@ -36,6 +37,11 @@ int DoIt( int argc, char * argv[], T )
 
   PARSE_ARGS;
 
+  if( numberOfThreads > 0 )
+    {
+    itk::MultiThreader::SetGlobalDefaultNumberOfThreads( numberOfThreads );
+    }
+
   typedef    float InputPixelType;
   typedef    T     OutputPixelType;
 
@@ -60,6 +66,12 @@ int DoIt( int argc, char * argv[], T )
                                        CLPProcessInformation);
 
   filter->SetInput( reader->GetOutput() );
+  // The float image read from the input volume is not needed anymore once
+  // the diffusion starts: iterate directly in its buffer instead of
+  // allocating another float image.
+  filter->InPlaceOn();
+  // Free the float image once it is cast to the output pixel type
+  filter->ReleaseDataFlagOn();
   filter->SetNumberOfIterations( numberOfIterations );
   filter->SetTimeStep( timeStep );
   filter->SetConductanceParameter( conductance );
@@ -15,7 +15,8 @@ Version:   $Revision$
 #include "GrayscaleModelMakerCLP.h"
 #include "vtkITKArchetypeImageSeriesScalarReader.h"
 #include "vtkImageData.h"
-#include "vtkMarchingCubes.h"
+#include "vtkExtractVOI.h"
+#include "vtkFlyingEdges3D.h"
 #include "vtkWindowedSincPolyDataFilter.h"
 #include "vtkTransform.h"
 #include "vtkDecimatePro.h"
@@ -32,6 +33,54 @@ Version:   $Revision$
 #include "vtkDebugLeaks.h"
 #include <vtkVersion.h>
 
+// STD includes
+#include <algorithm>
+
+namespace
+{
+
+// Find the extent of the voxels at or above the threshold, padded by one
+// voxel so that it contains all the cells crossed by the isosurface.
+template <class T>
+bool GetThresholdExtent(vtkImageData* image, double threshold, int thresholdExtent[6])
+{
+  int extent[6];
+  image->GetExtent(extent);
+  const T* scalars = static_cast<const T*>(image->GetScalarPointer());
+  const int numberOfComponents = image->GetNumberOfScalarComponents();
+  int box[6] = { extent[1], extent[0], extent[3], extent[2], extent[5], extent[4] };
+  for( int k = extent[4]; k <= extent[5]; ++k )
+    {
+    for( int j = extent[2]; j <= extent[3]; ++j )
+      {
+      for( int i = extent[0]; i <= extent[1]; ++i, scalars += numberOfComponents )
+        {
+        if( static_cast<double>(*scalars) >= threshold )
+          {
+          box[0] = std::min(box[0], i);
+          box[1] = std::max(box[1], i);
+          box[2] = std::min(box[2], j);
+          box[3] = std::max(box[3], j);
+          box[4] = std::min(box[4], k);
+          box[5] = std::max(box[5], k);
+          }
+        }
+      }
+    }
+  if( box[0] > box[1] )
+    {
+    return false;
+    }
+  for( int axis = 0; axis < 3; ++axis )
+    {
+    thresholdExtent[2 * axis] = std::max(extent[2 * axis], box[2 * axis] - 1);
+    thresholdExtent[2 * axis + 1] = std::min(extent[2 * axis + 1], box[2 * axis + 1] + 1);
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
 int main(int argc, char * argv[])
 {
   PARSE_ARGS;
@@ -68,7 +117,8 @@ int main(int argc, char * argv[])
   vtkImageData *                    image;
   vtkWindowedSincPolyDataFilter *   smootherSinc = NULL;
   vtkDecimatePro *                  decimator = NULL;
-  vtkMarchingCubes *                mcubes = NULL;
+  vtkExtractVOI *                   cropper = NULL;
+  vtkFlyingEdges3D *                mcubes = NULL;
   vtkTransform *                    transformIJKtoRAS = NULL;
   vtkReverseSense *                 reverser = NULL;
   vtkTransformPolyDataFilter *      transformer = NULL;
@@ -139,13 +189,41 @@ int main(int argc, char * argv[])
     transformIJKtoRAS->GetMatrix()->Print(std::cout);
     }
   transformIJKtoRAS->Inverse();
-  mcubes = vtkMarchingCubes::New();
+
+  // Only the region of the voxels above the threshold is contoured
+  int thresholdExtent[6];
+  bool foundThresholdExtent = false;
+  switch( image->GetScalarType() )
+    {
+    vtkTemplateMacro(foundThresholdExtent = GetThresholdExtent<VTK_TT>(image, Threshold, thresholdExtent));
+    default:
+      break;
+    }
+  cropper = vtkExtractVOI::New();
+  cropper->SetInputConnection(ici->GetOutputPort() );
+  if( foundThresholdExtent )
+    {
+    cropper->SetVOI(thresholdExtent);
+    }
+  else
+    {
+    cropper->SetVOI(extents);
+    }
+  if( debug && foundThresholdExtent )
+    {
+    std::cout << "Threshold extent: " << thresholdExtent[0] << " " << thresholdExtent[1] << " "
+              << thresholdExtent[2] << " " << thresholdExtent[3] << " "
+              << thresholdExtent[4] << " " << thresholdExtent[5] << endl;
+    }
+
+  // Flying edges is a multithreaded implementation of marching cubes
+  mcubes = vtkFlyingEdges3D::New();
   vtkPluginFilterWatcher watchMCubes(mcubes,
                                      "Marching Cubes",
                                      CLPProcessInformation,
                                      1.0 / 7.0, 0.0);
 
-  mcubes->SetInputConnection(ici->GetOutputPort() );
+  mcubes->SetInputConnection(cropper->GetOutputPort() );
   mcubes->SetValue(0, Threshold);
   mcubes->ComputeScalarsOff();
   mcubes->ComputeGradientsOff();
@@ -302,6 +380,10 @@ int main(int argc, char * argv[])
     {
     ici->Delete();
     }
+  if( cropper )
+    {
+    cropper->Delete();
+    }
   if( transformIJKtoRAS )
     {
     transformIJKtoRAS->Delete();
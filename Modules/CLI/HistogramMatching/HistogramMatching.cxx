@@ -23,10 +23,18 @@
 #include "itkImageFileWriter.h"
 #include "itkPluginUtilities.h"
 
-#include "itkHistogramMatchingImageFilter.h"
+#include "itkHistogram.h"
+#include "itkMultiThreader.h"
+#include "itkStatisticsImageFilter.h"
+#include "itkUnaryFunctorImageFilter.h"
 
 #include "HistogramMatchingCLP.h"
 
+// STD includes
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
 // Use an anonymous namespace to keep class types and function names
 // from colliding when module is used as shared object module.  Every
 // thing should be in an anonymous namespace except for the module
@@ -35,6 +43,265 @@
 namespace
 {
 
+// Intensities matched between two images, as computed by
+// itk::HistogramMatchingImageFilter: the minimum and maximum of the image
+// and its quantile table. The first quantile is the intensity threshold,
+// the last one the maximum.
+struct QuantileModel
+{
+  double Minimum;
+  double Maximum;
+  std::vector<double> Quantiles;
+};
+
+const char* QuantileModelHeader = "# HistogramMatching reference model";
+
+// Fill the frequencies of a 1D histogram, each thread bins its own range of
+// the image buffer.
+template <class TImage, class THistogram>
+struct HistogramFillData
+{
+  typedef typename TImage::PixelType PixelType;
+  const PixelType* Buffer;
+  itk::SizeValueType NumberOfPixels;
+  const THistogram* Histogram;
+  PixelType Minimum;
+  PixelType Maximum;
+  std::vector<std::vector<itk::SizeValueType> > Frequencies;
+};
+
+template <class TImage, class THistogram>
+ITK_THREAD_RETURN_TYPE FillHistogramThreadFunction(void* arg)
+{
+  itk::MultiThreader::ThreadInfoStruct* info = static_cast<itk::MultiThreader::ThreadInfoStruct*>(arg);
+  HistogramFillData<TImage, THistogram>* data =
+    static_cast<HistogramFillData<TImage, THistogram>*>(info->UserData);
+  const itk::SizeValueType first = data->NumberOfPixels * info->ThreadID / info->NumberOfThreads;
+  const itk::SizeValueType last = data->NumberOfPixels * (info->ThreadID + 1) / info->NumberOfThreads;
+  std::vector<itk::SizeValueType>& frequencies = data->Frequencies[info->ThreadID];
+
+  typename THistogram::MeasurementVectorType measurement;
+  measurement.SetSize(1);
+  typename THistogram::IndexType index;
+  index.SetSize(1);
+  for (itk::SizeValueType n = first; n < last; ++n)
+    {
+    const typename TImage::PixelType value = data->Buffer[n];
+    if (static_cast<double>(value) >= data->Minimum &&
+        static_cast<double>(value) <= data->Maximum)
+      {
+      measurement[0] = value;
+      // Values that fall out of the bins are not counted, as with
+      // itk::Statistics::Histogram::IncreaseFrequencyOfMeasurement()
+      if (data->Histogram->GetIndex(measurement, index))
+        {
+        ++frequencies[index[0]];
+        }
+      }
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+// Compute the quantile model of an image the same way as
+// itk::HistogramMatchingImageFilter, using all the threads.
+template <class TImage>
+QuantileModel ComputeQuantileModel(const TImage* image,
+                                   unsigned int numberOfHistogramLevels,
+                                   unsigned int numberOfMatchPoints,
+                                   bool thresholdAtMeanIntensity)
+{
+  typedef typename TImage::PixelType                PixelType;
+  typedef itk::Statistics::Histogram<PixelType>     HistogramType;
+  typedef itk::StatisticsImageFilter<TImage>        StatisticsType;
+
+  typename StatisticsType::Pointer statistics = StatisticsType::New();
+  statistics->SetInput(image);
+  statistics->Update();
+  const PixelType minimum = statistics->GetMinimum();
+  const PixelType maximum = statistics->GetMaximum();
+  const PixelType threshold = thresholdAtMeanIntensity ?
+    static_cast<PixelType>(statistics->GetMean()) : minimum;
+
+  typename HistogramType::Pointer histogram = HistogramType::New();
+  typename HistogramType::SizeType size;
+  typename HistogramType::MeasurementVectorType lowerBound;
+  typename HistogramType::MeasurementVectorType upperBound;
+  size.SetSize(1);
+  lowerBound.SetSize(1);
+  upperBound.SetSize(1);
+  histogram->SetMeasurementVectorSize(1);
+  size[0] = numberOfHistogramLevels;
+  lowerBound.Fill(threshold);
+  upperBound.Fill(maximum);
+  histogram->Initialize(size, lowerBound, upperBound);
+  histogram->SetToZero();
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  HistogramFillData<TImage, HistogramType> data;
+  data.Buffer = image->GetBufferPointer();
+  data.NumberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+  data.Histogram = histogram;
+  data.Minimum = threshold;
+  data.Maximum = maximum;
+  data.Frequencies.resize(threader->GetNumberOfThreads(),
+                          std::vector<itk::SizeValueType>(numberOfHistogramLevels, 0));
+  threader->SetSingleMethod(FillHistogramThreadFunction<TImage, HistogramType>, &data);
+  threader->SingleMethodExecute();
+  for (unsigned int bin = 0; bin < numberOfHistogramLevels; ++bin)
+    {
+    itk::SizeValueType frequency = 0;
+    for (size_t thread = 0; thread < data.Frequencies.size(); ++thread)
+      {
+      frequency += data.Frequencies[thread][bin];
+      }
+    histogram->SetFrequency(bin, frequency);
+    }
+
+  QuantileModel model;
+  model.Minimum = minimum;
+  model.Maximum = maximum;
+  model.Quantiles.resize(numberOfMatchPoints + 2);
+  model.Quantiles[0] = threshold;
+  model.Quantiles[numberOfMatchPoints + 1] = maximum;
+  const double delta = 1.0 / (static_cast<double>(numberOfMatchPoints) + 1.0);
+  for (unsigned int j = 1; j < numberOfMatchPoints + 1; ++j)
+    {
+    model.Quantiles[j] = histogram->Quantile(0, j * delta);
+    }
+  return model;
+}
+
+// The model is saved with the parameters it was computed with, so that it
+// is only reused with the same parameters.
+bool WriteQuantileModel(const std::string& fileName, const QuantileModel& model,
+                        int numberOfHistogramLevels, int numberOfMatchPoints,
+                        bool thresholdAtMeanIntensity)
+{
+  std::ofstream file(fileName.c_str());
+  file << QuantileModelHeader << std::endl
+       << numberOfHistogramLevels << " " << numberOfMatchPoints << " "
+       << (thresholdAtMeanIntensity ? 1 : 0) << std::endl
+       << std::setprecision(17) << model.Minimum << " " << model.Maximum << std::endl;
+  for (size_t j = 0; j < model.Quantiles.size(); ++j)
+    {
+    file << model.Quantiles[j] << (j + 1 < model.Quantiles.size() ? " " : "\n");
+    }
+  return file.good();
+}
+
+bool ReadQuantileModel(const std::string& fileName, QuantileModel& model,
+                       int numberOfHistogramLevels, int numberOfMatchPoints,
+                       bool thresholdAtMeanIntensity)
+{
+  std::ifstream file(fileName.c_str());
+  std::string header;
+  std::getline(file, header);
+  if (header != QuantileModelHeader)
+    {
+    std::cerr << fileName << " is not a histogram matching reference model" << std::endl;
+    return false;
+    }
+  int levels = 0;
+  int matchPoints = 0;
+  int threshold = 0;
+  file >> levels >> matchPoints >> threshold;
+  if (levels != numberOfHistogramLevels || matchPoints != numberOfMatchPoints ||
+      (threshold != 0) != thresholdAtMeanIntensity)
+    {
+    std::cerr << fileName << " was computed with " << levels << " histogram levels, "
+              << matchPoints << " match points and threshold " << (threshold ? "on" : "off")
+              << ": it does not match the parameters" << std::endl;
+    return false;
+    }
+  file >> model.Minimum >> model.Maximum;
+  model.Quantiles.resize(numberOfMatchPoints + 2);
+  for (size_t j = 0; j < model.Quantiles.size(); ++j)
+    {
+    file >> model.Quantiles[j];
+    }
+  if (file.fail())
+    {
+    std::cerr << "Failed to read " << fileName << std::endl;
+    return false;
+    }
+  return true;
+}
+
+// Piecewise linear mapping of the source quantiles to the reference
+// quantiles, extrapolated below the threshold and above the maximum, as in
+// itk::HistogramMatchingImageFilter.
+template <class TInput, class TOutput>
+class QuantileMapping
+{
+public:
+  QuantileMapping() : LowerGradient(0.), UpperGradient(0.) {}
+
+  void Initialize(const QuantileModel& source, const QuantileModel& reference)
+  {
+    this->Source = source;
+    this->Reference = reference;
+    const size_t numberOfQuantiles = source.Quantiles.size();
+    this->Gradients.assign(numberOfQuantiles - 1, 0.);
+    for (size_t j = 0; j + 1 < numberOfQuantiles; ++j)
+      {
+      const double denominator = source.Quantiles[j + 1] - source.Quantiles[j];
+      if (denominator != 0)
+        {
+        this->Gradients[j] = (reference.Quantiles[j + 1] - reference.Quantiles[j]) / denominator;
+        }
+      }
+    double denominator = source.Quantiles[0] - source.Minimum;
+    this->LowerGradient = denominator != 0 ?
+      (reference.Quantiles[0] - reference.Minimum) / denominator : 0.;
+    denominator = source.Quantiles[numberOfQuantiles - 1] - source.Maximum;
+    this->UpperGradient = denominator != 0 ?
+      (reference.Maximum - reference.Quantiles[numberOfQuantiles - 1]) / denominator : 0.;
+  }
+
+  bool operator!=(const QuantileMapping&) const
+  {
+    return true;
+  }
+
+  bool operator==(const QuantileMapping& other) const
+  {
+    return !(*this != other);
+  }
+
+  inline TOutput operator()(const TInput& input) const
+  {
+    const double value = static_cast<double>(input);
+    const size_t numberOfQuantiles = this->Source.Quantiles.size();
+    size_t j = 0;
+    while (j < numberOfQuantiles && value >= this->Source.Quantiles[j])
+      {
+      ++j;
+      }
+    double mappedValue;
+    if (j == 0)
+      {
+      mappedValue = this->Reference.Minimum + (value - this->Source.Minimum) * this->LowerGradient;
+      }
+    else if (j == numberOfQuantiles)
+      {
+      mappedValue = this->Reference.Maximum + (value - this->Source.Maximum) * this->UpperGradient;
+      }
+    else
+      {
+      mappedValue = this->Reference.Quantiles[j - 1] +
+        (value - this->Source.Quantiles[j - 1]) * this->Gradients[j - 1];
+      }
+    return static_cast<TOutput>(mappedValue);
+  }
+
+private:
+  QuantileModel Source;
+  QuantileModel Reference;
+  std::vector<double> Gradients;
+  double LowerGradient;
+  double UpperGradient;
+};
+
 template <class T>
 int DoIt( int argc, char * argv[], T )
 {
@@ -53,36 +320,79 @@ int DoIt( int argc, char * argv[], T )
   typedef itk::ImageFileWriter<OutputImageType> WriterType;
 
   // define the histogram matching
-  typedef itk::HistogramMatchingImageFilter<
-    InputImageType,
-    OutputImageType, InputPixelType>  FilterType;
-
-  // Creation of Reader and Writer filters
-  typename ReaderType::Pointer reader1 = ReaderType::New();
-  typename ReaderType::Pointer reader2 = ReaderType::New();
-  typename WriterType::Pointer writer  = WriterType::New();
-
-  // Create the filter
-  typename FilterType::Pointer  filter = FilterType::New();
-  itk::PluginFilterWatcher watcher(filter, "Match Histogram",
-                                   CLPProcessInformation);
-
-  // Setup the input and output files
-  reader1->SetFileName( inputVolume.c_str() );
-  reader2->SetFileName( referenceVolume.c_str() );
-  writer->SetFileName( outputVolume.c_str() );
-  writer->SetUseCompression(1);
-
-  // Setup the filter
-  filter->SetInput( reader1->GetOutput() );
-  filter->SetReferenceImage( reader2->GetOutput() );
-  filter->SetNumberOfHistogramLevels( numberOfHistogramLevels );
-  filter->SetNumberOfMatchPoints( numberOfMatchPoints );
-  filter->SetThresholdAtMeanIntensity( thresholdAtMeanIntensity );
-
-  // Write the output
-  writer->SetInput( filter->GetOutput() );
-  writer->Update();
+  typedef QuantileMapping<InputPixelType, OutputPixelType> MappingType;
+  typedef itk::UnaryFunctorImageFilter<
+    InputImageType, OutputImageType, MappingType>  FilterType;
+
+  if (numberOfHistogramLevels < 1 || numberOfMatchPoints < 0)
+    {
+    std::cerr << argv[0] << ": invalid number of histogram levels or match points" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::vector<std::string> inputVolumes(1, inputVolume);
+  inputVolumes.insert(inputVolumes.end(), additionalInputVolumes.begin(), additionalInputVolumes.end());
+  std::vector<std::string> outputVolumes(1, outputVolume);
+  outputVolumes.insert(outputVolumes.end(), additionalOutputVolumes.begin(), additionalOutputVolumes.end());
+  if (inputVolumes.size() != outputVolumes.size())
+    {
+    std::cerr << argv[0] << ": " << additionalInputVolumes.size() << " additional input volumes but "
+              << additionalOutputVolumes.size() << " additional output volumes" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The reference quantiles are computed once for all the input volumes
+  QuantileModel reference;
+  if (!referenceModel.empty())
+    {
+    if (!ReadQuantileModel(referenceModel, reference, numberOfHistogramLevels,
+                           numberOfMatchPoints, thresholdAtMeanIntensity))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  else
+    {
+    typename ReaderType::Pointer referenceReader = ReaderType::New();
+    itk::PluginFilterWatcher watchReader(referenceReader, "Read Reference Volume",
+                                         CLPProcessInformation);
+    referenceReader->SetFileName( referenceVolume.c_str() );
+    referenceReader->Update();
+    reference = ComputeQuantileModel<InputImageType>(referenceReader->GetOutput(),
+      numberOfHistogramLevels, numberOfMatchPoints, thresholdAtMeanIntensity);
+    }
+  if (!saveReferenceModel.empty() &&
+      !WriteQuantileModel(saveReferenceModel, reference, numberOfHistogramLevels,
+                          numberOfMatchPoints, thresholdAtMeanIntensity))
+    {
+    std::cerr << argv[0] << ": failed to write " << saveReferenceModel << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for (size_t i = 0; i < inputVolumes.size(); ++i)
+    {
+    typename ReaderType::Pointer reader = ReaderType::New();
+    reader->SetFileName( inputVolumes[i].c_str() );
+    reader->Update();
+
+    MappingType mapping;
+    mapping.Initialize(ComputeQuantileModel<InputImageType>(reader->GetOutput(),
+      numberOfHistogramLevels, numberOfMatchPoints, thresholdAtMeanIntensity), reference);
+
+    // Create the filter
+    typename FilterType::Pointer filter = FilterType::New();
+    itk::PluginFilterWatcher watcher(filter, "Match Histogram",
+                                     CLPProcessInformation);
+    filter->SetInput( reader->GetOutput() );
+    filter->SetFunctor( mapping );
+
+    // Write the output
+    typename WriterType::Pointer writer = WriterType::New();
+    writer->SetFileName( outputVolumes[i].c_str() );
+    writer->SetUseCompression(1);
+    writer->SetInput( filter->GetOutput() );
+    writer->Update();
+    }
 
   return EXIT_SUCCESS;
 
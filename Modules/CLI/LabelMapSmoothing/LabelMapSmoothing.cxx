@@ -17,7 +17,8 @@
 #include "itkMinimumMaximumImageFilter.h"
 #include "itkLabelStatisticsImageFilter.h"
 #include "itkRegionOfInterestImageFilter.h"
-#include "itkPasteImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMultiThreader.h"
 
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
@@ -26,6 +27,10 @@
 
 #include "LabelMapSmoothingCLP.h"
 
+// STD includes
+#include <map>
+#include <vector>
+
 // Use an anonymous namespace to keep class types and function names
 // from colliding when module is used as shared object module.  Every
 // thing should be in an anonymous namespace except for the module
@@ -34,6 +39,66 @@
 namespace
 {
 
+// Image Types
+const unsigned short ImageDimension = 3;
+typedef itk::Image<float, ImageDimension>         FloatImageType;
+typedef itk::Image<unsigned char, ImageDimension> UCharImageType;
+
+// Filter Types
+typedef itk::BinaryThresholdImageFilter<UCharImageType, UCharImageType>  InputThresholdType;
+typedef itk::MinimumMaximumImageFilter<UCharImageType>                   MinMaxType;
+typedef itk::LabelStatisticsImageFilter<UCharImageType, UCharImageType>  LabelStatisticsType;
+typedef itk::RegionOfInterestImageFilter<UCharImageType, UCharImageType> ExtracterType;
+typedef itk::AntiAliasBinaryImageFilter<UCharImageType, FloatImageType>  AntiAliasType;
+typedef itk::DiscreteGaussianImageFilter<FloatImageType, FloatImageType> GaussianType;
+
+// Smoothing of one label in its bounding box. The voxels of the label are
+// inside where the smoothed level set is positive.
+struct LabelSmoothing
+{
+  int Label;
+  UCharImageType::RegionType Region;
+  UCharImageType::Pointer    Mask;
+  AntiAliasType::Pointer     AntiAliasFilter;
+  GaussianType::Pointer      GaussianFilter;
+  FloatImageType::Pointer    Smoothed;
+  std::string                Error;
+};
+
+void SmoothLabel(LabelSmoothing& smoothing)
+{
+  try
+    {
+    smoothing.AntiAliasFilter->SetInput( smoothing.Mask );
+    smoothing.AntiAliasFilter->Update();
+    FloatImageType::Pointer antiAliasImage = smoothing.AntiAliasFilter->GetOutput();
+    antiAliasImage->DisconnectPipeline();
+    smoothing.Mask = NULL;
+
+    smoothing.GaussianFilter->SetInput( antiAliasImage );
+    smoothing.GaussianFilter->Update();
+    smoothing.Smoothed = smoothing.GaussianFilter->GetOutput();
+    smoothing.Smoothed->DisconnectPipeline();
+    }
+  catch( itk::ExceptionObject & exc )
+    {
+    smoothing.Error = exc.what();
+    }
+}
+
+// The level set filters are not multithreaded: the labels are smoothed in
+// parallel instead, each thread takes every NumberOfThreads label.
+ITK_THREAD_RETURN_TYPE SmoothLabelsThreadFunction(void* arg)
+{
+  itk::MultiThreader::ThreadInfoStruct* info = static_cast<itk::MultiThreader::ThreadInfoStruct*>(arg);
+  std::vector<LabelSmoothing>* smoothings = static_cast<std::vector<LabelSmoothing>*>(info->UserData);
+  for (size_t l = info->ThreadID; l < smoothings->size(); l += info->NumberOfThreads)
+    {
+    SmoothLabel((*smoothings)[l]);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 } // end of anonymous namespace
 
 int main( int argc, char * argv[] )
@@ -43,150 +108,187 @@ int main( int argc, char * argv[] )
   unsigned int numberOfLayers = 2;
   unsigned int boundingBoxPadding = vnl_math_max( (unsigned int)(std::ceil(4.0 * gaussianSigma) ), numberOfLayers);
 
-// Image Types
-  const unsigned short ImageDimension = 3;
-  typedef itk::Image<float, ImageDimension>         FloatImageType;
-  typedef itk::Image<unsigned char, ImageDimension> UCharImageType;
-
-// Filter Types
-  typedef itk::BinaryThresholdImageFilter<UCharImageType, UCharImageType>       InputThresholdType;
-  typedef itk::MinimumMaximumImageFilter<UCharImageType>                        MinMaxType;
-  typedef itk::LabelStatisticsImageFilter<UCharImageType, UCharImageType>       LabelStatisticsType;
-  typedef itk::RegionOfInterestImageFilter<UCharImageType, UCharImageType>      ExtracterType;
-  typedef itk::AntiAliasBinaryImageFilter<UCharImageType, FloatImageType>       AntiAliasType;
-  typedef itk::DiscreteGaussianImageFilter<FloatImageType, FloatImageType>      GaussianType;
-  typedef itk::BinaryThresholdImageFilter<FloatImageType, UCharImageType>       OutputThresholdType;
-  typedef itk::PasteImageFilter<UCharImageType, UCharImageType, UCharImageType> PasteType;
-
 // I/O Types
   typedef itk::ImageFileReader<UCharImageType> ReaderType;
   typedef itk::ImageFileWriter<UCharImageType> WriterType;
 
 // Instances
   ReaderType::Pointer          reader = ReaderType::New();
-  InputThresholdType::Pointer  inputThresholder = InputThresholdType::New();
   MinMaxType::Pointer          minMaxCalculator = MinMaxType::New();
   LabelStatisticsType::Pointer labelStatisticsFilter = LabelStatisticsType::New();
-  ExtracterType::Pointer       extracter = ExtracterType::New();
-  AntiAliasType::Pointer       antiAliasFilter = AntiAliasType::New();
-  GaussianType::Pointer        gaussianFilter = GaussianType::New();
-  OutputThresholdType::Pointer outputThresholder = OutputThresholdType::New();
-  PasteType::Pointer           paster = PasteType::New();
   WriterType::Pointer          writer = WriterType::New();
 
-// Watchers
-  itk::PluginFilterWatcher AntiAliasWatcher(antiAliasFilter, "Anti Alias Image Filter", CLPProcessInformation, 2.0
-                                            / 3.0,
-                                            0.0);
-  itk::PluginFilterWatcher GaussianWatcher(gaussianFilter, "Gaussian Image Filter", CLPProcessInformation, 1.0 / 3.0,
-                                           2.0 / 3.0);
-
   try
     {
 
     reader->SetFileName(inputVolume.c_str() );
     reader->Update();
+    UCharImageType::Pointer inputImage = reader->GetOutput();
+
+    // Choose the labels to smooth.  All others will be ignored.
+    // If a single label is smoothed, the output is a binary label map,
+    // otherwise the output voxels get the value of their label.
+    std::vector<int> labels(labelsToSmooth.begin(), labelsToSmooth.end());
+    const bool binaryOutput = labels.empty();
+    if( binaryOutput )
+      {
+      // If the chosen label is greater than the largest label in the
+      // image or lower than the smallest, the label will be set to the
+      // closest one.
+      // If no label is selected by the user, the maximum label in the image is chosen by default.
+      minMaxCalculator->SetInput( inputImage );
+      minMaxCalculator->Update();
+
+      if( labelToSmooth == -1 )
+        {
+        labelToSmooth = minMaxCalculator->GetMaximum();
+        }
+      else if( labelToSmooth > minMaxCalculator->GetMaximum() )
+        {
+        labelToSmooth = minMaxCalculator->GetMaximum();
+        }
+      else if( labelToSmooth < minMaxCalculator->GetMinimum() )
+        {
+        labelToSmooth = minMaxCalculator->GetMinimum();
+        }
+      labels.push_back( labelToSmooth );
+      }
 
-    // Choose a label to smooth.  All others will be ignored.
-    // If the chosen label is greater than the largest label in the
-    // image or lower than the smallest, the label will be set to the
-    // closest one.
-    // If no label is selected by the user, the maximum label in the image is chosen by default.
-    minMaxCalculator->SetInput( reader->GetOutput() );
-    minMaxCalculator->ReleaseDataFlagOn();
-    minMaxCalculator->Update();
+    // Find the bounding boxes of all the labels in one pass.
+    labelStatisticsFilter->SetInput( inputImage );
+    labelStatisticsFilter->SetLabelInput( inputImage );
+    labelStatisticsFilter->Update();
 
-    if( labelToSmooth == -1 )
+    // Extract each label in its bounding box.
+    UCharImageType::SizeType imageSize = inputImage->GetLargestPossibleRegion().GetSize();
+    std::vector<LabelSmoothing> smoothings;
+    for( size_t l = 0; l < labels.size(); ++l )
       {
-      labelToSmooth = minMaxCalculator->GetMaximum();
+      if( !labelStatisticsFilter->HasLabel( labels[l] ) )
+        {
+        std::cerr << "Label " << labels[l] << " is not in the input volume, it is ignored." << std::endl;
+        continue;
+        }
+      LabelStatisticsType::BoundingBoxType boundingBox = labelStatisticsFilter->GetBoundingBox( labels[l] );
+      // Extend the bounding box in each direction to ensure that the
+      // cropping of the image does not affect the final result.
+      // Make sure the new bounding box does not extend outside of the
+      // original image size.
+      UCharImageType::RegionType::SizeType regionSize;
+      UCharImageType::IndexType            regionIndex;
+      for( unsigned int i = 0; i < ImageDimension; i++ )
+        {
+        boundingBox[2 * i] = vnl_math_max(0, (int)(boundingBox[2 * i] - boundingBoxPadding) );
+        boundingBox[2 * i + 1] = vnl_math_min( (int)(imageSize[i] - 1), (int)(boundingBox[2 * i + 1] + boundingBoxPadding) );
+        regionIndex[i] = boundingBox[2 * i];
+        regionSize[i] = boundingBox[2 * i + 1] - boundingBox[2 * i] + 1;
+        }
+
+      LabelSmoothing smoothing;
+      smoothing.Label = labels[l];
+      smoothing.Region.SetSize( regionSize );
+      smoothing.Region.SetIndex( regionIndex );
+
+      // Extract the region from the image and keep only the label.
+      ExtracterType::Pointer extracter = ExtracterType::New();
+      extracter->SetInput( inputImage );
+      extracter->SetRegionOfInterest( smoothing.Region );
+      InputThresholdType::Pointer inputThresholder = InputThresholdType::New();
+      inputThresholder->SetInput( extracter->GetOutput() );
+      inputThresholder->SetInsideValue( 1 );
+      inputThresholder->SetOutsideValue( 0 );
+      inputThresholder->SetLowerThreshold( labels[l] );
+      inputThresholder->SetUpperThreshold( labels[l] );
+      inputThresholder->Update();
+      smoothing.Mask = inputThresholder->GetOutput();
+      smoothing.Mask->DisconnectPipeline();
+
+      smoothing.AntiAliasFilter = AntiAliasType::New();
+      smoothing.AntiAliasFilter->SetMaximumRMSError( maxRMSError );
+      smoothing.AntiAliasFilter->SetNumberOfIterations( numberOfIterations );
+      smoothing.AntiAliasFilter->SetNumberOfLayers( numberOfLayers );
+      smoothing.GaussianFilter = GaussianType::New();
+      smoothing.GaussianFilter->SetVariance( gaussianSigma * gaussianSigma );
+      smoothings.push_back( smoothing );
       }
-    else if( labelToSmooth > minMaxCalculator->GetMaximum() )
+
+    if( smoothings.size() == 1 )
       {
-      labelToSmooth = minMaxCalculator->GetMaximum();
+      // Watchers
+      itk::PluginFilterWatcher AntiAliasWatcher(smoothings[0].AntiAliasFilter, "Anti Alias Image Filter",
+                                                CLPProcessInformation, 2.0 / 3.0, 0.0);
+      itk::PluginFilterWatcher GaussianWatcher(smoothings[0].GaussianFilter, "Gaussian Image Filter",
+                                               CLPProcessInformation, 1.0 / 3.0, 2.0 / 3.0);
+      SmoothLabel( smoothings[0] );
       }
-    else if( labelToSmooth < minMaxCalculator->GetMinimum() )
+    else if( smoothings.size() > 1 )
       {
-      labelToSmooth = minMaxCalculator->GetMinimum();
+      itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+      threader->SetNumberOfThreads( vnl_math_min( threader->GetNumberOfThreads(),
+                                                  static_cast<itk::ThreadIdType>( smoothings.size() ) ) );
+      for( size_t l = 0; l < smoothings.size(); ++l )
+        {
+        smoothings[l].AntiAliasFilter->SetNumberOfThreads( 1 );
+        smoothings[l].GaussianFilter->SetNumberOfThreads( 1 );
+        }
+      threader->SetSingleMethod( SmoothLabelsThreadFunction, &smoothings );
+      threader->SingleMethodExecute();
       }
-
-    inputThresholder->SetInput( reader->GetOutput() );
-    inputThresholder->SetInsideValue( 1 );
-    inputThresholder->SetOutsideValue( 0 );
-    inputThresholder->SetLowerThreshold( labelToSmooth );
-    inputThresholder->SetUpperThreshold( labelToSmooth );
-    inputThresholder->ReleaseDataFlagOn();
-    inputThresholder->Update();
-
-    // Find the bounding box of the desired label.
-    labelStatisticsFilter->SetInput( inputThresholder->GetOutput() );
-    labelStatisticsFilter->SetLabelInput( inputThresholder->GetOutput() );
-    // labelStatisticsFilter->ReleaseDataFlagOn();
-    labelStatisticsFilter->Update();
-    LabelStatisticsType::BoundingBoxType boundingBox = labelStatisticsFilter->GetBoundingBox( 1 );
-    // Extend the bounding box in each direction to ensure that the
-    // cropping of the image does not affect the final result.
-    // Make sure the new bounding box does not extend outside of the
-    // original image size.
-    UCharImageType::SizeType             imageSize = reader->GetOutput()->GetLargestPossibleRegion().GetSize();
-    UCharImageType::RegionType::SizeType regionSize;
-    UCharImageType::IndexType            regionIndex;
-    for( unsigned int i = 0; i < ImageDimension; i++ )
+    for( size_t l = 0; l < smoothings.size(); ++l )
       {
-      boundingBox[2 * i] = vnl_math_max(0, (int)(boundingBox[2 * i] - boundingBoxPadding) );
-      boundingBox[2 * i + 1] = vnl_math_min( (int)(imageSize[i] - 1), (int)(boundingBox[2 * i + 1] + boundingBoxPadding) );
-      regionIndex[i] = boundingBox[2 * i];
-      regionSize[i] = boundingBox[2 * i + 1] - boundingBox[2 * i] + 1;
+      if( !smoothings[l].Error.empty() )
+        {
+        std::cout << "ExceptionObject caught !" << std::endl;
+        std::cout << smoothings[l].Error << std::endl;
+        return EXIT_FAILURE;
+        }
       }
 
-    // Create a region corresponding to the bounding box.
-    UCharImageType::RegionType boundingRegion;
-    boundingRegion.SetSize( regionSize );
-    boundingRegion.SetIndex( regionIndex );
-
-    // Extract the region from the image.
-    extracter->SetInput( inputThresholder->GetOutput() );
-    extracter->SetRegionOfInterest( boundingRegion );
-    extracter->ReleaseDataFlagOn();
-    extracter->Update();
-
-    FloatImageType::Pointer antiAliasImage;
+    // Paste the smoothed labels in an empty label map. Where smoothed
+    // labels overlap, the voxel goes to the label with the highest
+    // level set value.
+    UCharImageType::Pointer outputImage = UCharImageType::New();
+    outputImage->CopyInformation( inputImage );
+    outputImage->SetRegions( inputImage->GetLargestPossibleRegion() );
+    outputImage->Allocate();
+    outputImage->FillBuffer( 0 );
+    std::map<int, size_t> labelSmoothings;
+    for( size_t l = 0; l < smoothings.size(); ++l )
       {
-      antiAliasFilter->SetInput( extracter->GetOutput() );
-      antiAliasFilter->SetMaximumRMSError( maxRMSError );
-      antiAliasFilter->SetNumberOfIterations( numberOfIterations );
-      antiAliasFilter->SetNumberOfLayers( numberOfLayers );
-      antiAliasFilter->ReleaseDataFlagOn();
-      antiAliasFilter->Update();
-
-      antiAliasImage = antiAliasFilter->GetOutput();
-      antiAliasImage->DisconnectPipeline();
+      const unsigned char outputLabel = binaryOutput ? 1 : smoothings[l].Label;
+      labelSmoothings[outputLabel] = l;
+      itk::ImageRegionConstIteratorWithIndex<FloatImageType> smoothedIt(
+        smoothings[l].Smoothed, smoothings[l].Smoothed->GetBufferedRegion() );
+      for( ; !smoothedIt.IsAtEnd(); ++smoothedIt )
+        {
+        if( !(smoothedIt.Get() >= 0) )
+          {
+          continue;
+          }
+        UCharImageType::IndexType index = smoothings[l].Region.GetIndex();
+        for( unsigned int i = 0; i < ImageDimension; i++ )
+          {
+          index[i] += smoothedIt.GetIndex()[i] - smoothings[l].Smoothed->GetBufferedRegion().GetIndex()[i];
+          }
+        const unsigned char currentLabel = outputImage->GetPixel( index );
+        if( currentLabel != 0 && currentLabel != outputLabel )
+          {
+          const LabelSmoothing& other = smoothings[labelSmoothings[currentLabel]];
+          FloatImageType::IndexType otherIndex = other.Smoothed->GetBufferedRegion().GetIndex();
+          for( unsigned int i = 0; i < ImageDimension; i++ )
+            {
+            otherIndex[i] += index[i] - other.Region.GetIndex()[i];
+            }
+          if( other.Smoothed->GetPixel( otherIndex ) >= smoothedIt.Get() )
+            {
+            continue;
+            }
+          }
+        outputImage->SetPixel( index, outputLabel );
+        }
       }
 
-    gaussianFilter->SetInput( antiAliasImage );
-    gaussianFilter->SetVariance( gaussianSigma * gaussianSigma );
-    gaussianFilter->ReleaseDataFlagOn();
-    gaussianFilter->Update();
-
-    outputThresholder->SetInput( gaussianFilter->GetOutput() );
-    outputThresholder->SetLowerThreshold( 0 );
-    outputThresholder->SetInsideValue( 1 );
-    outputThresholder->SetOutsideValue( 0 );
-    outputThresholder->ReleaseDataFlagOn();
-    outputThresholder->Update();
-
-    // Paste the smoothed result back into the original thresholded
-    // image.  This is done rather than creating a new volume to save
-    // memory.  Since the bounding box ensures that the entire region of
-    // the inputThresholder image is included, the pasting will cover
-    // all foreground regions.
-    paster->SetDestinationImage( inputThresholder->GetOutput() );
-    paster->SetSourceImage( outputThresholder->GetOutput() );
-    paster->SetSourceRegion( outputThresholder->GetOutput()->GetRequestedRegion() );
-    paster->SetDestinationIndex( regionIndex );
-    paster->ReleaseDataFlagOn();
-    paster->Update();
-
-    writer->SetInput( paster->GetOutput() );
+    writer->SetInput( outputImage );
     writer->SetFileName( outputVolume.c_str() );
     writer->SetUseCompression(1);
     writer->Update();
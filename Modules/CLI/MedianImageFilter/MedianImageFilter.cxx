@@ -17,6 +17,8 @@
 #include "itkPluginUtilities.h"
 #include "itkImageFileWriter.h"
 #include "itkMedianImageFilter.h"
+#include "itkMultiThreader.h"
+#include "itkRankImageFilter.h"
 
 #include "MedianImageFilterCLP.h"
 
@@ -28,11 +30,20 @@
 namespace
 {
 
+// Neighborhood size (number of voxels) from which the moving histogram
+// median is faster than sorting the neighborhood of each voxel.
+const unsigned long HistogramMedianMinimumNeighborhoodSize = 7 * 7 * 7;
+
 template <class T>
 int DoIt( int argc, char * argv[], T )
 {
   PARSE_ARGS;
 
+  if( numberOfThreads > 0 )
+    {
+    itk::MultiThreader::SetGlobalDefaultNumberOfThreads( numberOfThreads );
+    }
+
   typedef itk::Image<T, 3> InputImageType;
   typedef itk::Image<T, 3> OutputImageType;
 
@@ -45,6 +56,35 @@ int DoIt( int argc, char * argv[], T )
   reader->SetFileName( inputVolume.c_str() );
   writer->SetFileName( outputVolume.c_str() );
 
+  typename InputImageType::SizeType indexRadius;
+
+  indexRadius[0] = neighborhood[0]; // radius along x
+  indexRadius[1] = neighborhood[1]; // radius along y
+  indexRadius[2] = neighborhood[2]; // radius along slice
+
+  const unsigned long neighborhoodSize =
+    (2 * indexRadius[0] + 1) * (2 * indexRadius[1] + 1) * (2 * indexRadius[2] + 1);
+  if( neighborhoodSize >= HistogramMedianMinimumNeighborhoodSize )
+    {
+    // The histogram is updated incrementally when the neighborhood moves,
+    // only the voxels entering and leaving the neighborhood are visited.
+    typedef itk::RankImageFilter<
+      InputImageType, OutputImageType>  FilterType;
+
+    typename FilterType::Pointer filter = FilterType::New();
+
+    itk::PluginFilterWatcher watcher(filter, "Median Image Filter",
+                                     CLPProcessInformation);
+
+    filter->SetRadius( indexRadius );
+    filter->SetRank( 0.5 );
+    filter->SetInput( reader->GetOutput() );
+    writer->SetInput( filter->GetOutput() );
+    writer->SetUseCompression(1);
+    writer->Update();
+    return EXIT_SUCCESS;
+    }
+
   typedef itk::MedianImageFilter<
     InputImageType, OutputImageType>  FilterType;
 
@@ -53,12 +93,6 @@ int DoIt( int argc, char * argv[], T )
   itk::PluginFilterWatcher watcher(filter, "Median Image Filter",
                                    CLPProcessInformation);
 
-  typename InputImageType::SizeType indexRadius;
-
-  indexRadius[0] = neighborhood[0]; // radius along x
-  indexRadius[1] = neighborhood[1]; // radius along y
-  indexRadius[2] = neighborhood[2]; // radius along slice
-
   filter->SetRadius( indexRadius );
   filter->SetInput( reader->GetOutput() );
   writer->SetInput( filter->GetOutput() );
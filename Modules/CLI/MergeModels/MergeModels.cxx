@@ -20,16 +20,15 @@
 
 #include "MergeModelsCLP.h"
 
+// SlicerBaseCLI includes
+#include <vtkPluginPolyDataIO.h>
+
 // VTK includes
-#include <vtkAlgorithmOutput.h>
 #include <vtkAppendPolyData.h>
 #include <vtkDebugLeaks.h>
-#include <vtkPolyDataReader.h>
-#include <vtkPolyDataWriter.h>
-#include <vtkXMLPolyDataReader.h>
-#include <vtkXMLPolyDataWriter.h>
+#include <vtkNew.h>
+#include <vtkPolyData.h>
 #include <vtkVersion.h>
-#include <vtksys/SystemTools.hxx>
 
 int main( int argc, char * argv[] )
 {
@@ -37,99 +36,33 @@ int main( int argc, char * argv[] )
 
   vtkDebugLeaks::SetExitError(true);
 
-  vtkAlgorithmOutput* reader1 = NULL;
-  vtkAlgorithmOutput* reader2 = NULL;
-
-  // do we have vtk or vtp models?
-  std::string extension = vtksys::SystemTools::LowerCase(
-    vtksys::SystemTools::GetFilenameLastExtension(Model1) );
-  if( extension.empty() )
-    {
-    std::cerr << "Failed to find an extension for " << Model1 << std::endl;
-    return EXIT_FAILURE;
-    }
-
-  // read the first poly data
-  if( extension == std::string(".vtk") )
-    {
-    vtkPolyDataReader* pdReader1 = vtkPolyDataReader::New();
-    pdReader1->SetFileName(Model1.c_str() );
-    pdReader1->Update();
-    reader1 = pdReader1->GetOutputPort();
-    }
-  else if( extension == std::string(".vtp") )
-    {
-    vtkXMLPolyDataReader* pdxReader1 = vtkXMLPolyDataReader::New();
-    pdxReader1->SetFileName(Model1.c_str() );
-    pdxReader1->Update();
-    reader1 = pdxReader1->GetOutputPort();
-    }
-  if( reader1->GetProducer()->GetErrorCode() != 0 )
+  // read the poly data, either from files (.vtk or .vtp) or directly from
+  // memory when run as a shared object module
+  vtkNew<vtkPolyData> model1;
+  if( !vtkPluginPolyDataIO::ReadPolyData(Model1, model1.GetPointer()) )
     {
     std::cerr << "Failed to read model 1 " << Model1 << std::endl;
     return EXIT_FAILURE;
     }
-  // read the second poly data
-
-  extension = vtksys::SystemTools::LowerCase( vtksys::SystemTools::GetFilenameLastExtension(Model2) );
-  if( extension.empty() )
+  vtkNew<vtkPolyData> model2;
+  if( !vtkPluginPolyDataIO::ReadPolyData(Model2, model2.GetPointer()) )
     {
-    std::cerr << "Failed to find an extension for " << Model2 << std::endl;
-    return EXIT_FAILURE;
-    }
-  if( extension == std::string(".vtk") )
-    {
-    vtkPolyDataReader* pdReader2 = vtkPolyDataReader::New();
-    pdReader2->SetFileName(Model2.c_str() );
-    pdReader2->Update();
-    reader2 = pdReader2->GetOutputPort();
-    }
-  else if( extension == std::string(".vtp") )
-    {
-    vtkXMLPolyDataReader* pdxReader2 = vtkXMLPolyDataReader::New();
-    pdxReader2->SetFileName(Model2.c_str() );
-    pdxReader2->Update();
-    reader2 = pdxReader2->GetOutputPort();
-    }
-  if( reader2->GetProducer()->GetErrorCode() != 0 )
-    {
-    std::cerr << "Failed to read model 1 " << Model2 << std::endl;
+    std::cerr << "Failed to read model 2 " << Model2 << std::endl;
     return EXIT_FAILURE;
     }
+
   // add them together
-  vtkAppendPolyData *add = vtkAppendPolyData::New();
-  add->AddInputConnection(reader1);
-  add->AddInputConnection(reader2);
+  vtkNew<vtkAppendPolyData> add;
+  add->AddInputData(model1.GetPointer());
+  add->AddInputData(model2.GetPointer());
   add->Update();
 
   // write the output
-  extension = vtksys::SystemTools::LowerCase( vtksys::SystemTools::GetFilenameLastExtension(ModelOutput) );
-  if( extension.empty() )
+  if( !vtkPluginPolyDataIO::WritePolyData(ModelOutput, add->GetOutput()) )
     {
-    std::cerr << "Failed to find an extension for " << ModelOutput << std::endl;
+    std::cerr << "Failed to write output model " << ModelOutput << std::endl;
     return EXIT_FAILURE;
     }
-  if( extension == std::string(".vtk") )
-    {
-    vtkPolyDataWriter *pdWriter = vtkPolyDataWriter::New();
-    pdWriter->SetFileName(ModelOutput.c_str() );
-    pdWriter->SetInputConnection(add->GetOutputPort() );
-    pdWriter->Write();
-    pdWriter->Delete();
-    }
-  else if( extension == std::string(".vtp") )
-    {
-    vtkXMLPolyDataWriter *pdWriter = vtkXMLPolyDataWriter::New();
-    pdWriter->SetIdTypeToInt32();
-    pdWriter->SetFileName(ModelOutput.c_str() );
-    pdWriter->SetInputConnection(add->GetOutputPort() );
-    pdWriter->Write();
-    pdWriter->Delete();
-    }
 
-  // clean up
-  add->Delete();
-  reader1->GetProducer()->Delete();
-  reader2->GetProducer()->Delete();
   return EXIT_SUCCESS;
 }
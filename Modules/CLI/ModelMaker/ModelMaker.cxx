@@ -36,6 +36,7 @@ Version:   $Revision$
 #include <vtkGeometryFilter.h>
 #include <vtkImageAccumulate.h>
 #include <vtkImageChangeInformation.h>
+#include <vtkImageClip.h>
 #include <vtkImageConstantPad.h>
 #include <vtkImageData.h>
 #include <vtkImageThreshold.h>
@@ -61,6 +62,55 @@ Version:   $Revision$
 // VTKsys includes
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace
+{
+
+typedef std::map<int, std::vector<int> > LabelExtentsType;
+
+//----------------------------------------------------------------------------
+// Compute the extent of the voxels of each (integer) label in a single pass
+template <class T>
+void ComputeLabelExtents(vtkImageData* image, T* ptr, LabelExtentsType& labelExtents)
+{
+  int extent[6];
+  image->GetExtent(extent);
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      for (int i = extent[0]; i <= extent[1]; ++i, ++ptr)
+        {
+        int label = static_cast<int>(*ptr);
+        if (static_cast<T>(label) != *ptr)
+          {
+          continue;
+          }
+        LabelExtentsType::iterator it = labelExtents.find(label);
+        if (it == labelExtents.end())
+          {
+          int labelExtent[6] = {i, i, j, j, k, k};
+          labelExtents[label] = std::vector<int>(labelExtent, labelExtent + 6);
+          continue;
+          }
+        std::vector<int>& labelExtent = it->second;
+        labelExtent[0] = std::min(labelExtent[0], i);
+        labelExtent[1] = std::max(labelExtent[1], i);
+        labelExtent[2] = std::min(labelExtent[2], j);
+        labelExtent[3] = std::max(labelExtent[3], j);
+        labelExtent[4] = std::min(labelExtent[4], k);
+        labelExtent[5] = std::max(labelExtent[5], k);
+        }
+      }
+    }
+}
+
+}
+
 int main(int argc, char * argv[])
 {
   PARSE_ARGS;
@@ -285,6 +335,7 @@ int main(int argc, char * argv[])
   vtkSmartPointer<vtkDecimatePro>             decimator;
   vtkSmartPointer<vtkMarchingCubes>           mcubes;
   vtkSmartPointer<vtkImageThreshold>          imageThreshold;
+  vtkSmartPointer<vtkImageClip>               labelClip;
   vtkSmartPointer<vtkThreshold>               threshold;
   vtkSmartPointer<vtkImageToStructuredPoints> imageToStructuredPoints;
   vtkSmartPointer<vtkGeometryFilter>          geometryFilter;
@@ -849,6 +900,22 @@ int main(int argc, char * argv[])
     }
   transformIJKtoRAS->Inverse();
 
+  // Compute the extent of all the labels at once so that each label is
+  // only thresholded and contoured around its own voxels, instead of over
+  // the whole volume.
+  LabelExtentsType labelExtents;
+  if (JointSmoothing == 0 && image->GetNumberOfScalarComponents() == 1)
+    {
+    switch (image->GetScalarType())
+      {
+      vtkTemplateMacro(ComputeLabelExtents(image,
+                                           static_cast<VTK_TT*>(image->GetScalarPointer()),
+                                           labelExtents));
+      default:
+        break;
+      }
+    }
+
   //
   // Loop through all the labels
   //
@@ -1000,7 +1067,44 @@ int main(int argc, char * argv[])
         {
         watchImageThreshold.QuietOn();
         }
-      if (Pad)
+      if (labelClip)
+        {
+        labelClip->SetInputData(NULL);
+        labelClip = NULL;
+        }
+      LabelExtentsType::const_iterator labelExtentIt = labelExtents.find(i);
+      if (labelExtentIt != labelExtents.end())
+        {
+        // Clip to the label voxels, with a margin of empty voxels to close
+        // the surface, in the (possibly padded) threshold input extent.
+        labelClip = vtkSmartPointer<vtkImageClip>::New();
+        int wholeExtent[6] = {extents[0], extents[1], extents[2], extents[3], extents[4], extents[5]};
+        int shift = 0;
+        if (Pad)
+          {
+          labelClip->SetInputConnection(padder->GetOutputPort());
+          wholeExtent[1] += 2;
+          wholeExtent[3] += 2;
+          wholeExtent[5] += 2;
+          shift = 1;
+          }
+        else
+          {
+          labelClip->SetInputData(image);
+          }
+        int clipExtent[6];
+        for (int axis = 0; axis < 3; ++axis)
+          {
+          clipExtent[2 * axis] = std::max(
+            labelExtentIt->second[2 * axis] + shift - 1, wholeExtent[2 * axis]);
+          clipExtent[2 * axis + 1] = std::min(
+            labelExtentIt->second[2 * axis + 1] + shift + 1, wholeExtent[2 * axis + 1]);
+          }
+        labelClip->SetOutputWholeExtent(clipExtent);
+        labelClip->ClipDataOn();
+        imageThreshold->SetInputConnection(labelClip->GetOutputPort());
+        }
+      else if (Pad)
         {
         imageThreshold->SetInputConnection(padder->GetOutputPort());
         }
@@ -1885,6 +1989,11 @@ int main(int argc, char * argv[])
       std::cout << "... done deleting image threshold" << endl;
       }
     }
+  if (labelClip)
+    {
+    labelClip->SetInputData(NULL);
+    labelClip = NULL;
+    }
   if (threshold)
     {
     if (debug)
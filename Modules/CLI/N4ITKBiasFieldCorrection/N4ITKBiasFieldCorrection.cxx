@@ -1,6 +1,7 @@
 #include "itkConstantPadImageFilter.h"
 #include "itkExtractImageFilter.h"
 #include "itkImageFileWriter.h"
+#include "itkMultiThreader.h"
 #include "itkN4BiasFieldCorrectionImageFilter.h"
 #include "itkOtsuThresholdImageFilter.h"
 #include "itkShrinkImageFilter.h"
@@ -67,6 +68,11 @@ int main(int argc, char* * argv)
 
   PARSE_ARGS;
 
+  if( numberOfThreads > 0 )
+    {
+    itk::MultiThreader::SetGlobalDefaultNumberOfThreads( numberOfThreads );
+    }
+
   ImageType::Pointer inputImage = NULL;
 
   typedef itk::Image<unsigned char, ImageDimension> MaskImageType;
@@ -322,6 +328,10 @@ int main(int argc, char* * argv)
      * Reconsruct the bias field at full image resoluion.  Divide
      * the original input image by the bias field to get the final
      * corrected image.
+     *
+     * Full resolution images can be large, therefore the bias field is
+     * computed into a single image and the input image is corrected in
+     * place, instead of creating an intermediate image at each step.
      */
     typedef itk::BSplineControlPointImageFilter<
       CorrecterType::BiasFieldControlPointLatticeType,
@@ -335,57 +345,59 @@ int main(int argc, char* * argv)
     bspliner->SetSpacing( inputImage->GetSpacing() );
     bspliner->Update();
 
-    ImageType::Pointer logField = ImageType::New();
-    logField->SetOrigin( inputImage->GetOrigin() );
-    logField->SetSpacing( inputImage->GetSpacing() );
-    logField->SetRegions( inputImage->GetLargestPossibleRegion() );
-    logField->SetDirection( inputImage->GetDirection() );
-    logField->Allocate();
+    ImageType::Pointer biasField = ImageType::New();
+    biasField->SetOrigin( inputImage->GetOrigin() );
+    biasField->SetSpacing( inputImage->GetSpacing() );
+    biasField->SetRegions( inputImage->GetLargestPossibleRegion() );
+    biasField->SetDirection( inputImage->GetDirection() );
+    biasField->Allocate();
 
     itk::ImageRegionIterator<CorrecterType::ScalarImageType> IB(
       bspliner->GetOutput(),
       bspliner->GetOutput()->GetLargestPossibleRegion() );
-    itk::ImageRegionIterator<ImageType> IF( logField,
-                                            logField->GetLargestPossibleRegion() );
-    for( IB.GoToBegin(), IF.GoToBegin(); !IB.IsAtEnd(); ++IB, ++IF )
+    itk::ImageRegionIterator<ImageType> IF( biasField,
+                                            biasField->GetLargestPossibleRegion() );
+    itk::ImageRegionIterator<ImageType> II( inputImage,
+                                            inputImage->GetLargestPossibleRegion() );
+    for( IB.GoToBegin(), IF.GoToBegin(), II.GoToBegin(); !IB.IsAtEnd(); ++IB, ++IF, ++II )
       {
-      IF.Set( IB.Get()[0] );
+      const RealType bias = std::exp( IB.Get()[0] );
+      IF.Set( bias );
+      II.Set( II.Get() / bias );
       }
-
-    typedef itk::ExpImageFilter<ImageType, ImageType> ExpFilterType;
-    ExpFilterType::Pointer expFilter = ExpFilterType::New();
-    expFilter->SetInput( logField );
-    expFilter->Update();
-
-    typedef itk::DivideImageFilter<ImageType, ImageType, ImageType> DividerType;
-    DividerType::Pointer divider = DividerType::New();
-    divider->SetInput1( inputImage );
-    divider->SetInput2( expFilter->GetOutput() );
-    divider->Update();
+    // The log bias field is not needed anymore
+    bspliner = NULL;
 
     ImageType::RegionType inputRegion;
     inputRegion.SetIndex( inputImageIndex );
     inputRegion.SetSize( inputImageSize );
 
-    typedef itk::ExtractImageFilter<ImageType, ImageType> CropperType;
-    CropperType::Pointer cropper = CropperType::New();
-    cropper->SetInput( divider->GetOutput() );
-    cropper->SetExtractionRegion( inputRegion );
-    cropper->SetDirectionCollapseToSubmatrix();
-    cropper->Update();
-
-    CropperType::Pointer biasFieldCropper = CropperType::New();
-    biasFieldCropper->SetInput( expFilter->GetOutput() );
-    biasFieldCropper->SetExtractionRegion( inputRegion );
-    biasFieldCropper->SetDirectionCollapseToSubmatrix();
-    biasFieldCropper->Update();
+    // Crop the images to the original region if they have been padded (when spline distance is specified)
+    ImageType::Pointer correctedImage = inputImage;
+    if( inputImage->GetLargestPossibleRegion() != inputRegion )
+      {
+      typedef itk::ExtractImageFilter<ImageType, ImageType> CropperType;
+      CropperType::Pointer cropper = CropperType::New();
+      cropper->SetInput( inputImage );
+      cropper->SetExtractionRegion( inputRegion );
+      cropper->SetDirectionCollapseToSubmatrix();
+      cropper->Update();
+      correctedImage = cropper->GetOutput();
+
+      CropperType::Pointer biasFieldCropper = CropperType::New();
+      biasFieldCropper->SetInput( biasField );
+      biasFieldCropper->SetExtractionRegion( inputRegion );
+      biasFieldCropper->SetDirectionCollapseToSubmatrix();
+      biasFieldCropper->Update();
+      biasField = biasFieldCropper->GetOutput();
+      }
 
     if( outputBiasFieldName != "" )
       {
       typedef itk::ImageFileWriter<ImageType> WriterType;
       WriterType::Pointer writer = WriterType::New();
       writer->SetFileName( outputBiasFieldName.c_str() );
-      writer->SetInput( biasFieldCropper->GetOutput() );
+      writer->SetInput( biasField );
       writer->SetUseCompression(1);
       writer->Update();
       }
@@ -402,7 +414,7 @@ int main(int argc, char* * argv)
       // signed types
       const char *fname = outputImageName.c_str();
 
-      return SaveIt(cropper->GetOutput(), fname);
+      return SaveIt(correctedImage, fname);
       }
     catch( itk::ExceptionObject & e )
       {
@@ -16,11 +16,11 @@
 
 // VTK includes
 #include <vtkGlobFileNames.h>
-#include <vtkImageAccumulate.h>
+#include <vtkDataArray.h>
 #include <vtkImageData.h>
-#include <vtkImageThreshold.h>
-#include <vtkImageToImageStencil.h>
+#include <vtkMultiThreader.h>
 #include <vtkNew.h>
+#include <vtkPointData.h>
 #include <vtkVersion.h>
 
 // ITK includes
@@ -737,21 +737,12 @@ double DecayCorrection(parameters & list, double inVal )
 // ...
 // ...............................................................................................
 // ...
-std::string MapLabelIDtoColorName( int id, std::string colorFile )
+std::string MapLabelIDtoColorName( int id, vtkMRMLColorTableNode* colorNode )
 {
   // use the colour table that was passed in with the VOI volume
 
   std::string colorName;
-
-  vtkNew<vtkMRMLColorTableNode> colorNode;
-  vtkNew<vtkMRMLColorTableStorageNode> colorStorageNode;
-  colorStorageNode->SetFileName(colorFile.c_str() );
-
-  if( !colorStorageNode->ReadData(colorNode.GetPointer()) )
-    {
-    std::cerr << "Error reading colour file " << colorStorageNode->GetFileName() << endl;
-    }
-  else
+  if( colorNode && colorNode->GetColorName(id) )
     {
     colorName = colorNode->GetColorName(id);
     }
@@ -761,88 +752,24 @@ std::string MapLabelIDtoColorName( int id, std::string colorFile )
 // ...
 // ...............................................................................................
 // ...
-template <class T>
-int LoadImagesAndComputeSUV( parameters & list, T )
+bool ReadColorTable( std::string colorFile, vtkMRMLColorTableNode* colorNode )
 {
-  //
-  // for writing csv output files
-  //
-  std::string   outputFile = list.SUVOutputTable;
-  std::ofstream ofile;
-  std::string  outputStringFile = list.SUVOutputStringFile;
-  std::ofstream stringFile;
-  vtkImageData *                    petVolume;
-  vtkImageData *                    voiVolume;
-  vtkITKArchetypeImageSeriesReader *reader1 = NULL;
-  vtkITKArchetypeImageSeriesReader *reader2 = NULL;
-  vtkAlgorithmOutput* petVolumeConnection = 0;
-  vtkAlgorithmOutput* voiVolumeConnection = 0;
-
-  // check for the input files
-  FILE * petfile;
-  petfile = fopen(list.PETVolumeName.c_str(), "r");
-  if( petfile == NULL )
-    {
-    std::cerr << "ERROR: cannot open input volume file '" << list.PETVolumeName.c_str() << "'" << endl;
-    return EXIT_FAILURE;
-    }
-  fclose(petfile);
-
-  FILE * voifile;
-  voifile = fopen(list.VOIVolumeName.c_str(), "r");
-  if( voifile == NULL )
-    {
-    std::cerr << "ERROR: cannot open ROI Volume  file '" << list.VOIVolumeName.c_str() << "'" << endl;
-    return EXIT_FAILURE;
-    }
-  fclose(voifile);
-
-  // Read the PET file
-
-  reader1 = vtkITKArchetypeImageSeriesScalarReader::New();
-//    vtkPluginFilterWatcher watchReader1 ( reader1, "Reading PET Volume", CLPProcessInformation );
-  reader1->SetArchetype(list.PETVolumeName.c_str() );
-  reader1->SetOutputScalarTypeToNative();
-  reader1->SetDesiredCoordinateOrientationToNative();
-  reader1->SetUseNativeOriginOn();
-  reader1->Update();
-  std::cout << "Done reading the file " << list.PETVolumeName.c_str() << endl;
-
-
-  // Read the VOI file
-  reader2 = vtkITKArchetypeImageSeriesScalarReader::New();
-//    vtkPluginFilterWatcher watchReader2 ( reader2, "Reading VOI Volume", CLPProcessInformation );
-  reader2->SetArchetype(list.VOIVolumeName.c_str() );
-  reader2->SetOutputScalarTypeToNative();
-  reader2->SetDesiredCoordinateOrientationToNative();
-  reader2->SetUseNativeOriginOn();
-  reader2->Update();
-  std::cout << "Done reading the file " << list.VOIVolumeName.c_str() << endl;
-
-  // stuff the images.
-  petVolume = reader1->GetOutput();
-  petVolumeConnection = reader1->GetOutputPort();
-  voiVolume = reader2->GetOutput();
-  voiVolumeConnection = reader2->GetOutputPort();
-
-
-  //
-  // COMPUTE SUV ///////////////////////////////////////////////////////////////////////////////RSNA CHANGE//////////////////////////
-  //
-
-  if( petVolume == NULL )
-    {
-    std::cerr << "No input PET volume found." << std::endl;
-    return EXIT_FAILURE;
-    }
+  vtkNew<vtkMRMLColorTableStorageNode> colorStorageNode;
+  colorStorageNode->SetFileName(colorFile.c_str() );
 
-  // find input labelmap volume
-  if( voiVolume == NULL )
+  if( !colorStorageNode->ReadData(colorNode) )
     {
-    std::cerr <<  "No input VOI volume found" << std::endl;
-    return EXIT_FAILURE;
+    std::cerr << "Error reading colour file " << colorStorageNode->GetFileName() << endl;
+    return false;
     }
+  return true;
+}
 
+// ...
+// ...............................................................................................
+// ...
+int ReadRadiopharmaceuticalParameters( parameters & list )
+{
   // read the DICOM dir to get the radiological data
 
   typedef short PixelValueType;
@@ -1337,6 +1264,261 @@ int LoadImagesAndComputeSUV( parameters & list, T )
     return EXIT_FAILURE;
     }
 
+  return EXIT_SUCCESS;
+}
+
+// ...
+// ...............................................................................................
+// ...
+// The DICOM headers are parsed once per series, the batch mode reuses them
+// for the volumes of the same series.
+typedef std::map<std::string, parameters> ParametersCacheType;
+
+int GetRadiopharmaceuticalParameters( parameters & list, ParametersCacheType & cache )
+{
+  ParametersCacheType::iterator cached = cache.find(list.PETDICOMPath);
+  if( cached == cache.end() )
+    {
+    if( ReadRadiopharmaceuticalParameters(list) != EXIT_SUCCESS )
+      {
+      return EXIT_FAILURE;
+      }
+    cache[list.PETDICOMPath] = list;
+    return EXIT_SUCCESS;
+    }
+  parameters fileNames = list;
+  list = cached->second;
+  list.PETVolumeName = fileNames.PETVolumeName;
+  list.VOIVolumeName = fileNames.VOIVolumeName;
+  list.VOIVolumeColorTableFile = fileNames.VOIVolumeColorTableFile;
+  list.SUVOutputTable = fileNames.SUVOutputTable;
+  list.SUVOutputStringFile = fileNames.SUVOutputStringFile;
+  std::cout << "Reusing the DICOM parameters of " << list.PETDICOMPath << std::endl;
+  return EXIT_SUCCESS;
+}
+
+// ...
+// ...............................................................................................
+// ...
+// PET statistics of one label
+struct LabelStatistics
+{
+  LabelStatistics() : Count(0), Min(0.0), Max(0.0), Sum(0.0) {}
+  vtkIdType Count;
+  double    Min;
+  double    Max;
+  double    Sum;
+
+  void Add( double value )
+  {
+    if( this->Count == 0 || value < this->Min )
+      {
+      this->Min = value;
+      }
+    if( this->Count == 0 || value > this->Max )
+      {
+      this->Max = value;
+      }
+    this->Sum += value;
+    ++this->Count;
+  }
+
+  void Add( const LabelStatistics & other )
+  {
+    if( other.Count == 0 )
+      {
+      return;
+      }
+    if( this->Count == 0 || other.Min < this->Min )
+      {
+      this->Min = other.Min;
+      }
+    if( this->Count == 0 || other.Max > this->Max )
+      {
+      this->Max = other.Max;
+      }
+    this->Sum += other.Sum;
+    this->Count += other.Count;
+  }
+};
+
+struct LabelStatisticsPass
+{
+  vtkImageData* PETVolume;
+  const int*    Labels;
+  int           LowestLabel;
+  int           NumberOfLabels;
+  std::vector<std::vector<LabelStatistics> > ThreadStatistics;
+};
+
+template <class T>
+void AccumulateLabelStatistics( const T* pet, const int* labels, vtkIdType first, vtkIdType last,
+                                int lowestLabel, std::vector<LabelStatistics> & statistics )
+{
+  for( vtkIdType v = first; v < last; ++v )
+    {
+    statistics[labels[v] - lowestLabel].Add(static_cast<double>(pet[v]) );
+    }
+}
+
+// Each thread accumulates the statistics of all the labels over a range of
+// voxels, they are merged afterward.
+VTK_THREAD_RETURN_TYPE LabelStatisticsThreadFunction( void* arg )
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  LabelStatisticsPass* pass = static_cast<LabelStatisticsPass*>(info->UserData);
+  std::vector<LabelStatistics> & statistics = pass->ThreadStatistics[info->ThreadID];
+  statistics.resize(pass->NumberOfLabels);
+
+  vtkIdType numberOfVoxels = pass->PETVolume->GetNumberOfPoints();
+  vtkIdType first = numberOfVoxels * info->ThreadID / info->NumberOfThreads;
+  vtkIdType last = numberOfVoxels * (info->ThreadID + 1) / info->NumberOfThreads;
+  void* pet = pass->PETVolume->GetScalarPointer();
+  switch( pass->PETVolume->GetScalarType() )
+    {
+    vtkTemplateMacro(AccumulateLabelStatistics(static_cast<VTK_TT*>(pet), pass->Labels, first, last,
+                                               pass->LowestLabel, statistics) );
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+// ...
+// ...............................................................................................
+// ...
+// Compute the statistics of all the labels of the VOI volume in one pass over
+// the PET volume. statistics[l] is the statistics of the label
+// lowestLabel + l. The VOI volume must have int scalars.
+bool ComputeLabelStatistics( vtkImageData* petVolume, vtkImageData* voiVolume,
+                             int & lowestLabel, std::vector<LabelStatistics> & statistics )
+{
+  int petDimensions[3], voiDimensions[3];
+  petVolume->GetDimensions(petDimensions);
+  voiVolume->GetDimensions(voiDimensions);
+  if( petDimensions[0] != voiDimensions[0] || petDimensions[1] != voiDimensions[1]
+      || petDimensions[2] != voiDimensions[2] )
+    {
+    std::cerr << "The PET volume and the VOI volume have different dimensions." << std::endl;
+    return false;
+    }
+
+  double labelRange[2];
+  voiVolume->GetPointData()->GetScalars()->GetRange(labelRange);
+  LabelStatisticsPass pass;
+  pass.PETVolume = petVolume;
+  pass.Labels = static_cast<const int*>(voiVolume->GetScalarPointer() );
+  pass.LowestLabel = static_cast<int>(labelRange[0]);
+  pass.NumberOfLabels = static_cast<int>(labelRange[1]) - pass.LowestLabel + 1;
+
+  vtkNew<vtkMultiThreader> threader;
+  pass.ThreadStatistics.resize(threader->GetNumberOfThreads() );
+  threader->SetSingleMethod(LabelStatisticsThreadFunction, &pass);
+  threader->SingleMethodExecute();
+
+  lowestLabel = pass.LowestLabel;
+  statistics.clear();
+  statistics.resize(pass.NumberOfLabels);
+  for( size_t t = 0; t < pass.ThreadStatistics.size(); ++t )
+    {
+    for( int l = 0; l < pass.NumberOfLabels; ++l )
+      {
+      statistics[l].Add(pass.ThreadStatistics[t][l]);
+      }
+    }
+  return true;
+}
+
+// ...
+// ...............................................................................................
+// ...
+template <class T>
+int LoadImagesAndComputeSUV( parameters & list, T, ParametersCacheType & parametersCache,
+                             vtkMRMLColorTableNode* colorNode )
+{
+  //
+  // for writing csv output files
+  //
+  std::string   outputFile = list.SUVOutputTable;
+  std::ofstream ofile;
+  std::string  outputStringFile = list.SUVOutputStringFile;
+  std::ofstream stringFile;
+  vtkImageData *                    petVolume;
+  vtkImageData *                    voiVolume;
+  vtkITKArchetypeImageSeriesReader *reader1 = NULL;
+  vtkITKArchetypeImageSeriesReader *reader2 = NULL;
+  vtkAlgorithmOutput* petVolumeConnection = 0;
+  vtkAlgorithmOutput* voiVolumeConnection = 0;
+
+  // check for the input files
+  FILE * petfile;
+  petfile = fopen(list.PETVolumeName.c_str(), "r");
+  if( petfile == NULL )
+    {
+    std::cerr << "ERROR: cannot open input volume file '" << list.PETVolumeName.c_str() << "'" << endl;
+    return EXIT_FAILURE;
+    }
+  fclose(petfile);
+
+  FILE * voifile;
+  voifile = fopen(list.VOIVolumeName.c_str(), "r");
+  if( voifile == NULL )
+    {
+    std::cerr << "ERROR: cannot open ROI Volume  file '" << list.VOIVolumeName.c_str() << "'" << endl;
+    return EXIT_FAILURE;
+    }
+  fclose(voifile);
+
+  // Read the PET file
+
+  reader1 = vtkITKArchetypeImageSeriesScalarReader::New();
+//    vtkPluginFilterWatcher watchReader1 ( reader1, "Reading PET Volume", CLPProcessInformation );
+  reader1->SetArchetype(list.PETVolumeName.c_str() );
+  reader1->SetOutputScalarTypeToNative();
+  reader1->SetDesiredCoordinateOrientationToNative();
+  reader1->SetUseNativeOriginOn();
+  reader1->Update();
+  std::cout << "Done reading the file " << list.PETVolumeName.c_str() << endl;
+
+
+  // Read the VOI file
+  reader2 = vtkITKArchetypeImageSeriesScalarReader::New();
+//    vtkPluginFilterWatcher watchReader2 ( reader2, "Reading VOI Volume", CLPProcessInformation );
+  reader2->SetArchetype(list.VOIVolumeName.c_str() );
+  reader2->SetOutputScalarTypeToInt();
+  reader2->SetDesiredCoordinateOrientationToNative();
+  reader2->SetUseNativeOriginOn();
+  reader2->Update();
+  std::cout << "Done reading the file " << list.VOIVolumeName.c_str() << endl;
+
+  // stuff the images.
+  petVolume = reader1->GetOutput();
+  petVolumeConnection = reader1->GetOutputPort();
+  voiVolume = reader2->GetOutput();
+  voiVolumeConnection = reader2->GetOutputPort();
+
+
+  //
+  // COMPUTE SUV ///////////////////////////////////////////////////////////////////////////////RSNA CHANGE//////////////////////////
+  //
+
+  if( petVolume == NULL )
+    {
+    std::cerr << "No input PET volume found." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // find input labelmap volume
+  if( voiVolume == NULL )
+    {
+    std::cerr <<  "No input VOI volume found" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // read the DICOM dir to get the radiological data, or reuse it
+  if( GetRadiopharmaceuticalParameters(list, parametersCache) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
   double suvmax, suvmin, suvmean;
 
   // make up a string with output to return
@@ -1346,13 +1528,34 @@ int LoadImagesAndComputeSUV( parameters & list, T )
   std::string outputSUVMeanString = "SUVMean = ";
   std::string outputSUVMinString = "SUVMin = ";
 
-  // --- find the max and min label in mask
-  vtkImageAccumulate *stataccum = vtkImageAccumulate::New();
-  stataccum->SetInputConnection( voiVolumeConnection );
-  stataccum->Update();
-  int lo = static_cast<int>(stataccum->GetMin()[0]);
-  int hi = static_cast<int>(stataccum->GetMax()[0]);
-  stataccum->Delete();
+  // --- statistics of all the labels in mask
+  int lo = 0;
+  std::vector<LabelStatistics> labelStatistics;
+  if( !ComputeLabelStatistics(petVolume, voiVolume, lo, labelStatistics) )
+    {
+    return EXIT_FAILURE;
+    }
+  int hi = lo + static_cast<int>(labelStatistics.size() ) - 1;
+
+  // open file containing suvs and append to it.
+  if (outputFile.compare("") != 0)
+    {
+    ofile.open( outputFile.c_str(), ios::out | ios::app );
+    if( !ofile.is_open() )
+      {
+      // report error
+      std::cerr << "ERROR: cannot open nuclear medicine output csv parameter file '" << outputFile.c_str() << "', see return strings for values" << std::endl;
+      }
+    else
+      {
+      ofile.seekp(0,ios::end);
+      long pos = ofile.tellp();
+      if (pos == 0)
+        {
+        ofile << "patientID,studyDate,dose,labelID,suvmin,suvmax,suvmean,labelName" << std::endl;
+        }
+      }
+    }
 
   std::string labelName;
   int         NumberOfVOIs = 0;
@@ -1366,7 +1569,7 @@ int LoadImagesAndComputeSUV( parameters & list, T )
       }
 
     labelName.clear();
-    labelName = MapLabelIDtoColorName(i, list.VOIVolumeColorTableFile);
+    labelName = MapLabelIDtoColorName(i, colorNode);
     if( labelName.empty() )
       {
       labelName.clear();
@@ -1378,38 +1581,16 @@ int LoadImagesAndComputeSUV( parameters & list, T )
     suvmax = 0.0;
     suvmean = 0.0;
 
-    // create the binary volume of the label
-    vtkImageThreshold *thresholder = vtkImageThreshold::New();
-    thresholder->SetInputConnection(voiVolumeConnection);
-    thresholder->SetInValue(1);
-    thresholder->SetOutValue(0);
-    thresholder->ReplaceOutOn();
-    thresholder->ThresholdBetween(i, i);
-    thresholder->SetOutputScalarType(petVolume->GetScalarType() );
-    thresholder->Update();
-
-    // use vtk's statistics class with the binary labelmap as a stencil
-    vtkImageToImageStencil *stencil = vtkImageToImageStencil::New();
-    stencil->SetInputConnection(thresholder->GetOutputPort() );
-    stencil->ThresholdBetween(1, 1);
-
-    vtkImageAccumulate *labelstat = vtkImageAccumulate::New();
-    labelstat->SetInputConnection(petVolumeConnection);
-    labelstat->SetInputConnection(1, stencil->GetOutputPort() ); // == SetStencilData()
-    labelstat->Update();
-
-    stencil->Delete();
-
     // --- For how many labels was SUV computed?
 
-    int voxNumber = labelstat->GetVoxelCount();
-    if( voxNumber > 0 )
+    const LabelStatistics & labelstat = labelStatistics[i - lo];
+    if( labelstat.Count > 0 )
       {
       NumberOfVOIs++;
 
-      double CPETmin = (labelstat->GetMin() )[0];
-      double CPETmax = (labelstat->GetMax() )[0];
-      double CPETmean = (labelstat->GetMean() )[0];
+      double CPETmin = labelstat.Min;
+      double CPETmax = labelstat.Max;
+      double CPETmean = labelstat.Sum / labelstat.Count;
 
       // --- we want to use the following units as noted at file top:
       // --- CPET(t) -- tissue radioactivity in pixels-- kBq/mlunits
@@ -1483,41 +1664,22 @@ int LoadImagesAndComputeSUV( parameters & list, T )
 
       // --- write output CSV file
 
-      // open file containing suvs and append to it.
-      if (outputFile.compare("") != 0)
+      if( ofile.is_open() )
         {
-        ofile.open( outputFile.c_str(), ios::out | ios::app );
-        if( !ofile.is_open() )
-          {
-          // report error, clean up, and get out.
-          std::cerr << "ERROR: cannot open nuclear medicine output csv parameter file '" << outputFile.c_str() << "', see return strings for values" << std::endl;
-          }
-        else
-          {
-          ss.str("");
-          ofile.seekp(0,ios::end);
-          long pos = ofile.tellp();
-          if (pos == 0)
-            {
-            ss << "patientID,studyDate,dose,labelID,suvmin,suvmax,suvmean,labelName" << std::endl;
-            }
-          // --- for each value..
-          // --- format looks like:
-          // patientID, studyDate, dose, labelID, suvmin, suvmax, suvmean, labelName
-          // ...
-
-          ss << list.patientName << ", " << list.studyDate << ", " << list.injectedDose  << ", "  << i << ", " << suvmin << ", " << suvmax
-             << ", " << suvmean << ", " << labelName.c_str() << std::endl;
-          ofile << ss.str();
-          ofile.close();
-          std::cout << "Wrote output for label " << labelName.c_str() << " to " << outputFile.c_str() << std::endl;
-          }
+        // --- for each value..
+        // --- format looks like:
+        // patientID, studyDate, dose, labelID, suvmin, suvmax, suvmean, labelName
+        // ...
+        ss << list.patientName << ", " << list.studyDate << ", " << list.injectedDose  << ", "  << i << ", " << suvmin << ", " << suvmax
+           << ", " << suvmean << ", " << labelName.c_str() << std::endl;
+        ofile << ss.str();
+        std::cout << "Wrote output for label " << labelName.c_str() << " to " << outputFile.c_str() << std::endl;
         }
       }
-
-
-    thresholder->Delete();
-    labelstat->Delete();
+    }
+  if( ofile.is_open() )
+    {
+    ofile.close();
     }
   // --- write output return string file
   if (outputStringFile.compare("") != 0)
@@ -1612,7 +1774,49 @@ int main( int argc, char * argv[] )
     // returnParameterFile, write the output strings in there as key = value pairs
     list.SUVOutputStringFile = returnParameterFile;
     std::cout << "list.SUVOutputStringFile = " << list.SUVOutputStringFile << std::endl;
-    LoadImagesAndComputeSUV( list, static_cast<double>(0) );
+
+    // the color table is read once for all the volumes
+    vtkNew<vtkMRMLColorTableNode> colorTable;
+    vtkMRMLColorTableNode* colorNode = NULL;
+    if( ColorTable.compare("") != 0 && ReadColorTable(ColorTable, colorTable.GetPointer() ) )
+      {
+      colorNode = colorTable.GetPointer();
+      }
+
+    // the DICOM headers of a series are parsed once
+    ParametersCacheType parametersCache;
+    if( LoadImagesAndComputeSUV( list, static_cast<double>(0), parametersCache, colorNode ) != EXIT_SUCCESS )
+      {
+      return EXIT_FAILURE;
+      }
+
+    // --- additional studies are appended to the output table
+    if( additionalPETVolumes.size() != additionalPETDICOMPaths.size() ||
+        additionalPETVolumes.size() != additionalLabelMaps.size() )
+      {
+      std::cerr << "Error: the number of additional PET volumes (" << additionalPETVolumes.size()
+                << "), DICOM directories (" << additionalPETDICOMPaths.size()
+                << ") and label maps (" << additionalLabelMaps.size() << ") are different." << std::endl;
+      return EXIT_FAILURE;
+      }
+    if( !additionalPETVolumes.empty() && OutputCSV.compare("") == 0 )
+      {
+      std::cerr << "Error: an output table is required to process additional PET volumes." << std::endl;
+      return EXIT_FAILURE;
+      }
+    for( size_t i = 0; i < additionalPETVolumes.size(); ++i )
+      {
+      list.PETDICOMPath = additionalPETDICOMPaths[i];
+      list.PETVolumeName = additionalPETVolumes[i];
+      list.VOIVolumeName = additionalLabelMaps[i];
+      // the return strings are only written for the first volume
+      list.SUVOutputStringFile = "";
+      std::cout << "Processing additional PET volume " << list.PETVolumeName << std::endl;
+      if( LoadImagesAndComputeSUV( list, static_cast<double>(0), parametersCache, colorNode ) != EXIT_SUCCESS )
+        {
+        return EXIT_FAILURE;
+        }
+      }
     }
 
   catch( itk::ExceptionObject & excep )
@@ -32,6 +32,10 @@ public:
   typedef DiffusionTensor3DLinearInterpolateFunction                                     Self;
   typedef DiffusionTensor3DInterpolateImageFunctionReimplementation<DataType, TCoordRep> Superclass;
   typedef typename Superclass::ImageType                                                 ImageType;
+  typedef typename Superclass::TensorDataType                                            TensorDataType;
+  typedef typename Superclass::DiffusionImageType                                        DiffusionImageType;
+  typedef typename Superclass::ContinuousIndexType                                       ContinuousIndexType;
+  typedef typename DiffusionImageType::IndexType                                         IndexType;
   typedef SmartPointer<Self>                                                             Pointer;
   typedef SmartPointer<const Self>                                                       ConstPointer;
   typedef LinearInterpolateImageFunction<ImageType,
@@ -41,6 +45,18 @@ public:
   itkTypeMacro(DiffusionTensor3DLinearInterpolateFunction, DiffusionTensor3DInterpolateImageFunctionReimplementation);
 
   itkNewMacro(Self);
+
+  /** Evaluate the interpolated tensor at a position
+   *
+   * The weights of the 8 neighboring voxels are computed once and all six tensor
+   * components are interpolated from them, directly from the tensor image.
+   */
+  TensorDataType EvaluateAtContinuousIndex( const ContinuousIndexType & index ) const ITK_OVERRIDE;
+
+  /** Set the input image. It is not separated into component images,
+   * the tensors are interpolated directly. */
+  void SetInputImage( const DiffusionImageType *inputImage ) ITK_OVERRIDE;
+
 protected:
   void AllocateInterpolator() ITK_OVERRIDE;
 
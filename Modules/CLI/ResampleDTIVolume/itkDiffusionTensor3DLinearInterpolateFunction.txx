@@ -15,6 +15,8 @@
 #define __itkDiffusionTensor3DLinearInterpolateFunction_txx
 
 #include "itkDiffusionTensor3DLinearInterpolateFunction.h"
+#include <itkMath.h>
+#include <algorithm>
 
 namespace itk
 {
@@ -31,6 +33,74 @@ DiffusionTensor3DLinearInterpolateFunction<TData, TCoordRep>
     }
 }
 
+template <class TData, class TCoordRep>
+void
+DiffusionTensor3DLinearInterpolateFunction<TData, TCoordRep>
+::SetInputImage( const DiffusionImageType *inputImage )
+{
+  // Skip the separation of the tensor components into 6 images done in the superclass
+  DiffusionTensor3DInterpolateImageFunction<DataType, TCoordRep>::SetInputImage( inputImage );
+}
+
+template <class TData, class TCoordRep>
+typename DiffusionTensor3DLinearInterpolateFunction<TData, TCoordRep>
+::TensorDataType
+DiffusionTensor3DLinearInterpolateFunction<TData, TCoordRep>
+::EvaluateAtContinuousIndex( const ContinuousIndexType & index ) const
+{
+  if( this->m_Image.IsNull() )
+    {
+    itkExceptionMacro( << "No InputImage Set" );
+    }
+  // Same boundary handling as LinearInterpolateImageFunction: neighbors outside
+  // the buffered region are replaced by the closest voxel on the border
+  IndexType baseIndex;
+  double    distance[3];
+  for( int dim = 0; dim < 3; dim++ )
+    {
+    baseIndex[dim] = Math::Floor<typename IndexType::IndexValueType>( index[dim] );
+    if( baseIndex[dim] < this->m_StartIndex[dim] )
+      {
+      baseIndex[dim] = this->m_StartIndex[dim];
+      }
+    distance[dim] = std::min( std::max( index[dim] - static_cast<double>( baseIndex[dim] ), 0.0 ), 1.0 );
+    }
+  double sum[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+  for( int corner = 0; corner < 8; corner++ )
+    {
+    IndexType neighborIndex;
+    double    weight = 1.0;
+    for( int dim = 0; dim < 3; dim++ )
+      {
+      if( corner & ( 1 << dim ) )
+        {
+        neighborIndex[dim] = std::min( baseIndex[dim] + 1, this->m_EndIndex[dim] );
+        weight *= distance[dim];
+        }
+      else
+        {
+        neighborIndex[dim] = baseIndex[dim];
+        weight *= 1.0 - distance[dim];
+        }
+      }
+    if( weight == 0.0 )
+      {
+      continue;
+      }
+    const TensorDataType & neighborValue = this->m_Image->GetPixel( neighborIndex );
+    for( int i = 0; i < 6; i++ )
+      {
+      sum[i] += weight * neighborValue[i];
+      }
+    }
+  TensorDataType pixelValue;
+  for( int i = 0; i < 6; i++ )
+    {
+    pixelValue[i] = ( DataType ) sum[i];
+    }
+  return pixelValue;
+}
+
 } // end itk namespace
 
 #endif
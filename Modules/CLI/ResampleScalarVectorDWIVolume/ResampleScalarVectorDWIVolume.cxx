@@ -17,6 +17,7 @@
 #include <itkCompositeTransform.h>
 #include <itkImageFileReader.h>
 #include <itkImageFileWriter.h>
+#include <itkLinearInterpolateImageFunction.h>
 #include <itkMetaDataObject.h>
 #include <itkNearestNeighborInterpolateImageFunction.h>
 #include <itkResampleImageFilter.h>
@@ -1213,6 +1214,56 @@ SetInterpolator( const parameters & list )
   return interpol;
 }
 
+// Resample all the components of a vector image in one pass: the transform is evaluated only once
+// for each output voxel and all the components are interpolated at the transformed position.
+// Only nearest neighbor and linear interpolators support vector images.
+template <class PixelType>
+typename itk::VectorImage<PixelType, 3>::Pointer
+ResampleVectorImage( const parameters & list,
+                     const typename itk::VectorImage<PixelType, 3>::Pointer & image,
+                     const typename itk::ResampleImageFilter<itk::Image<PixelType, 3>,
+                                                             itk::Image<PixelType, 3> >::Pointer & scalarResampler,
+                     const itk::Transform<double, 3, 3>::Pointer & transform
+                     )
+{
+  typedef itk::VectorImage<PixelType, 3>                                        VectorImageType;
+  typedef itk::ResampleImageFilter<VectorImageType, VectorImageType>            ResampleType;
+  typedef itk::InterpolateImageFunction<VectorImageType, double>                InterpolatorType;
+  typedef itk::NearestNeighborInterpolateImageFunction<VectorImageType, double> NearestNeighborInterpolateType;
+  typedef itk::LinearInterpolateImageFunction<VectorImageType, double>          LinearInterpolateType;
+  typename InterpolatorType::Pointer interpol;
+  if( !list.interpolationType.compare( "nn" ) )
+    {
+    interpol = NearestNeighborInterpolateType::New();
+    }
+  else
+    {
+    interpol = LinearInterpolateType::New();
+    }
+  typename ResampleType::Pointer resample = ResampleType::New();
+  resample->SetInput( image );
+  resample->SetInterpolator( interpol );
+  resample->SetTransform( transform );
+  // Output geometry has been computed for the scalar resampler (from the reference volume, the transforms, etc.)
+  resample->SetOutputSpacing( scalarResampler->GetOutputSpacing() );
+  resample->SetOutputOrigin( scalarResampler->GetOutputOrigin() );
+  resample->SetOutputDirection( scalarResampler->GetOutputDirection() );
+  resample->SetOutputStartIndex( scalarResampler->GetOutputStartIndex() );
+  resample->SetSize( scalarResampler->GetSize() );
+  typename VectorImageType::PixelType defaultPixel;
+  defaultPixel.SetSize( image->GetNumberOfComponentsPerPixel() );
+  defaultPixel.Fill( static_cast<PixelType>( list.defaultPixelValue ) );
+  resample->SetDefaultPixelValue( defaultPixel );
+  if( list.numberOfThread )
+    {
+    resample->SetNumberOfThreads( list.numberOfThread );
+    }
+  resample->Update();
+  typename VectorImageType::Pointer outputImage = resample->GetOutput();
+  outputImage->DisconnectPipeline();
+  return outputImage;
+}
+
 template <class PixelType>
 int Rotate( parameters & list )
 {
@@ -1223,7 +1274,12 @@ int Rotate( parameters & list )
   typedef itk::VectorImage<PixelType, 3>                   VectorImageType;
   typename ImageType::Pointer image;
   std::vector<typename ImageType::Pointer> vectorOfImage;
+  typename VectorImageType::Pointer        inputImage;
   itk::MetaDataDictionary                  dico;
+  // Interpolators that support vector images resample all the components at once,
+  // others (windowed sinc, B-spline) resample each component separately
+  const bool resampleAllComponentsAtOnce = ( !list.interpolationType.compare( "linear" )
+                                             || !list.interpolationType.compare( "nn" ) );
   try
     {
     // open image file
@@ -1237,8 +1293,23 @@ int Rotate( parameters & list )
       }
     // Save metadata dictionary
     dico = reader->GetOutput()->GetMetaDataDictionary();
-    // Separate the vector image into a vector of images
-    SeparateImages<PixelType>( reader->GetOutput(), vectorOfImage );
+    inputImage = reader->GetOutput();
+    if( resampleAllComponentsAtOnce )
+      {
+      // The output geometry and the transforms are computed from a scalar image,
+      // it only needs the geometry of the input image, no voxels are allocated
+      image = ImageType::New();
+      image->SetRegions( inputImage->GetLargestPossibleRegion() );
+      image->SetOrigin( inputImage->GetOrigin() );
+      image->SetSpacing( inputImage->GetSpacing() );
+      image->SetDirection( inputImage->GetDirection() );
+      vectorOfImage.push_back( image );
+      }
+    else
+      {
+      // Separate the vector image into a vector of images
+      SeparateImages<PixelType>( inputImage, vectorOfImage );
+      }
     }
   catch( itk::ExceptionObject exception )
     {
@@ -1260,19 +1331,31 @@ int Rotate( parameters & list )
     }
   resample->SetTransform( transform );
   resample->SetInterpolator( interpol );
-  std::vector<typename ImageType::Pointer> vectorOutputImage;
-  // Resample all the images separately
-  for( ::size_t idx = 0; idx < vectorOfImage.size(); idx++ )
+  if( list.numberOfThread )
     {
-    resample->SetInput( vectorOfImage[idx] );
-    resample->Update();
-    vectorOutputImage.push_back( resample->GetOutput() );
-    vectorOutputImage[idx]->DisconnectPipeline();
+    resample->SetNumberOfThreads( list.numberOfThread );
     }
   typename itk::VectorImage<PixelType, 3>::Pointer outputImage;
-  outputImage = itk::VectorImage<PixelType, 3>::New();
-  AddImage<PixelType>( outputImage, vectorOutputImage );
-  vectorOutputImage.clear();
+  if( resampleAllComponentsAtOnce )
+    {
+    outputImage = ResampleVectorImage<PixelType>( list, inputImage, resample, transform );
+    }
+  else
+    {
+    std::vector<typename ImageType::Pointer> vectorOutputImage;
+    // Resample all the images separately
+    for( ::size_t idx = 0; idx < vectorOfImage.size(); idx++ )
+      {
+      resample->SetInput( vectorOfImage[idx] );
+      resample->Update();
+      vectorOutputImage.push_back( resample->GetOutput() );
+      vectorOutputImage[idx]->DisconnectPipeline();
+      }
+    outputImage = itk::VectorImage<PixelType, 3>::New();
+    AddImage<PixelType>( outputImage, vectorOutputImage );
+    vectorOutputImage.clear();
+    }
+  inputImage = NULL;
   // If necessary, transform gradient vectors with the loaded transformations
   int dwmriProblem = CheckDWMRI( dico, transform );
   if( list.space ) // && list.transformationFile.compare( "" ) )
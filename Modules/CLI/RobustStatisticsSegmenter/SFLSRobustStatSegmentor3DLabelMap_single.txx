@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <ctime>
+#include <map>
 
 #include <limits>
 
@@ -98,6 +99,7 @@ CSFLSRobustStatSegmentor3DLabelMap<TPixel>
 // #ifndef NDEBUG
 //     std::ofstream ff("/tmp/force.txt");
 // #endif
+  std::vector<double> f(m_numberOfFeature);
   for( long i = 0; i < n; ++i )
     {
     typename CSFLSLayer::iterator itz = m_lzIterVct[i];
@@ -110,8 +112,6 @@ CSFLSRobustStatSegmentor3DLabelMap<TPixel>
 
     kappaOnZeroLS[i] = this->computeKappa(ix, iy, iz);
 
-    std::vector<double> f(m_numberOfFeature);
-
     computeFeatureAt(idx, f);
 
     // double a = -kernelEvaluation(f);
@@ -829,15 +829,35 @@ CSFLSRobustStatSegmentor3DLabelMap<TPixel>
 
     double var2 = -1.0 / (2 * stdDev * stdDev);
     double c = 1.0 / sqrt(2 * (vnl_math::pi) ) / stdDev;
+
+    /* Seeds typically have much fewer distinct feature values than
+       seeds (a label map has many voxels with the same neighborhood
+       statistics), so the kernel is evaluated once for each distinct
+       value and weighted by the number of seeds having it. */
+    std::map<double, long> featureValueCounts;
+    for( long ii = 0; ii < n; ++ii )
+      {
+      ++featureValueCounts[m_featureAtTheSeeds[ii][ifeature]];
+      }
+    std::vector<double> featureValues;
+    std::vector<double> featureCounts;
+    featureValues.reserve(featureValueCounts.size() );
+    featureCounts.reserve(featureValueCounts.size() );
+    for( std::map<double, long>::const_iterator itv = featureValueCounts.begin(); itv != featureValueCounts.end(); ++itv )
+      {
+      featureValues.push_back(itv->first);
+      featureCounts.push_back(static_cast<double>(itv->second) );
+      }
+    long numberOfFeatureValues = featureValues.size();
+
     for( TPixel a = m_inputImageIntensityMin; a <= m_inputImageIntensityMax; ++a )
       {
       long ia = static_cast<long>(a - m_inputImageIntensityMin);
 
       double pp = 0.0;
-      for( long ii = 0; ii < n; ++ii )
+      for( long ii = 0; ii < numberOfFeatureValues; ++ii )
         {
-        pp += exp(var2 * (a - m_featureAtTheSeeds[ii][ifeature]) * (a - m_featureAtTheSeeds[ii][ifeature]) );
-
+        pp += featureCounts[ii] * exp(var2 * (a - featureValues[ii]) * (a - featureValues[ii]) );
         }
 
       pp *= c;
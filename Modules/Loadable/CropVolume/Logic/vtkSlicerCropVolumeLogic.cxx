@@ -42,7 +42,11 @@
 #include <vtkBoundingBox.h>
 #include <vtkGeneralTransform.h>
 #include <vtkImageData.h>
+#include <vtkImageBSplineCoefficients.h>
+#include <vtkImageBSplineInterpolator.h>
 #include <vtkImageClip.h>
+#include <vtkImageReslice.h>
+#include <vtkImageSincInterpolator.h>
 #include <vtkNew.h>
 #include <vtkMatrix4x4.h>
 #include <vtkMatrix3x3.h>
@@ -419,12 +423,6 @@ int vtkSlicerCropVolumeLogic::CropInterpolated(vtkMRMLAnnotationROINode* roi, vt
     return -1;
     }
 
-  if (this->Internal->ResampleLogic == 0)
-    {
-    vtkErrorMacro("CropVolume: resample logic is not set");
-    return -3;
-    }
-
   int outputExtent[6] = { 0, -1, 0, -1, 0, -1 };
   double outputSpacing[3] = { 0 };
   this->GetInterpolatedCropOutputGeometry(roi, inputVolume, isotropicResampling, spacingScale, outputExtent, outputSpacing);
@@ -482,22 +480,6 @@ int vtkSlicerCropVolumeLogic::CropInterpolated(vtkMRMLAnnotationROINode* roi, vt
     outputSpacing[column] = vtkMath::Normalize(outputDirectionColRow[column]);
     }
 
-  vtkMRMLCommandLineModuleNode* cmdNode = this->Internal->ResampleLogic->CreateNodeInScene();
-  if (cmdNode == NULL)
-    {
-    vtkErrorMacro("CropVolume: failed to create resample node");
-    return -4;
-    }
-
-  cmdNode->SetParameterAsString("inputVolume", inputVolume->GetID());
-  cmdNode->SetParameterAsString("outputVolume", outputVolume->GetID());
-
-  std::stringstream sizeStream;
-  sizeStream << (outputExtent[1] - outputExtent[0] + 1)  << ","
-    << (outputExtent[3] - outputExtent[2] + 1) << ","
-    << (outputExtent[5] - outputExtent[4] + 1);
-  cmdNode->SetParameterAsString("outputImageSize", sizeStream.str());
-
   // Center the output image in the ROI. For that, compute the size difference between
   // the ROI and the output image.
   double sizeDifference_IJK[3] =
@@ -518,6 +500,42 @@ int vtkSlicerCropVolumeLogic::CropInterpolated(vtkMRMLAnnotationROINode* roi, vt
   double outputOrigin_RAS[4] = { 0.0, 0.0, 0.0, 1.0 };
   outputIJKToRAS->MultiplyPoint(outputOrigin_IJK, outputOrigin_RAS);
 
+  if (!vtkMRMLDiffusionWeightedVolumeNode::SafeDownCast(inputVolume))
+    {
+    // Gradient directions of DWI volumes have to be reoriented, which is done
+    // by the resample module, all other volumes are resampled in-process.
+    vtkNew<vtkMatrix4x4> outputVoxelIJKToRAS;
+    outputVoxelIJKToRAS->DeepCopy(outputIJKToRAS.GetPointer());
+    for (int row = 0; row < 3; row++)
+      {
+      outputVoxelIJKToRAS->SetElement(row, 3, outputOrigin_RAS[row]);
+      }
+    return vtkSlicerCropVolumeLogic::ResampleInterpolated(inputVolume, outputVolume,
+      outputVoxelIJKToRAS.GetPointer(), outputExtent, interpolationMode);
+    }
+
+  if (this->Internal->ResampleLogic == 0)
+    {
+    vtkErrorMacro("CropVolume: resample logic is not set");
+    return -3;
+    }
+
+  vtkMRMLCommandLineModuleNode* cmdNode = this->Internal->ResampleLogic->CreateNodeInScene();
+  if (cmdNode == NULL)
+    {
+    vtkErrorMacro("CropVolume: failed to create resample node");
+    return -4;
+    }
+
+  cmdNode->SetParameterAsString("inputVolume", inputVolume->GetID());
+  cmdNode->SetParameterAsString("outputVolume", outputVolume->GetID());
+
+  std::stringstream sizeStream;
+  sizeStream << (outputExtent[1] - outputExtent[0] + 1)  << ","
+    << (outputExtent[3] - outputExtent[2] + 1) << ","
+    << (outputExtent[5] - outputExtent[4] + 1);
+  cmdNode->SetParameterAsString("outputImageSize", sizeStream.str());
+
   vtkNew<vtkMRMLMarkupsFiducialNode> originMarkupNode;
   // Markups are transformed from RAS to LPS by the CLI infrastructure, so we pass them in RAS
   originMarkupNode->AddFiducial(outputOrigin_RAS[0], outputOrigin_RAS[1], outputOrigin_RAS[2]);
@@ -587,6 +605,87 @@ int vtkSlicerCropVolumeLogic::CropInterpolated(vtkMRMLAnnotationROINode* roi, vt
   return 0;
 }
 
+//----------------------------------------------------------------------------
+int vtkSlicerCropVolumeLogic::ResampleInterpolated(vtkMRMLVolumeNode* inputVolume, vtkMRMLVolumeNode* outputVolume,
+  vtkMatrix4x4* outputIJKToRAS, int outputExtent[6], int interpolationMode)
+{
+  if (!inputVolume || !outputVolume || !outputIJKToRAS)
+    {
+    return -1;
+    }
+  if (!inputVolume->GetImageData())
+    {
+    vtkGenericWarningMacro("vtkSlicerCropVolumeLogic::ResampleInterpolated: input image is empty")
+    outputVolume->SetAndObserveImageData(NULL);
+    return 0;
+    }
+
+  // Output IJK -> output RAS -> input RAS -> input IJK
+  vtkNew<vtkGeneralTransform> outputIJKToInputIJK;
+  outputIJKToInputIJK->PostMultiply();
+  outputIJKToInputIJK->Concatenate(outputIJKToRAS);
+  vtkNew<vtkGeneralTransform> outputRASToInputRAS;
+  vtkMRMLTransformNode::GetTransformBetweenNodes(outputVolume->GetParentTransformNode(),
+    inputVolume->GetParentTransformNode(), outputRASToInputRAS.GetPointer());
+  outputIJKToInputIJK->Concatenate(outputRASToInputRAS.GetPointer());
+  vtkNew<vtkMatrix4x4> inputRASToIJK;
+  inputVolume->GetRASToIJKMatrix(inputRASToIJK.GetPointer());
+  outputIJKToInputIJK->Concatenate(inputRASToIJK.GetPointer());
+
+  // vtkImageReslice only computes the voxels of the output extent, from the
+  // part of the input that they need, using multiple threads.
+  vtkNew<vtkImageReslice> reslice;
+  reslice->SetResliceTransform(outputIJKToInputIJK.GetPointer());
+  reslice->SetOutputOrigin(0.0, 0.0, 0.0);
+  reslice->SetOutputSpacing(1.0, 1.0, 1.0);
+  reslice->SetOutputExtent(outputExtent);
+  reslice->SetOutputScalarType(inputVolume->GetImageData()->GetScalarType());
+  reslice->SetBackgroundLevel(0.0);
+
+  vtkNew<vtkImageBSplineCoefficients> bSplineCoefficients;
+  switch (interpolationMode)
+    {
+    case vtkMRMLCropVolumeParametersNode::InterpolationNearestNeighbor:
+      reslice->SetInputData(inputVolume->GetImageData());
+      reslice->SetInterpolationModeToNearestNeighbor();
+      break;
+    case vtkMRMLCropVolumeParametersNode::InterpolationWindowedSinc:
+      {
+      reslice->SetInputData(inputVolume->GetImageData());
+      vtkNew<vtkImageSincInterpolator> sincInterpolator;
+      sincInterpolator->SetWindowFunctionToHamming();
+      reslice->SetInterpolator(sincInterpolator.GetPointer());
+      }
+      break;
+    case vtkMRMLCropVolumeParametersNode::InterpolationBSpline:
+      {
+      bSplineCoefficients->SetInputData(inputVolume->GetImageData());
+      bSplineCoefficients->SetSplineDegree(3);
+      reslice->SetInputConnection(bSplineCoefficients->GetOutputPort());
+      vtkNew<vtkImageBSplineInterpolator> bSplineInterpolator;
+      bSplineInterpolator->SetSplineDegree(3);
+      reslice->SetInterpolator(bSplineInterpolator.GetPointer());
+      }
+      break;
+    case vtkMRMLCropVolumeParametersNode::InterpolationLinear:
+    default:
+      reslice->SetInputData(inputVolume->GetImageData());
+      reslice->SetInterpolationModeToLinear();
+      break;
+    }
+  reslice->Update();
+
+  vtkNew<vtkImageData> outputImageData;
+  outputImageData->ShallowCopy(reslice->GetOutput());
+
+  int wasModified = outputVolume->StartModify();
+  outputVolume->SetAndObserveImageData(outputImageData.GetPointer());
+  outputVolume->SetIJKToRASMatrix(outputIJKToRAS);
+  outputVolume->EndModify(wasModified);
+
+  return 0;
+}
+
 //-----------------------------------------------------------------------------
 bool vtkSlicerCropVolumeLogic::FitROIToInputVolume(vtkMRMLCropVolumeParametersNode* parametersNode)
 {
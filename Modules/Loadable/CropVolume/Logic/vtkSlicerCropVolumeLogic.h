@@ -87,9 +87,20 @@ public:
   static bool GetVoxelBasedCropOutputExtent(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume, int outputExtent[6]);
 
   /// Perform interpolated cropping.
+  /// Diffusion weighted volumes are resampled using the resample logic (see SetResampleLogic),
+  /// all other volumes are resampled in-process by ResampleInterpolated().
   int CropInterpolated(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume, vtkMRMLVolumeNode* outputNode,
     bool isotropicResampling, double spacingScale, int interpolationMode);
 
+  /// Resample the input volume into the output geometry specified by
+  /// \a outputIJKToRAS (in the output volume's parent transform coordinate
+  /// system) and \a outputExtent, without calling the resample CLI module.
+  /// Only voxels inside the output extent are computed.
+  /// Input volume may be under a non-linear transform.
+  /// \a interpolationMode is one of vtkMRMLCropVolumeParametersNode::Interpolation* values.
+  static int ResampleInterpolated(vtkMRMLVolumeNode* inputVolume, vtkMRMLVolumeNode* outputVolume,
+    vtkMatrix4x4* outputIJKToRAS, int outputExtent[6], int interpolationMode);
+
   /// Computes output volume geometry for interpolated cropping (without actually cropping the image).
   static bool GetInterpolatedCropOutputGeometry(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume,
     bool isotropicResampling, double spacingScale, int outputExtent[6], double outputSpacing[3]);
@@ -140,6 +140,8 @@ class CropVolumeSelfTestTest(unittest.TestCase):
   def runTest(self):
     self.setUp()
     self.test_CropVolumeSelfTest()
+    self.setUp()
+    self.test_CropVolumeInterpolated()
 
 
   def test_CropVolumeSelfTest(self):
@@ -185,6 +187,45 @@ class CropVolumeSelfTestTest(unittest.TestCase):
 
     self.delayDisplay('Test passed')
 
+  def test_CropVolumeInterpolated(self):
+    """
+    Test in-process interpolated cropping
+    """
+
+    print("Running CropVolumeInterpolated Test case:")
+
+    vol = self.downloadMRHead()
+    roi = slicer.vtkMRMLAnnotationROINode()
+    roi.Initialize(slicer.mrmlScene)
+
+    cropVolumeNode = slicer.vtkMRMLCropVolumeParametersNode()
+    cropVolumeNode.SetScene(slicer.mrmlScene)
+    slicer.mrmlScene.AddNode(cropVolumeNode)
+    cropVolumeNode.SetInputVolumeNodeID(vol.GetID())
+    cropVolumeNode.SetROINodeID(roi.GetID())
+    cropVolumeNode.SetVoxelBased(False)
+    cropVolumeNode.SetIsotropicResampling(False)
+    cropVolumeNode.SetSpacingScalingConst(2.0)
+
+    cropVolumeLogic = slicer.modules.cropvolume.logic()
+    cropVolumeLogic.FitROIToInputVolume(cropVolumeNode)
+    self.assertEqual(cropVolumeLogic.Apply(cropVolumeNode), 0)
+
+    outputVolume = slicer.mrmlScene.GetNodeByID(cropVolumeNode.GetOutputVolumeNodeID())
+    self.assertIsNotNone(outputVolume.GetImageData())
+    inputDimensions = vol.GetImageData().GetDimensions()
+    outputDimensions = outputVolume.GetImageData().GetDimensions()
+    # output axes follow the ROI axes, which may be permuted compared to the input IJK axes
+    self.assertEqual(sorted(outputDimensions), sorted([dimension // 2 for dimension in inputDimensions]))
+    outputSpacing = sorted(outputVolume.GetSpacing())
+    inputSpacing = sorted(vol.GetSpacing())
+    for axis in range(3):
+      self.assertAlmostEqual(outputSpacing[axis], inputSpacing[axis] * 2.0)
+    self.assertEqual(outputVolume.GetImageData().GetScalarType(), vol.GetImageData().GetScalarType())
+    self.assertGreater(outputVolume.GetImageData().GetScalarRange()[1], 0)
+
+    self.delayDisplay('Test passed')
+
   def downloadMRHead(self):
     import SampleData
     sampleDataLogic = SampleData.SampleDataLogic()
@@ -213,6 +213,9 @@ void qSlicerDataModuleWidget::onSceneModelChanged(const QString& modelType)
   d->MRMLTreeView->setSceneModelType( modelType );
 
   d->MRMLTreeView->sceneModel()->setIDColumn(1);
+  // Large scenes: update node items once per event loop iteration instead of
+  // at each node modification.
+  d->MRMLTreeView->sceneModel()->setDelayedNodeUpdate(true);
   d->MRMLTreeView->sceneModel()->setHorizontalHeaderLabels(
     QStringList() << "Nodes" << "IDs");
 
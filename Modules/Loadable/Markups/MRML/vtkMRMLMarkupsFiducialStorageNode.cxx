@@ -26,8 +26,61 @@
 #include "vtkStringArray.h"
 #include <vtksys/SystemTools.hxx>
 
+#include <cstdlib>
 #include <sstream>
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Return the text from pos up to the next delimiter and move pos after the delimiter
+std::string GetNextComponent(const std::string& line, size_t& pos, char delimiter)
+{
+  if (pos >= line.size())
+    {
+    return std::string();
+    }
+  size_t endPos = line.find(delimiter, pos);
+  if (endPos == std::string::npos)
+    {
+    endPos = line.size();
+    }
+  std::string component = line.substr(pos, endPos - pos);
+  pos = (endPos < line.size() ? endPos + 1 : endPos);
+  return component;
+}
+
+//----------------------------------------------------------------------------
+// Parse the number at pos and move pos after the next delimiter.
+// The number is converted in place, without copying the component.
+double GetNextNumber(const std::string& line, size_t& pos, char delimiter)
+{
+  if (pos >= line.size())
+    {
+    return 0.0;
+    }
+  double value = strtod(line.c_str() + pos, NULL);
+  size_t endPos = line.find(delimiter, pos);
+  pos = (endPos == std::string::npos ? line.size() : endPos + 1);
+  return value;
+}
+
+//----------------------------------------------------------------------------
+// Parse the integer flag at pos and move pos after the next delimiter
+bool GetNextFlag(const std::string& line, size_t& pos, char delimiter)
+{
+  if (pos >= line.size())
+    {
+    return false;
+    }
+  int value = atoi(line.c_str() + pos);
+  size_t endPos = line.find(delimiter, pos);
+  pos = (endPos == std::string::npos ? line.size() : endPos + 1);
+  return value != 0;
+}
+
+}
+
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLMarkupsFiducialStorageNode);
 
@@ -193,50 +246,25 @@ int vtkMRMLMarkupsFiducialStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
           }
         else
           {
+          std::string lineString(line);
+          size_t pos = 0;
+          Markup markup;
+          markupsNode->InitMarkup(&markup);
           if (version.size() == 0)
             {
-            std::string label = std::string("");
             double x = 0.0, y = 0.0, z = 0.0;
-            int sel = 1, vis = 1;
-
-            markupsNode->AddMarkupWithNPoints(1);
-
-            std::stringstream ss(line);
-            std::string component;
-
+            char delimiter = ',';
             if (parseAsAnnotationFiducial)
               {
               // annotation fiducial line format = point|x|y|z|sel|vis
+              delimiter = '|';
               // label
-              getline(ss, component, '|');
-              if (component.size())
+              if (GetNextComponent(lineString, pos, delimiter).size())
                 {
-                vtkDebugMacro("Got point string = " << component.c_str());
                 // use the file name for the point label
                 std::string filenameName = vtksys::SystemTools::GetFilenameName(this->GetFileName());
-                label = vtksys::SystemTools::GetFilenameWithoutExtension(filenameName);
-                markupsNode->SetNthMarkupLabel(thisMarkupNumber,label);
+                markup.Label = vtksys::SystemTools::GetFilenameWithoutExtension(filenameName);
                 }
-
-              // x,y,z
-              getline(ss, component, '|');
-              x = atof(component.c_str());
-              getline(ss, component, '|');
-              y = atof(component.c_str());
-              getline(ss, component, '|');
-              z = atof(component.c_str());
-              markupsNode->SetMarkupPoint(thisMarkupNumber,0,x,y,z);
-
-              // selected
-              getline(ss, component, '|');
-              sel = atoi(component.c_str());
-              markupsNode->SetNthMarkupSelected(thisMarkupNumber,sel);
-
-              // visibility
-              getline(ss, component, '|');
-              vtkDebugMacro("component = " << component.c_str());
-              vis = atoi(component.c_str());
-              markupsNode->SetNthMarkupVisibility(thisMarkupNumber,vis);
               }
             else
               {
@@ -246,131 +274,77 @@ int vtkMRMLMarkupsFiducialStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
                 printedVersionWarning = true;
                 }
               // point line format = label,x,y,z,sel,vis
-
               // label
-              getline(ss, component, ',');
-              if (component.size())
+              std::string label = GetNextComponent(lineString, pos, delimiter);
+              if (label.size())
                 {
-                vtkDebugMacro("Got label = " << component.c_str());
-                label = component;
-                markupsNode->SetNthMarkupLabel(thisMarkupNumber,label);
+                vtkDebugMacro("Got label = " << label.c_str());
+                markup.Label = label;
                 }
-
-              // x,y,z
-              getline(ss, component, ',');
-              x = atof(component.c_str());
-              getline(ss, component, ',');
-              y = atof(component.c_str());
-              getline(ss, component, ',');
-              z = atof(component.c_str());
-              markupsNode->SetMarkupPoint(thisMarkupNumber,0,x,y,z);
-
-              // selected
-              getline(ss, component, ',');
-              sel = atoi(component.c_str());
-              markupsNode->SetNthMarkupSelected(thisMarkupNumber,sel);
-
-              // visibility
-              getline(ss, component, ',');
-              vtkDebugMacro("component = " << component.c_str());
-              vis = atoi(component.c_str());
-              markupsNode->SetNthMarkupVisibility(thisMarkupNumber,vis);
               }
-            thisMarkupNumber++;
+            // x,y,z
+            x = GetNextNumber(lineString, pos, delimiter);
+            y = GetNextNumber(lineString, pos, delimiter);
+            z = GetNextNumber(lineString, pos, delimiter);
+            markup.points.push_back(vtkVector3d(x, y, z));
+            // selected
+            markup.Selected = GetNextFlag(lineString, pos, delimiter);
+            // visibility
+            markup.Visibility = GetNextFlag(lineString, pos, delimiter);
             }
           else
             {
             // Slicer 4 markups fiducial file
             vtkDebugMacro("\n\n\n\nVersion = " << version << ", got a line: \n\"" << line << "\"");
-            std::string id = std::string("");
-            double x = 0.0, y = 0.0, z = 0.0;
-            double ow = 0.0, ox = 0.0, oy = 0.0, oz = 1.0;
-            int sel = 1, vis = 1, lock = 0;
-            std::string associatedNodeID = std::string("");
-            std::string label = std::string("");
-            std::string desc = std::string("");
-
-            std::stringstream ss(line);
-            int numPoints = 1;
-            markupsNode->AddMarkupWithNPoints(numPoints);
-
-            std::string component;
 
             // id
-            getline(ss, component, ',');
-            if (component.size())
+            std::string id = GetNextComponent(lineString, pos, ',');
+            if (id.size())
               {
-              vtkDebugMacro("Got id = " << component.c_str());
-              id = component;
-              markupsNode->SetNthMarkupID(thisMarkupNumber,id);
+              vtkDebugMacro("Got id = " << id.c_str());
+              markup.ID = id;
               }
             else
               {
               vtkDebugMacro("No ID");
               if (this->GetScene())
                 {
-                markupsNode->SetNthMarkupID(thisMarkupNumber,this->GetScene()->GenerateUniqueName(this->GetID()));
+                markup.ID = this->GetScene()->GenerateUniqueName(this->GetID());
                 }
               }
 
             // x,y,z
-            getline(ss, component, ',');
-            x = atof(component.c_str());
-            getline(ss, component, ',');
-            y = atof(component.c_str());
-            getline(ss, component, ',');
-            z = atof(component.c_str());
-            if (this->GetCoordinateSystem() == vtkMRMLMarkupsFiducialStorageNode::RAS)
-              {
-              markupsNode->SetMarkupPoint(thisMarkupNumber,0,x,y,z);
-              }
-            else if (this->GetCoordinateSystem() == vtkMRMLMarkupsFiducialStorageNode::LPS)
+            double x = GetNextNumber(lineString, pos, ',');
+            double y = GetNextNumber(lineString, pos, ',');
+            double z = GetNextNumber(lineString, pos, ',');
+            if (this->GetCoordinateSystem() == vtkMRMLMarkupsFiducialStorageNode::LPS)
               {
-              markupsNode->SetMarkupPointLPS(thisMarkupNumber,0,x,y,z);
-              }
-            else
-              {
-              // IJK not implemented yet, assume RAS
-              markupsNode->SetMarkupPoint(thisMarkupNumber,0,x,y,z);
+              x = -x;
+              y = -y;
               }
+            // IJK not implemented yet, assume RAS
+            markup.points.push_back(vtkVector3d(x, y, z));
 
             // orientatation
-            getline(ss, component, ',');
-            ow = atof(component.c_str());
-            getline(ss, component, ',');
-            ox = atof(component.c_str());
-            getline(ss, component, ',');
-            oy = atof(component.c_str());
-            getline(ss, component, ',');
-            oz = atof(component.c_str());
-            markupsNode->SetNthMarkupOrientation(thisMarkupNumber, ow, ox, oy, oz);
-
-            // visibility
-            getline(ss, component, ',');
-            vtkDebugMacro("component = " << component.c_str());
-            vis = atoi(component.c_str());
-            markupsNode->SetNthMarkupVisibility(thisMarkupNumber,vis);
-
-            // selected
-            getline(ss, component, ',');
-            sel = atoi(component.c_str());
-            markupsNode->SetNthMarkupSelected(thisMarkupNumber,sel);
+            for (int i = 0; i < 4; i++)
+              {
+              markup.OrientationWXYZ[i] = GetNextNumber(lineString, pos, ',');
+              }
 
-            // locked
-            getline(ss, component, ',');
-            lock = atoi(component.c_str());
-            markupsNode->SetNthMarkupLocked(thisMarkupNumber,lock);
+            // visibility, selected, locked
+            markup.Visibility = GetNextFlag(lineString, pos, ',');
+            markup.Selected = GetNextFlag(lineString, pos, ',');
+            markup.Locked = GetNextFlag(lineString, pos, ',');
 
             // label
             // the label may have quotes around it, look for the end quote and comma
-            // std::cout << "Line ss = '" << ss.str().c_str() << "'" << std::endl;
-            std::string labelDescID;
-            getline(ss, labelDescID);
+            std::string labelDescID = lineString.substr(pos);
             // if there's no quote at the start of the line, the label was
             // checked to be sure that there are no commas in it, so extract
             // to the next comma
-            size_t endCommaPos;
-            if (labelDescID[0] != '"')
+            std::string component;
+            size_t endCommaPos = std::string::npos;
+            if (labelDescID.empty() || labelDescID[0] != '"')
               {
               endCommaPos = labelDescID.find(",");
               component = labelDescID.substr(0, endCommaPos);
@@ -379,23 +353,17 @@ int vtkMRMLMarkupsFiducialStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
               {
               component = this->GetFirstQuotedString(labelDescID, &endCommaPos);
               }
-            if (component.size())
-              {
-              vtkDebugMacro("Got label = " << component.c_str());
-              label = this->ConvertStringFromStorageFormat(component);
-              markupsNode->SetNthMarkupLabel(thisMarkupNumber, label);
-              }
-            else
-              {
-              vtkDebugMacro("No label");
-              markupsNode->SetNthMarkupLabel(thisMarkupNumber,"");
-              }
+            markup.Label = this->ConvertStringFromStorageFormat(component);
 
             // description
             // get the rest of the string after the label
-            std::string descID = labelDescID.substr(endCommaPos + 1);
+            std::string descID;
+            if (endCommaPos != std::string::npos && endCommaPos < labelDescID.size())
+              {
+              descID = labelDescID.substr(endCommaPos + 1);
+              }
             // the description may have quotes around it as well
-            if (descID[0] != '"')
+            if (descID.empty() || descID[0] != '"')
               {
               endCommaPos = descID.find(",");
               component = descID.substr(0, endCommaPos);
@@ -404,50 +372,39 @@ int vtkMRMLMarkupsFiducialStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
               {
               component = this->GetFirstQuotedString(descID, &endCommaPos);
               }
-            if (component.size())
-              {
-              vtkDebugMacro("Got desc = " << component.c_str());
-              desc = this->ConvertStringFromStorageFormat(component);
-              markupsNode->SetNthMarkupDescription(thisMarkupNumber, desc);
-              }
-            else
-              {
-              vtkDebugMacro("No description");
-              markupsNode->SetNthMarkupDescription(thisMarkupNumber,"");
-              }
+            markup.Description = this->ConvertStringFromStorageFormat(component);
 
             // in case the file was written by hand, the associated node id
             // might be empty
-            size_t associatedNodeIDPos = ss.str().find_last_of(',');
+            size_t associatedNodeIDPos = lineString.find_last_of(',');
             if (associatedNodeIDPos != std::string::npos)
               {
-              component = ss.str().substr(associatedNodeIDPos + 1);
-              if (component.size())
-                {
-                vtkDebugMacro("Got associated node id = " << component.c_str());
-                associatedNodeID = component;
-                markupsNode->SetNthMarkupAssociatedNodeID(thisMarkupNumber,associatedNodeID);
-                }
-              else
-                {
-                vtkDebugMacro("no associated node id");
-                markupsNode->SetNthMarkupAssociatedNodeID(thisMarkupNumber,"");
-                }
-              }
-            else
-              {
-                  markupsNode->SetNthMarkupAssociatedNodeID(thisMarkupNumber,"");
+              markup.AssociatedNodeID = lineString.substr(associatedNodeIDPos + 1);
               }
 
-            thisMarkupNumber++;
-            vtkDebugMacro("Line parsed, got id = " << id << ", vis = " << vis << ", sel = " << sel
-                          << ", associatedNodeID = " << associatedNodeID.c_str()
-                          << ", label = '" << label.c_str() << "', markup number is now " << thisMarkupNumber);
+            vtkDebugMacro("Line parsed, got id = " << markup.ID << ", vis = " << markup.Visibility
+                          << ", sel = " << markup.Selected
+                          << ", associatedNodeID = " << markup.AssociatedNodeID.c_str()
+                          << ", label = '" << markup.Label.c_str() << "', markup number is now " << thisMarkupNumber);
             } // point line
+
+          // Add the markup without invoking events, a single event is invoked
+          // once the whole file is read
+          markupsNode->Markups.push_back(markup);
+          markupsNode->MaximumNumberOfMarkups++;
+          thisMarkupNumber++;
           }
         }
       }
     fstr.close();
+
+    if (thisMarkupNumber > 0)
+      {
+      markupsNode->Modified();
+      // -1 means that multiple markups were added
+      int markupIndex = -1;
+      markupsNode->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::MarkupAddedEvent, (void*)&markupIndex);
+      }
     }
   else
     {
@@ -550,7 +507,8 @@ int vtkMRMLMarkupsFiducialStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     of << "," << desc;
     of << "," << associatedNodeID;
 
-    of << endl;
+    // do not flush the stream after each line, it makes writing large lists slow
+    of << "\n";
     }
 
   of.close();
@@ -33,6 +33,7 @@
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkStringArray.h>
 
@@ -542,6 +543,96 @@ int vtkMRMLMarkupsNode::AddPointToNthMarkup(vtkVector3d point, int n)
   return pointIndex;
 }
 
+//-----------------------------------------------------------
+int vtkMRMLMarkupsNode::AddPointsToNewMarkups(vtkPoints* points)
+{
+  if (!points)
+    {
+    vtkErrorMacro("AddPointsToNewMarkups: invalid points");
+    return 0;
+    }
+  int numberOfNewMarkups = static_cast<int>(points->GetNumberOfPoints());
+  if (numberOfNewMarkups == 0)
+    {
+    return 0;
+    }
+  this->Markups.reserve(this->Markups.size() + numberOfNewMarkups);
+  double point[3] = { 0.0, 0.0, 0.0 };
+  for (int i = 0; i < numberOfNewMarkups; i++)
+    {
+    Markup markup;
+    // unique ID and default label are based on the number of markups
+    this->InitMarkup(&markup);
+    points->GetPoint(i, point);
+    markup.points.push_back(vtkVector3d(point[0], point[1], point[2]));
+    this->Markups.push_back(markup);
+    this->MaximumNumberOfMarkups++;
+    }
+
+  this->Modified();
+  // -1 means that multiple markups were added
+  int markupIndex = -1;
+  this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::MarkupAddedEvent, (void*)&markupIndex);
+  return numberOfNewMarkups;
+}
+
+//-----------------------------------------------------------
+void vtkMRMLMarkupsNode::GetAllMarkupPoints(vtkPoints* points)
+{
+  if (!points)
+    {
+    vtkErrorMacro("GetAllMarkupPoints: invalid points");
+    return;
+    }
+  vtkIdType numberOfPoints = 0;
+  for (std::vector<Markup>::iterator markupIt = this->Markups.begin(); markupIt != this->Markups.end(); ++markupIt)
+    {
+    numberOfPoints += static_cast<vtkIdType>(markupIt->points.size());
+    }
+  points->SetNumberOfPoints(numberOfPoints);
+  vtkIdType pointId = 0;
+  for (std::vector<Markup>::iterator markupIt = this->Markups.begin(); markupIt != this->Markups.end(); ++markupIt)
+    {
+    for (std::vector<vtkVector3d>::iterator pointIt = markupIt->points.begin(); pointIt != markupIt->points.end(); ++pointIt)
+      {
+      points->SetPoint(pointId++, pointIt->GetData());
+      }
+    }
+}
+
+//-----------------------------------------------------------
+bool vtkMRMLMarkupsNode::SetAllMarkupPoints(vtkPoints* points)
+{
+  if (!points)
+    {
+    vtkErrorMacro("SetAllMarkupPoints: invalid points");
+    return false;
+    }
+  vtkIdType numberOfPoints = 0;
+  for (std::vector<Markup>::iterator markupIt = this->Markups.begin(); markupIt != this->Markups.end(); ++markupIt)
+    {
+    numberOfPoints += static_cast<vtkIdType>(markupIt->points.size());
+    }
+  if (points->GetNumberOfPoints() != numberOfPoints)
+    {
+    vtkErrorMacro("SetAllMarkupPoints: expected " << numberOfPoints << " points, got " << points->GetNumberOfPoints());
+    return false;
+    }
+  vtkIdType pointId = 0;
+  double point[3] = { 0.0, 0.0, 0.0 };
+  for (std::vector<Markup>::iterator markupIt = this->Markups.begin(); markupIt != this->Markups.end(); ++markupIt)
+    {
+    for (std::vector<vtkVector3d>::iterator pointIt = markupIt->points.begin(); pointIt != markupIt->points.end(); ++pointIt)
+      {
+      points->GetPoint(pointId++, point);
+      pointIt->Set(point[0], point[1], point[2]);
+      }
+    }
+  // a single event is enough, listeners update all the points on node modified
+  this->Modified();
+  return true;
+}
+
 //-----------------------------------------------------------
 vtkVector3d vtkMRMLMarkupsNode::GetMarkupPointVector(int markupIndex, int pointIndex)
 {
@@ -1111,21 +1202,19 @@ bool vtkMRMLMarkupsNode::CanApplyNonLinearTransforms()const
 //---------------------------------------------------------------------------
 void vtkMRMLMarkupsNode::ApplyTransform(vtkAbstractTransform* transform)
 {
-  int numMarkups = this->GetNumberOfMarkups();
-  double xyzIn[3];
-  double xyzOut[3];
-  for (int m=0; m<numMarkups; m++)
+  // Transform all the points at once instead of one by one, to only invoke
+  // a single modified event (each point modified event triggers update of the
+  // displayable managers, which would make transforming large lists very slow).
+  vtkNew<vtkPoints> pointsIn;
+  this->GetAllMarkupPoints(pointsIn.GetPointer());
+  if (pointsIn->GetNumberOfPoints() == 0)
     {
-    int numPoints = this->GetNumberOfPointsInNthMarkup(m);
-    for (int n=0; n<numPoints; n++)
-      {
-      this->GetMarkupPoint(m, n, xyzIn);
-      transform->TransformPoint(xyzIn,xyzOut);
-      this->SetMarkupPointFromArray(m, n, xyzOut);
-      }
+    return;
     }
+  vtkNew<vtkPoints> pointsOut;
+  transform->TransformPoints(pointsIn.GetPointer(), pointsOut.GetPointer());
   this->StorableModifiedTime.Modified();
-  this->Modified();
+  this->SetAllMarkupPoints(pointsOut.GetPointer());
 }
 
 //---------------------------------------------------------------------------
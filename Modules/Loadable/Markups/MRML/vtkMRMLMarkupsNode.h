@@ -30,6 +30,7 @@
 
 class vtkStringArray;
 class vtkMatrix4x4;
+class vtkPoints;
 
 /// see doxygen enabled comment in class description
 typedef struct
@@ -193,6 +194,23 @@ public:
   int AddPointWorldToNewMarkup(vtkVector3d point, std::string label = std::string());
   /// Add a point to the nth markup, returning the point index
   int AddPointToNthMarkup(vtkVector3d point, int n);
+  /// Create a new markup with one point for each point in the list.
+  /// Only one MarkupAddedEvent is invoked (with -1 as markup index,
+  /// meaning that multiple markups were added), which is much faster
+  /// than adding the markups one by one when there are many of them.
+  /// Return the number of added markups.
+  int AddPointsToNewMarkups(vtkPoints* points);
+
+  /// Get the positions of all the points of all the markups.
+  /// Points are concatenated in markup order.
+  /// \sa SetAllMarkupPoints
+  void GetAllMarkupPoints(vtkPoints* points);
+  /// Set the positions of all the points of all the markups.
+  /// The number of points must be the same as returned by GetAllMarkupPoints.
+  /// Only one modified event is invoked.
+  /// Returns false if the number of points does not match.
+  /// \sa GetAllMarkupPoints
+  bool SetAllMarkupPoints(vtkPoints* points);
 
   /// Get the position of the pointIndex'th point in markupIndex markup,
   /// returning it as a vtkVector3d
@@ -37,14 +37,21 @@
 
 // VTK includes
 #include <vtkAbstractWidget.h>
+#include <vtkActor.h>
+#include <vtkActor2D.h>
 #include <vtkFollower.h>
+#include <vtkGlyph3DMapper.h>
 #include <vtkHandleRepresentation.h>
 #include <vtkInteractorStyle.h>
+#include <vtkLabeledDataMapper.h>
 #include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkOrientedPolygonalHandleRepresentation3D.h>
 #include <vtkPickingManager.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
 #include <vtkProperty2D.h>
 #include <vtkProperty.h>
 #include <vtkRenderer.h>
@@ -53,8 +60,12 @@
 #include <vtkSmartPointer.h>
 #include <vtkSeedRepresentation.h>
 #include <vtkSphereSource.h>
+#include <vtkStringArray.h>
+#include <vtkTextProperty.h>
+#include <vtkUnsignedCharArray.h>
 
 // STD includes
+#include <map>
 #include <sstream>
 #include <string>
 
@@ -162,14 +173,72 @@ public:
   bool PointMovedSinceStartInteraction;
 };
 
+//---------------------------------------------------------------------------
+class vtkMRMLMarkupsFiducialDisplayableManager3D::vtkInternal
+{
+public:
+  /// Glyphs and labels of all the markups of a node displayed in batch
+  struct BatchPipeline
+    {
+    BatchPipeline()
+      {
+      this->PolyData = vtkSmartPointer<vtkPolyData>::New();
+      this->GlyphSource = vtkSmartPointer<vtkSphereSource>::New();
+      this->GlyphSource->SetRadius(0.5);
+      this->GlyphSource->SetPhiResolution(10);
+      this->GlyphSource->SetThetaResolution(10);
+      vtkNew<vtkGlyph3DMapper> glyphMapper;
+      glyphMapper->SetInputData(this->PolyData);
+      glyphMapper->SetSourceConnection(this->GlyphSource->GetOutputPort());
+      glyphMapper->ScalingOff();
+      glyphMapper->OrientOff();
+      this->GlyphActor = vtkSmartPointer<vtkActor>::New();
+      this->GlyphActor->SetMapper(glyphMapper.GetPointer());
+      vtkNew<vtkLabeledDataMapper> labelMapper;
+      labelMapper->SetInputData(this->PolyData);
+      labelMapper->SetLabelModeToLabelFieldData();
+      labelMapper->SetFieldDataName("Labels");
+      this->LabelActor = vtkSmartPointer<vtkActor2D>::New();
+      this->LabelActor->SetMapper(labelMapper.GetPointer());
+      }
+    vtkSmartPointer<vtkPolyData> PolyData;
+    vtkSmartPointer<vtkSphereSource> GlyphSource;
+    vtkSmartPointer<vtkActor> GlyphActor;
+    vtkSmartPointer<vtkActor2D> LabelActor;
+    };
+
+  typedef std::map<vtkMRMLMarkupsNode*, BatchPipeline*> BatchPipelinesType;
+  BatchPipelinesType BatchPipelines;
+};
+
 //---------------------------------------------------------------------------
 // vtkMRMLMarkupsFiducialDisplayableManager3D methods
 
+//---------------------------------------------------------------------------
+vtkMRMLMarkupsFiducialDisplayableManager3D::vtkMRMLMarkupsFiducialDisplayableManager3D()
+{
+  this->Focus = "vtkMRMLMarkupsFiducialNode";
+  this->BatchDisplayThreshold = 500;
+  this->Internal = new vtkInternal;
+}
+
+//---------------------------------------------------------------------------
+vtkMRMLMarkupsFiducialDisplayableManager3D::~vtkMRMLMarkupsFiducialDisplayableManager3D()
+{
+  for (vtkInternal::BatchPipelinesType::iterator it = this->Internal->BatchPipelines.begin();
+    it != this->Internal->BatchPipelines.end(); ++it)
+    {
+    delete it->second;
+    }
+  delete this->Internal;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLMarkupsFiducialDisplayableManager3D::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   this->Helper->PrintSelf(os, indent);
+  os << indent << "BatchDisplayThreshold: " << this->BatchDisplayThreshold << "\n";
 }
 
 //---------------------------------------------------------------------------
@@ -275,6 +344,11 @@ bool vtkMRMLMarkupsFiducialDisplayableManager3D::UpdateNthSeedPositionFromMRML(i
     {
     return false;
     }
+  if (this->UseBatchDisplay(pointsNode))
+    {
+    // there are no seeds, the batch display is updated with the node
+    return false;
+    }
   vtkSeedWidget *seedWidget = vtkSeedWidget::SafeDownCast(widget);
   if (!seedWidget)
     {
@@ -586,6 +660,20 @@ void vtkMRMLMarkupsFiducialDisplayableManager3D::PropagateMRMLToWidget(vtkMRMLMa
     vtkDebugMacro("PropagateMRMLToWidget: Could not get display node for node " << (fiducialNode->GetID() ? fiducialNode->GetID() : "null id"));
     }
 
+  if (this->UseBatchDisplay(fiducialNode))
+    {
+    // remove the seeds that were created before the node had many markups
+    vtkSeedRepresentation * seedRepresentation = vtkSeedRepresentation::SafeDownCast(seedWidget->GetRepresentation());
+    for (int n = seedRepresentation->GetNumberOfSeeds() - 1; n >= 0; n--)
+      {
+      seedWidget->DeleteSeed(n);
+      }
+    this->UpdateBatchDisplay(fiducialNode);
+    this->Updating = 0;
+    return;
+    }
+  this->RemoveBatchDisplay(fiducialNode);
+
   // iterate over the fiducials in this markup
   int numberOfFiducials = fiducialNode->GetNumberOfMarkups();
 
@@ -892,6 +980,11 @@ void vtkMRMLMarkupsFiducialDisplayableManager3D::UpdatePosition(vtkAbstractWidge
     vtkErrorMacro("UpdatePosition: no widget associated with points node " << pointsNode->GetID());
     return;
     }
+  if (this->UseBatchDisplay(pointsNode))
+    {
+    this->UpdateBatchDisplay(vtkMRMLMarkupsFiducialNode::SafeDownCast(pointsNode));
+    return;
+    }
   // cast to a seed widget
   vtkSeedWidget* seedWidget = vtkSeedWidget::SafeDownCast(widget);
 
@@ -926,6 +1019,18 @@ void vtkMRMLMarkupsFiducialDisplayableManager3D::OnMRMLSceneEndClose()
 {
   // clear out the map of glyph types
   this->Helper->ClearNodeGlyphTypes();
+
+  while (!this->Internal->BatchPipelines.empty())
+    {
+    this->RemoveBatchDisplay(this->Internal->BatchPipelines.begin()->first);
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsFiducialDisplayableManager3D::OnMRMLSceneNodeRemoved(vtkMRMLNode* node)
+{
+  this->RemoveBatchDisplay(vtkMRMLMarkupsNode::SafeDownCast(node));
+  this->Superclass::OnMRMLSceneNodeRemoved(node);
 }
 
 //---------------------------------------------------------------------------
@@ -938,6 +1043,12 @@ void vtkMRMLMarkupsFiducialDisplayableManager3D::OnMRMLMarkupsNodeNthMarkupModif
     return;
     }
 
+  if (this->UseBatchDisplay(node))
+    {
+    this->UpdateBatchDisplay(vtkMRMLMarkupsFiducialNode::SafeDownCast(node));
+    return;
+    }
+
   vtkAbstractWidget *widget = this->Helper->GetWidget(node);
   if (!widget)
     {
@@ -977,6 +1088,12 @@ void vtkMRMLMarkupsFiducialDisplayableManager3D::OnMRMLMarkupsNodeMarkupAddedEve
     this->AddWidget(markupsNode);
     return;
     }
+  if (this->UseBatchDisplay(markupsNode))
+    {
+    // removes the seeds when the node reaches the threshold
+    this->PropagateMRMLToWidget(markupsNode, widget);
+    return;
+    }
 
   vtkSeedWidget* seedWidget = vtkSeedWidget::SafeDownCast(widget);
   if (!seedWidget)
@@ -1014,3 +1131,115 @@ void vtkMRMLMarkupsFiducialDisplayableManager3D::OnMRMLMarkupsNodeMarkupRemovedE
   this->Helper->RemoveWidgetAndNode(markupsNode);
   this->AddWidget(markupsNode);
 }
+
+//---------------------------------------------------------------------------
+bool vtkMRMLMarkupsFiducialDisplayableManager3D::UseBatchDisplay(vtkMRMLMarkupsNode* node)
+{
+  return node && this->BatchDisplayThreshold >= 0
+    && node->GetNumberOfMarkups() > this->BatchDisplayThreshold;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsFiducialDisplayableManager3D::UpdateBatchDisplay(vtkMRMLMarkupsFiducialNode* fiducialNode)
+{
+  if (!fiducialNode)
+    {
+    return;
+    }
+  vtkInternal::BatchPipeline* pipeline = NULL;
+  vtkInternal::BatchPipelinesType::iterator it = this->Internal->BatchPipelines.find(fiducialNode);
+  if (it == this->Internal->BatchPipelines.end())
+    {
+    pipeline = new vtkInternal::BatchPipeline;
+    this->Internal->BatchPipelines[fiducialNode] = pipeline;
+    this->GetRenderer()->AddViewProp(pipeline->GlyphActor);
+    this->GetRenderer()->AddViewProp(pipeline->LabelActor);
+    }
+  else
+    {
+    pipeline = it->second;
+    }
+
+  vtkMRMLMarkupsDisplayNode *displayNode = fiducialNode->GetMarkupsDisplayNode();
+  vtkMRMLViewNode *viewNode = this->GetMRMLViewNode();
+  bool nodeVisible = displayNode && displayNode->GetVisibility()
+    && (!viewNode || displayNode->GetVisibility(viewNode->GetID()));
+  pipeline->GlyphActor->SetVisibility(nodeVisible);
+  pipeline->LabelActor->SetVisibility(nodeVisible);
+  if (!nodeVisible)
+    {
+    return;
+    }
+
+  // Collect the visible markups
+  int numberOfMarkups = fiducialNode->GetNumberOfMarkups();
+  vtkNew<vtkPoints> points;
+  points->Allocate(numberOfMarkups);
+  vtkNew<vtkUnsignedCharArray> colors;
+  colors->SetName("Colors");
+  colors->SetNumberOfComponents(3);
+  colors->Allocate(3 * numberOfMarkups);
+  vtkNew<vtkStringArray> labels;
+  labels->SetName("Labels");
+  labels->Allocate(numberOfMarkups);
+  unsigned char color[3] = { 0, 0, 0 };
+  unsigned char selectedColor[3] = { 0, 0, 0 };
+  for (int i = 0; i < 3; i++)
+    {
+    color[i] = static_cast<unsigned char>(displayNode->GetColor()[i] * 255.0);
+    selectedColor[i] = static_cast<unsigned char>(displayNode->GetSelectedColor()[i] * 255.0);
+    }
+  for (int n = 0; n < numberOfMarkups; n++)
+    {
+    if (!fiducialNode->GetNthFiducialVisibility(n))
+      {
+      continue;
+      }
+    double worldCoordinates[4] = { 0.0, 0.0, 0.0, 1.0 };
+    fiducialNode->GetMarkupPointWorld(n, 0, worldCoordinates);
+    points->InsertNextPoint(worldCoordinates);
+    const unsigned char* markupColor = fiducialNode->GetNthFiducialSelected(n) ? selectedColor : color;
+    colors->InsertNextTuple3(markupColor[0], markupColor[1], markupColor[2]);
+    labels->InsertNextValue(fiducialNode->GetNthFiducialLabel(n));
+    }
+  pipeline->PolyData->Initialize();
+  pipeline->PolyData->SetPoints(points.GetPointer());
+  pipeline->PolyData->GetPointData()->SetScalars(colors.GetPointer());
+  pipeline->PolyData->GetPointData()->AddArray(labels.GetPointer());
+
+  // Glyph size and material
+  vtkGlyph3DMapper* glyphMapper = vtkGlyph3DMapper::SafeDownCast(pipeline->GlyphActor->GetMapper());
+  glyphMapper->SetScaleFactor(displayNode->GetGlyphScale());
+  vtkProperty* property = pipeline->GlyphActor->GetProperty();
+  property->SetOpacity(displayNode->GetOpacity());
+  property->SetAmbient(displayNode->GetAmbient());
+  property->SetDiffuse(displayNode->GetDiffuse());
+  property->SetSpecular(displayNode->GetSpecular());
+
+  // Labels are rendered in screen space, text scale is used as font size
+  vtkLabeledDataMapper* labelMapper = vtkLabeledDataMapper::SafeDownCast(pipeline->LabelActor->GetMapper());
+  vtkTextProperty* textProperty = labelMapper->GetLabelTextProperty();
+  textProperty->SetColor(displayNode->GetColor());
+  textProperty->SetOpacity(displayNode->GetOpacity());
+  textProperty->SetFontSize(static_cast<int>(displayNode->GetTextScale() * 4.0 + 0.5));
+
+  this->RequestRender();
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsFiducialDisplayableManager3D::RemoveBatchDisplay(vtkMRMLMarkupsNode* node)
+{
+  vtkInternal::BatchPipelinesType::iterator it = this->Internal->BatchPipelines.find(node);
+  if (it == this->Internal->BatchPipelines.end())
+    {
+    return;
+    }
+  if (this->GetRenderer())
+    {
+    this->GetRenderer()->RemoveViewProp(it->second->GlyphActor);
+    this->GetRenderer()->RemoveViewProp(it->second->LabelActor);
+    }
+  delete it->second;
+  this->Internal->BatchPipelines.erase(it);
+  this->RequestRender();
+}
@@ -39,10 +39,17 @@ public:
   vtkTypeMacro(vtkMRMLMarkupsFiducialDisplayableManager3D, vtkMRMLMarkupsDisplayableManager3D);
   void PrintSelf(ostream& os, vtkIndent indent);
 
+  /// Markups nodes having more markups than this number are displayed with
+  /// a single glyph mapper and a single label actor instead of one handle
+  /// widget per markup. Markups displayed this way cannot be moved in the view.
+  /// A negative value disables it. Default is 500.
+  vtkSetMacro(BatchDisplayThreshold, int);
+  vtkGetMacro(BatchDisplayThreshold, int);
+
 protected:
 
-  vtkMRMLMarkupsFiducialDisplayableManager3D(){this->Focus="vtkMRMLMarkupsFiducialNode";}
-  virtual ~vtkMRMLMarkupsFiducialDisplayableManager3D(){}
+  vtkMRMLMarkupsFiducialDisplayableManager3D();
+  virtual ~vtkMRMLMarkupsFiducialDisplayableManager3D();
 
   /// Callback for click in RenderWindow
   virtual void OnClickInRenderWindow(double x, double y, const char *associatedNodeID);
@@ -78,9 +85,24 @@ protected:
 
   // Clean up when scene closes
   virtual void OnMRMLSceneEndClose();
+  /// Remove the batch display of removed nodes
+  virtual void OnMRMLSceneNodeRemoved(vtkMRMLNode* node);
+
+  /// Return true if all markups of the node are displayed by a single glyph mapper
+  /// \sa BatchDisplayThreshold
+  bool UseBatchDisplay(vtkMRMLMarkupsNode* node);
+  /// Update the glyphs and labels of a node displayed in batch
+  void UpdateBatchDisplay(vtkMRMLMarkupsFiducialNode* fiducialNode);
+  /// Remove the glyphs and labels of a node displayed in batch
+  void RemoveBatchDisplay(vtkMRMLMarkupsNode* node);
+
+  int BatchDisplayThreshold;
 
 private:
 
+  class vtkInternal;
+  vtkInternal* Internal;
+
   vtkMRMLMarkupsFiducialDisplayableManager3D(const vtkMRMLMarkupsFiducialDisplayableManager3D&); /// Not implemented
   void operator=(const vtkMRMLMarkupsFiducialDisplayableManager3D&); /// Not Implemented
 };
@@ -20,6 +20,8 @@
 
 // VTK includes
 #include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkTransform.h>
 #include <vtkTestingOutputWindow.h>
 
 // test copy and swap
@@ -197,5 +199,61 @@ int vtkMRMLMarkupsNodeTest2(int , char * [] )
     return EXIT_FAILURE;
     }
 
+  // test bulk access to points
+  vtkNew<vtkMRMLMarkupsNode> node2;
+  vtkNew<vtkPoints> newPoints;
+  for (int i = 0; i < 100; i++)
+    {
+    newPoints->InsertNextPoint(i, 2.0 * i, -i);
+    }
+  if (node2->AddPointsToNewMarkups(newPoints.GetPointer()) != 100
+    || node2->GetNumberOfMarkups() != 100)
+    {
+    std::cerr << "AddPointsToNewMarkups failed, number of markups: "
+              << node2->GetNumberOfMarkups() << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (node2->GetNthMarkupID(0) == node2->GetNthMarkupID(99))
+    {
+    std::cerr << "AddPointsToNewMarkups failed, markup IDs are not unique" << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkNew<vtkTransform> translation;
+  translation->Translate(10.0, 20.0, 30.0);
+  node2->ApplyTransform(translation.GetPointer());
+  vtkNew<vtkPoints> allPoints;
+  node2->GetAllMarkupPoints(allPoints.GetPointer());
+  if (allPoints->GetNumberOfPoints() != 100)
+    {
+    std::cerr << "GetAllMarkupPoints failed, number of points: "
+              << allPoints->GetNumberOfPoints() << std::endl;
+    return EXIT_FAILURE;
+    }
+  double transformedPoint[3] = { 0.0, 0.0, 0.0 };
+  node2->GetMarkupPoint(50, 0, transformedPoint);
+  if (transformedPoint[0] != 60.0 || transformedPoint[1] != 120.0 || transformedPoint[2] != -20.0
+    || allPoints->GetPoint(50)[1] != 120.0)
+    {
+    std::cerr << "ApplyTransform failed, point 50 is "
+              << transformedPoint[0] << ", " << transformedPoint[1] << ", " << transformedPoint[2] << std::endl;
+    return EXIT_FAILURE;
+    }
+  allPoints->SetPoint(3, 1.0, 2.0, 3.0);
+  if (!node2->SetAllMarkupPoints(allPoints.GetPointer())
+    || node2->GetMarkupPointVector(3, 0).GetZ() != 3.0)
+    {
+    std::cerr << "SetAllMarkupPoints failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  allPoints->SetNumberOfPoints(10);
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  bool setResult = node2->SetAllMarkupPoints(allPoints.GetPointer());
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+  if (setResult)
+    {
+    std::cerr << "SetAllMarkupPoints did not fail for mismatching number of points" << std::endl;
+    return EXIT_FAILURE;
+    }
+
   return EXIT_SUCCESS;
 }
@@ -3010,7 +3010,9 @@ void qSlicerMarkupsModuleWidget::onActiveMarkupsNodeMarkupAddedEvent(vtkObject *
 {
   Q_D(qSlicerMarkupsModuleWidget);
 
-  if (callData == NULL)
+  // a negative markup index means that multiple markups were added
+  int* markupIndexPtr = reinterpret_cast<int*>(callData);
+  if (markupIndexPtr == NULL || *markupIndexPtr < 0)
     {
     // batch update
     this->updateWidgetFromMRML();
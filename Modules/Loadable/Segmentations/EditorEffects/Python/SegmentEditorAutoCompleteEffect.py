@@ -21,6 +21,9 @@ class SegmentEditorAutoCompleteEffect(AbstractScriptedSegmentEditorEffect):
     self.selectedSegmentModifiedTimes = {} # map from segment ID to ModifiedTime
     self.clippedMasterImageData = None
     self.growCutFilter = None
+    self.interpolator = None
+    # Result of the last preview update, only segments that are changed compared to it are updated in the preview
+    self.previousOutputLabelmap = None
     # Observation for auto-update
     self.observedSegmentation = None
     self.segmentationNodeObserverTags = []
@@ -258,6 +261,8 @@ The complete segmentation will be created by interpolating segmentations on slic
     self.selectedSegmentModifiedTimes = {}
     self.clippedMasterImageData = None
     self.growCutFilter = None
+    self.interpolator = None
+    self.previousOutputLabelmap = None
     self.updateGUIFromMRML()
 
   def onCancel(self):
@@ -373,10 +378,13 @@ The complete segmentation will be created by interpolating segmentations on slic
 
     if method == MORPHOLOGICAL_SLICE_INTERPOLATION:
         import vtkITK
-        interpolator = vtkITK.vtkITKMorphologicalContourInterpolator()
-        interpolator.SetInputData(mergedImage)
-        interpolator.Update()
-        outputLabelmap.DeepCopy(interpolator.GetOutput())
+        if not self.interpolator:
+          # Keep the interpolator so that in subsequent updates only the gaps next to the modified slices are computed
+          self.interpolator = vtkITK.vtkITKMorphologicalContourInterpolator()
+          self.interpolator.IncrementalOn()
+        self.interpolator.SetInputData(mergedImage)
+        self.interpolator.Update()
+        outputLabelmap.DeepCopy(self.interpolator.GetOutput())
 
     elif method == GROWCUT:
 
@@ -397,36 +405,25 @@ The complete segmentation will be created by interpolating segmentations on slic
       logging.error("Invalid auto-complete method {0}".format(smoothingMethod))
       return
 
-    # Write output segmentation results in segments
+    # Create preview segments
+    previewSegmentsAdded = False
     for index in xrange(self.selectedSegmentIds.GetNumberOfValues()):
       segmentID = self.selectedSegmentIds.GetValue(index)
+      if previewNode.GetSegmentation().GetSegment(segmentID):
+        continue
       segment = segmentationNode.GetSegmentation().GetSegment(segmentID)
-      # Disable save with scene?
-
-      # Get only the label of the current segment from the output image
-      thresh = vtk.vtkImageThreshold()
-      thresh.ReplaceInOn()
-      thresh.ReplaceOutOn()
-      thresh.SetInValue(1)
-      thresh.SetOutValue(0)
-      labelValue = index + 1 # n-th segment label value = n + 1 (background label value is 0)
-      thresh.ThresholdBetween(labelValue, labelValue);
-      thresh.SetOutputScalarType(vtk.VTK_UNSIGNED_CHAR)
-      thresh.SetInputData(outputLabelmap)
-      thresh.Update()
-
-      # Write label to segment
-      newSegmentLabelmap = vtkSegmentationCore.vtkOrientedImageData()
-      newSegmentLabelmap.ShallowCopy(thresh.GetOutput())
-      newSegmentLabelmap.CopyDirections(mergedImage)
-      newSegment = previewNode.GetSegmentation().GetSegment(segmentID)
-      if not newSegment:
-        newSegment = vtkSegmentationCore.vtkSegment()
-        newSegment.SetName(segment.GetName())
-        color = segmentationNode.GetSegmentation().GetSegment(segmentID).GetColor()
-        newSegment.SetColor(color)
-        previewNode.GetSegmentation().AddSegment(newSegment, segmentID)
-      slicer.vtkSlicerSegmentationsModuleLogic.SetBinaryLabelmapToSegment(newSegmentLabelmap, previewNode, segmentID)
+      newSegment = vtkSegmentationCore.vtkSegment()
+      newSegment.SetName(segment.GetName())
+      newSegment.SetColor(segment.GetColor())
+      previewNode.GetSegmentation().AddSegment(newSegment, segmentID)
+      previewSegmentsAdded = True
+
+    # Write output segmentation results in segments (n-th segment label value = n + 1).
+    # Only segments that have changed since the last update are written.
+    outputLabelmap.CopyDirections(mergedImage)
+    slicer.vtkSlicerSegmentationsModuleLogic.SetLabelmapToSegments(outputLabelmap, previewNode, self.selectedSegmentIds,
+      None if previewSegmentsAdded else self.previousOutputLabelmap)
+    self.previousOutputLabelmap = outputLabelmap
 
     self.updateGUIFromMRML()
 
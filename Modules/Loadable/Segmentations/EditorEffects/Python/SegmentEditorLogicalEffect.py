@@ -195,6 +195,8 @@ class SegmentEditorLogicalEffect(AbstractScriptedSegmentEditorEffect):
       if not modifierSegmentID:
         logging.error("Operation {0} requires a selected modifier segment".format(operation))
         return
+      modifierSegmentIDs = vtk.vtkStringArray()
+      modifierSegmentIDs.InsertNextValue(modifierSegmentID)
       modifierSegment = segmentation.GetSegment(modifierSegmentID)
       modifierSegmentLabelmap = modifierSegment.GetRepresentation(vtkSegmentationCore.vtkSegmentationConverter.GetSegmentationBinaryLabelmapRepresentationName())
 
@@ -206,34 +208,25 @@ class SegmentEditorLogicalEffect(AbstractScriptedSegmentEditorEffect):
           self.scriptedEffect.modifySelectedSegmentByLabelmap(modifierSegmentLabelmap, slicer.qSlicerSegmentEditorAbstractEffect.ModificationModeSet)
       elif operation == LOGICAL_UNION:
         if bypassMasking:
-          slicer.vtkSlicerSegmentationsModuleLogic.SetBinaryLabelmapToSegment(modifierSegmentLabelmap,
-            segmentationNode, selectedSegmentID, slicer.vtkSlicerSegmentationsModuleLogic.MODE_MERGE_MAX, modifierSegmentLabelmap.GetExtent())
+          slicer.vtkSlicerSegmentationsModuleLogic.ApplyBooleanOperation(segmentationNode, selectedSegmentID,
+            slicer.vtkSlicerSegmentationsModuleLogic.BOOLEAN_UNION, modifierSegmentIDs)
         else:
           self.scriptedEffect.modifySelectedSegmentByLabelmap(modifierSegmentLabelmap, slicer.qSlicerSegmentEditorAbstractEffect.ModificationModeAdd)
       elif operation == LOGICAL_SUBTRACT:
         if bypassMasking:
-          invertedModifierSegmentLabelmap = self.getInvertedBinaryLabelmap(modifierSegmentLabelmap)
-          slicer.vtkSlicerSegmentationsModuleLogic.SetBinaryLabelmapToSegment(invertedModifierSegmentLabelmap, segmentationNode, selectedSegmentID,
-            slicer.vtkSlicerSegmentationsModuleLogic.MODE_MERGE_MIN, modifierSegmentLabelmap.GetExtent())
+          slicer.vtkSlicerSegmentationsModuleLogic.ApplyBooleanOperation(segmentationNode, selectedSegmentID,
+            slicer.vtkSlicerSegmentationsModuleLogic.BOOLEAN_SUBTRACT, modifierSegmentIDs)
         else:
           self.scriptedEffect.modifySelectedSegmentByLabelmap(modifierSegmentLabelmap, slicer.qSlicerSegmentEditorAbstractEffect.ModificationModeRemove)
       elif operation == LOGICAL_INTERSECT:
-        selectedSegmentLabelmap = self.scriptedEffect.selectedSegmentLabelmap()
-        intersectionLabelmap = vtkSegmentationCore.vtkOrientedImageData()
-        vtkSegmentationCore.vtkOrientedImageDataResample.MergeImage(selectedSegmentLabelmap, modifierSegmentLabelmap, intersectionLabelmap, vtkSegmentationCore.vtkOrientedImageDataResample.OPERATION_MINIMUM, selectedSegmentLabelmap.GetExtent())
-        selectedSegmentLabelmapExtent = selectedSegmentLabelmap.GetExtent()
-        modifierSegmentLabelmapExtent = modifierSegmentLabelmap.GetExtent()
-        commonExtent = [max(selectedSegmentLabelmapExtent[0], modifierSegmentLabelmapExtent[0]),
-          min(selectedSegmentLabelmapExtent[1], modifierSegmentLabelmapExtent[1]),
-          max(selectedSegmentLabelmapExtent[2], modifierSegmentLabelmapExtent[2]),
-          min(selectedSegmentLabelmapExtent[3], modifierSegmentLabelmapExtent[3]),
-          max(selectedSegmentLabelmapExtent[4], modifierSegmentLabelmapExtent[4]),
-          min(selectedSegmentLabelmapExtent[5], modifierSegmentLabelmapExtent[5])]
         if bypassMasking:
-          slicer.vtkSlicerSegmentationsModuleLogic.SetBinaryLabelmapToSegment(intersectionLabelmap, segmentationNode, selectedSegmentID,
-            slicer.vtkSlicerSegmentationsModuleLogic.MODE_REPLACE, commonExtent)
+          slicer.vtkSlicerSegmentationsModuleLogic.ApplyBooleanOperation(segmentationNode, selectedSegmentID,
+            slicer.vtkSlicerSegmentationsModuleLogic.BOOLEAN_INTERSECT, modifierSegmentIDs)
         else:
-          self.scriptedEffect.modifySelectedSegmentByLabelmap(intersectionLabelmap, slicer.qSlicerSegmentEditorAbstractEffect.ModificationModeSet, commonExtent)
+          intersectionLabelmap = vtkSegmentationCore.vtkOrientedImageData()
+          slicer.vtkSlicerSegmentationsModuleLogic.GetBooleanOperationResult(segmentationNode, selectedSegmentID,
+            slicer.vtkSlicerSegmentationsModuleLogic.BOOLEAN_INTERSECT, modifierSegmentIDs, intersectionLabelmap)
+          self.scriptedEffect.modifySelectedSegmentByLabelmap(intersectionLabelmap, slicer.qSlicerSegmentEditorAbstractEffect.ModificationModeSet)
 
     elif operation == LOGICAL_INVERT:
       selectedSegmentLabelmap = self.scriptedEffect.selectedSegmentLabelmap()
@@ -1,5 +1,6 @@
 import os
 import vtk, qt, ctk, slicer
+import vtkITK
 import logging
 from SegmentEditorEffects import *
 
@@ -127,33 +128,68 @@ class SegmentEditorMarginEffect(AbstractScriptedSegmentEditorEffect):
     marginSizeMm = self.scriptedEffect.doubleParameter("MarginSizeMm")
     kernelSizePixel = self.getKernelSizePixel()
 
-    # We need to know exactly the value of the segment voxels, apply threshold to make force the selected label value
+    # Only the neighborhood of the segment can change
+    effectiveExtent = [0, -1, 0, -1, 0, -1]
+    if not slicer.vtkOrientedImageDataResample.CalculateEffectiveExtent(selectedSegmentLabelmap, effectiveExtent):
+      # Empty segment, there is nothing to grow or shrink
+      return
+    fullExtent = selectedSegmentLabelmap.GetExtent()
+    padding = [(abs(size)-1)//2 if marginSizeMm>0 else 1 for size in kernelSizePixel]
+    computedExtent = [0, -1, 0, -1, 0, -1]
+    for axis in range(3):
+      computedExtent[axis*2] = max(effectiveExtent[axis*2]-padding[axis], fullExtent[axis*2])
+      computedExtent[axis*2+1] = min(effectiveExtent[axis*2+1]+padding[axis], fullExtent[axis*2+1])
+
+    # The kernel of the margin is an ellipsoid, its radius is half the kernel size.
+    # A voxel is within the kernel of an object voxel if their distance is at most 1
+    # when the spacing is divided by the kernel radius.
+    # Shrinking the segment is growing the background.
     labelValue = 1
     backgroundValue = 0
     thresh = vtk.vtkImageThreshold()
     thresh.SetInputData(selectedSegmentLabelmap)
     thresh.ThresholdByLower(0)
-    thresh.SetInValue(backgroundValue)
-    thresh.SetOutValue(labelValue)
-    thresh.SetOutputScalarType(selectedSegmentLabelmap.GetScalarType())
-
-    erodeDilate = vtk.vtkImageDilateErode3D()
-    erodeDilate.SetInputConnection(thresh.GetOutputPort())
-    if marginSizeMm>0:
-      # grow
-      erodeDilate.SetDilateValue(labelValue)
-      erodeDilate.SetErodeValue(backgroundValue)
-    else:
-      # shrink
-      erodeDilate.SetDilateValue(backgroundValue)
-      erodeDilate.SetErodeValue(labelValue)
+    thresh.SetInValue(backgroundValue if marginSizeMm>0 else labelValue)
+    thresh.SetOutValue(labelValue if marginSizeMm>0 else backgroundValue)
+    thresh.SetOutputScalarType(vtk.VTK_FLOAT)
+
+    crop = vtk.vtkImageConstantPad()
+    crop.SetInputConnection(thresh.GetOutputPort())
+    crop.SetOutputWholeExtent(computedExtent)
+
+    spacing = selectedSegmentLabelmap.GetSpacing()
+    kernelSpacing = vtk.vtkImageChangeInformation()
+    kernelSpacing.SetInputConnection(crop.GetOutputPort())
+    kernelSpacing.SetOutputSpacing([spacing[axis]/(abs(kernelSizePixel[axis])/2.0) for axis in range(3)])
+
+    distance = vtkITK.vtkITKDistanceTransform()
+    distance.SetInputConnection(kernelSpacing.GetOutputPort())
+    distance.SetSquaredDistance(0)
+    distance.SetUseImageSpacing(1)
+    distance.SetInsideIsPositive(0)
+    distance.SetBackgroundValue(backgroundValue)
+
+    reached = vtk.vtkImageThreshold()
+    reached.SetInputConnection(distance.GetOutputPort())
+    reached.ThresholdByLower(1.0 + 1e-3)
+    reached.SetInValue(labelValue if marginSizeMm>0 else backgroundValue)
+    reached.SetOutValue(backgroundValue if marginSizeMm>0 else labelValue)
+    reached.SetOutputScalarType(selectedSegmentLabelmap.GetScalarType())
+
+    restoreSpacing = vtk.vtkImageChangeInformation()
+    restoreSpacing.SetInputConnection(reached.GetOutputPort())
+    restoreSpacing.SetOutputSpacing(spacing)
+
+    pad = vtk.vtkImageConstantPad()
+    pad.SetInputConnection(restoreSpacing.GetOutputPort())
+    pad.SetOutputWholeExtent(fullExtent)
+    pad.SetConstant(backgroundValue)
 
     # This can be a long operation - indicate it to the user
     qt.QApplication.setOverrideCursor(qt.Qt.WaitCursor)
 
-    erodeDilate.SetKernelSize(kernelSizePixel[0],kernelSizePixel[1],kernelSizePixel[2])
-    erodeDilate.Update()
-    modifierLabelmap.DeepCopy(erodeDilate.GetOutput())
+    pad.Update()
+    modifierLabelmap.DeepCopy(pad.GetOutput())
 
     # Apply changes
     self.scriptedEffect.modifySelectedSegmentByLabelmap(modifierLabelmap, slicer.qSlicerSegmentEditorAbstractEffect.ModificationModeSet)
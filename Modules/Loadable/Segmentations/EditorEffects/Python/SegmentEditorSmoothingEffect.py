@@ -40,12 +40,14 @@ class SegmentEditorSmoothingEffect(AbstractScriptedSegmentEditorEffect):
     self.methodSelectorComboBox.addItem("Closing (fill holes)", MORPHOLOGICAL_CLOSING)
     self.methodSelectorComboBox.addItem("Gaussian", GAUSSIAN)
     self.methodSelectorComboBox.addItem("Joint smoothing", JOINT_TAUBIN)
+    self.methodSelectorComboBox.addItem("Joint Gaussian smoothing", JOINT_GAUSSIAN)
     self.methodSelectorComboBox.setToolTip("""<html>Smoothing methods:<ul style="margin: 0">
 <li><b>Median:</b> removes small details while keeps smooth contours mostly unchanged.</li>
 <li><b>Opening:</b> removes extrusions smaller than the specified kernel size.</li>
 <li><b>Closing:</b> fills sharp corners and holes smaller than the specified kernel size.</li>
 <li><b>Gaussian:</b> smoothes all contours, tends to shrink the segment.</li>
 <li><b>Joint smoothing:</b> smoothes all visible segments at once. It requires segments to be non-overlapping. Bypasses masking settings.</li>
+<li><b>Joint Gaussian smoothing:</b> smoothes all visible segments at once using a Gaussian filter, without creating gaps or overlaps between them. It requires segments to be non-overlapping. Bypasses masking settings.</li>
 </ul></html>""")
     self.scriptedEffect.addLabeledOptionsWidget("Smoothing method:", self.methodSelectorComboBox)
 
@@ -111,8 +113,8 @@ class SegmentEditorSmoothingEffect(AbstractScriptedSegmentEditorEffect):
     self.kernelSizeMmLabel.setVisible(morphologicalMethod)
     self.kernelSizeMmSpinBox.setVisible(morphologicalMethod)
     self.kernelSizePixel.setVisible(morphologicalMethod)
-    self.gaussianStandardDeviationMmLabel.setVisible(smoothingMethod==GAUSSIAN)
-    self.gaussianStandardDeviationMmSpinBox.setVisible(smoothingMethod==GAUSSIAN)
+    self.gaussianStandardDeviationMmLabel.setVisible(smoothingMethod==GAUSSIAN or smoothingMethod==JOINT_GAUSSIAN)
+    self.gaussianStandardDeviationMmSpinBox.setVisible(smoothingMethod==GAUSSIAN or smoothingMethod==JOINT_GAUSSIAN)
     self.jointTaubinSmoothingFactorLabel.setVisible(smoothingMethod==JOINT_TAUBIN)
     self.jointTaubinSmoothingFactorSlider.setVisible(smoothingMethod==JOINT_TAUBIN)
 
@@ -173,6 +175,8 @@ class SegmentEditorSmoothingEffect(AbstractScriptedSegmentEditorEffect):
       smoothingMethod = self.scriptedEffect.parameter("SmoothingMethod")
       if smoothingMethod == JOINT_TAUBIN:
         self.smoothMultipleSegments()
+      elif smoothingMethod == JOINT_GAUSSIAN:
+        self.smoothMultipleSegmentsGaussian()
       else:
         self.smoothSelectedSegment()
     finally:
@@ -345,8 +349,20 @@ class SegmentEditorSmoothingEffect(AbstractScriptedSegmentEditorEffect):
       slicer.vtkSlicerSegmentationsModuleLogic.SetBinaryLabelmapToSegment(smoothedBinaryLabelMap,
         segmentationNode, segmentId, slicer.vtkSlicerSegmentationsModuleLogic.MODE_REPLACE, smoothedBinaryLabelMap.GetExtent())
 
+  def smoothMultipleSegmentsGaussian(self):
+    segmentationNode = self.scriptedEffect.parameterSetNode().GetSegmentationNode()
+    visibleSegmentIds = vtk.vtkStringArray()
+    segmentationNode.GetDisplayNode().GetVisibleSegmentIDs(visibleSegmentIds)
+    if visibleSegmentIds.GetNumberOfValues() == 0:
+      logging.info("Smoothing operation skipped: there are no visible segments")
+      return
+    standardDeviationMm = self.scriptedEffect.doubleParameter("GaussianStandardDeviationMm")
+    if not slicer.vtkSlicerSegmentationsModuleLogic.SmoothSegmentsJointly(segmentationNode, standardDeviationMm, visibleSegmentIds):
+      logging.error('Failed to apply joint Gaussian smoothing')
+
 MEDIAN = 'MEDIAN'
 GAUSSIAN = 'GAUSSIAN'
 MORPHOLOGICAL_OPENING = 'MORPHOLOGICAL_OPENING'
 MORPHOLOGICAL_CLOSING = 'MORPHOLOGICAL_CLOSING'
 JOINT_TAUBIN = 'JOINT_TAUBIN'
+JOINT_GAUSSIAN = 'JOINT_GAUSSIAN'
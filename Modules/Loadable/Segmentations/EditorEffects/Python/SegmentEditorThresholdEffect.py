@@ -140,6 +140,8 @@ class SegmentEditorThresholdEffect(AbstractScriptedSegmentEditorEffect):
   #
   def onThresholdValuesChanged(self,min,max):
     self.scriptedEffect.updateMRMLFromGUI()
+    # Update the preview right away instead of waiting for the next pulse
+    self.updatePreview()
 
   def onUseForPaint(self):
     parameterSetNode = self.scriptedEffect.parameterSetNode()
@@ -211,6 +213,19 @@ class SegmentEditorThresholdEffect(AbstractScriptedSegmentEditorEffect):
       self.scriptedEffect.addActor2D(sliceWidget, pipeline.actor)
 
   def preview(self):
+    self.updatePreview()
+
+    self.previewState += self.previewStep
+    if self.previewState >= self.previewSteps:
+      self.previewStep = -1
+    if self.previewState <= 0:
+      self.previewStep = 1
+
+  def updatePreview(self):
+    """Show voxels of the background layer within the threshold range in all slice views.
+    The threshold is applied by the lookup table, so only the colors need to be mapped."""
+    if not self.previewPipelines:
+      return
     opacity = 0.5 + self.previewState / (2. * self.previewSteps)
     min = self.scriptedEffect.doubleParameter("MinimumThreshold")
     max = self.scriptedEffect.doubleParameter("MaximumThreshold")
@@ -227,20 +242,14 @@ class SegmentEditorThresholdEffect(AbstractScriptedSegmentEditorEffect):
     # Set values to pipelines
     for sliceWidget in self.previewPipelines:
       pipeline = self.previewPipelines[sliceWidget]
-      pipeline.lookupTable.SetTableValue(1,  r, g, b,  opacity)
+      pipeline.lookupTable.SetTableValue(0,  r, g, b,  opacity)
+      pipeline.lookupTable.SetTableRange(min, max)
       sliceLogic = sliceWidget.sliceLogic()
       backgroundLogic = sliceLogic.GetBackgroundLayer()
-      pipeline.thresholdFilter.SetInputConnection(backgroundLogic.GetReslice().GetOutputPort())
-      pipeline.thresholdFilter.ThresholdBetween(min, max)
+      pipeline.colorMapper.SetInputConnection(backgroundLogic.GetReslice().GetOutputPort())
       pipeline.actor.VisibilityOn()
       sliceWidget.sliceView().scheduleRender()
 
-    self.previewState += self.previewStep
-    if self.previewState >= self.previewSteps:
-      self.previewStep = -1
-    if self.previewState <= 0:
-      self.previewStep = 1
-
 #
 # PreviewPipeline
 #
@@ -249,18 +258,19 @@ class PreviewPipeline:
   """
 
   def __init__(self):
+    # The table range is the threshold range: values inside are mapped to the
+    # single table value (segment color), values outside are transparent.
+    # This maps the resliced background directly, without thresholding it first.
     self.lookupTable = vtk.vtkLookupTable()
-    self.lookupTable.SetRampToLinear()
-    self.lookupTable.SetNumberOfTableValues(2)
-    self.lookupTable.SetTableRange(0, 1)
+    self.lookupTable.SetNumberOfTableValues(1)
     self.lookupTable.SetTableValue(0,  0, 0, 0,  0)
+    self.lookupTable.UseBelowRangeColorOn()
+    self.lookupTable.SetBelowRangeColor(0, 0, 0, 0)
+    self.lookupTable.UseAboveRangeColorOn()
+    self.lookupTable.SetAboveRangeColor(0, 0, 0, 0)
     self.colorMapper = vtk.vtkImageMapToRGBA()
     self.colorMapper.SetOutputFormatToRGBA()
     self.colorMapper.SetLookupTable(self.lookupTable)
-    self.thresholdFilter = vtk.vtkImageThreshold()
-    self.thresholdFilter.SetInValue(1)
-    self.thresholdFilter.SetOutValue(0)
-    self.thresholdFilter.SetOutputScalarTypeToUnsignedChar()
 
     # Feedback actor
     self.mapper = vtk.vtkImageMapper()
@@ -274,5 +284,4 @@ class PreviewPipeline:
     self.mapper.SetColorLevel(128)
 
     # Setup pipeline
-    self.colorMapper.SetInputConnection(self.thresholdFilter.GetOutputPort())
     self.mapper.SetInputConnection(self.colorMapper.GetOutputPort())
@@ -27,6 +27,7 @@
 #include "vtkMRMLSegmentEditorNode.h"
 #include "vtkOrientedImageData.h"
 #include "vtkSlicerSegmentationsModuleLogic.h"
+#include "vtkSlicerSegmentEditorLogic.h"
 
 // Qt includes
 #include <QDebug>
@@ -254,8 +255,6 @@ void qSlicerSegmentEditorAbstractEffect::modifySelectedSegmentByLabelmap(vtkOrie
 //-----------------------------------------------------------------------------
 void qSlicerSegmentEditorAbstractEffect::modifySelectedSegmentByLabelmap(vtkOrientedImageData* modifierLabelmapInput, ModificationMode modificationMode, const int modificationExtent[6])
 {
-  Q_D(qSlicerSegmentEditorAbstractEffect);
-
   vtkMRMLSegmentEditorNode* parameterSetNode = this->parameterSetNode();
   if (!parameterSetNode)
     {
@@ -264,83 +263,14 @@ void qSlicerSegmentEditorAbstractEffect::modifySelectedSegmentByLabelmap(vtkOrie
     return;
     }
 
-  vtkSmartPointer<vtkOrientedImageData> modifierLabelmap = modifierLabelmapInput;
-
-  // Apply mask to modifier labelmap if paint over is turned off
-  if (parameterSetNode->GetMaskMode() != vtkMRMLSegmentEditorNode::PaintAllowedEverywhere)
-    {
-    vtkOrientedImageData* maskImage = this->maskLabelmap();
-
-    if (modifierLabelmap.GetPointer() == modifierLabelmapInput)
-      {
-      // make a copy to not modify the input
-      vtkNew<vtkOrientedImageData> maskedModifierLabelmap;
-      maskedModifierLabelmap->DeepCopy(modifierLabelmap);
-      modifierLabelmap = maskedModifierLabelmap.GetPointer();
-      }
-    this->applyImageMask(modifierLabelmap, maskImage, this->m_EraseValue, true);
-    }
-
-  // Apply threshold mask if paint threshold is turned on
-  if (parameterSetNode->GetMasterVolumeIntensityMask())
-    {
-    vtkOrientedImageData* masterVolumeOrientedImageData = this->masterVolumeImageData();
-    if (!masterVolumeOrientedImageData)
-      {
-      qCritical() << Q_FUNC_INFO << ": Unable to get master volume image";
-      this->defaultModifierLabelmap();
-      return;
-      }
-    // Make sure the modifier labelmap has the same geometry as the master volume
-    if (!vtkOrientedImageDataResample::DoGeometriesMatch(modifierLabelmap, masterVolumeOrientedImageData))
-      {
-      qCritical() << Q_FUNC_INFO << ": Modifier labelmap should have the same geometry as the master volume";
-      this->defaultModifierLabelmap();
-      return;
-      }
-
-    // Create threshold image
-    vtkSmartPointer<vtkImageThreshold> threshold = vtkSmartPointer<vtkImageThreshold>::New();
-    threshold->SetInputData(masterVolumeOrientedImageData);
-    threshold->ThresholdBetween(parameterSetNode->GetMasterVolumeIntensityMaskRange()[0], parameterSetNode->GetMasterVolumeIntensityMaskRange()[1]);
-    threshold->SetInValue(1);
-    threshold->SetOutValue(0);
-    threshold->SetOutputScalarType(modifierLabelmap->GetScalarType());
-    threshold->Update();
-
-    vtkSmartPointer<vtkOrientedImageData> thresholdMask = vtkSmartPointer<vtkOrientedImageData>::New();
-    thresholdMask->DeepCopy(threshold->GetOutput());
-    vtkSmartPointer<vtkMatrix4x4> modifierLabelmapToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
-    modifierLabelmap->GetImageToWorldMatrix(modifierLabelmapToWorldMatrix);
-    thresholdMask->SetGeometryFromImageToWorldMatrix(modifierLabelmapToWorldMatrix);
-
-    if (modifierLabelmap.GetPointer() == modifierLabelmapInput)
-      {
-      // make a copy to not modify the input
-      vtkNew<vtkOrientedImageData> maskedModifierLabelmap;
-      maskedModifierLabelmap->DeepCopy(modifierLabelmap);
-      modifierLabelmap = maskedModifierLabelmap.GetPointer();
-      }
-    this->applyImageMask(modifierLabelmap.GetPointer(), thresholdMask, this->m_EraseValue);
-    }
-
-  if (!d->ParameterSetNode)
-    {
-    qCritical() << Q_FUNC_INFO << ": Invalid segment editor parameter set node";
-    this->defaultModifierLabelmap();
-    return;
-    }
-
-  vtkMRMLSegmentationNode* segmentationNode = d->ParameterSetNode->GetSegmentationNode();
-  const char* selectedSegmentID = d->ParameterSetNode->GetSelectedSegmentID();
-  if (!segmentationNode || !selectedSegmentID)
+  if (!parameterSetNode->GetSegmentationNode() || !parameterSetNode->GetSelectedSegmentID())
     {
     qCritical() << Q_FUNC_INFO << ": Invalid segment selection";
     this->defaultModifierLabelmap();
     return;
     }
 
-  if (!modifierLabelmap)
+  if (!modifierLabelmapInput)
     {
     // If per-segment flag is off, then it is not an error (the effect itself has written it back to segmentation)
     if (this->perSegment())
@@ -351,124 +281,29 @@ void qSlicerSegmentEditorAbstractEffect::modifySelectedSegmentByLabelmap(vtkOrie
     return;
     }
 
-  // Copy the temporary padded modifier labelmap to the segment.
-  // Mask and threshold was already applied on modifier labelmap at this point if requested.
-  const int* extent = modificationExtent;
-  if (extent[0]>extent[1] || extent[2]>extent[3] || extent[4]>extent[5])
-    {
-    // invalid extent, it means we have to work with the entire modifier labelmap
-    extent = NULL;
-    }
-
-  // TODO: composite modifierLabelmap with threshold mask
-
-  // Create inverted binary labelmap
-  vtkSmartPointer<vtkImageThreshold> inverter = vtkSmartPointer<vtkImageThreshold>::New();
-  inverter->SetInputData(modifierLabelmap);
-  inverter->SetInValue(m_FillValue);
-  inverter->SetOutValue(m_EraseValue);
-  inverter->ReplaceInOn();
-  inverter->ThresholdByLower(0);
-  inverter->SetOutputScalarType(VTK_UNSIGNED_CHAR);
-
-  if (modificationMode == qSlicerSegmentEditorAbstractEffect::ModificationModeSet)
-    {
-    if (!vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(
-      modifierLabelmap, segmentationNode, selectedSegmentID, vtkSlicerSegmentationsModuleLogic::MODE_REPLACE, extent))
-      {
-      qCritical() << Q_FUNC_INFO << ": Failed to set modifier labelmap to selected segment";
-      }
-    }
-  else if (modificationMode == qSlicerSegmentEditorAbstractEffect::ModificationModeAdd)
+  vtkOrientedImageData* maskImage = NULL;
+  if (parameterSetNode->GetMaskMode() != vtkMRMLSegmentEditorNode::PaintAllowedEverywhere)
     {
-    if (!vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(
-      modifierLabelmap, segmentationNode, selectedSegmentID, vtkSlicerSegmentationsModuleLogic::MODE_MERGE_MAX, extent))
-      {
-      qCritical() << Q_FUNC_INFO << ": Failed to add modifier labelmap to selected segment";
-      }
+    maskImage = this->maskLabelmap();
     }
-  else if (modificationMode == qSlicerSegmentEditorAbstractEffect::ModificationModeRemove)
-    {
-    inverter->Update();
-    vtkNew<vtkOrientedImageData> invertedModifierLabelmap;
-    invertedModifierLabelmap->ShallowCopy(inverter->GetOutput());
-    vtkNew<vtkMatrix4x4> imageToWorldMatrix;
-    modifierLabelmap->GetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
-    invertedModifierLabelmap->SetGeometryFromImageToWorldMatrix(imageToWorldMatrix.GetPointer());
-    if (!vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(
-      invertedModifierLabelmap.GetPointer(), segmentationNode, selectedSegmentID, vtkSlicerSegmentationsModuleLogic::MODE_MERGE_MIN, extent))
-      {
-      qCritical() << Q_FUNC_INFO << ": Failed to remove modifier labelmap from selected segment";
-      }
-    }
-
-  std::vector<std::string> allSegmentIDs;
-  segmentationNode->GetSegmentation()->GetSegmentIDs(allSegmentIDs);
-  // remove selected segment, that is already handled
-  allSegmentIDs.erase(std::remove(allSegmentIDs.begin(), allSegmentIDs.end(), selectedSegmentID), allSegmentIDs.end());
-
-  std::vector<std::string> visibleSegmentIDs;
-  vtkMRMLSegmentationDisplayNode* displayNode = vtkMRMLSegmentationDisplayNode::SafeDownCast(segmentationNode->GetDisplayNode());
-  if (displayNode)
+  vtkOrientedImageData* masterVolumeOrientedImageData = NULL;
+  if (parameterSetNode->GetMasterVolumeIntensityMask())
     {
-    for (std::vector<std::string>::iterator segmentIDIt = allSegmentIDs.begin(); segmentIDIt != allSegmentIDs.end(); ++segmentIDIt)
+    masterVolumeOrientedImageData = this->masterVolumeImageData();
+    if (!masterVolumeOrientedImageData)
       {
-      if (displayNode->GetSegmentVisibility(*segmentIDIt))
-        {
-        visibleSegmentIDs.push_back(*segmentIDIt);
-        }
+      qCritical() << Q_FUNC_INFO << ": Unable to get master volume image";
+      this->defaultModifierLabelmap();
+      return;
       }
     }
 
-  std::vector<std::string> segmentIDsToOverwrite;
-  switch (this->parameterSetNode()->GetOverwriteMode())
+  // Masking, threshold and overwriting other segments is shared with the GUI-less segment editor logic
+  // so that effects applied from scripts give the same results.
+  if (!vtkSlicerSegmentEditorLogic::ModifySegmentByLabelmap(parameterSetNode, modifierLabelmapInput, modificationMode,
+    modificationExtent, maskImage, masterVolumeOrientedImageData))
     {
-  case vtkMRMLSegmentEditorNode::OverwriteNone:
-    // nothing to overwrite
-    break;
-  case vtkMRMLSegmentEditorNode::OverwriteVisibleSegments:
-    segmentIDsToOverwrite = visibleSegmentIDs;
-    break;
-  case vtkMRMLSegmentEditorNode::OverwriteAllSegments:
-    segmentIDsToOverwrite = allSegmentIDs;
-    break;
-    }
-
-  if (!segmentIDsToOverwrite.empty())
-    {
-    if (modificationMode == qSlicerSegmentEditorAbstractEffect::ModificationModeSet
-      || modificationMode == qSlicerSegmentEditorAbstractEffect::ModificationModeAdd)
-      {
-      inverter->Update();
-      vtkNew<vtkOrientedImageData> invertedModifierLabelmap;
-      invertedModifierLabelmap->ShallowCopy(inverter->GetOutput());
-      vtkNew<vtkMatrix4x4> imageToWorldMatrix;
-      modifierLabelmap->GetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
-      invertedModifierLabelmap->SetGeometryFromImageToWorldMatrix(imageToWorldMatrix.GetPointer());
-      for (std::vector<std::string>::iterator segmentIDIt = segmentIDsToOverwrite.begin(); segmentIDIt != segmentIDsToOverwrite.end(); ++segmentIDIt)
-        {
-        if (!vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(
-          invertedModifierLabelmap.GetPointer(), segmentationNode, *segmentIDIt, vtkSlicerSegmentationsModuleLogic::MODE_MERGE_MIN, extent))
-          {
-          qCritical() << Q_FUNC_INFO << ": Failed to set modifier labelmap to segment " << (segmentIDIt->c_str());
-          }
-        }
-      }
-    else if (modificationMode == qSlicerSegmentEditorAbstractEffect::ModificationModeRemove)
-      {
-      // In general, we don't try to "add back" areas to other segments when an area is removed from the selected segment.
-      // The only exception is when we draw inside one specific segment. In that case erasing adds to the mask segment. It is useful
-      // for splitting a segment into two by painting.
-      if (this->parameterSetNode()->GetMaskMode() == vtkMRMLSegmentEditorNode::PaintAllowedInsideSingleSegment
-        && this->parameterSetNode()->GetMaskSegmentID())
-        {
-        if (!vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(
-          modifierLabelmap, segmentationNode, this->parameterSetNode()->GetMaskSegmentID(), vtkSlicerSegmentationsModuleLogic::MODE_MERGE_MAX, extent))
-          {
-          qCritical() << Q_FUNC_INFO << ": Failed to remove modifier labelmap from segment " << this->parameterSetNode()->GetMaskSegmentID();
-          }
-        }
-      }
+    qCritical() << Q_FUNC_INFO << ": Failed to modify selected segment by labelmap";
     }
 }
 
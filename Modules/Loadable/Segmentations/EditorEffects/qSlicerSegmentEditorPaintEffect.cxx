@@ -45,10 +45,8 @@
 #include <vtkGlyph2D.h>
 #include <vtkGlyph3D.h>
 #include <vtkIdList.h>
-#include <vtkImageChangeInformation.h>
 #include <vtkImageStencil.h>
 #include <vtkImageStencilData.h>
-#include <vtkImageStencilToImage.h>
 #include <vtkMath.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
@@ -72,6 +70,9 @@
 // CTK includes
 #include "ctkDoubleSlider.h"
 
+// STD includes
+#include <algorithm>
+
 // MRML includes
 #include <vtkEventBroker.h>
 #include <vtkMRMLScalarVolumeNode.h>
@@ -91,6 +92,55 @@
 #include "vtkMRMLSliceLayerLogic.h"
 #include "vtkOrientedImageDataResample.h"
 
+//-----------------------------------------------------------------------------
+/// Set the voxels of \a image covered by \a stencilData translated by \a shift
+/// (in IJK) to at least \a fillValue.
+template <class T>
+void PaintStencilRuns(vtkImageStencilData* stencilData, vtkImageData* image,
+                      const int shift[3], double fillValue)
+{
+  int stencilExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  stencilData->GetExtent(stencilExtent);
+  int* imageExtent = image->GetExtent();
+  vtkIdType increments[3] = { 0, 0, 0 };
+  image->GetIncrements(increments);
+  T* imagePtr = static_cast<T*>(image->GetScalarPointer());
+  const T value = static_cast<T>(fillValue);
+  for (int z = stencilExtent[4]; z <= stencilExtent[5]; z++)
+    {
+    int imageZ = z + shift[2];
+    if (imageZ < imageExtent[4] || imageZ > imageExtent[5])
+      {
+      continue;
+      }
+    for (int y = stencilExtent[2]; y <= stencilExtent[3]; y++)
+      {
+      int imageY = y + shift[1];
+      if (imageY < imageExtent[2] || imageY > imageExtent[3])
+        {
+        continue;
+        }
+      T* rowPtr = imagePtr + (imageY - imageExtent[2]) * increments[1]
+        + (imageZ - imageExtent[4]) * increments[2] - imageExtent[0];
+      int r1 = 0;
+      int r2 = 0;
+      int iter = 0;
+      while (stencilData->GetNextExtent(r1, r2, stencilExtent[0], stencilExtent[1], y, z, iter))
+        {
+        int x1 = std::max(r1 + shift[0], imageExtent[0]);
+        int x2 = std::min(r2 + shift[0], imageExtent[1]);
+        for (int x = x1; x <= x2; x++)
+          {
+          if (rowPtr[x] < value)
+            {
+            rowPtr[x] = value;
+            }
+          }
+        }
+      }
+    }
+}
+
 //-----------------------------------------------------------------------------
 /// Visualization objects and pipeline for each slice view for the paint brush
 class BrushPipeline
@@ -375,48 +425,32 @@ void qSlicerSegmentEditorPaintEffectPrivate::paintApply(qMRMLWidget* viewWidget)
     vtkNew<vtkPoints> paintCoordinates_Ijk;
     worldToModifierLabelmapIjkTransform->TransformPoints(this->PaintCoordinates_World, paintCoordinates_Ijk.GetPointer());
 
-    vtkNew<vtkImageStencilToImage> stencilToImage;
-    stencilToImage->SetInputConnection(this->BrushPolyDataToStencil->GetOutputPort());
-    stencilToImage->SetInsideValue(q->m_FillValue);
-    stencilToImage->SetOutsideValue(q->m_EraseValue);
-    stencilToImage->SetOutputScalarType(modifierLabelmap->GetScalarType());
-
-    vtkNew<vtkImageChangeInformation> brushPositioner;
-    brushPositioner->SetInputConnection(stencilToImage->GetOutputPort());
-    brushPositioner->SetOutputSpacing(modifierLabelmap->GetSpacing());
-    brushPositioner->SetOutputOrigin(modifierLabelmap->GetOrigin());
-
+    // Rasterize the brush stencil directly into the modifier labelmap at each
+    // point, only the voxels covered by the brush are visited.
     vtkIdType numberOfPoints = this->PaintCoordinates_World->GetNumberOfPoints();
     int updateExtent[6] = { 0, -1, 0, -1, 0, -1 };
     for (int pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
       {
       double* shiftDouble = paintCoordinates_Ijk->GetPoint(pointIndex);
       int shift[3] = {int(shiftDouble[0]+0.5), int(shiftDouble[1]+0.5), int(shiftDouble[2]+0.5)};
-      brushPositioner->SetExtentTranslation(shift);
-      brushPositioner->Update();
-      vtkNew<vtkOrientedImageData> orientedBrushPositionerOutput;
-      orientedBrushPositionerOutput->ShallowCopy(brushPositioner->GetOutput());
-      orientedBrushPositionerOutput->CopyDirections(modifierLabelmap);
-      if (pointIndex == 0)
-        {
-        orientedBrushPositionerOutput->GetExtent(updateExtent);
-        }
-      else
+      for (int i = 0; i < 3; i++)
         {
-        int* brushExtent = orientedBrushPositionerOutput->GetExtent();
-        for (int i = 0; i < 3; i++)
+        if (pointIndex == 0 || stencilExtent[i * 2] + shift[i] < updateExtent[i * 2])
           {
-          if (brushExtent[i * 2] < updateExtent[i * 2])
-            {
-            updateExtent[i * 2] = brushExtent[i * 2];
-            }
-          if (brushExtent[i * 2 + 1] > updateExtent[i * 2 + 1])
-            {
-            updateExtent[i * 2 + 1] = brushExtent[i * 2 + 1];
-            }
+          updateExtent[i * 2] = stencilExtent[i * 2] + shift[i];
           }
+        if (pointIndex == 0 || stencilExtent[i * 2 + 1] + shift[i] > updateExtent[i * 2 + 1])
+          {
+          updateExtent[i * 2 + 1] = stencilExtent[i * 2 + 1] + shift[i];
+          }
+        }
+      switch (modifierLabelmap->GetScalarType())
+        {
+        vtkTemplateMacro(PaintStencilRuns<VTK_TT>(stencilData, modifierLabelmap, shift, q->m_FillValue));
+        default:
+          qCritical() << Q_FUNC_INFO << ": Unsupported modifier labelmap scalar type";
+          break;
         }
-      vtkOrientedImageDataResample::ModifyImage(modifierLabelmap, orientedBrushPositionerOutput.GetPointer(), vtkOrientedImageDataResample::OPERATION_MAXIMUM);
       }
     modifierLabelmap->Modified();
     for (int i = 0; i < 6; i++)
@@ -1,6 +1,9 @@
 #include "vtkImageGrowCutSegment.h"
 
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <queue>
 #include <vector>
 
 #include <vtkInformation.h>
@@ -12,8 +15,6 @@
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkTimerLog.h>
 
-#include "FibHeap.h"
-
 vtkStandardNewMacro(vtkImageGrowCutSegment);
 
 //----------------------------------------------------------------------------
@@ -23,57 +24,12 @@ const DistancePixelType DIST_INF = std::numeric_limits<DistancePixelType>::max()
 const DistancePixelType DIST_EPSILON = 1e-3;
 
 //----------------------------------------------------------------------------
-class HeapNode : public FibHeapNode
-{
-public:
-  HeapNode()
-  : FibHeapNode()
-  , m_Key(0)
-  , m_Index(-1)
-  {
-  }
-
-  virtual void operator =(FibHeapNode& RHS)
-  {
-    FHN_Assign(RHS);
-    m_Key = ((HeapNode&)RHS).m_Key;
-  }
-
-  virtual int operator ==(FibHeapNode& RHS)
-  {
-    if (FHN_Cmp(RHS))
-      {
-      return 0;
-      }
-    return m_Key == ((HeapNode&)RHS).m_Key ? 1 : 0;
-  }
-
-  virtual int operator <(FibHeapNode& RHS)
-  {
-    int x = FHN_Cmp(RHS);
-    if (x != 0)
-      {
-      return x < 0 ? 1 : 0;
-      }
-    return m_Key < ((HeapNode&)RHS).m_Key ? 1 : 0;
-  }
-
-  virtual void operator =(DistancePixelType newKeyVal)
-  {
-    HeapNode tmp;
-    tmp.m_Key = m_Key = newKeyVal;
-    FHN_Assign(tmp);
-  }
-
-  inline DistancePixelType GetKeyValue() { return m_Key; }
-  inline void SetKeyValue(DistancePixelType keyValue) { m_Key = keyValue; }
-  inline long int GetIndexValue() { return m_Index; }
-  inline void SetIndexValue(long int indexValue) { m_Index = indexValue; }
-
-protected:
-  DistancePixelType m_Key;
-  long m_Index;
-};
+// Distance and voxel index of a voxel waiting for propagation.
+// Only seeds and voxels whose distance decreased are pushed into the queue, and entries that became
+// obsolete (a shorter distance has been found for the voxel since) are skipped when they are popped.
+// This requires much less memory and time than keeping a node for each voxel in a Fibonacci heap.
+typedef std::pair<DistancePixelType, long> DistanceIndexPair;
+typedef std::priority_queue<DistanceIndexPair, std::vector<DistanceIndexPair>, std::greater<DistanceIndexPair> > DistanceQueueType;
 
 //----------------------------------------------------------------------------
 class vtkImageGrowCutSegment::vtkInternal
@@ -107,16 +63,13 @@ public:
   std::vector<long> m_NeighborIndexOffsets;
   std::vector<unsigned char> m_NumberOfNeighbors;
 
-  FibHeap *m_Heap;
-  HeapNode *m_HeapNodes;
+  DistanceQueueType m_Heap;
   bool m_bSegInitialized;
 };
 
 //-----------------------------------------------------------------------------
 vtkImageGrowCutSegment::vtkInternal::vtkInternal()
 {
-  m_Heap = NULL;
-  m_HeapNodes = NULL;
   m_bSegInitialized = false;
   m_DistanceVolume = vtkSmartPointer<vtkImageData>::New();
   m_DistanceVolumePre = vtkSmartPointer<vtkImageData>::New();
@@ -133,16 +86,7 @@ vtkImageGrowCutSegment::vtkInternal::~vtkInternal()
 //-----------------------------------------------------------------------------
 void vtkImageGrowCutSegment::vtkInternal::Reset()
 {
-  if (m_Heap != NULL)
-    {
-    delete m_Heap;
-    m_Heap = NULL;
-    }
-  if (m_HeapNodes != NULL)
-    {
-    delete[]m_HeapNodes;
-    m_HeapNodes = NULL;
-    }
+  m_Heap = DistanceQueueType();
   m_bSegInitialized = false;
   m_DistanceVolume->Initialize();
   m_DistanceVolumePre->Initialize();
@@ -156,13 +100,8 @@ bool vtkImageGrowCutSegment::vtkInternal::InitializationAHP(
     vtkImageData *vtkNotUsed(intensityVolume),
     vtkImageData *seedLabelVolume)
 {
-  m_Heap = new FibHeap;
+  m_Heap = DistanceQueueType();
   long dimXYZ = m_DimX * m_DimY * m_DimZ;
-  if ((m_HeapNodes = new HeapNode[dimXYZ + 1]) == NULL)
-    {
-    vtkGenericWarningMacro("Memory allocation failed. Dimensions: " << m_DimX << "x" << m_DimY << "x" << m_DimZ);
-    return false;
-    }
   LabelPixelType* seedLabelVolumePtr = static_cast<LabelPixelType*>(seedLabelVolume->GetScalarPointer());
 
   if (!m_bSegInitialized)
@@ -233,16 +172,13 @@ bool vtkImageGrowCutSegment::vtkInternal::InitializationAHP(
       resultLabelVolumePtr[index] = seedValue;
       if (seedValue == 0)
         {
-        m_HeapNodes[index] = DIST_INF;
         distanceVolumePtr[index] = DIST_INF;
         }
       else
         {
-        m_HeapNodes[index] = DIST_EPSILON;
         distanceVolumePtr[index] = DIST_EPSILON;
+        m_Heap.push(DistanceIndexPair(DIST_EPSILON, index));
         }
-      m_Heap->Insert(&m_HeapNodes[index]);
-      m_HeapNodes[index].SetIndexValue(index);
       }
     }
   else
@@ -258,20 +194,15 @@ bool vtkImageGrowCutSegment::vtkInternal::InitializationAHP(
         // Only grow from new/changed seeds
         if (resultLabelVolumePtr[index] != seedLabelVolumePtr[index])
           {
-          m_HeapNodes[index] = DIST_EPSILON;
           distanceVolumePtr[index] = DIST_EPSILON;
           resultLabelVolumePtr[index] = seedLabelVolumePtr[index];
-          m_Heap->Insert(&m_HeapNodes[index]);
-          m_HeapNodes[index].SetIndexValue(index);
+          m_Heap.push(DistanceIndexPair(DIST_EPSILON, index));
           }
         }
       else
         {
-        m_HeapNodes[index] = DIST_INF;
         distanceVolumePtr[index] = DIST_INF;
         resultLabelVolumePtr[index] = 0;
-        m_Heap->Insert(&m_HeapNodes[index]);
-        m_HeapNodes[index].SetIndexValue(index);
         }
       }
     }
@@ -287,26 +218,24 @@ void vtkImageGrowCutSegment::vtkInternal::DijkstraBasedClassificationAHP(
   LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
   IntensityPixelType* imSrc = static_cast<IntensityPixelType*>(intensityVolume->GetScalarPointer());
 
-  // Insert 0 then extract it, which will balance heap
-  HeapNode hnZero;
-  m_Heap->Insert(&hnZero);
-  m_Heap->ExtractMin();
+  DistancePixelType* distanceVolumePtr = static_cast<DistancePixelType*>(m_DistanceVolume->GetScalarPointer());
 
   if (!m_bSegInitialized)
     {
     // Full computation
-    DistancePixelType* distanceVolumePtr = static_cast<DistancePixelType*>(m_DistanceVolume->GetScalarPointer());
-    LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
 
     // Normal Dijkstra (to be used in initializing the segmenter for the current image)
-    HeapNode hnTmp;
-    while (!m_Heap->IsEmpty())
+    while (!m_Heap.empty())
       {
-      HeapNode* hnMin = (HeapNode *)m_Heap->ExtractMin();
-      long index = hnMin->GetIndexValue();
-      DistancePixelType currentDistance = hnMin->GetKeyValue();
+      DistancePixelType currentDistance = m_Heap.top().first;
+      long index = m_Heap.top().second;
+      m_Heap.pop();
+      if (currentDistance > distanceVolumePtr[index])
+        {
+        // obsolete entry, the voxel has been reached on a shorter path since it was queued
+        continue;
+        }
       LabelPixelType currentLabel = resultLabelVolumePtr[index];
-      distanceVolumePtr[index] = currentDistance;
 
       // Update neighbors
       DistancePixelType pixCenter = imSrc[index];
@@ -320,10 +249,7 @@ void vtkImageGrowCutSegment::vtkInternal::DijkstraBasedClassificationAHP(
           {
           distanceVolumePtr[indexNgbh] = neighborNewDistance;
           resultLabelVolumePtr[indexNgbh] = currentLabel;
-
-          hnTmp = m_HeapNodes[indexNgbh];
-          hnTmp.SetKeyValue(neighborNewDistance);
-          m_Heap->DecreaseKey(&m_HeapNodes[indexNgbh], hnTmp);
+          m_Heap.push(DistanceIndexPair(neighborNewDistance, indexNgbh));
           }
         }
       }
@@ -333,34 +259,22 @@ void vtkImageGrowCutSegment::vtkInternal::DijkstraBasedClassificationAHP(
     // Quick update
 
     LabelPixelType* resultLabelVolumePrePtr = static_cast<LabelPixelType*>(m_ResultLabelVolumePre->GetScalarPointer());
+    DistancePixelType* distanceVolumePrePtr = static_cast<DistancePixelType*>(m_DistanceVolumePre->GetScalarPointer());
 
     // Adaptive Dijkstra
-    HeapNode hnTmp;
     long dimXYZ = m_DimX * m_DimY * m_DimZ;
-    while (!m_Heap->IsEmpty())
+    while (!m_Heap.empty())
       {
-      DistancePixelType* distanceVolumePrePtr = static_cast<DistancePixelType*>(m_DistanceVolumePre->GetScalarPointer());
-      DistancePixelType* distanceVolumePtr = static_cast<DistancePixelType*>(m_DistanceVolume->GetScalarPointer());
-
-      HeapNode* hnMin = (HeapNode *)m_Heap->ExtractMin();
-      DistancePixelType currentDistance = hnMin->GetKeyValue();
-
-      // Stop of minimum value is infinite
-      if (currentDistance == DIST_INF)
+      DistancePixelType currentDistance = m_Heap.top().first;
+      long index = m_Heap.top().second;
+      m_Heap.pop();
+      if (currentDistance > distanceVolumePtr[index])
         {
-        for (long index = 0; index < dimXYZ; index++)
-          {
-          if (resultLabelVolumePtr[index] == 0)
-            {
-            resultLabelVolumePtr[index] = resultLabelVolumePrePtr[index];
-            distanceVolumePtr[index] = distanceVolumePrePtr[index];
-            }
-          }
-        break;
+        // obsolete entry, the voxel has been reached on a shorter path since it was queued
+        continue;
         }
 
       // Stop propagation when the new distance is larger than the previous one
-      long index = hnMin->GetIndexValue();
       if (currentDistance > distanceVolumePrePtr[index])
         {
         distanceVolumePtr[index] = distanceVolumePrePtr[index];
@@ -369,7 +283,6 @@ void vtkImageGrowCutSegment::vtkInternal::DijkstraBasedClassificationAHP(
         }
 
       LabelPixelType currentLabel = resultLabelVolumePtr[index];
-      distanceVolumePtr[index] = currentDistance;
 
       // Update neighbors
       DistancePixelType pixCenter = imSrc[index];
@@ -383,13 +296,20 @@ void vtkImageGrowCutSegment::vtkInternal::DijkstraBasedClassificationAHP(
           {
           distanceVolumePtr[indexNgbh] = neighborNewDistance;
           resultLabelVolumePtr[indexNgbh] = currentLabel;
-
-          hnTmp = m_HeapNodes[indexNgbh];
-          hnTmp.SetKeyValue(neighborNewDistance);
-          m_Heap->DecreaseKey(&m_HeapNodes[indexNgbh], hnTmp);
+          m_Heap.push(DistanceIndexPair(neighborNewDistance, indexNgbh));
           }
         }
       }
+
+    // Voxels that have not been reached from the new seeds keep their previous label and distance
+    for (long index = 0; index < dimXYZ; index++)
+      {
+      if (resultLabelVolumePtr[index] == 0)
+        {
+        resultLabelVolumePtr[index] = resultLabelVolumePrePtr[index];
+        distanceVolumePtr[index] = distanceVolumePrePtr[index];
+        }
+      }
     }
 
   // Update previous labels and distance information
@@ -398,17 +318,7 @@ void vtkImageGrowCutSegment::vtkInternal::DijkstraBasedClassificationAHP(
   m_bSegInitialized = true;
 
   // Release memory
-  if (m_Heap != NULL)
-    {
-    delete m_Heap;
-    m_Heap = NULL;
-    }
-  //m_HeapNodes.clear();
-  if (m_HeapNodes != NULL)
-    {
-    delete[] m_HeapNodes;
-    m_HeapNodes = NULL;
-    }
+  m_Heap = DistanceQueueType();
 }
 
 //-----------------------------------------------------------------------------
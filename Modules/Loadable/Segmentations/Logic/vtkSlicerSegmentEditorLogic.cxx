@@ -0,0 +1,1152 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Segmentations includes
+#include "vtkSlicerSegmentEditorLogic.h"
+#include "vtkSlicerSegmentationsModuleLogic.h"
+#include "vtkMRMLSegmentEditorNode.h"
+
+// SegmentationCore includes
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+
+// MRML includes
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLSegmentationDisplayNode.h>
+#include <vtkMRMLSegmentationNode.h>
+#include <vtkMRMLTransformNode.h>
+
+// vtkITK includes
+#include <vtkITKDistanceTransform.h>
+#include <vtkITKIslandMath.h>
+
+// VTK includes
+#include <vtkDiscreteMarchingCubes.h>
+#include <vtkGeneralTransform.h>
+#include <vtkGeometryFilter.h>
+#include <vtkImageCast.h>
+#include <vtkImageChangeInformation.h>
+#include <vtkImageConstantPad.h>
+#include <vtkImageGaussianSmooth.h>
+#include <vtkImageMask.h>
+#include <vtkImageMedian3D.h>
+#include <vtkImageOpenClose3D.h>
+#include <vtkImageStencil.h>
+#include <vtkImageThreshold.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPolyDataToImageStencil.h>
+#include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+#include <vtkThreshold.h>
+#include <vtkWindowedSincPolyDataFilter.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+const double FILL_VALUE = 1.0;
+const double ERASE_VALUE = 0.0;
+
+//----------------------------------------------------------------------------
+// Same as qSlicerSegmentEditorAbstractEffect::applyImageMask
+bool ApplyImageMask(vtkOrientedImageData* input, vtkOrientedImageData* mask, double fillValue, bool notMask)
+{
+  if (!input || !mask)
+    {
+    vtkGenericWarningMacro("ApplyImageMask failed: Invalid inputs");
+    return false;
+    }
+  // Make sure mask has the same lattice as the input labelmap
+  if (!vtkOrientedImageDataResample::DoGeometriesMatch(input, mask))
+    {
+    vtkGenericWarningMacro("ApplyImageMask failed: input and mask image geometry mismatch");
+    return false;
+    }
+
+  // Make sure mask has the same extent as the input labelmap
+  vtkSmartPointer<vtkImageConstantPad> padder = vtkSmartPointer<vtkImageConstantPad>::New();
+  padder->SetInputData(mask);
+  padder->SetOutputWholeExtent(input->GetExtent());
+
+  vtkSmartPointer<vtkImageMask> masker = vtkSmartPointer<vtkImageMask>::New();
+  masker->SetImageInputData(input);
+  masker->SetMaskInputConnection(padder->GetOutputPort());
+  masker->SetNotMask(notMask);
+  masker->SetMaskedOutputValue(fillValue);
+  masker->Update();
+
+  vtkSmartPointer<vtkMatrix4x4> inputImageToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+  input->GetImageToWorldMatrix(inputImageToWorldMatrix);
+  input->DeepCopy(masker->GetOutput());
+  input->SetGeometryFromImageToWorldMatrix(inputImageToWorldMatrix);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void GetVisibleSegmentIDs(vtkMRMLSegmentationNode* segmentationNode, const std::vector<std::string>& segmentIDs,
+  std::vector<std::string>& visibleSegmentIDs)
+{
+  visibleSegmentIDs.clear();
+  vtkMRMLSegmentationDisplayNode* displayNode = vtkMRMLSegmentationDisplayNode::SafeDownCast(segmentationNode->GetDisplayNode());
+  if (!displayNode)
+    {
+    return;
+    }
+  for (std::vector<std::string>::const_iterator segmentIDIt = segmentIDs.begin(); segmentIDIt != segmentIDs.end(); ++segmentIDIt)
+    {
+    if (displayNode->GetSegmentVisibility(*segmentIDIt))
+      {
+      visibleSegmentIDs.push_back(*segmentIDIt);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Same as qMRMLSegmentEditorWidgetPrivate::getReferenceImageGeometryFromSegmentation
+std::string GetReferenceImageGeometryFromSegmentation(vtkSegmentation* segmentation)
+{
+  // If "reference image geometry" conversion parameter is set then use that
+  std::string referenceImageGeometry = segmentation->GetConversionParameter(vtkSegmentationConverter::GetReferenceImageGeometryParameterName());
+  if (!referenceImageGeometry.empty())
+    {
+    // Extend reference image geometry to contain all segments
+    vtkSmartPointer<vtkOrientedImageData> commonGeometryImage = vtkSmartPointer<vtkOrientedImageData>::New();
+    vtkSegmentationConverter::DeserializeImageGeometry(referenceImageGeometry, commonGeometryImage, false);
+    int commonSegmentExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    segmentation->DetermineCommonLabelmapExtent(commonSegmentExtent, commonGeometryImage);
+    if (commonSegmentExtent[0] <= commonSegmentExtent[1]
+      && commonSegmentExtent[2] <= commonSegmentExtent[3]
+      && commonSegmentExtent[4] <= commonSegmentExtent[5])
+      {
+      int commonGeometryExtent[6] = { 0, -1, 0, -1, 0, -1 };
+      commonGeometryImage->GetExtent(commonGeometryExtent);
+      for (int i = 0; i < 3; i++)
+        {
+        commonGeometryExtent[i * 2] = std::min(commonSegmentExtent[i * 2], commonGeometryExtent[i * 2]);
+        commonGeometryExtent[i * 2 + 1] = std::max(commonSegmentExtent[i * 2 + 1], commonGeometryExtent[i * 2 + 1]);
+        }
+      commonGeometryImage->SetExtent(commonGeometryExtent);
+      referenceImageGeometry = vtkSegmentationConverter::SerializeImageGeometry(commonGeometryImage);
+      }
+    return referenceImageGeometry;
+    }
+  if (segmentation->ContainsRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()))
+    {
+    // If no reference image geometry is specified but there are labels already then determine geometry from that
+    return segmentation->DetermineCommonLabelmapGeometry();
+    }
+  return "";
+}
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerSegmentEditorLogic);
+
+//----------------------------------------------------------------------------
+vtkCxxSetObjectMacro(vtkSlicerSegmentEditorLogic, SegmentEditorNode, vtkMRMLSegmentEditorNode);
+
+//----------------------------------------------------------------------------
+vtkSlicerSegmentEditorLogic::vtkSlicerSegmentEditorLogic()
+{
+  this->SegmentEditorNode = NULL;
+}
+
+//----------------------------------------------------------------------------
+vtkSlicerSegmentEditorLogic::~vtkSlicerSegmentEditorLogic()
+{
+  this->SetSegmentEditorNode(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerSegmentEditorLogic::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "SegmentEditorNode: " << this->SegmentEditorNode << "\n";
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSlicerSegmentEditorLogic::GetParameter(const std::string& effectName, const std::string& parameterName, const std::string& defaultValue/*=""*/)
+{
+  if (!this->SegmentEditorNode)
+    {
+    return defaultValue;
+    }
+  // Get effect-specific prefixed parameter first
+  std::string attributeName = effectName + "." + parameterName;
+  const char* value = this->SegmentEditorNode->GetAttribute(attributeName.c_str());
+  // Look for common parameter if effect-specific one is not found
+  if (!value || !value[0])
+    {
+    value = this->SegmentEditorNode->GetAttribute(parameterName.c_str());
+    }
+  if (!value || !value[0])
+    {
+    return defaultValue;
+    }
+  return value;
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerSegmentEditorLogic::GetDoubleParameter(const std::string& effectName, const std::string& parameterName, double defaultValue/*=0.0*/)
+{
+  std::string value = this->GetParameter(effectName, parameterName);
+  if (value.empty())
+    {
+    return defaultValue;
+    }
+  char* end = NULL;
+  double parameterDouble = strtod(value.c_str(), &end);
+  if (end == value.c_str())
+    {
+    vtkErrorMacro("GetDoubleParameter: Parameter named " << parameterName << " cannot be converted to floating point number");
+    return defaultValue;
+    }
+  return parameterDouble;
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerSegmentEditorLogic::GetIntegerParameter(const std::string& effectName, const std::string& parameterName, int defaultValue/*=0*/)
+{
+  std::string value = this->GetParameter(effectName, parameterName);
+  if (value.empty())
+    {
+    return defaultValue;
+    }
+  char* end = NULL;
+  long parameterInt = strtol(value.c_str(), &end, 10);
+  if (end == value.c_str())
+    {
+    vtkErrorMacro("GetIntegerParameter: Parameter named " << parameterName << " cannot be converted to integer");
+    return defaultValue;
+    }
+  return static_cast<int>(parameterInt);
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSlicerSegmentEditorLogic::GetReferenceImageGeometry()
+{
+  vtkMRMLSegmentationNode* segmentationNode = this->SegmentEditorNode ? this->SegmentEditorNode->GetSegmentationNode() : NULL;
+  if (!segmentationNode || !segmentationNode->GetSegmentation())
+    {
+    vtkErrorMacro("GetReferenceImageGeometry: Invalid segmentation");
+    return "";
+    }
+  std::string referenceImageGeometry = GetReferenceImageGeometryFromSegmentation(segmentationNode->GetSegmentation());
+  if (referenceImageGeometry.empty())
+    {
+    // If no reference image geometry could be determined then use the master volume's geometry
+    vtkMRMLScalarVolumeNode* masterVolumeNode = this->SegmentEditorNode->GetMasterVolumeNode();
+    if (!masterVolumeNode)
+      {
+      return "";
+      }
+    segmentationNode->SetReferenceImageGeometryParameterFromVolumeNode(masterVolumeNode);
+    referenceImageGeometry = GetReferenceImageGeometryFromSegmentation(segmentationNode->GetSegmentation());
+    }
+  return referenceImageGeometry;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerSegmentEditorLogic::GetDefaultModifierLabelmap(vtkOrientedImageData* modifierLabelmap)
+{
+  std::string referenceImageGeometry = this->GetReferenceImageGeometry();
+  if (!modifierLabelmap || referenceImageGeometry.empty())
+    {
+    vtkErrorMacro("GetDefaultModifierLabelmap: Cannot determine default modifier labelmap geometry");
+    return false;
+    }
+  vtkSegmentationConverter::DeserializeImageGeometry(referenceImageGeometry, modifierLabelmap, true, VTK_UNSIGNED_CHAR, 1);
+  vtkOrientedImageDataResample::FillImage(modifierLabelmap, ERASE_VALUE);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerSegmentEditorLogic::GetSelectedSegmentLabelmap(vtkOrientedImageData* selectedSegmentLabelmap)
+{
+  if (!this->SegmentEditorNode || !selectedSegmentLabelmap)
+    {
+    vtkErrorMacro("GetSelectedSegmentLabelmap: Invalid segment editor node or output image");
+    return false;
+    }
+  vtkMRMLSegmentationNode* segmentationNode = this->SegmentEditorNode->GetSegmentationNode();
+  const char* selectedSegmentID = this->SegmentEditorNode->GetSelectedSegmentID();
+  std::string referenceImageGeometry = this->GetReferenceImageGeometry();
+  if (!segmentationNode || !selectedSegmentID || referenceImageGeometry.empty())
+    {
+    vtkErrorMacro("GetSelectedSegmentLabelmap: Invalid segment selection");
+    return false;
+    }
+  vtkSegment* selectedSegment = segmentationNode->GetSegmentation()->GetSegment(selectedSegmentID);
+  if (!selectedSegment)
+    {
+    vtkErrorMacro("GetSelectedSegmentLabelmap: Segment " << selectedSegmentID << " not found in segmentation");
+    return false;
+    }
+  vtkOrientedImageData* segmentLabelmap = vtkOrientedImageData::SafeDownCast(
+    selectedSegment->GetRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
+  if (!segmentLabelmap)
+    {
+    vtkErrorMacro("GetSelectedSegmentLabelmap: Failed to get binary labelmap representation in segmentation " << segmentationNode->GetName());
+    return false;
+    }
+  int* extent = segmentLabelmap->GetExtent();
+  if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+    {
+    vtkSegmentationConverter::DeserializeImageGeometry(referenceImageGeometry, selectedSegmentLabelmap, false);
+    selectedSegmentLabelmap->SetExtent(0, -1, 0, -1, 0, -1);
+    selectedSegmentLabelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+    return true;
+    }
+  vtkNew<vtkOrientedImageData> referenceImage;
+  vtkSegmentationConverter::DeserializeImageGeometry(referenceImageGeometry, referenceImage.GetPointer(), false);
+  return vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(segmentLabelmap, referenceImage.GetPointer(),
+    selectedSegmentLabelmap, /*linearInterpolation=*/false);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerSegmentEditorLogic::GetAlignedMasterVolume(vtkOrientedImageData* alignedMasterVolume)
+{
+  if (!this->SegmentEditorNode || !alignedMasterVolume)
+    {
+    vtkErrorMacro("GetAlignedMasterVolume: Invalid segment editor node or output image");
+    return false;
+    }
+  vtkMRMLSegmentationNode* segmentationNode = this->SegmentEditorNode->GetSegmentationNode();
+  vtkMRMLScalarVolumeNode* masterVolumeNode = this->SegmentEditorNode->GetMasterVolumeNode();
+  std::string referenceImageGeometry = this->GetReferenceImageGeometry();
+  if (!segmentationNode || !masterVolumeNode || !masterVolumeNode->GetImageData() || referenceImageGeometry.empty())
+    {
+    vtkErrorMacro("GetAlignedMasterVolume: Invalid segmentation or master volume");
+    return false;
+    }
+
+  vtkNew<vtkOrientedImageData> referenceImage;
+  vtkSegmentationConverter::DeserializeImageGeometry(referenceImageGeometry, referenceImage.GetPointer(), false);
+
+  // Get a read-only version of master volume as a vtkOrientedImageData
+  vtkNew<vtkOrientedImageData> masterVolume;
+  masterVolume->vtkImageData::ShallowCopy(masterVolumeNode->GetImageData());
+  vtkNew<vtkMatrix4x4> ijkToRasMatrix;
+  masterVolumeNode->GetIJKToRASMatrix(ijkToRasMatrix.GetPointer());
+  masterVolume->SetGeometryFromImageToWorldMatrix(ijkToRasMatrix.GetPointer());
+
+  vtkNew<vtkGeneralTransform> masterVolumeToSegmentationTransform;
+  vtkMRMLTransformNode::GetTransformBetweenNodes(masterVolumeNode->GetParentTransformNode(),
+    segmentationNode->GetParentTransformNode(), masterVolumeToSegmentationTransform.GetPointer());
+
+  return vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(masterVolume.GetPointer(), referenceImage.GetPointer(),
+    alignedMasterVolume, /*linearInterpolation=*/true, /*padImage=*/false, masterVolumeToSegmentationTransform.GetPointer());
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerSegmentEditorLogic::GetMaskLabelmap(vtkOrientedImageData* maskLabelmap)
+{
+  if (!this->SegmentEditorNode || !maskLabelmap)
+    {
+    vtkErrorMacro("GetMaskLabelmap: Invalid segment editor node or output image");
+    return false;
+    }
+  vtkMRMLSegmentationNode* segmentationNode = this->SegmentEditorNode->GetSegmentationNode();
+  if (!segmentationNode || !this->SegmentEditorNode->GetSelectedSegmentID())
+    {
+    vtkErrorMacro("GetMaskLabelmap: Invalid segment selection");
+    return false;
+    }
+  vtkNew<vtkOrientedImageData> referenceImage;
+  if (!this->GetDefaultModifierLabelmap(referenceImage.GetPointer()))
+    {
+    return false;
+    }
+
+  std::vector<std::string> allSegmentIDs;
+  segmentationNode->GetSegmentation()->GetSegmentIDs(allSegmentIDs);
+  std::vector<std::string> visibleSegmentIDs;
+  GetVisibleSegmentIDs(segmentationNode, allSegmentIDs, visibleSegmentIDs);
+
+  std::string editedSegmentID(this->SegmentEditorNode->GetSelectedSegmentID());
+
+  std::vector<std::string> maskSegmentIDs;
+  bool paintInsideSegments = false;
+  switch (this->SegmentEditorNode->GetMaskMode())
+    {
+  case vtkMRMLSegmentEditorNode::PaintAllowedEverywhere:
+    paintInsideSegments = false;
+    break;
+  case vtkMRMLSegmentEditorNode::PaintAllowedInsideAllSegments:
+    paintInsideSegments = true;
+    maskSegmentIDs = allSegmentIDs;
+    break;
+  case vtkMRMLSegmentEditorNode::PaintAllowedInsideVisibleSegments:
+    paintInsideSegments = true;
+    maskSegmentIDs = visibleSegmentIDs;
+    break;
+  case vtkMRMLSegmentEditorNode::PaintAllowedOutsideAllSegments:
+    paintInsideSegments = false;
+    maskSegmentIDs = allSegmentIDs;
+    break;
+  case vtkMRMLSegmentEditorNode::PaintAllowedOutsideVisibleSegments:
+    paintInsideSegments = false;
+    maskSegmentIDs = visibleSegmentIDs;
+    break;
+  case vtkMRMLSegmentEditorNode::PaintAllowedInsideSingleSegment:
+    paintInsideSegments = true;
+    if (this->SegmentEditorNode->GetMaskSegmentID())
+      {
+      maskSegmentIDs.push_back(this->SegmentEditorNode->GetMaskSegmentID());
+      }
+    else
+      {
+      vtkWarningMacro("GetMaskLabelmap: PaintAllowedInsideSingleSegment selected but no mask segment is specified");
+      }
+    break;
+  default:
+    vtkWarningMacro("GetMaskLabelmap: unknown mask mode");
+    }
+
+  // Always allow paint inside edited segment
+  if (paintInsideSegments)
+    {
+    if (std::find(maskSegmentIDs.begin(), maskSegmentIDs.end(), editedSegmentID) == maskSegmentIDs.end())
+      {
+      maskSegmentIDs.push_back(editedSegmentID);
+      }
+    }
+  else
+    {
+    maskSegmentIDs.erase(std::remove(maskSegmentIDs.begin(), maskSegmentIDs.end(), editedSegmentID), maskSegmentIDs.end());
+    }
+
+  vtkNew<vtkOrientedImageData> mergedImage;
+  mergedImage->SetExtent(referenceImage->GetExtent());
+  mergedImage->AllocateScalars(VTK_SHORT, 1);
+  segmentationNode->GenerateMergedLabelmap(mergedImage.GetPointer(), vtkSegmentation::EXTENT_UNION_OF_SEGMENTS,
+    referenceImage.GetPointer(), maskSegmentIDs);
+  vtkNew<vtkMatrix4x4> mergedImageToWorldMatrix;
+  mergedImage->GetImageToWorldMatrix(mergedImageToWorldMatrix.GetPointer());
+
+  vtkSmartPointer<vtkImageThreshold> threshold = vtkSmartPointer<vtkImageThreshold>::New();
+  threshold->SetInputData(mergedImage.GetPointer());
+  threshold->SetInValue(paintInsideSegments ? 1 : 0);
+  threshold->SetOutValue(paintInsideSegments ? 0 : 1);
+  threshold->ReplaceInOn();
+  threshold->ThresholdByLower(0);
+  threshold->SetOutputScalarType(VTK_UNSIGNED_CHAR);
+  threshold->Update();
+
+  maskLabelmap->DeepCopy(threshold->GetOutput());
+  maskLabelmap->SetImageToWorldMatrix(mergedImageToWorldMatrix.GetPointer());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerSegmentEditorLogic::ModifySelectedSegmentByLabelmap(vtkOrientedImageData* modifierLabelmap, int modificationMode,
+  const int modificationExtent[6]/*=0*/)
+{
+  if (!this->SegmentEditorNode)
+    {
+    vtkErrorMacro("ModifySelectedSegmentByLabelmap: Invalid segment editor node");
+    return false;
+    }
+  vtkSmartPointer<vtkOrientedImageData> maskLabelmap;
+  if (this->SegmentEditorNode->GetMaskMode() != vtkMRMLSegmentEditorNode::PaintAllowedEverywhere)
+    {
+    maskLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+    if (!this->GetMaskLabelmap(maskLabelmap))
+      {
+      return false;
+      }
+    }
+  vtkSmartPointer<vtkOrientedImageData> alignedMasterVolume;
+  if (this->SegmentEditorNode->GetMasterVolumeIntensityMask())
+    {
+    alignedMasterVolume = vtkSmartPointer<vtkOrientedImageData>::New();
+    if (!this->GetAlignedMasterVolume(alignedMasterVolume))
+      {
+      return false;
+      }
+    }
+  int invalidExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  return vtkSlicerSegmentEditorLogic::ModifySegmentByLabelmap(this->SegmentEditorNode, modifierLabelmap, modificationMode,
+    modificationExtent ? modificationExtent : invalidExtent, maskLabelmap, alignedMasterVolume);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerSegmentEditorLogic::ModifySegmentByLabelmap(vtkMRMLSegmentEditorNode* segmentEditorNode,
+  vtkOrientedImageData* modifierLabelmapInput, int modificationMode, const int modificationExtent[6],
+  vtkOrientedImageData* maskLabelmap, vtkOrientedImageData* alignedMasterVolume)
+{
+  if (!segmentEditorNode || !modifierLabelmapInput)
+    {
+    vtkGenericWarningMacro("vtkSlicerSegmentEditorLogic::ModifySegmentByLabelmap failed: Invalid segment editor node or modifier labelmap");
+    return false;
+    }
+  vtkMRMLSegmentationNode* segmentationNode = segmentEditorNode->GetSegmentationNode();
+  const char* selectedSegmentIDChars = segmentEditorNode->GetSelectedSegmentID();
+  if (!segmentationNode || !selectedSegmentIDChars)
+    {
+    vtkGenericWarningMacro("vtkSlicerSegmentEditorLogic::ModifySegmentByLabelmap failed: Invalid segment selection");
+    return false;
+    }
+  std::string selectedSegmentID(selectedSegmentIDChars);
+
+  vtkSmartPointer<vtkOrientedImageData> modifierLabelmap = modifierLabelmapInput;
+
+  // Apply mask to modifier labelmap if paint over is turned off
+  if (segmentEditorNode->GetMaskMode() != vtkMRMLSegmentEditorNode::PaintAllowedEverywhere)
+    {
+    // make a copy to not modify the input
+    vtkNew<vtkOrientedImageData> maskedModifierLabelmap;
+    maskedModifierLabelmap->DeepCopy(modifierLabelmap);
+    modifierLabelmap = maskedModifierLabelmap.GetPointer();
+    if (!ApplyImageMask(modifierLabelmap, maskLabelmap, ERASE_VALUE, true))
+      {
+      return false;
+      }
+    }
+
+  // Apply threshold mask if paint threshold is turned on
+  if (segmentEditorNode->GetMasterVolumeIntensityMask())
+    {
+    if (!alignedMasterVolume)
+      {
+      vtkGenericWarningMacro("vtkSlicerSegmentEditorLogic::ModifySegmentByLabelmap failed: Unable to get master volume image");
+      return false;
+      }
+    // Make sure the modifier labelmap has the same geometry as the master volume
+    if (!vtkOrientedImageDataResample::DoGeometriesMatch(modifierLabelmap, alignedMasterVolume))
+      {
+      vtkGenericWarningMacro("vtkSlicerSegmentEditorLogic::ModifySegmentByLabelmap failed: Modifier labelmap should have the same geometry as the master volume");
+      return false;
+      }
+
+    vtkSmartPointer<vtkImageThreshold> threshold = vtkSmartPointer<vtkImageThreshold>::New();
+    threshold->SetInputData(alignedMasterVolume);
+    threshold->ThresholdBetween(segmentEditorNode->GetMasterVolumeIntensityMaskRange()[0], segmentEditorNode->GetMasterVolumeIntensityMaskRange()[1]);
+    threshold->SetInValue(1);
+    threshold->SetOutValue(0);
+    threshold->SetOutputScalarType(modifierLabelmap->GetScalarType());
+    threshold->Update();
+
+    vtkSmartPointer<vtkOrientedImageData> thresholdMask = vtkSmartPointer<vtkOrientedImageData>::New();
+    thresholdMask->DeepCopy(threshold->GetOutput());
+    vtkSmartPointer<vtkMatrix4x4> modifierLabelmapToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+    modifierLabelmap->GetImageToWorldMatrix(modifierLabelmapToWorldMatrix);
+    thresholdMask->SetGeometryFromImageToWorldMatrix(modifierLabelmapToWorldMatrix);
+
+    if (modifierLabelmap.GetPointer() == modifierLabelmapInput)
+      {
+      // make a copy to not modify the input
+      vtkNew<vtkOrientedImageData> maskedModifierLabelmap;
+      maskedModifierLabelmap->DeepCopy(modifierLabelmap);
+      modifierLabelmap = maskedModifierLabelmap.GetPointer();
+      }
+    if (!ApplyImageMask(modifierLabelmap, thresholdMask, ERASE_VALUE, false))
+      {
+      return false;
+      }
+    }
+
+  // Mask and threshold was already applied on modifier labelmap at this point if requested.
+  const int* extent = modificationExtent;
+  if (!extent || extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+    {
+    // invalid extent, it means we have to work with the entire modifier labelmap
+    extent = NULL;
+    }
+
+  // Inverted binary labelmap
+  vtkSmartPointer<vtkImageThreshold> inverter = vtkSmartPointer<vtkImageThreshold>::New();
+  inverter->SetInputData(modifierLabelmap);
+  inverter->SetInValue(FILL_VALUE);
+  inverter->SetOutValue(ERASE_VALUE);
+  inverter->ReplaceInOn();
+  inverter->ThresholdByLower(0);
+  inverter->SetOutputScalarType(VTK_UNSIGNED_CHAR);
+  vtkNew<vtkOrientedImageData> invertedModifierLabelmap;
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  modifierLabelmap->GetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+
+  bool success = true;
+  if (modificationMode == ModificationModeSet)
+    {
+    if (!vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(
+      modifierLabelmap, segmentationNode, selectedSegmentID, vtkSlicerSegmentationsModuleLogic::MODE_REPLACE, extent))
+      {
+      vtkGenericWarningMacro("vtkSlicerSegmentEditorLogic::ModifySegmentByLabelmap: Failed to set modifier labelmap to selected segment");
+      success = false;
+      }
+    }
+  else if (modificationMode == ModificationModeAdd)
+    {
+    if (!vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(
+      modifierLabelmap, segmentationNode, selectedSegmentID, vtkSlicerSegmentationsModuleLogic::MODE_MERGE_MAX, extent))
+      {
+      vtkGenericWarningMacro("vtkSlicerSegmentEditorLogic::ModifySegmentByLabelmap: Failed to add modifier labelmap to selected segment");
+      success = false;
+      }
+    }
+  else if (modificationMode == ModificationModeRemove)
+    {
+    inverter->Update();
+    invertedModifierLabelmap->ShallowCopy(inverter->GetOutput());
+    invertedModifierLabelmap->SetGeometryFromImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+    if (!vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(
+      invertedModifierLabelmap.GetPointer(), segmentationNode, selectedSegmentID, vtkSlicerSegmentationsModuleLogic::MODE_MERGE_MIN, extent))
+      {
+      vtkGenericWarningMacro("vtkSlicerSegmentEditorLogic::ModifySegmentByLabelmap: Failed to remove modifier labelmap from selected segment");
+      success = false;
+      }
+    }
+  else
+    {
+    vtkGenericWarningMacro("vtkSlicerSegmentEditorLogic::ModifySegmentByLabelmap failed: Invalid modification mode " << modificationMode);
+    return false;
+    }
+
+  std::vector<std::string> allSegmentIDs;
+  segmentationNode->GetSegmentation()->GetSegmentIDs(allSegmentIDs);
+  // remove selected segment, that is already handled
+  allSegmentIDs.erase(std::remove(allSegmentIDs.begin(), allSegmentIDs.end(), selectedSegmentID), allSegmentIDs.end());
+
+  std::vector<std::string> segmentIDsToOverwrite;
+  switch (segmentEditorNode->GetOverwriteMode())
+    {
+  case vtkMRMLSegmentEditorNode::OverwriteNone:
+    // nothing to overwrite
+    break;
+  case vtkMRMLSegmentEditorNode::OverwriteVisibleSegments:
+    GetVisibleSegmentIDs(segmentationNode, allSegmentIDs, segmentIDsToOverwrite);
+    break;
+  case vtkMRMLSegmentEditorNode::OverwriteAllSegments:
+    segmentIDsToOverwrite = allSegmentIDs;
+    break;
+    }
+
+  if (segmentIDsToOverwrite.empty())
+    {
+    return success;
+    }
+
+  if (modificationMode == ModificationModeSet || modificationMode == ModificationModeAdd)
+    {
+    inverter->Update();
+    invertedModifierLabelmap->ShallowCopy(inverter->GetOutput());
+    invertedModifierLabelmap->SetGeometryFromImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+    for (std::vector<std::string>::iterator segmentIDIt = segmentIDsToOverwrite.begin(); segmentIDIt != segmentIDsToOverwrite.end(); ++segmentIDIt)
+      {
+      if (!vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(
+        invertedModifierLabelmap.GetPointer(), segmentationNode, *segmentIDIt, vtkSlicerSegmentationsModuleLogic::MODE_MERGE_MIN, extent))
+        {
+        vtkGenericWarningMacro("vtkSlicerSegmentEditorLogic::ModifySegmentByLabelmap: Failed to set modifier labelmap to segment " << *segmentIDIt);
+        success = false;
+        }
+      }
+    }
+  else if (modificationMode == ModificationModeRemove)
+    {
+    // In general, we don't try to "add back" areas to other segments when an area is removed from the selected segment.
+    // The only exception is when we draw inside one specific segment. In that case erasing adds to the mask segment. It is useful
+    // for splitting a segment into two by painting.
+    if (segmentEditorNode->GetMaskMode() == vtkMRMLSegmentEditorNode::PaintAllowedInsideSingleSegment
+      && segmentEditorNode->GetMaskSegmentID())
+      {
+      if (!vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(
+        modifierLabelmap, segmentationNode, segmentEditorNode->GetMaskSegmentID(), vtkSlicerSegmentationsModuleLogic::MODE_MERGE_MAX, extent))
+        {
+        vtkGenericWarningMacro("vtkSlicerSegmentEditorLogic::ModifySegmentByLabelmap: Failed to remove modifier labelmap from segment "
+          << segmentEditorNode->GetMaskSegmentID());
+        success = false;
+        }
+      }
+    }
+  return success;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerSegmentEditorLogic::GetKernelSizePixel(double kernelSizeMm, vtkOrientedImageData* labelmap, int kernelSizePixel[3])
+{
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  if (labelmap)
+    {
+    labelmap->GetSpacing(spacing);
+    }
+  // size rounded to nearest odd number. If kernel size is even then image gets shifted.
+  for (int i = 0; i < 3; ++i)
+    {
+    kernelSizePixel[i] = vtkMath::Round((fabs(kernelSizeMm) / spacing[i] + 1.0) / 2.0) * 2 - 1;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerSegmentEditorLogic::ApplyEffect(const std::string& effectName)
+{
+  if (effectName == "Threshold")
+    {
+    return this->ApplyThreshold();
+    }
+  else if (effectName == "Islands")
+    {
+    return this->ApplyIslands();
+    }
+  else if (effectName == "Margin")
+    {
+    return this->ApplyMargin();
+    }
+  else if (effectName == "Smoothing")
+    {
+    return this->ApplySmoothing();
+    }
+  vtkErrorMacro("ApplyEffect: Effect " << effectName << " cannot be applied without the segment editor widget");
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerSegmentEditorLogic::ApplyThreshold()
+{
+  vtkNew<vtkOrientedImageData> masterImageData;
+  if (!this->GetAlignedMasterVolume(masterImageData.GetPointer()))
+    {
+    vtkErrorMacro("ApplyThreshold: Failed to get master volume");
+    return false;
+    }
+  double minimumThreshold = this->GetDoubleParameter("Threshold", "MinimumThreshold", 0.0);
+  double maximumThreshold = this->GetDoubleParameter("Threshold", "MaximumThreshold", 0.0);
+
+  vtkSmartPointer<vtkImageThreshold> threshold = vtkSmartPointer<vtkImageThreshold>::New();
+  threshold->SetInputData(masterImageData.GetPointer());
+  threshold->ThresholdBetween(minimumThreshold, maximumThreshold);
+  threshold->SetInValue(1);
+  threshold->SetOutValue(0);
+  threshold->SetOutputScalarType(VTK_UNSIGNED_CHAR);
+  threshold->Update();
+
+  vtkNew<vtkOrientedImageData> modifierLabelmap;
+  modifierLabelmap->ShallowCopy(threshold->GetOutput());
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  masterImageData->GetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+  modifierLabelmap->SetGeometryFromImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+
+  return this->ModifySelectedSegmentByLabelmap(modifierLabelmap.GetPointer(), ModificationModeSet);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerSegmentEditorLogic::ApplyIslands()
+{
+  std::string operation = this->GetParameter("Islands", "Operation", "KEEP_LARGEST_ISLAND");
+  int minimumSize = this->GetIntegerParameter("Islands", "MinimumSize", 1000);
+  bool split = true;
+  int maxNumberOfSegments = 0; // all islands are kept, regardless of how many
+  if (operation == "KEEP_LARGEST_ISLAND")
+    {
+    maxNumberOfSegments = 1;
+    }
+  else if (operation == "REMOVE_SMALL_ISLANDS")
+    {
+    split = false;
+    }
+  else if (operation != "SPLIT_ISLANDS_TO_SEGMENTS")
+    {
+    vtkErrorMacro("ApplyIslands: Unsupported operation " << operation);
+    return false;
+    }
+
+  vtkNew<vtkOrientedImageData> selectedSegmentLabelmap;
+  if (!this->GetSelectedSegmentLabelmap(selectedSegmentLabelmap.GetPointer()))
+    {
+    return false;
+    }
+  vtkNew<vtkMatrix4x4> selectedSegmentLabelmapImageToWorldMatrix;
+  selectedSegmentLabelmap->GetImageToWorldMatrix(selectedSegmentLabelmapImageToWorldMatrix.GetPointer());
+
+  vtkSmartPointer<vtkImageCast> castIn = vtkSmartPointer<vtkImageCast>::New();
+  castIn->SetInputData(selectedSegmentLabelmap.GetPointer());
+  castIn->SetOutputScalarTypeToUnsignedLong();
+
+  vtkSmartPointer<vtkITKIslandMath> islandMath = vtkSmartPointer<vtkITKIslandMath>::New();
+  islandMath->SetInputConnection(castIn->GetOutputPort());
+  islandMath->SetFullyConnected(false);
+  islandMath->SetMinimumSize(minimumSize);
+  islandMath->Update();
+
+  // Create a separate image for the first (largest) island
+  const int labelValue = 1;
+  const int backgroundValue = 0;
+  vtkSmartPointer<vtkImageThreshold> threshold = vtkSmartPointer<vtkImageThreshold>::New();
+  if (split)
+    {
+    threshold->ThresholdBetween(1, 1);
+    }
+  else
+    {
+    threshold->ThresholdByUpper(1);
+    }
+  threshold->SetInputConnection(islandMath->GetOutputPort());
+  threshold->SetOutValue(backgroundValue);
+  threshold->SetInValue(labelValue);
+  threshold->SetOutputScalarType(selectedSegmentLabelmap->GetScalarType());
+  threshold->Update();
+  vtkNew<vtkOrientedImageData> largestIslandImage;
+  largestIslandImage->ShallowCopy(threshold->GetOutput());
+  largestIslandImage->SetImageToWorldMatrix(selectedSegmentLabelmapImageToWorldMatrix.GetPointer());
+
+  if (split && maxNumberOfSegments != 1)
+    {
+    // 0 is background, 1 is largest island; we need label 2 and higher
+    vtkSmartPointer<vtkImageThreshold> smallerIslandsThreshold = vtkSmartPointer<vtkImageThreshold>::New();
+    smallerIslandsThreshold->ThresholdByUpper(2);
+    smallerIslandsThreshold->SetInputConnection(islandMath->GetOutputPort());
+    smallerIslandsThreshold->SetOutValue(backgroundValue);
+    smallerIslandsThreshold->ReplaceInOff();
+    smallerIslandsThreshold->Update();
+
+    vtkNew<vtkOrientedImageData> multiLabelImage;
+    multiLabelImage->DeepCopy(smallerIslandsThreshold->GetOutput());
+    multiLabelImage->SetGeometryFromImageToWorldMatrix(selectedSegmentLabelmapImageToWorldMatrix.GetPointer());
+
+    vtkMRMLSegmentationNode* segmentationNode = this->SegmentEditorNode->GetSegmentationNode();
+    vtkSegment* selectedSegment = segmentationNode->GetSegmentation()->GetSegment(this->SegmentEditorNode->GetSelectedSegmentID());
+    std::string selectedSegmentName = (selectedSegment && selectedSegment->GetName()) ? selectedSegment->GetName() : "";
+    if (!vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode(multiLabelImage.GetPointer(), segmentationNode,
+      selectedSegmentName + " -"))
+      {
+      vtkErrorMacro("ApplyIslands: Failed to import islands as new segments");
+      return false;
+      }
+    }
+
+  return this->ModifySelectedSegmentByLabelmap(largestIslandImage.GetPointer(), ModificationModeSet);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerSegmentEditorLogic::ApplyMargin()
+{
+  vtkNew<vtkOrientedImageData> selectedSegmentLabelmap;
+  if (!this->GetSelectedSegmentLabelmap(selectedSegmentLabelmap.GetPointer()))
+    {
+    return false;
+    }
+  double marginSizeMm = this->GetDoubleParameter("Margin", "MarginSizeMm", 3.0);
+  int kernelSizePixel[3] = { 1, 1, 1 };
+  vtkSlicerSegmentEditorLogic::GetKernelSizePixel(marginSizeMm, selectedSegmentLabelmap.GetPointer(), kernelSizePixel);
+
+  // Only the neighborhood of the segment can change
+  int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!vtkOrientedImageDataResample::CalculateEffectiveExtent(selectedSegmentLabelmap.GetPointer(), effectiveExtent))
+    {
+    // Empty segment, there is nothing to grow or shrink
+    return true;
+    }
+  int fullExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  selectedSegmentLabelmap->GetExtent(fullExtent);
+  int computedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    int padding = (marginSizeMm > 0 ? (abs(kernelSizePixel[axis]) - 1) / 2 : 1);
+    computedExtent[axis * 2] = std::max(effectiveExtent[axis * 2] - padding, fullExtent[axis * 2]);
+    computedExtent[axis * 2 + 1] = std::min(effectiveExtent[axis * 2 + 1] + padding, fullExtent[axis * 2 + 1]);
+    }
+
+  // The kernel of the margin is an ellipsoid, its radius is half the kernel size.
+  // Shrinking the segment is growing the background.
+  const int labelValue = 1;
+  const int backgroundValue = 0;
+  vtkSmartPointer<vtkImageThreshold> threshold = vtkSmartPointer<vtkImageThreshold>::New();
+  threshold->SetInputData(selectedSegmentLabelmap.GetPointer());
+  threshold->ThresholdByLower(0);
+  threshold->SetInValue(marginSizeMm > 0 ? backgroundValue : labelValue);
+  threshold->SetOutValue(marginSizeMm > 0 ? labelValue : backgroundValue);
+  threshold->SetOutputScalarType(VTK_FLOAT);
+
+  vtkSmartPointer<vtkImageConstantPad> crop = vtkSmartPointer<vtkImageConstantPad>::New();
+  crop->SetInputConnection(threshold->GetOutputPort());
+  crop->SetOutputWholeExtent(computedExtent);
+
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  selectedSegmentLabelmap->GetSpacing(spacing);
+  double kernelSpacing[3] = { 1.0, 1.0, 1.0 };
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    kernelSpacing[axis] = spacing[axis] / (abs(kernelSizePixel[axis]) / 2.0);
+    }
+  vtkSmartPointer<vtkImageChangeInformation> kernelSpacingChange = vtkSmartPointer<vtkImageChangeInformation>::New();
+  kernelSpacingChange->SetInputConnection(crop->GetOutputPort());
+  kernelSpacingChange->SetOutputSpacing(kernelSpacing);
+
+  vtkSmartPointer<vtkITKDistanceTransform> distance = vtkSmartPointer<vtkITKDistanceTransform>::New();
+  distance->SetInputConnection(kernelSpacingChange->GetOutputPort());
+  distance->SetSquaredDistance(0);
+  distance->SetUseImageSpacing(1);
+  distance->SetInsideIsPositive(0);
+  distance->SetBackgroundValue(backgroundValue);
+
+  vtkSmartPointer<vtkImageThreshold> reached = vtkSmartPointer<vtkImageThreshold>::New();
+  reached->SetInputConnection(distance->GetOutputPort());
+  reached->ThresholdByLower(1.0 + 1e-3);
+  reached->SetInValue(marginSizeMm > 0 ? labelValue : backgroundValue);
+  reached->SetOutValue(marginSizeMm > 0 ? backgroundValue : labelValue);
+  reached->SetOutputScalarType(selectedSegmentLabelmap->GetScalarType());
+
+  vtkSmartPointer<vtkImageChangeInformation> restoreSpacing = vtkSmartPointer<vtkImageChangeInformation>::New();
+  restoreSpacing->SetInputConnection(reached->GetOutputPort());
+  restoreSpacing->SetOutputSpacing(spacing);
+
+  vtkSmartPointer<vtkImageConstantPad> pad = vtkSmartPointer<vtkImageConstantPad>::New();
+  pad->SetInputConnection(restoreSpacing->GetOutputPort());
+  pad->SetOutputWholeExtent(fullExtent);
+  pad->SetConstant(backgroundValue);
+  pad->Update();
+
+  vtkNew<vtkOrientedImageData> modifierLabelmap;
+  modifierLabelmap->ShallowCopy(pad->GetOutput());
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  selectedSegmentLabelmap->GetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+  modifierLabelmap->SetGeometryFromImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+
+  return this->ModifySelectedSegmentByLabelmap(modifierLabelmap.GetPointer(), ModificationModeSet);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerSegmentEditorLogic::ApplySmoothing()
+{
+  std::string smoothingMethod = this->GetParameter("Smoothing", "SmoothingMethod", "MEDIAN");
+  if (smoothingMethod == "JOINT_TAUBIN")
+    {
+    return this->SmoothMultipleSegmentsTaubin();
+    }
+  else if (smoothingMethod == "JOINT_GAUSSIAN")
+    {
+    vtkMRMLSegmentationNode* segmentationNode = this->SegmentEditorNode ? this->SegmentEditorNode->GetSegmentationNode() : NULL;
+    vtkMRMLSegmentationDisplayNode* displayNode = segmentationNode ?
+      vtkMRMLSegmentationDisplayNode::SafeDownCast(segmentationNode->GetDisplayNode()) : NULL;
+    if (!displayNode)
+      {
+      vtkErrorMacro("ApplySmoothing: Invalid segmentation display node");
+      return false;
+      }
+    vtkNew<vtkStringArray> visibleSegmentIDs;
+    displayNode->GetVisibleSegmentIDs(visibleSegmentIDs.GetPointer());
+    if (visibleSegmentIDs->GetNumberOfValues() == 0)
+      {
+      // there are no visible segments, nothing to do
+      return true;
+      }
+    double standardDeviationMm = this->GetDoubleParameter("Smoothing", "GaussianStandardDeviationMm", 3.0);
+    return vtkSlicerSegmentationsModuleLogic::SmoothSegmentsJointly(segmentationNode, standardDeviationMm, visibleSegmentIDs.GetPointer());
+    }
+  return this->SmoothSelectedSegment();
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerSegmentEditorLogic::SmoothSelectedSegment()
+{
+  vtkNew<vtkOrientedImageData> selectedSegmentLabelmap;
+  if (!this->GetSelectedSegmentLabelmap(selectedSegmentLabelmap.GetPointer()))
+    {
+    return false;
+    }
+  std::string smoothingMethod = this->GetParameter("Smoothing", "SmoothingMethod", "MEDIAN");
+
+  vtkSmartPointer<vtkImageAlgorithm> smoothingFilter;
+  if (smoothingMethod == "GAUSSIAN")
+    {
+    const int maxValue = 255;
+    vtkSmartPointer<vtkImageThreshold> threshold = vtkSmartPointer<vtkImageThreshold>::New();
+    threshold->SetInputData(selectedSegmentLabelmap.GetPointer());
+    threshold->ThresholdByLower(0);
+    threshold->SetInValue(0);
+    threshold->SetOutValue(maxValue);
+    threshold->SetOutputScalarType(VTK_UNSIGNED_CHAR);
+
+    vtkSmartPointer<vtkImageGaussianSmooth> gaussianFilter = vtkSmartPointer<vtkImageGaussianSmooth>::New();
+    gaussianFilter->SetInputConnection(threshold->GetOutputPort());
+    gaussianFilter->SetStandardDeviation(this->GetDoubleParameter("Smoothing", "GaussianStandardDeviationMm", 3.0));
+    gaussianFilter->SetRadiusFactor(4);
+
+    vtkSmartPointer<vtkImageThreshold> binarize = vtkSmartPointer<vtkImageThreshold>::New();
+    binarize->SetInputConnection(gaussianFilter->GetOutputPort());
+    binarize->ThresholdByUpper(maxValue / 2);
+    binarize->SetInValue(1);
+    binarize->SetOutValue(0);
+    binarize->SetOutputScalarType(selectedSegmentLabelmap->GetScalarType());
+    smoothingFilter = binarize;
+    }
+  else
+    {
+    int kernelSizePixel[3] = { 1, 1, 1 };
+    vtkSlicerSegmentEditorLogic::GetKernelSizePixel(this->GetDoubleParameter("Smoothing", "KernelSizeMm", 3.0),
+      selectedSegmentLabelmap.GetPointer(), kernelSizePixel);
+    if (smoothingMethod == "MEDIAN")
+      {
+      // Median filter does not require a particular label value
+      vtkSmartPointer<vtkImageMedian3D> medianFilter = vtkSmartPointer<vtkImageMedian3D>::New();
+      medianFilter->SetInputData(selectedSegmentLabelmap.GetPointer());
+      medianFilter->SetKernelSize(kernelSizePixel[0], kernelSizePixel[1], kernelSizePixel[2]);
+      smoothingFilter = medianFilter;
+      }
+    else if (smoothingMethod == "MORPHOLOGICAL_OPENING" || smoothingMethod == "MORPHOLOGICAL_CLOSING")
+      {
+      // We need to know exactly the value of the segment voxels, apply threshold to make force the selected label value
+      const int labelValue = 1;
+      const int backgroundValue = 0;
+      vtkSmartPointer<vtkImageThreshold> threshold = vtkSmartPointer<vtkImageThreshold>::New();
+      threshold->SetInputData(selectedSegmentLabelmap.GetPointer());
+      threshold->ThresholdByLower(0);
+      threshold->SetInValue(backgroundValue);
+      threshold->SetOutValue(labelValue);
+      threshold->SetOutputScalarType(selectedSegmentLabelmap->GetScalarType());
+
+      vtkSmartPointer<vtkImageOpenClose3D> openCloseFilter = vtkSmartPointer<vtkImageOpenClose3D>::New();
+      openCloseFilter->SetInputConnection(threshold->GetOutputPort());
+      if (smoothingMethod == "MORPHOLOGICAL_OPENING")
+        {
+        openCloseFilter->SetOpenValue(labelValue);
+        openCloseFilter->SetCloseValue(backgroundValue);
+        }
+      else
+        {
+        openCloseFilter->SetOpenValue(backgroundValue);
+        openCloseFilter->SetCloseValue(labelValue);
+        }
+      openCloseFilter->SetKernelSize(kernelSizePixel[0], kernelSizePixel[1], kernelSizePixel[2]);
+      smoothingFilter = openCloseFilter;
+      }
+    else
+      {
+      vtkErrorMacro("SmoothSelectedSegment: Unsupported smoothing method " << smoothingMethod);
+      return false;
+      }
+    }
+  smoothingFilter->Update();
+
+  vtkNew<vtkOrientedImageData> modifierLabelmap;
+  modifierLabelmap->ShallowCopy(smoothingFilter->GetOutputDataObject(0));
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  selectedSegmentLabelmap->GetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+  modifierLabelmap->SetGeometryFromImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+
+  return this->ModifySelectedSegmentByLabelmap(modifierLabelmap.GetPointer(), ModificationModeSet);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerSegmentEditorLogic::SmoothMultipleSegmentsTaubin()
+{
+  vtkMRMLSegmentationNode* segmentationNode = this->SegmentEditorNode ? this->SegmentEditorNode->GetSegmentationNode() : NULL;
+  vtkMRMLSegmentationDisplayNode* displayNode = segmentationNode ?
+    vtkMRMLSegmentationDisplayNode::SafeDownCast(segmentationNode->GetDisplayNode()) : NULL;
+  if (!displayNode)
+    {
+    vtkErrorMacro("SmoothMultipleSegmentsTaubin: Invalid segmentation display node");
+    return false;
+    }
+  vtkNew<vtkStringArray> visibleSegmentIDs;
+  displayNode->GetVisibleSegmentIDs(visibleSegmentIDs.GetPointer());
+  if (visibleSegmentIDs->GetNumberOfValues() == 0)
+    {
+    // there are no visible segments, nothing to do
+    return true;
+    }
+
+  vtkNew<vtkOrientedImageData> mergedImage;
+  if (!segmentationNode->GenerateMergedLabelmapForAllSegments(mergedImage.GetPointer(),
+    vtkSegmentation::EXTENT_UNION_OF_SEGMENTS_PADDED, NULL, visibleSegmentIDs.GetPointer()))
+    {
+    vtkErrorMacro("SmoothMultipleSegmentsTaubin: Failed to generate merged labelmap of visible segments");
+    return false;
+    }
+
+  // Perform smoothing in voxel space
+  vtkSmartPointer<vtkImageChangeInformation> changeInformation = vtkSmartPointer<vtkImageChangeInformation>::New();
+  changeInformation->SetInputData(mergedImage.GetPointer());
+  changeInformation->SetOutputSpacing(1, 1, 1);
+  changeInformation->SetOutputOrigin(0, 0, 0);
+
+  // Convert labelmap to combined polydata. Label value of a segment is its index in the list plus one.
+  vtkSmartPointer<vtkDiscreteMarchingCubes> convertToPolyData = vtkSmartPointer<vtkDiscreteMarchingCubes>::New();
+  convertToPolyData->SetInputConnection(changeInformation->GetOutputPort());
+  convertToPolyData->SetNumberOfContours(visibleSegmentIDs->GetNumberOfValues());
+  for (vtkIdType segmentIndex = 0; segmentIndex < visibleSegmentIDs->GetNumberOfValues(); ++segmentIndex)
+    {
+    convertToPolyData->SetValue(segmentIndex, segmentIndex + 1);
+    }
+
+  // Low-pass filtering using Taubin's method
+  double smoothingFactor = this->GetDoubleParameter("Smoothing", "JointTaubinSmoothingFactor", 0.5);
+  vtkSmartPointer<vtkWindowedSincPolyDataFilter> smoother = vtkSmartPointer<vtkWindowedSincPolyDataFilter>::New();
+  smoother->SetInputConnection(convertToPolyData->GetOutputPort());
+  smoother->SetNumberOfIterations(100); // higher than the 10-20 recommended in VTK documentation to reduce chance of shrinking
+  smoother->BoundarySmoothingOff();
+  smoother->FeatureEdgeSmoothingOff();
+  smoother->SetFeatureAngle(90.0);
+  smoother->SetPassBand(pow(10.0, -4.0 * smoothingFactor)); // gives a range of 1-0.0001 from a smoothing factor of 0-1
+  smoother->NonManifoldSmoothingOn();
+  smoother->NormalizeCoordinatesOn();
+
+  // Extract a label
+  vtkSmartPointer<vtkThreshold> threshold = vtkSmartPointer<vtkThreshold>::New();
+  threshold->SetInputConnection(smoother->GetOutputPort());
+
+  vtkSmartPointer<vtkGeometryFilter> geometryFilter = vtkSmartPointer<vtkGeometryFilter>::New();
+  geometryFilter->SetInputConnection(threshold->GetOutputPort());
+
+  // Convert polydata to stencil
+  vtkSmartPointer<vtkPolyDataToImageStencil> polyDataToImageStencil = vtkSmartPointer<vtkPolyDataToImageStencil>::New();
+  polyDataToImageStencil->SetInputConnection(geometryFilter->GetOutputPort());
+  polyDataToImageStencil->SetOutputSpacing(1, 1, 1);
+  polyDataToImageStencil->SetOutputOrigin(0, 0, 0);
+  polyDataToImageStencil->SetOutputWholeExtent(mergedImage->GetExtent());
+
+  // Convert stencil to image
+  vtkNew<vtkImageData> emptyBinaryLabelmap;
+  emptyBinaryLabelmap->SetExtent(mergedImage->GetExtent());
+  emptyBinaryLabelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  vtkOrientedImageDataResample::FillImage(emptyBinaryLabelmap.GetPointer(), 0);
+  vtkSmartPointer<vtkImageStencil> stencil = vtkSmartPointer<vtkImageStencil>::New();
+  stencil->SetInputData(emptyBinaryLabelmap.GetPointer());
+  stencil->SetStencilConnection(polyDataToImageStencil->GetOutputPort());
+  stencil->ReverseStencilOn();
+  stencil->SetBackgroundValue(1); // General foreground value is 1 (background value because of reverse stencil)
+
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  mergedImage->GetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+
+  bool success = true;
+  for (vtkIdType segmentIndex = 0; segmentIndex < visibleSegmentIDs->GetNumberOfValues(); ++segmentIndex)
+    {
+    threshold->ThresholdBetween(segmentIndex + 1, segmentIndex + 1);
+    stencil->Update();
+    vtkNew<vtkOrientedImageData> smoothedBinaryLabelmap;
+    smoothedBinaryLabelmap->ShallowCopy(stencil->GetOutput());
+    smoothedBinaryLabelmap->SetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+    // Write results to segments directly, bypassing masking
+    if (!vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(smoothedBinaryLabelmap.GetPointer(),
+      segmentationNode, visibleSegmentIDs->GetValue(segmentIndex), vtkSlicerSegmentationsModuleLogic::MODE_REPLACE,
+      smoothedBinaryLabelmap->GetExtent()))
+      {
+      vtkErrorMacro("SmoothMultipleSegmentsTaubin: Failed to set smoothed labelmap to segment " << visibleSegmentIDs->GetValue(segmentIndex));
+      success = false;
+      }
+    }
+  return success;
+}
@@ -0,0 +1,147 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSlicerSegmentEditorLogic_h
+#define __vtkSlicerSegmentEditorLogic_h
+
+#include "vtkSlicerSegmentationsModuleLogicExport.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <string>
+
+class vtkMRMLSegmentEditorNode;
+class vtkOrientedImageData;
+
+/// \ingroup SlicerRt_QtModules_Segmentations
+/// \brief Apply segment editor effects without the segment editor widget.
+///
+/// Effects are applied to the selected segment of the segmentation of the segment editor node,
+/// using the effect parameters, masking and overwrite settings stored in that node, the same way
+/// as the corresponding interactive effects do. Supported effects are Threshold, Islands, Margin
+/// and Smoothing. Effect parameters are read from the "EffectName.ParameterName" attributes of the
+/// segment editor node (falling back to the common "ParameterName" attribute and then to the
+/// default value of the interactive effect).
+///
+/// No rendering or Qt is involved, therefore scripts can post-process segmentations without
+/// the application GUI. Separate instances (with separate segment editor nodes) that edit different
+/// segmentations can be used from multiple threads concurrently.
+///
+/// Example:
+/// \code
+/// editorNode = slicer.vtkMRMLSegmentEditorNode()
+/// editorNode.SetAndObserveSegmentationNode(segmentationNode)
+/// editorNode.SetAndObserveMasterVolumeNode(masterVolumeNode)
+/// editorNode.SetSelectedSegmentID(segmentID)
+/// editorNode.SetAttribute("Margin.MarginSizeMm", "2.5")
+/// editorLogic = slicer.vtkSlicerSegmentEditorLogic()
+/// editorLogic.SetSegmentEditorNode(editorNode)
+/// editorLogic.ApplyEffect("Margin")
+/// \endcode
+class VTK_SLICER_SEGMENTATIONS_LOGIC_EXPORT vtkSlicerSegmentEditorLogic : public vtkObject
+{
+public:
+  static vtkSlicerSegmentEditorLogic *New();
+  vtkTypeMacro(vtkSlicerSegmentEditorLogic,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  /// Modes of modifying the selected segment by a modifier labelmap
+  /// (same as qSlicerSegmentEditorAbstractEffect::ModificationMode)
+  enum
+    {
+    ModificationModeSet = 0,
+    ModificationModeAdd,
+    ModificationModeRemove
+    };
+
+  /// Parameter set node that specifies the segmentation, selected segment, master volume,
+  /// masking settings and effect parameters
+  virtual void SetSegmentEditorNode(vtkMRMLSegmentEditorNode* node);
+  vtkGetObjectMacro(SegmentEditorNode, vtkMRMLSegmentEditorNode);
+
+  /// Get effect parameter. Effect-specific "EffectName.ParameterName" attribute is returned if defined,
+  /// otherwise the common "ParameterName" attribute, otherwise the given default value.
+  std::string GetParameter(const std::string& effectName, const std::string& parameterName, const std::string& defaultValue="");
+  double GetDoubleParameter(const std::string& effectName, const std::string& parameterName, double defaultValue=0.0);
+  int GetIntegerParameter(const std::string& effectName, const std::string& parameterName, int defaultValue=0);
+
+  /// Apply an effect by name ("Threshold", "Islands", "Margin", or "Smoothing")
+  /// \return Success flag
+  bool ApplyEffect(const std::string& effectName);
+
+  /// Set the selected segment to the voxels of the master volume that are
+  /// between MinimumThreshold and MaximumThreshold parameters.
+  bool ApplyThreshold();
+
+  /// Apply Operation parameter (KEEP_LARGEST_ISLAND, REMOVE_SMALL_ISLANDS, SPLIT_ISLANDS_TO_SEGMENTS)
+  /// with MinimumSize parameter (in voxels) to the selected segment.
+  bool ApplyIslands();
+
+  /// Grow (positive MarginSizeMm parameter) or shrink (negative MarginSizeMm parameter) the selected segment.
+  bool ApplyMargin();
+
+  /// Smooth the selected segment (SmoothingMethod parameter MEDIAN, GAUSSIAN, MORPHOLOGICAL_OPENING,
+  /// MORPHOLOGICAL_CLOSING) or all visible segments (JOINT_TAUBIN, JOINT_GAUSSIAN).
+  /// Uses KernelSizeMm, GaussianStandardDeviationMm, JointTaubinSmoothingFactor parameters.
+  bool ApplySmoothing();
+
+  /// Get geometry that the editing is performed in (serialized image geometry, empty if cannot be determined).
+  /// If the segmentation has no reference geometry yet then it is set from the master volume.
+  std::string GetReferenceImageGeometry();
+
+  /// Get labelmap of the selected segment, in the reference geometry
+  bool GetSelectedSegmentLabelmap(vtkOrientedImageData* selectedSegmentLabelmap);
+
+  /// Get master volume resampled to the reference geometry
+  bool GetAlignedMasterVolume(vtkOrientedImageData* alignedMasterVolume);
+
+  /// Get mask defined by the MaskMode of the segment editor node, in the reference geometry.
+  /// Voxels where editing is not allowed are 1, all other voxels are 0.
+  bool GetMaskLabelmap(vtkOrientedImageData* maskLabelmap);
+
+  /// Modify the selected segment by the modifier labelmap, applying masking and overwrite settings
+  /// of the segment editor node (same as qSlicerSegmentEditorAbstractEffect::modifySelectedSegmentByLabelmap).
+  /// \param modificationExtent If valid then only this extent of the modifier labelmap is used.
+  bool ModifySelectedSegmentByLabelmap(vtkOrientedImageData* modifierLabelmap, int modificationMode, const int modificationExtent[6]=0);
+
+  /// Modify the selected segment of the segment editor node by the modifier labelmap, applying masking and overwrite settings.
+  /// \param maskLabelmap Mask used if mask mode of the segment editor node is not PaintAllowedEverywhere
+  /// \param alignedMasterVolume Master volume in the geometry of the modifier labelmap, used if master volume intensity mask is enabled
+  static bool ModifySegmentByLabelmap(vtkMRMLSegmentEditorNode* segmentEditorNode, vtkOrientedImageData* modifierLabelmap,
+    int modificationMode, const int modificationExtent[6], vtkOrientedImageData* maskLabelmap, vtkOrientedImageData* alignedMasterVolume);
+
+protected:
+  vtkSlicerSegmentEditorLogic();
+  ~vtkSlicerSegmentEditorLogic();
+
+  /// Empty labelmap in the reference geometry
+  bool GetDefaultModifierLabelmap(vtkOrientedImageData* modifierLabelmap);
+
+  /// Kernel size in voxels of the selected segment labelmap, rounded to nearest odd number
+  static void GetKernelSizePixel(double kernelSizeMm, vtkOrientedImageData* labelmap, int kernelSizePixel[3]);
+
+  bool SmoothSelectedSegment();
+  bool SmoothMultipleSegmentsTaubin();
+
+  vtkMRMLSegmentEditorNode* SegmentEditorNode;
+
+private:
+  vtkSlicerSegmentEditorLogic(const vtkSlicerSegmentEditorLogic&); // Not implemented
+  void operator=(const vtkSlicerSegmentEditorLogic&); // Not implemented
+};
+
+#endif
@@ -55,7 +55,15 @@
 #include <vtkTransformPolyDataFilter.h>
 #include <vtkImageMathematics.h>
 #include <vtkImageConstantPad.h>
+#include <vtkImageGaussianSmooth.h>
 #include <vtkLookupTable.h>
+#include <vtkStringArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMassProperties.h>
+#include <vtkMath.h>
+#include <vtkMultiThreader.h>
+#include <vtkTable.h>
 
 // MRML includes
 #include <vtkMRMLScene.h>
@@ -65,10 +73,15 @@
 #include <vtkMRMLLabelMapVolumeDisplayNode.h>
 #include <vtkMRMLModelNode.h>
 #include <vtkMRMLModelDisplayNode.h>
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLTableNode.h>
 #include <vtkMRMLTransformNode.h>
 
 // STD includes
+#include <algorithm>
+#include <cmath>
 #include <sstream>
+#include <vector>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerSegmentationsModuleLogic);
@@ -1361,6 +1374,8 @@ bool vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(vtkOrientedIm
   // 1. Append input labelmap to the segment labelmap if requested
   vtkSmartPointer<vtkOrientedImageData> newSegmentLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
   bool segmentLabelmapModified = true;
+  // Only a merge into a segment of the same geometry leaves voxels outside of the extent unchanged
+  bool modifiedExtentValid = false;
 
   int* segmentLabelmapExtent = segmentLabelmap->GetExtent();
   bool segmentLabelmapEmpty = (segmentLabelmapExtent[0] > segmentLabelmapExtent[1] ||
@@ -1409,6 +1424,7 @@ bool vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(vtkOrientedIm
         vtkErrorWithObjectMacro(segmentationNode, "vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment: Failed to merge labelmap (max)");
         return false;
         }
+      modifiedExtentValid = (extent != NULL);
       }
     }
 
@@ -1457,9 +1473,972 @@ bool vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(vtkOrientedIm
 
   // Re-enable master representation modified event
   segmentationNode->GetSegmentation()->SetMasterRepresentationModifiedEnabled(wasMasterRepresentationModifiedEnabled);
+  // Report the modified region to observers. Cropping to the effective extent does not change
+  // the IJK coordinates of the voxels, so the extent remains valid in the segment labelmap.
+  segmentationNode->GetSegmentation()->SetModifiedExtent(modifiedExtentValid ? extent : NULL);
   const char* segmentIdChar = segmentID.c_str();
   segmentationNode->GetSegmentation()->InvokeEvent(vtkSegmentation::MasterRepresentationModified, (void*)segmentIdChar);
   segmentationNode->GetSegmentation()->InvokeEvent(vtkSegmentation::RepresentationModified, (void*)segmentIdChar);
+  segmentationNode->GetSegmentation()->SetModifiedExtent(NULL);
 
   return true;
 }
+
+//-----------------------------------------------------------------------------
+template <class T>
+void SetLabelmapToSegmentsFindChangedLabels(T* labels, T* previousLabels, vtkIdType numberOfVoxels,
+  std::vector<bool>& changedLabels)
+{
+  const T numberOfLabels = static_cast<T>(changedLabels.size() - 1);
+  for (vtkIdType voxelIndex = 0; voxelIndex < numberOfVoxels; ++voxelIndex)
+    {
+    if (labels[voxelIndex] == previousLabels[voxelIndex])
+      {
+      continue;
+      }
+    if (labels[voxelIndex] > 0 && labels[voxelIndex] <= numberOfLabels)
+      {
+      changedLabels[labels[voxelIndex]] = true;
+      }
+    if (previousLabels[voxelIndex] > 0 && previousLabels[voxelIndex] <= numberOfLabels)
+      {
+      changedLabels[previousLabels[voxelIndex]] = true;
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerSegmentationsModuleLogic::SetLabelmapToSegments(vtkOrientedImageData* labelmap, vtkMRMLSegmentationNode* segmentationNode,
+  vtkStringArray* segmentIDs, vtkOrientedImageData* previousLabelmap/*=NULL*/)
+{
+  if (!labelmap || !segmentationNode || !segmentationNode->GetSegmentation() || !segmentIDs)
+    {
+    vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::SetLabelmapToSegments: Invalid inputs");
+    return false;
+    }
+  if (!labelmap->GetPointData() || !labelmap->GetPointData()->GetScalars()
+    || labelmap->GetNumberOfScalarComponents() != 1)
+    {
+    vtkErrorWithObjectMacro(segmentationNode, "vtkSlicerSegmentationsModuleLogic::SetLabelmapToSegments: Invalid input labelmap");
+    return false;
+    }
+  int extent[6] = {0,-1,0,-1,0,-1};
+  labelmap->GetExtent(extent);
+  std::vector<bool> changedLabels(segmentIDs->GetNumberOfValues() + 1, true);
+
+  bool previousLabelmapValid = (previousLabelmap && previousLabelmap->GetPointData() && previousLabelmap->GetPointData()->GetScalars()
+    && previousLabelmap->GetScalarType() == labelmap->GetScalarType() && previousLabelmap->GetNumberOfScalarComponents() == 1);
+  if (previousLabelmapValid)
+    {
+    int* previousExtent = previousLabelmap->GetExtent();
+    for (int i = 0; i < 6; ++i)
+      {
+      previousLabelmapValid &= (previousExtent[i] == extent[i]);
+      }
+    }
+  if (previousLabelmapValid)
+    {
+    std::fill(changedLabels.begin(), changedLabels.end(), false);
+    void* labelsPtr = labelmap->GetScalarPointer();
+    void* previousLabelsPtr = previousLabelmap->GetScalarPointer();
+    vtkIdType numberOfVoxels = labelmap->GetNumberOfPoints();
+    switch (labelmap->GetScalarType())
+      {
+      vtkTemplateMacro(SetLabelmapToSegmentsFindChangedLabels(static_cast<VTK_TT*>(labelsPtr),
+        static_cast<VTK_TT*>(previousLabelsPtr), numberOfVoxels, changedLabels));
+      default:
+        vtkErrorWithObjectMacro(segmentationNode, "vtkSlicerSegmentationsModuleLogic::SetLabelmapToSegments: Unsupported scalar type");
+        return false;
+      }
+    }
+
+  bool success = true;
+  vtkNew<vtkImageThreshold> threshold;
+  threshold->SetInputData(labelmap);
+  threshold->SetInValue(1);
+  threshold->SetOutValue(0);
+  threshold->SetOutputScalarType(VTK_UNSIGNED_CHAR);
+  vtkSmartPointer<vtkMatrix4x4> imageToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+  labelmap->GetImageToWorldMatrix(imageToWorldMatrix);
+  for (vtkIdType segmentIndex = 0; segmentIndex < segmentIDs->GetNumberOfValues(); ++segmentIndex)
+    {
+    // label value of the n-th segment is n+1 (background label value is 0)
+    if (!changedLabels[segmentIndex + 1])
+      {
+      continue;
+      }
+    std::string segmentID = segmentIDs->GetValue(segmentIndex);
+    if (!segmentationNode->GetSegmentation()->GetSegment(segmentID))
+      {
+      vtkWarningWithObjectMacro(segmentationNode, "vtkSlicerSegmentationsModuleLogic::SetLabelmapToSegments: Segment not found: " << segmentID);
+      success = false;
+      continue;
+      }
+    threshold->ThresholdBetween(segmentIndex + 1, segmentIndex + 1);
+    threshold->Update();
+    vtkSmartPointer<vtkOrientedImageData> segmentLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+    segmentLabelmap->ShallowCopy(threshold->GetOutput());
+    segmentLabelmap->SetImageToWorldMatrix(imageToWorldMatrix);
+    success &= vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(segmentLabelmap, segmentationNode, segmentID, MODE_REPLACE, extent);
+    }
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerSegmentationsModuleLogic::SmoothSegmentsJointly(vtkMRMLSegmentationNode* segmentationNode, double standardDeviationMm, vtkStringArray* segmentIDs/*=NULL*/)
+{
+  if (!segmentationNode || !segmentationNode->GetSegmentation() || standardDeviationMm <= 0)
+    {
+    vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::SmoothSegmentsJointly: Invalid inputs");
+    return false;
+    }
+  std::vector<std::string> smoothedSegmentIDs;
+  if (segmentIDs)
+    {
+    for (vtkIdType i = 0; i < segmentIDs->GetNumberOfValues(); ++i)
+      {
+      smoothedSegmentIDs.push_back(segmentIDs->GetValue(i));
+      }
+    }
+  else
+    {
+    segmentationNode->GetSegmentation()->GetSegmentIDs(smoothedSegmentIDs);
+    }
+  if (smoothedSegmentIDs.empty())
+    {
+    return true;
+    }
+
+  // Label value of each segment is its index in the list + 1
+  vtkSmartPointer<vtkOrientedImageData> mergedImage = vtkSmartPointer<vtkOrientedImageData>::New();
+  if (!segmentationNode->GenerateMergedLabelmap(mergedImage, vtkSegmentation::EXTENT_UNION_OF_SEGMENTS_PADDED, NULL, smoothedSegmentIDs))
+    {
+    vtkErrorWithObjectMacro(segmentationNode, "vtkSlicerSegmentationsModuleLogic::SmoothSegmentsJointly: Failed to generate merged labelmap");
+    return false;
+    }
+  int mergedExtent[6] = {0,-1,0,-1,0,-1};
+  mergedImage->GetExtent(mergedExtent);
+  if (mergedExtent[0] > mergedExtent[1] || mergedExtent[2] > mergedExtent[3] || mergedExtent[4] > mergedExtent[5])
+    {
+    // all segments are empty
+    return true;
+    }
+  const vtkIdType dimensions[3] = { mergedExtent[1]-mergedExtent[0]+1, mergedExtent[3]-mergedExtent[2]+1, mergedExtent[5]-mergedExtent[4]+1 };
+  const vtkIdType numberOfVoxels = dimensions[0] * dimensions[1] * dimensions[2];
+  const short* labels = static_cast<short*>(mergedImage->GetScalarPointerForExtent(mergedExtent));
+  const short numberOfLabels = static_cast<short>(smoothedSegmentIDs.size());
+
+  // Bounding box of each label
+  std::vector<int> labelExtents(6 * (numberOfLabels + 1));
+  for (short label = 0; label <= numberOfLabels; ++label)
+    {
+    for (int i = 0; i < 3; ++i)
+      {
+      labelExtents[label * 6 + i * 2] = VTK_INT_MAX;
+      labelExtents[label * 6 + i * 2 + 1] = VTK_INT_MIN;
+      }
+    }
+  const short* labelPtr = labels;
+  for (int k = mergedExtent[4]; k <= mergedExtent[5]; ++k)
+    {
+    for (int j = mergedExtent[2]; j <= mergedExtent[3]; ++j)
+      {
+      for (int i = mergedExtent[0]; i <= mergedExtent[1]; ++i, ++labelPtr)
+        {
+        if (*labelPtr <= 0 || *labelPtr > numberOfLabels)
+          {
+          continue;
+          }
+        int* labelExtent = &labelExtents[(*labelPtr) * 6];
+        labelExtent[0] = std::min(labelExtent[0], i); labelExtent[1] = std::max(labelExtent[1], i);
+        labelExtent[2] = std::min(labelExtent[2], j); labelExtent[3] = std::max(labelExtent[3], j);
+        labelExtent[4] = std::min(labelExtent[4], k); labelExtent[5] = std::max(labelExtent[5], k);
+        }
+      }
+    }
+
+  double spacing[3] = {1.0, 1.0, 1.0};
+  mergedImage->GetSpacing(spacing);
+  double standardDeviationsPixel[3] = {0.0, 0.0, 0.0};
+  int kernelRadius[3] = {0, 0, 0};
+  const double radiusFactor = 3.0;
+  for (int i = 0; i < 3; ++i)
+    {
+    standardDeviationsPixel[i] = standardDeviationMm / spacing[i];
+    kernelRadius[i] = static_cast<int>(ceil(standardDeviationsPixel[i] * radiusFactor));
+    }
+
+  // Blur the segments one by one, keeping the highest blurred value and its label for each voxel.
+  // The blurred background is not computed: as filtering is linear and the sum of the one-hot
+  // images of all labels is 1, it equals 1 minus the sum of the blurred segments.
+  std::vector<float> maximumValues(numberOfVoxels, 0.0f);
+  std::vector<float> sumValues(numberOfVoxels, 0.0f);
+  std::vector<short> maximumLabels(numberOfVoxels, 0);
+  vtkNew<vtkImageGaussianSmooth> gaussianFilter;
+  gaussianFilter->SetDimensionality(3);
+  gaussianFilter->SetStandardDeviations(standardDeviationsPixel);
+  gaussianFilter->SetRadiusFactors(radiusFactor, radiusFactor, radiusFactor);
+  for (short label = 1; label <= numberOfLabels; ++label)
+    {
+    int* labelExtent = &labelExtents[label * 6];
+    if (labelExtent[0] > labelExtent[1])
+      {
+      // empty segment
+      continue;
+      }
+    int paddedExtent[6] = {0,-1,0,-1,0,-1};
+    for (int i = 0; i < 3; ++i)
+      {
+      paddedExtent[i * 2] = std::max(labelExtent[i * 2] - kernelRadius[i], mergedExtent[i * 2]);
+      paddedExtent[i * 2 + 1] = std::min(labelExtent[i * 2 + 1] + kernelRadius[i], mergedExtent[i * 2 + 1]);
+      }
+    vtkSmartPointer<vtkImageData> labelImage = vtkSmartPointer<vtkImageData>::New();
+    labelImage->SetExtent(paddedExtent);
+    labelImage->AllocateScalars(VTK_FLOAT, 1);
+    float* labelImagePtr = static_cast<float*>(labelImage->GetScalarPointer());
+    for (int k = paddedExtent[4]; k <= paddedExtent[5]; ++k)
+      {
+      for (int j = paddedExtent[2]; j <= paddedExtent[3]; ++j)
+        {
+        labelPtr = labels + ((k - mergedExtent[4]) * dimensions[1] + (j - mergedExtent[2])) * dimensions[0] + (paddedExtent[0] - mergedExtent[0]);
+        for (int i = paddedExtent[0]; i <= paddedExtent[1]; ++i)
+          {
+          *(labelImagePtr++) = (*(labelPtr++) == label ? 1.0f : 0.0f);
+          }
+        }
+      }
+
+    gaussianFilter->SetInputData(labelImage);
+    gaussianFilter->Update();
+    const float* blurredPtr = static_cast<float*>(gaussianFilter->GetOutput()->GetScalarPointer());
+    for (int k = paddedExtent[4]; k <= paddedExtent[5]; ++k)
+      {
+      for (int j = paddedExtent[2]; j <= paddedExtent[3]; ++j)
+        {
+        vtkIdType voxelIndex = ((k - mergedExtent[4]) * dimensions[1] + (j - mergedExtent[2])) * dimensions[0] + (paddedExtent[0] - mergedExtent[0]);
+        for (int i = paddedExtent[0]; i <= paddedExtent[1]; ++i, ++voxelIndex, ++blurredPtr)
+          {
+          sumValues[voxelIndex] += *blurredPtr;
+          if (*blurredPtr > maximumValues[voxelIndex])
+            {
+            maximumValues[voxelIndex] = *blurredPtr;
+            maximumLabels[voxelIndex] = label;
+            }
+          }
+        }
+      }
+    }
+  gaussianFilter->SetInputData(NULL);
+
+  // Assign voxels to background where it has the highest blurred value and compute new bounding boxes
+  for (short label = 0; label <= numberOfLabels; ++label)
+    {
+    for (int i = 0; i < 3; ++i)
+      {
+      labelExtents[label * 6 + i * 2] = VTK_INT_MAX;
+      labelExtents[label * 6 + i * 2 + 1] = VTK_INT_MIN;
+      }
+    }
+  vtkIdType voxelIndex = 0;
+  for (int k = mergedExtent[4]; k <= mergedExtent[5]; ++k)
+    {
+    for (int j = mergedExtent[2]; j <= mergedExtent[3]; ++j)
+      {
+      for (int i = mergedExtent[0]; i <= mergedExtent[1]; ++i, ++voxelIndex)
+        {
+        if (maximumLabels[voxelIndex] == 0 || maximumValues[voxelIndex] <= 1.0f - sumValues[voxelIndex])
+          {
+          maximumLabels[voxelIndex] = 0;
+          continue;
+          }
+        int* labelExtent = &labelExtents[maximumLabels[voxelIndex] * 6];
+        labelExtent[0] = std::min(labelExtent[0], i); labelExtent[1] = std::max(labelExtent[1], i);
+        labelExtent[2] = std::min(labelExtent[2], j); labelExtent[3] = std::max(labelExtent[3], j);
+        labelExtent[4] = std::min(labelExtent[4], k); labelExtent[5] = std::max(labelExtent[5], k);
+        }
+      }
+    }
+
+  // Write results to segments, bypassing masking
+  vtkSmartPointer<vtkMatrix4x4> imageToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+  mergedImage->GetImageToWorldMatrix(imageToWorldMatrix);
+  bool success = true;
+  for (short label = 1; label <= numberOfLabels; ++label)
+    {
+    int segmentExtent[6] = {0,-1,0,-1,0,-1};
+    std::copy(labelExtents.begin() + label * 6, labelExtents.begin() + label * 6 + 6, segmentExtent);
+    if (segmentExtent[0] > segmentExtent[1])
+      {
+      // segment became empty, clear it using the whole merged extent
+      std::copy(mergedExtent, mergedExtent + 6, segmentExtent);
+      }
+    vtkSmartPointer<vtkOrientedImageData> smoothedLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+    smoothedLabelmap->SetExtent(segmentExtent);
+    smoothedLabelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+    smoothedLabelmap->SetImageToWorldMatrix(imageToWorldMatrix);
+    unsigned char* smoothedPtr = static_cast<unsigned char*>(smoothedLabelmap->GetScalarPointer());
+    for (int k = segmentExtent[4]; k <= segmentExtent[5]; ++k)
+      {
+      for (int j = segmentExtent[2]; j <= segmentExtent[3]; ++j)
+        {
+        voxelIndex = ((k - mergedExtent[4]) * dimensions[1] + (j - mergedExtent[2])) * dimensions[0] + (segmentExtent[0] - mergedExtent[0]);
+        for (int i = segmentExtent[0]; i <= segmentExtent[1]; ++i, ++voxelIndex)
+          {
+          *(smoothedPtr++) = (maximumLabels[voxelIndex] == label ? 1 : 0);
+          }
+        }
+      }
+    success &= vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(smoothedLabelmap, segmentationNode,
+      smoothedSegmentIDs[label - 1], MODE_REPLACE, segmentExtent);
+    }
+
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+/// Voxel statistics of one segment, accumulated by one thread or merged from all threads
+struct SegmentVoxelStatistics
+{
+  SegmentVoxelStatistics()
+    : VoxelCount(0)
+    , Sum(0.0)
+    , SumOfSquares(0.0)
+    , Min(VTK_DOUBLE_MAX)
+    , Max(-VTK_DOUBLE_MAX)
+    {
+    }
+  void Merge(const SegmentVoxelStatistics& other)
+    {
+    this->VoxelCount += other.VoxelCount;
+    this->Sum += other.Sum;
+    this->SumOfSquares += other.SumOfSquares;
+    this->Min = std::min(this->Min, other.Min);
+    this->Max = std::max(this->Max, other.Max);
+    }
+  vtkIdType VoxelCount;
+  double Sum;
+  double SumOfSquares;
+  double Min;
+  double Max;
+};
+
+//-----------------------------------------------------------------------------
+/// Data shared by the threads that compute segment statistics.
+/// Slices of the processed slice range are distributed between the threads,
+/// each thread accumulates into its own element of ThreadStatistics.
+struct SegmentStatisticsThreadData
+{
+  std::vector<vtkImageData*> Labelmaps;
+  vtkImageData* Scalars;
+  int SliceRange[2];
+  int NumberOfThreads;
+  std::vector< std::vector<SegmentVoxelStatistics> > ThreadStatistics;
+};
+
+//-----------------------------------------------------------------------------
+template <class TLabel, class TScalar>
+void AccumulateSegmentVoxelStatistics(vtkImageData* labelmap, TLabel*, vtkImageData* scalars, TScalar*,
+  const int extent[6], SegmentVoxelStatistics& statistics)
+{
+  const int numberOfScalarComponents = scalars->GetNumberOfScalarComponents();
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      const TLabel* labelPtr = static_cast<TLabel*>(labelmap->GetScalarPointer(extent[0], j, k));
+      const TScalar* scalarPtr = static_cast<TScalar*>(scalars->GetScalarPointer(extent[0], j, k));
+      for (int i = extent[0]; i <= extent[1]; ++i, ++labelPtr, scalarPtr += numberOfScalarComponents)
+        {
+        if (*labelPtr <= 0)
+          {
+          continue;
+          }
+        // only the first component is used, as in vtkImageAccumulate
+        const double value = static_cast<double>(*scalarPtr);
+        ++statistics.VoxelCount;
+        statistics.Sum += value;
+        statistics.SumOfSquares += value * value;
+        if (value < statistics.Min)
+          {
+          statistics.Min = value;
+          }
+        if (value > statistics.Max)
+          {
+          statistics.Max = value;
+          }
+        }
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+template <class TLabel>
+void AccumulateSegmentVoxelStatistics(vtkImageData* labelmap, TLabel* labelType, vtkImageData* scalars,
+  const int extent[6], SegmentVoxelStatistics& statistics)
+{
+  if (!scalars)
+    {
+    // count voxels only
+    for (int k = extent[4]; k <= extent[5]; ++k)
+      {
+      for (int j = extent[2]; j <= extent[3]; ++j)
+        {
+        const TLabel* labelPtr = static_cast<TLabel*>(labelmap->GetScalarPointer(extent[0], j, k));
+        for (int i = extent[0]; i <= extent[1]; ++i, ++labelPtr)
+          {
+          if (*labelPtr > 0)
+            {
+            ++statistics.VoxelCount;
+            }
+          }
+        }
+      }
+    return;
+    }
+  switch (scalars->GetScalarType())
+    {
+    vtkTemplateMacro(AccumulateSegmentVoxelStatistics(labelmap, labelType, scalars,
+      static_cast<VTK_TT*>(NULL), extent, statistics));
+    default:
+      break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE SegmentStatisticsThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  SegmentStatisticsThreadData* data = static_cast<SegmentStatisticsThreadData*>(threadInfo->UserData);
+  const int threadId = threadInfo->ThreadID;
+  const int numberOfThreads = std::min(threadInfo->NumberOfThreads, data->NumberOfThreads);
+  if (threadId >= numberOfThreads)
+    {
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  // Contiguous range of slices processed by this thread
+  const int numberOfSlices = data->SliceRange[1] - data->SliceRange[0] + 1;
+  const int firstSlice = data->SliceRange[0] + (numberOfSlices * threadId) / numberOfThreads;
+  const int lastSlice = data->SliceRange[0] + (numberOfSlices * (threadId + 1)) / numberOfThreads - 1;
+
+  std::vector<SegmentVoxelStatistics>& threadStatistics = data->ThreadStatistics[threadId];
+  for (size_t segmentIndex = 0; segmentIndex < data->Labelmaps.size(); ++segmentIndex)
+    {
+    vtkImageData* labelmap = data->Labelmaps[segmentIndex];
+    if (!labelmap || !labelmap->GetPointData()->GetScalars())
+      {
+      continue;
+      }
+    int extent[6] = {0,-1,0,-1,0,-1};
+    labelmap->GetExtent(extent);
+    if (data->Scalars)
+      {
+      int scalarExtent[6] = {0,-1,0,-1,0,-1};
+      data->Scalars->GetExtent(scalarExtent);
+      for (int i = 0; i < 3; ++i)
+        {
+        extent[i * 2] = std::max(extent[i * 2], scalarExtent[i * 2]);
+        extent[i * 2 + 1] = std::min(extent[i * 2 + 1], scalarExtent[i * 2 + 1]);
+        }
+      }
+    extent[4] = std::max(extent[4], firstSlice);
+    extent[5] = std::min(extent[5], lastSlice);
+    if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+      {
+      continue;
+      }
+    switch (labelmap->GetScalarType())
+      {
+      vtkTemplateMacro(AccumulateSegmentVoxelStatistics(labelmap, static_cast<VTK_TT*>(NULL), data->Scalars,
+        extent, threadStatistics[segmentIndex]));
+      default:
+        break;
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+/// Compute voxel statistics of all labelmaps in one multi-threaded pass.
+/// If scalars are specified then labelmaps must be in the same geometry as the scalars
+/// (their extents may be different), and statistics of the scalar values inside the labelmaps are computed.
+void ComputeSegmentVoxelStatistics(std::vector<vtkImageData*>& labelmaps, vtkImageData* scalars,
+  std::vector<SegmentVoxelStatistics>& statistics)
+{
+  statistics.clear();
+  statistics.resize(labelmaps.size());
+
+  SegmentStatisticsThreadData data;
+  data.Labelmaps = labelmaps;
+  data.Scalars = scalars;
+  data.SliceRange[0] = VTK_INT_MAX;
+  data.SliceRange[1] = VTK_INT_MIN;
+  for (std::vector<vtkImageData*>::iterator labelmapIt = labelmaps.begin(); labelmapIt != labelmaps.end(); ++labelmapIt)
+    {
+    if (!(*labelmapIt))
+      {
+      continue;
+      }
+    int extent[6] = {0,-1,0,-1,0,-1};
+    (*labelmapIt)->GetExtent(extent);
+    if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+      {
+      continue;
+      }
+    data.SliceRange[0] = std::min(data.SliceRange[0], extent[4]);
+    data.SliceRange[1] = std::max(data.SliceRange[1], extent[5]);
+    }
+  if (data.SliceRange[0] > data.SliceRange[1])
+    {
+    // all labelmaps are empty
+    return;
+    }
+
+  vtkNew<vtkMultiThreader> threader;
+  data.NumberOfThreads = std::min(threader->GetNumberOfThreads(), data.SliceRange[1] - data.SliceRange[0] + 1);
+  threader->SetNumberOfThreads(data.NumberOfThreads);
+  data.ThreadStatistics.resize(data.NumberOfThreads, std::vector<SegmentVoxelStatistics>(labelmaps.size()));
+  threader->SetSingleMethod(SegmentStatisticsThreadFunction, &data);
+  threader->SingleMethodExecute();
+
+  for (int threadId = 0; threadId < data.NumberOfThreads; ++threadId)
+    {
+    for (size_t segmentIndex = 0; segmentIndex < labelmaps.size(); ++segmentIndex)
+      {
+      statistics[segmentIndex].Merge(data.ThreadStatistics[threadId][segmentIndex]);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerSegmentationsModuleLogic::ComputeSegmentStatistics(vtkMRMLSegmentationNode* segmentationNode,
+  vtkMRMLScalarVolumeNode* scalarVolumeNode, vtkMRMLTableNode* tableNode, vtkStringArray* segmentIDs/*=NULL*/)
+{
+  if (!segmentationNode || !segmentationNode->GetSegmentation() || !tableNode)
+    {
+    vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::ComputeSegmentStatistics: Invalid inputs");
+    return false;
+    }
+  vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
+  std::vector<std::string> statisticsSegmentIDs;
+  if (segmentIDs)
+    {
+    for (vtkIdType i = 0; i < segmentIDs->GetNumberOfValues(); ++i)
+      {
+      statisticsSegmentIDs.push_back(segmentIDs->GetValue(i));
+      }
+    }
+  else
+    {
+    segmentation->GetSegmentIDs(statisticsSegmentIDs);
+    }
+  const int numberOfSegments = static_cast<int>(statisticsSegmentIDs.size());
+  const double ccPerCubicMM = 0.001;
+
+  int wasModified = tableNode->StartModify();
+  tableNode->RemoveAllColumns();
+  vtkTable* table = tableNode->GetTable();
+
+  vtkNew<vtkStringArray> segmentNameColumn;
+  segmentNameColumn->SetName("Segment");
+  segmentNameColumn->SetNumberOfValues(numberOfSegments);
+  for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+    {
+    vtkSegment* segment = segmentation->GetSegment(statisticsSegmentIDs[segmentIndex]);
+    segmentNameColumn->SetValue(segmentIndex, (segment && segment->GetName()) ? segment->GetName() : "");
+    }
+  table->AddColumn(segmentNameColumn.GetPointer());
+
+  std::string binaryLabelmapName = vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName();
+  if (segmentation->ContainsRepresentation(binaryLabelmapName))
+    {
+    // Labelmap statistics
+    std::vector<vtkImageData*> labelmaps(numberOfSegments, static_cast<vtkImageData*>(NULL));
+    for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+      {
+      vtkSegment* segment = segmentation->GetSegment(statisticsSegmentIDs[segmentIndex]);
+      labelmaps[segmentIndex] = segment ? vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(binaryLabelmapName)) : NULL;
+      }
+    std::vector<SegmentVoxelStatistics> statistics;
+    ComputeSegmentVoxelStatistics(labelmaps, NULL, statistics);
+
+    vtkNew<vtkIdTypeArray> voxelCountColumn;
+    voxelCountColumn->SetName("LM voxel count");
+    voxelCountColumn->SetNumberOfValues(numberOfSegments);
+    vtkNew<vtkDoubleArray> volumeMm3Column;
+    volumeMm3Column->SetName("LM volume mm3");
+    volumeMm3Column->SetNumberOfValues(numberOfSegments);
+    vtkNew<vtkDoubleArray> volumeCcColumn;
+    volumeCcColumn->SetName("LM volume cc");
+    volumeCcColumn->SetNumberOfValues(numberOfSegments);
+    for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+      {
+      double cubicMMPerVoxel = 0.0;
+      if (labelmaps[segmentIndex])
+        {
+        double* spacing = labelmaps[segmentIndex]->GetSpacing();
+        cubicMMPerVoxel = spacing[0] * spacing[1] * spacing[2];
+        }
+      voxelCountColumn->SetValue(segmentIndex, statistics[segmentIndex].VoxelCount);
+      volumeMm3Column->SetValue(segmentIndex, statistics[segmentIndex].VoxelCount * cubicMMPerVoxel);
+      volumeCcColumn->SetValue(segmentIndex, statistics[segmentIndex].VoxelCount * cubicMMPerVoxel * ccPerCubicMM);
+      }
+    table->AddColumn(voxelCountColumn.GetPointer());
+    table->AddColumn(volumeMm3Column.GetPointer());
+    table->AddColumn(volumeCcColumn.GetPointer());
+
+    if (scalarVolumeNode && scalarVolumeNode->GetImageData())
+      {
+      // Scalar volume statistics. Segments are resampled to the geometry of the volume if needed.
+      vtkSmartPointer<vtkOrientedImageData> referenceGeometry = vtkSmartPointer<vtkOrientedImageData>::New();
+      referenceGeometry->SetExtent(scalarVolumeNode->GetImageData()->GetExtent());
+      vtkSmartPointer<vtkMatrix4x4> ijkToRasMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+      scalarVolumeNode->GetIJKToRASMatrix(ijkToRasMatrix);
+      referenceGeometry->SetGeometryFromImageToWorldMatrix(ijkToRasMatrix);
+      vtkSmartPointer<vtkGeneralTransform> segmentationToReferenceGeometryTransform;
+      if (segmentationNode->GetParentTransformNode() != scalarVolumeNode->GetParentTransformNode())
+        {
+        segmentationToReferenceGeometryTransform = vtkSmartPointer<vtkGeneralTransform>::New();
+        vtkMRMLTransformNode::GetTransformBetweenNodes(segmentationNode->GetParentTransformNode(),
+          scalarVolumeNode->GetParentTransformNode(), segmentationToReferenceGeometryTransform);
+        }
+
+      std::vector< vtkSmartPointer<vtkOrientedImageData> > resampledLabelmaps(numberOfSegments);
+      std::vector<vtkImageData*> referenceLabelmaps(numberOfSegments, static_cast<vtkImageData*>(NULL));
+      for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+        {
+        vtkOrientedImageData* labelmap = vtkOrientedImageData::SafeDownCast(labelmaps[segmentIndex]);
+        if (!labelmap)
+          {
+          continue;
+          }
+        if (segmentationToReferenceGeometryTransform.GetPointer() == NULL
+          && vtkOrientedImageDataResample::DoGeometriesMatch(labelmap, referenceGeometry))
+          {
+          referenceLabelmaps[segmentIndex] = labelmap;
+          continue;
+          }
+        resampledLabelmaps[segmentIndex] = vtkSmartPointer<vtkOrientedImageData>::New();
+        if (!vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(labelmap, referenceGeometry,
+          resampledLabelmaps[segmentIndex], false, false, segmentationToReferenceGeometryTransform))
+          {
+          vtkErrorWithObjectMacro(segmentationNode, "vtkSlicerSegmentationsModuleLogic::ComputeSegmentStatistics: Failed to resample segment "
+            << statisticsSegmentIDs[segmentIndex] << " to the geometry of the scalar volume");
+          continue;
+          }
+        referenceLabelmaps[segmentIndex] = resampledLabelmaps[segmentIndex];
+        }
+      ComputeSegmentVoxelStatistics(referenceLabelmaps, scalarVolumeNode->GetImageData(), statistics);
+
+      double* spacing = referenceGeometry->GetSpacing();
+      const double cubicMMPerVoxel = spacing[0] * spacing[1] * spacing[2];
+      const char* scalarColumnNames[7] = { "GS voxel count", "GS volume mm3", "GS volume cc", "GS min", "GS max", "GS mean", "GS stdev" };
+      vtkNew<vtkIdTypeArray> scalarVoxelCountColumn;
+      scalarVoxelCountColumn->SetName(scalarColumnNames[0]);
+      scalarVoxelCountColumn->SetNumberOfValues(numberOfSegments);
+      vtkSmartPointer<vtkDoubleArray> scalarColumns[6];
+      for (int columnIndex = 0; columnIndex < 6; ++columnIndex)
+        {
+        scalarColumns[columnIndex] = vtkSmartPointer<vtkDoubleArray>::New();
+        scalarColumns[columnIndex]->SetName(scalarColumnNames[columnIndex + 1]);
+        scalarColumns[columnIndex]->SetNumberOfValues(numberOfSegments);
+        }
+      for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+        {
+        const SegmentVoxelStatistics& segmentStatistics = statistics[segmentIndex];
+        scalarVoxelCountColumn->SetValue(segmentIndex, segmentStatistics.VoxelCount);
+        scalarColumns[0]->SetValue(segmentIndex, segmentStatistics.VoxelCount * cubicMMPerVoxel);
+        scalarColumns[1]->SetValue(segmentIndex, segmentStatistics.VoxelCount * cubicMMPerVoxel * ccPerCubicMM);
+        if (segmentStatistics.VoxelCount > 0)
+          {
+          const double mean = segmentStatistics.Sum / segmentStatistics.VoxelCount;
+          // sample standard deviation, as in vtkImageAccumulate
+          double variance = 0.0;
+          if (segmentStatistics.VoxelCount > 1)
+            {
+            variance = (segmentStatistics.SumOfSquares - mean * segmentStatistics.Sum) / (segmentStatistics.VoxelCount - 1);
+            }
+          scalarColumns[2]->SetValue(segmentIndex, segmentStatistics.Min);
+          scalarColumns[3]->SetValue(segmentIndex, segmentStatistics.Max);
+          scalarColumns[4]->SetValue(segmentIndex, mean);
+          scalarColumns[5]->SetValue(segmentIndex, sqrt(std::max(variance, 0.0)));
+          }
+        else
+          {
+          // not available
+          for (int columnIndex = 2; columnIndex < 6; ++columnIndex)
+            {
+            scalarColumns[columnIndex]->SetValue(segmentIndex, vtkMath::Nan());
+            }
+          }
+        }
+      table->AddColumn(scalarVoxelCountColumn.GetPointer());
+      for (int columnIndex = 0; columnIndex < 6; ++columnIndex)
+        {
+        table->AddColumn(scalarColumns[columnIndex]);
+        }
+      }
+    }
+
+  std::string closedSurfaceName = vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName();
+  if (segmentation->ContainsRepresentation(closedSurfaceName))
+    {
+    // Closed surface statistics
+    vtkNew<vtkDoubleArray> surfaceAreaColumn;
+    surfaceAreaColumn->SetName("CS surface mm2");
+    surfaceAreaColumn->SetNumberOfValues(numberOfSegments);
+    vtkNew<vtkDoubleArray> volumeMm3Column;
+    volumeMm3Column->SetName("CS volume mm3");
+    volumeMm3Column->SetNumberOfValues(numberOfSegments);
+    vtkNew<vtkDoubleArray> volumeCcColumn;
+    volumeCcColumn->SetName("CS volume cc");
+    volumeCcColumn->SetNumberOfValues(numberOfSegments);
+    vtkNew<vtkMassProperties> massProperties;
+    for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+      {
+      vtkSegment* segment = segmentation->GetSegment(statisticsSegmentIDs[segmentIndex]);
+      vtkPolyData* closedSurface = segment ? vtkPolyData::SafeDownCast(segment->GetRepresentation(closedSurfaceName)) : NULL;
+      double surfaceArea = 0.0;
+      double volume = 0.0;
+      if (closedSurface && closedSurface->GetNumberOfPolys() > 0)
+        {
+        massProperties->SetInputData(closedSurface);
+        massProperties->Update();
+        surfaceArea = massProperties->GetSurfaceArea();
+        volume = massProperties->GetVolume();
+        }
+      surfaceAreaColumn->SetValue(segmentIndex, surfaceArea);
+      volumeMm3Column->SetValue(segmentIndex, volume);
+      volumeCcColumn->SetValue(segmentIndex, volume * ccPerCubicMM);
+      }
+    massProperties->SetInputData(NULL);
+    table->AddColumn(surfaceAreaColumn.GetPointer());
+    table->AddColumn(volumeMm3Column.GetPointer());
+    table->AddColumn(volumeCcColumn.GetPointer());
+    }
+
+  tableNode->Modified();
+  tableNode->EndModify(wasModified);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template <class T>
+void BooleanOperationCopyToMask(vtkImageData* labelmap, T*, vtkImageData* mask, const int extent[6])
+{
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      const T* labelPtr = static_cast<T*>(labelmap->GetScalarPointer(extent[0], j, k));
+      unsigned char* maskPtr = static_cast<unsigned char*>(mask->GetScalarPointer(extent[0], j, k));
+      const int rowLength = extent[1] - extent[0] + 1;
+      for (int i = 0; i < rowLength; ++i)
+        {
+        maskPtr[i] = (labelPtr[i] > 0 ? 1 : 0);
+        }
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Combine modifier labelmap with the 0/1 mask within the extent.
+/// The operation is selected for each row, so that the inner loops are simple byte operations
+/// that the compiler can vectorize.
+template <class T>
+void BooleanOperationApplyToMask(vtkImageData* modifierLabelmap, T*, vtkImageData* mask, const int extent[6], int operation)
+{
+  const int rowLength = extent[1] - extent[0] + 1;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      const T* modifierPtr = static_cast<T*>(modifierLabelmap->GetScalarPointer(extent[0], j, k));
+      unsigned char* maskPtr = static_cast<unsigned char*>(mask->GetScalarPointer(extent[0], j, k));
+      switch (operation)
+        {
+        case vtkSlicerSegmentationsModuleLogic::BOOLEAN_UNION:
+          for (int i = 0; i < rowLength; ++i)
+            {
+            maskPtr[i] |= (modifierPtr[i] > 0 ? 1 : 0);
+            }
+          break;
+        case vtkSlicerSegmentationsModuleLogic::BOOLEAN_INTERSECT:
+          for (int i = 0; i < rowLength; ++i)
+            {
+            maskPtr[i] &= (modifierPtr[i] > 0 ? 1 : 0);
+            }
+          break;
+        case vtkSlicerSegmentationsModuleLogic::BOOLEAN_SUBTRACT:
+          for (int i = 0; i < rowLength; ++i)
+            {
+            maskPtr[i] &= (modifierPtr[i] > 0 ? 0 : 1);
+            }
+          break;
+        default:
+          break;
+        }
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerSegmentationsModuleLogic::GetBooleanOperationResult(vtkMRMLSegmentationNode* segmentationNode, std::string segmentID,
+  int operation, vtkStringArray* modifierSegmentIDs, vtkOrientedImageData* outputLabelmap)
+{
+  if (!segmentationNode || !segmentationNode->GetSegmentation() || !modifierSegmentIDs || !outputLabelmap
+    || operation < BOOLEAN_UNION || operation > BOOLEAN_SUBTRACT)
+    {
+    vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::GetBooleanOperationResult: Invalid inputs");
+    return false;
+    }
+  vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
+  std::string binaryLabelmapName = vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName();
+  vtkSegment* segment = segmentation->GetSegment(segmentID);
+  vtkOrientedImageData* segmentLabelmap = segment ? vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(binaryLabelmapName)) : NULL;
+  if (!segmentLabelmap)
+    {
+    vtkErrorWithObjectMacro(segmentationNode, "vtkSlicerSegmentationsModuleLogic::GetBooleanOperationResult: Failed to get binary labelmap of segment " << segmentID);
+    return false;
+    }
+
+  // Get modifier labelmaps in the geometry of the segment. Labelmaps are only resampled if their geometry is different.
+  std::vector< vtkSmartPointer<vtkOrientedImageData> > modifierLabelmaps;
+  for (vtkIdType modifierIndex = 0; modifierIndex < modifierSegmentIDs->GetNumberOfValues(); ++modifierIndex)
+    {
+    std::string modifierSegmentID = modifierSegmentIDs->GetValue(modifierIndex);
+    vtkSegment* modifierSegment = segmentation->GetSegment(modifierSegmentID);
+    vtkOrientedImageData* modifierLabelmap = modifierSegment ?
+      vtkOrientedImageData::SafeDownCast(modifierSegment->GetRepresentation(binaryLabelmapName)) : NULL;
+    if (!modifierLabelmap || !modifierLabelmap->GetPointData()->GetScalars())
+      {
+      vtkErrorWithObjectMacro(segmentationNode, "vtkSlicerSegmentationsModuleLogic::GetBooleanOperationResult: Failed to get binary labelmap of segment " << modifierSegmentID);
+      return false;
+      }
+    if (vtkOrientedImageDataResample::DoGeometriesMatch(segmentLabelmap, modifierLabelmap))
+      {
+      modifierLabelmaps.push_back(modifierLabelmap);
+      continue;
+      }
+    vtkSmartPointer<vtkOrientedImageData> resampledModifierLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+    if (!vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(modifierLabelmap, segmentLabelmap,
+      resampledModifierLabelmap, false /*interpolate*/, true /*pad*/))
+      {
+      vtkErrorWithObjectMacro(segmentationNode, "vtkSlicerSegmentationsModuleLogic::GetBooleanOperationResult: Failed to resample segment " << modifierSegmentID);
+      return false;
+      }
+    modifierLabelmaps.push_back(resampledModifierLabelmap);
+    }
+
+  // Extent of the result
+  int segmentExtent[6] = {0,-1,0,-1,0,-1};
+  if (segmentLabelmap->GetPointData()->GetScalars())
+    {
+    segmentLabelmap->GetExtent(segmentExtent);
+    }
+  int resultExtent[6] = {0,-1,0,-1,0,-1};
+  std::copy(segmentExtent, segmentExtent + 6, resultExtent);
+  bool resultEmpty = (resultExtent[0] > resultExtent[1] || resultExtent[2] > resultExtent[3] || resultExtent[4] > resultExtent[5]);
+  for (std::vector< vtkSmartPointer<vtkOrientedImageData> >::iterator modifierIt = modifierLabelmaps.begin();
+    modifierIt != modifierLabelmaps.end(); ++modifierIt)
+    {
+    int* modifierExtent = (*modifierIt)->GetExtent();
+    bool modifierEmpty = (modifierExtent[0] > modifierExtent[1] || modifierExtent[2] > modifierExtent[3] || modifierExtent[4] > modifierExtent[5]);
+    if (operation == BOOLEAN_UNION)
+      {
+      if (modifierEmpty)
+        {
+        continue;
+        }
+      for (int i = 0; i < 3; ++i)
+        {
+        resultExtent[i * 2] = resultEmpty ? modifierExtent[i * 2] : std::min(resultExtent[i * 2], modifierExtent[i * 2]);
+        resultExtent[i * 2 + 1] = resultEmpty ? modifierExtent[i * 2 + 1] : std::max(resultExtent[i * 2 + 1], modifierExtent[i * 2 + 1]);
+        }
+      resultEmpty = false;
+      }
+    else if (operation == BOOLEAN_INTERSECT)
+      {
+      for (int i = 0; i < 3; ++i)
+        {
+        resultExtent[i * 2] = std::max(resultExtent[i * 2], modifierExtent[i * 2]);
+        resultExtent[i * 2 + 1] = std::min(resultExtent[i * 2 + 1], modifierExtent[i * 2 + 1]);
+        }
+      resultEmpty = resultEmpty || modifierEmpty
+        || resultExtent[0] > resultExtent[1] || resultExtent[2] > resultExtent[3] || resultExtent[4] > resultExtent[5];
+      }
+    }
+
+  vtkSmartPointer<vtkMatrix4x4> imageToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+  segmentLabelmap->GetImageToWorldMatrix(imageToWorldMatrix);
+  outputLabelmap->Initialize();
+  if (resultEmpty)
+    {
+    // Intersection is empty: the result is an empty segment in the extent of the segment
+    std::copy(segmentExtent, segmentExtent + 6, resultExtent);
+    }
+  outputLabelmap->SetExtent(resultExtent);
+  outputLabelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  outputLabelmap->SetImageToWorldMatrix(imageToWorldMatrix);
+  vtkOrientedImageDataResample::FillImage(outputLabelmap, 0);
+  if (resultEmpty)
+    {
+    return true;
+    }
+
+  // Start from the segment
+  int commonExtent[6] = {0,-1,0,-1,0,-1};
+  for (int i = 0; i < 3; ++i)
+    {
+    commonExtent[i * 2] = std::max(resultExtent[i * 2], segmentExtent[i * 2]);
+    commonExtent[i * 2 + 1] = std::min(resultExtent[i * 2 + 1], segmentExtent[i * 2 + 1]);
+    }
+  if (commonExtent[0] <= commonExtent[1] && commonExtent[2] <= commonExtent[3] && commonExtent[4] <= commonExtent[5])
+    {
+    switch (segmentLabelmap->GetScalarType())
+      {
+      vtkTemplateMacro(BooleanOperationCopyToMask(segmentLabelmap, static_cast<VTK_TT*>(NULL), outputLabelmap, commonExtent));
+      default:
+        vtkErrorWithObjectMacro(segmentationNode, "vtkSlicerSegmentationsModuleLogic::GetBooleanOperationResult: Unknown scalar type");
+        return false;
+      }
+    }
+
+  // Apply modifiers. Outside the extent of a modifier union and subtraction do not change the result,
+  // and the result extent of an intersection is inside the extent of all modifiers.
+  for (std::vector< vtkSmartPointer<vtkOrientedImageData> >::iterator modifierIt = modifierLabelmaps.begin();
+    modifierIt != modifierLabelmaps.end(); ++modifierIt)
+    {
+    int* modifierExtent = (*modifierIt)->GetExtent();
+    for (int i = 0; i < 3; ++i)
+      {
+      commonExtent[i * 2] = std::max(resultExtent[i * 2], modifierExtent[i * 2]);
+      commonExtent[i * 2 + 1] = std::min(resultExtent[i * 2 + 1], modifierExtent[i * 2 + 1]);
+      }
+    if (commonExtent[0] > commonExtent[1] || commonExtent[2] > commonExtent[3] || commonExtent[4] > commonExtent[5])
+      {
+      continue;
+      }
+    switch ((*modifierIt)->GetScalarType())
+      {
+      vtkTemplateMacro(BooleanOperationApplyToMask((*modifierIt).GetPointer(), static_cast<VTK_TT*>(NULL), outputLabelmap, commonExtent, operation));
+      default:
+        vtkErrorWithObjectMacro(segmentationNode, "vtkSlicerSegmentationsModuleLogic::GetBooleanOperationResult: Unknown scalar type");
+        return false;
+      }
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerSegmentationsModuleLogic::ApplyBooleanOperation(vtkMRMLSegmentationNode* segmentationNode, std::string segmentID,
+  int operation, vtkStringArray* modifierSegmentIDs)
+{
+  vtkSmartPointer<vtkOrientedImageData> resultLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+  if (!vtkSlicerSegmentationsModuleLogic::GetBooleanOperationResult(segmentationNode, segmentID, operation, modifierSegmentIDs, resultLabelmap))
+    {
+    return false;
+    }
+  return vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(resultLabelmap, segmentationNode, segmentID,
+    MODE_REPLACE, resultLabelmap->GetExtent());
+}
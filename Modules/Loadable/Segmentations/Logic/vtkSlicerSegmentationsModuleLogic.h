@@ -38,9 +38,11 @@ class vtkOrientedImageData;
 class vtkPolyData;
 class vtkDataObject;
 class vtkGeneralTransform;
+class vtkStringArray;
 
 class vtkMRMLScalarVolumeNode;
 class vtkMRMLSegmentationStorageNode;
+class vtkMRMLTableNode;
 class vtkMRMLLabelMapVolumeNode;
 class vtkMRMLModelNode;
 class vtkMRMLVolumeNode;
@@ -219,6 +221,68 @@ public:
     };
   static bool SetBinaryLabelmapToSegment(vtkOrientedImageData* labelmap, vtkMRMLSegmentationNode* segmentationNode, std::string segmentID, int mergeMode=MODE_REPLACE, const int extent[6]=0);
 
+  /// Smooth non-overlapping segments jointly, so that no gaps or overlaps are created between them.
+  /// Each segment is blurred using a Gaussian filter and each voxel is assigned to the segment
+  /// (or the background) with the highest blurred value. Only the bounding box of each segment,
+  /// padded by the kernel radius, is processed, and no per-segment volume of the full extent is created.
+  /// Segments are modified directly (masking settings of the segment editor are not used).
+  /// \param standardDeviationMm Standard deviation of the Gaussian kernel, in millimeters
+  /// \param segmentIDs Segments to smooth. All segments are smoothed if NULL.
+  /// 
+eturn Success flag
+  /// Set the content of multiple segments from a labelmap in which the n-th segment is labeled n+1.
+  /// Each segment is replaced by the region of its label, cropped to its bounding box.
+  /// \param segmentIDs Segments corresponding to the label values. Segments must exist in the segmentation.
+  /// \param previousLabelmap If specified and it has the same extent and scalar type as the labelmap,
+  ///   then only the segments that have voxels that are labeled differently in the two labelmaps are updated.
+  ///   This allows cheap update of a segmentation from the output of a filter that is run repeatedly
+  ///   (auto-complete preview, for example).
+  /// \return Success flag
+  static bool SetLabelmapToSegments(vtkOrientedImageData* labelmap, vtkMRMLSegmentationNode* segmentationNode,
+    vtkStringArray* segmentIDs, vtkOrientedImageData* previousLabelmap=NULL);
+
+  static bool SmoothSegmentsJointly(vtkMRMLSegmentationNode* segmentationNode, double standardDeviationMm, vtkStringArray* segmentIDs=NULL);
+
+  /// Boolean operations between segments
+  enum
+    {
+    BOOLEAN_UNION = 0,
+    BOOLEAN_INTERSECT,
+    BOOLEAN_SUBTRACT
+    };
+
+  /// Combine a segment with multiple modifier segments using a boolean operation, without modifying the segment.
+  /// Modifier segments are resampled to the geometry of the segment only if their geometry is different.
+  /// The result is computed in one step on the binary labelmaps, and not through
+  /// a separate merge (and resampling) for each modifier segment.
+  /// \param operation BOOLEAN_UNION adds all modifier segments, BOOLEAN_INTERSECT keeps only voxels that are
+  ///   in all modifier segments, BOOLEAN_SUBTRACT removes all modifier segments.
+  /// \param outputLabelmap Result, a 0/1 unsigned char labelmap in the geometry of the segment.
+  /// \return Success flag
+  static bool GetBooleanOperationResult(vtkMRMLSegmentationNode* segmentationNode, std::string segmentID,
+    int operation, vtkStringArray* modifierSegmentIDs, vtkOrientedImageData* outputLabelmap);
+
+  /// Replace a segment by the result of a boolean operation with multiple modifier segments.
+  /// Segment is modified directly (masking settings of the segment editor are not used).
+  /// \sa GetBooleanOperationResult
+  static bool ApplyBooleanOperation(vtkMRMLSegmentationNode* segmentationNode, std::string segmentID,
+    int operation, vtkStringArray* modifierSegmentIDs);
+
+  /// Compute statistics of segments and write them into a table, one row for each segment.
+  /// Labelmap statistics ("LM ..." columns) are computed if the segmentation contains binary labelmap representation,
+  /// scalar volume statistics ("GS ..." columns) if a scalar volume is specified as well, and closed surface statistics
+  /// ("CS ..." columns) if the segmentation contains closed surface representation.
+  /// Voxel statistics of all segments are computed in one multi-threaded pass: slices are distributed
+  /// between the threads, which accumulate statistics of all segments separately, and the results are merged at the end.
+  /// Segments are only resampled if their geometry does not match the geometry of the scalar volume.
+  /// Scalar statistics that are not available (for empty segments) are set to NaN.
+  /// \param scalarVolumeNode Volume for intensity statistics. Intensity statistics are not computed if NULL.
+  /// \param tableNode Output table. Existing columns are removed.
+  /// \param segmentIDs Segments to compute statistics for. All segments are used if NULL.
+  /// \return Success flag
+  static bool ComputeSegmentStatistics(vtkMRMLSegmentationNode* segmentationNode, vtkMRMLScalarVolumeNode* scalarVolumeNode,
+    vtkMRMLTableNode* tableNode, vtkStringArray* segmentIDs=NULL);
+
 protected:
   virtual void SetMRMLSceneInternal(vtkMRMLScene * newScene);
 
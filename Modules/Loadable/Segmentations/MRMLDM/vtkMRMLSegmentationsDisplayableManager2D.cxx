@@ -29,6 +29,7 @@
 #include <vtkMRMLTransformNode.h>
 
 // MRML logic includes
+#include "vtkAcceleratedPlaneCutter.h"
 #include "vtkImageLabelOutline.h"
 
 // SegmentationCore includes
@@ -50,11 +51,9 @@
 #include <vtkRenderer.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
-#include <vtkPointLocator.h>
 #include <vtkGeneralTransform.h>
 #include <vtkPointData.h>
 #include <vtkDataSetAttributes.h>
-#include <vtkCutter.h>
 #include <vtkImageReslice.h>
 #include <vtkImageMapper.h>
 #include <vtkImageMapToRGBA.h>
@@ -118,6 +117,43 @@ void SnapToPermuteMatrix(vtkTransform* transform)
     }
 }
 
+//---------------------------------------------------------------------------
+// Restrict a slice extent to the region where an image may appear.
+// The corners of the image extent are mapped to slice XY coordinates using
+// the inverse of the linear slice to image transform and the slice extent
+// is cropped to their bounding box, padded by margin pixels.
+// Reslicing only this region makes the cost of displaying a segment
+// proportional to its footprint in the view instead of the view size.
+//----------------------------------------------------------------------------
+void CropSliceExtentToImage(vtkTransform* sliceToImageTransform, int imageExtent[6], int margin, int sliceExtent[6])
+{
+  vtkNew<vtkMatrix4x4> imageToSliceMatrix;
+  vtkMatrix4x4::Invert(sliceToImageTransform->GetMatrix(), imageToSliceMatrix.GetPointer());
+  double bounds[4] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+  for (int corner=0; corner<8; corner++)
+    {
+    double point_Image[4] =
+      {
+      (corner & 1) ? imageExtent[1]+0.5 : imageExtent[0]-0.5,
+      (corner & 2) ? imageExtent[3]+0.5 : imageExtent[2]-0.5,
+      (corner & 4) ? imageExtent[5]+0.5 : imageExtent[4]-0.5,
+      1.0
+      };
+    double point_Slice[4] = { 0.0, 0.0, 0.0, 1.0 };
+    imageToSliceMatrix->MultiplyPoint(point_Image, point_Slice);
+    for (int i=0; i<2; i++)
+      {
+      bounds[i*2] = std::min(bounds[i*2], point_Slice[i]);
+      bounds[i*2+1] = std::max(bounds[i*2+1], point_Slice[i]);
+      }
+    }
+  for (int i=0; i<2; i++)
+    {
+    sliceExtent[i*2] = std::max(sliceExtent[i*2], int(floor(bounds[i*2])) - margin);
+    sliceExtent[i*2+1] = std::min(sliceExtent[i*2+1], int(ceil(bounds[i*2+1])) + margin);
+    }
+}
+
 //---------------------------------------------------------------------------
 class vtkMRMLSegmentationsDisplayableManager2D::vtkInternal
 {
@@ -137,7 +173,7 @@ public:
       // Create poly data pipeline
       this->PolyDataOutlineActor = vtkSmartPointer<vtkActor2D>::New();
       this->PolyDataFillActor = vtkSmartPointer<vtkActor2D>::New();
-      this->Cutter = vtkSmartPointer<vtkCutter>::New();
+      this->Cutter = vtkSmartPointer<vtkAcceleratedPlaneCutter>::New();
       this->ModelWarper = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
       this->Plane = vtkSmartPointer<vtkPlane>::New();
       this->Stripper = vtkSmartPointer<vtkStripper>::New();
@@ -146,8 +182,7 @@ public:
 
       // Set up poly data outline pipeline
       this->Cutter->SetInputConnection(this->ModelWarper->GetOutputPort());
-      this->Cutter->SetCutFunction(this->Plane);
-      this->Cutter->SetGenerateCutScalars(0);
+      this->Cutter->SetPlane(this->Plane);
       vtkSmartPointer<vtkTransformPolyDataFilter> polyDataOutlineTransformer = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
       polyDataOutlineTransformer->SetInputConnection(this->Cutter->GetOutputPort());
       polyDataOutlineTransformer->SetTransform(this->WorldToSliceTransform);
@@ -238,7 +273,7 @@ public:
     vtkSmartPointer<vtkActor2D> PolyDataFillActor;
     vtkSmartPointer<vtkTransformPolyDataFilter> ModelWarper;
     vtkSmartPointer<vtkPlane> Plane;
-    vtkSmartPointer<vtkCutter> Cutter;
+    vtkSmartPointer<vtkAcceleratedPlaneCutter> Cutter;
     vtkSmartPointer<vtkStripper> Stripper;
     vtkSmartPointer<vtkCleanPolyData> Cleaner;
     vtkSmartPointer<vtkTriangleFilter> TriangleFilter;
@@ -293,6 +328,7 @@ public:
   bool UseDisplayableNode(vtkMRMLSegmentationNode* node);
   void ClearDisplayableNodes();
   bool IsSegmentVisibleInCurrentSlice(vtkMRMLSegmentationDisplayNode* displayNode, const Pipeline* pipeline, const std::string &segmentID);
+  bool IsModifiedRegionVisibleInCurrentSlice(vtkMRMLSegmentationNode* segmentationNode, const std::string &segmentID);
 
 private:
   vtkSmartPointer<vtkMatrix4x4> SliceXYToRAS;
@@ -710,11 +746,12 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
     bool segmentFillVisible = displayNodeVisible && properties.Visible
       && properties.Visible2DFill && displayNode->GetVisibility2DFill();
 
-    // Get representation to display
-    vtkPolyData* polyData = vtkPolyData::SafeDownCast(
-      segmentation->GetSegmentRepresentation(pipelineIt->first, shownRepresenatationName));
-    vtkOrientedImageData* imageData = vtkOrientedImageData::SafeDownCast(
-      segmentation->GetSegmentRepresentation(pipelineIt->first, shownRepresenatationName));
+    // Get representation to display. Representations of hidden segments are not
+    // requested, so that the evicted ones are not generated again.
+    vtkDataObject* representation = (segmentOutlineVisible || segmentFillVisible) ?
+      segmentation->GetSegmentRepresentation(pipelineIt->first, shownRepresenatationName) : NULL;
+    vtkPolyData* polyData = vtkPolyData::SafeDownCast(representation);
+    vtkOrientedImageData* imageData = vtkOrientedImageData::SafeDownCast(representation);
     if (imageData)
       {
       int* imageExtent = imageData->GetExtent();
@@ -768,17 +805,6 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
       vtkMatrix4x4::Invert(this->SliceXYToRAS, rasToSliceXY.GetPointer());
       pipeline->WorldToSliceTransform->SetMatrix(rasToSliceXY.GetPointer());
 
-      // Optimization for slice to slice intersections which are 1 quad polydatas
-      // no need for 50^3 default locator divisions
-      if (polyData->GetPoints() != NULL && polyData->GetNumberOfPoints() <= 4 )
-        {
-        vtkNew<vtkPointLocator> locator;
-        double *bounds = polyData->GetBounds();
-        locator->SetDivisions(2,2,2);
-        locator->InitPointInsertion(polyData->GetPoints(), bounds);
-        pipeline->Cutter->SetLocator(locator.GetPointer());
-        }
-
       // Apply trick to create cell from line for poly data fill
       // Omit cells that are not closed (first point is not same as last)
       pipeline->Stripper->SetMaximumLength(10000);
@@ -881,7 +907,9 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
       // to a linear transform.
       // Also attempt to make it a permute transform, as it makes reslicing even faster.
       vtkSmartPointer<vtkTransform> linearSliceToImageTransform = vtkSmartPointer<vtkTransform>::New();
-      if (vtkMRMLTransformNode::IsGeneralTransformLinear(pipeline->SliceToImageTransform, linearSliceToImageTransform))
+      bool sliceToImageTransformLinear =
+        vtkMRMLTransformNode::IsGeneralTransformLinear(pipeline->SliceToImageTransform, linearSliceToImageTransform);
+      if (sliceToImageTransformLinear)
         {
         SnapToPermuteMatrix(linearSliceToImageTransform);
         pipeline->Reslice->SetResliceTransform(linearSliceToImageTransform);
@@ -910,6 +938,19 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
       int dimensions[3] = { 0, 0, 0 };
       this->SliceNode->GetDimensions(dimensions);
       int sliceOutputExtent[6] = { 0, dimensions[0] - 1, 0, dimensions[1] - 1, 0, dimensions[2] - 1 };
+      if (sliceToImageTransformLinear)
+        {
+        // Only reslice the region of the view that the segment covers (with a margin for the outline).
+        // The image mappers place the cropped image at its extent, so the actor position remains (0,0).
+        CropSliceExtentToImage(linearSliceToImageTransform, imageData->GetExtent(),
+          displayNode->GetSliceIntersectionThickness() + 1, sliceOutputExtent);
+        if (sliceOutputExtent[0] > sliceOutputExtent[1] || sliceOutputExtent[2] > sliceOutputExtent[3])
+          {
+          pipeline->ImageOutlineActor->SetVisibility(false);
+          pipeline->ImageFillActor->SetVisibility(false);
+          continue;
+          }
+        }
       pipeline->Reslice->SetOutputExtent(sliceOutputExtent);
 
       // If ThresholdValue is not specified, then do not perform thresholding
@@ -1177,6 +1218,86 @@ void vtkMRMLSegmentationsDisplayableManager2D::OnMRMLSceneNodeRemoved(vtkMRMLNod
     }
 }
 
+//---------------------------------------------------------------------------
+bool vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::IsModifiedRegionVisibleInCurrentSlice(
+  vtkMRMLSegmentationNode* segmentationNode, const std::string &segmentID)
+{
+  vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
+  if (!segmentation)
+    {
+    return true;
+    }
+  int* modifiedExtent = segmentation->GetModifiedExtent();
+  if (modifiedExtent[0] > modifiedExtent[1] || modifiedExtent[2] > modifiedExtent[3] || modifiedExtent[4] > modifiedExtent[5])
+    {
+    // the whole segment may have changed
+    return true;
+    }
+  vtkSegment* segment = segmentation->GetSegment(segmentID);
+  vtkOrientedImageData* labelmap = (segment ? vtkOrientedImageData::SafeDownCast(
+    segment->GetRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName())) : NULL);
+  if (!labelmap)
+    {
+    return true;
+    }
+
+  // Bounds of the modified region in the segmentation coordinate system, padded by a voxel
+  // to account for interpolation and outline extraction
+  vtkNew<vtkMatrix4x4> imageToSegmentMatrix;
+  labelmap->GetImageToWorldMatrix(imageToSegmentMatrix.GetPointer());
+  double regionBounds_Segment[6] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+  for (int corner = 0; corner < 8; ++corner)
+    {
+    double point_Image[4] =
+      {
+      (corner & 1) ? modifiedExtent[1] + 1.0 : modifiedExtent[0] - 1.0,
+      (corner & 2) ? modifiedExtent[3] + 1.0 : modifiedExtent[2] - 1.0,
+      (corner & 4) ? modifiedExtent[5] + 1.0 : modifiedExtent[4] - 1.0,
+      1.0
+      };
+    double point_Segment[4] = { 0.0, 0.0, 0.0, 1.0 };
+    imageToSegmentMatrix->MultiplyPoint(point_Image, point_Segment);
+    for (int i = 0; i < 3; ++i)
+      {
+      regionBounds_Segment[i * 2] = std::min(regionBounds_Segment[i * 2], point_Segment[i]);
+      regionBounds_Segment[i * 2 + 1] = std::max(regionBounds_Segment[i * 2 + 1], point_Segment[i]);
+      }
+    }
+
+  vtkNew<vtkMatrix4x4> rasToSliceXY;
+  vtkMatrix4x4::Invert(this->SliceXYToRAS, rasToSliceXY.GetPointer());
+  const double slicePositionTolerance = 0.1;
+  std::set<vtkMRMLSegmentationDisplayNode*>& displayNodes = this->SegmentationToDisplayNodes[segmentationNode];
+  for (std::set<vtkMRMLSegmentationDisplayNode*>::iterator dnodesIter = displayNodes.begin(); dnodesIter != displayNodes.end(); ++dnodesIter)
+    {
+    PipelinesCacheType::iterator pipelinesIter = this->DisplayPipelines.find(*dnodesIter);
+    if (pipelinesIter == this->DisplayPipelines.end())
+      {
+      continue;
+      }
+    // Other representations are re-converted from the whole segment
+    if ((*dnodesIter)->GetDisplayRepresentationName2D() != vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName())
+      {
+      return true;
+      }
+    PipelineMapType::iterator pipelineIt = pipelinesIter->second.find(segmentID);
+    if (pipelineIt == pipelinesIter->second.end())
+      {
+      return true;
+      }
+    vtkSmartPointer<vtkGeneralTransform> segmentationToSliceTransform = vtkSmartPointer<vtkGeneralTransform>::New();
+    segmentationToSliceTransform->Concatenate(rasToSliceXY.GetPointer());
+    segmentationToSliceTransform->Concatenate(pipelineIt->second->NodeToWorldTransform);
+    double regionBounds_Slice[6] = { 0 };
+    vtkOrientedImageDataResample::TransformBounds(regionBounds_Segment, segmentationToSliceTransform, regionBounds_Slice);
+    if (regionBounds_Slice[4] <= slicePositionTolerance && regionBounds_Slice[5] >= -slicePositionTolerance)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLSegmentationsDisplayableManager2D::ProcessMRMLNodesEvents(vtkObject* caller, unsigned long event, void* callData)
 {
@@ -1201,6 +1322,11 @@ void vtkMRMLSegmentationsDisplayableManager2D::ProcessMRMLNodesEvents(vtkObject*
         this->RequestRender();
         }
       }
+    else if (event == vtkSegmentation::RepresentationModified && callData
+      && !this->Internal->IsModifiedRegionVisibleInCurrentSlice(displayableNode, reinterpret_cast<const char*>(callData)))
+      {
+      // Only voxels that are not displayed in this slice view have changed
+      }
     else if ( (event == vtkMRMLDisplayableNode::TransformModifiedEvent)
            || (event == vtkMRMLTransformableNode::TransformModifiedEvent)
            || (event == vtkSegmentation::RepresentationModified)
@@ -458,6 +458,9 @@ void vtkMRMLSegmentationsDisplayableManager3D::vtkInternal::UpdateDisplayNodePip
     pipeline->Actor->SetVisibility(segmentVisible);
     if (!segmentVisible)
       {
+      // Do not keep a reference to the representation of hidden segments
+      // so that it can be evicted from the segmentation
+      pipeline->InputPolyData->Initialize();
       continue;
       }
 
@@ -36,6 +36,10 @@
 #include <vtkNew.h>
 #include <vtkSmartPointer.h>
 #include <vtkObjectFactory.h>
+#include <vtkStringArray.h>
+
+// STD includes
+#include <map>
 
 //----------------------------------------------------------------------------
 const char* vtkSlicerSubjectHierarchyModuleLogic::CLONED_SUBJECT_HIERARCHY_NODE_NAME_POSTFIX = " Copy";
@@ -93,59 +97,59 @@ void vtkSlicerSubjectHierarchyModuleLogic::UpdateFromMRMLScene()
 }
 
 //---------------------------------------------------------------------------
-vtkMRMLSubjectHierarchyNode* vtkSlicerSubjectHierarchyModuleLogic::InsertDicomSeriesInHierarchy(
-  vtkMRMLScene *scene, const char* patientId, const char* studyInstanceUID, const char* seriesInstanceUID )
+namespace
 {
-  if ( !scene || !patientId || !studyInstanceUID || !seriesInstanceUID )
-    {
-    vtkGenericWarningMacro("vtkSlicerSubjectHierarchyModuleLogic::InsertDicomSeriesInHierarchy: Invalid input arguments!");
-    return NULL;
-    }
-
-  vtkMRMLSubjectHierarchyNode* patientNode = NULL;
-  vtkMRMLSubjectHierarchyNode* studyNode = NULL;
-  std::vector<vtkMRMLSubjectHierarchyNode*> seriesNodes;
+typedef std::map<std::string, std::vector<vtkMRMLSubjectHierarchyNode*> > DicomUIDToNodesType;
 
+//---------------------------------------------------------------------------
+/// Collect subject hierarchy nodes by DICOM UID in one pass over the scene
+void GetSubjectHierarchyNodesByDicomUID(vtkMRMLScene* scene, DicomUIDToNodesType& nodesByUID)
+{
   std::vector<vtkMRMLNode*> subjectHierarchyNodes;
-  unsigned int numberOfNodes = scene->GetNodesByClass("vtkMRMLHierarchyNode", subjectHierarchyNodes);
-
-  // Find referenced nodes
+  unsigned int numberOfNodes = scene->GetNodesByClass("vtkMRMLSubjectHierarchyNode", subjectHierarchyNodes);
   for (unsigned int i=0; i<numberOfNodes; i++)
     {
     vtkMRMLSubjectHierarchyNode *node = vtkMRMLSubjectHierarchyNode::SafeDownCast(subjectHierarchyNodes[i]);
-    if ( node && node->IsA("vtkMRMLSubjectHierarchyNode") )
+    if (!node)
       {
-      std::string nodeDicomUIDStr = node->GetUID(vtkMRMLSubjectHierarchyConstants::GetDICOMUIDName());
-      const char* nodeDicomUID = nodeDicomUIDStr.c_str();
-      if (!nodeDicomUID)
-        {
-        // Having a UID is not mandatory
-        continue;
-        }
-      if (!strcmp(patientId, nodeDicomUID))
-        {
-        patientNode = node;
-        }
-      else if (!strcmp(studyInstanceUID, nodeDicomUID))
-        {
-        studyNode = node;
-        }
-      else if (!strcmp(seriesInstanceUID, nodeDicomUID))
-        {
-        seriesNodes.push_back(node);
-        }
+      continue;
       }
+    // Having a UID is not mandatory, nodes without DICOM UID are stored with empty UID
+    nodesByUID[node->GetUID(vtkMRMLSubjectHierarchyConstants::GetDICOMUIDName())].push_back(node);
+    }
+}
+
+//---------------------------------------------------------------------------
+/// Get the node with the given DICOM UID (the last one in the scene if there are more)
+vtkMRMLSubjectHierarchyNode* GetNodeByDicomUID(DicomUIDToNodesType& nodesByUID, const std::string& uid)
+{
+  DicomUIDToNodesType::iterator nodesIt = nodesByUID.find(uid);
+  if (nodesIt == nodesByUID.end() || nodesIt->second.empty())
+    {
+    return NULL;
     }
+  return nodesIt->second.back();
+}
 
-  if (seriesNodes.empty())
+//---------------------------------------------------------------------------
+/// Place series in subject hierarchy using the given UID to nodes map, which is
+/// updated with the created patient and study nodes
+vtkMRMLSubjectHierarchyNode* InsertDicomSeriesInHierarchyUsingMap(vtkMRMLScene *scene, DicomUIDToNodesType& nodesByUID,
+  const char* patientId, const char* studyInstanceUID, const char* seriesInstanceUID)
+{
+  DicomUIDToNodesType::iterator seriesNodesIt = nodesByUID.find(seriesInstanceUID);
+  if (seriesNodesIt == nodesByUID.end() || seriesNodesIt->second.empty())
     {
     vtkErrorWithObjectMacro(scene,
       "vtkSlicerSubjectHierarchyModuleLogic::InsertDicomSeriesInHierarchy: Subject hierarchy node with DICOM UID '"
       << seriesInstanceUID << "' cannot be found!");
     return NULL;
     }
+  // Copy, as the map may be changed when adding patient and study nodes
+  std::vector<vtkMRMLSubjectHierarchyNode*> seriesNodes = seriesNodesIt->second;
 
   // Create patient and study nodes if they do not exist yet
+  vtkMRMLSubjectHierarchyNode* patientNode = GetNodeByDicomUID(nodesByUID, patientId);
   if (!patientNode)
     {
     patientNode = vtkMRMLSubjectHierarchyNode::New();
@@ -154,8 +158,14 @@ vtkMRMLSubjectHierarchyNode* vtkSlicerSubjectHierarchyModuleLogic::InsertDicomSe
     patientNode->SetOwnerPluginName("DICOM");
     scene->AddNode(patientNode);
     patientNode->Delete(); // Return ownership to the scene only
+    nodesByUID[patientId].push_back(patientNode);
     }
 
+  vtkMRMLSubjectHierarchyNode* studyNode = NULL;
+  if (strcmp(patientId, studyInstanceUID))
+    {
+    studyNode = GetNodeByDicomUID(nodesByUID, studyInstanceUID);
+    }
   if (!studyNode)
     {
     studyNode = vtkMRMLSubjectHierarchyNode::New();
@@ -165,6 +175,7 @@ vtkMRMLSubjectHierarchyNode* vtkSlicerSubjectHierarchyModuleLogic::InsertDicomSe
     studyNode->SetParentNodeID(patientNode->GetID());
     scene->AddNode(studyNode);
     studyNode->Delete(); // Return ownership to the scene only
+    nodesByUID[studyInstanceUID].push_back(studyNode);
     }
 
   // In some cases there might be multiple subject hierarchy nodes for the same DICOM series,
@@ -174,6 +185,10 @@ vtkMRMLSubjectHierarchyNode* vtkSlicerSubjectHierarchyModuleLogic::InsertDicomSe
   for (std::vector<vtkMRMLSubjectHierarchyNode*>::iterator seriesIt = seriesNodes.begin(); seriesIt != seriesNodes.end(); ++seriesIt)
   {
     vtkMRMLSubjectHierarchyNode* seriesNode = (*seriesIt);
+    if (seriesNode == patientNode || seriesNode == studyNode)
+      {
+      continue;
+      }
     seriesNode->SetParentNodeID(studyNode->GetID());
   }
 
@@ -186,6 +201,52 @@ vtkMRMLSubjectHierarchyNode* vtkSlicerSubjectHierarchyModuleLogic::InsertDicomSe
 
   return *(seriesNodes.begin());
 }
+}
+
+//---------------------------------------------------------------------------
+vtkMRMLSubjectHierarchyNode* vtkSlicerSubjectHierarchyModuleLogic::InsertDicomSeriesInHierarchy(
+  vtkMRMLScene *scene, const char* patientId, const char* studyInstanceUID, const char* seriesInstanceUID )
+{
+  if ( !scene || !patientId || !studyInstanceUID || !seriesInstanceUID )
+    {
+    vtkGenericWarningMacro("vtkSlicerSubjectHierarchyModuleLogic::InsertDicomSeriesInHierarchy: Invalid input arguments!");
+    return NULL;
+    }
+
+  DicomUIDToNodesType nodesByUID;
+  GetSubjectHierarchyNodesByDicomUID(scene, nodesByUID);
+  return InsertDicomSeriesInHierarchyUsingMap(scene, nodesByUID, patientId, studyInstanceUID, seriesInstanceUID);
+}
+
+//---------------------------------------------------------------------------
+int vtkSlicerSubjectHierarchyModuleLogic::InsertDicomSeriesListInHierarchy(
+  vtkMRMLScene *scene, vtkStringArray* patientIds, vtkStringArray* studyInstanceUIDs, vtkStringArray* seriesInstanceUIDs )
+{
+  if ( !scene || !patientIds || !studyInstanceUIDs || !seriesInstanceUIDs
+    || patientIds->GetNumberOfValues() != seriesInstanceUIDs->GetNumberOfValues()
+    || studyInstanceUIDs->GetNumberOfValues() != seriesInstanceUIDs->GetNumberOfValues() )
+    {
+    vtkGenericWarningMacro("vtkSlicerSubjectHierarchyModuleLogic::InsertDicomSeriesListInHierarchy: Invalid input arguments!");
+    return 0;
+    }
+
+  int numberOfInsertedSeries = 0;
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+
+  DicomUIDToNodesType nodesByUID;
+  GetSubjectHierarchyNodesByDicomUID(scene, nodesByUID);
+  for (vtkIdType seriesIndex=0; seriesIndex<seriesInstanceUIDs->GetNumberOfValues(); ++seriesIndex)
+    {
+    if ( InsertDicomSeriesInHierarchyUsingMap( scene, nodesByUID, patientIds->GetValue(seriesIndex).c_str(),
+      studyInstanceUIDs->GetValue(seriesIndex).c_str(), seriesInstanceUIDs->GetValue(seriesIndex).c_str() ) )
+      {
+      ++numberOfInsertedSeries;
+      }
+    }
+
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  return numberOfInsertedSeries;
+}
 
 //---------------------------------------------------------------------------
 vtkMRMLSubjectHierarchyNode* vtkSlicerSubjectHierarchyModuleLogic::AreNodesInSameBranch(vtkMRMLNode* node1, vtkMRMLNode* node2,
@@ -36,6 +36,7 @@
 
 class vtkMRMLSubjectHierarchyNode;
 class vtkMRMLTransformNode;
+class vtkStringArray;
 
 /// \ingroup Slicer_QtModules_SubjectHierarchy
 class VTK_SLICER_SUBJECTHIERARCHY_LOGIC_EXPORT vtkSlicerSubjectHierarchyModuleLogic :
@@ -56,6 +57,14 @@ public:
   static vtkMRMLSubjectHierarchyNode* InsertDicomSeriesInHierarchy(
     vtkMRMLScene* scene, const char* subjectId, const char* studyInstanceUID, const char* seriesInstanceUID );
 
+  /// Place multiple series in subject hierarchy. Create subject and study nodes if needed.
+  /// The scene is scanned only once and it is in batch processing state during the insertion,
+  /// so that the subject hierarchy views are updated only once at the end.
+  /// The arrays contain the subject ID, study and series instance UID of each series.
+  /// \return Number of series successfully inserted
+  static int InsertDicomSeriesListInHierarchy(
+    vtkMRMLScene* scene, vtkStringArray* subjectIds, vtkStringArray* studyInstanceUIDs, vtkStringArray* seriesInstanceUIDs );
+
   /// Determine if two subject hierarchy nodes are in the same branch (share the same parent)
   /// \param node1 First node to check. Can be subject hierarchy node or a node associated with one
   /// \param node2 Second node to check
@@ -32,6 +32,7 @@
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
 
 // MRML includes
 #include "vtkMRMLScene.h"
@@ -56,6 +57,7 @@ namespace
   bool TestTreeOperations();
   bool TestInsertDicomSeriesEmptyScene();
   bool TestInsertDicomSeriesPopulatedScene();
+  bool TestInsertDicomSeriesList();
   bool TestVisibilityOperations();
   bool TestTransformBranch();
 
@@ -269,6 +271,11 @@ namespace
       std::cerr << "'TestInsertDicomSeriesPopulatedScene' call not successful." << std::endl;
       return false;
       }
+    if (!TestInsertDicomSeriesList())
+      {
+      std::cerr << "'TestInsertDicomSeriesList' call not successful." << std::endl;
+      return false;
+      }
     if (!TestVisibilityOperations())
       {
       std::cerr << "'TestVisibilityOperations' call not successful." << std::endl;
@@ -622,6 +629,70 @@ namespace
     return true;
     }
 
+  //---------------------------------------------------------------------------
+  bool TestInsertDicomSeriesList()
+    {
+    vtkSmartPointer<vtkMRMLScene> scene = vtkSmartPointer<vtkMRMLScene>::New();
+    if (!PopulateScene(scene))
+      {
+      return false;
+      }
+
+    // Create series nodes to insert: two in an existing study, one in a new study
+    const char* seriesUids[3] = { "NEW_SERIES1", "NEW_SERIES2", "NEW_SERIES3" };
+    const char* studyUids[3] = { STUDY1_UID_VALUE, STUDY1_UID_VALUE, "NEW_STUDY" };
+    vtkNew<vtkStringArray> patientIdArray;
+    vtkNew<vtkStringArray> studyUidArray;
+    vtkNew<vtkStringArray> seriesUidArray;
+    vtkMRMLSubjectHierarchyNode* seriesShNodes[3] = { NULL, NULL, NULL };
+    for (int seriesIndex=0; seriesIndex<3; ++seriesIndex)
+      {
+      seriesShNodes[seriesIndex] = vtkMRMLSubjectHierarchyNode::CreateSubjectHierarchyNode(
+        scene, NULL, vtkMRMLSubjectHierarchyConstants::GetDICOMLevelSeries(), "Series");
+      seriesShNodes[seriesIndex]->AddUID(UID_NAME, seriesUids[seriesIndex]);
+      patientIdArray->InsertNextValue(PATIENT_UID_VALUE);
+      studyUidArray->InsertNextValue(studyUids[seriesIndex]);
+      seriesUidArray->InsertNextValue(seriesUids[seriesIndex]);
+      }
+    // Series that is not in the scene
+    patientIdArray->InsertNextValue(PATIENT_UID_VALUE);
+    studyUidArray->InsertNextValue(STUDY1_UID_VALUE);
+    seriesUidArray->InsertNextValue("MISSING_SERIES");
+
+    int numberOfInsertedSeries = vtkSlicerSubjectHierarchyModuleLogic::InsertDicomSeriesListInHierarchy(
+      scene, patientIdArray.GetPointer(), studyUidArray.GetPointer(), seriesUidArray.GetPointer() );
+    if (numberOfInsertedSeries != 3)
+      {
+      std::cout << "Number of inserted series is " << numberOfInsertedSeries << " instead of 3" << std::endl;
+      return false;
+      }
+
+    vtkMRMLSubjectHierarchyNode* patientShNode =
+      vtkMRMLSubjectHierarchyNode::GetSubjectHierarchyNodeByUID(scene, UID_NAME, PATIENT_UID_VALUE);
+    vtkMRMLSubjectHierarchyNode* study1ShNode =
+      vtkMRMLSubjectHierarchyNode::GetSubjectHierarchyNodeByUID(scene, UID_NAME, STUDY1_UID_VALUE);
+    vtkMRMLSubjectHierarchyNode* newStudyShNode =
+      vtkMRMLSubjectHierarchyNode::GetSubjectHierarchyNodeByUID(scene, UID_NAME, "NEW_STUDY");
+    if (!patientShNode || !study1ShNode || !newStudyShNode || newStudyShNode->GetParentNode() != patientShNode)
+      {
+      std::cout << "Study node not found or not created under the existing patient node" << std::endl;
+      return false;
+      }
+    if ( seriesShNodes[0]->GetParentNode() != study1ShNode || seriesShNodes[1]->GetParentNode() != study1ShNode
+      || seriesShNodes[2]->GetParentNode() != newStudyShNode )
+      {
+      std::cout << "DICOM series nodes not correctly inserted under study nodes" << std::endl;
+      return false;
+      }
+    if (scene->IsBatchProcessing())
+      {
+      std::cout << "Scene is left in batch processing state" << std::endl;
+      return false;
+      }
+
+    return true;
+    }
+
   //---------------------------------------------------------------------------
   bool TestVisibilityOperations()
     {
@@ -41,6 +41,8 @@
 
 // STD includes
 #include <algorithm>
+#include <map>
+#include <vector>
 
 #include "rapidjson/document.h"     // rapidjson's DOM-style API
 #include "rapidjson/prettywriter.h" // for stringify JSON
@@ -147,6 +149,48 @@ public:
     terminologyMap[name] = doc;
     }
 
+  /// Search index of the codes in a Json code array, so that searching while typing
+  /// does not traverse the Json document and compare every code meaning
+  class CodeIndex
+    {
+    public:
+      /// Extract the codes from the Json array and index the trigrams of their lowercase meanings
+      /// \param invalidCodeMeanings Output argument containing the meanings of the codes missing mandatory members
+      void Build(rapidjson::Value& codeArray, std::vector<std::string>& invalidCodeMeanings);
+      /// Get the codes whose meaning contains the search string (case-insensitive), in array order
+      void Find(std::string search, std::vector<CodeIdentifier>& codes);
+
+    protected:
+      /// Key of the three characters of a string starting at a given position
+      static unsigned int GetTrigram(const std::string& text, size_t position)
+        {
+        return (static_cast<unsigned char>(text[position]) << 16)
+          | (static_cast<unsigned char>(text[position+1]) << 8)
+          | static_cast<unsigned char>(text[position+2]);
+        }
+
+      std::vector<CodeIdentifier> Codes;
+      std::vector<std::string> LowerCaseMeanings;
+      /// Indices of the codes containing each trigram, in increasing order
+      std::map<unsigned int, std::vector<int> > TrigramCodes;
+    };
+  typedef std::map<std::string, CodeIndex> CodeIndexMap;
+
+  /// Get category index for a given terminology. It is built on first use.
+  /// \return NULL if the terminology has no category array
+  CodeIndex* GetCategoryIndexInTerminology(std::string terminologyName);
+  /// Get type index for a given terminology and category. It is built on first use,
+  /// so that only the categories that are browsed are indexed.
+  /// \return NULL if the category has no type array
+  CodeIndex* GetTypeIndexInTerminologyCategory(std::string terminologyName, CodeIdentifier categoryId);
+  /// Get region index for a given anatomic context. It is built on first use.
+  /// \return NULL if the anatomic context has no region array
+  CodeIndex* GetRegionIndexInAnatomicContext(std::string anatomicContextName);
+  /// Discard indices of a terminology when it is (re)loaded
+  void ClearTerminologyIndices(const std::string& terminologyName);
+  /// Discard index of an anatomic context when it is (re)loaded
+  void ClearAnatomicContextIndices(const std::string& anatomicContextName);
+
 public:
   /// Loaded terminologies. Key is the context name, value is the root item.
   TerminologyMap LoadedTerminologies;
@@ -154,6 +198,14 @@ public:
   /// Loaded anatomical region contexts. Key is the context name, value is the root item.
   TerminologyMap LoadedAnatomicContexts;
 
+  /// Category indices. Key is the terminology context name.
+  CodeIndexMap CategoryIndices;
+  /// Type indices. Key is the terminology context name, then the category
+  /// coding scheme designator and code value.
+  std::map<std::string, CodeIndexMap> TypeIndices;
+  /// Region indices. Key is the anatomic context name.
+  CodeIndexMap RegionIndices;
+
 private:
   vtkSlicerTerminologiesModuleLogic* External;
 };
@@ -980,6 +1032,196 @@ void vtkSlicerTerminologiesModuleLogic::vtkInternal::GetJsonCodeFromIdentifier(
 }
 
 
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::CodeIndex::Build(
+  rapidjson::Value& codeArray, std::vector<std::string>& invalidCodeMeanings)
+{
+  this->Codes.clear();
+  this->LowerCaseMeanings.clear();
+  this->TrigramCodes.clear();
+  invalidCodeMeanings.clear();
+  if (!codeArray.IsArray())
+    {
+    return;
+    }
+
+  for (rapidjson::SizeType index = 0; index < codeArray.Size(); ++index)
+    {
+    rapidjson::Value& code = codeArray[index];
+    if (!code.IsObject())
+      {
+      continue;
+      }
+    rapidjson::Value& codeMeaning = code["CodeMeaning"];
+    rapidjson::Value& codingSchemeDesignator = code["CodingSchemeDesignator"];
+    rapidjson::Value& codeValue = code["CodeValue"];
+    if (!codeMeaning.IsString() || !codingSchemeDesignator.IsString() || !codeValue.IsString())
+      {
+      invalidCodeMeanings.push_back(codeMeaning.IsString() ? codeMeaning.GetString() : "");
+      continue;
+      }
+
+    int codeIndex = static_cast<int>(this->Codes.size());
+    this->Codes.push_back(CodeIdentifier(codingSchemeDesignator.GetString(), codeValue.GetString(), codeMeaning.GetString()));
+    std::string lowerCaseMeaning(codeMeaning.GetString());
+    std::transform(lowerCaseMeaning.begin(), lowerCaseMeaning.end(), lowerCaseMeaning.begin(), ::tolower);
+    this->LowerCaseMeanings.push_back(lowerCaseMeaning);
+    for (size_t position = 0; position + 3 <= lowerCaseMeaning.size(); ++position)
+      {
+      std::vector<int>& trigramCodes = this->TrigramCodes[GetTrigram(lowerCaseMeaning, position)];
+      // Codes are added in increasing order, a repeated trigram is only stored once
+      if (trigramCodes.empty() || trigramCodes.back() != codeIndex)
+        {
+        trigramCodes.push_back(codeIndex);
+        }
+      }
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::CodeIndex::Find(std::string search, std::vector<CodeIdentifier>& codes)
+{
+  codes.clear();
+  if (search.empty())
+    {
+    codes = this->Codes;
+    return;
+    }
+
+  // Make lowercase for case-insensitive comparison
+  std::transform(search.begin(), search.end(), search.begin(), ::tolower);
+
+  if (search.size() < 3)
+    {
+    // Too short for the trigrams, only compare the prepared lowercase meanings
+    for (size_t codeIndex = 0; codeIndex < this->LowerCaseMeanings.size(); ++codeIndex)
+      {
+      if (this->LowerCaseMeanings[codeIndex].find(search) != std::string::npos)
+        {
+        codes.push_back(this->Codes[codeIndex]);
+        }
+      }
+    return;
+    }
+
+  // Candidates are the codes containing the rarest trigram of the search string
+  const std::vector<int>* candidates = NULL;
+  for (size_t position = 0; position + 3 <= search.size(); ++position)
+    {
+    std::map<unsigned int, std::vector<int> >::const_iterator trigramIt = this->TrigramCodes.find(GetTrigram(search, position));
+    if (trigramIt == this->TrigramCodes.end())
+      {
+      // No code contains this trigram
+      return;
+      }
+    if (!candidates || trigramIt->second.size() < candidates->size())
+      {
+      candidates = &(trigramIt->second);
+      }
+    }
+  for (std::vector<int>::const_iterator codeIt = candidates->begin(); codeIt != candidates->end(); ++codeIt)
+    {
+    if (this->LowerCaseMeanings[*codeIt].find(search) != std::string::npos)
+      {
+      codes.push_back(this->Codes[*codeIt]);
+      }
+    }
+}
+
+//---------------------------------------------------------------------------
+vtkSlicerTerminologiesModuleLogic::vtkInternal::CodeIndex*
+vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCategoryIndexInTerminology(std::string terminologyName)
+{
+  CodeIndexMap::iterator indexIt = this->CategoryIndices.find(terminologyName);
+  if (indexIt != this->CategoryIndices.end())
+    {
+    return &(indexIt->second);
+    }
+
+  rapidjson::Value& categoryArray = this->GetCategoryArrayInTerminology(terminologyName);
+  if (categoryArray.IsNull())
+    {
+    return NULL;
+    }
+  CodeIndex& index = this->CategoryIndices[terminologyName];
+  std::vector<std::string> invalidCodeMeanings;
+  index.Build(categoryArray, invalidCodeMeanings);
+  for (std::vector<std::string>::iterator codeIt = invalidCodeMeanings.begin(); codeIt != invalidCodeMeanings.end(); ++codeIt)
+    {
+    vtkErrorWithObjectMacro(this->External, "FindCategoriesInTerminology: Invalid category '" << (*codeIt)
+      << "' in terminology '" << terminologyName << "'");
+    }
+  return &index;
+}
+
+//---------------------------------------------------------------------------
+vtkSlicerTerminologiesModuleLogic::vtkInternal::CodeIndex*
+vtkSlicerTerminologiesModuleLogic::vtkInternal::GetTypeIndexInTerminologyCategory(std::string terminologyName, CodeIdentifier categoryId)
+{
+  CodeIndexMap& categoryTypeIndices = this->TypeIndices[terminologyName];
+  std::string categoryKey = categoryId.CodingSchemeDesignator + "^" + categoryId.CodeValue;
+  CodeIndexMap::iterator indexIt = categoryTypeIndices.find(categoryKey);
+  if (indexIt != categoryTypeIndices.end())
+    {
+    return &(indexIt->second);
+    }
+
+  rapidjson::Value& typeArray = this->GetTypeArrayInTerminologyCategory(terminologyName, categoryId);
+  if (typeArray.IsNull())
+    {
+    return NULL;
+    }
+  CodeIndex& index = categoryTypeIndices[categoryKey];
+  std::vector<std::string> invalidCodeMeanings;
+  index.Build(typeArray, invalidCodeMeanings);
+  for (std::vector<std::string>::iterator codeIt = invalidCodeMeanings.begin(); codeIt != invalidCodeMeanings.end(); ++codeIt)
+    {
+    vtkErrorWithObjectMacro(this->External, "FindTypesInTerminologyCategory: Invalid type '" << (*codeIt) << "' in category '"
+      << categoryId.CodeMeaning << "' in terminology '" << terminologyName << "'");
+    }
+  return &index;
+}
+
+//---------------------------------------------------------------------------
+vtkSlicerTerminologiesModuleLogic::vtkInternal::CodeIndex*
+vtkSlicerTerminologiesModuleLogic::vtkInternal::GetRegionIndexInAnatomicContext(std::string anatomicContextName)
+{
+  CodeIndexMap::iterator indexIt = this->RegionIndices.find(anatomicContextName);
+  if (indexIt != this->RegionIndices.end())
+    {
+    return &(indexIt->second);
+    }
+
+  rapidjson::Value& regionArray = this->GetRegionArrayInAnatomicContext(anatomicContextName);
+  if (regionArray.IsNull())
+    {
+    return NULL;
+    }
+  CodeIndex& index = this->RegionIndices[anatomicContextName];
+  std::vector<std::string> invalidCodeMeanings;
+  index.Build(regionArray, invalidCodeMeanings);
+  for (std::vector<std::string>::iterator codeIt = invalidCodeMeanings.begin(); codeIt != invalidCodeMeanings.end(); ++codeIt)
+    {
+    vtkErrorWithObjectMacro(this->External, "FindRegionsInAnatomicContext: Invalid region '" << (*codeIt)
+      << "' in anatomic context '" << anatomicContextName << "'");
+    }
+  return &index;
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::ClearTerminologyIndices(const std::string& terminologyName)
+{
+  this->CategoryIndices.erase(terminologyName);
+  this->TypeIndices.erase(terminologyName);
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::ClearAnatomicContextIndices(const std::string& anatomicContextName)
+{
+  this->RegionIndices.erase(anatomicContextName);
+}
+
+
 //---------------------------------------------------------------------------
 // vtkSlicerTerminologiesModuleLogic methods
 
@@ -1041,6 +1283,7 @@ std::string vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromFile(std::stri
   contextName = (*terminologyRoot)["SegmentationCategoryTypeContextName"].GetString();
   vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
     this->Internal->LoadedTerminologies, contextName, terminologyRoot);
+  this->Internal->ClearTerminologyIndices(contextName);
 
   vtkInfoMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
   this->Modified();
@@ -1088,6 +1331,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromSegmentDescriptorFile
   // Store terminology
   vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
     this->Internal->LoadedTerminologies, contextName, convertedDoc );
+  this->Internal->ClearTerminologyIndices(contextName);
 
   vtkInfoMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
   this->Modified();
@@ -1135,6 +1379,7 @@ std::string vtkSlicerTerminologiesModuleLogic::LoadAnatomicContextFromFile(std::
   contextName = (*anatomicContextRoot)["AnatomicContextName"].GetString();
   vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
     this->Internal->LoadedAnatomicContexts, contextName, anatomicContextRoot);
+  this->Internal->ClearAnatomicContextIndices(contextName);
 
   vtkInfoMacro("Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
   return contextName;
@@ -1181,6 +1426,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadAnatomicContextFromSegmentDescriptor
   // Store anatomic context
   vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
     this->Internal->LoadedAnatomicContexts, contextName, convertedDoc );
+  this->Internal->ClearAnatomicContextIndices(contextName);
 
   vtkInfoMacro("Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
   this->Modified();
@@ -1268,46 +1514,14 @@ bool vtkSlicerTerminologiesModuleLogic::FindCategoriesInTerminology(std::string
 {
   categories.clear();
 
-  rapidjson::Value& categoryArray = this->Internal->GetCategoryArrayInTerminology(terminologyName);
-  if (categoryArray.IsNull())
+  vtkInternal::CodeIndex* categoryIndex = this->Internal->GetCategoryIndexInTerminology(terminologyName);
+  if (!categoryIndex)
     {
     vtkErrorMacro("FindCategoriesInTerminology: Failed to find category array in terminology '" << terminologyName << "'");
     return false;
     }
 
-  // Make lowercase for case-insensitive comparison
-  std::transform(search.begin(), search.end(), search.begin(), ::tolower);
-
-  // Traverse categories
-  rapidjson::SizeType index = 0;
-  while (index<categoryArray.Size())
-    {
-    rapidjson::Value& category = categoryArray[index];
-    if (category.IsObject())
-      {
-      rapidjson::Value& categoryName = category["CodeMeaning"];
-      rapidjson::Value& categoryCodingSchemeDesignator = category["CodingSchemeDesignator"];
-      rapidjson::Value& categoryCodeValue = category["CodeValue"];
-      if (categoryName.IsString() && categoryCodingSchemeDesignator.IsString() && categoryCodeValue.IsString())
-        {
-        // Add category to list if search string is empty or is contained by the current category name
-        std::string categoryNameStr = categoryName.GetString();
-        std::string categoryNameLowerCase(categoryNameStr);
-        std::transform(categoryNameLowerCase.begin(), categoryNameLowerCase.end(), categoryNameLowerCase.begin(), ::tolower);
-        if (search.empty() || categoryNameLowerCase.find(search) != std::string::npos)
-          {
-          CodeIdentifier categoryId(categoryCodingSchemeDesignator.GetString(), categoryCodeValue.GetString(), categoryNameStr);
-          categories.push_back(categoryId);
-          }
-        }
-      else
-        {
-        vtkErrorMacro("FindCategoriesInTerminology: Invalid category '" << categoryName.GetString() << "' in terminology '" << terminologyName << "'");
-        }
-      }
-    ++index;
-    }
-
+  categoryIndex->Find(search, categories);
   return true;
 }
 
@@ -1342,48 +1556,15 @@ bool vtkSlicerTerminologiesModuleLogic::FindTypesInTerminologyCategory(
 {
   types.clear();
 
-  rapidjson::Value& typeArray = this->Internal->GetTypeArrayInTerminologyCategory(terminologyName, categoryId);
-  if (typeArray.IsNull())
+  vtkInternal::CodeIndex* typeIndex = this->Internal->GetTypeIndexInTerminologyCategory(terminologyName, categoryId);
+  if (!typeIndex)
     {
     vtkErrorMacro("FindTypesInTerminologyCategory: Failed to find Type array member in category '"
       << categoryId.CodeMeaning << "' in terminology '" << terminologyName << "'");
     return false;
     }
 
-  // Make lowercase for case-insensitive comparison
-  std::transform(search.begin(), search.end(), search.begin(), ::tolower);
-
-  // Traverse types
-  rapidjson::SizeType index = 0;
-  while (index<typeArray.Size())
-    {
-    rapidjson::Value& type = typeArray[index];
-    if (type.IsObject())
-      {
-      rapidjson::Value& typeName = type["CodeMeaning"];
-      rapidjson::Value& typeCodingSchemeDesignator = type["CodingSchemeDesignator"];
-      rapidjson::Value& typeCodeValue = type["CodeValue"];
-      if (typeName.IsString() && typeCodingSchemeDesignator.IsString() && typeCodeValue.IsString())
-        {
-        // Add type to list if search string is empty or is contained by the current type name
-        std::string typeNameStr = typeName.GetString();
-        std::string typeNameLowerCase(typeNameStr);
-        std::transform(typeNameLowerCase.begin(), typeNameLowerCase.end(), typeNameLowerCase.begin(), ::tolower);
-        if (search.empty() || typeNameLowerCase.find(search) != std::string::npos)
-          {
-          CodeIdentifier typeId(typeCodingSchemeDesignator.GetString(), typeCodeValue.GetString(), typeNameStr);
-          types.push_back(typeId);
-          }
-        }
-      else
-        {
-        vtkErrorMacro("FindTypesInTerminologyCategory: Invalid type '" << typeName.GetString() << "in category '"
-          << categoryId.CodeMeaning << "' in terminology '" << terminologyName << "'");
-        }
-      }
-    ++index;
-    }
-
+  typeIndex->Find(search, types);
   return true;
 }
 
@@ -1477,47 +1658,14 @@ bool vtkSlicerTerminologiesModuleLogic::FindRegionsInAnatomicContext(std::string
 {
   regions.clear();
 
-  rapidjson::Value& regionArray = this->Internal->GetRegionArrayInAnatomicContext(anatomicContextName);
-  if (regionArray.IsNull())
+  vtkInternal::CodeIndex* regionIndex = this->Internal->GetRegionIndexInAnatomicContext(anatomicContextName);
+  if (!regionIndex)
     {
     vtkErrorMacro("FindRegionsInAnatomicContext: Failed to find region array member in anatomic context '" << anatomicContextName << "'");
     return false;
     }
 
-  // Make lowercase for case-insensitive comparison
-  std::transform(search.begin(), search.end(), search.begin(), ::tolower);
-
-  // Traverse regions
-  rapidjson::SizeType index = 0;
-  while (index<regionArray.Size())
-    {
-    rapidjson::Value& region = regionArray[index];
-    if (region.IsObject())
-      {
-      rapidjson::Value& regionName = region["CodeMeaning"];
-      rapidjson::Value& regionCodingSchemeDesignator = region["CodingSchemeDesignator"];
-      rapidjson::Value& regionCodeValue = region["CodeValue"];
-      if (regionName.IsString() && regionCodingSchemeDesignator.IsString() && regionCodeValue.IsString())
-        {
-        // Add region name to list if search string is empty or is contained by the current region name
-        std::string regionNameStr = regionName.GetString();
-        std::string regionNameLowerCase(regionNameStr);
-        std::transform(regionNameLowerCase.begin(), regionNameLowerCase.end(), regionNameLowerCase.begin(), ::tolower);
-        if (search.empty() || regionNameLowerCase.find(search) != std::string::npos)
-          {
-          CodeIdentifier regionId(regionCodingSchemeDesignator.GetString(), regionCodeValue.GetString(), regionNameStr);
-          regions.push_back(regionId);
-          }
-        }
-      else
-        {
-        vtkErrorMacro("FindRegionsInAnatomicContext: Invalid region '" << regionName.GetString()
-          << "' in anatomic context '" << anatomicContextName << "'");
-        }
-      }
-    ++index;
-    }
-
+  regionIndex->Find(search, regions);
   return true;
 }
 
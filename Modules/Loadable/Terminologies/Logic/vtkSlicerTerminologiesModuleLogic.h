@@ -91,6 +91,8 @@ public:
   /// \return Success flag
   bool GetCategoriesInTerminology(std::string terminologyName, std::vector<CodeIdentifier>& categories);
   /// Find category names (codeMeaning) in terminology containing a given string
+  /// Note: The categories are indexed by the trigrams of their lowercase names the first time they are searched,
+  ///   so that searching while typing does not traverse the terminology
   /// \param categories Output argument containing all the \sa vtkSlicerTerminologyCategory objects created
   ///   from the categories found in the given terminology
   /// \return Success flag
@@ -106,7 +108,8 @@ public:
   ///   from the types found in the given terminology category
   /// \return Success flag
   bool GetTypesInTerminologyCategory(std::string terminologyName, CodeIdentifier categoryId, std::vector<CodeIdentifier>& types);
-  /// Get all type names (codeMeaning) in a terminology category
+  /// Get all type names (codeMeaning) in a terminology category containing a given string
+  /// Note: The types of a category are only indexed the first time the category is searched
   /// \param typeCollection Output argument containing all the \sa vtkSlicerTerminologyType objects created
   ///   from the types found in the given terminology category
   /// \return Success flag
@@ -133,8 +136,8 @@ public:
   ///   from the regions found in the given anatomic context
   /// \return Success flag
   bool GetRegionsInAnatomicContext(std::string anatomicContextName, std::vector<CodeIdentifier>& regions);
-  /// Get all region names (codeMeaning) in an anatomic context
-  /// Note: Separate function from \sa FindRegionNamesInAnatomicContext for python compatibility
+  /// Get all region names (codeMeaning) in an anatomic context containing a given string
+  /// Note: The regions are indexed the first time they are searched
   /// \return Success flag
   bool FindRegionsInAnatomicContext(std::string anatomicContextName, std::vector<CodeIdentifier>& regions, std::string search);
   /// Get a region with given name from an anatomic context
@@ -0,0 +1,84 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// Logic includes
+#include "vtkSlicerTransformLogic.h"
+
+// MRML includes
+#include "vtkMRMLLinearTransformNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <cmath>
+
+//-----------------------------------------------------------------------------
+int vtkSlicerTransformLogicTest4(int vtkNotUsed(argc), char * vtkNotUsed(argv) [])
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLLinearTransformNode> transformNode;
+  scene->AddNode(transformNode.GetPointer());
+  vtkNew<vtkMatrix4x4> translation;
+  translation->SetElement(0, 3, 3.0);
+  translation->SetElement(1, 3, 4.0);
+  transformNode->SetMatrixTransformToParent(translation.GetPointer());
+
+  // Enough samples to be split between several threads
+  vtkNew<vtkMatrix4x4> ijkToRAS;
+  ijkToRAS->SetElement(0, 0, 2.0);
+  ijkToRAS->SetElement(0, 3, -10.0);
+
+  vtkNew<vtkImageData> magnitudeImage;
+  magnitudeImage->SetExtent(0, 39, 0, 29, 2, 6);
+  if (!vtkSlicerTransformLogic::GetTransformedPointSamplesAsMagnitudeImage(
+    magnitudeImage.GetPointer(), transformNode.GetPointer(), ijkToRAS.GetPointer()))
+    {
+    std::cerr << "GetTransformedPointSamplesAsMagnitudeImage failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkDataArray* magnitudes = magnitudeImage->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < magnitudes->GetNumberOfTuples(); i++)
+    {
+    if (fabs(magnitudes->GetTuple1(i) - 5.0) > 1e-4)
+      {
+      std::cerr << "Invalid displacement magnitude at voxel " << i << ": " << magnitudes->GetTuple1(i) << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  vtkNew<vtkImageData> vectorImage;
+  vectorImage->SetExtent(0, 39, 0, 29, 2, 6);
+  if (!vtkSlicerTransformLogic::GetTransformedPointSamplesAsVectorImage(
+    vectorImage.GetPointer(), transformNode.GetPointer(), ijkToRAS.GetPointer(), false))
+    {
+    std::cerr << "GetTransformedPointSamplesAsVectorImage failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkDataArray* vectors = vectorImage->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < vectors->GetNumberOfTuples(); i++)
+    {
+    double* vector = vectors->GetTuple3(i);
+    if (fabs(vector[0] + 3.0) > 1e-4 || fabs(vector[1] + 4.0) > 1e-4 || fabs(vector[2]) > 1e-4)
+      {
+      std::cerr << "Invalid displacement at voxel " << i << ": "
+        << vector[0] << ", " << vector[1] << ", " << vector[2] << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -44,6 +44,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include <vtkLine.h>
 #include <vtkLookupTable.h>
 #include <vtkMath.h>
+#include <vtkMultiThreader.h>
 #include <vtkTransform.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
@@ -77,6 +78,142 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include "itkTranslationTransform.h"
 #include "itkTransformFactory.h"
 
+// STD includes
+#include <algorithm>
+
+namespace
+{
+
+/// Below this number of samples per thread the displacement field is sampled in the calling thread
+const vtkIdType MINIMUM_NUMBER_OF_SAMPLES_PER_THREAD = 1000;
+
+/// Positions and results of displacement field sampling, shared by all sampling threads.
+/// Sample positions are either taken from SamplePositions or computed from the voxel index
+/// within GridExtent using GridToRAS.
+/// Results are written to VectorOutput (3 components) if set, otherwise to FloatOutput as
+/// vectors (FloatOutputComponents=3) or vector magnitudes (FloatOutputComponents=1).
+struct DisplacementSamplingData
+{
+  DisplacementSamplingData()
+    : Transform(NULL)
+    , SamplePositions(NULL)
+    , GridToRAS(NULL)
+    , NumberOfSamples(0)
+    , VectorOutput(NULL)
+    , FloatOutput(NULL)
+    , FloatOutputComponents(3)
+  {
+    for (int i = 0; i < 6; i++)
+      {
+      this->GridExtent[i] = 0;
+      }
+  }
+
+  vtkAbstractTransform* Transform;
+  vtkPoints* SamplePositions;
+  vtkMatrix4x4* GridToRAS;
+  int GridExtent[6];
+  vtkIdType NumberOfSamples;
+  double* VectorOutput;
+  float* FloatOutput;
+  int FloatOutputComponents;
+};
+
+//----------------------------------------------------------------------------
+void SampleDisplacements(DisplacementSamplingData* data, vtkIdType firstSample, vtkIdType lastSample)
+{
+  int* extent = data->GridExtent;
+  vtkIdType gridSizeI = extent[1] - extent[0] + 1;
+  vtkIdType gridSizeJ = extent[3] - extent[2] + 1;
+  double point_Grid[4] = { 0, 0, 0, 1 };
+  double point_RAS[4] = { 0, 0, 0, 1 };
+  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
+  for (vtkIdType sampleIndex = firstSample; sampleIndex < lastSample; sampleIndex++)
+    {
+    if (data->SamplePositions)
+      {
+      data->SamplePositions->GetPoint(sampleIndex, point_RAS);
+      }
+    else
+      {
+      point_Grid[0] = extent[0] + sampleIndex % gridSizeI;
+      point_Grid[1] = extent[2] + (sampleIndex / gridSizeI) % gridSizeJ;
+      point_Grid[2] = extent[4] + sampleIndex / (gridSizeI * gridSizeJ);
+      data->GridToRAS->MultiplyPoint(point_Grid, point_RAS);
+      }
+
+    data->Transform->TransformPoint(point_RAS, transformedPoint_RAS);
+
+    double displacement[3] =
+      {
+      transformedPoint_RAS[0] - point_RAS[0],
+      transformedPoint_RAS[1] - point_RAS[1],
+      transformedPoint_RAS[2] - point_RAS[2]
+      };
+    if (data->VectorOutput)
+      {
+      double* output = data->VectorOutput + 3 * sampleIndex;
+      output[0] = displacement[0];
+      output[1] = displacement[1];
+      output[2] = displacement[2];
+      }
+    else if (data->FloatOutputComponents == 1)
+      {
+      data->FloatOutput[sampleIndex] = static_cast<float>(vtkMath::Norm(displacement));
+      }
+    else
+      {
+      float* output = data->FloatOutput + 3 * sampleIndex;
+      output[0] = static_cast<float>(displacement[0]);
+      output[1] = static_cast<float>(displacement[1]);
+      output[2] = static_cast<float>(displacement[2]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE SampleDisplacementsThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  DisplacementSamplingData* data = static_cast<DisplacementSamplingData*>(threadInfo->UserData);
+  vtkIdType numberOfSamplesPerThread = (data->NumberOfSamples + threadInfo->NumberOfThreads - 1) / threadInfo->NumberOfThreads;
+  vtkIdType firstSample = threadInfo->ThreadID * numberOfSamplesPerThread;
+  vtkIdType lastSample = std::min(firstSample + numberOfSamplesPerThread, data->NumberOfSamples);
+  if (firstSample < lastSample)
+    {
+    SampleDisplacements(data, firstSample, lastSample);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+/// Sample the displacement field. The samples are split into contiguous ranges
+/// that are processed in parallel. The transform is only read during sampling.
+void SampleDisplacementsParallel(DisplacementSamplingData* data)
+{
+  if (data->NumberOfSamples <= 0)
+    {
+    return;
+    }
+  // Update the transform now so that sampling threads do not need to update it concurrently
+  data->Transform->Update();
+
+  vtkIdType numberOfThreads = std::min<vtkIdType>(vtkMultiThreader::GetGlobalDefaultNumberOfThreads(),
+    data->NumberOfSamples / MINIMUM_NUMBER_OF_SAMPLES_PER_THREAD);
+  numberOfThreads = std::min<vtkIdType>(numberOfThreads, VTK_MAX_THREADS);
+  if (numberOfThreads < 2)
+    {
+    SampleDisplacements(data, 0, data->NumberOfSamples);
+    return;
+    }
+  vtkNew<vtkMultiThreader> threader;
+  threader->SetNumberOfThreads(static_cast<int>(numberOfThreads));
+  threader->SetSingleMethod(SampleDisplacementsThreadFunction, data);
+  threader->SingleMethodExecute();
+}
+
+} // end of anonymous namespace
+
 vtkStandardNewMacro(vtkSlicerTransformLogic);
 
 //----------------------------------------------------------------------------
@@ -210,21 +347,11 @@ void vtkSlicerTransformLogic::GetTransformedPointSamples(vtkPointSet* outputPoin
   vtkMRMLTransformNode* inputTransformNode, vtkMatrix4x4* gridToRAS, int* gridSize,
   bool transformToWorld /* = true */)
 {
-  vtkNew<vtkGeneralTransform> inputTransform;
-  if (transformToWorld)
-  {
-    inputTransformNode->GetTransformToWorld(inputTransform.GetPointer());
-  }
-  else
-  {
-    inputTransformNode->GetTransformFromWorld(inputTransform.GetPointer());
-  }
   // Generate sample point set on a grid
   vtkNew<vtkPoints> samplePositions_RAS;
   int numOfSamples = gridSize[0] * gridSize[1] * gridSize[2];
   samplePositions_RAS->SetNumberOfPoints(numOfSamples);
   double point_RAS[4] = { 0, 0, 0, 1 };
-  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
   double point_Grid[4] = { 0, 0, 0, 1 };
   int sampleIndex = 0;
   for (point_Grid[2] = 0; point_Grid[2]<gridSize[2]; point_Grid[2]++)
@@ -234,7 +361,6 @@ void vtkSlicerTransformLogic::GetTransformedPointSamples(vtkPointSet* outputPoin
       for (point_Grid[0] = 0; point_Grid[0]<gridSize[0]; point_Grid[0]++)
         {
         gridToRAS->MultiplyPoint(point_Grid, point_RAS);
-        inputTransform->TransformPoint(point_RAS, transformedPoint_RAS);
         samplePositions_RAS->SetPoint(sampleIndex, point_RAS[0], point_RAS[1], point_RAS[2]);
         sampleIndex++;
         }
@@ -272,20 +398,12 @@ void vtkSlicerTransformLogic::GetTransformedPointSamples(vtkPointSet* outputPoin
     inputTransformNode->GetTransformFromWorld(inputTransform.GetPointer());
     }
 
-  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
-  double pointDislocationVector_RAS[4] = { 0, 0, 0, 1 };
-  for (int sampleIndex = 0; sampleIndex < numOfSamples; sampleIndex++)
-    {
-    double* point_RAS = samplePositions_RAS->GetPoint(sampleIndex);
-
-    inputTransform->TransformPoint(point_RAS, transformedPoint_RAS);
-
-    pointDislocationVector_RAS[0] = transformedPoint_RAS[0] - point_RAS[0];
-    pointDislocationVector_RAS[1] = transformedPoint_RAS[1] - point_RAS[1];
-    pointDislocationVector_RAS[2] = transformedPoint_RAS[2] - point_RAS[2];
-
-    sampleVectors_RAS->SetTuple3(sampleIndex, pointDislocationVector_RAS[0], pointDislocationVector_RAS[1], pointDislocationVector_RAS[2]);
-    }
+  DisplacementSamplingData samplingData;
+  samplingData.Transform = inputTransform.GetPointer();
+  samplingData.SamplePositions = samplePositions_RAS;
+  samplingData.NumberOfSamples = numOfSamples;
+  samplingData.VectorOutput = sampleVectors_RAS->GetPointer(0);
+  SampleDisplacementsParallel(&samplingData);
 
   outputPointSet->SetPoints(samplePositions_RAS);
   vtkPointData* pointData = outputPointSet->GetPointData();
@@ -409,35 +527,14 @@ bool vtkSlicerTransformLogic::GetTransformedPointSamplesAsMagnitudeImage(vtkImag
   // if the direction matrix is not identity.
   magnitudeImage->AllocateScalars(VTK_FLOAT, 1);
 
-  double point_RAS[4] = { 0, 0, 0, 1 };
-  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
-  double pointDislocationVector_RAS[4] = { 0, 0, 0, 1 };
-  double point_IJK[4] = { 0, 0, 0, 1 };
-  float* voxelPtr = static_cast<float*>(magnitudeImage->GetScalarPointer());
-  int* extent = magnitudeImage->GetExtent();
-  for (point_IJK[2] = extent[4]; point_IJK[2] <= extent[5]; point_IJK[2]++)
-  {
-    for (point_IJK[1] = extent[2]; point_IJK[1] <= extent[3]; point_IJK[1]++)
-    {
-      for (point_IJK[0] = extent[0]; point_IJK[0] <= extent[1]; point_IJK[0]++)
-      {
-        ijkToRAS->MultiplyPoint(point_IJK, point_RAS);
-
-        inputTransform->TransformPoint(point_RAS, transformedPoint_RAS);
-
-        pointDislocationVector_RAS[0] = transformedPoint_RAS[0] - point_RAS[0];
-        pointDislocationVector_RAS[1] = transformedPoint_RAS[1] - point_RAS[1];
-        pointDislocationVector_RAS[2] = transformedPoint_RAS[2] - point_RAS[2];
-
-        float mag = sqrt(
-          pointDislocationVector_RAS[0] * pointDislocationVector_RAS[0] +
-          pointDislocationVector_RAS[1] * pointDislocationVector_RAS[1] +
-          pointDislocationVector_RAS[2] * pointDislocationVector_RAS[2]);
-
-        *(voxelPtr++) = mag;
-      }
-    }
-  }
+  DisplacementSamplingData samplingData;
+  samplingData.Transform = inputTransform.GetPointer();
+  samplingData.GridToRAS = ijkToRAS;
+  magnitudeImage->GetExtent(samplingData.GridExtent);
+  samplingData.NumberOfSamples = magnitudeImage->GetNumberOfPoints();
+  samplingData.FloatOutput = static_cast<float*>(magnitudeImage->GetScalarPointer());
+  samplingData.FloatOutputComponents = 1;
+  SampleDisplacementsParallel(&samplingData);
 
   return true;
 }
@@ -703,28 +800,14 @@ bool vtkSlicerTransformLogic::GetTransformedPointSamplesAsVectorImage(vtkImageDa
   // if the direction matrix is not identity.
   vectorImage->AllocateScalars(VTK_FLOAT, 3);
 
-  double point_RAS[4] = { 0, 0, 0, 1 };
-  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
-  double point_IJK[4] = { 0, 0, 0, 1 };
-  float* voxelPtr = static_cast<float*>(vectorImage->GetScalarPointer());
-  int* extent = vectorImage->GetExtent();
-  for (point_IJK[2] = extent[4]; point_IJK[2] <= extent[5]; point_IJK[2]++)
-  {
-    for (point_IJK[1] = extent[2]; point_IJK[1] <= extent[3]; point_IJK[1]++)
-    {
-      for (point_IJK[0] = extent[0]; point_IJK[0] <= extent[1]; point_IJK[0]++)
-      {
-        ijkToRAS->MultiplyPoint(point_IJK, point_RAS);
-
-        inputTransform->TransformPoint(point_RAS, transformedPoint_RAS);
-
-        // store the pointDislocationVector_RAS components in the image
-        *(voxelPtr++) = static_cast<float>(transformedPoint_RAS[0] - point_RAS[0]);
-        *(voxelPtr++) = static_cast<float>(transformedPoint_RAS[1] - point_RAS[1]);
-        *(voxelPtr++) = static_cast<float>(transformedPoint_RAS[2] - point_RAS[2]);
-      }
-    }
-  }
+  DisplacementSamplingData samplingData;
+  samplingData.Transform = inputTransform.GetPointer();
+  samplingData.GridToRAS = ijkToRAS;
+  vectorImage->GetExtent(samplingData.GridExtent);
+  samplingData.NumberOfSamples = vectorImage->GetNumberOfPoints();
+  samplingData.FloatOutput = static_cast<float*>(vectorImage->GetScalarPointer());
+  samplingData.FloatOutputComponents = 3;
+  SampleDisplacementsParallel(&samplingData);
 
   return true;
 }
@@ -1503,6 +1586,28 @@ void vtkSlicerTransformLogic::GetTransformedNodes(
     }
 }
 
+//----------------------------------------------------------------------------
+int vtkSlicerTransformLogic::ApplyPendingTransforms(vtkMRMLScene* scene)
+{
+  if (!scene)
+    {
+    return 0;
+    }
+  int numberOfUpdatedNodes = 0;
+  std::vector<vtkMRMLNode*> nodes;
+  scene->GetNodesByClass("vtkMRMLLinearTransformNode", nodes);
+  for (size_t i = 0; i < nodes.size(); ++i)
+    {
+    vtkMRMLLinearTransformNode* node =
+      vtkMRMLLinearTransformNode::SafeDownCast(nodes[i]);
+    if (node && node->ApplyPendingMatrixTransformToParent())
+      {
+      ++numberOfUpdatedNodes;
+      }
+    }
+  return numberOfUpdatedNodes;
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerTransformLogic::GetNodesRASBounds(
   const std::vector<vtkMRMLDisplayableNode*>& nodes,
@@ -155,6 +155,14 @@ class VTK_SLICER_TRANSFORMS_MODULE_LOGIC_EXPORT vtkSlicerTransformLogic : public
     const std::vector<vtkMRMLDisplayableNode*>& nodes,
     double bounds[6]);
 
+  /// Apply the pending matrices of all the linear transform nodes of the scene
+  /// (see vtkMRMLLinearTransformNode::SetPendingMatrixTransformToParent).
+  /// Meant to be called once per rendered frame by applications that stream
+  /// poses at a high rate, so that each transform node invokes at most one
+  /// TransformModifiedEvent per frame.
+  /// Returns the number of transform nodes that have been updated.
+  static int ApplyPendingTransforms(vtkMRMLScene* scene);
+
   enum TransformKind
   {
     TRANSFORM_OTHER,
@@ -159,6 +159,9 @@ void qSlicerTransformsModuleWidget::setup()
 
   // Set a static min/max range to let users freely enter values
   d->MatrixWidget->setRange(-1e10, 1e10);
+  // Refresh the matrix at most 10 times per second, so that streamed transforms
+  // (e.g., from a tracking device) don't slow down the application
+  d->MatrixWidget->setMinimumUpdateInterval(100);
 
   // Transform nodes connection
   this->connect(d->TransformToolButton, SIGNAL(clicked()),
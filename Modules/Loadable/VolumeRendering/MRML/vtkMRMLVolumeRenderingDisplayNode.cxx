@@ -24,11 +24,16 @@ Version:   $Revision: 1.2 $
 // VTK includes
 #include <vtkCommand.h>
 #include <vtkIntArray.h>
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
 
 //#include "vtkMatrix4x4.h"
 #include <sstream>
 
+//----------------------------------------------------------------------------
+static const char* FUSED_VOLUME_REFERENCE_ROLE = "fusedVolume";
+static const char* FUSED_VOLUME_PROPERTY_REFERENCE_ROLE = "fusedVolumeProperty";
+
 //----------------------------------------------------------------------------
 vtkCxxSetReferenceStringMacro(vtkMRMLVolumeRenderingDisplayNode, VolumeNodeID);
 vtkCxxSetReferenceStringMacro(vtkMRMLVolumeRenderingDisplayNode, VolumePropertyNodeID);
@@ -361,6 +366,46 @@ vtkMRMLAnnotationROINode* vtkMRMLVolumeRenderingDisplayNode::GetROINode()
   return this->ROINode;
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayNode::SetAndObserveFusedVolumeNodeID(const char *volumeNodeID)
+{
+  vtkNew<vtkIntArray> events;
+  events->InsertNextValue(vtkCommand::ModifiedEvent);
+  events->InsertNextValue(vtkMRMLVolumeNode::ImageDataModifiedEvent);
+  events->InsertNextValue(vtkMRMLTransformableNode::TransformModifiedEvent);
+  this->SetAndObserveNodeReferenceID(FUSED_VOLUME_REFERENCE_ROLE, volumeNodeID, events.GetPointer());
+}
+
+//----------------------------------------------------------------------------
+const char* vtkMRMLVolumeRenderingDisplayNode::GetFusedVolumeNodeID()
+{
+  return this->GetNodeReferenceID(FUSED_VOLUME_REFERENCE_ROLE);
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeNode* vtkMRMLVolumeRenderingDisplayNode::GetFusedVolumeNode()
+{
+  return vtkMRMLVolumeNode::SafeDownCast(this->GetNodeReference(FUSED_VOLUME_REFERENCE_ROLE));
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayNode::SetAndObserveFusedVolumePropertyNodeID(const char *volumePropertyNodeID)
+{
+  this->SetAndObserveNodeReferenceID(FUSED_VOLUME_PROPERTY_REFERENCE_ROLE, volumePropertyNodeID);
+}
+
+//----------------------------------------------------------------------------
+const char* vtkMRMLVolumeRenderingDisplayNode::GetFusedVolumePropertyNodeID()
+{
+  return this->GetNodeReferenceID(FUSED_VOLUME_PROPERTY_REFERENCE_ROLE);
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumePropertyNode* vtkMRMLVolumeRenderingDisplayNode::GetFusedVolumePropertyNode()
+{
+  return vtkMRMLVolumePropertyNode::SafeDownCast(this->GetNodeReference(FUSED_VOLUME_PROPERTY_REFERENCE_ROLE));
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLVolumeRenderingDisplayNode::ProcessMRMLEvents(vtkObject *caller,
                                                           unsigned long event,
@@ -380,6 +425,13 @@ void vtkMRMLVolumeRenderingDisplayNode::ProcessMRMLEvents(vtkObject *caller,
     {
     this->InvokeEvent(vtkCommand::ModifiedEvent, NULL);
     }
+  // Changes of the fused volume require updating the fused image
+  vtkMRMLNode* callerNode = vtkMRMLNode::SafeDownCast(caller);
+  if (callerNode != NULL &&
+      (callerNode == this->GetFusedVolumeNode() || callerNode == this->GetFusedVolumePropertyNode()))
+    {
+    this->InvokeEvent(vtkCommand::ModifiedEvent, NULL);
+    }
 
   if (event == vtkCommand::StartEvent ||
       event == vtkCommand::EndEvent ||
@@ -401,4 +453,6 @@ void vtkMRMLVolumeRenderingDisplayNode::PrintSelf(ostream& os, vtkIndent indent)
   os << "ROINodeID: " << ( (this->VolumeNodeID) ? this->ROINodeID : "None" ) << "\n";
   os << "VolumePropertyNodeID: " << ( (this->VolumePropertyNodeID) ? this->VolumePropertyNodeID : "None" ) << "\n";
   os << "CroppingEnabled: " << this->CroppingEnabled << "\n";
+  os << "FusedVolumeNodeID: " << ( this->GetFusedVolumeNodeID() ? this->GetFusedVolumeNodeID() : "None" ) << "\n";
+  os << "FusedVolumePropertyNodeID: " << ( this->GetFusedVolumePropertyNodeID() ? this->GetFusedVolumePropertyNodeID() : "None" ) << "\n";
 }
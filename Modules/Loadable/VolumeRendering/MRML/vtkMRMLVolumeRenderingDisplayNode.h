@@ -79,6 +79,23 @@ public:
   /// Associated transform MRML node
   vtkMRMLAnnotationROINode* GetROINode();
 
+  /// ID of a second volume that is rendered together with the volume
+  /// node, in the same ray casting pass (e.g. PET over CT).
+  /// The fused volume is resampled into the voxel grid of the volume node,
+  /// taking into account the transforms of both nodes, and rendered as
+  /// the second, independent component of the volume.
+  /// Only single component volumes can be fused.
+  void SetAndObserveFusedVolumeNodeID(const char *volumeNodeID);
+  const char* GetFusedVolumeNodeID();
+  vtkMRMLVolumeNode* GetFusedVolumeNode();
+
+  /// ID of the volume property node used to render the fused volume.
+  /// Fusion is enabled only if both the fused volume and its volume
+  /// property are set.
+  void SetAndObserveFusedVolumePropertyNodeID(const char *volumePropertyNodeID);
+  const char* GetFusedVolumePropertyNodeID();
+  vtkMRMLVolumePropertyNode* GetFusedVolumePropertyNode();
+
   /// Is cropping enabled?
   vtkSetMacro(CroppingEnabled,int);
   vtkGetMacro(CroppingEnabled,int);
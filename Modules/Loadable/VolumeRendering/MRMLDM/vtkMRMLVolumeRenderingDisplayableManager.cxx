@@ -46,8 +46,11 @@
 #include <vtkAbstractTransform.h>
 #include <vtkCallbackCommand.h>
 #include "vtkFixedPointVolumeRayCastMapper.h"
+#include <vtkGeneralTransform.h>
 #include "vtkGPUVolumeRayCastMapper.h"
+#include <vtkImageAppendComponents.h>
 #include "vtkImageData.h"
+#include <vtkImageReslice.h>
 #include "vtkInteractorStyle.h"
 #include "vtkLookupTable.h"
 #include "vtkMatrix4x4.h"
@@ -86,6 +89,11 @@ vtkMRMLVolumeRenderingDisplayableManager::vtkMRMLVolumeRenderingDisplayableManag
   this->MapperRaycast = NULL;
   this->MapperGPURaycast3 = NULL;
   this->Volume = NULL;
+  this->FusedVolumeReslice = vtkImageReslice::New();
+  this->FusedVolumeReslice->SetInterpolationModeToLinear();
+  this->FusedImageAppend = vtkImageAppendComponents::New();
+  this->FusedVolumeProperty = vtkVolumeProperty::New();
+  this->RenderedPyramidLevel = 0;
   //this->Histograms = vtkKWHistogramSet::New();
   //this->HistogramsFg = vtkKWHistogramSet::New();
   //this->VolumePropertyGPURaycast3 = NULL;
@@ -142,6 +150,9 @@ vtkMRMLVolumeRenderingDisplayableManager::~vtkMRMLVolumeRenderingDisplayableMana
   vtkSetMRMLNodeMacro(this->MapperRaycast, NULL);
   vtkSetMRMLNodeMacro(this->MapperGPURaycast3, NULL);
   vtkSetMRMLNodeMacro(this->Volume, NULL);
+  this->FusedVolumeReslice->Delete();
+  this->FusedImageAppend->Delete();
+  this->FusedVolumeProperty->Delete();
   /**
   if(this->Histograms != NULL)
   {
@@ -458,8 +469,14 @@ int vtkMRMLVolumeRenderingDisplayableManager
     }
   vtkRenderWindow* window = this->GetRenderer()->GetRenderWindow();
 
-  volumeMapper->SetInputData(vtkMRMLScalarVolumeNode::SafeDownCast(
-                           vspNode->GetVolumeNode())->GetImageData() );
+  if (this->IsFusionEnabled(vspNode))
+    {
+    volumeMapper->SetInputConnection(this->FusedImageAppend->GetOutputPort());
+    }
+  else
+    {
+    volumeMapper->SetInputData(this->GetRenderedImageData(vspNode));
+    }
   int supported = 0;
   if (volumeMapper->IsA("vtkFixedPointVolumeRayCastMapper"))
     {
@@ -468,7 +485,7 @@ int vtkMRMLVolumeRenderingDisplayableManager
   else if (volumeMapper->IsA("vtkGPUVolumeRayCastMapper"))
     {
     supported = vtkGPUVolumeRayCastMapper::SafeDownCast(volumeMapper)->IsRenderSupported(
-      window,vspNode->GetVolumePropertyNode()->GetVolumeProperty());
+      window, this->GetRenderedVolumeProperty(vspNode));
     }
   //std::cout << vspNode->GetClassName() << " mapper supported: " << supported << std::endl;
   return supported;
@@ -508,6 +525,25 @@ void vtkMRMLVolumeRenderingDisplayableManager
     events->InsertNextValue(vtkCommand::ModifiedEvent);
     vtkObserveMRMLNodeEventsMacro(volumeNode, events.GetPointer());
     }
+  if (this->IsFusionEnabled(vspNode))
+    {
+    this->UpdateFusedImage(vspNode);
+    vtkVolumeMapper* volumeMapper = this->GetVolumeMapper(vspNode);
+    if (volumeMapper)
+      {
+      volumeMapper->SetInputConnection(0, this->FusedImageAppend->GetOutputPort());
+      }
+    return;
+    }
+  if (this->RenderedPyramidLevel > 0)
+    {
+    vtkVolumeMapper* volumeMapper = this->GetVolumeMapper(vspNode);
+    if (volumeMapper)
+      {
+      volumeMapper->SetInputData(this->GetRenderedImageData(vspNode));
+      }
+    return;
+    }
   this->SetupMapperFromVolumeNode(volumeNode, this->GetVolumeMapper(vspNode), 0);
 }
 
@@ -548,8 +584,7 @@ int vtkMRMLVolumeRenderingDisplayableManager
        this->UpdateMapper(vspNode))
     {
     volumeMapper = this->GetVolumeMapper(vspNode);
-    volumeProperty = vspNode->GetVolumePropertyNode() ?
-      vspNode->GetVolumePropertyNode()->GetVolumeProperty() : 0;
+    volumeProperty = this->GetRenderedVolumeProperty(vspNode);
     }
 
   this->Volume->SetMapper(volumeMapper);
@@ -564,6 +599,173 @@ int vtkMRMLVolumeRenderingDisplayableManager
   return (volumeMapper != 0 ? 1 : -1);
 }
 
+//---------------------------------------------------------------------------
+bool vtkMRMLVolumeRenderingDisplayableManager
+::IsFusionEnabled(vtkMRMLVolumeRenderingDisplayNode* vspNode)
+{
+  if (!vspNode || !vspNode->GetVolumePropertyNode() || !vspNode->GetFusedVolumePropertyNode())
+    {
+    return false;
+    }
+  vtkMRMLVolumeNode* volumeNode = vspNode->GetVolumeNode();
+  vtkMRMLVolumeNode* fusedVolumeNode = vspNode->GetFusedVolumeNode();
+  if (!volumeNode || !fusedVolumeNode || volumeNode == fusedVolumeNode
+    || !volumeNode->GetImageData() || !fusedVolumeNode->GetImageData())
+    {
+    return false;
+    }
+  // Each volume becomes one independent component of the rendered image
+  return volumeNode->GetImageData()->GetNumberOfScalarComponents() == 1
+    && fusedVolumeNode->GetImageData()->GetNumberOfScalarComponents() == 1;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager
+::UpdateFusedImage(vtkMRMLVolumeRenderingDisplayNode* vspNode)
+{
+  vtkMRMLVolumeNode* volumeNode = vspNode->GetVolumeNode();
+  vtkMRMLVolumeNode* fusedVolumeNode = vspNode->GetFusedVolumeNode();
+  vtkImageData* imageData = volumeNode->GetImageData();
+
+  // volume IJK -> volume RAS -> fused volume RAS -> fused volume IJK,
+  // the transform between the two volumes may be non-linear.
+  vtkNew<vtkGeneralTransform> volumeIJKToFusedIJK;
+  volumeIJKToFusedIJK->PostMultiply();
+  vtkNew<vtkMatrix4x4> volumeIJKToRAS;
+  volumeNode->GetIJKToRASMatrix(volumeIJKToRAS.GetPointer());
+  volumeIJKToFusedIJK->Concatenate(volumeIJKToRAS.GetPointer());
+  vtkNew<vtkGeneralTransform> volumeRASToFusedRAS;
+  vtkMRMLTransformNode::GetTransformBetweenNodes(volumeNode->GetParentTransformNode(),
+    fusedVolumeNode->GetParentTransformNode(), volumeRASToFusedRAS.GetPointer());
+  volumeIJKToFusedIJK->Concatenate(volumeRASToFusedRAS.GetPointer());
+  vtkNew<vtkMatrix4x4> fusedRASToIJK;
+  fusedVolumeNode->GetRASToIJKMatrix(fusedRASToIJK.GetPointer());
+  volumeIJKToFusedIJK->Concatenate(fusedRASToIJK.GetPointer());
+
+  this->FusedVolumeReslice->SetInputConnection(fusedVolumeNode->GetImageDataConnection());
+  this->FusedVolumeReslice->SetResliceTransform(volumeIJKToFusedIJK.GetPointer());
+  this->FusedVolumeReslice->SetOutputExtent(imageData->GetExtent());
+  this->FusedVolumeReslice->SetOutputOrigin(imageData->GetOrigin());
+  this->FusedVolumeReslice->SetOutputSpacing(imageData->GetSpacing());
+  // components must have the same scalar type
+  this->FusedVolumeReslice->SetOutputScalarType(imageData->GetScalarType());
+
+  this->FusedImageAppend->SetInputConnection(0, volumeNode->GetImageDataConnection());
+  this->FusedImageAppend->AddInputConnection(0, this->FusedVolumeReslice->GetOutputPort());
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager
+::UpdateFusedVolumeProperty(vtkMRMLVolumeRenderingDisplayNode* vspNode)
+{
+  vtkVolumeProperty* properties[2] =
+    {
+    vspNode->GetVolumePropertyNode()->GetVolumeProperty(),
+    vspNode->GetFusedVolumePropertyNode()->GetVolumeProperty()
+    };
+  vtkVolumeProperty* fusedProperty = this->FusedVolumeProperty;
+  fusedProperty->SetIndependentComponents(1);
+  fusedProperty->SetInterpolationType(properties[0]->GetInterpolationType());
+  for (int component = 0; component < 2; ++component)
+    {
+    vtkVolumeProperty* prop = properties[component];
+    if (prop->GetColorChannels(0) == 3)
+      {
+      fusedProperty->SetColor(component, prop->GetRGBTransferFunction(0));
+      }
+    else
+      {
+      fusedProperty->SetColor(component, prop->GetGrayTransferFunction(0));
+      }
+    fusedProperty->SetScalarOpacity(component, prop->GetScalarOpacity(0));
+    fusedProperty->SetGradientOpacity(component, prop->GetGradientOpacity(0));
+    fusedProperty->SetScalarOpacityUnitDistance(component, prop->GetScalarOpacityUnitDistance(0));
+    fusedProperty->SetDisableGradientOpacity(component, prop->GetDisableGradientOpacity(0));
+    fusedProperty->SetShade(component, prop->GetShade(0));
+    fusedProperty->SetAmbient(component, prop->GetAmbient(0));
+    fusedProperty->SetDiffuse(component, prop->GetDiffuse(0));
+    fusedProperty->SetSpecular(component, prop->GetSpecular(0));
+    fusedProperty->SetSpecularPower(component, prop->GetSpecularPower(0));
+    fusedProperty->SetComponentWeight(component, 1.0);
+    }
+}
+
+//---------------------------------------------------------------------------
+vtkVolumeProperty* vtkMRMLVolumeRenderingDisplayableManager
+::GetRenderedVolumeProperty(vtkMRMLVolumeRenderingDisplayNode* vspNode)
+{
+  if (this->IsFusionEnabled(vspNode))
+    {
+    this->UpdateFusedVolumeProperty(vspNode);
+    return this->FusedVolumeProperty;
+    }
+  return (vspNode && vspNode->GetVolumePropertyNode()) ?
+    vspNode->GetVolumePropertyNode()->GetVolumeProperty() : 0;
+}
+
+//---------------------------------------------------------------------------
+int vtkMRMLVolumeRenderingDisplayableManager
+::GetProxyPyramidLevel(vtkMRMLVolumeRenderingDisplayNode* vspNode)
+{
+  vtkMRMLScalarVolumeNode* volumeNode = vspNode ?
+    vtkMRMLScalarVolumeNode::SafeDownCast(vspNode->GetVolumeNode()) : 0;
+  if (!volumeNode || !volumeNode->GetImageData() || this->IsFusionEnabled(vspNode))
+    {
+    return 0;
+    }
+  int dimensions[3] = {0, 0, 0};
+  volumeNode->GetImageData()->GetDimensions(dimensions);
+  // Coarsest level that the mappers can still render (at least 2 voxels
+  // along each axis that has more than one voxel)
+  int level = 0;
+  while (level < volumeNode->GetMaximumPyramidLevel())
+    {
+    bool canShrink = false;
+    for (int i = 0; i < 3; ++i)
+      {
+      if (dimensions[i] > 1)
+        {
+        dimensions[i] /= 2;
+        canShrink = true;
+        if (dimensions[i] < 2)
+          {
+          return level;
+          }
+        }
+      }
+    if (!canShrink)
+      {
+      break;
+      }
+    ++level;
+    }
+  return level;
+}
+
+//---------------------------------------------------------------------------
+vtkImageData* vtkMRMLVolumeRenderingDisplayableManager
+::GetRenderedImageData(vtkMRMLVolumeRenderingDisplayNode* vspNode)
+{
+  vtkMRMLVolumeNode* volumeNode = vspNode ? vspNode->GetVolumeNode() : 0;
+  if (!volumeNode)
+    {
+    return 0;
+    }
+  vtkMRMLScalarVolumeNode* scalarVolumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(volumeNode);
+  if (this->RenderedPyramidLevel > 0 && scalarVolumeNode)
+    {
+    // Pyramid levels are defined in the IJK space of the image data, so the
+    // IJKToRAS matrix of the volume actor applies unchanged.
+    vtkImageData* levelImageData =
+      scalarVolumeNode->GetPyramidLevelImageData(this->RenderedPyramidLevel);
+    if (levelImageData)
+      {
+      return levelImageData;
+      }
+    }
+  return volumeNode->GetImageData();
+}
+
 //---------------------------------------------------------------------------
 bool vtkMRMLVolumeRenderingDisplayableManager::UpdateMapper(
   vtkMRMLVolumeRenderingDisplayNode* vspNode)
@@ -811,6 +1013,14 @@ void vtkMRMLVolumeRenderingDisplayableManager::OnCreate()
     events->InsertNextValue(vtkMRMLViewNode::GraphicalResourcesCreatedEvent);
     vtkObserveMRMLNodeEventsMacro(viewNode, events.GetPointer());
     }
+  // Refine progressively rendered volumes after each render
+  vtkRenderer* renderer = this->GetRenderer();
+  if (renderer && !vtkIsObservedMRMLNodeEventMacro(renderer, vtkCommand::EndEvent))
+    {
+    vtkNew<vtkIntArray> events;
+    events->InsertNextValue(vtkCommand::EndEvent);
+    vtkObserveMRMLNodeEventsMacro(renderer, events.GetPointer());
+    }
 
   this->UpdateDisplayNodeList();
 
@@ -892,6 +1102,16 @@ void vtkMRMLVolumeRenderingDisplayableManager
           }
       }
     }
+  else if (event == vtkCommand::EndEvent && caller == this->GetRenderer())
+    {
+    if (this->RenderedPyramidLevel > 0)
+      {
+      // The coarse level has been rendered, replace it by the full resolution
+      this->RenderedPyramidLevel = 0;
+      this->SetupMapperFromVolumeNode(this->DisplayedNode);
+      this->RequestRender();
+      }
+    }
   else if (event == vtkCommand::StartEvent ||
            event == vtkCommand::StartInteractionEvent)
     {
@@ -937,6 +1157,9 @@ void vtkMRMLVolumeRenderingDisplayableManager
     }
   else if (event == vtkMRMLScalarVolumeNode::ImageDataModifiedEvent)
     {
+    // Show a coarse level of the volume first if the volume has a pyramid:
+    // its texture is much smaller and the full resolution is rendered next.
+    this->RenderedPyramidLevel = this->GetProxyPyramidLevel(this->DisplayedNode);
     this->SetupMapperFromVolumeNode(this->DisplayedNode);
     this->RequestRender();
     }
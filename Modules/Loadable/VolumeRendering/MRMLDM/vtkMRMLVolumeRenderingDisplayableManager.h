@@ -25,6 +25,9 @@
 #include "vtkSlicerVolumeRenderingModuleMRMLDisplayableManagerExport.h"
 class vtkGPUVolumeRayCastMapper;
 class vtkFixedPointVolumeRayCastMapper;
+class vtkImageAppendComponents;
+class vtkImageData;
+class vtkImageReslice;
 class vtkMRMLCPURayCastVolumeRenderingDisplayNode;
 class vtkMRMLGPURayCastVolumeRenderingDisplayNode;
 class vtkMRMLVolumeNode;
@@ -189,6 +192,21 @@ protected:
 
   //vtkVolumeProperty *VolumePropertyGPURaycast3;
 
+  /// Resample the fused volume into the voxel grid of the displayed volume
+  vtkImageReslice *FusedVolumeReslice;
+
+  /// Combine the displayed and the fused volume into a two-component image,
+  /// so that both are sampled along each ray in a single pass
+  vtkImageAppendComponents *FusedImageAppend;
+
+  /// Volume property with independent components, built from the volume
+  /// properties of the displayed and the fused volume
+  vtkVolumeProperty *FusedVolumeProperty;
+
+  /// Level of the multi-resolution pyramid of the volume that is rendered,
+  /// 0 when the full resolution image data is rendered.
+  int RenderedPyramidLevel;
+
   vtkMRMLVolumeRenderingDisplayNode*    DisplayedNode;
 
   typedef std::map<std::string, vtkMRMLVolumeRenderingDisplayNode *> DisplayNodesType;
@@ -218,6 +236,24 @@ protected:
   double GetFramerate(vtkMRMLVolumeRenderingDisplayNode* vspNode);
   virtual vtkIdType GetMaxMemoryInBytes(vtkVolumeMapper* mapper, vtkMRMLVolumeRenderingDisplayNode* vspNode);
 
+  /// Return true if the display node has a valid fused volume and
+  /// volume property, and both volumes can be combined.
+  bool IsFusionEnabled(vtkMRMLVolumeRenderingDisplayNode* vspNode);
+  /// Update the pipeline combining the volume and the fused volume.
+  void UpdateFusedImage(vtkMRMLVolumeRenderingDisplayNode* vspNode);
+  /// Copy the volume properties of the volume and the fused volume into
+  /// the components of FusedVolumeProperty.
+  void UpdateFusedVolumeProperty(vtkMRMLVolumeRenderingDisplayNode* vspNode);
+  /// Return the volume property that is used for rendering the display node.
+  vtkVolumeProperty* GetRenderedVolumeProperty(vtkMRMLVolumeRenderingDisplayNode* vspNode);
+
+  /// Return the pyramid level that is rendered first after the image data
+  /// of the volume is modified, 0 if the volume has no pyramid.
+  /// \sa vtkMRMLScalarVolumeNode::SetMaximumPyramidLevel()
+  int GetProxyPyramidLevel(vtkMRMLVolumeRenderingDisplayNode* vspNode);
+  /// Return the image data (full resolution or pyramid level) to render.
+  vtkImageData* GetRenderedImageData(vtkMRMLVolumeRenderingDisplayNode* vspNode);
+
 };
 
 #endif
@@ -39,14 +39,19 @@
 
 // MRML includes
 #include "qSlicerPresetComboBox.h"
+#include "vtkSlicerVolumeRenderingLogic.h"
 #include <vtkMRMLScene.h>
+#include <vtkMRMLVectorVolumeNode.h>
 #include <vtkMRMLVolumePropertyNode.h>
 #include <vtkMRMLViewNode.h>
 
 // VTK includes
 #include <vtkNew.h>
 #include <vtkColorTransferFunction.h>
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
 #include <vtkPiecewiseFunction.h>
+#include <vtkPointData.h>
 
 #if QT_VERSION < 0x040700
 //static QImage pixmapCacheLoader( const QString& name, const QString &context )
@@ -66,6 +71,7 @@ private slots:
 
   void testSetScene();
   void testAddPresetNode();
+  void testDeferredIcons();
   void testPreview();
 };
 
@@ -118,6 +124,69 @@ void qSlicerPresetComboBoxTester::testAddPresetNode()
   presetComboBox.show();
   //qApp->exec();
 }
+// ----------------------------------------------------------------------------
+namespace
+{
+void addPresetWithIcon(vtkMRMLScene* scene, const char* name)
+{
+  vtkNew<vtkImageData> iconImage;
+  iconImage->SetDimensions(4, 4, 1);
+  iconImage->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  iconImage->GetPointData()->GetScalars()->Fill(128);
+  vtkNew<vtkMRMLVectorVolumeNode> iconNode;
+  iconNode->SetAndObserveImageData(iconImage.GetPointer());
+  scene->AddNode(iconNode.GetPointer());
+
+  vtkNew<vtkMRMLVolumePropertyNode> presetNode;
+  presetNode->SetName(name);
+  vtkNew<vtkColorTransferFunction> colorFunction;
+  colorFunction->AddRGBPoint(0., 0., 0., 0.);
+  colorFunction->AddRGBPoint(255., 1., 1., 1.);
+  presetNode->SetColor(colorFunction.GetPointer());
+  presetNode->SetNodeReferenceID(
+    vtkSlicerVolumeRenderingLogic::GetIconVolumeReferenceRole(), iconNode->GetID());
+  scene->AddNode(presetNode.GetPointer());
+}
+}
+
+// ----------------------------------------------------------------------------
+void qSlicerPresetComboBoxTester::testDeferredIcons()
+{
+  qSlicerPresetComboBox presetComboBox;
+
+  vtkNew<vtkMRMLScene> scene;
+  presetComboBox.setMRMLScene(scene.GetPointer());
+
+  addPresetWithIcon(scene.GetPointer(), "Preset1");
+  addPresetWithIcon(scene.GetPointer(), "Preset2");
+  addPresetWithIcon(scene.GetPointer(), "Preset3");
+  QCOMPARE(presetComboBox.nodeCount(), 3);
+
+  // Only the current preset gets its icon before the popup is shown
+  presetComboBox.setCurrentNode(presetComboBox.nodeFromIndex(0));
+  int currentIndex = presetComboBox.comboBox()->currentIndex();
+  for (int i = 0; i < presetComboBox.comboBox()->count(); ++i)
+    {
+    QCOMPARE(presetComboBox.comboBox()->itemIcon(i).isNull(), i != currentIndex);
+    }
+
+  presetComboBox.show();
+  presetComboBox.comboBox()->showPopup();
+  for (int i = 0; i < presetComboBox.comboBox()->count(); ++i)
+    {
+    QVERIFY(!presetComboBox.comboBox()->itemIcon(i).isNull());
+    }
+  presetComboBox.comboBox()->hidePopup();
+
+  // Presets added after the popup was shown get their icon right away
+  addPresetWithIcon(scene.GetPointer(), "Preset4");
+  QCOMPARE(presetComboBox.nodeCount(), 4);
+  for (int i = 0; i < presetComboBox.comboBox()->count(); ++i)
+    {
+    QVERIFY(!presetComboBox.comboBox()->itemIcon(i).isNull());
+    }
+}
+
 // ----------------------------------------------------------------------------
 void qSlicerPresetComboBoxTester::testPreview()
 {
@@ -47,6 +47,9 @@
 #include <vtkRenderWindow.h>
 #include <vtkRenderWindowInteractor.h>
 #include <vtkVersion.h>
+#include <vtkVolume.h>
+#include <vtkVolumeMapper.h>
+#include <vtkVolumeProperty.h>
 #include <vtkWindowToImageFilter.h>
 
 // STD includes
@@ -251,6 +254,146 @@ bool TestChangeImageData(int copyBehavior, vtkImageData* screenShot)
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool TestFusedVolume()
+{
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkRenderWindow> renderWindow;
+  SetupRenderer(renderWindow.GetPointer(), renderer.GetPointer());
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLApplicationLogic> applicationLogic;
+  vtkNew<vtkMRMLDisplayableManagerGroup> displayableManagerGroup;
+  SetupScene(renderer.GetPointer(), scene.GetPointer(),
+             applicationLogic.GetPointer(),
+             displayableManagerGroup.GetPointer());
+  vtkMRMLVolumeRenderingDisplayableManager* vrDisplayableManager =
+    vtkMRMLVolumeRenderingDisplayableManager::SafeDownCast(
+      displayableManagerGroup->GetDisplayableManager(0));
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  SetupVolumeNode(scene.GetPointer(), volumeNode.GetPointer());
+  vtkMRMLVolumeRenderingDisplayNode* vrDisplayNode =
+    vtkMRMLVolumeRenderingDisplayNode::SafeDownCast(
+      scene->GetFirstNodeByClass("vtkMRMLCPURayCastVolumeRenderingDisplayNode"));
+
+  vtkNew<vtkMRMLScalarVolumeNode> fusedVolumeNode;
+  vtkNew<vtkImageData> fusedImageData;
+  SetupImageData(fusedImageData.GetPointer());
+  fusedVolumeNode->SetAndObserveImageData(fusedImageData.GetPointer());
+  fusedVolumeNode->SetOrigin(1.0, 0.0, 0.0);
+  scene->AddNode(fusedVolumeNode.GetPointer());
+  vtkNew<vtkMRMLVolumePropertyNode> fusedVolumePropertyNode;
+  scene->AddNode(fusedVolumePropertyNode.GetPointer());
+
+  vrDisplayNode->SetAndObserveFusedVolumeNodeID(fusedVolumeNode->GetID());
+  vrDisplayNode->SetAndObserveFusedVolumePropertyNodeID(fusedVolumePropertyNode->GetID());
+  vrDisplayNode->SetVisibility(1);
+  renderer->ResetCamera();
+  renderWindow->Render();
+
+  vtkVolumeMapper* mapper = vrDisplayableManager->GetVolumeMapper(vrDisplayNode);
+  mapper->GetInputAlgorithm()->Update();
+  vtkImageData* renderedImage = mapper->GetInput();
+  if (!renderedImage || renderedImage->GetNumberOfScalarComponents() != 2)
+    {
+    std::cout << __LINE__ << ": fused volume is not rendered as a second component" << std::endl;
+    return false;
+    }
+  int dimensions[3] = { 0, 0, 0 };
+  renderedImage->GetDimensions(dimensions);
+  if (dimensions[0] != 3 || dimensions[1] != 3 || dimensions[2] != 3)
+    {
+    std::cout << __LINE__ << ": fused image does not match the volume geometry" << std::endl;
+    return false;
+    }
+  // The fused volume is shifted by one voxel along the first axis
+  if (renderedImage->GetScalarComponentAsDouble(1, 1, 1, 1)
+      != fusedImageData->GetScalarComponentAsDouble(0, 1, 1, 0))
+    {
+    std::cout << __LINE__ << ": fused volume is not resampled into the volume grid" << std::endl;
+    return false;
+    }
+  vtkVolumeProperty* volumeProperty = vrDisplayableManager->GetVolumeActor()->GetProperty();
+  if (!volumeProperty->GetIndependentComponents()
+    || volumeProperty->GetScalarOpacity(1) != fusedVolumePropertyNode->GetVolumeProperty()->GetScalarOpacity(0))
+    {
+    std::cout << __LINE__ << ": fused volume property is not used" << std::endl;
+    return false;
+    }
+
+  vrDisplayNode->SetAndObserveFusedVolumeNodeID(NULL);
+  mapper->GetInputAlgorithm()->Update();
+  if (mapper->GetInput()->GetNumberOfScalarComponents() != 1)
+    {
+    std::cout << __LINE__ << ": fusion is not disabled" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestProgressiveRendering()
+{
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkRenderWindow> renderWindow;
+  SetupRenderer(renderWindow.GetPointer(), renderer.GetPointer());
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLApplicationLogic> applicationLogic;
+  vtkNew<vtkMRMLDisplayableManagerGroup> displayableManagerGroup;
+  SetupScene(renderer.GetPointer(), scene.GetPointer(),
+             applicationLogic.GetPointer(),
+             displayableManagerGroup.GetPointer());
+  vtkMRMLVolumeRenderingDisplayableManager* vrDisplayableManager =
+    vtkMRMLVolumeRenderingDisplayableManager::SafeDownCast(
+      displayableManagerGroup->GetDisplayableManager(0));
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  SetupVolumeNode(scene.GetPointer(), volumeNode.GetPointer());
+  vtkMRMLVolumeRenderingDisplayNode* vrDisplayNode =
+    vtkMRMLVolumeRenderingDisplayNode::SafeDownCast(
+      scene->GetFirstNodeByClass("vtkMRMLCPURayCastVolumeRenderingDisplayNode"));
+  vrDisplayNode->SetVisibility(1);
+  renderer->ResetCamera();
+  renderWindow->Render();
+
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(8, 8, 8);
+  imageData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  volumeNode->SetMaximumPyramidLevel(3);
+  volumeNode->SetAndObserveImageData(imageData.GetPointer());
+
+  // The coarsest level with at least 2 voxels along each axis is shown first
+  vtkVolumeMapper* mapper = vrDisplayableManager->GetVolumeMapper(vrDisplayNode);
+  int dimensions[3] = { 0, 0, 0 };
+  mapper->GetInput()->GetDimensions(dimensions);
+  if (dimensions[0] != 2 || dimensions[1] != 2 || dimensions[2] != 2)
+    {
+    std::cout << __LINE__ << ": coarse level is not rendered first, got "
+              << dimensions[0] << "x" << dimensions[1] << "x" << dimensions[2] << std::endl;
+    return false;
+    }
+
+  // The full resolution replaces it once it has been rendered
+  renderWindow->Render();
+  if (mapper->GetInput() != imageData.GetPointer())
+    {
+    std::cout << __LINE__ << ": full resolution is not rendered after the coarse level" << std::endl;
+    return false;
+    }
+
+  // Without pyramid the full resolution is rendered right away
+  volumeNode->SetMaximumPyramidLevel(0);
+  imageData->Modified();
+  if (mapper->GetInput() != imageData.GetPointer())
+    {
+    std::cout << __LINE__ << ": full resolution is not rendered" << std::endl;
+    return false;
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLVolumeRenderingMultiVolumeTest(int vtkNotUsed(argc),
                                           char* vtkNotUsed(argv)[])
@@ -288,5 +431,15 @@ int vtkMRMLVolumeRenderingMultiVolumeTest(int vtkNotUsed(argc),
       return EXIT_FAILURE;
       }
     }
+  if (!TestFusedVolume())
+    {
+    std::cout << __LINE__ << ": TestFusedVolume failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!TestProgressiveRendering())
+    {
+    std::cout << __LINE__ << ": TestProgressiveRendering failed" << std::endl;
+    return EXIT_FAILURE;
+    }
   return EXIT_SUCCESS;
 }
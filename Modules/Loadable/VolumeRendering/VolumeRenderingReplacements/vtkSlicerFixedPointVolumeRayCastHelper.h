@@ -534,7 +534,7 @@
   COLOR[1] += (TMP[1]*REMAININGOPACITY+0x7fff)>>VTKKW_FP_SHIFT;                                 \
   COLOR[2] += (TMP[2]*REMAININGOPACITY+0x7fff)>>VTKKW_FP_SHIFT;                                 \
   REMAININGOPACITY = (REMAININGOPACITY*((~(TMP[3])&VTKKW_FP_MASK))+0x7fff)>>VTKKW_FP_SHIFT;     \
-  if ( REMAININGOPACITY < 0xff )                                                                \
+  if ( REMAININGOPACITY < remainingOpacityThreshold )                                           \
     {                                                                                           \
     break;                                                                                      \
     }
@@ -696,6 +696,8 @@
   int components                     = mapper->GetInput()->GetNumberOfScalarComponents();       \
   int cropping                       = (mapper->GetCropping() &&                                \
                                         mapper->GetCroppingRegionFlags() != 0x2000 );           \
+  unsigned short remainingOpacityThreshold = mapper->GetRemainingOpacityThreshold();            \
+  (void)(remainingOpacityThreshold);                                                            \
                                                                                                 \
   unsigned short *colorTable[4];                                                                \
   unsigned short *scalarOpacityTable[4];                                                        \
@@ -41,6 +41,8 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkSlicerFixedPointRayCastImage.h"
 #include <vtkVersion.h>
 
+#include <vector>
+
 
 vtkStandardNewMacro(vtkSlicerFixedPointVolumeRayCastMapper);
 vtkCxxSetObjectMacro(vtkSlicerFixedPointVolumeRayCastMapper, RayCastImage, vtkSlicerFixedPointRayCastImage);
@@ -509,6 +511,9 @@ vtkSlicerFixedPointVolumeRayCastMapper::vtkSlicerFixedPointVolumeRayCastMapper()
     this->Volume = NULL;
     //SLICERADD
     this->ManualInteractive=0;
+    // Default threshold: stop when less than 0xff/0x7fff opacity remains
+    this->RemainingOpacityThreshold = 0xff;
+    this->EarlyRayTerminationOpacity = 1.0 - 0xff / VTKKW_FP_SCALE;
     //ENDSLICERADD
 
 
@@ -977,21 +982,22 @@ void vtkSlicerFixedPointVolumeRayCastMapper::UpdateMinMaxVolume( vtkVolume *vol
         this->SavedMinMaxBuildTime.Modified();
     }
 
-    // Update the flags now
-    unsigned short *minNonZeroScalarIndex = new unsigned short [this->MinMaxVolumeSize[3]];
+    // Update the flags now. For each component, count the scalar values with
+    // non-zero opacity up to each table index, so that whether a block
+    // contains any visible scalar value is known from its min and max
+    // without searching the opacity table.
+    std::vector<unsigned int> nonZeroScalarCount[4];
     for ( c = 0; c < this->MinMaxVolumeSize[3]; c++ )
     {
+        nonZeroScalarCount[c].resize( this->TableSize[c] + 1, 0 );
         for ( i = 0; i < this->TableSize[c]; i++ )
         {
-            if ( this->ScalarOpacityTable[c][i] )
-            {
-                break;
-            }
+            nonZeroScalarCount[c][i+1] = nonZeroScalarCount[c][i] +
+                ( this->ScalarOpacityTable[c][i] ? 1 : 0 );
         }
-        minNonZeroScalarIndex[c] = i;
     }
 
-    unsigned char *minNonZeroGradientMagnitudeIndex = new unsigned char [this->MinMaxVolumeSize[3]];
+    unsigned char minNonZeroGradientMagnitudeIndex[4];
     for ( c = 0; c < this->MinMaxVolumeSize[3]; c++ )
     {
         for ( i = 0; i < 256; i++ )
@@ -1001,12 +1007,10 @@ void vtkSlicerFixedPointVolumeRayCastMapper::UpdateMinMaxVolume( vtkVolume *vol
                 break;
             }
         }
-        minNonZeroGradientMagnitudeIndex[c] = i;
+        minNonZeroGradientMagnitudeIndex[c] = static_cast<unsigned char>( (i < 256)?(i):(255) );
     }
 
     unsigned short *tmpPtr = this->MinMaxVolume;
-    int zero = 0;
-    int nonZero = 0;
 
     for ( k = 0; k < this->MinMaxVolumeSize[2]; k++ )
     {
@@ -1016,58 +1020,23 @@ void vtkSlicerFixedPointVolumeRayCastMapper::UpdateMinMaxVolume( vtkVolume *vol
             {
                 for ( c = 0; c < this->MinMaxVolumeSize[3]; c++ )
                 {
-                    // We definite have 0 opacity because our maximum scalar value in
-                    // this region is below the minimum scalar value with non-zero opacity
-                    // for this component
-                    if ( tmpPtr[1] < minNonZeroScalarIndex[c] )
-                    {
-                        tmpPtr[2] &= 0xff00;
-                        zero++;
-                    }
-                    // We have 0 opacity because we are using gradient magnitudes and
-                    // the maximum gradient magnitude in this area is below the minimum
-                    // gradient magnitude with non-zero opacity for this component
-                    else if ( this->GradientOpacityRequired &&
+                    tmpPtr[2] &= 0xff00;
+                    int tableSize = this->TableSize[c];
+                    int minIndex = (tmpPtr[0] < tableSize)?(tmpPtr[0]):(tableSize);
+                    int maxIndex = (tmpPtr[1] < tableSize)?(tmpPtr[1] + 1):(tableSize);
+                    // Visible if any scalar between min and max has non-zero opacity ...
+                    bool visible = minIndex < maxIndex &&
+                        nonZeroScalarCount[c][maxIndex] > nonZeroScalarCount[c][minIndex];
+                    // ... and, when gradient opacity is used, the maximum gradient
+                    // magnitude reaches a value with non-zero gradient opacity
+                    if ( visible && this->GradientOpacityRequired &&
                         (tmpPtr[2]>>8) < minNonZeroGradientMagnitudeIndex[c] )
                     {
-                        tmpPtr[2] &= 0xff00;
-                        zero++;
+                        visible = false;
                     }
-                    // We definitely have non-zero opacity because our minimum scalar
-                    // value is lower than our first scalar with non-zero opacity, and
-                    // the maximum scalar value is greater than this threshold - so
-                    // we must encounter scalars with opacity in between
-                    else if ( tmpPtr[0] < minNonZeroScalarIndex[c] )
+                    if ( visible )
                     {
-                        tmpPtr[2] &= 0xff00;
                         tmpPtr[2] |= 0x0001;
-                        nonZero++;
-                    }
-                    // We have to search between min scalar value and the
-                    // max scalar stored in the minmax volume to look for non-zero
-                    // opacity since both values must be above our first non-zero
-                    // threshold so we don't have information in this area
-                    else
-                    {
-                        int loop;
-                        for ( loop = tmpPtr[0]; loop <= tmpPtr[1]; loop++ )
-                        {
-                            if ( this->ScalarOpacityTable[c][loop] )
-                            {
-                                break;
-                            }
-                        }
-                        if ( loop <= tmpPtr[1] )
-                        {
-                            tmpPtr[2] &= 0xff00;
-                            tmpPtr[2] |= 0x0001;
-                            nonZero++;
-                        }
-                        else
-                        {
-                            tmpPtr[2] &= 0xff00;
-                            zero++;
-                        }
                     }
                     tmpPtr += 3;
                 }
@@ -3090,6 +3059,19 @@ int vtkSlicerFixedPointVolumeRayCastMapper::ShouldUseNearestNeighborInterpolatio
     return ( vol->GetProperty()->GetInterpolationType() == VTK_NEAREST_INTERPOLATION );
 }
 
+void vtkSlicerFixedPointVolumeRayCastMapper::SetEarlyRayTerminationOpacity( float opacity )
+{
+    opacity = (opacity < 0.5f)?(0.5f):((opacity > 1.0f)?(1.0f):(opacity));
+    if ( this->EarlyRayTerminationOpacity == opacity )
+    {
+        return;
+    }
+    this->EarlyRayTerminationOpacity = opacity;
+    this->RemainingOpacityThreshold =
+        static_cast<unsigned short>( (1.0 - opacity) * VTKKW_FP_SCALE + 0.5 );
+    this->Modified();
+}
+
 // Print method for vtkSlicerFixedPointVolumeRayCastMapper
 void vtkSlicerFixedPointVolumeRayCastMapper::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -3106,6 +3088,8 @@ void vtkSlicerFixedPointVolumeRayCastMapper::PrintSelf(ostream& os, vtkIndent in
         << this->MaximumImageSampleDistance << endl;
     os << indent << "Auto Adjust Sample Distances: "
         << this->AutoAdjustSampleDistances << endl;
+    os << indent << "Early Ray Termination Opacity: "
+        << this->EarlyRayTerminationOpacity << endl;
     os << indent << "Intermix Intersecting Geometry: "
         << (this->IntermixIntersectingGeometry ? "On\n" : "Off\n");
 
@@ -97,6 +97,17 @@ public:
     vtkGetMacro(ManualInteractiveRate,double);
     vtkSetMacro(ManualInteractiveRate,double);
 
+  // Description:
+  // Accumulated opacity at which a ray is terminated (between 0.5 and 1.0).
+  // Lower values stop rays earlier in dense regions, which is faster but
+  // slightly less accurate. 1.0 disables early ray termination.
+  void SetEarlyRayTerminationOpacity( float opacity );
+  vtkGetMacro(EarlyRayTerminationOpacity,float);
+
+  // Description:
+  // WARNING: INTERNAL METHOD - NOT INTENDED FOR GENERAL USE
+  // Remaining (fixed point) opacity below which rays are terminated.
+  unsigned short GetRemainingOpacityThreshold() {return this->RemainingOpacityThreshold;}
   //ENDSLICERADD
 
   static vtkSlicerFixedPointVolumeRayCastMapper *New();
@@ -263,6 +274,8 @@ protected:
     //SLICERADD
     int ManualInteractive;
     double ManualInteractiveRate;
+    float EarlyRayTerminationOpacity;
+    unsigned short RemainingOpacityThreshold;
   //ENDSLICERADD
 
 
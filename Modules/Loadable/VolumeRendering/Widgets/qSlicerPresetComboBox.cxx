@@ -69,6 +69,7 @@ qSlicerIconComboBox::qSlicerIconComboBox(QWidget* parentWidget)
 //-----------------------------------------------------------------------------
 void qSlicerIconComboBox::showPopup()
 {
+  emit popupAboutToBeShown();
   QFrame* container = qobject_cast<QFrame*>(this->view()->parentWidget());
   QStyleOptionComboBox opt;
   initStyleOption(&opt);
@@ -133,6 +134,7 @@ qSlicerPresetComboBoxPrivate::qSlicerPresetComboBoxPrivate(
   qSlicerPresetComboBox& object)
   : q_ptr(&object)
 {
+  this->IconsDeferred = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -161,7 +163,9 @@ void qSlicerPresetComboBoxPrivate::init()
   //sceneModel->setToolTipNameColumn(0);
 
   QObject::connect(q, SIGNAL(nodeAdded(vtkMRMLNode*)),
-                   q, SLOT(setIconToPreset(vtkMRMLNode*)));
+                   q, SLOT(onPresetAdded(vtkMRMLNode*)));
+  QObject::connect(comboBox, SIGNAL(popupAboutToBeShown()),
+                   q, SLOT(setIconsToPresets()));
   QObject::connect(q, SIGNAL(currentNodeChanged(vtkMRMLNode*)),
                    q, SLOT(updateComboBoxTitleAndIcon(vtkMRMLNode*)));
 }
@@ -202,8 +206,20 @@ void qSlicerPresetComboBox::setIconToPreset(vtkMRMLNode* presetNode)
     }
   if (presetIcon.availableSizes().size() == 0)
     {
-    // Check if an image is available for this preset in the stock preset images
-    presetIcon = QIcon(QString(":/presets/") + presetNode->GetName());
+    // Check if an image is available for this preset in the stock preset images.
+    // Decoded stock images are cached so that they are read only once even if
+    // the presets are added again or shown in multiple combo boxes.
+    QString stockIconPath = QString(":/presets/") + presetNode->GetName();
+    QPixmap stockPixmap;
+    if (!QPixmapCache::find(stockIconPath, &stockPixmap)
+        && stockPixmap.load(stockIconPath))
+      {
+      QPixmapCache::insert(stockIconPath, stockPixmap);
+      }
+    if (!stockPixmap.isNull())
+      {
+      presetIcon = QIcon(stockPixmap);
+      }
     }
   if (presetIcon.availableSizes().size() == 0)
     {
@@ -244,12 +260,43 @@ void qSlicerPresetComboBox::setIconToPreset(vtkMRMLNode* presetNode)
     }
 }
 
+// --------------------------------------------------------------------------
+void qSlicerPresetComboBox::onPresetAdded(vtkMRMLNode* presetNode)
+{
+  Q_D(qSlicerPresetComboBox);
+  if (d->IconsDeferred)
+    {
+    return;
+    }
+  this->setIconToPreset(presetNode);
+}
+
+// --------------------------------------------------------------------------
+void qSlicerPresetComboBox::setIconsToPresets()
+{
+  Q_D(qSlicerPresetComboBox);
+  d->IconsDeferred = false;
+  qMRMLSceneModel* sceneModel = qobject_cast<qMRMLSceneModel*>(this->sortFilterProxyModel()->sourceModel());
+  for (int i = 0; i < this->nodeCount(); ++i)
+    {
+    vtkMRMLNode* presetNode = this->nodeFromIndex(i);
+    if (sceneModel->data(sceneModel->indexFromNode(presetNode), Qt::DecorationRole).isNull())
+      {
+      this->setIconToPreset(presetNode);
+      }
+    }
+}
+
 // --------------------------------------------------------------------------
 void qSlicerPresetComboBox::updateComboBoxTitleAndIcon(vtkMRMLNode* node)
 {
   ctkComboBox* combo = qobject_cast<ctkComboBox*>(this->comboBox());
   if (node)
     {
+    if (combo->itemIcon(combo->currentIndex()).isNull())
+      {
+      this->setIconToPreset(node);
+      }
     combo->setDefaultText(node->GetName());
     combo->setDefaultIcon(combo->itemIcon(combo->currentIndex()));
     }
@@ -45,6 +45,9 @@ public slots:
 
 protected slots:
   void updateComboBoxTitleAndIcon(vtkMRMLNode* presetNode);
+  void onPresetAdded(vtkMRMLNode* presetNode);
+  /// Set the icons of all the presets that don't have an icon yet.
+  void setIconsToPresets();
 
 protected:
   QScopedPointer<qSlicerPresetComboBoxPrivate> d_ptr;
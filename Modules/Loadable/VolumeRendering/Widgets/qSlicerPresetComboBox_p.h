@@ -37,6 +37,11 @@ protected:
 public:
   qSlicerPresetComboBoxPrivate(qSlicerPresetComboBox& object);
   void init();
+
+  /// Icons of the presets are only set when the popup is first shown
+  /// (except for the current preset), so that adding the presets scene
+  /// doesn't have to load the icons and tooltips of all the presets.
+  bool IconsDeferred;
 };
 
 //-----------------------------------------------------------------------------
@@ -52,6 +57,10 @@ public:
 public :
   virtual void showPopup();
 
+signals:
+  /// Emitted before the popup is laid out and shown
+  void popupAboutToBeShown();
+
 private:
   Q_DISABLE_COPY(qSlicerIconComboBox);
 };
@@ -14,6 +14,12 @@
 
 // STD includes
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <vector>
 
 // Volumes includes
 #include "vtkSlicerVolumesLogic.h"
@@ -42,13 +48,16 @@
 
 // VTK includes
 #include <vtkCallbackCommand.h>
+#include <vtkCollection.h>
 #include <vtkGeneralTransform.h>
 #include <vtkImageData.h>
-#include <vtkImageThreshold.h>
 #include <vtkMathUtilities.h>
 #include <vtkMatrix4x4.h>
+#include <vtkMultiThreader.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkShortArray.h>
 #include <vtkSmartPointer.h>
 #include <vtkStringArray.h>
 #include <vtksys/SystemTools.hxx>
@@ -879,7 +888,8 @@ vtkSlicerVolumesLogic::CreateAndAddLabelVolume(vtkMRMLScene *scene,
   labelNode->SetName(uname.c_str());
   scene->AddNode(labelNode.GetPointer());
 
-  this->CreateLabelVolumeFromVolume(scene, labelNode.GetPointer(), volumeNode);
+  // The image data of the volume is replaced right away, it is not worth copying
+  this->CreateLabelVolumeFromVolume(scene, labelNode.GetPointer(), volumeNode, false);
 
   // Make an image data of the same size and shape as the input volume, but filled with zeros
   vtkSlicerVolumesLogic::ClearVolumeImageData(labelNode.GetPointer());
@@ -920,7 +930,7 @@ vtkSlicerVolumesLogic::FillLabelVolumeFromTemplate(vtkMRMLScene *scene,
                                                    vtkMRMLLabelMapVolumeNode *labelNode,
                                                    vtkMRMLVolumeNode *templateNode)
 {
-  this->CreateLabelVolumeFromVolume(scene, labelNode, templateNode);
+  this->CreateLabelVolumeFromVolume(scene, labelNode, templateNode, false);
 
   // Make an image data of the same size and shape as the input volume, but filled with zeros
   vtkSlicerVolumesLogic::ClearVolumeImageData(labelNode);
@@ -933,6 +943,16 @@ vtkMRMLLabelMapVolumeNode*
 vtkSlicerVolumesLogic::CreateLabelVolumeFromVolume(vtkMRMLScene *scene,
                                                    vtkMRMLLabelMapVolumeNode *labelNode,
                                                    vtkMRMLVolumeNode *inputVolume)
+{
+  return this->CreateLabelVolumeFromVolume(scene, labelNode, inputVolume, true);
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLLabelMapVolumeNode*
+vtkSlicerVolumesLogic::CreateLabelVolumeFromVolume(vtkMRMLScene *scene,
+                                                   vtkMRMLLabelMapVolumeNode *labelNode,
+                                                   vtkMRMLVolumeNode *inputVolume,
+                                                   bool copyImageData)
 {
   if (scene == NULL || labelNode == NULL || inputVolume == NULL)
     {
@@ -968,6 +988,13 @@ vtkSlicerVolumesLogic::CreateLabelVolumeFromVolume(vtkMRMLScene *scene,
   this->SetAndObserveColorToDisplayNode(labelDisplayNode,
                                         /* labelMap = */ 1, /* filename= */ 0);
 
+  if (!copyImageData)
+    {
+    // Share the image data of the input volume
+    labelNode->SetAndObserveImageData(inputVolume->GetImageData());
+    return labelNode;
+    }
+
   // Copy and set image data of the input volume to the label volume
   vtkNew<vtkImageData> imageData;
   imageData->DeepCopy(inputVolume->GetImageData());
@@ -985,18 +1012,33 @@ vtkSlicerVolumesLogic::ClearVolumeImageData(vtkMRMLVolumeNode *volumeNode)
     return;
     }
 
-  // Make an image data of the same size and shape as the input volume, but filled with zeros
-  vtkNew<vtkImageThreshold> thresh;
-  thresh->ReplaceInOn();
-  thresh->ReplaceOutOn();
-  thresh->SetInValue(0);
-  thresh->SetOutValue(0);
-  thresh->SetOutputScalarType(VTK_SHORT);
+  vtkImageData* inputImageData = volumeNode->GetImageData();
+  if (inputImageData == NULL)
+    {
+    return;
+    }
+
+  // Make an image data of the same size and shape as the input volume, but filled with zeros.
+  // The zeroed memory is requested from the system with calloc: the system only provides
+  // the pages when they are first written, so even labelmaps of very large volumes are
+  // created instantly and only take memory where they are painted.
+  int numberOfComponents = inputImageData->GetNumberOfScalarComponents();
+  vtkIdType numberOfValues = inputImageData->GetNumberOfPoints() * numberOfComponents;
+  short* values = static_cast<short*>(calloc(std::max(numberOfValues, static_cast<vtkIdType>(1)), sizeof(short)));
+  if (values == NULL)
+    {
+    vtkGenericWarningMacro("ClearVolumeImageData: Failed to allocate " << numberOfValues << " voxels");
+    return;
+    }
+  vtkNew<vtkShortArray> scalars;
+  scalars->SetNumberOfComponents(numberOfComponents);
+  scalars->SetArray(values, numberOfValues, 0, vtkAbstractArray::VTK_DATA_ARRAY_FREE);
 
   vtkNew<vtkImageData> imageData;
-  thresh->SetInputData(volumeNode->GetImageData());
-  thresh->Update();
-  imageData->DeepCopy(thresh->GetOutput());
+  imageData->SetExtent(inputImageData->GetExtent());
+  imageData->SetSpacing(inputImageData->GetSpacing());
+  imageData->SetOrigin(inputImageData->GetOrigin());
+  imageData->GetPointData()->SetScalars(scalars.GetPointer());
   volumeNode->SetAndObserveImageData(imageData.GetPointer());
 }
 
@@ -1618,3 +1660,907 @@ vtkSlicerVolumesLogic
 
   return outputVolumeNode;
 }
+
+//----------------------------------------------------------------------------
+// Voxelwise expressions
+//----------------------------------------------------------------------------
+namespace
+{
+
+/// Number of voxels of a row evaluated at once. Each operation of the
+/// expression is applied to a whole block in a loop simple enough for the
+/// compiler to vectorize, and the blocks stay in the cache.
+const int ExpressionBlockSize = 256;
+
+enum ExpressionOpcode
+{
+  ExpressionInput,
+  ExpressionConstant,
+  ExpressionNegate,
+  ExpressionNot,
+  ExpressionAbs,
+  ExpressionSqrt,
+  ExpressionExp,
+  ExpressionLog,
+  ExpressionAdd,
+  ExpressionSubtract,
+  ExpressionMultiply,
+  ExpressionDivide,
+  ExpressionMinimum,
+  ExpressionMaximum,
+  ExpressionLess,
+  ExpressionLessOrEqual,
+  ExpressionGreater,
+  ExpressionGreaterOrEqual,
+  ExpressionEqual,
+  ExpressionNotEqual,
+  ExpressionAnd,
+  ExpressionOr
+};
+
+struct ExpressionInstruction
+{
+  ExpressionInstruction(int opcode, int input = 0, double constant = 0.)
+    : Opcode(opcode), Input(input), Constant(constant) {}
+  int Opcode;
+  int Input;
+  double Constant;
+};
+
+//----------------------------------------------------------------------------
+/// Compile an expression into a program for a stack machine.
+/// Grammar, from the lowest to the highest precedence:
+///   or         := and ("||" and)*
+///   and        := comparison ("&&" comparison)*
+///   comparison := sum (("<" | "<=" | ">" | ">=" | "==" | "!=") sum)*
+///   sum        := product (("+" | "-") product)*
+///   product    := unary (("*" | "/") unary)*
+///   unary      := ("-" | "+" | "!") unary | primary
+///   primary    := number | variable | function "(" or ("," or)* ")" | "(" or ")"
+class ExpressionParser
+{
+public:
+  ExpressionParser(const std::string& text, int numberOfVariables)
+    : Text(text), Position(0), NumberOfVariables(numberOfVariables) {}
+
+  bool Parse(std::vector<ExpressionInstruction>& program, std::string& error)
+  {
+    this->Program.clear();
+    this->Error.clear();
+    this->Position = 0;
+    if (this->ParseOr())
+      {
+      this->SkipSpaces();
+      if (this->Position < this->Text.size())
+        {
+        this->SetError("unexpected character");
+        }
+      }
+    if (!this->Error.empty())
+      {
+      error = this->Error;
+      return false;
+      }
+    program = this->Program;
+    return true;
+  }
+
+private:
+  void SkipSpaces()
+  {
+    while (this->Position < this->Text.size() &&
+           isspace(static_cast<unsigned char>(this->Text[this->Position])))
+      {
+      ++this->Position;
+      }
+  }
+
+  bool Accept(const char* token)
+  {
+    this->SkipSpaces();
+    size_t length = strlen(token);
+    if (this->Text.compare(this->Position, length, token) != 0)
+      {
+      return false;
+      }
+    this->Position += length;
+    return true;
+  }
+
+  bool SetError(const std::string& message)
+  {
+    if (this->Error.empty())
+      {
+      std::stringstream errorStream;
+      errorStream << message << " at position " << this->Position;
+      this->Error = errorStream.str();
+      }
+    return false;
+  }
+
+  void Emit(int opcode, int input = 0, double constant = 0.)
+  {
+    this->Program.push_back(ExpressionInstruction(opcode, input, constant));
+  }
+
+  bool ParseOr()
+  {
+    if (!this->ParseAnd())
+      {
+      return false;
+      }
+    while (this->Accept("||"))
+      {
+      if (!this->ParseAnd())
+        {
+        return false;
+        }
+      this->Emit(ExpressionOr);
+      }
+    return true;
+  }
+
+  bool ParseAnd()
+  {
+    if (!this->ParseComparison())
+      {
+      return false;
+      }
+    while (this->Accept("&&"))
+      {
+      if (!this->ParseComparison())
+        {
+        return false;
+        }
+      this->Emit(ExpressionAnd);
+      }
+    return true;
+  }
+
+  bool ParseComparison()
+  {
+    if (!this->ParseSum())
+      {
+      return false;
+      }
+    while (true)
+      {
+      int opcode = -1;
+      if (this->Accept("<="))
+        {
+        opcode = ExpressionLessOrEqual;
+        }
+      else if (this->Accept(">="))
+        {
+        opcode = ExpressionGreaterOrEqual;
+        }
+      else if (this->Accept("=="))
+        {
+        opcode = ExpressionEqual;
+        }
+      else if (this->Accept("!="))
+        {
+        opcode = ExpressionNotEqual;
+        }
+      else if (this->Accept("<"))
+        {
+        opcode = ExpressionLess;
+        }
+      else if (this->Accept(">"))
+        {
+        opcode = ExpressionGreater;
+        }
+      else
+        {
+        return true;
+        }
+      if (!this->ParseSum())
+        {
+        return false;
+        }
+      this->Emit(opcode);
+      }
+  }
+
+  bool ParseSum()
+  {
+    if (!this->ParseProduct())
+      {
+      return false;
+      }
+    while (true)
+      {
+      int opcode = -1;
+      if (this->Accept("+"))
+        {
+        opcode = ExpressionAdd;
+        }
+      else if (this->Accept("-"))
+        {
+        opcode = ExpressionSubtract;
+        }
+      else
+        {
+        return true;
+        }
+      if (!this->ParseProduct())
+        {
+        return false;
+        }
+      this->Emit(opcode);
+      }
+  }
+
+  bool ParseProduct()
+  {
+    if (!this->ParseUnary())
+      {
+      return false;
+      }
+    while (true)
+      {
+      int opcode = -1;
+      if (this->Accept("*"))
+        {
+        opcode = ExpressionMultiply;
+        }
+      else if (this->Accept("/"))
+        {
+        opcode = ExpressionDivide;
+        }
+      else
+        {
+        return true;
+        }
+      if (!this->ParseUnary())
+        {
+        return false;
+        }
+      this->Emit(opcode);
+      }
+  }
+
+  bool ParseUnary()
+  {
+    if (this->Accept("-"))
+      {
+      if (!this->ParseUnary())
+        {
+        return false;
+        }
+      this->Emit(ExpressionNegate);
+      return true;
+      }
+    if (this->Accept("+"))
+      {
+      return this->ParseUnary();
+      }
+    if (this->Accept("!"))
+      {
+      if (!this->ParseUnary())
+        {
+        return false;
+        }
+      this->Emit(ExpressionNot);
+      return true;
+      }
+    return this->ParsePrimary();
+  }
+
+  bool ParsePrimary()
+  {
+    this->SkipSpaces();
+    if (this->Position >= this->Text.size())
+      {
+      return this->SetError("operand expected");
+      }
+    const char character = this->Text[this->Position];
+    if (isdigit(static_cast<unsigned char>(character)) || character == '.')
+      {
+      const char* start = this->Text.c_str() + this->Position;
+      char* end = NULL;
+      double value = strtod(start, &end);
+      if (end == start)
+        {
+        return this->SetError("invalid number");
+        }
+      this->Position += end - start;
+      this->Emit(ExpressionConstant, 0, value);
+      return true;
+      }
+    if (isalpha(static_cast<unsigned char>(character)))
+      {
+      size_t start = this->Position;
+      while (this->Position < this->Text.size() &&
+             (isalnum(static_cast<unsigned char>(this->Text[this->Position])) ||
+              this->Text[this->Position] == '_'))
+        {
+        ++this->Position;
+        }
+      std::string name = this->Text.substr(start, this->Position - start);
+      if (this->Accept("("))
+        {
+        return this->ParseFunction(name);
+        }
+      if (name.size() == 1 && name[0] >= 'a' && name[0] - 'a' < this->NumberOfVariables)
+        {
+        this->Emit(ExpressionInput, name[0] - 'a');
+        return true;
+        }
+      this->Position = start;
+      return this->SetError("unknown variable \"" + name + "\"");
+      }
+    if (this->Accept("("))
+      {
+      if (!this->ParseOr())
+        {
+        return false;
+        }
+      if (!this->Accept(")"))
+        {
+        return this->SetError("\")\" expected");
+        }
+      return true;
+      }
+    return this->SetError("operand expected");
+  }
+
+  bool ParseFunction(const std::string& name)
+  {
+    int opcode = -1;
+    int numberOfArguments = 1;
+    if (name == "abs")
+      {
+      opcode = ExpressionAbs;
+      }
+    else if (name == "sqrt")
+      {
+      opcode = ExpressionSqrt;
+      }
+    else if (name == "exp")
+      {
+      opcode = ExpressionExp;
+      }
+    else if (name == "log")
+      {
+      opcode = ExpressionLog;
+      }
+    else if (name == "min")
+      {
+      opcode = ExpressionMinimum;
+      numberOfArguments = 2;
+      }
+    else if (name == "max")
+      {
+      opcode = ExpressionMaximum;
+      numberOfArguments = 2;
+      }
+    else
+      {
+      return this->SetError("unknown function \"" + name + "\"");
+      }
+    for (int argument = 0; argument < numberOfArguments; ++argument)
+      {
+      if (argument > 0 && !this->Accept(","))
+        {
+        return this->SetError("\",\" expected");
+        }
+      if (!this->ParseOr())
+        {
+        return false;
+        }
+      }
+    if (!this->Accept(")"))
+      {
+      return this->SetError("\")\" expected");
+      }
+    this->Emit(opcode);
+    return true;
+  }
+
+  std::string Text;
+  size_t Position;
+  int NumberOfVariables;
+  std::vector<ExpressionInstruction> Program;
+  std::string Error;
+};
+
+//----------------------------------------------------------------------------
+/// Number of blocks of values on the stack while the program runs.
+int GetExpressionStackDepth(const std::vector<ExpressionInstruction>& program)
+{
+  int depth = 0;
+  int maximumDepth = 0;
+  for (size_t n = 0; n < program.size(); ++n)
+    {
+    const int opcode = program[n].Opcode;
+    if (opcode == ExpressionInput || opcode == ExpressionConstant)
+      {
+      maximumDepth = std::max(maximumDepth, ++depth);
+      }
+    else if (opcode >= ExpressionAdd)
+      {
+      --depth;
+      }
+    }
+  return maximumDepth;
+}
+
+//----------------------------------------------------------------------------
+/// Run \a program on \a count voxels. \a inputs holds the values of each
+/// input and \a stack the blocks of intermediate values, the result is
+/// left in the first block.
+void EvaluateExpressionBlock(const std::vector<ExpressionInstruction>& program,
+                             double* const* inputs, double* stack, int count)
+{
+#define EXPRESSION_UNARY_CASE(opcode, operation)  \
+  case opcode:                                    \
+    for (int v = 0; v < count; ++v)               \
+      {                                           \
+      const double x = top[v];                    \
+      top[v] = (operation);                       \
+      }                                           \
+    break;
+#define EXPRESSION_BINARY_CASE(opcode, operation) \
+  case opcode:                                    \
+    for (int v = 0; v < count; ++v)               \
+      {                                           \
+      const double x = left[v];                   \
+      const double y = top[v];                    \
+      left[v] = (operation);                      \
+      }                                           \
+    break;
+
+  int depth = 0;
+  for (size_t n = 0; n < program.size(); ++n)
+    {
+    const ExpressionInstruction& instruction = program[n];
+    if (instruction.Opcode == ExpressionInput)
+      {
+      std::copy(inputs[instruction.Input], inputs[instruction.Input] + count,
+                stack + ExpressionBlockSize * depth++);
+      continue;
+      }
+    if (instruction.Opcode == ExpressionConstant)
+      {
+      std::fill(stack + ExpressionBlockSize * depth, stack + ExpressionBlockSize * depth + count,
+                instruction.Constant);
+      ++depth;
+      continue;
+      }
+    double* top = stack + ExpressionBlockSize * (depth - 1);
+    if (instruction.Opcode < ExpressionAdd)
+      {
+      switch (instruction.Opcode)
+        {
+        EXPRESSION_UNARY_CASE(ExpressionNegate, -x)
+        EXPRESSION_UNARY_CASE(ExpressionNot, x == 0. ? 1. : 0.)
+        EXPRESSION_UNARY_CASE(ExpressionAbs, fabs(x))
+        EXPRESSION_UNARY_CASE(ExpressionSqrt, sqrt(x))
+        EXPRESSION_UNARY_CASE(ExpressionExp, exp(x))
+        EXPRESSION_UNARY_CASE(ExpressionLog, log(x))
+        default:
+          break;
+        }
+      continue;
+      }
+    double* left = top - ExpressionBlockSize;
+    switch (instruction.Opcode)
+      {
+      EXPRESSION_BINARY_CASE(ExpressionAdd, x + y)
+      EXPRESSION_BINARY_CASE(ExpressionSubtract, x - y)
+      EXPRESSION_BINARY_CASE(ExpressionMultiply, x * y)
+      EXPRESSION_BINARY_CASE(ExpressionDivide, x / y)
+      EXPRESSION_BINARY_CASE(ExpressionMinimum, x < y ? x : y)
+      EXPRESSION_BINARY_CASE(ExpressionMaximum, x > y ? x : y)
+      EXPRESSION_BINARY_CASE(ExpressionLess, x < y ? 1. : 0.)
+      EXPRESSION_BINARY_CASE(ExpressionLessOrEqual, x <= y ? 1. : 0.)
+      EXPRESSION_BINARY_CASE(ExpressionGreater, x > y ? 1. : 0.)
+      EXPRESSION_BINARY_CASE(ExpressionGreaterOrEqual, x >= y ? 1. : 0.)
+      EXPRESSION_BINARY_CASE(ExpressionEqual, x == y ? 1. : 0.)
+      EXPRESSION_BINARY_CASE(ExpressionNotEqual, x != y ? 1. : 0.)
+      EXPRESSION_BINARY_CASE(ExpressionAnd, (x != 0. && y != 0.) ? 1. : 0.)
+      EXPRESSION_BINARY_CASE(ExpressionOr, (x != 0. || y != 0.) ? 1. : 0.)
+      default:
+        break;
+      }
+    --depth;
+    }
+
+#undef EXPRESSION_UNARY_CASE
+#undef EXPRESSION_BINARY_CASE
+}
+
+//----------------------------------------------------------------------------
+struct ExpressionInputData
+{
+  const void* Scalars;
+  int ScalarType;
+  int Extent[6];
+  /// Offsets between neighbor voxels, in scalar values
+  vtkIdType Increments[3];
+  /// True if the input is only referenced by the expression
+  bool Used;
+  /// True if the voxels of the input are the voxels of the output
+  bool SameGrid;
+  bool NearestNeighbor;
+  /// Affine transform from the output IJK to the input IJK (3 first rows)
+  double OutputToInput[3][4];
+  /// For non-linear transforms: output IJK to RAS, transform from the output
+  /// RAS to the input RAS and input RAS to IJK
+  double OutputToRAS[3][4];
+  vtkAbstractTransform* Transform;
+  double RASToInput[3][4];
+};
+
+//----------------------------------------------------------------------------
+void TransformExpressionPoint(const double matrix[3][4], const double in[3], double out[3])
+{
+  for (int row = 0; row < 3; ++row)
+    {
+    out[row] = matrix[row][0] * in[0] + matrix[row][1] * in[1] + matrix[row][2] * in[2] + matrix[row][3];
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Resample the input at the continuous index \a point, 0 outside of the
+/// input.
+template <class T>
+double InterpolateExpressionInput(const ExpressionInputData& input, const double point[3])
+{
+  const T* scalars = static_cast<const T*>(input.Scalars);
+  if (input.NearestNeighbor)
+    {
+    vtkIdType offset = 0;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      const int index = static_cast<int>(floor(point[axis] + 0.5));
+      if (index < input.Extent[2 * axis] || index > input.Extent[2 * axis + 1])
+        {
+        return 0.;
+        }
+      offset += (index - input.Extent[2 * axis]) * input.Increments[axis];
+      }
+    return static_cast<double>(scalars[offset]);
+    }
+
+  // Trilinear interpolation, points on the border of the input (up to a
+  // rounding error) are inside
+  const double tolerance = 1e-4;
+  vtkIdType offset = 0;
+  vtkIdType steps[3];
+  double fractions[3];
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    const int first = input.Extent[2 * axis];
+    const int last = input.Extent[2 * axis + 1];
+    double position = point[axis];
+    if (position < first - tolerance || position > last + tolerance)
+      {
+      return 0.;
+      }
+    position = std::min(std::max(position, static_cast<double>(first)), static_cast<double>(last));
+    int base = static_cast<int>(floor(position));
+    if (base == last && last > first)
+      {
+      --base;
+      }
+    fractions[axis] = position - base;
+    steps[axis] = last > first ? input.Increments[axis] : 0;
+    offset += (base - first) * input.Increments[axis];
+    }
+  const T* voxel = scalars + offset;
+  double value = 0.;
+  for (int corner = 0; corner < 8; ++corner)
+    {
+    double weight = 1.;
+    vtkIdType cornerOffset = 0;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      if (corner & (1 << axis))
+        {
+        weight *= fractions[axis];
+        cornerOffset += steps[axis];
+        }
+      else
+        {
+        weight *= 1. - fractions[axis];
+        }
+      }
+    if (weight != 0.)
+      {
+      value += weight * static_cast<double>(voxel[cornerOffset]);
+      }
+    }
+  return value;
+}
+
+//----------------------------------------------------------------------------
+/// Read the values of the input at the output voxels (i, j, k) to
+/// (i + count - 1, j, k). Only the first scalar component is used.
+template <class T>
+void GatherExpressionInput(const ExpressionInputData& input, int i, int j, int k,
+                           int count, double* values)
+{
+  if (input.SameGrid)
+    {
+    const T* scalars = static_cast<const T*>(input.Scalars) +
+      (i - input.Extent[0]) * input.Increments[0] +
+      (j - input.Extent[2]) * input.Increments[1] +
+      (k - input.Extent[4]) * input.Increments[2];
+    const vtkIdType increment = input.Increments[0];
+    for (int v = 0; v < count; ++v)
+      {
+      values[v] = static_cast<double>(scalars[v * increment]);
+      }
+    return;
+    }
+  double outputPoint[3] = { static_cast<double>(i), static_cast<double>(j), static_cast<double>(k) };
+  if (!input.Transform)
+    {
+    // Step along the row in the input index space
+    double start[3];
+    TransformExpressionPoint(input.OutputToInput, outputPoint, start);
+    for (int v = 0; v < count; ++v)
+      {
+      double point[3];
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        point[axis] = start[axis] + v * input.OutputToInput[axis][0];
+        }
+      values[v] = InterpolateExpressionInput<T>(input, point);
+      }
+    return;
+    }
+  for (int v = 0; v < count; ++v)
+    {
+    double outputRAS[3];
+    double inputRAS[3];
+    double point[3];
+    outputPoint[0] = i + v;
+    TransformExpressionPoint(input.OutputToRAS, outputPoint, outputRAS);
+    input.Transform->InternalTransformPoint(outputRAS, inputRAS);
+    TransformExpressionPoint(input.RASToInput, inputRAS, point);
+    values[v] = InterpolateExpressionInput<T>(input, point);
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Integer outputs are rounded and clamped to the range of their type.
+template <class T>
+void StoreExpressionValues(const double* values, int count, T* output)
+{
+  for (int v = 0; v < count; ++v)
+    {
+    double value = values[v];
+    if (std::numeric_limits<T>::is_integer)
+      {
+      if (value != value) // is NaN
+        {
+        value = 0.;
+        }
+      value = floor(value + 0.5);
+      value = std::max(value, static_cast<double>(std::numeric_limits<T>::min()));
+      value = std::min(value, static_cast<double>(std::numeric_limits<T>::max()));
+      }
+    output[v] = static_cast<T>(value);
+    }
+}
+
+//----------------------------------------------------------------------------
+struct ExpressionData
+{
+  std::vector<ExpressionInstruction> Program;
+  int StackDepth;
+  std::vector<ExpressionInputData> Inputs;
+  int Extent[6];
+  void* Output;
+  int OutputScalarType;
+};
+
+//----------------------------------------------------------------------------
+/// Each thread evaluates a contiguous range of rows of the output.
+VTK_THREAD_RETURN_TYPE EvaluateExpressionThreadFunction(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  const ExpressionData* data = static_cast<ExpressionData*>(info->UserData);
+  const int* extent = data->Extent;
+  const int rowLength = extent[1] - extent[0] + 1;
+  const int numberOfRowsPerSlice = extent[3] - extent[2] + 1;
+  const vtkIdType numberOfRows = static_cast<vtkIdType>(numberOfRowsPerSlice) * (extent[5] - extent[4] + 1);
+  const vtkIdType firstRow = numberOfRows * info->ThreadID / info->NumberOfThreads;
+  const vtkIdType lastRow = numberOfRows * (info->ThreadID + 1) / info->NumberOfThreads;
+
+  const size_t numberOfInputs = data->Inputs.size();
+  std::vector<double> inputValues(numberOfInputs * ExpressionBlockSize);
+  std::vector<double*> inputs(numberOfInputs);
+  for (size_t n = 0; n < numberOfInputs; ++n)
+    {
+    inputs[n] = &inputValues[n * ExpressionBlockSize];
+    }
+  std::vector<double> stack(std::max(data->StackDepth, 1) * ExpressionBlockSize);
+
+  for (vtkIdType row = firstRow; row < lastRow; ++row)
+    {
+    const int j = extent[2] + static_cast<int>(row % numberOfRowsPerSlice);
+    const int k = extent[4] + static_cast<int>(row / numberOfRowsPerSlice);
+    for (int start = 0; start < rowLength; start += ExpressionBlockSize)
+      {
+      const int count = std::min(ExpressionBlockSize, rowLength - start);
+      for (size_t n = 0; n < numberOfInputs; ++n)
+        {
+        const ExpressionInputData& input = data->Inputs[n];
+        if (!input.Used)
+          {
+          continue;
+          }
+        switch (input.ScalarType)
+          {
+          vtkTemplateMacro(GatherExpressionInput<VTK_TT>(
+            input, extent[0] + start, j, k, count, inputs[n]));
+          default:
+            break;
+          }
+        }
+      EvaluateExpressionBlock(data->Program, &inputs[0], &stack[0], count);
+      switch (data->OutputScalarType)
+        {
+        vtkTemplateMacro(StoreExpressionValues(&stack[0], count,
+          static_cast<VTK_TT*>(data->Output) + row * rowLength + start));
+        default:
+          break;
+        }
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+bool vtkSlicerVolumesLogic::EvaluateVoxelwiseExpression(const char* expression,
+                                                        vtkCollection* inputVolumes,
+                                                        vtkMRMLScalarVolumeNode* outputVolume,
+                                                        int outputScalarType,
+                                                        int numberOfThreads)
+{
+  if (expression == NULL || inputVolumes == NULL || outputVolume == NULL)
+    {
+    vtkErrorMacro("EvaluateVoxelwiseExpression: invalid expression, input volumes or output volume");
+    return false;
+    }
+  const int numberOfInputs = inputVolumes->GetNumberOfItems();
+  if (numberOfInputs < 1 || numberOfInputs > 26)
+    {
+    vtkErrorMacro("EvaluateVoxelwiseExpression: expected from 1 to 26 input volumes, got " << numberOfInputs);
+    return false;
+    }
+
+  // The image data are referenced until the end: the output volume may be
+  // one of the inputs.
+  std::vector<vtkMRMLVolumeNode*> volumes(numberOfInputs);
+  std::vector<vtkSmartPointer<vtkImageData> > images(numberOfInputs);
+  for (int n = 0; n < numberOfInputs; ++n)
+    {
+    volumes[n] = vtkMRMLVolumeNode::SafeDownCast(inputVolumes->GetItemAsObject(n));
+    if (volumes[n] == NULL || volumes[n]->GetImageData() == NULL ||
+        volumes[n]->GetImageData()->GetScalarPointer() == NULL)
+      {
+      vtkErrorMacro("EvaluateVoxelwiseExpression: input volume " << n << " has no image data");
+      return false;
+      }
+    images[n] = volumes[n]->GetImageData();
+    }
+
+  ExpressionData data;
+  std::string error;
+  ExpressionParser parser(expression, numberOfInputs);
+  if (!parser.Parse(data.Program, error))
+    {
+    vtkErrorMacro("EvaluateVoxelwiseExpression: failed to parse \"" << expression << "\": " << error);
+    return false;
+    }
+  data.StackDepth = GetExpressionStackDepth(data.Program);
+
+  // The output has the geometry of the first input, the other inputs are
+  // resampled on the fly when their geometry differs.
+  vtkMRMLVolumeNode* referenceVolume = volumes[0];
+  vtkImageData* referenceImage = images[0];
+  referenceImage->GetExtent(data.Extent);
+  vtkNew<vtkMatrix4x4> outputIJKToRAS;
+  referenceVolume->GetIJKToRASMatrix(outputIJKToRAS.GetPointer());
+
+  std::vector<vtkSmartPointer<vtkGeneralTransform> > transforms(numberOfInputs);
+  data.Inputs.resize(numberOfInputs);
+  for (int n = 0; n < numberOfInputs; ++n)
+    {
+    ExpressionInputData& input = data.Inputs[n];
+    vtkImageData* image = images[n];
+    input.Scalars = image->GetScalarPointer();
+    input.ScalarType = image->GetScalarType();
+    image->GetExtent(input.Extent);
+    input.Increments[0] = image->GetNumberOfScalarComponents();
+    input.Increments[1] = input.Increments[0] * (input.Extent[1] - input.Extent[0] + 1);
+    input.Increments[2] = input.Increments[1] * (input.Extent[3] - input.Extent[2] + 1);
+    input.Used = false;
+    input.NearestNeighbor = volumes[n]->IsA("vtkMRMLLabelMapVolumeNode");
+    input.Transform = NULL;
+
+    vtkNew<vtkMatrix4x4> inputRASToIJK;
+    volumes[n]->GetRASToIJKMatrix(inputRASToIJK.GetPointer());
+    vtkNew<vtkMatrix4x4> outputToInputRAS;
+    if (vtkMRMLTransformNode::GetMatrixTransformBetweenNodes(referenceVolume->GetParentTransformNode(),
+          volumes[n]->GetParentTransformNode(), outputToInputRAS.GetPointer()))
+      {
+      vtkNew<vtkMatrix4x4> outputIJKToInputRAS;
+      vtkMatrix4x4::Multiply4x4(outputToInputRAS.GetPointer(), outputIJKToRAS.GetPointer(),
+                                outputIJKToInputRAS.GetPointer());
+      vtkNew<vtkMatrix4x4> outputToInput;
+      vtkMatrix4x4::Multiply4x4(inputRASToIJK.GetPointer(), outputIJKToInputRAS.GetPointer(),
+                                outputToInput.GetPointer());
+      bool identity = true;
+      for (int row = 0; row < 3; ++row)
+        {
+        for (int column = 0; column < 4; ++column)
+          {
+          input.OutputToInput[row][column] = outputToInput->GetElement(row, column);
+          identity = identity && fabs(input.OutputToInput[row][column] - (row == column ? 1. : 0.))
+                                   < this->CompareVolumeGeometryEpsilon;
+          }
+        }
+      input.SameGrid = identity && std::equal(input.Extent, input.Extent + 6, data.Extent);
+      }
+    else
+      {
+      transforms[n] = vtkSmartPointer<vtkGeneralTransform>::New();
+      vtkMRMLTransformNode::GetTransformBetweenNodes(referenceVolume->GetParentTransformNode(),
+        volumes[n]->GetParentTransformNode(), transforms[n]);
+      transforms[n]->Update();
+      input.Transform = transforms[n];
+      input.SameGrid = false;
+      for (int row = 0; row < 3; ++row)
+        {
+        for (int column = 0; column < 4; ++column)
+          {
+          input.OutputToRAS[row][column] = outputIJKToRAS->GetElement(row, column);
+          input.RASToInput[row][column] = inputRASToIJK->GetElement(row, column);
+          }
+        }
+      }
+    }
+  for (size_t n = 0; n < data.Program.size(); ++n)
+    {
+    if (data.Program[n].Opcode == ExpressionInput)
+      {
+      data.Inputs[data.Program[n].Input].Used = true;
+      }
+    }
+
+  vtkNew<vtkImageData> outputImage;
+  outputImage->SetExtent(data.Extent);
+  outputImage->SetSpacing(referenceImage->GetSpacing());
+  outputImage->SetOrigin(referenceImage->GetOrigin());
+  outputImage->AllocateScalars(outputScalarType < 0 ? referenceImage->GetScalarType() : outputScalarType, 1);
+  data.Output = outputImage->GetScalarPointer();
+  data.OutputScalarType = outputImage->GetScalarType();
+
+  const vtkIdType numberOfRows = static_cast<vtkIdType>(data.Extent[3] - data.Extent[2] + 1) *
+                                 (data.Extent[5] - data.Extent[4] + 1);
+  if (numberOfRows > 0 && data.Extent[1] >= data.Extent[0] && data.Output != NULL)
+    {
+    if (numberOfThreads <= 0)
+      {
+      numberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+      }
+    numberOfThreads = static_cast<int>(std::min(static_cast<vtkIdType>(std::min(numberOfThreads, VTK_MAX_THREADS)),
+                                                numberOfRows));
+    vtkNew<vtkMultiThreader> threader;
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(EvaluateExpressionThreadFunction, &data);
+    threader->SingleMethodExecute();
+    }
+
+  outputVolume->CopyOrientation(referenceVolume);
+  outputVolume->SetAndObserveImageData(outputImage.GetPointer());
+  return true;
+}
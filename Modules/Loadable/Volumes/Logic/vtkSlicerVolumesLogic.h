@@ -35,6 +35,7 @@
 
 #include "vtkSlicerVolumesModuleLogicExport.h"
 
+class vtkCollection;
 class vtkMRMLLabelMapVolumeNode;
 class vtkMRMLScalarVolumeNode;
 class vtkMRMLScalarVolumeDisplayNode;
@@ -187,8 +188,19 @@ public:
   vtkMRMLLabelMapVolumeNode *CreateLabelVolumeFromVolume(vtkMRMLScene *scene,
                                                        vtkMRMLLabelMapVolumeNode *labelNode,
                                                        vtkMRMLVolumeNode *inputVolume);
+  /// Same as above, but if \a copyImageData is false, the label map volume
+  /// references the image data of the input volume instead of a copy of it.
+  /// This is useful when the input volume is removed after the conversion or
+  /// when the image data is replaced right after.
+  vtkMRMLLabelMapVolumeNode *CreateLabelVolumeFromVolume(vtkMRMLScene *scene,
+                                                       vtkMRMLLabelMapVolumeNode *labelNode,
+                                                       vtkMRMLVolumeNode *inputVolume,
+                                                       bool copyImageData);
 
   /// Clear the image data of a volume node to contain all zeros
+  /// The new image data has the geometry and number of components of the
+  /// current one, with short scalars. Its memory is only committed by the
+  /// system when voxels are written.
   static void ClearVolumeImageData(vtkMRMLVolumeNode *volumeNode);
 
   /// Return a string listing any warnings about the spatial validity of
@@ -263,6 +275,27 @@ public:
   static vtkMRMLScalarVolumeNode* ResampleVolumeToReferenceVolume(vtkMRMLVolumeNode *inputVolumeNode,
                                                            vtkMRMLVolumeNode *referenceVolumeNode);
 
+  /// Evaluate \a expression for each voxel and store the result in \a outputVolume.
+  /// The volumes of \a inputVolumes are the variables "a", "b", "c"... of the
+  /// expression, e.g. "a * b + c", "a * (b == 1)" or "max(a - 100, 0)".
+  /// Supported operators are + - * / < <= > >= == != && || !, comparisons and
+  /// logical operators give 0 or 1. Supported functions are abs, sqrt, exp,
+  /// log, min and max.
+  /// The output has the geometry of the first input. Inputs with a different
+  /// geometry (or under a different transform) are resampled on the fly,
+  /// with linear interpolation or nearest neighbor for label maps, and are 0
+  /// outside of their extent. Only the first scalar component is used.
+  /// The output scalar type is the one of the first input if
+  /// \a outputScalarType is negative, integer results are rounded and clamped.
+  /// \a outputVolume may be one of the inputs. The expression is evaluated in
+  /// a single pass by \a numberOfThreads threads (0 for the default number).
+  /// Return false if the expression is invalid or an input has no image data.
+  bool EvaluateVoxelwiseExpression(const char* expression,
+                                   vtkCollection* inputVolumes,
+                                   vtkMRMLScalarVolumeNode* outputVolume,
+                                   int outputScalarType = -1,
+                                   int numberOfThreads = 0);
+
   /// Getting the epsilon value to use when determining if the
   /// elements of the IJK to RAS matrices of two volumes match.
   /// Defaults to 10 to the minus 6.
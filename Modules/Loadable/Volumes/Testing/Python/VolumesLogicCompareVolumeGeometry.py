@@ -83,6 +83,10 @@ class VolumesLogicCompareVolumeGeometryTesting(unittest.TestCase):
       return False
     else:
       print 'Success in comparing MRHead vs label map with epsilon',volumesLogic.GetCompareVolumeGeometryEpsilon()
+    labelImage = headLabel.GetImageData()
+    if labelImage.GetScalarType() != vtk.VTK_SHORT or labelImage.GetScalarRange() != (0.0, 0.0):
+      print 'Error: label map created from MRHead is not an empty short volume'
+      return False
 
     #
     # adjust the geometry and make it fail
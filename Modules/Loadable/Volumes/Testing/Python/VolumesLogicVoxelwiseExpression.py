@@ -0,0 +1,73 @@
+import unittest
+import numpy
+from vtk.util import numpy_support
+from  __main__ import vtk, slicer
+
+
+class VolumesLogicVoxelwiseExpressionTesting(unittest.TestCase):
+  def setUp(self):
+    slicer.mrmlScene.Clear(0)
+
+  def createVolume(self, array, spacing=(1., 1., 1.)):
+    image = vtk.vtkImageData()
+    image.SetDimensions(array.shape[2], array.shape[1], array.shape[0])
+    image.GetPointData().SetScalars(numpy_support.numpy_to_vtk(array.ravel(), deep=True,
+      array_type=numpy_support.get_vtk_array_type(array.dtype)))
+    volume = slicer.mrmlScene.AddNode(slicer.vtkMRMLScalarVolumeNode())
+    volume.SetSpacing(spacing)
+    volume.SetAndObserveImageData(image)
+    return volume
+
+  def arrayFromVolume(self, volume):
+    dimensions = volume.GetImageData().GetDimensions()
+    return numpy_support.vtk_to_numpy(volume.GetImageData().GetPointData().GetScalars()).reshape(
+      dimensions[2], dimensions[1], dimensions[0])
+
+  def evaluate(self, expression, volumes, outputVolume, outputScalarType=-1):
+    inputs = vtk.vtkCollection()
+    for volume in volumes:
+      inputs.AddItem(volume)
+    return slicer.modules.volumes.logic().EvaluateVoxelwiseExpression(
+      expression, inputs, outputVolume, outputScalarType)
+
+  def test_VolumesLogicVoxelwiseExpression(self):
+    k, j, i = numpy.mgrid[0:10, 0:20, 0:300]
+    a = (i - 150).astype(numpy.int16)
+    b = (j % 4).astype(numpy.int16)
+    c = k.astype(numpy.uint8)
+    volumeA = self.createVolume(a)
+    volumeB = self.createVolume(b)
+    volumeC = self.createVolume(c)
+    output = slicer.mrmlScene.AddNode(slicer.vtkMRMLScalarVolumeNode())
+
+    # fused arithmetic, in the scalar type of the first input
+    self.assertTrue(self.evaluate('a * b + c', [volumeA, volumeB, volumeC], output))
+    self.assertEqual(output.GetImageData().GetScalarType(), vtk.VTK_SHORT)
+    self.assertTrue(numpy.array_equal(self.arrayFromVolume(output), a * b + c))
+
+    # mask and threshold, clamped to the output type
+    self.assertTrue(self.evaluate('(b == 1) * max(a, 0) + (a > 100) * 1000',
+      [volumeA, volumeB], output, vtk.VTK_UNSIGNED_CHAR))
+    expected = numpy.clip((b == 1) * numpy.maximum(a, 0) + (a > 100) * 1000, 0, 255)
+    self.assertTrue(numpy.array_equal(self.arrayFromVolume(output), expected))
+
+    # a volume with twice the spacing is resampled on the fly
+    ramp = (3. * numpy.mgrid[0:5, 0:10, 0:150][2]).astype(numpy.float32)
+    volumeRamp = self.createVolume(ramp, spacing=(2., 2., 2.))
+    self.assertTrue(self.evaluate('b', [volumeA, volumeRamp], output, vtk.VTK_FLOAT))
+    result = self.arrayFromVolume(output)
+    # inside of the ramp volume, trilinear interpolation of a linear ramp is exact
+    self.assertTrue(numpy.allclose(result[:9, :19, :299], 1.5 * i[:9, :19, :299]))
+    self.assertTrue(numpy.all(result[9, :, :] == 0))
+
+    # in place
+    self.assertTrue(self.evaluate('-a', [volumeA], volumeA))
+    self.assertTrue(numpy.array_equal(self.arrayFromVolume(volumeA), -a))
+
+    # invalid expressions
+    self.assertFalse(self.evaluate('a +', [volumeB], output))
+    self.assertFalse(self.evaluate('a * b', [volumeB], output))
+
+  def runTest(self):
+    self.setUp()
+    self.test_VolumesLogicVoxelwiseExpression()
@@ -133,9 +133,11 @@ void qSlicerVolumesModuleWidget::convertToLabelmap()
     targetLabelMapNode->Delete(); // Release ownership to the scene only
     }
 
-  // Convert current scalar volume to the labelmap node
+  // Convert current scalar volume to the labelmap node. In case of in-place
+  // conversion the scalar volume is removed, its voxels do not need to be copied.
   vtkSlicerVolumesLogic* logic = vtkSlicerVolumesLogic::SafeDownCast(this->logic());
-  logic->CreateLabelVolumeFromVolume(this->mrmlScene(), targetLabelMapNode, currentScalarVolumeNode);
+  logic->CreateLabelVolumeFromVolume(this->mrmlScene(), targetLabelMapNode, currentScalarVolumeNode,
+    /* copyImageData = */ !inPlaceConversion);
 
   // In case of in-place conversion select the new labelmap node and delete the scalar volume node
   if (inPlaceConversion)
@@ -146,7 +146,7 @@ class DICOMFileDialog:
     mainWindow.moduleSelector().selectModule('DICOM')
     dicomWidget = slicer.modules.DICOMWidget
     for directory in self.directoriesToAdd:
-      dicomWidget.detailsPopup.dicomBrowser.onImportDirectory(directory)
+      dicomWidget.detailsPopup.importDirectoryInBackground(directory)
     self.directoriesToAdd = []
 
 #
@@ -0,0 +1,159 @@
+import os
+import time
+import logging
+import qt, ctk, slicer
+
+#########################################################
+#
+#
+comment = """
+
+DICOMIndexing contains helper classes to add files to
+the DICOM database without blocking the application.
+
+"""
+#
+#########################################################
+
+class DICOMBackgroundIndexer(object):
+  """Index the files of directories into a DICOM database in small batches.
+
+  File names are collected and files are indexed a batch at a time from a
+  timer, so the application (including the DICOM browser) stays usable
+  during the import. The database is only accessed from the main thread,
+  as neither ctkDICOMDatabase nor ctkDICOMIndexer is thread-safe.
+
+  Files that are already in the database and have not been modified since
+  they were indexed are skipped, therefore re-importing a directory only
+  parses the new and modified files.
+
+  Usage:
+
+    def progress(indexer):
+      print("%d/%d, %s s left" % (indexer.processedCount, indexer.totalCount, indexer.estimatedRemainingTime()))
+    indexer = DICOMLib.DICOMBackgroundIndexer(slicer.dicomDatabase, progressCallback=progress)
+    indexer.addDirectory('/path/to/dicom')
+  """
+
+  def __init__(self, database=None, destinationDirectory=None, batchSize=200,
+               progressCallback=None, finishedCallback=None):
+    """
+    :param database: the database to add the files to (default: slicer.dicomDatabase)
+    :param destinationDirectory: if specified, files are copied into this directory
+      (the database directory is used if set to empty string), else the files are linked
+    :param batchSize: number of files indexed in one timer event
+    :param progressCallback: called with this indexer after each batch
+    :param finishedCallback: called with this indexer after all the files are processed
+    """
+    self.database = database if database else slicer.dicomDatabase
+    self.destinationDirectory = destinationDirectory
+    self.batchSize = batchSize
+    self.progressCallback = progressCallback
+    self.finishedCallback = finishedCallback
+    self.indexer = ctk.ctkDICOMIndexer()
+    self.timer = qt.QTimer()
+    self.timer.setInterval(0)
+    self.timer.connect('timeout()', self._processBatch)
+    self._reset()
+
+  def _reset(self):
+    self.directoriesToWalk = []
+    self.walker = None
+    self.filesToIndex = []
+    self.processedCount = 0
+    self.indexedCount = 0
+    self.skippedCount = 0
+    self.failedCount = 0
+    self.totalCount = 0
+    self.startTime = None
+
+  def addDirectory(self, directory):
+    """Queue all the files in the directory (recursively) for indexing"""
+    self.directoriesToWalk.append(directory)
+    if not self.isRunning():
+      self.startTime = time.time()
+      self.timer.start()
+
+  def addFiles(self, filePaths):
+    """Queue files for indexing"""
+    self.filesToIndex.extend(filePaths)
+    self.totalCount += len(filePaths)
+    if not self.isRunning():
+      self.startTime = time.time()
+      self.timer.start()
+
+  def isRunning(self):
+    return self.timer.isActive()
+
+  def isEnumerating(self):
+    """Returns True while file names are still collected, totalCount is not final yet"""
+    return self.walker is not None or len(self.directoriesToWalk) > 0
+
+  def cancel(self):
+    """Stop indexing, files indexed so far remain in the database"""
+    self.timer.stop()
+    self._reset()
+
+  def estimatedRemainingTime(self):
+    """Remaining time in seconds, None if it cannot be estimated yet"""
+    if self.isEnumerating() or not self.processedCount or self.startTime is None:
+      return None
+    elapsed = time.time() - self.startTime
+    return elapsed / self.processedCount * (self.totalCount - self.processedCount)
+
+  def _collectFileNames(self, maximumNumberOfFiles):
+    """Collect file names without walking the whole directory tree at once"""
+    collected = 0
+    while collected < maximumNumberOfFiles:
+      if self.walker is None:
+        if not self.directoriesToWalk:
+          return
+        self.walker = os.walk(self.directoriesToWalk.pop(0))
+      try:
+        root, dirs, files = next(self.walker)
+      except StopIteration:
+        self.walker = None
+        continue
+      filePaths = [os.path.join(root, fileName) for fileName in files]
+      self.filesToIndex.extend(filePaths)
+      self.totalCount += len(filePaths)
+      collected += len(filePaths)
+
+  def _isUpToDate(self, filePath):
+    try:
+      return self.database.fileExistsAndUpToDate(filePath)
+    except AttributeError:
+      # not available in this CTK version
+      return False
+
+  def _processBatch(self):
+    self._collectFileNames(self.batchSize * 10)
+    batch = self.filesToIndex[:self.batchSize]
+    del self.filesToIndex[:self.batchSize]
+    if batch:
+      destination = self.destinationDirectory
+      if destination == '':
+        destination = os.path.dirname(self.database.databaseFilename)
+      for filePath in batch:
+        if self._isUpToDate(filePath):
+          self.skippedCount += 1
+        else:
+          try:
+            if destination:
+              self.indexer.addFile(self.database, filePath, destination)
+            else:
+              self.indexer.addFile(self.database, filePath)
+            self.indexedCount += 1
+          except Exception as e:
+            logging.debug('Failed to index %s: %s' % (filePath, str(e)))
+            self.failedCount += 1
+        self.processedCount += 1
+      if self.progressCallback:
+        self.progressCallback(self)
+    if not self.filesToIndex and not self.isEnumerating():
+      self.timer.stop()
+      logging.info('Indexed %d files, skipped %d up-to-date files in %.1f s'
+        % (self.indexedCount, self.skippedCount, time.time() - self.startTime))
+      if self.finishedCallback:
+        self.finishedCallback(self)
+      self._reset()
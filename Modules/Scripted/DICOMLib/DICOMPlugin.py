@@ -52,6 +52,34 @@ class DICOMLoadable(object):
     self.confidence = 0.5
 
 
+#
+# DICOMTagCache
+#
+
+class DICOMTagCache(object):
+  """Tag values of files, looked up in the DICOM database.
+  The DICOM browser shares one instance between all the plugins
+  that examine the same selection, so that each value is only
+  retrieved from the database once.
+  """
+
+  def __init__(self, database=None):
+    self.database = database if database else slicer.dicomDatabase
+    self.values = {}
+
+  def fileValue(self, filePath, tag):
+    # plugins use both upper and lower case hex digits for the same tag
+    key = (filePath, tag.upper())
+    try:
+      return self.values[key]
+    except KeyError:
+      value = self.database.fileValue(filePath, tag)
+      self.values[key] = value
+      return value
+
+  def clear(self):
+    self.values = {}
+
 #
 # DICOMPlugin
 #
@@ -60,6 +88,11 @@ class DICOMPlugin(object):
   """ Base class for DICOM plugins
   """
 
+  # Series added to subject hierarchy that are waiting to be placed under
+  # their patient and study nodes (None if series are placed immediately)
+  # (see beginSubjectHierarchyInsertion)
+  subjectHierarchyInsertionQueue = None
+
   def __init__(self):
     # displayed for the user as the plugin handling the load
     self.loadType = "Generic DICOM"
@@ -75,6 +108,17 @@ class DICOMPlugin(object):
     self.tags = {}
     self.tags['seriesDescription'] = "0008,103E"
     self.tags['seriesNumber'] = "0020,0011"
+    # tag values shared with other plugins during examination
+    # (None if values are retrieved from the database directly)
+    self.tagCache = None
+
+  def fileValue(self,filePath,tag):
+    """Get the value of a tag of a file from the shared tag cache
+    or from the database if there is no cache"""
+    tagCache = getattr(self,"tagCache",None)
+    if tagCache:
+      return tagCache.fileValue(filePath,tag)
+    return slicer.dicomDatabase.fileValue(filePath,tag)
 
   def hashFiles(self,files):
     """Create a hash key for a list of files"""
@@ -143,8 +187,8 @@ class DICOMPlugin(object):
     instanceFilePaths = slicer.dicomDatabase.filesForSeries(seriesUID)
     if len(instanceFilePaths) == 0:
       return "Unnamed Series"
-    seriesDescription = slicer.dicomDatabase.fileValue(instanceFilePaths[0],self.tags['seriesDescription'])
-    seriesNumber = slicer.dicomDatabase.fileValue(instanceFilePaths[0],self.tags['seriesNumber'])
+    seriesDescription = self.fileValue(instanceFilePaths[0],self.tags['seriesDescription'])
+    seriesNumber = self.fileValue(instanceFilePaths[0],self.tags['seriesNumber'])
     name = seriesDescription
     if seriesDescription == "":
       name = "Unnamed Series"
@@ -223,39 +267,97 @@ class DICOMPlugin(object):
 
     # Add series node to hierarchy under the right study and patient nodes. If they are present then used, if not, then created
     patientId = slicer.dicomDatabase.fileValue(firstFile,tags['patientID'])
-    patientNode = slicer.vtkMRMLSubjectHierarchyNode.GetSubjectHierarchyNodeByUID(slicer.mrmlScene, slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMUIDName(), patientId)
     studyInstanceUid = slicer.dicomDatabase.fileValue(firstFile,tags['studyInstanceUID'])
-    studyId = slicer.dicomDatabase.fileValue(firstFile,tags['studyID'])
+    if DICOMPlugin.subjectHierarchyInsertionQueue is not None:
+      # Placed in the hierarchy together with the other loaded series in endSubjectHierarchyInsertion
+      DICOMPlugin.subjectHierarchyInsertionQueue.append((seriesNode, firstFile, tags, patientId, studyInstanceUid, seriesInstanceUid))
+      return
+
+    patientNode = slicer.vtkMRMLSubjectHierarchyNode.GetSubjectHierarchyNodeByUID(slicer.mrmlScene, slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMUIDName(), patientId)
     studyNode = slicer.vtkMRMLSubjectHierarchyNode.GetSubjectHierarchyNodeByUID(slicer.mrmlScene, slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMUIDName(), studyInstanceUid)
     slicer.vtkSlicerSubjectHierarchyModuleLogic.InsertDicomSeriesInHierarchy(slicer.mrmlScene, patientId, studyInstanceUid, seriesInstanceUid)
 
     if patientNode is None:
       patientNode = slicer.vtkMRMLSubjectHierarchyNode.GetSubjectHierarchyNodeByUID(slicer.mrmlScene, slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMUIDName(), patientId)
       if patientNode is not None:
-        # Add attributes for DICOM tags
-        patientName = slicer.util.toVTKString(slicer.dicomDatabase.fileValue(firstFile,tags['patientName']))
-        if patientName == '':
-          patientName = 'No name'
-        patientNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMPatientNameAttributeName(),patientName)
-        patientNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMPatientIDAttributeName(),slicer.dicomDatabase.fileValue(firstFile, tags['patientID']))
-        patientNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMPatientSexAttributeName(),slicer.dicomDatabase.fileValue(firstFile, tags['patientSex']))
-        patientNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMPatientBirthDateAttributeName(),slicer.dicomDatabase.fileValue(firstFile, tags['patientBirthDate']))
-        patientNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMPatientCommentsAttributeName(),slicer.dicomDatabase.fileValue(firstFile, tags['patientComments']))
-        # Set node name
-        patientNode.SetName(patientName)
+        DICOMPlugin.setPatientAttributesInSubjectHierarchy(patientNode, firstFile, tags)
 
     if studyNode is None:
       studyNode = slicer.vtkMRMLSubjectHierarchyNode.GetSubjectHierarchyNodeByUID(slicer.mrmlScene, slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMUIDName(), studyInstanceUid)
       if studyNode is not None:
-        # Add attributes for DICOM tags
-        studyDescription = slicer.util.toVTKString(slicer.dicomDatabase.fileValue(firstFile,tags['studyDescription']))
-        if studyDescription == '':
-          studyDescription = 'No study description'
-        studyNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMStudyDescriptionAttributeName(),studyDescription)
-        studyDate = slicer.util.toVTKString(slicer.dicomDatabase.fileValue(firstFile,tags['studyDate']))
-        studyNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMStudyInstanceUIDTagName(),studyInstanceUid)
-        studyNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMStudyIDTagName(),studyId)
-        studyNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMStudyDateAttributeName(),studyDate)
-        studyNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMStudyTimeAttributeName(),slicer.dicomDatabase.fileValue(firstFile, tags['studyTime']))
-        # Set node name
-        studyNode.SetName(studyDescription + ' (' + studyDate + ')')
+        DICOMPlugin.setStudyAttributesInSubjectHierarchy(studyNode, firstFile, tags)
+
+  @staticmethod
+  def setPatientAttributesInSubjectHierarchy(patientNode, firstFile, tags):
+    """Set DICOM tag attributes and name of a newly created patient node"""
+    patientName = slicer.util.toVTKString(slicer.dicomDatabase.fileValue(firstFile,tags['patientName']))
+    if patientName == '':
+      patientName = 'No name'
+    patientNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMPatientNameAttributeName(),patientName)
+    patientNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMPatientIDAttributeName(),slicer.dicomDatabase.fileValue(firstFile, tags['patientID']))
+    patientNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMPatientSexAttributeName(),slicer.dicomDatabase.fileValue(firstFile, tags['patientSex']))
+    patientNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMPatientBirthDateAttributeName(),slicer.dicomDatabase.fileValue(firstFile, tags['patientBirthDate']))
+    patientNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMPatientCommentsAttributeName(),slicer.dicomDatabase.fileValue(firstFile, tags['patientComments']))
+    # Set node name
+    patientNode.SetName(patientName)
+
+  @staticmethod
+  def setStudyAttributesInSubjectHierarchy(studyNode, firstFile, tags):
+    """Set DICOM tag attributes and name of a newly created study node"""
+    studyDescription = slicer.util.toVTKString(slicer.dicomDatabase.fileValue(firstFile,tags['studyDescription']))
+    if studyDescription == '':
+      studyDescription = 'No study description'
+    studyNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMStudyDescriptionAttributeName(),studyDescription)
+    studyDate = slicer.util.toVTKString(slicer.dicomDatabase.fileValue(firstFile,tags['studyDate']))
+    studyNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMStudyInstanceUIDTagName(),slicer.dicomDatabase.fileValue(firstFile,tags['studyInstanceUID']))
+    studyNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMStudyIDTagName(),slicer.dicomDatabase.fileValue(firstFile,tags['studyID']))
+    studyNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMStudyDateAttributeName(),studyDate)
+    studyNode.SetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMStudyTimeAttributeName(),slicer.dicomDatabase.fileValue(firstFile, tags['studyTime']))
+    # Set node name
+    studyNode.SetName(studyDescription + ' (' + studyDate + ')')
+
+  @staticmethod
+  def beginSubjectHierarchyInsertion():
+    """Defer placing series added by addSeriesInSubjectHierarchy under their
+    patient and study nodes until endSubjectHierarchyInsertion is called.
+    When many series are loaded at once, this allows looking up and creating
+    the patient and study nodes in one pass, and updating the subject
+    hierarchy tree only once.
+    """
+    if DICOMPlugin.subjectHierarchyInsertionQueue is None:
+      DICOMPlugin.subjectHierarchyInsertionQueue = []
+
+  @staticmethod
+  def endSubjectHierarchyInsertion():
+    """Place all series added since beginSubjectHierarchyInsertion in the subject hierarchy"""
+    queue = DICOMPlugin.subjectHierarchyInsertionQueue
+    DICOMPlugin.subjectHierarchyInsertionQueue = None
+    if not queue:
+      return
+
+    import vtk
+    patientIds = vtk.vtkStringArray()
+    studyInstanceUids = vtk.vtkStringArray()
+    seriesInstanceUids = vtk.vtkStringArray()
+    for seriesNode, firstFile, tags, patientId, studyInstanceUid, seriesInstanceUid in queue:
+      patientIds.InsertNextValue(patientId)
+      studyInstanceUids.InsertNextValue(studyInstanceUid)
+      seriesInstanceUids.InsertNextValue(seriesInstanceUid)
+
+    scene = slicer.mrmlScene
+    scene.StartState(scene.BatchProcessState)
+    try:
+      slicer.vtkSlicerSubjectHierarchyModuleLogic.InsertDicomSeriesListInHierarchy(scene, patientIds, studyInstanceUids, seriesInstanceUids)
+
+      # Newly created patient and study nodes do not have DICOM tag attributes yet
+      for seriesNode, firstFile, tags, patientId, studyInstanceUid, seriesInstanceUid in queue:
+        studyNode = seriesNode.GetParentNode()
+        if studyNode is None:
+          continue
+        if studyNode.GetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMStudyDescriptionAttributeName()) is None:
+          DICOMPlugin.setStudyAttributesInSubjectHierarchy(studyNode, firstFile, tags)
+        patientNode = studyNode.GetParentNode()
+        if patientNode is not None and patientNode.GetAttribute(slicer.vtkMRMLSubjectHierarchyConstants.GetDICOMPatientNameAttributeName()) is None:
+          DICOMPlugin.setPatientAttributesInSubjectHierarchy(patientNode, firstFile, tags)
+    finally:
+      scene.EndState(scene.BatchProcessState)
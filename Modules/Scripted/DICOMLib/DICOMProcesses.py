@@ -278,11 +278,14 @@ class DICOMSender(DICOMProcess):
   (Uses storescu from dcmtk)
   """
 
-  def __init__(self,files,address,port,progressCallback=None):
+  def __init__(self,files,address,port,progressCallback=None,filesPerAssociation=100):
     super(DICOMSender,self).__init__()
     self.files = files
     self.address = address
     self.port = port
+    # storescu sends all the files given on its command line over a single
+    # association, which is much faster than one process per file
+    self.filesPerAssociation = max(1, filesPerAssociation)
     self.progressCallback = progressCallback
     if not self.progressCallback:
       self.progressCallback = self.defaultProgressCallback
@@ -296,25 +299,27 @@ class DICOMSender(DICOMProcess):
 
   def send(self):
     self.progressCallback("Starting send to %s:%s" % (self.address, self.port))
-    for file in self.files:
-      self.start(file)
-      self.progressCallback("Sent %s to %s:%s" % (file, self.address, self.port))
+    for first in range(0, len(self.files), self.filesPerAssociation):
+      files = self.files[first:first + self.filesPerAssociation]
+      self.start(files)
+      for file in files:
+        self.progressCallback("Sent %s to %s:%s" % (file, self.address, self.port))
 
-  def start(self,file):
+  def start(self,files):
     self.storeSCUExecutable = self.exeDir+'/storescu'+self.exeExtension
     # run the process!
     ### TODO: maybe use dcmsend (is smarter about the compress/decompress)
     ### TODO: add option in dialog to set AETitle
-    args = [str(self.address), str(self.port), "-aec", "CTK", file]
+    args = [str(self.address), str(self.port), "-aec", "CTK"] + [str(file) for file in files]
     super(DICOMSender,self).start(self.storeSCUExecutable, args)
-    self.process.waitForFinished()
+    self.process.waitForFinished(-1)
     if self.process.ExitStatus() == qt.QProcess.CrashExit or self.process.exitCode() != 0:
       stdout = self.process.readAllStandardOutput()
       stderr = self.process.readAllStandardError()
       print('error code is: %d' % self.process.error())
       print('standard out is: %s' % stdout)
       print('standard error is: %s' % stderr)
-      raise( UserWarning("Could not send %s to %s:%s" % (file, self.address, self.port)) )
+      raise( UserWarning("Could not send %s to %s:%s" % (", ".join(files), self.address, self.port)) )
 
 
 class DICOMTestingQRServer(object):
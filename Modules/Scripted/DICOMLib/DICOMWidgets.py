@@ -97,6 +97,7 @@ class DICOMDetailsBase(VTKObservationMixin, SizePositionSettingsMixin):
     self.dicomBrowser.connect('databaseDirectoryChanged(QString)', self.onDatabaseDirectoryChanged)
     self.extensionCheckPending = False
     self.dicomBrowser.connect('directoryImported()', self.onDirectoryImported)
+    self.backgroundIndexer = None
 
   def onSendActionTriggered(self, triggered):
     if len(self.fileLists):
@@ -409,6 +410,31 @@ class DICOMDetailsBase(VTKObservationMixin, SizePositionSettingsMixin):
         self.extensionCheckPending = False
       qt.QTimer.singleShot(0, timerCallback)
 
+  def importDirectoryInBackground(self, directory, copyToDatabase=False):
+    """Index the files of the directory into the database without blocking
+    the application. Files that are already indexed and unchanged are skipped."""
+    if not self.backgroundIndexer:
+      self.backgroundIndexer = DICOMLib.DICOMBackgroundIndexer(
+        progressCallback=self.onBackgroundIndexingProgress,
+        finishedCallback=self.onBackgroundIndexingFinished)
+    self.backgroundIndexer.database = slicer.dicomDatabase
+    self.backgroundIndexer.destinationDirectory = '' if copyToDatabase else None
+    self.backgroundIndexer.addDirectory(directory)
+
+  def onBackgroundIndexingProgress(self, indexer):
+    remainingTime = indexer.estimatedRemainingTime()
+    if remainingTime is None:
+      message = "Importing DICOM files: %d processed" % indexer.processedCount
+    else:
+      message = "Importing DICOM files: %d of %d processed, about %d s left" % (
+        indexer.processedCount, indexer.totalCount, int(remainingTime + 0.5))
+    slicer.util.showStatusMessage(message)
+
+  def onBackgroundIndexingFinished(self, indexer):
+    slicer.util.showStatusMessage("Imported %d DICOM files (%d unchanged files skipped)" % (
+      indexer.indexedCount, indexer.skippedCount), 5000)
+    self.onDirectoryImported()
+
   def promptForExtensions(self):
     extensionsToOffer = self.checkForExtensions()
     if len(extensionsToOffer) != 0:
@@ -680,6 +706,8 @@ class DICOMDetailsBase(VTKObservationMixin, SizePositionSettingsMixin):
     step = 0
 
     loadEnabled = False
+    # tag values are retrieved once and shared by all plugins
+    tagCache = DICOMLib.DICOMTagCache(slicer.dicomDatabase)
     plugins = self.pluginSelector.selectedPlugins()
     for pluginClass in plugins:
       if not self.pluginInstances.has_key(pluginClass):
@@ -687,6 +715,7 @@ class DICOMDetailsBase(VTKObservationMixin, SizePositionSettingsMixin):
       plugin = self.pluginInstances[pluginClass]
       if progress.wasCanceled:
         break
+      plugin.tagCache = tagCache
       progress.labelText = '\nChecking %s' % pluginClass
       slicer.app.processEvents()
       progress.setValue(step)
@@ -704,6 +733,7 @@ class DICOMDetailsBase(VTKObservationMixin, SizePositionSettingsMixin):
         slicer.util.warningDisplay("Warning: Plugin failed: %s\n\nSee python console for error message." % pluginClass,
                                    windowTitle="DICOM", parent=self)
         print "DICOM Plugin failed: %s" % str(e)
+      plugin.tagCache = None
       step += 1
 
     progress.close()
@@ -828,6 +858,9 @@ class DICOMDetailsBase(VTKObservationMixin, SizePositionSettingsMixin):
 
     self.addObserver(slicer.mrmlScene, slicer.vtkMRMLScene.NodeAddedEvent, onNodeAdded)
 
+    # Place all loaded series in subject hierarchy at once, after loading
+    DICOMLib.DICOMPlugin.beginSubjectHierarchyInsertion()
+
     for plugin in self.loadablesByPlugin:
       for loadable in self.loadablesByPlugin[plugin]:
         if progress.wasCanceled:
@@ -862,6 +895,10 @@ class DICOMDetailsBase(VTKObservationMixin, SizePositionSettingsMixin):
           # no derived items or some other attribute error
           pass
 
+    progress.labelText = '\nAdding series to subject hierarchy'
+    slicer.app.processEvents()
+    DICOMLib.DICOMPlugin.endSubjectHierarchyInsertion()
+
     self.removeObserver(slicer.mrmlScene, slicer.vtkMRMLScene.NodeAddedEvent, onNodeAdded)
 
     loadedFileParameters = {}
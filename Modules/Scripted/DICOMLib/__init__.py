@@ -1,4 +1,5 @@
 from DICOMProcesses import *
+from DICOMIndexing import *
 from DICOMExportScalarVolume import *
 from DICOMExportScene import *
 from DICOMWidgets import *
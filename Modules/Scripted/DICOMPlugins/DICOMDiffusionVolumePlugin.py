@@ -79,7 +79,7 @@ class DICOMDiffusionVolumePluginClass(DICOMPlugin):
     """
 
     # get the series description to use as base for volume name
-    name = slicer.dicomDatabase.fileValue(files[0], self.tags['seriesDescription'])
+    name = self.fileValue(files[0], self.tags['seriesDescription'])
     if name == "":
       name = "Unknown"
 
@@ -91,7 +91,7 @@ class DICOMDiffusionVolumePluginClass(DICOMPlugin):
         # Check the first three files because some tags may
         # not be present in the b0 image (e.g. for Siemens)
         for i in xrange(0, 3 if (len(files) > 2) else len(files)):
-          value = slicer.dicomDatabase.fileValue(files[i], tag)
+          value = self.fileValue(files[i], tag)
           hasTag = value != ""
           if hasTag:
             matchesVendor &= hasTag
@@ -236,25 +236,15 @@ class DataProbeInfoWidget(object):
 
     self.viewInfo.text = self.generateViewDescription(xyz, ras, sliceNode, sliceLogic)
 
-    def _roundInt(value):
-      try:
-        return int(round(value))
-      except ValueError:
-        return 0
-
     hasVolume = False
     layerLogicCalls = (('L', sliceLogic.GetLabelLayer),
                        ('F', sliceLogic.GetForegroundLayer),
                        ('B', sliceLogic.GetBackgroundLayer))
     for layer,logicCall in layerLogicCalls:
       layerLogic = logicCall()
-      volumeNode = layerLogic.GetVolumeNode()
       ijk = [0, 0, 0]
-      if volumeNode:
+      if layerLogic.GetIJKAtXY(xyz, ijk):
         hasVolume = True
-        xyToIJK = layerLogic.GetXYToIJKTransform()
-        ijkFloat = xyToIJK.TransformDoublePoint(xyz)
-        ijk = [_roundInt(value) for value in ijkFloat]
       self.layerNames[layer].setText(self.generateLayerName(layerLogic))
       self.layerIJKs[layer].setText(self.generateIJKPixelDescription(ijk, layerLogic))
       self.layerValues[layer].setText(self.generateIJKPixelValueDescription(ijk, layerLogic))
@@ -329,7 +319,12 @@ class DataProbeInfoWidget(object):
 
   def generateIJKPixelValueDescription(self, ijk, slicerLayerLogic):
     volumeNode = slicerLayerLogic.GetVolumeNode()
-    return "<b>%s</b>" % self.getPixelString(volumeNode,ijk) if volumeNode else ""
+    if not volumeNode:
+      return ""
+    # Values are looked up by the layer logic, except of tensor volumes
+    if volumeNode.IsA("vtkMRMLDiffusionTensorVolumeNode"):
+      return "<b>%s</b>" % self.getPixelString(volumeNode,ijk)
+    return "<b>%s</b>" % slicerLayerLogic.GetPixelDescriptionAtIJK(ijk)
 
   def _createMagnifiedPixmap(self, xyz, inputImageDataConnection, outputSize, crosshairColor, imageZoom=10):
 
@@ -1,5 +1,6 @@
 import os
 import vtk, qt, ctk, slicer
+import vtkITK
 from EditOptions import HelpButton
 from EditUtil import EditUtil
 import Effect
@@ -199,94 +200,61 @@ class FastMarchingEffectLogic(Effect.EffectLogic):
 
   def __init__(self,sliceLogic):
     super(FastMarchingEffectLogic,self).__init__(sliceLogic)
+    self.fm = None
+    self.seedImage = None
+    self.labelImage = None
+    self.labelMTime = 0
 
   def fastMarching(self,percentMax):
 
-    self.fm = None
-    # allocate a new filter each time March is hit
     bgImage = EditUtil.getBackgroundImage()
     labelImage = EditUtil.getLabelImage()
 
-    # collect seeds
-    dim = bgImage.GetDimensions()
-    print dim
-    # initialize the filter
-    self.fm = slicer.vtkPichonFastMarching()
-    scalarRange = bgImage.GetScalarRange()
-    depth = scalarRange[1]-scalarRange[0]
-
-    # this is more or less arbitrary; large depth values will bring the
-    # algorithm to the knees
-    scaleValue = 0
-    shiftValue = 0
-
-    if depth>300:
-      scaleValue = 300./depth
-    if scalarRange[0] < 0:
-      shiftValue = scalarRange[0]*-1
-
-    if scaleValue or shiftValue:
-      rescale = vtk.vtkImageShiftScale()
-      rescale.SetInputData(bgImage)
-      rescale.SetScale(scaleValue)
-      rescale.SetShift(shiftValue)
-      rescale.Update()
-      bgImage = rescale.GetOutput()
-      scalarRange = bgImage.GetScalarRange()
-      depth = scalarRange[1]-scalarRange[0]
-
-    print('Input scalar range: '+str(depth))
-    self.fm.init(dim[0], dim[1], dim[2], depth, 1, 1, 1)
-
-    caster = vtk.vtkImageCast()
-    caster.SetOutputScalarTypeToShort()
-    caster.SetInputData(bgImage)
-    self.fm.SetInputConnection(caster.GetOutputPort())
-
-    # self.fm.SetOutput(labelImage)
+    if not self.fm:
+      self.fm = vtkITK.vtkITKFastMarchingSegmentation()
+      self.seedImage = vtk.vtkImageData()
 
+    # the filter keeps the arrival times as long as the seeds do not change:
+    # marching again with another volume only marches the difference
+    if labelImage is not self.labelImage or labelImage.GetMTime() != self.labelMTime:
+      self.seedImage.DeepCopy(labelImage)
+      self.labelImage = labelImage
+
+    dim = bgImage.GetDimensions()
     npoints = int(dim[0]*dim[1]*dim[2]*percentMax/100.)
 
-    self.fm.setNPointsEvolution(npoints)
+    self.fm.SetInputData(0, bgImage)
+    self.fm.SetInputData(1, self.seedImage)
     print('Setting active label to '+str(EditUtil.getLabel()))
-    self.fm.setActiveLabel(EditUtil.getLabel())
-
-    nSeeds = self.fm.addSeedsFromImage(labelImage)
-    if nSeeds == 0:
-      return 0
-
-    self.fm.Modified()
-    self.fm.Update()
-
-    # TODO: need to call show() twice for data to be updated
-    self.fm.show(1)
-    self.fm.Modified()
+    self.fm.SetLabel(EditUtil.getLabel())
+    self.fm.SetTargetNumberOfVoxels(npoints)
+    self.fm.SetShowFraction(1)
     self.fm.Update()
 
-    self.fm.show(1)
-    self.fm.Modified()
-    self.fm.Update()
+    if self.fm.GetNumberOfMarchedVoxels() == 0:
+      return 0
 
     self.undoRedo.saveState()
 
-    EditUtil.getLabelImage().DeepCopy(self.fm.GetOutput())
-    EditUtil.markVolumeNodeAsModified(self.sliceLogic.GetLabelLayer().GetVolumeNode())
-    # print('FastMarching output image: '+str(output))
+    self.updateLabelImage()
     print('FastMarching march update completed')
 
     return npoints
 
   def updateLabel(self,value):
-    if not self.fm:
+    if not self.fm or self.fm.GetNumberOfMarchedVoxels() == 0:
       return
-    self.fm.show(value)
-    self.fm.Modified()
+    self.fm.SetShowFraction(value)
     self.fm.Update()
 
-    EditUtil.getLabelImage().DeepCopy(self.fm.GetOutput())
-    EditUtil.getLabelImage().Modified()
+    self.updateLabelImage()
 
+  def updateLabelImage(self):
+    labelImage = EditUtil.getLabelImage()
+    labelImage.DeepCopy(self.fm.GetOutput())
     EditUtil.markVolumeNodeAsModified(self.sliceLogic.GetLabelLayer().GetVolumeNode())
+    # remember the label map state to know if the seeds have been edited
+    self.labelMTime = labelImage.GetMTime()
 
   def getLabelNode(self):
     return self.sliceLogic.GetLabelLayer().GetVolumeNode()
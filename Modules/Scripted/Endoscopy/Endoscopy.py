@@ -52,8 +52,11 @@ class EndoscopyWidget(ScriptedLoadableModuleWidget):
     # Flythough variables
     self.transform = None
     self.path = None
+    self.frameMatrices = None
     self.camera = None
     self.skip = 0
+    self.playbackStartFrame = 0
+    self.playbackTime = qt.QTime()
     self.timer = qt.QTimer()
     self.timer.setInterval(20)
     self.timer.connect('timeout()', self.flyToNext)
@@ -231,10 +234,25 @@ class EndoscopyWidget(ScriptedLoadableModuleWidget):
     self.camera = self.camera
     self.transform = model.transform
     self.path = result.path
+    self.frameMatrices = self.computeFrameMatrices(model.transform, result.path)
 
     # Enable / Disable flythrough button
     self.flythroughCollapsibleButton.enabled = len(result.path) > 0
 
+  def computeFrameMatrices(self, transform, path):
+    """Precompute the cursor transform of each frame of the path."""
+    toParent = vtk.vtkMatrix4x4()
+    transform.GetMatrixTransformToParent(toParent)
+    frameMatrices = []
+    for p in path[:-1]:
+      frameMatrix = vtk.vtkMatrix4x4()
+      frameMatrix.DeepCopy(toParent)
+      frameMatrix.SetElement(0, 3, p[0])
+      frameMatrix.SetElement(1, 3, p[1])
+      frameMatrix.SetElement(2, 3, p[2])
+      frameMatrices.append(frameMatrix)
+    return frameMatrices
+
   def frameSliderValueChanged(self, newValue):
     #print "frameSliderValueChanged:", newValue
     self.flyTo(newValue)
@@ -255,18 +273,61 @@ class EndoscopyWidget(ScriptedLoadableModuleWidget):
 
   def onPlayButtonToggled(self, checked):
     if checked:
+      self.playbackStartFrame = int(self.frameSlider.value)
+      self.playbackTime.start()
+      self.setInteractiveRendering(True)
       self.timer.start()
       self.playButton.text = "Stop"
     else:
       self.timer.stop()
+      self.setInteractiveRendering(False)
       self.playButton.text = "Play"
 
   def flyToNext(self):
-    currentStep = self.frameSlider.value
-    nextStep = currentStep + self.skip + 1
-    if nextStep > len(self.path) - 2:
-      nextStep = 0
-    self.frameSlider.value = nextStep
+    """The frame is chosen from the time elapsed since the playback started,
+    frames are skipped when rendering takes longer than the frame delay so
+    that the fly-through speed does not depend on the scene complexity."""
+    if not self.path:
+      return
+    elapsedFrames = self.playbackTime.elapsed() // max(self.timer.interval, 1)
+    numberOfFrames = len(self.path) - 1
+    nextStep = (self.playbackStartFrame + elapsedFrames * (self.skip + 1)) % numberOfFrames
+    if nextStep != int(self.frameSlider.value):
+      self.frameSlider.value = nextStep
+
+  def threeDViewsOfCamera(self):
+    """Return the 3D views rendered with the selected camera."""
+    views = []
+    layoutManager = slicer.app.layoutManager()
+    if not layoutManager or not self.cameraNode:
+      return views
+    for index in range(layoutManager.threeDViewCount):
+      view = layoutManager.threeDWidget(index).threeDView()
+      viewNode = view.mrmlViewNode()
+      if viewNode and viewNode.GetID() == self.cameraNode.GetActiveTag():
+        views.append(view)
+    return views
+
+  def setInteractiveRendering(self, interactive):
+    """Render the camera views as during a mouse interaction while flying:
+    the desired update rate of the render window is set to the interactive
+    rate and the interaction events let the displayable managers (e.g. volume
+    rendering) lower their quality. Full quality is restored at the end."""
+    for view in self.threeDViewsOfCamera():
+      renderWindow = view.renderWindow()
+      interactor = renderWindow.GetInteractor()
+      if not interactor:
+        continue
+      style = interactor.GetInteractorStyle()
+      if interactive:
+        renderWindow.SetDesiredUpdateRate(interactor.GetDesiredUpdateRate())
+        if style:
+          style.InvokeEvent(vtk.vtkCommand.StartInteractionEvent)
+      else:
+        renderWindow.SetDesiredUpdateRate(interactor.GetStillUpdateRate())
+        if style:
+          style.InvokeEvent(vtk.vtkCommand.EndInteractionEvent)
+        view.scheduleRender()
 
   def flyTo(self, f):
     """ Apply the fth step in the path to the global camera"""
@@ -277,12 +338,7 @@ class EndoscopyWidget(ScriptedLoadableModuleWidget):
       foc = self.path[f+1]
       self.camera.SetFocalPoint(*foc)
 
-      toParent = vtk.vtkMatrix4x4()
-      self.transform.GetMatrixTransformToParent(toParent)
-      toParent.SetElement(0 ,3, p[0])
-      toParent.SetElement(1, 3, p[1])
-      toParent.SetElement(2, 3, p[2])
-      self.transform.SetMatrixTransformToParent(toParent)
+      self.transform.SetMatrixTransformToParent(self.frameMatrices[f])
 
 
 class EndoscopyComputePath:
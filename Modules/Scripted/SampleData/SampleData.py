@@ -74,19 +74,27 @@ class SampleDataSource:
 
     dataSource = SampleData.SampleDataSource('fixed', 'http://slicer.kitware.com/midas3/download/item/157188/small-mr-eye-fixed.nrrd', 'fixed.nrrd', 'fixed')
     fixed = sampleDataLogic.downloadFromSource(dataSource)[0]
+
+  Optional checksums ('<algorithm>:<hex digest>', e.g. 'SHA256:9a2f...',
+  any algorithm of hashlib) are verified after download and when a file
+  is reused from the cache.
   """
 
-  def __init__(self,sampleName=None,uris=None,fileNames=None,nodeNames=None,customDownloader=None):
+  def __init__(self,sampleName=None,uris=None,fileNames=None,nodeNames=None,customDownloader=None,checksums=None):
     self.sampleName = sampleName
     if isinstance(uris, basestring):
       uris = [uris,]
       fileNames = [fileNames,]
       nodeNames = [nodeNames,]
+      checksums = [checksums,]
+    if checksums is None:
+      checksums = [None,] * len(uris)
     self.uris = uris
     self.fileNames = fileNames
     self.nodeNames = nodeNames
+    self.checksums = checksums
     self.customDownloader = customDownloader
-    if len(uris) != len(fileNames) or len(uris) != len(nodeNames):
+    if len(uris) != len(fileNames) or len(uris) != len(nodeNames) or len(uris) != len(checksums):
       raise Exception("All fields of sample data source must have the same length")
 
 
@@ -160,7 +168,14 @@ class SampleDataLogic:
   SampleDataSource class.  These instances should be stored in a
   list that is assigned to a category following the model
   used in registerBuiltInSampleDataSources below.
+
+  All the files of a source are downloaded concurrently (up to
+  maximumNumberOfConcurrentDownloads at a time), interrupted downloads
+  are resumed from the partially downloaded file.
   """
+
+  maximumNumberOfConcurrentDownloads = 4
+
   def __init__(self, logMessage=None):
     if logMessage:
       self.logMessage = logMessage
@@ -197,26 +212,33 @@ class SampleDataLogic:
     for sourceArgument in sourceArguments:
       slicer.modules.sampleDataSources['BuiltIn'].append(SampleDataSource(*sourceArgument))
 
-  def downloadFileIntoCache(self, uri, name):
+  def downloadFileIntoCache(self, uri, name, checksum=None):
     """Given a uri and and a filename, download the data into
     a file of the given name in the scene's cache"""
     destFolderPath = slicer.mrmlScene.GetCacheManager().GetRemoteCacheDirectory()
-    return self.downloadFile(uri, destFolderPath, name)
+    return self.downloadFile(uri, destFolderPath, name, checksum)
+
+  def downloadFilesIntoCache(self, uris, names, checksums=None):
+    """Download several files into the scene's cache concurrently
+    and return the list of file paths, in the order of uris"""
+    if checksums is None:
+      checksums = [None,] * len(uris)
+    if len(uris) == 1:
+      return [self.downloadFileIntoCache(uris[0], names[0], checksums[0])]
+    destFolderPath = slicer.mrmlScene.GetCacheManager().GetRemoteCacheDirectory()
+    return self.downloadFiles(uris, destFolderPath, names, checksums)
 
   def downloadSourceIntoCache(self, source):
     """Download all files for the given source and return a
     list of file paths for the results"""
-    filePaths = []
-    for uri,fileName in zip(source.uris,source.fileNames):
-      filePaths.append(self.downloadFileIntoCache(uri, fileName))
-    return filePaths
+    return self.downloadFilesIntoCache(source.uris, source.fileNames, source.checksums)
 
   def downloadFromSource(self,source):
     """Given an instance of SampleDataSource, downloads the data
     if needed and loads the results in slicer"""
     nodes = []
-    for uri,fileName,nodeName in zip(source.uris,source.fileNames,source.nodeNames):
-      filePath = self.downloadFileIntoCache(uri, fileName)
+    filePaths = self.downloadSourceIntoCache(source)
+    for filePath,nodeName in zip(filePaths,source.nodeNames):
       if nodeName:
         nodes.append(self.loadVolume(filePath, nodeName))
     return nodes
@@ -299,22 +321,125 @@ class SampleDataLogic:
       self.logMessage('<i>Downloaded %s (%d%% of %s)...</i>' % (humanSizeSoFar, percent, humanSizeTotal))
       self.downloadPercent = percent
 
-  def downloadFile(self, uri, destFolderPath, name):
-    filePath = destFolderPath + '/' + name
+  def isFileInCache(self, filePath, checksum=None):
+    """Return True if the file exists and matches the checksum (if any).
+    A cached file that does not match the checksum is removed."""
     if not os.path.exists(filePath) or os.stat(filePath).st_size == 0:
-      import urllib
+      return False
+    if checksum and self.computeChecksum(filePath, checksum.split(':')[0]) != checksum.lower():
+      logging.warning('Cached file %s does not match checksum %s, downloading it again' % (filePath, checksum))
+      os.remove(filePath)
+      return False
+    return True
+
+  def computeChecksum(self, filePath, algorithm):
+    """Return the '<algorithm>:<hex digest>' checksum of a file (lowercase)"""
+    import hashlib
+    fileHash = hashlib.new(algorithm.lower())
+    with open(filePath, 'rb') as f:
+      for chunk in iter(lambda: f.read(1024 * 1024), b''):
+        fileHash.update(chunk)
+    return '%s:%s' % (algorithm.lower(), fileHash.hexdigest())
+
+  def fetchFile(self, uri, filePath, checksum=None, progressCallback=None):
+    """Download uri into filePath and return None on success or the error message.
+    The data is first written into filePath + '.part'. If that file exists, the
+    download is resumed with an HTTP range request. This method does not update
+    the GUI, it can be called from any thread."""
+    import urllib2
+    partialFilePath = filePath + '.part'
+    bytesSoFar = os.stat(partialFilePath).st_size if os.path.exists(partialFilePath) else 0
+    request = urllib2.Request(uri)
+    if bytesSoFar > 0:
+      request.add_header('Range', 'bytes=%d-' % bytesSoFar)
+    try:
+      try:
+        response = urllib2.urlopen(request)
+      except urllib2.HTTPError as e:
+        if e.code != 416 or bytesSoFar == 0:
+          raise
+        # Requested range not satisfiable: the partial file is complete
+        response = None
+      if response is not None:
+        if bytesSoFar > 0 and response.getcode() != 206:
+          # The server does not support range requests, start over
+          bytesSoFar = 0
+        contentLength = response.info().getheader('Content-Length')
+        totalSize = bytesSoFar + int(contentLength) if contentLength else -1
+        with open(partialFilePath, 'ab' if bytesSoFar > 0 else 'wb') as f:
+          while True:
+            chunk = response.read(1024 * 1024)
+            if not chunk:
+              break
+            f.write(chunk)
+            bytesSoFar += len(chunk)
+            if progressCallback:
+              progressCallback(bytesSoFar, totalSize)
+        response.close()
+    except (IOError, ValueError) as e:
+      return str(e)
+    if checksum:
+      actualChecksum = self.computeChecksum(partialFilePath, checksum.split(':')[0])
+      if actualChecksum != checksum.lower():
+        os.remove(partialFilePath)
+        return 'checksum mismatch (expected %s, got %s)' % (checksum, actualChecksum)
+    if os.path.exists(filePath):
+      os.remove(filePath)
+    os.rename(partialFilePath, filePath)
+    return None
+
+  def downloadFile(self, uri, destFolderPath, name, checksum=None):
+    filePath = destFolderPath + '/' + name
+    if not self.isFileInCache(filePath, checksum):
       self.logMessage('<b>Requesting download</b> <i>%s</i> from %s...\n' % (name, uri))
       # add a progress bar
       self.downloadPercent = 0
-      try:
-        urllib.urlretrieve(uri, filePath, self.reportHook)
+      error = self.fetchFile(uri, filePath, checksum,
+        lambda bytesSoFar, totalSize: totalSize > 0 and self.reportHook(bytesSoFar, 1, totalSize))
+      if error is None:
         self.logMessage('<b>Download finished</b>')
-      except IOError as e:
-        self.logMessage('<b><font color="red">\tDownload failed: %s</font></b>' % e)
+      else:
+        self.logMessage('<b><font color="red">\tDownload failed: %s</font></b>' % error)
     else:
       self.logMessage('<b>File already exists in cache - reusing it.</b>')
     return filePath
 
+  def downloadFiles(self, uris, destFolderPath, names, checksums):
+    """Download several files concurrently and return their paths.
+    Messages are logged from the calling thread only."""
+    import threading
+    filePaths = [destFolderPath + '/' + name for name in names]
+    pending = []
+    for uri, filePath, name, checksum in zip(uris, filePaths, names, checksums):
+      if self.isFileInCache(filePath, checksum):
+        self.logMessage('<b>File %s already exists in cache - reusing it.</b>' % name)
+      else:
+        pending.append((uri, filePath, name, checksum))
+    results = {}
+    def fetch(uri, filePath, checksum):
+      results[filePath] = self.fetchFile(uri, filePath, checksum)
+    running = []
+    while pending or running:
+      while pending and len(running) < self.maximumNumberOfConcurrentDownloads:
+        uri, filePath, name, checksum = pending.pop(0)
+        self.logMessage('<b>Requesting download</b> <i>%s</i> from %s...\n' % (name, uri))
+        thread = threading.Thread(target=fetch, args=(uri, filePath, checksum))
+        thread.daemon = True
+        thread.start()
+        running.append((thread, name))
+      for thread, name in running[:]:
+        thread.join(0.05)
+        if thread.is_alive():
+          continue
+        running.remove((thread, name))
+        error = results.get(destFolderPath + '/' + name)
+        if error is None:
+          self.logMessage('<b>Download of %s finished</b>' % name)
+        else:
+          self.logMessage('<b><font color="red">\tDownload of %s failed: %s</font></b>' % (name, error))
+      slicer.app.processEvents(qt.QEventLoop.ExcludeUserInputEvents)
+    return filePaths
+
   def loadVolume(self, uri, name):
     self.logMessage('<b>Requesting load</b> <i>%s</i> from %s...\n' % (name, uri))
     success, volumeNode = slicer.util.loadVolume(uri, properties = {'name' : name}, returnNode=True)
@@ -225,6 +225,15 @@ class ScreenCaptureWidget(ScriptedLoadableModuleWidget):
       +'should not be included in this list.')
     advancedFormLayout.addRow("Video extra options:", self.extraVideoOptionsWidget)
 
+    self.imageMagnificationWidget = qt.QSpinBox()
+    self.imageMagnificationWidget.minimum = 1
+    self.imageMagnificationWidget.maximum = 8
+    self.imageMagnificationWidget.value = 1
+    self.imageMagnificationWidget.suffix = "x"
+    self.imageMagnificationWidget.setToolTip("Captured images are this many times larger than the view."
+      " Larger images are rendered in multiple tiles, therefore the output resolution is not limited by the screen size.")
+    advancedFormLayout.addRow("Image magnification:", self.imageMagnificationWidget)
+
     self.fileNamePatternWidget = qt.QLineEdit()
     self.fileNamePatternWidget.setToolTip(
       "String that defines file name, type, and numbering scheme. Default: image%05d.png.")
@@ -430,9 +439,16 @@ class ScreenCaptureWidget(ScriptedLoadableModuleWidget):
     # existing files in the output directory
     imageFileNamePattern = self.logic.getRandomFilePattern() if videoOutputRequested else self.fileNamePatternWidget.text
 
+    self.logic.imageMagnification = self.imageMagnificationWidget.value
+
     slicer.app.setOverrideCursor(qt.Qt.WaitCursor)
 
     try:
+      if videoOutputRequested:
+        # Frames are sent directly to the video encoder, no image files are written
+        fps = numberOfSteps / self.videoLengthSliderWidget.value
+        self.logic.startVideoEncoding(fps, self.extraVideoOptionsWidget.text, outputDir, self.videoFileNameWidget.text)
+
       if self.animationModeWidget.currentText == "slice sweep":
         self.logic.captureSliceSweep(viewNode, self.sliceStartOffsetSliderWidget.value,
           self.sliceEndOffsetSliderWidget.value, numberOfSteps, outputDir, imageFileNamePattern)
@@ -449,19 +465,13 @@ class ScreenCaptureWidget(ScriptedLoadableModuleWidget):
         raise ValueError('Unsupported view node type.')
 
       if videoOutputRequested:
-        fps = numberOfSteps / self.videoLengthSliderWidget.value
-        try:
-          self.logic.createVideo(fps, self.extraVideoOptionsWidget.text,
-            outputDir, imageFileNamePattern, self.videoFileNameWidget.text)
-        except Exception as e:
-          self.logic.deleteTemporaryFiles(outputDir, imageFileNamePattern, numberOfSteps)
-          raise ValueError(e)
-        self.logic.deleteTemporaryFiles(outputDir, imageFileNamePattern, numberOfSteps)
+        self.logic.finishVideoEncoding()
 
       self.addLog("Done.")
       self.createdOutputFile = os.path.join(outputDir, self.videoFileNameWidget.text) if videoOutputRequested else outputDir
       self.showCreatedOutputFileButton.enabled = True
     except Exception as e:
+      self.logic.abortVideoEncoding()
       self.addLog("Unexpected error: {0}".format(e.message))
       import traceback
       traceback.print_exc()
@@ -485,6 +495,10 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
 
   def __init__(self):
     self.logCallback = None
+    # Captured images are this many times larger than the view
+    self.imageMagnification = 1
+    # If set then captured frames are sent to this encoder instead of written to image files
+    self.videoEncoder = None
 
     self.videoFormatPresets = [
       {"name": "H.264",                    "fileExtension": "mp4", "extraVideoOptions": "-codec libx264 -preset slower -pix_fmt yuv420p"},
@@ -632,14 +646,20 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
     return sliceOffsetResolution
 
   def captureImageFromView(self, view, filename):
+    """Capture the view and write it to an image file,
+    or send it to the video encoder if video encoding is started."""
     view.forceRender()
     # qt.QPixmap().grabWidget(...) would not grab the background
     rw = view.renderWindow()
     wti = vtk.vtkWindowToImageFilter()
     wti.SetInput(rw)
+    if self.imageMagnification > 1:
+      # render the view in tiles to get an image larger than the view
+      wti.SetScale(self.imageMagnification)
+    else:
+      # the view has just been rendered, do not render it again
+      wti.ShouldRerenderOff()
     wti.Update()
-    writer = vtk.vtkPNGWriter()
-    writer.SetFileName(filename)
     outputImage = wti.GetOutput()
     imageSize = outputImage.GetDimensions()
 
@@ -647,6 +667,13 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
       # image is too small, most likely it is invalid
       raise ValueError('Capture image from view failed')
 
+    if self.videoEncoder:
+      self.videoEncoder.addFrame(outputImage)
+      return
+
+    writer = vtk.vtkPNGWriter()
+    writer.SetFileName(filename)
+
     # Make sure image witdth and height is even, otherwise encoding may fail
     imageWidthOdd = (imageSize[0] & 1 == 1)
     imageHeightOdd = (imageSize[1] & 1 == 1)
@@ -793,6 +820,32 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
     sequenceBrowserNode.SetSelectedItemNumber(originalSelectedItemNumber)
 
 
+  def startVideoEncoding(self, frameRate, extraOptions, outputDir, videoFileName):
+    """Send all images captured until finishVideoEncoding() to ffmpeg, without writing image files."""
+    ffmpegPath = os.path.abspath(self.getFfmpegPath())
+    if not os.path.isfile(ffmpegPath):
+      raise ValueError("Video creation failed: ffmpeg executable path is invalid: "+ffmpegPath)
+    if not os.path.exists(outputDir):
+      os.makedirs(outputDir)
+    outputVideoFilePath = os.path.join(outputDir, videoFileName)
+    self.addLog("Export to video...")
+    self.videoEncoder = FfmpegVideoEncoder(ffmpegPath, frameRate, extraOptions, outputVideoFilePath, self.addLog)
+
+  def finishVideoEncoding(self):
+    """Wait for ffmpeg to write the video file of the captured images."""
+    if not self.videoEncoder:
+      return
+    videoEncoder = self.videoEncoder
+    self.videoEncoder = None
+    videoEncoder.close()
+    self.addLog("Video export succeeded to file: "+videoEncoder.outputVideoFilePath)
+
+  def abortVideoEncoding(self):
+    if not self.videoEncoder:
+      return
+    self.videoEncoder.abort()
+    self.videoEncoder = None
+
   def createVideo(self, frameRate, extraOptions, outputDir, imageFileNamePattern, videoFileName):
     self.addLog("Export to video...")
 
@@ -838,6 +891,105 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
       logging.debug("Delete temporary file " + filename)
       os.remove(filename)
 
+#
+# FfmpegVideoEncoder
+#
+
+class FfmpegVideoEncoder(object):
+  """Write images to a video file by sending them as raw frames to the standard input of ffmpeg.
+  ffmpeg is started when the first frame is added, as the frame size must be known.
+  """
+
+  def __init__(self, ffmpegPath, frameRate, extraOptions, outputVideoFilePath, logCallback=None):
+    self.ffmpegPath = ffmpegPath
+    self.frameRate = frameRate
+    self.extraOptions = extraOptions
+    self.outputVideoFilePath = outputVideoFilePath
+    self.logCallback = logCallback
+    self.process = None
+    self.errorOutput = None
+    self.frameSize = None
+    self.numberOfComponents = None
+
+  def addFrame(self, imageData):
+    from vtk.util import numpy_support
+    dims = imageData.GetDimensions()
+    scalars = imageData.GetPointData().GetScalars()
+    numberOfComponents = scalars.GetNumberOfComponents()
+    # Width and height must be even, otherwise encoding may fail
+    frameSize = (dims[0] & ~1, dims[1] & ~1)
+    if self.process is None:
+      self.start(frameSize, numberOfComponents)
+    elif frameSize != self.frameSize or numberOfComponents != self.numberOfComponents:
+      raise ValueError("Video creation failed: view size changed during capture")
+    # VTK image rows are stored from bottom to top, video frames from top to bottom
+    pixels = numpy_support.vtk_to_numpy(scalars).reshape(dims[1], dims[0], numberOfComponents)
+    pixels = pixels[frameSize[1]-1::-1, :frameSize[0]]
+    try:
+      self.process.stdin.write(pixels.tostring())
+    except IOError:
+      # ffmpeg exited, report its error
+      self.close()
+      raise ValueError("Video creation failed: ffmpeg stopped reading images")
+
+  def start(self, frameSize, numberOfComponents):
+    import subprocess
+    import tempfile
+    self.frameSize = frameSize
+    self.numberOfComponents = numberOfComponents
+    pixelFormats = {1: "gray", 3: "rgb24", 4: "rgba"}
+    if numberOfComponents not in pixelFormats:
+      raise ValueError("Video creation failed: unsupported number of image components: "+str(numberOfComponents))
+    ffmpegParams = [self.ffmpegPath,
+                    "-y", # overwrite without asking
+                    "-f", "rawvideo",
+                    "-pix_fmt", pixelFormats[numberOfComponents],
+                    "-s", "%dx%d" % frameSize,
+                    "-r", str(self.frameRate),
+                    "-i", "-"]
+    ffmpegParams += filter(None, self.extraOptions.split(' '))
+    ffmpegParams.append(self.outputVideoFilePath)
+    if self.logCallback:
+      self.logCallback("Start ffmpeg:\n"+' '.join(ffmpegParams))
+    # ffmpeg continuously reports progress, it is written to a file to make sure
+    # ffmpeg is not blocked by a full pipe while frames are written
+    self.errorOutput = tempfile.TemporaryFile()
+    self.process = subprocess.Popen(ffmpegParams, stdin=subprocess.PIPE,
+      stdout=self.errorOutput, stderr=self.errorOutput,
+      cwd=os.path.dirname(self.outputVideoFilePath))
+
+  def close(self):
+    if self.process is None:
+      raise ValueError("Video creation failed: no images were captured")
+    process = self.process
+    self.process = None
+    try:
+      process.stdin.close()
+    except IOError:
+      pass
+    returnCode = process.wait()
+    self.errorOutput.seek(0)
+    output = self.errorOutput.read()
+    self.errorOutput.close()
+    if returnCode != 0:
+      if self.logCallback:
+        self.logCallback("ffmpeg error output: " + output)
+      raise ValueError("ffmpeg returned with error")
+    logging.debug("ffmpeg output: " + output)
+
+  def abort(self):
+    if self.process is None:
+      return
+    process = self.process
+    self.process = None
+    try:
+      process.stdin.close()
+    except IOError:
+      pass
+    process.kill()
+    process.wait()
+    self.errorOutput.close()
+
 class ScreenCaptureTest(ScriptedLoadableModuleTest):
   """
   This is the test case for your scripted module.
@@ -890,6 +1042,7 @@ class ScreenCaptureTest(ScriptedLoadableModuleTest):
     self.test_SliceSweep()
     self.test_SliceFade()
     self.test_3dViewRotation()
+    self.test_ImageMagnification()
 
   def test_SliceSweep(self):
     self.delayDisplay("Testing SliceSweep")
@@ -914,3 +1067,21 @@ class ScreenCaptureTest(ScriptedLoadableModuleTest):
     self.logic.capture3dViewRotation(viewNode, -180, 180, self.numberOfImages, self.tempDir, self.imageFileNamePattern)
     self.verifyAndDeleteWrittenFiles()
     self.delayDisplay('Testing 3D view rotation completed successfully')
+
+  def test_ImageMagnification(self):
+    self.delayDisplay("Testing image magnification")
+    viewNode = slicer.util.getNode('vtkMRMLViewNode1')
+    self.assertIsNotNone(viewNode)
+    renderWindowSize = self.logic.viewFromNode(viewNode).renderWindow().GetSize()
+    self.logic.imageMagnification = 2
+    self.logic.capture3dViewRotation(viewNode, -180, 180, self.numberOfImages, self.tempDir, self.imageFileNamePattern)
+    self.logic.imageMagnification = 1
+    import os
+    reader = vtk.vtkPNGReader()
+    reader.SetFileName(os.path.join(self.tempDir, self.imageFileNamePattern % 0))
+    reader.Update()
+    imageSize = reader.GetOutput().GetDimensions()
+    self.assertEqual(imageSize[0], renderWindowSize[0]*2)
+    self.assertEqual(imageSize[1], renderWindowSize[1]*2)
+    self.verifyAndDeleteWrittenFiles()
+    self.delayDisplay('Testing image magnification completed successfully')
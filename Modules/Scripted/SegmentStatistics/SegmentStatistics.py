@@ -1,4 +1,5 @@
 import os
+import math
 import unittest
 import vtk, qt, ctk, slicer
 from slicer.ScriptedLoadableModule import *
@@ -188,141 +189,23 @@ class SegmentStatisticsLogic(ScriptedLoadableModuleLogic):
       self.statistics["SegmentIDs"].append(segmentID)
       self.statistics[segmentID,"Segment"] = segment.GetName()
 
-    self.addSegmentLabelmapStatistics()
-    self.addGrayscaleVolumeStatistics()
-    self.addSegmentClosedSurfaceStatistics()
-
-  def addSegmentLabelmapStatistics(self):
-    import vtkSegmentationCorePython as vtkSegmentationCore
-
-    containsLabelmapRepresentation = self.segmentationNode.GetSegmentation().ContainsRepresentation(
-      vtkSegmentationCore.vtkSegmentationConverter.GetSegmentationBinaryLabelmapRepresentationName())
-    if not containsLabelmapRepresentation:
-      return
-
-    for segmentID in self.statistics["SegmentIDs"]:
-      segment = self.segmentationNode.GetSegmentation().GetSegment(segmentID)
-      segmentLabelmap = segment.GetRepresentation(vtkSegmentationCore.vtkSegmentationConverter.GetSegmentationBinaryLabelmapRepresentationName())
-
-      # We need to know exactly the value of the segment voxels, apply threshold to make force the selected label value
-      labelValue = 1
-      backgroundValue = 0
-      thresh = vtk.vtkImageThreshold()
-      thresh.SetInputData(segmentLabelmap)
-      thresh.ThresholdByLower(0)
-      thresh.SetInValue(backgroundValue)
-      thresh.SetOutValue(labelValue)
-      thresh.SetOutputScalarType(vtk.VTK_UNSIGNED_CHAR)
-      thresh.Update()
-
-      #  Use binary labelmap as a stencil
-      stencil = vtk.vtkImageToImageStencil()
-      stencil.SetInputData(thresh.GetOutput())
-      stencil.ThresholdByUpper(labelValue)
-      stencil.Update()
-
-      stat = vtk.vtkImageAccumulate()
-      stat.SetInputData(thresh.GetOutput())
-      stat.SetStencilData(stencil.GetOutput())
-      stat.Update()
-
-      # Add data to statistics list
-      cubicMMPerVoxel = reduce(lambda x,y: x*y, segmentLabelmap.GetSpacing())
-      ccPerCubicMM = 0.001
-      self.statistics[segmentID,"LM voxel count"] = stat.GetVoxelCount()
-      self.statistics[segmentID,"LM volume mm3"] = stat.GetVoxelCount() * cubicMMPerVoxel
-      self.statistics[segmentID,"LM volume cc"] = stat.GetVoxelCount() * cubicMMPerVoxel * ccPerCubicMM
-
-  def addSegmentClosedSurfaceStatistics(self):
-    import vtkSegmentationCorePython as vtkSegmentationCore
-
-    containsClosedSurfaceRepresentation = self.segmentationNode.GetSegmentation().ContainsRepresentation(
-      vtkSegmentationCore.vtkSegmentationConverter.GetSegmentationClosedSurfaceRepresentationName())
-    if not containsClosedSurfaceRepresentation:
-      return
-
-    for segmentID in self.statistics["SegmentIDs"]:
-      segment = self.segmentationNode.GetSegmentation().GetSegment(segmentID)
-      segmentClosedSurface = segment.GetRepresentation(vtkSegmentationCore.vtkSegmentationConverter.GetSegmentationClosedSurfaceRepresentationName())
-
-      # Compute statistics
-      massProperties = vtk.vtkMassProperties()
-      massProperties.SetInputData(segmentClosedSurface)
-
-      # Add data to statistics list
-      ccPerCubicMM = 0.001
-      self.statistics[segmentID,"CS surface mm2"] = massProperties.GetSurfaceArea()
-      self.statistics[segmentID,"CS volume mm3"] = massProperties.GetVolume()
-      self.statistics[segmentID,"CS volume cc"] = massProperties.GetVolume() * ccPerCubicMM
-
-  def addGrayscaleVolumeStatistics(self):
-    import vtkSegmentationCorePython as vtkSegmentationCore
-
-    containsLabelmapRepresentation = self.segmentationNode.GetSegmentation().ContainsRepresentation(
-      vtkSegmentationCore.vtkSegmentationConverter.GetSegmentationBinaryLabelmapRepresentationName())
-    if not containsLabelmapRepresentation:
-      return
-
-    if self.grayscaleNode is None or self.grayscaleNode.GetImageData() is None:
+    # All statistics are computed in a single pass over the volume by the segmentations logic
+    statisticsTable = slicer.vtkMRMLTableNode()
+    if not slicer.vtkSlicerSegmentationsModuleLogic.ComputeSegmentStatistics(self.segmentationNode, self.grayscaleNode,
+        statisticsTable, visibleSegmentIds):
+      logging.error("computeStatistics: failed to compute segment statistics")
       return
-
-    # Get geometry of grayscale volume node as oriented image data
-    referenceGeometry_Reference = vtkSegmentationCore.vtkOrientedImageData() # reference geometry in reference node coordinate system
-    referenceGeometry_Reference.SetExtent(self.grayscaleNode.GetImageData().GetExtent())
-    ijkToRasMatrix = vtk.vtkMatrix4x4()
-    self.grayscaleNode.GetIJKToRASMatrix(ijkToRasMatrix)
-    referenceGeometry_Reference.SetGeometryFromImageToWorldMatrix(ijkToRasMatrix)
-
-    # Get transform between grayscale volume and segmentation
-    segmentationToReferenceGeometryTransform = vtk.vtkGeneralTransform()
-    slicer.vtkMRMLTransformNode.GetTransformBetweenNodes(self.segmentationNode.GetParentTransformNode(),
-      self.grayscaleNode.GetParentTransformNode(), segmentationToReferenceGeometryTransform)
-
-    cubicMMPerVoxel = reduce(lambda x,y: x*y, referenceGeometry_Reference.GetSpacing())
-    ccPerCubicMM = 0.001
-
-    for segmentID in self.statistics["SegmentIDs"]:
-      segment = self.segmentationNode.GetSegmentation().GetSegment(segmentID)
-      segmentLabelmap = segment.GetRepresentation(vtkSegmentationCore.vtkSegmentationConverter.GetSegmentationBinaryLabelmapRepresentationName())
-
-      segmentLabelmap_Reference = vtkSegmentationCore.vtkOrientedImageData()
-      vtkSegmentationCore.vtkOrientedImageDataResample.ResampleOrientedImageToReferenceOrientedImage(
-        segmentLabelmap, referenceGeometry_Reference, segmentLabelmap_Reference,
-        False, # nearest neighbor interpolation
-        False, # no padding
-        segmentationToReferenceGeometryTransform)
-
-      # We need to know exactly the value of the segment voxels, apply threshold to make force the selected label value
-      labelValue = 1
-      backgroundValue = 0
-      thresh = vtk.vtkImageThreshold()
-      thresh.SetInputData(segmentLabelmap_Reference)
-      thresh.ThresholdByLower(0)
-      thresh.SetInValue(backgroundValue)
-      thresh.SetOutValue(labelValue)
-      thresh.SetOutputScalarType(vtk.VTK_UNSIGNED_CHAR)
-      thresh.Update()
-
-      #  Use binary labelmap as a stencil
-      stencil = vtk.vtkImageToImageStencil()
-      stencil.SetInputData(thresh.GetOutput())
-      stencil.ThresholdByUpper(labelValue)
-      stencil.Update()
-
-      stat = vtk.vtkImageAccumulate()
-      stat.SetInputData(self.grayscaleNode.GetImageData())
-      stat.SetStencilData(stencil.GetOutput())
-      stat.Update()
-
-      # Add data to statistics list
-      self.statistics[segmentID,"GS voxel count"] = stat.GetVoxelCount()
-      self.statistics[segmentID,"GS volume mm3"] = stat.GetVoxelCount() * cubicMMPerVoxel
-      self.statistics[segmentID,"GS volume cc"] = stat.GetVoxelCount() * cubicMMPerVoxel * ccPerCubicMM
-      if stat.GetVoxelCount()>0:
-        self.statistics[segmentID,"GS min"] = stat.GetMin()[0]
-        self.statistics[segmentID,"GS max"] = stat.GetMax()[0]
-        self.statistics[segmentID,"GS mean"] = stat.GetMean()[0]
-        self.statistics[segmentID,"GS stdev"] = stat.GetStandardDeviation()[0]
+    table = statisticsTable.GetTable()
+    for key in self.keys[1:]:
+      column = table.GetColumnByName(key)
+      if not column:
+        continue
+      for rowIndex, segmentID in enumerate(self.statistics["SegmentIDs"]):
+        value = column.GetValue(rowIndex)
+        if isinstance(value, float) and math.isnan(value):
+          # not available
+          continue
+        self.statistics[segmentID,key] = value
 
   def getStatisticsValueAsString(self, segmentID, key):
     if self.statistics.has_key((segmentID, key)):
@@ -100,9 +100,18 @@ class SurfaceToolboxWidget(ScriptedLoadableModuleWidget):
     self.layout.addWidget(decimationFrame)
     decimationFormLayout = qt.QFormLayout(decimationFrame)
 
+    decimationMethodCombo = qt.QComboBox(decimationFrame)
+    decimationMethodCombo.addItem("DecimatePro")
+    decimationMethodCombo.addItem("Quadric")
+    decimationFormLayout.addWidget(decimationMethodCombo)
+
     reductionFrame, reductionSlider, reductionSpinBox = numericInputFrame(self.parent,"Reduction:","Tooltip",0.0,1.0,0.05,2)
     decimationFormLayout.addWidget(reductionFrame)
 
+    targetTrianglesFrame, targetTrianglesSlider, targetTrianglesSpinBox = numericInputFrame(self.parent,"Target triangles:",
+      "Number of triangles to keep. When not 0, it is used instead of the reduction.",0.0,10000000.0,1000.0,0)
+    decimationFormLayout.addWidget(targetTrianglesFrame)
+
     boundaryDeletionCheckBox = qt.QCheckBox("Boundary deletion")
     decimationFormLayout.addWidget(boundaryDeletionCheckBox)
 
@@ -223,7 +232,9 @@ class SurfaceToolboxWidget(ScriptedLoadableModuleWidget):
       inputModelNode = None
       outputModelNode = None
       decimation = False
+      decimationMethod = "DecimatePro"
       reduction = 0.8
+      targetTriangles = 0
       boundaryDeletion = False
       smoothing = False
       smoothingMethod = "Laplace"
@@ -267,6 +278,8 @@ class SurfaceToolboxWidget(ScriptedLoadableModuleWidget):
       boundaryDeletionCheckBox.checked = state.boundaryDeletion
       reductionSlider.value = state.reduction
       reductionSpinBox.value = state.reduction
+      targetTrianglesSlider.value = state.targetTriangles
+      targetTrianglesSpinBox.value = state.targetTriangles
 
       smoothingButton.checked = state.smoothing
       smoothingFrame.visible = state.smoothing
@@ -323,6 +336,9 @@ class SurfaceToolboxWidget(ScriptedLoadableModuleWidget):
     connect(decimationButton, 'clicked(bool)', 'state.decimation = args[0]')
     connect(reductionSlider, 'valueChanged(double)', 'state.reduction = args[0]')
     connect(reductionSpinBox, 'valueChanged(double)', 'state.reduction = args[0]')
+    connect(decimationMethodCombo, 'currentIndexChanged(QString)', 'state.decimationMethod = args[0]')
+    connect(targetTrianglesSlider, 'valueChanged(double)', 'state.targetTriangles = int(args[0])')
+    connect(targetTrianglesSpinBox, 'valueChanged(double)', 'state.targetTriangles = int(args[0])')
     connect(boundaryDeletionCheckBox, 'stateChanged(int)', 'state.boundaryDeletion = bool(args[0])')
 
     connect(smoothingButton, 'clicked(bool)', 'state.smoothing = args[0]')
@@ -396,73 +412,44 @@ class SurfaceToolboxLogic(ScriptedLoadableModuleLogic):
 
   def applyFilters(self, state):
 
-    surface = None
-    surface = state.inputModelNode.GetPolyDataConnection()
-
-    if state.decimation:
-      triangle = vtk.vtkTriangleFilter()
-      triangle.SetInputConnection(surface)
-      decimation = vtk.vtkDecimatePro()
-      decimation.SetTargetReduction(state.reduction)
-      decimation.SetBoundaryVertexDeletion(state.boundaryDeletion)
-      decimation.PreserveTopologyOn()
-      decimation.SetInputConnection(triangle.GetOutputPort())
-      surface = decimation.GetOutputPort()
-
-    if state.smoothing:
-      if state.smoothingMethod == "Laplace":
-        smoothing = vtk.vtkSmoothPolyDataFilter()
-        smoothing.SetBoundarySmoothing(state.boundarySmoothing)
-        smoothing.SetNumberOfIterations(state.laplaceIterations)
-        smoothing.SetRelaxationFactor(state.laplaceRelaxation)
-        smoothing.SetInputConnection(surface)
-        surface = smoothing.GetOutputPort()
-      elif state.smoothingMethod == "Taubin":
-        smoothing = vtk.vtkWindowedSincPolyDataFilter()
-        smoothing.SetBoundarySmoothing(state.boundarySmoothing)
-        smoothing.SetNumberOfIterations(state.taubinIterations)
-        smoothing.SetPassBand(state.taubinPassBand)
-        smoothing.SetInputConnection(surface)
-        surface = smoothing.GetOutputPort()
-
-    if state.normals:
-      normals = vtk.vtkPolyDataNormals()
-      normals.SetAutoOrientNormals(state.autoOrientNormals)
-      normals.SetFlipNormals(state.flipNormals)
-      normals.SetSplitting(state.splitting)
-      normals.SetFeatureAngle(state.featureAngle)
-      normals.ConsistencyOn()
-      normals.SetInputConnection(surface)
-      surface = normals.GetOutputPort()
-
-    if state.mirror:
-      mirrorTransformMatrix = vtk.vtkMatrix4x4()
-      mirrorTransformMatrix.SetElement(0, 0, -1 if state.mirrorX else 1)
-      mirrorTransformMatrix.SetElement(1, 1, -1 if state.mirrorY else 1)
-      mirrorTransformMatrix.SetElement(2, 2, -1 if state.mirrorZ else 1)
-      mirrorTransform = vtk.vtkTransform()
-      mirrorTransform.SetMatrix(mirrorTransformMatrix)
-      transformFilter = vtk.vtkTransformPolyDataFilter()
-      transformFilter.SetInputConnection(surface)
-      transformFilter.SetTransform(mirrorTransform)
-      surface = transformFilter.GetOutputPort()
-      if mirrorTransformMatrix.Determinant()<0:
-        reverse = vtk.vtkReverseSense()
-        reverse.SetInputConnection(surface)
-        surface = reverse.GetOutputPort()
-
-    if state.cleaner:
-      cleaner = vtk.vtkCleanPolyData()
-      cleaner.SetInputConnection(surface)
-      surface = cleaner.GetOutputPort()
-
-    if state.connectivity:
-      connectivity = vtk.vtkPolyDataConnectivityFilter()
-      connectivity.SetExtractionModeToLargestRegion()
-      connectivity.SetInputConnection(surface)
-      surface = connectivity.GetOutputPort()
-
-    state.outputModelNode.SetPolyDataConnection(surface)
+    surface = slicer.vtkSurfaceProcessingFilter()
+    surface.SetInputConnection(state.inputModelNode.GetPolyDataConnection())
+
+    surface.SetDecimation(state.decimation)
+    if state.decimationMethod == "Quadric":
+      surface.SetDecimationMethodToQuadricDecimation()
+    else:
+      surface.SetDecimationMethodToDecimatePro()
+    surface.SetTargetReduction(state.reduction)
+    surface.SetTargetNumberOfTriangles(state.targetTriangles)
+    surface.SetBoundaryVertexDeletion(state.boundaryDeletion)
+
+    surface.SetSmoothing(state.smoothing)
+    if state.smoothingMethod == "Taubin":
+      surface.SetSmoothingMethodToTaubin()
+    else:
+      surface.SetSmoothingMethodToLaplace()
+    surface.SetLaplaceNumberOfIterations(int(state.laplaceIterations))
+    surface.SetLaplaceRelaxationFactor(state.laplaceRelaxation)
+    surface.SetTaubinNumberOfIterations(int(state.taubinIterations))
+    surface.SetTaubinPassBand(state.taubinPassBand)
+    surface.SetBoundarySmoothing(state.boundarySmoothing)
+
+    surface.SetNormals(state.normals)
+    surface.SetAutoOrientNormals(state.autoOrientNormals)
+    surface.SetFlipNormals(state.flipNormals)
+    surface.SetSplitting(state.splitting)
+    surface.SetFeatureAngle(state.featureAngle)
+
+    surface.SetMirror(state.mirror)
+    surface.SetMirrorX(state.mirrorX)
+    surface.SetMirrorY(state.mirrorY)
+    surface.SetMirrorZ(state.mirrorZ)
+
+    surface.SetClean(state.cleaner)
+    surface.SetConnectivity(state.connectivity)
+
+    state.outputModelNode.SetPolyDataConnection(surface.GetOutputPort())
     return True
 
 
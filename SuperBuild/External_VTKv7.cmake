@@ -42,6 +42,10 @@ if((NOT DEFINED VTK_DIR OR NOT DEFINED VTK_SOURCE_DIR) AND NOT ${CMAKE_PROJECT_N
       -DPYTHON_EXECUTABLE:PATH=${PYTHON_EXECUTABLE}
       -DPYTHON_INCLUDE_DIR:PATH=${PYTHON_INCLUDE_DIR}
       -DPYTHON_LIBRARY:FILEPATH=${PYTHON_LIBRARY}
+      # Release the GIL while wrapped C++ methods run so that Python threads
+      # calling long running filters and logics can execute concurrently.
+      -DVTK_NO_PYTHON_THREADS:BOOL=OFF
+      -DVTK_PYTHON_FULL_THREADSAFE:BOOL=ON
       )
   endif()
 